@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -52,6 +53,33 @@ class AppInfo
 	CreateFunc  create;
 };
 
+/*
+ *  Performance budget - The limits a sample is held to when run as a test, declared with its CMake registration (see add_sample)
+ */
+
+struct PerformanceBudget
+{
+	/// The budget only applies to the GPUs whose name contains this, or to any GPU if empty
+	std::string device;
+
+	/// 95th percentile of the frame times, in milliseconds, 0 if not budgeted
+	double frame_time_p95{0.0};
+
+	/// Peak memory used from the heaps of the device, in MiB, 0 if not budgeted
+	double peak_memory{0.0};
+
+	/// Time to create and prepare the sample, in seconds, 0 if not budgeted
+	double load_time{0.0};
+
+	/// Graphics and compute pipelines created by the sample, 0 if not budgeted
+	uint32_t pipeline_count{0};
+
+	bool empty() const
+	{
+		return frame_time_p95 <= 0.0 && peak_memory <= 0.0 && load_time <= 0.0 && pipeline_count == 0;
+	}
+};
+
 /*
  *  Samples - These are individual applications which show different usages and optimizations of the Vulkan API
  */
@@ -59,8 +87,8 @@ class AppInfo
 class SampleInfo : public AppInfo
 {
   public:
-	SampleInfo(const std::string &id, const CreateFunc &create, const std::string &category, const std::string &author, const std::string &name, const std::string &description, const std::vector<std::string> &tags = {}) :
-	    AppInfo(id, create), category(category), author(author), name(name), description(description), tags(tags)
+	SampleInfo(const std::string &id, const CreateFunc &create, const std::string &category, const std::string &author, const std::string &name, const std::string &description, const std::vector<std::string> &tags = {}, const PerformanceBudget &budget = {}) :
+	    AppInfo(id, create), category(category), author(author), name(name), description(description), tags(tags), budget(budget)
 	{}
 
 	std::string              category;
@@ -68,6 +96,7 @@ class SampleInfo : public AppInfo
 	std::string              name;
 	std::string              description;
 	std::vector<std::string> tags;
+	PerformanceBudget        budget;
 };
 
 /**
@@ -50,10 +50,18 @@ int platform_main(const vkb::PlatformContext &);
     _context = (vkb::IosPlatformContext*)context.get();
     _context->view = self.vulkan_view;
     _code = (vkb::ExitCode)platform_main(*context);
-    uint32_t fps = 60;
-   _displayLink = [CADisplayLink displayLinkWithTarget: self selector: @selector(renderLoop)];
-   [_displayLink setPreferredFramesPerSecond:fps];
-   [_displayLink addToRunLoop: NSRunLoop.currentRunLoop forMode: NSDefaultRunLoopMode];
+
+    // Frames start on the vsyncs of the display, so that each one is presented on the next vsync, at up to the highest
+    // refresh rate of the display, e.g. 120 Hz on ProMotion displays
+    NSInteger max_fps = [UIScreen mainScreen].maximumFramesPerSecond;
+    _displayLink = [CADisplayLink displayLinkWithTarget: self selector: @selector(renderLoop)];
+    if (@available(iOS 15.0, *)) {
+        // Lets the system lower the rate in steps the display supports, rather than skipping vsyncs unevenly
+        [_displayLink setPreferredFrameRateRange:CAFrameRateRangeMake(max_fps / 2, max_fps, max_fps)];
+    } else {
+        [_displayLink setPreferredFramesPerSecond:max_fps];
+    }
+    [_displayLink addToRunLoop: NSRunLoop.currentRunLoop forMode: NSDefaultRunLoopMode];
 }
 
 -(void) renderLoop {
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -69,5 +69,6 @@ CUSTOM_MAIN(context)
 
 	platform.terminate(code);
 
-	return 0;
+	// Tests fail the run with an error, e.g. when a sample is over its performance budget
+	return platform.get_last_error().empty() ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,308 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "autotune.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <fmt/format.h>
+
+#include "batch_mode/batch_mode.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+#include "filesystem/legacy.h"
+#include "platform/platform.h"
+#include "rendering/render_context.h"
+#include "vulkan_sample.h"
+
+namespace plugins
+{
+namespace
+{
+/**
+ * @return The median of the measured times, the ones which are 0 were not measured
+ */
+double get_median(std::vector<double> times)
+{
+	times.erase(std::remove(times.begin(), times.end(), 0.0), times.end());
+
+	if (times.empty())
+	{
+		return 0.0;
+	}
+
+	auto middle = times.begin() + times.size() / 2;
+	std::nth_element(times.begin(), middle, times.end());
+
+	return *middle;
+}
+
+inline std::string get_results_path()
+{
+	return vkb::fs::path::get(vkb::fs::path::Type::Storage, "autotune.txt");
+}
+
+inline vkb::VulkanSample<vkb::BindingType::C> *get_vulkan_sample(vkb::Platform &platform)
+{
+	return dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform.get_app());
+}
+}        // namespace
+
+Autotune::Autotune() :
+    AutotuneTags("Autotune",
+                 "Find the fastest configuration of a sample on the device, and start the sample in it.",
+                 {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::PostDraw},
+                 {&autotune_flag, &autotune_duration_flag})
+{
+}
+
+bool Autotune::is_active(const vkb::CommandParser &parser)
+{
+	// Always active, so that the samples start in their stored configuration
+	return true;
+}
+
+void Autotune::init(const vkb::CommandParser &parser)
+{
+	sweep = parser.contains(&autotune_flag);
+
+	if (parser.contains(&autotune_duration_flag))
+	{
+		duration = std::max(parser.as<float>(&autotune_duration_flag), 0.1f);
+	}
+}
+
+void Autotune::on_app_start(const std::string &app_id)
+{
+	current_app_id = app_id;
+	started        = false;
+	sweeping       = false;
+	results.clear();
+}
+
+void Autotune::on_update(float delta_time)
+{
+	if (!sweeping)
+	{
+		return;
+	}
+
+	// The first frames of a configuration recreate its resources
+	if (++frame_count <= WARMUP_FRAMES)
+	{
+		return;
+	}
+
+	frame_times.push_back(delta_time * 1000.0);
+	elapsed_time += delta_time;
+
+	if (elapsed_time >= duration)
+	{
+		next_configuration();
+	}
+}
+
+void Autotune::on_post_draw(vkb::RenderContext &context)
+{
+	// The device of the app is only known once it draws
+	if (!started)
+	{
+		started = true;
+		start(context);
+	}
+
+	double gpu_frame_time = context.take_gpu_frame_time();
+
+	if (sweeping && frame_count > WARMUP_FRAMES)
+	{
+		gpu_times.push_back(gpu_frame_time * 1000.0);
+	}
+}
+
+void Autotune::start(vkb::RenderContext &context)
+{
+	auto *vulkan_app = get_vulkan_sample(*platform);
+	if (!vulkan_app)
+	{
+		return;
+	}
+
+	auto &properties = context.get_device().get_gpu().get_properties();
+	device_key       = fmt::format("{:04x}:{:04x}:{:08x}", properties.vendorID, properties.deviceID, properties.driverVersion);
+
+	auto &configuration = vulkan_app->get_configuration();
+
+	if (sweep)
+	{
+		if (configuration.size() < 2)
+		{
+			LOGI("Autotune: {} has no configurations to choose from", current_app_id);
+			return;
+		}
+
+		context.set_gpu_frame_timing(true);
+
+		configuration.reset();
+		configuration.set();
+
+		sweeping     = true;
+		frame_count  = 0;
+		elapsed_time = 0.0f;
+		frame_times.clear();
+		gpu_times.clear();
+
+		LOGI("Autotune: measuring {} configurations of {} for {:.1f}s each", configuration.size(), current_app_id, duration);
+		return;
+	}
+
+	// The batch mode runs every configuration from the first one
+	if (platform->using_plugin<BatchMode>())
+	{
+		return;
+	}
+
+	auto stored_results = load_results();
+
+	auto it = stored_results.find(device_key + " " + current_app_id);
+	if (it != stored_results.end() && it->second != configuration.get_current_index() && configuration.select(it->second))
+	{
+		configuration.set();
+
+		LOGI("Autotune: starting {} in its configuration {}", current_app_id, it->second);
+	}
+}
+
+void Autotune::next_configuration()
+{
+	auto *vulkan_app = get_vulkan_sample(*platform);
+	if (!vulkan_app)
+	{
+		sweeping = false;
+		return;
+	}
+
+	auto &configuration = vulkan_app->get_configuration();
+
+	Result result{configuration.get_current_index(), get_median(frame_times), get_median(gpu_times)};
+	results.push_back(result);
+
+	LOGI("Autotune: configuration {} of {}: {:.2f}ms per frame, {:.2f}ms GPU", result.configuration, current_app_id, result.frame_time, result.gpu_time);
+
+	frame_count  = 0;
+	elapsed_time = 0.0f;
+	frame_times.clear();
+	gpu_times.clear();
+
+	if (configuration.next())
+	{
+		configuration.set();
+		return;
+	}
+
+	sweeping = false;
+
+	auto best = std::min_element(results.begin(), results.end(), [](const Result &a, const Result &b) {
+		// When the presentation caps the frame rate the frame times are alike, and the GPU time tells the configurations apart
+		if (std::abs(a.frame_time - b.frame_time) <= FRAME_TIME_TOLERANCE * std::max(a.frame_time, b.frame_time) && a.gpu_time > 0.0 && b.gpu_time > 0.0)
+		{
+			return a.gpu_time < b.gpu_time;
+		}
+		return a.frame_time < b.frame_time;
+	});
+
+	configuration.select(best->configuration);
+	configuration.set();
+
+	store_result(*best);
+
+	LOGI("Autotune: configuration {} is the fastest for {}, it is stored in {}", best->configuration, current_app_id, get_results_path());
+}
+
+std::unordered_map<std::string, uint32_t> Autotune::load_results() const
+{
+	std::unordered_map<std::string, uint32_t> stored_results;
+
+	try
+	{
+		auto fs   = vkb::filesystem::get();
+		auto path = get_results_path();
+		if (!fs->is_file(path))
+		{
+			return stored_results;
+		}
+
+		// Each line holds a device key, an app id, the configuration and its frame time
+		std::istringstream lines{fs->read_file_string(path)};
+		std::string        line;
+		while (std::getline(lines, line))
+		{
+			std::istringstream fields{line};
+			std::string        line_device_key;
+			std::string        line_app_id;
+			uint32_t           line_configuration;
+			if (fields >> line_device_key >> line_app_id >> line_configuration)
+			{
+				stored_results[line_device_key + " " + line_app_id] = line_configuration;
+			}
+		}
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Autotune: failed to read the stored configurations: {}", e.what());
+	}
+
+	return stored_results;
+}
+
+void Autotune::store_result(const Result &result) const
+{
+	try
+	{
+		auto fs   = vkb::filesystem::get();
+		auto path = get_results_path();
+
+		std::string data;
+
+		// Keep the lines of the other devices and apps
+		if (fs->is_file(path))
+		{
+			std::istringstream lines{fs->read_file_string(path)};
+			std::string        line;
+			while (std::getline(lines, line))
+			{
+				std::istringstream fields{line};
+				std::string        line_device_key;
+				std::string        line_app_id;
+				if ((fields >> line_device_key >> line_app_id) && (line_device_key != device_key || line_app_id != current_app_id))
+				{
+					data += line + "\n";
+				}
+			}
+		}
+
+		data += fmt::format("{} {} {} {:.3f}\n", device_key, current_app_id, result.configuration, result.frame_time);
+
+		fs->write_file(path, data);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Autotune: failed to store the configuration: {}", e.what());
+	}
+}
+}        // namespace plugins
@@ -0,0 +1,125 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class Autotune;
+
+using AutotuneTags = vkb::PluginBase<Autotune, vkb::tags::Passive>;
+
+/**
+ * @brief Autotune
+ *
+ * Sweeps the configurations of a sample on the device it runs on, and keeps the fastest one. Each configuration is measured
+ * for a few seconds after a warm-up, and ranked by its median frame time. Configurations whose frame times are within a few
+ * percent, e.g. because the presentation caps the frame rate, are ranked by the median GPU time of their frames instead.
+ *
+ * The fastest configuration of each sample is stored per device and driver version in output/autotune.txt, and samples start
+ * in their stored configuration on later launches, except in batch mode. The knobs which are swept are the ones the samples
+ * insert into their vkb::Configuration, like the swapchain image count, buffer allocation or descriptor management strategies.
+ *
+ * Usage: vulkan_samples sample swapchain_images --autotune
+ *        vulkan_samples sample descriptor_management --autotune --autotune-duration 5
+ *
+ */
+class Autotune : public AutotuneTags
+{
+  public:
+	Autotune();
+
+	virtual ~Autotune() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_update(float delta_time) override;
+
+	virtual void on_app_start(const std::string &app_id) override;
+
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
+	vkb::FlagCommand autotune_flag          = {vkb::FlagType::FlagOnly, "autotune", "", "Sweep the configurations of the sample and keep the fastest one for the device"};
+	vkb::FlagCommand autotune_duration_flag = {vkb::FlagType::OneValue, "autotune-duration", "", "Seconds each configuration is measured for"};
+
+	/// Frames of each configuration excluded from its measurements, as the first ones recreate resources
+	static constexpr uint32_t WARMUP_FRAMES = 30;
+
+	/// Relative difference of the median frame times under which configurations are ranked by their GPU time
+	static constexpr double FRAME_TIME_TOLERANCE = 0.02;
+
+  private:
+	/// Median times of the measured frames of a configuration, in milliseconds
+	struct Result
+	{
+		uint32_t configuration{0};
+
+		double frame_time{0.0};
+
+		double gpu_time{0.0};
+	};
+
+	/**
+	 * @brief Sweeps the configurations from the first one, or selects the stored configuration of the app
+	 */
+	void start(vkb::RenderContext &context);
+
+	/**
+	 * @brief Records the result of the current configuration and moves to the next one, or ends the sweep
+	 */
+	void next_configuration();
+
+	/**
+	 * @return The stored configurations, by device key and app id
+	 */
+	std::unordered_map<std::string, uint32_t> load_results() const;
+
+	void store_result(const Result &result) const;
+
+	bool sweep{false};
+
+	float duration{3.0f};
+
+	std::string current_app_id;
+
+	/// Identifies the device and its driver, see start()
+	std::string device_key;
+
+	/// Whether the app drew its first frame, which starts the sweep or selects the stored configuration
+	bool started{false};
+
+	bool sweeping{false};
+
+	uint32_t frame_count{0};
+
+	float elapsed_time{0.0f};
+
+	std::vector<double> frame_times;
+
+	std::vector<double> gpu_times;
+
+	std::vector<Result> results;
+};
+}        // namespace plugins
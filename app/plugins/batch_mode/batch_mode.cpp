@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,9 @@
 
 #include "batch_mode.h"
 
+#include <cstdio>
+
+#include "device_handover.h"
 #include "vulkan_sample.h"
 
 #include "platform/parser.h"
@@ -31,6 +34,8 @@ BatchMode::BatchMode() :
                   {
                       vkb::Hook::OnUpdate,
                       vkb::Hook::OnAppError,
+                      vkb::Hook::OnAppStart,
+                      vkb::Hook::OnPlatformClose,
                   },
                   {&batch_cmd})
 {
@@ -53,6 +58,11 @@ void BatchMode::init(const vkb::CommandParser &parser)
 		wrap_to_start = true;
 	}
 
+	if (parser.contains(&share_device_flag))
+	{
+		share_device = true;
+	}
+
 	std::vector<std::string> tags;
 	if (parser.contains(&tags_flag))
 	{
@@ -71,6 +81,20 @@ void BatchMode::init(const vkb::CommandParser &parser)
 		skips = parser.as<std::unordered_set<std::string>>(&skip_flag);
 	}
 
+	if (parser.contains(&resolutions_flag))
+	{
+		for (auto &resolution : parser.as<std::vector<std::string>>(&resolutions_flag))
+		{
+			VkExtent2D extent{};
+			if (std::sscanf(resolution.c_str(), "%ux%u", &extent.width, &extent.height) != 2 || extent.width == 0 || extent.height == 0)
+			{
+				LOGE("Invalid resolution {}, expected WIDTHxHEIGHT", resolution);
+				throw std::runtime_error{"Can not continue"};
+			}
+			resolutions.push_back(extent);
+		}
+	}
+
 	sample_list = apps::get_samples(categories, tags);
 	if (!skips.empty())
 	{
@@ -115,6 +139,14 @@ void BatchMode::on_update(float delta_time)
 	{
 		elapsed_time = 0.0f;
 
+		// Each configuration runs at every resolution
+		if (resolution_index + 1 < resolutions.size())
+		{
+			resolution_index++;
+			set_resolution();
+			return;
+		}
+
 		// Only check and advance the config if the application is a vulkan sample
 		if (auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app()))
 		{
@@ -123,6 +155,8 @@ void BatchMode::on_update(float delta_time)
 			if (configuration.next())
 			{
 				configuration.set();
+				resolution_index = 0;
+				set_resolution();
 				return;
 			}
 		}
@@ -138,6 +172,47 @@ void BatchMode::on_app_error(const std::string &app_id)
 	load_next_app();
 }
 
+void BatchMode::on_app_start(const std::string &app_id)
+{
+	// Only the sample closed for the next one hands its device over, the last one is destroyed with the platform
+	vkb::DeviceHandover::get().set_enabled(false);
+
+	resolution_index = 0;
+	set_resolution();
+}
+
+void BatchMode::on_platform_close()
+{
+	// The objects of a sample which failed to start are still held
+	vkb::DeviceHandover::get().release();
+}
+
+void BatchMode::set_resolution()
+{
+	if (resolutions.empty())
+	{
+		return;
+	}
+
+	auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app());
+	if (!vulkan_app || !vulkan_app->has_render_context() || !vulkan_app->get_render_context().has_swapchain())
+	{
+		return;
+	}
+
+	auto &render_context = vulkan_app->get_render_context();
+	auto &extent         = resolutions[resolution_index];
+
+	vulkan_app->get_device().wait_idle();
+	render_context.update_swapchain(extent);
+
+	auto &swapchain_extent = render_context.get_swapchain().get_extent();
+	if (swapchain_extent.width != extent.width || swapchain_extent.height != extent.height)
+	{
+		LOGW("The surface does not support {}x{}, running at {}x{}", extent.width, extent.height, swapchain_extent.width, swapchain_extent.height);
+	}
+}
+
 void BatchMode::request_app()
 {
 	LOGI("===========================================");
@@ -164,6 +239,9 @@ void BatchMode::load_next_app()
 		}
 	}
 
+	// The current app hands its device over to the next one when it is closed
+	vkb::DeviceHandover::get().set_enabled(share_device);
+
 	// App will be started before the next update loop
 	request_app();
 }
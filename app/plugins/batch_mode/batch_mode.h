@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "apps.h"
+#include "common/vk_common.h"
 #include "platform/plugins/plugin_base.h"
 #include "timer.h"
 
@@ -34,8 +35,16 @@ using BatchModeTags = vkb::PluginBase<vkb::tags::Entrypoint, vkb::tags::FullCont
  * @brief Batch Mode
  *
  * Run a subset of samples. The next sample in the set will start after the current sample being executed has finished. Using --wrap-to-start will start again from the first sample after the last sample is executed.
+ * Using --resolution runs each configuration of a sample at each resolution, by recreating the swapchain with that extent. Surfaces which
+ * cannot be scaled keep the extent of the window.
+ *
+ * Combined with the benchmark mode, the frame times of every run are written to one report.
+ * Using --share-device keeps the instance, device and pipeline cache alive from one sample to the next when both require the same ones,
+ * so that the runtime of large batches is spent rendering instead of creating devices and pipelines, see vkb::DeviceHandover.
  *
  * Usage: vulkan_samples batch --duration 3 --category performance --tag arm
+ *        vulkan_samples batch --duration 10 --category performance --resolution 1280x720 1920x1080 --benchmark --benchmark-output report.json
+ *        vulkan_samples batch --duration 3 --category api --share-device
  *
  */
 class BatchMode : public BatchModeTags
@@ -53,6 +62,10 @@ class BatchMode : public BatchModeTags
 
 	virtual void on_app_error(const std::string &app_id) override;
 
+	virtual void on_app_start(const std::string &app_id) override;
+
+	virtual void on_platform_close() override;
+
 	// TODO: Could this be replaced by the stop after plugin?
 	vkb::FlagCommand duration_flag{vkb::FlagType::OneValue, "duration", "", "The duration which a configuration should run for in seconds"};
 
@@ -64,7 +77,11 @@ class BatchMode : public BatchModeTags
 
 	vkb::FlagCommand skip_flag{vkb::FlagType::ManyValues, "skip", "", "Skip a sample by id"};
 
-	vkb::SubCommand batch_cmd{"batch", "Enable batch mode", {&duration_flag, &wrap_flag, &tags_flag, &categories_flag, &skip_flag}};
+	vkb::FlagCommand resolutions_flag{vkb::FlagType::ManyValues, "resolution", "", "Run each configuration at these resolutions, as WIDTHxHEIGHT"};
+
+	vkb::FlagCommand share_device_flag{vkb::FlagType::FlagOnly, "share-device", "", "Keep the instance and device alive across samples which require the same ones"};
+
+	vkb::SubCommand batch_cmd{"batch", "Enable batch mode", {&duration_flag, &wrap_flag, &tags_flag, &categories_flag, &skip_flag, &resolutions_flag, &share_device_flag}};
 
   private:
 	/// The list of suitable samples to be run in conjunction with batch mode
@@ -80,8 +97,21 @@ class BatchMode : public BatchModeTags
 
 	bool wrap_to_start = false;
 
+	/// The resolutions each configuration runs at, empty to keep the one of the window
+	std::vector<VkExtent2D> resolutions;
+
+	size_t resolution_index{0};
+
+	/// Whether a sample hands its instance and device over to the next one
+	bool share_device{false};
+
 	void request_app();
 
+	/**
+	 * @brief Recreates the swapchain of the current sample with the current resolution
+	 */
+	void set_resolution();
+
 	void load_next_app();
 };
 }        // namespace plugins
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,15 +17,101 @@
 
 #include "benchmark_mode.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include <fmt/format.h>
+
+#include "core/allocated.h"
 #include "platform/platform.h"
+#include "rendering/render_context.h"
+#include "stats/stats_provider.h"
+#include "vulkan_sample.h"
 
 namespace plugins
 {
+namespace
+{
+/**
+ * @brief Nearest rank percentiles of the measured times, the ones which are 0 were not measured
+ */
+BenchmarkMode::Percentiles get_percentiles(std::vector<double> times)
+{
+	times.erase(std::remove(times.begin(), times.end(), 0.0), times.end());
+
+	if (times.empty())
+	{
+		return {};
+	}
+
+	std::sort(times.begin(), times.end());
+
+	auto percentile = [&times](double p) {
+		size_t rank = static_cast<size_t>(std::ceil(p * times.size()));
+		return times[std::max<size_t>(rank, 1) - 1];
+	};
+
+	return {percentile(0.50), percentile(0.95), percentile(0.99), times.back()};
+}
+
+/**
+ * @return The memory used from all heaps of the device and their budget, in bytes
+ */
+std::pair<VkDeviceSize, VkDeviceSize> get_memory_usage()
+{
+	auto &allocator = vkb::allocated::get_memory_allocator();
+	if (allocator == VK_NULL_HANDLE)
+	{
+		return {0, 0};
+	}
+
+	const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+	vmaGetMemoryProperties(allocator, &memory_properties);
+
+	std::vector<VmaBudget> budgets(memory_properties->memoryHeapCount);
+	vmaGetHeapBudgets(allocator, budgets.data());
+
+	VkDeviceSize usage  = 0;
+	VkDeviceSize budget = 0;
+	for (auto &heap_budget : budgets)
+	{
+		usage += heap_budget.usage;
+		budget += heap_budget.budget;
+	}
+
+	return {usage, budget};
+}
+
+std::vector<std::pair<std::string, BenchmarkMode::Percentiles>> get_run_percentiles(const std::vector<double> &frame_times,
+                                                                                    const std::vector<double> &cpu_times,
+                                                                                    const std::vector<double> &gpu_times)
+{
+	return {{"frame_time", get_percentiles(frame_times)}, {"cpu_time", get_percentiles(cpu_times)}, {"gpu_time", get_percentiles(gpu_times)}};
+}
+
+/**
+ * @brief Adds a value to the sum of a counter, by name
+ */
+void add_counter(std::vector<std::pair<std::string, double>> &counters, const std::string &name, double value)
+{
+	auto counter = std::find_if(counters.begin(), counters.end(), [&name](auto &entry) { return entry.first == name; });
+	if (counter == counters.end())
+	{
+		counters.emplace_back(name, value);
+	}
+	else
+	{
+		counter->second += value;
+	}
+}
+}        // namespace
+
 BenchmarkMode::BenchmarkMode() :
     BenchmarkModeTags("Benchmark Mode",
-                      "Log frame averages after running an app.",
-                      {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose},
-                      {&benchmark_flag})
+                      "Log frame averages and percentiles after running an app.",
+                      {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose, vkb::Hook::PostDraw},
+                      {&benchmark_flag, &benchmark_warmup_flag, &benchmark_output_flag})
 {
 }
 
@@ -40,23 +126,517 @@ void BenchmarkMode::init(const vkb::CommandParser &parser)
 	// This will effect the graph outputs of framerate
 	platform->force_simulation_fps(60.0f);
 	platform->force_render(true);
+
+	if (parser.contains(&benchmark_warmup_flag))
+	{
+		warmup_frames = parser.as<uint32_t>(&benchmark_warmup_flag);
+	}
+
+	if (parser.contains(&benchmark_output_flag))
+	{
+		output_path = parser.as<std::string>(&benchmark_output_flag);
+	}
 }
 
 void BenchmarkMode::on_update(float delta_time)
 {
 	elapsed_time += delta_time;
 	total_frames++;
+
+	auto &run = runs.back();
+	run.elapsed_time += delta_time;
+	run.total_frames++;
+
+	// The delta time of the first frame is measured from before the run started
+	capturing = run.total_frames > std::max(warmup_frames, 1u);
+
+	if (capturing)
+	{
+		run.frames.push_back({delta_time * 1000.0});
+		cpu_timer.start();
+	}
+}
+
+void BenchmarkMode::on_post_draw(vkb::RenderContext &context)
+{
+	// The render context of the app is only known once it draws
+	if (!gpu_frame_timing)
+	{
+		context.set_gpu_frame_timing(true);
+		context.set_gpu_profiling(true);
+		context.set_frame_timeline(true);
+		gpu_frame_timing = true;
+	}
+
+	update_run(context);
+
+	double gpu_frame_time = context.take_gpu_frame_time();
+
+	auto &run    = runs.back();
+	auto  memory = get_memory_usage();
+	if (memory.first > run.peak_memory)
+	{
+		run.peak_memory   = memory.first;
+		run.memory_budget = memory.second;
+	}
+
+	for (uint32_t tag = 0; tag < vkb::allocated::MEMORY_TAG_COUNT; tag++)
+	{
+		run.peak_tagged_memory[tag] = std::max(run.peak_tagged_memory[tag], vkb::allocated::get_tagged_memory_usage(static_cast<vkb::allocated::MemoryTag>(tag)));
+	}
+
+	// Throttling slows the frames down, so a run is only comparable to others which ran at the same thermal status
+	run.peak_thermal_status   = std::max(run.peak_thermal_status, platform->get_thermal_status());
+	run.peak_thermal_headroom = std::max(run.peak_thermal_headroom, platform->get_thermal_headroom());
+
+	if (capturing)
+	{
+		run.frames.back().cpu_time = cpu_timer.stop<vkb::Timer::Milliseconds>();
+		run.frames.back().gpu_time = gpu_frame_time * 1000.0;
+		capture_counters(run);
+		capture_bottleneck(run);
+		capture_gpu_scopes(run, context);
+		capture_frame_timeline(run, context);
+	}
+}
+
+void BenchmarkMode::update_run(vkb::RenderContext &context)
+{
+	uint32_t configuration = 0;
+	if (auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app()))
+	{
+		configuration = vulkan_app->get_configuration().get_current_index();
+	}
+
+	VkExtent2D extent = context.has_swapchain() ? context.get_swapchain().get_extent() : context.get_surface_extent();
+
+	auto &run = runs.back();
+
+	// The first frame of an app tells the configuration and extent of its first run
+	if (run.total_frames <= 1 && run.frames.empty())
+	{
+		run.configuration = configuration;
+		run.extent        = extent;
+		run.device_count  = context.get_device().get_device_group_size();
+		return;
+	}
+
+	if (run.configuration == configuration && run.extent.width == extent.width && run.extent.height == extent.height)
+	{
+		return;
+	}
+
+	// The frame was drawn with the new configuration or extent, it is the first one of the new run
+	if (capturing)
+	{
+		run.frames.pop_back();
+		capturing = false;
+	}
+
+	log_run(run);
+
+	Run next_run{run.app_id, configuration, extent};
+	next_run.total_frames = 1;
+	runs.push_back(std::move(next_run));
+}
+
+void BenchmarkMode::capture_counters(Run &run)
+{
+	auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app());
+	if (!vulkan_app || !vulkan_app->has_render_context())
+	{
+		return;
+	}
+
+	auto &stats = vulkan_app->get_stats();
+
+	for (auto index : stats.get_requested_stats())
+	{
+		// Frame times are captured by the benchmark itself, and the mean of a bottleneck is meaningless, see capture_bottleneck()
+		if (index == vkb::StatIndex::frame_times || index == vkb::StatIndex::gpu_bottleneck || !stats.is_available(index))
+		{
+			continue;
+		}
+
+		auto &data = stats.get_data(index);
+		if (data.empty())
+		{
+			continue;
+		}
+
+		auto  &graph_data = stats.get_graph_data(index);
+		double value      = data.back() * graph_data.scale_factor;
+
+		auto counter = std::find_if(run.counters.begin(), run.counters.end(), [&graph_data](auto &entry) { return entry.first == graph_data.name; });
+		if (counter == run.counters.end())
+		{
+			run.counters.emplace_back(graph_data.name, value);
+		}
+		else
+		{
+			counter->second += value;
+		}
+	}
+}
+
+void BenchmarkMode::capture_bottleneck(Run &run)
+{
+	auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app());
+	if (!vulkan_app || !vulkan_app->has_render_context())
+	{
+		return;
+	}
+
+	auto frame_bottleneck = vulkan_app->get_stats().get_bottleneck();
+
+	run.bottleneck_frames[static_cast<size_t>(frame_bottleneck.bottleneck)]++;
+
+	if (frame_bottleneck.pass.empty())
+	{
+		return;
+	}
+
+	auto pass = std::find_if(run.heaviest_passes.begin(), run.heaviest_passes.end(), [&frame_bottleneck](auto &entry) { return entry.first == frame_bottleneck.pass; });
+	if (pass == run.heaviest_passes.end())
+	{
+		run.heaviest_passes.emplace_back(frame_bottleneck.pass, 1);
+	}
+	else
+	{
+		pass->second++;
+	}
+}
+
+void BenchmarkMode::capture_gpu_scopes(Run &run, const vkb::RenderContext &context)
+{
+	auto *gpu_profiler = context.get_gpu_profiler();
+	if (!gpu_profiler)
+	{
+		return;
+	}
+
+	auto add_counter = [&run](const std::string &name, double value) {
+		auto counter = std::find_if(run.counters.begin(), run.counters.end(), [&name](auto &entry) { return entry.first == name; });
+		if (counter == run.counters.end())
+		{
+			run.counters.emplace_back(name, value);
+		}
+		else
+		{
+			counter->second += value;
+		}
+	};
+
+	for (auto &scope : gpu_profiler->get_scopes())
+	{
+		add_counter("GPU " + scope.name + " (ms)", scope.time * 1000.0);
+
+		// The pipeline statistics let mesh optimizations and culling changes be compared, see RenderContext::set_gpu_pipeline_statistics()
+		if (scope.has_statistics)
+		{
+			auto &statistics = scope.statistics;
+			add_counter("GPU " + scope.name + " vertex invocations", static_cast<double>(statistics.vertex_shader_invocations));
+			add_counter("GPU " + scope.name + " vertex reuse", statistics.get_vertex_reuse());
+			add_counter("GPU " + scope.name + " clipping primitives", static_cast<double>(statistics.clipping_primitives));
+			add_counter("GPU " + scope.name + " fragment invocations", static_cast<double>(statistics.fragment_shader_invocations));
+			add_counter("GPU " + scope.name + " compute invocations", static_cast<double>(statistics.compute_shader_invocations));
+		}
+	}
+}
+
+void BenchmarkMode::capture_frame_timeline(Run &run, vkb::RenderContext &context)
+{
+	// An app requesting the stats of the frame timeline takes its measurements, capture_counters() captures them instead
+	auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app());
+	if (vulkan_app && vulkan_app->has_render_context() && vulkan_app->get_stats().is_available(vkb::StatIndex::frames_ahead_of_gpu))
+	{
+		return;
+	}
+
+	auto measurements = context.take_frame_timeline_measurements();
+	if (measurements.frame_count == 0)
+	{
+		return;
+	}
+
+	// Named and scaled as the stats, so that the counters are the same whichever captured them
+	double frame_count = measurements.frame_count;
+	for (auto &value : {std::make_pair(vkb::StatIndex::frames_ahead_of_gpu, measurements.frames_ahead),
+	                    std::make_pair(vkb::StatIndex::gpu_idle_time, measurements.gpu_idle_times),
+	                    std::make_pair(vkb::StatIndex::queue_bubble_time, measurements.queue_bubble_times),
+	                    std::make_pair(vkb::StatIndex::acquire_time, measurements.acquire_times),
+	                    std::make_pair(vkb::StatIndex::present_time, measurements.present_times)})
+	{
+		auto &graph_data = vkb::StatsProvider::default_graph_data(value.first);
+		add_counter(run.counters, graph_data.name, value.second / frame_count * graph_data.scale_factor);
+	}
 }
 
 void BenchmarkMode::on_app_start(const std::string &app_id)
 {
-	elapsed_time = 0;
-	total_frames = 0;
+	elapsed_time     = 0;
+	total_frames     = 0;
+	capturing        = false;
+	gpu_frame_timing = false;
+	runs.push_back({app_id});
 	LOGI("Starting Benchmark for {}", app_id);
 }
 
 void BenchmarkMode::on_app_close(const std::string &app_id)
 {
 	LOGI("Benchmark for {} completed in {} seconds (ran {} frames, averaged {} fps)", app_id, elapsed_time, total_frames, total_frames / elapsed_time);
+
+	log_run(runs.back());
+
+	if (!output_path.empty())
+	{
+		write_output();
+	}
+}
+
+BenchmarkMode::AppSummary BenchmarkMode::get_app_summary() const
+{
+	AppSummary summary;
+
+	if (runs.empty())
+	{
+		return summary;
+	}
+
+	auto &app_id = runs.back().app_id;
+
+	for (auto run = runs.rbegin(); run != runs.rend() && run->app_id == app_id; ++run)
+	{
+		std::vector<double> frame_times;
+		for (auto &frame : run->frames)
+		{
+			frame_times.push_back(frame.frame_time);
+		}
+
+		summary.frames += run->frames.size();
+		summary.frame_time_p95 = std::max(summary.frame_time_p95, get_percentiles(frame_times).p95);
+		summary.peak_memory    = std::max(summary.peak_memory, run->peak_memory);
+	}
+
+	return summary;
+}
+
+void BenchmarkMode::log_run(const Run &run) const
+{
+	std::vector<double> frame_times, cpu_times, gpu_times;
+	for (auto &frame : run.frames)
+	{
+		frame_times.push_back(frame.frame_time);
+		cpu_times.push_back(frame.cpu_time);
+		gpu_times.push_back(frame.gpu_time);
+	}
+
+	LOGI("Run of {} configuration {} at {}x{} on {} GPU(s), peak memory {:.1f} MiB of a {:.1f} MiB budget",
+	     run.app_id, run.configuration, run.extent.width, run.extent.height, run.device_count, run.peak_memory / (1024.0 * 1024.0), run.memory_budget / (1024.0 * 1024.0));
+
+	for (uint32_t tag = 0; tag < vkb::allocated::MEMORY_TAG_COUNT; tag++)
+	{
+		LOGI("{} memory: peak {:.1f} MiB", vkb::allocated::to_string(static_cast<vkb::allocated::MemoryTag>(tag)), run.peak_tagged_memory[tag] / (1024.0 * 1024.0));
+	}
+
+	if (run.peak_thermal_status >= 0)
+	{
+		LOGI("Peak thermal status {}, peak thermal headroom {:.2f}", run.peak_thermal_status, run.peak_thermal_headroom);
+	}
+
+	for (size_t b = 0; b < vkb::BOTTLENECK_COUNT; b++)
+	{
+		if (run.bottleneck_frames[b] > 0)
+		{
+			LOGI("{}: {} frames", vkb::to_string(static_cast<vkb::Bottleneck>(b)), run.bottleneck_frames[b]);
+		}
+	}
+
+	for (auto &pass : run.heaviest_passes)
+	{
+		LOGI("Heaviest pass {}: {} frames", pass.first, pass.second);
+	}
+
+	for (auto &metric : get_run_percentiles(frame_times, cpu_times, gpu_times))
+	{
+		LOGI("{} over {} frames: p50 {:.2f} ms, p95 {:.2f} ms, p99 {:.2f} ms, max {:.2f} ms",
+		     metric.first, run.frames.size(), metric.second.p50, metric.second.p95, metric.second.p99, metric.second.max);
+	}
+
+	for (auto &counter : run.counters)
+	{
+		LOGI("{}: mean {:.2f}", counter.first, counter.second / run.frames.size());
+	}
+}
+
+void BenchmarkMode::write_output() const
+{
+	std::ofstream file{output_path};
+	if (!file)
+	{
+		LOGE("Cannot write the benchmark output to {}", output_path);
+		return;
+	}
+
+	bool csv = output_path.size() >= 4 && output_path.compare(output_path.size() - 4, 4, ".csv") == 0;
+
+	if (csv)
+	{
+		// One table per section, separated by empty lines, times in milliseconds, runs numbered in order
+		std::string summary    = "run,sample,configuration,width,height,devices,frames,peak_memory,metric,p50,p95,p99,max\n";
+		std::string counters   = "run,counter,mean\n";
+		std::string memory     = "run,tag,peak_memory\n";
+		std::string thermal    = "run,peak_thermal_status,peak_thermal_headroom\n";
+		std::string bottleneck = "run,bottleneck,frames\n";
+		std::string passes     = "run,heaviest_pass,frames\n";
+		std::string frames     = "run,frame,frame_time,cpu_time,gpu_time\n";
+
+		for (size_t r = 0; r < runs.size(); r++)
+		{
+			auto &run = runs[r];
+
+			std::vector<double> frame_times, cpu_times, gpu_times;
+			for (size_t i = 0; i < run.frames.size(); i++)
+			{
+				auto &frame = run.frames[i];
+				frame_times.push_back(frame.frame_time);
+				cpu_times.push_back(frame.cpu_time);
+				gpu_times.push_back(frame.gpu_time);
+				frames += fmt::format("{},{},{:.4f},{:.4f},{:.4f}\n", r, i, frame.frame_time, frame.cpu_time, frame.gpu_time);
+			}
+
+			for (auto &metric : get_run_percentiles(frame_times, cpu_times, gpu_times))
+			{
+				summary += fmt::format("{},{},{},{},{},{},{},{},{},{:.4f},{:.4f},{:.4f},{:.4f}\n", r, run.app_id, run.configuration, run.extent.width, run.extent.height,
+				                       run.device_count, run.frames.size(), run.peak_memory, metric.first, metric.second.p50, metric.second.p95, metric.second.p99, metric.second.max);
+			}
+
+			for (auto &counter : run.counters)
+			{
+				counters += fmt::format("{},{},{:.4f}\n", r, counter.first, counter.second / run.frames.size());
+			}
+
+			memory += fmt::format("{},budget,{}\n", r, run.memory_budget);
+			for (uint32_t tag = 0; tag < vkb::allocated::MEMORY_TAG_COUNT; tag++)
+			{
+				memory += fmt::format("{},{},{}\n", r, vkb::allocated::to_string(static_cast<vkb::allocated::MemoryTag>(tag)), run.peak_tagged_memory[tag]);
+			}
+
+			thermal += fmt::format("{},{},{:.4f}\n", r, run.peak_thermal_status, run.peak_thermal_headroom);
+
+			for (size_t b = 0; b < vkb::BOTTLENECK_COUNT; b++)
+			{
+				bottleneck += fmt::format("{},{},{}\n", r, vkb::to_string(static_cast<vkb::Bottleneck>(b)), run.bottleneck_frames[b]);
+			}
+
+			for (auto &pass : run.heaviest_passes)
+			{
+				passes += fmt::format("{},{},{}\n", r, pass.first, pass.second);
+			}
+		}
+
+		file << summary << "\n"
+		     << counters << "\n"
+		     << memory << "\n"
+		     << thermal << "\n"
+		     << bottleneck << "\n"
+		     << passes << "\n"
+		     << frames;
+	}
+	else
+	{
+		file << "{\n";
+		file << fmt::format("  \"warmup_frames\": {},\n", warmup_frames);
+		file << "  \"frame_columns\": [\"frame_time\", \"cpu_time\", \"gpu_time\"],\n";
+		file << "  \"runs\": [\n";
+
+		for (size_t r = 0; r < runs.size(); r++)
+		{
+			auto &run = runs[r];
+
+			std::vector<double> frame_times, cpu_times, gpu_times;
+			for (auto &frame : run.frames)
+			{
+				frame_times.push_back(frame.frame_time);
+				cpu_times.push_back(frame.cpu_time);
+				gpu_times.push_back(frame.gpu_time);
+			}
+
+			std::vector<uint32_t> histogram(static_cast<size_t>(HISTOGRAM_MAX / HISTOGRAM_BIN_WIDTH) + 1, 0);
+			for (auto &frame : run.frames)
+			{
+				histogram[std::min(static_cast<size_t>(frame.frame_time / HISTOGRAM_BIN_WIDTH), histogram.size() - 1)]++;
+			}
+
+			file << "    {\n";
+			file << fmt::format("      \"sample\": \"{}\",\n", run.app_id);
+			file << fmt::format("      \"configuration\": {},\n", run.configuration);
+			file << fmt::format("      \"width\": {},\n", run.extent.width);
+			file << fmt::format("      \"height\": {},\n", run.extent.height);
+			file << fmt::format("      \"devices\": {},\n", run.device_count);
+			file << fmt::format("      \"frames\": {},\n", run.frames.size());
+			file << fmt::format("      \"elapsed_time\": {:.4f},\n", run.elapsed_time);
+			file << fmt::format("      \"peak_memory\": {},\n", run.peak_memory);
+			file << fmt::format("      \"memory_budget\": {},\n", run.memory_budget);
+
+			file << "      \"tagged_memory\": {";
+			for (uint32_t tag = 0; tag < vkb::allocated::MEMORY_TAG_COUNT; tag++)
+			{
+				file << fmt::format("{}\"{}\": {}", tag > 0 ? ", " : "", vkb::allocated::to_string(static_cast<vkb::allocated::MemoryTag>(tag)), run.peak_tagged_memory[tag]);
+			}
+			file << "},\n";
+
+			file << fmt::format("      \"peak_thermal_status\": {},\n", run.peak_thermal_status);
+			file << fmt::format("      \"peak_thermal_headroom\": {:.4f},\n", run.peak_thermal_headroom);
+
+			file << "      \"bottleneck_frames\": {";
+			for (size_t b = 0; b < vkb::BOTTLENECK_COUNT; b++)
+			{
+				file << fmt::format("{}\"{}\": {}", b > 0 ? ", " : "", vkb::to_string(static_cast<vkb::Bottleneck>(b)), run.bottleneck_frames[b]);
+			}
+			file << "},\n";
+
+			file << "      \"heaviest_passes\": {";
+			for (size_t i = 0; i < run.heaviest_passes.size(); i++)
+			{
+				file << fmt::format("{}\"{}\": {}", i > 0 ? ", " : "", run.heaviest_passes[i].first, run.heaviest_passes[i].second);
+			}
+			file << "},\n";
+
+			for (auto &metric : get_run_percentiles(frame_times, cpu_times, gpu_times))
+			{
+				file << fmt::format("      \"{}\": {{\"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f}}},\n",
+				                    metric.first, metric.second.p50, metric.second.p95, metric.second.p99, metric.second.max);
+			}
+
+			file << "      \"counters\": {";
+			for (size_t i = 0; i < run.counters.size(); i++)
+			{
+				file << fmt::format("{}\"{}\": {:.4f}", i > 0 ? ", " : "", run.counters[i].first, run.counters[i].second / run.frames.size());
+			}
+			file << "},\n";
+
+			file << fmt::format("      \"histogram\": {{\"bin_width\": {:.1f}, \"counts\": [", HISTOGRAM_BIN_WIDTH);
+			for (size_t i = 0; i < histogram.size(); i++)
+			{
+				file << (i > 0 ? ", " : "") << histogram[i];
+			}
+			file << "]},\n";
+
+			file << "      \"frame_times\": [\n";
+			for (size_t i = 0; i < run.frames.size(); i++)
+			{
+				auto &frame = run.frames[i];
+				file << fmt::format("        [{:.4f}, {:.4f}, {:.4f}]{}\n", frame.frame_time, frame.cpu_time, frame.gpu_time, i + 1 < run.frames.size() ? "," : "");
+			}
+			file << "      ]\n";
+			file << (r + 1 < runs.size() ? "    },\n" : "    }\n");
+		}
+
+		file << "  ]\n";
+		file << "}\n";
+	}
+
+	LOGI("Benchmark output written to {}", output_path);
 }
 }        // namespace plugins
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,7 +17,13 @@
 
 #pragma once
 
+#include <array>
+
+#include "common/vk_common.h"
+#include "core/allocated.h"
 #include "platform/plugins/plugin_base.h"
+#include "stats/bottleneck.h"
+#include "timer.h"
 
 namespace plugins
 {
@@ -30,7 +36,22 @@ using BenchmarkModeTags = vkb::PluginBase<BenchmarkMode, vkb::tags::Passive>;
  * 
  * When enabled frame time statistics of a samples run will be printed to the console when an application closes. The simulation frame time (delta time) is also locked to 60FPS so that statistics can be compared more accurately across different devices.
  * 
+ * Each frame captures its frame time, its CPU time from the update to the end of its submission, and the GPU time of the frame retiring
+ * at its start, which lags by the frames in flight. The warm-up frames are excluded from the captures and their percentiles.
+ * A run is the frames of one configuration of a sample at one swapchain extent, so combined with the batch mode each sample,
+ * configuration and resolution gets a run of its own, with its own warm-up. Each run also gets the means of the stats requested
+ * by the sample, like the GPU counters, the mean GPU time of each pass, and the peak memory used from the heaps of the device.
+ * Where the device calibrates its timestamps, the runs also get the means of the frame timeline: how many frames the CPU is
+ * ahead of the GPU, and how long the GPU idles between frames, waiting for the CPU or for semaphores.
+ * Each captured frame is also classified by its bottleneck, and the runs count the frames of each bottleneck and the frames
+ * each pass was the heaviest of.
+ *
+ * The output file gets every run: its percentiles, counters, peak memory, a histogram of the frame times and the per-frame captures,
+ * as CSV if its extension is .csv, as JSON otherwise. It is rewritten each time an app closes.
+ * 
  * Usage: vulkan_samples sample afbc --benchmark
+ *        vulkan_samples sample afbc --benchmark --benchmark-warmup 60 --benchmark-output afbc.json
+ *        vulkan_samples batch --category performance --resolution 1280x720 1920x1080 --benchmark --benchmark-output report.json
  * 
  */
 class BenchmarkMode : public BenchmarkModeTags
@@ -50,11 +71,149 @@ class BenchmarkMode : public BenchmarkModeTags
 
 	virtual void on_app_close(const std::string &app_info) override;
 
-	vkb::FlagCommand benchmark_flag = {vkb::FlagType::FlagOnly, "benchmark", "", "Enable benchmark mode"};
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
+	vkb::FlagCommand benchmark_flag        = {vkb::FlagType::FlagOnly, "benchmark", "", "Enable benchmark mode"};
+	vkb::FlagCommand benchmark_warmup_flag = {vkb::FlagType::OneValue, "benchmark-warmup", "", "Number of frames excluded from the frame time statistics"};
+	vkb::FlagCommand benchmark_output_flag = {vkb::FlagType::OneValue, "benchmark-output", "", "Write the frame time statistics to a .json or .csv file"};
+
+	/// Width of the frame time histogram bins, in milliseconds
+	static constexpr double HISTOGRAM_BIN_WIDTH = 1.0;
+
+	/// Frame times from this one on go to the last histogram bin, in milliseconds
+	static constexpr double HISTOGRAM_MAX = 100.0;
+
+	/// Nearest rank percentiles of a time, in milliseconds
+	struct Percentiles
+	{
+		double p50{0.0};
+
+		double p95{0.0};
+
+		double p99{0.0};
+
+		double max{0.0};
+	};
+
+	/// The worst measurements of the runs of the last app, see get_app_summary()
+	struct AppSummary
+	{
+		/// Captured frames over all runs
+		size_t frames{0};
+
+		/// Highest 95th percentile of the frame times of a run, in milliseconds
+		double frame_time_p95{0.0};
+
+		/// Peak memory used from the heaps of the device over all runs, in bytes
+		VkDeviceSize peak_memory{0};
+	};
+
+	/**
+	 * @brief Summarizes the runs of the last app, e.g. to check them against its performance budget, see StartTest
+	 */
+	AppSummary get_app_summary() const;
 
   private:
+	/// Times of a frame in milliseconds, 0 if not measured
+	struct FrameTimes
+	{
+		double frame_time{0.0};
+
+		double cpu_time{0.0};
+
+		double gpu_time{0.0};
+	};
+
+	/// The frames of one configuration of an app at one swapchain extent
+	struct Run
+	{
+		std::string app_id;
+
+		uint32_t configuration{0};
+
+		VkExtent2D extent{0, 0};
+
+		/// Physical devices the frames are spread over, more than one over a device group
+		uint32_t device_count{1};
+
+		/// Frames of the run, including the warm-up ones
+		uint32_t total_frames{0};
+
+		float elapsed_time{0.0f};
+
+		std::vector<FrameTimes> frames;
+
+		/// Sums of the stats of the captured frames, by stat name
+		std::vector<std::pair<std::string, double>> counters;
+
+		/// Peak memory used from the heaps of the device, in bytes
+		VkDeviceSize peak_memory{0};
+
+		/// Budget of the heaps of the device when the memory peaked, in bytes
+		VkDeviceSize memory_budget{0};
+
+		/// Peak memory of the allocations of each subsystem, by allocated::MemoryTag, in bytes
+		std::array<VkDeviceSize, vkb::allocated::MEMORY_TAG_COUNT> peak_tagged_memory{};
+
+		/// Highest thermal status and headroom of the device during the run, negative if unknown, see Platform::get_thermal_status()
+		int32_t peak_thermal_status{-1};
+
+		float peak_thermal_headroom{-1.0f};
+
+		/// Captured frames with each bottleneck, by vkb::Bottleneck
+		std::array<uint32_t, vkb::BOTTLENECK_COUNT> bottleneck_frames{};
+
+		/// Captured frames each pass was the heaviest of, by pass name
+		std::vector<std::pair<std::string, uint32_t>> heaviest_passes;
+	};
+
+	/**
+	 * @brief Starts a new run if the configuration of the app or the swapchain extent changed
+	 */
+	void update_run(vkb::RenderContext &context);
+
+	/**
+	 * @brief Adds the last value of the stats requested by the app to the counters of the run
+	 */
+	void capture_counters(Run &run);
+
+	/**
+	 * @brief Counts the bottleneck and the heaviest pass of the frame in the run, see vkb::Stats::get_bottleneck()
+	 */
+	void capture_bottleneck(Run &run);
+
+	/**
+	 * @brief Adds the GPU time of each profiled scope, and its pipeline statistics if counted, to the counters of the run, see vkb::GpuProfiler
+	 */
+	void capture_gpu_scopes(Run &run, const vkb::RenderContext &context);
+
+	/**
+	 * @brief Adds the mean CPU frames ahead of the GPU, GPU idle and queue bubble times of the retired frames to the counters
+	 *        of the run, see vkb::FrameTimeline
+	 */
+	void capture_frame_timeline(Run &run, vkb::RenderContext &context);
+
+	void log_run(const Run &run) const;
+
+	void write_output() const;
+
 	uint32_t total_frames{0};
 
 	float elapsed_time{0.0f};
+
+	uint32_t warmup_frames{0};
+
+	std::string output_path;
+
+	vkb::Timer cpu_timer;
+
+	/// Whether the current frame is captured
+	bool capturing{false};
+
+	/// Whether the GPU frame timing of the render context of the app was enabled
+	bool gpu_frame_timing{false};
+
+	/// Runs of every app since the platform started
+	std::vector<Run> runs;
 };
-}        // namespace plugins
\ No newline at end of file
+}        // namespace plugins
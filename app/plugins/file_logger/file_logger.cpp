@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2024, Arm Limited and Contributors
+/* Copyright (c) 2021-2026, Arm Limited and Contributors
  * Copyright (c) 2021-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -19,6 +19,7 @@
 #include "file_logger.h"
 
 #include "apps.h"
+#include "core/util/logging.hpp"
 
 #include <fmt/format.h>
 #include <spdlog/sinks/basic_file_sink.h>
@@ -45,7 +46,7 @@ void FileLogger::init(const vkb::CommandParser &parser)
 		if (spdlog::default_logger())
 		{
 			std::string log_file_name = parser.as<std::string>(&log_file_flag);
-			spdlog::default_logger()->sinks().push_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_file_name, true));
+			vkb::logging::add_sink(std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_file_name, true));
 		}
 	}
 }
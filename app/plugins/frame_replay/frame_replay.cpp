@@ -0,0 +1,221 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include <fmt/format.h>
+
+#include "platform/platform.h"
+#include "rendering/render_context.h"
+
+namespace plugins
+{
+namespace
+{
+struct Percentiles
+{
+	double mean{0.0};
+
+	double p50{0.0};
+
+	double p95{0.0};
+
+	double p99{0.0};
+
+	double max{0.0};
+};
+
+/**
+ * @brief Nearest rank percentiles of the measured times, the ones which are 0 were not measured
+ */
+Percentiles get_percentiles(std::vector<double> times)
+{
+	times.erase(std::remove(times.begin(), times.end(), 0.0), times.end());
+
+	if (times.empty())
+	{
+		return {};
+	}
+
+	std::sort(times.begin(), times.end());
+
+	auto percentile = [&times](double p) {
+		size_t rank = static_cast<size_t>(std::ceil(p * times.size()));
+		return times[std::max<size_t>(rank, 1) - 1];
+	};
+
+	double sum = 0.0;
+	for (double time : times)
+	{
+		sum += time;
+	}
+
+	return {sum / times.size(), percentile(0.50), percentile(0.95), percentile(0.99), times.back()};
+}
+}        // namespace
+
+FrameReplay::FrameReplay() :
+    FrameReplayTags("Frame Replay",
+                    "Capture the frames in flight and submit them again, to measure the GPU and the submission alone.",
+                    {vkb::Hook::OnAppStart, vkb::Hook::OnAppClose, vkb::Hook::PostDraw},
+                    {&replay_frames_flag, &replay_warmup_flag, &replay_output_flag})
+{
+}
+
+bool FrameReplay::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&replay_frames_flag);
+}
+
+void FrameReplay::init(const vkb::CommandParser &parser)
+{
+	replay_frames = parser.as<uint32_t>(&replay_frames_flag);
+
+	if (parser.contains(&replay_warmup_flag))
+	{
+		warmup_frames = parser.as<uint32_t>(&replay_warmup_flag);
+	}
+
+	if (parser.contains(&replay_output_flag))
+	{
+		output_path = parser.as<std::string>(&replay_output_flag);
+	}
+
+	// The replay measures the GPU, so it goes on without focus
+	platform->force_render(true);
+}
+
+void FrameReplay::on_app_start(const std::string &app_id_)
+{
+	app_id          = app_id_;
+	state           = State::Warmup;
+	rendered_frames  = 0;
+	capturing_frames = 0;
+	captured_frames  = 0;
+	submit_times.clear();
+	gpu_times.clear();
+}
+
+void FrameReplay::on_app_close(const std::string &app_id_)
+{
+	if (state == State::Replaying)
+	{
+		finish_replay();
+	}
+}
+
+void FrameReplay::on_post_draw(vkb::RenderContext &context)
+{
+	switch (state)
+	{
+		case State::Warmup:
+			// The timestamps are written by the captured command buffers, so the timing is enabled before the capture
+			if (rendered_frames == 0)
+			{
+				context.set_gpu_frame_timing(true);
+			}
+
+			if (++rendered_frames >= warmup_frames)
+			{
+				context.begin_frame_capture();
+				state = State::Capturing;
+			}
+			break;
+
+		case State::Capturing:
+			if (context.has_frame_capture())
+			{
+				captured_frames = static_cast<uint32_t>(context.get_render_frames().size());
+				context.take_gpu_frame_time();
+				state = State::Replaying;
+			}
+			else if (!context.is_capturing_frames() || ++capturing_frames > MAX_CAPTURE_FRAMES)
+			{
+				LOGE("The frames of {} could not be captured for replay", app_id);
+				context.end_frame_capture();
+				state = State::Done;
+			}
+			break;
+
+		case State::Replaying:
+			if (!context.has_frame_capture())
+			{
+				LOGW("The capture was dropped after {} replayed frames", submit_times.size());
+				finish_replay();
+				break;
+			}
+
+			submit_times.push_back(context.get_replay_submit_time() * 1000.0);
+			gpu_times.push_back(context.take_gpu_frame_time() * 1000.0);
+
+			if (submit_times.size() >= replay_frames)
+			{
+				context.end_frame_capture();
+				finish_replay();
+			}
+			break;
+
+		case State::Done:
+			break;
+	}
+}
+
+void FrameReplay::finish_replay()
+{
+	state = State::Done;
+
+	auto submit = get_percentiles(submit_times);
+	auto gpu    = get_percentiles(gpu_times);
+
+	LOGI("Replayed {} captured frames of {} {} times", captured_frames, app_id, submit_times.size());
+	LOGI("submit_time: mean {:.3f} ms, p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms", submit.mean, submit.p50, submit.p95, submit.p99, submit.max);
+	LOGI("gpu_time: mean {:.3f} ms, p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms", gpu.mean, gpu.p50, gpu.p95, gpu.p99, gpu.max);
+
+	if (!output_path.empty())
+	{
+		write_output();
+	}
+}
+
+void FrameReplay::write_output() const
+{
+	std::ofstream file{output_path};
+	if (!file)
+	{
+		LOGE("Cannot write the replay output to {}", output_path);
+		return;
+	}
+
+	auto write_percentiles = [&file](const std::string &name, const Percentiles &percentiles, bool last) {
+		file << fmt::format("  \"{}\": {{\"mean\": {:.4f}, \"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f}}}{}\n",
+		                    name, percentiles.mean, percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max, last ? "" : ",");
+	};
+
+	file << "{\n";
+	file << fmt::format("  \"sample\": \"{}\",\n", app_id);
+	file << fmt::format("  \"warmup_frames\": {},\n", warmup_frames);
+	file << fmt::format("  \"captured_frames\": {},\n", captured_frames);
+	file << fmt::format("  \"replayed_frames\": {},\n", submit_times.size());
+	write_percentiles("submit_time", get_percentiles(submit_times), false);
+	write_percentiles("gpu_time", get_percentiles(gpu_times), true);
+	file << "}\n";
+}
+}        // namespace plugins
@@ -0,0 +1,109 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class FrameReplay;
+
+using FrameReplayTags = vkb::PluginBase<FrameReplay, vkb::tags::Passive>;
+
+/**
+ * @brief Frame Replay
+ *
+ * Captures the command buffers of a frame for each frame in flight, once the warm-up frames were rendered, and submits
+ * them again as they were a number of times, see vkb::RenderContext::begin_frame_capture(). The scene is not updated and
+ * nothing is recorded while replaying, so the times only vary with the GPU, the driver and the submission: the CPU time
+ * of each replayed submission and present, and the GPU time of each replayed frame, are reported as percentiles once
+ * the replays end, and written to a .json file if requested. The app then continues from the frame it was captured at.
+ *
+ * Only frames submitted with the render context, to its graphics queue alone, can be captured, which excludes the API
+ * samples. Resizing the window ends the replay.
+ *
+ * Usage: vulkan_samples sample afbc --replay-frames 1000
+ *        vulkan_samples sample afbc --replay-frames 1000 --replay-warmup 120 --replay-output afbc_replay.json --stop-after-frame 1200
+ *
+ */
+class FrameReplay : public FrameReplayTags
+{
+  public:
+	FrameReplay();
+
+	virtual ~FrameReplay() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_app_start(const std::string &app_id) override;
+
+	virtual void on_app_close(const std::string &app_id) override;
+
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
+	vkb::FlagCommand replay_frames_flag = {vkb::FlagType::OneValue, "replay-frames", "", "Capture the frames in flight and submit them again this many times"};
+	vkb::FlagCommand replay_warmup_flag = {vkb::FlagType::OneValue, "replay-warmup", "", "Number of frames rendered before the capture, 60 by default"};
+	vkb::FlagCommand replay_output_flag = {vkb::FlagType::OneValue, "replay-output", "", "Write the replayed frame times to a .json file"};
+
+	/// Frames rendered at most while capturing, as the frames of the apps submitting them themselves are never captured
+	static constexpr uint32_t MAX_CAPTURE_FRAMES{16};
+
+  private:
+	enum class State
+	{
+		Warmup,
+		Capturing,
+		Replaying,
+		Done
+	};
+
+	/**
+	 * @brief Logs the times of the replayed frames, and writes them to the output file
+	 */
+	void finish_replay();
+
+	void write_output() const;
+
+	uint32_t replay_frames{0};
+
+	uint32_t warmup_frames{60};
+
+	std::string output_path;
+
+	std::string app_id;
+
+	State state{State::Warmup};
+
+	uint32_t rendered_frames{0};
+
+	uint32_t capturing_frames{0};
+
+	uint32_t captured_frames{0};
+
+	/// CPU times of the submission and present of the replayed frames, in milliseconds
+	std::vector<double> submit_times;
+
+	/// GPU times of the replayed frames, in milliseconds, 0 if not measured
+	std::vector<double> gpu_times;
+};
+}        // namespace plugins
@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, Sascha Willems
+/* Copyright (c) 2023-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -44,5 +44,11 @@ void GpuSelection::init(const vkb::CommandParser &parser)
 		vkb::Instance::selected_gpu_index          = parser.as<uint32_t>(&selected_gpu_index);
 		vkb::core::HPPInstance::selected_gpu_index = parser.as<uint32_t>(&selected_gpu_index);
 	}
+
+	if (parser.contains(&device_group))
+	{
+		vkb::Instance::use_device_group          = true;
+		vkb::core::HPPInstance::use_device_group = true;
+	}
 }
 }        // namespace plugins
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, Sascha Willems
+/* Copyright (c) 2023-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -44,6 +44,8 @@ class GpuSelection : public GpuSelectionTags
 
 	vkb::FlagCommand selected_gpu_index = {vkb::FlagType::OneValue, "gpu", "", "Zero-based index of the GPU that the sample should use"};
 
-	vkb::CommandGroup gpu_selection_options_group = {"GPU selection Options", {&selected_gpu_index}};
+	vkb::FlagCommand device_group = {vkb::FlagType::FlagOnly, "device-group", "", "Create the device over the device group of the GPU, headless frames then alternate between its GPUs"};
+
+	vkb::CommandGroup gpu_selection_options_group = {"GPU selection Options", {&selected_gpu_index, &device_group}};
 };
 }        // namespace plugins
\ No newline at end of file
@@ -0,0 +1,174 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "offscreen_render.h"
+
+#include <fmt/format.h>
+
+#include "platform/platform.h"
+#include "rendering/hpp_render_context.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/transform.h"
+#include "scene_graph/node.h"
+#include "vulkan_sample.h"
+
+namespace plugins
+{
+OffscreenRender::OffscreenRender() :
+    OffscreenRenderTags("Offscreen Render",
+                        "Render a turntable of the scene to an image sequence, without presenting.",
+                        {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose, vkb::Hook::PostDraw},
+                        {&offscreen_render_flag, &offscreen_output_flag, &offscreen_frames_in_flight_flag})
+{
+}
+
+bool OffscreenRender::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&offscreen_render_flag);
+}
+
+void OffscreenRender::init(const vkb::CommandParser &parser)
+{
+	frame_count = parser.as<uint32_t>(&offscreen_render_flag);
+
+	if (parser.contains(&offscreen_output_flag))
+	{
+		output_prefix     = parser.as<std::string>(&offscreen_output_flag);
+		output_prefix_set = true;
+	}
+
+	if (parser.contains(&offscreen_frames_in_flight_flag))
+	{
+		frames_in_flight = std::max(parser.as<uint32_t>(&offscreen_frames_in_flight_flag), 1u);
+	}
+
+	// Without a swapchain, the frames are not paced by presentation
+	vkb::Window::OptionalProperties properties;
+	properties.mode = vkb::Window::Mode::Headless;
+	platform->set_window_properties(properties);
+
+	vkb::RenderContext::HEADLESS_FRAME_COUNT               = frames_in_flight;
+	vkb::rendering::HPPRenderContext::HEADLESS_FRAME_COUNT = frames_in_flight;
+
+	// The images depend on the frame number only, not on how fast they are rendered
+	platform->force_simulation_fps(60.0f);
+	platform->force_render(true);
+}
+
+void OffscreenRender::on_app_start(const std::string &app_info)
+{
+	current_frame = 0;
+	readback.reset();
+
+	if (!output_prefix_set)
+	{
+		output_prefix = app_info + "-turntable";
+	}
+
+	find_camera();
+
+	timer.start();
+}
+
+void OffscreenRender::on_app_close(const std::string &app_info)
+{
+	// Writes the frames in flight while the device still exists
+	readback.reset();
+	camera_node = nullptr;
+}
+
+void OffscreenRender::on_update(float delta_time)
+{
+	if (!camera_node || current_frame >= frame_count)
+	{
+		return;
+	}
+
+	// One turn around the vertical axis through the origin over the frames
+	float     angle     = glm::two_pi<float>() * static_cast<float>(current_frame) / static_cast<float>(frame_count);
+	glm::quat turn      = glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f));
+	auto     &transform = camera_node->get_transform();
+
+	transform.set_translation(turn * initial_translation);
+	transform.set_rotation(turn * initial_rotation);
+}
+
+void OffscreenRender::on_post_draw(vkb::RenderContext &context)
+{
+	if (!readback)
+	{
+		readback = std::make_unique<vkb::FrameReadback>(context, frames_in_flight);
+	}
+
+	readback->update();
+
+	if (current_frame >= frame_count)
+	{
+		return;
+	}
+
+	readback->capture(fmt::format("{}-{:05d}", output_prefix, current_frame));
+
+	if (++current_frame == frame_count)
+	{
+		readback->flush();
+
+		auto elapsed = timer.stop<vkb::Timer::Seconds>();
+		LOGI("[Offscreen Render] Wrote {} frames in {:.2f}s ({:.1f} FPS) on {} GPU(s)",
+		     frame_count, elapsed, elapsed > 0.0 ? frame_count / elapsed : 0.0, context.get_device().get_device_group_size());
+
+		platform->close();
+	}
+}
+
+void OffscreenRender::find_camera()
+{
+	camera_node = nullptr;
+
+	vkb::sg::Scene *scene = nullptr;
+	if (auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app()))
+	{
+		scene = vulkan_app->has_scene() ? &vulkan_app->get_scene() : nullptr;
+	}
+	else if (auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::Cpp> *>(&platform->get_app()))
+	{
+		scene = vulkan_app->has_scene() ? &vulkan_app->get_scene() : nullptr;
+	}
+
+	if (scene)
+	{
+		// Prefer the camera added by vkb::add_free_camera, which the samples render with
+		for (auto *camera : scene->get_components<vkb::sg::Camera>())
+		{
+			if (camera->get_node() && (!camera_node || camera->get_node()->get_name() == "main_camera"))
+			{
+				camera_node = camera->get_node();
+			}
+		}
+	}
+
+	if (!camera_node)
+	{
+		LOGW("[Offscreen Render] The sample has no scene camera, the frames are rendered without a turntable");
+		return;
+	}
+
+	initial_translation = camera_node->get_transform().get_translation();
+	initial_rotation    = camera_node->get_transform().get_rotation();
+}
+}        // namespace plugins
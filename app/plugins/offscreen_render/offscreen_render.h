@@ -0,0 +1,104 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "common/glm_common.h"
+#include "platform/plugins/plugin_base.h"
+#include "rendering/frame_readback.h"
+#include "timer.h"
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+}
+}        // namespace vkb
+
+namespace plugins
+{
+class OffscreenRender;
+
+using OffscreenRenderTags = vkb::PluginBase<OffscreenRender, vkb::tags::Passive>;
+
+/**
+ * @brief Offscreen Render
+ *
+ * Renders a turntable of the scene of a sample to an image sequence, as fast as the GPU allows, then closes the sample.
+ * The camera orbits the vertical axis through the origin once over the frames, starting from its initial transform.
+ *
+ * The window is headless, and several offscreen frames are in flight: while the GPU renders a frame, the previous ones
+ * are copied to readback buffers and encoded to PNG files on a worker thread, see FrameReadback. The simulation runs at
+ * a fixed 60 FPS, so the images do not depend on the rendering speed.
+ *
+ * Usage: vulkan_samples sample afbc --offscreen-render 360
+ *        vulkan_samples sample afbc --offscreen-render 360 --offscreen-output turntable/afbc --offscreen-frames-in-flight 4
+ *
+ */
+class OffscreenRender : public OffscreenRenderTags
+{
+  public:
+	OffscreenRender();
+
+	virtual ~OffscreenRender() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_update(float delta_time) override;
+
+	virtual void on_app_start(const std::string &app_info) override;
+
+	virtual void on_app_close(const std::string &app_info) override;
+
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
+	vkb::FlagCommand offscreen_render_flag           = {vkb::FlagType::OneValue, "offscreen-render", "", "Render a turntable of the given number of frames offscreen to images"};
+	vkb::FlagCommand offscreen_output_flag           = {vkb::FlagType::OneValue, "offscreen-output", "", "Prefix of the image files, followed by the frame number"};
+	vkb::FlagCommand offscreen_frames_in_flight_flag = {vkb::FlagType::OneValue, "offscreen-frames-in-flight", "", "Number of frames rendered, read back and encoded at once"};
+
+	static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 3;
+
+  private:
+	uint32_t frame_count{0};
+
+	uint32_t frames_in_flight{DEFAULT_FRAMES_IN_FLIGHT};
+
+	uint32_t current_frame{0};
+
+	bool output_prefix_set{false};
+
+	std::string output_prefix;
+
+	/// Node of the camera moved along the turntable, and its transform before the first frame
+	vkb::sg::Node *camera_node{nullptr};
+
+	glm::vec3 initial_translation{0.0f};
+
+	glm::quat initial_rotation{1.0f, 0.0f, 0.0f, 0.0f};
+
+	std::unique_ptr<vkb::FrameReadback> readback;
+
+	vkb::Timer timer;
+
+	void find_camera();
+};
+}        // namespace plugins
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -27,8 +27,8 @@ namespace plugins
 Screenshot::Screenshot() :
     ScreenshotTags("Screenshot",
                    "Save a screenshot of a specific frame",
-                   {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::PostDraw},
-                   {&screenshot_flag, &screenshot_output_flag})
+                   {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose, vkb::Hook::PostDraw},
+                   {&screenshot_flag, &screenshot_output_flag, &screenshot_interval_flag})
 {
 }
 
@@ -48,6 +48,11 @@ void Screenshot::init(const vkb::CommandParser &parser)
 			output_path     = parser.as<std::string>(&screenshot_output_flag);
 			output_path_set = true;
 		}
+
+		if (parser.contains(&screenshot_interval_flag))
+		{
+			frame_interval = parser.as<uint32_t>(&screenshot_interval_flag);
+		}
 	}
 }
 
@@ -62,9 +67,26 @@ void Screenshot::on_app_start(const std::string &name)
 	current_frame    = 0;
 }
 
+void Screenshot::on_app_close(const std::string &app_id)
+{
+	// Writes the captures in flight while the device still exists
+	readback.reset();
+}
+
 void Screenshot::on_post_draw(vkb::RenderContext &context)
 {
-	if (current_frame == frame_number)
+	if (readback)
+	{
+		readback->update();
+	}
+
+	bool capture_frame = current_frame == frame_number;
+	if (frame_interval > 0 && current_frame > frame_number)
+	{
+		capture_frame = (current_frame - frame_number) % frame_interval == 0;
+	}
+
+	if (capture_frame)
 	{
 		if (!output_path_set)
 		{
@@ -82,7 +104,17 @@ void Screenshot::on_post_draw(vkb::RenderContext &context)
 			output_path = stream.str();
 		}
 
-		screenshot(context, output_path);
+		std::string filename = output_path;
+		if (frame_interval > 0)
+		{
+			filename += "-" + std::to_string(current_frame);
+		}
+
+		if (!readback)
+		{
+			readback = std::make_unique<vkb::FrameReadback>(context);
+		}
+		readback->capture(filename);
 	}
 }
 }        // namespace plugins
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -19,6 +19,7 @@
 
 #include "filesystem/legacy.h"
 #include "platform/plugins/plugin_base.h"
+#include "rendering/frame_readback.h"
 
 namespace plugins
 {
@@ -30,8 +31,11 @@ using ScreenshotTags = vkb::PluginBase<Screenshot, vkb::tags::Passive>;
  * @brief Screenshot
  *
  * Capture a screen shot of the last rendered image at a given frame. The output can also be named
+ * With an interval, a screenshot is captured every interval frames from that frame on, the frame number being appended
+ * to the output name. Captures are read back and encoded asynchronously, so they do not stall the frames.
  *
  * Usage: vulkan_sample sample afbc --screenshot 1 --screenshot-output afbc-screenshot
+ *        vulkan_sample sample afbc --screenshot 100 --screenshot-interval 10
  *
  */
 class Screenshot : public ScreenshotTags
@@ -49,17 +53,23 @@ class Screenshot : public ScreenshotTags
 
 	virtual void on_app_start(const std::string &app_info) override;
 
+	virtual void on_app_close(const std::string &app_id) override;
+
 	virtual void on_post_draw(vkb::RenderContext &context) override;
 
-	vkb::FlagCommand screenshot_flag        = {vkb::FlagType::OneValue, "screenshot", "", "Take a screenshot at a given frame"};
-	vkb::FlagCommand screenshot_output_flag = {vkb::FlagType::OneValue, "screenshot-output", "", "Declare an output name for the image"};
+	vkb::FlagCommand screenshot_flag          = {vkb::FlagType::OneValue, "screenshot", "", "Take a screenshot at a given frame"};
+	vkb::FlagCommand screenshot_output_flag   = {vkb::FlagType::OneValue, "screenshot-output", "", "Declare an output name for the image"};
+	vkb::FlagCommand screenshot_interval_flag = {vkb::FlagType::OneValue, "screenshot-interval", "", "Take a screenshot every given number of frames"};
 
   private:
 	uint32_t    current_frame = 0;
 	uint32_t    frame_number;
+	uint32_t    frame_interval = 0;
 	std::string current_app_name;
 
 	bool        output_path_set = false;
 	std::string output_path;
+
+	std::unique_ptr<vkb::FrameReadback> readback;
 };
 }        // namespace plugins
\ No newline at end of file
@@ -0,0 +1,65 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shader_bundle.h"
+
+#include "shader_cache.h"
+
+namespace plugins
+{
+ShaderBundle::ShaderBundle() :
+    ShaderBundleTags("Shader Bundle",
+                     "Precompile the shaders used by the samples into a shader bundle, or load one",
+                     {vkb::Hook::OnPlatformClose}, {&output_flag, &optimizer_flag, &input_flag})
+{
+}
+
+bool ShaderBundle::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&output_flag) || parser.contains(&input_flag);
+}
+
+void ShaderBundle::init(const vkb::CommandParser &parser)
+{
+	auto &shader_cache = vkb::ShaderCache::get();
+
+	if (parser.contains(&input_flag))
+	{
+		shader_cache.load_bundle(parser.as<std::string>(&input_flag));
+	}
+
+	if (parser.contains(&output_flag))
+	{
+		output_path = parser.as<std::string>(&output_flag);
+
+		if (parser.contains(&optimizer_flag))
+		{
+			optimizer_path = parser.as<std::string>(&optimizer_flag);
+		}
+
+		shader_cache.set_bundle_recording(true);
+	}
+}
+
+void ShaderBundle::on_platform_close()
+{
+	if (!output_path.empty())
+	{
+		vkb::ShaderCache::get().write_bundle(output_path, optimizer_path);
+	}
+}
+}        // namespace plugins
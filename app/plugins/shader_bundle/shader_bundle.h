@@ -0,0 +1,64 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class ShaderBundle;
+
+using ShaderBundleTags = vkb::PluginBase<ShaderBundle, vkb::tags::Passive>;
+
+/**
+ * @brief Shader Bundle
+ *
+ * Packs the compiled SPIR-V and reflection results of every shader the samples use during the run into a single
+ * bundle file when the platform closes, optionally optimized with spirv-opt. A bundle can also be loaded at startup,
+ * so that its shaders are not compiled. See vkb::ShaderCache.
+ *
+ * Builds with VKB_SHADER_BUNDLE_ONLY load shaders/shaders.vksb, which the vkb__shader_bundle target writes.
+ *
+ * Usage: vulkan_samples batch --category performance --duration 3 --shader-bundle-output shaders/shaders.vksb
+ *
+ */
+class ShaderBundle : public ShaderBundleTags
+{
+  public:
+	ShaderBundle();
+
+	virtual ~ShaderBundle() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_platform_close() override;
+
+	vkb::FlagCommand output_flag = {vkb::FlagType::OneValue, "shader-bundle-output", "", "Write the shaders used during the run to a shader bundle"};
+
+	vkb::FlagCommand optimizer_flag = {vkb::FlagType::OneValue, "shader-bundle-optimizer", "", "Path of spirv-opt, to optimize the shaders of the bundle"};
+
+	vkb::FlagCommand input_flag = {vkb::FlagType::OneValue, "shader-bundle", "", "Load the shaders of a shader bundle instead of compiling them"};
+
+  private:
+	std::string output_path;
+
+	std::string optimizer_path;
+};
+}        // namespace plugins
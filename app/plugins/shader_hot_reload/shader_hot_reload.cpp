@@ -0,0 +1,51 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shader_hot_reload.h"
+
+#include "core/device.h"
+#include "rendering/render_context.h"
+
+namespace plugins
+{
+ShaderHotReload::ShaderHotReload() :
+    ShaderHotReloadTags("Shader Hot Reload",
+                        "Compile the shaders of a sample again when their source files change",
+                        {vkb::Hook::PostDraw}, {&hot_reload_flag})
+{
+}
+
+bool ShaderHotReload::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&hot_reload_flag);
+}
+
+void ShaderHotReload::init(const vkb::CommandParser &parser)
+{
+}
+
+void ShaderHotReload::on_post_draw(vkb::RenderContext &context)
+{
+	// The device of the app is only known once it draws, and a batch run switches between apps
+	auto &resource_cache = context.get_device().get_resource_cache();
+	if (!resource_cache.is_shader_hot_reload_enabled())
+	{
+		LOGI("Shader hot reload enabled");
+		resource_cache.set_shader_hot_reload(true);
+	}
+}
+}        // namespace plugins
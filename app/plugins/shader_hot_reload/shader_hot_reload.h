@@ -0,0 +1,55 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class ShaderHotReload;
+
+using ShaderHotReloadTags = vkb::PluginBase<ShaderHotReload, vkb::tags::Passive>;
+
+/**
+ * @brief Shader Hot Reload
+ *
+ * Compiles the GLSL shaders of a sample again when their files under shaders/ are edited, without restarting it.
+ * The files are polled in the background, and the new shaders are used from the next frame once they compiled.
+ * Errors are logged and the previous shaders are kept. See vkb::ResourceCache::set_shader_hot_reload().
+ *
+ * Only the shaders requested through the resource cache of the render context of a sample are reloaded.
+ *
+ * Usage: vulkan_samples sample afbc --hot-reload-shaders
+ *
+ */
+class ShaderHotReload : public ShaderHotReloadTags
+{
+  public:
+	ShaderHotReload();
+
+	virtual ~ShaderHotReload() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
+	vkb::FlagCommand hot_reload_flag = {vkb::FlagType::FlagOnly, "hot-reload-shaders", "", "Compile the shaders again when their files change"};
+};
+}        // namespace plugins
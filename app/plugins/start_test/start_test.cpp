@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,14 +17,19 @@
 
 #include "start_test.h"
 
+#include <fmt/format.h>
+
 #include "apps.h"
+#include "benchmark_mode/benchmark_mode.h"
+#include "platform/platform.h"
+#include "vulkan_sample.h"
 
 namespace plugins
 {
 StartTest::StartTest() :
     StartTestTags("Tests",
                   "A collection of flags to run tests.",
-                  {}, {&test_subcmd})
+                  {vkb::Hook::OnAppClose}, {&test_subcmd})
 {
 }
 
@@ -44,4 +49,89 @@ void StartTest::init(const vkb::CommandParser &parser)
 		}
 	}
 }
+
+void StartTest::on_app_close(const std::string &app_id)
+{
+	auto *sample = apps::get_sample(app_id);
+	if (!sample || sample->budget.empty())
+	{
+		return;
+	}
+
+	auto &budget = sample->budget;
+
+	auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app());
+	if (!vulkan_app || !vulkan_app->has_device())
+	{
+		LOGW("The performance budget of {} is only checked for samples using the C bindings", app_id);
+		return;
+	}
+
+	std::string device_name = vulkan_app->get_device().get_gpu().get_properties().deviceName;
+	if (!budget.device.empty() && device_name.find(budget.device) == std::string::npos)
+	{
+		LOGI("The performance budget of {} is set for {}, it is not checked on {}", app_id, budget.device, device_name);
+		return;
+	}
+
+	std::vector<std::string> exceeded;
+
+	float load_time = platform->get_app_load_time();
+	if (budget.load_time > 0.0 && load_time > budget.load_time)
+	{
+		exceeded.push_back(fmt::format("load time {:.2f} s, budget {:.2f} s", load_time, budget.load_time));
+	}
+
+	if (budget.pipeline_count > 0)
+	{
+		auto  &state          = vulkan_app->get_device().get_resource_cache().get_internal_state();
+		size_t pipeline_count = state.graphics_pipelines.size() + state.compute_pipelines.size();
+		if (pipeline_count > budget.pipeline_count)
+		{
+			exceeded.push_back(fmt::format("{} pipelines, budget {}", pipeline_count, budget.pipeline_count));
+		}
+	}
+
+	// Frame times and memory are only measured by the benchmark mode, which also runs the sample at a fixed simulation rate
+	if (budget.frame_time_p95 > 0.0 || budget.peak_memory > 0.0)
+	{
+		if (!platform->using_plugin<BenchmarkMode>())
+		{
+			LOGW("The frame time and memory budgets of {} are only checked in benchmark mode (--benchmark)", app_id);
+		}
+		else
+		{
+			auto summary = platform->get_plugin<BenchmarkMode>()->get_app_summary();
+
+			double peak_memory = summary.peak_memory / (1024.0 * 1024.0);
+
+			if (summary.frames == 0)
+			{
+				LOGW("No frames of {} were captured to check its frame time budget", app_id);
+			}
+			else if (budget.frame_time_p95 > 0.0 && summary.frame_time_p95 > budget.frame_time_p95)
+			{
+				exceeded.push_back(fmt::format("p95 frame time {:.2f} ms, budget {:.2f} ms", summary.frame_time_p95, budget.frame_time_p95));
+			}
+
+			if (budget.peak_memory > 0.0 && peak_memory > budget.peak_memory)
+			{
+				exceeded.push_back(fmt::format("peak memory {:.1f} MiB, budget {:.1f} MiB", peak_memory, budget.peak_memory));
+			}
+		}
+	}
+
+	if (exceeded.empty())
+	{
+		LOGI("{} is within its performance budget on {}", app_id, device_name);
+		return;
+	}
+
+	for (auto &value : exceeded)
+	{
+		LOGE("{} is over its performance budget on {}: {}", app_id, device_name, value);
+	}
+
+	platform->set_last_error(fmt::format("{} is over its performance budget", app_id));
+}
 }        // namespace plugins
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -27,8 +27,14 @@ using StartTestTags = vkb::PluginBase<vkb::tags::Entrypoint>;
  * @brief Start Test
  * 
  * Start a given test. Used by system_test.py
+ *
+ * A sample run as a test is also held to the performance budget declared with its CMake registration, see add_sample in
+ * sample_helper.cmake. When the sample closes, its load time and pipeline count are checked, and in benchmark mode the
+ * 95th percentile of its frame times and its peak device memory too. Budgets set for a device are only checked on the GPUs
+ * whose name contains it. The values over budget are logged as errors and fail the run.
  * 
  * Usage: vulkan_sample test bonza
+ *        vulkan_sample test afbc --benchmark --benchmark-warmup 60 --stop-after-frame 600
  * 
  */
 class StartTest : public StartTestTags
@@ -42,6 +48,8 @@ class StartTest : public StartTestTags
 
 	virtual void init(const vkb::CommandParser &parser) override;
 
+	virtual void on_app_close(const std::string &app_id) override;
+
 	vkb::PositionalCommand test_cmd    = {"test_id", "An ID of the test to run"};
 	vkb::SubCommand        test_subcmd = {"test", "Run a specific test", {&test_cmd}};
 };
@@ -0,0 +1,491 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "telemetry_stream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if !defined(_WIN32)
+#	include <fcntl.h>
+#	include <netinet/in.h>
+#	include <netinet/tcp.h>
+#	include <poll.h>
+#	include <sys/socket.h>
+#	include <sys/time.h>
+#	include <unistd.h>
+#endif
+
+#include "core/allocated.h"
+#include "core/util/logging.hpp"
+#include "core/util/profiling.hpp"
+#include "platform/platform.h"
+#include "rendering/render_context.h"
+#include "vulkan_sample.h"
+
+namespace plugins
+{
+namespace
+{
+/// Size of the header of a packet: magic, version, type and payload size
+constexpr size_t PACKET_HEADER_SIZE = 12;
+
+void write_u8(std::vector<uint8_t> &buffer, uint8_t value)
+{
+	buffer.push_back(value);
+}
+
+void write_u16(std::vector<uint8_t> &buffer, uint16_t value)
+{
+	buffer.push_back(static_cast<uint8_t>(value));
+	buffer.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void write_u32(std::vector<uint8_t> &buffer, uint32_t value)
+{
+	write_u16(buffer, static_cast<uint16_t>(value));
+	write_u16(buffer, static_cast<uint16_t>(value >> 16));
+}
+
+void write_u64(std::vector<uint8_t> &buffer, uint64_t value)
+{
+	write_u32(buffer, static_cast<uint32_t>(value));
+	write_u32(buffer, static_cast<uint32_t>(value >> 32));
+}
+
+void write_f32(std::vector<uint8_t> &buffer, float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	write_u32(buffer, bits);
+}
+
+/**
+ * @brief Starts a packet in an empty buffer, its payload size is written by end_packet()
+ */
+void begin_packet(std::vector<uint8_t> &buffer, TelemetryStream::PacketType type)
+{
+	buffer.clear();
+	write_u32(buffer, TelemetryStream::MAGIC);
+	write_u16(buffer, TelemetryStream::PROTOCOL_VERSION);
+	write_u16(buffer, static_cast<uint16_t>(type));
+	write_u32(buffer, 0);
+}
+
+void end_packet(std::vector<uint8_t> &buffer)
+{
+	uint32_t payload_size = static_cast<uint32_t>(buffer.size() - PACKET_HEADER_SIZE);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		buffer[8 + i] = static_cast<uint8_t>(payload_size >> (8 * i));
+	}
+}
+
+TelemetryStream::PacketType get_packet_type(const std::vector<uint8_t> &packet)
+{
+	return static_cast<TelemetryStream::PacketType>(packet[6] | (packet[7] << 8));
+}
+
+/**
+ * @return The memory used from all heaps of the device and their budget, in bytes
+ */
+std::pair<VkDeviceSize, VkDeviceSize> get_memory_usage()
+{
+	auto &allocator = vkb::allocated::get_memory_allocator();
+	if (allocator == VK_NULL_HANDLE)
+	{
+		return {0, 0};
+	}
+
+	const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+	vmaGetMemoryProperties(allocator, &memory_properties);
+
+	std::vector<VmaBudget> budgets(memory_properties->memoryHeapCount);
+	vmaGetHeapBudgets(allocator, budgets.data());
+
+	VkDeviceSize usage  = 0;
+	VkDeviceSize budget = 0;
+	for (auto &heap_budget : budgets)
+	{
+		usage += heap_budget.usage;
+		budget += heap_budget.budget;
+	}
+
+	return {usage, budget};
+}
+
+float to_megabytes(VkDeviceSize size)
+{
+	return static_cast<float>(static_cast<double>(size) / (1024.0 * 1024.0));
+}
+
+#if !defined(_WIN32)
+#	if defined(MSG_NOSIGNAL)
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#	else
+constexpr int SEND_FLAGS = 0;
+#	endif
+
+/// Time after which a client which stopped reading is disconnected
+constexpr int SEND_TIMEOUT_MS = 100;
+
+/// Time the sender thread waits for clients when there is nothing to send
+constexpr int IDLE_WAIT_MS = 10;
+
+/**
+ * @return Whether the whole packet was sent, false if the client disconnected or stopped reading
+ */
+bool send_packet(int client, const std::vector<uint8_t> &packet)
+{
+	size_t sent = 0;
+	while (sent < packet.size())
+	{
+		auto result = send(client, packet.data() + sent, packet.size() - sent, SEND_FLAGS);
+		if (result <= 0)
+		{
+			return false;
+		}
+		sent += static_cast<size_t>(result);
+	}
+	return true;
+}
+
+void configure_client(int client)
+{
+	// Accepted sockets inherit the non-blocking mode of the listening socket on some platforms
+	fcntl(client, F_SETFL, fcntl(client, F_GETFL, 0) & ~O_NONBLOCK);
+
+	int no_delay = 1;
+	setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+	timeval timeout{0, SEND_TIMEOUT_MS * 1000};
+	setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+#	if defined(SO_NOSIGPIPE)
+	int no_sigpipe = 1;
+	setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#	endif
+}
+#endif
+}        // namespace
+
+TelemetryStream::TelemetryStream() :
+    TelemetryStreamTags("Telemetry Stream",
+                        "Stream the stats, GPU scope times and memory usage to a remote dashboard.",
+                        {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::PostDraw, vkb::Hook::OnPlatformClose},
+                        {&telemetry_port_flag, &telemetry_rate_flag})
+{
+}
+
+TelemetryStream::~TelemetryStream()
+{
+	stop();
+}
+
+bool TelemetryStream::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&telemetry_port_flag);
+}
+
+void TelemetryStream::init(const vkb::CommandParser &parser)
+{
+	port = static_cast<uint16_t>(parser.as<uint32_t>(&telemetry_port_flag));
+
+	if (parser.contains(&telemetry_rate_flag))
+	{
+		sample_interval = 1.0f / std::max(parser.as<float>(&telemetry_rate_flag), 0.1f);
+	}
+
+#if defined(_WIN32)
+	LOGW("The telemetry stream is not supported on Windows");
+#else
+	listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+	if (listen_socket < 0)
+	{
+		LOGE("Cannot create the telemetry socket: {}", std::strerror(errno));
+		return;
+	}
+
+	int reuse_address = 1;
+	setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+
+	// Listening on all interfaces lets a dashboard reach the devices of a lab directly, as well as through adb forward
+	sockaddr_in address{};
+	address.sin_family      = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port        = htons(port);
+
+	if (bind(listen_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listen_socket, 4) != 0)
+	{
+		LOGE("Cannot listen for telemetry clients on port {}: {}", port, std::strerror(errno));
+		close(listen_socket);
+		listen_socket = -1;
+		return;
+	}
+
+	fcntl(listen_socket, F_SETFL, fcntl(listen_socket, F_GETFL, 0) | O_NONBLOCK);
+
+	packets      = std::make_unique<vkb::SpscRing<std::vector<uint8_t>>>(QUEUE_CAPACITY);
+	free_buffers = std::make_unique<vkb::SpscRing<std::vector<uint8_t>>>(QUEUE_CAPACITY);
+
+	running = true;
+	sender  = std::thread(&TelemetryStream::run_sender, this);
+
+	LOGI("Streaming telemetry on port {} at {} samples per second", port, 1.0f / sample_interval);
+#endif
+}
+
+void TelemetryStream::on_update(float delta_time)
+{
+	frame_time = delta_time;
+	elapsed_time += delta_time;
+}
+
+void TelemetryStream::on_app_start(const std::string &app_id)
+{
+	frame_index   = 0;
+	elapsed_time  = 0.0f;
+	gpu_profiling = false;
+
+	// Each app starts a new schema, even if its values have the same names
+	schema_names.clear();
+}
+
+void TelemetryStream::on_post_draw(vkb::RenderContext &context)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	// The render context of the app is only known once it draws
+	if (!gpu_profiling)
+	{
+		context.set_gpu_profiling(true);
+		gpu_profiling = true;
+	}
+
+	frame_index++;
+
+	if (elapsed_time < sample_interval)
+	{
+		return;
+	}
+
+	elapsed_time = 0.0f;
+
+	sample(context);
+}
+
+void TelemetryStream::on_platform_close()
+{
+	stop();
+}
+
+void TelemetryStream::sample(vkb::RenderContext &context)
+{
+	names.clear();
+	values.clear();
+
+	auto add_value = [this](std::string name, float value) {
+		names.push_back(std::move(name));
+		values.push_back(value);
+	};
+
+	add_value("Frame time (ms)", frame_time * 1000.0f);
+
+	auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app());
+	if (vulkan_app && vulkan_app->has_render_context())
+	{
+		auto &stats = vulkan_app->get_stats();
+
+		for (auto index : stats.get_requested_stats())
+		{
+			if (index == vkb::StatIndex::frame_times || !stats.is_available(index) || stats.get_data(index).empty())
+			{
+				continue;
+			}
+
+			auto &graph_data = stats.get_graph_data(index);
+			add_value(graph_data.name, stats.get_data(index).back() * graph_data.scale_factor);
+		}
+	}
+
+	if (auto *gpu_profiler = context.get_gpu_profiler())
+	{
+		for (auto &scope : gpu_profiler->get_scopes())
+		{
+			add_value("GPU " + scope.name + " (ms)", static_cast<float>(scope.time * 1000.0));
+		}
+	}
+
+	auto memory = get_memory_usage();
+	add_value("Memory usage (MB)", to_megabytes(memory.first));
+	add_value("Memory budget (MB)", to_megabytes(memory.second));
+
+	for (uint32_t tag = 0; tag < vkb::allocated::MEMORY_TAG_COUNT; tag++)
+	{
+		auto memory_tag = static_cast<vkb::allocated::MemoryTag>(tag);
+		add_value(std::string("Memory ") + vkb::allocated::to_string(memory_tag) + " (MB)", to_megabytes(vkb::allocated::get_tagged_memory_usage(memory_tag)));
+	}
+
+	// Negative where the platform does not report it
+	add_value("Thermal headroom", platform->get_thermal_headroom());
+
+	if (names != schema_names)
+	{
+		auto packet = take_buffer();
+		begin_packet(packet, PacketType::Schema);
+		write_u32(packet, schema_id + 1);
+		write_u16(packet, static_cast<uint16_t>(names.size()));
+		for (auto &name : names)
+		{
+			auto length = std::min<size_t>(name.size(), UINT8_MAX);
+			write_u8(packet, static_cast<uint8_t>(length));
+			packet.insert(packet.end(), name.begin(), name.begin() + length);
+		}
+		end_packet(packet);
+
+		// The samples are only meaningful after their schema, so the schema is sent again with the next sample if it was dropped
+		if (!queue(std::move(packet)))
+		{
+			return;
+		}
+
+		schema_id++;
+		schema_names = names;
+	}
+
+	auto packet = take_buffer();
+	begin_packet(packet, PacketType::Sample);
+	write_u32(packet, schema_id);
+	write_u64(packet, frame_index);
+	write_u64(packet, vkb::profiling::now());
+	write_u32(packet, dropped_samples);
+	for (auto value : values)
+	{
+		write_f32(packet, value);
+	}
+	end_packet(packet);
+
+	if (queue(std::move(packet)))
+	{
+		dropped_samples = 0;
+	}
+}
+
+bool TelemetryStream::queue(std::vector<uint8_t> &&packet)
+{
+	if (!packets->try_push(std::move(packet)))
+	{
+		dropped_samples++;
+		return false;
+	}
+	return true;
+}
+
+std::vector<uint8_t> TelemetryStream::take_buffer()
+{
+	std::vector<uint8_t> buffer;
+	free_buffers->try_pop(buffer);
+	return buffer;
+}
+
+void TelemetryStream::run_sender()
+{
+#if !defined(_WIN32)
+	std::vector<int> clients;
+
+	// The last schema, sent first to each new client
+	std::vector<uint8_t> schema_packet;
+
+	std::vector<uint8_t> packet;
+
+	while (running)
+	{
+		int client;
+		while ((client = accept(listen_socket, nullptr, nullptr)) >= 0)
+		{
+			configure_client(client);
+
+			if (!schema_packet.empty() && !send_packet(client, schema_packet))
+			{
+				close(client);
+				continue;
+			}
+
+			LOGI("Telemetry client connected");
+			clients.push_back(client);
+		}
+
+		bool sent = false;
+		while (packets->try_pop(packet))
+		{
+			if (get_packet_type(packet) == PacketType::Schema)
+			{
+				schema_packet = packet;
+			}
+
+			for (auto it = clients.begin(); it != clients.end();)
+			{
+				if (send_packet(*it, packet))
+				{
+					++it;
+					continue;
+				}
+
+				LOGI("Telemetry client disconnected");
+				close(*it);
+				it = clients.erase(it);
+			}
+
+			// The frame thread allocates a new buffer if this one cannot be returned
+			free_buffers->try_push(std::move(packet));
+			sent = true;
+		}
+
+		if (!sent)
+		{
+			pollfd listen_poll{listen_socket, POLLIN, 0};
+			poll(&listen_poll, 1, IDLE_WAIT_MS);
+		}
+	}
+
+	for (auto client : clients)
+	{
+		close(client);
+	}
+#endif
+}
+
+void TelemetryStream::stop()
+{
+	if (!running)
+	{
+		return;
+	}
+
+	running = false;
+	sender.join();
+
+#if !defined(_WIN32)
+	close(listen_socket);
+	listen_socket = -1;
+#endif
+}
+}        // namespace plugins
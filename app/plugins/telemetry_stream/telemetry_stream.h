@@ -0,0 +1,153 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/util/spsc_ring.hpp"
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class TelemetryStream;
+
+using TelemetryStreamTags = vkb::PluginBase<TelemetryStream, vkb::tags::Passive>;
+
+/**
+ * @brief Telemetry Stream
+ *
+ * Streams the requested stats counters, the GPU time of the debug label scopes, see vkb::GpuProfiler, and the memory
+ * usage of the app to the clients connected to a TCP port, so that devices without a visible Gui overlay can be watched
+ * from a dashboard. On Android the port is reached from the host with adb forward.
+ *
+ * The frame thread only encodes a sample into a recycled buffer and hands it over to the sender thread through a
+ * vkb::SpscRing, so a slow or missing client never stalls the frames. Samples are dropped while the ring is full.
+ *
+ * The protocol is a sequence of little endian packets, each starting with a header of the magic "VKBT" as a uint32,
+ * the protocol version and the packet type as uint16 and the size of the payload as uint32:
+ * - A schema packet lists the names of the values of the samples: a uint32 schema id, a uint16 value count, and for
+ *   each value a uint8 length and the characters of its name. It is sent to each new client, and again whenever the
+ *   values change, e.g. when the GPU scopes of the app change.
+ * - A sample packet holds the uint32 schema id it follows, the uint64 frame index, the uint64 time in nanoseconds of
+ *   std::chrono::steady_clock, the uint32 count of samples dropped before it, and a float32 per value of the schema.
+ *
+ * Usage: vulkan_samples sample afbc --telemetry-port 5959 --telemetry-rate 20
+ *        adb forward tcp:5959 tcp:5959
+ *
+ */
+class TelemetryStream : public TelemetryStreamTags
+{
+  public:
+	static constexpr uint32_t MAGIC = 0x5442'4b56;        // "VKBT"
+
+	static constexpr uint16_t PROTOCOL_VERSION = 1;
+
+	enum class PacketType : uint16_t
+	{
+		Schema = 0,
+		Sample = 1
+	};
+
+	TelemetryStream();
+
+	virtual ~TelemetryStream();
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_update(float delta_time) override;
+
+	virtual void on_app_start(const std::string &app_id) override;
+
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
+	virtual void on_platform_close() override;
+
+	vkb::FlagCommand telemetry_port_flag = {vkb::FlagType::OneValue, "telemetry-port", "", "Stream the stats, GPU scope times and memory usage to the clients of a TCP port"};
+	vkb::FlagCommand telemetry_rate_flag = {vkb::FlagType::OneValue, "telemetry-rate", "", "Number of samples streamed per second, 10 by default"};
+
+  private:
+	/// Number of samples the frame thread can hand over before the sender thread takes them
+	static constexpr size_t QUEUE_CAPACITY = 64;
+
+	/**
+	 * @brief Gathers the names and values of a sample, and encodes it with a new schema if its names changed
+	 */
+	void sample(vkb::RenderContext &context);
+
+	/**
+	 * @brief Queues a packet for the sender thread, or counts it as dropped if the queue is full
+	 */
+	bool queue(std::vector<uint8_t> &&packet);
+
+	/**
+	 * @return A buffer returned by the sender thread, or a new one
+	 */
+	std::vector<uint8_t> take_buffer();
+
+	/**
+	 * @brief Accepts clients and sends them the queued packets, until the stream is stopped
+	 */
+	void run_sender();
+
+	void stop();
+
+	uint16_t port{0};
+
+	float sample_interval{0.1f};
+
+	float elapsed_time{0.0f};
+
+	float frame_time{0.0f};
+
+	uint64_t frame_index{0};
+
+	/// Names of the values of the current schema
+	std::vector<std::string> schema_names;
+
+	uint32_t schema_id{0};
+
+	/// Names and values of the sample being gathered, reused from one sample to the next
+	std::vector<std::string> names;
+
+	std::vector<float> values;
+
+	uint32_t dropped_samples{0};
+
+	/// Whether the GPU profiling of the render context of the app was enabled
+	bool gpu_profiling{false};
+
+	/// Packets from the frame thread to the sender thread
+	std::unique_ptr<vkb::SpscRing<std::vector<uint8_t>>> packets;
+
+	/// Buffers of sent packets from the sender thread back to the frame thread
+	std::unique_ptr<vkb::SpscRing<std::vector<uint8_t>>> free_buffers;
+
+	std::thread sender;
+
+	std::atomic<bool> running{false};
+
+	int listen_socket{-1};
+};
+}        // namespace plugins
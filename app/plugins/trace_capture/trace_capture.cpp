@@ -0,0 +1,277 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace_capture.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <fmt/format.h>
+
+#include "common/error.h"
+#include "common/strings.h"
+#include "core/device.h"
+#include "core/util/profiling.hpp"
+#include "rendering/render_context.h"
+
+namespace plugins
+{
+namespace
+{
+std::string escape_json(const std::string &text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped.push_back('\\');
+		}
+		escaped.push_back(c);
+	}
+	return escaped;
+}
+}        // namespace
+
+TraceCapture::TraceCapture() :
+    TraceCaptureTags("Trace Capture",
+                     "Write a Chrome trace of the CPU profiling zones and GPU scopes of a number of frames.",
+                     {vkb::Hook::OnAppStart, vkb::Hook::OnAppClose, vkb::Hook::PostDraw},
+                     {&trace_output_flag, &trace_frames_flag})
+{
+}
+
+bool TraceCapture::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&trace_output_flag);
+}
+
+void TraceCapture::init(const vkb::CommandParser &parser)
+{
+	output_path = parser.as<std::string>(&trace_output_flag);
+
+	if (parser.contains(&trace_frames_flag))
+	{
+		trace_frames = parser.as<uint32_t>(&trace_frames_flag);
+	}
+
+#ifndef VKB_PROFILING
+	LOGW("Built without VKB_PROFILING, the trace only has the frames and the GPU scopes");
+#endif
+}
+
+void TraceCapture::on_app_start(const std::string &app_id)
+{
+	captured_frames = 0;
+	capturing       = false;
+	captured        = false;
+	render_context  = nullptr;
+	cpu_events.clear();
+	gpu_events.clear();
+}
+
+void TraceCapture::on_app_close(const std::string &app_id)
+{
+	if (capturing)
+	{
+		finish_capture();
+	}
+}
+
+void TraceCapture::on_post_draw(vkb::RenderContext &context)
+{
+	if (captured)
+	{
+		return;
+	}
+
+	uint64_t now = vkb::profiling::now();
+
+	// The capture starts after the first frame, once the render context of the app is known
+	if (!capturing)
+	{
+		context.set_gpu_profiling(true);
+
+		render_context    = &context;
+		timestamp_period  = context.get_device().get_gpu().get_properties().limits.timestampPeriod;
+		start_calibration = calibrate(context.get_device());
+		capture_start     = now;
+		frame_start       = now;
+		gpu_frames_read   = 0;
+		capturing         = true;
+
+		vkb::profiling::collect();
+		vkb::profiling::set_capturing(true);
+		return;
+	}
+
+	cpu_events.push_back({"Frame", 0, 0, frame_start, now});
+	frame_start = now;
+
+	collect();
+
+	if (++captured_frames >= trace_frames)
+	{
+		finish_capture();
+	}
+}
+
+TraceCapture::Calibration TraceCapture::calibrate(vkb::Device &device) const
+{
+	Calibration calibration;
+
+	if (!device.is_enabled(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+	{
+		return calibration;
+	}
+
+	uint32_t domain_count = 0;
+	VK_CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(device.get_gpu().get_handle(), &domain_count, nullptr));
+	std::vector<VkTimeDomainEXT> domains(domain_count);
+	VK_CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(device.get_gpu().get_handle(), &domain_count, domains.data()));
+
+	if (std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) == domains.end())
+	{
+		return calibration;
+	}
+
+	// std::chrono::steady_clock is CLOCK_MONOTONIC where that domain is available, otherwise the CPU time is taken around the call
+	bool monotonic = std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT) != domains.end();
+
+	std::vector<VkCalibratedTimestampInfoEXT> timestamp_infos{{VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, nullptr, VK_TIME_DOMAIN_DEVICE_EXT}};
+	if (monotonic)
+	{
+		timestamp_infos.push_back({VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, nullptr, VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT});
+	}
+
+	std::vector<uint64_t> timestamps(timestamp_infos.size());
+	uint64_t              max_deviation = 0;
+
+	uint64_t before = vkb::profiling::now();
+	VkResult result = vkGetCalibratedTimestampsEXT(device.get_handle(), static_cast<uint32_t>(timestamp_infos.size()), timestamp_infos.data(), timestamps.data(), &max_deviation);
+	uint64_t after  = vkb::profiling::now();
+
+	if (result != VK_SUCCESS)
+	{
+		LOGW("Cannot calibrate the GPU timestamps: {}", vkb::to_string(result));
+		return calibration;
+	}
+
+	calibration.gpu_timestamp = timestamps[0];
+	calibration.cpu_time      = monotonic ? timestamps[1] : before + (after - before) / 2;
+	calibration.valid         = true;
+
+	return calibration;
+}
+
+void TraceCapture::collect()
+{
+	for (auto &thread_zones : vkb::profiling::collect())
+	{
+		for (auto &zone : thread_zones.zones)
+		{
+			// Thread 0 of the CPU process is the frames track
+			cpu_events.push_back({zone.name, 0, thread_zones.thread_index + 1, zone.begin, zone.end});
+		}
+	}
+
+	auto *gpu_profiler = render_context->get_gpu_profiler();
+	if (gpu_profiler && gpu_profiler->get_frames_read() != gpu_frames_read)
+	{
+		gpu_frames_read = gpu_profiler->get_frames_read();
+
+		for (auto &scope : gpu_profiler->get_scopes())
+		{
+			gpu_events.push_back({scope.name, 1, scope.depth, scope.begin_timestamp, scope.end_timestamp});
+		}
+	}
+}
+
+void TraceCapture::finish_capture()
+{
+	vkb::profiling::set_capturing(false);
+
+	collect();
+
+	end_calibration = calibrate(render_context->get_device());
+
+	capturing = false;
+	captured  = true;
+
+	write_trace();
+
+	cpu_events.clear();
+	gpu_events.clear();
+}
+
+void TraceCapture::write_trace() const
+{
+	std::ofstream file{output_path};
+	if (!file)
+	{
+		LOGE("Cannot write the trace to {}", output_path);
+		return;
+	}
+
+	bool calibrated = start_calibration.valid && end_calibration.valid && end_calibration.gpu_timestamp > start_calibration.gpu_timestamp;
+
+	// The GPU timestamps are mapped linearly between the two calibrations, which also corrects the drift of the clocks
+	uint64_t gpu_origin  = calibrated ? start_calibration.gpu_timestamp : (gpu_events.empty() ? 0 : gpu_events.front().begin);
+	uint64_t cpu_origin  = calibrated ? start_calibration.cpu_time : capture_start;
+	double   ns_per_tick = timestamp_period;
+	if (calibrated)
+	{
+		ns_per_tick = static_cast<double>(end_calibration.cpu_time - start_calibration.cpu_time) /
+		              static_cast<double>(end_calibration.gpu_timestamp - start_calibration.gpu_timestamp);
+	}
+
+	auto gpu_to_cpu = [&](uint64_t timestamp) {
+		return static_cast<double>(cpu_origin) + (static_cast<double>(timestamp) - static_cast<double>(gpu_origin)) * ns_per_tick;
+	};
+
+	std::vector<std::string> events;
+
+	events.push_back(R"({"name": "process_name", "ph": "M", "pid": 0, "args": {"name": "CPU"}})");
+	events.push_back(fmt::format(R"({{"name": "process_name", "ph": "M", "pid": 1, "args": {{"name": "GPU{}"}}}})", calibrated ? "" : " (uncalibrated)"));
+	events.push_back(R"({"name": "thread_name", "ph": "M", "pid": 0, "tid": 0, "args": {"name": "Frames"}})");
+
+	auto add_event = [&](const Event &event, double begin, double end) {
+		// Times are in microseconds from the start of the capture
+		events.push_back(fmt::format(R"({{"name": "{}", "ph": "X", "pid": {}, "tid": {}, "ts": {:.3f}, "dur": {:.3f}}})",
+		                             escape_json(event.name), event.process, event.thread, (begin - static_cast<double>(capture_start)) / 1000.0, (end - begin) / 1000.0));
+	};
+
+	for (auto &event : cpu_events)
+	{
+		add_event(event, static_cast<double>(event.begin), static_cast<double>(event.end));
+	}
+
+	for (auto &event : gpu_events)
+	{
+		add_event(event, gpu_to_cpu(event.begin), gpu_to_cpu(event.end));
+	}
+
+	file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+	for (size_t i = 0; i < events.size(); i++)
+	{
+		file << "  " << events[i] << (i + 1 < events.size() ? ",\n" : "\n");
+	}
+	file << "]}\n";
+
+	LOGI("Trace of {} frames written to {}", captured_frames, output_path);
+}
+}        // namespace plugins
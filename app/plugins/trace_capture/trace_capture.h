@@ -0,0 +1,136 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "platform/plugins/plugin_base.h"
+
+namespace vkb
+{
+class Device;
+}
+
+namespace plugins
+{
+class TraceCapture;
+
+using TraceCaptureTags = vkb::PluginBase<TraceCapture, vkb::tags::Passive>;
+
+/**
+ * @brief Trace Capture
+ *
+ * Captures the CPU profiling zones of VKB_PROFILE_SCOPE, which require building with VKB_PROFILING, and the GPU time of
+ * the debug label scopes, see vkb::GpuProfiler, for a number of frames. The capture is written as a Chrome trace JSON file,
+ * which chrome://tracing and the Perfetto UI open.
+ *
+ * The GPU timestamps are converted to the CPU clock with VK_EXT_calibrated_timestamps, calibrated at the start and at the
+ * end of the capture. Without it the GPU track is only aligned to the start of the capture.
+ *
+ * Usage: vulkan_samples sample afbc --trace-output afbc_trace.json --trace-frames 120
+ *
+ */
+class TraceCapture : public TraceCaptureTags
+{
+  public:
+	TraceCapture();
+
+	virtual ~TraceCapture() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_app_start(const std::string &app_id) override;
+
+	virtual void on_app_close(const std::string &app_id) override;
+
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
+	vkb::FlagCommand trace_output_flag = {vkb::FlagType::OneValue, "trace-output", "", "Write a Chrome trace of the CPU zones and GPU scopes to a .json file"};
+	vkb::FlagCommand trace_frames_flag = {vkb::FlagType::OneValue, "trace-frames", "", "Number of frames to trace, 300 by default"};
+
+  private:
+	/// A pair of simultaneous GPU and CPU timestamps
+	struct Calibration
+	{
+		uint64_t gpu_timestamp{0};
+
+		/// Nanoseconds of std::chrono::steady_clock
+		uint64_t cpu_time{0};
+
+		bool valid{false};
+	};
+
+	struct Event
+	{
+		std::string name;
+
+		/// 0 for CPU threads, 1 for the GPU
+		uint32_t process{0};
+
+		uint32_t thread{0};
+
+		/// Nanoseconds of std::chrono::steady_clock, or GPU timestamps until the capture ends
+		uint64_t begin{0};
+
+		uint64_t end{0};
+	};
+
+	Calibration calibrate(vkb::Device &device) const;
+
+	/**
+	 * @brief Collects the CPU zones and the GPU scopes read back since the last frame
+	 */
+	void collect();
+
+	void finish_capture();
+
+	void write_trace() const;
+
+	std::string output_path;
+
+	uint32_t trace_frames{300};
+
+	uint32_t captured_frames{0};
+
+	bool capturing{false};
+
+	bool captured{false};
+
+	/// The render context of the app being captured
+	vkb::RenderContext *render_context{nullptr};
+
+	double timestamp_period{1.0};
+
+	Calibration start_calibration;
+
+	Calibration end_calibration;
+
+	uint64_t capture_start{0};
+
+	uint64_t frame_start{0};
+
+	uint64_t gpu_frames_read{0};
+
+	std::vector<Event> cpu_events;
+
+	std::vector<Event> gpu_events;
+};
+}        // namespace plugins
@@ -43,5 +43,11 @@ void UserInterfaceOptions::init(const vkb::CommandParser &parser)
 		vkb::Gui::visible    = false;
 		vkb::HPPGui::visible = false;
 	}
+
+	if (parser.contains(&retained_ui_flag))
+	{
+		vkb::Gui::retained    = true;
+		vkb::HPPGui::retained = true;
+	}
 }
 }        // namespace plugins
\ No newline at end of file
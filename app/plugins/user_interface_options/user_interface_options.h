@@ -44,6 +44,8 @@ class UserInterfaceOptions : public UserInterfaceOptionsTags
 
 	vkb::FlagCommand hide_ui_flag = {vkb::FlagType::FlagOnly, "hideui", "", "If flag is set, hides the user interface at startup"};
 
-	vkb::CommandGroup user_interface_options_group = {"User interface Options", {&hide_ui_flag}};
+	vkb::FlagCommand retained_ui_flag = {vkb::FlagType::FlagOnly, "retained-ui", "", "If flag is set, records the user interface once and reuses its commands until it changes"};
+
+	vkb::CommandGroup user_interface_options_group = {"User interface Options", {&hide_ui_flag, &retained_ui_flag}};
 };
 }        // namespace plugins
\ No newline at end of file
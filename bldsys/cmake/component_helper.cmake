@@ -160,4 +160,58 @@ function(vkb__register_tests)
              WORKING_DIRECTORY ${CMAKE_SOURCE_DIR})
 
     add_dependencies(vkb__tests ${TARGET_NAME})
+endfunction()
+
+# Bucket target for all benchmarks
+add_custom_target(vkb__benchmarks)
+set_target_properties(vkb__benchmarks PROPERTIES FOLDER "CMake/CustomTargets")
+
+# Register a new microbenchmark
+# Adds the benchmark to the vkb__benchmarks target
+# Benchmarks are Catch2 BENCHMARK cases, they are not added to CTest as their results are timings rather than pass or fail
+function(vkb__register_benchmarks)
+    set(oneValueArgs COMPONENT NAME)
+    set(multiValueArgs SRC HEADERS LINK_LIBS INCLUDE_DIRS)
+
+    if(NOT VKB_BUILD_BENCHMARKS)
+        return() # benchmarks not enabled
+    endif()
+
+    cmake_parse_arguments(TARGET "" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+    if(TARGET_NAME STREQUAL "")
+        message(FATAL_ERROR "NAME must be defined in vkb__register_benchmarks")
+    endif()
+
+    if(NOT TARGET_SRC)
+        message(FATAL_ERROR "One or more source files must be added to vkb__register_benchmarks")
+    endif()
+
+    set(TARGET_FOLDER "benchmarks")
+    set(TARGET_NAME "benchmark__${TARGET_NAME}")
+
+    message(STATUS "BENCHMARK: ${TARGET_NAME}")
+
+    add_executable(${TARGET_NAME} ${TARGET_SRC} ${TARGET_HEADERS})
+
+    target_link_libraries(${TARGET_NAME} PUBLIC Catch2::Catch2WithMain)
+
+    target_compile_definitions(${TARGET_NAME} PUBLIC VKB_BUILD_BENCHMARKS)
+
+    set_property(TARGET ${TARGET_NAME} PROPERTY FOLDER ${TARGET_FOLDER})
+
+    set_target_properties(${TARGET_NAME}
+        PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/benchmarks/${CMAKE_BUILD_TYPE}"
+    )
+
+    if(TARGET_LINK_LIBS)
+        target_link_libraries(${TARGET_NAME} PUBLIC ${TARGET_LINK_LIBS})
+    endif()
+
+    if(TARGET_INCLUDE_DIRS)
+        target_include_directories(${TARGET_NAME} PUBLIC ${TARGET_INCLUDE_DIRS})
+    endif()
+
+    add_dependencies(vkb__benchmarks ${TARGET_NAME})
 endfunction()
\ No newline at end of file
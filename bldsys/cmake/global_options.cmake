@@ -1,5 +1,5 @@
 #[[
- Copyright (c) 2019-2024, Arm Limited and Contributors
+ Copyright (c) 2019-2026, Arm Limited and Contributors
 
  SPDX-License-Identifier: Apache-2.0
 
@@ -49,9 +49,13 @@ set(VKB_VALIDATION_LAYERS OFF CACHE BOOL "Enable validation layers for every app
 set(VKB_VALIDATION_LAYERS_GPU_ASSISTED OFF CACHE BOOL "Enable GPU assisted validation layers for every application (implicitly enables VKB_VALIDATION_LAYERS).")
 set(VKB_VALIDATION_LAYERS_BEST_PRACTICES OFF CACHE BOOL "Enable best practices validation layers for every application (implicitly enables VKB_VALIDATION_LAYERS).")
 set(VKB_VALIDATION_LAYERS_SYNCHRONIZATION OFF CACHE BOOL "Enable synchronization validation layers for every application (implicitly enables VKB_VALIDATION_LAYERS).")
-set(VKB_VULKAN_DEBUG ON CACHE BOOL "Enable VK_EXT_debug_utils or VK_EXT_debug_marker if supported.")
+set(VKB_VULKAN_DEBUG ON CACHE BOOL "Enable VK_EXT_debug_utils or VK_EXT_debug_marker if supported and a debugging tool is active, debug labels and object names are compiled out otherwise.")
+set(VKB_PROFILING OFF CACHE BOOL "Enable the CPU profiling zones of VKB_PROFILE_SCOPE, captured with the trace capture plugin.")
 set(VKB_BUILD_SAMPLES ON CACHE BOOL "Enable generation and building of Vulkan best practice samples.")
 set(VKB_BUILD_TESTS OFF CACHE BOOL "Enable generation and building of Vulkan best practice tests.")
+set(VKB_BUILD_BENCHMARKS OFF CACHE BOOL "Enable generation and building of the microbenchmarks of the components and the framework.")
+set(VKB_BUILD_TOOLS OFF CACHE BOOL "Enable generation and building of the offline asset tools, such as the asset packer.")
+set(VKB_SHADER_BUNDLE_ONLY OFF CACHE BOOL "Load GLSL shaders only from the precompiled shaders/shaders.vksb bundle, without compiling them at runtime.")
 set(VKB_WSI_SELECTION "XCB" CACHE STRING "Select WSI target (XCB, XLIB, WAYLAND, D2D)")
 set(VKB_CLANG_TIDY OFF CACHE STRING "Use CMake Clang Tidy integration")
 set(VKB_CLANG_TIDY_EXTRAS "-header-filter=framework,samples,app;-checks=-*,google-*,-google-runtime-references;--fix;--fix-errors" CACHE STRING "Clang Tidy Parameters")
@@ -1,5 +1,5 @@
 #[[
- Copyright (c) 2019-2024, Arm Limited and Contributors
+ Copyright (c) 2019-2026, Arm Limited and Contributors
  Copyright (c) 2024, Mobica Limited
  Copyright (c) 2024, Sascha Willems
 
@@ -21,9 +21,17 @@
 
 set(SCRIPT_DIR ${CMAKE_CURRENT_LIST_DIR})
 
+# Performance budget of a sample, checked when it runs as a test with the benchmark mode (see app/plugins/start_test):
+#   BUDGET_DEVICE     - the budget only applies to the GPUs whose name contains this, to any GPU if not set
+#   BUDGET_FRAME_TIME - 95th percentile of the frame times, in milliseconds
+#   BUDGET_MEMORY     - peak memory used from the heaps of the device, in MiB
+#   BUDGET_LOAD_TIME  - time to create and prepare the sample, in seconds
+#   BUDGET_PIPELINES  - graphics and compute pipelines created by the sample
+set(SAMPLE_BUDGET_ARGS BUDGET_DEVICE BUDGET_FRAME_TIME BUDGET_MEMORY BUDGET_LOAD_TIME BUDGET_PIPELINES)
+
 function(add_sample)
     set(options)  
-    set(oneValueArgs ID CATEGORY AUTHOR NAME DESCRIPTION DXC_ADDITIONAL_ARGUMENTS)
+    set(oneValueArgs ID CATEGORY AUTHOR NAME DESCRIPTION DXC_ADDITIONAL_ARGUMENTS ${SAMPLE_BUDGET_ARGS})
     set(multiValueArgs FILES LIBS SHADER_FILES_GLSL SHADER_FILES_HLSL)
 
     cmake_parse_arguments(TARGET "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
@@ -45,12 +53,17 @@ function(add_sample)
             ${TARGET_SHADER_FILES_GLSL}
         SHADER_FILES_HLSL
             ${TARGET_SHADER_FILES_HLSL}
-        DXC_ADDITIONAL_ARGUMENTS ${TARGET_DXC_ADDITIONAL_ARGUMENTS})
+        DXC_ADDITIONAL_ARGUMENTS ${TARGET_DXC_ADDITIONAL_ARGUMENTS}
+        BUDGET_DEVICE "${TARGET_BUDGET_DEVICE}"
+        BUDGET_FRAME_TIME ${TARGET_BUDGET_FRAME_TIME}
+        BUDGET_MEMORY ${TARGET_BUDGET_MEMORY}
+        BUDGET_LOAD_TIME ${TARGET_BUDGET_LOAD_TIME}
+        BUDGET_PIPELINES ${TARGET_BUDGET_PIPELINES})
 endfunction()
 
 function(add_sample_with_tags)
     set(options)
-    set(oneValueArgs ID CATEGORY AUTHOR NAME DESCRIPTION DXC_ADDITIONAL_ARGUMENTS)
+    set(oneValueArgs ID CATEGORY AUTHOR NAME DESCRIPTION DXC_ADDITIONAL_ARGUMENTS ${SAMPLE_BUDGET_ARGS})
     set(multiValueArgs TAGS FILES LIBS SHADER_FILES_GLSL SHADER_FILES_HLSL)
 
     cmake_parse_arguments(TARGET "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
@@ -94,7 +107,12 @@ function(add_sample_with_tags)
             ${SHADERS_GLSL}
         SHADERS_HLSL
             ${SHADERS_HLSL}
-        DXC_ADDITIONAL_ARGUMENTS ${TARGET_DXC_ADDITIONAL_ARGUMENTS})
+        DXC_ADDITIONAL_ARGUMENTS ${TARGET_DXC_ADDITIONAL_ARGUMENTS}
+        BUDGET_DEVICE "${TARGET_BUDGET_DEVICE}"
+        BUDGET_FRAME_TIME ${TARGET_BUDGET_FRAME_TIME}
+        BUDGET_MEMORY ${TARGET_BUDGET_MEMORY}
+        BUDGET_LOAD_TIME ${TARGET_BUDGET_LOAD_TIME}
+        BUDGET_PIPELINES ${TARGET_BUDGET_PIPELINES})
 
 endfunction()
 
@@ -124,7 +142,7 @@ endfunction()
 
 function(add_project)
     set(options)  
-    set(oneValueArgs TYPE ID CATEGORY AUTHOR NAME DESCRIPTION DXC_ADDITIONAL_ARGUMENTS)
+    set(oneValueArgs TYPE ID CATEGORY AUTHOR NAME DESCRIPTION DXC_ADDITIONAL_ARGUMENTS ${SAMPLE_BUDGET_ARGS})
     set(multiValueArgs TAGS FILES LIBS SHADERS_GLSL SHADERS_HLSL)
 
     cmake_parse_arguments(TARGET "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
@@ -186,6 +204,21 @@ endif()
                 SAMPLE_DESCRIPTION ${TARGET_DESCRIPTION}
                 SAMPLE_TAGS "${TARGET_TAGS}")
 
+        # unset budgets are 0, which does not budget that value
+        foreach(BUDGET_ARG FRAME_TIME MEMORY LOAD_TIME PIPELINES)
+            if(NOT TARGET_BUDGET_${BUDGET_ARG})
+                set(TARGET_BUDGET_${BUDGET_ARG} 0)
+            endif()
+        endforeach()
+
+        set_target_properties(${PROJECT_NAME}
+            PROPERTIES
+                SAMPLE_BUDGET_DEVICE "${TARGET_BUDGET_DEVICE}"
+                SAMPLE_BUDGET_FRAME_TIME ${TARGET_BUDGET_FRAME_TIME}
+                SAMPLE_BUDGET_MEMORY ${TARGET_BUDGET_MEMORY}
+                SAMPLE_BUDGET_LOAD_TIME ${TARGET_BUDGET_LOAD_TIME}
+                SAMPLE_BUDGET_PIPELINES ${TARGET_BUDGET_PIPELINES})
+
         # add sample project to a folder
         set_property(TARGET ${PROJECT_NAME} PROPERTY FOLDER "Samples//${CATEGORY}")
     elseif(${TARGET_TYPE} STREQUAL "Test")
@@ -0,0 +1,137 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <android/choreographer.h>
+#include <android/looper.h>
+
+namespace vkb
+{
+/**
+ * @brief Paces presents with the vsync of the display, from the frame callbacks of the Choreographer
+ *
+ * Each present waits for the vsync one swap interval after the previous one. Frames which take longer than a refresh
+ * period are held to a swap interval of several periods, so that they are displayed at an even rate instead of
+ * alternating between one and two periods, and the CPU and GPU idle for the rest of the interval.
+ */
+class AndroidFramePacer
+{
+  public:
+	/// Frames slower than this many refresh periods are presented as soon as they are ready
+	static constexpr uint32_t MAX_SWAP_INTERVAL = 4;
+
+	/**
+	 * @brief Starts receiving the vsync callbacks on a thread of the pacer
+	 */
+	AndroidFramePacer();
+
+	~AndroidFramePacer();
+
+	AndroidFramePacer(const AndroidFramePacer &)            = delete;
+	AndroidFramePacer &operator=(const AndroidFramePacer &) = delete;
+
+	/**
+	 * @brief Blocks until the vsync the next present is due on, called right before each present
+	 *        The swap interval is selected from the times between the calls, unless it is set with set_swap_interval().
+	 *        Presents are not paced until the first vsyncs are received, nor while they stop, e.g. when the app is paused.
+	 */
+	void wait_for_vsync();
+
+	/**
+	 * @param swap_interval The refresh periods between presents, 0 to select it from the frame times
+	 */
+	void set_swap_interval(uint32_t swap_interval);
+
+	/**
+	 * @return The refresh periods between the presents, from the presenting thread
+	 */
+	uint32_t get_swap_interval() const;
+
+	/**
+	 * @return The refresh period of the display, zero until it is known
+	 */
+	std::chrono::nanoseconds get_refresh_period() const;
+
+	/**
+	 * @brief Returns the time wait_for_vsync() blocked for since the last call, which the frames did not spend working
+	 */
+	std::chrono::nanoseconds take_wait_time();
+
+  private:
+#if __ANDROID_API__ >= 29
+	static void on_frame(int64_t frame_time_nanos, void *data);
+#else
+	static void on_frame(long frame_time_nanos, void *data);
+#endif
+
+#if __ANDROID_API__ >= 30
+	static void on_refresh_rate(int64_t vsync_period_nanos, void *data);
+#endif
+
+	void run();
+
+	void post_frame_callback();
+
+	void on_vsync(std::chrono::steady_clock::time_point time);
+
+	void select_swap_interval(std::chrono::steady_clock::duration frame_duration);
+
+	std::thread thread;
+
+	mutable std::mutex mutex;
+
+	std::condition_variable vsync_condition;
+
+	/// Looper of the thread receiving the callbacks, woken to stop it
+	ALooper *looper{nullptr};
+
+	bool stopping{false};
+
+	/// Vsyncs received since the pacer started, and the time of the last one
+	uint64_t vsync_count{0};
+
+	std::chrono::steady_clock::time_point vsync_time;
+
+	std::chrono::nanoseconds refresh_period{0};
+
+	/// Whether the refresh period is reported by the Choreographer, instead of measured between vsyncs
+	bool refresh_period_reported{false};
+
+	/// Vsync of the last present, and the time it returned from waiting for it
+	uint64_t present_vsync{0};
+
+	std::chrono::steady_clock::time_point present_time;
+
+	/// Moving average of the time between returning from a wait and the next wait, in seconds
+	double frame_time{0.0};
+
+	uint32_t swap_interval{1};
+
+	/// Swap interval set by the app, 0 if selected automatically
+	uint32_t fixed_swap_interval{0};
+
+	/// Time spent waiting for the vsyncs since the last call to take_wait_time()
+	std::chrono::nanoseconds wait_time{0};
+};
+}        // namespace vkb
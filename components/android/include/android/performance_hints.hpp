@@ -0,0 +1,120 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if __ANDROID_API__ >= 30
+#	include <android/thermal.h>
+#endif
+#if __ANDROID_API__ >= 33
+#	include <android/performance_hint.h>
+#endif
+
+namespace vkb
+{
+/**
+ * @brief Reports the work durations of the frames to the performance hint manager of the Android Dynamic Performance Framework
+ *
+ * The system raises or lowers the CPU clocks of the threads of the session so that their work fits the target duration,
+ * instead of guessing the load from the utilization. Requires API 33, without it reports are dropped.
+ */
+class AndroidPerformanceHintSession
+{
+  public:
+	/**
+	 * @brief Creates a session for the calling thread, the one the work durations are measured on
+	 * @param target_work_duration The duration the work of a frame should take
+	 */
+	explicit AndroidPerformanceHintSession(std::chrono::nanoseconds target_work_duration);
+
+	~AndroidPerformanceHintSession();
+
+	AndroidPerformanceHintSession(const AndroidPerformanceHintSession &)            = delete;
+	AndroidPerformanceHintSession &operator=(const AndroidPerformanceHintSession &) = delete;
+
+	/**
+	 * @return Whether the system supports performance hints
+	 */
+	bool is_supported() const;
+
+	/**
+	 * @brief Changes the target duration, only calling the manager when it differs from the previous one
+	 */
+	void set_target_work_duration(std::chrono::nanoseconds target_work_duration);
+
+	std::chrono::nanoseconds get_target_work_duration() const;
+
+	/**
+	 * @brief Reports the duration the threads of the session worked on a frame, excluding the time they waited
+	 */
+	void report_actual_work_duration(std::chrono::nanoseconds actual_work_duration);
+
+  private:
+#if __ANDROID_API__ >= 33
+	APerformanceHintSession *session{nullptr};
+#endif
+
+	std::chrono::nanoseconds target_work_duration;
+};
+
+/**
+ * @brief Reads the thermal status and headroom of the device, so that throttled measurements can be told apart
+ *        Requires API 30 for the status and API 31 for the headroom.
+ */
+class AndroidThermalMonitor
+{
+  public:
+	/// Thermal status when it is unknown, otherwise one of the AThermalStatus values, from none (0) to shutdown (6)
+	static constexpr int32_t UNKNOWN_STATUS = -1;
+
+	AndroidThermalMonitor();
+
+	~AndroidThermalMonitor();
+
+	AndroidThermalMonitor(const AndroidThermalMonitor &)            = delete;
+	AndroidThermalMonitor &operator=(const AndroidThermalMonitor &) = delete;
+
+	/**
+	 * @return The current thermal status, or UNKNOWN_STATUS
+	 */
+	int32_t get_status() const;
+
+	/**
+	 * @brief Returns how close the device is to severe throttling, 1.0 being the point where it throttles
+	 *        The manager rejects queries more frequent than once per second, so the last headroom is returned in between.
+	 * @return The headroom, or a negative value if it is unknown
+	 */
+	float get_headroom();
+
+	/**
+	 * @return A name for the thermal status
+	 */
+	static const char *to_string(int32_t status);
+
+  private:
+#if __ANDROID_API__ >= 30
+	AThermalManager *manager{nullptr};
+#endif
+
+	float headroom{-1.0f};
+
+	std::chrono::steady_clock::time_point headroom_time;
+};
+}        // namespace vkb
@@ -0,0 +1,249 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "android/frame_pacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+namespace
+{
+// Frames within this fraction of their interval miss their vsync now and then, so they move to the next interval
+constexpr double FRAME_TIME_MARGIN = 0.1;
+
+// Waits for vsyncs which do not come, e.g. while the app is paused, give up on pacing the present
+constexpr std::chrono::milliseconds VSYNC_TIMEOUT{100};
+}        // namespace
+
+AndroidFramePacer::AndroidFramePacer()
+{
+	thread = std::thread(&AndroidFramePacer::run, this);
+
+	// The looper is woken to stop the thread, so it must exist before the pacer can be destroyed
+	std::unique_lock<std::mutex> lock(mutex);
+	vsync_condition.wait(lock, [this] { return looper != nullptr; });
+}
+
+AndroidFramePacer::~AndroidFramePacer()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	ALooper_wake(looper);
+	thread.join();
+	ALooper_release(looper);
+}
+
+void AndroidFramePacer::run()
+{
+	ALooper *thread_looper = ALooper_prepare(0);
+	ALooper_acquire(thread_looper);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		looper = thread_looper;
+	}
+	vsync_condition.notify_all();
+
+	post_frame_callback();
+
+#if __ANDROID_API__ >= 30
+	AChoreographer_registerRefreshRateCallback(AChoreographer_getInstance(), on_refresh_rate, this);
+#endif
+
+	while (true)
+	{
+		ALooper_pollOnce(-1, nullptr, nullptr, nullptr);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (stopping)
+		{
+			break;
+		}
+	}
+
+#if __ANDROID_API__ >= 30
+	AChoreographer_unregisterRefreshRateCallback(AChoreographer_getInstance(), on_refresh_rate, this);
+#endif
+}
+
+void AndroidFramePacer::post_frame_callback()
+{
+	// The Choreographer of the thread calls back on its looper
+#if __ANDROID_API__ >= 29
+	AChoreographer_postFrameCallback64(AChoreographer_getInstance(), on_frame, this);
+#else
+	AChoreographer_postFrameCallback(AChoreographer_getInstance(), on_frame, this);
+#endif
+}
+
+#if __ANDROID_API__ >= 29
+void AndroidFramePacer::on_frame(int64_t frame_time_nanos, void *data)
+{
+	auto *pacer = static_cast<AndroidFramePacer *>(data);
+
+	// Both are times of CLOCK_MONOTONIC
+	pacer->on_vsync(std::chrono::steady_clock::time_point{std::chrono::nanoseconds{frame_time_nanos}});
+	pacer->post_frame_callback();
+}
+#else
+void AndroidFramePacer::on_frame(long /* frame_time_nanos */, void *data)
+{
+	auto *pacer = static_cast<AndroidFramePacer *>(data);
+
+	// The frame time overflows a 32-bit long, so the vsync is timed when its callback runs instead
+	pacer->on_vsync(std::chrono::steady_clock::now());
+	pacer->post_frame_callback();
+}
+#endif
+
+#if __ANDROID_API__ >= 30
+void AndroidFramePacer::on_refresh_rate(int64_t vsync_period_nanos, void *data)
+{
+	auto *pacer = static_cast<AndroidFramePacer *>(data);
+
+	std::lock_guard<std::mutex> lock(pacer->mutex);
+	pacer->refresh_period          = std::chrono::nanoseconds{vsync_period_nanos};
+	pacer->refresh_period_reported = true;
+}
+#endif
+
+void AndroidFramePacer::on_vsync(std::chrono::steady_clock::time_point time)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (!refresh_period_reported && vsync_count > 0)
+		{
+			auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(time - vsync_time);
+
+			// Longer intervals skipped a vsync, e.g. while the thread was not scheduled
+			if (refresh_period.count() == 0)
+			{
+				refresh_period = interval;
+			}
+			else if (interval < refresh_period * 3 / 2)
+			{
+				refresh_period = (refresh_period * 7 + interval) / 8;
+			}
+		}
+
+		vsync_count++;
+		vsync_time = time;
+	}
+
+	vsync_condition.notify_all();
+}
+
+void AndroidFramePacer::wait_for_vsync()
+{
+	auto now = std::chrono::steady_clock::now();
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (refresh_period.count() == 0)
+	{
+		present_vsync = vsync_count;
+		present_time  = now;
+		return;
+	}
+
+	if (present_time != std::chrono::steady_clock::time_point{})
+	{
+		select_swap_interval(now - present_time);
+	}
+
+	// A frame which missed its vsync is presented right away, the next interval starts from it
+	uint64_t target_vsync = present_vsync + swap_interval;
+
+	vsync_condition.wait_for(lock, VSYNC_TIMEOUT, [this, target_vsync] { return stopping || vsync_count >= target_vsync; });
+
+	present_vsync = vsync_count;
+	present_time  = std::chrono::steady_clock::now();
+	wait_time += std::chrono::duration_cast<std::chrono::nanoseconds>(present_time - now);
+}
+
+void AndroidFramePacer::select_swap_interval(std::chrono::steady_clock::duration frame_duration)
+{
+	double duration = std::chrono::duration<double>(frame_duration).count();
+
+	frame_time = frame_time == 0.0 ? duration : 0.9 * frame_time + 0.1 * duration;
+
+	if (fixed_swap_interval > 0)
+	{
+		swap_interval = fixed_swap_interval;
+		return;
+	}
+
+	double period = std::chrono::duration<double>(refresh_period).count();
+
+	auto needed_interval = static_cast<uint32_t>(std::ceil(frame_time * (1.0 + FRAME_TIME_MARGIN) / period));
+	needed_interval      = std::clamp(needed_interval, 1u, MAX_SWAP_INTERVAL);
+
+	uint32_t new_interval = swap_interval;
+	if (needed_interval > swap_interval)
+	{
+		new_interval = needed_interval;
+	}
+	else if (swap_interval > 1 && frame_time < (swap_interval - 1) * period * (1.0 - FRAME_TIME_MARGIN))
+	{
+		// Stepping down only once frames fit well in the shorter interval keeps it from flipping every few frames
+		new_interval = swap_interval - 1;
+	}
+
+	if (new_interval != swap_interval)
+	{
+		LOGI("Frame pacing: {:.1f} ms frames, presenting every {} vsyncs of {:.1f} ms", frame_time * 1000.0, new_interval, period * 1000.0);
+		swap_interval = new_interval;
+	}
+}
+
+void AndroidFramePacer::set_swap_interval(uint32_t new_swap_interval)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	fixed_swap_interval = std::min(new_swap_interval, MAX_SWAP_INTERVAL);
+	if (fixed_swap_interval > 0)
+	{
+		swap_interval = fixed_swap_interval;
+	}
+}
+
+uint32_t AndroidFramePacer::get_swap_interval() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return swap_interval;
+}
+
+std::chrono::nanoseconds AndroidFramePacer::get_refresh_period() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return refresh_period;
+}
+
+std::chrono::nanoseconds AndroidFramePacer::take_wait_time()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return std::exchange(wait_time, std::chrono::nanoseconds{0});
+}
+}        // namespace vkb
@@ -0,0 +1,168 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "android/performance_hints.hpp"
+
+#include <cmath>
+
+#include <unistd.h>
+
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+namespace
+{
+// Headroom queries more frequent than this return NaN
+constexpr std::chrono::seconds HEADROOM_QUERY_INTERVAL{1};
+}        // namespace
+
+AndroidPerformanceHintSession::AndroidPerformanceHintSession(std::chrono::nanoseconds target_work_duration) :
+    target_work_duration{target_work_duration}
+{
+#if __ANDROID_API__ >= 33
+	if (auto *manager = APerformanceHint_getManager())
+	{
+		int32_t thread_id = gettid();
+		session           = APerformanceHint_createSession(manager, &thread_id, 1, target_work_duration.count());
+	}
+
+	if (!session)
+	{
+		LOGW("Performance hints are not supported, the CPU clocks follow the utilization");
+	}
+#endif
+}
+
+AndroidPerformanceHintSession::~AndroidPerformanceHintSession()
+{
+#if __ANDROID_API__ >= 33
+	if (session)
+	{
+		APerformanceHint_closeSession(session);
+	}
+#endif
+}
+
+bool AndroidPerformanceHintSession::is_supported() const
+{
+#if __ANDROID_API__ >= 33
+	return session != nullptr;
+#else
+	return false;
+#endif
+}
+
+void AndroidPerformanceHintSession::set_target_work_duration(std::chrono::nanoseconds new_target_work_duration)
+{
+	if (new_target_work_duration == target_work_duration || new_target_work_duration.count() <= 0)
+	{
+		return;
+	}
+
+	target_work_duration = new_target_work_duration;
+
+#if __ANDROID_API__ >= 33
+	if (session)
+	{
+		APerformanceHint_updateTargetWorkDuration(session, target_work_duration.count());
+	}
+#endif
+}
+
+std::chrono::nanoseconds AndroidPerformanceHintSession::get_target_work_duration() const
+{
+	return target_work_duration;
+}
+
+void AndroidPerformanceHintSession::report_actual_work_duration(std::chrono::nanoseconds actual_work_duration)
+{
+#if __ANDROID_API__ >= 33
+	// The manager rejects durations which are not positive
+	if (session && actual_work_duration.count() > 0)
+	{
+		APerformanceHint_reportActualWorkDuration(session, actual_work_duration.count());
+	}
+#endif
+}
+
+AndroidThermalMonitor::AndroidThermalMonitor()
+{
+#if __ANDROID_API__ >= 30
+	manager = AThermal_acquireManager();
+#endif
+}
+
+AndroidThermalMonitor::~AndroidThermalMonitor()
+{
+#if __ANDROID_API__ >= 30
+	if (manager)
+	{
+		AThermal_releaseManager(manager);
+	}
+#endif
+}
+
+int32_t AndroidThermalMonitor::get_status() const
+{
+#if __ANDROID_API__ >= 30
+	if (manager)
+	{
+		return static_cast<int32_t>(AThermal_getCurrentThermalStatus(manager));
+	}
+#endif
+	return UNKNOWN_STATUS;
+}
+
+float AndroidThermalMonitor::get_headroom()
+{
+#if __ANDROID_API__ >= 31
+	auto now = std::chrono::steady_clock::now();
+
+	if (manager && (headroom_time == std::chrono::steady_clock::time_point{} || now - headroom_time >= HEADROOM_QUERY_INTERVAL))
+	{
+		float value   = AThermal_getThermalHeadroom(manager, 0);
+		headroom      = std::isnan(value) ? -1.0f : value;
+		headroom_time = now;
+	}
+#endif
+	return headroom;
+}
+
+const char *AndroidThermalMonitor::to_string(int32_t status)
+{
+	switch (status)
+	{
+		case 0:
+			return "none";
+		case 1:
+			return "light";
+		case 2:
+			return "moderate";
+		case 3:
+			return "severe";
+		case 4:
+			return "critical";
+		case 5:
+			return "emergency";
+		case 6:
+			return "shutdown";
+		default:
+			return "unknown";
+	}
+}
+}        // namespace vkb
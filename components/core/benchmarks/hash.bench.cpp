@@ -0,0 +1,95 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/hash.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace vkb;
+
+namespace
+{
+/// A cache key of the size of the state hashed by the resource caches, without padding
+struct StateKey
+{
+	std::array<uint32_t, 16> values;
+};
+}        // namespace
+
+TEST_CASE("vkb::hash_bytes", "[benchmark][hash]")
+{
+	std::vector<uint8_t> data(64 * 1024);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 31);
+	}
+
+	BENCHMARK("16 bytes")
+	{
+		return hash_bytes(data.data(), 16);
+	};
+
+	BENCHMARK("64 bytes")
+	{
+		return hash_bytes(data.data(), 64);
+	};
+
+	BENCHMARK("1 KiB")
+	{
+		return hash_bytes(data.data(), 1024);
+	};
+
+	BENCHMARK("64 KiB")
+	{
+		return hash_bytes(data.data(), data.size());
+	};
+
+	BENCHMARK("64 KiB to 128 bits")
+	{
+		return hash_bytes_128(data.data(), data.size());
+	};
+}
+
+TEST_CASE("vkb::hash_combine", "[benchmark][hash]")
+{
+	StateKey key{};
+	for (uint32_t i = 0; i < key.values.size(); ++i)
+	{
+		key.values[i] = i * 0x9e3779b9u;
+	}
+
+	BENCHMARK("16 values one at a time")
+	{
+		size_t seed = 0;
+		for (auto value : key.values)
+		{
+			hash_combine(seed, value);
+		}
+		return seed;
+	};
+
+	BENCHMARK("16 values by their bytes")
+	{
+		size_t seed = 0;
+		hash_combine_bytes(seed, key);
+		return seed;
+	};
+}
@@ -0,0 +1,97 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/hash.hpp>
+#include <core/util/read_mostly_map.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+using namespace vkb;
+
+namespace
+{
+constexpr size_t ENTRY_COUNT = 1024;
+
+/**
+ * @return Keys spread like the hashes of the requests of the resource caches
+ */
+std::vector<size_t> get_keys()
+{
+	std::vector<size_t> keys(ENTRY_COUNT);
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		keys[i] = 0;
+		hash_combine(keys[i], i);
+	}
+	return keys;
+}
+}        // namespace
+
+TEST_CASE("vkb::ReadMostlyMap", "[benchmark][read_mostly_map]")
+{
+	auto keys = get_keys();
+
+	std::vector<int>   values(keys.size());
+	ReadMostlyMap<int> map;
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		map.insert(keys[i], &values[i]);
+	}
+
+	// The locked map of the resource caches before the lookup index, for comparison
+	std::unordered_map<size_t, int *> unordered_map;
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		unordered_map[keys[i]] = &values[i];
+	}
+
+	size_t index = 0;
+
+	BENCHMARK("find hit")
+	{
+		index = (index + 1) % keys.size();
+		return map.find(keys[index]);
+	};
+
+	BENCHMARK("find miss")
+	{
+		index = (index + 1) % keys.size();
+		return map.find(keys[index] + 1);
+	};
+
+	BENCHMARK("std::unordered_map find hit")
+	{
+		index = (index + 1) % keys.size();
+		return unordered_map.find(keys[index])->second;
+	};
+
+	BENCHMARK_ADVANCED("insert 1024 entries")(Catch::Benchmark::Chronometer meter)
+	{
+		meter.measure([&keys, &values] {
+			ReadMostlyMap<int> inserted;
+			for (size_t i = 0; i < keys.size(); ++i)
+			{
+				inserted.insert(keys[i], &values[i]);
+			}
+			return inserted.find(keys[0]);
+		});
+	};
+}
@@ -0,0 +1,85 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/sort_key_list.hpp>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace vkb;
+
+namespace
+{
+constexpr size_t DRAW_COUNT = 10000;
+
+/**
+ * @return Sort keys laid out like the opaque draws of vkb::GeometrySubpass: [63:48] pipeline state, [47:32] material, [31:0] depth
+ */
+std::vector<uint64_t> get_draw_keys()
+{
+	std::mt19937_64                       rng{1234};
+	std::uniform_int_distribution<size_t> state(0, 15);
+	std::uniform_int_distribution<size_t> material(0, 255);
+	std::uniform_real_distribution<float> distance(0.1f, 1000.0f);
+
+	std::vector<uint64_t> keys(DRAW_COUNT);
+	for (auto &key : keys)
+	{
+		key = (static_cast<uint64_t>(state(rng)) << 48) | (static_cast<uint64_t>(material(rng)) << 32) | to_sortable_bits(distance(rng));
+	}
+	return keys;
+}
+}        // namespace
+
+TEST_CASE("vkb::SortKeyList sort of the draws of a frame", "[benchmark][sort_key_list]")
+{
+	auto keys = get_draw_keys();
+
+	SortKeyList<std::pair<const void *, const void *>> list;
+	list.reserve(keys.size());
+
+	BENCHMARK("SortKeyList 10000 draws")
+	{
+		list.clear();
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			list.push_back(keys[i], {&keys[i], &keys[i]});
+		}
+		list.sort();
+		return list[0].key;
+	};
+
+	std::vector<std::pair<uint64_t, std::pair<const void *, const void *>>> draws;
+	draws.reserve(keys.size());
+
+	// The comparison sort of the draws before the sort key lists, for comparison
+	BENCHMARK("std::stable_sort 10000 draws")
+	{
+		draws.clear();
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			draws.push_back({keys[i], {&keys[i], &keys[i]}});
+		}
+		std::stable_sort(draws.begin(), draws.end(), [](auto &a, auto &b) { return a.first < b.first; });
+		return draws[0].first;
+	};
+}
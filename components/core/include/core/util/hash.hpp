@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, Thomas Atkinson
+/* Copyright (c) 2023-2026, Thomas Atkinson
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,14 +17,201 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if !defined(__SIZEOF_INT128__) && defined(_MSC_VER) && defined(_M_X64)
+#	include <intrin.h>
+#endif
 
 namespace vkb
 {
+namespace detail
+{
+// Secret of wyhash, odd constants with balanced bits
+constexpr uint64_t HASH_SECRET[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+/**
+ * @brief Multiplies a and b to 128 bits, and returns the low half in a and the high half in b
+ */
+inline void hash_multiply(uint64_t &a, uint64_t &b)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = static_cast<__uint128_t>(a) * b;
+	a             = static_cast<uint64_t>(r);
+	b             = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	a = _umul128(a, b, &b);
+#else
+	uint64_t low_low   = (a & 0xffffffffull) * (b & 0xffffffffull);
+	uint64_t low_high  = (a & 0xffffffffull) * (b >> 32);
+	uint64_t high_low  = (a >> 32) * (b & 0xffffffffull);
+	uint64_t high_high = (a >> 32) * (b >> 32);
+	uint64_t cross     = (low_low >> 32) + (high_low & 0xffffffffull) + low_high;
+	a                  = (cross << 32) | (low_low & 0xffffffffull);
+	b                  = high_high + (high_low >> 32) + (cross >> 32);
+#endif
+}
+
+/**
+ * @brief Folds the 128-bit product of a and b to 64 bits
+ */
+inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+	hash_multiply(a, b);
+	return a ^ b;
+}
+
+inline uint64_t hash_read8(const uint8_t *p)
+{
+	uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+inline uint64_t hash_read4(const uint8_t *p)
+{
+	uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+}        // namespace detail
+
+/**
+ * @brief Hashes a block of memory to 64 bits, with the wyhash algorithm
+ *        It reads 48 bytes per iteration, so it is much faster than hashing the elements of large objects one at a time.
+ *        Results depend on the byte order, so they must not be shared between machines.
+ * @param data The memory to hash
+ * @param size The size of the memory in bytes
+ * @param seed The seed, e.g. the hash of the previous data to chain hashes
+ */
+inline uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = 0)
+{
+	using namespace detail;
+
+	const uint8_t *p = static_cast<const uint8_t *>(data);
+
+	seed ^= hash_mix(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+
+	uint64_t a = 0;
+	uint64_t b = 0;
+
+	if (size <= 16)
+	{
+		if (size >= 4)
+		{
+			a = (hash_read4(p) << 32) | hash_read4(p + ((size >> 3) << 2));
+			b = (hash_read4(p + size - 4) << 32) | hash_read4(p + size - 4 - ((size >> 3) << 2));
+		}
+		else if (size > 0)
+		{
+			a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[size >> 1]) << 8) | p[size - 1];
+		}
+	}
+	else
+	{
+		size_t remaining = size;
+
+		if (remaining >= 48)
+		{
+			uint64_t seed1 = seed;
+			uint64_t seed2 = seed;
+
+			do
+			{
+				seed  = hash_mix(hash_read8(p) ^ HASH_SECRET[1], hash_read8(p + 8) ^ seed);
+				seed1 = hash_mix(hash_read8(p + 16) ^ HASH_SECRET[2], hash_read8(p + 24) ^ seed1);
+				seed2 = hash_mix(hash_read8(p + 32) ^ HASH_SECRET[3], hash_read8(p + 40) ^ seed2);
+				p += 48;
+				remaining -= 48;
+			} while (remaining >= 48);
+
+			seed ^= seed1 ^ seed2;
+		}
+
+		while (remaining > 16)
+		{
+			seed = hash_mix(hash_read8(p) ^ HASH_SECRET[1], hash_read8(p + 8) ^ seed);
+			p += 16;
+			remaining -= 16;
+		}
+
+		// The last 16 bytes, overlapping the previous ones if needed
+		a = hash_read8(p + remaining - 16);
+		b = hash_read8(p + remaining - 8);
+	}
+
+	a ^= HASH_SECRET[1];
+	b ^= seed;
+	hash_multiply(a, b);
+
+	return hash_mix(a ^ HASH_SECRET[0] ^ size, b ^ HASH_SECRET[1]);
+}
+
+/**
+ * @brief A 128-bit hash, for keys which must stay unique across runs, such as the names of persistent cache entries
+ */
+struct Hash128
+{
+	uint64_t low{0};
+
+	uint64_t high{0};
+
+	bool operator==(const Hash128 &other) const
+	{
+		return low == other.low && high == other.high;
+	}
+
+	bool operator!=(const Hash128 &other) const
+	{
+		return !(*this == other);
+	}
+};
+
+/**
+ * @brief Hashes a block of memory to 128 bits, as two 64-bit hashes with independent seeds
+ * @param data The memory to hash
+ * @param size The size of the memory in bytes
+ * @param seed The seed, e.g. the hash of the previous data to chain hashes
+ */
+inline Hash128 hash_bytes_128(const void *data, size_t size, const Hash128 &seed = {})
+{
+	return {hash_bytes(data, size, seed.low),
+	        hash_bytes(data, size, seed.high ^ detail::HASH_SECRET[2])};
+}
+
+/**
+ * @brief Chains the bytes of a trivially copyable value, or the contents of a string or a vector of them, to a 128-bit hash
+ */
+template <class T>
+inline void hash_combine(Hash128 &seed, const T &value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values are hashed by their bytes");
+	seed = hash_bytes_128(&value, sizeof(T), seed);
+}
+
+inline void hash_combine(Hash128 &seed, const std::string &value)
+{
+	seed = hash_bytes_128(value.data(), value.size(), seed);
+}
+
+template <class T>
+inline void hash_combine(Hash128 &seed, const std::vector<T> &value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only vectors of trivially copyable values are hashed by their bytes");
+	seed = hash_bytes_128(value.data(), value.size() * sizeof(T), seed);
+}
+
+/**
+ * @brief Combines a hash into a seed, with a full 64-bit multiply so that every bit of the inputs affects every bit of the result
+ */
 inline void hash_combine(size_t &seed, size_t hash)
 {
-	hash += 0x9e3779b9 + (seed << 6) + (seed >> 2);
-	seed ^= hash;
+	seed = static_cast<size_t>(detail::hash_mix(static_cast<uint64_t>(seed) ^ detail::HASH_SECRET[0], static_cast<uint64_t>(hash) ^ detail::HASH_SECRET[1]));
 }
 
 /**
@@ -38,4 +225,38 @@ inline void hash_combine(size_t &seed, const T &v)
 
 	hash_combine(seed, hasher(v));
 }
-}        // namespace vkb
\ No newline at end of file
+
+/**
+ * @brief Combines the bytes of a plain data value into a seed in one pass, instead of hashing its members one at a time
+ *        The value must not have padding, whose bytes are undefined, and its floats are compared by their bits.
+ */
+template <class T>
+inline void hash_combine_bytes(size_t &seed, const T &value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values are hashed by their bytes");
+	seed = static_cast<size_t>(hash_bytes(&value, sizeof(T), seed));
+}
+
+/**
+ * @brief Combines the bytes of an array of plain data values into a seed in one pass, see hash_combine_bytes()
+ */
+template <class T>
+inline void hash_combine_bytes(size_t &seed, const T *values, size_t count)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values are hashed by their bytes");
+	seed = static_cast<size_t>(hash_bytes(values, count * sizeof(T), seed));
+}
+}        // namespace vkb
+
+namespace std
+{
+template <>
+struct hash<vkb::Hash128>
+{
+	size_t operator()(const vkb::Hash128 &hash) const
+	{
+		// The halves are already well mixed, so either one is a good hash
+		return static_cast<size_t>(hash.low);
+	}
+};
+}        // namespace std
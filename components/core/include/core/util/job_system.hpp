@@ -0,0 +1,210 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkb
+{
+struct Job;
+
+/**
+ * @brief Handle to a job submitted to a JobSystem, used to wait on it or to make other jobs depend on it
+ *        A default constructed handle refers to no job and counts as done.
+ */
+class JobHandle
+{
+  public:
+	JobHandle() = default;
+
+	bool is_valid() const;
+
+	bool is_done() const;
+
+  private:
+	friend class JobSystem;
+
+	explicit JobHandle(std::shared_ptr<Job> job);
+
+	std::shared_ptr<Job> job;
+};
+
+/**
+ * @brief A work-stealing task scheduler
+ *
+ * Every worker owns a deque: it runs its own jobs newest first, and steals the oldest jobs of the other
+ * workers once its deque is empty. Jobs submitted from outside the workers are spread over the deques.
+ * A job only becomes runnable once all of its dependencies are done.
+ * Threads waiting on a job run other jobs in the meantime, so jobs can wait on the jobs they submit.
+ */
+class JobSystem
+{
+  public:
+	/**
+	 * @param worker_count Number of worker threads, 0 runs every job on the thread waiting for it
+	 */
+	explicit JobSystem(size_t worker_count = get_default_worker_count());
+
+	JobSystem(const JobSystem &) = delete;
+
+	JobSystem(JobSystem &&) = delete;
+
+	/**
+	 * @brief Runs the jobs already runnable, then joins the workers
+	 */
+	~JobSystem();
+
+	JobSystem &operator=(const JobSystem &) = delete;
+
+	JobSystem &operator=(JobSystem &&) = delete;
+
+	/**
+	 * @brief Access the process wide job system, created on first use with the default number of workers
+	 */
+	static JobSystem &get();
+
+	/**
+	 * @return One worker per hardware thread besides the calling one, at least one
+	 */
+	static size_t get_default_worker_count();
+
+	/**
+	 * @return 0 on threads which are not job system workers, i + 1 on worker i
+	 *         Meant for selecting per-thread resources, such as the per-thread pools of a render frame.
+	 */
+	static size_t get_thread_index();
+
+	size_t get_worker_count() const;
+
+	/**
+	 * @brief Schedules a task, to run once all of its dependencies are done
+	 * @param task The task, an exception it throws is rethrown by wait()
+	 * @param dependencies Jobs that must be done before the task starts, regardless of whether they threw
+	 */
+	JobHandle submit(std::function<void()> task, const std::vector<JobHandle> &dependencies = {});
+
+	/**
+	 * @brief Runs other jobs until the job is done
+	 *        Rethrows the exception thrown by the job, if any
+	 */
+	void wait(const JobHandle &job);
+
+	/**
+	 * @brief Waits for all of the jobs, then rethrows the first exception thrown by any of them, if any
+	 */
+	void wait(const std::vector<JobHandle> &jobs);
+
+	/**
+	 * @brief Calls body(begin, end) over [0, count) split in ranges of grain_size elements, and waits for all of them
+	 *        The first range runs on the calling thread.
+	 */
+	template <typename Body>
+	void parallel_for(size_t count, size_t grain_size, Body &&body);
+
+  private:
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+
+		std::deque<std::shared_ptr<Job>> jobs;
+	};
+
+	void worker_loop(size_t worker_index);
+
+	/**
+	 * @brief Pops a job from the deque of the worker, or steals one from the others
+	 */
+	std::shared_ptr<Job> find_job(size_t worker_index);
+
+	void schedule(std::shared_ptr<Job> job);
+
+	void execute(const std::shared_ptr<Job> &job);
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+	std::vector<std::thread> workers;
+
+	/// Jobs in the deques, workers sleep while it is zero
+	std::atomic<size_t> queued_count{0};
+
+	/// Deque receiving the next job submitted from outside the workers
+	std::atomic<size_t> next_queue{0};
+
+	std::mutex sleep_mutex;
+
+	std::condition_variable wake_condition;
+
+	bool stopping{false};
+};
+
+template <typename Body>
+void JobSystem::parallel_for(size_t count, size_t grain_size, Body &&body)
+{
+	grain_size = std::max<size_t>(grain_size, 1);
+
+	size_t range_count = (count + grain_size - 1) / grain_size;
+
+	if (range_count <= 1 || workers.empty())
+	{
+		if (count > 0)
+		{
+			body(static_cast<size_t>(0), count);
+		}
+		return;
+	}
+
+	std::vector<JobHandle> jobs;
+	jobs.reserve(range_count - 1);
+
+	for (size_t range = 1; range < range_count; ++range)
+	{
+		size_t begin = range * grain_size;
+		size_t end   = std::min(begin + grain_size, count);
+
+		jobs.push_back(submit([&body, begin, end]() { body(begin, end); }));
+	}
+
+	// The submitted jobs reference body, so they must finish before an exception leaves this scope
+	try
+	{
+		body(static_cast<size_t>(0), grain_size);
+	}
+	catch (...)
+	{
+		try
+		{
+			wait(jobs);
+		}
+		catch (...)
+		{
+		}
+		throw;
+	}
+
+	wait(jobs);
+}
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <spdlog/fmt/fmt.h>
 #include <spdlog/spdlog.h>
 
@@ -26,12 +31,68 @@
 #define LOGI(...) spdlog::info(__VA_ARGS__);
 #define LOGW(...) spdlog::warn(__VA_ARGS__);
 #define LOGE(...) spdlog::error("{}", fmt::format(__VA_ARGS__));
-#define LOGD(...) spdlog::debug(__VA_ARGS__);
+
+// Debug messages are compiled out unless SPDLOG_ACTIVE_LEVEL enables them, which only debug builds do
+// The arguments are left unevaluated, but still referenced so that variables only logged are not reported as unused
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#	define LOGD(...) spdlog::debug(__VA_ARGS__);
+#else
+#	define LOGD(...) static_cast<void>(sizeof(fmt::format(__VA_ARGS__)));
+#endif
 
 namespace vkb
 {
 namespace logging
 {
+/**
+ * @brief What the asynchronous logger does with a message when its queue is full
+ */
+enum class OverflowPolicy
+{
+	/// Wait for the logging thread to make room, no message is lost
+	Block,
+
+	/// Replace the oldest queued message, the logging thread never slows down the caller
+	OverrunOldest
+};
+
+/**
+ * @brief Options of the asynchronous logger, which formats and writes messages on a background thread
+ *        Logging to logcat or a console is slow, so it keeps those writes out of the render thread.
+ */
+struct AsyncOptions
+{
+	bool enabled{false};
+
+	/// Number of messages the bounded queue holds, its memory is allocated upfront
+	size_t queue_size{8192};
+
+	OverflowPolicy overflow_policy{OverflowPolicy::OverrunOldest};
+};
+
+/**
+ * @brief Reads the asynchronous logger options from the environment
+ *        VKB_LOG_ASYNC (0 or 1, on by default on Android), VKB_LOG_QUEUE_SIZE and VKB_LOG_OVERFLOW (block or overrun).
+ */
+AsyncOptions get_async_options();
+
+/**
+ * @brief Creates a logger writing to the given sinks, asynchronously if enabled in the options
+ */
+std::shared_ptr<spdlog::logger> create_logger(const std::string &name, const std::vector<spdlog::sink_ptr> &sinks, const AsyncOptions &options);
+
+/**
+ * @brief Adds a sink to the default logger
+ *        The sinks of an asynchronous logger are used by its thread, so the logger is replaced by a copy with the new sink.
+ *        It must be called before other threads log, e.g. while the plugins are initialized.
+ */
+void add_sink(const spdlog::sink_ptr &sink);
+
+/**
+ * @brief Writes the queued messages and releases the loggers, no message may be logged afterwards
+ */
+void shutdown();
+
 void init();
-}
+}        // namespace logging
 }        // namespace vkb
\ No newline at end of file
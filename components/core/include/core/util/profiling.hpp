@@ -0,0 +1,111 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+namespace profiling
+{
+/// Slots of the zone ring of each thread, it keeps all but one of them between two collections and drops the oldest zones beyond
+constexpr size_t ZONE_RING_SIZE = 16384;
+
+/**
+ * @brief A named CPU time range, with times in nanoseconds of std::chrono::steady_clock
+ */
+struct Zone
+{
+	/// Name of the zone, it must outlive the captures, as a string literal does
+	const char *name{nullptr};
+
+	uint64_t begin{0};
+
+	uint64_t end{0};
+
+	/// Number of enclosing zones of the same thread
+	uint32_t depth{0};
+};
+
+struct ThreadZones
+{
+	/// Identifies the thread in the order threads recorded their first zone, from 0
+	uint32_t thread_index{0};
+
+	std::vector<Zone> zones;
+};
+
+/**
+ * @return The current time in nanoseconds of std::chrono::steady_clock
+ */
+uint64_t now();
+
+/**
+ * @brief Starts or stops recording zones, zones ending after the capture stops are still recorded if they began during it
+ */
+void set_capturing(bool capturing);
+
+bool is_capturing();
+
+/**
+ * @brief Returns the zones ended since the last collection, by thread
+ *        Zones are recorded to per-thread rings without locks, the oldest zones of a ring are dropped if it overflows
+ *        between two collections. Only one thread may collect at a time.
+ */
+std::vector<ThreadZones> collect();
+
+/**
+ * @brief Records a zone from its construction to its destruction, if zones are being captured at its construction
+ *        Use VKB_PROFILE_SCOPE rather than this class, so the zone is compiled out unless VKB_PROFILING is defined.
+ */
+class ScopedZone
+{
+  public:
+	explicit ScopedZone(const char *name);
+
+	ScopedZone(const ScopedZone &) = delete;
+
+	ScopedZone(ScopedZone &&) = delete;
+
+	~ScopedZone();
+
+	ScopedZone &operator=(const ScopedZone &) = delete;
+
+	ScopedZone &operator=(ScopedZone &&) = delete;
+
+  private:
+	const char *name;
+
+	/// 0 if the zone is not recorded
+	uint64_t begin{0};
+};
+}        // namespace profiling
+}        // namespace vkb
+
+#define VKB_PROFILE_CONCAT_IMPL(a, b) a##b
+#define VKB_PROFILE_CONCAT(a, b) VKB_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef VKB_PROFILING
+/// Records a CPU zone until the end of the enclosing scope, the name must be a string literal
+#	define VKB_PROFILE_SCOPE(name) ::vkb::profiling::ScopedZone VKB_PROFILE_CONCAT(vkb_profile_zone_, __LINE__)(name)
+#else
+#	define VKB_PROFILE_SCOPE(name)
+#endif
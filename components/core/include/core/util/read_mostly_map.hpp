@@ -0,0 +1,199 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief An open addressing hash index from precomputed hashes to object pointers, tuned for read-mostly access
+ *
+ * find() never locks and can run concurrently with a single writer.
+ * insert() must be serialized by the caller. When the table grows the previous table is retired but kept alive,
+ * so readers holding it stay valid, until clear() is called.
+ * clear() must not run concurrently with any reader or writer.
+ */
+template <typename T>
+class ReadMostlyMap
+{
+  public:
+	explicit ReadMostlyMap(size_t initial_capacity = 64)
+	{
+		size_t capacity = 1;
+		while (capacity < initial_capacity)
+		{
+			capacity <<= 1;
+		}
+		this->initial_capacity = capacity;
+
+		allocate_table(capacity);
+	}
+
+	ReadMostlyMap(const ReadMostlyMap &) = delete;
+
+	ReadMostlyMap(ReadMostlyMap &&) = delete;
+
+	ReadMostlyMap &operator=(const ReadMostlyMap &) = delete;
+
+	ReadMostlyMap &operator=(ReadMostlyMap &&) = delete;
+
+	~ReadMostlyMap() = default;
+
+	/**
+	 * @brief Looks up a key without taking any lock
+	 * @return The stored pointer, or nullptr if the key is not present
+	 */
+	T *find(size_t key) const
+	{
+		const Table *table = current.load(std::memory_order_acquire);
+
+		for (size_t i = 0; i <= table->mask; ++i)
+		{
+			const Slot &slot  = table->slots[(key + i) & table->mask];
+			T          *value = slot.value.load(std::memory_order_acquire);
+
+			if (value == nullptr)
+			{
+				return nullptr;
+			}
+
+			if (slot.key.load(std::memory_order_relaxed) == key)
+			{
+				return value;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * @brief Inserts a key, writers must be serialized by the caller
+	 * @return False if the key was already present, in which case the stored value is left untouched
+	 */
+	bool insert(size_t key, T *value)
+	{
+		assert(value && "ReadMostlyMap cannot store null values");
+
+		if (find(key))
+		{
+			return false;
+		}
+
+		Table *table = current.load(std::memory_order_relaxed);
+
+		// Keep the load factor below one half so that probe sequences stay short
+		if ((count + 1) * 2 > table->mask + 1)
+		{
+			Table *grown = allocate_table((table->mask + 1) * 2);
+
+			for (size_t i = 0; i <= table->mask; ++i)
+			{
+				if (T *existing = table->slots[i].value.load(std::memory_order_relaxed))
+				{
+					store(*grown, table->slots[i].key.load(std::memory_order_relaxed), existing);
+				}
+			}
+
+			current.store(grown, std::memory_order_release);
+			table = grown;
+		}
+
+		store(*table, key, value);
+		count++;
+
+		return true;
+	}
+
+	/**
+	 * @brief Removes all entries and releases retired tables, must not run concurrently with readers
+	 */
+	void clear()
+	{
+		tables.clear();
+		count = 0;
+		allocate_table(initial_capacity);
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+  private:
+	struct Slot
+	{
+		std::atomic<size_t> key{0};
+		std::atomic<T *>    value{nullptr};
+	};
+
+	struct Table
+	{
+		explicit Table(size_t capacity) :
+		    mask{capacity - 1},
+		    slots{std::make_unique<Slot[]>(capacity)}
+		{}
+
+		size_t                  mask;
+		std::unique_ptr<Slot[]> slots;
+	};
+
+	Table *allocate_table(size_t capacity)
+	{
+		tables.push_back(std::make_unique<Table>(capacity));
+		Table *table = tables.back().get();
+
+		// A fresh table only becomes visible through clear() or once it has been filled by insert()
+		if (tables.size() == 1)
+		{
+			current.store(table, std::memory_order_release);
+		}
+
+		return table;
+	}
+
+	static void store(Table &table, size_t key, T *value)
+	{
+		for (size_t i = 0;; ++i)
+		{
+			Slot &slot = table.slots[(key + i) & table.mask];
+
+			if (slot.value.load(std::memory_order_relaxed) == nullptr)
+			{
+				// The key must be visible before the value publishes the slot
+				slot.key.store(key, std::memory_order_relaxed);
+				slot.value.store(value, std::memory_order_release);
+				return;
+			}
+		}
+	}
+
+	size_t initial_capacity;
+
+	size_t count{0};
+
+	std::atomic<Table *> current{nullptr};
+
+	/// Every table ever allocated since the last clear, the last one is the current table
+	std::vector<std::unique_ptr<Table>> tables;
+};
+}        // namespace vkb
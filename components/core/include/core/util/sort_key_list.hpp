@@ -0,0 +1,170 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Maps a float to an unsigned integer with the same ordering, so it can be packed into a sort key
+ */
+inline uint32_t to_sortable_bits(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	// Negative floats sort in reverse, so flip all their bits, otherwise only flip the sign bit
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/**
+ * @brief A flat list of values ordered by a 64-bit sort key
+ *
+ * Values live in one contiguous vector and are ordered with a stable LSD radix sort.
+ * The list is meant to be kept alive across frames and cleared between them, so that
+ * its storage is reused and steady state frames do not allocate.
+ */
+template <typename T>
+class SortKeyList
+{
+  public:
+	struct Item
+	{
+		uint64_t key;
+		T        value;
+	};
+
+	using const_iterator         = typename std::vector<Item>::const_iterator;
+	using const_reverse_iterator = typename std::vector<Item>::const_reverse_iterator;
+
+	/**
+	 * @brief Removes all items, keeping the allocated storage
+	 */
+	void clear()
+	{
+		items.clear();
+	}
+
+	void reserve(size_t capacity)
+	{
+		items.reserve(capacity);
+	}
+
+	void push_back(uint64_t key, const T &value)
+	{
+		items.push_back({key, value});
+	}
+
+	/**
+	 * @brief Sorts the items by ascending key, items with equal keys keep their insertion order
+	 */
+	void sort()
+	{
+		const size_t count = items.size();
+
+		if (count < 2)
+		{
+			return;
+		}
+
+		// Build the histograms of all eight key bytes in a single pass
+		std::array<std::array<size_t, 256>, 8> histograms{};
+
+		for (auto &item : items)
+		{
+			for (size_t byte = 0; byte < 8; ++byte)
+			{
+				histograms[byte][(item.key >> (byte * 8)) & 0xff]++;
+			}
+		}
+
+		scratch.resize(count);
+
+		for (size_t byte = 0; byte < 8; ++byte)
+		{
+			auto &histogram = histograms[byte];
+
+			// Every item has the same value in this byte, so this pass would not change the order
+			if (histogram[(items[0].key >> (byte * 8)) & 0xff] == count)
+			{
+				continue;
+			}
+
+			size_t offset = 0;
+			for (auto &bucket : histogram)
+			{
+				size_t bucket_count = bucket;
+				bucket              = offset;
+				offset += bucket_count;
+			}
+
+			for (auto &item : items)
+			{
+				scratch[histogram[(item.key >> (byte * 8)) & 0xff]++] = item;
+			}
+
+			items.swap(scratch);
+		}
+	}
+
+	size_t size() const
+	{
+		return items.size();
+	}
+
+	bool empty() const
+	{
+		return items.empty();
+	}
+
+	const Item &operator[](size_t index) const
+	{
+		return items[index];
+	}
+
+	const_iterator begin() const
+	{
+		return items.begin();
+	}
+
+	const_iterator end() const
+	{
+		return items.end();
+	}
+
+	const_reverse_iterator rbegin() const
+	{
+		return items.rbegin();
+	}
+
+	const_reverse_iterator rend() const
+	{
+		return items.rend();
+	}
+
+  private:
+	std::vector<Item> items;
+
+	/// Ping-pong buffer for the radix passes, kept to avoid reallocating on every sort
+	std::vector<Item> scratch;
+};
+}        // namespace vkb
@@ -0,0 +1,114 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief A bounded queue between one producer thread and one consumer thread, which never locks
+ *
+ * try_push() must only be called by the producer and try_pop() by the consumer. The producer publishes a value by
+ * advancing the tail once it is written, the consumer frees its slot by advancing the head once it is moved out.
+ */
+template <typename T>
+class SpscRing
+{
+  public:
+	/**
+	 * @param capacity Number of values the ring holds, rounded up to a power of two
+	 */
+	explicit SpscRing(size_t capacity)
+	{
+		size_t slot_count = 1;
+		while (slot_count < capacity)
+		{
+			slot_count <<= 1;
+		}
+
+		slots.resize(slot_count);
+		mask = slot_count - 1;
+	}
+
+	SpscRing(const SpscRing &) = delete;
+
+	SpscRing(SpscRing &&) = delete;
+
+	SpscRing &operator=(const SpscRing &) = delete;
+
+	SpscRing &operator=(SpscRing &&) = delete;
+
+	~SpscRing() = default;
+
+	/**
+	 * @return Whether the value was queued, false if the ring is full
+	 */
+	bool try_push(T value)
+	{
+		size_t tail_index = tail.load(std::memory_order_relaxed);
+
+		if (tail_index - head.load(std::memory_order_acquire) > mask)
+		{
+			return false;
+		}
+
+		slots[tail_index & mask] = std::move(value);
+		tail.store(tail_index + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/**
+	 * @return Whether a value was dequeued into value, false if the ring is empty
+	 */
+	bool try_pop(T &value)
+	{
+		size_t head_index = head.load(std::memory_order_relaxed);
+
+		if (head_index == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		value = std::move(slots[head_index & mask]);
+		head.store(head_index + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	size_t capacity() const
+	{
+		return slots.size();
+	}
+
+  private:
+	std::vector<T> slots;
+
+	size_t mask{0};
+
+	/// Index of the next value to pop, only written by the consumer
+	std::atomic<size_t> head{0};
+
+	/// Index of the next value to push, only written by the producer
+	std::atomic<size_t> tail{0};
+};
+}        // namespace vkb
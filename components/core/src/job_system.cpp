@@ -0,0 +1,316 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/job_system.hpp>
+
+#include <chrono>
+#include <exception>
+
+namespace vkb
+{
+struct Job
+{
+	std::function<void()> task;
+
+	/// Dependencies not done yet, plus one held by submit() until the job is registered with all of them
+	std::atomic<size_t> pending_dependencies{1};
+
+	/// Guards the continuations, and the transition to done
+	std::mutex mutex;
+
+	std::condition_variable done_condition;
+
+	std::atomic<bool> done{false};
+
+	/// Jobs depending on this one, scheduled once it is done
+	std::vector<std::shared_ptr<Job>> continuations;
+
+	std::exception_ptr exception;
+};
+
+namespace
+{
+thread_local JobSystem *current_job_system{nullptr};
+
+thread_local size_t current_worker_index{0};
+}        // namespace
+
+JobHandle::JobHandle(std::shared_ptr<Job> job) :
+    job{std::move(job)}
+{}
+
+bool JobHandle::is_valid() const
+{
+	return job != nullptr;
+}
+
+bool JobHandle::is_done() const
+{
+	return !job || job->done.load(std::memory_order_acquire);
+}
+
+JobSystem::JobSystem(size_t worker_count)
+{
+	// Without workers, jobs are queued for the waiting threads to run
+	for (size_t i = 0; i < std::max<size_t>(worker_count, 1); ++i)
+	{
+		queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	for (size_t i = 0; i < worker_count; ++i)
+	{
+		workers.emplace_back(&JobSystem::worker_loop, this, i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		stopping = true;
+	}
+	wake_condition.notify_all();
+
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+}
+
+JobSystem &JobSystem::get()
+{
+	static JobSystem job_system;
+	return job_system;
+}
+
+size_t JobSystem::get_default_worker_count()
+{
+	size_t hardware_threads = std::thread::hardware_concurrency();
+	return hardware_threads > 1 ? hardware_threads - 1 : 1;
+}
+
+size_t JobSystem::get_thread_index()
+{
+	return current_job_system ? current_worker_index + 1 : 0;
+}
+
+size_t JobSystem::get_worker_count() const
+{
+	return workers.size();
+}
+
+JobHandle JobSystem::submit(std::function<void()> task, const std::vector<JobHandle> &dependencies)
+{
+	auto job  = std::make_shared<Job>();
+	job->task = std::move(task);
+
+	for (auto &dependency : dependencies)
+	{
+		if (!dependency.job)
+		{
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lock(dependency.job->mutex);
+
+		if (!dependency.job->done.load(std::memory_order_relaxed))
+		{
+			job->pending_dependencies.fetch_add(1, std::memory_order_relaxed);
+			dependency.job->continuations.push_back(job);
+		}
+	}
+
+	// Release the reference held while registering, the job may already be runnable
+	if (job->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		schedule(job);
+	}
+
+	return JobHandle{job};
+}
+
+void JobSystem::wait(const JobHandle &handle)
+{
+	if (!handle.job)
+	{
+		return;
+	}
+
+	auto &job = handle.job;
+
+	// Threads outside the job system help from the first deque
+	size_t worker_index = current_job_system == this ? current_worker_index : 0;
+
+	while (!job->done.load(std::memory_order_acquire))
+	{
+		if (auto other_job = find_job(worker_index))
+		{
+			execute(other_job);
+			continue;
+		}
+
+		// Nothing to help with, the job is running elsewhere or waiting on a running dependency
+		std::unique_lock<std::mutex> lock(job->mutex);
+		job->done_condition.wait_for(lock, std::chrono::microseconds(100), [&job]() { return job->done.load(std::memory_order_acquire); });
+	}
+
+	if (job->exception)
+	{
+		std::rethrow_exception(job->exception);
+	}
+}
+
+void JobSystem::wait(const std::vector<JobHandle> &jobs)
+{
+	std::exception_ptr first_exception;
+
+	for (auto &job : jobs)
+	{
+		try
+		{
+			wait(job);
+		}
+		catch (...)
+		{
+			if (!first_exception)
+			{
+				first_exception = std::current_exception();
+			}
+		}
+	}
+
+	if (first_exception)
+	{
+		std::rethrow_exception(first_exception);
+	}
+}
+
+void JobSystem::worker_loop(size_t worker_index)
+{
+	current_job_system   = this;
+	current_worker_index = worker_index;
+
+	while (true)
+	{
+		if (auto job = find_job(worker_index))
+		{
+			execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		wake_condition.wait(lock, [this]() { return stopping || queued_count.load() > 0; });
+
+		if (stopping && queued_count.load() == 0)
+		{
+			break;
+		}
+	}
+
+	current_job_system = nullptr;
+}
+
+std::shared_ptr<Job> JobSystem::find_job(size_t worker_index)
+{
+	if (queued_count.load() == 0)
+	{
+		return nullptr;
+	}
+
+	// Own jobs newest first, as they are the most likely to still be in cache
+	{
+		auto                       &queue = *queues[worker_index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.jobs.empty())
+		{
+			auto job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			queued_count--;
+			return job;
+		}
+	}
+
+	// Steal the oldest job of another worker, which tends to be the largest piece of work left
+	for (size_t i = 1; i < queues.size(); ++i)
+	{
+		auto                       &queue = *queues[(worker_index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.jobs.empty())
+		{
+			auto job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			queued_count--;
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+void JobSystem::schedule(std::shared_ptr<Job> job)
+{
+	size_t queue_index = current_job_system == this ? current_worker_index : next_queue++ % queues.size();
+
+	// Count the job first, so that the count never drops below the number of queued jobs
+	queued_count++;
+
+	{
+		auto                       &queue = *queues[queue_index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+
+	// Taking the lock makes sure a worker about to sleep sees the new job
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+	}
+	wake_condition.notify_one();
+}
+
+void JobSystem::execute(const std::shared_ptr<Job> &job)
+{
+	try
+	{
+		job->task();
+	}
+	catch (...)
+	{
+		job->exception = std::current_exception();
+	}
+
+	// Release whatever the task captured
+	job->task = nullptr;
+
+	std::vector<std::shared_ptr<Job>> continuations;
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		job->done.store(true, std::memory_order_release);
+		continuations.swap(job->continuations);
+	}
+	job->done_condition.notify_all();
+
+	for (auto &continuation : continuations)
+	{
+		if (continuation->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			schedule(std::move(continuation));
+		}
+	}
+}
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2024, Thomas Atkinson
+/* Copyright (c) 2024-2026, Thomas Atkinson
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,11 @@
 
 #include "core/util/logging.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "spdlog/async.h"
 #include "spdlog/cfg/env.h"
 
 #ifdef PLATFORM__ANDROID
@@ -29,6 +34,85 @@ namespace vkb
 {
 namespace logging
 {
+AsyncOptions get_async_options()
+{
+	AsyncOptions options;
+
+#ifdef PLATFORM__ANDROID
+	// Writes to logcat block the render thread
+	options.enabled = true;
+#endif
+
+	auto async = spdlog::details::os::getenv("VKB_LOG_ASYNC");
+	if (!async.empty())
+	{
+		options.enabled = async != "0";
+	}
+
+	auto queue_size = spdlog::details::os::getenv("VKB_LOG_QUEUE_SIZE");
+	if (!queue_size.empty())
+	{
+		options.queue_size = std::max<size_t>(std::strtoull(queue_size.c_str(), nullptr, 10), 1);
+	}
+
+	auto overflow = spdlog::details::os::getenv("VKB_LOG_OVERFLOW");
+	std::transform(overflow.begin(), overflow.end(), overflow.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	if (overflow == "block")
+	{
+		options.overflow_policy = OverflowPolicy::Block;
+	}
+	else if (overflow == "overrun")
+	{
+		options.overflow_policy = OverflowPolicy::OverrunOldest;
+	}
+
+	return options;
+}
+
+std::shared_ptr<spdlog::logger> create_logger(const std::string &name, const std::vector<spdlog::sink_ptr> &sinks, const AsyncOptions &options)
+{
+	if (!options.enabled)
+	{
+		return std::make_shared<spdlog::logger>(name, sinks.begin(), sinks.end());
+	}
+
+	// A single thread writes the messages, so they keep their order
+	if (!spdlog::thread_pool())
+	{
+		spdlog::init_thread_pool(options.queue_size, 1);
+	}
+
+	auto policy = options.overflow_policy == OverflowPolicy::Block ? spdlog::async_overflow_policy::block : spdlog::async_overflow_policy::overrun_oldest;
+
+	auto logger = std::make_shared<spdlog::async_logger>(name, sinks.begin(), sinks.end(), spdlog::thread_pool(), policy);
+
+	// Errors usually come before a crash, so they are written out straight away
+	logger->flush_on(spdlog::level::err);
+
+	return logger;
+}
+
+void add_sink(const spdlog::sink_ptr &sink)
+{
+	auto logger = spdlog::default_logger();
+	if (!logger)
+	{
+		return;
+	}
+
+	// The copy is not shared yet, so its sinks can be changed safely
+	auto new_logger = logger->clone(logger->name());
+	new_logger->sinks().push_back(sink);
+
+	spdlog::set_default_logger(new_logger);
+}
+
+void shutdown()
+{
+	// Flushes the loggers, and joins the thread of the asynchronous ones once their queue is empty
+	spdlog::shutdown();
+}
+
 void init()
 {
 	// Taken from "spdlog/cfg/env.h" and renamed SPDLOG_LEVEL to VKB_LOG_LEVEL
@@ -39,11 +123,13 @@ void init()
 	}
 
 #ifdef PLATFORM__ANDROID
-	auto logger = spdlog::android_logger_mt("vkb", "VulkanSamples");
+	auto sink = std::make_shared<spdlog::sinks::android_sink_mt>("VulkanSamples");
 #else
-	auto logger = spdlog::stdout_color_mt("vkb");
+	auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
 #endif
 
+	auto logger = create_logger("vkb", {sink}, get_async_options());
+
 	logger->set_pattern(LOGGER_FORMAT);
 	logger->set_level(spdlog::level::trace);
 	spdlog::set_default_logger(logger);
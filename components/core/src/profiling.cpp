@@ -0,0 +1,158 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/profiling.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace vkb
+{
+namespace profiling
+{
+namespace
+{
+/**
+ * @brief The zones of a thread, written by the thread and read by the collecting thread
+ *
+ * The thread publishes each zone by incrementing the write index, the collector reads up to it. A zone is dropped if the
+ * thread overwrote it while it was read, which the collector tells from the write index once it read the zones.
+ */
+struct ZoneRing
+{
+	uint32_t thread_index{0};
+
+	std::vector<Zone> zones = std::vector<Zone>(ZONE_RING_SIZE);
+
+	std::atomic<uint64_t> write_index{0};
+
+	/// Only accessed by the collector
+	uint64_t read_index{0};
+
+	/// Only accessed by the thread
+	uint32_t depth{0};
+};
+
+std::atomic<bool> capturing{false};
+
+/// Rings of every thread which recorded a zone, kept after the threads exit so their last zones can be collected
+std::mutex rings_mutex;
+
+std::vector<std::shared_ptr<ZoneRing>> rings;
+
+ZoneRing &get_thread_ring()
+{
+	thread_local std::shared_ptr<ZoneRing> ring;
+
+	if (!ring)
+	{
+		std::lock_guard<std::mutex> lock{rings_mutex};
+
+		ring               = std::make_shared<ZoneRing>();
+		ring->thread_index = static_cast<uint32_t>(rings.size());
+		rings.push_back(ring);
+	}
+
+	return *ring;
+}
+}        // namespace
+
+uint64_t now()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void set_capturing(bool enable)
+{
+	capturing.store(enable, std::memory_order_relaxed);
+}
+
+bool is_capturing()
+{
+	return capturing.load(std::memory_order_relaxed);
+}
+
+std::vector<ThreadZones> collect()
+{
+	std::vector<std::shared_ptr<ZoneRing>> collected_rings;
+	{
+		std::lock_guard<std::mutex> lock{rings_mutex};
+		collected_rings = rings;
+	}
+
+	std::vector<ThreadZones> thread_zones;
+
+	for (auto &ring : collected_rings)
+	{
+		uint64_t write_index = ring->write_index.load(std::memory_order_acquire);
+		// The slot of the oldest zone is the one the thread writes next, it is not read
+		uint64_t first_index = std::max(ring->read_index, write_index >= ZONE_RING_SIZE ? write_index - ZONE_RING_SIZE + 1 : 0);
+
+		ThreadZones zones;
+		zones.thread_index = ring->thread_index;
+		for (uint64_t i = first_index; i < write_index; i++)
+		{
+			zones.zones.push_back(ring->zones[i % ZONE_RING_SIZE]);
+		}
+
+		// The zones the thread wrote over in the meantime may be torn, including the one it may be writing
+		uint64_t last_write_index = ring->write_index.load(std::memory_order_acquire);
+		if (last_write_index + 1 > first_index + ZONE_RING_SIZE)
+		{
+			size_t torn_count = static_cast<size_t>(std::min<uint64_t>(last_write_index + 1 - ZONE_RING_SIZE - first_index, zones.zones.size()));
+			zones.zones.erase(zones.zones.begin(), zones.zones.begin() + torn_count);
+		}
+
+		ring->read_index = write_index;
+
+		if (!zones.zones.empty())
+		{
+			thread_zones.push_back(std::move(zones));
+		}
+	}
+
+	return thread_zones;
+}
+
+ScopedZone::ScopedZone(const char *name) :
+    name{name}
+{
+	if (is_capturing())
+	{
+		begin = now();
+		get_thread_ring().depth++;
+	}
+}
+
+ScopedZone::~ScopedZone()
+{
+	if (begin == 0)
+	{
+		return;
+	}
+
+	auto &ring = get_thread_ring();
+	ring.depth--;
+
+	uint64_t write_index                     = ring.write_index.load(std::memory_order_relaxed);
+	ring.zones[write_index % ZONE_RING_SIZE] = {name, begin, now(), ring.depth};
+	ring.write_index.store(write_index + 1, std::memory_order_release);
+}
+}        // namespace profiling
+}        // namespace vkb
@@ -0,0 +1,132 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/hash.hpp>
+
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace vkb;
+
+TEST_CASE("vkb::hash_bytes matches the wyhash test vectors", "[common]")
+{
+	const std::vector<std::pair<std::string, uint64_t>> vectors = {
+	    {"", 0x93228a4de0eec5a2ull},
+	    {"a", 0xc5bac3db178713c4ull},
+	    {"abc", 0xa97f2f7b1d9b3314ull},
+	    {"message digest", 0x786d1f1df3801df4ull},
+	    {"abcdefghijklmnopqrstuvwxyz", 0xdca5a8138ad37c87ull},
+	    {"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 0xb9e734f117cfaf70ull},
+	    {"12345678901234567890123456789012345678901234567890123456789012345678901234567890", 0x6cc5eab49a92d617ull}};
+
+	for (size_t i = 0; i < vectors.size(); ++i)
+	{
+		// The seed of each vector is its index
+		REQUIRE(hash_bytes(vectors[i].first.data(), vectors[i].first.size(), i) == vectors[i].second);
+	}
+}
+
+TEST_CASE("vkb::hash_bytes depends on every byte", "[common]")
+{
+	std::vector<uint8_t> data(100, 0);
+
+	std::unordered_set<uint64_t> hashes;
+	hashes.insert(hash_bytes(data.data(), data.size()));
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = 1;
+		REQUIRE(hashes.insert(hash_bytes(data.data(), data.size())).second);
+		data[i] = 0;
+	}
+
+	// Sizes are hashed too, so trailing zeros are not ignored
+	for (size_t size = 0; size < data.size(); ++size)
+	{
+		REQUIRE(hashes.insert(hash_bytes(data.data(), size)).second);
+	}
+}
+
+TEST_CASE("vkb::hash_combine spreads sequential values", "[common]")
+{
+	std::unordered_set<size_t> hashes;
+
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		size_t seed = 0;
+		hash_combine(seed, i);
+		REQUIRE(hashes.insert(seed).second);
+	}
+
+	// Combining is order dependent
+	size_t first  = 0;
+	size_t second = 0;
+	hash_combine(first, size_t{1});
+	hash_combine(first, size_t{2});
+	hash_combine(second, size_t{2});
+	hash_combine(second, size_t{1});
+	REQUIRE(first != second);
+}
+
+TEST_CASE("vkb::hash_combine_bytes hashes plain data in one pass", "[common]")
+{
+	struct State
+	{
+		uint32_t a;
+		uint32_t b;
+		float    c;
+	};
+
+	State state{1, 2, 3.0f};
+
+	size_t seed = 0;
+	hash_combine_bytes(seed, state);
+	REQUIRE(seed == hash_bytes(&state, sizeof(state)));
+
+	State  states[2]  = {state, state};
+	size_t array_seed = 0;
+	hash_combine_bytes(array_seed, states, 2);
+	REQUIRE(array_seed == hash_bytes(states, sizeof(states)));
+
+	state.b        = 3;
+	size_t changed = 0;
+	hash_combine_bytes(changed, state);
+	REQUIRE(changed != seed);
+}
+
+TEST_CASE("vkb::Hash128 chains values", "[common]")
+{
+	Hash128 first;
+	hash_combine(first, std::string{"shader"});
+	hash_combine(first, uint32_t{1});
+
+	Hash128 second;
+	hash_combine(second, std::string{"shader"});
+	hash_combine(second, uint32_t{2});
+
+	REQUIRE(first != second);
+	REQUIRE(first.low != first.high);
+
+	Hash128 vector_hash;
+	hash_combine(vector_hash, std::vector<uint32_t>{1, 2, 3});
+	uint32_t values[3] = {1, 2, 3};
+	REQUIRE(vector_hash == hash_bytes_128(values, sizeof(values)));
+}
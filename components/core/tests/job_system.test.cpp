@@ -0,0 +1,183 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/job_system.hpp>
+
+#include <stdexcept>
+
+using namespace vkb;
+
+TEST_CASE("vkb::JobSystem submit and wait", "[common]")
+{
+	JobSystem job_system{4};
+
+	std::atomic<int>       counter{0};
+	std::vector<JobHandle> jobs;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		jobs.push_back(job_system.submit([&counter]() { counter++; }));
+	}
+
+	job_system.wait(jobs);
+
+	REQUIRE(counter == 1000);
+
+	for (auto &job : jobs)
+	{
+		REQUIRE(job.is_done());
+	}
+
+	REQUIRE(JobHandle{}.is_done());
+	REQUIRE_FALSE(JobHandle{}.is_valid());
+}
+
+TEST_CASE("vkb::JobSystem runs jobs after their dependencies", "[common]")
+{
+	JobSystem job_system{4};
+
+	std::atomic<int>  stage{0};
+	std::atomic<bool> ordered{true};
+
+	std::vector<JobHandle> first_stage;
+	for (int i = 0; i < 16; ++i)
+	{
+		first_stage.push_back(job_system.submit([&stage]() { stage++; }));
+	}
+
+	auto check_first_stage = [&stage, &ordered]() {
+		if (stage != 16)
+		{
+			ordered = false;
+		}
+		stage = 100;
+	};
+	auto second_stage = job_system.submit(check_first_stage, first_stage);
+
+	auto check_second_stage = [&stage, &ordered]() {
+		if (stage != 100)
+		{
+			ordered = false;
+		}
+	};
+	auto third_stage = job_system.submit(check_second_stage, {second_stage});
+
+	job_system.wait(third_stage);
+
+	REQUIRE(ordered);
+	REQUIRE(second_stage.is_done());
+}
+
+TEST_CASE("vkb::JobSystem parallel_for covers the range once", "[common]")
+{
+	JobSystem job_system{3};
+
+	std::vector<std::atomic<int>> visits(10007);
+
+	job_system.parallel_for(visits.size(), 64, [&visits](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			visits[i]++;
+		}
+	});
+
+	for (auto &visit : visits)
+	{
+		REQUIRE(visit == 1);
+	}
+
+	bool called = false;
+	job_system.parallel_for(0, 64, [&called](size_t, size_t) { called = true; });
+	REQUIRE_FALSE(called);
+}
+
+TEST_CASE("vkb::JobSystem supports waiting from within a job", "[common]")
+{
+	JobSystem job_system{2};
+
+	std::atomic<int> counter{0};
+
+	std::vector<JobHandle> jobs;
+	for (int i = 0; i < 8; ++i)
+	{
+		jobs.push_back(job_system.submit([&job_system, &counter]() {
+			job_system.parallel_for(256, 16, [&counter](size_t begin, size_t end) { counter += static_cast<int>(end - begin); });
+		}));
+	}
+
+	job_system.wait(jobs);
+
+	REQUIRE(counter == 8 * 256);
+}
+
+TEST_CASE("vkb::JobSystem without workers runs jobs on the waiting thread", "[common]")
+{
+	JobSystem job_system{0};
+
+	REQUIRE(job_system.get_worker_count() == 0);
+
+	size_t thread_index = 42;
+	auto   job          = job_system.submit([&thread_index]() { thread_index = JobSystem::get_thread_index(); });
+
+	job_system.wait(job);
+
+	REQUIRE(thread_index == 0);
+}
+
+TEST_CASE("vkb::JobSystem thread indices", "[common]")
+{
+	JobSystem job_system{4};
+
+	REQUIRE(JobSystem::get_thread_index() == 0);
+
+	std::vector<std::atomic<int>> seen(job_system.get_worker_count() + 1);
+
+	job_system.parallel_for(4096, 1, [&seen](size_t, size_t) { seen[JobSystem::get_thread_index()]++; });
+
+	int total = 0;
+	for (auto &count : seen)
+	{
+		total += count;
+	}
+
+	REQUIRE(total == 4096);
+}
+
+TEST_CASE("vkb::JobSystem rethrows exceptions on wait", "[common]")
+{
+	JobSystem job_system{2};
+
+	auto failing = job_system.submit([]() { throw std::runtime_error("job failed"); });
+
+	bool dependent_ran = false;
+	auto dependent     = job_system.submit([&dependent_ran]() { dependent_ran = true; }, {failing});
+
+	REQUIRE_THROWS_AS(job_system.wait(failing), std::runtime_error);
+
+	job_system.wait(dependent);
+	REQUIRE(dependent_ran);
+
+	auto failing_range = [](size_t begin, size_t) {
+		if (begin == 50)
+		{
+			throw std::runtime_error("range failed");
+		}
+	};
+	REQUIRE_THROWS_AS(job_system.parallel_for(100, 10, failing_range), std::runtime_error);
+}
@@ -0,0 +1,139 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/profiling.hpp>
+
+#include <thread>
+
+using namespace vkb::profiling;
+
+namespace
+{
+std::vector<Zone> collect_thread_zones(uint32_t thread_index)
+{
+	for (auto &thread_zones : collect())
+	{
+		if (thread_zones.thread_index == thread_index)
+		{
+			return thread_zones.zones;
+		}
+	}
+
+	return {};
+}
+
+uint32_t get_thread_index()
+{
+	set_capturing(true);
+	{
+		ScopedZone zone{"thread"};
+	}
+	set_capturing(false);
+
+	auto thread_zones = collect();
+	REQUIRE(thread_zones.size() == 1);
+
+	return thread_zones[0].thread_index;
+}
+}        // namespace
+
+TEST_CASE("vkb::profiling records nested zones", "[common]")
+{
+	collect();
+	uint32_t thread_index = get_thread_index();
+
+	set_capturing(true);
+	{
+		ScopedZone outer{"outer"};
+		{
+			ScopedZone inner{"inner"};
+		}
+	}
+	set_capturing(false);
+
+	auto zones = collect_thread_zones(thread_index);
+	REQUIRE(zones.size() == 2);
+
+	// Zones are recorded as they end
+	REQUIRE(std::string{zones[0].name} == "inner");
+	REQUIRE(zones[0].depth == 1);
+	REQUIRE(std::string{zones[1].name} == "outer");
+	REQUIRE(zones[1].depth == 0);
+
+	REQUIRE(zones[1].begin <= zones[0].begin);
+	REQUIRE(zones[0].begin <= zones[0].end);
+	REQUIRE(zones[0].end <= zones[1].end);
+
+	// Collected zones are not returned again
+	REQUIRE(collect_thread_zones(thread_index).empty());
+}
+
+TEST_CASE("vkb::profiling only records zones beginning during a capture", "[common]")
+{
+	collect();
+	uint32_t thread_index = get_thread_index();
+
+	{
+		ScopedZone before{"before"};
+		set_capturing(true);
+		ScopedZone during{"during"};
+	}
+	set_capturing(false);
+
+	auto zones = collect_thread_zones(thread_index);
+	REQUIRE(zones.size() == 1);
+	REQUIRE(std::string{zones[0].name} == "during");
+	REQUIRE(zones[0].depth == 0);
+}
+
+TEST_CASE("vkb::profiling keeps the zones of each thread", "[common]")
+{
+	collect();
+
+	set_capturing(true);
+	std::thread first{[]() { ScopedZone zone{"first"}; }};
+	std::thread second{[]() { ScopedZone zone{"second"}; }};
+	first.join();
+	second.join();
+	set_capturing(false);
+
+	auto thread_zones = collect();
+	REQUIRE(thread_zones.size() == 2);
+	REQUIRE(thread_zones[0].thread_index != thread_zones[1].thread_index);
+
+	for (auto &zones : thread_zones)
+	{
+		REQUIRE(zones.zones.size() == 1);
+	}
+}
+
+TEST_CASE("vkb::profiling drops the oldest zones of a full ring", "[common]")
+{
+	collect();
+	uint32_t thread_index = get_thread_index();
+
+	set_capturing(true);
+	for (size_t i = 0; i < ZONE_RING_SIZE + 10; i++)
+	{
+		ScopedZone zone{"zone"};
+	}
+	set_capturing(false);
+
+	REQUIRE(collect_thread_zones(thread_index).size() == ZONE_RING_SIZE - 1);
+}
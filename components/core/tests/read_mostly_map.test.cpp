@@ -0,0 +1,116 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/read_mostly_map.hpp>
+
+#include <thread>
+
+using namespace vkb;
+
+TEST_CASE("vkb::ReadMostlyMap insert and find", "[common]")
+{
+	ReadMostlyMap<int> map{4};
+	std::vector<int>   values(100);
+
+	REQUIRE(map.find(0) == nullptr);
+
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		REQUIRE(map.insert(i * 7919, &values[i]));
+	}
+
+	REQUIRE(map.size() == values.size());
+
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		REQUIRE(map.find(i * 7919) == &values[i]);
+	}
+
+	REQUIRE(map.find(1) == nullptr);
+}
+
+TEST_CASE("vkb::ReadMostlyMap rejects duplicate keys", "[common]")
+{
+	ReadMostlyMap<int> map;
+	int                first  = 1;
+	int                second = 2;
+
+	REQUIRE(map.insert(42, &first));
+	REQUIRE_FALSE(map.insert(42, &second));
+	REQUIRE(map.find(42) == &first);
+}
+
+TEST_CASE("vkb::ReadMostlyMap clear", "[common]")
+{
+	ReadMostlyMap<int> map{2};
+	int                value = 0;
+
+	for (size_t i = 0; i < 16; ++i)
+	{
+		map.insert(i, &value);
+	}
+
+	map.clear();
+
+	REQUIRE(map.size() == 0);
+	REQUIRE(map.find(3) == nullptr);
+	REQUIRE(map.insert(3, &value));
+	REQUIRE(map.find(3) == &value);
+}
+
+TEST_CASE("vkb::ReadMostlyMap concurrent readers", "[common]")
+{
+	ReadMostlyMap<size_t> map{2};
+	std::vector<size_t>   values(4096);
+
+	std::atomic<bool> done{false};
+	std::atomic<bool> mismatch{false};
+
+	std::vector<std::thread> readers;
+	for (size_t r = 0; r < 4; ++r)
+	{
+		readers.emplace_back([&]() {
+			while (!done)
+			{
+				for (size_t i = 0; i < values.size(); ++i)
+				{
+					auto *value = map.find(i);
+					if (value && value != &values[i])
+					{
+						mismatch = true;
+					}
+				}
+			}
+		});
+	}
+
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		map.insert(i, &values[i]);
+	}
+
+	done = true;
+	for (auto &reader : readers)
+	{
+		reader.join();
+	}
+
+	REQUIRE_FALSE(mismatch);
+	REQUIRE(map.size() == values.size());
+}
@@ -0,0 +1,100 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/sort_key_list.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace vkb;
+
+TEST_CASE("vkb::to_sortable_bits", "[common]")
+{
+	std::vector<float> values{-1000.0f, -2.5f, -0.0f, 0.0f, 1e-6f, 0.5f, 1.0f, 3.0f, 1e20f};
+
+	for (size_t i = 1; i < values.size(); ++i)
+	{
+		REQUIRE(to_sortable_bits(values[i - 1]) <= to_sortable_bits(values[i]));
+	}
+
+	REQUIRE(to_sortable_bits(-1.0f) < to_sortable_bits(1.0f));
+}
+
+TEST_CASE("vkb::SortKeyList sort", "[common]")
+{
+	std::mt19937_64       rng{1234};
+	SortKeyList<size_t>   list;
+	std::vector<uint64_t> keys;
+
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		uint64_t key = rng();
+		keys.push_back(key);
+		list.push_back(key, i);
+	}
+
+	list.sort();
+	std::sort(keys.begin(), keys.end());
+
+	REQUIRE(list.size() == keys.size());
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		REQUIRE(list[i].key == keys[i]);
+	}
+}
+
+TEST_CASE("vkb::SortKeyList sort is stable", "[common]")
+{
+	SortKeyList<int> list;
+
+	for (int i = 0; i < 64; ++i)
+	{
+		list.push_back(static_cast<uint64_t>(i % 4) << 40, i);
+	}
+
+	list.sort();
+
+	for (size_t i = 1; i < list.size(); ++i)
+	{
+		REQUIRE(list[i - 1].key <= list[i].key);
+		if (list[i - 1].key == list[i].key)
+		{
+			REQUIRE(list[i - 1].value < list[i].value);
+		}
+	}
+}
+
+TEST_CASE("vkb::SortKeyList clear", "[common]")
+{
+	SortKeyList<int> list;
+	list.push_back(2, 2);
+	list.push_back(1, 1);
+	list.sort();
+
+	REQUIRE(list.begin()->value == 1);
+	REQUIRE(list.rbegin()->value == 2);
+
+	list.clear();
+
+	REQUIRE(list.empty());
+
+	list.sort();
+
+	REQUIRE(list.empty());
+}
@@ -0,0 +1,93 @@
+/* Copyright (c) 2026, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/spsc_ring.hpp>
+
+#include <string>
+#include <thread>
+
+using namespace vkb;
+
+TEST_CASE("vkb::SpscRing push and pop", "[common]")
+{
+	SpscRing<std::string> ring{3};
+
+	REQUIRE(ring.capacity() == 4);
+
+	std::string value;
+	REQUIRE_FALSE(ring.try_pop(value));
+
+	for (int i = 0; i < 4; ++i)
+	{
+		REQUIRE(ring.try_push(std::to_string(i)));
+	}
+
+	// The ring is full
+	REQUIRE_FALSE(ring.try_push("4"));
+
+	for (int i = 0; i < 4; ++i)
+	{
+		REQUIRE(ring.try_pop(value));
+		REQUIRE(value == std::to_string(i));
+	}
+
+	REQUIRE_FALSE(ring.try_pop(value));
+
+	// The slots are reused once popped
+	REQUIRE(ring.try_push("5"));
+	REQUIRE(ring.try_pop(value));
+	REQUIRE(value == "5");
+}
+
+TEST_CASE("vkb::SpscRing keeps the order across threads", "[common]")
+{
+	SpscRing<size_t> ring{64};
+
+	constexpr size_t count = 100000;
+
+	std::thread producer{[&ring]() {
+		for (size_t i = 0; i < count; ++i)
+		{
+			while (!ring.try_push(i))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}};
+
+	bool   ordered  = true;
+	size_t expected = 0;
+	while (expected < count)
+	{
+		size_t value;
+		if (ring.try_pop(value))
+		{
+			ordered = ordered && value == expected;
+			expected++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	producer.join();
+
+	REQUIRE(ordered);
+}
@@ -0,0 +1,105 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "filesystem/filesystem.hpp"
+
+namespace vkb
+{
+namespace filesystem
+{
+// A packed archive of a directory, a single file which is opened once and read sequentially.
+// Entries are aligned to ARCHIVE_ALIGNMENT, so that uncompressed ones are mapped in place, and a flat table of
+// contents at the end of the archive gives their offsets. All values are little endian.
+//
+//     ArchiveHeader | padding | entry data, each aligned | ArchiveEntry[entry_count] | entry names
+
+constexpr uint32_t ARCHIVE_MAGIC   = 0x4b415056;        // "VPAK"
+constexpr uint32_t ARCHIVE_VERSION = 1;
+
+// The page size of most devices, so that entries start on a page of the archive mapping
+constexpr uint64_t ARCHIVE_ALIGNMENT = 4096;
+
+// The archive of a directory sits next to it, e.g. assets.vkbpak for assets/
+constexpr const char *ARCHIVE_EXTENSION = ".vkbpak";
+
+enum class ArchiveCompression : uint32_t
+{
+	// Stored as is, so that the entry can be mapped
+	None,
+	Zstd
+};
+
+struct ArchiveHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t toc_offset;
+	uint32_t entry_count;
+	uint32_t names_size;
+};
+
+struct ArchiveEntry
+{
+	uint64_t           offset;
+	uint64_t           stored_size;
+	uint64_t           size;
+	ArchiveCompression compression;
+
+	// The path relative to the archived directory with '/' separators, in the names following the table of contents
+	uint32_t name_offset;
+	uint32_t name_size;
+	uint32_t padding;
+};
+
+// Writes an archive entry by entry, without holding the entries in memory
+class ArchiveWriter
+{
+  public:
+	explicit ArchiveWriter(const Path &path);
+
+	ArchiveWriter(const ArchiveWriter &)            = delete;
+	ArchiveWriter &operator=(const ArchiveWriter &) = delete;
+
+	// Add a file, compressed if that saves enough space, otherwise stored so that it can be mapped
+	// The name is the path relative to the archived directory, with '/' separators
+	void add(const std::string &name, const std::vector<uint8_t> &data, ArchiveCompression compression = ArchiveCompression::Zstd);
+
+	// Write the table of contents, the archive is incomplete until then
+	void finish();
+
+  private:
+	std::ofstream file;
+
+	uint64_t offset{0};
+
+	std::vector<ArchiveEntry> entries;
+
+	std::string names;
+};
+
+// Serve the files of an archive as the contents of a directory, and any other path from the given filesystem
+// Writes always go to the given filesystem, a file written to the directory is shadowed by the archive.
+FileSystemPtr mount_archive(FileSystemPtr file_system, const Path &archive_path, const Path &directory);
+}        // namespace filesystem
+}        // namespace vkb
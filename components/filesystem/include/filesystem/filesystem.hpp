@@ -18,7 +18,9 @@
 #pragma once
 
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -38,12 +40,34 @@ struct FileStat
 
 using Path = std::filesystem::path;
 
+// A read-only view of the contents of a file, valid for as long as the mapping is alive
+class MappedFile
+{
+  public:
+	MappedFile()          = default;
+	virtual ~MappedFile() = default;
+
+	MappedFile(const MappedFile &)            = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	// Null for an empty file
+	virtual const uint8_t *data() const = 0;
+	virtual size_t         size() const = 0;
+};
+
+using MappedFilePtr = std::shared_ptr<const MappedFile>;
+
+// A view of file contents which were read into memory, for consumers of mapped files
+MappedFilePtr make_mapped_file(std::vector<uint8_t> &&data);
+
+class ReadQueue;
+
 // A thin filesystem wrapper
 class FileSystem
 {
   public:
-	FileSystem()          = default;
-	virtual ~FileSystem() = default;
+	FileSystem();
+	virtual ~FileSystem();
 
 	virtual FileStat             stat_file(const Path &path)                                    = 0;
 	virtual bool                 is_file(const Path &path)                                      = 0;
@@ -54,16 +78,42 @@ class FileSystem
 	virtual void                 write_file(const Path &path, const std::vector<uint8_t> &data) = 0;
 	virtual void                 remove(const Path &path)                                       = 0;
 
+	// Move a file, replacing the destination if it exists
+	virtual void rename(const Path &from, const Path &to) = 0;
+
+	// Map the entire file read-only, so that large files can be consumed without copying them to the heap first
+	virtual MappedFilePtr map_file(const Path &path) = 0;
+
 	virtual const Path &external_storage_directory() const = 0;
 	virtual const Path &temp_directory() const             = 0;
 
 	void write_file(const Path &path, const std::string &data);
 
+	// Write the file next to its destination first, so that readers never see a partially written file
+	// Each writer uses a temporary file of its own, when several write the same path the last one to rename it wins
+	void write_file_atomic(const Path &path, const std::vector<uint8_t> &data);
+
 	// Read the entire file into a string
 	std::string read_file_string(const Path &path);
 
 	// Read the entire file into a vector of bytes
 	std::vector<uint8_t> read_file_binary(const Path &path);
+
+	// Queue a read of a chunk of the file on the I/O threads of the filesystem, with the semantics of read_chunk
+	// The reads are batched and ordered by file and offset, so that loaders can issue all their reads up front
+	virtual std::future<std::vector<uint8_t>> read_chunk_async(const Path &path, size_t offset, size_t count);
+
+	// Queue a read of the entire file on the I/O threads of the filesystem
+	virtual std::future<std::vector<uint8_t>> read_file_binary_async(const Path &path);
+
+  protected:
+	// The queue reads the files directly, filesystems which do not store files as is translate their requests
+	ReadQueue &get_read_queue();
+
+  private:
+	// Started on the first asynchronous read
+	std::once_flag             read_queue_flag;
+	std::unique_ptr<ReadQueue> read_queue;
 };
 
 using FileSystemPtr = std::shared_ptr<FileSystem>;
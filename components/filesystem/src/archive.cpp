@@ -0,0 +1,128 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "filesystem/archive.hpp"
+
+#include <stdexcept>
+
+#include <zstd.h>
+
+namespace vkb
+{
+namespace filesystem
+{
+namespace
+{
+// Archives are packed offline, where the ratio matters more than the compression time, and decompression is as fast at any level
+constexpr int ZSTD_LEVEL = 12;
+
+static_assert(sizeof(ArchiveHeader) == 24, "The archive header must not have padding");
+static_assert(sizeof(ArchiveEntry) == 40, "The archive entries must not have padding");
+
+uint64_t align_offset(uint64_t offset, uint64_t alignment)
+{
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+}        // namespace
+
+ArchiveWriter::ArchiveWriter(const Path &path) :
+    file{path, std::ios::binary | std::ios::trunc}
+{
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open archive for writing");
+	}
+
+	// The header is rewritten by finish(), once the table of contents is written
+	ArchiveHeader header{};
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	offset = sizeof(header);
+}
+
+void ArchiveWriter::add(const std::string &name, const std::vector<uint8_t> &data, ArchiveCompression compression)
+{
+	std::vector<uint8_t> compressed;
+
+	if (compression == ArchiveCompression::Zstd && !data.empty())
+	{
+		compressed.resize(ZSTD_compressBound(data.size()));
+
+		auto compressed_size = ZSTD_compress(compressed.data(), compressed.size(), data.data(), data.size(), ZSTD_LEVEL);
+		if (ZSTD_isError(compressed_size))
+		{
+			throw std::runtime_error(std::string{"Failed to compress archive entry: "} + ZSTD_getErrorName(compressed_size));
+		}
+
+		compressed.resize(compressed_size);
+	}
+
+	// Files which barely compress, such as images, are better mapped in place than decompressed to the heap
+	if (compressed.empty() || compressed.size() > data.size() - data.size() / 8)
+	{
+		compression = ArchiveCompression::None;
+	}
+
+	const auto &stored = compression == ArchiveCompression::None ? data : compressed;
+
+	auto entry_offset = align_offset(offset, ARCHIVE_ALIGNMENT);
+
+	static const std::vector<char> zeros(ARCHIVE_ALIGNMENT);
+	file.write(zeros.data(), static_cast<std::streamsize>(entry_offset - offset));
+	file.write(reinterpret_cast<const char *>(stored.data()), static_cast<std::streamsize>(stored.size()));
+
+	if (!file)
+	{
+		throw std::runtime_error("Failed to write archive entry");
+	}
+
+	ArchiveEntry entry{};
+	entry.offset      = entry_offset;
+	entry.stored_size = stored.size();
+	entry.size        = data.size();
+	entry.compression = compression;
+	entry.name_offset = static_cast<uint32_t>(names.size());
+	entry.name_size   = static_cast<uint32_t>(name.size());
+	entries.push_back(entry);
+
+	names += name;
+
+	offset = entry_offset + stored.size();
+}
+
+void ArchiveWriter::finish()
+{
+	// The table of contents is read in place from the archive mapping
+	auto toc_offset = align_offset(offset, alignof(ArchiveEntry));
+
+	static const std::vector<char> zeros(alignof(ArchiveEntry));
+	file.write(zeros.data(), static_cast<std::streamsize>(toc_offset - offset));
+	file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(ArchiveEntry)));
+	file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+	ArchiveHeader header{ARCHIVE_MAGIC, ARCHIVE_VERSION, toc_offset, static_cast<uint32_t>(entries.size()), static_cast<uint32_t>(names.size())};
+
+	file.seekp(0);
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.close();
+
+	if (file.fail())
+	{
+		throw std::runtime_error("Failed to write archive table of contents");
+	}
+}
+}        // namespace filesystem
+}        // namespace vkb
@@ -0,0 +1,365 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "archive_filesystem.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <zstd.h>
+
+#include "read_queue.hpp"
+
+namespace vkb
+{
+namespace filesystem
+{
+namespace
+{
+// A view of an entry stored in the mapping of its archive, which it keeps alive
+class ArchiveEntryFile final : public MappedFile
+{
+  public:
+	ArchiveEntryFile(MappedFilePtr archive, uint64_t offset, uint64_t size) :
+	    archive{std::move(archive)},
+	    offset{offset},
+	    _size{static_cast<size_t>(size)}
+	{}
+
+	const uint8_t *data() const override
+	{
+		return _size > 0 ? archive->data() + offset : nullptr;
+	}
+
+	size_t size() const override
+	{
+		return _size;
+	}
+
+  private:
+	MappedFilePtr archive;
+	uint64_t      offset;
+	size_t        _size;
+};
+
+std::vector<uint8_t> decompress_entry(const ArchiveEntry &entry, const uint8_t *stored)
+{
+	std::vector<uint8_t> data(static_cast<size_t>(entry.size));
+
+	auto size = ZSTD_decompress(data.data(), data.size(), stored, static_cast<size_t>(entry.stored_size));
+	if (ZSTD_isError(size) || size != data.size())
+	{
+		throw std::runtime_error("Failed to decompress archive entry");
+	}
+
+	return data;
+}
+
+std::future<std::vector<uint8_t>> make_ready_future(std::vector<uint8_t> &&data)
+{
+	std::promise<std::vector<uint8_t>> promise;
+	promise.set_value(std::move(data));
+	return promise.get_future();
+}
+}        // namespace
+
+ArchiveFileSystem::ArchiveFileSystem(FileSystemPtr file_system, const Path &archive_path, const Path &directory) :
+    file_system{std::move(file_system)},
+    archive_path{archive_path},
+    directory{directory.lexically_normal()}
+{
+	// Paths are compared by their elements, so the directory must not end with a separator
+	if (!this->directory.has_filename())
+	{
+		this->directory = this->directory.parent_path();
+	}
+
+	archive = this->file_system->map_file(archive_path);
+
+	const uint8_t *data = archive->data();
+	const size_t   size = archive->size();
+
+	ArchiveHeader header{};
+	if (size < sizeof(header))
+	{
+		throw std::runtime_error("Archive is truncated");
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	if (header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION)
+	{
+		throw std::runtime_error("Archive has an unsupported format");
+	}
+
+	const uint64_t names_offset = header.toc_offset + uint64_t{header.entry_count} * sizeof(ArchiveEntry);
+	if (header.toc_offset > size || names_offset + header.names_size > size)
+	{
+		throw std::runtime_error("Archive table of contents is truncated");
+	}
+
+	const char *names = reinterpret_cast<const char *>(data + names_offset);
+
+	directories.insert("");
+
+	entries.reserve(header.entry_count);
+	for (uint32_t i = 0; i < header.entry_count; ++i)
+	{
+		ArchiveEntry entry{};
+		std::memcpy(&entry, data + header.toc_offset + i * sizeof(ArchiveEntry), sizeof(entry));
+
+		if (entry.offset + entry.stored_size > header.toc_offset || uint64_t{entry.name_offset} + entry.name_size > header.names_size ||
+		    (entry.compression != ArchiveCompression::None && entry.compression != ArchiveCompression::Zstd) ||
+		    (entry.compression == ArchiveCompression::None && entry.stored_size != entry.size))
+		{
+			throw std::runtime_error("Archive has an invalid entry");
+		}
+
+		std::string name{names + entry.name_offset, entry.name_size};
+
+		for (auto separator = name.find('/'); separator != std::string::npos; separator = name.find('/', separator + 1))
+		{
+			directories.insert(name.substr(0, separator));
+		}
+
+		entries.emplace(std::move(name), entry);
+	}
+}
+
+bool ArchiveFileSystem::get_archive_name(const Path &path, std::string &name) const
+{
+	auto relative_path = path.lexically_normal().lexically_relative(directory);
+	if (relative_path.empty())
+	{
+		return false;
+	}
+
+	name = relative_path.generic_string();
+
+	if (name == "." || name == "./")
+	{
+		name.clear();
+		return true;
+	}
+
+	if (name.compare(0, 2, "..") == 0)
+	{
+		return false;
+	}
+
+	// A path to a directory may end with a separator
+	if (!name.empty() && name.back() == '/')
+	{
+		name.pop_back();
+	}
+
+	return true;
+}
+
+const ArchiveEntry *ArchiveFileSystem::find_entry(const Path &path) const
+{
+	std::string name;
+	if (!get_archive_name(path, name))
+	{
+		return nullptr;
+	}
+
+	auto it = entries.find(name);
+
+	return it != entries.end() ? &it->second : nullptr;
+}
+
+bool ArchiveFileSystem::is_archive_directory(const Path &path) const
+{
+	std::string name;
+	return get_archive_name(path, name) && directories.count(name) > 0;
+}
+
+std::vector<uint8_t> ArchiveFileSystem::read_entry(const ArchiveEntry &entry) const
+{
+	const uint8_t *stored = archive->data() + entry.offset;
+
+	if (entry.compression == ArchiveCompression::None)
+	{
+		return {stored, stored + entry.size};
+	}
+
+	return decompress_entry(entry, stored);
+}
+
+FileStat ArchiveFileSystem::stat_file(const Path &path)
+{
+	if (auto entry = find_entry(path))
+	{
+		return FileStat{
+		    true,
+		    false,
+		    static_cast<size_t>(entry->size),
+		};
+	}
+
+	if (is_archive_directory(path))
+	{
+		return FileStat{
+		    false,
+		    true,
+		    0,
+		};
+	}
+
+	return file_system->stat_file(path);
+}
+
+bool ArchiveFileSystem::is_file(const Path &path)
+{
+	auto stat = stat_file(path);
+	return stat.is_file;
+}
+
+bool ArchiveFileSystem::is_directory(const Path &path)
+{
+	auto stat = stat_file(path);
+	return stat.is_directory;
+}
+
+bool ArchiveFileSystem::exists(const Path &path)
+{
+	auto stat = stat_file(path);
+	return stat.is_file || stat.is_directory;
+}
+
+bool ArchiveFileSystem::create_directory(const Path &path)
+{
+	if (is_archive_directory(path))
+	{
+		return true;
+	}
+
+	return file_system->create_directory(path);
+}
+
+std::vector<uint8_t> ArchiveFileSystem::read_chunk(const Path &path, size_t offset, size_t count)
+{
+	auto entry = find_entry(path);
+	if (!entry)
+	{
+		return file_system->read_chunk(path, offset, count);
+	}
+
+	if (offset + count > entry->size)
+	{
+		return {};
+	}
+
+	if (entry->compression == ArchiveCompression::None)
+	{
+		const uint8_t *stored = archive->data() + entry->offset + offset;
+		return {stored, stored + count};
+	}
+
+	auto data = read_entry(*entry);
+	return {data.begin() + offset, data.begin() + offset + count};
+}
+
+void ArchiveFileSystem::write_file(const Path &path, const std::vector<uint8_t> &data)
+{
+	file_system->write_file(path, data);
+}
+
+void ArchiveFileSystem::remove(const Path &path)
+{
+	file_system->remove(path);
+}
+
+void ArchiveFileSystem::rename(const Path &from, const Path &to)
+{
+	file_system->rename(from, to);
+}
+
+MappedFilePtr ArchiveFileSystem::map_file(const Path &path)
+{
+	auto entry = find_entry(path);
+	if (!entry)
+	{
+		return file_system->map_file(path);
+	}
+
+	if (entry->compression == ArchiveCompression::None)
+	{
+		return std::make_shared<ArchiveEntryFile>(archive, entry->offset, entry->size);
+	}
+
+	return make_mapped_file(read_entry(*entry));
+}
+
+const Path &ArchiveFileSystem::external_storage_directory() const
+{
+	return file_system->external_storage_directory();
+}
+
+const Path &ArchiveFileSystem::temp_directory() const
+{
+	return file_system->temp_directory();
+}
+
+std::future<std::vector<uint8_t>> ArchiveFileSystem::read_chunk_async(const Path &path, size_t offset, size_t count)
+{
+	auto entry = find_entry(path);
+	if (!entry)
+	{
+		return file_system->read_chunk_async(path, offset, count);
+	}
+
+	if (offset + count > entry->size)
+	{
+		return make_ready_future({});
+	}
+
+	// The reads of all entries go to the archive, so the queue orders them into a sequential read of it
+	if (entry->compression == ArchiveCompression::None)
+	{
+		return get_read_queue().push(archive_path, static_cast<size_t>(entry->offset) + offset, count);
+	}
+
+	// Compressed entries are read whole, and decompressed on the I/O thread
+	return get_read_queue().push(archive_path, static_cast<size_t>(entry->offset), static_cast<size_t>(entry->stored_size),
+	                             [entry = *entry, offset, count](std::vector<uint8_t> &&stored) {
+		                             auto data = decompress_entry(entry, stored.data());
+		                             if (offset == 0 && count == data.size())
+		                             {
+			                             return data;
+		                             }
+		                             return std::vector<uint8_t>{data.begin() + offset, data.begin() + offset + count};
+	                             });
+}
+
+std::future<std::vector<uint8_t>> ArchiveFileSystem::read_file_binary_async(const Path &path)
+{
+	auto entry = find_entry(path);
+	if (!entry)
+	{
+		return file_system->read_file_binary_async(path);
+	}
+
+	return read_chunk_async(path, 0, static_cast<size_t>(entry->size));
+}
+
+FileSystemPtr mount_archive(FileSystemPtr file_system, const Path &archive_path, const Path &directory)
+{
+	return std::make_shared<ArchiveFileSystem>(std::move(file_system), archive_path, directory);
+}
+}        // namespace filesystem
+}        // namespace vkb
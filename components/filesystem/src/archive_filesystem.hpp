@@ -0,0 +1,93 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "filesystem/archive.hpp"
+#include "filesystem/filesystem.hpp"
+
+namespace vkb
+{
+namespace filesystem
+{
+// Serves the files of an archive as the contents of a directory, and any other path from another filesystem, see mount_archive()
+class ArchiveFileSystem final : public FileSystem
+{
+  public:
+	ArchiveFileSystem(FileSystemPtr file_system, const Path &archive_path, const Path &directory);
+
+	virtual ~ArchiveFileSystem() = default;
+
+	FileStat stat_file(const Path &path) override;
+
+	bool is_file(const Path &path) override;
+
+	bool is_directory(const Path &path) override;
+
+	bool exists(const Path &path) override;
+
+	bool create_directory(const Path &path) override;
+
+	std::vector<uint8_t> read_chunk(const Path &path, size_t offset, size_t count) override;
+
+	void write_file(const Path &path, const std::vector<uint8_t> &data) override;
+
+	void remove(const Path &path) override;
+
+	void rename(const Path &from, const Path &to) override;
+
+	MappedFilePtr map_file(const Path &path) override;
+
+	const Path &external_storage_directory() const override;
+
+	const Path &temp_directory() const override;
+
+	std::future<std::vector<uint8_t>> read_chunk_async(const Path &path, size_t offset, size_t count) override;
+
+	std::future<std::vector<uint8_t>> read_file_binary_async(const Path &path) override;
+
+  private:
+	// The path relative to the archived directory with '/' separators, false if the path is outside of it
+	bool get_archive_name(const Path &path, std::string &name) const;
+
+	// The entry of a file, or null if the archive does not hold it
+	const ArchiveEntry *find_entry(const Path &path) const;
+
+	bool is_archive_directory(const Path &path) const;
+
+	std::vector<uint8_t> read_entry(const ArchiveEntry &entry) const;
+
+	FileSystemPtr file_system;
+
+	Path archive_path;
+
+	Path directory;
+
+	// The whole archive is mapped, its stored entries are served in place
+	MappedFilePtr archive;
+
+	std::unordered_map<std::string, ArchiveEntry> entries;
+
+	// The archived directory is the empty name
+	std::unordered_set<std::string> directories;
+};
+}        // namespace filesystem
+}        // namespace vkb
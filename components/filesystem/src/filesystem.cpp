@@ -19,25 +19,106 @@
 
 #include "core/platform/context.hpp"
 #include "core/util/error.hpp"
+#include "filesystem/archive.hpp"
 
+#include "read_queue.hpp"
 #include "std_filesystem.hpp"
 
+#include <atomic>
+#include <functional>
+#include <random>
+#include <thread>
+
 namespace vkb
 {
 namespace filesystem
 {
 static FileSystemPtr fs = nullptr;
 
+// Blocking reads mostly wait on the storage, so a couple of threads keep it busy without competing with the job system
+static constexpr uint32_t READ_QUEUE_THREAD_COUNT = 2;
+
+namespace
+{
+class MemoryMappedFile final : public MappedFile
+{
+  public:
+	explicit MemoryMappedFile(std::vector<uint8_t> &&data) :
+	    _data(std::move(data))
+	{}
+
+	const uint8_t *data() const override
+	{
+		return _data.empty() ? nullptr : _data.data();
+	}
+
+	size_t size() const override
+	{
+		return _data.size();
+	}
+
+  private:
+	std::vector<uint8_t> _data;
+};
+
+/**
+ * @brief A suffix no other writer uses, so that concurrent writers of a file, from this or another process, each write
+ *        their own temporary file
+ */
+std::string unique_temp_suffix()
+{
+	// Drawn once per process, tells the processes sharing a directory apart
+	static const uint64_t process_nonce = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+
+	// Tells the writes of a thread apart
+	static std::atomic<uint64_t> write_count{0};
+
+	const auto thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+	return fmt::format(".{:016x}.{:x}.{:x}.tmp", process_nonce, thread_hash, write_count.fetch_add(1, std::memory_order_relaxed));
+}
+}        // namespace
+
+/**
+ * @brief Serves the directories packed into an archive next to them from the archive, e.g. assets/ from assets.vkbpak
+ */
+static FileSystemPtr mount_packed_directories(FileSystemPtr file_system)
+{
+	for (const char *directory_name : {"assets", "shaders"})
+	{
+		auto directory    = file_system->external_storage_directory() / directory_name;
+		auto archive_path = directory;
+		archive_path += ARCHIVE_EXTENSION;
+
+		if (!file_system->is_file(archive_path))
+		{
+			continue;
+		}
+
+		try
+		{
+			file_system = mount_archive(file_system, archive_path, directory);
+			LOGI("Serving {} from {}", directory.string(), archive_path.string());
+		}
+		catch (const std::exception &e)
+		{
+			LOGW("Failed to mount archive {}: {}", archive_path.string(), e.what());
+		}
+	}
+
+	return file_system;
+}
+
 void init()
 {
-	fs = std::make_shared<StdFileSystem>();
+	fs = mount_packed_directories(std::make_shared<StdFileSystem>());
 }
 
 void init_with_context(const PlatformContext &context)
 {
-	fs = std::make_shared<StdFileSystem>(
+	fs = mount_packed_directories(std::make_shared<StdFileSystem>(
 	    context.external_storage_directory(),
-	    context.temp_directory());
+	    context.temp_directory()));
 }
 
 FileSystemPtr get()
@@ -46,11 +127,59 @@ FileSystemPtr get()
 	return fs;
 }
 
+MappedFilePtr make_mapped_file(std::vector<uint8_t> &&data)
+{
+	return std::make_shared<MemoryMappedFile>(std::move(data));
+}
+
+FileSystem::FileSystem() = default;
+
+// The queue reads files by itself, so its pending reads complete safely while the derived filesystem is destroyed
+FileSystem::~FileSystem() = default;
+
 void FileSystem::write_file(const Path &path, const std::string &data)
 {
 	write_file(path, std::vector<uint8_t>(data.begin(), data.end()));
 }
 
+void FileSystem::write_file_atomic(const Path &path, const std::vector<uint8_t> &data)
+{
+	auto temp_path = path;
+	temp_path += unique_temp_suffix();
+
+	try
+	{
+		write_file(temp_path, data);
+	}
+	catch (...)
+	{
+		if (exists(temp_path))
+		{
+			remove(temp_path);
+		}
+		throw;
+	}
+
+	try
+	{
+		rename(temp_path, path);
+	}
+	catch (...)
+	{
+		remove(temp_path);
+
+		// Another writer may hold the destination while it replaces it, e.g. on Windows. Writers of a path write the
+		// same contents, so the file it put in place is as good as ours.
+		if (exists(path))
+		{
+			LOGD("Lost the race to write {}, keeping the file of the other writer", path.string());
+			return;
+		}
+
+		throw;
+	}
+}
+
 std::string FileSystem::read_file_string(const Path &path)
 {
 	auto bin = read_file_binary(path);
@@ -63,5 +192,21 @@ std::vector<uint8_t> FileSystem::read_file_binary(const Path &path)
 	return read_chunk(path, 0, stat.size);
 }
 
+std::future<std::vector<uint8_t>> FileSystem::read_chunk_async(const Path &path, size_t offset, size_t count)
+{
+	return get_read_queue().push(path, offset, count);
+}
+
+std::future<std::vector<uint8_t>> FileSystem::read_file_binary_async(const Path &path)
+{
+	return get_read_queue().push(path, 0, ReadQueue::TO_END);
+}
+
+ReadQueue &FileSystem::get_read_queue()
+{
+	std::call_once(read_queue_flag, [this]() { read_queue = std::make_unique<ReadQueue>(READ_QUEUE_THREAD_COUNT); });
+	return *read_queue;
+}
+
 }        // namespace filesystem
 }        // namespace vkb
\ No newline at end of file
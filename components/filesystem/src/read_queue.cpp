@@ -0,0 +1,277 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "read_queue.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#else
+#	include <cerrno>
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace vkb
+{
+namespace filesystem
+{
+namespace
+{
+// Requests taken by a thread at once, small enough for the other threads to share a burst of requests
+constexpr size_t MAX_BATCH_SIZE = 16;
+
+// A file opened for positional reads, which do not move a shared file cursor
+class PositionalFile
+{
+  public:
+	explicit PositionalFile(const Path &path)
+	{
+#if defined(_WIN32)
+		handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error("Failed to open file for reading");
+		}
+
+		LARGE_INTEGER file_size{};
+		if (!GetFileSizeEx(handle, &file_size))
+		{
+			CloseHandle(handle);
+			throw std::runtime_error("Failed to get the size of the file to read");
+		}
+
+		_size = static_cast<size_t>(file_size.QuadPart);
+#else
+		handle = open(path.c_str(), O_RDONLY);
+		if (handle < 0)
+		{
+			throw std::runtime_error("Failed to open file for reading");
+		}
+
+		struct stat file_stat
+		{};
+		if (fstat(handle, &file_stat) != 0)
+		{
+			close(handle);
+			throw std::runtime_error("Failed to get the size of the file to read");
+		}
+
+		_size = static_cast<size_t>(file_stat.st_size);
+#endif
+	}
+
+	~PositionalFile()
+	{
+#if defined(_WIN32)
+		CloseHandle(handle);
+#else
+		close(handle);
+#endif
+	}
+
+	PositionalFile(const PositionalFile &)            = delete;
+	PositionalFile &operator=(const PositionalFile &) = delete;
+
+	size_t size() const
+	{
+		return _size;
+	}
+
+	void read(size_t offset, uint8_t *dst, size_t count)
+	{
+		while (count > 0)
+		{
+#if defined(_WIN32)
+			// The offset of a synchronous read is given by its overlapped structure
+			OVERLAPPED overlapped{};
+			overlapped.Offset     = static_cast<DWORD>(offset);
+			overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+
+			DWORD read_count = 0;
+			if (!ReadFile(handle, dst, static_cast<DWORD>(std::min<size_t>(count, 1u << 30)), &read_count, &overlapped) || read_count == 0)
+			{
+				throw std::runtime_error("Failed to read file");
+			}
+#else
+			ssize_t read_count = pread(handle, dst, count, static_cast<off_t>(offset));
+			if (read_count < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (read_count <= 0)
+			{
+				throw std::runtime_error("Failed to read file");
+			}
+#endif
+
+			offset += static_cast<size_t>(read_count);
+			dst += read_count;
+			count -= static_cast<size_t>(read_count);
+		}
+	}
+
+  private:
+#if defined(_WIN32)
+	HANDLE handle{INVALID_HANDLE_VALUE};
+#else
+	int handle{-1};
+#endif
+	size_t _size{0};
+};
+}        // namespace
+
+ReadQueue::ReadQueue(uint32_t thread_count)
+{
+	threads.reserve(thread_count);
+	for (uint32_t i = 0; i < thread_count; ++i)
+	{
+		threads.emplace_back(&ReadQueue::run, this);
+	}
+}
+
+ReadQueue::~ReadQueue()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+
+std::future<std::vector<uint8_t>> ReadQueue::push(const Path &path, size_t offset, size_t count, Transform transform)
+{
+	Request request{path, offset, count, std::move(transform), {}};
+
+	auto future = request.promise.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.push_back(std::move(request));
+	}
+	condition.notify_one();
+
+	return future;
+}
+
+void ReadQueue::run()
+{
+	std::vector<Request> batch;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this] { return stopping || !pending.empty(); });
+
+			// The pending requests are drained before stopping, so that no future is left without a value
+			if (pending.empty())
+			{
+				return;
+			}
+
+			auto batch_size = std::min(pending.size(), MAX_BATCH_SIZE);
+			batch.assign(std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.begin() + batch_size));
+			pending.erase(pending.begin(), pending.begin() + batch_size);
+		}
+
+		read_batch(batch);
+		batch.clear();
+	}
+}
+
+void ReadQueue::read_batch(std::vector<Request> &batch)
+{
+	// Reading each file once in increasing offsets lets the OS read ahead, instead of seeking back and forth
+	std::stable_sort(batch.begin(), batch.end(), [](const Request &a, const Request &b) {
+		return a.path != b.path ? a.path < b.path : a.offset < b.offset;
+	});
+
+	std::unique_ptr<PositionalFile> file;
+	std::exception_ptr              open_error;
+
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		auto &request = batch[i];
+
+		if (i == 0 || request.path != batch[i - 1].path)
+		{
+			file.reset();
+			open_error = nullptr;
+
+			try
+			{
+				file = std::make_unique<PositionalFile>(request.path);
+			}
+			catch (...)
+			{
+				open_error = std::current_exception();
+			}
+		}
+
+		if (open_error)
+		{
+			request.promise.set_exception(open_error);
+			continue;
+		}
+
+		try
+		{
+			auto count = request.count;
+			if (count == TO_END)
+			{
+				count = request.offset <= file->size() ? file->size() - request.offset : 0;
+			}
+
+			std::vector<uint8_t> data;
+
+			// Out of bounds reads return no data, as FileSystem::read_chunk does
+			if (request.offset <= file->size() && count <= file->size() - request.offset)
+			{
+				data.resize(count);
+				file->read(request.offset, data.data(), count);
+			}
+
+			if (request.transform)
+			{
+				data = request.transform(std::move(data));
+			}
+
+			request.promise.set_value(std::move(data));
+		}
+		catch (...)
+		{
+			request.promise.set_exception(std::current_exception());
+		}
+	}
+}
+}        // namespace filesystem
+}        // namespace vkb
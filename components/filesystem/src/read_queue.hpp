@@ -0,0 +1,84 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "filesystem/filesystem.hpp"
+
+namespace vkb
+{
+namespace filesystem
+{
+// Reads files on dedicated I/O threads, so that blocking reads do not stall the threads which consume their contents.
+// Each thread takes a batch of pending requests and reads it ordered by file and offset, opening every file once,
+// with positional reads so that the requests of a file do not share a file cursor.
+class ReadQueue
+{
+  public:
+	// Count of a request which reads the file from its offset to its end
+	static constexpr size_t TO_END = std::numeric_limits<size_t>::max();
+
+	// Applied to the data read on the I/O thread, e.g. to decompress it
+	using Transform = std::function<std::vector<uint8_t>(std::vector<uint8_t> &&)>;
+
+	explicit ReadQueue(uint32_t thread_count);
+
+	// Completes the pending requests before returning
+	~ReadQueue();
+
+	ReadQueue(const ReadQueue &)            = delete;
+	ReadQueue &operator=(const ReadQueue &) = delete;
+
+	// Queue a read, with the semantics of FileSystem::read_chunk
+	std::future<std::vector<uint8_t>> push(const Path &path, size_t offset, size_t count, Transform transform = nullptr);
+
+  private:
+	struct Request
+	{
+		Path                               path;
+		size_t                             offset;
+		size_t                             count;
+		Transform                          transform;
+		std::promise<std::vector<uint8_t>> promise;
+	};
+
+	void run();
+
+	static void read_batch(std::vector<Request> &batch);
+
+	std::mutex mutex;
+
+	std::condition_variable condition;
+
+	// Requests in submission order
+	std::vector<Request> pending;
+
+	bool stopping{false};
+
+	std::vector<std::thread> threads;
+};
+}        // namespace filesystem
+}        // namespace vkb
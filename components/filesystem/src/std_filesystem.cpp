@@ -22,10 +22,129 @@
 #include <filesystem>
 #include <fstream>
 
+#if defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
 namespace vkb
 {
 namespace filesystem
 {
+namespace
+{
+class StdMappedFile final : public MappedFile
+{
+  public:
+	explicit StdMappedFile(const Path &path)
+	{
+#if defined(_WIN32)
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error("Failed to open file for mapping");
+		}
+
+		LARGE_INTEGER file_size{};
+		if (!GetFileSizeEx(file, &file_size))
+		{
+			CloseHandle(file);
+			throw std::runtime_error("Failed to get the size of the file to map");
+		}
+
+		_size = static_cast<size_t>(file_size.QuadPart);
+
+		// Empty files cannot be mapped, they are represented by an empty view
+		if (_size > 0)
+		{
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping)
+			{
+				_data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+				// The view keeps the mapping alive
+				CloseHandle(mapping);
+			}
+		}
+
+		CloseHandle(file);
+#else
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			throw std::runtime_error("Failed to open file for mapping");
+		}
+
+		struct stat file_stat
+		{};
+		if (fstat(file, &file_stat) != 0)
+		{
+			close(file);
+			throw std::runtime_error("Failed to get the size of the file to map");
+		}
+
+		_size = static_cast<size_t>(file_stat.st_size);
+
+		// Empty files cannot be mapped, they are represented by an empty view
+		if (_size > 0)
+		{
+			void *mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (mapping != MAP_FAILED)
+			{
+				_data = static_cast<const uint8_t *>(mapping);
+			}
+		}
+
+		// The mapping keeps the file alive
+		close(file);
+#endif
+
+		if (_size > 0 && !_data)
+		{
+			throw std::runtime_error("Failed to map file");
+		}
+	}
+
+	~StdMappedFile() override
+	{
+		if (!_data)
+		{
+			return;
+		}
+
+#if defined(_WIN32)
+		UnmapViewOfFile(_data);
+#else
+		munmap(const_cast<uint8_t *>(_data), _size);
+#endif
+	}
+
+	const uint8_t *data() const override
+	{
+		return _data;
+	}
+
+	size_t size() const override
+	{
+		return _size;
+	}
+
+  private:
+	const uint8_t *_data{nullptr};
+	size_t         _size{0};
+};
+}        // namespace
+
 FileStat StdFileSystem::stat_file(const Path &path)
 {
 	std::error_code ec;
@@ -140,6 +259,23 @@ void StdFileSystem::remove(const Path &path)
 	}
 }
 
+void StdFileSystem::rename(const Path &from, const Path &to)
+{
+	std::error_code ec;
+
+	std::filesystem::rename(from, to, ec);
+
+	if (ec)
+	{
+		throw std::runtime_error("Failed to rename file");
+	}
+}
+
+MappedFilePtr StdFileSystem::map_file(const Path &path)
+{
+	return std::make_shared<StdMappedFile>(path);
+}
+
 const Path &StdFileSystem::external_storage_directory() const
 {
 	return _external_storage_directory;
@@ -49,6 +49,10 @@ class StdFileSystem final : public FileSystem
 
 	virtual void remove(const Path &path) override;
 
+	void rename(const Path &from, const Path &to) override;
+
+	MappedFilePtr map_file(const Path &path) override;
+
 	const Path &external_storage_directory() const override;
 
 	const Path &temp_directory() const override;
@@ -0,0 +1,149 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "filesystem/archive.hpp"
+#include "filesystem/filesystem.hpp"
+
+using namespace vkb::filesystem;
+
+namespace
+{
+std::vector<uint8_t> to_bytes(const std::string &data)
+{
+	return {data.begin(), data.end()};
+}
+}        // namespace
+
+TEST_CASE("Archive serves the files of a directory", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto root         = fs->temp_directory() / "vulkan_samples";
+	const auto directory    = root / "archive_test";
+	const auto archive_path = root / "archive_test.vkbpak";
+
+	if (!fs->is_directory(root))
+	{
+		fs->create_directory(root);
+	}
+
+	// Compresses well, so it is stored compressed
+	const std::string compressible(10000, 'a');
+
+	// Does not compress, so it is stored as is
+	std::string incompressible(5000, '\0');
+	uint32_t    state = 1;
+	for (auto &c : incompressible)
+	{
+		state = state * 1664525u + 1013904223u;
+		c     = static_cast<char>(state >> 24);
+	}
+
+	{
+		ArchiveWriter writer{archive_path};
+		writer.add("compressible.txt", to_bytes(compressible));
+		writer.add("nested/incompressible.bin", to_bytes(incompressible));
+		writer.add("nested/empty.txt", {});
+		writer.finish();
+	}
+
+	auto archive_fs = mount_archive(fs, archive_path, directory);
+
+	SECTION("Lists files and directories")
+	{
+		REQUIRE(archive_fs->is_directory(directory));
+		REQUIRE(archive_fs->is_directory(directory / "nested"));
+		REQUIRE(archive_fs->is_directory(directory / "nested/"));
+		REQUIRE(archive_fs->is_file(directory / "compressible.txt"));
+		REQUIRE(archive_fs->is_file(directory / "nested" / "incompressible.bin"));
+		REQUIRE(archive_fs->stat_file(directory / "nested" / "incompressible.bin").size == incompressible.size());
+		REQUIRE_FALSE(archive_fs->exists(directory / "missing.txt"));
+		REQUIRE_FALSE(archive_fs->exists(directory / "nest"));
+	}
+
+	SECTION("Reads stored and compressed files")
+	{
+		REQUIRE(archive_fs->read_file_string(directory / "compressible.txt") == compressible);
+		REQUIRE(archive_fs->read_file_string(directory / "nested" / "incompressible.bin") == incompressible);
+		REQUIRE(archive_fs->read_file_binary(directory / "nested" / "empty.txt").empty());
+
+		const auto chunk = archive_fs->read_chunk(directory / "nested" / "incompressible.bin", 100, 10);
+		REQUIRE(std::string(chunk.begin(), chunk.end()) == incompressible.substr(100, 10));
+
+		REQUIRE(archive_fs->read_chunk(directory / "compressible.txt", 9995, 10).empty());
+	}
+
+	SECTION("Maps stored files in place")
+	{
+		const auto mapped = archive_fs->map_file(directory / "nested" / "incompressible.bin");
+		REQUIRE(mapped->size() == incompressible.size());
+		REQUIRE(std::string(reinterpret_cast<const char *>(mapped->data()), mapped->size()) == incompressible);
+		REQUIRE(reinterpret_cast<uintptr_t>(mapped->data()) % ARCHIVE_ALIGNMENT == 0);
+
+		const auto decompressed = archive_fs->map_file(directory / "compressible.txt");
+		REQUIRE(std::string(reinterpret_cast<const char *>(decompressed->data()), decompressed->size()) == compressible);
+	}
+
+	SECTION("Reads files asynchronously")
+	{
+		auto compressed_read = archive_fs->read_file_binary_async(directory / "compressible.txt");
+		auto chunk_read      = archive_fs->read_chunk_async(directory / "compressible.txt", 10, 5);
+		auto stored_read     = archive_fs->read_chunk_async(directory / "nested" / "incompressible.bin", 100, 10);
+
+		const auto compressed_data = compressed_read.get();
+		REQUIRE(std::string(compressed_data.begin(), compressed_data.end()) == compressible);
+
+		REQUIRE(chunk_read.get() == to_bytes("aaaaa"));
+
+		const auto stored_data = stored_read.get();
+		REQUIRE(std::string(stored_data.begin(), stored_data.end()) == incompressible.substr(100, 10));
+	}
+
+	SECTION("Serves other paths from the underlying filesystem")
+	{
+		const auto other_file = root / "archive_other_test.txt";
+
+		REQUIRE_NOTHROW(archive_fs->write_file(other_file, "Hello, World!"));
+		REQUIRE(fs->read_file_string(other_file) == "Hello, World!");
+		REQUIRE(archive_fs->read_file_string(other_file) == "Hello, World!");
+		REQUIRE_NOTHROW(archive_fs->remove(other_file));
+		REQUIRE_FALSE(fs->exists(other_file));
+	}
+
+	archive_fs.reset();
+
+	REQUIRE_NOTHROW(fs->remove(archive_path));
+}
+
+TEST_CASE("Archive rejects invalid files", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto archive_path = fs->temp_directory() / "vulkan_samples" / "archive_invalid_test.vkbpak";
+
+	fs->write_file(archive_path, "Not an archive, but long enough for a header");
+
+	REQUIRE_THROWS(mount_archive(fs, archive_path, fs->temp_directory() / "vulkan_samples" / "archive_invalid_test"));
+
+	REQUIRE_NOTHROW(fs->remove(archive_path));
+}
@@ -19,6 +19,10 @@
 
 #include "filesystem/filesystem.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using namespace vkb::filesystem;
 
 void create_test_file(FileSystemPtr fs, const Path &path, const std::string &data)
@@ -32,6 +36,22 @@ void create_test_file(FileSystemPtr fs, const Path &path, const std::string &dat
 	REQUIRE(data == written_data);
 }
 
+// Counts the temporary files write_file_atomic() left next to the file
+size_t count_temp_files(const Path &path)
+{
+	size_t     count  = 0;
+	const auto prefix = path.filename().string() + ".";
+	for (const auto &entry : std::filesystem::directory_iterator(path.parent_path()))
+	{
+		const auto name = entry.path().filename().string();
+		if (name.size() > prefix.size() && name.compare(0, prefix.size(), prefix) == 0 && entry.path().extension() == ".tmp")
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
 void delete_test_file(FileSystemPtr fs, const Path &path)
 {
 	REQUIRE(fs);
@@ -123,4 +143,157 @@ TEST_CASE("Read binary file", "[filesystem]")
 	REQUIRE(binary_str == test_data);
 
 	delete_test_file(fs, test_file);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Map file", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto        test_file = fs->temp_directory() / "vulkan_samples" / "map_test.txt";
+	const std::string test_data = "Hello, World!";
+
+	create_test_file(fs, test_file, test_data);
+
+	{
+		const auto mapped = fs->map_file(test_file);
+		REQUIRE(mapped);
+		REQUIRE(mapped->size() == test_data.size());
+
+		std::string mapped_str(reinterpret_cast<const char *>(mapped->data()), mapped->size());
+		REQUIRE(mapped_str == test_data);
+	}
+
+	delete_test_file(fs, test_file);
+
+	const auto empty_file = fs->temp_directory() / "vulkan_samples" / "map_empty_test.txt";
+
+	create_test_file(fs, empty_file, "");
+
+	{
+		const auto mapped = fs->map_file(empty_file);
+		REQUIRE(mapped->size() == 0);
+		REQUIRE(mapped->data() == nullptr);
+	}
+
+	delete_test_file(fs, empty_file);
+
+	REQUIRE_THROWS(fs->map_file(fs->temp_directory() / "vulkan_samples" / "map_missing_test.txt"));
+}
+
+TEST_CASE("Write file atomically", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto test_file = fs->temp_directory() / "vulkan_samples" / "atomic_test.txt";
+
+	create_test_file(fs, test_file, "Hello, World!");
+
+	const std::string replaced_data = "Goodbye";
+	REQUIRE_NOTHROW(fs->write_file_atomic(test_file, std::vector<uint8_t>(replaced_data.begin(), replaced_data.end())));
+	REQUIRE(fs->read_file_string(test_file) == replaced_data);
+
+	REQUIRE(count_temp_files(test_file) == 0);
+
+	delete_test_file(fs, test_file);
+}
+
+TEST_CASE("Write file atomically from several threads", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto test_file = fs->temp_directory() / "vulkan_samples" / "atomic_concurrent_test.txt";
+
+	// Large enough for the writes to overlap, each thread writes its own byte so that a torn file is detected
+	constexpr size_t   data_size    = 1024 * 1024;
+	constexpr uint32_t thread_count = 8;
+	constexpr uint32_t write_count  = 4;
+
+	std::vector<std::thread> threads;
+	std::atomic<uint32_t>    failures{0};
+	for (uint32_t i = 0; i < thread_count; ++i)
+	{
+		threads.emplace_back([&, i]() {
+			const std::vector<uint8_t> data(data_size, static_cast<uint8_t>('a' + i));
+			for (uint32_t j = 0; j < write_count; ++j)
+			{
+				try
+				{
+					fs->write_file_atomic(test_file, data);
+				}
+				catch (...)
+				{
+					++failures;
+				}
+			}
+		});
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	REQUIRE(failures == 0);
+
+	const auto written_data = fs->read_file_binary(test_file);
+	REQUIRE(written_data.size() == data_size);
+	REQUIRE(std::all_of(written_data.begin(), written_data.end(), [&](uint8_t byte) { return byte == written_data[0]; }));
+
+	REQUIRE(count_temp_files(test_file) == 0);
+
+	delete_test_file(fs, test_file);
+}
+
+TEST_CASE("Read file asynchronously", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto        test_file = fs->temp_directory() / "vulkan_samples" / "async_test.txt";
+	const std::string test_data = "Hello, World!";
+
+	create_test_file(fs, test_file, test_data);
+
+	const auto other_file = fs->temp_directory() / "vulkan_samples" / "async_other_test.txt";
+
+	create_test_file(fs, other_file, "Goodbye");
+
+	// Requests of several files, out of order, are batched together
+	std::vector<std::future<std::vector<uint8_t>>> chunks;
+	for (size_t i = 0; i < 64; ++i)
+	{
+		chunks.push_back(fs->read_chunk_async(test_file, test_data.size() - 1 - i % test_data.size(), 1));
+	}
+
+	auto whole_file    = fs->read_file_binary_async(test_file);
+	auto other_chunk   = fs->read_chunk_async(other_file, 4, 3);
+	auto out_of_bounds = fs->read_chunk_async(test_file, 10, 5);
+	auto missing       = fs->read_file_binary_async(fs->temp_directory() / "vulkan_samples" / "async_missing_test.txt");
+
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		const auto chunk = chunks[i].get();
+		REQUIRE(chunk.size() == 1);
+		REQUIRE(chunk[0] == static_cast<uint8_t>(test_data[test_data.size() - 1 - i % test_data.size()]));
+	}
+
+	const auto whole_file_data = whole_file.get();
+	REQUIRE(std::string(whole_file_data.begin(), whole_file_data.end()) == test_data);
+
+	const auto other_chunk_data = other_chunk.get();
+	REQUIRE(std::string(other_chunk_data.begin(), other_chunk_data.end()) == "bye");
+
+	REQUIRE(out_of_bounds.get().empty());
+
+	REQUIRE_THROWS(missing.get());
+
+	delete_test_file(fs, test_file);
+	delete_test_file(fs, other_file);
+}
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -21,6 +21,7 @@
 #include "core/swapchain.h"
 #include "gltf_loader.h"
 #include "scene_graph/components/image.h"
+#include "scene_graph/components/image/ktx.h"
 #include "scene_graph/components/sampler.h"
 #include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
@@ -32,16 +33,27 @@ bool ApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 		return false;
 	}
 
-	depth_format = vkb::get_suitable_depth_format(get_device().get_gpu().get_handle());
+	depth_format = vkb::get_suitable_depth_format(get_device().get_gpu());
+
+	// Supercompressed textures loaded by load_texture() are transcoded to a format the GPU supports
+	vkb::sg::Ktx::select_transcode_format(get_device().get_gpu());
 
 	// Create synchronization objects
-	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
-	// Create a semaphore used to synchronize image presentation
-	// Ensures that the current swapchain render target has completed presentation and has been released by the presentation engine, ready for rendering
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphores.acquired_image_ready));
-	// Create a semaphore used to synchronize command submission
-	// Ensures that the image is not presented until all commands have been sumbitted and executed
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphores.render_complete));
+	if (frames_in_flight > 1)
+	{
+		// The semaphores are switched by prepare_frame()
+		create_frame_syncs();
+	}
+	else
+	{
+		VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
+		// Create a semaphore used to synchronize image presentation
+		// Ensures that the current swapchain render target has completed presentation and has been released by the presentation engine, ready for rendering
+		VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphores.acquired_image_ready));
+		// Create a semaphore used to synchronize command submission
+		// Ensures that the image is not presented until all commands have been sumbitted and executed
+		VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphores.render_complete));
+	}
 
 	// Set up submit info structure
 	// Semaphores will stay the same during application lifetime
@@ -123,6 +135,9 @@ bool ApiVulkanSample::resize(const uint32_t _width, const uint32_t _height)
 	// Ensure all operations on the device have been finished before destroying resources
 	get_device().wait_idle();
 
+	// The images of the new swapchain have not been rendered to
+	std::fill(image_fences.begin(), image_fences.end(), VK_NULL_HANDLE);
+
 	create_swapchain_buffers();
 
 	// Recreate the frame buffers
@@ -166,7 +181,7 @@ void ApiVulkanSample::create_render_context()
 	// We always want an sRGB surface to match the display.
 	// If we used a UNORM surface, we'd have to do the conversion to sRGB ourselves at the end of our fragment shaders.
 	auto surface_priority_list = std::vector<VkSurfaceFormatKHR>{{VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
-	                                                             {VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR}};
+	                                                                   {VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR}};
 
 	VulkanSample::create_render_context(surface_priority_list);
 }
@@ -402,6 +417,8 @@ void ApiVulkanSample::create_command_buffers()
 	        static_cast<uint32_t>(draw_cmd_buffers.size()));
 
 	VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &allocate_info, draw_cmd_buffers.data()));
+
+	command_buffers_out_of_date.assign(draw_cmd_buffers.size(), false);
 }
 
 void ApiVulkanSample::destroy_command_buffers()
@@ -486,7 +503,14 @@ void ApiVulkanSample::update_overlay(float delta_time, const std::function<void(
 
 		get_gui().update(delta_time);
 
-		if (get_gui().update_buffers() || get_gui().get_drawer().is_dirty())
+		// The frames in flight may still read the buffers of the gui
+		std::function<void()> before_write;
+		if (frames_in_flight > 1)
+		{
+			before_write = [this]() { wait_for_frames_in_flight(); };
+		}
+
+		if (get_gui().update_buffers(before_write) || get_gui().get_drawer().is_dirty())
 		{
 			rebuild_command_buffers();
 			get_gui().get_drawer().clear();
@@ -509,6 +533,16 @@ void ApiVulkanSample::draw_ui(const VkCommandBuffer command_buffer)
 
 void ApiVulkanSample::prepare_frame()
 {
+	if (frames_in_flight > 1)
+	{
+		auto &frame_sync = frame_syncs[frame_index];
+
+		// Wait for the frame which last used this frame index, so that its resources may be written again
+		VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &frame_sync.fence, VK_TRUE, UINT64_MAX));
+
+		semaphores.acquired_image_ready = frame_sync.acquired_image_ready;
+	}
+
 	if (get_render_context().has_swapchain())
 	{
 		handle_surface_changes();
@@ -526,10 +560,66 @@ void ApiVulkanSample::prepare_frame()
 			VK_CHECK(result);
 		}
 	}
+
+	if (frames_in_flight > 1)
+	{
+		auto &frame_sync = frame_syncs[frame_index];
+
+		if (current_buffer >= image_fences.size())
+		{
+			image_fences.resize(current_buffer + 1, VK_NULL_HANDLE);
+		}
+
+		// Images may be acquired out of order, so the command buffer of the image may still be used by another frame
+		if (image_fences[current_buffer] != VK_NULL_HANDLE && image_fences[current_buffer] != frame_sync.fence)
+		{
+			VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &image_fences[current_buffer], VK_TRUE, UINT64_MAX));
+		}
+		image_fences[current_buffer] = frame_sync.fence;
+
+		while (current_buffer >= image_render_complete_semaphores.size())
+		{
+			VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
+			VkSemaphore           semaphore             = VK_NULL_HANDLE;
+			VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphore));
+			image_render_complete_semaphores.push_back(semaphore);
+		}
+		semaphores.render_complete = image_render_complete_semaphores[current_buffer];
+
+		// Signaled again by submit_frame(), once the work submitted for this frame has completed
+		VK_CHECK(vkResetFences(get_device().get_handle(), 1, &frame_sync.fence));
+	}
+
+	// The frames which read the command buffer of the image have completed
+	if (lazy_command_buffer_rebuild && command_buffers_out_of_date[current_buffer])
+	{
+		VK_CHECK(vkResetCommandBuffer(draw_cmd_buffers[current_buffer], 0));
+		build_command_buffer(current_buffer);
+		command_buffers_out_of_date[current_buffer] = false;
+	}
+
+	// The frames which read the slices of the image have completed
+	for (auto &ring : uniform_rings)
+	{
+		ring->write(current_buffer);
+	}
+
+	frame_prepared = true;
 }
 
 void ApiVulkanSample::submit_frame()
 {
+	frame_prepared = false;
+
+	if (frames_in_flight > 1)
+	{
+		// A fence signal waits for all the batches submitted before it to the queue, so an empty submission signals the
+		// fence of the frame once the work the sample submitted has completed, however many submissions it made
+		VK_CHECK(vkQueueSubmit(queue, 0, nullptr, frame_syncs[frame_index].fence));
+
+		frame_index = (frame_index + 1) % frames_in_flight;
+	}
+
 	if (get_render_context().has_swapchain())
 	{
 		const auto &queue = get_device().get_queue_by_present(0);
@@ -575,10 +665,14 @@ void ApiVulkanSample::submit_frame()
 		}
 	}
 
-	// DO NOT USE
-	// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
-	// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
-	VK_CHECK(get_device().get_queue_by_present(0).wait_idle());
+	if (frames_in_flight == 1)
+	{
+		// DO NOT USE
+		// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
+		// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
+		// See set_frames_in_flight() for the alternative.
+		VK_CHECK(get_device().get_queue_by_present(0).wait_idle());
+	}
 }
 
 ApiVulkanSample::~ApiVulkanSample()
@@ -616,8 +710,20 @@ ApiVulkanSample::~ApiVulkanSample()
 
 		vkDestroyCommandPool(get_device().get_handle(), cmd_pool, nullptr);
 
-		vkDestroySemaphore(get_device().get_handle(), semaphores.acquired_image_ready, nullptr);
-		vkDestroySemaphore(get_device().get_handle(), semaphores.render_complete, nullptr);
+		if (frame_syncs.empty())
+		{
+			vkDestroySemaphore(get_device().get_handle(), semaphores.acquired_image_ready, nullptr);
+			vkDestroySemaphore(get_device().get_handle(), semaphores.render_complete, nullptr);
+		}
+		for (auto &frame_sync : frame_syncs)
+		{
+			vkDestroySemaphore(get_device().get_handle(), frame_sync.acquired_image_ready, nullptr);
+			vkDestroyFence(get_device().get_handle(), frame_sync.fence, nullptr);
+		}
+		for (auto &semaphore : image_render_complete_semaphores)
+		{
+			vkDestroySemaphore(get_device().get_handle(), semaphore, nullptr);
+		}
 		for (auto &fence : wait_fences)
 		{
 			vkDestroyFence(get_device().get_handle(), fence, nullptr);
@@ -631,8 +737,24 @@ void ApiVulkanSample::view_changed()
 void ApiVulkanSample::build_command_buffers()
 {}
 
+void ApiVulkanSample::build_command_buffer(uint32_t index)
+{}
+
 void ApiVulkanSample::rebuild_command_buffers()
 {
+	if (lazy_command_buffer_rebuild)
+	{
+		// Recorded by prepare_frame() as their images are acquired
+		std::fill(command_buffers_out_of_date.begin(), command_buffers_out_of_date.end(), true);
+		return;
+	}
+
+	if (frames_in_flight > 1)
+	{
+		// Resetting the pool resets the command buffers of the frames still in flight
+		get_device().wait_idle();
+	}
+
 	vkResetCommandPool(get_device().get_handle(), cmd_pool, 0);
 	build_command_buffers();
 }
@@ -648,11 +770,80 @@ void ApiVulkanSample::create_synchronization_primitives()
 	}
 }
 
+void ApiVulkanSample::set_lazy_command_buffer_rebuild(bool enable)
+{
+	lazy_command_buffer_rebuild = enable;
+}
+
+void ApiVulkanSample::set_frames_in_flight(uint32_t count)
+{
+	assert(count > 0 && frame_syncs.empty() && "The frames in flight are set once, before prepare()");
+
+	frames_in_flight = count;
+}
+
+uint32_t ApiVulkanSample::get_frames_in_flight() const
+{
+	return frames_in_flight;
+}
+
+uint32_t ApiVulkanSample::get_frame_index() const
+{
+	return frame_index;
+}
+
+void ApiVulkanSample::wait_for_frames_in_flight()
+{
+	for (auto &frame_sync : frame_syncs)
+	{
+		VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &frame_sync.fence, VK_TRUE, UINT64_MAX));
+	}
+}
+
+UniformRing &ApiVulkanSample::create_uniform_ring(VkDeviceSize size)
+{
+	uniform_rings.push_back(std::make_unique<UniformRing>(get_device(), size, static_cast<uint32_t>(draw_cmd_buffers.size())));
+
+	return *uniform_rings.back();
+}
+
+void ApiVulkanSample::update_uniform_ring(UniformRing &ring, const void *data, size_t size)
+{
+	ring.set_data(data, size);
+
+	if (frame_prepared)
+	{
+		ring.write(current_buffer);
+	}
+}
+
+void ApiVulkanSample::create_frame_syncs()
+{
+	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
+	// Signaled, so that the first wait of each frame does not block
+	VkFenceCreateInfo fence_create_info = vkb::initializers::fence_create_info(VK_FENCE_CREATE_SIGNALED_BIT);
+
+	frame_syncs.resize(frames_in_flight);
+	for (auto &frame_sync : frame_syncs)
+	{
+		VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &frame_sync.acquired_image_ready));
+		VK_CHECK(vkCreateFence(get_device().get_handle(), &fence_create_info, nullptr, &frame_sync.fence));
+	}
+
+	semaphores.acquired_image_ready = frame_syncs[0].acquired_image_ready;
+	semaphores.render_complete      = VK_NULL_HANDLE;
+}
+
 void ApiVulkanSample::create_command_pool()
 {
 	VkCommandPoolCreateInfo command_pool_info = {};
 	command_pool_info.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	command_pool_info.queueFamilyIndex        = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0).get_family_index();
+	if (lazy_command_buffer_rebuild)
+	{
+		// The command buffers are reset one at a time
+		command_pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	}
 	VK_CHECK(vkCreateCommandPool(get_device().get_handle(), &command_pool_info, nullptr, &cmd_pool));
 }
 
@@ -963,8 +1154,8 @@ void ApiVulkanSample::handle_surface_changes()
 {
 	VkSurfaceCapabilitiesKHR surface_properties;
 	VK_CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(get_device().get_gpu().get_handle(),
-	                                                   get_render_context().get_swapchain().get_surface(),
-	                                                   &surface_properties));
+	                                                         get_render_context().get_swapchain().get_surface(),
+	                                                         &surface_properties));
 
 	if (surface_properties.currentExtent.width != get_render_context().get_surface_extent().width ||
 	    surface_properties.currentExtent.height != get_render_context().get_surface_extent().height)
@@ -1014,6 +1205,16 @@ VkDescriptorImageInfo ApiVulkanSample::create_descriptor(Texture &texture, VkDes
 	return descriptor;
 }
 
+vkb::UploadManager &ApiVulkanSample::get_upload_manager()
+{
+	if (!upload_manager)
+	{
+		upload_manager = std::make_unique<vkb::UploadManager>(get_device());
+	}
+
+	return *upload_manager;
+}
+
 Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::ContentType content_type)
 {
 	Texture texture{};
@@ -1021,12 +1222,6 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	texture.image = vkb::sg::Image::load(file, file, content_type);
 	texture.image->create_vk_image(get_device());
 
-	const auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(get_device(), texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> bufferCopyRegions;
 
@@ -1047,37 +1242,15 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 		bufferCopyRegions.push_back(buffer_copy_region);
 	}
 
-	VkImageSubresourceRange subresource_range = {};
-	subresource_range.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
-	subresource_range.baseMipLevel            = 0;
-	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
-	subresource_range.layerCount              = 1;
-
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_UNDEFINED,
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(bufferCopyRegions.size()),
-	    bufferCopyRegions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	                             subresource_range);
-
-	get_device().flush_command_buffer(command_buffer, queue.get_handle());
+	// The copies run on the transfer queue, then the graphics queue acquires the texture
+	get_upload_manager().upload_image(texture.image->get_vk_image_view(),
+	                                  texture.image->get_data().data(),
+	                                  texture.image->get_data().size(),
+	                                  bufferCopyRegions,
+	                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                                  VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                                  VK_ACCESS_SHADER_READ_BIT);
+	get_upload_manager().finish();
 
 	// Calculate valid filter and mipmap modes
 	VkFilter            filter      = VK_FILTER_LINEAR;
@@ -1117,12 +1290,6 @@ Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Im
 	texture.image = vkb::sg::Image::load(file, file, content_type);
 	texture.image->create_vk_image(get_device(), VK_IMAGE_VIEW_TYPE_2D_ARRAY);
 
-	const auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(get_device(), texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> buffer_copy_regions;
 
@@ -1149,37 +1316,15 @@ Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Im
 		}
 	}
 
-	VkImageSubresourceRange subresource_range = {};
-	subresource_range.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
-	subresource_range.baseMipLevel            = 0;
-	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
-	subresource_range.layerCount              = layers;
-
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_UNDEFINED,
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(buffer_copy_regions.size()),
-	    buffer_copy_regions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	                             subresource_range);
-
-	get_device().flush_command_buffer(command_buffer, queue.get_handle());
+	// The copies run on the transfer queue, then the graphics queue acquires the texture
+	get_upload_manager().upload_image(texture.image->get_vk_image_view(),
+	                                  texture.image->get_data().data(),
+	                                  texture.image->get_data().size(),
+	                                  buffer_copy_regions,
+	                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                                  VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                                  VK_ACCESS_SHADER_READ_BIT);
+	get_upload_manager().finish();
 
 	// Calculate valid filter and mipmap modes
 	VkFilter            filter      = VK_FILTER_LINEAR;
@@ -1216,12 +1361,6 @@ Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::
 	texture.image = vkb::sg::Image::load(file, file, content_type);
 	texture.image->create_vk_image(get_device(), VK_IMAGE_VIEW_TYPE_CUBE, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
 
-	const auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(get_device(), texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> buffer_copy_regions;
 
@@ -1248,37 +1387,15 @@ Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::
 		}
 	}
 
-	VkImageSubresourceRange subresource_range = {};
-	subresource_range.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
-	subresource_range.baseMipLevel            = 0;
-	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
-	subresource_range.layerCount              = layers;
-
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_UNDEFINED,
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(buffer_copy_regions.size()),
-	    buffer_copy_regions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	                             subresource_range);
-
-	get_device().flush_command_buffer(command_buffer, queue.get_handle());
+	// The copies run on the transfer queue, then the graphics queue acquires the texture
+	get_upload_manager().upload_image(texture.image->get_vk_image_view(),
+	                                  texture.image->get_data().data(),
+	                                  texture.image->get_data().size(),
+	                                  buffer_copy_regions,
+	                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                                  VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                                  VK_ACCESS_SHADER_READ_BIT);
+	get_upload_manager().finish();
 
 	// Calculate valid filter and mipmap modes
 	VkFilter            filter      = VK_FILTER_LINEAR;
@@ -1352,3 +1469,50 @@ void ApiVulkanSample::with_vkb_command_buffer(const std::function<void(vkb::Comm
 	queue.submit(cmd, get_device().request_fence());
 	get_device().get_fence_pool().wait();
 }
+
+namespace
+{
+VkDeviceSize get_uniform_ring_stride(vkb::Device &device, VkDeviceSize size)
+{
+	VkDeviceSize alignment = device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
+
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+}        // namespace
+
+UniformRing::UniformRing(vkb::Device &device, VkDeviceSize size, uint32_t slice_count) :
+    buffer{device, get_uniform_ring_stride(device, size) * slice_count, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU},
+    size{size},
+    stride{get_uniform_ring_stride(device, size)},
+    data(size),
+    slice_versions(slice_count, 0)
+{}
+
+uint32_t UniformRing::get_dynamic_offset(uint32_t image_index) const
+{
+	return static_cast<uint32_t>(stride * image_index);
+}
+
+VkDescriptorBufferInfo UniformRing::get_descriptor() const
+{
+	return {buffer.get_handle(), 0, size};
+}
+
+void UniformRing::set_data(const void *new_data, size_t new_size)
+{
+	assert(new_size <= size && "Data does not fit in the uniform ring");
+
+	std::memcpy(data.data(), new_data, new_size);
+	version++;
+}
+
+void UniformRing::write(uint32_t image_index)
+{
+	assert(image_index < slice_versions.size());
+
+	if (slice_versions[image_index] != version)
+	{
+		buffer.update(data.data(), data.size(), get_dynamic_offset(image_index));
+		slice_versions[image_index] = version;
+	}
+}
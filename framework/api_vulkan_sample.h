@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -41,6 +41,7 @@
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/sampler.h"
 #include "scene_graph/components/texture.h"
+#include "upload_manager.h"
 #include "vulkan_sample.h"
 
 /**
@@ -61,6 +62,56 @@ struct Texture
 	VkSampler                       sampler;
 };
 
+/**
+ * @brief A uniform buffer with one slice per swapchain image, so that it is updated without racing the frames in flight,
+ *        see ApiVulkanSample::set_frames_in_flight()
+ *        The command buffer of each image binds its slice with the dynamic offset of one VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+ *        descriptor, so that a single descriptor set serves all images and command buffers may still be recorded up front.
+ *        Create it with ApiVulkanSample::create_uniform_ring() and update it with ApiVulkanSample::update_uniform_ring().
+ */
+class UniformRing
+{
+  public:
+	UniformRing(vkb::Device &device, VkDeviceSize size, uint32_t slice_count);
+
+	/**
+	 * @return The dynamic offset of the slice read by the command buffer of a swapchain image
+	 */
+	uint32_t get_dynamic_offset(uint32_t image_index) const;
+
+	/**
+	 * @return A descriptor of one slice, for a VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC binding
+	 */
+	VkDescriptorBufferInfo get_descriptor() const;
+
+	/**
+	 * @brief Stores new data, which is written to each slice once the frames reading it have completed
+	 */
+	void set_data(const void *new_data, size_t new_size);
+
+	/**
+	 * @brief Writes the latest data to the slice of a swapchain image, if it is out of date
+	 *        The image must not be read by a frame in flight.
+	 */
+	void write(uint32_t image_index);
+
+  private:
+	vkb::core::Buffer buffer;
+
+	VkDeviceSize size;
+
+	/// The size aligned to minUniformBufferOffsetAlignment
+	VkDeviceSize stride;
+
+	std::vector<uint8_t> data;
+
+	/// Incremented by set_data()
+	uint32_t version{0};
+
+	/// The version of the data in each slice
+	std::vector<uint32_t> slice_versions;
+};
+
 /**
  * @brief The structure of a vertex
  */
@@ -178,6 +229,43 @@ class ApiVulkanSample : public vkb::VulkanSample<vkb::BindingType::C>
 	// Synchronization fences
 	std::vector<VkFence> wait_fences;
 
+	/**
+	 * @brief Sets how many frames the CPU may record ahead of the GPU, must be called before prepare()
+	 *        With more than one frame, submit_frame() does not wait for the queue to be idle. Instead prepare_frame() waits
+	 *        for the frame which last used the same frame index, and for the frame which last rendered to the acquired image,
+	 *        so draw_cmd_buffers[current_buffer] may be recorded again. The semaphores are then switched per frame.
+	 *        Resources written by the CPU every frame, such as uniform buffers, must have a copy per frame index,
+	 *        see get_frame_index().
+	 */
+	void set_frames_in_flight(uint32_t count);
+
+	uint32_t get_frames_in_flight() const;
+
+	/**
+	 * @return The index of the frame being recorded, in [0, get_frames_in_flight())
+	 */
+	uint32_t get_frame_index() const;
+
+	/**
+	 * @brief Creates a uniform buffer with one slice per swapchain image, owned by the sample
+	 *        It replaces a single uniform buffer updated every frame, which is only safe while submit_frame() waits for the queue.
+	 * @param size The size of the uniform data
+	 */
+	UniformRing &create_uniform_ring(VkDeviceSize size);
+
+	/**
+	 * @brief Updates a uniform ring, at any point of the frame
+	 *        The slice of the current swapchain image is written once it is acquired, see prepare_frame(), and the slices
+	 *        of the other images once they are acquired again.
+	 */
+	void update_uniform_ring(UniformRing &ring, const void *data, size_t size);
+
+	template <class T>
+	void update_uniform_ring(UniformRing &ring, const T &data)
+	{
+		update_uniform_ring(ring, &data, sizeof(T));
+	}
+
 	/**
 	 * @brief Populates the swapchain_buffers vector with the image and imageviews
 	 */
@@ -209,6 +297,11 @@ class ApiVulkanSample : public vkb::VulkanSample<vkb::BindingType::C>
 	 */
 	VkDescriptorImageInfo create_descriptor(Texture &texture, VkDescriptorType descriptor_type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 
+	/**
+	 * @brief Returns the manager the textures are uploaded with, created on first use
+	 */
+	vkb::UploadManager &get_upload_manager();
+
 	/**
 	 * @brief Loads in a ktx 2D texture
 	 * @param file The filename of the texture to load
@@ -279,11 +372,28 @@ class ApiVulkanSample : public vkb::VulkanSample<vkb::BindingType::C>
 	 */
 	virtual void build_command_buffers() = 0;
 
+	/**
+	 * @brief To be overridden by derived classes which record the command buffer of each swapchain image on its own,
+	 *        see set_lazy_command_buffer_rebuild()
+	 * @param index The index of the swapchain image in draw_cmd_buffers
+	 */
+	virtual void build_command_buffer(uint32_t index);
+
 	/**
 	 * @brief Rebuild the command buffers by first resetting the corresponding command pool and then building the command buffers.
+	 *        With lazy rebuilds, the command buffers are only marked as out of date instead.
 	 */
 	void rebuild_command_buffers();
 
+	/**
+	 * @brief Sets whether rebuild_command_buffers() defers recording, must be called before prepare()
+	 *        With lazy rebuilds, prepare_frame() records the command buffer of the acquired image with build_command_buffer()
+	 *        if it is out of date. A change such as a gui toggle then costs one recording per frame, instead of recording
+	 *        the command buffers of all the swapchain images at once.
+	 *        The sample must implement build_command_buffer(), build_command_buffers() may then loop over it.
+	 */
+	void set_lazy_command_buffer_rebuild(bool enable);
+
 	/**
 	 * @brief Creates the fences for rendering
 	 */
@@ -402,6 +512,49 @@ class ApiVulkanSample : public vkb::VulkanSample<vkb::BindingType::C>
 
 	void handle_mouse_move(int32_t x, int32_t y);
 
+	std::unique_ptr<vkb::UploadManager> upload_manager;
+
+	/**
+	 * @brief Synchronization of one frame in flight, see set_frames_in_flight()
+	 */
+	struct FrameSync
+	{
+		VkSemaphore acquired_image_ready{VK_NULL_HANDLE};
+
+		/// Signaled once the work of the frame has completed on the queue
+		VkFence fence{VK_NULL_HANDLE};
+	};
+
+	uint32_t frames_in_flight{1};
+
+	uint32_t frame_index{0};
+
+	std::vector<FrameSync> frame_syncs;
+
+	/// One per swapchain image, as the presentation of an image may wait for its semaphore after the frame has completed
+	std::vector<VkSemaphore> image_render_complete_semaphores;
+
+	/// The fence of the frame which last rendered to each swapchain image, or null
+	std::vector<VkFence> image_fences;
+
+	void create_frame_syncs();
+
+	/**
+	 * @brief Waits until the frames submitted so far have completed, outside of prepare_frame() and submit_frame()
+	 */
+	void wait_for_frames_in_flight();
+
+	std::vector<std::unique_ptr<UniformRing>> uniform_rings;
+
+	/// See set_lazy_command_buffer_rebuild()
+	bool lazy_command_buffer_rebuild{false};
+
+	/// Whether each of draw_cmd_buffers must be recorded again before it is submitted, with lazy rebuilds
+	std::vector<bool> command_buffers_out_of_date;
+
+	/// Whether the image of the frame was acquired and it is not submitted yet
+	bool frame_prepared{false};
+
 #if defined(VKB_DEBUG) || defined(VKB_VALIDATION_LAYERS)
 	/// The debug report callback
 	VkDebugReportCallbackEXT debug_report_callback{VK_NULL_HANDLE};
@@ -0,0 +1,72 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark_device.h"
+
+#include "common/error.h"
+#include "common/hpp_vk_common.h"
+#include "core/debug.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+
+namespace vkb
+{
+Device *BenchmarkDevice::get()
+{
+	static BenchmarkDevice benchmark_device;
+
+	return benchmark_device.device.get();
+}
+
+BenchmarkDevice::BenchmarkDevice()
+{
+	try
+	{
+		filesystem::init();
+
+		// Same loading as VulkanSample::prepare(), the framework still mixes the C and C++ bindings
+		static vk::DynamicLoader dl;
+		VULKAN_HPP_DEFAULT_DISPATCHER.init(dl.getProcAddress<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr"));
+
+		VkResult result = volkInitialize();
+		if (result)
+		{
+			throw VulkanException(result, "Failed to initialize volk.");
+		}
+
+		instance = std::make_unique<Instance>("vkb benchmarks", std::unordered_map<const char *, bool>{}, std::vector<const char *>{}, false, API_VERSION);
+		VULKAN_HPP_DEFAULT_DISPATCHER.init(instance->get_handle());
+
+		device = std::make_unique<Device>(instance->get_first_gpu(), VK_NULL_HANDLE, std::make_unique<DummyDebugUtils>());
+		VULKAN_HPP_DEFAULT_DISPATCHER.init(device->get_handle());
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("No Vulkan device for the benchmarks, the ones which need it are skipped: {}", e.what());
+		device.reset();
+		instance.reset();
+	}
+}
+
+BenchmarkDevice::~BenchmarkDevice()
+{
+	if (device)
+	{
+		device->wait_idle();
+	}
+}
+}        // namespace vkb
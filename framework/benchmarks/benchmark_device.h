@@ -0,0 +1,53 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "core/device.h"
+#include "core/instance.h"
+
+namespace vkb
+{
+/**
+ * @brief The instance and device shared by the benchmarks which need a real Vulkan device
+ *
+ * The device is created on first use, without a surface, on the first GPU of the instance. The benchmarks using it skip
+ * themselves when it could not be created, e.g. on machines without a Vulkan driver.
+ */
+class BenchmarkDevice
+{
+  public:
+	/// Vulkan version of the instance, 1.1 so that the subgroup operations can be benchmarked
+	static constexpr uint32_t API_VERSION = VK_API_VERSION_1_1;
+
+	/**
+	 * @return The shared device, or nullptr if it could not be created
+	 */
+	static Device *get();
+
+	~BenchmarkDevice();
+
+  private:
+	BenchmarkDevice();
+
+	std::unique_ptr<Instance> instance;
+
+	std::unique_ptr<Device> device;
+};
+}        // namespace vkb
@@ -0,0 +1,49 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "benchmark_device.h"
+#include "buffer_pool.h"
+
+using namespace vkb;
+
+TEST_CASE("vkb::BufferPool", "[benchmark][buffer_pool]")
+{
+	auto device = BenchmarkDevice::get();
+	if (!device)
+	{
+		SKIP("No Vulkan device");
+	}
+
+	BufferPool buffer_pool{*device, 256 * 1024, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT};
+
+	// The uniforms of the draws of a frame, the pool is reset as a frame is reused
+	BENCHMARK("request_buffer_block and allocate for 1000 draws")
+	{
+		buffer_pool.reset();
+
+		VkDeviceSize offset = 0;
+		for (uint32_t i = 0; i < 1000; ++i)
+		{
+			auto &block = buffer_pool.request_buffer_block(256);
+			offset += block.allocate(256).get_offset();
+		}
+		return offset;
+	};
+}
@@ -0,0 +1,220 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "benchmark_device.h"
+#include "core/command_buffer.h"
+#include "core/command_pool.h"
+#include "core/query_pool.h"
+#include "core/util/logging.hpp"
+#include "fence_pool.h"
+#include "rendering/compute_primitives.h"
+
+using namespace vkb;
+
+namespace
+{
+constexpr uint32_t ELEMENT_COUNT = 4 * 1024 * 1024;
+
+/// Runs of each primitive between the timestamps, to average out the overhead of the first dispatches
+constexpr uint32_t RUN_COUNT = 10;
+
+/**
+ * @brief Records commands to a command buffer of the graphics queue, submits it and waits for it
+ */
+template <class Record>
+void submit_and_wait(Device &device, Record &&record)
+{
+	auto &queue = device.get_suitable_graphics_queue();
+
+	CommandPool command_pool{device, queue.get_family_index()};
+	FencePool   fence_pool{device};
+
+	auto &command_buffer = command_pool.request_command_buffer();
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	record(command_buffer);
+	command_buffer.end();
+
+	queue.submit(command_buffer, fence_pool.request_fence());
+	fence_pool.wait();
+}
+
+std::unique_ptr<core::Buffer> create_storage_buffer(Device &device, const std::vector<uint32_t> &data)
+{
+	auto buffer = std::make_unique<core::Buffer>(device, data.size() * sizeof(uint32_t),
+	                                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                             VMA_MEMORY_USAGE_GPU_ONLY, 0);
+
+	auto staging_buffer = core::Buffer::create_staging_buffer(device, data);
+
+	submit_and_wait(device, [&](CommandBuffer &command_buffer) {
+		command_buffer.buffer_transition(*buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+		command_buffer.copy_buffer(staging_buffer, *buffer, staging_buffer.get_size());
+	});
+
+	return buffer;
+}
+
+std::vector<uint32_t> read_storage_buffer(Device &device, const core::Buffer &buffer, uint32_t count)
+{
+	core::Buffer readback_buffer{device, count * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU};
+
+	submit_and_wait(device, [&](CommandBuffer &command_buffer) {
+		command_buffer.buffer_transition(buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+		command_buffer.copy_buffer(buffer, readback_buffer, readback_buffer.get_size());
+
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_HOST_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
+		command_buffer.buffer_memory_barrier(readback_buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+	});
+
+	readback_buffer.invalidate();
+	auto data = reinterpret_cast<const uint32_t *>(readback_buffer.get_data());
+
+	return {data, data + count};
+}
+
+/**
+ * @brief Records a primitive RUN_COUNT times between two timestamps after a first run
+ * @return The average GPU time of a run in seconds
+ */
+template <class Record>
+double measure_gpu_time(Device &device, Record &&record)
+{
+	VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+	query_pool_info.queryCount = 2;
+
+	QueryPool query_pool{device, query_pool_info};
+
+	submit_and_wait(device, [&](CommandBuffer &command_buffer) {
+		command_buffer.reset_query_pool(query_pool, 0, 2);
+
+		record(command_buffer);
+
+		command_buffer.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, 0);
+		for (uint32_t run = 0; run < RUN_COUNT; ++run)
+		{
+			record(command_buffer);
+		}
+		command_buffer.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, 1);
+	});
+
+	uint64_t timestamps[2]{};
+	query_pool.get_results(0, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+
+	return static_cast<double>(timestamps[1] - timestamps[0]) * device.get_gpu().get_properties().limits.timestampPeriod * 1e-9 / RUN_COUNT;
+}
+
+/**
+ * @brief Logs the bandwidth of a primitive, as the bytes of the arrays it reads and writes over its GPU time
+ */
+void report(Device &device, const ComputePrimitives &primitives, const char *name, double bytes, double seconds)
+{
+	LOGI("{} on {} ({}): {:.2f} GB/s, {:.3f} ms",
+	     name,
+	     device.get_gpu().get_properties().deviceName,
+	     primitives.uses_subgroup_arithmetic() ? "subgroup arithmetic" : "shared memory",
+	     bytes / seconds * 1e-9,
+	     seconds * 1e3);
+}
+}        // namespace
+
+TEST_CASE("vkb::ComputePrimitives", "[benchmark][compute_primitives]")
+{
+	auto device = BenchmarkDevice::get();
+	if (!device)
+	{
+		SKIP("No Vulkan device");
+	}
+
+	if (!device->get_gpu().get_properties().limits.timestampComputeAndGraphics)
+	{
+		SKIP("No timestamps on the graphics queue");
+	}
+
+	std::mt19937                            random{1};
+	std::uniform_int_distribution<uint32_t> distribution;
+
+	std::vector<uint32_t> values(ELEMENT_COUNT);
+	std::generate(values.begin(), values.end(), [&] { return distribution(random) & 0xffff; });
+
+	// About half of the elements are kept by the compaction
+	std::vector<uint32_t> flags(ELEMENT_COUNT);
+	std::generate(flags.begin(), flags.end(), [&] { return distribution(random) & 1; });
+
+	auto input  = create_storage_buffer(*device, values);
+	auto flag   = create_storage_buffer(*device, flags);
+	auto output = create_storage_buffer(*device, std::vector<uint32_t>(ELEMENT_COUNT));
+	auto keys   = create_storage_buffer(*device, values);
+	auto count  = create_storage_buffer(*device, {0});
+
+	double array_size = ELEMENT_COUNT * sizeof(uint32_t);
+
+	// The shared memory fallback with Vulkan 1.0, and the subgroup operations where supported
+	for (uint32_t api_version : {VK_API_VERSION_1_0, BenchmarkDevice::API_VERSION})
+	{
+		ComputePrimitives primitives{*device, ELEMENT_COUNT, api_version};
+
+		if (api_version != VK_API_VERSION_1_0 && !primitives.uses_subgroup_arithmetic())
+		{
+			break;
+		}
+
+		double seconds = measure_gpu_time(*device, [&](CommandBuffer &command_buffer) {
+			primitives.reduce(command_buffer, *input, ELEMENT_COUNT, *output);
+		});
+		report(*device, primitives, "reduce", array_size, seconds);
+		CHECK(read_storage_buffer(*device, *output, 1)[0] == std::accumulate(values.begin(), values.end(), 0U));
+
+		seconds = measure_gpu_time(*device, [&](CommandBuffer &command_buffer) {
+			primitives.exclusive_scan(command_buffer, *input, *output, ELEMENT_COUNT);
+		});
+		report(*device, primitives, "exclusive_scan", 2 * array_size, seconds);
+
+		std::vector<uint32_t> expected_scan(ELEMENT_COUNT);
+		std::exclusive_scan(values.begin(), values.end(), expected_scan.begin(), 0U);
+		CHECK(read_storage_buffer(*device, *output, ELEMENT_COUNT) == expected_scan);
+
+		uint32_t kept_count = static_cast<uint32_t>(std::count(flags.begin(), flags.end(), 1U));
+
+		seconds = measure_gpu_time(*device, [&](CommandBuffer &command_buffer) {
+			primitives.compact(command_buffer, *input, *flag, ELEMENT_COUNT, *output, *count);
+		});
+		report(*device, primitives, "compact", 2 * array_size + kept_count * sizeof(uint32_t), seconds);
+		CHECK(read_storage_buffer(*device, *count, 1)[0] == kept_count);
+
+		// Each run sorts the keys sorted by the previous run, which takes as long with a radix sort
+		seconds = measure_gpu_time(*device, [&](CommandBuffer &command_buffer) {
+			primitives.radix_sort(command_buffer, *keys, ELEMENT_COUNT);
+		});
+		report(*device, primitives, "radix_sort", array_size, seconds);
+
+		auto sorted_keys = read_storage_buffer(*device, *keys, ELEMENT_COUNT);
+		CHECK(std::is_sorted(sorted_keys.begin(), sorted_keys.end()));
+	}
+}
@@ -0,0 +1,52 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "benchmark_device.h"
+#include "filesystem/legacy.h"
+#include "gltf_loader.h"
+#include "scene_graph/scene.h"
+
+using namespace vkb;
+
+TEST_CASE("vkb::GLTFLoader", "[benchmark][gltf_loader]")
+{
+	auto device = BenchmarkDevice::get();
+	if (!device)
+	{
+		SKIP("No Vulkan device");
+	}
+
+	const std::string scene_path = "scenes/teapot.gltf";
+	if (!fs::is_file(fs::path::get(fs::path::Type::Assets, scene_path)))
+	{
+		SKIP("The assets are not available");
+	}
+
+	// Each load creates and uploads the buffers and images of the scene, so that the samples are few and long
+	BENCHMARK_ADVANCED("read_scene_from_file")(Catch::Benchmark::Chronometer meter)
+	{
+		meter.measure([device, &scene_path] {
+			GLTFLoader loader{*device};
+			auto       scene = loader.read_scene_from_file(scene_path);
+			device->wait_idle();
+			return scene != nullptr;
+		});
+	};
+}
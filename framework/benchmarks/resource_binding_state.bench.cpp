@@ -0,0 +1,72 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include "benchmark_device.h"
+#include "core/buffer.h"
+#include "resource_binding_state.h"
+
+using namespace vkb;
+
+TEST_CASE("vkb::ResourceBindingState", "[benchmark][resource_binding_state]")
+{
+	auto device = BenchmarkDevice::get();
+	if (!device)
+	{
+		SKIP("No Vulkan device");
+	}
+
+	constexpr uint32_t BINDING_COUNT = 8;
+
+	std::vector<core::Buffer> buffers;
+	buffers.reserve(BINDING_COUNT);
+	for (uint32_t i = 0; i < BINDING_COUNT; ++i)
+	{
+		buffers.emplace_back(*device, 256, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	}
+
+	ResourceBindingState binding_state;
+
+	// The bindings of a draw after the command buffer was reset, as a frame binds them
+	BENCHMARK("bind 8 buffers after a reset")
+	{
+		binding_state.reset();
+		for (uint32_t i = 0; i < BINDING_COUNT; ++i)
+		{
+			binding_state.bind_buffer(buffers[i], 0, 256, 0, i, 0);
+		}
+		return binding_state.get_resource_sets()[0].get_hash();
+	};
+
+	// The bindings of consecutive draws, whose offsets into the same buffers change
+	VkDeviceSize offset = 0;
+
+	BENCHMARK("rebind 8 buffers at new offsets")
+	{
+		offset = (offset + 256) % 4096;
+		for (uint32_t i = 0; i < BINDING_COUNT; ++i)
+		{
+			binding_state.bind_buffer(buffers[i], offset, 256, 0, i, 0);
+		}
+		binding_state.clear_dirty();
+		return binding_state.get_resource_sets()[0].get_hash();
+	};
+}
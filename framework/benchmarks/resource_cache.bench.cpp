@@ -0,0 +1,92 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "benchmark_device.h"
+#include "common/resource_cache_lookup.h"
+#include "core/util/hash.hpp"
+#include "resource_cache.h"
+
+using namespace vkb;
+
+TEST_CASE("vkb::common::request_indexed_resource without a device", "[benchmark][resource_cache]")
+{
+	// The lookup path of the resource caches, with plain values in place of Vulkan objects
+	std::mutex                      resource_mutex;
+	std::atomic<uint32_t>           contention_count{0};
+	ReadMostlyMap<int>              index;
+	std::unordered_map<size_t, int> resources;
+
+	std::vector<size_t> hashes(256);
+	for (size_t i = 0; i < hashes.size(); ++i)
+	{
+		hash_combine(hashes[i], i);
+	}
+
+	auto request = [&](size_t hash) -> int & {
+		return common::request_indexed_resource(hash, resource_mutex, contention_count, index, [&]() -> int & {
+			return resources.emplace(hash, static_cast<int>(hash)).first->second;
+		});
+	};
+
+	for (auto hash : hashes)
+	{
+		request(hash);
+	}
+
+	size_t i = 0;
+
+	BENCHMARK("hit")
+	{
+		i = (i + 1) % hashes.size();
+		return request(hashes[i]);
+	};
+}
+
+TEST_CASE("vkb::ResourceCache::request_render_pass", "[benchmark][resource_cache]")
+{
+	auto device = BenchmarkDevice::get();
+	if (!device)
+	{
+		SKIP("No Vulkan device");
+	}
+
+	auto &resource_cache = device->get_resource_cache();
+
+	std::vector<Attachment> attachments{{VK_FORMAT_R8G8B8A8_UNORM, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT},
+	                                    {VK_FORMAT_D32_SFLOAT, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT}};
+
+	std::vector<LoadStoreInfo> load_store_infos(2);
+	load_store_infos[1].store_op = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+	std::vector<SubpassInfo> subpasses(1);
+	subpasses[0].output_attachments = {0};
+
+	// The first request creates the render pass, the benchmark measures the hashing and lookup of the following ones
+	resource_cache.request_render_pass(attachments, load_store_infos, subpasses);
+
+	BENCHMARK("hit")
+	{
+		return &resource_cache.request_render_pass(attachments, load_store_infos, subpasses);
+	};
+}
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,32 +17,39 @@
 
 #include "buffer_pool.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 
 #include "core/device.h"
 #include "core/util/logging.hpp"
 
 namespace vkb
 {
-BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
-    buffer{device, size, usage, memory_usage}
+namespace
+{
+VkDeviceSize get_offset_alignment(Device &device, VkBufferUsageFlags usage)
 {
-	if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+	if (usage & VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT)
+	{
+		return device.get_descriptor_buffer_properties().descriptorBufferOffsetAlignment;
+	}
+	else if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minStorageBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minStorageBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minTexelBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minTexelBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_INDEX_BUFFER_BIT || usage == VK_BUFFER_USAGE_VERTEX_BUFFER_BIT || usage == VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
 	{
 		// Used to calculate the offset, required when allocating memory (its value should be power of 2)
-		alignment = 16;
+		return 16;
 	}
 	else
 	{
@@ -50,6 +57,29 @@ BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags u
 	}
 }
 
+/**
+ * @brief Selects the memory of a buffer block, VMA_MEMORY_USAGE_AUTO selecting the memory of per-frame data
+ */
+core::BufferBuilder &with_block_memory(core::BufferBuilder &builder, VmaMemoryUsage memory_usage)
+{
+	if (memory_usage == VMA_MEMORY_USAGE_AUTO)
+	{
+		return builder.with_upload_frequency(allocated::UploadFrequency::PerFrame);
+	}
+
+	return builder.with_vma_usage(memory_usage).with_vma_flags(VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+}
+}        // namespace
+
+BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
+    buffer{device, with_block_memory(core::BufferBuilder{size}
+                                         .with_usage(usage)
+                                         .with_memory_tag(allocated::MemoryTag::BufferPool),
+                                     memory_usage)}
+{
+	alignment = get_offset_alignment(device, usage);
+}
+
 VkDeviceSize BufferBlock::aligned_offset() const
 {
 	return (offset + alignment - 1) & ~(alignment - 1);
@@ -75,21 +105,52 @@ BufferAllocation BufferBlock::allocate(VkDeviceSize size)
 	return BufferAllocation{};
 }
 
+BufferAllocation BufferBlock::allocate_array(VkDeviceSize element_size, uint32_t element_count)
+{
+	VkDeviceSize stride = get_element_stride(element_size);
+
+	if (can_allocate(stride * element_count))
+	{
+		auto aligned = aligned_offset();
+		offset       = aligned + stride * element_count;
+		return BufferAllocation{buffer, stride * element_count, aligned, stride};
+	}
+
+	return BufferAllocation{};
+}
+
+VkDeviceSize BufferBlock::get_element_stride(VkDeviceSize element_size) const
+{
+	return (element_size + alignment - 1) & ~(alignment - 1);
+}
+
 VkDeviceSize BufferBlock::get_size() const
 {
 	return buffer.get_size();
 }
 
+VkDeviceSize BufferBlock::get_used_size() const
+{
+	return offset;
+}
+
+uint32_t BufferBlock::get_idle_resets() const
+{
+	return idle_resets;
+}
+
 void BufferBlock::reset()
 {
-	offset = 0;
+	idle_resets = offset == 0 ? idle_resets + 1 : 0;
+	offset      = 0;
 }
 
 BufferPool::BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
     device{device},
     block_size{block_size},
     usage{usage},
-    memory_usage{memory_usage}
+    memory_usage{memory_usage},
+    alignment{get_offset_alignment(device, usage)}
 {
 }
 
@@ -116,28 +177,100 @@ BufferBlock &BufferPool::request_buffer_block(const VkDeviceSize minimum_size, b
 	return *it->get();
 }
 
+BufferAllocation BufferPool::allocate_array(VkDeviceSize element_size, uint32_t element_count)
+{
+	return request_buffer_block(get_element_stride(element_size) * element_count).allocate_array(element_size, element_count);
+}
+
+VkDeviceSize BufferPool::get_element_stride(VkDeviceSize element_size) const
+{
+	return (element_size + alignment - 1) & ~(alignment - 1);
+}
+
 void BufferPool::reset()
 {
+	VkDeviceSize usage_since_reset = 0;
+
 	for (auto &buffer_block : buffer_blocks)
 	{
+		usage_since_reset += buffer_block->get_used_size();
 		buffer_block->reset();
 	}
+
+	peak_usage = std::max(peak_usage, usage_since_reset);
+
+	if (high_water_mark == 0 && idle_reset_limit == 0)
+	{
+		return;
+	}
+
+	// Walk the blocks in creation order, so the blocks kept are the ones every frame fills first
+	VkDeviceSize kept_capacity = 0;
+
+	auto trimmed_it = std::remove_if(buffer_blocks.begin(), buffer_blocks.end(), [&](const std::unique_ptr<BufferBlock> &buffer_block) {
+		bool first_block = kept_capacity == 0;
+		bool over_limit  = high_water_mark != 0 && kept_capacity + buffer_block->get_size() > high_water_mark;
+		bool idle        = idle_reset_limit != 0 && buffer_block->get_idle_resets() >= idle_reset_limit;
+
+		if (!first_block && (over_limit || idle))
+		{
+			return true;
+		}
+
+		kept_capacity += buffer_block->get_size();
+		return false;
+	});
+
+	if (trimmed_it != buffer_blocks.end())
+	{
+		LOGD("Releasing {} buffer blocks ({})", std::distance(trimmed_it, buffer_blocks.end()), usage);
+		buffer_blocks.erase(trimmed_it, buffer_blocks.end());
+	}
 }
 
-BufferAllocation::BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDeviceSize offset) :
+void BufferPool::set_trim_policy(VkDeviceSize new_high_water_mark, uint32_t new_idle_reset_limit)
+{
+	high_water_mark  = new_high_water_mark;
+	idle_reset_limit = new_idle_reset_limit;
+}
+
+VkDeviceSize BufferPool::get_peak_usage() const
+{
+	return peak_usage;
+}
+
+VkDeviceSize BufferPool::get_capacity() const
+{
+	VkDeviceSize capacity = 0;
+
+	for (auto &buffer_block : buffer_blocks)
+	{
+		capacity += buffer_block->get_size();
+	}
+
+	return capacity;
+}
+
+BufferAllocation::BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDeviceSize offset, VkDeviceSize element_stride) :
     buffer{&buffer},
     size{size},
-    base_offset{offset}
+    base_offset{offset},
+    element_stride{element_stride}
 {
 }
 
 void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
+{
+	update(data.data(), data.size(), offset);
+}
+
+void BufferAllocation::update(const uint8_t *data, size_t data_size, uint32_t offset)
 {
 	assert(buffer && "Invalid buffer pointer");
 
-	if (offset + data.size() <= size)
+	if (offset + data_size <= size)
 	{
-		buffer->update(data, to_u32(base_offset) + offset);
+		buffer->update(data, data_size, to_u32(base_offset) + offset);
 	}
 	else
 	{
@@ -145,6 +278,51 @@ void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
 	}
 }
 
+uint8_t *BufferAllocation::map(size_t write_size, uint32_t offset)
+{
+	assert(buffer && "Invalid buffer pointer");
+
+	if (offset + write_size > size)
+	{
+		LOGE("Buffer allocation mapping out of range");
+		return nullptr;
+	}
+
+	return buffer->map() + base_offset + offset;
+}
+
+void BufferAllocation::update_elements(const uint8_t *data, size_t element_size, uint32_t element_count, uint32_t first_element)
+{
+	assert(element_size <= element_stride && "Element does not fit the stride of the allocation");
+
+	uint8_t *mapped = map(element_count * element_stride, to_u32(first_element * element_stride));
+	if (!mapped)
+	{
+		return;
+	}
+
+	if (element_size == element_stride)
+	{
+		std::memcpy(mapped, data, element_count * element_size);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < element_count; ++i)
+		{
+			std::memcpy(mapped + i * element_stride, data + i * element_size, element_size);
+		}
+	}
+
+	buffer->flush(base_offset + first_element * element_stride, element_count * element_stride);
+}
+
+void BufferAllocation::flush()
+{
+	assert(buffer && "Invalid buffer pointer");
+
+	buffer->flush(base_offset, size);
+}
+
 bool BufferAllocation::empty() const
 {
 	return size == 0 || buffer == nullptr;
@@ -160,6 +338,22 @@ VkDeviceSize BufferAllocation::get_offset() const
 	return base_offset;
 }
 
+VkDeviceSize BufferAllocation::get_element_stride() const
+{
+	return element_stride;
+}
+
+uint32_t BufferAllocation::get_element_count() const
+{
+	return element_stride == 0 ? 0 : to_u32(size / element_stride);
+}
+
+uint32_t BufferAllocation::get_dynamic_offset(uint32_t index) const
+{
+	assert(index < get_element_count() && "Element index out of range");
+	return to_u32(index * element_stride);
+}
+
 core::Buffer &BufferAllocation::get_buffer()
 {
 	assert(buffer && "Invalid buffer pointer");
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -33,7 +33,10 @@ class BufferAllocation
   public:
 	BufferAllocation() = default;
 
-	BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDeviceSize offset);
+	/**
+	 * @param element_stride Distance in bytes between the elements of an array allocation, 0 if the allocation is not an array
+	 */
+	BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDeviceSize offset, VkDeviceSize element_stride = 0);
 
 	BufferAllocation(const BufferAllocation &) = delete;
 
@@ -45,18 +48,86 @@ class BufferAllocation
 
 	void update(const std::vector<uint8_t> &data, uint32_t offset = 0);
 
+	/**
+	 * @brief Copies data_size bytes straight into the mapped memory of the allocation
+	 */
+	void update(const uint8_t *data, size_t data_size, uint32_t offset = 0);
+
 	template <class T>
 	void update(const T &value, uint32_t offset = 0)
 	{
-		update(to_bytes(value), offset);
+		update(reinterpret_cast<const uint8_t *>(&value), sizeof(T), offset);
+	}
+
+	/**
+	 * @brief Gives access to the mapped memory of the allocation, so that data can be written in place
+	 *        Call flush() once writing is done, so that the data also reaches non-coherent memory.
+	 * @param write_size The number of bytes which will be written
+	 * @param offset The offset from the start of the allocation
+	 * @return A pointer into the mapped memory, or nullptr if the range does not fit in the allocation
+	 */
+	uint8_t *map(size_t write_size, uint32_t offset = 0);
+
+	template <class T>
+	T *map(uint32_t offset = 0)
+	{
+		return reinterpret_cast<T *>(map(sizeof(T), offset));
+	}
+
+	/**
+	 * @brief Gives access to one element of an array allocation, see BufferBlock::allocate_array()
+	 * @return A pointer into the mapped memory, or nullptr if the element is out of range
+	 */
+	template <class T>
+	T *map_element(uint32_t index)
+	{
+		return reinterpret_cast<T *>(map(sizeof(T), to_u32(index * element_stride)));
 	}
 
+	/**
+	 * @brief Copies tightly packed elements into an array allocation, placing each element at its aligned offset
+	 *        When the stride matches the element size this is a single copy, otherwise one copy per element.
+	 *        The written range is flushed afterwards.
+	 * @param data The elements to copy
+	 * @param element_size The size in bytes of one element in data
+	 * @param element_count The number of elements to copy
+	 * @param first_element The index of the first element to write in the allocation
+	 */
+	void update_elements(const uint8_t *data, size_t element_size, uint32_t element_count, uint32_t first_element = 0);
+
+	template <class T>
+	void update_elements(const std::vector<T> &elements, uint32_t first_element = 0)
+	{
+		update_elements(reinterpret_cast<const uint8_t *>(elements.data()), sizeof(T), to_u32(elements.size()), first_element);
+	}
+
+	/**
+	 * @brief Flushes the whole allocation, needed after writing through map()
+	 */
+	void flush();
+
 	bool empty() const;
 
 	VkDeviceSize get_size() const;
 
 	VkDeviceSize get_offset() const;
 
+	/**
+	 * @return The aligned distance in bytes between two elements of an array allocation, 0 if it is not an array
+	 */
+	VkDeviceSize get_element_stride() const;
+
+	/**
+	 * @return The number of elements of an array allocation
+	 */
+	uint32_t get_element_count() const;
+
+	/**
+	 * @brief The offset of an element relative to get_offset(), to be passed as the dynamic offset
+	 *        of a dynamic uniform or storage buffer descriptor bound at get_offset()
+	 */
+	uint32_t get_dynamic_offset(uint32_t index) const;
+
 	core::Buffer &get_buffer();
 
   private:
@@ -65,6 +136,8 @@ class BufferAllocation
 	VkDeviceSize base_offset{0};
 
 	VkDeviceSize size{0};
+
+	VkDeviceSize element_stride{0};
 };
 
 /**
@@ -73,6 +146,9 @@ class BufferAllocation
 class BufferBlock
 {
   public:
+	/**
+	 * @param memory_usage The memory usage of the buffer, VMA_MEMORY_USAGE_AUTO for the memory of per-frame data, see allocated::UploadFrequency
+	 */
 	BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage);
 
 	/**
@@ -87,8 +163,32 @@ class BufferBlock
 	 */
 	BufferAllocation allocate(VkDeviceSize size);
 
+	/**
+	 * @brief Allocates an array whose elements each start at an offset aligned for this block's usage,
+	 *        e.g. minUniformBufferOffsetAlignment for uniform buffers
+	 * @param element_size The size in bytes of one element
+	 * @param element_count The number of elements
+	 * @return An array allocation, empty if the block has not enough space left
+	 */
+	BufferAllocation allocate_array(VkDeviceSize element_size, uint32_t element_count);
+
+	/**
+	 * @return The size of an element rounded up to the offset alignment of this block
+	 */
+	VkDeviceSize get_element_stride(VkDeviceSize element_size) const;
+
 	VkDeviceSize get_size() const;
 
+	/**
+	 * @return The number of bytes allocated since the last reset
+	 */
+	VkDeviceSize get_used_size() const;
+
+	/**
+	 * @return The number of consecutive resets during which nothing was allocated from this block
+	 */
+	uint32_t get_idle_resets() const;
+
 	void reset();
 
   private:
@@ -106,6 +206,8 @@ class BufferBlock
 
 	// Current offset, it increases on every allocation
 	VkDeviceSize offset{0};
+
+	uint32_t idle_resets{0};
 };
 
 /**
@@ -123,16 +225,52 @@ class BufferBlock
  *
  * We re-use descriptor sets: we only need one for the corresponding buffer infos (and we only
  * have one VkBuffer per BufferBlock), then it is bound and we use dynamic offsets.
+ *
+ * Blocks created for a usage spike can be released again on reset, see set_trim_policy().
+ *
+ * By default the blocks are in the memory of per-frame data, which is device local with Resizable BAR and unified
+ * memory, see allocated::apply_upload_policy(). The host must then only write them sequentially.
  */
 class BufferPool
 {
   public:
-	BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
+	BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_AUTO);
 
 	BufferBlock &request_buffer_block(VkDeviceSize minimum_size, bool minimal = false);
 
+	/**
+	 * @brief Allocates an array with aligned elements from a block which can hold it, see BufferBlock::allocate_array()
+	 */
+	BufferAllocation allocate_array(VkDeviceSize element_size, uint32_t element_count);
+
+	/**
+	 * @return The size of an element rounded up to the offset alignment of the blocks of this pool
+	 */
+	VkDeviceSize get_element_stride(VkDeviceSize element_size) const;
+
+	/**
+	 * @brief Resets all blocks, then releases the blocks selected by the trim policy
+	 *        The caller must make sure the GPU no longer uses any allocation from this pool
+	 */
 	void reset();
 
+	/**
+	 * @brief Sets which blocks are released on reset, the first block is always kept
+	 * @param high_water_mark Blocks beyond this many bytes of total capacity are released, 0 keeps all blocks
+	 * @param idle_reset_limit Blocks unused for this many consecutive resets are released, 0 keeps idle blocks
+	 */
+	void set_trim_policy(VkDeviceSize high_water_mark, uint32_t idle_reset_limit);
+
+	/**
+	 * @return The largest number of bytes allocated from the pool between two resets
+	 */
+	VkDeviceSize get_peak_usage() const;
+
+	/**
+	 * @return The total size of the blocks currently held by the pool
+	 */
+	VkDeviceSize get_capacity() const;
+
   private:
 	Device &device;
 
@@ -145,5 +283,14 @@ class BufferPool
 	VkBufferUsageFlags usage{};
 
 	VmaMemoryUsage memory_usage{};
+
+	VkDeviceSize high_water_mark{0};
+
+	uint32_t idle_reset_limit{0};
+
+	VkDeviceSize peak_usage{0};
+
+	/// Offset alignment of the blocks, it depends on the usage
+	VkDeviceSize alignment{0};
 };
 }        // namespace vkb
@@ -216,6 +216,7 @@ struct hash<vkb::core::HPPSubpassInfo>
 		vkb::hash_combine(result, subpass_info.depth_stencil_resolve_attachment);
 		vkb::hash_combine(result, subpass_info.depth_stencil_resolve_mode);
 		vkb::hash_combine(result, subpass_info.debug_name);
+		vkb::hash_combine(result, subpass_info.view_mask);
 		return result;
 	}
 };
@@ -33,10 +33,12 @@ namespace common
 
 struct HPPBufferMemoryBarrier
 {
-	vk::PipelineStageFlags src_stage_mask  = vk::PipelineStageFlagBits::eBottomOfPipe;
-	vk::PipelineStageFlags dst_stage_mask  = vk::PipelineStageFlagBits::eTopOfPipe;
-	vk::AccessFlags        src_access_mask = {};
-	vk::AccessFlags        dst_access_mask = {};
+	vk::PipelineStageFlags src_stage_mask   = vk::PipelineStageFlagBits::eBottomOfPipe;
+	vk::PipelineStageFlags dst_stage_mask   = vk::PipelineStageFlagBits::eTopOfPipe;
+	vk::AccessFlags        src_access_mask  = {};
+	vk::AccessFlags        dst_access_mask  = {};
+	uint32_t               old_queue_family = VK_QUEUE_FAMILY_IGNORED;
+	uint32_t               new_queue_family = VK_QUEUE_FAMILY_IGNORED;
 };
 
 struct HPPImageMemoryBarrier
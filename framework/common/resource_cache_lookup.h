@@ -0,0 +1,147 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_map>
+
+#include "core/util/logging.hpp"
+#include "core/util/profiling.hpp"
+#include "core/util/read_mostly_map.hpp"
+
+// The lookup and build paths of the resource caches, shared by vkb::ResourceCache and vkb::HPPResourceCache.
+// Both caches keep each type of resource in a std::unordered_map indexed by a ReadMostlyMap for lock free lookups.
+// Only hashing a request and building and recording a resource depend on the binding, so these are passed as callables
+// and the locking and indexing are implemented once for both.
+
+namespace vkb
+{
+namespace common
+{
+/**
+ * @brief Locks the resources of a type, and counts the times the lock was already held
+ */
+inline std::unique_lock<std::mutex> lock_resource(std::mutex &resource_mutex, std::atomic<uint32_t> &contention_count)
+{
+	std::unique_lock<std::mutex> lock(resource_mutex, std::try_to_lock);
+
+	if (!lock.owns_lock())
+	{
+		contention_count++;
+		lock.lock();
+	}
+
+	return lock;
+}
+
+/**
+ * @brief Finds a resource in the index, or calls request() under the resource lock to find or build it
+ * @param hash The hash of the request
+ * @param request Returns the resource from the map of resources, building and recording it if missing
+ */
+template <class T, class Request>
+T &request_indexed_resource(std::size_t hash, std::mutex &resource_mutex, std::atomic<uint32_t> &contention_count, ReadMostlyMap<T> &index, Request &&request)
+{
+	VKB_PROFILE_SCOPE("ResourceCache lookup");
+
+	if (T *res = index.find(hash))
+	{
+		return *res;
+	}
+
+	auto guard = lock_resource(resource_mutex, contention_count);
+
+	T &res = request();
+
+	index.insert(hash, &res);
+
+	return res;
+}
+
+/**
+ * @brief Finds a resource in the index or the map of resources, or builds it outside of the resource lock,
+ *        so that objects of the same type can be created concurrently, e.g. during warmup_async.
+ *        If two threads build the same object, the first one inserted wins and the other is released.
+ * @param hash The hash of the request
+ * @param build Returns a new resource for the request
+ * @param record Called with the resource once it is inserted, under the resource lock
+ */
+template <class T, class Build, class Record>
+T &request_concurrent_resource(std::size_t                         hash,
+                               std::mutex                         &resource_mutex,
+                               std::atomic<uint32_t>              &contention_count,
+                               ReadMostlyMap<T>                   &index,
+                               std::unordered_map<std::size_t, T> &resources,
+                               Build                             &&build,
+                               Record                            &&record)
+{
+	VKB_PROFILE_SCOPE("ResourceCache lookup");
+
+	if (T *res = index.find(hash))
+	{
+		return *res;
+	}
+
+	{
+		auto guard = lock_resource(resource_mutex, contention_count);
+
+		auto res_it = resources.find(hash);
+
+		if (res_it != resources.end())
+		{
+			return res_it->second;
+		}
+	}
+
+	LOGD("Building cache object ({})", typeid(T).name());
+
+	VKB_PROFILE_SCOPE("ResourceCache build");
+
+	T resource = build();
+
+	auto guard = lock_resource(resource_mutex, contention_count);
+
+	auto res_ins_it = resources.emplace(hash, std::move(resource));
+
+	if (res_ins_it.second)
+	{
+		index.insert(hash, &res_ins_it.first->second);
+
+		record(res_ins_it.first->second);
+	}
+
+	return res_ins_it.first->second;
+}
+
+/**
+ * @brief Rebuilds the lookup index of a resource map once some of its resources were erased or moved
+ */
+template <class T>
+void rebuild_index(ReadMostlyMap<T> &index, std::unordered_map<std::size_t, T> &resources)
+{
+	index.clear();
+	for (auto &kv_pair : resources)
+	{
+		index.insert(kv_pair.first, &kv_pair.second);
+	}
+}
+}        // namespace common
+}        // namespace vkb
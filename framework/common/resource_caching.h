@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2021, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -144,8 +144,7 @@ struct hash<vkb::LoadStoreInfo>
 	{
 		std::size_t result = 0;
 
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkAttachmentLoadOp>::type>(load_store_info.load_op));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkAttachmentStoreOp>::type>(load_store_info.store_op));
+		vkb::hash_combine_bytes(result, load_store_info);
 
 		return result;
 	}
@@ -176,6 +175,7 @@ struct hash<vkb::SubpassInfo>
 		vkb::hash_combine(result, subpass_info.disable_depth_stencil_attachment);
 		vkb::hash_combine(result, subpass_info.depth_stencil_resolve_attachment);
 		vkb::hash_combine(result, subpass_info.depth_stencil_resolve_mode);
+		vkb::hash_combine(result, subpass_info.view_mask);
 
 		return result;
 	}
@@ -255,6 +255,50 @@ struct hash<VkDescriptorImageInfo>
 	}
 };
 
+template <>
+struct hash<VkSamplerCreateInfo>
+{
+	std::size_t operator()(const VkSamplerCreateInfo &sampler_info) const
+	{
+		std::size_t result = 0;
+
+		vkb::hash_combine(result, sampler_info.flags);
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkFilter>::type>(sampler_info.magFilter));
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkFilter>::type>(sampler_info.minFilter));
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkSamplerMipmapMode>::type>(sampler_info.mipmapMode));
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkSamplerAddressMode>::type>(sampler_info.addressModeU));
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkSamplerAddressMode>::type>(sampler_info.addressModeV));
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkSamplerAddressMode>::type>(sampler_info.addressModeW));
+		vkb::hash_combine(result, sampler_info.mipLodBias);
+		vkb::hash_combine(result, sampler_info.anisotropyEnable);
+		vkb::hash_combine(result, sampler_info.maxAnisotropy);
+		vkb::hash_combine(result, sampler_info.compareEnable);
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkCompareOp>::type>(sampler_info.compareOp));
+		vkb::hash_combine(result, sampler_info.minLod);
+		vkb::hash_combine(result, sampler_info.maxLod);
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkBorderColor>::type>(sampler_info.borderColor));
+		vkb::hash_combine(result, sampler_info.unnormalizedCoordinates);
+
+		return result;
+	}
+};
+
+template <>
+struct hash<VkComponentMapping>
+{
+	std::size_t operator()(const VkComponentMapping &components) const
+	{
+		std::size_t result = 0;
+
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkComponentSwizzle>::type>(components.r));
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkComponentSwizzle>::type>(components.g));
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkComponentSwizzle>::type>(components.b));
+		vkb::hash_combine(result, static_cast<std::underlying_type<VkComponentSwizzle>::type>(components.a));
+
+		return result;
+	}
+};
+
 template <>
 struct hash<VkWriteDescriptorSet>
 {
@@ -315,10 +359,7 @@ struct hash<VkVertexInputAttributeDescription>
 	{
 		std::size_t result = 0;
 
-		vkb::hash_combine(result, vertex_attrib.binding);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkFormat>::type>(vertex_attrib.format));
-		vkb::hash_combine(result, vertex_attrib.location);
-		vkb::hash_combine(result, vertex_attrib.offset);
+		vkb::hash_combine_bytes(result, vertex_attrib);
 
 		return result;
 	}
@@ -331,9 +372,7 @@ struct hash<VkVertexInputBindingDescription>
 	{
 		std::size_t result = 0;
 
-		vkb::hash_combine(result, vertex_binding.binding);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkVertexInputRate>::type>(vertex_binding.inputRate));
-		vkb::hash_combine(result, vertex_binding.stride);
+		vkb::hash_combine_bytes(result, vertex_binding);
 
 		return result;
 	}
@@ -346,10 +385,7 @@ struct hash<vkb::StencilOpState>
 	{
 		std::size_t result = 0;
 
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkCompareOp>::type>(stencil.compare_op));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkStencilOp>::type>(stencil.depth_fail_op));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkStencilOp>::type>(stencil.fail_op));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkStencilOp>::type>(stencil.pass_op));
+		vkb::hash_combine_bytes(result, stencil);
 
 		return result;
 	}
@@ -362,8 +398,7 @@ struct hash<VkExtent2D>
 	{
 		size_t result = 0;
 
-		vkb::hash_combine(result, extent.width);
-		vkb::hash_combine(result, extent.height);
+		vkb::hash_combine_bytes(result, extent);
 
 		return result;
 	}
@@ -376,8 +411,7 @@ struct hash<VkOffset2D>
 	{
 		size_t result = 0;
 
-		vkb::hash_combine(result, offset.x);
-		vkb::hash_combine(result, offset.y);
+		vkb::hash_combine_bytes(result, offset);
 
 		return result;
 	}
@@ -390,8 +424,7 @@ struct hash<VkRect2D>
 	{
 		size_t result = 0;
 
-		vkb::hash_combine(result, rect.extent);
-		vkb::hash_combine(result, rect.offset);
+		vkb::hash_combine_bytes(result, rect);
 
 		return result;
 	}
@@ -404,12 +437,7 @@ struct hash<VkViewport>
 	{
 		size_t result = 0;
 
-		vkb::hash_combine(result, viewport.width);
-		vkb::hash_combine(result, viewport.height);
-		vkb::hash_combine(result, viewport.maxDepth);
-		vkb::hash_combine(result, viewport.minDepth);
-		vkb::hash_combine(result, viewport.x);
-		vkb::hash_combine(result, viewport.y);
+		vkb::hash_combine_bytes(result, viewport);
 
 		return result;
 	}
@@ -422,14 +450,7 @@ struct hash<vkb::ColorBlendAttachmentState>
 	{
 		std::size_t result = 0;
 
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkBlendOp>::type>(color_blend_attachment.alpha_blend_op));
-		vkb::hash_combine(result, color_blend_attachment.blend_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkBlendOp>::type>(color_blend_attachment.color_blend_op));
-		vkb::hash_combine(result, color_blend_attachment.color_write_mask);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkBlendFactor>::type>(color_blend_attachment.dst_alpha_blend_factor));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkBlendFactor>::type>(color_blend_attachment.dst_color_blend_factor));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkBlendFactor>::type>(color_blend_attachment.src_alpha_blend_factor));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkBlendFactor>::type>(color_blend_attachment.src_color_blend_factor));
+		vkb::hash_combine_bytes(result, color_blend_attachment);
 
 		return result;
 	}
@@ -457,79 +478,7 @@ struct hash<vkb::PipelineState>
 {
 	std::size_t operator()(const vkb::PipelineState &pipeline_state) const
 	{
-		std::size_t result = 0;
-
-		vkb::hash_combine(result, pipeline_state.get_pipeline_layout().get_handle());
-
-		// For graphics only
-		if (auto render_pass = pipeline_state.get_render_pass())
-		{
-			vkb::hash_combine(result, render_pass->get_handle());
-		}
-
-		vkb::hash_combine(result, pipeline_state.get_specialization_constant_state());
-
-		vkb::hash_combine(result, pipeline_state.get_subpass_index());
-
-		for (auto shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
-		{
-			vkb::hash_combine(result, shader_module->get_id());
-		}
-
-		// VkPipelineVertexInputStateCreateInfo
-		for (auto &attribute : pipeline_state.get_vertex_input_state().attributes)
-		{
-			vkb::hash_combine(result, attribute);
-		}
-
-		for (auto &binding : pipeline_state.get_vertex_input_state().bindings)
-		{
-			vkb::hash_combine(result, binding);
-		}
-
-		// VkPipelineInputAssemblyStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_input_assembly_state().primitive_restart_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkPrimitiveTopology>::type>(pipeline_state.get_input_assembly_state().topology));
-
-		//VkPipelineViewportStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_viewport_state().viewport_count);
-		vkb::hash_combine(result, pipeline_state.get_viewport_state().scissor_count);
-
-		// VkPipelineRasterizationStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_rasterization_state().cull_mode);
-		vkb::hash_combine(result, pipeline_state.get_rasterization_state().depth_bias_enable);
-		vkb::hash_combine(result, pipeline_state.get_rasterization_state().depth_clamp_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkFrontFace>::type>(pipeline_state.get_rasterization_state().front_face));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkPolygonMode>::type>(pipeline_state.get_rasterization_state().polygon_mode));
-		vkb::hash_combine(result, pipeline_state.get_rasterization_state().rasterizer_discard_enable);
-
-		// VkPipelineMultisampleStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().alpha_to_coverage_enable);
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().alpha_to_one_enable);
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().min_sample_shading);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkSampleCountFlagBits>::type>(pipeline_state.get_multisample_state().rasterization_samples));
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().sample_shading_enable);
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().sample_mask);
-
-		// VkPipelineDepthStencilStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().back);
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().depth_bounds_test_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkCompareOp>::type>(pipeline_state.get_depth_stencil_state().depth_compare_op));
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().depth_test_enable);
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().depth_write_enable);
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().front);
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().stencil_test_enable);
-
-		// VkPipelineColorBlendStateCreateInfo
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkLogicOp>::type>(pipeline_state.get_color_blend_state().logic_op));
-		vkb::hash_combine(result, pipeline_state.get_color_blend_state().logic_op_enable);
-
-		for (auto &attachment : pipeline_state.get_color_blend_state().attachments)
-		{
-			vkb::hash_combine(result, attachment);
-		}
-
-		return result;
+		return pipeline_state.get_hash();
 	}
 };
 }        // namespace std
@@ -554,7 +503,7 @@ inline void hash_param<std::vector<uint8_t>>(
     size_t &                    seed,
     const std::vector<uint8_t> &value)
 {
-	hash_combine(seed, std::string{value.begin(), value.end()});
+	hash_combine_bytes(seed, value.data(), value.size());
 }
 
 template <>
@@ -573,10 +522,7 @@ inline void hash_param<std::vector<LoadStoreInfo>>(
     size_t &                          seed,
     const std::vector<LoadStoreInfo> &value)
 {
-	for (auto &load_store_info : value)
-	{
-		hash_combine(seed, load_store_info);
-	}
+	hash_combine_bytes(seed, value.data(), value.size());
 }
 
 template <>
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -47,6 +47,7 @@ class CommandBuffer;
 
 /**
  * @brief Takes a screenshot of the app by writing the swapchain image to file (slow function)
+ *        Waits for the copy and the encoding, use a FrameReadback to capture frames without stalling
  * @param render_context The RenderContext to use
  * @param filename The name of the file to save the output to
  */
@@ -105,4 +106,12 @@ sg::Light &add_spot_light(sg::Scene &scene, const glm::vec3 &position, const glm
  */
 sg::Node &add_free_camera(sg::Scene &scene, const std::string &node_name, VkExtent2D extent);
 
+/**
+ * @brief Checks whether compute shaders can reduce values with subgroup arithmetic operations
+ * @param device The device to run the shaders on
+ * @param api_version The Vulkan version of the instance, subgroup operations need version 1.1
+ * @return Whether basic and arithmetic subgroup operations are supported in the compute stage
+ */
+bool supports_subgroup_arithmetic(Device &device, uint32_t api_version);
+
 }        // namespace vkb
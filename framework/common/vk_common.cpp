@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -20,6 +20,7 @@
 
 #include <fmt/format.h>
 
+#include "core/physical_device.h"
 #include "filesystem/legacy.h"
 #include "glsl_compiler.h"
 
@@ -149,7 +150,14 @@ bool is_depth_format(VkFormat format)
 	return is_depth_only_format(format) || is_depth_stencil_format(format);
 }
 
-VkFormat get_suitable_depth_format(VkPhysicalDevice physical_device, bool depth_only, const std::vector<VkFormat> &depth_format_priority_list)
+namespace
+{
+/**
+ * @brief Picks the first format of the priority list usable as an optimal tiling depth attachment
+ * @param get_format_properties Returns the properties of a format
+ */
+template <class GetFormatProperties>
+VkFormat select_depth_format(bool depth_only, const std::vector<VkFormat> &depth_format_priority_list, GetFormatProperties &&get_format_properties)
 {
 	VkFormat depth_format{VK_FORMAT_UNDEFINED};
 
@@ -160,8 +168,7 @@ VkFormat get_suitable_depth_format(VkPhysicalDevice physical_device, bool depth_
 			continue;
 		}
 
-		VkFormatProperties properties;
-		vkGetPhysicalDeviceFormatProperties(physical_device, format, &properties);
+		VkFormatProperties properties = get_format_properties(format);
 
 		// Format must support depth stencil attachment for optimal tiling
 		if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
@@ -179,6 +186,21 @@ VkFormat get_suitable_depth_format(VkPhysicalDevice physical_device, bool depth_
 
 	throw std::runtime_error("No suitable depth format could be determined");
 }
+}        // namespace
+
+VkFormat get_suitable_depth_format(VkPhysicalDevice physical_device, bool depth_only, const std::vector<VkFormat> &depth_format_priority_list)
+{
+	return select_depth_format(depth_only, depth_format_priority_list, [physical_device](VkFormat format) {
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(physical_device, format, &properties);
+		return properties;
+	});
+}
+
+VkFormat get_suitable_depth_format(const PhysicalDevice &gpu, bool depth_only, const std::vector<VkFormat> &depth_format_priority_list)
+{
+	return select_depth_format(depth_only, depth_format_priority_list, [&gpu](VkFormat format) { return gpu.get_format_properties(format); });
+}
 
 VkFormat choose_blendable_format(VkPhysicalDevice physical_device, const std::vector<VkFormat> &format_priority_list)
 {
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  * Copyright (c) 2024, Mobica Limited
  *
@@ -41,6 +41,8 @@ using BindingMap = std::map<uint32_t, std::map<uint32_t, T>>;
 
 namespace vkb
 {
+class PhysicalDevice;
+
 enum class BindingType
 {
 	C,
@@ -83,6 +85,17 @@ VkFormat get_suitable_depth_format(VkPhysicalDevice             physical_device,
                                        VK_FORMAT_D24_UNORM_S8_UINT,
                                        VK_FORMAT_D16_UNORM});
 
+/**
+ * @brief Helper function to determine a suitable supported depth format based on a priority list,
+ *        with the format properties probed by a previous launch if the GPU has them, see PhysicalDevice::get_format_properties()
+ */
+VkFormat get_suitable_depth_format(const PhysicalDevice        &gpu,
+                                   bool                         depth_only                 = false,
+                                   const std::vector<VkFormat> &depth_format_priority_list = {
+                                       VK_FORMAT_D32_SFLOAT,
+                                       VK_FORMAT_D24_UNORM_S8_UINT,
+                                       VK_FORMAT_D16_UNORM});
+
 /**
  * @brief Helper function to pick a blendable format from a priority ordered list
  * @param physical_device The physical device to check the formats against
@@ -192,6 +205,10 @@ struct BufferMemoryBarrier
 	VkAccessFlags src_access_mask{0};
 
 	VkAccessFlags dst_access_mask{0};
+
+	uint32_t old_queue_family{VK_QUEUE_FAMILY_IGNORED};
+
+	uint32_t new_queue_family{VK_QUEUE_FAMILY_IGNORED};
 };
 
 /**
@@ -46,7 +46,8 @@ uint64_t AccelerationStructure::add_triangle_geometry(std::unique_ptr<vkb::core:
                                                       VkFormat vertex_format, VkGeometryFlagsKHR flags,
                                                       uint64_t vertex_buffer_data_address,
                                                       uint64_t index_buffer_data_address,
-                                                      uint64_t transform_buffer_data_address)
+                                                      uint64_t transform_buffer_data_address,
+                                                      VkIndexType index_type)
 {
 	VkAccelerationStructureGeometryKHR geometry{};
 	geometry.sType                                          = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
@@ -56,10 +57,10 @@ uint64_t AccelerationStructure::add_triangle_geometry(std::unique_ptr<vkb::core:
 	geometry.geometry.triangles.vertexFormat                = vertex_format;
 	geometry.geometry.triangles.maxVertex                   = max_vertex;
 	geometry.geometry.triangles.vertexStride                = vertex_stride;
-	geometry.geometry.triangles.indexType                   = VK_INDEX_TYPE_UINT32;
+	geometry.geometry.triangles.indexType                   = index_type;
 	geometry.geometry.triangles.vertexData.deviceAddress    = vertex_buffer_data_address == 0 ? vertex_buffer->get_device_address() : vertex_buffer_data_address;
-	geometry.geometry.triangles.indexData.deviceAddress     = index_buffer_data_address == 0 ? index_buffer->get_device_address() : index_buffer_data_address;
-	geometry.geometry.triangles.transformData.deviceAddress = transform_buffer_data_address == 0 ? transform_buffer->get_device_address() : transform_buffer_data_address;
+	geometry.geometry.triangles.indexData.deviceAddress     = index_buffer_data_address == 0 ? (index_buffer ? index_buffer->get_device_address() : 0) : index_buffer_data_address;
+	geometry.geometry.triangles.transformData.deviceAddress = transform_buffer_data_address == 0 ? (transform_buffer ? transform_buffer->get_device_address() : 0) : transform_buffer_data_address;
 
 	uint64_t index = geometries.size();
 	geometries.insert({index, {geometry, triangle_count, transform_offset}});
@@ -75,7 +76,8 @@ void AccelerationStructure::update_triangle_geometry(uint64_t
                                                      VkFormat vertex_format, VkGeometryFlagsKHR flags,
                                                      uint64_t vertex_buffer_data_address,
                                                      uint64_t index_buffer_data_address,
-                                                     uint64_t transform_buffer_data_address)
+                                                     uint64_t transform_buffer_data_address,
+                                                     VkIndexType index_type)
 {
 	VkAccelerationStructureGeometryKHR *geometry             = &geometries[triangleUUID].geometry;
 	geometry->sType                                          = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
@@ -85,10 +87,10 @@ void AccelerationStructure::update_triangle_geometry(uint64_t
 	geometry->geometry.triangles.vertexFormat                = vertex_format;
 	geometry->geometry.triangles.maxVertex                   = max_vertex;
 	geometry->geometry.triangles.vertexStride                = vertex_stride;
-	geometry->geometry.triangles.indexType                   = VK_INDEX_TYPE_UINT32;
+	geometry->geometry.triangles.indexType                   = index_type;
 	geometry->geometry.triangles.vertexData.deviceAddress    = vertex_buffer_data_address == 0 ? vertex_buffer->get_device_address() : vertex_buffer_data_address;
-	geometry->geometry.triangles.indexData.deviceAddress     = index_buffer_data_address == 0 ? index_buffer->get_device_address() : index_buffer_data_address;
-	geometry->geometry.triangles.transformData.deviceAddress = transform_buffer_data_address == 0 ? transform_buffer->get_device_address() : transform_buffer_data_address;
+	geometry->geometry.triangles.indexData.deviceAddress     = index_buffer_data_address == 0 ? (index_buffer ? index_buffer->get_device_address() : 0) : index_buffer_data_address;
+	geometry->geometry.triangles.transformData.deviceAddress = transform_buffer_data_address == 0 ? (transform_buffer ? transform_buffer->get_device_address() : 0) : transform_buffer_data_address;
 	geometries[triangleUUID].primitive_count                 = triangle_count;
 	geometries[triangleUUID].transform_offset                = transform_offset;
 	geometries[triangleUUID].updated                         = true;
@@ -127,42 +129,65 @@ void AccelerationStructure::update_instance_geometry(uint64_t
 }
 
 void AccelerationStructure::build(VkQueue queue, VkBuildAccelerationStructureFlagsKHR flags, VkBuildAccelerationStructureModeKHR mode)
+{
+	VkDeviceSize scratch_size = prepare_build(flags, mode);
+
+	// Create a scratch buffer as a temporary storage for the acceleration structure build
+	scratch_buffer = std::make_unique<vkb::core::Buffer>(
+	    device,
+	    scratch_size,
+	    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+	    VMA_MEMORY_USAGE_GPU_ONLY);
+
+	build_geometry_info.scratchData.deviceAddress = scratch_buffer->get_device_address();
+
+	// Build the acceleration structure on the device via a one-time command buffer submission
+	VkCommandBuffer command_buffer       = device.create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+	auto            as_build_range_infos = &*build_range_infos.data();
+	vkCmdBuildAccelerationStructuresKHR(
+	    command_buffer,
+	    1,
+	    &build_geometry_info,
+	    &as_build_range_infos);
+	device.flush_command_buffer(command_buffer, queue);
+	scratch_buffer.reset();
+}
+
+VkDeviceSize AccelerationStructure::prepare_build(VkBuildAccelerationStructureFlagsKHR flags, VkBuildAccelerationStructureModeKHR mode)
 {
 	assert(!geometries.empty());
 
-	std::vector<VkAccelerationStructureGeometryKHR>       acceleration_structure_geometries;
-	std::vector<VkAccelerationStructureBuildRangeInfoKHR> acceleration_structure_build_range_infos;
-	std::vector<uint32_t>                                 primitive_counts;
+	bool update = mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR && handle != VK_NULL_HANDLE;
+
+	// An update must have the geometries of the build it updates, including the unchanged ones
+	build_geometries.clear();
+	build_range_infos.clear();
+	std::vector<uint32_t> primitive_counts;
 	for (auto &geometry : geometries)
 	{
-		if (mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR && !geometry.second.updated)
-		{
-			continue;
-		}
-		acceleration_structure_geometries.push_back(geometry.second.geometry);
+		build_geometries.push_back(geometry.second.geometry);
 		// Infer build range info from geometry
 		VkAccelerationStructureBuildRangeInfoKHR build_range_info;
 		build_range_info.primitiveCount  = geometry.second.primitive_count;
 		build_range_info.primitiveOffset = 0;
 		build_range_info.firstVertex     = 0;
 		build_range_info.transformOffset = geometry.second.transform_offset;
-		acceleration_structure_build_range_infos.push_back(build_range_info);
+		build_range_infos.push_back(build_range_info);
 		primitive_counts.push_back(geometry.second.primitive_count);
 		geometry.second.updated = false;
 	}
 
-	VkAccelerationStructureBuildGeometryInfoKHR build_geometry_info{};
+	build_geometry_info       = {};
 	build_geometry_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
 	build_geometry_info.type  = type;
 	build_geometry_info.flags = flags;
-	build_geometry_info.mode  = mode;
-	if (mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR && handle != VK_NULL_HANDLE)
+	build_geometry_info.mode  = update ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR : VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+	if (update)
 	{
 		build_geometry_info.srcAccelerationStructure = handle;
-		build_geometry_info.dstAccelerationStructure = handle;
 	}
-	build_geometry_info.geometryCount = static_cast<uint32_t>(acceleration_structure_geometries.size());
-	build_geometry_info.pGeometries   = acceleration_structure_geometries.data();
+	build_geometry_info.geometryCount = static_cast<uint32_t>(build_geometries.size());
+	build_geometry_info.pGeometries   = build_geometries.data();
 
 	// Get required build sizes
 	build_sizes_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
@@ -173,54 +198,48 @@ void AccelerationStructure::build(VkQueue queue, VkBuildAccelerationStructureFla
 	    primitive_counts.data(),
 	    &build_sizes_info);
 
-	// Create a buffer for the acceleration structure
-	if (!buffer || buffer->get_size() != build_sizes_info.accelerationStructureSize)
+	// Create a buffer for the acceleration structure, updates are done in place
+	if (!update && (!buffer || buffer->get_size() != build_sizes_info.accelerationStructureSize))
 	{
-		buffer = std::make_unique<vkb::core::Buffer>(
-		    device,
-		    build_sizes_info.accelerationStructureSize,
-		    VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-		    VMA_MEMORY_USAGE_GPU_ONLY);
-
-		VkAccelerationStructureCreateInfoKHR acceleration_structure_create_info{};
-		acceleration_structure_create_info.sType  = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
-		acceleration_structure_create_info.buffer = buffer->get_handle();
-		acceleration_structure_create_info.size   = build_sizes_info.accelerationStructureSize;
-		acceleration_structure_create_info.type   = type;
-		VkResult result                           = vkCreateAccelerationStructureKHR(device.get_handle(), &acceleration_structure_create_info, nullptr, &handle);
-
-		if (result != VK_SUCCESS)
-		{
-			throw VulkanException{result, "Could not create acceleration structure"};
-		}
+		create(build_sizes_info.accelerationStructureSize);
 	}
 
-	// Get the acceleration structure's handle
-	VkAccelerationStructureDeviceAddressInfoKHR acceleration_device_address_info{};
-	acceleration_device_address_info.sType                 = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
-	acceleration_device_address_info.accelerationStructure = handle;
-	device_address                                         = vkGetAccelerationStructureDeviceAddressKHR(device.get_handle(), &acceleration_device_address_info);
+	build_geometry_info.dstAccelerationStructure = handle;
 
-	// Create a scratch buffer as a temporary storage for the acceleration structure build
-	scratch_buffer = std::make_unique<vkb::core::Buffer>(
+	return update ? build_sizes_info.updateScratchSize : build_sizes_info.buildScratchSize;
+}
+
+void AccelerationStructure::create(VkDeviceSize size)
+{
+	if (handle != VK_NULL_HANDLE)
+	{
+		vkDestroyAccelerationStructureKHR(device.get_handle(), handle, nullptr);
+		handle = VK_NULL_HANDLE;
+	}
+
+	buffer = std::make_unique<vkb::core::Buffer>(
 	    device,
-	    build_sizes_info.buildScratchSize,
-	    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+	    size,
+	    VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
 	    VMA_MEMORY_USAGE_GPU_ONLY);
 
-	build_geometry_info.scratchData.deviceAddress = scratch_buffer->get_device_address();
-	build_geometry_info.dstAccelerationStructure  = handle;
+	VkAccelerationStructureCreateInfoKHR acceleration_structure_create_info{};
+	acceleration_structure_create_info.sType  = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+	acceleration_structure_create_info.buffer = buffer->get_handle();
+	acceleration_structure_create_info.size   = size;
+	acceleration_structure_create_info.type   = type;
+	VkResult result                           = vkCreateAccelerationStructureKHR(device.get_handle(), &acceleration_structure_create_info, nullptr, &handle);
 
-	// Build the acceleration structure on the device via a one-time command buffer submission
-	VkCommandBuffer command_buffer       = device.create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-	auto            as_build_range_infos = &*acceleration_structure_build_range_infos.data();
-	vkCmdBuildAccelerationStructuresKHR(
-	    command_buffer,
-	    1,
-	    &build_geometry_info,
-	    &as_build_range_infos);
-	device.flush_command_buffer(command_buffer, queue);
-	scratch_buffer.reset();
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Could not create acceleration structure"};
+	}
+
+	// Get the acceleration structure's handle
+	VkAccelerationStructureDeviceAddressInfoKHR acceleration_device_address_info{};
+	acceleration_device_address_info.sType                 = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
+	acceleration_device_address_info.accelerationStructure = handle;
+	device_address                                         = vkGetAccelerationStructureDeviceAddressKHR(device.get_handle(), &acceleration_device_address_info);
 }
 
 VkAccelerationStructureKHR AccelerationStructure::get_handle() const
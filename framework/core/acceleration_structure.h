@@ -27,11 +27,15 @@ class Device;
 
 namespace core
 {
+class AccelerationStructureBuilder;
+
 /**
  * @brief Wraps setup and access for a ray tracing top- or bottom-level acceleration structure
  */
 class AccelerationStructure
 {
+	friend class AccelerationStructureBuilder;
+
   public:
 	/**
 	 * @brief Creates a acceleration structure and the required buffer to store it's geometries
@@ -48,7 +52,7 @@ class AccelerationStructure
 	 * @returns UUID for the geometry instance for the case of multiple geometries to look up in the map
 	 * @param vertex_buffer Buffer containing vertices
 	 * @param index_buffer Buffer containing indices
-	 * @param transform_buffer Buffer containing transform data
+	 * @param transform_buffer Buffer containing transform data, may be null if the geometry is not transformed
 	 * @param triangle_count Number of triangles for this geometry
 	 * @param max_vertex Index of the last vertex in the geometry
 	 * @param vertex_stride Stride of the vertex structure
@@ -58,6 +62,7 @@ class AccelerationStructure
 	 * @param vertex_buffer_data_address set this if don't want the vertex_buffer data_address
 	 * @param index_buffer_data_address set this if don't want the index_buffer data_address
 	 * @param transform_buffer_data_address set this if don't want the transform_buffer data_address
+	 * @param index_type Type of the indices, VK_INDEX_TYPE_NONE_KHR if the geometry is not indexed
 	 */
 	uint64_t add_triangle_geometry(std::unique_ptr<vkb::core::Buffer> &vertex_buffer,
 	                               std::unique_ptr<vkb::core::Buffer> &index_buffer,
@@ -70,7 +75,8 @@ class AccelerationStructure
 	                               VkGeometryFlagsKHR                  flags                         = VK_GEOMETRY_OPAQUE_BIT_KHR,
 	                               uint64_t                            vertex_buffer_data_address    = 0,
 	                               uint64_t                            index_buffer_data_address     = 0,
-	                               uint64_t                            transform_buffer_data_address = 0);
+	                               uint64_t                            transform_buffer_data_address = 0,
+	                               VkIndexType                         index_type                    = VK_INDEX_TYPE_UINT32);
 
 	void update_triangle_geometry(uint64_t triangleUUID, std::unique_ptr<vkb::core::Buffer> &vertex_buffer,
 	                              std::unique_ptr<vkb::core::Buffer> &index_buffer,
@@ -83,7 +89,8 @@ class AccelerationStructure
 	                              VkGeometryFlagsKHR                  flags                         = VK_GEOMETRY_OPAQUE_BIT_KHR,
 	                              uint64_t                            vertex_buffer_data_address    = 0,
 	                              uint64_t                            index_buffer_data_address     = 0,
-	                              uint64_t                            transform_buffer_data_address = 0);
+	                              uint64_t                            transform_buffer_data_address = 0,
+	                              VkIndexType                         index_type                    = VK_INDEX_TYPE_UINT32);
 
 	/**
 	 * @brief Adds instance geometry to the acceleration structure (only valid for top level)
@@ -105,9 +112,10 @@ class AccelerationStructure
 
 	/**
 	 * @brief Builds the acceleration structure on the device (requires at least one geometry to be added)
+	 *        To build many structures at once, see AccelerationStructureBuilder.
 	 * @param queue Queue to use for the build process
 	 * @param flags Build flags
-	 * @param mode Build mode (build or update)
+	 * @param mode Build mode (build or update), updates require a build with VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR
 	 */
 	void build(VkQueue                              queue,
 	           VkBuildAccelerationStructureFlagsKHR flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR,
@@ -130,6 +138,17 @@ class AccelerationStructure
 	}
 
   private:
+	/**
+	 * @brief Prepares the build info of the geometries, and creates the structure if it is not updated in place
+	 * @return The size of the scratch memory the build needs
+	 */
+	VkDeviceSize prepare_build(VkBuildAccelerationStructureFlagsKHR flags, VkBuildAccelerationStructureModeKHR mode);
+
+	/**
+	 * @brief Creates the structure, and the buffer storing it
+	 */
+	void create(VkDeviceSize size);
+
 	Device &device;
 
 	VkAccelerationStructureKHR handle{VK_NULL_HANDLE};
@@ -152,6 +171,13 @@ class AccelerationStructure
 
 	std::map<uint64_t, Geometry> geometries{};
 
+	/// Build info of the last prepare_build(), without scratch data
+	VkAccelerationStructureBuildGeometryInfoKHR build_geometry_info{};
+
+	std::vector<VkAccelerationStructureGeometryKHR> build_geometries;
+
+	std::vector<VkAccelerationStructureBuildRangeInfoKHR> build_range_infos;
+
 	std::unique_ptr<vkb::core::Buffer> buffer{nullptr};
 };
 }        // namespace core
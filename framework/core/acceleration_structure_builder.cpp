@@ -0,0 +1,239 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "acceleration_structure_builder.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "acceleration_structure.h"
+#include "common/logging.h"
+#include "core/buffer.h"
+#include "core/query_pool.h"
+#include "device.h"
+
+namespace vkb
+{
+namespace core
+{
+namespace
+{
+VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+}        // namespace
+
+AccelerationStructureBuilder::AccelerationStructureBuilder(Device &device, VkDeviceSize max_scratch_size) :
+    device{device},
+    max_scratch_size{max_scratch_size}
+{
+	VkPhysicalDeviceAccelerationStructurePropertiesKHR acceleration_structure_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
+
+	VkPhysicalDeviceProperties2KHR properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+	properties.pNext = &acceleration_structure_properties;
+	vkGetPhysicalDeviceProperties2KHR(device.get_gpu().get_handle(), &properties);
+
+	scratch_alignment = std::max<VkDeviceSize>(acceleration_structure_properties.minAccelerationStructureScratchOffsetAlignment, 1);
+}
+
+void AccelerationStructureBuilder::add(AccelerationStructure &acceleration_structure, VkBuildAccelerationStructureFlagsKHR flags, VkBuildAccelerationStructureModeKHR mode)
+{
+	builds.push_back({&acceleration_structure, flags, mode});
+}
+
+void AccelerationStructureBuilder::build(VkQueue queue)
+{
+	if (builds.empty())
+	{
+		return;
+	}
+
+	// Suballocate the scratch memory of the builds, starting a new batch when the arena is full
+	std::vector<VkDeviceSize> scratch_offsets;
+	std::vector<size_t>       batch_ends;
+	VkDeviceSize              arena_size   = 0;
+	VkDeviceSize              batch_offset = 0;
+
+	std::vector<AccelerationStructure *> compacted_structures;
+
+	for (size_t i = 0; i < builds.size(); ++i)
+	{
+		auto &build        = builds[i];
+		auto  scratch_size = align_up(build.acceleration_structure->prepare_build(build.flags, build.mode), scratch_alignment);
+
+		if (batch_offset > 0 && batch_offset + scratch_size > max_scratch_size)
+		{
+			batch_ends.push_back(i);
+			batch_offset = 0;
+		}
+
+		scratch_offsets.push_back(batch_offset);
+		batch_offset += scratch_size;
+		arena_size = std::max(arena_size, batch_offset);
+
+		// Updated structures are refitted in place, only new builds are compacted
+		if (build.acceleration_structure->build_geometry_info.mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR &&
+		    (build.flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR))
+		{
+			compacted_structures.push_back(build.acceleration_structure);
+		}
+	}
+	batch_ends.push_back(builds.size());
+
+	// The arena has room for aligning its start
+	auto scratch_buffer = std::make_unique<vkb::core::Buffer>(
+	    device,
+	    arena_size + scratch_alignment,
+	    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+	    VMA_MEMORY_USAGE_GPU_ONLY);
+
+	VkDeviceAddress scratch_address = align_up(scratch_buffer->get_device_address(), scratch_alignment);
+
+	std::unique_ptr<QueryPool> query_pool;
+	if (!compacted_structures.empty())
+	{
+		VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		query_pool_info.queryType  = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+		query_pool_info.queryCount = to_u32(compacted_structures.size());
+		query_pool                 = std::make_unique<QueryPool>(device, query_pool_info);
+	}
+
+	VkCommandBuffer command_buffer = device.create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+
+	// Scratch memory is reused by the next batch, and compacted sizes are only known once the builds are done
+	VkMemoryBarrier build_barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+	build_barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+	build_barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+	size_t batch_begin = 0;
+	for (auto batch_end : batch_ends)
+	{
+		std::vector<VkAccelerationStructureBuildGeometryInfoKHR>      build_geometry_infos;
+		std::vector<const VkAccelerationStructureBuildRangeInfoKHR *> build_range_infos;
+
+		for (size_t i = batch_begin; i < batch_end; ++i)
+		{
+			auto acceleration_structure = builds[i].acceleration_structure;
+
+			acceleration_structure->build_geometry_info.scratchData.deviceAddress = scratch_address + scratch_offsets[i];
+
+			build_geometry_infos.push_back(acceleration_structure->build_geometry_info);
+			build_range_infos.push_back(acceleration_structure->build_range_infos.data());
+		}
+
+		vkCmdBuildAccelerationStructuresKHR(command_buffer,
+		                                    to_u32(build_geometry_infos.size()),
+		                                    build_geometry_infos.data(),
+		                                    build_range_infos.data());
+
+		vkCmdPipelineBarrier(command_buffer,
+		                     VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+		                     VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+		                     0, 1, &build_barrier, 0, nullptr, 0, nullptr);
+
+		batch_begin = batch_end;
+	}
+
+	if (query_pool)
+	{
+		std::vector<VkAccelerationStructureKHR> handles;
+		for (auto acceleration_structure : compacted_structures)
+		{
+			handles.push_back(acceleration_structure->get_handle());
+		}
+
+		vkCmdResetQueryPool(command_buffer, query_pool->get_handle(), 0, to_u32(handles.size()));
+		vkCmdWriteAccelerationStructuresPropertiesKHR(command_buffer,
+		                                              to_u32(handles.size()),
+		                                              handles.data(),
+		                                              VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+		                                              query_pool->get_handle(),
+		                                              0);
+	}
+
+	device.flush_command_buffer(command_buffer, queue);
+	builds.clear();
+
+	if (query_pool)
+	{
+		std::vector<VkDeviceSize> compacted_sizes(compacted_structures.size());
+		VK_CHECK(query_pool->get_results(0, to_u32(compacted_sizes.size()),
+		                                 compacted_sizes.size() * sizeof(VkDeviceSize), compacted_sizes.data(), sizeof(VkDeviceSize),
+		                                 VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+
+		compact(queue, compacted_structures, compacted_sizes);
+	}
+}
+
+void AccelerationStructureBuilder::compact(VkQueue queue, const std::vector<AccelerationStructure *> &compacted_structures, const std::vector<VkDeviceSize> &compacted_sizes)
+{
+	// The built structures are destroyed once copied
+	std::vector<VkAccelerationStructureKHR>         built_handles;
+	std::vector<std::unique_ptr<vkb::core::Buffer>> built_buffers;
+
+	VkDeviceSize built_size   = 0;
+	VkDeviceSize compact_size = 0;
+
+	VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+
+	for (size_t i = 0; i < compacted_structures.size(); ++i)
+	{
+		auto acceleration_structure = compacted_structures[i];
+
+		if (compacted_sizes[i] == 0 || compacted_sizes[i] >= acceleration_structure->buffer->get_size())
+		{
+			continue;
+		}
+
+		if (command_buffer == VK_NULL_HANDLE)
+		{
+			command_buffer = device.create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+		}
+
+		built_size += acceleration_structure->buffer->get_size();
+		compact_size += compacted_sizes[i];
+
+		built_handles.push_back(acceleration_structure->handle);
+		built_buffers.push_back(std::move(acceleration_structure->buffer));
+
+		acceleration_structure->handle = VK_NULL_HANDLE;
+		acceleration_structure->create(compacted_sizes[i]);
+
+		VkCopyAccelerationStructureInfoKHR copy_info{VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR};
+		copy_info.src  = built_handles.back();
+		copy_info.dst  = acceleration_structure->handle;
+		copy_info.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+		vkCmdCopyAccelerationStructureKHR(command_buffer, &copy_info);
+	}
+
+	if (command_buffer == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	device.flush_command_buffer(command_buffer, queue);
+
+	for (auto handle : built_handles)
+	{
+		vkDestroyAccelerationStructureKHR(device.get_handle(), handle, nullptr);
+	}
+
+	LOGI("Compacted {} acceleration structures from {} to {} bytes", built_handles.size(), built_size, compact_size);
+}
+}        // namespace core
+}        // namespace vkb
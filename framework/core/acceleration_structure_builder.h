@@ -0,0 +1,104 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+
+namespace core
+{
+class AccelerationStructure;
+
+/**
+ * @brief Builds many acceleration structures in one submission, and compacts them
+ *
+ * The structures added are built by as few vkCmdBuildAccelerationStructuresKHR calls as the scratch arena allows: the
+ * scratch memory of every build is suballocated from a single buffer of at most max_scratch_size bytes, and builds not
+ * fitting in it are recorded in a next batch reusing the arena.
+ *
+ * Structures built with VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR are then copied to a structure of
+ * their compacted size. Compaction changes their device address, so top-level structures referencing them must be
+ * built after build() returns.
+ */
+class AccelerationStructureBuilder
+{
+  public:
+	/**
+	 * @param device The device to build on
+	 * @param max_scratch_size The size of the scratch arena, raised to the scratch size of the largest build if needed
+	 */
+	AccelerationStructureBuilder(Device &device, VkDeviceSize max_scratch_size = 64 * 1024 * 1024);
+
+	AccelerationStructureBuilder(const AccelerationStructureBuilder &) = delete;
+
+	AccelerationStructureBuilder(AccelerationStructureBuilder &&) = delete;
+
+	AccelerationStructureBuilder &operator=(const AccelerationStructureBuilder &) = delete;
+
+	AccelerationStructureBuilder &operator=(AccelerationStructureBuilder &&) = delete;
+
+	/**
+	 * @brief Adds a structure to the next build(), it must have at least one geometry
+	 * @param acceleration_structure The structure to build, it must outlive the build
+	 * @param flags Build flags
+	 * @param mode Build mode (build or update), updates require a build with VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR
+	 *        and are not compacted
+	 */
+	void add(AccelerationStructure              &acceleration_structure,
+	         VkBuildAccelerationStructureFlagsKHR flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR,
+	         VkBuildAccelerationStructureModeKHR  mode  = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR);
+
+	/**
+	 * @brief Builds then compacts the structures added, and waits for the device to finish
+	 * @param queue Queue to use for the build process
+	 */
+	void build(VkQueue queue);
+
+  private:
+	struct Build
+	{
+		AccelerationStructure *acceleration_structure;
+
+		VkBuildAccelerationStructureFlagsKHR flags;
+
+		VkBuildAccelerationStructureModeKHR mode;
+	};
+
+	/**
+	 * @brief Copies the structures to their compacted size
+	 * @param compacted_structures The structures built with compaction allowed
+	 * @param compacted_sizes The compacted size of each structure
+	 */
+	void compact(VkQueue queue, const std::vector<AccelerationStructure *> &compacted_structures, const std::vector<VkDeviceSize> &compacted_sizes);
+
+	Device &device;
+
+	VkDeviceSize max_scratch_size;
+
+	VkDeviceSize scratch_alignment{1};
+
+	std::vector<Build> builds;
+};
+}        // namespace core
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2021-2026, NVIDIA CORPORATION. All rights reserved.
  * Copyright (c) 2024, Bradley Austin Davis. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -18,11 +18,394 @@
 
 #include "allocated.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
 namespace vkb
 {
 
 namespace allocated
 {
+namespace
+{
+std::array<std::atomic<VkDeviceSize>, MEMORY_TAG_COUNT> &get_tagged_memory()
+{
+	static std::array<std::atomic<VkDeviceSize>, MEMORY_TAG_COUNT> tagged_memory{};
+	return tagged_memory;
+}
+
+thread_local MemoryTag current_memory_tag = MemoryTag::Other;
+
+std::atomic<VkDeviceSize> &get_tagged_memory(const VmaAllocationInfo &allocation_info)
+{
+	auto tag = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(allocation_info.pUserData));
+	assert(tag < MEMORY_TAG_COUNT && "The user data of the allocation is not a memory tag");
+	return get_tagged_memory()[tag];
+}
+
+std::atomic<uint64_t> move_generation{0};
+
+MemoryArchitecture memory_architecture = MemoryArchitecture::Discrete;
+
+std::atomic<VkDeviceSize> direct_upload_memory{0};
+
+/**
+ * @return Whether the memory of an allocation is both device local and host visible
+ */
+bool is_direct_upload_memory(const VmaAllocationInfo &allocation_info)
+{
+	const VkMemoryPropertyFlags direct_upload_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+	VkMemoryPropertyFlags memory_properties;
+	vmaGetMemoryTypeProperties(get_memory_allocator(), allocation_info.memoryType, &memory_properties);
+	return (memory_properties & direct_upload_flags) == direct_upload_flags;
+}
+
+/**
+ * @brief Finds how the host reaches the device local memory
+ *        Without Resizable BAR, discrete GPUs only have a window of 256 MiB of device local memory visible to the host.
+ */
+MemoryArchitecture detect_memory_architecture()
+{
+	const VkPhysicalDeviceProperties *properties = nullptr;
+	vmaGetPhysicalDeviceProperties(get_memory_allocator(), &properties);
+
+	const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+	vmaGetMemoryProperties(get_memory_allocator(), &memory_properties);
+
+	VkDeviceSize device_local_heap_size  = 0;
+	VkDeviceSize host_visible_heap_size  = 0;
+	bool         all_device_local_mapped = true;
+
+	for (uint32_t i = 0; i < memory_properties->memoryTypeCount; ++i)
+	{
+		auto &memory_type = memory_properties->memoryTypes[i];
+		if (!(memory_type.propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+		{
+			continue;
+		}
+
+		VkDeviceSize heap_size = memory_properties->memoryHeaps[memory_type.heapIndex].size;
+		device_local_heap_size = std::max(device_local_heap_size, heap_size);
+
+		if (memory_type.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			host_visible_heap_size = std::max(host_visible_heap_size, heap_size);
+		}
+		else
+		{
+			all_device_local_mapped = false;
+		}
+	}
+
+	if (host_visible_heap_size == 0)
+	{
+		return MemoryArchitecture::Discrete;
+	}
+
+	if (properties->deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU || all_device_local_mapped)
+	{
+		return MemoryArchitecture::Unified;
+	}
+
+	constexpr VkDeviceSize bar_window_size = 256 * 1024 * 1024;
+
+	return host_visible_heap_size > bar_window_size && host_visible_heap_size >= device_local_heap_size ? MemoryArchitecture::ResizableBar : MemoryArchitecture::Discrete;
+}
+
+/**
+ * @brief The pools of the subsystems, keyed by tag and memory type, and the resources allocated from them
+ */
+struct MemoryPools
+{
+	std::mutex mutex;
+
+	std::map<std::pair<uint32_t, uint32_t>, VmaPool> pools;
+
+	std::unordered_map<VmaAllocation, AllocatedBase *> resources;
+};
+
+MemoryPools &get_pool_registry()
+{
+	static MemoryPools memory_pools;
+	return memory_pools;
+}
+
+void register_pooled_resource(VmaAllocation allocation, AllocatedBase *resource)
+{
+	auto &memory_pools = get_pool_registry();
+
+	std::lock_guard<std::mutex> lock{memory_pools.mutex};
+	memory_pools.resources[allocation] = resource;
+}
+
+void unregister_pooled_resource(VmaAllocation allocation)
+{
+	auto &memory_pools = get_pool_registry();
+
+	std::lock_guard<std::mutex> lock{memory_pools.mutex};
+	memory_pools.resources.erase(allocation);
+}
+
+/**
+ * @return The size of the memory an image needs, measured on a temporary image as VMA does to find its memory type
+ */
+VkDeviceSize get_image_memory_size(const VkImageCreateInfo &create_info)
+{
+	VmaAllocatorInfo allocator_info{};
+	vmaGetAllocatorInfo(get_memory_allocator(), &allocator_info);
+
+	VkImage image{VK_NULL_HANDLE};
+	if (vkCreateImage(allocator_info.device, &create_info, nullptr, &image) != VK_SUCCESS)
+	{
+		return 0;
+	}
+
+	VkMemoryRequirements memory_requirements{};
+	vkGetImageMemoryRequirements(allocator_info.device, image, &memory_requirements);
+	vkDestroyImage(allocator_info.device, image, nullptr);
+
+	return memory_requirements.size;
+}
+
+/**
+ * @brief Allocates the resources of a subsystem from its pool, or gives them a dedicated allocation if they are large
+ *        The allocations left as they are go to the default pools, like the memory the application maps.
+ * @param alloc_create_info The allocation info of the resource, whose user data holds its tag
+ * @param get_size Returns the size of the memory of the resource
+ * @param find_memory_type Finds the memory type of the resource
+ * @return Whether the resource is allocated from a pool
+ */
+template <typename GetSize, typename FindMemoryType>
+bool select_memory_pool(VmaAllocationCreateInfo &alloc_create_info, GetSize get_size, FindMemoryType find_memory_type)
+{
+	const VmaAllocationCreateFlags host_access_flags = VMA_ALLOCATION_CREATE_MAPPED_BIT |
+	                                                   VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+	                                                   VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+
+	auto tag    = static_cast<MemoryTag>(reinterpret_cast<uintptr_t>(alloc_create_info.pUserData));
+	auto config = get_memory_pool_config(tag);
+
+	if (config.block_size == 0 || alloc_create_info.pool != VK_NULL_HANDLE || (alloc_create_info.flags & VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT) ||
+	    (alloc_create_info.flags & host_access_flags) || (alloc_create_info.requiredFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ||
+	    alloc_create_info.usage == VMA_MEMORY_USAGE_CPU_ONLY || alloc_create_info.usage == VMA_MEMORY_USAGE_CPU_TO_GPU ||
+	    alloc_create_info.usage == VMA_MEMORY_USAGE_GPU_TO_CPU)
+	{
+		return false;
+	}
+
+	if (get_size() >= config.dedicated_threshold)
+	{
+		alloc_create_info.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+		return false;
+	}
+
+	uint32_t memory_type_index{0};
+	if (find_memory_type(memory_type_index) != VK_SUCCESS)
+	{
+		return false;
+	}
+
+	auto &memory_pools = get_pool_registry();
+
+	std::lock_guard<std::mutex> lock{memory_pools.mutex};
+
+	auto &pool = memory_pools.pools[{static_cast<uint32_t>(tag), memory_type_index}];
+	if (pool == VK_NULL_HANDLE)
+	{
+		VmaPoolCreateInfo pool_create_info{};
+		pool_create_info.memoryTypeIndex = memory_type_index;
+		pool_create_info.blockSize       = config.block_size;
+
+		if (vmaCreatePool(get_memory_allocator(), &pool_create_info, &pool) != VK_SUCCESS)
+		{
+			memory_pools.pools.erase({static_cast<uint32_t>(tag), memory_type_index});
+			return false;
+		}
+	}
+
+	alloc_create_info.pool = pool;
+	return true;
+}
+}        // namespace
+
+const char *to_string(MemoryTag tag)
+{
+	switch (tag)
+	{
+		case MemoryTag::Other:
+			return "other";
+		case MemoryTag::BufferPool:
+			return "buffer_pool";
+		case MemoryTag::RenderTarget:
+			return "render_target";
+		case MemoryTag::SceneTexture:
+			return "scene_texture";
+		case MemoryTag::SceneGeometry:
+			return "scene_geometry";
+		case MemoryTag::Staging:
+			return "staging";
+	}
+	return "unknown";
+}
+
+const char *to_string(MemoryArchitecture architecture)
+{
+	switch (architecture)
+	{
+		case MemoryArchitecture::Discrete:
+			return "discrete";
+		case MemoryArchitecture::ResizableBar:
+			return "resizable_bar";
+		case MemoryArchitecture::Unified:
+			return "unified";
+	}
+	return "unknown";
+}
+
+MemoryArchitecture get_memory_architecture()
+{
+	return memory_architecture;
+}
+
+void apply_upload_policy(VmaAllocationCreateInfo &alloc_create_info, UploadFrequency frequency)
+{
+	if (frequency == UploadFrequency::PerFrame)
+	{
+		if (memory_architecture == MemoryArchitecture::Discrete)
+		{
+			alloc_create_info.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+			alloc_create_info.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+		}
+		else
+		{
+			// Write combined memory, which the host must only write sequentially and never read
+			alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+			alloc_create_info.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+		}
+		return;
+	}
+
+	alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+	// VMA may still pick memory which is not host visible, in which case the buffer is staged
+	if (memory_architecture == MemoryArchitecture::Unified)
+	{
+		alloc_create_info.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+		                           VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT;
+	}
+}
+
+VkDeviceSize get_direct_upload_memory_usage()
+{
+	return direct_upload_memory.load(std::memory_order_relaxed);
+}
+
+MemoryPoolConfig get_memory_pool_config(MemoryTag tag)
+{
+	constexpr VkDeviceSize MiB = 1024 * 1024;
+
+	switch (tag)
+	{
+		case MemoryTag::RenderTarget:
+			// Render targets are recreated together on resize, and 4K targets are large enough for dedicated memory
+			return {64 * MiB, 32 * MiB};
+		case MemoryTag::SceneGeometry:
+			return {32 * MiB, 16 * MiB};
+		case MemoryTag::SceneTexture:
+			// Streamed textures come and go in every size, in the blocks that MemoryDefragmenter compacts
+			return {64 * MiB, 32 * MiB};
+		default:
+			return {};
+	}
+}
+
+std::vector<VmaPool> get_memory_pools(MemoryTag tag)
+{
+	auto &memory_pools = get_pool_registry();
+
+	std::lock_guard<std::mutex> lock{memory_pools.mutex};
+
+	std::vector<VmaPool> pools;
+	for (auto &key_pool : memory_pools.pools)
+	{
+		if (key_pool.first.first == static_cast<uint32_t>(tag))
+		{
+			pools.push_back(key_pool.second);
+		}
+	}
+
+	return pools;
+}
+
+uint64_t get_move_generation()
+{
+	return move_generation.load(std::memory_order_relaxed);
+}
+
+void next_move_generation()
+{
+	move_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocatedBase *find_pooled_resource(VmaAllocation allocation)
+{
+	auto &memory_pools = get_pool_registry();
+
+	std::lock_guard<std::mutex> lock{memory_pools.mutex};
+
+	auto it = memory_pools.resources.find(allocation);
+	return it != memory_pools.resources.end() ? it->second : nullptr;
+}
+
+VkDeviceSize get_tagged_memory_usage(MemoryTag tag)
+{
+	return get_tagged_memory()[static_cast<uint32_t>(tag)].load(std::memory_order_relaxed);
+}
+
+void track_allocation(VmaAllocation allocation)
+{
+	VmaAllocationInfo allocation_info{};
+	vmaGetAllocationInfo(get_memory_allocator(), allocation, &allocation_info);
+	get_tagged_memory(allocation_info).fetch_add(allocation_info.size, std::memory_order_relaxed);
+
+	if (is_direct_upload_memory(allocation_info))
+	{
+		direct_upload_memory.fetch_add(allocation_info.size, std::memory_order_relaxed);
+	}
+}
+
+void untrack_allocation(VmaAllocation allocation)
+{
+	VmaAllocationInfo allocation_info{};
+	vmaGetAllocationInfo(get_memory_allocator(), allocation, &allocation_info);
+	get_tagged_memory(allocation_info).fetch_sub(allocation_info.size, std::memory_order_relaxed);
+
+	if (is_direct_upload_memory(allocation_info))
+	{
+		direct_upload_memory.fetch_sub(allocation_info.size, std::memory_order_relaxed);
+	}
+}
+
+MemoryTag get_current_memory_tag()
+{
+	return current_memory_tag;
+}
+
+ScopedMemoryTag::ScopedMemoryTag(MemoryTag tag) :
+    previous_tag{current_memory_tag}
+{
+	current_memory_tag = tag;
+}
+
+ScopedMemoryTag::~ScopedMemoryTag()
+{
+	current_memory_tag = previous_tag;
+}
 
 VmaAllocator &get_memory_allocator()
 {
@@ -37,6 +420,9 @@ void init(const VmaAllocatorCreateInfo &create_info)
 	{
 		throw VulkanException{result, "Cannot create allocator"};
 	}
+
+	memory_architecture = detect_memory_architecture();
+	LOGI("Memory architecture: {}", to_string(memory_architecture));
 }
 
 void shutdown()
@@ -44,6 +430,13 @@ void shutdown()
 	auto &allocator = get_memory_allocator();
 	if (allocator != VK_NULL_HANDLE)
 	{
+		auto &memory_pools = get_pool_registry();
+		for (auto &key_pool : memory_pools.pools)
+		{
+			vmaDestroyPool(allocator, key_pool.second);
+		}
+		memory_pools.pools.clear();
+
 		VmaTotalStatistics stats;
 		vmaCalculateStatistics(allocator, &stats);
 		LOGI("Total device memory leaked: {} bytes.", stats.total.statistics.allocationBytes);
@@ -62,8 +455,14 @@ AllocatedBase::AllocatedBase(AllocatedBase &&other) noexcept :
     allocation(std::exchange(other.allocation, {})),
     mapped_data(std::exchange(other.mapped_data, {})),
     coherent(std::exchange(other.coherent, {})),
-    persistent(std::exchange(other.persistent, {}))
+    persistent(std::exchange(other.persistent, {})),
+    aliased(std::exchange(other.aliased, {})),
+    pooled(std::exchange(other.pooled, {}))
 {
+	if (pooled)
+	{
+		register_pooled_resource(allocation, this);
+	}
 }
 
 const uint8_t *AllocatedBase::get_data() const
@@ -78,6 +477,13 @@ VkDeviceMemory AllocatedBase::get_memory() const
 	return alloc_info.deviceMemory;
 }
 
+VkMemoryPropertyFlags AllocatedBase::get_memory_properties() const
+{
+	VkMemoryPropertyFlags memory_properties;
+	vmaGetAllocationMemoryProperties(get_memory_allocator(), allocation, &memory_properties);
+	return memory_properties;
+}
+
 void AllocatedBase::flush(VkDeviceSize offset, VkDeviceSize size)
 {
 	if (!coherent)
@@ -86,6 +492,14 @@ void AllocatedBase::flush(VkDeviceSize offset, VkDeviceSize size)
 	}
 }
 
+void AllocatedBase::invalidate(VkDeviceSize offset, VkDeviceSize size)
+{
+	if (!coherent)
+	{
+		vmaInvalidateAllocation(get_memory_allocator(), allocation, offset, size);
+	}
+}
+
 uint8_t *AllocatedBase::map()
 {
 	if (!persistent && !mapped())
@@ -127,6 +541,15 @@ size_t AllocatedBase::update(void const *data, size_t size, size_t offset)
 	return update(reinterpret_cast<const uint8_t *>(data), size, offset);
 }
 
+bool AllocatedBase::begin_move(VkCommandBuffer command_buffer, VmaAllocation destination)
+{
+	return false;
+}
+
+void AllocatedBase::end_move(std::vector<VkImageView> &old_views, std::vector<VkImageView> &new_views)
+{
+}
+
 void AllocatedBase::post_create(VmaAllocationInfo const &allocation_info)
 {
 	VkMemoryPropertyFlags memory_properties;
@@ -141,6 +564,17 @@ void AllocatedBase::post_create(VmaAllocationInfo const &allocation_info)
 	VkBuffer          handleResult = VK_NULL_HANDLE;
 	VmaAllocationInfo allocation_info{};
 
+	if (alloc_create_info.pUserData == nullptr)
+	{
+		alloc_create_info.pUserData = reinterpret_cast<void *>(static_cast<uintptr_t>(current_memory_tag));
+	}
+
+	pooled = select_memory_pool(
+	    alloc_create_info, [&]() { return create_info.size; },
+	    [&](uint32_t &memory_type_index) {
+		    return vmaFindMemoryTypeIndexForBufferInfo(get_memory_allocator(), &create_info, &alloc_create_info, &memory_type_index);
+	    });
+
 	auto result = vmaCreateBuffer(
 	    get_memory_allocator(),
 	    &create_info,
@@ -153,6 +587,11 @@ void AllocatedBase::post_create(VmaAllocationInfo const &allocation_info)
 	{
 		throw VulkanException{result, "Cannot create Buffer"};
 	}
+	track_allocation(allocation);
+	if (pooled)
+	{
+		register_pooled_resource(allocation, this);
+	}
 	post_create(allocation_info);
 	return handleResult;
 }
@@ -166,19 +605,26 @@ void AllocatedBase::post_create(VmaAllocationInfo const &allocation_info)
 	VkImage           handleResult = VK_NULL_HANDLE;
 	VmaAllocationInfo allocation_info{};
 
-#if 0
-		// If the image is an attachment, prefer dedicated memory
-		constexpr VkImageUsageFlags attachment_only_flags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
-		if (create_info.usage & attachment_only_flags)
-		{
-			alloc_create_info.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-		}
+	// Transient attachments may never be backed by memory on tile based GPUs, if a lazily allocated memory type is available
+	if (create_info.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+	{
+		alloc_create_info.preferredFlags |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+	}
 
-		if (create_info.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
-		{
-			alloc_create_info.preferredFlags |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
-		}
-#endif
+	if (alloc_create_info.pUserData == nullptr)
+	{
+		alloc_create_info.pUserData = reinterpret_cast<void *>(static_cast<uintptr_t>(current_memory_tag));
+	}
+
+	// Lazily allocated memory is never fragmented, as it is not backed until used
+	if (!(create_info.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT))
+	{
+		pooled = select_memory_pool(
+		    alloc_create_info, [&]() { return get_image_memory_size(create_info); },
+		    [&](uint32_t &memory_type_index) {
+			    return vmaFindMemoryTypeIndexForImageInfo(get_memory_allocator(), &create_info, &alloc_create_info, &memory_type_index);
+		    });
+	}
 
 	auto result = vmaCreateImage(
 	    get_memory_allocator(),
@@ -193,6 +639,33 @@ void AllocatedBase::post_create(VmaAllocationInfo const &allocation_info)
 		throw VulkanException{result, "Cannot create Image"};
 	}
 
+	track_allocation(allocation);
+	if (pooled)
+	{
+		register_pooled_resource(allocation, this);
+	}
+	post_create(allocation_info);
+	return handleResult;
+}
+
+[[nodiscard]] VkImage AllocatedBase::create_aliasing_image(VmaAllocation alias_allocation, VkImageCreateInfo const &create_info)
+{
+	assert(alias_allocation != VK_NULL_HANDLE && "Aliasing images need an allocation to alias");
+
+	VkImage handleResult = VK_NULL_HANDLE;
+
+	auto result = vmaCreateAliasingImage(get_memory_allocator(), alias_allocation, &create_info, &handleResult);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot create aliasing Image"};
+	}
+
+	allocation = alias_allocation;
+	aliased    = true;
+
+	VmaAllocationInfo allocation_info{};
+	vmaGetAllocationInfo(get_memory_allocator(), allocation, &allocation_info);
 	post_create(allocation_info);
 	return handleResult;
 }
@@ -202,6 +675,11 @@ void AllocatedBase::destroy_buffer(VkBuffer handle)
 	if (handle != VK_NULL_HANDLE && allocation != VK_NULL_HANDLE)
 	{
 		unmap();
+		untrack_allocation(allocation);
+		if (pooled)
+		{
+			unregister_pooled_resource(allocation);
+		}
 		vmaDestroyBuffer(get_memory_allocator(), handle, allocation);
 		clear();
 	}
@@ -211,8 +689,25 @@ void AllocatedBase::destroy_image(VkImage image)
 {
 	if (image != VK_NULL_HANDLE && allocation != VK_NULL_HANDLE)
 	{
-		unmap();
-		vmaDestroyImage(get_memory_allocator(), image, allocation);
+		if (aliased)
+		{
+			// The allocation outlives the image, only the image is destroyed
+			VmaAllocatorInfo allocator_info{};
+			vmaGetAllocatorInfo(get_memory_allocator(), &allocator_info);
+			vkDestroyImage(allocator_info.device, image, nullptr);
+			allocation = VK_NULL_HANDLE;
+			aliased    = false;
+		}
+		else
+		{
+			unmap();
+			untrack_allocation(allocation);
+			if (pooled)
+			{
+				unregister_pooled_resource(allocation);
+			}
+			vmaDestroyImage(get_memory_allocator(), image, allocation);
+		}
 		clear();
 	}
 }
@@ -226,6 +721,7 @@ void AllocatedBase::clear()
 {
 	mapped_data       = nullptr;
 	persistent        = false;
+	pooled            = false;
 	alloc_create_info = {};
 }
 
@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2021-2026, NVIDIA CORPORATION. All rights reserved.
  * Copyright (c) 2024, Bradley Austin Davis. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -31,6 +31,153 @@ class Device;
 namespace allocated
 {
 
+/**
+ * @brief The subsystem an allocation is attributed to, stored as the VMA user data of the allocation
+ */
+enum class MemoryTag : uint32_t
+{
+	Other,
+	BufferPool,
+	RenderTarget,
+	SceneTexture,
+	SceneGeometry,
+	Staging
+};
+
+constexpr uint32_t MEMORY_TAG_COUNT = static_cast<uint32_t>(MemoryTag::Staging) + 1;
+
+const char *to_string(MemoryTag tag);
+
+/**
+ * @return The memory of the live allocations attributed to a subsystem, in bytes
+ */
+VkDeviceSize get_tagged_memory_usage(MemoryTag tag);
+
+/**
+ * @brief Adds an allocation to the usage of the subsystem of its VMA user data
+ *        Allocations of buffers and images are tracked by AllocatedBase, other allocations of the allocator must be tracked by their owner.
+ */
+void track_allocation(VmaAllocation allocation);
+
+/**
+ * @brief Removes an allocation from the usage of its subsystem, before it is freed
+ */
+void untrack_allocation(VmaAllocation allocation);
+
+/**
+ * @brief How the host reaches the device local memory, detected when the allocator is created
+ */
+enum class MemoryArchitecture
+{
+	/// Device local memory is not host visible, or only through a small window, so uploads to it are staged
+	Discrete,
+
+	/// All of the device local memory is host visible, with Resizable BAR or Smart Access Memory
+	ResizableBar,
+
+	/// The device and the host share the same memory, as on integrated and most mobile GPUs
+	Unified
+};
+
+const char *to_string(MemoryArchitecture architecture);
+
+MemoryArchitecture get_memory_architecture();
+
+/**
+ * @brief How often the host writes the contents of a buffer, which selects its memory, see with_upload_frequency()
+ */
+enum class UploadFrequency
+{
+	/// Written once and then only read by the device, such as the geometry of a scene
+	Static,
+
+	/// Written again every frame, such as uniform data
+	PerFrame
+};
+
+/**
+ * @brief Selects the memory of a buffer written by the host, from the memory architecture
+ *        Per-frame data is written sequentially into device local memory with Resizable BAR and unified memory, and
+ *        into host visible memory otherwise. Static buffers are device local, and are host visible only with unified
+ *        memory: uploads write them in place when they are host visible, and stage them otherwise.
+ */
+void apply_upload_policy(VmaAllocationCreateInfo &alloc_create_info, UploadFrequency frequency);
+
+/**
+ * @return The memory of the live allocations which are both device local and host visible, in bytes
+ */
+VkDeviceSize get_direct_upload_memory_usage();
+
+/**
+ * @brief Suballocation of the device memory of a subsystem from VMA pools of its own, so that resources with different
+ *        lifetimes do not fragment the memory of each other
+ */
+struct MemoryPoolConfig
+{
+	/// Size of the device memory blocks of the pools, 0 if the subsystem allocates from the default pools
+	VkDeviceSize block_size{0};
+
+	/// Resources of at least this size get a dedicated allocation instead, which some drivers prefer for large images
+	VkDeviceSize dedicated_threshold{0};
+};
+
+/**
+ * @return The pool configuration of the allocations attributed to a subsystem
+ *         Render targets, scene geometry and scene textures have pools, in which device local resources are allocated
+ *         unless they are mapped, transient or given a pool or a dedicated allocation by their builder.
+ */
+MemoryPoolConfig get_memory_pool_config(MemoryTag tag);
+
+/**
+ * @return The pools created so far for the allocations of a subsystem, one for each memory type
+ */
+std::vector<VmaPool> get_memory_pools(MemoryTag tag);
+
+/**
+ * @return A counter increased whenever resources move to other memory, which caches of resource handles compare to
+ *         know that they are stale, see MemoryDefragmenter
+ */
+uint64_t get_move_generation();
+
+/**
+ * @brief Increases the move generation, once resources moved
+ */
+void next_move_generation();
+
+class AllocatedBase;
+
+/**
+ * @return The resource owning an allocation from a memory pool, null if there is none
+ */
+AllocatedBase *find_pooled_resource(VmaAllocation allocation);
+
+/**
+ * @return The tag of the allocations of the calling thread which are not given one by their builder
+ */
+MemoryTag get_current_memory_tag();
+
+/**
+ * @brief Tags the allocations of the calling thread during its lifetime, unless their builder gives them a tag
+ */
+class ScopedMemoryTag
+{
+  public:
+	explicit ScopedMemoryTag(MemoryTag tag);
+
+	ScopedMemoryTag(const ScopedMemoryTag &) = delete;
+
+	ScopedMemoryTag(ScopedMemoryTag &&) = delete;
+
+	~ScopedMemoryTag();
+
+	ScopedMemoryTag &operator=(const ScopedMemoryTag &) = delete;
+
+	ScopedMemoryTag &operator=(ScopedMemoryTag &&) = delete;
+
+  private:
+	MemoryTag previous_tag;
+};
+
 template <
     typename BuilderType,
     typename CreateInfoType,
@@ -86,12 +233,24 @@ struct Builder
 		return *static_cast<BuilderType *>(this);
 	}
 
+	BuilderType &with_upload_frequency(UploadFrequency frequency)
+	{
+		apply_upload_policy(alloc_create_info, frequency);
+		return *static_cast<BuilderType *>(this);
+	}
+
 	BuilderType &with_vma_pool(VmaPool pool)
 	{
 		alloc_create_info.pool = pool;
 		return *static_cast<BuilderType *>(this);
 	}
 
+	BuilderType &with_memory_tag(MemoryTag tag)
+	{
+		alloc_create_info.pUserData = reinterpret_cast<void *>(static_cast<uintptr_t>(tag));
+		return *static_cast<BuilderType *>(this);
+	}
+
 	BuilderType &with_queue_families(uint32_t count, const uint32_t *family_indices)
 	{
 		create_info.queueFamilyIndexCount = count;
@@ -191,11 +350,21 @@ class AllocatedBase
 	const uint8_t *get_data() const;
 	VkDeviceMemory get_memory() const;
 
+	/**
+	 * @return The property flags of the memory type the allocation lives in
+	 */
+	VkMemoryPropertyFlags get_memory_properties() const;
+
 	/**
 	 * @brief Flushes memory if it is HOST_VISIBLE and not HOST_COHERENT
 	 */
 	void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
 
+	/**
+	 * @brief Invalidates memory if it is HOST_VISIBLE and not HOST_COHERENT, so that the host reads the device writes
+	 */
+	void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
 	/**
 	 * @brief Returns true if the memory is mapped, false otherwise
 	 * @return mapping status
@@ -257,10 +426,31 @@ class AllocatedBase
 		return update(reinterpret_cast<const uint8_t *>(&object), sizeof(T), offset);
 	}
 
+	/**
+	 * @brief Starts moving the resource to the memory of a defragmentation move: creates its copy bound to the memory,
+	 *        and records the copy of its contents, see MemoryDefragmenter
+	 * @param command_buffer The command buffer recording the copies of the moves
+	 * @param destination The temporary allocation of the move
+	 * @return Whether the resource moves, the resources which cannot keep their memory
+	 */
+	virtual bool begin_move(VkCommandBuffer command_buffer, VmaAllocation destination);
+
+	/**
+	 * @brief Replaces the resource with its copy once the copy completed, and recreates the views referring to it
+	 * @param old_views Appended the handles of the replaced views, which the caller destroys
+	 * @param new_views Appended the handles replacing them
+	 */
+	virtual void end_move(std::vector<VkImageView> &old_views, std::vector<VkImageView> &new_views);
+
   protected:
 	virtual void           post_create(VmaAllocationInfo const &allocation_info);
 	[[nodiscard]] VkBuffer create_buffer(VkBufferCreateInfo const &create_info);
 	[[nodiscard]] VkImage  create_image(VkImageCreateInfo const &create_info);
+
+	/**
+	 * @brief Creates an image bound to the memory of an allocation owned by someone else, which is not freed with the image
+	 */
+	[[nodiscard]] VkImage create_aliasing_image(VmaAllocation alias_allocation, VkImageCreateInfo const &create_info);
 	void                   destroy_buffer(VkBuffer buffer);
 	void                   destroy_image(VkImage image);
 	void                   clear();
@@ -270,6 +460,8 @@ class AllocatedBase
 	uint8_t                *mapped_data = nullptr;
 	bool                    coherent    = false;
 	bool                    persistent  = false;        // Whether the buffer is persistently mapped or not
+	bool                    aliased     = false;        // Whether the allocation is shared with other resources, and owned by someone else
+	bool                    pooled      = false;        // Whether the allocation is from the memory pool of its subsystem, see get_memory_pool_config()
 };
 
 template <
@@ -39,6 +39,7 @@ Buffer Buffer::create_staging_buffer(Device &device, VkDeviceSize size, const vo
 	BufferBuilder builder{size};
 	builder.with_vma_flags(VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
 	builder.with_usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+	builder.with_memory_tag(allocated::MemoryTag::Staging);
 	Buffer result(device, builder);
 	if (data != nullptr)
 	{
@@ -65,7 +66,15 @@ Buffer::Buffer(vkb::Device                 &device,
 Buffer::Buffer(Device &device, const BufferBuilder &builder) :
     Allocated{builder.alloc_create_info, VK_NULL_HANDLE, &device}, size(builder.create_info.size)
 {
-	set_handle(create_buffer(builder.create_info));
+	VkBufferCreateInfo create_info = builder.create_info;
+
+	// Descriptor buffers reference uniform and storage buffers by address
+	if (device.uses_descriptor_buffers() && (create_info.usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)))
+	{
+		create_info.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+	}
+
+	set_handle(create_buffer(create_info));
 	if (!builder.debug_name.empty())
 	{
 		set_debug_name(builder.debug_name);
@@ -74,7 +83,8 @@ Buffer::Buffer(Device &device, const BufferBuilder &builder) :
 
 Buffer::Buffer(Buffer &&other) noexcept :
     Allocated{std::move(other)},
-    size{std::exchange(other.size, {})}
+    size{std::exchange(other.size, {})},
+    state{std::exchange(other.state, {})}
 {
 }
 
@@ -88,7 +98,7 @@ VkDeviceSize Buffer::get_size() const
 	return size;
 }
 
-uint64_t Buffer::get_device_address()
+uint64_t Buffer::get_device_address() const
 {
 	VkBufferDeviceAddressInfoKHR buffer_device_address_info{};
 	buffer_device_address_info.sType  = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
@@ -96,5 +106,15 @@ uint64_t Buffer::get_device_address()
 	return vkGetBufferDeviceAddressKHR(get_device().get_handle(), &buffer_device_address_info);
 }
 
+const BufferState &Buffer::get_state() const
+{
+	return state;
+}
+
+void Buffer::set_state(const BufferState &state) const
+{
+	this->state = state;
+}
+
 }        // namespace core
 }        // namespace vkb
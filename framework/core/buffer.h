@@ -70,6 +70,17 @@ struct BufferBuilder : public allocated::Builder<BufferBuilder, VkBufferCreateIn
 	BufferPtr build_unique(Device &device) const;
 };
 
+/**
+ * @brief The last known use of a buffer by the GPU, in command recording order
+ */
+struct BufferState
+{
+	/// Stages which accessed the buffer since its last write
+	VkPipelineStageFlags stage_mask{0};
+
+	VkAccessFlags access_mask{0};
+};
+
 class Buffer : public allocated::Allocated<VkBuffer>
 {
   public:
@@ -153,10 +164,23 @@ class Buffer : public allocated::Allocated<VkBuffer>
 	/**
 	 * @return Return the buffer's device address (note: requires that the buffer has been created with the VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT usage fla)
 	 */
-	uint64_t get_device_address();
+	uint64_t get_device_address() const;
+
+	/**
+	 * @brief Returns the tracked state of the whole buffer, see CommandBuffer::buffer_transition()
+	 */
+	const BufferState &get_state() const;
+
+	/**
+	 * @brief Sets the tracked state of the buffer, CommandBuffer does so for every barrier it records on the buffer
+	 *        The state is bookkeeping of the commands recorded so far, which is why it can be set on a const buffer.
+	 */
+	void set_state(const BufferState &state) const;
 
   private:
 	VkDeviceSize size{0};
+
+	mutable BufferState state;
 };
 }        // namespace core
 }        // namespace vkb
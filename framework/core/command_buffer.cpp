@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -19,7 +19,9 @@
 
 #include "command_pool.h"
 #include "common/error.h"
+#include "common/helpers.h"
 #include "device.h"
+#include "rendering/gpu_profiler.h"
 #include "rendering/render_frame.h"
 #include "rendering/subpass.h"
 
@@ -27,6 +29,73 @@
 
 namespace vkb
 {
+namespace
+{
+constexpr VkAccessFlags WRITE_ACCESS_MASK = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT |
+                                            VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+/**
+ * @brief Returns the subresource range of an image view, with the aspects a barrier on a depth image needs
+ */
+VkImageSubresourceRange get_barrier_subresource_range(const core::ImageView &image_view)
+{
+	auto subresource_range = image_view.get_subresource_range();
+	auto format            = image_view.get_format();
+	if (is_depth_only_format(format))
+	{
+		subresource_range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	}
+	else if (is_depth_stencil_format(format))
+	{
+		subresource_range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+	}
+
+	return subresource_range;
+}
+
+/**
+ * @brief Tracks that an attachment is written by a render pass, and left in a layout
+ */
+void set_attachment_state(const core::ImageView &image_view, VkImageLayout layout)
+{
+	core::ImageSubresourceState state{layout};
+	if (is_depth_format(image_view.get_format()))
+	{
+		state.stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		state.access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	}
+	else
+	{
+		state.stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		state.access_mask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	}
+
+	image_view.get_image().set_subresource_state(image_view.get_subresource_range(), state);
+}
+
+/**
+ * @brief Whether accesses in the state are all synchronized with the requested ones, so no barrier is needed between them
+ */
+bool is_state_synchronized(VkPipelineStageFlags stage_mask, VkAccessFlags access_mask, VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask)
+{
+	// Reads after reads are only skipped if the earlier reads were already made to wait for the last write on these stages
+	return ((access_mask | dst_access_mask) & WRITE_ACCESS_MASK) == 0 &&
+	       (dst_stage_mask & ~stage_mask) == 0 &&
+	       (dst_access_mask & ~access_mask) == 0;
+}
+
+/**
+ * @brief Whether a barrier moves a resource to another queue family, and so has to be recorded on both families
+ */
+bool is_ownership_transfer(uint32_t old_queue_family, uint32_t new_queue_family)
+{
+	return old_queue_family != new_queue_family && old_queue_family != VK_QUEUE_FAMILY_IGNORED && new_queue_family != VK_QUEUE_FAMILY_IGNORED;
+}
+}        // namespace
+
+std::atomic<uint32_t> CommandBuffer::skipped_pipeline_bind_count{0};
+
 CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level) :
     VulkanResource{VK_NULL_HANDLE, &command_pool.get_device()},
     command_pool{command_pool},
@@ -45,6 +114,8 @@ CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel lev
 	{
 		throw VulkanException{result, "Failed to allocate command buffer"};
 	}
+
+	pipeline_state.set_dynamic_state_flags(get_device().get_dynamic_pipeline_state_flags());
 }
 
 CommandBuffer::~CommandBuffer()
@@ -65,7 +136,19 @@ CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
     update_after_bind(std::exchange(other.update_after_bind, {})),
-    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {}))
+    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {})),
+    bound_descriptor_buffer(std::exchange(other.bound_descriptor_buffer, {})),
+    bound_graphics_pipeline(std::exchange(other.bound_graphics_pipeline, {})),
+    bound_compute_pipeline(std::exchange(other.bound_compute_pipeline, {})),
+    immediate_mode(std::exchange(other.immediate_mode, {})),
+    shader_object_pass(std::exchange(other.shader_object_pass, {})),
+    rendering_subpasses(std::exchange(other.rendering_subpasses, {})),
+    subpass_rendering_states(std::exchange(other.subpass_rendering_states, {})),
+    barrier_batch_open(std::exchange(other.barrier_batch_open, {})),
+    pending_image_barriers(std::exchange(other.pending_image_barriers, {})),
+    pending_buffer_barriers(std::exchange(other.pending_buffer_barriers, {})),
+    fragment_shading_rate(std::exchange(other.fragment_shading_rate, {1, 1})),
+    scratch_arena(std::move(other.scratch_arena))
 {}
 
 void CommandBuffer::clear(VkClearAttachment attachment, VkClearRect rect)
@@ -92,7 +175,25 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	pipeline_state.reset();
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
+	bound_descriptor_buffer = VK_NULL_HANDLE;
+	bound_graphics_pipeline = VK_NULL_HANDLE;
+	bound_compute_pipeline  = VK_NULL_HANDLE;
+	immediate_mode          = false;
+	shader_object_pass      = false;
+	barrier_batch_open      = false;
 	stored_push_constants.clear();
+	rendering_subpasses.clear();
+	subpass_rendering_states.clear();
+	pending_image_barriers.clear();
+	pending_buffer_barriers.clear();
+	scratch_arena.reset();
+
+	// The command buffers of a frame captured for replay are submitted more than once
+	auto render_frame = command_pool.get_render_frame();
+	if (render_frame && render_frame->is_replayable())
+	{
+		flags &= ~VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	}
 
 	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
@@ -100,45 +201,122 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 
 	if (level == VK_COMMAND_BUFFER_LEVEL_SECONDARY)
 	{
-		assert((render_pass && framebuffer) && "Render pass and framebuffer must be provided when calling begin from a secondary one");
+		assert(render_pass && "A render pass must be provided when calling begin from a secondary one");
 
 		current_render_pass.render_pass = render_pass;
 		current_render_pass.framebuffer = framebuffer;
 
 		inheritance.renderPass  = current_render_pass.render_pass->get_handle();
-		inheritance.framebuffer = current_render_pass.framebuffer->get_handle();
+		inheritance.framebuffer = current_render_pass.framebuffer ? current_render_pass.framebuffer->get_handle() : VK_NULL_HANDLE;
 		inheritance.subpass     = subpass_index;
 
+		// The secondary command buffers may be executed within a scope counting pipeline statistics
+		if (auto *profiler = get_device().get_gpu_profiler())
+		{
+			inheritance.pipelineStatistics = profiler->get_pipeline_statistics();
+		}
+
 		begin_info.pInheritanceInfo = &inheritance;
+
+		// Match the pipeline state to the subpass being continued
+		pipeline_state.set_subpass_index(subpass_index);
+
+		auto blend_state = pipeline_state.get_color_blend_state();
+		blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(subpass_index));
+		pipeline_state.set_color_blend_state(blend_state);
+	}
+
+	VkResult result = vkBeginCommandBuffer(get_handle(), &begin_info);
+
+	// The pipelines set the shading rate dynamically, which command buffers do not inherit
+	if (result == VK_SUCCESS)
+	{
+		set_fragment_shading_rate({1, 1});
 	}
 
-	return vkBeginCommandBuffer(get_handle(), &begin_info);
+	return result;
+}
+
+VkResult CommandBuffer::continue_render_pass(CommandBuffer &primary_cmd_buf, VkCommandBufferUsageFlags flags)
+{
+	assert(level == VK_COMMAND_BUFFER_LEVEL_SECONDARY && "Only a secondary command buffer can continue a render pass");
+
+	VkResult result = begin(flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &primary_cmd_buf);
+	if (result != VK_SUCCESS)
+	{
+		return result;
+	}
+
+	resource_binding_state = primary_cmd_buf.resource_binding_state;
+	stored_push_constants  = primary_cmd_buf.stored_push_constants;
+
+	set_fragment_shading_rate(primary_cmd_buf.fragment_shading_rate);
+
+	current_render_pass.render_area = primary_cmd_buf.current_render_pass.render_area;
+
+	const auto &extent = current_render_pass.render_area;
+
+	VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+	set_viewport(0, {viewport});
+
+	VkRect2D scissor{{0, 0}, extent};
+	set_scissor(0, {scissor});
+
+	return VK_SUCCESS;
 }
 
 VkResult CommandBuffer::end()
 {
+	flush_barriers();
+
 	vkEndCommandBuffer(get_handle());
 
 	return VK_SUCCESS;
 }
 
-void CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
+bool CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
 {
-	flush_pipeline_state(pipeline_bind_point);
+	// The pipeline and descriptor sets were bound by the caller
+	if (immediate_mode)
+	{
+		return true;
+	}
+
+	if (!flush_pipeline_state(pipeline_bind_point))
+	{
+		return false;
+	}
 
 	flush_push_constants();
 
 	flush_descriptor_state(pipeline_bind_point);
+
+	return true;
 }
 
 void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values, const std::vector<std::unique_ptr<Subpass>> &subpasses, VkSubpassContents contents)
 {
+	record_pending_barriers();
+
 	// Reset state
 	pipeline_state.reset();
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
 
+	// Subpass inputs are only read within dynamic rendering with local reads, secondary command buffers continue render passes
+	bool has_input_attachments = std::any_of(subpasses.begin(), subpasses.end(), [](const std::unique_ptr<Subpass> &subpass) {
+		return !subpass->get_input_attachments().empty();
+	});
+
+	if (get_device().uses_dynamic_rendering() && contents == VK_SUBPASS_CONTENTS_INLINE &&
+	    ((subpasses.size() == 1 && !has_input_attachments) || get_device().uses_dynamic_rendering_local_read()))
+	{
+		begin_rendering(render_target, load_store_infos, clear_values, subpasses);
+		return;
+	}
+
 	auto &render_pass = get_render_pass(render_target, load_store_infos, subpasses);
+
 	auto &framebuffer = get_device().get_resource_cache().request_framebuffer(render_target, render_pass);
 
 	begin_render_pass(render_target, render_pass, framebuffer, clear_values, contents);
@@ -146,14 +324,25 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const s
 
 void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const RenderPass &render_pass, const Framebuffer &framebuffer, const std::vector<VkClearValue> &clear_values, VkSubpassContents contents)
 {
+	record_pending_barriers();
+
+	// The render pass leaves every attachment in its final layout
+	const auto &views         = render_target.get_views();
+	const auto &final_layouts = render_pass.get_final_layouts();
+	for (size_t i = 0; i < views.size() && i < final_layouts.size(); i++)
+	{
+		set_attachment_state(views[i], final_layouts[i]);
+	}
+
 	current_render_pass.render_pass = &render_pass;
 	current_render_pass.framebuffer = &framebuffer;
+	current_render_pass.render_area = render_target.get_render_extent();
 
 	// Begin render pass
 	VkRenderPassBeginInfo begin_info{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
 	begin_info.renderPass        = current_render_pass.render_pass->get_handle();
 	begin_info.framebuffer       = current_render_pass.framebuffer->get_handle();
-	begin_info.renderArea.extent = render_target.get_extent();
+	begin_info.renderArea.extent = current_render_pass.render_area;
 	begin_info.clearValueCount   = to_u32(clear_values.size());
 	begin_info.pClearValues      = clear_values.data();
 
@@ -181,199 +370,681 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const R
 	pipeline_state.set_color_blend_state(blend_state);
 }
 
-void CommandBuffer::next_subpass()
+void CommandBuffer::begin_rendering(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos,
+                                    const std::vector<VkClearValue> &clear_values, const std::vector<std::unique_ptr<Subpass>> &subpasses)
 {
-	// Increment subpass index
-	pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
+	current_render_pass.render_pass = nullptr;
+	current_render_pass.framebuffer = nullptr;
+	current_render_pass.render_area = render_target.get_render_extent();
 
-	// Update blend state attachments
-	auto blend_state = pipeline_state.get_color_blend_state();
-	blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(pipeline_state.get_subpass_index()));
-	pipeline_state.set_color_blend_state(blend_state);
+	bound_graphics_pipeline = VK_NULL_HANDLE;
 
-	// Reset descriptor sets
-	resource_binding_state.reset();
-	descriptor_set_layout_binding_state.clear();
+	auto &views       = render_target.get_views();
+	auto &attachments = render_target.get_attachments();
 
-	// Clear stored push constants
-	stored_push_constants.clear();
+	// Subpasses beyond the first one, and input attachments, are recorded by reading the attachments locally
+	bool local_read = subpasses.size() > 1 || !subpasses[0]->get_input_attachments().empty();
 
-	vkCmdNextSubpass(get_handle(), VK_SUBPASS_CONTENTS_INLINE);
-}
+	// Shader objects have no attachment locations and input indices
+	shader_object_pass = get_device().uses_shader_objects() && !local_read;
 
-void CommandBuffer::execute_commands(CommandBuffer &secondary_command_buffer)
-{
-	vkCmdExecuteCommands(get_handle(), 1, &secondary_command_buffer.get_handle());
-}
+	auto is_input_attachment = [&subpasses](uint32_t attachment) {
+		return std::any_of(subpasses.begin(), subpasses.end(), [attachment](const std::unique_ptr<Subpass> &subpass) {
+			auto &input_attachments = subpass->get_input_attachments();
+			return std::find(input_attachments.begin(), input_attachments.end(), attachment) != input_attachments.end();
+		});
+	};
 
-void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_command_buffers)
-{
-	std::vector<VkCommandBuffer> sec_cmd_buf_handles(secondary_command_buffers.size(), VK_NULL_HANDLE);
-	std::transform(secondary_command_buffers.begin(), secondary_command_buffers.end(), sec_cmd_buf_handles.begin(),
-	               [](const vkb::CommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
-	vkCmdExecuteCommands(get_handle(), to_u32(sec_cmd_buf_handles.size()), sec_cmd_buf_handles.data());
-}
+	// Without local reads the color attachments are the outputs of the subpass, in their order,
+	// otherwise they are all attachments written or read by a subpass, mapped to the outputs of each subpass by locations
+	auto &arena = get_arena();
 
-void CommandBuffer::end_render_pass()
-{
-	vkCmdEndRenderPass(get_handle());
-}
+	ArenaVector<uint32_t> color_attachment_indices{arena};
+	color_attachment_indices.reserve(attachments.size());
 
-void CommandBuffer::bind_pipeline_layout(PipelineLayout &pipeline_layout)
-{
-	pipeline_state.set_pipeline_layout(pipeline_layout);
-}
+	if (local_read)
+	{
+		ArenaVector<uint8_t> used(attachments.size(), 0, arena);
+		for (auto &subpass : subpasses)
+		{
+			for (auto attachment : subpass->get_output_attachments())
+			{
+				used[attachment] = 1;
+			}
 
-void CommandBuffer::set_specialization_constant(uint32_t constant_id, const std::vector<uint8_t> &data)
-{
-	pipeline_state.set_specialization_constant(constant_id, data);
-}
+			for (auto attachment : subpass->get_input_attachments())
+			{
+				used[attachment] = 1;
+			}
+		}
 
-void CommandBuffer::push_constants(const std::vector<uint8_t> &values)
-{
-	uint32_t push_constant_size = to_u32(stored_push_constants.size() + values.size());
+		for (auto &subpass : subpasses)
+		{
+			for (auto attachment : subpass->get_color_resolve_attachments())
+			{
+				used[attachment] = 0;
+			}
+		}
 
-	if (push_constant_size > max_push_constants_size)
-	{
-		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, values.size(), push_constant_size);
-		throw std::runtime_error("Push constant limit exceeded.");
+		for (uint32_t i = 0; i < to_u32(attachments.size()); ++i)
+		{
+			if (used[i] && !is_depth_format(attachments[i].format))
+			{
+				color_attachment_indices.push_back(i);
+			}
+		}
 	}
 	else
 	{
-		stored_push_constants.insert(stored_push_constants.end(), values.begin(), values.end());
+		for (auto output_attachment : subpasses[0]->get_output_attachments())
+		{
+			if (!is_depth_format(attachments[output_attachment].format))
+			{
+				color_attachment_indices.push_back(output_attachment);
+			}
+		}
 	}
-}
 
-void CommandBuffer::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
-{
-	resource_binding_state.bind_buffer(buffer, offset, range, set, binding, array_element);
-}
+	uint32_t depth_index = VK_ATTACHMENT_UNUSED;
 
-void CommandBuffer::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element)
-{
-	resource_binding_state.bind_image(image_view, sampler, set, binding, array_element);
-}
+	bool depth_enabled = std::any_of(subpasses.begin(), subpasses.end(), [](const std::unique_ptr<Subpass> &subpass) {
+		return !subpass->get_disable_depth_stencil_attachment();
+	});
 
-void CommandBuffer::bind_image(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
-{
-	resource_binding_state.bind_image(image_view, set, binding, array_element);
-}
+	if (depth_enabled)
+	{
+		auto it = std::find_if(attachments.begin(), attachments.end(), [](const Attachment &attachment) { return is_depth_format(attachment.format); });
 
-void CommandBuffer::bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
-{
-	resource_binding_state.bind_input(image_view, set, binding, array_element);
-}
+		if (it != attachments.end())
+		{
+			depth_index = to_u32(std::distance(attachments.begin(), it));
+		}
+	}
 
-void CommandBuffer::bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::Buffer>> &buffers, const std::vector<VkDeviceSize> &offsets)
-{
-	std::vector<VkBuffer> buffer_handles(buffers.size(), VK_NULL_HANDLE);
-	std::transform(buffers.begin(), buffers.end(), buffer_handles.begin(),
-	               [](const core::Buffer &buffer) { return buffer.get_handle(); });
-	vkCmdBindVertexBuffers(get_handle(), first_binding, to_u32(buffer_handles.size()), buffer_handles.data(), offsets.data());
-}
+	// Same layouts as the render pass would use, attachments read by later subpasses stay in the local read layout
+	auto get_layout = [&](uint32_t attachment, VkImageLayout default_layout) {
+		if (local_read && is_input_attachment(attachment))
+		{
+			return VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR;
+		}
 
-void CommandBuffer::bind_index_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type)
-{
-	vkCmdBindIndexBuffer(get_handle(), buffer.get_handle(), offset, index_type);
-}
+		return attachments[attachment].initial_layout == VK_IMAGE_LAYOUT_UNDEFINED ? default_layout : attachments[attachment].initial_layout;
+	};
 
-void CommandBuffer::bind_lighting(LightingState &lighting_state, uint32_t set, uint32_t binding)
-{
-	bind_buffer(lighting_state.light_buffer.get_buffer(), lighting_state.light_buffer.get_offset(), lighting_state.light_buffer.get_size(), set, binding, 0);
+	// Dynamic rendering has no implicit layout transitions, the attachments are transitioned before it begins and stay in their layout
+	auto transition_attachment = [&](uint32_t attachment, VkImageLayout layout) {
+		VkPipelineStageFlags stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		VkAccessFlags        access_mask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
-	set_specialization_constant(0, to_u32(lighting_state.directional_lights.size()));
-	set_specialization_constant(1, to_u32(lighting_state.point_lights.size()));
-	set_specialization_constant(2, to_u32(lighting_state.spot_lights.size()));
-}
+		if (is_depth_format(attachments[attachment].format))
+		{
+			stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		}
 
-void CommandBuffer::set_viewport_state(const ViewportState &state_info)
-{
-	pipeline_state.set_viewport_state(state_info);
-}
+		if (layout == VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR)
+		{
+			stage_mask |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			access_mask |= VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+		}
 
-void CommandBuffer::set_vertex_input_state(const VertexInputState &state_info)
-{
-	pipeline_state.set_vertex_input_state(state_info);
-}
+		image_transition(views[attachment], layout, stage_mask, access_mask);
+		set_attachment_state(views[attachment], layout);
+	};
 
-void CommandBuffer::set_input_assembly_state(const InputAssemblyState &state_info)
-{
-	pipeline_state.set_input_assembly_state(state_info);
-}
+	// Same load operations as the render pass would use, see RenderPass
+	auto get_attachment_info = [&](uint32_t attachment, VkImageLayout layout) {
+		VkRenderingAttachmentInfoKHR attachment_info{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR};
+		attachment_info.imageView   = views[attachment].get_handle();
+		attachment_info.imageLayout = layout;
+		attachment_info.loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		attachment_info.storeOp     = VK_ATTACHMENT_STORE_OP_STORE;
 
-void CommandBuffer::set_rasterization_state(const RasterizationState &state_info)
-{
-	pipeline_state.set_rasterization_state(state_info);
-}
+		transition_attachment(attachment, layout);
 
-void CommandBuffer::set_multisample_state(const MultisampleState &state_info)
-{
-	pipeline_state.set_multisample_state(state_info);
-}
+		if (attachment < load_store_infos.size())
+		{
+			attachment_info.loadOp  = load_store_infos[attachment].load_op;
+			attachment_info.storeOp = load_store_infos[attachment].store_op;
+		}
 
-void CommandBuffer::set_depth_stencil_state(const DepthStencilState &state_info)
-{
-	pipeline_state.set_depth_stencil_state(state_info);
-}
+		if (attachment < clear_values.size())
+		{
+			attachment_info.clearValue = clear_values[attachment];
+		}
 
-void CommandBuffer::set_color_blend_state(const ColorBlendState &state_info)
-{
-	pipeline_state.set_color_blend_state(state_info);
-}
+		return attachment_info;
+	};
 
-void CommandBuffer::set_viewport(uint32_t first_viewport, const std::vector<VkViewport> &viewports)
-{
-	vkCmdSetViewport(get_handle(), first_viewport, to_u32(viewports.size()), viewports.data());
-}
+	ArenaVector<VkRenderingAttachmentInfoKHR> color_attachments{arena};
+	color_attachments.reserve(color_attachment_indices.size());
 
-void CommandBuffer::set_scissor(uint32_t first_scissor, const std::vector<VkRect2D> &scissors)
-{
-	vkCmdSetScissor(get_handle(), first_scissor, to_u32(scissors.size()), scissors.data());
-}
+	for (auto color_attachment : color_attachment_indices)
+	{
+		color_attachments.push_back(get_attachment_info(color_attachment, get_layout(color_attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)));
+	}
 
-void CommandBuffer::set_line_width(float line_width)
-{
-	vkCmdSetLineWidth(get_handle(), line_width);
-}
+	// A resolve attachment of a subpass resolves the attachment of its color output of the same index
+	for (auto &subpass : subpasses)
+	{
+		auto &color_resolve_attachments = subpass->get_color_resolve_attachments();
 
-void CommandBuffer::set_depth_bias(float depth_bias_constant_factor, float depth_bias_clamp, float depth_bias_slope_factor)
-{
-	vkCmdSetDepthBias(get_handle(), depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor);
-}
+		ArenaVector<uint32_t> color_outputs{arena};
+		for (auto output_attachment : subpass->get_output_attachments())
+		{
+			if (!is_depth_format(attachments[output_attachment].format))
+			{
+				color_outputs.push_back(output_attachment);
+			}
+		}
 
-void CommandBuffer::set_blend_constants(const std::array<float, 4> &blend_constants)
-{
-	vkCmdSetBlendConstants(get_handle(), blend_constants.data());
-}
+		for (size_t i = 0; i < color_resolve_attachments.size() && i < color_outputs.size(); ++i)
+		{
+			auto it = std::find(color_attachment_indices.begin(), color_attachment_indices.end(), color_outputs[i]);
+			if (it == color_attachment_indices.end())
+			{
+				continue;
+			}
 
-void CommandBuffer::set_depth_bounds(float min_depth_bounds, float max_depth_bounds)
-{
-	vkCmdSetDepthBounds(get_handle(), min_depth_bounds, max_depth_bounds);
-}
+			auto  resolve_attachment = color_resolve_attachments[i];
+			auto  resolve_layout     = get_layout(resolve_attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+			auto &attachment_info    = color_attachments[std::distance(color_attachment_indices.begin(), it)];
 
-void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
-{
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+			attachment_info.resolveMode        = VK_RESOLVE_MODE_AVERAGE_BIT;
+			attachment_info.resolveImageView   = views[resolve_attachment].get_handle();
+			attachment_info.resolveImageLayout = resolve_layout;
+
+			transition_attachment(resolve_attachment, resolve_layout);
+		}
+	}
+
+	VkRenderingInfoKHR rendering_info{VK_STRUCTURE_TYPE_RENDERING_INFO_KHR};
+	rendering_info.renderArea.extent    = current_render_pass.render_area;
+	rendering_info.layerCount           = 1;
+	rendering_info.colorAttachmentCount = to_u32(color_attachments.size());
+	rendering_info.pColorAttachments    = color_attachments.data();
+
+	VkRenderingAttachmentInfoKHR depth_attachment{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR};
+
+	if (depth_index != VK_ATTACHMENT_UNUSED)
+	{
+		depth_attachment = get_attachment_info(depth_index, get_layout(depth_index, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL));
+
+		for (auto &subpass : subpasses)
+		{
+			if (subpass->get_depth_stencil_resolve_mode() != VK_RESOLVE_MODE_NONE)
+			{
+				auto resolve_attachment             = subpass->get_depth_stencil_resolve_attachment();
+				depth_attachment.resolveMode        = subpass->get_depth_stencil_resolve_mode();
+				depth_attachment.resolveImageView   = views[resolve_attachment].get_handle();
+				depth_attachment.resolveImageLayout = get_layout(resolve_attachment, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+				transition_attachment(resolve_attachment, depth_attachment.resolveImageLayout);
+			}
+		}
+
+		rendering_info.pDepthAttachment = &depth_attachment;
+
+		if (is_depth_stencil_format(attachments[depth_index].format))
+		{
+			rendering_info.pStencilAttachment = &depth_attachment;
+		}
+	}
+
+	// The pipelines of each subpass are created for the attachments of the rendering
+	subpass_rendering_states.clear();
+	rendering_subpasses.clear();
+
+	for (auto &subpass : subpasses)
+	{
+		RenderingState rendering_state;
+
+		for (auto color_attachment : color_attachment_indices)
+		{
+			rendering_state.color_attachment_formats.push_back(attachments[color_attachment].format);
+		}
+
+		if (depth_index != VK_ATTACHMENT_UNUSED)
+		{
+			rendering_state.depth_attachment_format = attachments[depth_index].format;
+
+			if (is_depth_stencil_format(attachments[depth_index].format))
+			{
+				rendering_state.stencil_attachment_format = attachments[depth_index].format;
+			}
+		}
+
+		if (local_read)
+		{
+			// Fragment outputs and input attachment indices are numbered as in the subpass
+			auto &output_attachments = subpass->get_output_attachments();
+			auto &input_attachments  = subpass->get_input_attachments();
+
+			auto get_index = [](const std::vector<uint32_t> &subpass_attachments, uint32_t attachment) {
+				auto it = std::find(subpass_attachments.begin(), subpass_attachments.end(), attachment);
+				return it == subpass_attachments.end() ? VK_ATTACHMENT_UNUSED : to_u32(std::distance(subpass_attachments.begin(), it));
+			};
+
+			std::vector<uint32_t> color_outputs;
+			for (auto output_attachment : output_attachments)
+			{
+				if (!is_depth_format(attachments[output_attachment].format))
+				{
+					color_outputs.push_back(output_attachment);
+				}
+			}
+
+			for (auto color_attachment : color_attachment_indices)
+			{
+				rendering_state.color_attachment_locations.push_back(get_index(color_outputs, color_attachment));
+				rendering_state.color_attachment_input_indices.push_back(get_index(input_attachments, color_attachment));
+			}
+
+			if (depth_index != VK_ATTACHMENT_UNUSED)
+			{
+				rendering_state.depth_stencil_input_index = get_index(input_attachments, depth_index);
+			}
+		}
+
+		subpass_rendering_states.push_back(std::move(rendering_state));
+		rendering_subpasses.push_back(subpass.get());
+	}
+
+	record_pending_barriers();
+
+	vkCmdBeginRenderingKHR(get_handle(), &rendering_info);
+
+	set_rendering_subpass(0);
+}
+
+void CommandBuffer::set_rendering_subpass(uint32_t subpass_index)
+{
+	auto &rendering_state = subpass_rendering_states[subpass_index];
+
+	pipeline_state.set_rendering_state(rendering_state);
+
+	auto blend_state = pipeline_state.get_color_blend_state();
+	blend_state.attachments.resize(rendering_state.color_attachment_formats.size());
+	pipeline_state.set_color_blend_state(blend_state);
+
+	// The depth attachment is only left out of the subpasses of a render pass, here the subpass stops testing and writing it
+	if (rendering_subpasses[subpass_index]->get_disable_depth_stencil_attachment() && rendering_state.depth_attachment_format != VK_FORMAT_UNDEFINED)
+	{
+		DepthStencilState depth_stencil_state{};
+		depth_stencil_state.depth_test_enable   = VK_FALSE;
+		depth_stencil_state.depth_write_enable  = VK_FALSE;
+		depth_stencil_state.stencil_test_enable = VK_FALSE;
+		pipeline_state.set_depth_stencil_state(depth_stencil_state);
+	}
+
+	if (rendering_state.color_attachment_locations.empty())
+	{
+		return;
+	}
+
+	VkRenderingAttachmentLocationInfoKHR location_info{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_LOCATION_INFO_KHR};
+	location_info.colorAttachmentCount      = to_u32(rendering_state.color_attachment_locations.size());
+	location_info.pColorAttachmentLocations = rendering_state.color_attachment_locations.data();
+
+	vkCmdSetRenderingAttachmentLocationsKHR(get_handle(), &location_info);
+
+	VkRenderingInputAttachmentIndexInfoKHR input_index_info{VK_STRUCTURE_TYPE_RENDERING_INPUT_ATTACHMENT_INDEX_INFO_KHR};
+	input_index_info.colorAttachmentCount         = to_u32(rendering_state.color_attachment_input_indices.size());
+	input_index_info.pColorAttachmentInputIndices = rendering_state.color_attachment_input_indices.data();
+	input_index_info.pDepthInputAttachmentIndex   = &rendering_state.depth_stencil_input_index;
+	input_index_info.pStencilInputAttachmentIndex = &rendering_state.depth_stencil_input_index;
+
+	vkCmdSetRenderingInputAttachmentIndicesKHR(get_handle(), &input_index_info);
+}
+
+void CommandBuffer::next_subpass(VkSubpassContents contents)
+{
+	// Increment subpass index
+	pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
+
+	// Reset descriptor sets
+	resource_binding_state.reset();
+	descriptor_set_layout_binding_state.clear();
+
+	// Clear stored push constants
+	stored_push_constants.clear();
+
+	if (!rendering_subpasses.empty())
+	{
+		// The next subpass reads the attachments written so far as input attachments, in the same pixel
+		VkMemoryBarrier memory_barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+		memory_barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		memory_barrier.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+
+		vkCmdPipelineBarrier(get_handle(),
+		                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+		                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_DEPENDENCY_BY_REGION_BIT, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+
+		set_rendering_subpass(pipeline_state.get_subpass_index());
+		return;
+	}
+
+	// Update blend state attachments
+	auto blend_state = pipeline_state.get_color_blend_state();
+	blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(pipeline_state.get_subpass_index()));
+	pipeline_state.set_color_blend_state(blend_state);
+
+	vkCmdNextSubpass(get_handle(), contents);
+}
+
+void CommandBuffer::execute_commands(CommandBuffer &secondary_command_buffer)
+{
+	vkCmdExecuteCommands(get_handle(), 1, &secondary_command_buffer.get_handle());
+
+	// The pipeline bindings of the primary command buffer are undefined after executing secondary ones
+	bound_graphics_pipeline = VK_NULL_HANDLE;
+	bound_compute_pipeline  = VK_NULL_HANDLE;
+}
+
+void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_command_buffers)
+{
+	std::vector<VkCommandBuffer> sec_cmd_buf_handles(secondary_command_buffers.size(), VK_NULL_HANDLE);
+	std::transform(secondary_command_buffers.begin(), secondary_command_buffers.end(), sec_cmd_buf_handles.begin(),
+	               [](const vkb::CommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
+	vkCmdExecuteCommands(get_handle(), to_u32(sec_cmd_buf_handles.size()), sec_cmd_buf_handles.data());
+
+	bound_graphics_pipeline = VK_NULL_HANDLE;
+	bound_compute_pipeline  = VK_NULL_HANDLE;
+}
+
+void CommandBuffer::end_render_pass()
+{
+	if (!rendering_subpasses.empty())
+	{
+		vkCmdEndRenderingKHR(get_handle());
+		shader_object_pass = false;
+		rendering_subpasses.clear();
+		subpass_rendering_states.clear();
+		return;
+	}
+
+	vkCmdEndRenderPass(get_handle());
+}
+
+void CommandBuffer::bind_pipeline_layout(PipelineLayout &pipeline_layout)
+{
+	pipeline_state.set_pipeline_layout(pipeline_layout);
+}
+
+void CommandBuffer::begin_immediate()
+{
+	assert(!immediate_mode && "Command buffer is already in immediate mode");
+
+	immediate_mode = true;
+}
+
+void CommandBuffer::end_immediate()
+{
+	assert(immediate_mode && "Command buffer is not in immediate mode");
+
+	// The pipeline bound last is still known, so the tracked state only binds a different one
+	pipeline_state.reset();
+	resource_binding_state.reset();
+	descriptor_set_layout_binding_state.clear();
+	stored_push_constants.clear();
+
+	immediate_mode = false;
+}
+
+bool CommandBuffer::is_immediate() const
+{
+	return immediate_mode;
+}
+
+void CommandBuffer::bind_pipeline(VkPipelineBindPoint pipeline_bind_point, const Pipeline &pipeline)
+{
+	assert(immediate_mode && "Pipelines are only bound directly in immediate mode");
+
+	VkPipeline *bound_pipeline = pipeline_bind_point == VK_PIPELINE_BIND_POINT_COMPUTE ? &bound_compute_pipeline : &bound_graphics_pipeline;
+
+	if (pipeline.get_handle() == *bound_pipeline)
+	{
+		skipped_pipeline_bind_count.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	vkCmdBindPipeline(get_handle(), pipeline_bind_point, pipeline.get_handle());
+
+	*bound_pipeline = pipeline.get_handle();
+}
+
+void CommandBuffer::bind_descriptor_set(VkPipelineBindPoint pipeline_bind_point, const PipelineLayout &pipeline_layout, uint32_t set,
+                                        const DescriptorSet &descriptor_set, const std::vector<uint32_t> &dynamic_offsets)
+{
+	assert(immediate_mode && "Descriptor sets are only bound directly in immediate mode");
+
+	VkDescriptorSet descriptor_set_handle = descriptor_set.get_handle();
+
+	vkCmdBindDescriptorSets(get_handle(),
+	                        pipeline_bind_point,
+	                        pipeline_layout.get_handle(),
+	                        set,
+	                        1, &descriptor_set_handle,
+	                        to_u32(dynamic_offsets.size()),
+	                        dynamic_offsets.data());
+}
+
+void CommandBuffer::push_constants(const PipelineLayout &pipeline_layout, VkShaderStageFlags shader_stages, uint32_t offset, const uint8_t *data, uint32_t size)
+{
+	assert(immediate_mode && "Push constants are only recorded directly in immediate mode");
+
+	vkCmdPushConstants(get_handle(), pipeline_layout.get_handle(), shader_stages, offset, size, data);
+}
+
+void CommandBuffer::set_specialization_constant(uint32_t constant_id, const std::vector<uint8_t> &data)
+{
+	pipeline_state.set_specialization_constant(constant_id, data);
+}
+
+void CommandBuffer::push_constants(const std::vector<uint8_t> &values)
+{
+	push_constants(values.data(), values.size());
+}
+
+void CommandBuffer::push_constants(const uint8_t *data, size_t size)
+{
+	uint32_t push_constant_size = to_u32(stored_push_constants.size() + size);
+
+	if (push_constant_size > max_push_constants_size)
+	{
+		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, size, push_constant_size);
+		throw std::runtime_error("Push constant limit exceeded.");
+	}
+	else
+	{
+		stored_push_constants.insert(stored_push_constants.end(), data, data + size);
+	}
+}
+
+void CommandBuffer::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
+{
+	resource_binding_state.bind_buffer(buffer, offset, range, set, binding, array_element);
+}
+
+void CommandBuffer::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element)
+{
+	resource_binding_state.bind_image(image_view, sampler, set, binding, array_element);
+}
+
+void CommandBuffer::bind_image(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
+{
+	resource_binding_state.bind_image(image_view, set, binding, array_element);
+}
+
+void CommandBuffer::bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
+{
+	resource_binding_state.bind_input(image_view, set, binding, array_element);
+}
+
+void CommandBuffer::bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::Buffer>> &buffers, const std::vector<VkDeviceSize> &offsets)
+{
+	std::vector<VkBuffer> buffer_handles(buffers.size(), VK_NULL_HANDLE);
+	std::transform(buffers.begin(), buffers.end(), buffer_handles.begin(),
+	               [](const core::Buffer &buffer) { return buffer.get_handle(); });
+	vkCmdBindVertexBuffers(get_handle(), first_binding, to_u32(buffer_handles.size()), buffer_handles.data(), offsets.data());
+}
+
+void CommandBuffer::bind_index_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type)
+{
+	vkCmdBindIndexBuffer(get_handle(), buffer.get_handle(), offset, index_type);
+}
+
+void CommandBuffer::bind_lighting(LightingState &lighting_state, uint32_t set, uint32_t binding)
+{
+	bind_buffer(lighting_state.light_buffer.get_buffer(), lighting_state.light_buffer.get_offset(), lighting_state.light_buffer.get_size(), set, binding, 0);
+
+	set_specialization_constant(0, to_u32(lighting_state.directional_lights.size()));
+	set_specialization_constant(1, to_u32(lighting_state.point_lights.size()));
+	set_specialization_constant(2, to_u32(lighting_state.spot_lights.size()));
+}
+
+void CommandBuffer::set_viewport_state(const ViewportState &state_info)
+{
+	pipeline_state.set_viewport_state(state_info);
+}
+
+void CommandBuffer::set_vertex_input_state(const VertexInputState &state_info)
+{
+	pipeline_state.set_vertex_input_state(state_info);
+}
+
+void CommandBuffer::set_input_assembly_state(const InputAssemblyState &state_info)
+{
+	pipeline_state.set_input_assembly_state(state_info);
+}
+
+void CommandBuffer::set_rasterization_state(const RasterizationState &state_info)
+{
+	pipeline_state.set_rasterization_state(state_info);
+}
+
+void CommandBuffer::set_multisample_state(const MultisampleState &state_info)
+{
+	pipeline_state.set_multisample_state(state_info);
+}
+
+void CommandBuffer::set_depth_stencil_state(const DepthStencilState &state_info)
+{
+	pipeline_state.set_depth_stencil_state(state_info);
+}
+
+void CommandBuffer::set_color_blend_state(const ColorBlendState &state_info)
+{
+	pipeline_state.set_color_blend_state(state_info);
+}
+
+void CommandBuffer::set_viewport(uint32_t first_viewport, const std::vector<VkViewport> &viewports)
+{
+	vkCmdSetViewport(get_handle(), first_viewport, to_u32(viewports.size()), viewports.data());
+
+	// Shader objects take the viewport count from the dynamic state as well
+	if (get_device().uses_shader_objects() && first_viewport == 0)
+	{
+		vkCmdSetViewportWithCountEXT(get_handle(), to_u32(viewports.size()), viewports.data());
+	}
+}
+
+void CommandBuffer::set_scissor(uint32_t first_scissor, const std::vector<VkRect2D> &scissors)
+{
+	vkCmdSetScissor(get_handle(), first_scissor, to_u32(scissors.size()), scissors.data());
+
+	if (get_device().uses_shader_objects() && first_scissor == 0)
+	{
+		vkCmdSetScissorWithCountEXT(get_handle(), to_u32(scissors.size()), scissors.data());
+	}
+}
+
+void CommandBuffer::set_line_width(float line_width)
+{
+	vkCmdSetLineWidth(get_handle(), line_width);
+}
+
+void CommandBuffer::set_depth_bias(float depth_bias_constant_factor, float depth_bias_clamp, float depth_bias_slope_factor)
+{
+	vkCmdSetDepthBias(get_handle(), depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor);
+}
+
+void CommandBuffer::set_blend_constants(const std::array<float, 4> &blend_constants)
+{
+	vkCmdSetBlendConstants(get_handle(), blend_constants.data());
+}
+
+void CommandBuffer::set_depth_bounds(float min_depth_bounds, float max_depth_bounds)
+{
+	vkCmdSetDepthBounds(get_handle(), min_depth_bounds, max_depth_bounds);
+}
+
+void CommandBuffer::set_fragment_shading_rate(const VkExtent2D &rate)
+{
+	// Only command buffers of graphics queues can set it
+	auto &queue_family_properties = get_device().get_gpu().get_queue_family_properties();
+	if (!get_device().uses_fragment_shading_rates() ||
+	    !(queue_family_properties[command_pool.get_queue_family_index()].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+	{
+		return;
+	}
+
+	fragment_shading_rate = rate;
+
+	// The pipeline rate is used as is, neither primitive nor attachment rates are used
+	const VkFragmentShadingRateCombinerOpKHR combiner_ops[2]{VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR, VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR};
+	vkCmdSetFragmentShadingRateKHR(get_handle(), &fragment_shading_rate, combiner_ops);
+}
+
+const VkExtent2D &CommandBuffer::get_fragment_shading_rate() const
+{
+	return fragment_shading_rate;
+}
+
+void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
+{
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		return;
+	}
 
 	vkCmdDraw(get_handle(), vertex_count, instance_count, first_vertex, first_instance);
 }
 
 void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		return;
+	}
 
 	vkCmdDrawIndexed(get_handle(), index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
 void CommandBuffer::draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		return;
+	}
 
 	vkCmdDrawIndexedIndirect(get_handle(), buffer.get_handle(), offset, draw_count, stride);
 }
 
+void CommandBuffer::draw_mesh_tasks(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
+{
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		return;
+	}
+
+	vkCmdDrawMeshTasksEXT(get_handle(), group_count_x, group_count_y, group_count_z);
+}
+
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
 {
+	record_pending_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatch(get_handle(), group_count_x, group_count_y, group_count_z);
@@ -381,6 +1052,8 @@ void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uin
 
 void CommandBuffer::dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset)
 {
+	record_pending_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatchIndirect(get_handle(), buffer.get_handle(), offset);
@@ -388,11 +1061,20 @@ void CommandBuffer::dispatch_indirect(const core::Buffer &buffer, VkDeviceSize o
 
 void CommandBuffer::update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data)
 {
-	vkCmdUpdateBuffer(get_handle(), buffer.get_handle(), offset, data.size(), data.data());
+	update_buffer(buffer, offset, data.data(), data.size());
+}
+
+void CommandBuffer::update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, size_t size)
+{
+	record_pending_barriers();
+
+	vkCmdUpdateBuffer(get_handle(), buffer.get_handle(), offset, size, data);
 }
 
 void CommandBuffer::blit_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageBlit> &regions)
 {
+	record_pending_barriers();
+
 	vkCmdBlitImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	               dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	               to_u32(regions.size()), regions.data(), VK_FILTER_NEAREST);
@@ -400,6 +1082,8 @@ void CommandBuffer::blit_image(const core::Image &src_img, const core::Image &ds
 
 void CommandBuffer::resolve_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageResolve> &regions)
 {
+	record_pending_barriers();
+
 	vkCmdResolveImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	                  dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	                  to_u32(regions.size()), regions.data());
@@ -407,6 +1091,8 @@ void CommandBuffer::resolve_image(const core::Image &src_img, const core::Image
 
 void CommandBuffer::copy_buffer(const core::Buffer &src_buffer, const core::Buffer &dst_buffer, VkDeviceSize size)
 {
+	record_pending_barriers();
+
 	VkBufferCopy copy_region = {};
 	copy_region.size         = size;
 	vkCmdCopyBuffer(get_handle(), src_buffer.get_handle(), dst_buffer.get_handle(), 1, &copy_region);
@@ -414,103 +1100,599 @@ void CommandBuffer::copy_buffer(const core::Buffer &src_buffer, const core::Buff
 
 void CommandBuffer::copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions)
 {
+	record_pending_barriers();
+
 	vkCmdCopyImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	               dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	               to_u32(regions.size()), regions.data());
 }
 
-void CommandBuffer::copy_buffer_to_image(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions)
-{
-	vkCmdCopyBufferToImage(get_handle(), buffer.get_handle(),
-	                       image.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                       to_u32(regions.size()), regions.data());
-}
+void CommandBuffer::copy_buffer_to_image(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions)
+{
+	record_pending_barriers();
+
+	vkCmdCopyBufferToImage(get_handle(), buffer.get_handle(),
+	                       image.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                       to_u32(regions.size()), regions.data());
+}
+
+void CommandBuffer::copy_image_to_buffer(const core::Image &image, VkImageLayout image_layout, const core::Buffer &buffer, const std::vector<VkBufferImageCopy> &regions)
+{
+	record_pending_barriers();
+
+	vkCmdCopyImageToBuffer(get_handle(), image.get_handle(), image_layout,
+	                       buffer.get_handle(), to_u32(regions.size()), regions.data());
+}
+
+void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier)
+{
+	auto subresource_range = get_barrier_subresource_range(image_view);
+
+	VkImageMemoryBarrier2KHR image_memory_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+	image_memory_barrier.srcStageMask        = to_stage_flags2(memory_barrier.src_stage_mask, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	image_memory_barrier.srcAccessMask       = memory_barrier.src_access_mask;
+	image_memory_barrier.dstStageMask        = to_stage_flags2(memory_barrier.dst_stage_mask, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+	image_memory_barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+	image_memory_barrier.oldLayout           = memory_barrier.old_layout;
+	image_memory_barrier.newLayout           = memory_barrier.new_layout;
+	image_memory_barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+	image_memory_barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+	image_memory_barrier.image               = image_view.get_image().get_handle();
+	image_memory_barrier.subresourceRange    = subresource_range;
+
+	pending_image_barriers.push_back(image_memory_barrier);
+
+	image_view.get_image().set_subresource_state(subresource_range, {memory_barrier.new_layout, memory_barrier.dst_stage_mask, memory_barrier.dst_access_mask});
+
+	if (!barrier_batch_open)
+	{
+		record_pending_barriers();
+	}
+}
+
+void CommandBuffer::buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
+{
+	VkBufferMemoryBarrier2KHR buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR};
+	buffer_memory_barrier.srcStageMask        = to_stage_flags2(memory_barrier.src_stage_mask, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	buffer_memory_barrier.srcAccessMask       = memory_barrier.src_access_mask;
+	buffer_memory_barrier.dstStageMask        = to_stage_flags2(memory_barrier.dst_stage_mask, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+	buffer_memory_barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+	buffer_memory_barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+	buffer_memory_barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+	buffer_memory_barrier.buffer              = buffer.get_handle();
+	buffer_memory_barrier.offset              = offset;
+	buffer_memory_barrier.size                = size;
+
+	pending_buffer_barriers.push_back(buffer_memory_barrier);
+
+	// A barrier on part of the buffer says nothing about the rest of it
+	if (offset == 0 && (size == VK_WHOLE_SIZE || size >= buffer.get_size()))
+	{
+		buffer.set_state({memory_barrier.dst_stage_mask, memory_barrier.dst_access_mask});
+	}
+
+	if (!barrier_batch_open)
+	{
+		record_pending_barriers();
+	}
+}
+
+void CommandBuffer::image_transition(const core::ImageView &image_view, VkImageLayout new_layout, VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask)
+{
+	auto &image = image_view.get_image();
+	auto  range = get_barrier_subresource_range(image_view);
+
+	uint32_t level_count = range.levelCount == VK_REMAINING_MIP_LEVELS ? image.get_subresource().mipLevel - range.baseMipLevel : range.levelCount;
+	uint32_t layer_count = range.layerCount == VK_REMAINING_ARRAY_LAYERS ? image.get_array_layer_count() - range.baseArrayLayer : range.layerCount;
+
+	auto same_state = [](const core::ImageSubresourceState &lhs, const core::ImageSubresourceState &rhs) {
+		return lhs.layout == rhs.layout && lhs.stage_mask == rhs.stage_mask && lhs.access_mask == rhs.access_mask;
+	};
+
+	// The whole range is transitioned by one barrier if its subresources share their state, as they usually do
+	const auto &first_state  = image.get_subresource_state(range.baseMipLevel, range.baseArrayLayer);
+	bool        uniform_range = true;
+	for (uint32_t layer = 0; layer < layer_count && uniform_range; layer++)
+	{
+		for (uint32_t level = 0; level < level_count && uniform_range; level++)
+		{
+			uniform_range = same_state(first_state, image.get_subresource_state(range.baseMipLevel + level, range.baseArrayLayer + layer));
+		}
+	}
+
+	auto transition = [&](core::ImageSubresourceState state, const VkImageSubresourceRange &subresource_range) {
+		if (state.layout == new_layout && is_state_synchronized(state.stage_mask, state.access_mask, dst_stage_mask, dst_access_mask))
+		{
+			return;
+		}
+
+		VkImageMemoryBarrier2KHR image_memory_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+		image_memory_barrier.srcStageMask        = state.stage_mask;
+		image_memory_barrier.srcAccessMask       = state.access_mask & WRITE_ACCESS_MASK;
+		image_memory_barrier.dstStageMask        = dst_stage_mask;
+		image_memory_barrier.dstAccessMask       = dst_access_mask;
+		image_memory_barrier.oldLayout           = state.layout;
+		image_memory_barrier.newLayout           = new_layout;
+		image_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_memory_barrier.image               = image.get_handle();
+		image_memory_barrier.subresourceRange    = subresource_range;
+
+		pending_image_barriers.push_back(image_memory_barrier);
+
+		// Further reads in the same layout only have to be synchronized for the stages which did not read yet
+		if (state.layout == new_layout && ((state.access_mask | dst_access_mask) & WRITE_ACCESS_MASK) == 0)
+		{
+			state.stage_mask |= dst_stage_mask;
+			state.access_mask |= dst_access_mask;
+		}
+		else
+		{
+			state = {new_layout, dst_stage_mask, dst_access_mask};
+		}
+
+		image.set_subresource_state(subresource_range, state);
+	};
+
+	if (uniform_range)
+	{
+		transition(first_state, range);
+		return;
+	}
+
+	for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + layer_count; layer++)
+	{
+		for (uint32_t level = range.baseMipLevel; level < range.baseMipLevel + level_count; level++)
+		{
+			transition(image.get_subresource_state(level, layer), {range.aspectMask, level, 1, layer, 1});
+		}
+	}
+}
+
+void CommandBuffer::buffer_transition(const core::Buffer &buffer, VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask)
+{
+	auto state = buffer.get_state();
+
+	if (is_state_synchronized(state.stage_mask, state.access_mask, dst_stage_mask, dst_access_mask))
+	{
+		return;
+	}
+
+	VkBufferMemoryBarrier2KHR buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR};
+	buffer_memory_barrier.srcStageMask        = state.stage_mask;
+	buffer_memory_barrier.srcAccessMask       = state.access_mask & WRITE_ACCESS_MASK;
+	buffer_memory_barrier.dstStageMask        = dst_stage_mask;
+	buffer_memory_barrier.dstAccessMask       = dst_access_mask;
+	buffer_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	buffer_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	buffer_memory_barrier.buffer              = buffer.get_handle();
+	buffer_memory_barrier.offset              = 0;
+	buffer_memory_barrier.size                = VK_WHOLE_SIZE;
+
+	pending_buffer_barriers.push_back(buffer_memory_barrier);
+
+	if (((state.access_mask | dst_access_mask) & WRITE_ACCESS_MASK) == 0)
+	{
+		state.stage_mask |= dst_stage_mask;
+		state.access_mask |= dst_access_mask;
+	}
+	else
+	{
+		state = {dst_stage_mask, dst_access_mask};
+	}
+
+	buffer.set_state(state);
+}
+
+void CommandBuffer::release_ownership(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier)
+{
+	if (!is_ownership_transfer(memory_barrier.old_queue_family, memory_barrier.new_queue_family))
+	{
+		return;
+	}
+
+	// The acquire waits for the release with a semaphore, the destination scope of the release is not used
+	ImageMemoryBarrier release_barrier = memory_barrier;
+	release_barrier.dst_stage_mask     = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	release_barrier.dst_access_mask    = 0;
+
+	image_memory_barrier(image_view, release_barrier);
+}
+
+void CommandBuffer::acquire_ownership(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier)
+{
+	ImageMemoryBarrier acquire_barrier = memory_barrier;
+
+	if (is_ownership_transfer(memory_barrier.old_queue_family, memory_barrier.new_queue_family))
+	{
+		acquire_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		acquire_barrier.src_access_mask = 0;
+	}
+	else
+	{
+		// Within a queue family the whole barrier is recorded here
+		acquire_barrier.old_queue_family = VK_QUEUE_FAMILY_IGNORED;
+		acquire_barrier.new_queue_family = VK_QUEUE_FAMILY_IGNORED;
+	}
+
+	image_memory_barrier(image_view, acquire_barrier);
+}
+
+void CommandBuffer::release_ownership(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
+{
+	if (!is_ownership_transfer(memory_barrier.old_queue_family, memory_barrier.new_queue_family))
+	{
+		return;
+	}
+
+	BufferMemoryBarrier release_barrier = memory_barrier;
+	release_barrier.dst_stage_mask      = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	release_barrier.dst_access_mask     = 0;
+
+	buffer_memory_barrier(buffer, offset, size, release_barrier);
+}
+
+void CommandBuffer::acquire_ownership(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
+{
+	BufferMemoryBarrier acquire_barrier = memory_barrier;
+
+	if (is_ownership_transfer(memory_barrier.old_queue_family, memory_barrier.new_queue_family))
+	{
+		acquire_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		acquire_barrier.src_access_mask = 0;
+	}
+	else
+	{
+		acquire_barrier.old_queue_family = VK_QUEUE_FAMILY_IGNORED;
+		acquire_barrier.new_queue_family = VK_QUEUE_FAMILY_IGNORED;
+	}
+
+	buffer_memory_barrier(buffer, offset, size, acquire_barrier);
+}
+
+void CommandBuffer::begin_barrier_batch()
+{
+	barrier_batch_open = true;
+}
+
+void CommandBuffer::flush_barriers()
+{
+	barrier_batch_open = false;
+
+	record_pending_barriers();
+}
+
+VkPipelineStageFlags2KHR CommandBuffer::to_stage_flags2(VkPipelineStageFlags stage_mask, VkPipelineStageFlagBits no_op_stage)
+{
+	// The stage only orders execution on its side of a barrier, which synchronization2 expresses as no stage
+	return stage_mask == static_cast<VkPipelineStageFlags>(no_op_stage) ? VK_PIPELINE_STAGE_2_NONE_KHR : stage_mask;
+}
+
+void CommandBuffer::record_pending_barriers()
+{
+	if (pending_image_barriers.empty() && pending_buffer_barriers.empty())
+	{
+		return;
+	}
+
+	if (get_device().uses_synchronization2())
+	{
+		VkDependencyInfoKHR dependency_info{VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR};
+		dependency_info.bufferMemoryBarrierCount = to_u32(pending_buffer_barriers.size());
+		dependency_info.pBufferMemoryBarriers    = pending_buffer_barriers.data();
+		dependency_info.imageMemoryBarrierCount  = to_u32(pending_image_barriers.size());
+		dependency_info.pImageMemoryBarriers     = pending_image_barriers.data();
+
+		vkCmdPipelineBarrier2KHR(get_handle(), &dependency_info);
+	}
+	else
+	{
+		// The barriers were made from legacy masks, which fit the legacy flags
+		VkPipelineStageFlags src_stage_mask = 0;
+		VkPipelineStageFlags dst_stage_mask = 0;
+
+		std::vector<VkImageMemoryBarrier> image_memory_barriers;
+		for (auto &barrier : pending_image_barriers)
+		{
+			VkImageMemoryBarrier image_memory_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+			image_memory_barrier.srcAccessMask       = static_cast<VkAccessFlags>(barrier.srcAccessMask);
+			image_memory_barrier.dstAccessMask       = static_cast<VkAccessFlags>(barrier.dstAccessMask);
+			image_memory_barrier.oldLayout           = barrier.oldLayout;
+			image_memory_barrier.newLayout           = barrier.newLayout;
+			image_memory_barrier.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+			image_memory_barrier.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+			image_memory_barrier.image               = barrier.image;
+			image_memory_barrier.subresourceRange    = barrier.subresourceRange;
+			image_memory_barriers.push_back(image_memory_barrier);
+
+			src_stage_mask |= static_cast<VkPipelineStageFlags>(barrier.srcStageMask);
+			dst_stage_mask |= static_cast<VkPipelineStageFlags>(barrier.dstStageMask);
+		}
+
+		std::vector<VkBufferMemoryBarrier> buffer_memory_barriers;
+		for (auto &barrier : pending_buffer_barriers)
+		{
+			VkBufferMemoryBarrier buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+			buffer_memory_barrier.srcAccessMask       = static_cast<VkAccessFlags>(barrier.srcAccessMask);
+			buffer_memory_barrier.dstAccessMask       = static_cast<VkAccessFlags>(barrier.dstAccessMask);
+			buffer_memory_barrier.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+			buffer_memory_barrier.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+			buffer_memory_barrier.buffer              = barrier.buffer;
+			buffer_memory_barrier.offset              = barrier.offset;
+			buffer_memory_barrier.size                = barrier.size;
+			buffer_memory_barriers.push_back(buffer_memory_barrier);
+
+			src_stage_mask |= static_cast<VkPipelineStageFlags>(barrier.srcStageMask);
+			dst_stage_mask |= static_cast<VkPipelineStageFlags>(barrier.dstStageMask);
+		}
+
+		vkCmdPipelineBarrier(get_handle(),
+		                     src_stage_mask ? src_stage_mask : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		                     dst_stage_mask ? dst_stage_mask : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		                     0,
+		                     0, nullptr,
+		                     to_u32(buffer_memory_barriers.size()), buffer_memory_barriers.data(),
+		                     to_u32(image_memory_barriers.size()), image_memory_barriers.data());
+	}
+
+	pending_image_barriers.clear();
+	pending_buffer_barriers.clear();
+}
+
+bool CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
+{
+	// Create a new pipeline only if the graphics state changed
+	if (!pipeline_state.is_dirty())
+	{
+		return true;
+	}
+
+	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS && shader_object_pass)
+	{
+		pipeline_state.clear_dirty();
+		flush_shader_object_state();
+		return true;
+	}
+
+	auto &resource_cache = get_device().get_resource_cache();
+
+	// Create and bind pipeline
+	VkPipeline  pipeline_handle = VK_NULL_HANDLE;
+	VkPipeline *bound_pipeline  = nullptr;
+
+	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+	{
+		// Dynamic rendering passes have no render pass, the pipelines are created for their rendering state
+		if (current_render_pass.render_pass)
+		{
+			pipeline_state.set_render_pass(*current_render_pass.render_pass);
+		}
+		bound_pipeline = &bound_graphics_pipeline;
+
+		if (resource_cache.get_pipeline_compile_mode() == PipelineCompileMode::Async)
+		{
+			GraphicsPipeline *pipeline = resource_cache.request_graphics_pipeline_async(pipeline_state);
+
+			if (pipeline)
+			{
+				pipeline_state.clear_dirty();
+			}
+			else
+			{
+				// The state stays dirty, so that the pipeline is requested again by the next draw
+				pipeline = resource_cache.request_fallback_graphics_pipeline(pipeline_state);
+
+				if (!pipeline)
+				{
+					return false;
+				}
+			}
+
+			pipeline_handle = pipeline->get_handle();
+		}
+		else
+		{
+			pipeline_state.clear_dirty();
+			pipeline_handle = resource_cache.request_graphics_pipeline(pipeline_state).get_handle();
+		}
+	}
+	else if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
+	{
+		pipeline_state.clear_dirty();
+		pipeline_handle = resource_cache.request_compute_pipeline(pipeline_state).get_handle();
+		bound_pipeline  = &bound_compute_pipeline;
+	}
+	else
+	{
+		throw "Only graphics and compute pipeline bind points are supported now";
+	}
+
+	// The state may have changed back to the one of the bound pipeline, or only in its dynamic state
+	if (pipeline_handle == *bound_pipeline)
+	{
+		skipped_pipeline_bind_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+	{
+		vkCmdBindPipeline(get_handle(),
+		                  pipeline_bind_point,
+		                  pipeline_handle);
+
+		*bound_pipeline = pipeline_handle;
+	}
+
+	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+	{
+		flush_dynamic_pipeline_state(pipeline_state.get_dynamic_state_flags());
+	}
+
+	return true;
+}
+
+void CommandBuffer::flush_shader_object_state()
+{
+	auto &resource_cache     = get_device().get_resource_cache();
+	auto &pipeline_layout    = pipeline_state.get_pipeline_layout();
+	auto &specialization     = pipeline_state.get_specialization_constant_state();
+	auto  requested_features = get_device().get_gpu().get_requested_features();
+
+	// Every graphics stage the device enables must be bound, stages without a shader are bound to null
+	std::vector<VkShaderStageFlagBits> stages{VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT};
+
+	if (get_device().uses_mesh_shaders())
+	{
+		stages.push_back(VK_SHADER_STAGE_TASK_BIT_EXT);
+		stages.push_back(VK_SHADER_STAGE_MESH_BIT_EXT);
+	}
+
+	if (requested_features.tessellationShader)
+	{
+		stages.push_back(VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT);
+		stages.push_back(VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT);
+	}
+
+	if (requested_features.geometryShader)
+	{
+		stages.push_back(VK_SHADER_STAGE_GEOMETRY_BIT);
+	}
+
+	std::vector<VkShaderEXT> shaders(stages.size(), VK_NULL_HANDLE);
+
+	for (auto *shader_module : pipeline_layout.get_shader_modules())
+	{
+		auto it = std::find(stages.begin(), stages.end(), shader_module->get_stage());
+
+		if (it != stages.end())
+		{
+			shaders[std::distance(stages.begin(), it)] = resource_cache.request_shader_object(pipeline_layout, *shader_module, specialization).get_handle();
+		}
+	}
 
-void CommandBuffer::copy_image_to_buffer(const core::Image &image, VkImageLayout image_layout, const core::Buffer &buffer, const std::vector<VkBufferImageCopy> &regions)
-{
-	vkCmdCopyImageToBuffer(get_handle(), image.get_handle(), image_layout,
-	                       buffer.get_handle(), to_u32(regions.size()), regions.data());
-}
+	vkCmdBindShadersEXT(get_handle(), to_u32(stages.size()), stages.data(), shaders.data());
 
-void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier) const
-{
-	// Adjust barrier's subresource range for depth images
-	auto subresource_range = image_view.get_subresource_range();
-	auto format            = image_view.get_format();
-	if (is_depth_only_format(format))
+	// Nothing is baked, so all of the pipeline state is set
+	auto &vertex_input_state = pipeline_state.get_vertex_input_state();
+
+	std::vector<VkVertexInputBindingDescription2EXT> vertex_bindings;
+	for (auto &binding : vertex_input_state.bindings)
 	{
-		subresource_range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+		VkVertexInputBindingDescription2EXT vertex_binding{VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT};
+		vertex_binding.binding   = binding.binding;
+		vertex_binding.stride    = binding.stride;
+		vertex_binding.inputRate = binding.inputRate;
+		vertex_binding.divisor   = 1;
+		vertex_bindings.push_back(vertex_binding);
 	}
-	else if (is_depth_stencil_format(format))
+
+	std::vector<VkVertexInputAttributeDescription2EXT> vertex_attributes;
+	for (auto &attribute : vertex_input_state.attributes)
 	{
-		subresource_range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		VkVertexInputAttributeDescription2EXT vertex_attribute{VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT};
+		vertex_attribute.location = attribute.location;
+		vertex_attribute.binding  = attribute.binding;
+		vertex_attribute.format   = attribute.format;
+		vertex_attribute.offset   = attribute.offset;
+		vertex_attributes.push_back(vertex_attribute);
 	}
 
-	vkb::image_layout_transition(get_handle(),
-	                             image_view.get_image().get_handle(),
-	                             memory_barrier.src_stage_mask,
-	                             memory_barrier.dst_stage_mask,
-	                             memory_barrier.src_access_mask,
-	                             memory_barrier.dst_access_mask,
-	                             memory_barrier.old_layout,
-	                             memory_barrier.new_layout,
-	                             subresource_range);
-}
+	vkCmdSetVertexInputEXT(get_handle(), to_u32(vertex_bindings.size()), vertex_bindings.data(), to_u32(vertex_attributes.size()), vertex_attributes.data());
 
-void CommandBuffer::buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
-{
-	VkBufferMemoryBarrier buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
-	buffer_memory_barrier.srcAccessMask = memory_barrier.src_access_mask;
-	buffer_memory_barrier.dstAccessMask = memory_barrier.dst_access_mask;
-	buffer_memory_barrier.buffer        = buffer.get_handle();
-	buffer_memory_barrier.offset        = offset;
-	buffer_memory_barrier.size          = size;
+	auto &input_assembly_state = pipeline_state.get_input_assembly_state();
+
+	vkCmdSetPrimitiveTopologyEXT(get_handle(), input_assembly_state.topology);
+	vkCmdSetPrimitiveRestartEnableEXT(get_handle(), input_assembly_state.primitive_restart_enable);
+
+	auto &rasterization_state = pipeline_state.get_rasterization_state();
+
+	vkCmdSetRasterizerDiscardEnableEXT(get_handle(), rasterization_state.rasterizer_discard_enable);
+	vkCmdSetPolygonModeEXT(get_handle(), rasterization_state.polygon_mode);
+	vkCmdSetDepthBiasEnableEXT(get_handle(), rasterization_state.depth_bias_enable);
+	vkCmdSetDepthClampEnableEXT(get_handle(), rasterization_state.depth_clamp_enable);
+
+	auto &multisample_state = pipeline_state.get_multisample_state();
+
+	// A sample mask of 0 stands for all samples, as in the pipeline path
+	VkSampleMask sample_mask = multisample_state.sample_mask ? multisample_state.sample_mask : ~0u;
+
+	vkCmdSetRasterizationSamplesEXT(get_handle(), multisample_state.rasterization_samples);
+	vkCmdSetSampleMaskEXT(get_handle(), multisample_state.rasterization_samples, &sample_mask);
+	vkCmdSetAlphaToCoverageEnableEXT(get_handle(), multisample_state.alpha_to_coverage_enable);
+	vkCmdSetAlphaToOneEnableEXT(get_handle(), multisample_state.alpha_to_one_enable);
 
-	VkPipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
-	VkPipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
+	auto &color_blend_state = pipeline_state.get_color_blend_state();
 
-	vkCmdPipelineBarrier(
-	    get_handle(),
-	    src_stage_mask,
-	    dst_stage_mask,
-	    0,
-	    0, nullptr,
-	    1, &buffer_memory_barrier,
-	    0, nullptr);
+	vkCmdSetLogicOpEnableEXT(get_handle(), color_blend_state.logic_op_enable);
+	vkCmdSetLogicOpEXT(get_handle(), color_blend_state.logic_op);
+
+	flush_dynamic_pipeline_state(DYNAMIC_PIPELINE_STATE_RASTERIZATION_BIT | DYNAMIC_PIPELINE_STATE_DEPTH_STENCIL_BIT | DYNAMIC_PIPELINE_STATE_COLOR_BLEND_BIT);
 }
 
-void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
+void CommandBuffer::flush_dynamic_pipeline_state(DynamicPipelineStateFlags dynamic_state_flags)
 {
-	// Create a new pipeline only if the graphics state changed
-	if (!pipeline_state.is_dirty())
+	if (dynamic_state_flags & DYNAMIC_PIPELINE_STATE_RASTERIZATION_BIT)
 	{
-		return;
-	}
+		auto &rasterization_state = pipeline_state.get_rasterization_state();
 
-	pipeline_state.clear_dirty();
+		vkCmdSetCullModeEXT(get_handle(), rasterization_state.cull_mode);
+		vkCmdSetFrontFaceEXT(get_handle(), rasterization_state.front_face);
+	}
 
-	// Create and bind pipeline
-	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+	if (dynamic_state_flags & DYNAMIC_PIPELINE_STATE_DEPTH_STENCIL_BIT)
 	{
-		pipeline_state.set_render_pass(*current_render_pass.render_pass);
-		auto &pipeline = get_device().get_resource_cache().request_graphics_pipeline(pipeline_state);
+		auto &depth_stencil_state = pipeline_state.get_depth_stencil_state();
 
-		vkCmdBindPipeline(get_handle(),
-		                  pipeline_bind_point,
-		                  pipeline.get_handle());
+		vkCmdSetDepthTestEnableEXT(get_handle(), depth_stencil_state.depth_test_enable);
+		vkCmdSetDepthWriteEnableEXT(get_handle(), depth_stencil_state.depth_write_enable);
+		vkCmdSetDepthCompareOpEXT(get_handle(), depth_stencil_state.depth_compare_op);
+		vkCmdSetDepthBoundsTestEnableEXT(get_handle(), depth_stencil_state.depth_bounds_test_enable);
+		vkCmdSetStencilTestEnableEXT(get_handle(), depth_stencil_state.stencil_test_enable);
+
+		auto &front = depth_stencil_state.front;
+		auto &back  = depth_stencil_state.back;
+
+		vkCmdSetStencilOpEXT(get_handle(), VK_STENCIL_FACE_FRONT_BIT, front.fail_op, front.pass_op, front.depth_fail_op, front.compare_op);
+		vkCmdSetStencilOpEXT(get_handle(), VK_STENCIL_FACE_BACK_BIT, back.fail_op, back.pass_op, back.depth_fail_op, back.compare_op);
 	}
-	else if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
+
+	auto &attachments = pipeline_state.get_color_blend_state().attachments;
+
+	if ((dynamic_state_flags & DYNAMIC_PIPELINE_STATE_COLOR_BLEND_BIT) && !attachments.empty())
 	{
-		auto &pipeline = get_device().get_resource_cache().request_compute_pipeline(pipeline_state);
+		std::vector<VkBool32>                blend_enables;
+		std::vector<VkColorBlendEquationEXT> blend_equations;
+		std::vector<VkColorComponentFlags>   write_masks;
 
-		vkCmdBindPipeline(get_handle(),
-		                  pipeline_bind_point,
-		                  pipeline.get_handle());
+		for (auto &attachment : attachments)
+		{
+			blend_enables.push_back(attachment.blend_enable);
+			blend_equations.push_back({attachment.src_color_blend_factor,
+			                           attachment.dst_color_blend_factor,
+			                           attachment.color_blend_op,
+			                           attachment.src_alpha_blend_factor,
+			                           attachment.dst_alpha_blend_factor,
+			                           attachment.alpha_blend_op});
+			write_masks.push_back(attachment.color_write_mask);
+		}
+
+		vkCmdSetColorBlendEnableEXT(get_handle(), 0, to_u32(blend_enables.size()), blend_enables.data());
+		vkCmdSetColorBlendEquationEXT(get_handle(), 0, to_u32(blend_equations.size()), blend_equations.data());
+		vkCmdSetColorWriteMaskEXT(get_handle(), 0, to_u32(write_masks.size()), write_masks.data());
 	}
-	else
+}
+
+FrameArena &CommandBuffer::get_arena()
+{
+	if (auto render_frame = command_pool.get_render_frame())
 	{
-		throw "Only graphics and compute pipeline bind points are supported now";
+		return render_frame->get_arena(command_pool.get_thread_index());
 	}
+
+	return scratch_arena;
+}
+
+uint32_t CommandBuffer::take_skipped_pipeline_bind_count()
+{
+	return skipped_pipeline_bind_count.exchange(0);
 }
 
 void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point)
@@ -519,7 +1701,9 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 
 	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
 
-	std::unordered_set<uint32_t> update_descriptor_sets;
+	auto &arena = get_arena();
+
+	ArenaVector<uint32_t> update_descriptor_sets{arena};
 
 	// Iterate over the shader sets to check if they have already been bound
 	// If they have, add the set so that the command buffer later updates it
@@ -533,7 +1717,7 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 		{
 			if (descriptor_set_layout_it->second->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle())
 			{
-				update_descriptor_sets.emplace(descriptor_set_id);
+				update_descriptor_sets.push_back(descriptor_set_id);
 			}
 		}
 	}
@@ -551,19 +1735,30 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 		}
 	}
 
+	if (get_device().uses_descriptor_buffers())
+	{
+		flush_descriptor_buffer_state(pipeline_bind_point);
+		return;
+	}
+
 	// Check if a descriptor set needs to be created
 	if (resource_binding_state.is_dirty() || !update_descriptor_sets.empty())
 	{
 		resource_binding_state.clear_dirty();
 
 		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+		auto &resource_sets = resource_binding_state.get_resource_sets();
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < to_u32(resource_sets.size()); ++descriptor_set_id)
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			auto &resource_set = resource_sets[descriptor_set_id];
+
+			if (resource_set.empty())
+			{
+				continue;
+			}
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
-			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
+			if (!resource_set.is_dirty() && std::find(update_descriptor_sets.begin(), update_descriptor_sets.end(), descriptor_set_id) == update_descriptor_sets.end())
 			{
 				continue;
 			}
@@ -582,101 +1777,108 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 			// Make descriptor set layout bound for current set
 			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
 
-			BindingMap<VkDescriptorBufferInfo> buffer_infos;
-			BindingMap<VkDescriptorImageInfo>  image_infos;
+			// Small per-draw sets are pushed, which skips the descriptor set cache
+			if (descriptor_set_layout.is_push_descriptor())
+			{
+				BindingMap<VkDescriptorBufferInfo> buffer_infos;
+				BindingMap<VkDescriptorImageInfo>  image_infos;
+				collect_descriptor_infos(descriptor_set_layout, resource_set, buffer_infos, image_infos);
+
+				ArenaVector<VkWriteDescriptorSet> write_descriptor_sets{arena};
+
+				for (auto &binding_it : buffer_infos)
+				{
+					for (auto &element_it : binding_it.second)
+					{
+						VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+						write_descriptor_set.dstBinding      = binding_it.first;
+						write_descriptor_set.dstArrayElement = element_it.first;
+						write_descriptor_set.descriptorCount = 1;
+						write_descriptor_set.descriptorType  = descriptor_set_layout.find_layout_binding(binding_it.first)->descriptorType;
+						write_descriptor_set.pBufferInfo     = &element_it.second;
+
+						write_descriptor_sets.push_back(write_descriptor_set);
+					}
+				}
+
+				for (auto &binding_it : image_infos)
+				{
+					for (auto &element_it : binding_it.second)
+					{
+						VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+						write_descriptor_set.dstBinding      = binding_it.first;
+						write_descriptor_set.dstArrayElement = element_it.first;
+						write_descriptor_set.descriptorCount = 1;
+						write_descriptor_set.descriptorType  = descriptor_set_layout.find_layout_binding(binding_it.first)->descriptorType;
+						write_descriptor_set.pImageInfo      = &element_it.second;
+
+						write_descriptor_sets.push_back(write_descriptor_set);
+					}
+				}
+
+				if (!write_descriptor_sets.empty())
+				{
+					vkCmdPushDescriptorSetKHR(get_handle(),
+					                          pipeline_bind_point,
+					                          pipeline_layout.get_handle(),
+					                          descriptor_set_id,
+					                          to_u32(write_descriptor_sets.size()),
+					                          write_descriptor_sets.data());
+				}
+
+				continue;
+			}
+
+			ArenaVector<uint32_t> dynamic_offsets{arena};
 
-			std::vector<uint32_t> dynamic_offsets;
+			// The hash of the set is kept up to date as resources are bound, it only needs to be walked if the descriptors
+			// differ from the resources, which also collects the dynamic offsets in binding order
+			size_t resources_hash = resource_set.get_hash();
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
+			if (descriptor_set_layout.has_dynamic_or_input_descriptors())
 			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				resources_hash = 0;
 
-				// Check if binding exists in the pipeline layout
-				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
+				for (auto &resource_binding : resource_set.get_resource_bindings())
 				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
+					auto  binding_info  = descriptor_set_layout.find_layout_binding(resource_binding.binding);
+					auto &resource_info = resource_binding.info;
+
+					size_t binding_hash = resource_binding.hash;
+
+					if (binding_info && resource_info.buffer != nullptr && is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+					{
+						dynamic_offsets.push_back(to_u32(resource_info.offset));
+
+						binding_hash = resource_binding.dynamic_hash;
+					}
+					else if (binding_info && resource_info.image_view != nullptr && binding_info->descriptorType == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT)
 					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
-
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
-
-						// Get buffer info
-						if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
-						{
-							VkDescriptorBufferInfo buffer_info{};
-
-							buffer_info.buffer = resource_info.buffer->get_handle();
-							buffer_info.offset = resource_info.offset;
-							buffer_info.range  = resource_info.range;
-
-							if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
-
-								buffer_info.offset = 0;
-							}
-
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
-
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
-						{
-							// Can be null for input attachments
-							VkDescriptorImageInfo image_info{};
-							image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
-							image_info.imageView = image_view->get_handle();
-
-							if (image_view != nullptr)
-							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
-								{
-									case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										break;
-									case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-										if (is_depth_format(image_view->get_format()))
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-										}
-										else
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										}
-										break;
-									case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-										break;
-
-									default:
-										continue;
-								}
-							}
-
-							image_infos[binding_index][array_element] = image_info;
-						}
+						hash_combine(binding_hash, get_input_attachment_layout(*resource_info.image_view));
 					}
 
-					assert((!update_after_bind ||
-					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
-					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+					resources_hash ^= binding_hash;
 				}
 			}
 
-			VkDescriptorSet descriptor_set_handle =
-			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
-			                                                            buffer_infos,
-			                                                            image_infos,
-			                                                            update_after_bind,
-			                                                            command_pool.get_thread_index());
+			hash_combine(resources_hash, descriptor_set_layout.get_handle());
+
+			auto render_frame = command_pool.get_render_frame();
+			auto thread_index = command_pool.get_thread_index();
+
+			// Sets with update after bind resources are requested every time, as their bindings are updated when requested
+			VkDescriptorSet descriptor_set_handle = update_after_bind ? VK_NULL_HANDLE : render_frame->find_descriptor_set(resources_hash, thread_index);
+
+			if (descriptor_set_handle == VK_NULL_HANDLE)
+			{
+				BindingMap<VkDescriptorBufferInfo> buffer_infos;
+				BindingMap<VkDescriptorImageInfo>  image_infos;
+				collect_descriptor_infos(descriptor_set_layout, resource_set, buffer_infos, image_infos);
+
+				descriptor_set_handle = update_after_bind ?
+				                            render_frame->request_descriptor_set(descriptor_set_layout, buffer_infos, image_infos, true, thread_index) :
+				                            render_frame->request_descriptor_set(resources_hash, descriptor_set_layout, buffer_infos, image_infos, thread_index);
+			}
 
 			// Bind descriptor set
 			vkCmdBindDescriptorSets(get_handle(),
@@ -690,6 +1892,313 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 	}
 }
 
+void CommandBuffer::collect_descriptor_infos(const DescriptorSetLayout &descriptor_set_layout, const ResourceSet &resource_set,
+                                             BindingMap<VkDescriptorBufferInfo> &buffer_infos, BindingMap<VkDescriptorImageInfo> &image_infos)
+{
+	// Iterate over all resource bindings
+	for (auto &resource_binding : resource_set.get_resource_bindings())
+	{
+		auto binding_index = resource_binding.binding;
+		auto array_element = resource_binding.array_element;
+
+		// Check if binding exists in the pipeline layout
+		auto binding_info = descriptor_set_layout.find_layout_binding(binding_index);
+		if (!binding_info)
+		{
+			continue;
+		}
+
+		auto &resource_info = resource_binding.info;
+
+		// Pointer references
+		auto &buffer     = resource_info.buffer;
+		auto &sampler    = resource_info.sampler;
+		auto &image_view = resource_info.image_view;
+
+		// Get buffer info
+		if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
+		{
+			VkDescriptorBufferInfo buffer_info{};
+
+			buffer_info.buffer = resource_info.buffer->get_handle();
+			buffer_info.offset = resource_info.offset;
+			buffer_info.range  = resource_info.range;
+
+			// The offset of dynamic buffers is bound with the set
+			if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+			{
+				buffer_info.offset = 0;
+			}
+
+			buffer_infos[binding_index][array_element] = buffer_info;
+		}
+
+		// Get image info
+		else if (image_view != nullptr || sampler != nullptr)
+		{
+			// Can be null for input attachments
+			VkDescriptorImageInfo image_info{};
+			image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
+			image_info.imageView = image_view->get_handle();
+
+			if (image_view != nullptr)
+			{
+				// Add image layout info based on descriptor type
+				switch (binding_info->descriptorType)
+				{
+					case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+						image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+						break;
+					case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+						image_info.imageLayout = get_input_attachment_layout(*image_view);
+						break;
+					case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+						image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+						break;
+
+					default:
+						continue;
+				}
+			}
+
+			image_infos[binding_index][array_element] = image_info;
+		}
+	}
+
+	assert(std::all_of(resource_set.get_resource_bindings().begin(), resource_set.get_resource_bindings().end(),
+	                   [&](const ResourceBinding &resource_binding) {
+		                   return !update_after_bind || !descriptor_set_layout.find_layout_binding(resource_binding.binding) ||
+		                          buffer_infos.count(resource_binding.binding) > 0 || image_infos.count(resource_binding.binding) > 0;
+	                   }) &&
+	       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+}
+
+void CommandBuffer::flush_descriptor_buffer_state(VkPipelineBindPoint pipeline_bind_point)
+{
+	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
+
+	VkDeviceSize alignment = get_device().get_descriptor_buffer_properties().descriptorBufferOffsetAlignment;
+
+	ArenaVector<uint32_t> sets_to_write{get_arena()};
+
+	// Collects the sets whose resources changed, or whose offset was not set for the layout of the bound pipeline
+	auto collect_sets_to_write = [&](bool all_sets) {
+		sets_to_write.clear();
+
+		VkDeviceSize size = 0;
+
+		auto &resource_sets = resource_binding_state.get_resource_sets();
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < to_u32(resource_sets.size()); ++descriptor_set_id)
+		{
+			auto &resource_set = resource_sets[descriptor_set_id];
+
+			if (resource_set.empty() || !pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+			{
+				continue;
+			}
+
+			auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
+
+			if (descriptor_set_layout.get_descriptor_buffer_size() == 0)
+			{
+				continue;
+			}
+
+			auto bound_layout_it = descriptor_set_layout_binding_state.find(descriptor_set_id);
+
+			if (!all_sets && !resource_set.is_dirty() && bound_layout_it != descriptor_set_layout_binding_state.end() &&
+			    bound_layout_it->second->get_handle() == descriptor_set_layout.get_handle())
+			{
+				continue;
+			}
+
+			sets_to_write.push_back(descriptor_set_id);
+			size += (descriptor_set_layout.get_descriptor_buffer_size() + alignment - 1) & ~(alignment - 1);
+		}
+
+		return size;
+	};
+
+	VkDeviceSize size = collect_sets_to_write(false);
+
+	resource_binding_state.clear_dirty();
+
+	if (sets_to_write.empty())
+	{
+		return;
+	}
+
+	auto *render_frame = command_pool.get_render_frame();
+	auto  allocation   = render_frame->allocate_buffer(RenderFrame::DESCRIPTOR_BUFFER_USAGE, size, command_pool.get_thread_index());
+
+	if (allocation.empty())
+	{
+		throw std::runtime_error("Cannot allocate descriptor buffer memory");
+	}
+
+	if (allocation.get_buffer().get_handle() != bound_descriptor_buffer)
+	{
+		// Binding another descriptor buffer invalidates the offsets of all sets, so all of them are written again
+		descriptor_set_layout_binding_state.clear();
+
+		VkDeviceSize all_sets_size = collect_sets_to_write(true);
+		if (all_sets_size != size)
+		{
+			allocation = render_frame->allocate_buffer(RenderFrame::DESCRIPTOR_BUFFER_USAGE, all_sets_size, command_pool.get_thread_index());
+
+			if (allocation.empty())
+			{
+				throw std::runtime_error("Cannot allocate descriptor buffer memory");
+			}
+		}
+
+		VkDescriptorBufferBindingInfoEXT binding_info{VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT};
+		binding_info.address = allocation.get_buffer().get_device_address();
+		binding_info.usage   = RenderFrame::DESCRIPTOR_BUFFER_USAGE;
+
+		vkCmdBindDescriptorBuffersEXT(get_handle(), 1, &binding_info);
+
+		bound_descriptor_buffer = allocation.get_buffer().get_handle();
+	}
+
+	uint8_t *data = allocation.map(allocation.get_size());
+
+	VkDeviceSize set_offset = 0;
+
+	for (auto descriptor_set_id : sets_to_write)
+	{
+		auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
+		auto &resource_set          = resource_binding_state.get_resource_sets().at(descriptor_set_id);
+
+		write_descriptor_buffer_set(descriptor_set_layout, resource_set, data + set_offset);
+
+		uint32_t     buffer_index = 0;
+		VkDeviceSize offset       = allocation.get_offset() + set_offset;
+
+		vkCmdSetDescriptorBufferOffsetsEXT(get_handle(),
+		                                   pipeline_bind_point,
+		                                   pipeline_layout.get_handle(),
+		                                   descriptor_set_id,
+		                                   1, &buffer_index,
+		                                   &offset);
+
+		resource_binding_state.clear_dirty(descriptor_set_id);
+		descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+
+		set_offset += (descriptor_set_layout.get_descriptor_buffer_size() + alignment - 1) & ~(alignment - 1);
+	}
+
+	allocation.flush();
+}
+
+void CommandBuffer::write_descriptor_buffer_set(const DescriptorSetLayout &descriptor_set_layout, const ResourceSet &resource_set, uint8_t *data)
+{
+	const auto &properties = get_device().get_descriptor_buffer_properties();
+
+	bool robust = get_device().get_gpu().get_requested_features().robustBufferAccess;
+
+	for (auto &resource_binding : resource_set.get_resource_bindings())
+	{
+		auto binding_index = resource_binding.binding;
+
+		auto binding_info = descriptor_set_layout.find_layout_binding(binding_index);
+		if (!binding_info)
+		{
+			continue;
+		}
+
+		size_t descriptor_size = 0;
+		switch (binding_info->descriptorType)
+		{
+			case VK_DESCRIPTOR_TYPE_SAMPLER:
+				descriptor_size = properties.samplerDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+				descriptor_size = properties.combinedImageSamplerDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+				descriptor_size = properties.sampledImageDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+				descriptor_size = properties.storageImageDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+				descriptor_size = properties.inputAttachmentDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+				descriptor_size = robust ? properties.robustUniformBufferDescriptorSize : properties.uniformBufferDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+				descriptor_size = robust ? properties.robustStorageBufferDescriptorSize : properties.storageBufferDescriptorSize;
+				break;
+			default:
+				continue;
+		}
+
+		uint8_t *binding_data = data + descriptor_set_layout.get_descriptor_buffer_offset(binding_index);
+
+		auto  array_element = resource_binding.array_element;
+		auto &resource_info = resource_binding.info;
+
+		VkDescriptorGetInfoEXT get_info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+		get_info.type = binding_info->descriptorType;
+
+		VkDescriptorAddressInfoEXT address_info{VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT};
+		VkDescriptorImageInfo      image_info{};
+
+		if (resource_info.buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
+		{
+			address_info.address = resource_info.buffer->get_device_address() + resource_info.offset;
+			address_info.range   = resource_info.range == VK_WHOLE_SIZE ? resource_info.buffer->get_size() - resource_info.offset : resource_info.range;
+
+			if (binding_info->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+			{
+				get_info.data.pUniformBuffer = &address_info;
+			}
+			else
+			{
+				get_info.data.pStorageBuffer = &address_info;
+			}
+		}
+		else if (resource_info.image_view != nullptr || resource_info.sampler != nullptr)
+		{
+			image_info.sampler   = resource_info.sampler ? resource_info.sampler->get_handle() : VK_NULL_HANDLE;
+			image_info.imageView = resource_info.image_view ? resource_info.image_view->get_handle() : VK_NULL_HANDLE;
+
+			switch (binding_info->descriptorType)
+			{
+				case VK_DESCRIPTOR_TYPE_SAMPLER:
+					get_info.data.pSampler = &image_info.sampler;
+					break;
+				case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+					image_info.imageLayout             = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+					get_info.data.pCombinedImageSampler = &image_info;
+					break;
+				case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+					image_info.imageLayout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+					get_info.data.pSampledImage = &image_info;
+					break;
+				case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+					image_info.imageLayout              = get_input_attachment_layout(*resource_info.image_view);
+					get_info.data.pInputAttachmentImage = &image_info;
+					break;
+				case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+					image_info.imageLayout      = VK_IMAGE_LAYOUT_GENERAL;
+					get_info.data.pStorageImage = &image_info;
+					break;
+				default:
+					continue;
+			}
+		}
+		else
+		{
+			continue;
+		}
+
+		vkGetDescriptorEXT(get_device().get_handle(), &get_info, descriptor_size, binding_data + array_element * descriptor_size);
+	}
+}
+
 void CommandBuffer::flush_push_constants()
 {
 	if (stored_push_constants.empty())
@@ -728,6 +2237,35 @@ const uint32_t CommandBuffer::get_current_subpass_index() const
 	return pipeline_state.get_subpass_index();
 }
 
+size_t CommandBuffer::hash_resource_bindings()
+{
+	size_t result = 0;
+
+	// The sets keep the hash of their resources up to date as they are bound
+	auto &resource_sets = resource_binding_state.get_resource_sets();
+	for (uint32_t set = 0; set < to_u32(resource_sets.size()); ++set)
+	{
+		if (!resource_sets[set].empty())
+		{
+			hash_combine(result, set);
+			hash_combine(result, resource_sets[set].get_hash());
+		}
+	}
+
+	return result;
+}
+
+VkImageLayout CommandBuffer::get_input_attachment_layout(const core::ImageView &image_view) const
+{
+	// Attachments read locally within dynamic rendering stay in the local read layout
+	if (!subpass_rendering_states.empty() && !subpass_rendering_states[0].color_attachment_locations.empty())
+	{
+		return VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR;
+	}
+
+	return is_depth_format(image_view.get_format()) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+}
+
 const bool CommandBuffer::is_render_size_optimal(const VkExtent2D &framebuffer_extent, const VkRect2D &render_area)
 {
 	auto render_area_granularity = current_render_pass.render_pass->get_render_area_granularity();
@@ -758,6 +2296,27 @@ void CommandBuffer::write_timestamp(VkPipelineStageFlagBits pipeline_stage,
 	vkCmdWriteTimestamp(get_handle(), pipeline_stage, query_pool.get_handle(), query);
 }
 
+void CommandBuffer::copy_query_pool_results(const QueryPool &query_pool, uint32_t first_query, uint32_t query_count,
+                                            const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize stride, VkQueryResultFlags flags)
+{
+	vkCmdCopyQueryPoolResults(get_handle(), query_pool.get_handle(), first_query, query_count, buffer.get_handle(), offset, stride, flags);
+}
+
+void CommandBuffer::begin_conditional_rendering(const core::Buffer &buffer, VkDeviceSize offset, VkConditionalRenderingFlagsEXT flags)
+{
+	VkConditionalRenderingBeginInfoEXT begin_info{VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT};
+	begin_info.buffer = buffer.get_handle();
+	begin_info.offset = offset;
+	begin_info.flags  = flags;
+
+	vkCmdBeginConditionalRenderingEXT(get_handle(), &begin_info);
+}
+
+void CommandBuffer::end_conditional_rendering()
+{
+	vkCmdEndConditionalRenderingEXT(get_handle());
+}
+
 VkResult CommandBuffer::reset(ResetMode reset_mode)
 {
 	VkResult result = VK_SUCCESS;
@@ -788,10 +2347,21 @@ RenderPass &CommandBuffer::get_render_pass(const vkb::RenderTarget &render_targe
 		subpass_info_it->depth_stencil_resolve_mode       = subpass->get_depth_stencil_resolve_mode();
 		subpass_info_it->depth_stencil_resolve_attachment = subpass->get_depth_stencil_resolve_attachment();
 		subpass_info_it->debug_name                       = subpass->get_debug_name();
+		subpass_info_it->view_mask                        = render_target.get_view_mask();
 
 		++subpass_info_it;
 	}
 
 	return get_device().get_resource_cache().request_render_pass(render_target.get_attachments(), load_store_infos, subpass_infos);
 }
+
+CommandPool &CommandBuffer::get_command_pool()
+{
+	return command_pool;
+}
+
+VkCommandBufferLevel CommandBuffer::get_level() const
+{
+	return level;
+}
 }        // namespace vkb
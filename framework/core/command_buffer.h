@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 
 #include "common/helpers.h"
@@ -27,6 +28,7 @@
 #include "core/query_pool.h"
 #include "core/sampler.h"
 #include "core/vulkan_resource.h"
+#include "rendering/frame_arena.h"
 #include "rendering/pipeline_state.h"
 #include "rendering/render_target.h"
 #include "resource_binding_state.h"
@@ -65,6 +67,9 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 		const RenderPass *render_pass;
 
 		const Framebuffer *framebuffer;
+
+		/// The extent of the render area, see RenderTarget::set_render_extent()
+		VkExtent2D render_area;
 	};
 
 	CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level);
@@ -82,8 +87,10 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 	/**
 	 * @brief Flushes the command buffer, pushing the new changes
 	 * @param pipeline_bind_point The type of pipeline we want to flush
+	 * @return False if nothing should be recorded, as the pipeline is not compiled yet and has no fallback,
+	 *         see PipelineCompileMode::Async
 	 */
-	void flush(VkPipelineBindPoint pipeline_bind_point);
+	bool flush(VkPipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Sets the command buffer so that it is ready for recording
@@ -101,21 +108,38 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 	 *        render pass and framebuffer as well as subpass index must be provided
 	 * @param flags Usage behavior for the command buffer
 	 * @param render_pass
-	 * @param framebuffer
+	 * @param framebuffer May be null for a secondary command buffer, which can then be executed in any framebuffer of the render pass
 	 * @param subpass_index
 	 * @return Whether it succeeded or not
 	 */
 	VkResult begin(VkCommandBufferUsageFlags flags, const RenderPass *render_pass, const Framebuffer *framebuffer, uint32_t subpass_index);
 
+	/**
+	 * @brief Begins a secondary command buffer continuing the current subpass of a primary command buffer
+	 *        On top of begin(), this carries over the state Vulkan does not inherit: the resource bindings
+	 *        and push constants recorded on the primary in this subpass, and a viewport and scissor
+	 *        covering the framebuffer.
+	 * @param primary_cmd_buf The primary command buffer recording the render pass
+	 * @param flags Usage behavior for the command buffer, render pass continue is always added
+	 * @return Whether it succeeded or not
+	 */
+	VkResult continue_render_pass(CommandBuffer &primary_cmd_buf, VkCommandBufferUsageFlags flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
 	VkResult end();
 
 	void clear(VkClearAttachment info, VkClearRect rect);
 
+	/**
+	 * @brief Begins a render pass for the subpasses
+	 *        If the device uses dynamic rendering, a render pass recorded inline is begun with dynamic rendering instead,
+	 *        if it has a single subpass without input attachments or if the device also uses dynamic rendering local read.
+	 *        Draws of a single subpass without input attachments bind shader objects if the device uses them.
+	 */
 	void begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values, const std::vector<std::unique_ptr<Subpass>> &subpasses, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
 	void begin_render_pass(const RenderTarget &render_target, const RenderPass &render_pass, const Framebuffer &framebuffer, const std::vector<VkClearValue> &clear_values, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
-	void next_subpass();
+	void next_subpass(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
 	void execute_commands(CommandBuffer &secondary_command_buffer);
 
@@ -125,6 +149,38 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	void bind_pipeline_layout(PipelineLayout &pipeline_layout);
 
+	/**
+	 * @brief Starts recording in immediate mode, where pipelines, descriptor sets and push constants are bound as
+	 *        handles created up front, e.g. requested once from the resource cache, instead of being tracked
+	 *        Draws and dispatches skip the flush of the tracked state, so they cost no more than the raw Vulkan calls.
+	 *        Dynamic state, vertex and index buffers and barriers are recorded as usual.
+	 */
+	void begin_immediate();
+
+	/**
+	 * @brief Returns to tracked recording
+	 *        The tracked state is reset as when a render pass begins, so the pipeline state and resources must be set again.
+	 */
+	void end_immediate();
+
+	bool is_immediate() const;
+
+	/**
+	 * @brief Binds a pipeline in immediate mode, see begin_immediate()
+	 */
+	void bind_pipeline(VkPipelineBindPoint pipeline_bind_point, const Pipeline &pipeline);
+
+	/**
+	 * @brief Binds a descriptor set in immediate mode, see begin_immediate()
+	 */
+	void bind_descriptor_set(VkPipelineBindPoint pipeline_bind_point, const PipelineLayout &pipeline_layout, uint32_t set,
+	                         const DescriptorSet &descriptor_set, const std::vector<uint32_t> &dynamic_offsets = {});
+
+	/**
+	 * @brief Records push constants in immediate mode, see begin_immediate()
+	 */
+	void push_constants(const PipelineLayout &pipeline_layout, VkShaderStageFlags shader_stages, uint32_t offset, const uint8_t *data, uint32_t size);
+
 	template <class T>
 	void set_specialization_constant(uint32_t constant_id, const T &data);
 
@@ -136,20 +192,15 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 	 */
 	void push_constants(const std::vector<uint8_t> &values);
 
+	/**
+	 * @brief Records size bytes of data to be pushed as push constants, without an intermediate copy
+	 */
+	void push_constants(const uint8_t *data, size_t size);
+
 	template <typename T>
 	void push_constants(const T &value)
 	{
-		auto data = to_bytes(value);
-
-		uint32_t size = to_u32(stored_push_constants.size() + data.size());
-
-		if (size > max_push_constants_size)
-		{
-			LOGE("Push constant limit exceeded ({} / {} bytes)", size, max_push_constants_size);
-			throw std::runtime_error("Cannot overflow push constant limit");
-		}
-
-		stored_push_constants.insert(stored_push_constants.end(), data.begin(), data.end());
+		push_constants(reinterpret_cast<const uint8_t *>(&value), sizeof(T));
 	}
 
 	void bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
@@ -192,18 +243,35 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	void set_depth_bounds(float min_depth_bounds, float max_depth_bounds);
 
+	/**
+	 * @brief Sets the size of the fragments shaded by a single invocation of the fragment shader, for the following draws
+	 *        Command buffers begin at the full rate of 1x1, secondary ones continuing a render pass take the rate of the primary.
+	 *        Does nothing unless Device::uses_fragment_shading_rates() and the queue family supports graphics,
+	 *        an unsupported rate is clamped to a supported one.
+	 */
+	void set_fragment_shading_rate(const VkExtent2D &rate);
+
+	const VkExtent2D &get_fragment_shading_rate() const;
+
 	void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance);
 
 	void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance);
 
 	void draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride);
 
+	/**
+	 * @brief Records a mesh shader draw, requires Device::uses_mesh_shaders() and a pipeline layout with a task or mesh stage
+	 */
+	void draw_mesh_tasks(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
+
 	void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
 
 	void dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset);
 
 	void update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data);
 
+	void update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, size_t size);
+
 	void blit_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageBlit> &regions);
 
 	void resolve_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageResolve> &regions);
@@ -216,10 +284,64 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	void copy_image_to_buffer(const core::Image &image, VkImageLayout image_layout, const core::Buffer &buffer, const std::vector<VkBufferImageCopy> &regions);
 
-	void image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier) const;
+	/**
+	 * @brief Records an image barrier, or adds it to the open barrier batch
+	 */
+	void image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
 
+	/**
+	 * @brief Records a buffer barrier, or adds it to the open barrier batch
+	 */
 	void buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
 
+	/**
+	 * @brief Opens a barrier batch, the barriers requested until flush_barriers() are recorded together
+	 *        With Device::uses_synchronization2() the batch is recorded as one vkCmdPipelineBarrier2 keeping the stages
+	 *        of every barrier, otherwise as one vkCmdPipelineBarrier with the stages of all barriers combined.
+	 */
+	void begin_barrier_batch();
+
+	/**
+	 * @brief Records the barriers of the open batch, and closes it
+	 */
+	void flush_barriers();
+
+	/**
+	 * @brief Transitions the subresources of an image view for their next use, from the state tracked by core::Image
+	 *        The barrier is deferred, and recorded with the other pending ones before the next render pass, dispatch or transfer command.
+	 *        Subresources already in the layout that were read by the same stages since their last write need no barrier and are skipped.
+	 *        Must be called outside of a render pass.
+	 * @param image_view The view of the subresources to transition
+	 * @param new_layout The layout of the next use
+	 * @param dst_stage_mask The stages of the next use
+	 * @param dst_access_mask The accesses of the next use
+	 */
+	void image_transition(const core::ImageView &image_view, VkImageLayout new_layout, VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask);
+
+	/**
+	 * @brief Synchronizes a whole buffer for its next use, from the state tracked by core::Buffer, see image_transition()
+	 */
+	void buffer_transition(const core::Buffer &buffer, VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask);
+
+	/**
+	 * @brief Records the release half of a queue family ownership transfer, on a command buffer of the old queue family
+	 *        The acquire half is recorded with the same barrier by acquire_ownership(), on a command buffer of the new queue family
+	 *        submitted after this one, e.g. with RenderContext::submit_chained(). The destination stages and accesses of the barrier
+	 *        only apply to the acquire half. Nothing is recorded if the barrier does not change the queue family.
+	 */
+	void release_ownership(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
+
+	/**
+	 * @brief Records the acquire half of a queue family ownership transfer, see release_ownership()
+	 *        The source stages and accesses of the barrier only apply to the release half, unless the barrier does not change
+	 *        the queue family, in which case it is recorded as a whole, so that the same code works whichever queues are used.
+	 */
+	void acquire_ownership(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
+
+	void release_ownership(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
+
+	void acquire_ownership(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
+
 	void set_update_after_bind(bool update_after_bind_);
 
 	void reset_query_pool(const QueryPool &query_pool, uint32_t first_query, uint32_t query_count);
@@ -230,6 +352,20 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	void write_timestamp(VkPipelineStageFlagBits pipeline_stage, const QueryPool &query_pool, uint32_t query);
 
+	/**
+	 * @brief Copies the results of queries to a buffer, outside of a render pass
+	 */
+	void copy_query_pool_results(const QueryPool &query_pool, uint32_t first_query, uint32_t query_count,
+	                             const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize stride, VkQueryResultFlags flags);
+
+	/**
+	 * @brief Discards the draws recorded until end_conditional_rendering() if the 32-bit value at offset in buffer is zero,
+	 *        requires VK_EXT_conditional_rendering. State bound in between is kept either way.
+	 */
+	void begin_conditional_rendering(const core::Buffer &buffer, VkDeviceSize offset, VkConditionalRenderingFlagsEXT flags = 0);
+
+	void end_conditional_rendering();
+
 	/**
 	 * @brief Reset the command buffer to a state where it can be recorded to
 	 * @param reset_mode How to reset the buffer, should match the one used by the pool to allocate it
@@ -238,6 +374,29 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	RenderPass &get_render_pass(const vkb::RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<std::unique_ptr<Subpass>> &subpasses);
 
+	CommandPool &get_command_pool();
+
+	VkCommandBufferLevel get_level() const;
+
+	/**
+	 * @return The render pass and framebuffer of the current render pass, null outside of one or in a dynamic rendering pass
+	 */
+	const RenderPassBinding &get_current_render_pass() const;
+
+	const uint32_t get_current_subpass_index() const;
+
+	/**
+	 * @return A hash of the resources bound, which secondary command buffers continuing the render pass inherit
+	 *         It does not depend on the order the resources were bound in.
+	 */
+	size_t hash_resource_bindings();
+
+	/**
+	 * @brief Returns the number of pipeline binds skipped since the last call, and resets it
+	 *        A bind is skipped when a changed pipeline state resolves to the pipeline already bound.
+	 */
+	static uint32_t take_skipped_pipeline_bind_count();
+
 	const VkCommandBufferLevel level;
 
   private:
@@ -263,9 +422,45 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_binding_state;
 
-	const RenderPassBinding &get_current_render_pass() const;
+	/// The descriptor buffer the set offsets refer to, if Device::uses_descriptor_buffers()
+	VkBuffer bound_descriptor_buffer{VK_NULL_HANDLE};
 
-	const uint32_t get_current_subpass_index() const;
+	VkPipeline bound_graphics_pipeline{VK_NULL_HANDLE};
+
+	VkPipeline bound_compute_pipeline{VK_NULL_HANDLE};
+
+	/// Whether pipelines and descriptor sets are bound directly, see begin_immediate()
+	bool immediate_mode{false};
+
+	/// Whether the current render pass uses dynamic rendering and shader objects, see begin_render_pass()
+	bool shader_object_pass{false};
+
+	/// The subpasses of the current dynamic rendering pass, empty if it is a render pass, see begin_rendering()
+	std::vector<const Subpass *> rendering_subpasses;
+
+	/// The attachments pipelines are created for in each subpass of the current dynamic rendering pass
+	std::vector<RenderingState> subpass_rendering_states;
+
+	/// Whether barriers are batched, see begin_barrier_batch()
+	bool barrier_batch_open{false};
+
+	std::vector<VkImageMemoryBarrier2KHR> pending_image_barriers;
+
+	std::vector<VkBufferMemoryBarrier2KHR> pending_buffer_barriers;
+
+	/// See set_fragment_shading_rate()
+	VkExtent2D fragment_shading_rate{1, 1};
+
+	/// Arena for the temporaries of command buffers without a render frame, reset when recording begins, see get_arena()
+	FrameArena scratch_arena;
+
+	/// Counted over all command buffers, as they may be recorded from several threads
+	static std::atomic<uint32_t> skipped_pipeline_bind_count;
+
+	/**
+	 * @return The arena of the render frame for the thread of the command pool, or the scratch arena without a render frame
+	 */
+	FrameArena &get_arena();
 
 	/**
 	 * @brief Check that the render area is an optimal size by comparing to the render area granularity
@@ -274,14 +469,72 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	/**
 	 * @brief Flush the pipeline state
+	 * @return False if no pipeline could be bound, see flush()
+	 */
+	bool flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point);
+
+	/**
+	 * @brief Sets the groups of graphics pipeline state which are dynamic, see PipelineState::get_dynamic_state_flags()
+	 */
+	void flush_dynamic_pipeline_state(DynamicPipelineStateFlags dynamic_state_flags);
+
+	/**
+	 * @brief Binds the shader objects of the pipeline layout, and sets all of the pipeline state dynamically
+	 */
+	void flush_shader_object_state();
+
+	/**
+	 * @brief Begins dynamic rendering to the attachments of the subpasses, in place of a render pass
+	 *        Subpasses after the first one, and input attachments, are recorded with dynamic rendering local read:
+	 *        the color attachments are all those written or read by a subpass, remapped to the outputs and inputs
+	 *        of each subpass, and next_subpass() records a by region barrier instead of a subpass dependency.
+	 */
+	void begin_rendering(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos,
+	                     const std::vector<VkClearValue> &clear_values, const std::vector<std::unique_ptr<Subpass>> &subpasses);
+
+	/**
+	 * @brief Sets the rendering state of a subpass of the current dynamic rendering pass, see begin_rendering()
+	 */
+	void set_rendering_subpass(uint32_t subpass_index);
+
+	/**
+	 * @return The layout an input attachment is read in, in the current render pass
+	 */
+	VkImageLayout get_input_attachment_layout(const core::ImageView &image_view) const;
+
+	/**
+	 * @brief Records the pending barriers, see begin_barrier_batch()
 	 */
-	void flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point);
+	void record_pending_barriers();
+
+	/**
+	 * @brief Converts a legacy stage mask, on the side of the barrier where the stage has no effect it becomes none
+	 */
+	static VkPipelineStageFlags2KHR to_stage_flags2(VkPipelineStageFlags stage_mask, VkPipelineStageFlagBits no_op_stage);
 
 	/**
 	 * @brief Flush the descriptor set state
 	 */
 	void flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point);
 
+	/**
+	 * @brief Flush the descriptor set state to the descriptor buffer of the render frame
+	 *        Sets are written when their resources change, and bound by offset
+	 */
+	void flush_descriptor_buffer_state(VkPipelineBindPoint pipeline_bind_point);
+
+	/**
+	 * @brief Builds the infos a descriptor set is written with from the resources of a set, laid out as the descriptor set layout
+	 */
+	void collect_descriptor_infos(const DescriptorSetLayout &descriptor_set_layout, const ResourceSet &resource_set,
+	                              BindingMap<VkDescriptorBufferInfo> &buffer_infos, BindingMap<VkDescriptorImageInfo> &image_infos);
+
+	/**
+	 * @brief Writes the descriptors of a resource set, laid out as the descriptor set layout
+	 * @param data Start of the set in the descriptor buffer
+	 */
+	void write_descriptor_buffer_set(const DescriptorSetLayout &descriptor_set_layout, const ResourceSet &resource_set, uint8_t *data);
+
 	/**
 	 * @brief Flush the push constant state
 	 */
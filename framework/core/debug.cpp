@@ -1,4 +1,4 @@
-/* Copyright (c) 2021, Arm Limited and Contributors
+/* Copyright (c) 2021-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -19,7 +19,11 @@
 
 #include "core/command_buffer.h"
 #include "core/device.h"
+#include "core/util/logging.hpp"
+#include "rendering/gpu_profiler.h"
 
+#include <algorithm>
+#include <cstring>
 #include <glm/gtc/type_ptr.hpp>
 #include <unordered_map>
 
@@ -177,6 +181,46 @@ void DebugMarkerExtDebugUtils::cmd_insert_label(VkCommandBuffer command_buffer,
 	vkCmdDebugMarkerInsertEXT(command_buffer, &marker_info);
 }
 
+bool is_debug_tool_active(VkPhysicalDevice gpu)
+{
+	uint32_t extension_count = 0;
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extension_count, nullptr));
+
+	std::vector<VkExtensionProperties> extensions(extension_count);
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extension_count, extensions.data()));
+
+	bool tooling_info = std::any_of(extensions.begin(), extensions.end(), [](const VkExtensionProperties &extension) {
+		return std::strcmp(extension.extensionName, VK_EXT_TOOLING_INFO_EXTENSION_NAME) == 0;
+	});
+
+	if (!tooling_info || !vkGetPhysicalDeviceToolPropertiesEXT)
+	{
+		return true;
+	}
+
+	uint32_t tool_count = 0;
+	VK_CHECK(vkGetPhysicalDeviceToolPropertiesEXT(gpu, &tool_count, nullptr));
+
+	std::vector<VkPhysicalDeviceToolPropertiesEXT> tools(tool_count, {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TOOL_PROPERTIES_EXT});
+	VK_CHECK(vkGetPhysicalDeviceToolPropertiesEXT(gpu, &tool_count, tools.data()));
+
+	// Capture tools report tracing, profilers report profiling, and the validation layers name objects in their messages
+	const VkToolPurposeFlagsEXT label_purposes = VK_TOOL_PURPOSE_DEBUG_MARKERS_BIT_EXT | VK_TOOL_PURPOSE_TRACING_BIT_EXT |
+	                                             VK_TOOL_PURPOSE_PROFILING_BIT_EXT | VK_TOOL_PURPOSE_VALIDATION_BIT_EXT |
+	                                             VK_TOOL_PURPOSE_DEBUG_REPORTING_BIT_EXT;
+
+	for (uint32_t i = 0; i < tool_count; ++i)
+	{
+		if (tools[i].purposes & label_purposes)
+		{
+			LOGI("Debugging tool active: {} {}", tools[i].name, tools[i].version);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 ScopedDebugLabel::ScopedDebugLabel(const DebugUtils &debug_utils, VkCommandBuffer command_buffer,
                                    const char *name, glm::vec4 color) :
     debug_utils{&debug_utils},
@@ -187,7 +231,9 @@ ScopedDebugLabel::ScopedDebugLabel(const DebugUtils &debug_utils, VkCommandBuffe
 		assert(command_buffer != VK_NULL_HANDLE);
 		this->command_buffer = command_buffer;
 
+#ifdef VKB_VULKAN_DEBUG
 		debug_utils.cmd_begin_label(command_buffer, name, color);
+#endif
 	}
 }
 
@@ -195,14 +241,27 @@ ScopedDebugLabel::ScopedDebugLabel(const CommandBuffer &command_buffer,
                                    const char *name, glm::vec4 color) :
     ScopedDebugLabel{command_buffer.get_device().get_debug_utils(), command_buffer.get_handle(), name, color}
 {
+	auto *profiler = command_buffer.get_device().get_gpu_profiler();
+
+	if (profiler && this->command_buffer != VK_NULL_HANDLE && profiler->begin_scope(this->command_buffer, name, command_buffer.get_level()))
+	{
+		gpu_profiler = profiler;
+	}
 }
 
 ScopedDebugLabel::~ScopedDebugLabel()
 {
+	if (gpu_profiler)
+	{
+		gpu_profiler->end_scope(command_buffer);
+	}
+
+#ifdef VKB_VULKAN_DEBUG
 	if (command_buffer != VK_NULL_HANDLE)
 	{
 		debug_utils->cmd_end_label(command_buffer);
 	}
+#endif
 }
 
 }        // namespace vkb
\ No newline at end of file
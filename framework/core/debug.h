@@ -1,4 +1,4 @@
-/* Copyright (c) 2021, Arm Limited and Contributors
+/* Copyright (c) 2021-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -135,12 +135,23 @@ class DummyDebugUtils final : public DebugUtils
 };
 
 class CommandBuffer;
+class GpuProfiler;
+
+/**
+ * @brief Checks whether a tool reading debug labels and object names is active on a physical device, such as RenderDoc or
+ *        the validation layers, as reported by VK_EXT_tooling_info. If the device does not support the extension, tools
+ *        cannot be detected and are assumed to be active.
+ */
+bool is_debug_tool_active(VkPhysicalDevice gpu);
 
 /**
  * @brief A RAII debug label.
  *        If any of EXT_debug_utils or EXT_debug_marker is available, this:
  *        - Begins a debug label / marker on construction
  *        - Ends it on destruction
+ *        Labels on a CommandBuffer are also measured by the GPU profiler of its device, if any.
+ *        Without VKB_VULKAN_DEBUG the labels are compiled out, and only the GPU profiler scopes remain.
+ *        The name is not copied, it must outlive the scope, as an example the name of the object drawn.
  */
 class ScopedDebugLabel final
 {
@@ -156,6 +167,9 @@ class ScopedDebugLabel final
   private:
 	const DebugUtils *debug_utils;
 	VkCommandBuffer   command_buffer;
+
+	/// The profiler measuring the scope, if any, see Device::set_gpu_profiler
+	GpuProfiler *gpu_profiler{nullptr};
 };
 
 }        // namespace vkb
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -22,6 +22,8 @@
 
 namespace vkb
 {
+std::atomic<uint32_t> DescriptorPool::growth_count{0};
+
 DescriptorPool::DescriptorPool(Device &                   device,
                                const DescriptorSetLayout &descriptor_set_layout,
                                uint32_t                   pool_size) :
@@ -43,12 +45,12 @@ DescriptorPool::DescriptorPool(Device &                   device,
 
 	auto pool_size_it = pool_sizes.begin();
 
-	// Fill pool size for each descriptor type count multiplied by the pool size
+	// Fill pool size for each descriptor type count of one set
 	for (auto &it : descriptor_type_counts)
 	{
 		pool_size_it->type = it.first;
 
-		pool_size_it->descriptorCount = it.second * pool_size;
+		pool_size_it->descriptorCount = it.second;
 
 		++pool_size_it;
 	}
@@ -67,18 +69,42 @@ DescriptorPool::~DescriptorPool()
 
 void DescriptorPool::reset()
 {
+	// Clear internal tracking of descriptor set allocations
+	set_pool_mapping.clear();
+	free_sets.clear();
+	available_pools.clear();
+
+	if (pools.size() > 1)
+	{
+		// Merge the pools into one holding all their sets, no set is allocated from them anymore
+		uint32_t max_sets = 0;
+		for (size_t i = 0; i < pools.size(); ++i)
+		{
+			vkDestroyDescriptorPool(device.get_handle(), pools[i], nullptr);
+			max_sets += pool_capacities[i];
+		}
+
+		pools.clear();
+		pool_capacities.clear();
+		pool_sets_count.clear();
+
+		create_pool(std::min(max_sets, std::max(MAX_SETS_PER_GROWN_POOL, pool_max_sets)));
+
+		return;
+	}
+
 	// Reset all descriptor pools
 	for (auto pool : pools)
 	{
 		vkResetDescriptorPool(device.get_handle(), pool, 0);
 	}
 
-	// Clear internal tracking of descriptor set allocations
 	std::fill(pool_sets_count.begin(), pool_sets_count.end(), 0);
-	set_pool_mapping.clear();
 
-	// Reset the pool index from which descriptor sets are allocated
-	pool_index = 0;
+	for (uint32_t i = 0; i < to_u32(pools.size()); ++i)
+	{
+		available_pools.push_back(i);
+	}
 }
 
 const DescriptorSetLayout &DescriptorPool::get_descriptor_set_layout() const
@@ -94,7 +120,14 @@ void DescriptorPool::set_descriptor_set_layout(const DescriptorSetLayout &set_la
 
 VkDescriptorSet DescriptorPool::allocate()
 {
-	pool_index = find_available_pool(pool_index);
+	if (!free_sets.empty())
+	{
+		VkDescriptorSet handle = free_sets.back();
+		free_sets.pop_back();
+		return handle;
+	}
+
+	uint32_t pool_index = find_available_pool();
 
 	// Increment allocated set count for the current pool
 	++pool_sets_count[pool_index];
@@ -122,6 +155,12 @@ VkDescriptorSet DescriptorPool::allocate()
 	// Store mapping between the descriptor set and the pool
 	set_pool_mapping.emplace(handle, pool_index);
 
+	// The pool is at the back of the available ones, remove it once full
+	if (pool_sets_count[pool_index] == pool_capacities[pool_index])
+	{
+		available_pools.pop_back();
+	}
+
 	return handle;
 }
 
@@ -143,63 +182,93 @@ VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
 	// Remove descriptor set mapping to the pool
 	set_pool_mapping.erase(it);
 
+	// A full pool has room for a set again, allocate from it next
+	if (pool_sets_count[desc_pool_index] == pool_capacities[desc_pool_index])
+	{
+		available_pools.push_back(desc_pool_index);
+	}
+
 	// Decrement allocated set count for the pool
 	--pool_sets_count[desc_pool_index];
 
-	// Change the current pool index to use the available pool
-	pool_index = desc_pool_index;
-
 	return VK_SUCCESS;
 }
 
-std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
+void DescriptorPool::release(VkDescriptorSet descriptor_set)
+{
+	assert(set_pool_mapping.count(descriptor_set) > 0 && "Descriptor set was not allocated from this pool");
+	free_sets.push_back(descriptor_set);
+}
+
+uint32_t DescriptorPool::take_growth_count()
+{
+	return growth_count.exchange(0, std::memory_order_relaxed);
+}
+
+uint32_t DescriptorPool::find_available_pool()
 {
-	// Create a new pool
-	if (pools.size() <= search_index)
+	if (available_pools.empty())
 	{
-		VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+		// Each new pool holds twice as many sets as the previous one
+		uint32_t max_sets = pool_capacities.empty() ? pool_max_sets : std::max(std::min(pool_capacities.back() * 2, MAX_SETS_PER_GROWN_POOL), pool_max_sets);
 
-		create_info.poolSizeCount = to_u32(pool_sizes.size());
-		create_info.pPoolSizes    = pool_sizes.data();
-		create_info.maxSets       = pool_max_sets;
+		create_pool(max_sets);
+	}
 
-		// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
-		create_info.flags = 0;
+	return available_pools.back();
+}
 
-		// Check descriptor set layout and enable the required flags
-		auto &binding_flags = descriptor_set_layout->get_binding_flags();
-		for (auto binding_flag : binding_flags)
-		{
-			if (binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT)
-			{
-				create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
-			}
-		}
+uint32_t DescriptorPool::create_pool(uint32_t max_sets)
+{
+	std::vector<VkDescriptorPoolSize> scaled_pool_sizes = pool_sizes;
+	for (auto &pool_size : scaled_pool_sizes)
+	{
+		pool_size.descriptorCount *= max_sets;
+	}
+
+	VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
 
-		VkDescriptorPool handle = VK_NULL_HANDLE;
+	create_info.poolSizeCount = to_u32(scaled_pool_sizes.size());
+	create_info.pPoolSizes    = scaled_pool_sizes.data();
+	create_info.maxSets       = max_sets;
 
-		// Create the Vulkan descriptor pool
-		auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+	// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
+	create_info.flags = 0;
 
-		if (result != VK_SUCCESS)
+	// Check descriptor set layout and enable the required flags
+	auto &binding_flags = descriptor_set_layout->get_binding_flags();
+	for (auto binding_flag : binding_flags)
+	{
+		if (binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT)
 		{
-			return 0;
+			create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
 		}
+	}
 
-		// Store internally the Vulkan handle
-		pools.push_back(handle);
+	VkDescriptorPool handle = VK_NULL_HANDLE;
 
-		// Add set count for the descriptor pool
-		pool_sets_count.push_back(0);
+	// Create the Vulkan descriptor pool
+	auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
 
-		return search_index;
-	}
-	else if (pool_sets_count[search_index] < pool_max_sets)
+	if (result != VK_SUCCESS)
 	{
-		return search_index;
+		throw VulkanException{result, "Cannot create descriptor pool"};
 	}
 
-	// Increment pool index
-	return find_available_pool(++search_index);
+	growth_count.fetch_add(1, std::memory_order_relaxed);
+
+	// Store internally the Vulkan handle
+	pools.push_back(handle);
+
+	pool_capacities.push_back(max_sets);
+
+	// Add set count for the descriptor pool
+	pool_sets_count.push_back(0);
+
+	uint32_t index = to_u32(pools.size() - 1);
+
+	available_pools.push_back(index);
+
+	return index;
 }
 }        // namespace vkb
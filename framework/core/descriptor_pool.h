@@ -1,4 +1,4 @@
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 
 #include "common/helpers.h"
@@ -28,13 +29,21 @@ class Device;
 class DescriptorSetLayout;
 
 /**
- * @brief Manages an array of fixed size VkDescriptorPool and is able to allocate descriptor sets
+ * @brief Manages an array of VkDescriptorPool and is able to allocate descriptor sets
+ *
+ * The first VkDescriptorPool holds pool_size sets, and each one created when the others are full holds twice as many
+ * as the previous one, up to MAX_SETS_PER_GROWN_POOL. Pools with room for more sets are kept on a stack, so finding
+ * one does not depend on the number of pools. When the pool is reset, the VkDescriptorPools are merged into one
+ * holding all their sets, so that a layout used for many sets ends up allocating them from a single VkDescriptorPool.
  */
 class DescriptorPool
 {
   public:
 	static const uint32_t MAX_SETS_PER_POOL = 16;
 
+	/// The number of sets past which VkDescriptorPools stop growing
+	static constexpr uint32_t MAX_SETS_PER_GROWN_POOL = 1024;
+
 	DescriptorPool(Device &                   device,
 	               const DescriptorSetLayout &descriptor_set_layout,
 	               uint32_t                   pool_size = MAX_SETS_PER_POOL);
@@ -59,30 +68,55 @@ class DescriptorPool
 
 	VkResult free(VkDescriptorSet descriptor_set);
 
+	/**
+	 * @brief Returns a descriptor set to the pool, to be handed out again by allocate()
+	 *        Unlike free(), the set stays allocated from its VkDescriptorPool, so the caller
+	 *        must make sure the GPU no longer uses it.
+	 */
+	void release(VkDescriptorSet descriptor_set);
+
+	/**
+	 * @brief Returns the number of VkDescriptorPools created by all pools since the last call, and resets it
+	 *        Pools grow while the number of sets increases, a steady frame creates none.
+	 */
+	static uint32_t take_growth_count();
+
   private:
 	Device &device;
 
 	const DescriptorSetLayout *descriptor_set_layout{nullptr};
 
-	// Descriptor pool size
+	// Descriptor pool size of one set, scaled by the number of sets of each pool
 	std::vector<VkDescriptorPoolSize> pool_sizes;
 
-	// Number of sets to allocate for each pool
+	// Number of sets to allocate for the first pool
 	uint32_t pool_max_sets{0};
 
 	// Total descriptor pools created
 	std::vector<VkDescriptorPool> pools;
 
+	// Number of sets of each pool
+	std::vector<uint32_t> pool_capacities;
+
 	// Count sets for each pool
 	std::vector<uint32_t> pool_sets_count;
 
-	// Current pool index to allocate descriptor set
-	uint32_t pool_index{0};
+	// Indices of the pools with room for more sets, the one to allocate from at the back
+	std::vector<uint32_t> available_pools;
 
 	// Map between descriptor set and pool index
 	std::unordered_map<VkDescriptorSet, uint32_t> set_pool_mapping;
 
-	// Find next pool index or create new pool
-	uint32_t find_available_pool(uint32_t pool_index);
+	// Released descriptor sets, reused before allocating new ones
+	std::vector<VkDescriptorSet> free_sets;
+
+	/// Counted over all pools, as they may be used from several threads
+	static std::atomic<uint32_t> growth_count;
+
+	// Find a pool with room for a set or create a new pool
+	uint32_t find_available_pool();
+
+	// Create a pool of the given number of sets, and return its index
+	uint32_t create_pool(uint32_t max_sets);
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -147,6 +147,20 @@ void DescriptorSet::prepare()
 			LOGE("Shader layout set does not use image binding at #{}", binding_index);
 		}
 	}
+
+	// Array elements are unique per binding, so writing as many descriptors as the layout has in bounds writes all of them
+	uses_update_template = descriptor_set_layout.get_update_template() != VK_NULL_HANDLE &&
+	                       write_descriptor_sets.size() == descriptor_set_layout.get_descriptor_count() &&
+	                       std::all_of(write_descriptor_sets.begin(), write_descriptor_sets.end(), [this](const VkWriteDescriptorSet &write_descriptor_set) {
+		                       auto binding_info = descriptor_set_layout.find_layout_binding(write_descriptor_set.dstBinding);
+		                       return write_descriptor_set.dstArrayElement < binding_info->descriptorCount &&
+		                              (write_descriptor_set.pBufferInfo != nullptr) == is_buffer_descriptor_type(binding_info->descriptorType);
+	                       });
+
+	if (uses_update_template)
+	{
+		template_infos.resize(write_descriptor_sets.size());
+	}
 }
 
 void DescriptorSet::update(const std::vector<uint32_t> &bindings_to_update)
@@ -196,8 +210,13 @@ void DescriptorSet::update(const std::vector<uint32_t> &bindings_to_update)
 		}
 	}
 
-	// Perform the Vulkan call to update the DescriptorSet by executing the write operations
-	if (!write_operations.empty())
+	// Perform the Vulkan call to update the DescriptorSet by executing the write operations,
+	// through the update template of the layout if they write the whole set
+	if (uses_update_template && write_operations.size() == write_descriptor_sets.size())
+	{
+		write_with_template();
+	}
+	else if (!write_operations.empty())
 	{
 		vkUpdateDescriptorSets(device.get_handle(),
 		                       to_u32(write_operations.size()),
@@ -216,6 +235,12 @@ void DescriptorSet::update(const std::vector<uint32_t> &bindings_to_update)
 
 void DescriptorSet::apply_writes() const
 {
+	if (uses_update_template)
+	{
+		write_with_template();
+		return;
+	}
+
 	vkUpdateDescriptorSets(device.get_handle(),
 	                       to_u32(write_descriptor_sets.size()),
 	                       write_descriptor_sets.data(),
@@ -223,6 +248,25 @@ void DescriptorSet::apply_writes() const
 	                       nullptr);
 }
 
+void DescriptorSet::write_with_template() const
+{
+	for (auto &write_descriptor_set : write_descriptor_sets)
+	{
+		auto &template_info = template_infos[descriptor_set_layout.get_update_template_offset(write_descriptor_set.dstBinding) + write_descriptor_set.dstArrayElement];
+
+		if (write_descriptor_set.pBufferInfo)
+		{
+			template_info.buffer = *write_descriptor_set.pBufferInfo;
+		}
+		else
+		{
+			template_info.image = *write_descriptor_set.pImageInfo;
+		}
+	}
+
+	vkUpdateDescriptorSetWithTemplateKHR(device.get_handle(), handle, descriptor_set_layout.get_update_template(), template_infos.data());
+}
+
 DescriptorSet::DescriptorSet(DescriptorSet &&other) :
     device{other.device},
     descriptor_set_layout{other.descriptor_set_layout},
@@ -231,11 +275,18 @@ DescriptorSet::DescriptorSet(DescriptorSet &&other) :
     image_infos{std::move(other.image_infos)},
     handle{other.handle},
     write_descriptor_sets{std::move(other.write_descriptor_sets)},
-    updated_bindings{std::move(other.updated_bindings)}
+    updated_bindings{std::move(other.updated_bindings)},
+    uses_update_template{other.uses_update_template},
+    template_infos{std::move(other.template_infos)}
 {
 	other.handle = VK_NULL_HANDLE;
 }
 
+DescriptorPool &DescriptorSet::get_descriptor_pool() const
+{
+	return descriptor_pool;
+}
+
 VkDescriptorSet DescriptorSet::get_handle() const
 {
 	return handle;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -19,11 +19,11 @@
 
 #include "common/helpers.h"
 #include "common/vk_common.h"
+#include "core/descriptor_set_layout.h"
 
 namespace vkb
 {
 class Device;
-class DescriptorSetLayout;
 class DescriptorPool;
 
 /**
@@ -31,6 +31,8 @@ class DescriptorPool;
  *        Destroying the handle has no effect, as the pool manages the lifecycle of its descriptor sets.
  *
  *        Keeps track of what bindings were written to prevent a double write.
+ *        When every descriptor of the set is written at once, they are packed in an array and written
+ *        through the update template of the layout, see DescriptorSetLayout::get_update_template().
  */
 class DescriptorSet
 {
@@ -83,6 +85,8 @@ class DescriptorSet
 
 	const DescriptorSetLayout &get_layout() const;
 
+	DescriptorPool &get_descriptor_pool() const;
+
 	VkDescriptorSet get_handle() const;
 
 	BindingMap<VkDescriptorBufferInfo> &get_buffer_infos();
@@ -96,6 +100,12 @@ class DescriptorSet
 	 */
 	void prepare();
 
+	/**
+	 * @brief Packs the descriptors of all write operations and writes them through the update template of the layout
+	 *        Only valid if uses_update_template is true
+	 */
+	void write_with_template() const;
+
   private:
 	Device &device;
 
@@ -115,5 +125,11 @@ class DescriptorSet
 	// The bindings of the write descriptors that have had vkUpdateDescriptorSets since the last call to update().
 	// Each binding number is mapped to a hash of the binding description that it will be updated to.
 	std::unordered_map<uint32_t, size_t> updated_bindings;
+
+	// Whether the write operations cover every descriptor of the layout, so that they can be written with its update template
+	bool uses_update_template{false};
+
+	// The descriptors packed for the update template, rebuilt from the write operations as the infos may have been modified
+	mutable std::vector<DescriptorTemplateInfo> template_infos;
 };
 }        // namespace vkb
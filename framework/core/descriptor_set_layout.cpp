@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -118,9 +118,10 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 		}
 
 		// Convert from ShaderResourceType to VkDescriptorType.
-		auto descriptor_type = find_descriptor_type(resource.type, resource.mode == ShaderResourceMode::Dynamic);
+		// Descriptor buffers hold buffer addresses, there are no dynamic offsets nor updates after bind
+		auto descriptor_type = find_descriptor_type(resource.type, resource.mode == ShaderResourceMode::Dynamic && !device.uses_descriptor_buffers());
 
-		if (resource.mode == ShaderResourceMode::UpdateAfterBind)
+		if (resource.mode == ShaderResourceMode::UpdateAfterBind && !device.uses_descriptor_buffers())
 		{
 			binding_flags.push_back(VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT);
 		}
@@ -150,14 +151,36 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 		resources_lookup.emplace(resource.name, resource.binding);
 	}
 
+	// A pipeline layout can only have one push descriptor set, so only small sets at index 0 are pushed.
+	// Push descriptor sets can't have dynamic nor update-after-bind descriptors.
+	for (auto &binding : bindings)
+	{
+		descriptor_count += binding.descriptorCount;
+	}
+
+	push_descriptor = set_index == 0 && !bindings.empty() && descriptor_count <= device.get_max_push_descriptors() &&
+	                  std::none_of(resource_set.begin(), resource_set.end(), [](const ShaderResource &shader_resource) {
+		                  return shader_resource.mode == ShaderResourceMode::Dynamic || shader_resource.mode == ShaderResourceMode::UpdateAfterBind;
+	                  });
+
+	dynamic_or_input_descriptors = std::any_of(bindings.begin(), bindings.end(), [](const VkDescriptorSetLayoutBinding &binding) {
+		return is_dynamic_buffer_descriptor_type(binding.descriptorType) || binding.descriptorType == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+	});
+
 	VkDescriptorSetLayoutCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-	create_info.flags        = 0;
+	create_info.flags        = device.uses_descriptor_buffers() ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0;
 	create_info.bindingCount = to_u32(bindings.size());
 	create_info.pBindings    = bindings.data();
 
+	if (push_descriptor)
+	{
+		create_info.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+	}
+
 	// Handle update-after-bind extensions
 	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT};
-	if (std::find_if(resource_set.begin(), resource_set.end(),
+	if (!device.uses_descriptor_buffers() &&
+	    std::find_if(resource_set.begin(), resource_set.end(),
 	                 [](const ShaderResource &shader_resource) { return shader_resource.mode == ShaderResourceMode::UpdateAfterBind; }) != resource_set.end())
 	{
 		// Spec states you can't have ANY dynamic resources if you have one of the bindings set to update-after-bind
@@ -186,6 +209,55 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	{
 		throw VulkanException{result, "Cannot create DescriptorSetLayout"};
 	}
+
+	if (device.uses_descriptor_buffers())
+	{
+		vkGetDescriptorSetLayoutSizeEXT(device.get_handle(), handle, &descriptor_buffer_size);
+
+		for (auto &binding : bindings)
+		{
+			VkDeviceSize offset{0};
+			vkGetDescriptorSetLayoutBindingOffsetEXT(device.get_handle(), handle, binding.binding, &offset);
+			descriptor_buffer_offsets.emplace(binding.binding, offset);
+		}
+	}
+
+	// Sets which are allocated are written with a template, which packs the descriptors of all bindings in one array
+	if (device.uses_descriptor_update_templates() && !push_descriptor && !bindings.empty())
+	{
+		std::vector<VkDescriptorUpdateTemplateEntryKHR> entries;
+		entries.reserve(bindings.size());
+
+		uint32_t offset = 0;
+		for (auto &binding : bindings)
+		{
+			VkDescriptorUpdateTemplateEntryKHR entry{};
+			entry.dstBinding      = binding.binding;
+			entry.dstArrayElement = 0;
+			entry.descriptorCount = binding.descriptorCount;
+			entry.descriptorType  = binding.descriptorType;
+			entry.offset          = offset * sizeof(DescriptorTemplateInfo);
+			entry.stride          = sizeof(DescriptorTemplateInfo);
+
+			entries.push_back(entry);
+			update_template_offsets.emplace(binding.binding, offset);
+
+			offset += binding.descriptorCount;
+		}
+
+		VkDescriptorUpdateTemplateCreateInfoKHR template_info{VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR};
+		template_info.descriptorUpdateEntryCount = to_u32(entries.size());
+		template_info.pDescriptorUpdateEntries   = entries.data();
+		template_info.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+		template_info.descriptorSetLayout        = handle;
+
+		result = vkCreateDescriptorUpdateTemplateKHR(device.get_handle(), &template_info, nullptr, &update_template);
+
+		if (result != VK_SUCCESS)
+		{
+			throw VulkanException{result, "Cannot create DescriptorUpdateTemplate"};
+		}
+	}
 }
 
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
@@ -197,13 +269,26 @@ DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
     binding_flags{std::move(other.binding_flags)},
     bindings_lookup{std::move(other.bindings_lookup)},
     binding_flags_lookup{std::move(other.binding_flags_lookup)},
-    resources_lookup{std::move(other.resources_lookup)}
+    resources_lookup{std::move(other.resources_lookup)},
+    push_descriptor{other.push_descriptor},
+    dynamic_or_input_descriptors{other.dynamic_or_input_descriptors},
+    descriptor_buffer_size{other.descriptor_buffer_size},
+    descriptor_buffer_offsets{std::move(other.descriptor_buffer_offsets)},
+    descriptor_count{other.descriptor_count},
+    update_template{other.update_template},
+    update_template_offsets{std::move(other.update_template_offsets)}
 {
-	other.handle = VK_NULL_HANDLE;
+	other.handle          = VK_NULL_HANDLE;
+	other.update_template = VK_NULL_HANDLE;
 }
 
 DescriptorSetLayout::~DescriptorSetLayout()
 {
+	if (update_template != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorUpdateTemplateKHR(device.get_handle(), update_template, nullptr);
+	}
+
 	// Destroy descriptor set layout
 	if (handle != VK_NULL_HANDLE)
 	{
@@ -231,6 +316,50 @@ const std::vector<VkDescriptorBindingFlagsEXT> &DescriptorSetLayout::get_binding
 	return binding_flags;
 }
 
+bool DescriptorSetLayout::is_push_descriptor() const
+{
+	return push_descriptor;
+}
+
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_size() const
+{
+	return descriptor_buffer_size;
+}
+
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_offset(uint32_t binding_index) const
+{
+	auto it = descriptor_buffer_offsets.find(binding_index);
+
+	if (it == descriptor_buffer_offsets.end())
+	{
+		throw std::runtime_error("Binding not found in the descriptor set layout.");
+	}
+
+	return it->second;
+}
+
+VkDescriptorUpdateTemplateKHR DescriptorSetLayout::get_update_template() const
+{
+	return update_template;
+}
+
+uint32_t DescriptorSetLayout::get_update_template_offset(uint32_t binding_index) const
+{
+	auto it = update_template_offsets.find(binding_index);
+
+	if (it == update_template_offsets.end())
+	{
+		throw std::runtime_error("Binding not found in the descriptor set layout.");
+	}
+
+	return it->second;
+}
+
+uint32_t DescriptorSetLayout::get_descriptor_count() const
+{
+	return descriptor_count;
+}
+
 std::unique_ptr<VkDescriptorSetLayoutBinding> DescriptorSetLayout::get_layout_binding(uint32_t binding_index) const
 {
 	auto it = bindings_lookup.find(binding_index);
@@ -243,6 +372,18 @@ std::unique_ptr<VkDescriptorSetLayoutBinding> DescriptorSetLayout::get_layout_bi
 	return std::make_unique<VkDescriptorSetLayoutBinding>(it->second);
 }
 
+const VkDescriptorSetLayoutBinding *DescriptorSetLayout::find_layout_binding(uint32_t binding_index) const
+{
+	auto it = bindings_lookup.find(binding_index);
+
+	return it != bindings_lookup.end() ? &it->second : nullptr;
+}
+
+bool DescriptorSetLayout::has_dynamic_or_input_descriptors() const
+{
+	return dynamic_or_input_descriptors;
+}
+
 std::unique_ptr<VkDescriptorSetLayoutBinding> DescriptorSetLayout::get_layout_binding(const std::string &name) const
 {
 	auto it = resources_lookup.find(name);
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -28,6 +28,16 @@ class ShaderModule;
 
 struct ShaderResource;
 
+/**
+ * @brief A descriptor of the packed array written through the update template of a DescriptorSetLayout
+ */
+union DescriptorTemplateInfo
+{
+	VkDescriptorBufferInfo buffer;
+
+	VkDescriptorImageInfo image;
+};
+
 /**
  * @brief Caches DescriptorSet objects for the shader's set index.
  *        Creates a DescriptorPool to allocate the DescriptorSet objects
@@ -67,12 +77,57 @@ class DescriptorSetLayout
 
 	std::unique_ptr<VkDescriptorSetLayoutBinding> get_layout_binding(const std::string &name) const;
 
+	/**
+	 * @brief Same as get_layout_binding(), without copying the binding
+	 * @return The binding, or null if the layout has no such binding
+	 */
+	const VkDescriptorSetLayoutBinding *find_layout_binding(uint32_t binding_index) const;
+
+	/**
+	 * @brief Whether descriptors of the set are written from more than the bound resources, as the offsets of dynamic buffers
+	 *        are bound with the set and the layout of input attachments depends on the render pass
+	 */
+	bool has_dynamic_or_input_descriptors() const;
+
 	const std::vector<VkDescriptorBindingFlagsEXT> &get_binding_flags() const;
 
 	VkDescriptorBindingFlagsEXT get_layout_binding_flag(const uint32_t binding_index) const;
 
 	const std::vector<ShaderModule *> &get_shader_modules() const;
 
+	/**
+	 * @brief Whether the set is a push descriptor set, which is pushed to command buffers instead of allocated
+	 *        Set 0 is pushed if VK_KHR_push_descriptor is enabled, and it fits and has no dynamic nor update-after-bind resources
+	 */
+	bool is_push_descriptor() const;
+
+	/**
+	 * @return The size in bytes of the set in a descriptor buffer, only valid if Device::uses_descriptor_buffers()
+	 */
+	VkDeviceSize get_descriptor_buffer_size() const;
+
+	/**
+	 * @return The offset in bytes of a binding from the start of the set in a descriptor buffer, only valid if Device::uses_descriptor_buffers()
+	 */
+	VkDeviceSize get_descriptor_buffer_offset(uint32_t binding_index) const;
+
+	/**
+	 * @brief The template writing every descriptor of the set from an array of DescriptorTemplateInfo, with the descriptors
+	 *        of each binding packed in order, see get_update_template_offset()
+	 * @return The template, or VK_NULL_HANDLE if the set is pushed or Device::uses_descriptor_update_templates() is false
+	 */
+	VkDescriptorUpdateTemplateKHR get_update_template() const;
+
+	/**
+	 * @return The index in the packed array of the first descriptor of a binding, only valid if the layout has an update template
+	 */
+	uint32_t get_update_template_offset(uint32_t binding_index) const;
+
+	/**
+	 * @return The number of descriptors of the set, which is the size of the packed array written by the update template
+	 */
+	uint32_t get_descriptor_count() const;
+
   private:
 	Device &device;
 
@@ -91,5 +146,19 @@ class DescriptorSetLayout
 	std::unordered_map<std::string, uint32_t> resources_lookup;
 
 	std::vector<ShaderModule *> shader_modules;
+
+	bool push_descriptor{false};
+
+	bool dynamic_or_input_descriptors{false};
+
+	VkDeviceSize descriptor_buffer_size{0};
+
+	std::unordered_map<uint32_t, VkDeviceSize> descriptor_buffer_offsets;
+
+	uint32_t descriptor_count{0};
+
+	VkDescriptorUpdateTemplateKHR update_template{VK_NULL_HANDLE};
+
+	std::unordered_map<uint32_t, uint32_t> update_template_offsets;
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -23,6 +23,12 @@
 
 namespace vkb
 {
+namespace
+{
+// The name of VK_KHR_portability_subset, whose header is only included with VK_ENABLE_BETA_EXTENSIONS
+constexpr const char *PORTABILITY_SUBSET_EXTENSION_NAME = "VK_KHR_portability_subset";
+}        // namespace
+
 Device::Device(PhysicalDevice                        &gpu,
                VkSurfaceKHR                           surface,
                std::unique_ptr<DebugUtils>          &&debug_utils,
@@ -100,6 +106,56 @@ Device::Device(PhysicalDevice                        &gpu,
 		}
 	}
 
+	// Calibrated timestamps correlate GPU timestamps with the CPU clock, as in the traces of the trace capture plugin
+	bool calibrated_timestamps_requested = std::any_of(requested_extensions.begin(), requested_extensions.end(),
+	                                                   [](auto &extension) { return strcmp(extension.first, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) == 0; });
+	if (is_extension_supported(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) && !calibrated_timestamps_requested)
+	{
+		enabled_extensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+	}
+
+	// Descriptor update templates let descriptor sets be written from packed arrays, see DescriptorSetLayout::get_update_template()
+	bool descriptor_update_template_requested = std::any_of(requested_extensions.begin(), requested_extensions.end(),
+	                                                        [](auto &extension) { return strcmp(extension.first, VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME) == 0; });
+	if (is_extension_supported(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME) && !descriptor_update_template_requested)
+	{
+		enabled_extensions.push_back(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
+	}
+
+	// Half precision arithmetic lets the framework shaders use the faster FP16 paths of mobile GPUs, see uses_float16_arithmetic()
+	bool float16_int8_requested = std::any_of(requested_extensions.begin(), requested_extensions.end(),
+	                                          [](auto &extension) { return strcmp(extension.first, VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME) == 0; });
+	if (is_extension_supported(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME) &&
+	    gpu.get_instance().is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		auto &float16_int8_features = gpu.request_extension_features<VkPhysicalDeviceShaderFloat16Int8FeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR);
+
+		if (float16_int8_features.shaderFloat16)
+		{
+			if (!float16_int8_requested)
+			{
+				enabled_extensions.push_back(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME);
+			}
+
+			float16_arithmetic = true;
+			LOGI("Half precision shader arithmetic enabled");
+		}
+	}
+
+	// Layered implementations such as MoltenVK must have the portability subset enabled, see uses_portability_subset()
+	bool portability_subset_requested = std::any_of(requested_extensions.begin(), requested_extensions.end(),
+	                                                [](auto &extension) { return strcmp(extension.first, PORTABILITY_SUBSET_EXTENSION_NAME) == 0; });
+	if (is_extension_supported(PORTABILITY_SUBSET_EXTENSION_NAME))
+	{
+		if (!portability_subset_requested)
+		{
+			enabled_extensions.push_back(PORTABILITY_SUBSET_EXTENSION_NAME);
+		}
+
+		portability_subset = true;
+		LOGI("Portability subset enabled");
+	}
+
 	// Check that extensions are supported before trying to create the device
 	std::vector<const char *> unsupported_extensions{};
 	for (auto &extension : requested_extensions)
@@ -146,6 +202,184 @@ Device::Device(PhysicalDevice                        &gpu,
 		}
 	}
 
+	// The descriptor buffer backend is opted into by enabling the extensions and requesting their features
+	if (is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) && is_enabled(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME))
+	{
+		auto *descriptor_buffer_features     = gpu.find_requested_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+		auto *buffer_device_address_features = gpu.find_requested_extension_features<VkPhysicalDeviceBufferDeviceAddressFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR);
+
+		if (descriptor_buffer_features && descriptor_buffer_features->descriptorBuffer &&
+		    buffer_device_address_features && buffer_device_address_features->bufferDeviceAddress)
+		{
+			VkPhysicalDeviceProperties2KHR properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+			properties.pNext = &descriptor_buffer_properties;
+			vkGetPhysicalDeviceProperties2KHR(gpu.get_handle(), &properties);
+			descriptor_buffer_properties.pNext = nullptr;
+
+			descriptor_buffers = true;
+			LOGI("Descriptor buffers enabled");
+		}
+	}
+
+	// Descriptor buffers are written directly, there are no descriptor sets to update
+	descriptor_update_templates = is_enabled(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME) && !descriptor_buffers;
+
+	if (is_enabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME) && !descriptor_buffers)
+	{
+		VkPhysicalDevicePushDescriptorPropertiesKHR push_descriptor_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR};
+
+		VkPhysicalDeviceProperties2KHR properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+		properties.pNext = &push_descriptor_properties;
+		vkGetPhysicalDeviceProperties2KHR(gpu.get_handle(), &properties);
+
+		max_push_descriptors = push_descriptor_properties.maxPushDescriptors;
+		LOGI("Push descriptors enabled");
+	}
+
+	if (is_enabled(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME))
+	{
+		auto *extended_dynamic_state_features = gpu.find_requested_extension_features<VkPhysicalDeviceExtendedDynamicStateFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT);
+
+		if (extended_dynamic_state_features && extended_dynamic_state_features->extendedDynamicState)
+		{
+			dynamic_pipeline_state_flags |= DYNAMIC_PIPELINE_STATE_RASTERIZATION_BIT | DYNAMIC_PIPELINE_STATE_DEPTH_STENCIL_BIT;
+		}
+	}
+
+	if (is_enabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+	{
+		auto *extended_dynamic_state3_features = gpu.find_requested_extension_features<VkPhysicalDeviceExtendedDynamicState3FeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT);
+
+		if (extended_dynamic_state3_features &&
+		    extended_dynamic_state3_features->extendedDynamicState3ColorBlendEnable &&
+		    extended_dynamic_state3_features->extendedDynamicState3ColorBlendEquation &&
+		    extended_dynamic_state3_features->extendedDynamicState3ColorWriteMask)
+		{
+			dynamic_pipeline_state_flags |= DYNAMIC_PIPELINE_STATE_COLOR_BLEND_BIT;
+		}
+	}
+
+	// Metal bakes the blend state into its pipelines, so a portability implementation builds a pipeline for each dynamic
+	// blend state at draw time, which costs more than looking up the pipelines of the static blend states in the cache
+	if (portability_subset && (dynamic_pipeline_state_flags & DYNAMIC_PIPELINE_STATE_COLOR_BLEND_BIT))
+	{
+		dynamic_pipeline_state_flags &= ~DYNAMIC_PIPELINE_STATE_COLOR_BLEND_BIT;
+		LOGI("Dynamic color blend state disabled on the portability subset");
+	}
+
+	if (dynamic_pipeline_state_flags)
+	{
+		LOGI("Dynamic pipeline state enabled");
+	}
+
+	if (is_enabled(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) && is_enabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+	{
+		auto *graphics_pipeline_library_features = gpu.find_requested_extension_features<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT);
+
+		if (graphics_pipeline_library_features && graphics_pipeline_library_features->graphicsPipelineLibrary)
+		{
+			graphics_pipeline_libraries = true;
+			LOGI("Graphics pipeline libraries enabled");
+		}
+	}
+
+	if (is_enabled(VK_EXT_SHADER_OBJECT_EXTENSION_NAME) && is_enabled(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+	{
+		auto *shader_object_features     = gpu.find_requested_extension_features<VkPhysicalDeviceShaderObjectFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT);
+		auto *dynamic_rendering_features = gpu.find_requested_extension_features<VkPhysicalDeviceDynamicRenderingFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR);
+
+		if (shader_object_features && shader_object_features->shaderObject &&
+		    dynamic_rendering_features && dynamic_rendering_features->dynamicRendering)
+		{
+			shader_objects = true;
+			LOGI("Shader objects enabled");
+		}
+	}
+
+	if (is_enabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+	{
+		auto *timeline_semaphore_features = gpu.find_requested_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR);
+
+		if (timeline_semaphore_features && timeline_semaphore_features->timelineSemaphore)
+		{
+			timeline_semaphores = true;
+			LOGI("Timeline semaphores enabled");
+		}
+	}
+
+	if (is_enabled(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+	{
+		auto *synchronization2_features = gpu.find_requested_extension_features<VkPhysicalDeviceSynchronization2FeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR);
+
+		if (synchronization2_features && synchronization2_features->synchronization2)
+		{
+			synchronization2 = true;
+			LOGI("Synchronization2 enabled");
+		}
+	}
+
+	if (is_enabled(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+	{
+		auto *dynamic_rendering_features = gpu.find_requested_extension_features<VkPhysicalDeviceDynamicRenderingFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR);
+
+		if (dynamic_rendering_features && dynamic_rendering_features->dynamicRendering)
+		{
+			dynamic_rendering = true;
+			LOGI("Dynamic rendering enabled");
+		}
+	}
+
+	if (dynamic_rendering && is_enabled(VK_KHR_DYNAMIC_RENDERING_LOCAL_READ_EXTENSION_NAME))
+	{
+		auto *local_read_features = gpu.find_requested_extension_features<VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR);
+
+		if (local_read_features && local_read_features->dynamicRenderingLocalRead)
+		{
+			dynamic_rendering_local_read = true;
+			LOGI("Dynamic rendering local read enabled");
+		}
+	}
+
+	if (is_enabled(VK_KHR_PRESENT_ID_EXTENSION_NAME) && is_enabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+	{
+		auto *present_id_features   = gpu.find_requested_extension_features<VkPhysicalDevicePresentIdFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR);
+		auto *present_wait_features = gpu.find_requested_extension_features<VkPhysicalDevicePresentWaitFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR);
+
+		if (present_id_features && present_id_features->presentId &&
+		    present_wait_features && present_wait_features->presentWait)
+		{
+			present_wait = true;
+			LOGI("Present wait enabled");
+		}
+	}
+
+	if (is_enabled(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME))
+	{
+		auto *fragment_shading_rate_features = gpu.find_requested_extension_features<VkPhysicalDeviceFragmentShadingRateFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR);
+
+		if (fragment_shading_rate_features && fragment_shading_rate_features->pipelineFragmentShadingRate)
+		{
+			fragment_shading_rates = true;
+			LOGI("Fragment shading rates enabled");
+		}
+	}
+
+	if (is_enabled(VK_EXT_MESH_SHADER_EXTENSION_NAME))
+	{
+		auto *mesh_shader_features = gpu.find_requested_extension_features<VkPhysicalDeviceMeshShaderFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT);
+
+		if (mesh_shader_features && mesh_shader_features->taskShader && mesh_shader_features->meshShader)
+		{
+			VkPhysicalDeviceProperties2KHR properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+			properties.pNext = &mesh_shader_properties;
+			vkGetPhysicalDeviceProperties2KHR(gpu.get_handle(), &properties);
+			mesh_shader_properties.pNext = nullptr;
+
+			mesh_shaders = true;
+			LOGI("Mesh shaders enabled");
+		}
+	}
+
 	VkDeviceCreateInfo create_info{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
 
 	// Latest requested feature will have the pNext's all set up for device creation.
@@ -159,6 +393,18 @@ Device::Device(PhysicalDevice                        &gpu,
 	const auto requested_gpu_features = gpu.get_requested_features();
 	create_info.pEnabledFeatures      = &requested_gpu_features;
 
+	// The logical device spans every physical device of the group, their memory is replicated on each of them
+	VkDeviceGroupDeviceCreateInfoKHR device_group_info{VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO_KHR};
+	if (gpu.get_device_group().size() > 1)
+	{
+		device_group_info.pNext               = create_info.pNext;
+		device_group_info.physicalDeviceCount = to_u32(gpu.get_device_group().size());
+		device_group_info.pPhysicalDevices    = gpu.get_device_group().data();
+		create_info.pNext                     = &device_group_info;
+
+		LOGI("Device group of {} GPUs enabled", device_group_info.physicalDeviceCount);
+	}
+
 	VkResult result = vkCreateDevice(gpu.get_handle(), &create_info, nullptr, &get_handle());
 
 	if (result != VK_SUCCESS)
@@ -184,6 +430,9 @@ Device::Device(PhysicalDevice                        &gpu,
 
 	command_pool = std::make_unique<CommandPool>(*this, get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0).get_family_index());
 	fence_pool   = std::make_unique<FencePool>(*this);
+
+	// Everything the framework and the sample probed to create the device is known by now
+	gpu.save_capabilities();
 }
 
 Device::Device(PhysicalDevice &gpu, VkDevice &vulkan_device, VkSurfaceKHR surface) :
@@ -196,10 +445,14 @@ Device::Device(PhysicalDevice &gpu, VkDevice &vulkan_device, VkSurfaceKHR surfac
 
 Device::~Device()
 {
+	retire_queue.clear();
+
 	resource_cache.clear();
 
 	command_pool.reset();
 	fence_pool.reset();
+	attachment_allocator.reset();
+	transient_resource_pool.reset();
 
 	vkb::allocated::shutdown();
 
@@ -216,6 +469,96 @@ bool Device::is_enabled(const char *extension) const
 	return std::find_if(enabled_extensions.begin(), enabled_extensions.end(), [extension](const char *enabled_extension) { return strcmp(extension, enabled_extension) == 0; }) != enabled_extensions.end();
 }
 
+bool Device::uses_descriptor_buffers() const
+{
+	return descriptor_buffers;
+}
+
+const VkPhysicalDeviceDescriptorBufferPropertiesEXT &Device::get_descriptor_buffer_properties() const
+{
+	return descriptor_buffer_properties;
+}
+
+bool Device::uses_descriptor_update_templates() const
+{
+	return descriptor_update_templates;
+}
+
+uint32_t Device::get_max_push_descriptors() const
+{
+	return max_push_descriptors;
+}
+
+DynamicPipelineStateFlags Device::get_dynamic_pipeline_state_flags() const
+{
+	return dynamic_pipeline_state_flags;
+}
+
+bool Device::uses_graphics_pipeline_libraries() const
+{
+	return graphics_pipeline_libraries;
+}
+
+bool Device::uses_shader_objects() const
+{
+	return shader_objects;
+}
+
+bool Device::uses_timeline_semaphores() const
+{
+	return timeline_semaphores;
+}
+
+uint32_t Device::get_device_group_size() const
+{
+	return std::max(to_u32(gpu.get_device_group().size()), 1u);
+}
+
+bool Device::uses_synchronization2() const
+{
+	return synchronization2;
+}
+
+bool Device::uses_dynamic_rendering() const
+{
+	return dynamic_rendering;
+}
+
+bool Device::uses_dynamic_rendering_local_read() const
+{
+	return dynamic_rendering_local_read;
+}
+
+bool Device::uses_present_wait() const
+{
+	return present_wait;
+}
+
+bool Device::uses_fragment_shading_rates() const
+{
+	return fragment_shading_rates;
+}
+
+bool Device::uses_mesh_shaders() const
+{
+	return mesh_shaders;
+}
+
+bool Device::uses_float16_arithmetic() const
+{
+	return float16_arithmetic;
+}
+
+bool Device::uses_portability_subset() const
+{
+	return portability_subset;
+}
+
+const VkPhysicalDeviceMeshShaderPropertiesEXT &Device::get_mesh_shader_properties() const
+{
+	return mesh_shader_properties;
+}
+
 const PhysicalDevice &Device::get_gpu() const
 {
 	return gpu;
@@ -548,4 +891,44 @@ ResourceCache &Device::get_resource_cache()
 {
 	return resource_cache;
 }
+
+AttachmentAllocator &Device::get_attachment_allocator()
+{
+	if (!attachment_allocator)
+	{
+		attachment_allocator = std::make_unique<AttachmentAllocator>(*this);
+	}
+
+	return *attachment_allocator;
+}
+
+TransientResourcePool &Device::get_transient_resource_pool()
+{
+	if (!transient_resource_pool)
+	{
+		transient_resource_pool = std::make_unique<TransientResourcePool>(*this);
+	}
+
+	return *transient_resource_pool;
+}
+
+RetireQueue &Device::get_retire_queue()
+{
+	return retire_queue;
+}
+
+TextureRegistry &Device::get_texture_registry()
+{
+	return texture_registry;
+}
+
+void Device::set_gpu_profiler(GpuProfiler *profiler)
+{
+	gpu_profiler = profiler;
+}
+
+GpuProfiler *Device::get_gpu_profiler() const
+{
+	return gpu_profiler;
+}
 }        // namespace vkb
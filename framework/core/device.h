@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -32,17 +32,23 @@
 #include "core/pipeline_layout.h"
 #include "core/queue.h"
 #include "core/render_pass.h"
+#include "core/retire_queue.h"
 #include "core/shader_module.h"
 #include "core/swapchain.h"
 #include "core/util/logging.hpp"
 #include "core/vulkan_resource.h"
 #include "fence_pool.h"
+#include "rendering/attachment_allocator.h"
+#include "rendering/transient_resource_pool.h"
 #include "rendering/pipeline_state.h"
 #include "rendering/render_target.h"
 #include "resource_cache.h"
+#include "texture_registry.h"
 
 namespace vkb
 {
+class GpuProfiler;
+
 struct DriverVersion
 {
 	uint16_t major;
@@ -130,6 +136,137 @@ class Device : public vkb::core::VulkanResource<vkb::BindingType::C, VkDevice>
 
 	bool is_enabled(const char *extension) const;
 
+	/**
+	 * @brief Whether descriptors are written to descriptor buffers instead of descriptor sets
+	 *
+	 *        The descriptor buffer backend is selected at device creation, when the VK_EXT_descriptor_buffer
+	 *        and VK_KHR_buffer_device_address extensions are enabled, and their descriptorBuffer and
+	 *        bufferDeviceAddress features requested.
+	 */
+	bool uses_descriptor_buffers() const;
+
+	/**
+	 * @return The descriptor buffer properties of the GPU, only valid if uses_descriptor_buffers()
+	 */
+	const VkPhysicalDeviceDescriptorBufferPropertiesEXT &get_descriptor_buffer_properties() const;
+
+	/**
+	 * @brief Whether descriptor sets are written through the update template of their layout, see DescriptorSetLayout::get_update_template()
+	 *
+	 *        VK_KHR_descriptor_update_template is enabled whenever it is supported, and templates are not used with descriptor buffers.
+	 */
+	bool uses_descriptor_update_templates() const;
+
+	/**
+	 * @return The maximum number of descriptors in a push descriptor set layout,
+	 *         0 if VK_KHR_push_descriptor is not enabled or descriptor buffers are used
+	 */
+	uint32_t get_max_push_descriptors() const;
+
+	/**
+	 * @brief The groups of pipeline state which command buffers set dynamically, see PipelineState::set_dynamic_state_flags()
+	 *
+	 *        Rasterization and depth stencil state are dynamic when VK_EXT_extended_dynamic_state is enabled and its
+	 *        extendedDynamicState feature requested. Color blend state is dynamic when VK_EXT_extended_dynamic_state3 is
+	 *        enabled and its color blend enable, equation and write mask features requested, except on the portability subset.
+	 */
+	DynamicPipelineStateFlags get_dynamic_pipeline_state_flags() const;
+
+	/**
+	 * @brief Whether the resource cache links graphics pipelines from graphics pipeline libraries
+	 *
+	 *        Libraries are used when VK_KHR_pipeline_library and VK_EXT_graphics_pipeline_library are enabled,
+	 *        and the graphicsPipelineLibrary feature requested.
+	 */
+	bool uses_graphics_pipeline_libraries() const;
+
+	/**
+	 * @brief Whether command buffers draw with shader objects instead of graphics pipelines
+	 *
+	 *        Shader objects are used when VK_EXT_shader_object and VK_KHR_dynamic_rendering are enabled, and the
+	 *        shaderObject and dynamicRendering features requested. See CommandBuffer::begin_render_pass for the
+	 *        render passes which can use them.
+	 */
+	bool uses_shader_objects() const;
+
+	/**
+	 * @brief Whether timeline semaphores can be used, see RenderContext::set_timeline_frame_sync
+	 *
+	 *        They can be used when VK_KHR_timeline_semaphore is enabled, and the timelineSemaphore feature requested.
+	 */
+	bool uses_timeline_semaphores() const;
+
+	/**
+	 * @return The number of physical devices the device spans, more than one if it was created over a device group
+	 */
+	uint32_t get_device_group_size() const;
+
+	/**
+	 * @brief Whether queue submissions and command buffer barriers use the synchronization2 commands
+	 *
+	 *        Synchronization2 is used when VK_KHR_synchronization2 is enabled, and the synchronization2 feature requested.
+	 */
+	bool uses_synchronization2() const;
+
+	/**
+	 * @brief Whether RenderPipeline and CommandBuffer::begin_render_pass render with dynamic rendering instead of render pass objects
+	 *
+	 *        Dynamic rendering is used when VK_KHR_dynamic_rendering is enabled, and the dynamicRendering feature requested.
+	 *        Passes with several subpasses additionally need uses_dynamic_rendering_local_read(), or keep using render passes.
+	 */
+	bool uses_dynamic_rendering() const;
+
+	/**
+	 * @brief Whether subpass inputs can be read from the attachments of a dynamic rendering pass
+	 *
+	 *        Local read is used when VK_KHR_dynamic_rendering_local_read is enabled, and the dynamicRenderingLocalRead feature requested.
+	 */
+	bool uses_dynamic_rendering_local_read() const;
+
+	/**
+	 * @brief Whether presents can be identified and waited for, see RenderContext::set_low_latency_mode
+	 *
+	 *        Present wait is used when VK_KHR_present_id and VK_KHR_present_wait are enabled, and the presentId
+	 *        and presentWait features requested.
+	 */
+	bool uses_present_wait() const;
+
+	/**
+	 * @brief Whether command buffers set a fragment shading rate, see CommandBuffer::set_fragment_shading_rate
+	 *
+	 *        Fragment shading rates are used when VK_KHR_fragment_shading_rate is enabled, and the pipelineFragmentShadingRate
+	 *        feature requested.
+	 */
+	bool uses_fragment_shading_rates() const;
+
+	/**
+	 * @brief Whether graphics pipelines can have task and mesh shader stages, see MeshletSubpass
+	 *
+	 *        Mesh shaders are used when VK_EXT_mesh_shader is enabled, and the taskShader and meshShader features requested.
+	 */
+	bool uses_mesh_shaders() const;
+
+	/**
+	 * @return The mesh shader properties of the GPU, only valid if uses_mesh_shaders()
+	 */
+	const VkPhysicalDeviceMeshShaderPropertiesEXT &get_mesh_shader_properties() const;
+
+	/**
+	 * @brief Whether shaders can do arithmetic on 16-bit floats, which the framework shaders do through the FP16_ARITHMETIC definition
+	 *
+	 *        VK_KHR_shader_float16_int8 is enabled with the shaderFloat16 feature whenever the GPU supports it, as half precision
+	 *        doubles the throughput and halves the register use of the shaders of many mobile GPUs.
+	 */
+	bool uses_float16_arithmetic() const;
+
+	/**
+	 * @brief Whether the device implements Vulkan over another API, e.g. MoltenVK over Metal
+	 *
+	 *        VK_KHR_portability_subset is enabled whenever it is supported, as the specification requires. The framework
+	 *        then avoids the features which such implementations emulate at draw time, see get_dynamic_pipeline_state_flags().
+	 */
+	bool uses_portability_subset() const;
+
 	uint32_t get_queue_family_index(VkQueueFlagBits queue_flag);
 
 	uint32_t get_num_queues_for_queue_family(uint32_t queue_family_index);
@@ -212,6 +349,34 @@ class Device : public vkb::core::VulkanResource<vkb::BindingType::C, VkDevice>
 
 	ResourceCache &get_resource_cache();
 
+	/**
+	 * @brief Returns the allocator sharing the memory of render target attachments, created on first use
+	 */
+	AttachmentAllocator &get_attachment_allocator();
+
+	/**
+	 * @brief Returns the pool recycling the images and buffers of transient resources, created on first use
+	 */
+	TransientResourcePool &get_transient_resource_pool();
+
+	/**
+	 * @brief Returns the queue destroying replaced objects once the frames in flight retired, instead of waiting for the device to be idle
+	 */
+	RetireQueue &get_retire_queue();
+
+	/**
+	 * @brief Returns the registry sharing the Vulkan images of textures of the same content across the scenes loaded on the device
+	 */
+	TextureRegistry &get_texture_registry();
+
+	/**
+	 * @brief Sets the profiler the scopes of ScopedDebugLabel are measured with, see RenderContext::set_gpu_profiling
+	 * @param profiler The profiler, or null to stop measuring
+	 */
+	void set_gpu_profiler(GpuProfiler *profiler);
+
+	GpuProfiler *get_gpu_profiler() const;
+
   private:
 	const PhysicalDevice &gpu;
 
@@ -230,5 +395,49 @@ class Device : public vkb::core::VulkanResource<vkb::BindingType::C, VkDevice>
 	std::unique_ptr<FencePool> fence_pool;
 
 	ResourceCache resource_cache;
+
+	VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+
+	bool descriptor_buffers{false};
+
+	uint32_t max_push_descriptors{0};
+
+	DynamicPipelineStateFlags dynamic_pipeline_state_flags{0};
+
+	bool graphics_pipeline_libraries{false};
+
+	bool shader_objects{false};
+
+	bool timeline_semaphores{false};
+
+	bool synchronization2{false};
+
+	bool dynamic_rendering{false};
+
+	bool dynamic_rendering_local_read{false};
+
+	bool present_wait{false};
+
+	bool fragment_shading_rates{false};
+
+	VkPhysicalDeviceMeshShaderPropertiesEXT mesh_shader_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_PROPERTIES_EXT};
+
+	bool mesh_shaders{false};
+
+	bool float16_arithmetic{false};
+
+	bool portability_subset{false};
+
+	bool descriptor_update_templates{false};
+
+	std::unique_ptr<AttachmentAllocator> attachment_allocator;
+
+	std::unique_ptr<TransientResourcePool> transient_resource_pool;
+
+	RetireQueue retire_queue;
+
+	TextureRegistry texture_registry;
+
+	GpuProfiler *gpu_profiler{nullptr};
 };
 }        // namespace vkb
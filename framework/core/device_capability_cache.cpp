@@ -0,0 +1,307 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_capability_cache.h"
+
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "common/helpers.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+
+namespace vkb
+{
+namespace
+{
+// Bump the version whenever the file layout changes
+constexpr uint32_t CAPABILITY_CACHE_MAGIC   = 0x43444b56;        // "VKDC"
+constexpr uint32_t CAPABILITY_CACHE_VERSION = 1;
+
+struct CapabilityCacheFileHeader
+{
+	uint32_t magic;
+
+	uint32_t version;
+
+	uint32_t vendor_id;
+
+	uint32_t device_id;
+
+	uint32_t driver_version;
+
+	uint8_t pipeline_cache_uuid[VK_UUID_SIZE];
+
+	uint32_t extension_count;
+
+	uint32_t format_count;
+
+	uint32_t feature_count;
+};
+
+struct FormatEntry
+{
+	VkFormat format;
+
+	VkFormatProperties properties;
+};
+
+struct FeatureEntry
+{
+	VkStructureType type;
+
+	uint32_t size;
+};
+
+inline filesystem::Path get_cache_directory()
+{
+	return filesystem::get()->temp_directory() / "vulkan_samples" / "device_capabilities";
+}
+
+template <class T>
+void append(std::vector<uint8_t> &data, const T *values, size_t count)
+{
+	auto bytes = reinterpret_cast<const uint8_t *>(values);
+	data.insert(data.end(), bytes, bytes + count * sizeof(T));
+}
+
+/**
+ * @brief Copies count values from data at offset, and advances offset past them
+ * @return Whether data holds the values
+ */
+template <class T>
+bool read(const std::vector<uint8_t> &data, size_t &offset, T *values, size_t count)
+{
+	if (data.size() < offset || (data.size() - offset) / sizeof(T) < count)
+	{
+		return false;
+	}
+
+	std::memcpy(values, data.data() + offset, count * sizeof(T));
+	offset += count * sizeof(T);
+
+	return true;
+}
+}        // namespace
+
+DeviceCapabilityCache::DeviceCapabilityCache(const VkPhysicalDeviceProperties &properties) :
+    properties{properties},
+    path{(get_cache_directory() / fmt::format("{:08x}_{:08x}.bin", properties.vendorID, properties.deviceID)).string()}
+{
+	load();
+}
+
+const std::vector<VkExtensionProperties> *DeviceCapabilityCache::find_extensions() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	return has_extensions ? &extensions : nullptr;
+}
+
+void DeviceCapabilityCache::set_extensions(const std::vector<VkExtensionProperties> &new_extensions)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	extensions     = new_extensions;
+	has_extensions = true;
+	modified       = true;
+}
+
+bool DeviceCapabilityCache::find_format_properties(VkFormat format, VkFormatProperties &properties_out) const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	auto it = format_properties.find(format);
+	if (it == format_properties.end())
+	{
+		return false;
+	}
+
+	properties_out = it->second;
+
+	return true;
+}
+
+void DeviceCapabilityCache::set_format_properties(VkFormat format, const VkFormatProperties &properties_in)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	format_properties[format] = properties_in;
+	modified                  = true;
+}
+
+bool DeviceCapabilityCache::find_features(VkStructureType type, void *features_out, size_t size) const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	auto it = features.find(type);
+	if (it == features.end() || size < sizeof(VkBaseOutStructure) || it->second.size() != size - sizeof(VkBaseOutStructure))
+	{
+		return false;
+	}
+
+	std::memcpy(static_cast<uint8_t *>(features_out) + sizeof(VkBaseOutStructure), it->second.data(), it->second.size());
+
+	return true;
+}
+
+void DeviceCapabilityCache::set_features(VkStructureType type, const void *features_in, size_t size)
+{
+	if (size < sizeof(VkBaseOutStructure))
+	{
+		return;
+	}
+
+	auto members = static_cast<const uint8_t *>(features_in) + sizeof(VkBaseOutStructure);
+
+	std::lock_guard<std::mutex> lock{mutex};
+
+	features[type] = std::vector<uint8_t>(members, members + size - sizeof(VkBaseOutStructure));
+	modified       = true;
+}
+
+void DeviceCapabilityCache::save()
+{
+	std::vector<uint8_t> data;
+
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+
+		if (!modified)
+		{
+			return;
+		}
+
+		CapabilityCacheFileHeader header{CAPABILITY_CACHE_MAGIC, CAPABILITY_CACHE_VERSION, properties.vendorID, properties.deviceID, properties.driverVersion};
+		std::memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+		header.extension_count = has_extensions ? to_u32(extensions.size()) : ~0U;
+		header.format_count    = to_u32(format_properties.size());
+		header.feature_count   = to_u32(features.size());
+
+		append(data, &header, 1);
+		append(data, extensions.data(), has_extensions ? extensions.size() : 0);
+
+		for (auto &format : format_properties)
+		{
+			FormatEntry entry{format.first, format.second};
+			append(data, &entry, 1);
+		}
+
+		for (auto &feature : features)
+		{
+			FeatureEntry entry{feature.first, to_u32(feature.second.size())};
+			append(data, &entry, 1);
+			append(data, feature.second.data(), feature.second.size());
+		}
+
+		modified = false;
+	}
+
+	try
+	{
+		filesystem::get()->write_file_atomic(path, data);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write device capabilities {}: {}", path, e.what());
+	}
+}
+
+void DeviceCapabilityCache::load()
+{
+	std::vector<uint8_t> data;
+
+	try
+	{
+		auto fs = filesystem::get();
+		if (!fs->is_file(path))
+		{
+			return;
+		}
+
+		data = fs->read_file_binary(path);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read device capabilities {}: {}", path, e.what());
+		return;
+	}
+
+	size_t                    offset = 0;
+	CapabilityCacheFileHeader header{};
+
+	if (!read(data, offset, &header, 1) ||
+	    header.magic != CAPABILITY_CACHE_MAGIC ||
+	    header.version != CAPABILITY_CACHE_VERSION ||
+	    header.vendor_id != properties.vendorID ||
+	    header.device_id != properties.deviceID ||
+	    header.driver_version != properties.driverVersion ||
+	    std::memcmp(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		LOGI("Discarding device capabilities {}, they were saved by another driver or device", path);
+		return;
+	}
+
+	// A truncated file is discarded as a whole
+	bool valid = true;
+
+	std::vector<VkExtensionProperties> loaded_extensions;
+	if (header.extension_count != ~0U)
+	{
+		loaded_extensions.resize(header.extension_count);
+		valid = read(data, offset, loaded_extensions.data(), loaded_extensions.size());
+	}
+
+	std::unordered_map<VkFormat, VkFormatProperties> loaded_formats;
+	for (uint32_t i = 0; valid && i < header.format_count; ++i)
+	{
+		FormatEntry entry;
+		valid = read(data, offset, &entry, 1);
+		if (valid)
+		{
+			loaded_formats[entry.format] = entry.properties;
+		}
+	}
+
+	std::map<VkStructureType, std::vector<uint8_t>> loaded_features;
+	for (uint32_t i = 0; valid && i < header.feature_count; ++i)
+	{
+		FeatureEntry entry;
+		valid = read(data, offset, &entry, 1);
+		if (valid)
+		{
+			std::vector<uint8_t> members(entry.size);
+			valid = read(data, offset, members.data(), members.size());
+			loaded_features[entry.type] = std::move(members);
+		}
+	}
+
+	if (!valid)
+	{
+		LOGW("Discarding device capabilities {}, the file is truncated", path);
+		return;
+	}
+
+	extensions        = std::move(loaded_extensions);
+	has_extensions    = header.extension_count != ~0U;
+	format_properties = std::move(loaded_formats);
+	features          = std::move(loaded_features);
+
+	LOGI("Loaded device capabilities {} ({} extensions, {} formats, {} feature structs)", path, extensions.size(), format_properties.size(), features.size());
+}
+}        // namespace vkb
@@ -0,0 +1,102 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/**
+ * @brief The capabilities of a physical device probed by the previous launches, loaded from and saved to the temporary storage directory
+ *
+ * The device extensions, the format properties and the extension feature structs queried through PhysicalDevice are
+ * recorded, so that later launches, and the capability checks of the samples, look them up instead of querying the driver.
+ * The saved capabilities are only loaded back for the same device and driver, as told by the vendor and device IDs,
+ * the driver version and the pipeline cache UUID, which changes with the device and the driver build.
+ */
+class DeviceCapabilityCache
+{
+  public:
+	/**
+	 * @brief Loads the capabilities saved for a device, if they are compatible
+	 * @param properties The properties of the physical device
+	 */
+	explicit DeviceCapabilityCache(const VkPhysicalDeviceProperties &properties);
+
+	/**
+	 * @return The device extensions, nullptr if they were not recorded
+	 */
+	const std::vector<VkExtensionProperties> *find_extensions() const;
+
+	void set_extensions(const std::vector<VkExtensionProperties> &extensions);
+
+	/**
+	 * @brief Looks up the recorded properties of a format
+	 * @return Whether the properties were recorded
+	 */
+	bool find_format_properties(VkFormat format, VkFormatProperties &format_properties) const;
+
+	void set_format_properties(VkFormat format, const VkFormatProperties &format_properties);
+
+	/**
+	 * @brief Looks up a recorded extension feature struct, and copies its members after sType and pNext
+	 * @param features The struct to fill, of its sType
+	 * @param size The size of the struct
+	 * @return Whether the struct was recorded with this size
+	 */
+	bool find_features(VkStructureType type, void *features, size_t size) const;
+
+	/**
+	 * @brief Records the members of an extension feature struct after sType and pNext
+	 */
+	void set_features(VkStructureType type, const void *features, size_t size);
+
+	/**
+	 * @brief Writes the capabilities to storage if some were recorded since they were loaded or saved
+	 *        The file is replaced atomically, failures are logged and otherwise ignored.
+	 */
+	void save();
+
+  private:
+	void load();
+
+	VkPhysicalDeviceProperties properties;
+
+	std::string path;
+
+	mutable std::mutex mutex;
+
+	std::vector<VkExtensionProperties> extensions;
+
+	bool has_extensions{false};
+
+	std::unordered_map<VkFormat, VkFormatProperties> format_properties;
+
+	/// Members of the extension feature structs after sType and pNext, ordered so that the saved file is stable
+	std::map<VkStructureType, std::vector<uint8_t>> features;
+
+	/// Whether capabilities were recorded since they were loaded or saved
+	bool modified{false};
+};
+}        // namespace vkb
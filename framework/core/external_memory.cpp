@@ -0,0 +1,459 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/external_memory.h"
+
+#include "common/helpers.h"
+#include "core/device.h"
+
+#include <cassert>
+
+#ifdef _WIN32
+#	include <aclapi.h>
+#	include <dxgi1_2.h>
+#endif
+
+namespace vkb
+{
+namespace
+{
+#ifdef _WIN32
+/**
+ * @brief Security attributes granting read and write access to exported handles, which the opaque Win32 handle types require
+ */
+class WinSecurityAttributes
+{
+  public:
+	WinSecurityAttributes()
+	{
+		security_descriptor = (PSECURITY_DESCRIPTOR) calloc(1, SECURITY_DESCRIPTOR_MIN_LENGTH + 2 * sizeof(void **));
+
+		PSID *ppSID = (PSID *) ((PBYTE) security_descriptor + SECURITY_DESCRIPTOR_MIN_LENGTH);
+		PACL *ppACL = (PACL *) ((PBYTE) ppSID + sizeof(PSID *));
+
+		InitializeSecurityDescriptor(security_descriptor, SECURITY_DESCRIPTOR_REVISION);
+
+		SID_IDENTIFIER_AUTHORITY sid_identifier_authority = SECURITY_WORLD_SID_AUTHORITY;
+		AllocateAndInitializeSid(&sid_identifier_authority, 1, SECURITY_WORLD_RID, 0, 0, 0, 0, 0, 0, 0, ppSID);
+
+		EXPLICIT_ACCESS explicit_access{};
+		explicit_access.grfAccessPermissions = STANDARD_RIGHTS_ALL | SPECIFIC_RIGHTS_ALL;
+		explicit_access.grfAccessMode        = SET_ACCESS;
+		explicit_access.grfInheritance       = INHERIT_ONLY;
+		explicit_access.Trustee.TrusteeForm  = TRUSTEE_IS_SID;
+		explicit_access.Trustee.TrusteeType  = TRUSTEE_IS_WELL_KNOWN_GROUP;
+		explicit_access.Trustee.ptstrName    = (LPTSTR) *ppSID;
+		SetEntriesInAcl(1, &explicit_access, nullptr, ppACL);
+
+		SetSecurityDescriptorDacl(security_descriptor, TRUE, *ppACL, FALSE);
+
+		security_attributes.nLength              = sizeof(SECURITY_ATTRIBUTES);
+		security_attributes.lpSecurityDescriptor = security_descriptor;
+		security_attributes.bInheritHandle       = TRUE;
+	}
+
+	~WinSecurityAttributes()
+	{
+		PSID *ppSID = (PSID *) ((PBYTE) security_descriptor + SECURITY_DESCRIPTOR_MIN_LENGTH);
+		PACL *ppACL = (PACL *) ((PBYTE) ppSID + sizeof(PSID *));
+
+		if (*ppSID)
+		{
+			FreeSid(*ppSID);
+		}
+
+		if (*ppACL)
+		{
+			LocalFree(*ppACL);
+		}
+
+		free(security_descriptor);
+	}
+
+	SECURITY_ATTRIBUTES *operator&()
+	{
+		return &security_attributes;
+	}
+
+  private:
+	SECURITY_ATTRIBUTES security_attributes;
+
+	PSECURITY_DESCRIPTOR security_descriptor;
+};
+#endif
+
+/**
+ * @brief Allocates dedicated exportable memory for the requirements of a resource
+ */
+VkDeviceMemory allocate_exportable_memory(Device &device, const VkMemoryRequirements &memory_requirements, VkMemoryPropertyFlags memory_properties,
+                                          VkImage image, VkBuffer buffer)
+{
+	// Drivers importing the memory may need to know the resource it backs
+	VkMemoryDedicatedAllocateInfo dedicated_allocate_info{VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO};
+	dedicated_allocate_info.image  = image;
+	dedicated_allocate_info.buffer = buffer;
+
+	VkExportMemoryAllocateInfo export_memory_allocate_info{VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO};
+	export_memory_allocate_info.pNext       = &dedicated_allocate_info;
+	export_memory_allocate_info.handleTypes = get_external_memory_handle_type();
+
+#ifdef _WIN32
+	WinSecurityAttributes            win_security_attributes;
+	VkExportMemoryWin32HandleInfoKHR export_memory_win32_handle_info{VK_STRUCTURE_TYPE_EXPORT_MEMORY_WIN32_HANDLE_INFO_KHR};
+	export_memory_win32_handle_info.pNext       = export_memory_allocate_info.pNext;
+	export_memory_win32_handle_info.pAttributes = &win_security_attributes;
+	export_memory_win32_handle_info.dwAccess    = DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE;
+	export_memory_allocate_info.pNext           = &export_memory_win32_handle_info;
+#endif
+
+	VkMemoryAllocateInfo memory_allocate_info{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+	memory_allocate_info.pNext           = &export_memory_allocate_info;
+	memory_allocate_info.allocationSize  = memory_requirements.size;
+	memory_allocate_info.memoryTypeIndex = device.get_memory_type(memory_requirements.memoryTypeBits, memory_properties);
+
+	VkDeviceMemory memory{VK_NULL_HANDLE};
+	VK_CHECK(vkAllocateMemory(device.get_handle(), &memory_allocate_info, nullptr, &memory));
+
+	return memory;
+}
+
+ExternalHandle export_memory(Device &device, VkDeviceMemory memory)
+{
+	ExternalHandle handle;
+
+#ifdef _WIN32
+	VkMemoryGetWin32HandleInfoKHR get_handle_info{VK_STRUCTURE_TYPE_MEMORY_GET_WIN32_HANDLE_INFO_KHR};
+	get_handle_info.memory     = memory;
+	get_handle_info.handleType = get_external_memory_handle_type();
+	VK_CHECK(vkGetMemoryWin32HandleKHR(device.get_handle(), &get_handle_info, &handle));
+#else
+	VkMemoryGetFdInfoKHR get_handle_info{VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR};
+	get_handle_info.memory     = memory;
+	get_handle_info.handleType = get_external_memory_handle_type();
+	VK_CHECK(vkGetMemoryFdKHR(device.get_handle(), &get_handle_info, &handle));
+#endif
+
+	return handle;
+}
+}        // namespace
+
+VkExternalMemoryHandleTypeFlagBits get_external_memory_handle_type()
+{
+	// Windows 8 and older need the _KMT handle types, which are not supported
+#ifdef _WIN32
+	return VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT;
+#else
+	return VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+#endif
+}
+
+VkExternalSemaphoreHandleTypeFlagBits get_external_semaphore_handle_type()
+{
+#ifdef _WIN32
+	return VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_WIN32_BIT;
+#else
+	return VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+#endif
+}
+
+ExternalSemaphore::ExternalSemaphore(Device &device) :
+    device{device}
+{
+	VkExportSemaphoreCreateInfo export_semaphore_create_info{VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO};
+	export_semaphore_create_info.handleTypes = get_external_semaphore_handle_type();
+
+#ifdef _WIN32
+	WinSecurityAttributes               win_security_attributes;
+	VkExportSemaphoreWin32HandleInfoKHR export_semaphore_handle_info{VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_WIN32_HANDLE_INFO_KHR};
+	export_semaphore_handle_info.pAttributes = &win_security_attributes;
+	export_semaphore_handle_info.dwAccess    = DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE;
+	export_semaphore_create_info.pNext       = &export_semaphore_handle_info;
+#endif
+
+	VkSemaphoreCreateInfo semaphore_create_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+	semaphore_create_info.pNext = &export_semaphore_create_info;
+
+	VK_CHECK(vkCreateSemaphore(device.get_handle(), &semaphore_create_info, nullptr, &handle));
+}
+
+ExternalSemaphore::~ExternalSemaphore()
+{
+	vkDestroySemaphore(device.get_handle(), handle, nullptr);
+}
+
+VkSemaphore ExternalSemaphore::get_handle() const
+{
+	return handle;
+}
+
+ExternalHandle ExternalSemaphore::export_handle() const
+{
+	ExternalHandle external_handle;
+
+#ifdef _WIN32
+	VkSemaphoreGetWin32HandleInfoKHR get_handle_info{VK_STRUCTURE_TYPE_SEMAPHORE_GET_WIN32_HANDLE_INFO_KHR};
+	get_handle_info.semaphore  = handle;
+	get_handle_info.handleType = get_external_semaphore_handle_type();
+	VK_CHECK(vkGetSemaphoreWin32HandleKHR(device.get_handle(), &get_handle_info, &external_handle));
+#else
+	VkSemaphoreGetFdInfoKHR get_handle_info{VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR};
+	get_handle_info.semaphore  = handle;
+	get_handle_info.handleType = get_external_semaphore_handle_type();
+	VK_CHECK(vkGetSemaphoreFdKHR(device.get_handle(), &get_handle_info, &external_handle));
+#endif
+
+	return external_handle;
+}
+
+ExternalBuffer::ExternalBuffer(Device &device, const VkBufferCreateInfo &info, VkMemoryPropertyFlags memory_properties) :
+    device{device},
+    size{info.size}
+{
+	VkExternalMemoryBufferCreateInfo external_memory_buffer_info{VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO};
+	external_memory_buffer_info.pNext       = info.pNext;
+	external_memory_buffer_info.handleTypes = get_external_memory_handle_type();
+
+	VkBufferCreateInfo buffer_info = info;
+	buffer_info.pNext              = &external_memory_buffer_info;
+
+	VK_CHECK(vkCreateBuffer(device.get_handle(), &buffer_info, nullptr, &handle));
+
+	VkMemoryRequirements memory_requirements;
+	vkGetBufferMemoryRequirements(device.get_handle(), handle, &memory_requirements);
+
+	memory      = allocate_exportable_memory(device, memory_requirements, memory_properties, VK_NULL_HANDLE, handle);
+	memory_size = memory_requirements.size;
+
+	VK_CHECK(vkBindBufferMemory(device.get_handle(), handle, memory, 0));
+}
+
+ExternalBuffer::~ExternalBuffer()
+{
+	vkDestroyBuffer(device.get_handle(), handle, nullptr);
+	vkFreeMemory(device.get_handle(), memory, nullptr);
+}
+
+VkBuffer ExternalBuffer::get_handle() const
+{
+	return handle;
+}
+
+VkDeviceMemory ExternalBuffer::get_memory() const
+{
+	return memory;
+}
+
+VkDeviceSize ExternalBuffer::get_size() const
+{
+	return size;
+}
+
+VkDeviceSize ExternalBuffer::get_memory_size() const
+{
+	return memory_size;
+}
+
+ExternalHandle ExternalBuffer::export_memory_handle() const
+{
+	return export_memory(device, memory);
+}
+
+ExternalImage::ExternalImage(Device &device, const VkImageCreateInfo &info) :
+    device{device},
+    extent{info.extent},
+    format{info.format}
+{
+	VkExternalMemoryImageCreateInfo external_memory_image_info{VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO};
+	external_memory_image_info.pNext       = info.pNext;
+	external_memory_image_info.handleTypes = get_external_memory_handle_type();
+
+	VkImageCreateInfo image_info = info;
+	image_info.pNext             = &external_memory_image_info;
+
+	VK_CHECK(vkCreateImage(device.get_handle(), &image_info, nullptr, &handle));
+
+	VkMemoryRequirements memory_requirements;
+	vkGetImageMemoryRequirements(device.get_handle(), handle, &memory_requirements);
+
+	memory      = allocate_exportable_memory(device, memory_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, handle, VK_NULL_HANDLE);
+	memory_size = memory_requirements.size;
+
+	VK_CHECK(vkBindImageMemory(device.get_handle(), handle, memory, 0));
+
+	VkImageViewCreateInfo view_info{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+	view_info.image            = handle;
+	view_info.format           = info.format;
+	view_info.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, info.mipLevels, 0, info.arrayLayers};
+
+	switch (info.imageType)
+	{
+		case VK_IMAGE_TYPE_1D:
+			view_info.viewType = info.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_1D_ARRAY : VK_IMAGE_VIEW_TYPE_1D;
+			break;
+		case VK_IMAGE_TYPE_3D:
+			view_info.viewType = VK_IMAGE_VIEW_TYPE_3D;
+			break;
+		default:
+			view_info.viewType = info.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+			break;
+	}
+
+	VK_CHECK(vkCreateImageView(device.get_handle(), &view_info, nullptr, &view));
+}
+
+ExternalImage::~ExternalImage()
+{
+	vkDestroyImageView(device.get_handle(), view, nullptr);
+	vkDestroyImage(device.get_handle(), handle, nullptr);
+	vkFreeMemory(device.get_handle(), memory, nullptr);
+}
+
+VkImage ExternalImage::get_handle() const
+{
+	return handle;
+}
+
+VkImageView ExternalImage::get_view() const
+{
+	return view;
+}
+
+VkDeviceMemory ExternalImage::get_memory() const
+{
+	return memory;
+}
+
+VkDeviceSize ExternalImage::get_memory_size() const
+{
+	return memory_size;
+}
+
+const VkExtent3D &ExternalImage::get_extent() const
+{
+	return extent;
+}
+
+VkFormat ExternalImage::get_format() const
+{
+	return format;
+}
+
+ExternalHandle ExternalImage::export_memory_handle() const
+{
+	return export_memory(device, memory);
+}
+
+SharedResourceRing::SharedResourceRing(Device &device, uint32_t slot_count, const VkBufferCreateInfo &info) :
+    slots(slot_count)
+{
+	for (auto &slot : slots)
+	{
+		slot.buffer = std::make_unique<ExternalBuffer>(device, info);
+	}
+
+	create_semaphores(device);
+}
+
+SharedResourceRing::SharedResourceRing(Device &device, uint32_t slot_count, const VkImageCreateInfo &info) :
+    slots(slot_count)
+{
+	for (auto &slot : slots)
+	{
+		slot.image = std::make_unique<ExternalImage>(device, info);
+	}
+
+	create_semaphores(device);
+}
+
+void SharedResourceRing::create_semaphores(Device &device)
+{
+	assert(!slots.empty() && "A shared resource ring needs at least one slot");
+
+	for (auto &slot : slots)
+	{
+		slot.produced = std::make_unique<ExternalSemaphore>(device);
+		slot.consumed = std::make_unique<ExternalSemaphore>(device);
+	}
+}
+
+uint32_t SharedResourceRing::get_slot_count() const
+{
+	return to_u32(slots.size());
+}
+
+SharedResourceRing::Slot &SharedResourceRing::get_slot(uint32_t index)
+{
+	return slots[index];
+}
+
+bool SharedResourceRing::can_produce() const
+{
+	return producing_slot == ~0u && produced_count - consumed_count < slots.size();
+}
+
+uint32_t SharedResourceRing::begin_produce(bool &wait_consumed)
+{
+	assert(can_produce() && "Every slot of the ring waits for the consumer");
+
+	producing_slot = static_cast<uint32_t>(produced_count % slots.size());
+
+	auto &slot = slots[producing_slot];
+
+	// The wait unsignals the semaphore, so that the consumer can signal it again
+	wait_consumed         = slot.consumed_pending;
+	slot.consumed_pending = false;
+
+	return producing_slot;
+}
+
+void SharedResourceRing::end_produce()
+{
+	assert(producing_slot != ~0u && "No slot was taken with begin_produce()");
+
+	producing_slot = ~0u;
+	produced_count++;
+}
+
+bool SharedResourceRing::can_consume() const
+{
+	return consuming_slot == ~0u && consumed_count < produced_count;
+}
+
+uint32_t SharedResourceRing::begin_consume()
+{
+	assert(can_consume() && "No slot was produced");
+
+	consuming_slot = static_cast<uint32_t>(consumed_count % slots.size());
+
+	return consuming_slot;
+}
+
+void SharedResourceRing::end_consume()
+{
+	assert(consuming_slot != ~0u && "No slot was taken with begin_consume()");
+
+	slots[consuming_slot].consumed_pending = true;
+
+	consuming_slot = ~0u;
+	consumed_count++;
+}
+
+uint64_t SharedResourceRing::get_produced_count() const
+{
+	return produced_count;
+}
+}        // namespace vkb
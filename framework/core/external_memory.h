@@ -0,0 +1,292 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+
+#ifdef _WIN32
+/// A Win32 HANDLE, exported with the opaque Win32 handle types
+using ExternalHandle = void *;
+#else
+/// A file descriptor, exported with the opaque fd handle types
+using ExternalHandle = int;
+#endif
+
+/**
+ * @return The opaque memory handle type of the platform, which OpenCL and OpenGL import
+ */
+VkExternalMemoryHandleTypeFlagBits get_external_memory_handle_type();
+
+/**
+ * @return The opaque semaphore handle type of the platform, which OpenCL and OpenGL import
+ */
+VkExternalSemaphoreHandleTypeFlagBits get_external_semaphore_handle_type();
+
+/**
+ * @brief A binary semaphore which can be exported to another API, to order its work with the one of Vulkan
+ */
+class ExternalSemaphore
+{
+  public:
+	explicit ExternalSemaphore(Device &device);
+
+	ExternalSemaphore(const ExternalSemaphore &) = delete;
+
+	ExternalSemaphore(ExternalSemaphore &&) = delete;
+
+	~ExternalSemaphore();
+
+	ExternalSemaphore &operator=(const ExternalSemaphore &) = delete;
+
+	ExternalSemaphore &operator=(ExternalSemaphore &&) = delete;
+
+	VkSemaphore get_handle() const;
+
+	/**
+	 * @brief Exports a new handle to the semaphore, which the importing API takes ownership of
+	 */
+	ExternalHandle export_handle() const;
+
+  private:
+	Device &device;
+
+	VkSemaphore handle{VK_NULL_HANDLE};
+};
+
+/**
+ * @brief A buffer in dedicated memory which can be exported to another API, so that both read and write it without copies
+ */
+class ExternalBuffer
+{
+  public:
+	/**
+	 * @param device The device
+	 * @param info The creation details of the buffer, the external memory handle type is added to them
+	 * @param memory_properties The properties of the memory the buffer is bound to
+	 */
+	ExternalBuffer(Device &device, const VkBufferCreateInfo &info, VkMemoryPropertyFlags memory_properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	ExternalBuffer(const ExternalBuffer &) = delete;
+
+	ExternalBuffer(ExternalBuffer &&) = delete;
+
+	~ExternalBuffer();
+
+	ExternalBuffer &operator=(const ExternalBuffer &) = delete;
+
+	ExternalBuffer &operator=(ExternalBuffer &&) = delete;
+
+	VkBuffer get_handle() const;
+
+	VkDeviceMemory get_memory() const;
+
+	VkDeviceSize get_size() const;
+
+	/**
+	 * @return The size of the memory, which the importing API may need instead of the size of the buffer
+	 */
+	VkDeviceSize get_memory_size() const;
+
+	/**
+	 * @brief Exports a new handle to the memory of the buffer, which the importing API takes ownership of
+	 */
+	ExternalHandle export_memory_handle() const;
+
+  private:
+	Device &device;
+
+	VkBuffer handle{VK_NULL_HANDLE};
+
+	VkDeviceMemory memory{VK_NULL_HANDLE};
+
+	VkDeviceSize size{0};
+
+	VkDeviceSize memory_size{0};
+};
+
+/**
+ * @brief An image in dedicated memory which can be exported to another API, with a view of all its subresources
+ */
+class ExternalImage
+{
+  public:
+	/**
+	 * @param device The device
+	 * @param info The creation details of the image, the external memory handle type is added to them
+	 */
+	ExternalImage(Device &device, const VkImageCreateInfo &info);
+
+	ExternalImage(const ExternalImage &) = delete;
+
+	ExternalImage(ExternalImage &&) = delete;
+
+	~ExternalImage();
+
+	ExternalImage &operator=(const ExternalImage &) = delete;
+
+	ExternalImage &operator=(ExternalImage &&) = delete;
+
+	VkImage get_handle() const;
+
+	VkImageView get_view() const;
+
+	VkDeviceMemory get_memory() const;
+
+	VkDeviceSize get_memory_size() const;
+
+	const VkExtent3D &get_extent() const;
+
+	VkFormat get_format() const;
+
+	/**
+	 * @brief Exports a new handle to the memory of the image, which the importing API takes ownership of
+	 */
+	ExternalHandle export_memory_handle() const;
+
+  private:
+	Device &device;
+
+	VkImage handle{VK_NULL_HANDLE};
+
+	VkImageView view{VK_NULL_HANDLE};
+
+	VkDeviceMemory memory{VK_NULL_HANDLE};
+
+	VkDeviceSize memory_size{0};
+
+	VkExtent3D extent;
+
+	VkFormat format;
+};
+
+/**
+ * @brief A ring of buffers or images shared with another API, so that the producer fills one while the consumer reads another
+ *
+ * Each slot has a resource and two exported semaphores: the producer signals produced once it filled the slot, and the
+ * consumer waits for it, then signals consumed once it read the slot, which the producer waits for before filling it again.
+ * The hand-offs only order the work of the two APIs on their GPU queues, neither CPU waits for the other. Up to
+ * slot_count slots may be produced ahead of the consumer.
+ *
+ * Binary semaphores must be signaled before a wait on them is submitted, so the ring tracks which slots the producer must
+ * wait for: a slot which was never consumed has no pending signal.
+ */
+class SharedResourceRing
+{
+  public:
+	struct Slot
+	{
+		/// Set for a ring of buffers
+		std::unique_ptr<ExternalBuffer> buffer;
+
+		/// Set for a ring of images
+		std::unique_ptr<ExternalImage> image;
+
+		/// Signaled by the producer once the slot is filled
+		std::unique_ptr<ExternalSemaphore> produced;
+
+		/// Signaled by the consumer once the slot is read
+		std::unique_ptr<ExternalSemaphore> consumed;
+
+		/// Whether consumed was signaled, and not waited for by the producer yet
+		bool consumed_pending{false};
+	};
+
+	/**
+	 * @brief Creates a ring of buffers
+	 */
+	SharedResourceRing(Device &device, uint32_t slot_count, const VkBufferCreateInfo &info);
+
+	/**
+	 * @brief Creates a ring of images
+	 */
+	SharedResourceRing(Device &device, uint32_t slot_count, const VkImageCreateInfo &info);
+
+	SharedResourceRing(const SharedResourceRing &) = delete;
+
+	SharedResourceRing(SharedResourceRing &&) = delete;
+
+	~SharedResourceRing() = default;
+
+	SharedResourceRing &operator=(const SharedResourceRing &) = delete;
+
+	SharedResourceRing &operator=(SharedResourceRing &&) = delete;
+
+	uint32_t get_slot_count() const;
+
+	Slot &get_slot(uint32_t index);
+
+	/**
+	 * @return Whether the producer can fill a slot, false if every slot waits for the consumer
+	 */
+	bool can_produce() const;
+
+	/**
+	 * @brief Takes the next slot to fill
+	 * @param[out] wait_consumed Whether the producer must wait for the consumed semaphore of the slot before filling it
+	 * @return The index of the slot
+	 */
+	uint32_t begin_produce(bool &wait_consumed);
+
+	/**
+	 * @brief Hands the slot taken with begin_produce() to the consumer, once the signal of its produced semaphore is submitted
+	 */
+	void end_produce();
+
+	/**
+	 * @return Whether a produced slot waits for the consumer
+	 */
+	bool can_consume() const;
+
+	/**
+	 * @brief Takes the oldest produced slot, whose produced semaphore the consumer must wait for
+	 * @return The index of the slot
+	 */
+	uint32_t begin_consume();
+
+	/**
+	 * @brief Hands the slot taken with begin_consume() back to the producer, once the signal of its consumed semaphore is submitted
+	 */
+	void end_consume();
+
+	/**
+	 * @return The number of slots produced since the ring was created, to measure the throughput of the shared path
+	 */
+	uint64_t get_produced_count() const;
+
+  private:
+	void create_semaphores(Device &device);
+
+	std::vector<Slot> slots;
+
+	uint64_t produced_count{0};
+
+	uint64_t consumed_count{0};
+
+	/// Slot taken by begin_produce() or begin_consume(), or ~0u
+	uint32_t producing_slot{~0u};
+
+	uint32_t consuming_slot{~0u};
+};
+}        // namespace vkb
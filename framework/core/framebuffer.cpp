@@ -31,12 +31,21 @@ const VkExtent2D &Framebuffer::get_extent() const
 	return extent;
 }
 
+const std::vector<VkImageView> &Framebuffer::get_attachments() const
+{
+	return attachments;
+}
+
+VkRenderPass Framebuffer::get_render_pass() const
+{
+	return render_pass;
+}
+
 Framebuffer::Framebuffer(Device &device, const RenderTarget &render_target, const RenderPass &render_pass) :
     device{device},
-    extent{render_target.get_extent()}
+    extent{render_target.get_extent()},
+    render_pass{render_pass.get_handle()}
 {
-	std::vector<VkImageView> attachments;
-
 	for (auto &view : render_target.get_views())
 	{
 		attachments.emplace_back(view.get_handle());
@@ -62,7 +71,9 @@ Framebuffer::Framebuffer(Device &device, const RenderTarget &render_target, cons
 Framebuffer::Framebuffer(Framebuffer &&other) :
     device{other.device},
     handle{other.handle},
-    extent{other.extent}
+    extent{other.extent},
+    attachments{std::move(other.attachments)},
+    render_pass{other.render_pass}
 {
 	other.handle = VK_NULL_HANDLE;
 }
@@ -45,11 +45,22 @@ class Framebuffer
 
 	const VkExtent2D &get_extent() const;
 
+	/**
+	 * @return The image views the framebuffer was created with
+	 */
+	const std::vector<VkImageView> &get_attachments() const;
+
+	VkRenderPass get_render_pass() const;
+
   private:
 	Device &device;
 
 	VkFramebuffer handle{VK_NULL_HANDLE};
 
 	VkExtent2D extent{};
+
+	std::vector<VkImageView> attachments;
+
+	VkRenderPass render_pass{VK_NULL_HANDLE};
 };
 }        // namespace vkb
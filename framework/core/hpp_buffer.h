@@ -112,6 +112,10 @@ class HPPBuffer : public allocated::HPPAllocated<vk::Buffer>
 
   private:
 	vk::DeviceSize size = 0;
+
+	/// Mirrors vkb::core::Buffer, state tracking is not supported by the hpp framework
+	vk::PipelineStageFlags stage_mask;
+	vk::AccessFlags        access_mask;
 };
 
 }        // namespace core
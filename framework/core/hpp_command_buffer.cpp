@@ -1,4 +1,4 @@
-/* Copyright (c) 2023-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -87,16 +87,23 @@ vk::Result HPPCommandBuffer::begin(vk::CommandBufferUsageFlags flags, const vkb:
 
 	if (level == vk::CommandBufferLevel::eSecondary)
 	{
-		assert((render_pass && framebuffer) && "Render pass and framebuffer must be provided when calling begin from a secondary one");
+		assert(render_pass && "A render pass must be provided when calling begin from a secondary one");
 
 		current_render_pass.render_pass = render_pass;
 		current_render_pass.framebuffer = framebuffer;
 
 		inheritance.renderPass  = current_render_pass.render_pass->get_handle();
-		inheritance.framebuffer = current_render_pass.framebuffer->get_handle();
+		inheritance.framebuffer = current_render_pass.framebuffer ? current_render_pass.framebuffer->get_handle() : nullptr;
 		inheritance.subpass     = subpass_index;
 
 		begin_info.pInheritanceInfo = &inheritance;
+
+		// Match the pipeline state to the subpass being continued
+		pipeline_state.set_subpass_index(subpass_index);
+
+		auto blend_state = pipeline_state.get_color_blend_state();
+		blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(subpass_index));
+		pipeline_state.set_color_blend_state(blend_state);
 	}
 
 	get_handle().begin(begin_info);
@@ -133,10 +140,11 @@ void HPPCommandBuffer::begin_render_pass(const vkb::rendering::HPPRenderTarget &
 {
 	current_render_pass.render_pass = &render_pass;
 	current_render_pass.framebuffer = &framebuffer;
+	current_render_pass.render_area = render_target.get_render_extent();
 
 	// Begin render pass
 	vk::RenderPassBeginInfo begin_info(
-	    current_render_pass.render_pass->get_handle(), current_render_pass.framebuffer->get_handle(), {{}, render_target.get_extent()}, clear_values);
+	    current_render_pass.render_pass->get_handle(), current_render_pass.framebuffer->get_handle(), {{}, current_render_pass.render_area}, clear_values);
 
 	const auto &framebuffer_extent = current_render_pass.framebuffer->get_extent();
 
@@ -222,7 +230,13 @@ void HPPCommandBuffer::buffer_memory_barrier(const vkb::core::HPPBuffer
                                              vk::DeviceSize                             size,
                                              const vkb::common::HPPBufferMemoryBarrier &memory_barrier)
 {
-	vk::BufferMemoryBarrier buffer_memory_barrier(memory_barrier.src_access_mask, memory_barrier.dst_access_mask, {}, {}, buffer.get_handle(), offset, size);
+	vk::BufferMemoryBarrier buffer_memory_barrier(memory_barrier.src_access_mask,
+	                                              memory_barrier.dst_access_mask,
+	                                              memory_barrier.old_queue_family,
+	                                              memory_barrier.new_queue_family,
+	                                              buffer.get_handle(),
+	                                              offset,
+	                                              size);
 
 	vk::PipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
 	vk::PipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
@@ -235,6 +249,29 @@ void HPPCommandBuffer::clear(vk::ClearAttachment attachment, vk::ClearRect rect)
 	get_handle().clearAttachments(attachment, rect);
 }
 
+vk::Result HPPCommandBuffer::continue_render_pass(HPPCommandBuffer &primary_cmd_buf, vk::CommandBufferUsageFlags flags)
+{
+	assert(level == vk::CommandBufferLevel::eSecondary && "Only a secondary command buffer can continue a render pass");
+
+	vk::Result result = begin(flags | vk::CommandBufferUsageFlagBits::eRenderPassContinue, &primary_cmd_buf);
+	if (result != vk::Result::eSuccess)
+	{
+		return result;
+	}
+
+	resource_binding_state = primary_cmd_buf.resource_binding_state;
+	stored_push_constants  = primary_cmd_buf.stored_push_constants;
+
+	current_render_pass.render_area = primary_cmd_buf.current_render_pass.render_area;
+
+	const auto &extent = current_render_pass.render_area;
+
+	set_viewport(0, {{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f}});
+	set_scissor(0, {vk::Rect2D({}, extent)});
+
+	return vk::Result::eSuccess;
+}
+
 void HPPCommandBuffer::copy_buffer(const vkb::core::HPPBuffer &src_buffer, const vkb::core::HPPBuffer &dst_buffer, vk::DeviceSize size)
 {
 	vk::BufferCopy copy_region({}, {}, size);
@@ -323,6 +360,11 @@ void HPPCommandBuffer::execute_commands(std::vector<HPPCommandBuffer *> &seconda
 	get_handle().executeCommands(sec_cmd_buf_handles);
 }
 
+vkb::core::HPPCommandPool &HPPCommandBuffer::get_command_pool()
+{
+	return command_pool;
+}
+
 vkb::core::HPPRenderPass &HPPCommandBuffer::get_render_pass(const vkb::rendering::HPPRenderTarget                          &render_target,
                                                             const std::vector<vkb::common::HPPLoadStoreInfo>               &load_store_infos,
                                                             const std::vector<std::unique_ptr<vkb::rendering::HPPSubpass>> &subpasses)
@@ -377,7 +419,7 @@ void HPPCommandBuffer::image_memory_barrier(const vkb::core::HPPImageView &image
 	get_handle().pipelineBarrier(src_stage_mask, dst_stage_mask, {}, {}, {}, image_memory_barrier);
 }
 
-void HPPCommandBuffer::next_subpass()
+void HPPCommandBuffer::next_subpass(vk::SubpassContents contents)
 {
 	// Increment subpass index
 	pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
@@ -394,21 +436,26 @@ void HPPCommandBuffer::next_subpass()
 	// Clear stored push constants
 	stored_push_constants.clear();
 
-	get_handle().nextSubpass(vk::SubpassContents::eInline);
+	get_handle().nextSubpass(contents);
 }
 
 void HPPCommandBuffer::push_constants(const std::vector<uint8_t> &values)
 {
-	uint32_t push_constant_size = to_u32(stored_push_constants.size() + values.size());
+	push_constants(values.data(), values.size());
+}
+
+void HPPCommandBuffer::push_constants(const uint8_t *data, size_t size)
+{
+	uint32_t push_constant_size = to_u32(stored_push_constants.size() + size);
 
 	if (push_constant_size > max_push_constants_size)
 	{
-		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, values.size(), push_constant_size);
+		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, size, push_constant_size);
 		throw std::runtime_error("Push constant limit exceeded.");
 	}
 	else
 	{
-		stored_push_constants.insert(stored_push_constants.end(), values.begin(), values.end());
+		stored_push_constants.insert(stored_push_constants.end(), data, data + size);
 	}
 }
 
@@ -511,7 +558,12 @@ void HPPCommandBuffer::set_viewport_state(const vkb::rendering::HPPViewportState
 
 void HPPCommandBuffer::update_buffer(const vkb::core::HPPBuffer &buffer, vk::DeviceSize offset, const std::vector<uint8_t> &data)
 {
-	get_handle().updateBuffer<uint8_t>(buffer.get_handle(), offset, data);
+	update_buffer(buffer, offset, data.data(), data.size());
+}
+
+void HPPCommandBuffer::update_buffer(const vkb::core::HPPBuffer &buffer, vk::DeviceSize offset, const uint8_t *data, size_t size)
+{
+	get_handle().updateBuffer(buffer.get_handle(), offset, static_cast<vk::DeviceSize>(size), data);
 }
 
 void HPPCommandBuffer::write_timestamp(vk::PipelineStageFlagBits pipeline_stage, const vkb::core::HPPQueryPool &query_pool, uint32_t query)
@@ -570,10 +622,15 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 		resource_binding_state.clear_dirty();
 
 		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+		auto &resource_sets = resource_binding_state.get_resource_sets();
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < to_u32(resource_sets.size()); ++descriptor_set_id)
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			auto &resource_set = resource_sets[descriptor_set_id];
+
+			if (resource_set.empty())
+			{
+				continue;
+			}
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
 			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
@@ -601,67 +658,62 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 			std::vector<uint32_t> dynamic_offsets;
 
 			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
+			for (auto &resource_binding : resource_set.get_resource_bindings())
 			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				auto binding_index = resource_binding.binding;
 
 				// Check if binding exists in the pipeline layout
 				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
 				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
-					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+					auto  array_element = resource_binding.array_element;
+					auto &resource_info = resource_binding.info;
 
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
+					// Pointer references
+					auto &buffer     = resource_info.buffer;
+					auto &sampler    = resource_info.sampler;
+					auto &image_view = resource_info.image_view;
+
+					// Get buffer info
+					if (buffer != nullptr && vkb::common::is_buffer_descriptor_type(binding_info->descriptorType))
+					{
+						vk::DescriptorBufferInfo buffer_info(resource_info.buffer->get_handle(), resource_info.offset, resource_info.range);
 
-						// Get buffer info
-						if (buffer != nullptr && vkb::common::is_buffer_descriptor_type(binding_info->descriptorType))
+						if (vkb::common::is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
 						{
-							vk::DescriptorBufferInfo buffer_info(resource_info.buffer->get_handle(), resource_info.offset, resource_info.range);
+							dynamic_offsets.push_back(to_u32(buffer_info.offset));
+							buffer_info.offset = 0;
+						}
 
-							if (vkb::common::is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
-								buffer_info.offset = 0;
-							}
+						buffer_infos[binding_index][array_element] = buffer_info;
+					}
 
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
+					// Get image info
+					else if (image_view != nullptr || sampler != nullptr)
+					{
+						// Can be null for input attachments
+						vk::DescriptorImageInfo image_info(sampler ? sampler->get_handle() : nullptr, image_view->get_handle());
 
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
+						if (image_view != nullptr)
 						{
-							// Can be null for input attachments
-							vk::DescriptorImageInfo image_info(sampler ? sampler->get_handle() : nullptr, image_view->get_handle());
-
-							if (image_view != nullptr)
+							// Add image layout info based on descriptor type
+							switch (binding_info->descriptorType)
 							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
-								{
-									case vk::DescriptorType::eCombinedImageSampler:
-										image_info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-										break;
-									case vk::DescriptorType::eInputAttachment:
-										image_info.imageLayout =
-										    vkb::common::is_depth_format(image_view->get_format()) ? vk::ImageLayout::eDepthStencilReadOnlyOptimal : vk::ImageLayout::eShaderReadOnlyOptimal;
-										break;
-									case vk::DescriptorType::eStorageImage:
-										image_info.imageLayout = vk::ImageLayout::eGeneral;
-										break;
-									default:
-										continue;
-								}
+								case vk::DescriptorType::eCombinedImageSampler:
+									image_info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+									break;
+								case vk::DescriptorType::eInputAttachment:
+									image_info.imageLayout =
+									    vkb::common::is_depth_format(image_view->get_format()) ? vk::ImageLayout::eDepthStencilReadOnlyOptimal : vk::ImageLayout::eShaderReadOnlyOptimal;
+									break;
+								case vk::DescriptorType::eStorageImage:
+									image_info.imageLayout = vk::ImageLayout::eGeneral;
+									break;
+								default:
+									continue;
 							}
-
-							image_infos[binding_index][array_element] = image_info;
 						}
+
+						image_infos[binding_index][array_element] = image_info;
 					}
 
 					assert((!update_after_bind ||
@@ -23,6 +23,7 @@
 #include <hpp_resource_binding_state.h>
 #include <rendering/hpp_pipeline_state.h>
 #include <rendering/hpp_render_target.h>
+#include <rendering/frame_arena.h>
 #include <rendering/hpp_subpass.h>
 
 namespace vkb
@@ -43,6 +44,7 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	{
 		const vkb::core::HPPRenderPass  *render_pass;
 		const vkb::core::HPPFramebuffer *framebuffer;
+		vk::Extent2D                     render_area;
 	};
 
 	enum class ResetMode
@@ -77,7 +79,7 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	 *        render pass and framebuffer as well as subpass index must be provided
 	 * @param flags Usage behavior for the command buffer
 	 * @param render_pass
-	 * @param framebuffer
+	 * @param framebuffer May be null for a secondary command buffer, which can then be executed in any framebuffer of the render pass
 	 * @param subpass_index
 	 * @return Whether it succeeded or not
 	 */
@@ -110,6 +112,12 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	                                                vk::DeviceSize                             size,
 	                                                const vkb::common::HPPBufferMemoryBarrier &memory_barrier);
 	void                      clear(vk::ClearAttachment info, vk::ClearRect rect);
+
+	/**
+	 * @brief Begins a secondary command buffer continuing the current subpass of a primary command buffer
+	 *        See vkb::CommandBuffer::continue_render_pass
+	 */
+	vk::Result                continue_render_pass(HPPCommandBuffer &primary_cmd_buf, vk::CommandBufferUsageFlags flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 	void                      copy_buffer(const vkb::core::HPPBuffer &src_buffer, const vkb::core::HPPBuffer &dst_buffer, vk::DeviceSize size);
 	void                      copy_buffer_to_image(const vkb::core::HPPBuffer &buffer, const vkb::core::HPPImage &image, const std::vector<vk::BufferImageCopy> &regions);
 	void                      copy_image(const vkb::core::HPPImage &src_img, const vkb::core::HPPImage &dst_img, const std::vector<vk::ImageCopy> &regions);
@@ -127,31 +135,30 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	void                      end_render_pass();
 	void                      execute_commands(HPPCommandBuffer &secondary_command_buffer);
 	void                      execute_commands(std::vector<HPPCommandBuffer *> &secondary_command_buffers);
+	vkb::core::HPPCommandPool &get_command_pool();
+	const RenderPassBinding  &get_current_render_pass() const;
+	const uint32_t            get_current_subpass_index() const;
 	vkb::core::HPPRenderPass &get_render_pass(const vkb::rendering::HPPRenderTarget                          &render_target,
 	                                          const std::vector<vkb::common::HPPLoadStoreInfo>               &load_store_infos,
 	                                          const std::vector<std::unique_ptr<vkb::rendering::HPPSubpass>> &subpasses);
 	void                      image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier) const;
-	void                      next_subpass();
+	void                      next_subpass(vk::SubpassContents contents = vk::SubpassContents::eInline);
 
 	/**
 	 * @brief Records byte data into the command buffer to be pushed as push constants to each draw call
 	 * @param values The byte data to store
 	 */
 	void push_constants(const std::vector<uint8_t> &values);
+
+	/**
+	 * @brief Records size bytes of data to be pushed as push constants, without an intermediate copy
+	 */
+	void push_constants(const uint8_t *data, size_t size);
+
 	template <typename T>
 	void push_constants(const T &value)
 	{
-		auto data = to_bytes(value);
-
-		uint32_t size = to_u32(stored_push_constants.size() + data.size());
-
-		if (size > max_push_constants_size)
-		{
-			LOGE("Push constant limit exceeded ({} / {} bytes)", size, max_push_constants_size);
-			throw std::runtime_error("Cannot overflow push constant limit");
-		}
-
-		stored_push_constants.insert(stored_push_constants.end(), data.begin(), data.end());
+		push_constants(reinterpret_cast<const uint8_t *>(&value), sizeof(T));
 	}
 
 	/**
@@ -183,6 +190,7 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	void set_viewport(uint32_t first_viewport, const std::vector<vk::Viewport> &viewports);
 	void set_viewport_state(const vkb::rendering::HPPViewportState &state_info);
 	void update_buffer(const vkb::core::HPPBuffer &buffer, vk::DeviceSize offset, const std::vector<uint8_t> &data);
+	void update_buffer(const vkb::core::HPPBuffer &buffer, vk::DeviceSize offset, const uint8_t *data, size_t size);
 	void write_timestamp(vk::PipelineStageFlagBits pipeline_stage, const vkb::core::HPPQueryPool &query_pool, uint32_t query);
 
   private:
@@ -207,9 +215,6 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	 */
 	void flush_push_constants();
 
-	const RenderPassBinding &get_current_render_pass() const;
-	const uint32_t           get_current_subpass_index() const;
-
 	/**
 	 * @brief Check that the render area is an optimal size by comparing to the render area granularity
 	 */
@@ -231,6 +236,35 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	bool update_after_bind = false;
 
 	std::unordered_map<uint32_t, vkb::core::HPPDescriptorSetLayout const *> descriptor_set_layout_binding_state;
+
+	/// Mirrors vkb::CommandBuffer, the descriptor buffer backend is not supported by the hpp framework
+	vk::Buffer bound_descriptor_buffer;
+
+	vk::Pipeline bound_graphics_pipeline;
+
+	vk::Pipeline bound_compute_pipeline;
+
+	/// Mirrors vkb::CommandBuffer, immediate binding is not supported by the hpp framework
+	bool immediate_mode = false;
+
+	bool shader_object_pass = false;
+
+	/// Mirrors vkb::CommandBuffer, dynamic rendering is not supported by the hpp framework
+	std::vector<vkb::rendering::HPPSubpass const *> rendering_subpasses;
+
+	std::vector<vkb::RenderingState> subpass_rendering_states;
+
+	bool barrier_batch_open = false;
+
+	std::vector<vk::ImageMemoryBarrier2KHR> pending_image_barriers;
+
+	std::vector<vk::BufferMemoryBarrier2KHR> pending_buffer_barriers;
+
+	/// Mirrors vkb::CommandBuffer, fragment shading rates are not supported by the hpp framework
+	vk::Extent2D fragment_shading_rate = {1, 1};
+
+	/// Mirrors vkb::CommandBuffer, frame arenas are not supported by the hpp framework
+	vkb::FrameArena scratch_arena;
 };
 
 template <class T>
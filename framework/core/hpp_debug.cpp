@@ -85,20 +85,22 @@ void HPPDebugMarkerExtDebugUtils::cmd_insert_label(vk::CommandBuffer command_buf
 
 HPPScopedDebugLabel::HPPScopedDebugLabel(const HPPDebugUtils &debug_utils,
                                          vk::CommandBuffer    command_buffer,
-                                         std::string const   &name,
+                                         const char          *name,
                                          glm::vec4 const      color) :
     debug_utils{&debug_utils}, command_buffer{VK_NULL_HANDLE}
 {
-	if (!name.empty())
+#ifdef VKB_VULKAN_DEBUG
+	if (name && *name != '\0')
 	{
 		assert(command_buffer);
 		this->command_buffer = command_buffer;
 
-		debug_utils.cmd_begin_label(command_buffer, name.c_str(), color);
+		debug_utils.cmd_begin_label(command_buffer, name, color);
 	}
+#endif
 }
 
-HPPScopedDebugLabel::HPPScopedDebugLabel(const vkb::core::HPPCommandBuffer &command_buffer, std::string const &name, glm::vec4 const color) :
+HPPScopedDebugLabel::HPPScopedDebugLabel(const vkb::core::HPPCommandBuffer &command_buffer, const char *name, glm::vec4 const color) :
     HPPScopedDebugLabel{command_buffer.get_device().get_debug_utils(), command_buffer.get_handle(), name, color}
 {
 }
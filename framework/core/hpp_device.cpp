@@ -1,4 +1,4 @@
-/* Copyright (c) 2022-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2022-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,6 +20,8 @@
 #include <common/hpp_error.h>
 #include <core/hpp_buffer.h>
 #include <core/hpp_command_pool.h>
+#include <rendering/attachment_allocator.h>
+#include <rendering/transient_resource_pool.h>
 
 namespace vkb
 {
@@ -152,6 +154,15 @@ HPPDevice::HPPDevice(vkb::core::HPPPhysicalDevice               &gpu,
 	// Latest requested feature will have the pNext's all set up for device creation.
 	create_info.pNext = gpu.get_extension_feature_chain();
 
+	// The logical device spans every physical device of the group, their memory is replicated on each of them
+	vk::DeviceGroupDeviceCreateInfoKHR device_group_info(gpu.get_device_group(), create_info.pNext);
+	if (gpu.get_device_group().size() > 1)
+	{
+		create_info.pNext = &device_group_info;
+
+		LOGI("Device group of {} GPUs enabled", device_group_info.physicalDeviceCount);
+	}
+
 	set_handle(gpu.get_handle().createDevice(create_info));
 
 	queues.resize(queue_family_properties.size());
@@ -177,10 +188,14 @@ HPPDevice::HPPDevice(vkb::core::HPPPhysicalDevice               &gpu,
 
 HPPDevice::~HPPDevice()
 {
+	retire_queue.clear();
+
 	resource_cache.clear();
 
 	command_pool.reset();
 	fence_pool.reset();
+	attachment_allocator.reset();
+	transient_resource_pool.reset();
 
 	vkb::allocated::shutdown();
 
@@ -202,6 +217,11 @@ bool HPPDevice::is_enabled(std::string const &extension) const
 	                    [extension](const char *enabled_extension) { return extension == enabled_extension; }) != enabled_extensions.end();
 }
 
+uint32_t HPPDevice::get_device_group_size() const
+{
+	return std::max(static_cast<uint32_t>(gpu.get_device_group().size()), 1u);
+}
+
 vkb::core::HPPPhysicalDevice const &HPPDevice::get_gpu() const
 {
 	return gpu;
@@ -420,5 +440,10 @@ vkb::HPPResourceCache &HPPDevice::get_resource_cache()
 {
 	return resource_cache;
 }
+
+vkb::RetireQueue &HPPDevice::get_retire_queue()
+{
+	return retire_queue;
+}
 }        // namespace core
 }        // namespace vkb
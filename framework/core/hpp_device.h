@@ -1,4 +1,4 @@
-/* Copyright (c) 2022-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2022-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -23,12 +23,18 @@
 #include <core/hpp_debug.h>
 #include <core/hpp_physical_device.h>
 #include <core/hpp_queue.h>
+#include <core/retire_queue.h>
 #include <hpp_fence_pool.h>
 #include <hpp_resource_cache.h>
+#include <texture_registry.h>
 #include <vulkan/vulkan.hpp>
 
 namespace vkb
 {
+class AttachmentAllocator;
+class GpuProfiler;
+class TransientResourcePool;
+
 namespace core
 {
 class HPPBuffer;
@@ -81,6 +87,11 @@ class HPPDevice : public vkb::core::VulkanResource<vkb::BindingType::Cpp, vk::De
 
 	bool is_enabled(std::string const &extension) const;
 
+	/**
+	 * @return The number of physical devices the device spans, more than one if it was created over a device group
+	 */
+	uint32_t get_device_group_size() const;
+
 	uint32_t get_queue_family_index(vk::QueueFlagBits queue_flag) const;
 
 	vkb::core::HPPCommandPool &get_command_pool();
@@ -126,6 +137,8 @@ class HPPDevice : public vkb::core::VulkanResource<vkb::BindingType::Cpp, vk::De
 
 	vkb::HPPResourceCache &get_resource_cache();
 
+	vkb::RetireQueue &get_retire_queue();
+
   private:
 	vkb::core::HPPPhysicalDevice const &gpu;
 
@@ -144,6 +157,51 @@ class HPPDevice : public vkb::core::VulkanResource<vkb::BindingType::Cpp, vk::De
 	std::unique_ptr<vkb::HPPFencePool> fence_pool;
 
 	vkb::HPPResourceCache resource_cache;
+
+	/// Mirrors vkb::Device, descriptor buffers, push descriptors, dynamic pipeline state, pipeline libraries, shader objects, timeline semaphore frame sync, synchronization2, dynamic rendering, present wait, fragment shading rates, mesh shaders, half precision arithmetic, the portability subset, descriptor update templates, the attachment allocator, the transient resource pool, the retire queue, the texture registry and the GPU profiler are not supported by the hpp framework
+	vk::PhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties;
+
+	bool descriptor_buffers = false;
+
+	uint32_t max_push_descriptors = 0;
+
+	uint32_t dynamic_pipeline_state_flags = 0;
+
+	bool graphics_pipeline_libraries = false;
+
+	bool shader_objects = false;
+
+	bool timeline_semaphores = false;
+
+	bool synchronization2 = false;
+
+	bool dynamic_rendering = false;
+
+	bool dynamic_rendering_local_read = false;
+
+	bool present_wait = false;
+
+	bool fragment_shading_rates = false;
+
+	vk::PhysicalDeviceMeshShaderPropertiesEXT mesh_shader_properties;
+
+	bool mesh_shaders = false;
+
+	bool float16_arithmetic = false;
+
+	bool portability_subset = false;
+
+	bool descriptor_update_templates = false;
+
+	std::unique_ptr<vkb::AttachmentAllocator> attachment_allocator;
+
+	std::unique_ptr<vkb::TransientResourcePool> transient_resource_pool;
+
+	vkb::RetireQueue retire_queue;
+
+	vkb::TextureRegistry texture_registry;
+
+	vkb::GpuProfiler *gpu_profiler = nullptr;
 };
 }        // namespace core
 }        // namespace vkb
@@ -19,6 +19,8 @@
 
 #include "core/vulkan_resource.h"
 #include "hpp_allocated.h"
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace vkb
@@ -113,6 +115,16 @@ struct HPPImageBuilder : public allocated::HPPBuilder<HPPImageBuilder, vk::Image
 	HPPImagePtr build_unique(HPPDevice &device) const;
 };
 
+/**
+ * @brief facade struct around vkb::core::ImageSubresourceState, providing a vulkan.hpp-based interface
+ */
+struct HPPImageSubresourceState
+{
+	vk::ImageLayout        layout = vk::ImageLayout::eUndefined;
+	vk::PipelineStageFlags stage_mask;
+	vk::AccessFlags        access_mask;
+};
+
 class HPPImage : public allocated::HPPAllocated<vk::Image>
 {
   public:
@@ -170,6 +182,15 @@ class HPPImage : public allocated::HPPAllocated<vk::Image>
 	vk::ImageCreateInfo                           create_info;
 	vk::ImageSubresource                          subresource;
 	std::unordered_set<vkb::core::HPPImageView *> views;        /// HPPImage views referring to this image
+
+	/// Mirrors vkb::core::Image, views shared through the resource cache are not supported by the hpp framework
+	std::unordered_map<std::size_t, std::unique_ptr<vkb::core::HPPImageView>> shared_views;
+
+	/// Mirrors vkb::core::Image, images are not moved by the hpp framework
+	vk::Image moved_handle;
+
+	/// Mirrors vkb::core::Image, subresource state tracking is not supported by the hpp framework
+	mutable std::vector<HPPImageSubresourceState> subresource_states;
 };
 }        // namespace core
 }        // namespace vkb
@@ -112,7 +112,9 @@ HPPImage::HPPImage(HPPImage &&other) noexcept :
     HPPAllocated{std::move(other)},
     create_info(std::exchange(other.create_info, {})),
     subresource(std::exchange(other.subresource, {})),
-    views(std::exchange(other.views, {}))
+    views(std::exchange(other.views, {})),
+    shared_views(std::exchange(other.shared_views, {})),
+    moved_handle(std::exchange(other.moved_handle, {}))
 {
 	// Update image views references to this image to avoid dangling pointers
 	for (auto &view : views)
@@ -123,6 +125,8 @@ HPPImage::HPPImage(HPPImage &&other) noexcept :
 
 HPPImage::~HPPImage()
 {
+	shared_views.clear();
+
 	destroy_image(get_handle());
 }
 
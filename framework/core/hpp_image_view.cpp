@@ -31,8 +31,9 @@ HPPImageView::HPPImageView(vkb::core::HPPImage &img,
                            uint32_t             mip_level,
                            uint32_t             array_layer,
                            uint32_t             n_mip_levels,
-                           uint32_t             n_array_layers) :
-    VulkanResource{nullptr, &img.get_device()}, image{&img}, format{format}
+                           uint32_t             n_array_layers,
+                           vk::ComponentMapping components) :
+    VulkanResource{nullptr, &img.get_device()}, image{&img}, view_type{view_type}, format{format}, components{components}
 {
 	if (format == vk::Format::eUndefined)
 	{
@@ -46,7 +47,7 @@ HPPImageView::HPPImageView(vkb::core::HPPImage &img,
 	                              array_layer,
 	                              n_array_layers == 0 ? image->get_subresource().arrayLayer : n_array_layers);
 
-	vk::ImageViewCreateInfo image_view_create_info({}, image->get_handle(), view_type, format, {}, subresource_range);
+	vk::ImageViewCreateInfo image_view_create_info({}, image->get_handle(), view_type, format, components, subresource_range);
 
 	set_handle(get_device().get_handle().createImageView(image_view_create_info));
 
@@ -56,7 +57,7 @@ HPPImageView::HPPImageView(vkb::core::HPPImage &img,
 }
 
 HPPImageView::HPPImageView(HPPImageView &&other) :
-    VulkanResource{std::move(other)}, image{other.image}, format{other.format}, subresource_range{other.subresource_range}
+    VulkanResource{std::move(other)}, image{other.image}, view_type{other.view_type}, format{other.format}, subresource_range{other.subresource_range}, components{other.components}
 {
 	// Remove old view from image set and add this new one
 	auto &views = image->get_views();
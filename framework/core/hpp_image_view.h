@@ -33,7 +33,8 @@ class HPPImageView : public vkb::core::VulkanResource<vkb::BindingType::Cpp, vk:
 	             uint32_t             base_mip_level   = 0,
 	             uint32_t             base_array_layer = 0,
 	             uint32_t             n_mip_levels     = 0,
-	             uint32_t             n_array_layers   = 0);
+	             uint32_t             n_array_layers   = 0,
+	             vk::ComponentMapping components       = {});
 
 	HPPImageView(HPPImageView &) = delete;
 	HPPImageView(HPPImageView &&other);
@@ -51,8 +52,10 @@ class HPPImageView : public vkb::core::VulkanResource<vkb::BindingType::Cpp, vk:
 
   private:
 	vkb::core::HPPImage      *image = nullptr;
+	vk::ImageViewType         view_type;
 	vk::Format                format;
 	vk::ImageSubresourceRange subresource_range;
+	vk::ComponentMapping      components;
 };
 }        // namespace core
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2022-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2022-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -140,6 +140,8 @@ std::vector<const char *> get_optimal_validation_layers(const std::vector<vk::La
 
 Optional<uint32_t> HPPInstance::selected_gpu_index;
 
+bool HPPInstance::use_device_group = false;
+
 namespace
 {
 bool enable_extension(const char                                 *required_ext_name,
@@ -474,6 +476,26 @@ bool HPPInstance::is_enabled(const char *extension) const
 	                    [extension](const char *enabled_extension) { return strcmp(extension, enabled_extension) == 0; }) != enabled_extensions.end();
 }
 
+std::vector<vk::PhysicalDevice> HPPInstance::get_device_group(vk::PhysicalDevice gpu) const
+{
+	if (!is_enabled(VK_KHR_DEVICE_GROUP_CREATION_EXTENSION_NAME))
+	{
+		return {gpu};
+	}
+
+	for (auto &group : handle.enumeratePhysicalDeviceGroupsKHR())
+	{
+		auto begin = group.physicalDevices.begin();
+		auto end   = group.physicalDevices.begin() + group.physicalDeviceCount;
+		if (std::find(begin, end, gpu) != end)
+		{
+			return {begin, end};
+		}
+	}
+
+	return {gpu};
+}
+
 void HPPInstance::query_gpus()
 {
 	// Querying valid physical devices on the machine
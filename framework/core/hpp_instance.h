@@ -1,4 +1,4 @@
-/* Copyright (c) 2022-2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2022-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -48,6 +48,11 @@ class HPPInstance
 	 */
 	static Optional<uint32_t> selected_gpu_index;
 
+	/**
+	 * @brief Can be set from the GPU selection plugin to create the device over the device group of the selected GPU
+	 */
+	static bool use_device_group;
+
 	/**
 	 * @brief Initializes the connection to Vulkan
 	 * @param application_name The name of the application
@@ -102,6 +107,12 @@ class HPPInstance
 	 */
 	bool is_enabled(const char *extension) const;
 
+	/**
+	 * @brief Finds the device group of a GPU, which requires VK_KHR_device_group_creation to be enabled
+	 * @return The physical devices of the group, or the GPU alone if it is not part of a group of several devices
+	 */
+	std::vector<vk::PhysicalDevice> get_device_group(vk::PhysicalDevice gpu) const;
+
   private:
 	/**
 	 * @brief Queries the instance for the physical devices on the machine
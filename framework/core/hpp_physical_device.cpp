@@ -1,4 +1,4 @@
-/* Copyright (c) 2022-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2022-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -35,7 +35,23 @@ HPPPhysicalDevice::HPPPhysicalDevice(HPPInstance &instance, vk::PhysicalDevice p
 
 	queue_family_properties = physical_device.getQueueFamilyProperties();
 
-	device_extensions = physical_device.enumerateDeviceExtensionProperties();
+	capabilities = std::make_unique<DeviceCapabilityCache>(static_cast<const VkPhysicalDeviceProperties &>(properties));
+
+	if (auto cached_extensions = capabilities->find_extensions())
+	{
+		device_extensions = reinterpret_cast<const std::vector<vk::ExtensionProperties> &>(*cached_extensions);
+	}
+	else
+	{
+		device_extensions = physical_device.enumerateDeviceExtensionProperties();
+
+		capabilities->set_extensions(reinterpret_cast<const std::vector<VkExtensionProperties> &>(device_extensions));
+	}
+
+	for (auto &extension : device_extensions)
+	{
+		device_extension_names.insert(extension.extensionName.data());
+	}
 
 	// Display supported extensions
 	if (device_extensions.size() > 0)
@@ -48,6 +64,11 @@ HPPPhysicalDevice::HPPPhysicalDevice(HPPInstance &instance, vk::PhysicalDevice p
 	}
 }
 
+HPPPhysicalDevice::~HPPPhysicalDevice()
+{
+	capabilities->save();
+}
+
 DriverVersion HPPPhysicalDevice::get_driver_version() const
 {
 	DriverVersion version;
@@ -83,9 +104,7 @@ void *HPPPhysicalDevice::get_extension_feature_chain() const
 
 bool HPPPhysicalDevice::is_extension_supported(const std::string &requested_extension) const
 {
-	return std::find_if(device_extensions.begin(),
-	                    device_extensions.end(),
-	                    [requested_extension](auto &device_extension) { return std::strcmp(device_extension.extensionName, requested_extension.c_str()) == 0; }) != device_extensions.end();
+	return device_extension_names.count(requested_extension) > 0;
 }
 
 const vk::PhysicalDeviceFeatures &HPPPhysicalDevice::get_features() const
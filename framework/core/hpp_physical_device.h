@@ -1,4 +1,4 @@
-/* Copyright (c) 2023-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,8 +17,10 @@
 
 #pragma once
 
+#include <core/device_capability_cache.h>
 #include <core/hpp_instance.h>
 #include <map>
+#include <unordered_set>
 #include <vulkan/vulkan.hpp>
 
 namespace vkb
@@ -44,6 +46,8 @@ class HPPPhysicalDevice
   public:
 	HPPPhysicalDevice(HPPInstance &instance, vk::PhysicalDevice physical_device);
 
+	~HPPPhysicalDevice();
+
 	HPPPhysicalDevice(const HPPPhysicalDevice &) = delete;
 
 	HPPPhysicalDevice(HPPPhysicalDevice &&) = delete;
@@ -119,11 +123,21 @@ class HPPPhysicalDevice
 			return *static_cast<HPPStructureType *>(extension_features_it->second.get());
 		}
 
-		// Get the extension feature
-		vk::StructureChain<vk::PhysicalDeviceFeatures2KHR, HPPStructureType> featureChain = handle.getFeatures2KHR<vk::PhysicalDeviceFeatures2KHR, HPPStructureType>();
+		// Get the extension feature, from the capabilities probed by a previous launch if possible
+		HPPStructureType extension;
+		if (!capabilities->find_features(static_cast<VkStructureType>(structureType), &extension, sizeof(HPPStructureType)))
+		{
+			vk::StructureChain<vk::PhysicalDeviceFeatures2KHR, HPPStructureType> featureChain = handle.getFeatures2KHR<vk::PhysicalDeviceFeatures2KHR, HPPStructureType>();
+
+			extension       = featureChain.template get<HPPStructureType>();
+			extension.pNext = nullptr;
+
+			capabilities->set_features(static_cast<VkStructureType>(structureType), &extension, sizeof(HPPStructureType));
+		}
 
 		// Insert the extension feature into the extension feature map so its ownership is held
-		extension_features.insert({structureType, std::make_shared<HPPStructureType>(featureChain.template get<HPPStructureType>())});
+		extension_features.insert({structureType, std::make_shared<HPPStructureType>(extension)});
+		extension_feature_sizes[structureType] = sizeof(HPPStructureType);
 
 		// Pull out the dereferenced void pointer, we can assume its type based on the template
 		auto *extension_ptr = static_cast<HPPStructureType *>(extension_features.find(structureType)->second.get());
@@ -159,6 +173,23 @@ class HPPPhysicalDevice
 		return high_priority_graphics_queue;
 	}
 
+	/**
+	 * @brief Sets the physical devices of the device group to create the logical device over, which must include this one
+	 *        Requires VK_KHR_device_group_creation to be enabled on the instance, see Instance::get_device_group().
+	 */
+	void set_device_group(const std::vector<vk::PhysicalDevice> &physical_devices)
+	{
+		device_group = physical_devices;
+	}
+
+	/**
+	 * @return The physical devices the logical device is created over, empty if it is this one only
+	 */
+	const std::vector<vk::PhysicalDevice> &get_device_group() const
+	{
+		return device_group;
+	}
+
   private:
 	// Handle to the Vulkan instance
 	HPPInstance &instance;
@@ -172,6 +203,9 @@ class HPPPhysicalDevice
 	// The extensions that this GPU supports
 	std::vector<vk::ExtensionProperties> device_extensions;
 
+	// The names of device_extensions, for the lookups of is_extension_supported()
+	std::unordered_set<std::string> device_extension_names;
+
 	// The GPU properties
 	vk::PhysicalDeviceProperties properties;
 
@@ -181,6 +215,9 @@ class HPPPhysicalDevice
 	// The GPU queue family properties
 	std::vector<vk::QueueFamilyProperties> queue_family_properties;
 
+	// The capabilities probed by this and previous launches on the same device and driver, see vkb::PhysicalDevice
+	std::unique_ptr<DeviceCapabilityCache> capabilities;
+
 	// The features that will be requested to be enabled in the logical device
 	vk::PhysicalDeviceFeatures requested_features;
 
@@ -191,6 +228,11 @@ class HPPPhysicalDevice
 	std::map<vk::StructureType, std::shared_ptr<void>> extension_features;
 
 	bool high_priority_graphics_queue{false};
+
+	std::vector<vk::PhysicalDevice> device_group;
+
+	// The sizes of the extension feature structures
+	std::map<vk::StructureType, size_t> extension_feature_sizes;
 };
 }        // namespace core
 }        // namespace vkb
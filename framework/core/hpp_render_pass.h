@@ -49,6 +49,7 @@ struct HPPSubpassInfo
 	uint32_t                depth_stencil_resolve_attachment;
 	vk::ResolveModeFlagBits depth_stencil_resolve_mode;
 	std::string             debug_name;
+	uint32_t                view_mask{0};
 };
 
 class HPPRenderPass : private vkb::RenderPass
@@ -72,6 +72,7 @@ struct HPPShaderResource
 	uint32_t              array_size;
 	uint32_t              offset;
 	uint32_t              size;
+	uint32_t              runtime_array_stride;
 	uint32_t              constant_id;
 	uint32_t              qualifiers;
 	std::string           name;
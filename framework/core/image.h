@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "common/helpers.h"
@@ -129,8 +131,33 @@ struct ImageBuilder : public allocated::Builder<ImageBuilder, VkImageCreateInfo>
 		return *this;
 	}
 
+	/**
+	 * @brief Binds the image to the memory of an existing allocation, instead of allocating memory for it
+	 *        The allocation must satisfy the memory requirements of the image and outlive it, see AttachmentAllocator.
+	 */
+	ImageBuilder &with_alias_allocation(VmaAllocation allocation)
+	{
+		alias_allocation = allocation;
+		return *this;
+	}
+
 	Image    build(Device &device) const;
 	ImagePtr build_unique(Device &device) const;
+
+	VmaAllocation alias_allocation{VK_NULL_HANDLE};
+};
+
+/**
+ * @brief The last known use of an image subresource by the GPU, in command recording order
+ */
+struct ImageSubresourceState
+{
+	VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+	/// Stages which accessed the subresource since its last write
+	VkPipelineStageFlags stage_mask{0};
+
+	VkAccessFlags access_mask{0};
 };
 
 class ImageView;
@@ -189,15 +216,47 @@ class Image : public allocated::Allocated<VkImage>
 
 	std::unordered_set<ImageView *> &get_views();
 
+	/**
+	 * @brief Views shared through ResourceCache::request_image_view(), by hash of their parameters
+	 */
+	std::unordered_map<std::size_t, std::unique_ptr<ImageView>> &get_shared_views();
+
 	VkDeviceSize get_image_required_size() const;
 
 	VkImageCompressionPropertiesEXT get_applied_compression() const;
 
+	/**
+	 * @brief Returns the tracked state of a subresource, see CommandBuffer::image_transition()
+	 */
+	const ImageSubresourceState &get_subresource_state(uint32_t mip_level, uint32_t array_layer) const;
+
+	/**
+	 * @brief Sets the tracked state of a range of subresources, CommandBuffer does so for every barrier it records on the image
+	 *        The state is bookkeeping of the commands recorded so far, which is why it can be set on a const image.
+	 */
+	void set_subresource_state(const VkImageSubresourceRange &range, const ImageSubresourceState &state) const;
+
+	/**
+	 * @brief Moves the image if all its subresources are in the same layout, and it can be copied
+	 *        The copy is left in the layout of the image.
+	 */
+	bool begin_move(VkCommandBuffer command_buffer, VmaAllocation destination) override;
+
+	void end_move(std::vector<VkImageView> &old_views, std::vector<VkImageView> &new_views) override;
+
   private:
 	/// Image views referring to this image
 	VkImageCreateInfo               create_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
 	VkImageSubresource              subresource{};
 	std::unordered_set<ImageView *> views;
+
+	std::unordered_map<std::size_t, std::unique_ptr<ImageView>> shared_views;
+
+	/// The copy of the image being moved, see begin_move()
+	VkImage moved_handle{VK_NULL_HANDLE};
+
+	/// Indexed by array layer, then mip level
+	mutable std::vector<ImageSubresourceState> subresource_states;
 };
 }        // namespace core
 }        // namespace vkb
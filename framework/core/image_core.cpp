@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,6 +20,9 @@
 #include "device.h"
 #include "image_view.h"
 
+#include <algorithm>
+#include <array>
+
 namespace vkb
 {
 namespace
@@ -110,9 +113,10 @@ Image::Image(vkb::Device          &device,
 Image::Image(vkb::Device &device, ImageBuilder const &builder) :
     Allocated{builder.alloc_create_info, VK_NULL_HANDLE, &device}, create_info(builder.create_info)
 {
-	set_handle(create_image(create_info));
+	set_handle(builder.alias_allocation != VK_NULL_HANDLE ? create_aliasing_image(builder.alias_allocation, create_info) : create_image(create_info));
 	subresource.arrayLayer = create_info.arrayLayers;
 	subresource.mipLevel   = create_info.mipLevels;
+	subresource_states.resize(create_info.arrayLayers * create_info.mipLevels, ImageSubresourceState{create_info.initialLayout});
 	if (!builder.debug_name.empty())
 	{
 		set_debug_name(builder.debug_name);
@@ -129,13 +133,17 @@ Image::Image(Device &device, VkImage handle, const VkExtent3D &extent, VkFormat
 	create_info.usage      = image_usage;
 	subresource.arrayLayer = create_info.arrayLayers = 1;
 	subresource.mipLevel = create_info.mipLevels = 1;
+	subresource_states.resize(1);
 }
 
 Image::Image(Image &&other) noexcept :
     Allocated{std::move(other)},
     create_info{std::exchange(other.create_info, {})},
     subresource{std::exchange(other.subresource, {})},
-    views(std::exchange(other.views, {}))
+    views(std::exchange(other.views, {})),
+    shared_views(std::exchange(other.shared_views, {})),
+    moved_handle(std::exchange(other.moved_handle, {})),
+    subresource_states(std::exchange(other.subresource_states, {}))
 {
 	// Update image views references to this image to avoid dangling pointers
 	for (auto &view : views)
@@ -146,6 +154,8 @@ Image::Image(Image &&other) noexcept :
 
 Image::~Image()
 {
+	shared_views.clear();
+
 	destroy_image(get_handle());
 }
 
@@ -194,6 +204,11 @@ std::unordered_set<ImageView *> &Image::get_views()
 	return views;
 }
 
+std::unordered_map<std::size_t, std::unique_ptr<ImageView>> &Image::get_shared_views()
+{
+	return shared_views;
+}
+
 VkDeviceSize Image::get_image_required_size() const
 {
 	VkMemoryRequirements memory_requirements;
@@ -207,5 +222,133 @@ VkImageCompressionPropertiesEXT Image::get_applied_compression() const
 {
 	return query_applied_compression(get_device().get_handle(), get_handle());
 }
+
+const ImageSubresourceState &Image::get_subresource_state(uint32_t mip_level, uint32_t array_layer) const
+{
+	assert(mip_level < create_info.mipLevels && array_layer < create_info.arrayLayers);
+	return subresource_states[array_layer * create_info.mipLevels + mip_level];
+}
+
+void Image::set_subresource_state(const VkImageSubresourceRange &range, const ImageSubresourceState &state) const
+{
+	uint32_t level_count = range.levelCount == VK_REMAINING_MIP_LEVELS ? create_info.mipLevels - range.baseMipLevel : range.levelCount;
+	uint32_t layer_count = range.layerCount == VK_REMAINING_ARRAY_LAYERS ? create_info.arrayLayers - range.baseArrayLayer : range.layerCount;
+
+	for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + layer_count; layer++)
+	{
+		for (uint32_t level = range.baseMipLevel; level < range.baseMipLevel + level_count; level++)
+		{
+			subresource_states[layer * create_info.mipLevels + level] = state;
+		}
+	}
+}
+
+bool Image::begin_move(VkCommandBuffer command_buffer, VmaAllocation destination)
+{
+	const VkImageLayout layout = subresource_states.front().layout;
+
+	bool same_layout = std::all_of(subresource_states.begin(), subresource_states.end(),
+	                               [layout](const ImageSubresourceState &state) { return state.layout == layout; });
+
+	// Undefined contents need no copy
+	const VkImageUsageFlags copy_usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	bool                    copied     = layout != VK_IMAGE_LAYOUT_UNDEFINED;
+
+	if ((create_info.flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT) || aliased || !same_layout ||
+	    (copied && (create_info.usage & copy_usage) != copy_usage))
+	{
+		return false;
+	}
+
+	// The extension structures of the create info did not outlive the construction
+	VkImageCreateInfo moved_create_info = create_info;
+	moved_create_info.pNext             = nullptr;
+	moved_create_info.initialLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VK_CHECK(vkCreateImage(get_device().get_handle(), &moved_create_info, nullptr, &moved_handle));
+	VK_CHECK(vmaBindImageMemory(allocated::get_memory_allocator(), destination, moved_handle));
+
+	if (!copied)
+	{
+		return true;
+	}
+
+	VkImageAspectFlags aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT;
+	if (is_depth_format(create_info.format))
+	{
+		aspect_mask = is_depth_stencil_format(create_info.format) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+	}
+
+	VkImageSubresourceRange range{aspect_mask, 0, create_info.mipLevels, 0, create_info.arrayLayers};
+
+	std::array<VkImageMemoryBarrier, 2> barriers{};
+	barriers[0].sType            = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barriers[0].srcAccessMask    = VK_ACCESS_MEMORY_WRITE_BIT;
+	barriers[0].dstAccessMask    = VK_ACCESS_TRANSFER_READ_BIT;
+	barriers[0].oldLayout        = layout;
+	barriers[0].newLayout        = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barriers[0].image            = get_handle();
+	barriers[0].subresourceRange = range;
+
+	barriers[1]               = barriers[0];
+	barriers[1].srcAccessMask = 0;
+	barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+	barriers[1].newLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].image         = moved_handle;
+
+	for (auto &barrier : barriers)
+	{
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	}
+
+	vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+	                     0, nullptr, 0, nullptr, to_u32(barriers.size()), barriers.data());
+
+	std::vector<VkImageCopy> regions(create_info.mipLevels);
+	for (uint32_t level = 0; level < create_info.mipLevels; ++level)
+	{
+		auto &region          = regions[level];
+		region.srcSubresource = {aspect_mask, level, 0, create_info.arrayLayers};
+		region.dstSubresource = region.srcSubresource;
+		region.extent         = {std::max(create_info.extent.width >> level, 1u),
+		                         std::max(create_info.extent.height >> level, 1u),
+		                         std::max(create_info.extent.depth >> level, 1u)};
+	}
+
+	vkCmdCopyImage(command_buffer, get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, moved_handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	               to_u32(regions.size()), regions.data());
+
+	// The copy takes the place of the image, in the layout the image was left in
+	barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	barriers[1].oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].newLayout     = layout;
+
+	vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+	                     0, nullptr, 0, nullptr, 1, &barriers[1]);
+
+	return true;
+}
+
+void Image::end_move(std::vector<VkImageView> &old_views, std::vector<VkImageView> &new_views)
+{
+	assert(moved_handle != VK_NULL_HANDLE && "The image is not being moved");
+
+	vkDestroyImage(get_device().get_handle(), get_handle(), nullptr);
+	set_handle(std::exchange(moved_handle, VK_NULL_HANDLE));
+
+	if (!get_debug_name().empty())
+	{
+		set_debug_name(get_debug_name());
+	}
+
+	for (auto *view : views)
+	{
+		old_views.push_back(view->recreate());
+		new_views.push_back(view->get_handle());
+	}
+}
 }        // namespace core
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -26,10 +26,13 @@ namespace core
 {
 ImageView::ImageView(Image &img, VkImageViewType view_type, VkFormat format,
                      uint32_t mip_level, uint32_t array_layer,
-                     uint32_t n_mip_levels, uint32_t n_array_layers) :
+                     uint32_t n_mip_levels, uint32_t n_array_layers,
+                     const VkComponentMapping &components) :
     VulkanResource{VK_NULL_HANDLE, &img.get_device()},
     image{&img},
-    format{format}
+    view_type{view_type},
+    format{format},
+    components{components}
 {
 	if (format == VK_FORMAT_UNDEFINED)
 	{
@@ -50,18 +53,7 @@ ImageView::ImageView(Image &img, VkImageViewType view_type, VkFormat format,
 		subresource_range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 	}
 
-	VkImageViewCreateInfo view_info{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
-	view_info.image            = image->get_handle();
-	view_info.viewType         = view_type;
-	view_info.format           = format;
-	view_info.subresourceRange = subresource_range;
-
-	auto result = vkCreateImageView(get_device().get_handle(), &view_info, nullptr, &get_handle());
-
-	if (result != VK_SUCCESS)
-	{
-		throw VulkanException{result, "Cannot create ImageView"};
-	}
+	set_handle(create_handle());
 
 	// Register this image view to its image
 	// in order to be notified when it gets moved
@@ -71,8 +63,10 @@ ImageView::ImageView(Image &img, VkImageViewType view_type, VkFormat format,
 ImageView::ImageView(ImageView &&other) :
     VulkanResource{std::move(other)},
     image{other.image},
+    view_type{other.view_type},
     format{other.format},
-    subresource_range{other.subresource_range}
+    subresource_range{other.subresource_range},
+    components{other.components}
 {
 	// Remove old view from image set and add this new one
 	auto &views = image->get_views();
@@ -99,6 +93,34 @@ void ImageView::set_image(Image &img)
 	image = &img;
 }
 
+VkImageView ImageView::recreate()
+{
+	VkImageView old_handle = get_handle();
+	set_handle(create_handle());
+	return old_handle;
+}
+
+VkImageView ImageView::create_handle() const
+{
+	VkImageViewCreateInfo view_info{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+	view_info.image            = image->get_handle();
+	view_info.viewType         = view_type;
+	view_info.format           = format;
+	view_info.components       = components;
+	view_info.subresourceRange = subresource_range;
+
+	VkImageView handle{VK_NULL_HANDLE};
+
+	auto result = vkCreateImageView(get_device().get_handle(), &view_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot create ImageView"};
+	}
+
+	return handle;
+}
+
 VkFormat ImageView::get_format() const
 {
 	return format;
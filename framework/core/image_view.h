@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -29,9 +29,13 @@ namespace core
 class ImageView : public vkb::core::VulkanResource<vkb::BindingType::C, VkImageView>
 {
   public:
+	/**
+	 * @param components The swizzle of the view, such as to read images of fewer channels as RGBA
+	 */
 	ImageView(Image &image, VkImageViewType view_type, VkFormat format = VK_FORMAT_UNDEFINED,
 	          uint32_t base_mip_level = 0, uint32_t base_array_layer = 0,
-	          uint32_t n_mip_levels = 0, uint32_t n_array_layers = 0);
+	          uint32_t n_mip_levels = 0, uint32_t n_array_layers = 0,
+	          const VkComponentMapping &components = {});
 
 	ImageView(ImageView &) = delete;
 
@@ -51,6 +55,12 @@ class ImageView : public vkb::core::VulkanResource<vkb::BindingType::C, VkImageV
 	 */
 	void set_image(Image &image);
 
+	/**
+	 * @brief Creates a new handle of the view for the handle of its image, once the image moved to other memory
+	 * @return The previous handle, which the caller destroys once nothing refers to it
+	 */
+	VkImageView recreate();
+
 	VkFormat get_format() const;
 
 	VkImageSubresourceRange get_subresource_range() const;
@@ -58,11 +68,17 @@ class ImageView : public vkb::core::VulkanResource<vkb::BindingType::C, VkImageV
 	VkImageSubresourceLayers get_subresource_layers() const;
 
   private:
+	VkImageView create_handle() const;
+
 	Image *image{};
 
+	VkImageViewType view_type{};
+
 	VkFormat format{};
 
 	VkImageSubresourceRange subresource_range{};
+
+	VkComponentMapping components{};
 };
 }        // namespace core
 }        // namespace vkb
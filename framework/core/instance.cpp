@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -140,6 +140,8 @@ std::vector<const char *> get_optimal_validation_layers(const std::vector<VkLaye
 
 Optional<uint32_t> Instance::selected_gpu_index;
 
+bool Instance::use_device_group = false;
+
 namespace
 {
 bool enable_extension(const char                               *required_ext_name,
@@ -530,6 +532,32 @@ bool Instance::is_enabled(const char *extension) const
 	return std::find_if(enabled_extensions.begin(), enabled_extensions.end(), [extension](const char *enabled_extension) { return strcmp(extension, enabled_extension) == 0; }) != enabled_extensions.end();
 }
 
+std::vector<VkPhysicalDevice> Instance::get_device_group(VkPhysicalDevice gpu) const
+{
+	if (!is_enabled(VK_KHR_DEVICE_GROUP_CREATION_EXTENSION_NAME))
+	{
+		return {gpu};
+	}
+
+	uint32_t group_count{0};
+	VK_CHECK(vkEnumeratePhysicalDeviceGroupsKHR(handle, &group_count, nullptr));
+
+	std::vector<VkPhysicalDeviceGroupPropertiesKHR> groups(group_count, {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES_KHR});
+	VK_CHECK(vkEnumeratePhysicalDeviceGroupsKHR(handle, &group_count, groups.data()));
+
+	for (auto &group : groups)
+	{
+		auto begin = group.physicalDevices;
+		auto end   = group.physicalDevices + group.physicalDeviceCount;
+		if (std::find(begin, end, gpu) != end)
+		{
+			return {begin, end};
+		}
+	}
+
+	return {gpu};
+}
+
 VkInstance Instance::get_handle() const
 {
 	return handle;
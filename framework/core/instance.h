@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -45,6 +45,11 @@ class Instance
 	 */
 	static Optional<uint32_t> selected_gpu_index;
 
+	/**
+	 * @brief Can be set from the GPU selection plugin to create the device over the device group of the selected GPU
+	 */
+	static bool use_device_group;
+
 	/**
 	 * @brief Initializes the connection to Vulkan
 	 * @param application_name The name of the application
@@ -102,6 +107,12 @@ class Instance
 	 */
 	bool is_enabled(const char *extension) const;
 
+	/**
+	 * @brief Finds the device group of a GPU, which requires VK_KHR_device_group_creation to be enabled
+	 * @return The physical devices of the group, or the GPU alone if it is not part of a group of several devices
+	 */
+	std::vector<VkPhysicalDevice> get_device_group(VkPhysicalDevice gpu) const;
+
 	VkInstance get_handle() const;
 
 	const std::vector<const char *> &get_extensions();
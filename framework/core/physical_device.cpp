@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -34,10 +34,26 @@ PhysicalDevice::PhysicalDevice(Instance &instance, VkPhysicalDevice physical_dev
 	queue_family_properties = std::vector<VkQueueFamilyProperties>(queue_family_properties_count);
 	vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_properties_count, queue_family_properties.data());
 
-	uint32_t device_extension_count;
-	VK_CHECK(vkEnumerateDeviceExtensionProperties(get_handle(), nullptr, &device_extension_count, nullptr));
-	device_extensions = std::vector<VkExtensionProperties>(device_extension_count);
-	VK_CHECK(vkEnumerateDeviceExtensionProperties(get_handle(), nullptr, &device_extension_count, device_extensions.data()));
+	capabilities = std::make_unique<DeviceCapabilityCache>(properties);
+
+	if (auto cached_extensions = capabilities->find_extensions())
+	{
+		device_extensions = *cached_extensions;
+	}
+	else
+	{
+		uint32_t device_extension_count;
+		VK_CHECK(vkEnumerateDeviceExtensionProperties(get_handle(), nullptr, &device_extension_count, nullptr));
+		device_extensions = std::vector<VkExtensionProperties>(device_extension_count);
+		VK_CHECK(vkEnumerateDeviceExtensionProperties(get_handle(), nullptr, &device_extension_count, device_extensions.data()));
+
+		capabilities->set_extensions(device_extensions);
+	}
+
+	for (auto &extension : device_extensions)
+	{
+		device_extension_names.insert(extension.extensionName);
+	}
 
 	// Display supported extensions
 	if (device_extensions.size() > 0)
@@ -50,6 +66,11 @@ PhysicalDevice::PhysicalDevice(Instance &instance, VkPhysicalDevice physical_dev
 	}
 }
 
+PhysicalDevice::~PhysicalDevice()
+{
+	save_capabilities();
+}
+
 Instance &PhysicalDevice::get_instance() const
 {
 	return instance;
@@ -69,21 +90,28 @@ VkBool32 PhysicalDevice::is_present_supported(VkSurfaceKHR surface, uint32_t que
 
 bool PhysicalDevice::is_extension_supported(const std::string &requested_extension) const
 {
-	return std::find_if(device_extensions.begin(), device_extensions.end(),
-	                    [requested_extension](auto &device_extension) {
-		                    return std::strcmp(device_extension.extensionName, requested_extension.c_str()) == 0;
-	                    }) != device_extensions.end();
+	return device_extension_names.count(requested_extension) > 0;
 }
 
 const VkFormatProperties PhysicalDevice::get_format_properties(VkFormat format) const
 {
 	VkFormatProperties format_properties;
 
-	vkGetPhysicalDeviceFormatProperties(handle, format, &format_properties);
+	if (!capabilities->find_format_properties(format, format_properties))
+	{
+		vkGetPhysicalDeviceFormatProperties(handle, format, &format_properties);
+
+		capabilities->set_format_properties(format, format_properties);
+	}
 
 	return format_properties;
 }
 
+void PhysicalDevice::save_capabilities()
+{
+	capabilities->save();
+}
+
 VkPhysicalDevice PhysicalDevice::get_handle() const
 {
 	return handle;
@@ -143,4 +171,32 @@ void *PhysicalDevice::get_extension_feature_chain() const
 	return last_requested_extension_feature;
 }
 
+void PhysicalDevice::reset_requested_features()
+{
+	requested_features               = {};
+	last_requested_extension_feature = nullptr;
+	extension_features.clear();
+	extension_feature_sizes.clear();
+}
+
+std::vector<uint8_t> PhysicalDevice::get_requested_feature_bytes() const
+{
+	auto bytes = reinterpret_cast<const uint8_t *>(&requested_features);
+
+	std::vector<uint8_t> feature_bytes(bytes, bytes + sizeof(requested_features));
+
+	for (auto &extension_feature : extension_features)
+	{
+		auto type    = extension_feature.first;
+		auto members = static_cast<const uint8_t *>(extension_feature.second.get()) + sizeof(VkBaseOutStructure);
+		auto size    = extension_feature_sizes.at(type) - sizeof(VkBaseOutStructure);
+
+		auto type_bytes = reinterpret_cast<const uint8_t *>(&type);
+		feature_bytes.insert(feature_bytes.end(), type_bytes, type_bytes + sizeof(type));
+		feature_bytes.insert(feature_bytes.end(), members, members + size);
+	}
+
+	return feature_bytes;
+}
+
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <unordered_set>
+
+#include "core/device_capability_cache.h"
 #include "core/instance.h"
 
 namespace vkb
@@ -33,6 +36,11 @@ class PhysicalDevice
   public:
 	PhysicalDevice(Instance &instance, VkPhysicalDevice physical_device);
 
+	/**
+	 * @brief Saves the capabilities probed since the device was created, see save_capabilities()
+	 */
+	~PhysicalDevice();
+
 	PhysicalDevice(const PhysicalDevice &) = delete;
 
 	PhysicalDevice(PhysicalDevice &&) = delete;
@@ -47,8 +55,17 @@ class PhysicalDevice
 
 	bool is_extension_supported(const std::string &extension) const;
 
+	/**
+	 * @brief Queries the properties of a format, or looks them up in the capabilities probed by a previous launch
+	 */
 	const VkFormatProperties get_format_properties(VkFormat format) const;
 
+	/**
+	 * @brief Writes the extensions, format properties and extension features probed so far to storage,
+	 *        so that the next launch on the same device and driver looks them up instead of querying the driver
+	 */
+	void save_capabilities();
+
 	VkPhysicalDevice get_handle() const;
 
 	const VkPhysicalDeviceFeatures &get_features() const;
@@ -107,14 +124,21 @@ class PhysicalDevice
 			return *static_cast<T *>(extension_features_it->second.get());
 		}
 
-		// Get the extension feature
-		VkPhysicalDeviceFeatures2KHR physical_device_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR};
-		T                            extension{type};
-		physical_device_features.pNext = &extension;
-		vkGetPhysicalDeviceFeatures2KHR(handle, &physical_device_features);
+		// Get the extension feature, from the capabilities probed by a previous launch if possible
+		T extension{type};
+		if (!capabilities->find_features(type, &extension, sizeof(T)))
+		{
+			VkPhysicalDeviceFeatures2KHR physical_device_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR};
+			physical_device_features.pNext = &extension;
+			vkGetPhysicalDeviceFeatures2KHR(handle, &physical_device_features);
+			extension.pNext = nullptr;
+
+			capabilities->set_features(type, &extension, sizeof(T));
+		}
 
 		// Insert the extension feature into the extension feature map so its ownership is held
 		extension_features.insert({type, std::make_shared<T>(extension)});
+		extension_feature_sizes[type] = sizeof(T);
 
 		// Pull out the dereferenced void pointer, we can assume its type based on the template
 		auto *extension_ptr = static_cast<T *>(extension_features.find(type)->second.get());
@@ -130,6 +154,35 @@ class PhysicalDevice
 		return *extension_ptr;
 	}
 
+	/**
+	 * @brief Looks up an extension feature struct previously requested with request_extension_features()
+	 * @param type The VkStructureType of the extension feature struct
+	 * @returns The requested struct, or nullptr if it was not requested
+	 */
+	template <typename T>
+	const T *find_requested_extension_features(VkStructureType type) const
+	{
+		auto extension_features_it = extension_features.find(type);
+		if (extension_features_it == extension_features.end())
+		{
+			return nullptr;
+		}
+
+		return static_cast<const T *>(extension_features_it->second.get());
+	}
+
+	/**
+	 * @brief Clears the requested core and extension features, so that they are requested again for a device created
+	 *        by another sample, see DeviceHandover. The device created with them must not be destroyed yet.
+	 */
+	void reset_requested_features();
+
+	/**
+	 * @return The bytes of the requested core features and of the members of the requested extension features,
+	 *         to tell whether two samples request the same ones
+	 */
+	std::vector<uint8_t> get_requested_feature_bytes() const;
+
 	/**
 	 * @brief Sets whether or not the first graphics queue should have higher priority than other queues.
 	 * Very specific feature which is used by async compute samples.
@@ -150,6 +203,23 @@ class PhysicalDevice
 		return high_priority_graphics_queue;
 	}
 
+	/**
+	 * @brief Sets the physical devices of the device group to create the logical device over, which must include this one
+	 *        Requires VK_KHR_device_group_creation to be enabled on the instance, see Instance::get_device_group().
+	 */
+	void set_device_group(const std::vector<VkPhysicalDevice> &physical_devices)
+	{
+		device_group = physical_devices;
+	}
+
+	/**
+	 * @return The physical devices the logical device is created over, empty if it is this one only
+	 */
+	const std::vector<VkPhysicalDevice> &get_device_group() const
+	{
+		return device_group;
+	}
+
   private:
 	// Handle to the Vulkan instance
 	Instance &instance;
@@ -163,6 +233,9 @@ class PhysicalDevice
 	// The extensions that this GPU supports
 	std::vector<VkExtensionProperties> device_extensions;
 
+	// The names of device_extensions, for the lookups of is_extension_supported()
+	std::unordered_set<std::string> device_extension_names;
+
 	// The GPU properties
 	VkPhysicalDeviceProperties properties;
 
@@ -172,6 +245,9 @@ class PhysicalDevice
 	// The GPU queue family properties
 	std::vector<VkQueueFamilyProperties> queue_family_properties;
 
+	// The capabilities probed by this and previous launches on the same device and driver
+	std::unique_ptr<DeviceCapabilityCache> capabilities;
+
 	// The features that will be requested to be enabled in the logical device
 	VkPhysicalDeviceFeatures requested_features{};
 
@@ -182,5 +258,10 @@ class PhysicalDevice
 	std::map<VkStructureType, std::shared_ptr<void>> extension_features;
 
 	bool high_priority_graphics_queue{};
+
+	std::vector<VkPhysicalDevice> device_group;
+
+	// The sizes of the extension feature structures
+	std::map<VkStructureType, size_t> extension_feature_sizes;
 };
 }        // namespace vkb
@@ -112,6 +112,11 @@ ComputePipeline::ComputePipeline(Device &        device,
 	create_info.layout = pipeline_state.get_pipeline_layout().get_handle();
 	create_info.stage  = stage;
 
+	if (device.uses_descriptor_buffers())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
 	result = vkCreateComputePipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
 
 	if (result != VK_SUCCESS)
@@ -122,11 +127,29 @@ ComputePipeline::ComputePipeline(Device &        device,
 	vkDestroyShaderModule(device.get_handle(), stage.module, nullptr);
 }
 
-GraphicsPipeline::GraphicsPipeline(Device &        device,
-                                   VkPipelineCache pipeline_cache,
-                                   PipelineState & pipeline_state) :
-    Pipeline{device}
+namespace
+{
+/**
+ * @brief Creates a graphics pipeline from the pipeline state
+ * @param library_parts The parts to create a graphics pipeline library with, or 0 for a complete pipeline
+ */
+VkPipeline create_graphics_pipeline(Device                           &device,
+                                    VkPipelineCache                   pipeline_cache,
+                                    PipelineState                    &pipeline_state,
+                                    VkGraphicsPipelineLibraryFlagsEXT library_parts)
 {
+	bool mesh_shading = false;
+	for (const ShaderModule *shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
+	{
+		mesh_shading = mesh_shading || shader_module->get_stage() == VK_SHADER_STAGE_MESH_BIT_EXT;
+	}
+
+	// Mesh shading pipelines have no vertex input state
+	bool vertex_input_interface    = !mesh_shading && (!library_parts || (library_parts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT));
+	bool pre_rasterization_shaders = !library_parts || (library_parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT);
+	bool fragment_shader           = !library_parts || (library_parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT);
+	bool fragment_output_interface = !library_parts || (library_parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT);
+
 	std::vector<VkShaderModule> shader_modules;
 
 	std::vector<VkPipelineShaderStageCreateInfo> stage_create_infos;
@@ -151,6 +174,13 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 
 	for (const ShaderModule *shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
 	{
+		bool is_fragment_stage = shader_module->get_stage() == VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		if (is_fragment_stage ? !fragment_shader : !pre_rasterization_shaders)
+		{
+			continue;
+		}
+
 		VkPipelineShaderStageCreateInfo stage_create_info{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
 
 		stage_create_info.stage = shader_module->get_stage();
@@ -259,7 +289,7 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 	color_blend_state.blendConstants[2] = 1.0f;
 	color_blend_state.blendConstants[3] = 1.0f;
 
-	std::array<VkDynamicState, 9> dynamic_states{
+	std::vector<VkDynamicState> dynamic_states{
 	    VK_DYNAMIC_STATE_VIEWPORT,
 	    VK_DYNAMIC_STATE_SCISSOR,
 	    VK_DYNAMIC_STATE_LINE_WIDTH,
@@ -271,36 +301,227 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 	    VK_DYNAMIC_STATE_STENCIL_REFERENCE,
 	};
 
+	// The values of the dynamic state groups are set by CommandBuffer::flush_pipeline_state()
+	auto dynamic_state_flags = pipeline_state.get_dynamic_state_flags();
+
+	if (dynamic_state_flags & DYNAMIC_PIPELINE_STATE_RASTERIZATION_BIT)
+	{
+		dynamic_states.push_back(VK_DYNAMIC_STATE_CULL_MODE_EXT);
+		dynamic_states.push_back(VK_DYNAMIC_STATE_FRONT_FACE_EXT);
+	}
+
+	if (dynamic_state_flags & DYNAMIC_PIPELINE_STATE_DEPTH_STENCIL_BIT)
+	{
+		dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT);
+		dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
+		dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT);
+		dynamic_states.push_back(VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT);
+		dynamic_states.push_back(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT);
+		dynamic_states.push_back(VK_DYNAMIC_STATE_STENCIL_OP_EXT);
+	}
+
+	if (dynamic_state_flags & DYNAMIC_PIPELINE_STATE_COLOR_BLEND_BIT)
+	{
+		dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+		dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+		dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+	}
+
+	// Set by CommandBuffer::set_fragment_shading_rate(), which every command buffer begins with
+	if (device.uses_fragment_shading_rates())
+	{
+		dynamic_states.push_back(VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR);
+	}
+
 	VkPipelineDynamicStateCreateInfo dynamic_state{VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
 
 	dynamic_state.pDynamicStates    = dynamic_states.data();
 	dynamic_state.dynamicStateCount = to_u32(dynamic_states.size());
 
-	create_info.pVertexInputState   = &vertex_input_state;
-	create_info.pInputAssemblyState = &input_assembly_state;
-	create_info.pViewportState      = &viewport_state;
-	create_info.pRasterizationState = &rasterization_state;
-	create_info.pMultisampleState   = &multisample_state;
-	create_info.pDepthStencilState  = &depth_stencil_state;
-	create_info.pColorBlendState    = &color_blend_state;
-	create_info.pDynamicState       = &dynamic_state;
+	create_info.pDynamicState = &dynamic_state;
 
-	create_info.layout     = pipeline_state.get_pipeline_layout().get_handle();
-	create_info.renderPass = pipeline_state.get_render_pass()->get_handle();
-	create_info.subpass    = pipeline_state.get_subpass_index();
+	if (vertex_input_interface)
+	{
+		create_info.pVertexInputState   = &vertex_input_state;
+		create_info.pInputAssemblyState = &input_assembly_state;
+	}
 
-	auto result = vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
+	if (pre_rasterization_shaders)
+	{
+		create_info.pViewportState      = &viewport_state;
+		create_info.pRasterizationState = &rasterization_state;
+	}
 
-	if (result != VK_SUCCESS)
+	if (fragment_shader)
+	{
+		create_info.pDepthStencilState = &depth_stencil_state;
+	}
+
+	if (fragment_shader || fragment_output_interface)
 	{
-		throw VulkanException{result, "Cannot create GraphicsPipelines"};
+		create_info.pMultisampleState = &multisample_state;
 	}
 
+	if (fragment_output_interface)
+	{
+		create_info.pColorBlendState = &color_blend_state;
+	}
+
+	if (pre_rasterization_shaders || fragment_shader)
+	{
+		create_info.layout = pipeline_state.get_pipeline_layout().get_handle();
+	}
+
+	auto &rendering_state = pipeline_state.get_rendering_state();
+
+	VkPipelineRenderingCreateInfoKHR       rendering_create_info{VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR};
+	VkRenderingAttachmentLocationInfoKHR   location_info{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_LOCATION_INFO_KHR};
+	VkRenderingInputAttachmentIndexInfoKHR input_index_info{VK_STRUCTURE_TYPE_RENDERING_INPUT_ATTACHMENT_INDEX_INFO_KHR};
+
+	if ((pre_rasterization_shaders || fragment_shader || fragment_output_interface) && pipeline_state.get_render_pass())
+	{
+		create_info.renderPass = pipeline_state.get_render_pass()->get_handle();
+		create_info.subpass    = pipeline_state.get_subpass_index();
+	}
+	else if (pre_rasterization_shaders || fragment_shader || fragment_output_interface)
+	{
+		// Dynamic rendering, see CommandBuffer::begin_rendering
+		rendering_create_info.colorAttachmentCount    = to_u32(rendering_state.color_attachment_formats.size());
+		rendering_create_info.pColorAttachmentFormats = rendering_state.color_attachment_formats.data();
+		rendering_create_info.depthAttachmentFormat   = rendering_state.depth_attachment_format;
+		rendering_create_info.stencilAttachmentFormat = rendering_state.stencil_attachment_format;
+
+		if (!rendering_state.color_attachment_locations.empty())
+		{
+			location_info.colorAttachmentCount      = to_u32(rendering_state.color_attachment_locations.size());
+			location_info.pColorAttachmentLocations = rendering_state.color_attachment_locations.data();
+
+			input_index_info.pNext                        = &location_info;
+			input_index_info.colorAttachmentCount         = to_u32(rendering_state.color_attachment_input_indices.size());
+			input_index_info.pColorAttachmentInputIndices = rendering_state.color_attachment_input_indices.data();
+			input_index_info.pDepthInputAttachmentIndex   = &rendering_state.depth_stencil_input_index;
+			input_index_info.pStencilInputAttachmentIndex = &rendering_state.depth_stencil_input_index;
+
+			rendering_create_info.pNext = &input_index_info;
+		}
+
+		create_info.pNext = &rendering_create_info;
+	}
+
+	VkGraphicsPipelineLibraryCreateInfoEXT library_create_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT};
+
+	if (library_parts)
+	{
+		library_create_info.flags = library_parts;
+
+		// Retaining the link time optimization info lets optimized pipelines be linked later on
+		library_create_info.pNext = create_info.pNext;
+		create_info.pNext         = &library_create_info;
+		create_info.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+	}
+
+	if (device.uses_descriptor_buffers())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
+	VkPipeline handle{VK_NULL_HANDLE};
+
+	auto result = vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
+
 	for (auto shader_module : shader_modules)
 	{
 		vkDestroyShaderModule(device.get_handle(), shader_module, nullptr);
 	}
 
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, library_parts ? "Cannot create GraphicsPipelineLibrary" : "Cannot create GraphicsPipelines"};
+	}
+
+	return handle;
+}
+}        // namespace
+
+GraphicsPipeline::GraphicsPipeline(Device &        device,
+                                   VkPipelineCache pipeline_cache,
+                                   PipelineState & pipeline_state) :
+    Pipeline{device}
+{
+	handle = create_graphics_pipeline(device, pipeline_cache, pipeline_state, 0);
+
+	state = pipeline_state;
+}
+
+GraphicsPipeline::GraphicsPipeline(Device                        &device,
+                                   VkPipelineCache                pipeline_cache,
+                                   PipelineState                 &pipeline_state,
+                                   const std::vector<VkPipeline> &libraries,
+                                   bool                           link_time_optimization) :
+    Pipeline{device}
+{
+	VkPipelineLibraryCreateInfoKHR library_info{VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR};
+
+	library_info.libraryCount = to_u32(libraries.size());
+	library_info.pLibraries   = libraries.data();
+
+	VkGraphicsPipelineCreateInfo create_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+
+	create_info.pNext  = &library_info;
+	create_info.layout = pipeline_state.get_pipeline_layout().get_handle();
+
+	if (link_time_optimization)
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+	}
+
+	if (device.uses_descriptor_buffers())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
+	auto result = vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot link GraphicsPipelines"};
+	}
+
+	state = pipeline_state;
+}
+
+GraphicsPipeline::GraphicsPipeline(GraphicsPipeline &&other) :
+    Pipeline{std::move(other)},
+    retired_handles{std::move(other.retired_handles)}
+{
+	other.retired_handles.clear();
+}
+
+GraphicsPipeline::~GraphicsPipeline()
+{
+	for (auto retired_handle : retired_handles)
+	{
+		vkDestroyPipeline(device.get_handle(), retired_handle, nullptr);
+	}
+}
+
+void GraphicsPipeline::replace_handle(GraphicsPipeline &&other)
+{
+	// Command buffers recorded earlier may still use the current handle
+	retired_handles.push_back(handle);
+
+	handle       = other.handle;
+	other.handle = VK_NULL_HANDLE;
+}
+
+GraphicsPipelineLibrary::GraphicsPipelineLibrary(Device                           &device,
+                                                 VkPipelineCache                   pipeline_cache,
+                                                 PipelineState                    &pipeline_state,
+                                                 VkGraphicsPipelineLibraryFlagsEXT library_parts) :
+    Pipeline{device}
+{
+	handle = create_graphics_pipeline(device, pipeline_cache, pipeline_state, library_parts);
+
 	state = pipeline_state;
 }
 }        // namespace vkb
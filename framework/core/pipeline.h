@@ -67,12 +67,53 @@ class ComputePipeline : public Pipeline
 class GraphicsPipeline : public Pipeline
 {
   public:
-	GraphicsPipeline(GraphicsPipeline &&) = default;
+	GraphicsPipeline(GraphicsPipeline &&other);
 
-	virtual ~GraphicsPipeline() = default;
+	virtual ~GraphicsPipeline();
 
 	GraphicsPipeline(Device &        device,
 	                 VkPipelineCache pipeline_cache,
 	                 PipelineState & pipeline_state);
+
+	/**
+	 * @brief Links a graphics pipeline from graphics pipeline libraries
+	 * @param libraries Libraries which together contain all the parts of the pipeline, see GraphicsPipelineLibrary
+	 * @param link_time_optimization Whether to optimize the pipeline, which is slower to link
+	 */
+	GraphicsPipeline(Device                        &device,
+	                 VkPipelineCache                pipeline_cache,
+	                 PipelineState                 &pipeline_state,
+	                 const std::vector<VkPipeline> &libraries,
+	                 bool                           link_time_optimization);
+
+	/**
+	 * @brief Takes over the handle of an equivalent pipeline, e.g. an optimized one
+	 *        The current handle is kept alive until destruction, as recorded command buffers may still use it.
+	 *        Must not be called while command buffers are being recorded.
+	 */
+	void replace_handle(GraphicsPipeline &&other);
+
+  private:
+	std::vector<VkPipeline> retired_handles;
+};
+
+/**
+ * @brief A graphics pipeline library with some parts of a graphics pipeline, from VK_EXT_graphics_pipeline_library
+ *        Libraries are created with the link time optimization info retained.
+ */
+class GraphicsPipelineLibrary : public Pipeline
+{
+  public:
+	GraphicsPipelineLibrary(GraphicsPipelineLibrary &&) = default;
+
+	virtual ~GraphicsPipelineLibrary() = default;
+
+	/**
+	 * @param library_parts The parts of the pipeline state in the library
+	 */
+	GraphicsPipelineLibrary(Device                           &device,
+	                        VkPipelineCache                   pipeline_cache,
+	                        PipelineState                    &pipeline_state,
+	                        VkGraphicsPipelineLibraryFlagsEXT library_parts);
 };
 }        // namespace vkb
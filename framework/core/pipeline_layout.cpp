@@ -84,26 +84,9 @@ PipelineLayout::PipelineLayout(Device &device, const std::vector<ShaderModule *>
 		descriptor_set_layouts.emplace_back(&device.get_resource_cache().request_descriptor_set_layout(shader_set_it.first, shader_modules, shader_set_it.second));
 	}
 
-	// Collect all the descriptor set layout handles, maintaining set order
-	std::vector<VkDescriptorSetLayout> descriptor_set_layout_handles;
-	for (uint32_t i = 0; i < descriptor_set_layouts.size(); ++i)
-	{
-		if (descriptor_set_layouts[i])
-		{
-			descriptor_set_layout_handles.push_back(descriptor_set_layouts[i]->get_handle());
-		}
-		else
-		{
-			descriptor_set_layout_handles.push_back(VK_NULL_HANDLE);
-		}
-	}
+	auto descriptor_set_layout_handles = get_descriptor_set_layout_handles();
 
-	// Collect all the push constant shader resources
-	std::vector<VkPushConstantRange> push_constant_ranges;
-	for (auto &push_constant_resource : get_resources(ShaderResourceType::PushConstant))
-	{
-		push_constant_ranges.push_back({push_constant_resource.stages, push_constant_resource.offset, push_constant_resource.size});
-	}
+	auto push_constant_ranges = get_push_constant_ranges();
 
 	VkPipelineLayoutCreateInfo create_info{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
 
@@ -193,6 +176,37 @@ DescriptorSetLayout &PipelineLayout::get_descriptor_set_layout(const uint32_t se
 	throw std::runtime_error("Couldn't find descriptor set layout at set index " + to_string(set_index));
 }
 
+std::vector<VkDescriptorSetLayout> PipelineLayout::get_descriptor_set_layout_handles() const
+{
+	// Collect all the descriptor set layout handles, maintaining set order
+	std::vector<VkDescriptorSetLayout> descriptor_set_layout_handles;
+	for (uint32_t i = 0; i < descriptor_set_layouts.size(); ++i)
+	{
+		if (descriptor_set_layouts[i])
+		{
+			descriptor_set_layout_handles.push_back(descriptor_set_layouts[i]->get_handle());
+		}
+		else
+		{
+			descriptor_set_layout_handles.push_back(VK_NULL_HANDLE);
+		}
+	}
+
+	return descriptor_set_layout_handles;
+}
+
+std::vector<VkPushConstantRange> PipelineLayout::get_push_constant_ranges() const
+{
+	// Collect all the push constant shader resources
+	std::vector<VkPushConstantRange> push_constant_ranges;
+	for (auto &push_constant_resource : get_resources(ShaderResourceType::PushConstant))
+	{
+		push_constant_ranges.push_back({push_constant_resource.stages, push_constant_resource.offset, push_constant_resource.size});
+	}
+
+	return push_constant_ranges;
+}
+
 VkShaderStageFlags PipelineLayout::get_push_constant_range_stage(uint32_t size, uint32_t offset) const
 {
 	VkShaderStageFlags stages = 0;
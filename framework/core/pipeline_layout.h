@@ -55,6 +55,16 @@ class PipelineLayout
 
 	DescriptorSetLayout &get_descriptor_set_layout(const uint32_t set_index) const;
 
+	/**
+	 * @brief The descriptor set layouts the pipeline layout was created with, in the same order
+	 */
+	std::vector<VkDescriptorSetLayout> get_descriptor_set_layout_handles() const;
+
+	/**
+	 * @brief The push constant ranges the pipeline layout was created with
+	 */
+	std::vector<VkPushConstantRange> get_push_constant_ranges() const;
+
 	VkShaderStageFlags get_push_constant_range_stage(uint32_t size, uint32_t offset = 0) const;
 
   private:
@@ -22,14 +22,18 @@
 namespace vkb
 {
 QueryPool::QueryPool(Device &d, const VkQueryPoolCreateInfo &info) :
-    device{d}
+    device{d},
+    query_type{info.queryType},
+    pipeline_statistics{info.queryType == VK_QUERY_TYPE_PIPELINE_STATISTICS ? info.pipelineStatistics : 0}
 {
 	VK_CHECK(vkCreateQueryPool(device.get_handle(), &info, nullptr, &handle));
 }
 
 QueryPool::QueryPool(QueryPool &&other) :
     device{other.device},
-    handle{other.handle}
+    handle{other.handle},
+    query_type{other.query_type},
+    pipeline_statistics{other.pipeline_statistics}
 {
 	other.handle = VK_NULL_HANDLE;
 }
@@ -64,4 +68,14 @@ VkResult QueryPool::get_results(uint32_t first_query, uint32_t num_queries,
 	                             result_bytes, results, stride, flags);
 }
 
+VkQueryType QueryPool::get_query_type() const
+{
+	return query_type;
+}
+
+VkQueryPipelineStatisticFlags QueryPool::get_pipeline_statistics() const
+{
+	return pipeline_statistics;
+}
+
 }        // namespace vkb
@@ -72,9 +72,21 @@ class QueryPool
 	                     size_t result_bytes, void *results, VkDeviceSize stride,
 	                     VkQueryResultFlags flags);
 
+	VkQueryType get_query_type() const;
+
+	/**
+	 * @return The statistics counted by the queries of a VK_QUERY_TYPE_PIPELINE_STATISTICS pool, 0 for other types
+	 *         The result of a query holds one value per statistic, in the order of their bits.
+	 */
+	VkQueryPipelineStatisticFlags get_pipeline_statistics() const;
+
   private:
 	Device &device;
 
 	VkQueryPool handle{VK_NULL_HANDLE};
+
+	VkQueryType query_type;
+
+	VkQueryPipelineStatisticFlags pipeline_statistics;
 };
 }        // namespace vkb
@@ -0,0 +1,127 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/query_ring.h"
+
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+VkQueryPoolCreateInfo get_ring_pool_info(VkQueryPoolCreateInfo info, uint32_t slice_count)
+{
+	info.queryCount *= slice_count;
+	return info;
+}
+}        // namespace
+
+QueryRing::QueryRing(Device &device, const VkQueryPoolCreateInfo &info, uint32_t slice_count, VkDeviceSize result_stride,
+                     VkQueryResultFlags result_flags, ResultCallback callback) :
+    query_pool{device, get_ring_pool_info(info, slice_count)},
+    query_count{info.queryCount},
+    result_stride{result_stride},
+    result_flags{result_flags & ~VK_QUERY_RESULT_WAIT_BIT},
+    callback{std::move(callback)},
+    results(info.queryCount * result_stride)
+{
+	// Queries must be reset before their first use
+	query_pool.host_reset(0, query_count * slice_count);
+
+	free_slices.reserve(slice_count);
+	for (uint32_t slice = slice_count; slice > 0; --slice)
+	{
+		free_slices.push_back(slice - 1);
+	}
+}
+
+bool QueryRing::begin_slice()
+{
+	assert(active_slice == ~0u && "The previous slice was not ended");
+
+	poll();
+
+	if (free_slices.empty())
+	{
+		return false;
+	}
+
+	active_slice = free_slices.back();
+	free_slices.pop_back();
+
+	return true;
+}
+
+void QueryRing::end_slice(bool submitted)
+{
+	assert(active_slice != ~0u && "No slice was taken");
+
+	if (submitted)
+	{
+		written_slices.push_back(active_slice);
+	}
+	else
+	{
+		// The queries were never written, so they are still reset
+		free_slices.push_back(active_slice);
+	}
+
+	active_slice = ~0u;
+}
+
+void QueryRing::poll()
+{
+	while (!written_slices.empty())
+	{
+		uint32_t slice = written_slices.front();
+
+		// A one shot check, results are passed in the order the slices were written so the first one not available stops the poll
+		VkResult result = query_pool.get_results(slice * query_count, query_count, results.size(), results.data(), result_stride, result_flags);
+
+		if (result == VK_NOT_READY)
+		{
+			return;
+		}
+
+		if (result == VK_SUCCESS)
+		{
+			callback(results.data());
+		}
+
+		written_slices.pop_front();
+
+		query_pool.host_reset(slice * query_count, query_count);
+		free_slices.push_back(slice);
+	}
+}
+
+QueryPool &QueryRing::get_query_pool()
+{
+	return query_pool;
+}
+
+uint32_t QueryRing::get_first_query() const
+{
+	assert(active_slice != ~0u && "No slice was taken");
+	return active_slice * query_count;
+}
+
+uint32_t QueryRing::get_query_count() const
+{
+	return query_count;
+}
+}        // namespace vkb
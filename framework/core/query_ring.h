@@ -0,0 +1,121 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/query_pool.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief A query pool split in slices, one written per frame, whose results are read back frames later without stalling
+ *
+ * A frame writes the queries of the slice taken with begin_slice(). The written slices are then checked once per
+ * frame, oldest first and without waiting, and the results of each available slice are passed to the callback before
+ * the slice is reset on the host and reused. The results of a frame therefore arrive a few frames later, and a frame is
+ * not measured if every slice is still waiting for its results, so the queries never stall the CPU.
+ *
+ * Slices are reset with VK_EXT_host_query_reset, so no reset is recorded to command buffers.
+ */
+class QueryRing
+{
+  public:
+	/**
+	 * @brief Receives the results of a slice, query_count results of result_stride bytes
+	 */
+	using ResultCallback = std::function<void(const uint8_t *results)>;
+
+	/**
+	 * @param device The device, with VK_EXT_host_query_reset enabled
+	 * @param info The creation details of the query pool, with the number of queries of one slice
+	 * @param slice_count The number of slices, more than the number of frames in flight so that results may arrive late
+	 * @param result_stride The size in bytes of the result of a query
+	 * @param result_flags How results are read, VK_QUERY_RESULT_WAIT_BIT is ignored
+	 * @param callback Called with the results of each slice, in the order the slices were written
+	 */
+	QueryRing(Device &device, const VkQueryPoolCreateInfo &info, uint32_t slice_count, VkDeviceSize result_stride,
+	          VkQueryResultFlags result_flags, ResultCallback callback);
+
+	QueryRing(const QueryRing &) = delete;
+
+	QueryRing(QueryRing &&) = delete;
+
+	~QueryRing() = default;
+
+	QueryRing &operator=(const QueryRing &) = delete;
+
+	QueryRing &operator=(QueryRing &&) = delete;
+
+	/**
+	 * @brief Polls the written slices, then takes a free slice to write
+	 * @return Whether a slice was taken, otherwise the frame must not write any query
+	 */
+	bool begin_slice();
+
+	/**
+	 * @brief Marks the slice taken with begin_slice() as written
+	 * @param submitted False if the command buffers writing the slice were not submitted, the slice is then reused as is
+	 */
+	void end_slice(bool submitted = true);
+
+	/**
+	 * @brief Checks the written slices once, oldest first, passing the results of those available to the callback
+	 */
+	void poll();
+
+	QueryPool &get_query_pool();
+
+	/**
+	 * @return The first query of the slice taken with begin_slice()
+	 */
+	uint32_t get_first_query() const;
+
+	/**
+	 * @return The number of queries of a slice
+	 */
+	uint32_t get_query_count() const;
+
+  private:
+	QueryPool query_pool;
+
+	uint32_t query_count;
+
+	VkDeviceSize result_stride;
+
+	VkQueryResultFlags result_flags;
+
+	ResultCallback callback;
+
+	/// Slices which can be written
+	std::vector<uint32_t> free_slices;
+
+	/// Slices written and waiting for their results, oldest first
+	std::deque<uint32_t> written_slices;
+
+	/// The slice taken by begin_slice(), or ~0u
+	uint32_t active_slice{~0u};
+
+	std::vector<uint8_t> results;
+};
+}        // namespace vkb
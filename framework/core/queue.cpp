@@ -79,9 +79,97 @@ VkBool32 Queue::support_present() const
 
 VkResult Queue::submit(const std::vector<VkSubmitInfo> &submit_infos, VkFence fence) const
 {
+	if (device.uses_synchronization2())
+	{
+		return submit2(submit_infos, fence);
+	}
+
 	return vkQueueSubmit(handle, to_u32(submit_infos.size()), submit_infos.data(), fence);
 }
 
+VkResult Queue::submit2(const std::vector<VkSubmitInfo> &submit_infos, VkFence fence) const
+{
+	std::vector<VkSubmitInfo2KHR> submit_infos2;
+
+	// Storage for the arrays the submit infos point to, sized upfront so that the pointers stay valid
+	size_t wait_count = 0, command_buffer_count = 0, signal_count = 0;
+	for (auto &submit_info : submit_infos)
+	{
+		wait_count           += submit_info.waitSemaphoreCount;
+		command_buffer_count += submit_info.commandBufferCount;
+		signal_count         += submit_info.signalSemaphoreCount;
+	}
+
+	std::vector<VkSemaphoreSubmitInfoKHR>     wait_infos;
+	std::vector<VkCommandBufferSubmitInfoKHR> command_buffer_infos;
+	std::vector<VkSemaphoreSubmitInfoKHR>     signal_infos;
+	wait_infos.reserve(wait_count);
+	command_buffer_infos.reserve(command_buffer_count);
+	signal_infos.reserve(signal_count);
+
+	for (auto &submit_info : submit_infos)
+	{
+		const VkTimelineSemaphoreSubmitInfoKHR *timeline_info = nullptr;
+
+		for (auto *next = static_cast<const VkBaseInStructure *>(submit_info.pNext); next; next = next->pNext)
+		{
+			if (next->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR)
+			{
+				timeline_info = reinterpret_cast<const VkTimelineSemaphoreSubmitInfoKHR *>(next);
+			}
+			else
+			{
+				// Other extension structs have no sync2 equivalent here
+				return vkQueueSubmit(handle, to_u32(submit_infos.size()), submit_infos.data(), fence);
+			}
+		}
+
+		VkSubmitInfo2KHR submit_info2{VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR};
+
+		submit_info2.waitSemaphoreInfoCount = submit_info.waitSemaphoreCount;
+		submit_info2.pWaitSemaphoreInfos    = wait_infos.data() + wait_infos.size();
+		for (uint32_t i = 0; i < submit_info.waitSemaphoreCount; ++i)
+		{
+			VkSemaphoreSubmitInfoKHR wait_info{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR};
+			wait_info.semaphore = submit_info.pWaitSemaphores[i];
+			wait_info.stageMask = submit_info.pWaitDstStageMask[i];
+			if (timeline_info && i < timeline_info->waitSemaphoreValueCount)
+			{
+				wait_info.value = timeline_info->pWaitSemaphoreValues[i];
+			}
+			wait_infos.push_back(wait_info);
+		}
+
+		submit_info2.commandBufferInfoCount = submit_info.commandBufferCount;
+		submit_info2.pCommandBufferInfos    = command_buffer_infos.data() + command_buffer_infos.size();
+		for (uint32_t i = 0; i < submit_info.commandBufferCount; ++i)
+		{
+			VkCommandBufferSubmitInfoKHR command_buffer_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR};
+			command_buffer_info.commandBuffer = submit_info.pCommandBuffers[i];
+			command_buffer_infos.push_back(command_buffer_info);
+		}
+
+		submit_info2.signalSemaphoreInfoCount = submit_info.signalSemaphoreCount;
+		submit_info2.pSignalSemaphoreInfos    = signal_infos.data() + signal_infos.size();
+		for (uint32_t i = 0; i < submit_info.signalSemaphoreCount; ++i)
+		{
+			// Legacy signal operations happen once all commands completed
+			VkSemaphoreSubmitInfoKHR signal_info{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR};
+			signal_info.semaphore = submit_info.pSignalSemaphores[i];
+			signal_info.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+			if (timeline_info && i < timeline_info->signalSemaphoreValueCount)
+			{
+				signal_info.value = timeline_info->pSignalSemaphoreValues[i];
+			}
+			signal_infos.push_back(signal_info);
+		}
+
+		submit_infos2.push_back(submit_info2);
+	}
+
+	return vkQueueSubmit2KHR(handle, to_u32(submit_infos2.size()), submit_infos2.data(), fence);
+}
+
 VkResult Queue::submit(const CommandBuffer &command_buffer, VkFence fence) const
 {
 	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
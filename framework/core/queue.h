@@ -51,6 +51,9 @@ class Queue
 
 	VkBool32 support_present() const;
 
+	/**
+	 * @brief Submits to the queue, with vkQueueSubmit2 if Device::uses_synchronization2()
+	 */
 	VkResult submit(const std::vector<VkSubmitInfo> &submit_infos, VkFence fence) const;
 
 	VkResult submit(const CommandBuffer &command_buffer, VkFence fence) const;
@@ -60,6 +63,11 @@ class Queue
 	VkResult wait_idle() const;
 
   private:
+	/**
+	 * @brief Translates the submit infos to vkQueueSubmit2, waits keep their stage masks and signals happen after all commands
+	 */
+	VkResult submit2(const std::vector<VkSubmitInfo> &submit_infos, VkFence fence) const;
+
 	Device &device;
 
 	VkQueue handle{VK_NULL_HANDLE};
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -77,6 +77,33 @@ inline void set_pointer_next(VkSubpassDescription2KHR &subpass_description, VkSu
 	subpass_description.pNext                    = &depth_resolve;
 }
 
+inline void set_view_mask(VkSubpassDescription &subpass_description, uint32_t view_mask)
+{
+	// VkSubpassDescription has no viewMask field, the view masks are chained to VkRenderPassCreateInfo instead
+}
+
+inline void set_view_mask(VkSubpassDescription2KHR &subpass_description, uint32_t view_mask)
+{
+	subpass_description.viewMask = view_mask;
+}
+
+inline void set_multiview(VkRenderPassCreateInfo &create_info, VkRenderPassMultiviewCreateInfo &multiview, const std::vector<uint32_t> &view_masks, const uint32_t &correlation_mask)
+{
+	multiview.sType                = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+	multiview.subpassCount         = to_u32(view_masks.size());
+	multiview.pViewMasks           = view_masks.data();
+	multiview.correlationMaskCount = 1;
+	multiview.pCorrelationMasks    = &correlation_mask;
+	create_info.pNext              = &multiview;
+}
+
+inline void set_multiview(VkRenderPassCreateInfo2KHR &create_info, VkRenderPassMultiviewCreateInfo &multiview, const std::vector<uint32_t> &view_masks, const uint32_t &correlation_mask)
+{
+	// The view masks of VkSubpassDescription2KHR are set with the subpasses
+	create_info.correlatedViewMaskCount = 1;
+	create_info.pCorrelatedViewMasks    = &correlation_mask;
+}
+
 inline const VkAttachmentReference2KHR *get_depth_resolve_reference(const VkSubpassDescription &subpass_description)
 {
 	// VkSubpassDescription cannot have pNext point to a VkSubpassDescriptionDepthStencilResolveKHR containing a VkAttachmentReference2KHR
@@ -245,7 +272,7 @@ void set_attachment_layouts(std::vector<T_SubpassDescription> &subpass_descripti
 }
 
 template <typename T>
-std::vector<T> get_subpass_dependencies(const size_t subpass_count)
+std::vector<T> get_subpass_dependencies(const size_t subpass_count, const bool multiview)
 {
 	std::vector<T> dependencies(subpass_count - 1);
 
@@ -261,6 +288,12 @@ std::vector<T> get_subpass_dependencies(const size_t subpass_count)
 			dependencies[i].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 			dependencies[i].dstAccessMask   = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
 			dependencies[i].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+			if (multiview)
+			{
+				// Each view only depends on the same view of the previous subpass
+				dependencies[i].dependencyFlags |= VK_DEPENDENCY_VIEW_LOCAL_BIT;
+			}
 		}
 	}
 
@@ -352,6 +385,16 @@ void RenderPass::create_renderpass(const std::vector<Attachment> &attachments, c
 		}
 	}
 
+	// All the subpasses of a multiview render pass render to views, their masks are all set or all zero
+	std::vector<uint32_t> view_masks;
+	uint32_t              correlation_mask{0};
+	for (auto &subpass : subpasses)
+	{
+		view_masks.push_back(subpass.view_mask);
+		correlation_mask |= subpass.view_mask;
+	}
+	const bool multiview = correlation_mask != 0;
+
 	std::vector<T_SubpassDescription> subpass_descriptions;
 	subpass_descriptions.reserve(subpass_count);
 	VkSubpassDescriptionDepthStencilResolveKHR depth_resolve{};
@@ -362,6 +405,7 @@ void RenderPass::create_renderpass(const std::vector<Attachment> &attachments, c
 		T_SubpassDescription subpass_description{};
 		set_structure_type(subpass_description);
 		subpass_description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		set_view_mask(subpass_description, subpass.view_mask);
 
 		subpass_description.pInputAttachments    = input_attachments[i].empty() ? nullptr : input_attachments[i].data();
 		subpass_description.inputAttachmentCount = to_u32(input_attachments[i].size());
@@ -438,7 +482,13 @@ void RenderPass::create_renderpass(const std::vector<Attachment> &attachments, c
 		color_output_count.push_back(to_u32(color_attachments[i].size()));
 	}
 
-	const auto &subpass_dependencies = get_subpass_dependencies<T_SubpassDependency>(subpass_count);
+	final_layouts.reserve(attachment_descriptions.size());
+	for (auto &attachment_description : attachment_descriptions)
+	{
+		final_layouts.push_back(attachment_description.finalLayout);
+	}
+
+	const auto &subpass_dependencies = get_subpass_dependencies<T_SubpassDependency>(subpass_count, multiview);
 
 	T_RenderPassCreateInfo create_info{};
 	set_structure_type(create_info);
@@ -449,6 +499,13 @@ void RenderPass::create_renderpass(const std::vector<Attachment> &attachments, c
 	create_info.dependencyCount = to_u32(subpass_dependencies.size());
 	create_info.pDependencies   = subpass_dependencies.data();
 
+	// The views are rendered from nearby viewpoints, like the eyes of a stereo pair, so implementations may render them concurrently
+	VkRenderPassMultiviewCreateInfo multiview_info{};
+	if (multiview)
+	{
+		set_multiview(create_info, multiview_info, view_masks, correlation_mask);
+	}
+
 	auto result = create_vk_renderpass(get_device().get_handle(), create_info, &get_handle());
 
 	if (result != VK_SUCCESS)
@@ -480,7 +537,8 @@ RenderPass::RenderPass(Device &device, const std::vector<Attachment> &attachment
 RenderPass::RenderPass(RenderPass &&other) :
     VulkanResource{std::move(other)},
     subpass_count{other.subpass_count},
-    color_output_count{other.color_output_count}
+    color_output_count{other.color_output_count},
+    final_layouts{other.final_layouts}
 {}
 
 RenderPass::~RenderPass()
@@ -497,6 +555,11 @@ const uint32_t RenderPass::get_color_output_count(uint32_t subpass_index) const
 	return color_output_count[subpass_index];
 }
 
+const std::vector<VkImageLayout> &RenderPass::get_final_layouts() const
+{
+	return final_layouts;
+}
+
 const VkExtent2D RenderPass::get_render_area_granularity() const
 {
 	VkExtent2D render_area_granularity = {};
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -41,6 +41,9 @@ struct SubpassInfo
 	VkResolveModeFlagBits depth_stencil_resolve_mode;
 
 	std::string debug_name;
+
+	/// Views the subpass renders to with VK_KHR_multiview, one bit per layer of the attachments, 0 to disable multiview
+	uint32_t view_mask{0};
 };
 
 class RenderPass : public vkb::core::VulkanResource<vkb::BindingType::C, VkRenderPass>
@@ -65,6 +68,11 @@ class RenderPass : public vkb::core::VulkanResource<vkb::BindingType::C, VkRende
 
 	const VkExtent2D get_render_area_granularity() const;
 
+	/**
+	 * @return The layout each attachment is left in at the end of the render pass
+	 */
+	const std::vector<VkImageLayout> &get_final_layouts() const;
+
   private:
 	size_t subpass_count;
 
@@ -72,5 +80,7 @@ class RenderPass : public vkb::core::VulkanResource<vkb::BindingType::C, VkRende
 	void create_renderpass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses);
 
 	std::vector<uint32_t> color_output_count;
+
+	std::vector<VkImageLayout> final_layouts;
 };
 }        // namespace vkb
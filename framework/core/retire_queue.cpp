@@ -0,0 +1,71 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "retire_queue.h"
+
+namespace vkb
+{
+void RetireQueue::next_frame(uint32_t frames_in_flight)
+{
+	std::deque<Retired> destroyed;
+
+	{
+		std::lock_guard<std::mutex> lock{retired_mutex};
+
+		++frame_index;
+
+		while (!retired.empty() && frame_index - retired.front().frame >= frames_in_flight)
+		{
+			destroyed.push_back(std::move(retired.front()));
+			retired.pop_front();
+		}
+	}
+
+	// Destroyed outside of the lock, as destructors may retire other objects
+	while (!destroyed.empty())
+	{
+		destroyed.pop_front();
+	}
+}
+
+void RetireQueue::clear()
+{
+	std::deque<Retired> destroyed;
+
+	{
+		std::lock_guard<std::mutex> lock{retired_mutex};
+		destroyed.swap(retired);
+	}
+
+	while (!destroyed.empty())
+	{
+		destroyed.pop_front();
+	}
+}
+
+size_t RetireQueue::get_retired_count() const
+{
+	std::lock_guard<std::mutex> lock{retired_mutex};
+	return retired.size();
+}
+
+void RetireQueue::retire_object(std::shared_ptr<void> &&object)
+{
+	std::lock_guard<std::mutex> lock{retired_mutex};
+	retired.push_back({frame_index, std::move(object)});
+}
+}        // namespace vkb
@@ -0,0 +1,107 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+namespace vkb
+{
+/**
+ * @brief Defers the destruction of objects which the frames in flight may still use, so that replacing them does not
+ *        wait for the GPU to be idle
+ *
+ * Objects are moved to the queue when they are replaced, e.g. render targets on resize or render passes evicted from the
+ * resource cache, and destroyed once the frames which may use them retired, see next_frame(). Objects retired in the
+ * same frame are destroyed in the order they were retired, so views must be retired before the images they refer to.
+ */
+class RetireQueue
+{
+  public:
+	RetireQueue() = default;
+
+	RetireQueue(const RetireQueue &) = delete;
+
+	RetireQueue(RetireQueue &&) = delete;
+
+	~RetireQueue() = default;
+
+	RetireQueue &operator=(const RetireQueue &) = delete;
+
+	RetireQueue &operator=(RetireQueue &&) = delete;
+
+	/**
+	 * @brief Takes an object to destroy once the frames in flight retired
+	 */
+	template <typename Resource>
+	void retire(Resource &&resource)
+	{
+		static_assert(!std::is_lvalue_reference<Resource>::value, "Retired objects are moved to the queue");
+		retire_object(std::make_shared<Resource>(std::move(resource)));
+	}
+
+	/**
+	 * @brief Takes an object owned by a pointer to destroy once the frames in flight retired, null pointers are ignored
+	 */
+	template <typename Resource>
+	void retire(std::unique_ptr<Resource> &&resource)
+	{
+		if (resource)
+		{
+			retire_object(std::shared_ptr<Resource>(std::move(resource)));
+		}
+	}
+
+	/**
+	 * @brief Starts a frame: the objects retired frames_in_flight frames ago are destroyed
+	 *        RenderContext calls this once it waited for the frame.
+	 * @param frames_in_flight The number of frames the GPU may still be processing
+	 */
+	void next_frame(uint32_t frames_in_flight);
+
+	/**
+	 * @brief Destroys all retired objects, the GPU must be idle
+	 */
+	void clear();
+
+	/**
+	 * @return The number of objects waiting to be destroyed
+	 */
+	size_t get_retired_count() const;
+
+  private:
+	struct Retired
+	{
+		uint64_t frame;
+
+		std::shared_ptr<void> object;
+	};
+
+	void retire_object(std::shared_ptr<void> &&object);
+
+	/// Objects may be retired by worker threads, e.g. while evicting cached resources
+	mutable std::mutex retired_mutex;
+
+	uint64_t frame_index{0};
+
+	/// Retired objects, from the oldest
+	std::deque<Retired> retired;
+};
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -21,6 +21,7 @@
 #include "device.h"
 #include "filesystem/legacy.h"
 #include "glsl_compiler.h"
+#include "shader_cache.h"
 #include "spirv_reflection.h"
 
 namespace vkb
@@ -80,7 +81,10 @@ inline std::vector<uint8_t> convert_to_bytes(std::vector<std::string> &lines)
 ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const std::string &entry_point, const ShaderVariant &shader_variant) :
     device{device},
     stage{stage},
-    entry_point{entry_point}
+    entry_point{entry_point},
+    source_filename{glsl_source.get_filename()},
+    source_id{glsl_source.get_id()},
+    shader_variant{shader_variant}
 {
 	debug_name = fmt::format("{} [variant {:X}] [entrypoint {}]",
 	                         glsl_source.get_filename(), shader_variant.get_id(), entry_point);
@@ -101,25 +105,44 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const Sh
 
 	// Precompile source into the final spirv bytecode
 	auto glsl_final_source = precompile_shader(source);
+	auto glsl_final_bytes  = convert_to_bytes(glsl_final_source);
 
-	// Compile the GLSL source
-	GLSLCompiler glsl_compiler;
+	// Skip compilation and reflection if an up to date result is cached on disk
+	auto   &shader_cache = ShaderCache::get();
+	Hash128 cache_key    = shader_cache.compute_key(stage, glsl_source, glsl_final_bytes, entry_point, shader_variant);
 
-	if (!glsl_compiler.compile_to_spirv(stage, convert_to_bytes(glsl_final_source), entry_point, shader_variant, spirv, info_log))
+	if (!shader_cache.load(cache_key, spirv, resources))
 	{
-		LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
-		LOGE("{}", info_log);
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
-	}
+		if (shader_cache.is_bundle_only())
+		{
+			LOGE("Shader \"{}\" is missing from the shader bundle, it must be precompiled with the vkb__shader_bundle target", glsl_source.get_filename());
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
 
-	SPIRVReflection spirv_reflection;
+		// Compile the GLSL source
+		GLSLCompiler glsl_compiler;
 
-	// Reflect all shader resources
-	if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
-	{
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		if (!glsl_compiler.compile_to_spirv(stage, glsl_final_bytes, entry_point, shader_variant, spirv, info_log))
+		{
+			LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
+			LOGE("{}", info_log);
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
+
+		SPIRVReflection spirv_reflection;
+
+		// Reflect all shader resources
+		if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources))
+		{
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
+
+		shader_cache.store(cache_key, spirv, resources);
 	}
 
+	// Cached resources are shared by the variants which only differ by their runtime array sizes
+	SPIRVReflection::apply_runtime_array_sizes(resources, shader_variant);
+
 	// Generate a unique id, determined by source and variant
 	std::hash<std::string> hasher{};
 	id = hasher(std::string{reinterpret_cast<const char *>(spirv.data()),
@@ -134,7 +157,10 @@ ShaderModule::ShaderModule(ShaderModule &&other) :
     debug_name{other.debug_name},
     spirv{other.spirv},
     resources{other.resources},
-    info_log{other.info_log}
+    info_log{other.info_log},
+    source_filename{other.source_filename},
+    source_id{other.source_id},
+    shader_variant{other.shader_variant}
 {
 	other.stage = {};
 }
@@ -149,6 +175,21 @@ VkShaderStageFlagBits ShaderModule::get_stage() const
 	return stage;
 }
 
+const std::string &ShaderModule::get_source_filename() const
+{
+	return source_filename;
+}
+
+size_t ShaderModule::get_source_id() const
+{
+	return source_id;
+}
+
+const ShaderVariant &ShaderModule::get_shader_variant() const
+{
+	return shader_variant;
+}
+
 const std::string &ShaderModule::get_entry_point() const
 {
 	return entry_point;
@@ -261,6 +302,16 @@ void ShaderVariant::set_runtime_array_sizes(const std::unordered_map<std::string
 	this->runtime_array_sizes = sizes;
 }
 
+void ShaderVariant::set_specialization_constant(uint32_t constant_id, uint32_t value)
+{
+	specialization_constants[constant_id] = value;
+}
+
+const std::map<uint32_t, uint32_t> &ShaderVariant::get_specialization_constants() const
+{
+	return specialization_constants;
+}
+
 const std::string &ShaderVariant::get_preamble() const
 {
 	return preamble;
@@ -281,6 +332,7 @@ void ShaderVariant::clear()
 	preamble.clear();
 	processes.clear();
 	runtime_array_sizes.clear();
+	specialization_constants.clear();
 	update_id();
 }
 
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -92,6 +92,9 @@ struct ShaderResource
 
 	uint32_t size;
 
+	/// Stride of the runtime array which ends a buffer block, or 0, see SPIRVReflection::apply_runtime_array_sizes()
+	uint32_t runtime_array_stride;
+
 	uint32_t constant_id;
 
 	uint32_t qualifiers;
@@ -140,6 +143,20 @@ class ShaderVariant
 
 	void set_runtime_array_sizes(const std::unordered_map<std::string, size_t> &sizes);
 
+	/**
+	 * @brief Sets a specialization constant, for a feature which does not change the interface of the shader
+	 *        Unlike definitions, constants are not part of the id of the variant, so that variants which only differ by
+	 *        them share a shader module. They are set on the pipeline instead, see get_specialization_constants().
+	 * @param constant_id Id the shader declares the constant with
+	 * @param value Value of the constant, booleans are 0 or 1
+	 */
+	void set_specialization_constant(uint32_t constant_id, uint32_t value);
+
+	/**
+	 * @return The specialization constants of the variant by id
+	 */
+	const std::map<uint32_t, uint32_t> &get_specialization_constants() const;
+
 	const std::string &get_preamble() const;
 
 	const std::vector<std::string> &get_processes() const;
@@ -157,6 +174,8 @@ class ShaderVariant
 
 	std::unordered_map<std::string, size_t> runtime_array_sizes;
 
+	std::map<uint32_t, uint32_t> specialization_constants;
+
 	void update_id();
 };
 
@@ -221,6 +240,21 @@ class ShaderModule
 
 	const std::vector<uint32_t> &get_binary() const;
 
+	/**
+	 * @brief The file name of the source the module was built from, see ShaderSource::get_filename()
+	 */
+	const std::string &get_source_filename() const;
+
+	/**
+	 * @brief The id of the source the module was built from, see ShaderSource::get_id()
+	 */
+	size_t get_source_id() const;
+
+	/**
+	 * @brief The variant the module was built with, so that it can be built again from a changed source
+	 */
+	const ShaderVariant &get_shader_variant() const;
+
 	inline const std::string &get_debug_name() const
 	{
 		return debug_name;
@@ -259,5 +293,11 @@ class ShaderModule
 	std::vector<ShaderResource> resources;
 
 	std::string info_log;
+
+	std::string source_filename;
+
+	size_t source_id{0};
+
+	ShaderVariant shader_variant;
 };
 }        // namespace vkb
@@ -0,0 +1,156 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shader_object.h"
+
+#include "device.h"
+#include "pipeline_layout.h"
+#include "shader_module.h"
+
+namespace vkb
+{
+namespace
+{
+VkShaderStageFlags get_layout_stages(const PipelineLayout &pipeline_layout)
+{
+	VkShaderStageFlags layout_stages = 0;
+	for (auto *shader_module : pipeline_layout.get_shader_modules())
+	{
+		layout_stages |= shader_module->get_stage();
+	}
+
+	return layout_stages;
+}
+
+/**
+ * @brief The stage which follows the given one among the stages of the pipeline layout
+ */
+VkShaderStageFlags get_next_stage(const PipelineLayout &pipeline_layout, VkShaderStageFlagBits stage)
+{
+	// Layouts have either the task and mesh stages, or the vertex processing stages
+	const std::vector<VkShaderStageFlagBits> stage_order{VK_SHADER_STAGE_TASK_BIT_EXT,
+	                                                     VK_SHADER_STAGE_MESH_BIT_EXT,
+	                                                     VK_SHADER_STAGE_VERTEX_BIT,
+	                                                     VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+	                                                     VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+	                                                     VK_SHADER_STAGE_GEOMETRY_BIT,
+	                                                     VK_SHADER_STAGE_FRAGMENT_BIT};
+
+	VkShaderStageFlags layout_stages = get_layout_stages(pipeline_layout);
+
+	auto stage_it = std::find(stage_order.begin(), stage_order.end(), stage);
+	if (stage_it == stage_order.end())
+	{
+		return 0;
+	}
+
+	for (++stage_it; stage_it != stage_order.end(); ++stage_it)
+	{
+		if (layout_stages & *stage_it)
+		{
+			return *stage_it;
+		}
+	}
+
+	return 0;
+}
+}        // namespace
+
+ShaderObject::ShaderObject(Device                            &device,
+                           const PipelineLayout              &pipeline_layout,
+                           const ShaderModule                &shader_module,
+                           const SpecializationConstantState &specialization_constant_state) :
+    device{device},
+    stage{shader_module.get_stage()}
+{
+	// Create specialization info from tracked state
+	std::vector<uint8_t>                  data{};
+	std::vector<VkSpecializationMapEntry> map_entries{};
+
+	for (const auto &specialization_constant : specialization_constant_state.get_specialization_constant_state())
+	{
+		map_entries.push_back({specialization_constant.first, to_u32(data.size()), specialization_constant.second.size()});
+		data.insert(data.end(), specialization_constant.second.begin(), specialization_constant.second.end());
+	}
+
+	VkSpecializationInfo specialization_info{};
+	specialization_info.mapEntryCount = to_u32(map_entries.size());
+	specialization_info.pMapEntries   = map_entries.data();
+	specialization_info.dataSize      = data.size();
+	specialization_info.pData         = data.data();
+
+	// Same interface as the pipeline layout, so that descriptors and push constants can be bound with it
+	auto set_layouts          = pipeline_layout.get_descriptor_set_layout_handles();
+	auto push_constant_ranges = pipeline_layout.get_push_constant_ranges();
+
+	VkShaderCreateInfoEXT create_info{VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT};
+
+	create_info.stage                  = stage;
+	create_info.nextStage              = get_next_stage(pipeline_layout, stage);
+	create_info.codeType               = VK_SHADER_CODE_TYPE_SPIRV_EXT;
+	create_info.codeSize               = shader_module.get_binary().size() * sizeof(uint32_t);
+	create_info.pCode                  = shader_module.get_binary().data();
+	create_info.pName                  = shader_module.get_entry_point().c_str();
+	create_info.setLayoutCount         = to_u32(set_layouts.size());
+	create_info.pSetLayouts            = set_layouts.data();
+	create_info.pushConstantRangeCount = to_u32(push_constant_ranges.size());
+	create_info.pPushConstantRanges    = push_constant_ranges.data();
+	create_info.pSpecializationInfo    = &specialization_info;
+
+	if (stage == VK_SHADER_STAGE_MESH_BIT_EXT && !(get_layout_stages(pipeline_layout) & VK_SHADER_STAGE_TASK_BIT_EXT))
+	{
+		create_info.flags |= VK_SHADER_CREATE_NO_TASK_SHADER_BIT_EXT;
+	}
+
+	VkResult result = vkCreateShadersEXT(device.get_handle(), 1, &create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot create ShaderObject"};
+	}
+
+	device.get_debug_utils().set_debug_name(device.get_handle(),
+	                                        VK_OBJECT_TYPE_SHADER_EXT, reinterpret_cast<uint64_t>(handle),
+	                                        shader_module.get_debug_name().c_str());
+}
+
+ShaderObject::ShaderObject(ShaderObject &&other) :
+    device{other.device},
+    handle{other.handle},
+    stage{other.stage}
+{
+	other.handle = VK_NULL_HANDLE;
+}
+
+ShaderObject::~ShaderObject()
+{
+	if (handle != VK_NULL_HANDLE)
+	{
+		vkDestroyShaderEXT(device.get_handle(), handle, nullptr);
+	}
+}
+
+VkShaderEXT ShaderObject::get_handle() const
+{
+	return handle;
+}
+
+VkShaderStageFlagBits ShaderObject::get_stage() const
+{
+	return stage;
+}
+}        // namespace vkb
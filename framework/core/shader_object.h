@@ -0,0 +1,66 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "rendering/pipeline_state.h"
+
+namespace vkb
+{
+class Device;
+class PipelineLayout;
+class ShaderModule;
+
+/**
+ * @brief A wrapper class for VkShaderEXT, from VK_EXT_shader_object
+ *
+ * A shader object is created from one shader module of a pipeline layout, with the descriptor set layouts
+ * and push constant ranges of the layout, so that descriptors bound with the layout can be used by it.
+ * All the other state is set dynamically on the command buffer.
+ */
+class ShaderObject
+{
+  public:
+	ShaderObject(Device                            &device,
+	             const PipelineLayout              &pipeline_layout,
+	             const ShaderModule                &shader_module,
+	             const SpecializationConstantState &specialization_constant_state);
+
+	ShaderObject(const ShaderObject &) = delete;
+
+	ShaderObject(ShaderObject &&other);
+
+	~ShaderObject();
+
+	ShaderObject &operator=(const ShaderObject &) = delete;
+
+	ShaderObject &operator=(ShaderObject &&) = delete;
+
+	VkShaderEXT get_handle() const;
+
+	VkShaderStageFlagBits get_stage() const;
+
+  private:
+	Device &device;
+
+	VkShaderEXT handle{VK_NULL_HANDLE};
+
+	VkShaderStageFlagBits stage;
+};
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2024, Arm Limited and Contributors
+/* Copyright (c) 2021-2026, Arm Limited and Contributors
  * Copyright (c) 2024, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -269,10 +269,12 @@ inline void VulkanResource<bindingType, Handle>::set_debug_name(const std::strin
 {
 	debug_name = name;
 
+#ifdef VKB_VULKAN_DEBUG
 	if (device && !debug_name.empty())
 	{
 		get_device().get_debug_utils().set_debug_name(get_device().get_handle(), get_object_type(), get_handle_u64(), debug_name.c_str());
 	}
+#endif
 }
 
 template <vkb::BindingType bindingType, typename Handle>
@@ -0,0 +1,132 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_handover.h"
+
+#include "core/hpp_device.h"
+#include "core/hpp_instance.h"
+#include "core/util/logging.hpp"
+#include "persistent_pipeline_cache.h"
+
+namespace vkb
+{
+bool DeviceHandover::InstanceRequirements::operator==(const InstanceRequirements &other) const
+{
+	return api_version == other.api_version &&
+	       headless == other.headless &&
+	       extensions == other.extensions &&
+	       layers == other.layers;
+}
+
+bool DeviceHandover::DeviceRequirements::operator==(const DeviceRequirements &other) const
+{
+	return extensions == other.extensions &&
+	       features == other.features &&
+	       high_priority_graphics_queue == other.high_priority_graphics_queue &&
+	       device_group == other.device_group;
+}
+
+DeviceHandover &DeviceHandover::get()
+{
+	static DeviceHandover handover;
+	return handover;
+}
+
+void DeviceHandover::set_enabled(bool enable)
+{
+	enabled = enable;
+}
+
+bool DeviceHandover::is_enabled() const
+{
+	return enabled;
+}
+
+void DeviceHandover::hand_over(std::unique_ptr<core::HPPInstance>       &&new_instance,
+                               vk::SurfaceKHR                             new_surface,
+                               const InstanceRequirements                &new_instance_requirements,
+                               std::unique_ptr<core::HPPDevice>         &&new_device,
+                               std::unique_ptr<PersistentPipelineCache> &&new_pipeline_cache,
+                               const DeviceRequirements                  &new_device_requirements)
+{
+	release();
+
+	instance              = std::move(new_instance);
+	surface               = new_surface;
+	instance_requirements = new_instance_requirements;
+	device                = std::move(new_device);
+	pipeline_cache        = std::move(new_pipeline_cache);
+	device_requirements   = new_device_requirements;
+}
+
+bool DeviceHandover::take_instance(const InstanceRequirements &requirements, std::unique_ptr<core::HPPInstance> &instance_out, vk::SurfaceKHR &surface_out)
+{
+	if (!instance || !(instance_requirements == requirements))
+	{
+		release();
+		return false;
+	}
+
+	LOGI("Taking over the instance of the previous sample");
+
+	instance_out = std::move(instance);
+	surface_out  = surface;
+	surface      = nullptr;
+
+	return true;
+}
+
+bool DeviceHandover::take_device(const DeviceRequirements &requirements, std::unique_ptr<core::HPPDevice> &device_out, std::unique_ptr<PersistentPipelineCache> &pipeline_cache_out)
+{
+	if (!device || !(device_requirements == requirements))
+	{
+		release_device();
+		return false;
+	}
+
+	LOGI("Taking over the device of the previous sample");
+
+	device_out         = std::move(device);
+	pipeline_cache_out = std::move(pipeline_cache);
+
+	return true;
+}
+
+void DeviceHandover::release()
+{
+	release_device();
+
+	if (surface)
+	{
+		instance->get_handle().destroySurfaceKHR(surface);
+		surface = nullptr;
+	}
+
+	instance.reset();
+}
+
+void DeviceHandover::release_device()
+{
+	if (device)
+	{
+		device->get_handle().waitIdle();
+	}
+
+	pipeline_cache.reset();
+	device.reset();
+}
+}        // namespace vkb
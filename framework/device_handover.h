@@ -0,0 +1,151 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+namespace vkb
+{
+class PersistentPipelineCache;
+
+namespace core
+{
+class HPPDevice;
+class HPPInstance;
+}        // namespace core
+
+/**
+ * @brief The instance, surface, device and pipeline cache a sample hands over to the next one in place of destroying them
+ *
+ * Once enabled, e.g. by the batch mode between two samples, the next sample to be destroyed hands its Vulkan objects
+ * over, and the next one to be prepared takes them over if it would create an instance and a device with the same
+ * requirements. Objects it can not take over are released before it creates its own, as a window only has one surface.
+ * Shaders are shared through ShaderCache::get() already, so a taken over device only skips instance and device creation,
+ * loading the pipeline cache, and creating the shader modules, layouts and pipelines of the resource cache again.
+ */
+class DeviceHandover
+{
+  public:
+	/**
+	 * @brief What an instance is created with
+	 */
+	struct InstanceRequirements
+	{
+		uint32_t api_version{0};
+
+		bool headless{false};
+
+		/// The extensions and whether they are optional
+		std::map<std::string, bool> extensions;
+
+		std::vector<std::string> layers;
+
+		bool operator==(const InstanceRequirements &other) const;
+	};
+
+	/**
+	 * @brief What a device is created with
+	 */
+	struct DeviceRequirements
+	{
+		/// The extensions and whether they are optional
+		std::map<std::string, bool> extensions;
+
+		/// The requested core and extension features, see PhysicalDevice::get_requested_feature_bytes()
+		std::vector<uint8_t> features;
+
+		bool high_priority_graphics_queue{false};
+
+		std::vector<VkPhysicalDevice> device_group;
+
+		bool operator==(const DeviceRequirements &other) const;
+	};
+
+	static DeviceHandover &get();
+
+	DeviceHandover() = default;
+
+	DeviceHandover(const DeviceHandover &) = delete;
+
+	DeviceHandover(DeviceHandover &&) = delete;
+
+	~DeviceHandover() = default;
+
+	DeviceHandover &operator=(const DeviceHandover &) = delete;
+
+	DeviceHandover &operator=(DeviceHandover &&) = delete;
+
+	/**
+	 * @brief Sets whether the next sample destroyed hands its objects over
+	 */
+	void set_enabled(bool enable);
+
+	bool is_enabled() const;
+
+	/**
+	 * @brief Hands the objects of a sample over, releasing the ones held already
+	 *        The device must be idle, and must not hold resources of the sample anymore.
+	 */
+	void hand_over(std::unique_ptr<core::HPPInstance>       &&instance,
+	               vk::SurfaceKHR                             surface,
+	               const InstanceRequirements                &instance_requirements,
+	               std::unique_ptr<core::HPPDevice>         &&device,
+	               std::unique_ptr<PersistentPipelineCache> &&pipeline_cache,
+	               const DeviceRequirements                  &device_requirements);
+
+	/**
+	 * @brief Takes the instance and its surface over if they were created with the same requirements, or releases everything
+	 * @return Whether the instance was taken over
+	 */
+	bool take_instance(const InstanceRequirements &requirements, std::unique_ptr<core::HPPInstance> &instance, vk::SurfaceKHR &surface);
+
+	/**
+	 * @brief Takes the device and its pipeline cache over if it was created with the same requirements, or releases them
+	 *        The instance must have been taken over before.
+	 * @return Whether the device was taken over
+	 */
+	bool take_device(const DeviceRequirements &requirements, std::unique_ptr<core::HPPDevice> &device, std::unique_ptr<PersistentPipelineCache> &pipeline_cache);
+
+	/**
+	 * @brief Destroys the objects handed over and not taken yet
+	 */
+	void release();
+
+  private:
+	void release_device();
+
+	bool enabled{false};
+
+	std::unique_ptr<core::HPPInstance> instance;
+
+	vk::SurfaceKHR surface;
+
+	InstanceRequirements instance_requirements;
+
+	std::unique_ptr<core::HPPDevice> device;
+
+	std::unique_ptr<PersistentPipelineCache> pipeline_cache;
+
+	DeviceRequirements device_requirements;
+};
+}        // namespace vkb
@@ -0,0 +1,114 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "aabb_batch.h"
+
+#include <core/util/job_system.hpp>
+
+#include "frustum.h"
+
+namespace vkb
+{
+void AABBBatch::clear()
+{
+	min_x.clear();
+	min_y.clear();
+	min_z.clear();
+	max_x.clear();
+	max_y.clear();
+	max_z.clear();
+}
+
+void AABBBatch::reserve(size_t capacity)
+{
+	min_x.reserve(capacity);
+	min_y.reserve(capacity);
+	min_z.reserve(capacity);
+	max_x.reserve(capacity);
+	max_y.reserve(capacity);
+	max_z.reserve(capacity);
+}
+
+size_t AABBBatch::push_back(const glm::vec3 &min, const glm::vec3 &max)
+{
+	min_x.push_back(min.x);
+	min_y.push_back(min.y);
+	min_z.push_back(min.z);
+	max_x.push_back(max.x);
+	max_y.push_back(max.y);
+	max_z.push_back(max.z);
+
+	return min_x.size() - 1;
+}
+
+size_t AABBBatch::size() const
+{
+	return min_x.size();
+}
+
+glm::vec3 AABBBatch::get_min(size_t index) const
+{
+	return {min_x[index], min_y[index], min_z[index]};
+}
+
+glm::vec3 AABBBatch::get_max(size_t index) const
+{
+	return {max_x[index], max_y[index], max_z[index]};
+}
+
+void AABBBatch::cull(const Frustum &frustum, std::vector<uint8_t> &visible, JobSystem *job_system) const
+{
+	// Ranges smaller than this are not worth the cost of dispatching to the job system
+	const size_t parallel_grain_size = 4096;
+
+	const size_t count = size();
+
+	visible.assign(count, 1);
+
+	uint8_t *visible_data = visible.data();
+
+	if (!job_system || count <= parallel_grain_size)
+	{
+		cull_range(frustum, 0, count, visible_data);
+		return;
+	}
+
+	job_system->parallel_for(count, parallel_grain_size, [this, &frustum, visible_data](size_t begin, size_t end) {
+		cull_range(frustum, begin, end, visible_data);
+	});
+}
+
+void AABBBatch::cull_range(const Frustum &frustum, size_t begin, size_t end, uint8_t *visible) const
+{
+	for (auto &plane : frustum.get_planes())
+	{
+		// For each plane only the corner furthest along the plane normal needs testing,
+		// choosing it per plane keeps the inner loop branch free
+		const float *x = plane.x > 0.0f ? max_x.data() : min_x.data();
+		const float *y = plane.y > 0.0f ? max_y.data() : min_y.data();
+		const float *z = plane.z > 0.0f ? max_z.data() : min_z.data();
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			float distance = plane.x * x[i] + plane.y * y[i] + plane.z * z[i] + plane.w;
+
+			// Written so that a degenerate plane, e.g. the far plane of an infinite projection, culls nothing
+			visible[i] &= static_cast<uint8_t>(!(distance < 0.0f));
+		}
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,74 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/glm_common.h"
+
+namespace vkb
+{
+class Frustum;
+class JobSystem;
+
+/**
+ * @brief A batch of axis aligned bounding boxes stored as a structure of arrays,
+ *        so that culling a whole batch against a frustum vectorizes well
+ */
+class AABBBatch
+{
+  public:
+	/**
+	 * @brief Removes all boxes, keeping the allocated storage
+	 */
+	void clear();
+
+	void reserve(size_t capacity);
+
+	/**
+	 * @brief Adds a box to the batch
+	 * @return The index of the box within the batch
+	 */
+	size_t push_back(const glm::vec3 &min, const glm::vec3 &max);
+
+	size_t size() const;
+
+	glm::vec3 get_min(size_t index) const;
+
+	glm::vec3 get_max(size_t index) const;
+
+	/**
+	 * @brief Tests every box of the batch against a frustum
+	 * @param frustum The frustum to test against
+	 * @param[out] visible One entry per box, set to 1 if the box intersects the frustum and 0 otherwise
+	 * @param job_system If given, large batches are split in ranges culled in parallel
+	 */
+	void cull(const Frustum &frustum, std::vector<uint8_t> &visible, JobSystem *job_system = nullptr) const;
+
+  private:
+	void cull_range(const Frustum &frustum, size_t begin, size_t end, uint8_t *visible) const;
+
+	std::vector<float> min_x;
+	std::vector<float> min_y;
+	std::vector<float> min_z;
+	std::vector<float> max_x;
+	std::vector<float> max_y;
+	std::vector<float> max_z;
+};
+}        // namespace vkb
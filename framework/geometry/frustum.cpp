@@ -17,6 +17,9 @@
 
 #include "frustum.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace vkb
 {
 void Frustum::update(const glm::mat4 &matrix)
@@ -58,6 +61,59 @@ void Frustum::update(const glm::mat4 &matrix)
 	}
 }
 
+void Frustum::update(const std::vector<glm::mat4> &matrices)
+{
+	assert(!matrices.empty() && "Cannot update a frustum without a matrix");
+
+	if (matrices.size() == 1)
+	{
+		update(matrices[0]);
+		return;
+	}
+
+	// Corners of all the frustums, from the corners of the clip volume, whose depth range [-1, 1] contains the one of Vulkan
+	std::vector<glm::vec3>                corners;
+	std::vector<std::array<glm::vec4, 6>> frustum_planes;
+	corners.reserve(matrices.size() * 8);
+	frustum_planes.reserve(matrices.size());
+
+	for (auto &matrix : matrices)
+	{
+		glm::mat4 inverse = glm::inverse(matrix);
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			glm::vec4 corner = inverse * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+			corners.push_back(glm::vec3(corner) / corner.w);
+		}
+
+		update(matrix);
+		frustum_planes.push_back(planes);
+	}
+
+	for (size_t side = 0; side < planes.size(); side++)
+	{
+		float min_shift = std::numeric_limits<float>::max();
+
+		for (auto &candidates : frustum_planes)
+		{
+			glm::vec4 plane = candidates[side];
+
+			// Distance the plane is moved along its normal so that no corner is outside of it
+			float shift = 0.0f;
+			for (auto &corner : corners)
+			{
+				shift = std::max(shift, -(glm::dot(glm::vec3(plane), corner) + plane.w));
+			}
+
+			if (shift < min_shift)
+			{
+				min_shift    = shift;
+				planes[side] = glm::vec4(glm::vec3(plane), plane.w + shift);
+			}
+		}
+	}
+}
+
 bool Frustum::check_sphere(glm::vec3 pos, float radius)
 {
 	for (size_t i = 0; i < planes.size(); i++)
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "common/error.h"
 
@@ -48,6 +49,14 @@ class Frustum
 	 */
 	void update(const glm::mat4 &matrix);
 
+	/**
+	 * @brief Updates the frustums planes to contain the frustums of several matrices, such as the ones of the eyes of a stereo pair
+	 *        Each plane is the plane of one of the frustums moved out until the corners of all the frustums are inside it, the one
+	 *        moved the least. Objects inside any of the frustums are never culled, some outside of all of them may pass.
+	 * @param matrices The matrices of the frustums, with a finite far plane
+	 */
+	void update(const std::vector<glm::mat4> &matrices);
+
 	/**
 	 * @brief Checks if a sphere is inside the Frustum
 	 * @param pos The center of the sphere
@@ -0,0 +1,515 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry/mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace vkb
+{
+namespace
+{
+/// Size of the cache modelled by optimize_vertex_cache(), larger than the caches of most GPUs, as in Forsyth's paper
+constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+
+/// Size of the FIFO cache simulated to cut the clusters of optimize_overdraw()
+constexpr uint32_t FIFO_CACHE_SIZE = 16;
+
+/// Finest grid of simplify_mesh() tried by optimize_mesh(), in cells along the largest side of the bounds
+constexpr float FINEST_LOD_GRID = 1024.0f;
+
+/**
+ * @brief Score of a vertex in Forsyth's algorithm, the triangle with the highest sum of vertex scores is emitted next
+ * @param cache_position Position in the modelled cache, -1 if the vertex is not in the cache
+ * @param remaining_triangles Number of triangles of the vertex not emitted yet
+ */
+float forsyth_vertex_score(int32_t cache_position, uint32_t remaining_triangles)
+{
+	if (remaining_triangles == 0)
+	{
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+
+	if (cache_position >= 0)
+	{
+		// The vertices of the last triangle get a fixed score, so that the next triangle does not just reuse its edge
+		if (cache_position < 3)
+		{
+			score = 0.75f;
+		}
+		else
+		{
+			score = std::pow(1.0f - static_cast<float>(cache_position - 3) / (FORSYTH_CACHE_SIZE - 3), 1.5f);
+		}
+	}
+
+	// Vertices with few triangles left are favoured, so that they are finished instead of being left alone
+	return score + 2.0f / std::sqrt(static_cast<float>(remaining_triangles));
+}
+
+std::pair<glm::vec3, glm::vec3> compute_bounds(const std::vector<glm::vec3> &positions)
+{
+	glm::vec3 min{std::numeric_limits<float>::max()};
+	glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+	for (auto &position : positions)
+	{
+		min = glm::min(min, position);
+		max = glm::max(max, position);
+	}
+
+	return {min, max};
+}
+}        // namespace
+
+void optimize_vertex_cache(std::vector<uint32_t> &indices, uint32_t vertex_count)
+{
+	size_t triangle_count = indices.size() / 3;
+	if (triangle_count == 0)
+	{
+		return;
+	}
+
+	// Triangles of each vertex, the ones not emitted yet first
+	std::vector<uint32_t> triangle_offsets(vertex_count + 1, 0);
+	for (auto index : indices)
+	{
+		++triangle_offsets[index + 1];
+	}
+	std::partial_sum(triangle_offsets.begin(), triangle_offsets.end(), triangle_offsets.begin());
+
+	std::vector<uint32_t> vertex_triangles(triangle_count * 3);
+	std::vector<uint32_t> remaining_triangles(vertex_count, 0);
+	for (uint32_t triangle = 0; triangle < triangle_count; ++triangle)
+	{
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t vertex = indices[triangle * 3 + corner];
+			vertex_triangles[triangle_offsets[vertex] + remaining_triangles[vertex]++] = triangle;
+		}
+	}
+
+	std::vector<int32_t> cache_positions(vertex_count, -1);
+
+	std::vector<float> vertex_scores(vertex_count);
+	for (uint32_t vertex = 0; vertex < vertex_count; ++vertex)
+	{
+		vertex_scores[vertex] = forsyth_vertex_score(-1, remaining_triangles[vertex]);
+	}
+
+	std::vector<float> triangle_scores(triangle_count);
+	for (uint32_t triangle = 0; triangle < triangle_count; ++triangle)
+	{
+		triangle_scores[triangle] = vertex_scores[indices[triangle * 3]] + vertex_scores[indices[triangle * 3 + 1]] + vertex_scores[indices[triangle * 3 + 2]];
+	}
+
+	std::vector<bool> emitted(triangle_count, false);
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> new_cache;
+
+	auto update_score = [&](uint32_t vertex, int32_t cache_position) {
+		cache_positions[vertex] = cache_position;
+
+		float score = forsyth_vertex_score(cache_position, remaining_triangles[vertex]);
+		float delta = score - vertex_scores[vertex];
+
+		vertex_scores[vertex] = score;
+
+		for (uint32_t i = 0; i < remaining_triangles[vertex]; ++i)
+		{
+			triangle_scores[vertex_triangles[triangle_offsets[vertex] + i]] += delta;
+		}
+	};
+
+	size_t  next_unemitted = 0;
+	int64_t best_triangle  = -1;
+
+	while (result.size() < triangle_count * 3)
+	{
+		if (best_triangle < 0)
+		{
+			// No triangle of the cached vertices is left, carry on with the next one of the original order
+			while (emitted[next_unemitted])
+			{
+				++next_unemitted;
+			}
+			best_triangle = static_cast<int64_t>(next_unemitted);
+		}
+
+		auto triangle = static_cast<uint32_t>(best_triangle);
+
+		emitted[triangle] = true;
+
+		new_cache.clear();
+
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t vertex = indices[triangle * 3 + corner];
+			result.push_back(vertex);
+
+			// Moves the triangle past the remaining triangles of the vertex
+			auto begin = vertex_triangles.begin() + triangle_offsets[vertex];
+			auto end   = begin + remaining_triangles[vertex];
+			auto it    = std::find(begin, end, triangle);
+			if (it != end)
+			{
+				std::iter_swap(it, end - 1);
+				--remaining_triangles[vertex];
+			}
+
+			if (std::find(new_cache.begin(), new_cache.end(), vertex) == new_cache.end())
+			{
+				new_cache.push_back(vertex);
+			}
+		}
+
+		for (auto vertex : cache)
+		{
+			if (std::find(new_cache.begin(), new_cache.end(), vertex) == new_cache.end())
+			{
+				new_cache.push_back(vertex);
+			}
+		}
+
+		for (size_t i = FORSYTH_CACHE_SIZE; i < new_cache.size(); ++i)
+		{
+			update_score(new_cache[i], -1);
+		}
+		new_cache.resize(std::min<size_t>(new_cache.size(), FORSYTH_CACHE_SIZE));
+
+		std::swap(cache, new_cache);
+
+		for (size_t i = 0; i < cache.size(); ++i)
+		{
+			update_score(cache[i], static_cast<int32_t>(i));
+		}
+
+		// Only the triangles of the cached vertices are candidates, which keeps the algorithm linear
+		best_triangle    = -1;
+		float best_score = std::numeric_limits<float>::lowest();
+		for (auto vertex : cache)
+		{
+			for (uint32_t i = 0; i < remaining_triangles[vertex]; ++i)
+			{
+				uint32_t candidate = vertex_triangles[triangle_offsets[vertex] + i];
+				if (triangle_scores[candidate] > best_score)
+				{
+					best_score    = triangle_scores[candidate];
+					best_triangle = candidate;
+				}
+			}
+		}
+	}
+
+	indices = std::move(result);
+}
+
+void optimize_overdraw(std::vector<uint32_t> &indices, const std::vector<glm::vec3> &positions)
+{
+	size_t triangle_count = indices.size() / 3;
+	if (triangle_count == 0)
+	{
+		return;
+	}
+
+	// A vertex is in the FIFO cache if fewer than FIFO_CACHE_SIZE vertices were added to the cache since it was
+	std::vector<uint32_t> cache_timestamps(positions.size(), 0);
+	uint32_t              timestamp = FIFO_CACHE_SIZE + 1;
+
+	std::vector<size_t> cluster_starts;
+	for (size_t triangle = 0; triangle < triangle_count; ++triangle)
+	{
+		uint32_t misses = 0;
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t vertex = indices[triangle * 3 + corner];
+			if (timestamp - cache_timestamps[vertex] > FIFO_CACHE_SIZE)
+			{
+				cache_timestamps[vertex] = timestamp++;
+				++misses;
+			}
+		}
+
+		if (triangle == 0 || misses == 3)
+		{
+			cluster_starts.push_back(triangle);
+		}
+	}
+	cluster_starts.push_back(triangle_count);
+
+	size_t cluster_count = cluster_starts.size() - 1;
+
+	std::vector<glm::vec3> cluster_centroids(cluster_count, glm::vec3{0.0f});
+	std::vector<glm::vec3> cluster_normals(cluster_count, glm::vec3{0.0f});
+
+	glm::vec3 mesh_centroid{0.0f};
+	float     mesh_area = 0.0f;
+
+	for (size_t cluster = 0; cluster < cluster_count; ++cluster)
+	{
+		float cluster_area = 0.0f;
+
+		for (size_t triangle = cluster_starts[cluster]; triangle < cluster_starts[cluster + 1]; ++triangle)
+		{
+			const glm::vec3 &a = positions[indices[triangle * 3]];
+			const glm::vec3 &b = positions[indices[triangle * 3 + 1]];
+			const glm::vec3 &c = positions[indices[triangle * 3 + 2]];
+
+			glm::vec3 normal = glm::cross(b - a, c - a);
+			float     area   = glm::length(normal);
+
+			cluster_centroids[cluster] += (a + b + c) * (area / 3.0f);
+			cluster_normals[cluster] += normal;
+			cluster_area += area;
+		}
+
+		mesh_centroid += cluster_centroids[cluster];
+		mesh_area += cluster_area;
+
+		if (cluster_area > 0.0f)
+		{
+			cluster_centroids[cluster] /= cluster_area;
+		}
+	}
+
+	if (mesh_area > 0.0f)
+	{
+		mesh_centroid /= mesh_area;
+	}
+
+	// Clusters facing away from the center are on the outside of the mesh, and hide the inner ones when drawn first
+	std::vector<float> cluster_keys(cluster_count, 0.0f);
+	for (size_t cluster = 0; cluster < cluster_count; ++cluster)
+	{
+		float normal_length = glm::length(cluster_normals[cluster]);
+		if (normal_length > 0.0f)
+		{
+			cluster_keys[cluster] = glm::dot(cluster_centroids[cluster] - mesh_centroid, cluster_normals[cluster] / normal_length);
+		}
+	}
+
+	std::vector<size_t> cluster_order(cluster_count);
+	std::iota(cluster_order.begin(), cluster_order.end(), 0);
+	std::stable_sort(cluster_order.begin(), cluster_order.end(), [&cluster_keys](size_t a, size_t b) { return cluster_keys[a] > cluster_keys[b]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	for (auto cluster : cluster_order)
+	{
+		result.insert(result.end(), indices.begin() + cluster_starts[cluster] * 3, indices.begin() + cluster_starts[cluster + 1] * 3);
+	}
+
+	indices = std::move(result);
+}
+
+std::vector<uint32_t> optimize_vertex_fetch(std::vector<uint32_t> &indices, uint32_t vertex_count)
+{
+	constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+
+	std::vector<uint32_t> remap(vertex_count, UNUSED);
+
+	uint32_t next_vertex = 0;
+
+	for (auto &index : indices)
+	{
+		if (remap[index] == UNUSED)
+		{
+			remap[index] = next_vertex++;
+		}
+
+		index = remap[index];
+	}
+
+	for (auto &new_index : remap)
+	{
+		if (new_index == UNUSED)
+		{
+			new_index = next_vertex++;
+		}
+	}
+
+	return remap;
+}
+
+void remap_vertex_data(std::vector<uint8_t> &data, size_t stride, const std::vector<uint32_t> &remap)
+{
+	std::vector<uint8_t> result(data.size());
+
+	size_t vertex_count = std::min(remap.size(), data.size() / stride);
+
+	for (size_t vertex = 0; vertex < vertex_count; ++vertex)
+	{
+		std::memcpy(result.data() + remap[vertex] * stride, data.data() + vertex * stride, stride);
+	}
+
+	data = std::move(result);
+}
+
+std::vector<uint32_t> simplify_mesh(const std::vector<uint32_t> &indices, const std::vector<glm::vec3> &positions, float cell_size)
+{
+	auto bounds = compute_bounds(positions);
+
+	// 21 bits per axis of the cell coordinates, packed into a 64-bit key
+	constexpr uint64_t CELL_MASK = (1u << 21) - 1;
+
+	std::unordered_map<uint64_t, uint32_t> cell_ids;
+
+	std::vector<uint32_t>  vertex_cells(positions.size());
+	std::vector<glm::vec3> cell_centroids;
+	std::vector<uint32_t>  cell_vertex_counts;
+
+	for (size_t vertex = 0; vertex < positions.size(); ++vertex)
+	{
+		glm::uvec3 cell = glm::uvec3((positions[vertex] - bounds.first) / cell_size);
+		uint64_t   key  = (uint64_t{cell.x} & CELL_MASK) | ((uint64_t{cell.y} & CELL_MASK) << 21) | ((uint64_t{cell.z} & CELL_MASK) << 42);
+
+		auto cell_it = cell_ids.emplace(key, static_cast<uint32_t>(cell_centroids.size())).first;
+		if (cell_it->second == cell_centroids.size())
+		{
+			cell_centroids.emplace_back(0.0f);
+			cell_vertex_counts.push_back(0);
+		}
+
+		vertex_cells[vertex] = cell_it->second;
+		cell_centroids[cell_it->second] += positions[vertex];
+		++cell_vertex_counts[cell_it->second];
+	}
+
+	// Each cell keeps the vertex closest to its centroid, so that the simplified triangles use the vertex data as it is
+	std::vector<uint32_t> cell_vertices(cell_centroids.size(), 0);
+	std::vector<float>    cell_distances(cell_centroids.size(), std::numeric_limits<float>::max());
+
+	for (size_t vertex = 0; vertex < positions.size(); ++vertex)
+	{
+		uint32_t  cell     = vertex_cells[vertex];
+		glm::vec3 centroid = cell_centroids[cell] / static_cast<float>(cell_vertex_counts[cell]);
+		glm::vec3 offset   = positions[vertex] - centroid;
+		float     distance = glm::dot(offset, offset);
+
+		if (distance < cell_distances[cell])
+		{
+			cell_distances[cell] = distance;
+			cell_vertices[cell]  = static_cast<uint32_t>(vertex);
+		}
+	}
+
+	std::vector<std::array<uint32_t, 3>> triangles;
+	triangles.reserve(indices.size() / 3);
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		std::array<uint32_t, 3> triangle{cell_vertices[vertex_cells[indices[i]]],
+		                                 cell_vertices[vertex_cells[indices[i + 1]]],
+		                                 cell_vertices[vertex_cells[indices[i + 2]]]};
+
+		if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0])
+		{
+			continue;
+		}
+
+		// Rotated to start with the lowest index, which keeps the winding, so that duplicates are found by sorting
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+
+	std::sort(triangles.begin(), triangles.end());
+	triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+
+	std::vector<uint32_t> result;
+	result.reserve(triangles.size() * 3);
+
+	for (auto &triangle : triangles)
+	{
+		result.insert(result.end(), triangle.begin(), triangle.end());
+	}
+
+	optimize_vertex_cache(result, static_cast<uint32_t>(positions.size()));
+
+	return result;
+}
+
+std::vector<uint32_t> optimize_mesh(std::vector<uint32_t> &indices, std::vector<glm::vec3> &positions, uint32_t lod_count, std::vector<MeshLod> &lods)
+{
+	auto vertex_count = static_cast<uint32_t>(positions.size());
+
+	lods.clear();
+
+	optimize_vertex_cache(indices, vertex_count);
+	optimize_overdraw(indices, positions);
+
+	if (lod_count > 0 && !indices.empty())
+	{
+		auto      bounds = compute_bounds(positions);
+		glm::vec3 size   = bounds.second - bounds.first;
+		float     extent = std::max({size.x, size.y, size.z});
+
+		const std::vector<uint32_t> full_indices = indices;
+
+		size_t previous_index_count = full_indices.size();
+		float  cell_size            = extent / FINEST_LOD_GRID;
+
+		// The grid gets coarser until a level has at most half the triangles of the previous one
+		while (lods.size() < lod_count && cell_size > 0.0f && cell_size < extent)
+		{
+			size_t target_index_count = previous_index_count / 6 * 3;
+
+			std::vector<uint32_t> lod_indices;
+			float                 lod_cell_size;
+			do
+			{
+				lod_indices   = simplify_mesh(full_indices, positions, cell_size);
+				lod_cell_size = cell_size;
+				cell_size *= 2.0f;
+			} while (lod_indices.size() > target_index_count && cell_size < extent);
+
+			if (lod_indices.empty() || lod_indices.size() * 10 > previous_index_count * 9)
+			{
+				break;
+			}
+
+			lods.push_back({static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod_indices.size()), lod_cell_size * std::sqrt(3.0f)});
+			indices.insert(indices.end(), lod_indices.begin(), lod_indices.end());
+
+			previous_index_count = lod_indices.size();
+		}
+	}
+
+	auto remap = optimize_vertex_fetch(indices, vertex_count);
+
+	std::vector<glm::vec3> remapped_positions(positions.size());
+	for (size_t vertex = 0; vertex < positions.size(); ++vertex)
+	{
+		remapped_positions[remap[vertex]] = positions[vertex];
+	}
+	positions = std::move(remapped_positions);
+
+	return remap;
+}
+}        // namespace vkb
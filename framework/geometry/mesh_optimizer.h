@@ -0,0 +1,97 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/glm_common.h"
+
+namespace vkb
+{
+/**
+ * @brief A simplified level of detail of a submesh, a range of its index data drawn with the vertices of the full detail
+ */
+struct MeshLod
+{
+	/// First index of the level, counted from the first index of the submesh
+	uint32_t first_index;
+
+	uint32_t index_count;
+
+	/// Largest model space distance between a simplified vertex and the vertices it replaces
+	float error;
+};
+
+/**
+ * @brief Reorders the triangles of a triangle list so that consecutive triangles share vertices, which raises the hit
+ *        rate of the post-transform vertex cache, with Forsyth's linear-speed algorithm
+ * @param indices Triangle list indices, reordered in place
+ * @param vertex_count Number of vertices, all indices must be lower
+ */
+void optimize_vertex_cache(std::vector<uint32_t> &indices, uint32_t vertex_count);
+
+/**
+ * @brief Reorders clusters of triangles so that those facing away from the center of the mesh are drawn first, and occlude
+ *        the ones behind them from most points of view
+ *        The triangles are cut into clusters where the order given by optimize_vertex_cache() restarts with three new
+ *        vertices, so the cache hit rate is mostly kept.
+ * @param indices Triangle list indices, reordered in place
+ * @param positions Positions of the vertices
+ */
+void optimize_overdraw(std::vector<uint32_t> &indices, const std::vector<glm::vec3> &positions);
+
+/**
+ * @brief Renumbers the vertices in the order of their first use, so that vertex fetches go through memory linearly
+ * @param indices Triangle list indices, renumbered in place
+ * @param vertex_count Number of vertices, the unused ones are moved last
+ * @return The new index of each vertex, for remap_vertex_data()
+ */
+std::vector<uint32_t> optimize_vertex_fetch(std::vector<uint32_t> &indices, uint32_t vertex_count);
+
+/**
+ * @brief Moves vertex data to the vertex indices returned by optimize_vertex_fetch()
+ * @param data Vertex data, one vertex every stride bytes
+ * @param stride Distance between two vertices in bytes
+ * @param remap New index of each vertex
+ */
+void remap_vertex_data(std::vector<uint8_t> &data, size_t stride, const std::vector<uint32_t> &remap);
+
+/**
+ * @brief Simplifies a triangle list by merging the vertices in the same cell of a grid into one of them
+ *        The simplified triangles only use the vertices of the mesh, so they are drawn with the same vertex data. Triangles
+ *        which collapse are dropped, and the others are ordered with optimize_vertex_cache().
+ * @param indices Triangle list indices
+ * @param positions Positions of the vertices
+ * @param cell_size Size of the cells of the grid, in model space
+ * @return The indices of the simplified triangles
+ */
+std::vector<uint32_t> simplify_mesh(const std::vector<uint32_t> &indices, const std::vector<glm::vec3> &positions, float cell_size);
+
+/**
+ * @brief Runs the optimizations on a triangle list, and appends up to lod_count simplified levels of detail to the indices,
+ *        each with about half the triangles of the previous one
+ *        Levels stop once they no longer remove a tenth of the triangles of the previous one.
+ * @param indices Triangle list indices, reordered, followed by the indices of the levels of detail on return
+ * @param positions Positions of the vertices, remapped as the vertex data on return
+ * @param lod_count Maximum number of simplified levels of detail
+ * @param lods Set to the levels of detail, with their ranges in indices
+ * @return The new index of each vertex, to pass the other attributes to remap_vertex_data()
+ */
+std::vector<uint32_t> optimize_mesh(std::vector<uint32_t> &indices, std::vector<glm::vec3> &positions, uint32_t lod_count, std::vector<MeshLod> &lods);
+}        // namespace vkb
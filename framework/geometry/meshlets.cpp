@@ -0,0 +1,221 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry/meshlets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace vkb
+{
+namespace
+{
+/// Local index of the vertices which are not in the current meshlet
+constexpr uint8_t UNUSED_VERTEX = 0xFF;
+
+static_assert(MAX_MESHLET_VERTICES < UNUSED_VERTEX, "Meshlet vertices must have 8 bit local indices");
+
+glm::vec3 read_position(const uint8_t *position_data, size_t position_stride, uint32_t index)
+{
+	glm::vec3 position;
+	std::memcpy(&position, position_data + index * position_stride, sizeof(glm::vec3));
+	return position;
+}
+
+uint32_t read_index(const uint8_t *index_data, VkIndexType index_type, uint32_t i)
+{
+	if (!index_data)
+	{
+		return i;
+	}
+
+	if (index_type == VK_INDEX_TYPE_UINT32)
+	{
+		uint32_t index;
+		std::memcpy(&index, index_data + i * sizeof(uint32_t), sizeof(uint32_t));
+		return index;
+	}
+
+	uint16_t index;
+	std::memcpy(&index, index_data + i * sizeof(uint16_t), sizeof(uint16_t));
+	return index;
+}
+
+/**
+ * @brief Computes the bounding sphere and normal cone of the last meshlet
+ */
+void compute_bounds(MeshletGeometry &geometry, const uint8_t *position_data, size_t position_stride)
+{
+	auto &meshlet = geometry.meshlets.back();
+
+	glm::vec3 min_position{std::numeric_limits<float>::max()};
+	glm::vec3 max_position{std::numeric_limits<float>::lowest()};
+	for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+	{
+		auto position = read_position(position_data, position_stride, geometry.vertices[meshlet.first_vertex + i]);
+		min_position  = glm::min(min_position, position);
+		max_position  = glm::max(max_position, position);
+	}
+
+	glm::vec3 center = (min_position + max_position) * 0.5f;
+	float     radius = 0.0f;
+	for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+	{
+		auto position = read_position(position_data, position_stride, geometry.vertices[meshlet.first_vertex + i]);
+		radius        = std::max(radius, glm::length(position - center));
+	}
+
+	meshlet.bounding_sphere = glm::vec4(center, radius);
+
+	// The cone contains the normals of all the triangles, except the degenerate ones which are not rasterized
+	std::vector<glm::vec3> normals;
+	normals.reserve(meshlet.triangle_count);
+
+	glm::vec3 axis{0.0f};
+	for (uint32_t i = 0; i < meshlet.triangle_count; ++i)
+	{
+		uint32_t triangle = geometry.triangles[meshlet.first_triangle + i];
+
+		glm::vec3 p0 = read_position(position_data, position_stride, geometry.vertices[meshlet.first_vertex + (triangle & 0xFF)]);
+		glm::vec3 p1 = read_position(position_data, position_stride, geometry.vertices[meshlet.first_vertex + ((triangle >> 8) & 0xFF)]);
+		glm::vec3 p2 = read_position(position_data, position_stride, geometry.vertices[meshlet.first_vertex + ((triangle >> 16) & 0xFF)]);
+
+		glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		float     length = glm::length(normal);
+		if (length == 0.0f)
+		{
+			continue;
+		}
+
+		normals.push_back(normal / length);
+		axis += normals.back();
+	}
+
+	float axis_length = glm::length(axis);
+
+	meshlet.cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	if (axis_length == 0.0f)
+	{
+		return;
+	}
+
+	axis /= axis_length;
+
+	float min_dot = 1.0f;
+	for (auto &normal : normals)
+	{
+		min_dot = std::min(min_dot, glm::dot(axis, normal));
+	}
+
+	// The normals span a half space or more, so some triangle faces every camera
+	if (min_dot <= 0.0f)
+	{
+		return;
+	}
+
+	meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - min_dot * min_dot));
+}
+}        // namespace
+
+MeshletGeometry build_meshlets(const uint8_t *position_data,
+                               size_t         position_stride,
+                               uint32_t       vertex_count,
+                               const uint8_t *index_data,
+                               VkIndexType    index_type,
+                               uint32_t       index_count)
+{
+	MeshletGeometry geometry;
+
+	std::vector<uint8_t> local_indices(vertex_count, UNUSED_VERTEX);
+
+	auto finish_meshlet = [&]() {
+		auto &meshlet = geometry.meshlets.back();
+		for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+		{
+			local_indices[geometry.vertices[meshlet.first_vertex + i]] = UNUSED_VERTEX;
+		}
+
+		compute_bounds(geometry, position_data, position_stride);
+	};
+
+	for (uint32_t i = 0; i + 2 < index_count; i += 3)
+	{
+		uint32_t triangle[3] = {read_index(index_data, index_type, i),
+		                        read_index(index_data, index_type, i + 1),
+		                        read_index(index_data, index_type, i + 2)};
+
+		uint32_t new_vertex_count = 0;
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			if (triangle[j] >= vertex_count)
+			{
+				throw std::runtime_error("Meshlet vertex index out of range");
+			}
+
+			// Count repeated vertices of the triangle once
+			bool repeated = (j > 0 && triangle[j] == triangle[0]) || (j > 1 && triangle[j] == triangle[1]);
+			if (local_indices[triangle[j]] == UNUSED_VERTEX && !repeated)
+			{
+				new_vertex_count++;
+			}
+		}
+
+		if (geometry.meshlets.empty() ||
+		    geometry.meshlets.back().vertex_count + new_vertex_count > MAX_MESHLET_VERTICES ||
+		    geometry.meshlets.back().triangle_count == MAX_MESHLET_TRIANGLES)
+		{
+			if (!geometry.meshlets.empty())
+			{
+				finish_meshlet();
+			}
+
+			Meshlet meshlet{};
+			meshlet.first_vertex   = static_cast<uint32_t>(geometry.vertices.size());
+			meshlet.first_triangle = static_cast<uint32_t>(geometry.triangles.size());
+			geometry.meshlets.push_back(meshlet);
+		}
+
+		auto &meshlet = geometry.meshlets.back();
+
+		uint32_t packed_triangle = 0;
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			auto &local_index = local_indices[triangle[j]];
+			if (local_index == UNUSED_VERTEX)
+			{
+				local_index = static_cast<uint8_t>(meshlet.vertex_count++);
+				geometry.vertices.push_back(triangle[j]);
+			}
+
+			packed_triangle |= static_cast<uint32_t>(local_index) << (j * 8);
+		}
+
+		geometry.triangles.push_back(packed_triangle);
+		meshlet.triangle_count++;
+	}
+
+	if (!geometry.meshlets.empty())
+	{
+		finish_meshlet();
+	}
+
+	return geometry;
+}
+}        // namespace vkb
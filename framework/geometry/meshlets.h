@@ -0,0 +1,91 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/// Limits of a meshlet, the output sizes of meshlet_geometry.mesh, see meshlet_shared.h
+constexpr uint32_t MAX_MESHLET_VERTICES = 64;
+
+constexpr uint32_t MAX_MESHLET_TRIANGLES = 124;
+
+/**
+ * @brief A cluster of triangles of a submesh, drawn by one mesh shader workgroup, as read by meshlet_geometry.task
+ */
+struct alignas(16) Meshlet
+{
+	/// Center in model space, and radius
+	glm::vec4 bounding_sphere;
+
+	/// Average normal of the triangles, and cone cutoff. The meshlet faces away from a camera at position p if
+	/// dot(center - p, axis) >= cutoff * length(center - p) + radius. The cutoff is 1 if the meshlet cannot be culled.
+	glm::vec4 cone;
+
+	/// First vertex in MeshletGeometry::vertices
+	uint32_t first_vertex;
+
+	uint32_t vertex_count;
+
+	/// First triangle in MeshletGeometry::triangles
+	uint32_t first_triangle;
+
+	uint32_t triangle_count;
+};
+
+/**
+ * @brief The meshlets of a submesh
+ */
+struct MeshletGeometry
+{
+	std::vector<Meshlet> meshlets;
+
+	/// Vertex indices of the meshlets, as found in the index data of the submesh
+	std::vector<uint32_t> vertices;
+
+	/// Triangles of the meshlets, one per element, as three 8 bit indices in the vertices of their meshlet
+	std::vector<uint32_t> triangles;
+};
+
+/**
+ * @brief Splits the triangles of a submesh into meshlets of at most MAX_MESHLET_VERTICES vertices and
+ *        MAX_MESHLET_TRIANGLES triangles, and computes their culling bounds
+ *
+ * Triangles are added to the meshlets in the order of the index data, so the indices should be ordered for vertex
+ * reuse, as glTF exporters usually do.
+ *
+ * @param position_data Vertex positions, as VK_FORMAT_R32G32B32_SFLOAT
+ * @param position_stride Distance between two positions in bytes
+ * @param vertex_count Number of positions
+ * @param index_data Triangle list indices, nullptr if the submesh is not indexed
+ * @param index_type Type of the indices, VK_INDEX_TYPE_UINT16 or VK_INDEX_TYPE_UINT32
+ * @param index_count Number of indices, or of vertices if the submesh is not indexed
+ * @throws std::runtime_error if an index is out of range
+ */
+MeshletGeometry build_meshlets(const uint8_t *position_data,
+                               size_t         position_stride,
+                               uint32_t       vertex_count,
+                               const uint8_t *index_data,
+                               VkIndexType    index_type,
+                               uint32_t       index_count);
+}        // namespace vkb
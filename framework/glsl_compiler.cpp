@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,15 +17,18 @@
 
 #include "glsl_compiler.h"
 
+#ifndef VKB_SHADER_BUNDLE_ONLY
 #include <SPIRV/GLSL.std.450.h>
 #include <SPIRV/GlslangToSpv.h>
 #include <StandAlone/DirStackFileIncluder.h>
 #include <glslang/Include/ShHandle.h>
 #include <glslang/OSDependent/osinclude.h>
 #include <glslang/Public/ResourceLimits.h>
+#endif
 
 namespace vkb
 {
+#ifndef VKB_SHADER_BUNDLE_ONLY
 namespace
 {
 inline EShLanguage FindShaderLanguage(VkShaderStageFlagBits stage)
@@ -79,22 +82,71 @@ inline EShLanguage FindShaderLanguage(VkShaderStageFlagBits stage)
 	}
 }
 }        // namespace
+#endif
 
 glslang::EShTargetLanguage        GLSLCompiler::env_target_language         = glslang::EShTargetLanguage::EShTargetNone;
 glslang::EShTargetLanguageVersion GLSLCompiler::env_target_language_version = static_cast<glslang::EShTargetLanguageVersion>(0);
+std::mutex                        GLSLCompiler::env_mutex;
+
+#ifdef VKB_SHADER_BUNDLE_ONLY
+// Shaders are precompiled into a bundle, so no glslang code is referenced and the linker drops it from the binary
+GLSLCompiler::ProcessScope::ProcessScope()
+{
+}
+
+GLSLCompiler::ProcessScope::~ProcessScope()
+{
+}
+#else
+GLSLCompiler::ProcessScope::ProcessScope()
+{
+	glslang::InitializeProcess();
+}
+
+GLSLCompiler::ProcessScope::~ProcessScope()
+{
+	glslang::FinalizeProcess();
+}
+#endif
+
+GLSLCompiler::GLSLCompiler()
+{
+	std::lock_guard<std::mutex> lock{env_mutex};
+
+	target_language         = env_target_language;
+	target_language_version = env_target_language_version;
+}
 
 void GLSLCompiler::set_target_environment(glslang::EShTargetLanguage target_language, glslang::EShTargetLanguageVersion target_language_version)
 {
+	std::lock_guard<std::mutex> lock{env_mutex};
+
 	GLSLCompiler::env_target_language         = target_language;
 	GLSLCompiler::env_target_language_version = target_language_version;
 }
 
 void GLSLCompiler::reset_target_environment()
 {
+	std::lock_guard<std::mutex> lock{env_mutex};
+
 	GLSLCompiler::env_target_language         = glslang::EShTargetLanguage::EShTargetNone;
 	GLSLCompiler::env_target_language_version = static_cast<glslang::EShTargetLanguageVersion>(0);
 }
 
+glslang::EShTargetLanguage GLSLCompiler::get_target_language()
+{
+	std::lock_guard<std::mutex> lock{env_mutex};
+
+	return GLSLCompiler::env_target_language;
+}
+
+glslang::EShTargetLanguageVersion GLSLCompiler::get_target_language_version()
+{
+	std::lock_guard<std::mutex> lock{env_mutex};
+
+	return GLSLCompiler::env_target_language_version;
+}
+
 bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
                                     const std::vector<uint8_t> &glsl_source,
                                     const std::string          &entry_point,
@@ -102,8 +154,12 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
                                     std::vector<std::uint32_t> &spirv,
                                     std::string                &info_log)
 {
-	// Initialize glslang library.
-	glslang::InitializeProcess();
+#ifdef VKB_SHADER_BUNDLE_ONLY
+	info_log = "GLSL compilation is not available in builds with VKB_SHADER_BUNDLE_ONLY, shaders must be loaded from a shader bundle";
+	return false;
+#else
+	// Initialize glslang library, the process is reference counted so concurrent compilations are safe
+	ProcessScope process_scope;
 
 	EShMessages messages = static_cast<EShMessages>(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules);
 
@@ -119,9 +175,9 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
 	shader.setSourceEntryPoint(entry_point.c_str());
 	shader.setPreamble(shader_variant.get_preamble().c_str());
 	shader.addProcesses(shader_variant.get_processes());
-	if (GLSLCompiler::env_target_language != glslang::EShTargetLanguage::EShTargetNone)
+	if (target_language != glslang::EShTargetLanguage::EShTargetNone)
 	{
-		shader.setEnvTarget(GLSLCompiler::env_target_language, GLSLCompiler::env_target_language_version);
+		shader.setEnvTarget(target_language, target_language_version);
 	}
 
 	DirStackFileIncluder includeDir;
@@ -170,9 +226,7 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
 
 	info_log += logger.getAllMessages() + "\n";
 
-	// Shutdown glslang library.
-	glslang::FinalizeProcess();
-
 	return true;
+#endif
 }
 }        // namespace vkb
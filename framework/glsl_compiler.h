@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -22,6 +22,8 @@
 
 #include "common/error.h"
 
+#include <mutex>
+
 #include <glslang/Public/ShaderLang.h>
 
 #include "common/vk_common.h"
@@ -37,7 +39,40 @@ class GLSLCompiler
 	static glslang::EShTargetLanguage        env_target_language;
 	static glslang::EShTargetLanguageVersion env_target_language_version;
 
+	/// Guards the target environment, which is read by compilations running on other threads
+	static std::mutex env_mutex;
+
+	glslang::EShTargetLanguage        target_language;
+	glslang::EShTargetLanguageVersion target_language_version;
+
   public:
+	/**
+	 * @brief Keeps the glslang process initialized while it is alive
+	 *        glslang builds its built-in symbol tables on the first initialization and releases them on the last
+	 *        finalization, so compilations in the scope of one, e.g. during a parallel warm-up, share the tables.
+	 */
+	class ProcessScope
+	{
+	  public:
+		ProcessScope();
+
+		ProcessScope(const ProcessScope &) = delete;
+
+		ProcessScope(ProcessScope &&) = delete;
+
+		~ProcessScope();
+
+		ProcessScope &operator=(const ProcessScope &) = delete;
+
+		ProcessScope &operator=(ProcessScope &&) = delete;
+	};
+
+	/**
+	 * @brief Creates a compiler using the target environment set when it is created
+	 *        Compilers may be used concurrently on different threads, each with its own compiler.
+	 */
+	GLSLCompiler();
+
 	/**
 	 * @brief Set the glslang target environment to translate to when generating code
 	 * @param target_language The language to translate to
@@ -51,6 +86,16 @@ class GLSLCompiler
 	 */
 	static void reset_target_environment();
 
+	/**
+	 * @brief Get the glslang target language currently used when generating code
+	 */
+	static glslang::EShTargetLanguage get_target_language();
+
+	/**
+	 * @brief Get the glslang target language version currently used when generating code
+	 */
+	static glslang::EShTargetLanguageVersion get_target_language_version();
+
 	/**
 	 * @brief Compiles GLSL to SPIRV code
 	 * @param stage The Vulkan shader stage flag
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -19,29 +19,43 @@
 #define TINYGLTF_IMPLEMENTATION
 #include "gltf_loader.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <future>
 #include <limits>
 #include <queue>
 
 #include "common/error.h"
 
 #include "common/glm_common.h"
+#include <glm/gtc/packing.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "api_vulkan_sample.h"
 #include "common/utils.h"
 #include "common/vk_common.h"
+#include "core/command_pool.h"
 #include "core/device.h"
 #include "core/image.h"
+#include "core/util/hash.hpp"
 #include "core/util/logging.hpp"
+#include "fence_pool.h"
 #include "filesystem/legacy.h"
+#include "rendering/mip_generator.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/image/astc.h"
+#include "scene_graph/components/image/ktx.h"
 #include "scene_graph/components/light.h"
+#include "scene_graph/components/lod_group.h"
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
 #include "scene_graph/components/perspective_camera.h"
 #include "scene_graph/components/sampler.h"
+#include "scene_graph/components/skin.h"
 #include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
 #include "scene_graph/components/transform.h"
@@ -49,7 +63,7 @@
 #include "scene_graph/scene.h"
 #include "scene_graph/scripts/animation.h"
 
-#include <ctpl_stl.h>
+#include <core/util/job_system.hpp>
 
 namespace vkb
 {
@@ -283,7 +297,233 @@ inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uin
 	return result;
 }
 
-inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &staging_buffer, sg::Image &image)
+/**
+ * @brief Converts vectors of 32-bit floats to vectors of 16-bit components, see GLTFLoader::set_vertex_quantization()
+ * @param src_data The vectors, one every src_stride bytes
+ * @param component_count The number of floats in a vector, the missing ones up to four are zero
+ * @param dst_component_count The number of components in a converted vector
+ * @param encode Writes the components of a converted vector from the four floats of a vector
+ */
+template <typename Encode>
+inline std::vector<uint8_t> encode_vertex_data(const std::vector<uint8_t> &src_data, size_t count, size_t src_stride,
+                                               uint32_t component_count, uint32_t dst_component_count, Encode encode)
+{
+	std::vector<uint8_t> result(count * dst_component_count * sizeof(uint16_t));
+
+	auto *dst = reinterpret_cast<uint16_t *>(result.data());
+
+	glm::vec4 src{0.0f};
+
+	for (size_t i = 0; i < count; ++i, dst += dst_component_count)
+	{
+		std::memcpy(glm::value_ptr(src), src_data.data() + i * src_stride, component_count * sizeof(float));
+		encode(src, dst);
+	}
+
+	return result;
+}
+
+/**
+ * @brief Maps a unit vector to the octahedron folded onto the [-1, 1] square, see decode_octahedral() in vertex_compression.h
+ */
+inline glm::vec2 encode_octahedral(const glm::vec3 &v)
+{
+	float length = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+	if (length == 0.0f)
+	{
+		return glm::vec2{0.0f};
+	}
+
+	glm::vec3 n = v / length;
+	if (n.z >= 0.0f)
+	{
+		return glm::vec2{n};
+	}
+
+	return glm::vec2{(1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+	                 (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)};
+}
+
+/// Screen size of the full detail of the levels of detail without a screen coverage, see GLTFLoader::parse_lod_group()
+constexpr float DEFAULT_LOD_SCREEN_SIZE = 0.25f;
+
+/// Words of a vertex packed for vertex pulling, see GLTFLoader::set_vertex_pulling()
+constexpr size_t PULLED_VERTEX_WORDS = 5;
+
+/// Primitives read per thread in each batch of GLTFLoader::load_scene(), bounding the data read ahead of its buffers
+constexpr size_t PRIMITIVE_BATCH_SIZE_PER_THREAD = 8;
+
+/**
+ * @brief Appends the vertices of a submesh to the data read by vertex pulling, see GLTFLoader::set_vertex_pulling()
+ *        The layout must match the one read by base.vert with VERTEX_PULLING.
+ * @param attribute_data Data of each attribute of the submesh
+ * @param pulled_vertices Packed vertices of the previous submeshes, PULLED_VERTEX_WORDS per vertex
+ * @return Whether the vertices were appended, false if the position, normal or texture coordinates are not floats
+ */
+inline bool append_pulled_vertices(const sg::SubMesh &sub_mesh, const std::map<std::string, std::vector<uint8_t>> &attribute_data,
+                                   std::vector<uint32_t> &pulled_vertices)
+{
+	sg::VertexAttribute position;
+	sg::VertexAttribute normal;
+	sg::VertexAttribute texcoord;
+
+	bool has_normal   = sub_mesh.get_attribute(sg::VertexAttributeSlot::Normal, normal);
+	bool has_texcoord = sub_mesh.get_attribute(sg::VertexAttributeSlot::Texcoord0, texcoord);
+
+	if (!sub_mesh.get_attribute(sg::VertexAttributeSlot::Position, position) || position.format != VK_FORMAT_R32G32B32_SFLOAT ||
+	    (has_normal && normal.format != VK_FORMAT_R32G32B32_SFLOAT) || (has_texcoord && texcoord.format != VK_FORMAT_R32G32_SFLOAT))
+	{
+		return false;
+	}
+
+	const uint8_t *position_data = attribute_data.at("position").data() + position.offset;
+	const uint8_t *normal_data   = has_normal ? attribute_data.at("normal").data() + normal.offset : nullptr;
+	const uint8_t *texcoord_data = has_texcoord ? attribute_data.at("texcoord_0").data() + texcoord.offset : nullptr;
+
+	size_t first_word = pulled_vertices.size();
+	pulled_vertices.resize(first_word + size_t{sub_mesh.vertices_count} * PULLED_VERTEX_WORDS);
+
+	uint32_t *dst = pulled_vertices.data() + first_word;
+
+	for (uint32_t i = 0; i < sub_mesh.vertices_count; ++i, dst += PULLED_VERTEX_WORDS)
+	{
+		std::memcpy(dst, position_data + i * position.stride, 3 * sizeof(float));
+
+		glm::vec2 uv{0.0f};
+		if (texcoord_data)
+		{
+			std::memcpy(glm::value_ptr(uv), texcoord_data + i * texcoord.stride, sizeof(uv));
+		}
+		dst[3] = glm::packHalf2x16(uv);
+
+		glm::vec3 n{0.0f, 0.0f, 1.0f};
+		if (normal_data)
+		{
+			std::memcpy(glm::value_ptr(n), normal_data + i * normal.stride, sizeof(n));
+		}
+		dst[4] = glm::packSnorm2x16(encode_octahedral(n));
+	}
+
+	return true;
+}
+
+/**
+ * @brief Creates a static buffer holding data, written in place if it is host visible as with unified memory, or with
+ *        a staging copy recorded to the command buffer otherwise, see allocated::apply_upload_policy()
+ * @param transient_buffers Appended the staging buffer, which must live until the copy completed
+ */
+template <typename T>
+inline core::Buffer create_static_buffer(Device &device, CommandBuffer &command_buffer, const std::vector<T> &data, VkBufferUsageFlags usage,
+                                         std::vector<core::Buffer> &transient_buffers)
+{
+	VkDeviceSize size = data.size() * sizeof(T);
+
+	core::Buffer buffer{device, core::BufferBuilder{size}
+	                                .with_usage(usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+	                                .with_upload_frequency(allocated::UploadFrequency::Static)};
+
+	if (buffer.mapped())
+	{
+		buffer.update(data);
+		return buffer;
+	}
+
+	core::Buffer stage_buffer = core::Buffer::create_staging_buffer(device, data);
+
+	command_buffer.copy_buffer(stage_buffer, buffer, size);
+
+	transient_buffers.push_back(std::move(stage_buffer));
+
+	return buffer;
+}
+
+/**
+ * @brief Creates a staging buffer holding the texel data of an image
+ *        A payload still pending in the image file is decoded or copied straight into the mapped buffer.
+ */
+inline core::BufferPtr create_image_staging_buffer(Device &device, sg::Image &image)
+{
+	auto staging_buffer = std::make_unique<core::Buffer>(core::Buffer::create_staging_buffer(device, image.get_payload_size(), nullptr));
+
+	image.write_payload(staging_buffer->map());
+	staging_buffer->flush();
+
+	return staging_buffer;
+}
+
+/**
+ * @brief Queues the reads of the image files of a model on the I/O threads of the filesystem, so that they overlap with decoding
+ * @return Per glTF image, the pending read of its file, invalid for images embedded in the glTF file
+ */
+inline std::vector<std::future<std::vector<uint8_t>>> read_image_files_async(const tinygltf::Model &model, const std::string &model_path)
+{
+	auto file_system = filesystem::get();
+
+	std::vector<std::future<std::vector<uint8_t>>> file_reads(model.images.size());
+	for (size_t image_index = 0; image_index < model.images.size(); image_index++)
+	{
+		auto &gltf_image = model.images[image_index];
+
+		if (gltf_image.image.empty() && !gltf_image.uri.empty())
+		{
+			file_reads[image_index] = file_system->read_file_binary_async(fs::path::get(fs::path::Type::Assets) + model_path + "/" + gltf_image.uri);
+		}
+	}
+
+	return file_reads;
+}
+
+/**
+ * @brief Hashes the encoded content of an image, so that images of the same content share their Vulkan image, see TextureRegistry
+ * @param file The contents of the image file, unless the image is embedded in the glTF file
+ */
+inline Hash128 hash_image_content(const tinygltf::Image &gltf_image, const filesystem::MappedFile *file)
+{
+	Hash128 content_hash;
+
+	if (!gltf_image.image.empty())
+	{
+		// Embedded images are already decoded by tinygltf
+		hash_combine(content_hash, gltf_image.width);
+		hash_combine(content_hash, gltf_image.height);
+		hash_combine(content_hash, gltf_image.image);
+	}
+	else if (file)
+	{
+		content_hash = hash_bytes_128(file->data(), file->size());
+	}
+
+	return content_hash;
+}
+
+/**
+ * @brief Waits for the read of an image file
+ * @return The contents of the file, or null if it was not read, in which case the image maps its file itself
+ */
+inline filesystem::MappedFilePtr take_image_file(std::future<std::vector<uint8_t>> &file_read)
+{
+	if (!file_read.valid())
+	{
+		return nullptr;
+	}
+
+	try
+	{
+		return filesystem::make_mapped_file(file_read.get());
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read image file ahead of decoding: {}", e.what());
+		return nullptr;
+	}
+}
+
+/**
+ * @brief Records the upload of an image, leaving it ready for sampling by fragment shaders
+ *        If the queue families differ, the image ownership is released to dst_queue_family, which must acquire it, see acquire_image().
+ */
+inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &staging_buffer, sg::Image &image,
+                                uint32_t src_queue_family = VK_QUEUE_FAMILY_IGNORED, uint32_t dst_queue_family = VK_QUEUE_FAMILY_IGNORED)
 {
 	// Clean up the image data, as they are copied in the staging buffer
 	image.clear_data();
@@ -328,10 +568,37 @@ inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &sta
 		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
 		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 
+		if (src_queue_family != dst_queue_family)
+		{
+			// Release half of the ownership transfer, the shader read happens after the acquire on the other family
+			memory_barrier.dst_access_mask  = 0;
+			memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			memory_barrier.old_queue_family = src_queue_family;
+			memory_barrier.new_queue_family = dst_queue_family;
+		}
+
 		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
 	}
 }
 
+/**
+ * @brief Records the acquire half of the ownership transfer of an image released by upload_image_to_gpu()
+ */
+inline void acquire_image(CommandBuffer &command_buffer, sg::Image &image, uint32_t src_queue_family, uint32_t dst_queue_family)
+{
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	memory_barrier.new_layout       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	memory_barrier.src_access_mask  = 0;
+	memory_barrier.dst_access_mask  = VK_ACCESS_SHADER_READ_BIT;
+	memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	memory_barrier.old_queue_family = src_queue_family;
+	memory_barrier.new_queue_family = dst_queue_family;
+
+	command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+}
+
 inline void prepare_meshlets(std::vector<Meshlet> &meshlets, std::unique_ptr<vkb::sg::SubMesh> &submesh, std::vector<unsigned char> &index_data)
 {
 	Meshlet meshlet;
@@ -396,697 +663,1969 @@ static inline bool texture_needs_srgb_colorspace(const std::string &name)
 	return false;
 }
 
-}        // namespace
-
-std::unordered_map<std::string, bool> GLTFLoader::supported_extensions = {
-    {KHR_LIGHTS_PUNCTUAL_EXTENSION, false}};
-
-GLTFLoader::GLTFLoader(Device &device) :
-    device{device}
-{
-}
-
-std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &file_name, int scene_index)
+/**
+ * @brief Packs the vertex and index data of submeshes into a few buffers shared by all of them
+ *
+ * Submeshes with the same vertex layout, i.e. attribute names, formats and strides, append their attributes to the same
+ * streams, one per attribute, and are told apart by their vertex offset. Their indices are appended to a stream per index type,
+ * and told apart by their first index. Submeshes in the same streams are thus drawn with the same buffer bindings.
+ * Streams are split so that none is larger than the buffer size, then laid out in as few buffers as needed.
+ */
+class GeometryPacker
 {
-	std::string err;
-	std::string warn;
-
-	tinygltf::TinyGLTF gltf_loader;
-
-	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
-
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
-
-	if (!importResult)
-	{
-		LOGE("Failed to load gltf file {}.", gltf_file.c_str());
-
-		return nullptr;
-	}
-
-	if (!err.empty())
+  public:
+	explicit GeometryPacker(size_t buffer_size) :
+	    buffer_size{buffer_size}
+	{}
+
+	/**
+	 * @brief Appends the data of a submesh, which must already have its attributes, counts and index type set
+	 * @param attribute_data Data of each attribute, vertices_count elements of the attribute stride
+	 * @param index_data Indices of the index type of the submesh, empty if it is not indexed
+	 */
+	void add(sg::SubMesh &sub_mesh, const std::map<std::string, std::vector<uint8_t>> &attribute_data, const std::vector<uint8_t> &index_data)
 	{
-		LOGE("Error loading gltf model: {}.", err.c_str());
+		PackedSubMesh packed{&sub_mesh};
 
-		return nullptr;
-	}
+		if (!attribute_data.empty())
+		{
+			// The map orders the attributes by name, so that the key is the same for every submesh of a layout
+			std::string layout_key;
+			uint32_t    max_stride = 1;
+			for (auto &attribute : attribute_data)
+			{
+				sg::VertexAttribute layout;
+				sub_mesh.get_attribute(attribute.first, layout);
+				layout_key += fmt::format("{}:{}:{};", attribute.first, static_cast<uint32_t>(layout.format), layout.stride);
+				max_stride = std::max(max_stride, layout.stride);
+			}
 
-	if (!warn.empty())
-	{
-		LOGI("{}", warn.c_str());
-	}
+			auto layout_it = open_layouts.find(layout_key);
 
-	size_t pos = file_name.find_last_of('/');
+			if (layout_it == open_layouts.end() ||
+			    (layouts[layout_it->second].vertex_count != 0 &&
+			     (layouts[layout_it->second].vertex_count + size_t{sub_mesh.vertices_count}) * max_stride > buffer_size))
+			{
+				VertexLayout layout;
+				for (size_t i = 0; i < attribute_data.size(); ++i)
+				{
+					layout.streams.push_back(streams.size());
+					streams.emplace_back();
+				}
 
-	model_path = file_name.substr(0, pos);
+				layouts.push_back(std::move(layout));
+				layout_it = open_layouts.insert_or_assign(layout_key, layouts.size() - 1).first;
+			}
 
-	if (pos == std::string::npos)
-	{
-		model_path.clear();
-	}
+			auto &layout = layouts[layout_it->second];
 
-	return std::make_unique<sg::Scene>(load_scene(scene_index));
-}
+			sub_mesh.vertex_offset = static_cast<int32_t>(layout.vertex_count);
+			layout.vertex_count += sub_mesh.vertices_count;
 
-std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string &file_name, uint32_t index, bool storage_buffer)
-{
-	std::string err;
-	std::string warn;
+			auto stream_index_it = layout.streams.begin();
+			for (auto &attribute : attribute_data)
+			{
+				size_t stream_index = *stream_index_it++;
+				auto  &stream       = streams[stream_index];
+				stream.data.insert(stream.data.end(), attribute.second.begin(), attribute.second.end());
 
-	tinygltf::TinyGLTF gltf_loader;
+				packed.vertex_streams.emplace_back(attribute.first, stream_index);
+			}
+		}
 
-	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
+		if (!index_data.empty())
+		{
+			auto stream_it = open_index_streams.find(sub_mesh.index_type);
 
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+			if (stream_it == open_index_streams.end() ||
+			    (!streams[stream_it->second].data.empty() && streams[stream_it->second].data.size() + index_data.size() > buffer_size))
+			{
+				streams.emplace_back();
+				stream_it = open_index_streams.insert_or_assign(sub_mesh.index_type, streams.size() - 1).first;
+			}
 
-	if (!importResult)
-	{
-		LOGE("Failed to load gltf file {}.", gltf_file.c_str());
+			auto  &stream     = streams[stream_it->second];
+			size_t index_size = sub_mesh.index_type == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
 
-		return nullptr;
-	}
+			sub_mesh.first_index = to_u32(stream.data.size() / index_size);
+			stream.data.insert(stream.data.end(), index_data.begin(), index_data.end());
 
-	if (!err.empty())
-	{
-		LOGE("Error loading gltf model: {}.", err.c_str());
+			packed.index_stream = stream_it->second;
+		}
 
-		return nullptr;
+		sub_meshes.push_back(std::move(packed));
 	}
 
-	if (!warn.empty())
+	/**
+	 * @brief Uploads the streams to host visible buffers, and points the submeshes to their ranges
+	 * @param usage Usage of the buffers, besides vertex and index buffer
+	 */
+	void pack(Device &device, VkBufferUsageFlags usage)
 	{
-		LOGI("{}", warn.c_str());
-	}
+		// Any offset aligned to 16 bytes is valid for vertex and index bindings
+		const VkDeviceSize alignment = 16;
 
-	size_t pos = file_name.find_last_of('/');
+		std::vector<VkDeviceSize> buffer_sizes;
 
-	model_path = file_name.substr(0, pos);
+		for (auto &stream : streams)
+		{
+			VkDeviceSize offset = buffer_sizes.empty() ? 0 : (buffer_sizes.back() + alignment - 1) / alignment * alignment;
 
-	if (pos == std::string::npos)
-	{
-		model_path.clear();
-	}
+			if (buffer_sizes.empty() || (buffer_sizes.back() != 0 && offset + stream.data.size() > buffer_size))
+			{
+				buffer_sizes.push_back(0);
+				offset = 0;
+			}
 
-	return std::move(load_model(index, storage_buffer));
-}
+			stream.buffer_index = buffer_sizes.size() - 1;
+			stream.offset       = offset;
+			buffer_sizes.back() = offset + stream.data.size();
+		}
 
-sg::Scene GLTFLoader::load_scene(int scene_index)
-{
-	auto scene = sg::Scene();
+		std::vector<std::shared_ptr<core::Buffer>> buffers;
 
-	scene.set_name("gltf_scene");
+		for (size_t i = 0; i < buffer_sizes.size(); ++i)
+		{
+			buffers.push_back(std::make_shared<core::Buffer>(device,
+			                                                 std::max<VkDeviceSize>(buffer_sizes[i], alignment),
+			                                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | usage,
+			                                                 VMA_MEMORY_USAGE_CPU_TO_GPU));
+			buffers.back()->set_debug_name(fmt::format("packed geometry buffer #{}", i));
+		}
 
-	// Check extensions
-	for (auto &used_extension : model.extensionsUsed)
-	{
-		auto it = supported_extensions.find(used_extension);
+		for (auto &stream : streams)
+		{
+			buffers[stream.buffer_index]->update(stream.data, stream.offset);
+			stream.data = {};
+		}
 
-		// Check if extension isn't supported by the GLTFLoader
-		if (it == supported_extensions.end())
+		for (auto &packed : sub_meshes)
 		{
-			// If extension is required then we shouldn't allow the scene to be loaded
-			if (std::find(model.extensionsRequired.begin(), model.extensionsRequired.end(), used_extension) != model.extensionsRequired.end())
+			for (auto &vertex_stream : packed.vertex_streams)
 			{
-				throw std::runtime_error("Cannot load glTF file. Contains a required unsupported extension: " + used_extension);
+				auto &stream = streams[vertex_stream.second];
+				packed.sub_mesh->shared_vertex_buffers[vertex_stream.first] = {buffers[stream.buffer_index], stream.offset};
 			}
-			else
+
+			if (packed.index_stream < streams.size())
 			{
-				// Otherwise, if extension isn't required (but is in the file) then print a warning to the user
-				LOGW("glTF file contains an unsupported extension, unexpected results may occur: {}", used_extension);
+				auto &stream                       = streams[packed.index_stream];
+				packed.sub_mesh->shared_index_buffer = buffers[stream.buffer_index];
+				packed.sub_mesh->index_offset        = to_u32(stream.offset);
 			}
 		}
-		else
-		{
-			// Extension is supported, so enable it
-			LOGI("glTF file contains extension: {}", used_extension);
-			it->second = true;
-		}
+
+		LOGI("Packed the geometry of {} submeshes in {} buffers", sub_meshes.size(), buffers.size());
 	}
 
-	// Load lights
-	std::vector<std::unique_ptr<sg::Light>> light_components = parse_khr_lights_punctual();
+  private:
+	struct Stream
+	{
+		std::vector<uint8_t> data;
 
-	scene.set_components(std::move(light_components));
+		size_t buffer_index{0};
 
-	// Load samplers
-	std::vector<std::unique_ptr<sg::Sampler>>
-	    sampler_components(model.samplers.size());
+		VkDeviceSize offset{0};
+	};
 
-	for (size_t sampler_index = 0; sampler_index < model.samplers.size(); sampler_index++)
+	/// Streams of a vertex layout, which grow together
+	struct VertexLayout
 	{
-		auto sampler                      = parse_sampler(model.samplers[sampler_index]);
-		sampler_components[sampler_index] = std::move(sampler);
-	}
+		std::vector<size_t> streams;
 
-	scene.set_components(std::move(sampler_components));
+		uint32_t vertex_count{0};
+	};
 
-	Timer timer;
-	timer.start();
+	struct PackedSubMesh
+	{
+		sg::SubMesh *sub_mesh;
 
-	// Load images
-	auto thread_count = std::thread::hardware_concurrency();
-	thread_count      = thread_count == 0 ? 1 : thread_count;
-	ctpl::thread_pool thread_pool(thread_count);
+		/// Stream of each attribute
+		std::vector<std::pair<std::string, size_t>> vertex_streams;
 
-	auto image_count = to_u32(model.images.size());
+		size_t index_stream{std::numeric_limits<size_t>::max()};
+	};
 
-	std::vector<std::future<std::unique_ptr<sg::Image>>> image_component_futures;
-	for (size_t image_index = 0; image_index < image_count; image_index++)
-	{
-		auto fut = thread_pool.push(
-		    [this, image_index](size_t) {
-			    auto image = parse_image(model.images[image_index]);
+	size_t buffer_size;
 
-			    LOGI("Loaded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
+	std::vector<Stream> streams;
 
-			    return image;
-		    });
+	std::vector<VertexLayout> layouts;
 
-		image_component_futures.push_back(std::move(fut));
-	}
+	/// Layouts and index streams still appended to, by key
+	std::unordered_map<std::string, size_t> open_layouts;
 
-	std::vector<std::unique_ptr<sg::Image>> image_components;
+	std::unordered_map<VkIndexType, size_t> open_index_streams;
 
-	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
-	// double the amount of memory (all the images and all the corresponding buffers).
-	// This helps keep memory footprint lower which is helpful on smaller devices.
-	size_t image_index = 0;
-	while (image_index < image_count)
+	std::vector<PackedSubMesh> sub_meshes;
+};
+}        // namespace
+
+std::unordered_map<std::string, bool> GLTFLoader::supported_extensions = {
+    {KHR_LIGHTS_PUNCTUAL_EXTENSION, false},
+    {MSFT_LOD_EXTENSION, false}};
+
+/// Images of a scene read by read_scene_from_file_async(), from decoding to residency
+struct GLTFLoader::ImageStream
+{
+	enum class State
 	{
-		std::vector<core::Buffer> transient_buffers;
+		Decoding,
+		Uploading,
+		Resident,
+		Failed
+	};
 
-		auto &command_buffer = device.request_command_buffer();
+	sg::Scene *scene{nullptr};
 
-		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+	/// Per glTF image, the decoded image until it is resident and moved to the scene
+	std::vector<std::unique_ptr<sg::Image>> images;
 
-		size_t batch_size = 0;
+	/// Per glTF image, the read of its file, taken by its decode job
+	std::vector<std::future<std::vector<uint8_t>>> file_reads;
 
-		// Deal with 64MB of image data at a time to keep memory footprint low
-		while (image_index < image_count && batch_size < 64 * 1024 * 1024)
-		{
-			// Wait for this image to complete loading, then stage for upload
-			image_components.push_back(image_component_futures[image_index].get());
+	std::vector<JobHandle> decode_jobs;
 
-			auto &image = image_components[image_index];
+	std::vector<State> states;
 
-			core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(device, image->get_data());
+	std::vector<bool> needs_srgb;
 
-			batch_size += image->get_data().size();
+	/// Per glTF image, the textures to switch from the placeholder once it is resident
+	std::vector<std::vector<sg::Texture *>> textures;
 
-			upload_image_to_gpu(command_buffer, stage_buffer, *image);
+	uint32_t transfer_queue_family{0};
 
-			transient_buffers.push_back(std::move(stage_buffer));
+	uint32_t graphics_queue_family{0};
 
-			image_index++;
-		}
+	std::unique_ptr<CommandPool> transfer_command_pool;
 
-		command_buffer.end();
+	/// Only used when the transfer queue family differs from the graphics one
+	std::unique_ptr<CommandPool> graphics_command_pool;
+
+	/// Private to the stream, as the fences of the device are waited on and reset by blocking loads
+	std::unique_ptr<FencePool> fence_pool;
+
+	/// Per glTF image, the staging buffer its texels are written to by its decode job, until it is resident
+	std::vector<core::BufferPtr> staging_buffers;
+
+	/// Images of the batch in flight
+	std::vector<size_t> batch;
 
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+	/// Whether the batch in flight is being acquired by the graphics queue family
+	bool acquiring{false};
+};
 
-		queue.submit(command_buffer, device.request_fence());
+GLTFLoader::GLTFLoader(Device &device) :
+    device{device}
+{
+	sg::Ktx::select_transcode_format(device.get_gpu());
+}
 
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset_pool();
-		device.wait_idle();
+GLTFLoader::~GLTFLoader()
+{
+	if (image_stream)
+	{
+		// The decode jobs reference the model, and the batch in flight the staging buffers and command buffers
+		try
+		{
+			JobSystem::get().wait(image_stream->decode_jobs);
+		}
+		catch (...)
+		{
+		}
 
-		// Remove the staging buffers for the batch we just processed
-		transient_buffers.clear();
+		image_stream->fence_pool->wait();
 	}
+}
 
-	scene.set_components(std::move(image_components));
+void GLTFLoader::set_pack_geometry(bool pack, size_t max_buffer_size)
+{
+	pack_geometry      = pack;
+	packed_buffer_size = max_buffer_size;
+}
 
-	auto elapsed_time = timer.stop();
+void GLTFLoader::set_vertex_pulling(bool enable)
+{
+	vertex_pulling = enable;
+}
 
-	LOGI("Time spent loading images: {} seconds across {} threads.", vkb::to_string(elapsed_time), thread_count);
+void GLTFLoader::set_ray_tracing_geometry(bool enable)
+{
+	const VkBufferUsageFlags usage = VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
 
-	// Load textures
-	auto images                  = scene.get_components<sg::Image>();
-	auto samplers                = scene.get_components<sg::Sampler>();
-	auto default_sampler_linear  = create_default_sampler(TINYGLTF_TEXTURE_FILTER_LINEAR);
-	auto default_sampler_nearest = create_default_sampler(TINYGLTF_TEXTURE_FILTER_NEAREST);
-	bool used_nearest_sampler    = false;
+	geometry_buffer_usage = enable ? geometry_buffer_usage | usage : geometry_buffer_usage & ~usage;
+}
 
-	for (auto &gltf_texture : model.textures)
+void GLTFLoader::set_meshlet_geometry(bool enable)
+{
+	meshlet_geometry = enable;
+
+	geometry_buffer_usage = enable ? geometry_buffer_usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT : geometry_buffer_usage & ~VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+}
+
+MipGenerator &GLTFLoader::get_mip_generator()
+{
+	if (!mip_generator)
 	{
-		auto texture = parse_texture(gltf_texture);
+		mip_generator = std::make_unique<MipGenerator>(device);
+	}
 
-		assert(gltf_texture.source < images.size());
-		texture->set_image(*images[gltf_texture.source]);
+	return *mip_generator;
+}
 
-		if (gltf_texture.sampler >= 0 && gltf_texture.sampler < static_cast<int>(samplers.size()))
+void GLTFLoader::set_streamed_textures(bool enable)
+{
+	streamed_textures = enable;
+}
+
+void GLTFLoader::set_texture_arrays(bool enable, uint32_t max_extent)
+{
+	texture_arrays           = enable;
+	max_texture_array_extent = max_extent;
+}
+
+void GLTFLoader::set_mesh_optimization(bool enable, uint32_t lod_count)
+{
+	mesh_optimization = enable;
+	mesh_lod_count    = lod_count;
+}
+
+void GLTFLoader::optimize_submesh(sg::SubMesh &submesh, std::map<std::string, std::vector<uint8_t>> &attribute_data, std::vector<uint8_t> &index_data,
+                                  std::vector<uint8_t> &position_data, size_t &position_stride) const
+{
+	size_t index_size = submesh.index_type == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+
+	std::vector<uint32_t> indices(submesh.vertex_indices);
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		if (index_size == sizeof(uint32_t))
 		{
-			texture->set_sampler(*samplers[gltf_texture.sampler]);
+			std::memcpy(&indices[i], index_data.data() + i * index_size, index_size);
 		}
 		else
 		{
-			if (gltf_texture.name.empty())
-			{
-				gltf_texture.name = images[gltf_texture.source]->get_name();
-			}
-
-			// Get the properties for the image format. We'll need to check whether a linear sampler is valid.
-			const VkFormatProperties fmtProps = device.get_gpu().get_format_properties(images[gltf_texture.source]->get_format());
-
-			if (fmtProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
-			{
-				texture->set_sampler(*default_sampler_linear);
-			}
-			else
-			{
-				texture->set_sampler(*default_sampler_nearest);
-				used_nearest_sampler = true;
-			}
+			uint16_t index;
+			std::memcpy(&index, index_data.data() + i * index_size, index_size);
+			indices[i] = index;
 		}
 
-		scene.add_component(std::move(texture));
+		if (indices[i] >= submesh.vertices_count)
+		{
+			LOGW("{} has an index out of range, it is not optimized", submesh.get_name());
+			return;
+		}
 	}
 
-	scene.add_component(std::move(default_sampler_linear));
-	if (used_nearest_sampler)
+	std::vector<glm::vec3> positions(submesh.vertices_count);
+	for (size_t i = 0; i < positions.size(); ++i)
 	{
-		scene.add_component(std::move(default_sampler_nearest));
+		std::memcpy(glm::value_ptr(positions[i]), position_data.data() + i * position_stride, sizeof(glm::vec3));
 	}
 
-	// Load materials
-	bool                            has_textures = scene.has_component<sg::Texture>();
-	std::vector<vkb::sg::Texture *> textures;
-	if (has_textures)
+	auto remap = optimize_mesh(indices, positions, mesh_lod_count, submesh.lods);
+
+	for (auto &attribute : attribute_data)
 	{
-		textures = scene.get_components<sg::Texture>();
+		sg::VertexAttribute layout;
+		submesh.get_attribute(attribute.first, layout);
+		remap_vertex_data(attribute.second, layout.stride, remap);
 	}
 
-	for (auto &gltf_material : model.materials)
-	{
-		auto material = parse_material(gltf_material);
+	position_data.resize(positions.size() * sizeof(glm::vec3));
+	std::memcpy(position_data.data(), positions.data(), position_data.size());
+	position_stride = sizeof(glm::vec3);
 
-		for (auto &gltf_value : gltf_material.values)
+	// The indices of the levels of detail follow the ones of the full detail, which keeps vertex_indices
+	index_data.resize(indices.size() * index_size);
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		if (index_size == sizeof(uint32_t))
 		{
-			if (gltf_value.first.find("Texture") != std::string::npos)
-			{
-				std::string tex_name = to_snake_case(gltf_value.first);
-
-				assert(gltf_value.second.TextureIndex() < textures.size());
-				vkb::sg::Texture *tex = textures[gltf_value.second.TextureIndex()];
-
-				if (texture_needs_srgb_colorspace(gltf_value.first))
-				{
-					tex->get_image()->coerce_format_to_srgb();
-				}
-
-				material->textures[tex_name] = tex;
-			}
+			std::memcpy(index_data.data() + i * index_size, &indices[i], index_size);
 		}
-
-		for (auto &gltf_value : gltf_material.additionalValues)
+		else
 		{
-			if (gltf_value.first.find("Texture") != std::string::npos)
-			{
-				std::string tex_name = to_snake_case(gltf_value.first);
+			auto index = static_cast<uint16_t>(indices[i]);
+			std::memcpy(index_data.data() + i * index_size, &index, index_size);
+		}
+	}
+}
 
-				assert(gltf_value.second.TextureIndex() < textures.size());
-				vkb::sg::Texture *tex = textures[gltf_value.second.TextureIndex()];
+void GLTFLoader::set_vertex_quantization(VertexQuantization quantization)
+{
+	vertex_quantization = quantization;
+}
 
-				if (texture_needs_srgb_colorspace(gltf_value.first))
-				{
-					tex->get_image()->coerce_format_to_srgb();
-				}
+void GLTFLoader::quantize_vertex_attribute(const std::string &name, size_t count, std::vector<uint8_t> &data, sg::VertexAttribute &attribute, const sg::Mesh &mesh) const
+{
+	bool compressed = vertex_quantization == VertexQuantization::Compressed;
 
-				material->textures[tex_name] = tex;
-			}
-		}
+	uint32_t component_count;
+	VkFormat quantized_format;
 
-		scene.add_component(std::move(material));
-	}
+	std::function<void(const glm::vec4 &, uint16_t *)> encode;
 
-	auto default_material = create_default_material();
+	if (name == "position" && attribute.format == VK_FORMAT_R32G32B32_SFLOAT && compressed && !geometry_buffer_usage)
+	{
+		// Three component 16-bit formats are rarely supported for vertex buffers, positions are padded to four
+		component_count  = 3;
+		quantized_format = VK_FORMAT_R16G16B16A16_UNORM;
 
-	// Load meshes
-	auto materials = scene.get_components<sg::PBRMaterial>();
+		glm::vec3 offset = mesh.get_position_offset();
+		glm::vec3 scale  = mesh.get_position_scale();
 
-	for (auto &gltf_mesh : model.meshes)
+		encode = [offset, scale](const glm::vec4 &v, uint16_t *dst) {
+			glm::vec3 normalized = (glm::vec3{v} - offset) / scale;
+			for (int c = 0; c < 3; ++c)
+			{
+				dst[c] = glm::packUnorm1x16(normalized[c]);
+			}
+			dst[3] = 0;
+		};
+	}
+	else if ((name == "normal" && attribute.format == VK_FORMAT_R32G32B32_SFLOAT) ||
+	         (name == "tangent" && attribute.format == VK_FORMAT_R32G32B32A32_SFLOAT))
 	{
-		auto mesh = parse_mesh(gltf_mesh);
+		component_count = attribute.format == VK_FORMAT_R32G32B32_SFLOAT ? 3 : 4;
 
-		for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size(); i_primitive++)
+		if (compressed && name == "normal")
 		{
-			const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
-
-			auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, i_primitive);
-			auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
-
-			for (auto &attribute : gltf_primitive.attributes)
-			{
-				std::string attrib_name = attribute.first;
-				std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+			quantized_format = VK_FORMAT_R16G16_SNORM;
 
-				auto vertex_data = get_attribute_data(&model, attribute.second);
+			encode = [](const glm::vec4 &v, uint16_t *dst) {
+				glm::vec2 octahedral = encode_octahedral(glm::vec3{v});
+				dst[0]               = glm::packSnorm1x16(octahedral.x);
+				dst[1]               = glm::packSnorm1x16(octahedral.y);
+			};
+		}
+		else if (compressed)
+		{
+			quantized_format = VK_FORMAT_R16G16_SNORM;
+
+			// The handedness is the sign of the second component, which holds the octahedral y remapped to [1/32767, 1]
+			encode = [](const glm::vec4 &v, uint16_t *dst) {
+				glm::vec2 octahedral = encode_octahedral(glm::vec3{v});
+				float     y          = std::max(octahedral.y * 0.5f + 0.5f, 1.0f / 32767.0f);
+				dst[0]               = glm::packSnorm1x16(octahedral.x);
+				dst[1]               = glm::packSnorm1x16(v.w < 0.0f ? -y : y);
+			};
+		}
+		else
+		{
+			// Three component 16-bit formats are rarely supported for vertex buffers, normals are padded to four
+			quantized_format = VK_FORMAT_R16G16B16A16_SNORM;
 
-				if (attrib_name == "position")
+			encode = [](const glm::vec4 &v, uint16_t *dst) {
+				for (int c = 0; c < 4; ++c)
 				{
-					assert(attribute.second < model.accessors.size());
-					submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
+					dst[c] = glm::packSnorm1x16(v[c]);
 				}
+			};
+		}
+	}
+	else if (name.compare(0, 9, "texcoord_") == 0 && attribute.format == VK_FORMAT_R32G32_SFLOAT)
+	{
+		component_count  = 2;
+		quantized_format = VK_FORMAT_R16G16_SFLOAT;
 
-				core::Buffer buffer{device,
-				                    vertex_data.size(),
-				                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-				                    VMA_MEMORY_USAGE_CPU_TO_GPU};
-				buffer.update(vertex_data);
-				buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
-				                                  gltf_mesh.name, i_primitive, attrib_name));
-
-				submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
-
-				sg::VertexAttribute attrib;
-				attrib.format = get_attribute_format(&model, attribute.second);
-				attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
+		encode = [](const glm::vec4 &v, uint16_t *dst) {
+			dst[0] = glm::packHalf1x16(v.x);
+			dst[1] = glm::packHalf1x16(v.y);
+		};
+	}
+	else
+	{
+		return;
+	}
 
-				submesh->set_attribute(attrib_name, attrib);
-			}
+	if (!(device.get_gpu().get_format_properties(quantized_format).bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT))
+	{
+		return;
+	}
 
-			if (gltf_primitive.indices >= 0)
-			{
-				submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
+	uint32_t quantized_component_count = quantized_format == VK_FORMAT_R16G16B16A16_SNORM || quantized_format == VK_FORMAT_R16G16B16A16_UNORM ? 4 : 2;
 
-				auto format = get_attribute_format(&model, gltf_primitive.indices);
+	data             = encode_vertex_data(data, count, attribute.stride, component_count, quantized_component_count, encode);
+	attribute.format = quantized_format;
+	attribute.stride = quantized_component_count * sizeof(uint16_t);
+}
 
-				auto index_data = get_attribute_data(&model, gltf_primitive.indices);
+void GLTFLoader::set_position_quantization(const tinygltf::Model &model, const tinygltf::Mesh &gltf_mesh, sg::Mesh &mesh) const
+{
+	glm::vec3 min{std::numeric_limits<float>::max()};
+	glm::vec3 max{std::numeric_limits<float>::lowest()};
 
-				switch (format)
-				{
-					case VK_FORMAT_R8_UINT:
-						// Converts uint8 data into uint16 data, still represented by a uint8 vector
-						index_data          = convert_underlying_data_stride(index_data, 1, 2);
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R16_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R32_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT32;
-						break;
-					default:
-						LOGE("gltf primitive has invalid format type");
-						break;
-				}
+	for (auto &gltf_primitive : gltf_mesh.primitives)
+	{
+		auto attribute_it = gltf_primitive.attributes.find("POSITION");
+		if (attribute_it == gltf_primitive.attributes.end())
+		{
+			continue;
+		}
 
-				submesh->index_buffer = std::make_unique<core::Buffer>(device,
-				                                                       index_data.size(),
-				                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-				                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
-				submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
-				                                                  gltf_mesh.name, i_primitive));
+		// glTF requires the bounds of position accessors, but not all exporters write them
+		auto &accessor = model.accessors[attribute_it->second];
+		if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
+		{
+			min = glm::min(min, glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]));
+			max = glm::max(max, glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]));
+		}
+		else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && accessor.type == TINYGLTF_TYPE_VEC3)
+		{
+			auto   data   = get_attribute_data(&model, attribute_it->second);
+			size_t stride = get_attribute_stride(&model, attribute_it->second);
 
-				submesh->index_buffer->update(index_data);
-			}
-			else
+			for (size_t i = 0; i < accessor.count; ++i)
 			{
-				submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
-			}
+				glm::vec3 position;
+				std::memcpy(glm::value_ptr(position), data.data() + i * stride, sizeof(position));
 
-			if (gltf_primitive.material < 0)
-			{
-				submesh->set_material(*default_material);
-			}
-			else
-			{
-				assert(gltf_primitive.material < materials.size());
-				submesh->set_material(*materials[gltf_primitive.material]);
+				min = glm::min(min, position);
+				max = glm::max(max, position);
 			}
-
-			mesh->add_submesh(*submesh);
-
-			scene.add_component(std::move(submesh));
 		}
+	}
 
-		scene.add_component(std::move(mesh));
+	if (min.x > max.x)
+	{
+		return;
 	}
 
-	device.get_fence_pool().wait();
-	device.get_fence_pool().reset();
-	device.get_command_pool().reset_pool();
+	// Flat meshes still need a non zero extent to divide by
+	mesh.set_position_quantization(min, glm::max(max - min, glm::vec3{std::numeric_limits<float>::min()}));
+}
 
-	scene.add_component(std::move(default_material));
+GLTFLoader::PrimitiveData GLTFLoader::read_primitive(const tinygltf::Mesh &gltf_mesh, size_t primitive_index, const sg::Mesh &mesh, bool skinned) const
+{
+	const auto &gltf_primitive = gltf_mesh.primitives[primitive_index];
 
-	// Load cameras
-	for (auto &gltf_camera : model.cameras)
-	{
-		auto camera = parse_camera(gltf_camera);
-		scene.add_component(std::move(camera));
-	}
+	auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, primitive_index);
+	auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
 
-	// Load nodes
-	auto meshes = scene.get_components<sg::Mesh>();
+	std::map<std::string, std::vector<uint8_t>> attribute_data;
 
-	std::vector<std::unique_ptr<sg::Node>> nodes;
+	// Kept as floats for building the meshlets and optimizing the mesh once the indices are read
+	std::vector<uint8_t> position_data;
+	size_t               position_stride = 0;
 
-	for (size_t node_index = 0; node_index < model.nodes.size(); ++node_index)
+	for (auto &attribute : gltf_primitive.attributes)
 	{
-		auto gltf_node = model.nodes[node_index];
-		auto node      = parse_node(gltf_node, node_index);
+		std::string attrib_name = attribute.first;
+		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
 
-		if (gltf_node.mesh >= 0)
+		if (!skinned && (attrib_name == "joints_0" || attrib_name == "weights_0"))
 		{
-			assert(gltf_node.mesh < meshes.size());
-			auto mesh = meshes[gltf_node.mesh];
+			continue;
+		}
 
-			node->set_component(*mesh);
+		auto vertex_data = get_attribute_data(&model, attribute.second);
 
-			mesh->add_node(*node);
-		}
+		sg::VertexAttribute attrib;
+		attrib.format = get_attribute_format(&model, attribute.second);
+		attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
 
-		if (gltf_node.camera >= 0)
+		if (attrib_name == "position")
 		{
-			auto cameras = scene.get_components<sg::Camera>();
-			assert(gltf_node.camera < cameras.size());
-			auto camera = cameras[gltf_node.camera];
-
-			node->set_component(*camera);
+			assert(attribute.second < model.accessors.size());
+			submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
 
-			camera->set_node(*node);
+			if ((meshlet_geometry || mesh_optimization) && attrib.format == VK_FORMAT_R32G32B32_SFLOAT)
+			{
+				position_data   = vertex_data;
+				position_stride = attrib.stride;
+			}
 		}
 
-		if (auto extension = get_extension(gltf_node.extensions, KHR_LIGHTS_PUNCTUAL_EXTENSION))
+		if (vertex_quantization != VertexQuantization::None && !meshlet_geometry && !vertex_pulling)
 		{
-			auto lights      = scene.get_components<sg::Light>();
-			int  light_index = extension->Get("light").Get<int>();
-			assert(light_index < lights.size());
-			auto light = lights[light_index];
-
-			node->set_component(*light);
-
-			light->set_node(*node);
+			quantize_vertex_attribute(attrib_name, model.accessors[attribute.second].count, vertex_data, attrib, mesh);
 		}
 
-		nodes.push_back(std::move(node));
+		attribute_data[attrib_name] = std::move(vertex_data);
+
+		submesh->set_attribute(attrib_name, attrib);
 	}
 
-	std::vector<std::unique_ptr<sg::Animation>> animations;
+	std::vector<uint8_t> index_data;
 
-	// Load animations
-	for (size_t animation_index = 0; animation_index < model.animations.size(); ++animation_index)
+	if (gltf_primitive.indices >= 0)
 	{
-		auto &gltf_animation = model.animations[animation_index];
+		submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
 
-		std::vector<sg::AnimationSampler> samplers;
+		auto format = get_attribute_format(&model, gltf_primitive.indices);
 
-		for (size_t sampler_index = 0; sampler_index < gltf_animation.samplers.size(); ++sampler_index)
+		index_data = get_attribute_data(&model, gltf_primitive.indices);
+
+		switch (format)
 		{
-			auto gltf_sampler = gltf_animation.samplers[sampler_index];
+			case VK_FORMAT_R8_UINT:
+				// Converts uint8 data into uint16 data, still represented by a uint8 vector
+				index_data          = convert_underlying_data_stride(index_data, 1, 2);
+				submesh->index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R16_UINT:
+				submesh->index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R32_UINT:
+				submesh->index_type = VK_INDEX_TYPE_UINT32;
+				break;
+			default:
+				LOGE("gltf primitive has invalid format type");
+				break;
+		}
+	}
+	else
+	{
+		submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
+	}
 
-			sg::AnimationSampler sampler;
-			if (gltf_sampler.interpolation == "LINEAR")
+	if (mesh_optimization && gltf_primitive.mode == TINYGLTF_MODE_TRIANGLES && !index_data.empty() && !position_data.empty() &&
+	    submesh->vertex_indices % 3 == 0)
+	{
+		optimize_submesh(*submesh, attribute_data, index_data, position_data, position_stride);
+	}
+
+	if (meshlet_geometry && gltf_primitive.mode == TINYGLTF_MODE_TRIANGLES && !position_data.empty())
+	{
+		submesh->meshlets = build_meshlets(position_data.data(), position_stride, submesh->vertices_count,
+		                                   index_data.empty() ? nullptr : index_data.data(), submesh->index_type,
+		                                   index_data.empty() ? submesh->vertices_count : submesh->vertex_indices);
+	}
+
+	return {std::move(submesh), std::move(attribute_data), std::move(index_data)};
+}
+
+std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &file_name, int scene_index)
+{
+	std::string err;
+	std::string warn;
+
+	tinygltf::TinyGLTF gltf_loader;
+
+	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
+
+	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+
+	if (!importResult)
+	{
+		LOGE("Failed to load gltf file {}.", gltf_file.c_str());
+
+		return nullptr;
+	}
+
+	if (!err.empty())
+	{
+		LOGE("Error loading gltf model: {}.", err.c_str());
+
+		return nullptr;
+	}
+
+	if (!warn.empty())
+	{
+		LOGI("{}", warn.c_str());
+	}
+
+	size_t pos = file_name.find_last_of('/');
+
+	model_path = file_name.substr(0, pos);
+
+	if (pos == std::string::npos)
+	{
+		model_path.clear();
+	}
+
+	return std::make_unique<sg::Scene>(load_scene(scene_index));
+}
+
+std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file_async(const std::string &file_name, int scene_index)
+{
+	if (image_stream)
+	{
+		throw std::runtime_error("Cannot stream " + file_name + ", the loader is already streaming a scene");
+	}
+
+	if (streamed_textures)
+	{
+		throw std::runtime_error("Cannot stream " + file_name + ", its textures are streamed");
+	}
+
+	std::unique_ptr<sg::Scene> scene;
+
+	stream_images = true;
+	try
+	{
+		scene = read_scene_from_file(file_name, scene_index);
+	}
+	catch (...)
+	{
+		stream_images = false;
+		throw;
+	}
+	stream_images = false;
+
+	// load_scene() returns the scene by value, so the stream only knows where it lives now
+	if (image_stream)
+	{
+		image_stream->scene = scene.get();
+	}
+
+	return scene;
+}
+
+bool GLTFLoader::update_streaming()
+{
+	if (!image_stream)
+	{
+		return true;
+	}
+
+	auto &stream = *image_stream;
+
+	if (!stream.batch.empty())
+	{
+		// The batch in flight is still being transferred, or acquired
+		if (stream.fence_pool->wait(0) != VK_SUCCESS)
+		{
+			return false;
+		}
+
+		stream.fence_pool->reset();
+
+		if (!stream.acquiring && stream.transfer_queue_family != stream.graphics_queue_family)
+		{
+			acquire_image_batch();
+			return false;
+		}
+
+		complete_image_batch();
+	}
+
+	submit_image_batch();
+
+	return stream.batch.empty() &&
+	       std::all_of(stream.states.begin(), stream.states.end(), [](ImageStream::State state) {
+		       return state == ImageStream::State::Resident || state == ImageStream::State::Failed;
+	       });
+}
+
+bool GLTFLoader::is_image_resident(size_t image_index) const
+{
+	if (!image_stream)
+	{
+		return image_index < model.images.size();
+	}
+
+	return image_index < image_stream->states.size() && image_stream->states[image_index] == ImageStream::State::Resident;
+}
+
+std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string &file_name, uint32_t index, bool storage_buffer)
+{
+	std::string err;
+	std::string warn;
+
+	tinygltf::TinyGLTF gltf_loader;
+
+	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
+
+	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+
+	if (!importResult)
+	{
+		LOGE("Failed to load gltf file {}.", gltf_file.c_str());
+
+		return nullptr;
+	}
+
+	if (!err.empty())
+	{
+		LOGE("Error loading gltf model: {}.", err.c_str());
+
+		return nullptr;
+	}
+
+	if (!warn.empty())
+	{
+		LOGI("{}", warn.c_str());
+	}
+
+	size_t pos = file_name.find_last_of('/');
+
+	model_path = file_name.substr(0, pos);
+
+	if (pos == std::string::npos)
+	{
+		model_path.clear();
+	}
+
+	return std::move(load_model(index, storage_buffer));
+}
+
+sg::Scene GLTFLoader::load_scene(int scene_index)
+{
+	// The vertex and index buffers of the scene, its images and staging buffers are tagged by themselves
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::SceneGeometry};
+
+	auto scene = sg::Scene();
+
+	scene.set_name("gltf_scene");
+
+	// Check extensions
+	for (auto &used_extension : model.extensionsUsed)
+	{
+		auto it = supported_extensions.find(used_extension);
+
+		// Check if extension isn't supported by the GLTFLoader
+		if (it == supported_extensions.end())
+		{
+			// If extension is required then we shouldn't allow the scene to be loaded
+			if (std::find(model.extensionsRequired.begin(), model.extensionsRequired.end(), used_extension) != model.extensionsRequired.end())
+			{
+				throw std::runtime_error("Cannot load glTF file. Contains a required unsupported extension: " + used_extension);
+			}
+			else
+			{
+				// Otherwise, if extension isn't required (but is in the file) then print a warning to the user
+				LOGW("glTF file contains an unsupported extension, unexpected results may occur: {}", used_extension);
+			}
+		}
+		else
+		{
+			// Extension is supported, so enable it
+			LOGI("glTF file contains extension: {}", used_extension);
+			it->second = true;
+		}
+	}
+
+	// Load lights
+	std::vector<std::unique_ptr<sg::Light>> light_components = parse_khr_lights_punctual();
+
+	scene.set_components(std::move(light_components));
+
+	// Load samplers
+	std::vector<std::unique_ptr<sg::Sampler>>
+	    sampler_components(model.samplers.size());
+
+	for (size_t sampler_index = 0; sampler_index < model.samplers.size(); sampler_index++)
+	{
+		auto sampler                      = parse_sampler(model.samplers[sampler_index]);
+		sampler_components[sampler_index] = std::move(sampler);
+	}
+
+	scene.set_components(std::move(sampler_components));
+
+	// Load images, or start streaming them in
+	if (stream_images)
+	{
+		scene.add_component(start_image_stream());
+	}
+	else
+	{
+		load_images(scene);
+	}
+
+	// Load textures
+	auto images                  = scene.get_components<sg::Image>();
+	auto samplers                = scene.get_components<sg::Sampler>();
+	auto default_sampler_linear  = create_default_sampler(TINYGLTF_TEXTURE_FILTER_LINEAR);
+	auto default_sampler_nearest = create_default_sampler(TINYGLTF_TEXTURE_FILTER_NEAREST);
+	bool used_nearest_sampler    = false;
+
+	for (auto &gltf_texture : model.textures)
+	{
+		auto texture = parse_texture(gltf_texture);
+
+		assert(gltf_texture.source < model.images.size());
+
+		// While streaming, the only image is the placeholder sampled until the texture image is resident
+		sg::Image *image = stream_images ? images.front() : images[gltf_texture.source];
+		texture->set_image(*image);
+
+		if (stream_images)
+		{
+			image_stream->textures[gltf_texture.source].push_back(texture.get());
+		}
+
+		if (gltf_texture.sampler >= 0 && gltf_texture.sampler < static_cast<int>(samplers.size()))
+		{
+			texture->set_sampler(*samplers[gltf_texture.sampler]);
+		}
+		else
+		{
+			if (gltf_texture.name.empty())
+			{
+				gltf_texture.name = model.images[gltf_texture.source].name;
+			}
+
+			// Get the properties for the image format. We'll need to check whether a linear sampler is valid.
+			// While streaming this is the placeholder format, as the image has not been decoded yet.
+			const VkFormatProperties fmtProps = device.get_gpu().get_format_properties(image->get_format());
+
+			if (fmtProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+			{
+				texture->set_sampler(*default_sampler_linear);
+			}
+			else
+			{
+				texture->set_sampler(*default_sampler_nearest);
+				used_nearest_sampler = true;
+			}
+		}
+
+		scene.add_component(std::move(texture));
+	}
+
+	scene.add_component(std::move(default_sampler_linear));
+	if (used_nearest_sampler)
+	{
+		scene.add_component(std::move(default_sampler_nearest));
+	}
+
+	// Load materials
+	bool                            has_textures = scene.has_component<sg::Texture>();
+	std::vector<vkb::sg::Texture *> textures;
+	if (has_textures)
+	{
+		textures = scene.get_components<sg::Texture>();
+	}
+
+	// While streaming, the images are only converted once decoded, before their Vulkan image is created
+	auto coerce_texture_to_srgb = [this, &textures](int texture_index) {
+		if (stream_images)
+		{
+			image_stream->needs_srgb[model.textures[texture_index].source] = true;
+		}
+		else
+		{
+			textures[texture_index]->get_image()->coerce_format_to_srgb();
+		}
+	};
+
+	for (auto &gltf_material : model.materials)
+	{
+		auto material = parse_material(gltf_material);
+
+		for (auto &gltf_value : gltf_material.values)
+		{
+			if (gltf_value.first.find("Texture") != std::string::npos)
+			{
+				std::string tex_name = to_snake_case(gltf_value.first);
+
+				assert(gltf_value.second.TextureIndex() < textures.size());
+				vkb::sg::Texture *tex = textures[gltf_value.second.TextureIndex()];
+
+				if (texture_needs_srgb_colorspace(gltf_value.first))
+				{
+					coerce_texture_to_srgb(gltf_value.second.TextureIndex());
+				}
+
+				material->textures[tex_name] = tex;
+			}
+		}
+
+		for (auto &gltf_value : gltf_material.additionalValues)
+		{
+			if (gltf_value.first.find("Texture") != std::string::npos)
+			{
+				std::string tex_name = to_snake_case(gltf_value.first);
+
+				assert(gltf_value.second.TextureIndex() < textures.size());
+				vkb::sg::Texture *tex = textures[gltf_value.second.TextureIndex()];
+
+				if (texture_needs_srgb_colorspace(gltf_value.first))
+				{
+					coerce_texture_to_srgb(gltf_value.second.TextureIndex());
+				}
+
+				material->textures[tex_name] = tex;
+			}
+		}
+
+		scene.add_component(std::move(material));
+	}
+
+	auto default_material = create_default_material();
+
+	// Load meshes
+	auto materials = scene.get_components<sg::PBRMaterial>();
+
+	std::unique_ptr<GeometryPacker> geometry_packer;
+	if (pack_geometry)
+	{
+		geometry_packer = std::make_unique<GeometryPacker>(packed_buffer_size);
+	}
+
+	// Vertices of the submeshes drawn with vertex pulling, in a single buffer so that draws bind the same descriptor
+	std::vector<uint32_t>      pulled_vertex_data;
+	std::vector<sg::SubMesh *> pulled_submeshes;
+	const size_t               max_pulled_vertex_words = device.get_gpu().get_properties().limits.maxStorageBufferRange / sizeof(uint32_t);
+
+	// Joints and weights are only loaded for the meshes deformed by a skin, as the shaders skin any vertices which have them
+	std::vector<bool> skinned_meshes(model.meshes.size(), false);
+	for (auto &gltf_node : model.nodes)
+	{
+		if (gltf_node.mesh >= 0 && gltf_node.skin >= 0)
+		{
+			skinned_meshes[gltf_node.mesh] = true;
+		}
+	}
+
+	// Meshes are parsed first, as reading a primitive may compress it in the box of its mesh
+	std::vector<std::unique_ptr<sg::Mesh>> meshes;
+	std::vector<std::pair<size_t, size_t>> primitive_indices;
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); ++mesh_index)
+	{
+		auto &gltf_mesh = model.meshes[mesh_index];
+
+		auto mesh = parse_mesh(gltf_mesh);
+
+		if (vertex_quantization == VertexQuantization::Compressed)
+		{
+			set_position_quantization(model, gltf_mesh, *mesh);
+		}
+
+		for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size(); i_primitive++)
+		{
+			primitive_indices.emplace_back(mesh_index, i_primitive);
+		}
+
+		meshes.push_back(std::move(mesh));
+	}
+
+	// The primitives are read in parallel, in batches so that only the data of a batch waits for its buffers.
+	// The buffers are then created in the order of the model, so that the packed geometry does not depend on the scheduling.
+	Timer timer;
+	timer.start();
+
+	auto  &job_system = JobSystem::get();
+	size_t batch_size = PRIMITIVE_BATCH_SIZE_PER_THREAD * (job_system.get_worker_count() + 1);
+
+	std::vector<PrimitiveData> primitives;
+
+	for (size_t batch_begin = 0; batch_begin < primitive_indices.size(); batch_begin += batch_size)
+	{
+		primitives.clear();
+		primitives.resize(std::min(batch_size, primitive_indices.size() - batch_begin));
+
+		job_system.parallel_for(primitives.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				auto &indices = primitive_indices[batch_begin + i];
+
+				primitives[i] = read_primitive(model.meshes[indices.first], indices.second, *meshes[indices.first], skinned_meshes[indices.first]);
+			}
+		});
+
+		for (size_t i = 0; i < primitives.size(); ++i)
+		{
+			size_t mesh_index  = primitive_indices[batch_begin + i].first;
+			size_t i_primitive = primitive_indices[batch_begin + i].second;
+
+			const auto &gltf_mesh      = model.meshes[mesh_index];
+			const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
+
+			auto &submesh        = primitives[i].submesh;
+			auto &attribute_data = primitives[i].attribute_data;
+			auto &index_data     = primitives[i].index_data;
+
+			if (!geometry_packer)
+			{
+				for (auto &attribute : attribute_data)
+				{
+					core::Buffer buffer{device,
+					                    attribute.second.size(),
+					                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | geometry_buffer_usage,
+					                    VMA_MEMORY_USAGE_CPU_TO_GPU};
+					buffer.update(attribute.second);
+					buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
+					                                  gltf_mesh.name, i_primitive, attribute.first));
+
+					submesh->vertex_buffers.insert(std::make_pair(attribute.first, std::move(buffer)));
+				}
+
+				if (!index_data.empty())
+				{
+					submesh->index_buffer = std::make_unique<core::Buffer>(device,
+					                                                       index_data.size(),
+					                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT | geometry_buffer_usage,
+					                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
+					submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
+					                                                  gltf_mesh.name, i_primitive));
+
+					submesh->index_buffer->update(index_data);
+				}
+			}
+
+			if (vertex_pulling && !skinned_meshes[mesh_index] &&
+			    pulled_vertex_data.size() + size_t{submesh->vertices_count} * PULLED_VERTEX_WORDS <= max_pulled_vertex_words)
+			{
+				auto pulled_vertex_offset = static_cast<int32_t>(pulled_vertex_data.size() / PULLED_VERTEX_WORDS);
+
+				if (append_pulled_vertices(*submesh, attribute_data, pulled_vertex_data))
+				{
+					submesh->pulled_vertex_offset = pulled_vertex_offset;
+					pulled_submeshes.push_back(submesh.get());
+				}
+			}
+
+			if (geometry_packer)
+			{
+				geometry_packer->add(*submesh, attribute_data, index_data);
+			}
+
+			if (gltf_primitive.material < 0)
+			{
+				submesh->set_material(*default_material);
+			}
+			else
+			{
+				assert(gltf_primitive.material < materials.size());
+				submesh->set_material(*materials[gltf_primitive.material]);
+			}
+
+			meshes[mesh_index]->add_submesh(*submesh);
+
+			scene.add_component(std::move(submesh));
+		}
+	}
+
+	LOGI("Time spent reading meshes: {} seconds across {} threads.", vkb::to_string(timer.stop()), job_system.get_worker_count() + 1);
+
+	for (auto &mesh : meshes)
+	{
+		scene.add_component(std::move(mesh));
+	}
+
+	if (geometry_packer)
+	{
+		geometry_packer->pack(device, geometry_buffer_usage);
+	}
+
+	if (!pulled_vertex_data.empty())
+	{
+		auto pulled_vertex_buffer = std::make_shared<core::Buffer>(device,
+		                                                           pulled_vertex_data.size() * sizeof(uint32_t),
+		                                                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		                                                           VMA_MEMORY_USAGE_CPU_TO_GPU);
+		pulled_vertex_buffer->update(pulled_vertex_data);
+		pulled_vertex_buffer->set_debug_name("pulled vertex buffer");
+
+		for (auto submesh : pulled_submeshes)
+		{
+			submesh->pulled_vertex_buffer = pulled_vertex_buffer;
+		}
+
+		LOGI("Packed the vertices of {} submeshes for vertex pulling", pulled_submeshes.size());
+	}
+
+	device.get_fence_pool().wait();
+	device.get_fence_pool().reset();
+	device.get_command_pool().reset_pool();
+
+	scene.add_component(std::move(default_material));
+
+	// Load cameras
+	for (auto &gltf_camera : model.cameras)
+	{
+		auto camera = parse_camera(gltf_camera);
+		scene.add_component(std::move(camera));
+	}
+
+	// Load nodes
+	auto meshes = scene.get_components<sg::Mesh>();
+
+	std::vector<std::unique_ptr<sg::Node>> nodes;
+
+	// The lower levels of detail of MSFT_lod are drawn by the node of the full detail, not by their own nodes
+	std::vector<bool> lod_nodes(model.nodes.size(), false);
+	for (auto &gltf_node : model.nodes)
+	{
+		if (auto extension = get_extension(gltf_node.extensions, MSFT_LOD_EXTENSION))
+		{
+			auto &ids = extension->Get("ids");
+			for (size_t i = 0; i < ids.ArrayLen(); ++i)
+			{
+				int id = ids.Get(static_cast<int>(i)).Get<int>();
+				if (id >= 0 && id < static_cast<int>(lod_nodes.size()))
+				{
+					lod_nodes[id] = true;
+				}
+			}
+		}
+	}
+
+	for (size_t node_index = 0; node_index < model.nodes.size(); ++node_index)
+	{
+		auto gltf_node = model.nodes[node_index];
+		auto node      = parse_node(gltf_node, node_index);
+
+		if (gltf_node.mesh >= 0 && !lod_nodes[node_index])
+		{
+			assert(gltf_node.mesh < meshes.size());
+			auto mesh = meshes[gltf_node.mesh];
+
+			node->set_component(*mesh);
+
+			mesh->add_node(*node);
+
+			if (auto lod_group = parse_lod_group(gltf_node, *mesh, meshes))
+			{
+				node->set_component(*lod_group);
+
+				scene.add_component(std::move(lod_group));
+			}
+		}
+
+		if (gltf_node.camera >= 0)
+		{
+			auto cameras = scene.get_components<sg::Camera>();
+			assert(gltf_node.camera < cameras.size());
+			auto camera = cameras[gltf_node.camera];
+
+			node->set_component(*camera);
+
+			camera->set_node(*node);
+		}
+
+		if (auto extension = get_extension(gltf_node.extensions, KHR_LIGHTS_PUNCTUAL_EXTENSION))
+		{
+			auto lights      = scene.get_components<sg::Light>();
+			int  light_index = extension->Get("light").Get<int>();
+			assert(light_index < lights.size());
+			auto light = lights[light_index];
+
+			node->set_component(*light);
+
+			light->set_node(*node);
+		}
+
+		nodes.push_back(std::move(node));
+	}
+
+	// Load skins
+	for (auto &gltf_skin : model.skins)
+	{
+		auto skin = std::make_unique<sg::Skin>(gltf_skin.name);
+
+		std::vector<sg::Node *> joints;
+		for (auto joint_index : gltf_skin.joints)
+		{
+			assert(joint_index < nodes.size());
+			joints.push_back(nodes[joint_index].get());
+		}
+
+		// Joints without inverse bind matrices are already in the space of the mesh in the bind pose
+		std::vector<glm::mat4> inverse_bind_matrices(joints.size(), glm::mat4(1.0f));
+		if (gltf_skin.inverseBindMatrices >= 0)
+		{
+			// glTF stores them as column major float matrices, as glm does
+			auto data = get_attribute_data(&model, gltf_skin.inverseBindMatrices);
+			std::memcpy(inverse_bind_matrices.data(), data.data(), std::min(data.size(), inverse_bind_matrices.size() * sizeof(glm::mat4)));
+		}
+
+		skin->set_joints(std::move(joints), std::move(inverse_bind_matrices));
+
+		scene.add_component(std::move(skin));
+	}
+
+	if (!model.skins.empty())
+	{
+		auto skins = scene.get_components<sg::Skin>();
+
+		for (size_t node_index = 0; node_index < model.nodes.size(); ++node_index)
+		{
+			int skin_index = model.nodes[node_index].skin;
+			if (skin_index >= 0 && model.nodes[node_index].mesh >= 0)
+			{
+				assert(skin_index < skins.size());
+				nodes[node_index]->set_component(*skins[skin_index]);
+			}
+		}
+	}
+
+	std::vector<std::unique_ptr<sg::Animation>> animations;
+
+	// Load animations
+	for (size_t animation_index = 0; animation_index < model.animations.size(); ++animation_index)
+	{
+		auto &gltf_animation = model.animations[animation_index];
+
+		std::vector<sg::AnimationSampler> samplers;
+
+		for (size_t sampler_index = 0; sampler_index < gltf_animation.samplers.size(); ++sampler_index)
+		{
+			auto gltf_sampler = gltf_animation.samplers[sampler_index];
+
+			sg::AnimationSampler sampler;
+			if (gltf_sampler.interpolation == "LINEAR")
+			{
+				sampler.type = sg::AnimationType::Linear;
+			}
+			else if (gltf_sampler.interpolation == "STEP")
+			{
+				sampler.type = sg::AnimationType::Step;
+			}
+			else if (gltf_sampler.interpolation == "CUBICSPLINE")
+			{
+				sampler.type = sg::AnimationType::CubicSpline;
+			}
+			else
+			{
+				LOGW("Gltf animation sampler #{} has unknown interpolation value", sampler_index);
+			}
+
+			auto input_accessor      = model.accessors[gltf_sampler.input];
+			auto input_accessor_data = get_attribute_data(&model, gltf_sampler.input);
+
+			const float *data = reinterpret_cast<const float *>(input_accessor_data.data());
+			for (size_t i = 0; i < input_accessor.count; ++i)
+			{
+				sampler.inputs.push_back(data[i]);
+			}
+
+			auto output_accessor      = model.accessors[gltf_sampler.output];
+			auto output_accessor_data = get_attribute_data(&model, gltf_sampler.output);
+
+			switch (output_accessor.type)
+			{
+				case TINYGLTF_TYPE_VEC3:
+				{
+					const glm::vec3 *data = reinterpret_cast<const glm::vec3 *>(output_accessor_data.data());
+					for (size_t i = 0; i < output_accessor.count; ++i)
+					{
+						sampler.outputs.push_back(glm::vec4(data[i], 0.0f));
+					}
+					break;
+				}
+				case TINYGLTF_TYPE_VEC4:
+				{
+					const glm::vec4 *data = reinterpret_cast<const glm::vec4 *>(output_accessor_data.data());
+					for (size_t i = 0; i < output_accessor.count; ++i)
+					{
+						sampler.outputs.push_back(glm::vec4(data[i]));
+					}
+					break;
+				}
+				default:
+				{
+					LOGW("Gltf animation sampler #{} has unknown output data type", sampler_index);
+					continue;
+				}
+			}
+
+			samplers.push_back(sampler);
+		}
+
+		auto animation = std::make_unique<sg::Animation>(gltf_animation.name);
+
+		for (size_t channel_index = 0; channel_index < gltf_animation.channels.size(); ++channel_index)
+		{
+			auto &gltf_channel = gltf_animation.channels[channel_index];
+
+			sg::AnimationTarget target;
+			if (gltf_channel.target_path == "translation")
+			{
+				target = sg::AnimationTarget::Translation;
+			}
+			else if (gltf_channel.target_path == "rotation")
+			{
+				target = sg::AnimationTarget::Rotation;
+			}
+			else if (gltf_channel.target_path == "scale")
+			{
+				target = sg::AnimationTarget::Scale;
+			}
+			else if (gltf_channel.target_path == "weights")
+			{
+				LOGW("Gltf animation channel #{} has unsupported target path: {}", channel_index, gltf_channel.target_path);
+				continue;
+			}
+			else
+			{
+				LOGW("Gltf animation channel #{} has unknown target path", channel_index);
+				continue;
+			}
+
+			float start_time{std::numeric_limits<float>::max()};
+			float end_time{std::numeric_limits<float>::min()};
+
+			for (auto input : samplers[gltf_channel.sampler].inputs)
+			{
+				if (input < start_time)
+				{
+					start_time = input;
+				}
+				if (input > end_time)
+				{
+					end_time = input;
+				}
+			}
+
+			animation->update_times(start_time, end_time);
+
+			animation->add_channel(*nodes[gltf_channel.target_node], target, samplers[gltf_channel.sampler]);
+		}
+
+		animations.push_back(std::move(animation));
+	}
+
+	scene.set_components(std::move(animations));
+
+	// Load scenes
+	std::queue<std::pair<sg::Node &, int>> traverse_nodes;
+
+	tinygltf::Scene *gltf_scene{nullptr};
+
+	if (scene_index >= 0 && scene_index < static_cast<int>(model.scenes.size()))
+	{
+		gltf_scene = &model.scenes[scene_index];
+	}
+	else if (model.defaultScene >= 0 && model.defaultScene < static_cast<int>(model.scenes.size()))
+	{
+		gltf_scene = &model.scenes[model.defaultScene];
+	}
+	else if (model.scenes.size() > 0)
+	{
+		gltf_scene = &model.scenes[0];
+	}
+
+	if (!gltf_scene)
+	{
+		throw std::runtime_error("Couldn't determine which scene to load!");
+	}
+
+	auto root_node = std::make_unique<sg::Node>(0, gltf_scene->name);
+
+	for (auto node_index : gltf_scene->nodes)
+	{
+		traverse_nodes.push(std::make_pair(std::ref(*root_node), node_index));
+	}
+
+	while (!traverse_nodes.empty())
+	{
+		auto node_it = traverse_nodes.front();
+		traverse_nodes.pop();
+
+		assert(node_it.second < nodes.size());
+		auto &current_node       = *nodes[node_it.second];
+		auto &traverse_root_node = node_it.first;
+
+		current_node.set_parent(traverse_root_node);
+		traverse_root_node.add_child(current_node);
+
+		for (auto child_node_index : model.nodes[node_it.second].children)
+		{
+			traverse_nodes.push(std::make_pair(std::ref(current_node), child_node_index));
+		}
+	}
+
+	scene.set_root_node(*root_node);
+	nodes.push_back(std::move(root_node));
+
+	// Store nodes into the scene
+	scene.set_nodes(std::move(nodes));
+
+	// Create node for the default camera
+	auto camera_node = std::make_unique<sg::Node>(-1, "default_camera");
+
+	auto default_camera = create_default_camera();
+	default_camera->set_node(*camera_node);
+	camera_node->set_component(*default_camera);
+	scene.add_component(std::move(default_camera));
+
+	scene.get_root_node().add_child(*camera_node);
+	scene.add_node(std::move(camera_node));
+
+	if (!scene.has_component<vkb::sg::Light>())
+	{
+		// Add a default light if none are present
+		vkb::add_directional_light(scene, glm::quat({glm::radians(-90.0f), 0.0f, glm::radians(30.0f)}));
+	}
+
+	return scene;
+}
+
+void GLTFLoader::load_images(sg::Scene &scene)
+{
+	Timer timer;
+	timer.start();
+
+	// Load images
+	auto &job_system = JobSystem::get();
+
+	auto image_count = to_u32(model.images.size());
+
+	std::vector<std::unique_ptr<sg::Image>> image_components(image_count);
+
+	// Images of the same content share one Vulkan image, with the scenes previously loaded on the device or within the model.
+	// Per glTF image, its source is itself if it is loaded, the first image of its content in the model, or the registry.
+	constexpr size_t SHARED_FROM_REGISTRY = std::numeric_limits<size_t>::max();
+
+	auto &texture_registry = device.get_texture_registry();
+
+	std::vector<Hash128>                content_hashes(image_count);
+	std::vector<size_t>                 sources(image_count);
+	std::unordered_map<Hash128, size_t> first_images;
+	std::mutex                          first_images_mutex;
+
+	for (size_t image_index = 0; image_index < image_count; image_index++)
+	{
+		sources[image_index] = image_index;
+	}
+
+	// All the files are read up front, the jobs decode each one as soon as it is read
+	auto file_reads = read_image_files_async(model, model_path);
+
+	std::vector<JobHandle> image_jobs;
+	image_jobs.reserve(image_count);
+	for (size_t image_index = 0; image_index < image_count; image_index++)
+	{
+		image_jobs.push_back(job_system.submit(
+		    [&, image_index]() {
+			    auto  file       = take_image_file(file_reads[image_index]);
+			    auto &gltf_image = model.images[image_index];
+
+			    if (streamed_textures)
+			    {
+				    // A texture streamer creates the Vulkan image and streams the texels from the CPU
+				    image_components[image_index] = decode_image(gltf_image, std::move(file));
+				    image_components[image_index]->resolve_payload();
+			    }
+			    else
+			    {
+				    if (!file && gltf_image.image.empty())
+				    {
+					    file = fs::map_asset(model_path + "/" + gltf_image.uri);
+				    }
+
+				    content_hashes[image_index] = hash_image_content(gltf_image, file.get());
+
+				    if (auto shared_image = texture_registry.find(content_hashes[image_index], gltf_image.name))
+				    {
+					    image_components[image_index] = std::move(shared_image);
+					    sources[image_index]          = SHARED_FROM_REGISTRY;
+					    LOGI("Shared gltf image #{} ({}) with a previous load", image_index, gltf_image.uri.c_str());
+					    return;
+				    }
+
+				    {
+					    std::lock_guard<std::mutex> lock(first_images_mutex);
+
+					    size_t first_image = first_images.emplace(content_hashes[image_index], image_index).first->second;
+					    if (first_image != image_index)
+					    {
+						    // Shares the Vulkan image of the first image once it is resident
+						    sources[image_index] = first_image;
+						    return;
+					    }
+				    }
+
+				    image_components[image_index] = parse_image(gltf_image, std::move(file));
+			    }
+
+			    LOGI("Loaded gltf image #{} ({})", image_index, gltf_image.uri.c_str());
+		    }));
+	}
+
+	if (streamed_textures)
+	{
+		job_system.wait(image_jobs);
+
+		scene.set_components(std::move(image_components));
+
+		LOGI("Time spent loading images: {} seconds across {} threads.", vkb::to_string(timer.stop()), job_system.get_worker_count() + 1);
+		return;
+	}
+
+	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
+	// double the amount of memory (all the images and all the corresponding buffers).
+	// This helps keep memory footprint lower which is helpful on smaller devices.
+	// Two batches are in flight, so that one is recorded while the previous one is copied.
+	struct UploadBatch
+	{
+		std::unique_ptr<CommandPool> command_pool;
+
+		std::unique_ptr<FencePool> fence_pool;
+
+		std::vector<core::BufferPtr> staging_buffers;
+	};
+
+	// Prefers a transfer only queue family, in which case the images are acquired by the graphics one at the end
+	uint32_t transfer_queue_family = device.get_queue_family_index(VK_QUEUE_TRANSFER_BIT);
+	uint32_t graphics_queue_family = device.get_suitable_graphics_queue().get_family_index();
+
+	auto &transfer_queue = device.get_queue(transfer_queue_family, 0);
+
+	std::array<UploadBatch, 2> upload_batches;
+	for (auto &upload_batch : upload_batches)
+	{
+		upload_batch.command_pool = std::make_unique<CommandPool>(device, transfer_queue_family);
+		upload_batch.fence_pool   = std::make_unique<FencePool>(device);
+	}
+
+	size_t image_index = 0;
+	size_t batch_index = 0;
+	while (image_index < image_count)
+	{
+		auto &upload_batch = upload_batches[batch_index++ % upload_batches.size()];
+
+		// Only wait for the batch previously recorded with these resources, the other one keeps copying
+		upload_batch.fence_pool->wait();
+		upload_batch.fence_pool->reset();
+		upload_batch.command_pool->reset_pool();
+		upload_batch.staging_buffers.clear();
+
+		auto &command_buffer = upload_batch.command_pool->request_command_buffer();
+
+		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+		size_t batch_size = 0;
+
+		// Deal with 64MB of image data at a time to keep memory footprint low
+		while (image_index < image_count && batch_size < 64 * 1024 * 1024)
+		{
+			// Wait for this image to complete loading, then stage for upload
+			try
 			{
-				sampler.type = sg::AnimationType::Linear;
+				job_system.wait(image_jobs[image_index]);
 			}
-			else if (gltf_sampler.interpolation == "STEP")
+			catch (...)
 			{
-				sampler.type = sg::AnimationType::Step;
+				// The remaining jobs write to image_components, and the batches in flight read their staging buffers
+				try
+				{
+					job_system.wait(image_jobs);
+				}
+				catch (...)
+				{
+				}
+				for (auto &batch : upload_batches)
+				{
+					batch.fence_pool->wait();
+				}
+				throw;
 			}
-			else if (gltf_sampler.interpolation == "CUBICSPLINE")
+
+			// Shared images are already resident, or share their source once it is
+			if (sources[image_index] != image_index)
 			{
-				sampler.type = sg::AnimationType::CubicSpline;
+				image_index++;
+				continue;
 			}
-			else
+
+			auto &image = image_components[image_index];
+
+			batch_size += image->get_payload_size();
+
+			auto stage_buffer = create_image_staging_buffer(device, *image);
+
+			upload_image_to_gpu(command_buffer, *stage_buffer, *image, transfer_queue_family, graphics_queue_family);
+
+			// Otherwise the mip chain is generated once acquired by the graphics queue family
+			if (image->needs_mip_generation() && transfer_queue_family == graphics_queue_family)
 			{
-				LOGW("Gltf animation sampler #{} has unknown interpolation value", sampler_index);
+				get_mip_generator().generate(command_buffer, image->get_vk_image_view());
 			}
 
-			auto input_accessor      = model.accessors[gltf_sampler.input];
-			auto input_accessor_data = get_attribute_data(&model, gltf_sampler.input);
+			upload_batch.staging_buffers.push_back(std::move(stage_buffer));
 
-			const float *data = reinterpret_cast<const float *>(input_accessor_data.data());
-			for (size_t i = 0; i < input_accessor.count; ++i)
+			image_index++;
+		}
+
+		command_buffer.end();
+
+		transfer_queue.submit(command_buffer, upload_batch.fence_pool->request_fence());
+	}
+
+	for (auto &upload_batch : upload_batches)
+	{
+		upload_batch.fence_pool->wait();
+	}
+
+	if (transfer_queue_family != graphics_queue_family && image_count > 0)
+	{
+		CommandPool graphics_command_pool{device, graphics_queue_family};
+		FencePool   graphics_fence_pool{device};
+
+		auto &command_buffer = graphics_command_pool.request_command_buffer();
+
+		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+		for (size_t i = 0; i < image_count; i++)
+		{
+			if (sources[i] != i)
 			{
-				sampler.inputs.push_back(data[i]);
+				continue;
 			}
 
-			auto output_accessor      = model.accessors[gltf_sampler.output];
-			auto output_accessor_data = get_attribute_data(&model, gltf_sampler.output);
+			auto &image = image_components[i];
 
-			switch (output_accessor.type)
+			acquire_image(command_buffer, *image, transfer_queue_family, graphics_queue_family);
+
+			if (image->needs_mip_generation())
 			{
-				case TINYGLTF_TYPE_VEC3:
-				{
-					const glm::vec3 *data = reinterpret_cast<const glm::vec3 *>(output_accessor_data.data());
-					for (size_t i = 0; i < output_accessor.count; ++i)
-					{
-						sampler.outputs.push_back(glm::vec4(data[i], 0.0f));
-					}
-					break;
-				}
-				case TINYGLTF_TYPE_VEC4:
-				{
-					const glm::vec4 *data = reinterpret_cast<const glm::vec4 *>(output_accessor_data.data());
-					for (size_t i = 0; i < output_accessor.count; ++i)
-					{
-						sampler.outputs.push_back(glm::vec4(data[i]));
-					}
-					break;
-				}
-				default:
-				{
-					LOGW("Gltf animation sampler #{} has unknown output data type", sampler_index);
-					continue;
-				}
+				get_mip_generator().generate(command_buffer, image->get_vk_image_view());
 			}
+		}
+
+		command_buffer.end();
+
+		device.get_suitable_graphics_queue().submit(command_buffer, graphics_fence_pool.request_fence());
+
+		graphics_fence_pool.wait();
+	}
+
+	if (texture_arrays)
+	{
+		std::vector<bool> loaded(image_count);
+		for (size_t i = 0; i < image_count; i++)
+		{
+			loaded[i] = sources[i] == i;
+		}
+
+		// Before the images are registered and shared, so that they share the layers
+		pack_texture_arrays(image_components, loaded);
+	}
+
+	size_t shared_count = 0;
+	for (size_t i = 0; i < image_count; i++)
+	{
+		if (sources[i] == i)
+		{
+			texture_registry.add(content_hashes[i], *image_components[i]);
+			continue;
+		}
+
+		if (sources[i] != SHARED_FROM_REGISTRY)
+		{
+			image_components[i] = image_components[sources[i]]->share(model.images[i].name);
+		}
+
+		shared_count++;
+	}
+
+	if (shared_count > 0)
+	{
+		LOGI("Shared {} of {} images with images of the same content", shared_count, image_count);
+	}
+
+	scene.set_components(std::move(image_components));
+
+	auto elapsed_time = timer.stop();
+
+	LOGI("Time spent loading images: {} seconds across {} threads.", vkb::to_string(elapsed_time), job_system.get_worker_count() + 1);
+}
+
+std::unique_ptr<sg::Image> GLTFLoader::start_image_stream()
+{
+	image_stream = std::make_unique<ImageStream>();
+
+	auto &stream      = *image_stream;
+	auto  image_count = model.images.size();
+
+	stream.images.resize(image_count);
+	stream.states.resize(image_count, ImageStream::State::Decoding);
+	stream.needs_srgb.resize(image_count, false);
+	stream.textures.resize(image_count);
+	stream.staging_buffers.resize(image_count);
+
+	// Prefers a transfer only queue family, which copies alongside the rendering
+	stream.transfer_queue_family = device.get_queue_family_index(VK_QUEUE_TRANSFER_BIT);
+	stream.graphics_queue_family = device.get_suitable_graphics_queue().get_family_index();
+
+	stream.transfer_command_pool = std::make_unique<CommandPool>(device, stream.transfer_queue_family);
+	if (stream.transfer_queue_family != stream.graphics_queue_family)
+	{
+		stream.graphics_command_pool = std::make_unique<CommandPool>(device, stream.graphics_queue_family);
+	}
+	stream.fence_pool = std::make_unique<FencePool>(device);
+
+	auto &job_system = JobSystem::get();
+
+	stream.file_reads = read_image_files_async(model, model_path);
+
+	stream.decode_jobs.reserve(image_count);
+	for (size_t image_index = 0; image_index < image_count; image_index++)
+	{
+		stream.decode_jobs.push_back(job_system.submit(
+		    [this, &stream, image_index]() {
+			    stream.images[image_index] = decode_image(model.images[image_index], take_image_file(stream.file_reads[image_index]));
+
+			    // Decoding pending payloads here keeps them off the thread calling update_streaming()
+			    stream.staging_buffers[image_index] = create_image_staging_buffer(device, *stream.images[image_index]);
+
+			    LOGI("Decoded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
+		    }));
+	}
+
+	// A single white texel, uploaded right away so that the scene can be drawn before any image is resident
+	std::vector<uint8_t>    placeholder_data{255, 255, 255, 255};
+	std::vector<sg::Mipmap> placeholder_mipmaps{{0, 0, {1, 1, 1}}};
+
+	auto placeholder = std::make_unique<sg::Image>("placeholder", std::move(placeholder_data), std::move(placeholder_mipmaps));
+	placeholder->create_vk_image(device);
+
+	core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(device, placeholder->get_data());
+
+	auto &command_buffer = device.request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+	upload_image_to_gpu(command_buffer, stage_buffer, *placeholder);
+
+	command_buffer.end();
+
+	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
 
-			samplers.push_back(sampler);
-		}
+	queue.submit(command_buffer, device.request_fence());
 
-		auto animation = std::make_unique<sg::Animation>(gltf_animation.name);
+	device.get_fence_pool().wait();
+	device.get_fence_pool().reset();
+	device.get_command_pool().reset_pool();
 
-		for (size_t channel_index = 0; channel_index < gltf_animation.channels.size(); ++channel_index)
+	return placeholder;
+}
+
+void GLTFLoader::submit_image_batch()
+{
+	auto &stream     = *image_stream;
+	auto &job_system = JobSystem::get();
+
+	CommandBuffer *command_buffer = nullptr;
+
+	size_t batch_size = 0;
+
+	// Same 64MB budget as blocking loads, to bound the staging memory
+	for (size_t image_index = 0; image_index < stream.images.size() && batch_size < 64 * 1024 * 1024; image_index++)
+	{
+		if (stream.states[image_index] != ImageStream::State::Decoding || !stream.decode_jobs[image_index].is_done())
 		{
-			auto &gltf_channel = gltf_animation.channels[channel_index];
+			continue;
+		}
 
-			sg::AnimationTarget target;
-			if (gltf_channel.target_path == "translation")
-			{
-				target = sg::AnimationTarget::Translation;
-			}
-			else if (gltf_channel.target_path == "rotation")
-			{
-				target = sg::AnimationTarget::Rotation;
-			}
-			else if (gltf_channel.target_path == "scale")
-			{
-				target = sg::AnimationTarget::Scale;
-			}
-			else if (gltf_channel.target_path == "weights")
-			{
-				LOGW("Gltf animation channel #{} has unsupported target path: {}", channel_index, gltf_channel.target_path);
-				continue;
-			}
-			else
-			{
-				LOGW("Gltf animation channel #{} has unknown target path", channel_index);
-				continue;
-			}
+		try
+		{
+			job_system.wait(stream.decode_jobs[image_index]);
+		}
+		catch (const std::exception &e)
+		{
+			// Textures using the image keep sampling the placeholder
+			LOGE("Failed to load gltf image #{} ({}): {}", image_index, model.images[image_index].uri.c_str(), e.what());
+			stream.states[image_index] = ImageStream::State::Failed;
+			continue;
+		}
 
-			float start_time{std::numeric_limits<float>::max()};
-			float end_time{std::numeric_limits<float>::min()};
+		auto &image = *stream.images[image_index];
 
-			for (auto input : samplers[gltf_channel.sampler].inputs)
-			{
-				if (input < start_time)
-				{
-					start_time = input;
-				}
-				if (input > end_time)
-				{
-					end_time = input;
-				}
-			}
+		if (stream.needs_srgb[image_index])
+		{
+			image.coerce_format_to_srgb();
+		}
 
-			animation->update_times(start_time, end_time);
+		image.create_vk_image(device, VK_IMAGE_VIEW_TYPE_2D, 0, true);
 
-			animation->add_channel(*nodes[gltf_channel.target_node], target, samplers[gltf_channel.sampler]);
+		if (!command_buffer)
+		{
+			command_buffer = &stream.transfer_command_pool->request_command_buffer();
+			command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 		}
 
-		animations.push_back(std::move(animation));
-	}
+		auto &stage_buffer = *stream.staging_buffers[image_index];
 
-	scene.set_components(std::move(animations));
+		batch_size += stage_buffer.get_size();
 
-	// Load scenes
-	std::queue<std::pair<sg::Node &, int>> traverse_nodes;
+		upload_image_to_gpu(*command_buffer, stage_buffer, image, stream.transfer_queue_family, stream.graphics_queue_family);
 
-	tinygltf::Scene *gltf_scene{nullptr};
+		// Otherwise the mip chain is generated by acquire_image_batch()
+		if (image.needs_mip_generation() && stream.transfer_queue_family == stream.graphics_queue_family)
+		{
+			get_mip_generator().generate(*command_buffer, image.get_vk_image_view());
+		}
 
-	if (scene_index >= 0 && scene_index < static_cast<int>(model.scenes.size()))
-	{
-		gltf_scene = &model.scenes[scene_index];
-	}
-	else if (model.defaultScene >= 0 && model.defaultScene < static_cast<int>(model.scenes.size()))
-	{
-		gltf_scene = &model.scenes[model.defaultScene];
-	}
-	else if (model.scenes.size() > 0)
-	{
-		gltf_scene = &model.scenes[0];
+		stream.batch.push_back(image_index);
+		stream.states[image_index] = ImageStream::State::Uploading;
 	}
 
-	if (!gltf_scene)
+	if (!command_buffer)
 	{
-		throw std::runtime_error("Couldn't determine which scene to load!");
+		return;
 	}
 
-	auto root_node = std::make_unique<sg::Node>(0, gltf_scene->name);
+	command_buffer->end();
 
-	for (auto node_index : gltf_scene->nodes)
+	auto &queue = device.get_queue(stream.transfer_queue_family, 0);
+
+	queue.submit(*command_buffer, stream.fence_pool->request_fence());
+}
+
+void GLTFLoader::acquire_image_batch()
+{
+	auto &stream = *image_stream;
+
+	// The transfer is complete
+	for (auto image_index : stream.batch)
 	{
-		traverse_nodes.push(std::make_pair(std::ref(*root_node), node_index));
+		stream.staging_buffers[image_index].reset();
 	}
+	stream.transfer_command_pool->reset_pool();
 
-	while (!traverse_nodes.empty())
-	{
-		auto node_it = traverse_nodes.front();
-		traverse_nodes.pop();
+	auto &command_buffer = stream.graphics_command_pool->request_command_buffer();
 
-		assert(node_it.second < nodes.size());
-		auto &current_node       = *nodes[node_it.second];
-		auto &traverse_root_node = node_it.first;
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
-		current_node.set_parent(traverse_root_node);
-		traverse_root_node.add_child(current_node);
+	for (auto image_index : stream.batch)
+	{
+		auto &image = *stream.images[image_index];
 
-		for (auto child_node_index : model.nodes[node_it.second].children)
+		acquire_image(command_buffer, image, stream.transfer_queue_family, stream.graphics_queue_family);
+
+		if (image.needs_mip_generation())
 		{
-			traverse_nodes.push(std::make_pair(std::ref(current_node), child_node_index));
+			get_mip_generator().generate(command_buffer, image.get_vk_image_view());
 		}
 	}
 
-	scene.set_root_node(*root_node);
-	nodes.push_back(std::move(root_node));
+	command_buffer.end();
 
-	// Store nodes into the scene
-	scene.set_nodes(std::move(nodes));
+	auto &queue = device.get_suitable_graphics_queue();
 
-	// Create node for the default camera
-	auto camera_node = std::make_unique<sg::Node>(-1, "default_camera");
+	queue.submit(command_buffer, stream.fence_pool->request_fence());
 
-	auto default_camera = create_default_camera();
-	default_camera->set_node(*camera_node);
-	camera_node->set_component(*default_camera);
-	scene.add_component(std::move(default_camera));
+	stream.acquiring = true;
+}
 
-	scene.get_root_node().add_child(*camera_node);
-	scene.add_node(std::move(camera_node));
+void GLTFLoader::complete_image_batch()
+{
+	auto &stream = *image_stream;
 
-	if (!scene.has_component<vkb::sg::Light>())
+	for (auto image_index : stream.batch)
 	{
-		// Add a default light if none are present
-		vkb::add_directional_light(scene, glm::quat({glm::radians(-90.0f), 0.0f, glm::radians(30.0f)}));
+		auto &image = stream.images[image_index];
+
+		for (auto texture : stream.textures[image_index])
+		{
+			texture->set_image(*image);
+		}
+
+		stream.scene->add_component(std::move(image));
+		stream.staging_buffers[image_index].reset();
+		stream.states[image_index] = ImageStream::State::Resident;
 	}
 
-	return scene;
+	LOGD("Streamed in a batch of {} gltf images", stream.batch.size());
+
+	stream.batch.clear();
+	stream.transfer_command_pool->reset_pool();
+	if (stream.graphics_command_pool)
+	{
+		stream.graphics_command_pool->reset_pool();
+	}
+	stream.acquiring = false;
 }
 
 std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage_buffer)
 {
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::SceneGeometry};
+
 	auto submesh = std::make_unique<sg::SubMesh>();
 
 	std::vector<core::Buffer> transient_buffers;
@@ -1160,19 +2699,10 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 			aligned_vertex_data.push_back(vert);
 		}
 
-		core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(device, aligned_vertex_data);
-
-		core::Buffer buffer{device,
-		                    aligned_vertex_data.size() * sizeof(AlignedVertex),
-		                    VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-		                    VMA_MEMORY_USAGE_GPU_ONLY};
-
-		command_buffer.copy_buffer(stage_buffer, buffer, aligned_vertex_data.size() * sizeof(AlignedVertex));
+		core::Buffer buffer = create_static_buffer(device, command_buffer, aligned_vertex_data, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, transient_buffers);
 
 		auto pair = std::make_pair("vertex_buffer", std::move(buffer));
 		submesh->vertex_buffers.insert(std::move(pair));
-
-		transient_buffers.push_back(std::move(stage_buffer));
 	}
 	else
 	{
@@ -1188,19 +2718,10 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 			vertex_data.push_back(vert);
 		}
 
-		core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(device, vertex_data);
-
-		core::Buffer buffer{device,
-		                    vertex_data.size() * sizeof(Vertex),
-		                    VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-		                    VMA_MEMORY_USAGE_GPU_ONLY};
-
-		command_buffer.copy_buffer(stage_buffer, buffer, vertex_data.size() * sizeof(Vertex));
+		core::Buffer buffer = create_static_buffer(device, command_buffer, vertex_data, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, transient_buffers);
 
 		auto pair = std::make_pair("vertex_buffer", std::move(buffer));
 		submesh->vertex_buffers.insert(std::move(pair));
-
-		transient_buffers.push_back(std::move(stage_buffer));
 	}
 
 	if (gltf_primitive.indices >= 0)
@@ -1245,29 +2766,13 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 			// vertex_indices and index_buffer are used for meshlets now
 			submesh->vertex_indices = static_cast<uint32_t>(meshlets.size());
 
-			core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(device, meshlets);
-
-			submesh->index_buffer = std::make_unique<core::Buffer>(device,
-			                                                       meshlets.size() * sizeof(Meshlet),
-			                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-			                                                       VMA_MEMORY_USAGE_GPU_ONLY);
-
-			command_buffer.copy_buffer(stage_buffer, *submesh->index_buffer, meshlets.size() * sizeof(Meshlet));
-
-			transient_buffers.push_back(std::move(stage_buffer));
+			submesh->index_buffer = std::make_unique<core::Buffer>(
+			    create_static_buffer(device, command_buffer, meshlets, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, transient_buffers));
 		}
 		else
 		{
-			core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(device, index_data);
-
-			submesh->index_buffer = std::make_unique<core::Buffer>(device,
-			                                                       index_data.size(),
-			                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-			                                                       VMA_MEMORY_USAGE_GPU_ONLY);
-
-			command_buffer.copy_buffer(stage_buffer, *submesh->index_buffer, index_data.size());
-
-			transient_buffers.push_back(std::move(stage_buffer));
+			submesh->index_buffer = std::make_unique<core::Buffer>(
+			    create_static_buffer(device, command_buffer, index_data, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, transient_buffers));
 		}
 	}
 
@@ -1412,7 +2917,182 @@ std::unique_ptr<sg::PBRMaterial> GLTFLoader::parse_material(const tinygltf::Mate
 	return material;
 }
 
-std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image) const
+std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image, filesystem::MappedFilePtr file) const
+{
+	auto image = decode_image(gltf_image, std::move(file));
+
+	// Packed images are copied to their texture array
+	image->create_vk_image(device, VK_IMAGE_VIEW_TYPE_2D, 0, true, is_packable(*image) ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+
+	return image;
+}
+
+bool GLTFLoader::is_packable(const sg::Image &image) const
+{
+	auto &extent = image.get_extent();
+
+	return texture_arrays && image.get_layers() == 1 && extent.depth == 1 &&
+	       extent.width <= max_texture_array_extent && extent.height <= max_texture_array_extent;
+}
+
+void GLTFLoader::pack_texture_arrays(std::vector<std::unique_ptr<sg::Image>> &images, const std::vector<bool> &loaded)
+{
+	// Images of the same format, extent, levels and swizzle, by the first of them
+	std::vector<std::vector<sg::Image *>> groups;
+
+	auto is_same_array = [](const sg::Image &a, const sg::Image &b) {
+		auto &a_image      = a.get_vk_image();
+		auto &b_image      = b.get_vk_image();
+		auto &a_components = a.get_components();
+		auto &b_components = b.get_components();
+
+		return a_image.get_format() == b_image.get_format() &&
+		       a_image.get_extent().width == b_image.get_extent().width && a_image.get_extent().height == b_image.get_extent().height &&
+		       a_image.get_subresource().mipLevel == b_image.get_subresource().mipLevel &&
+		       a_components.r == b_components.r && a_components.g == b_components.g &&
+		       a_components.b == b_components.b && a_components.a == b_components.a;
+	};
+
+	uint32_t max_layers = device.get_gpu().get_properties().limits.maxImageArrayLayers;
+
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		auto &image = *images[i];
+
+		// The images which are not packable were created without the transfer source usage
+		if (!loaded[i] || !is_packable(image) || !(image.get_vk_image().get_usage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+		{
+			continue;
+		}
+
+		auto group_it = std::find_if(groups.begin(), groups.end(), [&](const std::vector<sg::Image *> &group) {
+			return group.size() < max_layers && is_same_array(*group.front(), image);
+		});
+
+		if (group_it == groups.end())
+		{
+			groups.emplace_back();
+			group_it = std::prev(groups.end());
+		}
+
+		group_it->push_back(&image);
+	}
+
+	groups.erase(std::remove_if(groups.begin(), groups.end(), [](const std::vector<sg::Image *> &group) { return group.size() < 2; }), groups.end());
+
+	if (groups.empty())
+	{
+		return;
+	}
+
+	std::vector<std::shared_ptr<core::Image>>     arrays;
+	std::vector<std::shared_ptr<core::ImageView>> array_views;
+
+	CommandPool command_pool{device, device.get_suitable_graphics_queue().get_family_index()};
+	FencePool   fence_pool{device};
+
+	auto &command_buffer = command_pool.request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+	size_t packed_count = 0;
+
+	for (auto &group : groups)
+	{
+		auto &first_image = group.front()->get_vk_image();
+		auto  mip_levels  = first_image.get_subresource().mipLevel;
+
+		auto array = std::make_shared<core::Image>(device, core::ImageBuilder{first_image.get_extent()}
+		                                                       .with_format(first_image.get_format())
+		                                                       .with_usage(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+		                                                       .with_mip_levels(mip_levels)
+		                                                       .with_array_layers(to_u32(group.size()))
+		                                                       .with_vma_usage(VMA_MEMORY_USAGE_GPU_ONLY)
+		                                                       .with_memory_tag(allocated::MemoryTag::SceneTexture)
+		                                                       .with_debug_name("Texture array of " + group.front()->get_name()));
+
+		auto array_view = std::make_shared<core::ImageView>(*array, VK_IMAGE_VIEW_TYPE_2D_ARRAY, VK_FORMAT_UNDEFINED, 0, 0, 0, 0, group.front()->get_components());
+
+		{
+			ImageMemoryBarrier memory_barrier{};
+			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			memory_barrier.src_access_mask = 0;
+			memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+			command_buffer.image_memory_barrier(*array_view, memory_barrier);
+		}
+
+		for (uint32_t layer = 0; layer < group.size(); layer++)
+		{
+			auto &image = *group[layer];
+
+			// The uploads were waited for, and left the images ready for sampling
+			ImageMemoryBarrier memory_barrier{};
+			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			memory_barrier.src_access_mask = 0;
+			memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_READ_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+			command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+
+			std::vector<VkImageCopy> copy_regions(mip_levels);
+
+			for (uint32_t level = 0; level < mip_levels; level++)
+			{
+				auto &copy_region = copy_regions[level];
+
+				copy_region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+				copy_region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1};
+				copy_region.extent         = {std::max(first_image.get_extent().width >> level, 1u),
+				                              std::max(first_image.get_extent().height >> level, 1u),
+				                              1u};
+			}
+
+			command_buffer.copy_image(image.get_vk_image(), *array, copy_regions);
+		}
+
+		{
+			ImageMemoryBarrier memory_barrier{};
+			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+			command_buffer.image_memory_barrier(*array_view, memory_barrier);
+		}
+
+		arrays.push_back(std::move(array));
+		array_views.push_back(std::move(array_view));
+
+		packed_count += group.size();
+	}
+
+	command_buffer.end();
+
+	device.get_suitable_graphics_queue().submit(command_buffer, fence_pool.request_fence());
+
+	fence_pool.wait();
+
+	// The images release their own Vulkan image now that it was copied
+	for (size_t group_index = 0; group_index < groups.size(); group_index++)
+	{
+		for (uint32_t layer = 0; layer < groups[group_index].size(); layer++)
+		{
+			groups[group_index][layer]->set_array_layer(arrays[group_index], array_views[group_index], layer);
+		}
+	}
+
+	LOGI("Packed {} images in {} texture arrays", packed_count, groups.size());
+}
+
+std::unique_ptr<sg::Image> GLTFLoader::decode_image(tinygltf::Image &gltf_image, filesystem::MappedFilePtr file) const
 {
 	std::unique_ptr<sg::Image> image{nullptr};
 
@@ -1430,9 +3110,13 @@ std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image)
 	}
 	else
 	{
-		// Load image from uri
+		// Load image from uri, unless its file was read ahead
 		auto image_uri = model_path + "/" + gltf_image.uri;
-		image          = sg::Image::load(gltf_image.name, image_uri, vkb::sg::Image::Unknown);
+		if (!file)
+		{
+			file = fs::map_asset(image_uri);
+		}
+		image = sg::Image::load(gltf_image.name, image_uri, std::move(file), vkb::sg::Image::Unknown, true);
 	}
 
 	// Check whether the format is supported by the GPU
@@ -1441,13 +3125,12 @@ std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image)
 		if (!device.is_image_format_supported(image->get_format()))
 		{
 			LOGW("ASTC not supported: decoding {}", image->get_name());
+			image->resolve_payload();
 			image = std::make_unique<sg::Astc>(*image);
 			image->generate_mipmaps();
 		}
 	}
 
-	image->create_vk_image(device);
-
 	return image;
 }
 
@@ -1475,10 +3158,10 @@ std::unique_ptr<sg::Sampler> GLTFLoader::parse_sampler(const tinygltf::Sampler &
 	sampler_info.borderColor  = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
 	sampler_info.maxLod       = std::numeric_limits<float>::max();
 
-	core::Sampler vk_sampler{device, sampler_info};
-	vk_sampler.set_debug_name(gltf_sampler.name);
+	// Shared with the samplers of the same state in other scenes, so it is not named after this one
+	auto &vk_sampler = device.get_resource_cache().request_sampler(sampler_info);
 
-	return std::make_unique<sg::Sampler>(name, std::move(vk_sampler));
+	return std::make_unique<sg::Sampler>(name, vk_sampler);
 }
 
 std::unique_ptr<sg::Texture> GLTFLoader::parse_texture(const tinygltf::Texture &gltf_texture) const
@@ -1642,6 +3325,74 @@ bool GLTFLoader::is_extension_enabled(const std::string &requested_extension)
 	}
 }
 
+std::unique_ptr<sg::LodGroup> GLTFLoader::parse_lod_group(tinygltf::Node &gltf_node, sg::Mesh &mesh, const std::vector<sg::Mesh *> &meshes)
+{
+	std::vector<std::pair<sg::Mesh *, uint32_t>> levels{{&mesh, 0}};
+
+	std::vector<float> screen_sizes;
+
+	if (auto extension = get_extension(gltf_node.extensions, MSFT_LOD_EXTENSION))
+	{
+		auto &ids = extension->Get("ids");
+		for (size_t i = 0; i < ids.ArrayLen(); ++i)
+		{
+			int id = ids.Get(static_cast<int>(i)).Get<int>();
+
+			// A level without a mesh draws nothing, so the previous level is the coarsest one
+			if (id < 0 || id >= static_cast<int>(model.nodes.size()) || model.nodes[id].mesh < 0)
+			{
+				break;
+			}
+
+			assert(model.nodes[id].mesh < meshes.size());
+			levels.emplace_back(meshes[model.nodes[id].mesh], 0);
+		}
+
+		if (gltf_node.extras.Has("MSFT_screencoverage"))
+		{
+			auto &coverages = gltf_node.extras.Get("MSFT_screencoverage");
+			for (size_t i = 0; i < coverages.ArrayLen(); ++i)
+			{
+				screen_sizes.push_back(std::sqrt(static_cast<float>(coverages.Get(static_cast<int>(i)).Get<double>())));
+			}
+		}
+	}
+	else
+	{
+		size_t lod_count = 0;
+		for (auto sub_mesh : mesh.get_submeshes())
+		{
+			lod_count = std::max(lod_count, sub_mesh->lods.size());
+		}
+
+		for (uint32_t lod = 1; lod <= lod_count; ++lod)
+		{
+			levels.emplace_back(&mesh, lod);
+		}
+	}
+
+	if (levels.size() < 2)
+	{
+		return nullptr;
+	}
+
+	auto lod_group = std::make_unique<sg::LodGroup>(gltf_node.name);
+
+	float screen_size = std::numeric_limits<float>::max();
+
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		// Without a screen coverage the coarsest level is always drawn
+		float default_screen_size = i + 1 < levels.size() ? DEFAULT_LOD_SCREEN_SIZE / static_cast<float>(1u << std::min<size_t>(i, 16)) : 0.0f;
+
+		screen_size = std::min(screen_size, i < screen_sizes.size() ? screen_sizes[i] : default_screen_size);
+
+		lod_group->add_level(*levels[i].first, levels[i].second, screen_size);
+	}
+
+	return lod_group;
+}
+
 tinygltf::Value *GLTFLoader::get_extension(tinygltf::ExtensionMap &tinygltf_extensions, const std::string &extension)
 {
 	auto it = tinygltf_extensions.find(extension);
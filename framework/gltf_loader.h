@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <mutex>
 
@@ -26,19 +27,23 @@
 #define TINYGLTF_NO_EXTERNAL_IMAGE
 #include <tiny_gltf.h>
 
+#include "filesystem/filesystem.hpp"
 #include "timer.h"
 
 #define KHR_LIGHTS_PUNCTUAL_EXTENSION "KHR_lights_punctual"
+#define MSFT_LOD_EXTENSION "MSFT_lod"
 
 namespace vkb
 {
 class Device;
+class MipGenerator;
 
 namespace sg
 {
 class Camera;
 class Image;
 class Light;
+class LodGroup;
 class Mesh;
 class Node;
 class PBRMaterial;
@@ -46,6 +51,7 @@ class Sampler;
 class Scene;
 class SubMesh;
 class Texture;
+struct VertexAttribute;
 }        // namespace sg
 
 /**
@@ -63,18 +69,149 @@ struct TypeCast
 	}
 };
 
+/**
+ * @brief How GLTFLoader stores the float vertex attributes, see GLTFLoader::set_vertex_quantization()
+ */
+enum class VertexQuantization
+{
+	/// Attributes keep the formats of their glTF accessors
+	None,
+
+	/// Normals and tangents are 16-bit signed normalized, texture coordinates half floats, shaders read them unchanged
+	Normalized,
+
+	/// As Normalized, with positions 16-bit unsigned normalized in the bounds of their mesh, and octahedral normals
+	/// and tangents, which shaders decode with vertex_compression.h
+	Compressed
+};
+
 /// Read a gltf file and return a scene object. Converts the gltf objects
 /// to our internal scene implementation. Mesh data is copied to vulkan buffers and
 /// images are loaded from the folder of gltf file to vulkan images.
 class GLTFLoader
 {
   public:
+	static constexpr size_t DEFAULT_PACKED_BUFFER_SIZE{64 * 1024 * 1024};
+
+	/// Largest width and height of the textures packed by default, see set_texture_arrays()
+	static constexpr uint32_t DEFAULT_MAX_TEXTURE_ARRAY_EXTENT{512};
+
 	GLTFLoader(Device &device);
 
-	virtual ~GLTFLoader() = default;
+	/**
+	 * @brief Waits for the images still streaming in, if any
+	 */
+	virtual ~GLTFLoader();
+
+	/**
+	 * @brief Makes the scenes read afterwards pack the vertex and index data of all their submeshes into a few shared buffers,
+	 *        instead of allocating buffers per submesh and attribute
+	 *        Packed submeshes have no vertex_buffers nor index_buffer, their data is found with SubMesh::get_vertex_buffer()
+	 *        and SubMesh::get_index_buffer(), at their vertex_offset and first_index. Submeshes with the same vertex layout
+	 *        share the same bindings, so they can be drawn without rebinding buffers, or merged into multi draws.
+	 * @param pack Whether to pack the geometry, disabled by default
+	 * @param max_buffer_size Size above which the data is split in more buffers, unless a single submesh needs more
+	 */
+	void set_pack_geometry(bool pack, size_t max_buffer_size = DEFAULT_PACKED_BUFFER_SIZE);
+
+	/**
+	 * @brief Makes the scenes read afterwards create their vertex and index buffers with device addresses, usable as
+	 *        acceleration structure build inputs, see RayTracingScene
+	 *        Requires the bufferDeviceAddress feature and VK_KHR_acceleration_structure.
+	 * @param enable Whether the geometry is ray traced, disabled by default
+	 */
+	void set_ray_tracing_geometry(bool enable);
+
+	/**
+	 * @brief Makes the scenes read afterwards build the meshlets of their triangle list submeshes, and create their
+	 *        vertex and index buffers as storage buffers, for a MeshletSubpass to draw them with mesh shaders
+	 *        Only the submeshes with R32G32B32_SFLOAT positions get meshlets, see SubMesh::meshlets.
+	 * @param enable Whether the geometry is drawn as meshlets, disabled by default
+	 */
+	void set_meshlet_geometry(bool enable);
+
+	/**
+	 * @brief Makes the scenes read afterwards keep the texels of their images on the CPU, without creating their Vulkan
+	 *        images, for a MipStreamer to add them
+	 *        Not supported by read_scene_from_file_async().
+	 * @param enable Whether the textures are streamed, disabled by default
+	 */
+	void set_streamed_textures(bool enable);
+
+	/**
+	 * @brief Makes the scenes read afterwards pack their small images of the same format, extent, levels and swizzle into
+	 *        the layers of 2D array images, so that they share one allocation instead of each being aligned on its own
+	 *        The views of packed images only see their layer, so they are sampled as before. Bindless materials bind one
+	 *        descriptor per array instead of per texture, and select the layer in the push constants, see
+	 *        GeometrySubpass::set_bindless_materials(). The images are copied into the arrays on the GPU once uploaded.
+	 *        Only read_scene_from_file() packs images, and not the ones shared with a previous scene, see TextureRegistry.
+	 * @param enable Whether to pack the images, disabled by default
+	 * @param max_extent Largest width and height of the images to pack
+	 */
+	void set_texture_arrays(bool enable, uint32_t max_extent = DEFAULT_MAX_TEXTURE_ARRAY_EXTENT);
+
+	/**
+	 * @brief Makes the scenes read afterwards store their float vertex attributes in 16-bit formats, halving the memory
+	 *        and vertex fetch bandwidth they need
+	 *        Attributes are kept as they are if the GPU cannot fetch the 16-bit formats from vertex buffers, or if the
+	 *        geometry is drawn as meshlets, see set_meshlet_geometry(). Compressed positions are also kept for ray tracing.
+	 *        Compressed submeshes set the specialization constants of sg::SubMeshSpecializationConstant in their shader
+	 *        variant, which base.vert and deferred/geometry.vert support, with the position box of their
+	 *        mesh in the GlobalUniform, see sg::Mesh::get_position_offset().
+	 * @param quantization How the attributes are stored, VertexQuantization::None by default
+	 */
+	void set_vertex_quantization(VertexQuantization quantization);
+
+	/**
+	 * @brief Makes the scenes read afterwards optimize their indexed triangle list submeshes, see optimize_mesh()
+	 *        The triangles are reordered for the post-transform vertex cache, then by clusters to lower overdraw, and the
+	 *        vertices are renumbered in the order they are fetched. Simplified levels of detail are appended to the
+	 *        index data of each submesh, see SubMesh::lods, and the nodes drawing the meshes get a sg::LodGroup of them
+	 *        unless they have levels of detail from the MSFT_lod extension.
+	 * @param enable Whether to optimize the meshes, disabled by default
+	 * @param lod_count Maximum number of simplified levels of detail per submesh
+	 */
+	void set_mesh_optimization(bool enable, uint32_t lod_count = 0);
+
+	/**
+	 * @brief Makes the scenes read afterwards also pack the vertices of their submeshes into one storage buffer, which
+	 *        vertex shaders read at gl_VertexIndex instead of fetching vertex attributes, see SubMesh::pulled_vertex_buffer
+	 *        Each vertex is five words: the float position, the texture coordinates as two half floats and the octahedral
+	 *        normal as two 16-bit signed normalized values, 20 bytes instead of the 32 bytes of the float attributes.
+	 *        Only the submeshes with float positions, normals and texture coordinates are packed, skinned ones are not.
+	 *        The attributes are not quantized, see set_vertex_quantization(), as the packed vertices have their own compression.
+	 * @param enable Whether to pack the vertices for vertex pulling, disabled by default
+	 */
+	void set_vertex_pulling(bool enable);
 
+	/**
+	 * @brief Reads a scene, blocking until its images are resident
+	 *        Images of the same content share one Vulkan image, within the scene and with the scenes previously read on the
+	 *        device, so that they are only decoded and uploaded once, see TextureRegistry. Images streamed with
+	 *        set_streamed_textures() or read_scene_from_file_async() are not shared.
+	 */
 	std::unique_ptr<sg::Scene> read_scene_from_file(const std::string &file_name, int scene_index = -1);
 
+	/**
+	 * @brief Reads a scene without waiting for its images, which are decoded on the job system and
+	 *        streamed in by update_streaming(). Until an image is resident, the textures using it sample a placeholder.
+	 *        The loader and the scene must outlive the streaming, and only one scene can stream at a time.
+	 */
+	std::unique_ptr<sg::Scene> read_scene_from_file_async(const std::string &file_name, int scene_index = -1);
+
+	/**
+	 * @brief Makes progress on the images streaming in, without blocking
+	 *        Decoded images are uploaded in batches on a transfer queue, and the textures using them switch from
+	 *        the placeholder once their batch is complete. Call it from the thread recording the frames, e.g. once per update.
+	 * @return True once every image of the scene is resident, or failed to load
+	 */
+	bool update_streaming();
+
+	/**
+	 * @return Whether the image of the glTF file at the given index has been uploaded and is used by its textures
+	 */
+	bool is_image_resident(size_t image_index) const;
+
 	/**
 	 * @brief Loads the first model from a GLTF file for use in simpler samples
 	 *        makes use of the Vertex struct in vulkan_example_base.h
@@ -90,7 +227,10 @@ class GLTFLoader
 
 	virtual std::unique_ptr<sg::PBRMaterial> parse_material(const tinygltf::Material &gltf_material) const;
 
-	virtual std::unique_ptr<sg::Image> parse_image(tinygltf::Image &gltf_image) const;
+	/**
+	 * @param file The contents of the image file if it was read ahead, otherwise the image maps its file
+	 */
+	virtual std::unique_ptr<sg::Image> parse_image(tinygltf::Image &gltf_image, filesystem::MappedFilePtr file = nullptr) const;
 
 	virtual std::unique_ptr<sg::Sampler> parse_sampler(const tinygltf::Sampler &gltf_sampler) const;
 
@@ -102,6 +242,16 @@ class GLTFLoader
 
 	virtual std::unique_ptr<sg::Camera> create_default_camera();
 
+	/**
+	 * @brief Creates the levels of detail of a mesh node, from the lower level nodes of its MSFT_lod extension and their
+	 *        screen coverages, or from the simplified levels of its submeshes, see set_mesh_optimization()
+	 *        The screen coverages of the MSFT_screencoverage extras are fractions of the screen area, their square roots
+	 *        are used as screen sizes. Levels without one get a default screen size, halved at each level.
+	 * @param mesh The mesh of the node, drawn at full detail
+	 * @return The levels of detail, nullptr if the node has none
+	 */
+	std::unique_ptr<sg::LodGroup> parse_lod_group(tinygltf::Node &gltf_node, sg::Mesh &mesh, const std::vector<sg::Mesh *> &meshes);
+
 	/**
 	 * @brief Parses and returns a list of scene graph lights from the KHR_lights_punctual extension
 	 */
@@ -132,8 +282,141 @@ class GLTFLoader
 	static std::unordered_map<std::string, bool> supported_extensions;
 
   private:
+	struct ImageStream;
+
 	sg::Scene load_scene(int scene_index = -1);
 
+	/**
+	 * @brief Loads and uploads all the images of the model, blocking until they are resident
+	 */
+	void load_images(sg::Scene &scene);
+
+	/**
+	 * @return Whether an image is to be packed in a texture array once resident, see set_texture_arrays()
+	 */
+	bool is_packable(const sg::Image &image) const;
+
+	/**
+	 * @brief Copies the resident images of the same format, extent, levels and swizzle to the layers of texture arrays,
+	 *        and makes the images layers of them, see set_texture_arrays()
+	 * @param loaded Whether each image was loaded by this model, the others are shared and left as they are
+	 */
+	void pack_texture_arrays(std::vector<std::unique_ptr<sg::Image>> &images, const std::vector<bool> &loaded);
+
+	/**
+	 * @brief Decodes an image, without creating its Vulkan image
+	 * @param file The contents of the image file if it was read ahead, otherwise the image maps its file
+	 */
+	std::unique_ptr<sg::Image> decode_image(tinygltf::Image &gltf_image, filesystem::MappedFilePtr file = nullptr) const;
+
+	/**
+	 * @brief Starts decoding the images of the model on the job system
+	 * @return The resident placeholder the textures sample meanwhile
+	 */
+	std::unique_ptr<sg::Image> start_image_stream();
+
+	/**
+	 * @brief Submits the decoded images to the transfer queue, up to a batch size
+	 */
+	void submit_image_batch();
+
+	/**
+	 * @brief Acquires the images of a transferred batch on the graphics queue family, if it differs from the transfer one
+	 */
+	void acquire_image_batch();
+
+	/**
+	 * @brief Switches the textures of a completed batch to their images, and moves the images to the scene
+	 */
+	void complete_image_batch();
+
 	std::unique_ptr<sg::SubMesh> load_model(uint32_t index, bool storage_buffer = false);
+
+	/**
+	 * @return The generator of the mip chains of the images without mipmaps, created on first use
+	 */
+	MipGenerator &get_mip_generator();
+
+	/**
+	 * @brief Converts the data of a vertex attribute to a 16-bit format, see set_vertex_quantization()
+	 *        Leaves the attributes which are not float positions, normals, tangents or texture coordinates untouched.
+	 * @param mesh The mesh of the attribute, holding the box its positions are compressed in
+	 */
+	void quantize_vertex_attribute(const std::string &name, size_t count, std::vector<uint8_t> &data, sg::VertexAttribute &attribute, const sg::Mesh &mesh) const;
+
+	/**
+	 * @brief Optimizes the triangles and vertices of a submesh, see set_mesh_optimization()
+	 * @param attribute_data Data of each attribute, remapped in place
+	 * @param index_data Indices, replaced by the optimized ones, followed by the levels of detail
+	 * @param position_data Float positions, remapped in place
+	 * @param position_stride Distance between two positions, set to the size of a position
+	 */
+	void optimize_submesh(sg::SubMesh &submesh, std::map<std::string, std::vector<uint8_t>> &attribute_data, std::vector<uint8_t> &index_data,
+	                      std::vector<uint8_t> &position_data, size_t &position_stride) const;
+
+	/**
+	 * @brief Sets the box the positions of a mesh are compressed in, from the bounds of its primitives
+	 */
+	void set_position_quantization(const tinygltf::Model &model, const tinygltf::Mesh &gltf_mesh, sg::Mesh &mesh) const;
+
+	/**
+	 * @brief The submesh of a primitive with the data of its buffers, see read_primitive()
+	 */
+	struct PrimitiveData
+	{
+		std::unique_ptr<sg::SubMesh> submesh;
+
+		/// Data of each attribute, converted and optimized as set
+		std::map<std::string, std::vector<uint8_t>> attribute_data;
+
+		/// Indices of the index type of the submesh, empty if the primitive is not indexed
+		std::vector<uint8_t> index_data;
+	};
+
+	/**
+	 * @brief Reads the attributes and indices of a primitive, then converts and optimizes them and builds its meshlets as set
+	 *        Only reads the model and the mesh, so that the primitives are read concurrently. Creating the buffers of the
+	 *        submesh and setting its material is left to the caller.
+	 * @param mesh The mesh of the primitive, with its position quantization set
+	 * @param skinned Whether the mesh is deformed by a skin, otherwise its joints and weights are skipped
+	 */
+	PrimitiveData read_primitive(const tinygltf::Mesh &gltf_mesh, size_t primitive_index, const sg::Mesh &mesh, bool skinned) const;
+
+	/// Whether load_scene() streams the images instead of loading them, set by read_scene_from_file_async()
+	bool stream_images{false};
+
+	std::unique_ptr<ImageStream> image_stream;
+
+	/// Set by set_pack_geometry()
+	bool pack_geometry{false};
+
+	size_t packed_buffer_size{DEFAULT_PACKED_BUFFER_SIZE};
+
+	/// Usage added to the vertex and index buffers, set by set_ray_tracing_geometry() and set_meshlet_geometry()
+	VkBufferUsageFlags geometry_buffer_usage{0};
+
+	/// Set by set_meshlet_geometry()
+	bool meshlet_geometry{false};
+
+	/// Set by set_streamed_textures()
+	bool streamed_textures{false};
+
+	/// Set by set_texture_arrays()
+	bool texture_arrays{false};
+
+	uint32_t max_texture_array_extent{DEFAULT_MAX_TEXTURE_ARRAY_EXTENT};
+
+	/// Set by set_mesh_optimization()
+	bool mesh_optimization{false};
+
+	uint32_t mesh_lod_count{0};
+
+	/// Set by set_vertex_pulling()
+	bool vertex_pulling{false};
+
+	/// Set by set_vertex_quantization()
+	VertexQuantization vertex_quantization{VertexQuantization::None};
+
+	std::unique_ptr<MipGenerator> mip_generator;
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -18,12 +18,15 @@
 
 #include "gui.h"
 
+#include <cstring>
 #include <map>
 #include <numeric>
+#include <string_view>
 
 #include "common/error.h"
 
 #include "common/glm_common.h"
+#include "common/helpers.h"
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "buffer_pool.h"
@@ -35,7 +38,10 @@
 #include "core/pipeline.h"
 #include "core/pipeline_layout.h"
 #include "core/shader_module.h"
+#include "core/util/hash.hpp"
+#include "core/util/profiling.hpp"
 #include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
 #include "filesystem/legacy.h"
 #include "imgui_internal.h"
 #include "platform/window.h"
@@ -62,6 +68,292 @@ void upload_draw_data(const ImDrawData *draw_data, uint8_t *vertex_data, uint8_t
 	}
 }
 
+/**
+ * @return A hash of the vertices and indices of the draw data
+ */
+size_t hash_draw_data(const ImDrawData *draw_data)
+{
+	size_t hash = 0;
+
+	for (int n = 0; n < draw_data->CmdListsCount; n++)
+	{
+		const ImDrawList *cmd_list = draw_data->CmdLists[n];
+		hash_combine(hash, std::string_view{reinterpret_cast<const char *>(cmd_list->VtxBuffer.Data), cmd_list->VtxBuffer.Size * sizeof(ImDrawVert)});
+		hash_combine(hash, std::string_view{reinterpret_cast<const char *>(cmd_list->IdxBuffer.Data), cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx)});
+	}
+
+	return hash;
+}
+
+/**
+ * @return A hash of the draw commands of the draw data, which Gui::draw records along with the vertex offsets of the command lists
+ */
+size_t hash_draw_commands(const ImDrawData *draw_data)
+{
+	size_t hash = 0;
+
+	for (int n = 0; n < draw_data->CmdListsCount; n++)
+	{
+		const ImDrawList *cmd_list = draw_data->CmdLists[n];
+		hash_combine(hash, cmd_list->VtxBuffer.Size);
+
+		for (int i = 0; i < cmd_list->CmdBuffer.Size; i++)
+		{
+			const ImDrawCmd &cmd = cmd_list->CmdBuffer[i];
+			hash_combine(hash, cmd.ElemCount);
+			hash_combine(hash, cmd.ClipRect.x);
+			hash_combine(hash, cmd.ClipRect.y);
+			hash_combine(hash, cmd.ClipRect.z);
+			hash_combine(hash, cmd.ClipRect.w);
+		}
+	}
+
+	return hash;
+}
+
+/**
+ * @return The capacity grown geometrically until it holds the size, so that the buffers are not recreated as the draw data grows a little every frame
+ */
+size_t grow_capacity(size_t capacity, size_t size)
+{
+	capacity = std::max<size_t>(capacity, 4096);
+
+	while (capacity < size)
+	{
+		capacity *= 2;
+	}
+
+	return capacity;
+}
+
+// Bump the version whenever the entry layout changes
+constexpr uint32_t FONT_CACHE_MAGIC   = 0x544e4f46;        // "FONT"
+constexpr uint32_t FONT_CACHE_VERSION = 1;
+
+/**
+ * @brief Header of a font atlas cache entry
+ *        It is followed by a FontCacheUVs, then by a FontCacheFont and the glyphs of each font, then by the RGBA texels of the atlas.
+ */
+struct FontCacheHeader
+{
+	uint32_t magic;
+
+	uint32_t version;
+
+	/// The glyphs are stored as ImFontGlyph, whose layout depends on the version of ImGui
+	uint32_t imgui_version;
+
+	uint32_t font_count;
+
+	uint32_t width;
+
+	uint32_t height;
+};
+
+/**
+ * @brief Texture coordinates of the atlas regions which ImGui draws shapes from
+ */
+struct FontCacheUVs
+{
+	ImVec2 white_pixel;
+
+	ImVec4 lines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];
+};
+
+struct FontCacheFont
+{
+	float size;
+
+	float ascent;
+
+	float descent;
+
+	uint32_t glyph_count;
+};
+
+inline filesystem::Path get_font_cache_directory()
+{
+	return filesystem::get()->temp_directory() / "vulkan_samples" / "font_cache";
+}
+
+/**
+ * @return The path of the cache entry of the fonts, keyed by the contents of their files and their sizes, which are scaled by DPI
+ */
+filesystem::Path get_font_cache_entry_path(const std::vector<Font> &fonts, const ImFontAtlas &atlas)
+{
+	Hash128 key;
+
+	for (auto &font : fonts)
+	{
+		hash_combine(key, font.data);
+		hash_combine(key, font.size);
+	}
+
+	hash_combine(key, atlas.Flags);
+	hash_combine(key, atlas.TexDesiredWidth);
+	hash_combine(key, atlas.TexGlyphPadding);
+
+	return get_font_cache_directory() / fmt::format("{:016x}{:016x}.font", key.high, key.low);
+}
+
+/**
+ * @brief Restores the glyphs and the texels of the atlas from a previous build of the same fonts, so that they are not rasterized again
+ *        The fonts must have been added to the atlas, which must not be built yet. The atlas is left untouched if the entry is not valid.
+ */
+bool load_font_atlas(const filesystem::Path &path, ImFontAtlas &atlas)
+{
+	// The fonts are set up as ImFontAtlasBuildSetupFont does, which expects a config per font
+	if (atlas.ConfigData.Size != atlas.Fonts.Size)
+	{
+		return false;
+	}
+
+	FontCacheHeader                       header;
+	FontCacheUVs                          uvs;
+	std::vector<FontCacheFont>            font_metrics;
+	std::vector<std::vector<ImFontGlyph>> font_glyphs;
+	filesystem::MappedFilePtr             file;
+	const uint8_t                        *texels = nullptr;
+
+	try
+	{
+		auto fs = filesystem::get();
+
+		if (!fs->is_file(path))
+		{
+			return false;
+		}
+
+		file = fs->map_file(path);
+
+		size_t offset = 0;
+
+		auto read = [&file, &offset](size_t size) {
+			if (offset + size > file->size())
+			{
+				throw std::runtime_error{"the entry is truncated"};
+			}
+			auto data = file->data() + offset;
+			offset += size;
+			return data;
+		};
+
+		std::memcpy(&header, read(sizeof(header)), sizeof(header));
+
+		if (header.magic != FONT_CACHE_MAGIC || header.version != FONT_CACHE_VERSION ||
+		    header.imgui_version != IMGUI_VERSION_NUM || header.font_count != to_u32(atlas.Fonts.Size))
+		{
+			LOGW("Discarding stale font cache entry {}", path.string());
+			return false;
+		}
+
+		std::memcpy(&uvs, read(sizeof(uvs)), sizeof(uvs));
+
+		font_metrics.resize(header.font_count);
+		font_glyphs.resize(header.font_count);
+		for (uint32_t i = 0; i < header.font_count; ++i)
+		{
+			std::memcpy(&font_metrics[i], read(sizeof(FontCacheFont)), sizeof(FontCacheFont));
+
+			font_glyphs[i].resize(font_metrics[i].glyph_count);
+			std::memcpy(font_glyphs[i].data(), read(font_glyphs[i].size() * sizeof(ImFontGlyph)), font_glyphs[i].size() * sizeof(ImFontGlyph));
+		}
+
+		texels = read(static_cast<size_t>(header.width) * header.height * 4);
+
+		if (offset != file->size())
+		{
+			throw std::runtime_error{"the entry has trailing data"};
+		}
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read font cache entry {}: {}", path.string(), e.what());
+		return false;
+	}
+
+	for (int i = 0; i < atlas.Fonts.Size; ++i)
+	{
+		ImFont *font          = atlas.Fonts[i];
+		font->FontSize        = font_metrics[i].size;
+		font->ConfigData      = &atlas.ConfigData[i];
+		font->ConfigDataCount = 1;
+		font->ContainerAtlas  = &atlas;
+		font->Ascent          = font_metrics[i].ascent;
+		font->Descent         = font_metrics[i].descent;
+
+		font->Glyphs.resize(static_cast<int>(font_glyphs[i].size()));
+		std::memcpy(font->Glyphs.Data, font_glyphs[i].data(), font_glyphs[i].size() * sizeof(ImFontGlyph));
+		font->BuildLookupTable();
+	}
+
+	size_t texel_size = static_cast<size_t>(header.width) * header.height * 4;
+
+	atlas.TexWidth        = static_cast<int>(header.width);
+	atlas.TexHeight       = static_cast<int>(header.height);
+	atlas.TexUvScale      = ImVec2(1.0f / atlas.TexWidth, 1.0f / atlas.TexHeight);
+	atlas.TexUvWhitePixel = uvs.white_pixel;
+	std::memcpy(atlas.TexUvLines, uvs.lines, sizeof(uvs.lines));
+	atlas.TexPixelsRGBA32 = static_cast<unsigned int *>(IM_ALLOC(texel_size));
+	std::memcpy(atlas.TexPixelsRGBA32, texels, texel_size);
+#if IMGUI_VERSION_NUM >= 18700
+	atlas.TexReady = true;
+#endif
+
+	return true;
+}
+
+/**
+ * @brief Writes the glyphs and the RGBA texels of a built atlas to a cache entry
+ */
+void store_font_atlas(const filesystem::Path &path, const ImFontAtlas &atlas)
+{
+	FontCacheHeader header{FONT_CACHE_MAGIC, FONT_CACHE_VERSION, IMGUI_VERSION_NUM, to_u32(atlas.Fonts.Size), to_u32(atlas.TexWidth), to_u32(atlas.TexHeight)};
+
+	FontCacheUVs uvs;
+	uvs.white_pixel = atlas.TexUvWhitePixel;
+	std::memcpy(uvs.lines, atlas.TexUvLines, sizeof(uvs.lines));
+
+	std::vector<uint8_t> data;
+
+	auto write = [&data](const void *bytes, size_t size) {
+		auto first = static_cast<const uint8_t *>(bytes);
+		data.insert(data.end(), first, first + size);
+	};
+
+	write(&header, sizeof(header));
+	write(&uvs, sizeof(uvs));
+
+	for (ImFont *font : atlas.Fonts)
+	{
+		FontCacheFont font_metrics{font->FontSize, font->Ascent, font->Descent, to_u32(font->Glyphs.Size)};
+		write(&font_metrics, sizeof(font_metrics));
+		write(font->Glyphs.Data, font->Glyphs.Size * sizeof(ImFontGlyph));
+	}
+
+	write(atlas.TexPixelsRGBA32, static_cast<size_t>(header.width) * header.height * 4);
+
+	try
+	{
+		auto fs        = filesystem::get();
+		auto directory = get_font_cache_directory();
+		if (!fs->is_directory(directory.parent_path()))
+		{
+			fs->create_directory(directory.parent_path());
+		}
+		if (!fs->is_directory(directory))
+		{
+			fs->create_directory(directory);
+		}
+
+		fs->write_file_atomic(path, data);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write font cache entry: {}", e.what());
+	}
+}
+
 inline void reset_graph_max_value(StatGraphData &graph_data)
 {
 	// If it does not have a fixed max
@@ -75,6 +367,8 @@ inline void reset_graph_max_value(StatGraphData &graph_data)
 
 bool Gui::visible = true;
 
+bool Gui::retained = false;
+
 const double Gui::press_time_ms = 200.0f;
 
 const float Gui::overlay_alpha = 0.3f;
@@ -153,12 +447,21 @@ Gui::Gui(VulkanSample<vkb::BindingType::C> &sample_, const Window &window, const
 	// Debug window font
 	fonts.emplace_back("RobotoMono-Regular", (font_size / 2) * dpi_factor);
 
+	// Restore the atlas of a previous run, or rasterize the fonts and cache the atlas for the next one
+	auto font_cache_path   = get_font_cache_entry_path(fonts, *io.Fonts);
+	bool font_atlas_cached = load_font_atlas(font_cache_path, *io.Fonts);
+
 	// Create font texture
 	unsigned char *font_data;
 	int            tex_width, tex_height;
 	io.Fonts->GetTexDataAsRGBA32(&font_data, &tex_width, &tex_height);
 	size_t upload_size = tex_width * tex_height * 4 * sizeof(char);
 
+	if (!font_atlas_cached)
+	{
+		store_font_atlas(font_cache_path, *io.Fonts);
+	}
+
 	auto &device = sample.get_render_context().get_device();
 
 	// Create target image for copy
@@ -172,62 +475,18 @@ Gui::Gui(VulkanSample<vkb::BindingType::C> &sample_, const Window &window, const
 	font_image_view = std::make_unique<core::ImageView>(*font_image, VK_IMAGE_VIEW_TYPE_2D);
 	font_image_view->set_debug_name("View on GUI font image");
 
-	// Upload font data into the vulkan image memory
+	// Upload font data on the transfer queue without waiting, the first draw waits for it, see finish_font_upload()
 	{
-		core::Buffer stage_buffer = core::Buffer::create_staging_buffer(device, upload_size, font_data);
-
-		auto &command_buffer = device.request_command_buffer();
-
-		FencePool fence_pool{device};
-
-		// Begin recording
-		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+		font_upload_manager = std::make_unique<UploadManager>(device, upload_size);
 
-		{
-			// Prepare for transfer
-			ImageMemoryBarrier memory_barrier{};
-			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
-			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			memory_barrier.src_access_mask = 0;
-			memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
-			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-			command_buffer.image_memory_barrier(*font_image_view, memory_barrier);
-		}
-
-		// Copy
 		VkBufferImageCopy buffer_copy_region{};
 		buffer_copy_region.imageSubresource.layerCount = font_image_view->get_subresource_range().layerCount;
 		buffer_copy_region.imageSubresource.aspectMask = font_image_view->get_subresource_range().aspectMask;
 		buffer_copy_region.imageExtent                 = font_image->get_extent();
 
-		command_buffer.copy_buffer_to_image(stage_buffer, *font_image, {buffer_copy_region});
-
-		{
-			// Prepare for fragmen shader
-			ImageMemoryBarrier memory_barrier{};
-			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
-			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-
-			command_buffer.image_memory_barrier(*font_image_view, memory_barrier);
-		}
-
-		// End recording
-		command_buffer.end();
-
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-		queue.submit(command_buffer, device.request_fence());
-
-		// Wait for the command buffer to finish its work before destroying the staging buffer
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset_pool();
+		font_upload_manager->upload_image(*font_image_view, font_data, upload_size, {buffer_copy_region},
+		                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+		font_upload_manager->flush();
 	}
 
 	// Calculate valid filter
@@ -386,8 +645,10 @@ void Gui::update(const float delta_time)
 	ImGui::Render();
 }
 
-bool Gui::update_buffers()
+bool Gui::update_buffers(const std::function<void()> &before_write)
 {
+	VKB_PROFILE_SCOPE("Gui::update_buffers");
+
 	ImDrawData *draw_data = ImGui::GetDrawData();
 	bool        updated   = false;
 
@@ -404,44 +665,65 @@ bool Gui::update_buffers()
 		return false;
 	}
 
-	if ((vertex_buffer->get_handle() == VK_NULL_HANDLE) || (vertex_buffer_size != last_vertex_buffer_size))
+	size_t draw_data_hash = hash_draw_data(draw_data);
+
+	if (before_write && (vertex_buffer_size > vertex_buffer_capacity || index_buffer_size > index_buffer_capacity || draw_data_hash != last_draw_data_hash))
+	{
+		before_write();
+	}
+
+	// The buffers only grow, they are persistently mapped and written directly
+	bool recreated = false;
+
+	if (vertex_buffer_size > vertex_buffer_capacity)
 	{
-		last_vertex_buffer_size = vertex_buffer_size;
-		updated                 = true;
+		vertex_buffer_capacity = grow_capacity(vertex_buffer_capacity, vertex_buffer_size);
+		recreated              = true;
 
 		vertex_buffer.reset();
-		vertex_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), vertex_buffer_size,
+		vertex_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), vertex_buffer_capacity,
 		                                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-		                                               VMA_MEMORY_USAGE_GPU_TO_CPU);
+		                                               VMA_MEMORY_USAGE_CPU_TO_GPU,
+		                                               VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
 		vertex_buffer->set_debug_name("GUI vertex buffer");
 	}
 
-	if ((index_buffer->get_handle() == VK_NULL_HANDLE) || (index_buffer_size != last_index_buffer_size))
+	if (index_buffer_size > index_buffer_capacity)
 	{
-		last_index_buffer_size = index_buffer_size;
-		updated                = true;
+		index_buffer_capacity = grow_capacity(index_buffer_capacity, index_buffer_size);
+		recreated             = true;
 
 		index_buffer.reset();
-		index_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), index_buffer_size,
+		index_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), index_buffer_capacity,
 		                                              VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-		                                              VMA_MEMORY_USAGE_GPU_TO_CPU);
+		                                              VMA_MEMORY_USAGE_CPU_TO_GPU,
+		                                              VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
 		index_buffer->set_debug_name("GUI index buffer");
 	}
 
-	// Upload data
-	upload_draw_data(draw_data, vertex_buffer->map(), index_buffer->map());
+	// The command buffers recorded with draw() bind the buffers and hold the draw commands, they must be re-recorded if either changed
+	size_t draw_commands_hash = hash_draw_commands(draw_data);
+	updated                   = recreated || draw_commands_hash != last_draw_commands_hash;
+	last_draw_commands_hash   = draw_commands_hash;
 
-	vertex_buffer->flush();
-	index_buffer->flush();
+	// Upload data, unless the buffers already hold it
+	if (recreated || draw_data_hash != last_draw_data_hash)
+	{
+		last_draw_data_hash = draw_data_hash;
 
-	vertex_buffer->unmap();
-	index_buffer->unmap();
+		upload_draw_data(draw_data, vertex_buffer->map(), index_buffer->map());
+
+		vertex_buffer->flush();
+		index_buffer->flush();
+	}
 
 	return updated;
 }
 
 void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_frame)
 {
+	VKB_PROFILE_SCOPE("Gui::update_buffers");
+
 	ImDrawData *draw_data = ImGui::GetDrawData();
 
 	if (!draw_data)
@@ -457,14 +739,14 @@ void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_fram
 		return;
 	}
 
-	std::vector<uint8_t> vertex_data(vertex_buffer_size);
-	std::vector<uint8_t> index_data(index_buffer_size);
+	// The buffer pools of the frame are persistently mapped, the draw data is written directly into them
+	auto vertex_allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertex_buffer_size);
+	auto index_allocation  = render_frame.allocate_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, index_buffer_size);
 
-	upload_draw_data(draw_data, vertex_data.data(), index_data.data());
+	upload_draw_data(draw_data, vertex_allocation.map(vertex_buffer_size), index_allocation.map(index_buffer_size));
 
-	auto vertex_allocation = sample.get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertex_buffer_size);
-
-	vertex_allocation.update(vertex_data);
+	vertex_allocation.flush();
+	index_allocation.flush();
 
 	std::vector<std::reference_wrapper<const core::Buffer>> buffers;
 	buffers.emplace_back(std::ref(vertex_allocation.get_buffer()));
@@ -473,10 +755,6 @@ void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_fram
 
 	command_buffer.bind_vertex_buffers(0, buffers, offsets);
 
-	auto index_allocation = sample.get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, index_buffer_size);
-
-	index_allocation.update(index_data);
-
 	command_buffer.bind_index_buffer(index_allocation.get_buffer(), index_allocation.get_offset(), VK_INDEX_TYPE_UINT16);
 }
 
@@ -496,6 +774,149 @@ void Gui::draw(CommandBuffer &command_buffer)
 
 	ScopedDebugLabel debug_label{command_buffer, "GUI"};
 
+	set_draw_state(command_buffer);
+
+	// If a render context is used, then use the frames buffer pools to allocate GUI vertex/index data from
+	if (!explicit_update)
+	{
+		update_buffers(command_buffer, sample.get_render_context().get_active_frame());
+	}
+	else
+	{
+		std::vector<std::reference_wrapper<const vkb::core::Buffer>> buffers;
+		buffers.push_back(*vertex_buffer);
+		command_buffer.bind_vertex_buffers(0, buffers, {0});
+
+		command_buffer.bind_index_buffer(*index_buffer, 0, VK_INDEX_TYPE_UINT16);
+	}
+
+	draw_commands(command_buffer);
+}
+
+bool Gui::draw_retained(CommandBuffer &command_buffer)
+{
+	auto &render_frame        = sample.get_render_context().get_active_frame();
+	auto &render_pass_binding = command_buffer.get_current_render_pass();
+
+	// The descriptor sets bound by the command buffer must outlive it, which only the descriptor set cache of the frame guarantees
+	if (sample.get_render_context().get_device().uses_descriptor_buffers() ||
+	    render_frame.get_descriptor_management_strategy() != DescriptorManagementStrategy::StoreInCache ||
+	    render_pass_binding.render_pass == nullptr)
+	{
+		return false;
+	}
+
+	if (!visible)
+	{
+		return true;
+	}
+
+	ImDrawData *draw_data = ImGui::GetDrawData();
+
+	if (!draw_data || draw_data->TotalVtxCount == 0 || draw_data->TotalIdxCount == 0)
+	{
+		return true;
+	}
+
+	ScopedDebugLabel debug_label{command_buffer, "GUI"};
+
+	auto &retained_frame = get_retained_frame(render_frame, command_buffer.get_command_pool().get_queue_family_index());
+
+	// The framebuffer is not inherited, so that recreating the swapchain does not invalidate the command buffer, its extent is part of the key instead
+	auto &io     = ImGui::GetIO();
+	auto &extent = render_pass_binding.framebuffer->get_extent();
+
+	size_t key = hash_draw_data(draw_data);
+	hash_combine(key, hash_draw_commands(draw_data));
+	hash_combine(key, io.DisplaySize.x);
+	hash_combine(key, io.DisplaySize.y);
+	hash_combine(key, extent.width);
+	hash_combine(key, extent.height);
+	hash_combine(key, render_pass_binding.render_pass->get_handle());
+	hash_combine(key, command_buffer.get_current_subpass_index());
+
+	if (sample.get_render_context().has_swapchain())
+	{
+		hash_combine(key, static_cast<uint32_t>(sample.get_render_context().get_swapchain().get_transform()));
+	}
+
+	if (key != retained_frame.key)
+	{
+		VKB_PROFILE_SCOPE("Gui::draw_retained");
+
+		size_t vertex_buffer_size = draw_data->TotalVtxCount * sizeof(ImDrawVert);
+		size_t index_buffer_size  = draw_data->TotalIdxCount * sizeof(ImDrawIdx);
+
+		// The fence of the frame was waited on, so the GPU is done with the buffers and the command buffer
+		if (vertex_buffer_size > retained_frame.vertex_buffer_capacity)
+		{
+			retained_frame.vertex_buffer_capacity = grow_capacity(retained_frame.vertex_buffer_capacity, vertex_buffer_size);
+
+			retained_frame.vertex_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), retained_frame.vertex_buffer_capacity,
+			                                                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			                                                              VMA_MEMORY_USAGE_CPU_TO_GPU,
+			                                                              VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+			retained_frame.vertex_buffer->set_debug_name("GUI retained vertex buffer");
+		}
+
+		if (index_buffer_size > retained_frame.index_buffer_capacity)
+		{
+			retained_frame.index_buffer_capacity = grow_capacity(retained_frame.index_buffer_capacity, index_buffer_size);
+
+			retained_frame.index_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), retained_frame.index_buffer_capacity,
+			                                                             VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+			                                                             VMA_MEMORY_USAGE_CPU_TO_GPU,
+			                                                             VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+			retained_frame.index_buffer->set_debug_name("GUI retained index buffer");
+		}
+
+		upload_draw_data(draw_data, retained_frame.vertex_buffer->map(), retained_frame.index_buffer->map());
+
+		retained_frame.vertex_buffer->flush();
+		retained_frame.index_buffer->flush();
+
+		auto &retained_command_buffer = *retained_frame.command_buffer;
+
+		retained_command_buffer.reset(CommandBuffer::ResetMode::ResetIndividually);
+		retained_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, render_pass_binding.render_pass, nullptr,
+		                              command_buffer.get_current_subpass_index());
+
+		VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+		retained_command_buffer.set_viewport(0, {viewport});
+
+		set_draw_state(retained_command_buffer);
+
+		std::vector<std::reference_wrapper<const vkb::core::Buffer>> buffers;
+		buffers.push_back(*retained_frame.vertex_buffer);
+		retained_command_buffer.bind_vertex_buffers(0, buffers, {0});
+
+		retained_command_buffer.bind_index_buffer(*retained_frame.index_buffer, 0, VK_INDEX_TYPE_UINT16);
+
+		draw_commands(retained_command_buffer);
+
+		retained_command_buffer.end();
+
+		retained_frame.key = key;
+	}
+
+	command_buffer.execute_commands(*retained_frame.command_buffer);
+
+	return true;
+}
+
+void Gui::finish_font_upload()
+{
+	if (font_upload_manager)
+	{
+		font_upload_manager->finish();
+		font_upload_manager.reset();
+	}
+}
+
+void Gui::set_draw_state(CommandBuffer &command_buffer)
+{
+	finish_font_upload();
+
 	// Vertex input state
 	VkVertexInputBindingDescription vertex_input_binding{};
 	vertex_input_binding.stride = to_u32(sizeof(ImDrawVert));
@@ -579,22 +1000,11 @@ void Gui::draw(CommandBuffer &command_buffer)
 
 	// Push constants
 	command_buffer.push_constants(push_transform);
+}
 
-	// If a render context is used, then use the frames buffer pools to allocate GUI vertex/index data from
-	if (!explicit_update)
-	{
-		update_buffers(command_buffer, sample.get_render_context().get_active_frame());
-	}
-	else
-	{
-		std::vector<std::reference_wrapper<const vkb::core::Buffer>> buffers;
-		buffers.push_back(*vertex_buffer);
-		command_buffer.bind_vertex_buffers(0, buffers, {0});
-
-		command_buffer.bind_index_buffer(*index_buffer, 0, VK_INDEX_TYPE_UINT16);
-	}
-
-	// Render commands
+void Gui::draw_commands(CommandBuffer &command_buffer)
+{
+	auto       &io            = ImGui::GetIO();
 	ImDrawData *draw_data     = ImGui::GetDrawData();
 	int32_t     vertex_offset = 0;
 	uint32_t    index_offset  = 0;
@@ -651,6 +1061,28 @@ void Gui::draw(CommandBuffer &command_buffer)
 	}
 }
 
+Gui::RetainedFrame &Gui::get_retained_frame(RenderFrame &render_frame, uint32_t queue_family_index)
+{
+	auto it = std::find_if(retained_frames.begin(), retained_frames.end(),
+	                       [&render_frame](const RetainedFrame &retained_frame) { return retained_frame.render_frame == &render_frame; });
+
+	if (it != retained_frames.end())
+	{
+		return *it;
+	}
+
+	// The frames of a render context are never destroyed, only updated with new render targets
+	RetainedFrame retained_frame;
+	retained_frame.render_frame   = &render_frame;
+	retained_frame.command_pool   = std::make_unique<CommandPool>(sample.get_render_context().get_device(), queue_family_index, &render_frame, 0,
+	                                                              CommandBuffer::ResetMode::ResetIndividually);
+	retained_frame.command_buffer = &retained_frame.command_pool->request_command_buffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+	retained_frames.push_back(std::move(retained_frame));
+
+	return retained_frames.back();
+}
+
 void Gui::draw(VkCommandBuffer command_buffer)
 {
 	if (!visible)
@@ -668,6 +1100,8 @@ void Gui::draw(VkCommandBuffer command_buffer)
 		return;
 	}
 
+	finish_font_upload();
+
 	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout->get_handle(), 0, 1, &descriptor_set, 0, NULL);
 
@@ -892,6 +1326,21 @@ void Gui::show_stats(const Stats &stats)
 {
 	for (const auto &stat_index : stats.get_requested_stats())
 	{
+		// The bottleneck is a category, a graph of it would not be readable
+		if (stat_index == StatIndex::gpu_bottleneck)
+		{
+			auto frame_bottleneck = stats.get_bottleneck();
+			if (frame_bottleneck.pass.empty())
+			{
+				ImGui::Text("Bottleneck: %s", to_string(frame_bottleneck.bottleneck));
+			}
+			else
+			{
+				ImGui::Text("Bottleneck: %s, heaviest pass %s: %.2f ms", to_string(frame_bottleneck.bottleneck), frame_bottleneck.pass.c_str(), frame_bottleneck.pass_time * 1000.0);
+			}
+			continue;
+		}
+
 		// Find the graph data of this stat index
 		auto pr = stats_view.graph_map.find(stat_index);
 
@@ -933,6 +1382,22 @@ void Gui::show_stats(const Stats &stats)
 			ImGui::Text("%s", graph_label.str().c_str());
 		}
 	}
+
+	// GPU time breakdown of the profiled scopes, nested scopes are indented
+	if (auto *gpu_profiler = stats.get_gpu_profiler())
+	{
+		for (auto &scope : gpu_profiler->get_scopes())
+		{
+			ImGui::Text("%*s%s: %.2f ms", static_cast<int>(scope.depth * 2), "", scope.name.c_str(), scope.time * 1000.0);
+
+			if (scope.has_statistics)
+			{
+				auto &statistics = scope.statistics;
+				ImGui::Text("%*s%.1fk primitives, %.2f vertex reuse, %.1fk fragments", static_cast<int>(scope.depth * 2 + 2), "",
+				            statistics.clipping_primitives * 1e-3, statistics.get_vertex_reuse(), statistics.fragment_shader_invocations * 1e-3);
+			}
+		}
+	}
 }
 
 void Gui::show_options_window(std::function<void()> body, const uint32_t lines)
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -27,6 +27,7 @@
 
 #include "core/buffer.h"
 #include "core/command_buffer.h"
+#include "core/command_pool.h"
 #include "core/sampler.h"
 #include "debug_info.h"
 #include "drawer.h"
@@ -34,6 +35,7 @@
 #include "platform/input_events.h"
 #include "rendering/render_context.h"
 #include "stats/stats.h"
+#include "upload_manager.h"
 #include "vulkan_sample.h"
 
 namespace vkb
@@ -140,6 +142,14 @@ class Gui
 	/// Used to show/hide the GUI
 	static bool visible;
 
+	/**
+	 * @brief Whether the commands of the GUI are recorded once in a secondary command buffer per frame,
+	 *        which is executed again as long as the draw data, the display and the render pass stay the same
+	 *        The sample then records the last subpass of its render pipeline in secondary command buffers,
+	 *        see RenderPipeline::set_last_subpass_secondary.
+	 */
+	static bool retained;
+
 	/**
 	 * @brief Initializes the Gui
 	 * @param sample A vulkan render context
@@ -176,7 +186,12 @@ class Gui
 	 */
 	void update(const float delta_time);
 
-	bool update_buffers();
+	/**
+	 * @brief Writes the draw data into the buffers of the explicit updates, unless they already hold it
+	 * @param before_write Called before the buffers are written or recreated, e.g. to wait for the frames in flight reading them
+	 * @return Whether the command buffers recorded with draw(VkCommandBuffer) are out of date and must be recorded again
+	 */
+	bool update_buffers(const std::function<void()> &before_write = {});
 
 	/**
 	 * @brief Draws the Gui
@@ -190,6 +205,13 @@ class Gui
 	 */
 	void draw(VkCommandBuffer command_buffer);
 
+	/**
+	 * @brief Executes the retained command buffer of the active frame, recording it again if it is out of date
+	 * @param command_buffer Primary command buffer in a subpass with secondary command buffer contents
+	 * @return Whether the Gui was drawn, if not it cannot be retained and must be drawn with draw()
+	 */
+	bool draw_retained(CommandBuffer &command_buffer);
+
 	/**
 	 * @brief Shows an overlay top window with app info and maybe stats
 	 * @param app_name Application name
@@ -260,6 +282,49 @@ class Gui
 	 */
 	void update_buffers(CommandBuffer &command_buffer, RenderFrame &render_frame);
 
+	/**
+	 * @brief A secondary command buffer holding the Gui commands of a frame, with the buffers it draws from
+	 */
+	struct RetainedFrame
+	{
+		RenderFrame *render_frame{nullptr};
+
+		std::unique_ptr<CommandPool> command_pool;
+
+		CommandBuffer *command_buffer{nullptr};
+
+		std::unique_ptr<core::Buffer> vertex_buffer;
+
+		std::unique_ptr<core::Buffer> index_buffer;
+
+		size_t vertex_buffer_capacity{0};
+
+		size_t index_buffer_capacity{0};
+
+		/// Hash of what the command buffer was recorded for, zero if it was not recorded
+		size_t key{0};
+	};
+
+	/**
+	 * @brief Waits for the upload of the font image started by the constructor, and acquires the image on the graphics queue
+	 */
+	void finish_font_upload();
+
+	/**
+	 * @brief Sets the pipeline state, the font image and the push constants of the draw commands
+	 */
+	void set_draw_state(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Records the draw commands of the draw data, from the bound vertex and index buffers
+	 */
+	void draw_commands(CommandBuffer &command_buffer);
+
+	/**
+	 * @return The retained command buffer of a frame, created on first use with a pool of the queue family
+	 */
+	RetainedFrame &get_retained_frame(RenderFrame &render_frame, uint32_t queue_family_index);
+
 	static const double press_time_ms;
 
 	static const float overlay_alpha;
@@ -276,9 +341,16 @@ class Gui
 
 	std::unique_ptr<core::Buffer> index_buffer;
 
-	size_t last_vertex_buffer_size;
+	/// Sizes of the buffers of the explicit updates, they grow geometrically
+	size_t vertex_buffer_capacity{0};
 
-	size_t last_index_buffer_size;
+	size_t index_buffer_capacity{0};
+
+	/// Hash of the draw data in the buffers of the explicit updates
+	size_t last_draw_data_hash{0};
+
+	/// Hash of the draw commands of the last explicit update
+	size_t last_draw_commands_hash{0};
 
 	///  Scale factor to apply due to a difference between the window and GL pixel sizes
 	float content_scale_factor{1.0f};
@@ -295,6 +367,9 @@ class Gui
 	std::unique_ptr<core::Image>     font_image;
 	std::unique_ptr<core::ImageView> font_image_view;
 
+	/// Uploads the font image while the sample prepares, released once the first draw waited for it
+	std::unique_ptr<UploadManager> font_upload_manager;
+
 	std::unique_ptr<core::Sampler> sampler{nullptr};
 
 	PipelineLayout *pipeline_layout{nullptr};
@@ -322,6 +397,8 @@ class Gui
 	bool show_graph_file_output = false;
 
 	uint32_t subpass = 0;
+
+	std::vector<RetainedFrame> retained_frames;
 };
 
 void Gui::new_frame()
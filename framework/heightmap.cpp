@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -63,4 +63,30 @@ float HeightMap::get_height(const uint32_t x, const uint32_t y)
 	rpos /= glm::ivec2(scale);
 	return *(data + (rpos.x + rpos.y * dim) * scale) / 65535.0f;
 }
+
+float HeightMap::sample(float u, float v) const
+{
+	auto mirror = [this](int32_t i) {
+		int32_t period = 2 * static_cast<int32_t>(dim);
+		i %= period;
+		i = i < 0 ? i + period : i;
+		return static_cast<uint32_t>(i < static_cast<int32_t>(dim) ? i : period - 1 - i);
+	};
+
+	glm::vec2 position = glm::vec2(u, v) * static_cast<float>(dim) - 0.5f;
+	glm::vec2 base     = glm::floor(position);
+	glm::vec2 weight   = position - base;
+
+	int32_t x = static_cast<int32_t>(base.x);
+	int32_t y = static_cast<int32_t>(base.y);
+
+	auto texel = [&](int32_t dx, int32_t dy) { return data[mirror(x + dx) + mirror(y + dy) * dim] / 65535.0f; };
+
+	return glm::mix(glm::mix(texel(0, 0), texel(1, 0), weight.x), glm::mix(texel(0, 1), texel(1, 1), weight.x), weight.y);
+}
+
+uint32_t HeightMap::get_dimension() const
+{
+	return dim;
+}
 }        // namespace vkb
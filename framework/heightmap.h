@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -45,6 +45,19 @@ class HeightMap
 	 */
 	float get_height(const uint32_t x, const uint32_t y);
 
+	/**
+	 * @brief Samples the heightmap with bilinear filtering, mirroring it outside of [0, 1]
+	 * @param u The horizontal coordinate, 1 being the width of the heightmap
+	 * @param v The vertical coordinate, 1 being the height of the heightmap
+	 * @returns A height value in [0, 1]
+	 */
+	float sample(float u, float v) const;
+
+	/**
+	 * @returns The number of samples on a side of the heightmap
+	 */
+	uint32_t get_dimension() const;
+
   private:
 	uint16_t *data;
 
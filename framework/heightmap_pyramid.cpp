@@ -0,0 +1,265 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "heightmap_pyramid.h"
+
+#include <algorithm>
+
+#include "common/error.h"
+#include "common/utils.h"
+#include "core/device.h"
+
+namespace vkb
+{
+HeightMapPyramid::HeightMapPyramid(Device &device, uint32_t level_count, uint32_t tile_resolution, uint32_t slot_count, uint32_t max_loads_per_update, TileLoader &&loader) :
+    device{device},
+    level_count{level_count},
+    tile_resolution{tile_resolution},
+    max_loads_per_update{std::max(max_loads_per_update, 1U)},
+    loader{std::move(loader)},
+    slots(std::max(slot_count, 1U)),
+    tile_entries(get_tile_index(level_count, 0, 0), HeightMapTileEntry{NOT_RESIDENT, 0})
+{
+	assert(level_count > 0 && level_count <= 16 && "The tile table of the pyramid is indexed with 32 bits");
+
+	atlas = std::make_unique<core::Image>(device,
+	                                      VkExtent3D{tile_resolution, tile_resolution, 1},
+	                                      VK_FORMAT_R16_UNORM,
+	                                      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+	                                      VMA_MEMORY_USAGE_GPU_ONLY,
+	                                      VK_SAMPLE_COUNT_1_BIT,
+	                                      1,
+	                                      to_u32(slots.size()));
+	atlas->set_debug_name("HeightMapPyramid: atlas");
+
+	atlas_view = std::make_unique<core::ImageView>(*atlas, VK_IMAGE_VIEW_TYPE_2D_ARRAY);
+
+	tile_table = std::make_unique<core::Buffer>(device,
+	                                            tile_entries.size() * sizeof(HeightMapTileEntry),
+	                                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	                                            VMA_MEMORY_USAGE_CPU_TO_GPU);
+	tile_table->set_debug_name("HeightMapPyramid: tile table");
+	tile_table->update(tile_entries);
+
+	staging_buffer = std::make_unique<core::Buffer>(device,
+	                                                this->max_loads_per_update * tile_resolution * tile_resolution * sizeof(uint16_t),
+	                                                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	                                                VMA_MEMORY_USAGE_CPU_ONLY);
+	staging_buffer->set_debug_name("HeightMapPyramid: staging buffer");
+}
+
+uint32_t HeightMapPyramid::get_tile_index(uint32_t level, uint32_t x, uint32_t y)
+{
+	// Level l starts after the (4^l - 1) / 3 tiles of the levels above it
+	return ((1U << (2 * level)) - 1) / 3 + (y << level) + x;
+}
+
+uint32_t HeightMapPyramid::get_level_count() const
+{
+	return level_count;
+}
+
+uint32_t HeightMapPyramid::get_tile_resolution() const
+{
+	return tile_resolution;
+}
+
+uint32_t HeightMapPyramid::get_resident_count() const
+{
+	return resident_count;
+}
+
+const core::ImageView &HeightMapPyramid::get_atlas_view() const
+{
+	return *atlas_view;
+}
+
+core::Buffer &HeightMapPyramid::get_tile_table()
+{
+	return *tile_table;
+}
+
+void HeightMapPyramid::request_tiles(uint32_t level, uint32_t x, uint32_t y, const glm::vec3 &viewer_position, float split_factor, std::vector<TileRequest> &requests)
+{
+	if (level + 1 >= level_count)
+	{
+		return;
+	}
+
+	// Same metric as the quadtree of the renderer: the distance to the node rectangle, with the height of the viewer
+	float     node_size = 1.0f / static_cast<float>(1U << level);
+	glm::vec2 node_min  = glm::vec2(x, y) * node_size;
+	glm::vec2 offset    = glm::max(glm::max(node_min - glm::vec2(viewer_position), glm::vec2(viewer_position) - node_min - node_size), glm::vec2(0.0f));
+	float     distance  = glm::length(glm::vec3(offset, viewer_position.z));
+
+	if (distance >= split_factor * node_size)
+	{
+		return;
+	}
+
+	for (uint32_t child = 0; child < 4; ++child)
+	{
+		uint32_t child_x = 2 * x + (child & 1);
+		uint32_t child_y = 2 * y + (child >> 1);
+
+		auto &entry = tile_entries[get_tile_index(level + 1, child_x, child_y)];
+		if (entry.slot == NOT_RESIDENT)
+		{
+			requests.push_back({level + 1, child_x, child_y, distance});
+			continue;
+		}
+
+		slots[entry.slot].last_needed = update_count;
+		request_tiles(level + 1, child_x, child_y, viewer_position, split_factor, requests);
+	}
+}
+
+uint32_t HeightMapPyramid::allocate_slot()
+{
+	uint32_t oldest = NOT_RESIDENT;
+
+	for (uint32_t i = 0; i < to_u32(slots.size()); ++i)
+	{
+		if (slots[i].tile == NOT_RESIDENT)
+		{
+			return i;
+		}
+
+		// The root is never evicted, nor the tiles needed by this update
+		if (slots[i].tile != 0 && slots[i].last_needed < update_count &&
+		    (oldest == NOT_RESIDENT || slots[i].last_needed < slots[oldest].last_needed))
+		{
+			oldest = i;
+		}
+	}
+
+	return oldest;
+}
+
+uint32_t HeightMapPyramid::update(VkCommandBuffer command_buffer, const glm::vec3 &viewer_position, float split_factor)
+{
+	++update_count;
+
+	std::vector<TileRequest> requests;
+
+	auto &root = tile_entries[0];
+	if (root.slot == NOT_RESIDENT)
+	{
+		requests.push_back({0, 0, 0, 0.0f});
+	}
+	else
+	{
+		slots[root.slot].last_needed = update_count;
+		request_tiles(0, 0, 0, viewer_position, split_factor, requests);
+	}
+
+	if (requests.empty())
+	{
+		return 0;
+	}
+
+	// The coarse tiles first, as the finer ones are not drawn without them
+	std::sort(requests.begin(), requests.end(), [](const TileRequest &a, const TileRequest &b) {
+		return a.level != b.level ? a.level < b.level : a.distance < b.distance;
+	});
+
+	const size_t tile_size = tile_resolution * tile_resolution * sizeof(uint16_t);
+	samples.resize(tile_resolution * tile_resolution);
+
+	std::vector<VkBufferImageCopy> copy_regions;
+
+	for (auto &request : requests)
+	{
+		if (copy_regions.size() == max_loads_per_update)
+		{
+			break;
+		}
+
+		uint32_t slot_index = allocate_slot();
+		if (slot_index == NOT_RESIDENT)
+		{
+			break;
+		}
+
+		auto &slot = slots[slot_index];
+		if (slot.tile != NOT_RESIDENT)
+		{
+			tile_entries[slot.tile].slot = NOT_RESIDENT;
+			tile_table->convert_and_update(tile_entries[slot.tile], slot.tile * sizeof(HeightMapTileEntry));
+			--resident_count;
+		}
+
+		loader(request.level, request.x, request.y, samples);
+
+		auto bounds = std::minmax_element(samples.begin(), samples.end());
+
+		uint32_t tile_index = get_tile_index(request.level, request.x, request.y);
+		slot.tile           = tile_index;
+		slot.last_needed    = update_count;
+
+		tile_entries[tile_index] = {slot_index, glm::packHalf2x16(glm::vec2(*bounds.first, *bounds.second) / 65535.0f)};
+		tile_table->convert_and_update(tile_entries[tile_index], tile_index * sizeof(HeightMapTileEntry));
+		++resident_count;
+
+		VkDeviceSize staging_offset = copy_regions.size() * tile_size;
+		staging_buffer->update(reinterpret_cast<const uint8_t *>(samples.data()), tile_size, staging_offset);
+
+		VkBufferImageCopy copy_region{};
+		copy_region.bufferOffset     = staging_offset;
+		copy_region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, slot_index, 1};
+		copy_region.imageExtent      = {tile_resolution, tile_resolution, 1};
+		copy_regions.push_back(copy_region);
+	}
+
+	if (copy_regions.empty())
+	{
+		return 0;
+	}
+
+	staging_buffer->flush();
+	tile_table->flush();
+
+	VkImageSubresourceRange subresource_range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, to_u32(slots.size())};
+
+	// The tiles are read by the quadtree and vertex shaders of the previous frame
+	image_layout_transition(command_buffer,
+	                        atlas->get_handle(),
+	                        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                        0,
+	                        VK_ACCESS_TRANSFER_WRITE_BIT,
+	                        atlas_initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED,
+	                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                        subresource_range);
+
+	vkCmdCopyBufferToImage(command_buffer, staging_buffer->get_handle(), atlas->get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, to_u32(copy_regions.size()), copy_regions.data());
+
+	image_layout_transition(command_buffer,
+	                        atlas->get_handle(),
+	                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                        VK_ACCESS_TRANSFER_WRITE_BIT,
+	                        VK_ACCESS_SHADER_READ_BIT,
+	                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                        subresource_range);
+
+	atlas_initialized = true;
+
+	return to_u32(copy_regions.size());
+}
+}        // namespace vkb
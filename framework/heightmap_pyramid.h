@@ -0,0 +1,179 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/image.h"
+#include "core/image_view.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Residency of a tile of a HeightMapPyramid, read by the shaders from the tile table
+ */
+struct HeightMapTileEntry
+{
+	/// Layer of the tile in the atlas, NOT_RESIDENT if the tile is not loaded
+	uint32_t slot;
+
+	/// packHalf2x16 of the lowest and highest normalized heights of the tile
+	uint32_t height_range;
+};
+
+/**
+ * @brief A heightmap too large to load at once, split into a pyramid of tiles streamed into a GPU atlas around a viewer
+ *
+ * Level 0 is a single tile covering the whole heightmap, and every level has twice as many tiles per side as the one
+ * above it, each holding tile_resolution x tile_resolution samples. Tiles include the samples of their edges, so
+ * neighbours share them. The tiles are produced by a TileLoader, which reads them from storage or generates them: the
+ * whole heightmap is never in memory. A loader must point sample the heightmap, so that every other sample of a tile
+ * is a sample of its parent, which the geomorphing of the LOD transitions relies on.
+ *
+ * update() finds the tiles a viewer needs, the ones of the quadtree nodes a renderer splits within split_factor node
+ * sizes of it, loads at most max_loads_per_update of them, the coarsest and nearest first, and records their upload.
+ * The least recently needed tiles are evicted when the atlas is full, except the root which is always resident.
+ *
+ * The tile table is a storage buffer with a HeightMapTileEntry for every tile of the pyramid, level after level, in
+ * row-major order within a level. It is host visible and written by update(), so the GPU must be done reading it.
+ */
+class HeightMapPyramid
+{
+  public:
+	static constexpr uint32_t NOT_RESIDENT = ~0U;
+
+	/**
+	 * @brief Writes the normalized samples of a tile, row by row
+	 */
+	using TileLoader = std::function<void(uint32_t level, uint32_t x, uint32_t y, std::vector<uint16_t> &samples)>;
+
+	/**
+	 * @param device The device to create the atlas on
+	 * @param level_count Number of levels of the pyramid
+	 * @param tile_resolution Samples on the side of a tile
+	 * @param slot_count Tiles the atlas holds
+	 * @param max_loads_per_update Tiles loaded by an update() at most
+	 * @param loader Produces the samples of the tiles
+	 */
+	HeightMapPyramid(Device &device, uint32_t level_count, uint32_t tile_resolution, uint32_t slot_count, uint32_t max_loads_per_update, TileLoader &&loader);
+
+	HeightMapPyramid(const HeightMapPyramid &) = delete;
+
+	HeightMapPyramid(HeightMapPyramid &&) = delete;
+
+	HeightMapPyramid &operator=(const HeightMapPyramid &) = delete;
+
+	HeightMapPyramid &operator=(HeightMapPyramid &&) = delete;
+
+	/**
+	 * @brief Streams in the tiles needed around a viewer, and records their upload to the atlas
+	 * @param command_buffer The command buffer to record to, outside of a render pass
+	 * @param viewer_position Position of the viewer in heightmap space: x and y in [0, 1] over the heightmap, z its height above it
+	 * @param split_factor Distance under which a quadtree node is split, in node sizes
+	 * @return The number of tiles loaded
+	 */
+	uint32_t update(VkCommandBuffer command_buffer, const glm::vec3 &viewer_position, float split_factor);
+
+	/**
+	 * @return The index of the entry of a tile in the tile table
+	 */
+	static uint32_t get_tile_index(uint32_t level, uint32_t x, uint32_t y);
+
+	uint32_t get_level_count() const;
+
+	uint32_t get_tile_resolution() const;
+
+	/**
+	 * @return The number of tiles in the atlas
+	 */
+	uint32_t get_resident_count() const;
+
+	const core::ImageView &get_atlas_view() const;
+
+	core::Buffer &get_tile_table();
+
+  private:
+	struct Slot
+	{
+		/// Index of the tile in the tile table, NOT_RESIDENT if the slot is free
+		uint32_t tile{NOT_RESIDENT};
+
+		/// Last update() which needed the tile
+		uint64_t last_needed{0};
+	};
+
+	struct TileRequest
+	{
+		uint32_t level;
+
+		uint32_t x;
+
+		uint32_t y;
+
+		float distance;
+	};
+
+	/**
+	 * @brief Lists the tiles under a needed tile which are needed too, marking the resident ones as used
+	 */
+	void request_tiles(uint32_t level, uint32_t x, uint32_t y, const glm::vec3 &viewer_position, float split_factor, std::vector<TileRequest> &requests);
+
+	/**
+	 * @return A free slot, or the one of the least recently needed tile which was not needed by this update()
+	 */
+	uint32_t allocate_slot();
+
+	Device &device;
+
+	uint32_t level_count;
+
+	uint32_t tile_resolution;
+
+	uint32_t max_loads_per_update;
+
+	TileLoader loader;
+
+	std::unique_ptr<core::Image> atlas;
+
+	std::unique_ptr<core::ImageView> atlas_view;
+
+	std::unique_ptr<core::Buffer> tile_table;
+
+	std::unique_ptr<core::Buffer> staging_buffer;
+
+	std::vector<Slot> slots;
+
+	/// Copy of the tile table
+	std::vector<HeightMapTileEntry> tile_entries;
+
+	std::vector<uint16_t> samples;
+
+	uint64_t update_count{0};
+
+	uint32_t resident_count{0};
+
+	bool atlas_initialized{false};
+};
+}        // namespace vkb
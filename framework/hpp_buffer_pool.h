@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -30,7 +30,13 @@ namespace vkb
 class HPPBufferAllocation : private vkb::BufferAllocation
 {
   public:
+	using vkb::BufferAllocation::flush;
+	using vkb::BufferAllocation::get_dynamic_offset;
+	using vkb::BufferAllocation::get_element_count;
+	using vkb::BufferAllocation::map;
+	using vkb::BufferAllocation::map_element;
 	using vkb::BufferAllocation::update;
+	using vkb::BufferAllocation::update_elements;
 
   public:
 	vkb::core::HPPBuffer &get_buffer()
@@ -47,6 +53,11 @@ class HPPBufferAllocation : private vkb::BufferAllocation
 	{
 		return static_cast<vk::DeviceSize>(vkb::BufferAllocation::get_size());
 	}
+
+	vk::DeviceSize get_element_stride() const
+	{
+		return static_cast<vk::DeviceSize>(vkb::BufferAllocation::get_element_stride());
+	}
 };
 
 /**
@@ -63,6 +74,12 @@ class HPPBufferBlock : private vkb::BufferBlock
 		return std::move(*(reinterpret_cast<vkb::HPPBufferAllocation *>(&ba)));
 	}
 
+	vkb::HPPBufferAllocation allocate_array(vk::DeviceSize element_size, uint32_t element_count)
+	{
+		vkb::BufferAllocation ba = vkb::BufferBlock::allocate_array(static_cast<VkDeviceSize>(element_size), element_count);
+		return std::move(*(reinterpret_cast<vkb::HPPBufferAllocation *>(&ba)));
+	}
+
 	bool can_allocate(vk::DeviceSize size) const
 	{
 		return vkb::BufferBlock::can_allocate(static_cast<VkDeviceSize>(size));
@@ -77,15 +94,29 @@ class HPPBufferBlock : private vkb::BufferBlock
 class HPPBufferPool : private vkb::BufferPool
 {
   public:
+	using vkb::BufferPool::get_capacity;
+	using vkb::BufferPool::get_peak_usage;
 	using vkb::BufferPool::reset;
+	using vkb::BufferPool::set_trim_policy;
 
 	HPPBufferPool(
-	    vkb::core::HPPDevice &device, vk::DeviceSize block_size, vk::BufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU) :
+	    vkb::core::HPPDevice &device, vk::DeviceSize block_size, vk::BufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_AUTO) :
 	    vkb::BufferPool(
 	        reinterpret_cast<vkb::Device &>(device), static_cast<VkDeviceSize>(block_size), static_cast<VkBufferUsageFlags>(usage), memory_usage)
 	{
 	}
 
+	vkb::HPPBufferAllocation allocate_array(vk::DeviceSize element_size, uint32_t element_count)
+	{
+		vkb::BufferAllocation ba = vkb::BufferPool::allocate_array(static_cast<VkDeviceSize>(element_size), element_count);
+		return std::move(*(reinterpret_cast<vkb::HPPBufferAllocation *>(&ba)));
+	}
+
+	vk::DeviceSize get_element_stride(vk::DeviceSize element_size) const
+	{
+		return static_cast<vk::DeviceSize>(vkb::BufferPool::get_element_stride(static_cast<VkDeviceSize>(element_size)));
+	}
+
 	vkb::HPPBufferBlock &request_buffer_block(vk::DeviceSize minimum_size, bool minimal = false)
 	{
 		return reinterpret_cast<vkb::HPPBufferBlock &>(vkb::BufferPool::request_buffer_block(static_cast<VkDeviceSize>(minimum_size), minimal));
@@ -32,7 +32,13 @@ namespace vkb
 class HPPGLTFLoader : private vkb::GLTFLoader
 {
   public:
+	using vkb::GLTFLoader::is_image_resident;
 	using vkb::GLTFLoader::read_scene_from_file;
+	using vkb::GLTFLoader::read_scene_from_file_async;
+	using vkb::GLTFLoader::set_meshlet_geometry;
+	using vkb::GLTFLoader::set_ray_tracing_geometry;
+	using vkb::GLTFLoader::set_streamed_textures;
+	using vkb::GLTFLoader::update_streaming;
 
 	HPPGLTFLoader(vkb::core::HPPDevice &device) :
 	    GLTFLoader(reinterpret_cast<vkb::Device &>(device))
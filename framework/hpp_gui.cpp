@@ -17,12 +17,14 @@
 
 #include "hpp_gui.h"
 #include "vulkan_sample.h"
+#include <common/helpers.h>
 #include <common/hpp_utils.h>
 #include <core/hpp_buffer.h>
 #include <core/hpp_command_pool.h>
 #include <imgui_internal.h>
 
 #include <numeric>
+#include <string_view>
 
 namespace vkb
 {
@@ -43,6 +45,55 @@ void upload_draw_data(const ImDrawData *draw_data, uint8_t *vertex_data, uint8_t
 	}
 }
 
+size_t hash_draw_data(const ImDrawData *draw_data)
+{
+	size_t hash = 0;
+
+	for (int n = 0; n < draw_data->CmdListsCount; n++)
+	{
+		const ImDrawList *cmd_list = draw_data->CmdLists[n];
+		vkb::hash_combine(hash, std::string_view{reinterpret_cast<const char *>(cmd_list->VtxBuffer.Data), cmd_list->VtxBuffer.Size * sizeof(ImDrawVert)});
+		vkb::hash_combine(hash, std::string_view{reinterpret_cast<const char *>(cmd_list->IdxBuffer.Data), cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx)});
+	}
+
+	return hash;
+}
+
+size_t hash_draw_commands(const ImDrawData *draw_data)
+{
+	size_t hash = 0;
+
+	for (int n = 0; n < draw_data->CmdListsCount; n++)
+	{
+		const ImDrawList *cmd_list = draw_data->CmdLists[n];
+		vkb::hash_combine(hash, cmd_list->VtxBuffer.Size);
+
+		for (int i = 0; i < cmd_list->CmdBuffer.Size; i++)
+		{
+			const ImDrawCmd &cmd = cmd_list->CmdBuffer[i];
+			vkb::hash_combine(hash, cmd.ElemCount);
+			vkb::hash_combine(hash, cmd.ClipRect.x);
+			vkb::hash_combine(hash, cmd.ClipRect.y);
+			vkb::hash_combine(hash, cmd.ClipRect.z);
+			vkb::hash_combine(hash, cmd.ClipRect.w);
+		}
+	}
+
+	return hash;
+}
+
+size_t grow_capacity(size_t capacity, size_t size)
+{
+	capacity = std::max<size_t>(capacity, 4096);
+
+	while (capacity < size)
+	{
+		capacity *= 2;
+	}
+
+	return capacity;
+}
+
 void reset_graph_max_value(StatGraphData &graph_data)
 {
 	// If it does not have a fixed max
@@ -55,6 +106,7 @@ void reset_graph_max_value(StatGraphData &graph_data)
 }        // namespace
 
 bool                   HPPGui::visible       = true;
+bool                   HPPGui::retained      = false;
 const double           HPPGui::press_time_ms = 200.0f;
 const float            HPPGui::overlay_alpha = 0.3f;
 const std::string      HPPGui::default_font  = "Roboto-Regular";
@@ -374,36 +426,48 @@ bool HPPGui::update_buffers()
 		return false;
 	}
 
-	if ((!vertex_buffer->get_handle()) || (vertex_buffer_size != last_vertex_buffer_size))
-	{
-		last_vertex_buffer_size = vertex_buffer_size;
-		updated                 = true;
+	bool recreated = false;
 
-		vertex_buffer = std::make_unique<vkb::core::HPPBuffer>(sample.get_render_context().get_device(), vertex_buffer_size,
-		                                                       vk::BufferUsageFlagBits::eVertexBuffer,
-		                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
-		vertex_buffer->set_debug_name("GUI vertex buffer");
+	if (vertex_buffer_size > vertex_buffer_capacity)
+	{
+		vertex_buffer_capacity = grow_capacity(vertex_buffer_capacity, vertex_buffer_size);
+		recreated              = true;
+
+		vertex_buffer = vkb::core::HPPBufferBuilder(vertex_buffer_capacity)
+		                    .with_usage(vk::BufferUsageFlagBits::eVertexBuffer)
+		                    .with_vma_usage(VMA_MEMORY_USAGE_CPU_TO_GPU)
+		                    .with_vma_flags(VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT)
+		                    .with_debug_name("GUI vertex buffer")
+		                    .build_unique(sample.get_render_context().get_device());
 	}
 
-	if ((!index_buffer->get_handle()) || (index_buffer_size != last_index_buffer_size))
+	if (index_buffer_size > index_buffer_capacity)
 	{
-		last_index_buffer_size = index_buffer_size;
-		updated                = true;
-
-		index_buffer = std::make_unique<vkb::core::HPPBuffer>(sample.get_render_context().get_device(), index_buffer_size,
-		                                                      vk::BufferUsageFlagBits::eIndexBuffer,
-		                                                      VMA_MEMORY_USAGE_GPU_TO_CPU);
-		index_buffer->set_debug_name("GUI index buffer");
+		index_buffer_capacity = grow_capacity(index_buffer_capacity, index_buffer_size);
+		recreated             = true;
+
+		index_buffer = vkb::core::HPPBufferBuilder(index_buffer_capacity)
+		                   .with_usage(vk::BufferUsageFlagBits::eIndexBuffer)
+		                   .with_vma_usage(VMA_MEMORY_USAGE_CPU_TO_GPU)
+		                   .with_vma_flags(VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT)
+		                   .with_debug_name("GUI index buffer")
+		                   .build_unique(sample.get_render_context().get_device());
 	}
 
-	// Upload data
-	upload_draw_data(draw_data, vertex_buffer->map(), index_buffer->map());
+	size_t draw_commands_hash = hash_draw_commands(draw_data);
+	updated                   = recreated || draw_commands_hash != last_draw_commands_hash;
+	last_draw_commands_hash   = draw_commands_hash;
+
+	size_t draw_data_hash = hash_draw_data(draw_data);
+	if (recreated || draw_data_hash != last_draw_data_hash)
+	{
+		last_draw_data_hash = draw_data_hash;
 
-	vertex_buffer->flush();
-	index_buffer->flush();
+		upload_draw_data(draw_data, vertex_buffer->map(), index_buffer->map());
 
-	vertex_buffer->unmap();
-	index_buffer->unmap();
+		vertex_buffer->flush();
+		index_buffer->flush();
+	}
 
 	return updated;
 }
@@ -421,24 +485,19 @@ void HPPGui::update_buffers(vkb::core::HPPCommandBuffer &command_buffer) const
 	size_t vertex_buffer_size = draw_data->TotalVtxCount * sizeof(ImDrawVert);
 	size_t index_buffer_size  = draw_data->TotalIdxCount * sizeof(ImDrawIdx);
 
-	std::vector<uint8_t> vertex_data(vertex_buffer_size);
-	std::vector<uint8_t> index_data(index_buffer_size);
-
-	upload_draw_data(draw_data, vertex_data.data(), index_data.data());
-
 	auto vertex_allocation = render_frame.allocate_buffer(vk::BufferUsageFlagBits::eVertexBuffer, vertex_buffer_size);
+	auto index_allocation  = render_frame.allocate_buffer(vk::BufferUsageFlagBits::eIndexBuffer, index_buffer_size);
 
-	vertex_allocation.update(vertex_data);
+	upload_draw_data(draw_data, vertex_allocation.map(vertex_buffer_size), index_allocation.map(index_buffer_size));
+
+	vertex_allocation.flush();
+	index_allocation.flush();
 
 	std::vector<std::reference_wrapper<const core::HPPBuffer>> buffers;
 	buffers.emplace_back(std::ref(vertex_allocation.get_buffer()));
 
 	command_buffer.bind_vertex_buffers(0, buffers, {vertex_allocation.get_offset()});
 
-	auto index_allocation = render_frame.allocate_buffer(vk::BufferUsageFlagBits::eIndexBuffer, index_buffer_size);
-
-	index_allocation.update(index_data);
-
 	command_buffer.bind_index_buffer(index_allocation.get_buffer(), index_allocation.get_offset(), vk::IndexType::eUint16);
 }
 
@@ -463,6 +522,136 @@ void HPPGui::draw(vkb::core::HPPCommandBuffer &command_buffer)
 
 	vkb::core::HPPScopedDebugLabel debug_label(command_buffer, "GUI");
 
+	set_draw_state(command_buffer);
+
+	// If a render context is used, then use the frames buffer pools to allocate GUI vertex/index data from
+	if (!explicit_update)
+	{
+		update_buffers(command_buffer);
+	}
+	else
+	{
+		std::vector<std::reference_wrapper<const vkb::core::HPPBuffer>> buffers;
+		buffers.push_back(*vertex_buffer);
+		command_buffer.bind_vertex_buffers(0, buffers, {0});
+
+		command_buffer.bind_index_buffer(*index_buffer, 0, vk::IndexType::eUint16);
+	}
+
+	draw_commands(command_buffer);
+}
+
+bool HPPGui::draw_retained(vkb::core::HPPCommandBuffer &command_buffer)
+{
+	auto &render_frame        = sample.get_render_context().get_active_frame();
+	auto &render_pass_binding = command_buffer.get_current_render_pass();
+
+	// The descriptor sets bound by the command buffer must outlive it, which only the descriptor set cache of the frame guarantees
+	if (render_frame.get_descriptor_management_strategy() != vkb::rendering::DescriptorManagementStrategy::StoreInCache ||
+	    render_pass_binding.render_pass == nullptr)
+	{
+		return false;
+	}
+
+	if (!visible)
+	{
+		return true;
+	}
+
+	ImDrawData *draw_data = ImGui::GetDrawData();
+
+	if (!draw_data || draw_data->TotalVtxCount == 0 || draw_data->TotalIdxCount == 0)
+	{
+		return true;
+	}
+
+	vkb::core::HPPScopedDebugLabel debug_label(command_buffer, "GUI");
+
+	auto &retained_frame = get_retained_frame(render_frame, command_buffer.get_command_pool().get_queue_family_index());
+
+	// The framebuffer is not inherited, so that recreating the swapchain does not invalidate the command buffer, its extent is part of the key instead
+	auto &io     = ImGui::GetIO();
+	auto &extent = render_pass_binding.framebuffer->get_extent();
+
+	size_t key = hash_draw_data(draw_data);
+	hash_combine(key, hash_draw_commands(draw_data));
+	hash_combine(key, io.DisplaySize.x);
+	hash_combine(key, io.DisplaySize.y);
+	hash_combine(key, extent.width);
+	hash_combine(key, extent.height);
+	hash_combine(key, static_cast<VkRenderPass>(render_pass_binding.render_pass->get_handle()));
+	hash_combine(key, command_buffer.get_current_subpass_index());
+
+	if (sample.get_render_context().has_swapchain())
+	{
+		hash_combine(key, static_cast<uint32_t>(sample.get_render_context().get_swapchain().get_transform()));
+	}
+
+	if (key != retained_frame.key)
+	{
+		size_t vertex_buffer_size = draw_data->TotalVtxCount * sizeof(ImDrawVert);
+		size_t index_buffer_size  = draw_data->TotalIdxCount * sizeof(ImDrawIdx);
+
+		// The fence of the frame was waited on, so the GPU is done with the buffers and the command buffer
+		if (vertex_buffer_size > retained_frame.vertex_buffer_capacity)
+		{
+			retained_frame.vertex_buffer_capacity = grow_capacity(retained_frame.vertex_buffer_capacity, vertex_buffer_size);
+
+			retained_frame.vertex_buffer = vkb::core::HPPBufferBuilder(retained_frame.vertex_buffer_capacity)
+			                                   .with_usage(vk::BufferUsageFlagBits::eVertexBuffer)
+			                                   .with_vma_usage(VMA_MEMORY_USAGE_CPU_TO_GPU)
+			                                   .with_vma_flags(VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT)
+			                                   .with_debug_name("GUI retained vertex buffer")
+			                                   .build_unique(sample.get_render_context().get_device());
+		}
+
+		if (index_buffer_size > retained_frame.index_buffer_capacity)
+		{
+			retained_frame.index_buffer_capacity = grow_capacity(retained_frame.index_buffer_capacity, index_buffer_size);
+
+			retained_frame.index_buffer = vkb::core::HPPBufferBuilder(retained_frame.index_buffer_capacity)
+			                                  .with_usage(vk::BufferUsageFlagBits::eIndexBuffer)
+			                                  .with_vma_usage(VMA_MEMORY_USAGE_CPU_TO_GPU)
+			                                  .with_vma_flags(VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT)
+			                                  .with_debug_name("GUI retained index buffer")
+			                                  .build_unique(sample.get_render_context().get_device());
+		}
+
+		upload_draw_data(draw_data, retained_frame.vertex_buffer->map(), retained_frame.index_buffer->map());
+
+		retained_frame.vertex_buffer->flush();
+		retained_frame.index_buffer->flush();
+
+		auto &retained_command_buffer = *retained_frame.command_buffer;
+
+		retained_command_buffer.reset(vkb::core::HPPCommandBuffer::ResetMode::ResetIndividually);
+		retained_command_buffer.begin(vk::CommandBufferUsageFlagBits::eRenderPassContinue, render_pass_binding.render_pass, nullptr,
+		                              command_buffer.get_current_subpass_index());
+
+		retained_command_buffer.set_viewport(0, {vk::Viewport(0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f)});
+
+		set_draw_state(retained_command_buffer);
+
+		std::vector<std::reference_wrapper<const vkb::core::HPPBuffer>> buffers;
+		buffers.push_back(*retained_frame.vertex_buffer);
+		retained_command_buffer.bind_vertex_buffers(0, buffers, {0});
+
+		retained_command_buffer.bind_index_buffer(*retained_frame.index_buffer, 0, vk::IndexType::eUint16);
+
+		draw_commands(retained_command_buffer);
+
+		retained_command_buffer.end();
+
+		retained_frame.key = key;
+	}
+
+	command_buffer.execute_commands(*retained_frame.command_buffer);
+
+	return true;
+}
+
+void HPPGui::set_draw_state(vkb::core::HPPCommandBuffer &command_buffer)
+{
 	// Vertex input state
 	vk::VertexInputBindingDescription vertex_input_binding({}, to_u32(sizeof(ImDrawVert)));
 
@@ -537,22 +726,11 @@ void HPPGui::draw(vkb::core::HPPCommandBuffer &command_buffer)
 
 	// Push constants
 	command_buffer.push_constants(push_transform);
+}
 
-	// If a render context is used, then use the frames buffer pools to allocate GUI vertex/index data from
-	if (!explicit_update)
-	{
-		update_buffers(command_buffer);
-	}
-	else
-	{
-		std::vector<std::reference_wrapper<const vkb::core::HPPBuffer>> buffers;
-		buffers.push_back(*vertex_buffer);
-		command_buffer.bind_vertex_buffers(0, buffers, {0});
-
-		command_buffer.bind_index_buffer(*index_buffer, 0, vk::IndexType::eUint16);
-	}
-
-	// Render commands
+void HPPGui::draw_commands(vkb::core::HPPCommandBuffer &command_buffer)
+{
+	auto       &io            = ImGui::GetIO();
 	ImDrawData *draw_data     = ImGui::GetDrawData();
 	int32_t     vertex_offset = 0;
 	uint32_t    index_offset  = 0;
@@ -609,6 +787,28 @@ void HPPGui::draw(vkb::core::HPPCommandBuffer &command_buffer)
 	}
 }
 
+HPPGui::RetainedFrame &HPPGui::get_retained_frame(vkb::rendering::HPPRenderFrame &render_frame, uint32_t queue_family_index)
+{
+	auto it = std::find_if(retained_frames.begin(), retained_frames.end(),
+	                       [&render_frame](const RetainedFrame &retained_frame) { return retained_frame.render_frame == &render_frame; });
+
+	if (it != retained_frames.end())
+	{
+		return *it;
+	}
+
+	// The frames of a render context are never destroyed, only updated with new render targets
+	RetainedFrame retained_frame;
+	retained_frame.render_frame   = &render_frame;
+	retained_frame.command_pool   = std::make_unique<vkb::core::HPPCommandPool>(sample.get_render_context().get_device(), queue_family_index, &render_frame, 0,
+	                                                                            vkb::core::HPPCommandBuffer::ResetMode::ResetIndividually);
+	retained_frame.command_buffer = &retained_frame.command_pool->request_command_buffer(vk::CommandBufferLevel::eSecondary);
+
+	retained_frames.push_back(std::move(retained_frame));
+
+	return retained_frames.back();
+}
+
 void HPPGui::draw(vk::CommandBuffer command_buffer) const
 {
 	if (!visible)
@@ -20,6 +20,7 @@
 #include <imgui.h>
 
 #include "core/hpp_command_buffer.h"
+#include "core/hpp_command_pool.h"
 #include "core/hpp_image_view.h"
 #include "core/hpp_pipeline_layout.h"
 #include "debug_info.h"
@@ -27,6 +28,7 @@
 #include "filesystem/legacy.h"
 #include "platform/input_events.h"
 #include "stats/hpp_stats.h"
+#include "upload_manager.h"
 
 namespace vkb
 {
@@ -107,6 +109,8 @@ class HPPGui
 	static const std::string default_font;
 	// Used to show/hide the GUI
 	static bool visible;
+	// Whether the GUI commands are retained in a secondary command buffer per frame, see vkb::Gui::retained
+	static bool retained;
 
   public:
 	/**
@@ -149,6 +153,10 @@ class HPPGui
 	 */
 	void update(float delta_time);
 
+	/**
+	 * @brief Writes the draw data into the buffers of the explicit updates, unless they already hold it
+	 * @return Whether the command buffers recorded with draw(vk::CommandBuffer) are out of date and must be recorded again
+	 */
 	bool update_buffers();
 
 	/**
@@ -163,6 +171,13 @@ class HPPGui
 	 */
 	void draw(vk::CommandBuffer command_buffer) const;
 
+	/**
+	 * @brief Executes the retained command buffer of the active frame, recording it again if it is out of date
+	 * @param command_buffer Primary command buffer in a subpass with secondary command buffer contents
+	 * @return Whether the HPPGui was drawn, if not it cannot be retained and must be drawn with draw()
+	 */
+	bool draw_retained(vkb::core::HPPCommandBuffer &command_buffer);
+
 	/**
 	 * @brief Shows an overlay top window with app info and maybe stats
 	 * @param app_name Application name
@@ -226,6 +241,16 @@ class HPPGui
 	 */
 	void update_buffers(vkb::core::HPPCommandBuffer &command_buffer) const;
 
+	/**
+	 * @brief Sets the pipeline state, the font image and the push constants of the draw commands
+	 */
+	void set_draw_state(vkb::core::HPPCommandBuffer &command_buffer);
+
+	/**
+	 * @brief Records the draw commands of the draw data, from the bound vertex and index buffers
+	 */
+	void draw_commands(vkb::core::HPPCommandBuffer &command_buffer);
+
   private:
 	/**
 	 * @brief Helper class for rendering debug statistics in the GUI
@@ -244,6 +269,26 @@ class HPPGui
 		glm::vec2 translate;
 	};
 
+	/**
+	 * @brief A secondary command buffer holding the HPPGui commands of a frame, with the buffers it draws from
+	 */
+	struct RetainedFrame
+	{
+		vkb::rendering::HPPRenderFrame            *render_frame = nullptr;
+		std::unique_ptr<vkb::core::HPPCommandPool> command_pool;
+		vkb::core::HPPCommandBuffer               *command_buffer = nullptr;
+		std::unique_ptr<vkb::core::HPPBuffer>      vertex_buffer;
+		std::unique_ptr<vkb::core::HPPBuffer>      index_buffer;
+		size_t                                     vertex_buffer_capacity = 0;
+		size_t                                     index_buffer_capacity  = 0;
+		size_t                                     key                    = 0;        // Hash of what the command buffer was recorded for, zero if it was not recorded
+	};
+
+	/**
+	 * @return The retained command buffer of a frame, created on first use with a pool of the queue family
+	 */
+	RetainedFrame &get_retained_frame(vkb::rendering::HPPRenderFrame &render_frame, uint32_t queue_family_index);
+
   private:
 	/**
 	 * @brief Block size of a buffer pool in kilobytes
@@ -261,8 +306,10 @@ class HPPGui
 	VulkanSample<vkb::BindingType::Cpp>     &sample;
 	std::unique_ptr<vkb::core::HPPBuffer>    vertex_buffer;
 	std::unique_ptr<vkb::core::HPPBuffer>    index_buffer;
-	size_t                                   last_vertex_buffer_size = 0;
-	size_t                                   last_index_buffer_size  = 0;
+	size_t                                   vertex_buffer_capacity  = 0;
+	size_t                                   index_buffer_capacity   = 0;
+	size_t                                   last_draw_data_hash     = 0;
+	size_t                                   last_draw_commands_hash = 0;
 	float                                    content_scale_factor    = 1.0f;        // Scale factor to apply due to a difference between the window and GL pixel sizes
 	float                                    dpi_factor              = 1.0f;        // Scale factor to apply to the size of gui elements (expressed in dp)
 	bool                                     explicit_update         = false;
@@ -270,6 +317,7 @@ class HPPGui
 	std::vector<HPPFont>                     fonts;
 	std::unique_ptr<vkb::core::HPPImage>     font_image;
 	std::unique_ptr<vkb::core::HPPImageView> font_image_view;
+	std::unique_ptr<vkb::UploadManager>      font_upload_manager;        // Mirrors vkb::Gui, uploading the font image is not supported by the hpp framework
 	std::unique_ptr<vkb::core::HPPSampler>   sampler;
 	vkb::core::HPPPipelineLayout            *pipeline_layout = nullptr;
 	StatsView                                stats_view;
@@ -283,5 +331,6 @@ class HPPGui
 	bool                                     two_finger_tap         = false;        // Whether or not the GUI has detected a multi touch gesture
 	bool                                     show_graph_file_output = false;
 	uint32_t                                 subpass                = 0;
+	std::vector<RetainedFrame>               retained_frames;
 };
 }        // namespace vkb
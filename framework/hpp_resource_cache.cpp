@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,24 +17,64 @@
 
 #include "hpp_resource_cache.h"
 #include <common/hpp_resource_caching.h>
+#include <common/resource_cache_lookup.h>
 #include <core/hpp_descriptor_set.h>
 #include <core/hpp_device.h>
 #include <core/hpp_image_view.h>
 #include <core/hpp_pipeline_layout.h>
 
+#include <ctpl_stl.h>
+
 namespace vkb
 {
 namespace
 {
 template <class T, class... A>
-T &request_resource(
-    vkb::core::HPPDevice &device, vkb::HPPResourceRecord &recorder, std::mutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, A &...args)
+T &request_resource(vkb::core::HPPDevice               &device,
+                    vkb::HPPResourceRecord             &recorder,
+                    std::mutex                         &resource_mutex,
+                    std::atomic<uint32_t>              &contention_count,
+                    ReadMostlyMap<T>                   &index,
+                    std::unordered_map<std::size_t, T> &resources,
+                    A &...args)
+{
+	size_t hash{0U};
+	hash_param(hash, args...);
+
+	return vkb::common::request_indexed_resource(hash, resource_mutex, contention_count, index, [&]() -> T & {
+		return vkb::common::request_resource(device, &recorder, resources, args...);
+	});
+}
+
+/**
+ * @brief Variant of request_resource which builds a missing object outside of the resource lock
+ *
+ * See the vkb::ResourceCache implementation for documentation
+ */
+template <class T, class... A>
+T &request_resource(vkb::core::HPPDevice               &device,
+                    vkb::HPPResourceRecord             &recorder,
+                    std::mutex                         &recorder_mutex,
+                    std::mutex                         &resource_mutex,
+                    std::atomic<uint32_t>              &contention_count,
+                    ReadMostlyMap<T>                   &index,
+                    std::unordered_map<std::size_t, T> &resources,
+                    A &...args)
 {
-	std::lock_guard<std::mutex> guard(resource_mutex);
+	size_t hash{0U};
+	hash_param(hash, args...);
 
-	auto &res = vkb::common::request_resource(device, &recorder, resources, args...);
+	return vkb::common::request_concurrent_resource(
+	    hash, resource_mutex, contention_count, index, resources,
+	    [&]() { return T(device, args...); },
+	    [&](T &resource) {
+		    std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
 
-	return res;
+		    vkb::common::HPPRecordHelper<T, A...> record_helper;
+
+		    size_t record_index = record_helper.record(recorder, args...);
+		    record_helper.index(recorder, record_index, resource);
+	    });
 }
 }        // namespace
 
@@ -42,26 +82,61 @@ HPPResourceCache::HPPResourceCache(vkb::core::HPPDevice &device) :
     device{device}
 {}
 
+HPPResourceCache::~HPPResourceCache()
+{
+	wait_shader_poll();
+	wait_warmup();
+	wait_pipeline_compilations();
+	wait_optimized_pipelines();
+}
+
 void HPPResourceCache::clear()
 {
+	wait_shader_poll();
+	wait_warmup();
+
+	index.shader_modules.clear();
+	index.pipeline_layouts.clear();
+	index.descriptor_sets.clear();
+	index.descriptor_pools.clear();
+	index.descriptor_set_layouts.clear();
+	index.render_passes.clear();
 	state.shader_modules.clear();
 	state.pipeline_layouts.clear();
 	state.descriptor_sets.clear();
+	state.descriptor_pools.clear();
 	state.descriptor_set_layouts.clear();
 	state.render_passes.clear();
+	index.samplers.clear();
+	state.samplers.clear();
+	render_pass_generations.clear();
 	clear_pipelines();
 	clear_framebuffers();
 }
 
 void HPPResourceCache::clear_framebuffers()
 {
+	index.framebuffers.clear();
 	state.framebuffers.clear();
 }
 
 void HPPResourceCache::clear_pipelines()
 {
+	wait_pipeline_compilations();
+	wait_optimized_pipelines();
+
+	failed_pipeline_compilations.clear();
+
+	optimized_pipelines.clear();
+
+	index.graphics_pipelines.clear();
+	index.graphics_pipeline_libraries.clear();
+	index.compute_pipelines.clear();
+	index.shader_objects.clear();
 	state.graphics_pipelines.clear();
+	state.graphics_pipeline_libraries.clear();
 	state.compute_pipelines.clear();
+	state.shader_objects.clear();
 }
 
 const HPPResourceCacheState &HPPResourceCache::get_internal_state() const
@@ -69,47 +144,52 @@ const HPPResourceCacheState &HPPResourceCache::get_internal_state() const
 	return state;
 }
 
+uint32_t HPPResourceCache::get_lock_contention_count() const
+{
+	return lock_contention_count;
+}
+
 vkb::core::HPPComputePipeline &HPPResourceCache::request_compute_pipeline(vkb::rendering::HPPPipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, compute_pipeline_mutex, state.compute_pipelines, pipeline_cache, pipeline_state);
+	return request_resource(device, recorder, recorder_mutex, compute_pipeline_mutex, lock_contention_count, index.compute_pipelines, state.compute_pipelines, pipeline_cache, pipeline_state);
 }
 
 vkb::core::HPPDescriptorSet &HPPResourceCache::request_descriptor_set(vkb::core::HPPDescriptorSetLayout          &descriptor_set_layout,
                                                                       const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
                                                                       const BindingMap<vk::DescriptorImageInfo>  &image_infos)
 {
-	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, state.descriptor_pools, descriptor_set_layout);
-	return request_resource(device, recorder, descriptor_set_mutex, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, lock_contention_count, index.descriptor_pools, state.descriptor_pools, descriptor_set_layout);
+	return request_resource(device, recorder, descriptor_set_mutex, lock_contention_count, index.descriptor_sets, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
 }
 
 vkb::core::HPPDescriptorSetLayout &HPPResourceCache::request_descriptor_set_layout(const uint32_t                                   set_index,
                                                                                    const std::vector<vkb::core::HPPShaderModule *> &shader_modules,
                                                                                    const std::vector<vkb::core::HPPShaderResource> &set_resources)
 {
-	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	return request_resource(device, recorder, recorder_mutex, descriptor_set_layout_mutex, lock_contention_count, index.descriptor_set_layouts, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
 }
 
 vkb::core::HPPFramebuffer &HPPResourceCache::request_framebuffer(const vkb::rendering::HPPRenderTarget &render_target,
                                                                  const vkb::core::HPPRenderPass        &render_pass)
 {
-	return request_resource(device, recorder, framebuffer_mutex, state.framebuffers, render_target, render_pass);
+	return request_resource(device, recorder, framebuffer_mutex, lock_contention_count, index.framebuffers, state.framebuffers, render_target, render_pass);
 }
 
 vkb::core::HPPGraphicsPipeline &HPPResourceCache::request_graphics_pipeline(vkb::rendering::HPPPipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, graphics_pipeline_mutex, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	return request_resource(device, recorder, recorder_mutex, graphics_pipeline_mutex, lock_contention_count, index.graphics_pipelines, state.graphics_pipelines, pipeline_cache, pipeline_state);
 }
 
 vkb::core::HPPPipelineLayout &HPPResourceCache::request_pipeline_layout(const std::vector<vkb::core::HPPShaderModule *> &shader_modules)
 {
-	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
+	return request_resource(device, recorder, recorder_mutex, pipeline_layout_mutex, lock_contention_count, index.pipeline_layouts, state.pipeline_layouts, shader_modules);
 }
 
 vkb::core::HPPRenderPass &HPPResourceCache::request_render_pass(const std::vector<vkb::rendering::HPPAttachment> &attachments,
                                                                 const std::vector<vkb::common::HPPLoadStoreInfo> &load_store_infos,
                                                                 const std::vector<vkb::core::HPPSubpassInfo>     &subpasses)
 {
-	return request_resource(device, recorder, render_pass_mutex, state.render_passes, attachments, load_store_infos, subpasses);
+	return request_resource(device, recorder, recorder_mutex, render_pass_mutex, lock_contention_count, index.render_passes, state.render_passes, attachments, load_store_infos, subpasses);
 }
 
 vkb::core::HPPShaderModule &HPPResourceCache::request_shader_module(vk::ShaderStageFlagBits            stage,
@@ -117,7 +197,7 @@ vkb::core::HPPShaderModule &HPPResourceCache::request_shader_module(vk::ShaderSt
                                                                     const vkb::core::HPPShaderVariant &shader_variant)
 {
 	std::string entry_point{"main"};
-	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
+	return request_resource(device, recorder, recorder_mutex, shader_module_mutex, lock_contention_count, index.shader_modules, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
 }
 
 std::vector<uint8_t> HPPResourceCache::serialize()
@@ -128,6 +208,7 @@ std::vector<uint8_t> HPPResourceCache::serialize()
 void HPPResourceCache::set_pipeline_cache(vk::PipelineCache new_pipeline_cache)
 {
 	pipeline_cache = new_pipeline_cache;
+	worker_pipeline_caches.clear();
 }
 
 void HPPResourceCache::update_descriptor_sets(const std::vector<vkb::core::HPPImageView> &old_views, const std::vector<vkb::core::HPPImageView> &new_views)
@@ -201,12 +282,114 @@ void HPPResourceCache::update_descriptor_sets(const std::vector<vkb::core::HPPIm
 		// Add (key, resource) to the cache
 		state.descriptor_sets.emplace(new_key, std::move(descriptor_set));
 	}
+
+	// Moved descriptor sets live at new addresses, so the lookup index has to be rebuilt
+	if (!matches.empty())
+	{
+		vkb::common::rebuild_index(index.descriptor_sets, state.descriptor_sets);
+	}
+}
+
+void HPPResourceCache::wait_optimized_pipelines()
+{
+	std::vector<std::future<void>> optimizations;
+
+	{
+		std::lock_guard<std::mutex> optimized_guard(optimized_pipeline_mutex);
+		optimizations.swap(pipeline_optimizations);
+	}
+
+	for (auto &optimization : optimizations)
+	{
+		try
+		{
+			optimization.get();
+		}
+		catch (const std::exception &e)
+		{
+			LOGE("Optimized pipeline compilation failed: {}", e.what());
+		}
+	}
+}
+
+void HPPResourceCache::wait_pipeline_compilations()
+{
+	std::vector<JobHandle> compilations;
+
+	{
+		std::lock_guard<std::mutex> guard(pipeline_compilation_mutex);
+
+		for (auto &compilation : pipeline_compilations)
+		{
+			compilations.push_back(compilation.second);
+		}
+	}
+
+	JobSystem::get().wait(compilations);
+}
+
+void HPPResourceCache::wait_shader_poll()
+{
+	if (shader_poll_job.is_valid())
+	{
+		JobSystem::get().wait(shader_poll_job);
+		shader_poll_job = {};
+	}
+}
+
+void HPPResourceCache::wait_warmup()
+{
+	if (warmup_future.valid())
+	{
+		try
+		{
+			warmup_future.get();
+		}
+		catch (const std::exception &e)
+		{
+			LOGE("Resource cache warmup failed: {}", e.what());
+		}
+
+		warmup_future = {};
+	}
 }
 
 void HPPResourceCache::warmup(const std::vector<uint8_t> &data)
 {
-	recorder.set_data(data);
+	wait_warmup();
+
+	{
+		std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+		recorder.set_data(data);
+	}
 
 	replayer.play(*this, recorder);
 }
+
+std::shared_future<void> HPPResourceCache::warmup_async(const std::vector<uint8_t> &data, uint32_t thread_count, HPPResourceReplay::ProgressCallback progress_callback)
+{
+	wait_warmup();
+
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	if (!warmup_thread_pool || warmup_thread_pool->size() != static_cast<int>(thread_count))
+	{
+		warmup_thread_pool = std::make_unique<ctpl::thread_pool>(thread_count);
+	}
+
+	{
+		std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+		recorder.set_data(data);
+	}
+
+	// The replay reads its own copy of the data, as the requests of other threads keep recording while it runs
+	warmup_future = std::async(std::launch::async, [this, data, progress_callback]() {
+		                replayer.play_parallel(*this, data, *warmup_thread_pool, progress_callback);
+	                }).share();
+
+	return warmup_future;
+}
 }        // namespace vkb
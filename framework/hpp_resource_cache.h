@@ -21,10 +21,21 @@
 #include <core/hpp_framebuffer.h>
 #include <core/hpp_pipeline_layout.h>
 #include <core/hpp_render_pass.h>
+#include <core/hpp_sampler.h>
+#include <core/pipeline.h>
+#include <core/util/read_mostly_map.hpp>
 #include <hpp_resource_record.h>
 #include <hpp_resource_replay.h>
+#include <resource_cache.h>
 #include <vulkan/vulkan.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
 namespace vkb
 {
 namespace core
@@ -42,6 +53,7 @@ class HPPRenderTarget;
 /**
  * @brief Struct to hold the internal state of the Resource Cache
  *
+ * Mirrors vkb::ResourceCacheState, the resources not supported by the hpp framework keep their vkb types
  */
 struct HPPResourceCacheState
 {
@@ -51,15 +63,40 @@ struct HPPResourceCacheState
 	std::unordered_map<std::size_t, vkb::core::HPPDescriptorPool>      descriptor_pools;
 	std::unordered_map<std::size_t, vkb::core::HPPRenderPass>          render_passes;
 	std::unordered_map<std::size_t, vkb::core::HPPGraphicsPipeline>    graphics_pipelines;
+	std::unordered_map<std::size_t, vkb::GraphicsPipelineLibrary>      graphics_pipeline_libraries;
 	std::unordered_map<std::size_t, vkb::core::HPPComputePipeline>     compute_pipelines;
+	std::unordered_map<std::size_t, vkb::ShaderObject>                 shader_objects;
 	std::unordered_map<std::size_t, vkb::core::HPPDescriptorSet>       descriptor_sets;
 	std::unordered_map<std::size_t, vkb::core::HPPFramebuffer>         framebuffers;
+	std::unordered_map<std::size_t, vkb::core::HPPSampler>             samplers;
+};
+
+/**
+ * @brief vulkan.hpp version of the vkb::ResourceCacheIndex struct
+ */
+struct HPPResourceCacheIndex
+{
+	ReadMostlyMap<vkb::core::HPPShaderModule>        shader_modules;
+	ReadMostlyMap<vkb::core::HPPPipelineLayout>      pipeline_layouts;
+	ReadMostlyMap<vkb::core::HPPDescriptorSetLayout> descriptor_set_layouts;
+	ReadMostlyMap<vkb::core::HPPDescriptorPool>      descriptor_pools;
+	ReadMostlyMap<vkb::core::HPPRenderPass>          render_passes;
+	ReadMostlyMap<vkb::core::HPPGraphicsPipeline>    graphics_pipelines;
+	ReadMostlyMap<vkb::GraphicsPipelineLibrary>      graphics_pipeline_libraries;
+	ReadMostlyMap<vkb::core::HPPComputePipeline>     compute_pipelines;
+	ReadMostlyMap<vkb::ShaderObject>                 shader_objects;
+	ReadMostlyMap<vkb::core::HPPDescriptorSet>       descriptor_sets;
+	ReadMostlyMap<vkb::core::HPPFramebuffer>         framebuffers;
+	ReadMostlyMap<vkb::core::HPPSampler>             samplers;
 };
 
 /**
  * @brief vulkan.hpp version of the vkb::ResourceCache class
  *
  * See vkb::ResourceCache for documentation
+ *
+ * The members mirror the ones of vkb::ResourceCache, as the cache of a vkb::Device is destroyed as a HPPResourceCache.
+ * The features not supported by the hpp framework keep their vkb types.
  */
 class HPPResourceCache
 {
@@ -70,11 +107,13 @@ class HPPResourceCache
 	HPPResourceCache(HPPResourceCache &&)                 = delete;
 	HPPResourceCache &operator=(const HPPResourceCache &) = delete;
 	HPPResourceCache &operator=(HPPResourceCache &&)      = delete;
+	~HPPResourceCache();
 
 	void                               clear();
 	void                               clear_framebuffers();
 	void                               clear_pipelines();
 	const HPPResourceCacheState       &get_internal_state() const;
+	uint32_t                           get_lock_contention_count() const;
 	vkb::core::HPPComputePipeline     &request_compute_pipeline(vkb::rendering::HPPPipelineState &pipeline_state);
 	vkb::core::HPPDescriptorSet       &request_descriptor_set(vkb::core::HPPDescriptorSetLayout          &descriptor_set_layout,
 	                                                          const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
@@ -98,21 +137,58 @@ class HPPResourceCache
 	/// @param new_views New image views to be referred
 	void update_descriptor_sets(const std::vector<vkb::core::HPPImageView> &old_views, const std::vector<vkb::core::HPPImageView> &new_views);
 
-	void warmup(const std::vector<uint8_t> &data);
+	void                     wait_optimized_pipelines();
+	void                     wait_pipeline_compilations();
+	void                     wait_shader_poll();
+	void                     wait_warmup();
+	void                     warmup(const std::vector<uint8_t> &data);
+	std::shared_future<void> warmup_async(const std::vector<uint8_t> &data, uint32_t thread_count = 0, HPPResourceReplay::ProgressCallback progress_callback = {});
 
   private:
-	vkb::core::HPPDevice  &device;
-	vkb::HPPResourceRecord recorder                    = {};
-	vkb::HPPResourceReplay replayer                    = {};
-	vk::PipelineCache      pipeline_cache              = nullptr;
-	HPPResourceCacheState  state                       = {};
-	std::mutex             descriptor_set_mutex        = {};
-	std::mutex             pipeline_layout_mutex       = {};
-	std::mutex             shader_module_mutex         = {};
-	std::mutex             descriptor_set_layout_mutex = {};
-	std::mutex             graphics_pipeline_mutex     = {};
-	std::mutex             render_pass_mutex           = {};
-	std::mutex             compute_pipeline_mutex      = {};
-	std::mutex             framebuffer_mutex           = {};
+	vkb::core::HPPDevice                                                 &device;
+	vkb::HPPResourceRecord                                               recorder                          = {};
+	vkb::HPPResourceReplay                                               replayer                          = {};
+	vk::PipelineCache                                                    pipeline_cache                    = nullptr;
+	std::vector<vk::PipelineCache>                                       worker_pipeline_caches            = {};
+	HPPResourceCacheState                                                state                             = {};
+	HPPResourceCacheIndex                                                index;
+	std::atomic<uint32_t>                                                lock_contention_count             = {0};
+	uint64_t                                                             generation                        = 0;
+	std::unordered_map<VkRenderPass, uint64_t>                           render_pass_generations           = {};
+	std::unique_ptr<ctpl::thread_pool>                                   warmup_thread_pool                = {};
+	std::shared_future<void>                                             warmup_future                     = {};
+	std::unique_ptr<ctpl::thread_pool>                                   pipeline_optimization_thread_pool = {};
+	std::vector<std::future<void>>                                       pipeline_optimizations            = {};
+	std::vector<std::pair<std::size_t, vkb::GraphicsPipeline>>           optimized_pipelines               = {};
+	std::mutex                                                           optimized_pipeline_mutex          = {};
+	PipelineCompileMode                                                  pipeline_compile_mode             = PipelineCompileMode::Inline;
+	ResourceCache::PipelineFallbackFunction                              pipeline_fallback                 = {};
+	std::unordered_map<std::size_t, JobHandle>                           pipeline_compilations             = {};
+	std::unordered_set<std::size_t>                                      failed_pipeline_compilations      = {};
+	std::mutex                                                           pipeline_compilation_mutex        = {};
+	std::atomic<uint32_t>                                                pipeline_compile_queue_depth      = {0};
+	std::atomic<uint32_t>                                                pipeline_compile_stall_count      = {0};
+	std::atomic<bool>                                                    shader_hot_reload                 = {false};
+	std::atomic<uint32_t>                                                shader_generation                 = {0};
+	std::unordered_map<std::string, ResourceCache::WatchedShaderFile>    watched_shader_files              = {};
+	std::unordered_set<std::string>                                      unwatched_shader_files            = {};
+	std::unordered_map<std::string, ResourceCache::ReloadedShaderSource> pending_shader_sources            = {};
+	std::unordered_map<std::string, ResourceCache::ReloadedShaderSource> reloaded_shader_sources           = {};
+	std::mutex                                                           shader_hot_reload_mutex           = {};
+	JobHandle                                                            shader_poll_job                   = {};
+	std::chrono::steady_clock::time_point                                last_shader_poll                  = {};
+	std::mutex                                                           recorder_mutex                    = {};
+	std::mutex                                                           descriptor_set_mutex              = {};
+	std::mutex                                                           pipeline_layout_mutex             = {};
+	std::mutex                                                           shader_module_mutex               = {};
+	std::mutex                                                           descriptor_set_layout_mutex       = {};
+	std::mutex                                                           graphics_pipeline_mutex           = {};
+	std::mutex                                                           graphics_pipeline_library_mutex   = {};
+	std::mutex                                                           render_pass_mutex                 = {};
+	std::mutex                                                           compute_pipeline_mutex            = {};
+	std::mutex                                                           shader_object_mutex               = {};
+	std::mutex                                                           framebuffer_mutex                 = {};
+	std::mutex                                                           sampler_mutex                     = {};
+	std::mutex                                                           image_view_mutex                  = {};
 };
 }        // namespace vkb
@@ -32,9 +32,19 @@ class HPPResourceRecord;
 class HPPResourceReplay : private vkb::ResourceReplay
 {
   public:
+	using vkb::ResourceReplay::ProgressCallback;
+
 	void play(vkb::HPPResourceCache &resource_cache, vkb::HPPResourceRecord &recorder)
 	{
 		vkb::ResourceReplay::play(reinterpret_cast<vkb::ResourceCache &>(resource_cache), reinterpret_cast<vkb::ResourceRecord &>(recorder));
 	}
+
+	void play_parallel(vkb::HPPResourceCache      &resource_cache,
+	                   const std::vector<uint8_t> &data,
+	                   ctpl::thread_pool          &thread_pool,
+	                   const ProgressCallback     &progress_callback = {})
+	{
+		vkb::ResourceReplay::play_parallel(reinterpret_cast<vkb::ResourceCache &>(resource_cache), data, thread_pool, progress_callback);
+	}
 };
 }        // namespace vkb
@@ -0,0 +1,167 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_defragmenter.h"
+
+#include "core/device.h"
+#include "core/util/logging.hpp"
+#include "resource_cache.h"
+
+#include <algorithm>
+
+namespace vkb
+{
+MemoryDefragmenter::MemoryDefragmenter(Device &device, allocated::MemoryTag tag, VkDeviceSize max_bytes_per_pass, uint32_t max_moves_per_pass) :
+    device{device},
+    tag{tag},
+    max_bytes_per_pass{max_bytes_per_pass},
+    max_moves_per_pass{max_moves_per_pass}
+{
+}
+
+MemoryDefragmenter::~MemoryDefragmenter()
+{
+	end_defragmentation();
+}
+
+bool MemoryDefragmenter::is_needed() const
+{
+	if (context != VK_NULL_HANDLE)
+	{
+		return true;
+	}
+
+	auto pools = allocated::get_memory_pools(tag);
+	return std::any_of(pools.begin(), pools.end(), [this](VmaPool pool) { return is_fragmented(pool); });
+}
+
+uint32_t MemoryDefragmenter::run_pass()
+{
+	auto &allocator = allocated::get_memory_allocator();
+
+	if (context == VK_NULL_HANDLE)
+	{
+		auto pools = allocated::get_memory_pools(tag);
+		auto it    = std::find_if(pools.begin(), pools.end(), [this](VmaPool pool) { return is_fragmented(pool); });
+		if (it == pools.end())
+		{
+			return 0;
+		}
+
+		VmaDefragmentationInfo defragmentation_info{};
+		defragmentation_info.flags                 = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+		defragmentation_info.pool                  = *it;
+		defragmentation_info.maxBytesPerPass       = max_bytes_per_pass;
+		defragmentation_info.maxAllocationsPerPass = max_moves_per_pass;
+
+		VK_CHECK(vmaBeginDefragmentation(allocator, &defragmentation_info, &context));
+	}
+
+	VmaDefragmentationPassMoveInfo pass{};
+	if (vmaBeginDefragmentationPass(allocator, context, &pass) == VK_SUCCESS)
+	{
+		end_defragmentation();
+		return 0;
+	}
+
+	// Resources which cannot move keep their memory
+	VkCommandBuffer command_buffer = device.create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+
+	std::vector<std::pair<allocated::AllocatedBase *, VmaAllocation>> moving_resources;
+	for (uint32_t i = 0; i < pass.moveCount; ++i)
+	{
+		auto &move     = pass.pMoves[i];
+		auto *resource = allocated::find_pooled_resource(move.srcAllocation);
+
+		if (resource && resource->begin_move(command_buffer, move.dstTmpAllocation))
+		{
+			moving_resources.emplace_back(resource, move.srcAllocation);
+		}
+		else
+		{
+			move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+		}
+	}
+
+	device.flush_command_buffer(command_buffer, device.get_suitable_graphics_queue().get_handle());
+
+	std::vector<VkImageView> old_views;
+	std::vector<VkImageView> new_views;
+	for (auto &resource_allocation : moving_resources)
+	{
+		resource_allocation.first->end_move(old_views, new_views);
+
+		VmaAllocationInfo allocation_info{};
+		vmaGetAllocationInfo(allocator, resource_allocation.second, &allocation_info);
+		moved_bytes += allocation_info.size;
+	}
+
+	if (!old_views.empty())
+	{
+		device.get_resource_cache().update_descriptor_sets(old_views, new_views);
+
+		for (VkImageView old_view : old_views)
+		{
+			vkDestroyImageView(device.get_handle(), old_view, nullptr);
+		}
+	}
+
+	if (!moving_resources.empty())
+	{
+		allocated::next_move_generation();
+	}
+
+	if (vmaEndDefragmentationPass(allocator, context, &pass) == VK_SUCCESS)
+	{
+		end_defragmentation();
+	}
+
+	return to_u32(moving_resources.size());
+}
+
+std::pair<VkDeviceSize, VkDeviceSize> MemoryDefragmenter::get_moved_and_freed_bytes() const
+{
+	return {moved_bytes, freed_bytes};
+}
+
+bool MemoryDefragmenter::is_fragmented(VmaPool pool) const
+{
+	VmaStatistics statistics{};
+	vmaGetPoolStatistics(allocated::get_memory_allocator(), pool, &statistics);
+
+	// Compacting is worth it once the free memory between the allocations would fill a block, which could then be released
+	auto config = allocated::get_memory_pool_config(tag);
+	return statistics.blockCount > 1 && statistics.blockBytes - statistics.allocationBytes >= config.block_size;
+}
+
+void MemoryDefragmenter::end_defragmentation()
+{
+	if (context == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	VmaDefragmentationStats stats{};
+	vmaEndDefragmentation(allocated::get_memory_allocator(), context, &stats);
+	context = VK_NULL_HANDLE;
+
+	freed_bytes += stats.bytesFreed;
+
+	LOGD("Memory defragmenter: {} pool compacted, {} bytes moved, {} blocks released", allocated::to_string(tag), stats.bytesMoved,
+	     stats.deviceMemoryBlocksFreed);
+}
+}        // namespace vkb
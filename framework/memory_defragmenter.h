@@ -0,0 +1,91 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "core/allocated.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Compacts the memory pools of a subsystem, see allocated::get_memory_pools(), with incremental passes which move
+ *        a bounded amount of memory each
+ *
+ *        Resources move with copies on the graphics queue, after which the descriptor sets of the resource cache referring
+ *        to the moved image views are updated, and the move generation is increased for the caches of other handles.
+ *        Only images move, the other resources of the pools keep their memory.
+ */
+class MemoryDefragmenter
+{
+  public:
+	/**
+	 * @param device The device
+	 * @param tag The subsystem whose pools are compacted
+	 * @param max_bytes_per_pass The most memory a pass moves
+	 * @param max_moves_per_pass The most resources a pass moves
+	 */
+	MemoryDefragmenter(Device &device, allocated::MemoryTag tag, VkDeviceSize max_bytes_per_pass, uint32_t max_moves_per_pass);
+
+	MemoryDefragmenter(const MemoryDefragmenter &) = delete;
+
+	MemoryDefragmenter(MemoryDefragmenter &&) = delete;
+
+	~MemoryDefragmenter();
+
+	MemoryDefragmenter &operator=(const MemoryDefragmenter &) = delete;
+
+	MemoryDefragmenter &operator=(MemoryDefragmenter &&) = delete;
+
+	/**
+	 * @return Whether a pass has work to do: a defragmentation is in progress, or the free memory of a pool would fill a block
+	 */
+	bool is_needed() const;
+
+	/**
+	 * @brief Runs a pass, starting the defragmentation of the next fragmented pool if none is in progress
+	 *        The resources of the pool must not be in use by the GPU, and the pass waits for its copies to complete.
+	 * @return The number of resources moved
+	 */
+	uint32_t run_pass();
+
+	/**
+	 * @return The memory moved and the memory released to the device since the defragmenter was created, in bytes
+	 */
+	std::pair<VkDeviceSize, VkDeviceSize> get_moved_and_freed_bytes() const;
+
+  private:
+	bool is_fragmented(VmaPool pool) const;
+
+	void end_defragmentation();
+
+	Device &device;
+
+	allocated::MemoryTag tag;
+
+	VkDeviceSize max_bytes_per_pass;
+
+	uint32_t max_moves_per_pass;
+
+	VmaDefragmentationContext context{VK_NULL_HANDLE};
+
+	VkDeviceSize moved_bytes{0};
+
+	VkDeviceSize freed_bytes{0};
+};
+}        // namespace vkb
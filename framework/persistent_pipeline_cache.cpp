@@ -0,0 +1,190 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "persistent_pipeline_cache.h"
+
+#include <cstring>
+
+#include "common/error.h"
+#include "common/helpers.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+
+namespace vkb
+{
+namespace
+{
+// Bump the version whenever the file header changes
+constexpr uint32_t PIPELINE_CACHE_MAGIC   = 0x43504b56;        // "VKPC"
+constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+
+/// Prepended to the Vulkan pipeline cache data, some drivers do not change the cache UUID on every update
+struct PipelineCacheFileHeader
+{
+	uint32_t magic;
+
+	uint32_t version;
+
+	uint32_t driver_version;
+
+	uint32_t data_size;
+};
+
+inline filesystem::Path get_cache_directory()
+{
+	return filesystem::get()->temp_directory() / "vulkan_samples" / "pipeline_cache";
+}
+}        // namespace
+
+PersistentPipelineCache::PersistentPipelineCache(VkDevice device, const VkPhysicalDeviceProperties &properties, const std::string &name, size_t worker_cache_count) :
+    device{device},
+    properties{properties},
+    path{(get_cache_directory() / (name + ".bin")).string()}
+{
+	auto data = load();
+
+	VkPipelineCacheCreateInfo create_info{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+	if (!data.empty())
+	{
+		create_info.initialDataSize = data.size() - sizeof(PipelineCacheFileHeader);
+		create_info.pInitialData    = data.data() + sizeof(PipelineCacheFileHeader);
+	}
+
+	VK_CHECK(vkCreatePipelineCache(device, &create_info, nullptr, &handle));
+
+	// The workers are warm started as well, only what they add is merged back
+	worker_handles.resize(worker_cache_count, VK_NULL_HANDLE);
+	for (auto &worker_handle : worker_handles)
+	{
+		VK_CHECK(vkCreatePipelineCache(device, &create_info, nullptr, &worker_handle));
+	}
+}
+
+PersistentPipelineCache::~PersistentPipelineCache()
+{
+	for (auto worker_handle : worker_handles)
+	{
+		vkDestroyPipelineCache(device, worker_handle, nullptr);
+	}
+
+	vkDestroyPipelineCache(device, handle, nullptr);
+}
+
+VkPipelineCache PersistentPipelineCache::get_handle() const
+{
+	return handle;
+}
+
+const std::vector<VkPipelineCache> &PersistentPipelineCache::get_worker_handles() const
+{
+	return worker_handles;
+}
+
+void PersistentPipelineCache::save()
+{
+	if (!worker_handles.empty())
+	{
+		VkResult result = vkMergePipelineCaches(device, handle, to_u32(worker_handles.size()), worker_handles.data());
+
+		if (result != VK_SUCCESS)
+		{
+			LOGW("Failed to merge worker pipeline caches: {}", to_string(result));
+		}
+	}
+
+	size_t size = 0;
+	if (vkGetPipelineCacheData(device, handle, &size, nullptr) != VK_SUCCESS || size == 0)
+	{
+		return;
+	}
+
+	std::vector<uint8_t> data(sizeof(PipelineCacheFileHeader) + size);
+	if (vkGetPipelineCacheData(device, handle, &size, data.data() + sizeof(PipelineCacheFileHeader)) != VK_SUCCESS)
+	{
+		LOGW("Failed to get pipeline cache data");
+		return;
+	}
+	data.resize(sizeof(PipelineCacheFileHeader) + size);
+
+	PipelineCacheFileHeader header{PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION, properties.driverVersion, to_u32(size)};
+	std::memcpy(data.data(), &header, sizeof(header));
+
+	try
+	{
+		filesystem::get()->write_file_atomic(path, data);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write pipeline cache {}: {}", path, e.what());
+	}
+}
+
+bool PersistentPipelineCache::is_compatible(const std::vector<uint8_t> &data, const VkPhysicalDeviceProperties &properties)
+{
+	PipelineCacheFileHeader         file_header{};
+	VkPipelineCacheHeaderVersionOne cache_header{};
+
+	if (data.size() < sizeof(file_header) + sizeof(cache_header))
+	{
+		return false;
+	}
+
+	std::memcpy(&file_header, data.data(), sizeof(file_header));
+	std::memcpy(&cache_header, data.data() + sizeof(file_header), sizeof(cache_header));
+
+	return file_header.magic == PIPELINE_CACHE_MAGIC &&
+	       file_header.version == PIPELINE_CACHE_VERSION &&
+	       file_header.driver_version == properties.driverVersion &&
+	       file_header.data_size == data.size() - sizeof(file_header) &&
+	       cache_header.headerSize >= sizeof(cache_header) &&
+	       cache_header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+	       cache_header.vendorID == properties.vendorID &&
+	       cache_header.deviceID == properties.deviceID &&
+	       std::memcmp(cache_header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<uint8_t> PersistentPipelineCache::load() const
+{
+	std::vector<uint8_t> data;
+
+	try
+	{
+		auto fs = filesystem::get();
+		if (!fs->is_file(path))
+		{
+			return {};
+		}
+
+		data = fs->read_file_binary(path);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read pipeline cache {}: {}", path, e.what());
+		return {};
+	}
+
+	if (!is_compatible(data, properties))
+	{
+		LOGI("Discarding pipeline cache {}, it was saved by another driver or device", path);
+		return {};
+	}
+
+	LOGI("Loaded pipeline cache {} ({} bytes)", path, data.size() - sizeof(PipelineCacheFileHeader));
+
+	return data;
+}
+}        // namespace vkb
@@ -0,0 +1,86 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/**
+ * @brief A VkPipelineCache which is loaded from and saved to the temporary storage directory
+ *
+ * The saved data is only loaded back if it was written by the same driver on the same device,
+ * as told by the vendor, device and pipeline cache UUID in the Vulkan cache header, and by the driver version.
+ * Additional caches can be created for worker threads, so that they do not contend on the main cache,
+ * they are merged into the main cache on save.
+ */
+class PersistentPipelineCache
+{
+  public:
+	/**
+	 * @brief Creates the pipeline caches, warm started from the saved data if it is compatible
+	 * @param device The device the caches are created on
+	 * @param properties The properties of the physical device of the device
+	 * @param name The name of the cache file, usually the name of the sample
+	 * @param worker_cache_count The number of caches to create for worker threads
+	 */
+	PersistentPipelineCache(VkDevice device, const VkPhysicalDeviceProperties &properties, const std::string &name, size_t worker_cache_count = 0);
+
+	PersistentPipelineCache(const PersistentPipelineCache &) = delete;
+
+	PersistentPipelineCache(PersistentPipelineCache &&) = delete;
+
+	~PersistentPipelineCache();
+
+	PersistentPipelineCache &operator=(const PersistentPipelineCache &) = delete;
+
+	PersistentPipelineCache &operator=(PersistentPipelineCache &&) = delete;
+
+	VkPipelineCache get_handle() const;
+
+	const std::vector<VkPipelineCache> &get_worker_handles() const;
+
+	/**
+	 * @brief Merges the worker caches into the main one, and writes its data to storage
+	 *        The file is replaced atomically, failures are logged and otherwise ignored.
+	 *        Must not be called while pipelines are being created with the worker caches.
+	 */
+	void save();
+
+	/**
+	 * @brief Checks that pipeline cache data, including its file header, was written for these device properties
+	 */
+	static bool is_compatible(const std::vector<uint8_t> &data, const VkPhysicalDeviceProperties &properties);
+
+  private:
+	std::vector<uint8_t> load() const;
+
+	VkDevice device;
+
+	VkPhysicalDeviceProperties properties;
+
+	std::string path;
+
+	VkPipelineCache handle{VK_NULL_HANDLE};
+
+	std::vector<VkPipelineCache> worker_handles;
+};
+}        // namespace vkb
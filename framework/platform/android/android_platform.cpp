@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -379,6 +379,50 @@ void AndroidPlatform::create_window(const Window::Properties &properties)
 	window = std::make_unique<AndroidWindow>(this, app->window, properties);
 }
 
+void AndroidPlatform::on_frame_work(std::chrono::steady_clock::duration frame_duration)
+{
+	// Frames are due on each vsync of the display, or 60 times a second until its refresh period is known
+	std::chrono::nanoseconds target_duration{16666667};
+	std::chrono::nanoseconds wait_time{0};
+
+	if (auto *android_window = dynamic_cast<AndroidWindow *>(window.get()))
+	{
+		if (auto *frame_pacer = android_window->get_frame_pacer())
+		{
+			if (frame_pacer->get_refresh_period().count() > 0)
+			{
+				target_duration = frame_pacer->get_refresh_period();
+			}
+			wait_time = frame_pacer->take_wait_time();
+		}
+	}
+
+	if (!performance_hint_session)
+	{
+		performance_hint_session = std::make_unique<AndroidPerformanceHintSession>(target_duration);
+	}
+
+	if (!performance_hint_session->is_supported())
+	{
+		return;
+	}
+
+	// Aiming at the refresh period rather than the paced interval keeps the clocks up while the pacer holds a longer interval,
+	// otherwise the frames would be slowed down to fill it and the pacer could never step back down
+	performance_hint_session->set_target_work_duration(target_duration);
+	performance_hint_session->report_actual_work_duration(std::chrono::duration_cast<std::chrono::nanoseconds>(frame_duration) - wait_time);
+}
+
+int32_t AndroidPlatform::get_thermal_status()
+{
+	return thermal_monitor.get_status();
+}
+
+float AndroidPlatform::get_thermal_headroom()
+{
+	return thermal_monitor.get_headroom();
+}
+
 void AndroidPlatform::process_android_input_events(void)
 {
 	auto input_buf = android_app_swap_input_buffers(app);
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,8 +17,11 @@
 
 #pragma once
 
+#include <memory>
+
 #include <game-activity/native_app_glue/android_native_app_glue.h>
 
+#include "android/performance_hints.hpp"
 #include "platform/platform.h"
 
 namespace vkb
@@ -54,9 +57,18 @@ class AndroidPlatform : public Platform
 
 	void process_android_input_events(void);
 
+	virtual int32_t get_thermal_status() override;
+
+	virtual float get_thermal_headroom() override;
+
   private:
 	virtual void create_window(const Window::Properties &properties) override;
 
+	/**
+	 * @brief Reports the work duration of the frame to the performance hint manager, without the time it waited for the vsync
+	 */
+	virtual void on_frame_work(std::chrono::steady_clock::duration frame_duration) override;
+
   private:
 	android_app *app{nullptr};
 
@@ -65,6 +77,11 @@ class AndroidPlatform : public Platform
 	virtual std::vector<spdlog::sink_ptr> get_platform_sinks() override;
 
 	bool surface_ready{false};
+
+	/// Created on the first frame, by the thread running the frames
+	std::unique_ptr<AndroidPerformanceHintSession> performance_hint_session;
+
+	AndroidThermalMonitor thermal_monitor;
 };
 
 /**
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2023, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -26,6 +26,10 @@ AndroidWindow::AndroidWindow(AndroidPlatform *platform, ANativeWindow *&window,
     handle{window},
     platform{platform}
 {
+	if (properties.mode != Mode::Headless)
+	{
+		frame_pacer = std::make_unique<AndroidFramePacer>();
+	}
 }
 
 VkSurfaceKHR AndroidWindow::create_surface(Instance &instance)
@@ -56,6 +60,12 @@ void AndroidWindow::process_events()
 	process_android_events(platform->get_android_app());
 }
 
+void AndroidWindow::sample_input()
+{
+	// Only the input buffers are read, the commands of the activity wait for the end of the frame
+	platform->process_android_input_events();
+}
+
 bool AndroidWindow::should_close()
 {
 	return finish_called ? true : handle == nullptr;
@@ -72,6 +82,24 @@ float AndroidWindow::get_dpi_factor() const
 	return AConfiguration_getDensity(platform->get_android_app()->config) / static_cast<float>(ACONFIGURATION_DENSITY_MEDIUM);
 }
 
+bool AndroidWindow::paces_presents() const
+{
+	return frame_pacer != nullptr;
+}
+
+void AndroidWindow::pace_present() const
+{
+	if (frame_pacer)
+	{
+		frame_pacer->wait_for_vsync();
+	}
+}
+
+AndroidFramePacer *AndroidWindow::get_frame_pacer() const
+{
+	return frame_pacer.get();
+}
+
 std::vector<const char *> AndroidWindow::get_required_surface_extensions() const
 {
 	return {VK_KHR_ANDROID_SURFACE_EXTENSION_NAME};
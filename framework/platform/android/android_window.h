@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2023, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,8 +17,11 @@
 
 #pragma once
 
+#include <memory>
+
 #include <game-activity/native_app_glue/android_native_app_glue.h>
 
+#include "android/frame_pacer.hpp"
 #include "common/vk_common.h"
 #include "platform/window.h"
 
@@ -57,12 +60,26 @@ class AndroidWindow : public Window
 
 	virtual void process_events() override;
 
+	virtual void sample_input() override;
+
 	virtual bool should_close() override;
 
 	virtual void close() override;
 
 	virtual float get_dpi_factor() const override;
 
+	/**
+	 * @return Whether the presents are paced with the Choreographer, which is not used in headless mode
+	 */
+	virtual bool paces_presents() const override;
+
+	virtual void pace_present() const override;
+
+	/**
+	 * @return The pacer of the presents, or nullptr in headless mode
+	 */
+	AndroidFramePacer *get_frame_pacer() const;
+
 	std::vector<const char *> get_required_surface_extensions() const override;
 
   private:
@@ -72,5 +89,7 @@ class AndroidWindow : public Window
 	ANativeWindow *&handle;
 
 	bool finish_called{false};
+
+	std::unique_ptr<AndroidFramePacer> frame_pacer;
 };
 }        // namespace vkb
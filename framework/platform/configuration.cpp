@@ -1,4 +1,4 @@
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -97,6 +97,35 @@ void Configuration::reset()
 	current_configuration = configs.begin();
 }
 
+uint32_t Configuration::get_current_index() const
+{
+	if (configs.empty() || current_configuration == configs.end())
+	{
+		return 0;
+	}
+
+	return current_configuration->first;
+}
+
+bool Configuration::select(uint32_t config_index)
+{
+	auto it = configs.find(config_index);
+
+	if (it == configs.end())
+	{
+		return false;
+	}
+
+	current_configuration = it;
+
+	return true;
+}
+
+size_t Configuration::size() const
+{
+	return configs.size();
+}
+
 void Configuration::insert_setting(uint32_t config_index, std::unique_ptr<Setting> setting)
 {
 	settings.push_back(std::move(setting));
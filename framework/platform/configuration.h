@@ -1,4 +1,4 @@
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -111,6 +111,23 @@ class Configuration
 	 */
 	void reset();
 
+	/**
+	 * @returns The index of the current configuration, see insert_setting()
+	 */
+	uint32_t get_current_index() const;
+
+	/**
+	 * @brief Makes a configuration the current one, without configuring its settings
+	 * @param config_index The configuration to select, see insert_setting()
+	 * @returns True if the configuration exists
+	 */
+	bool select(uint32_t config_index);
+
+	/**
+	 * @returns The number of configurations
+	 */
+	size_t size() const;
+
 	/**
 	 * @brief Inserts a setting into the current configuration
 	 * @param config_index The configuration to insert the setting into
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -368,6 +368,11 @@ void GlfwWindow::process_events()
 	glfwPollEvents();
 }
 
+void GlfwWindow::sample_input()
+{
+	glfwPollEvents();
+}
+
 void GlfwWindow::close()
 {
 	glfwSetWindowShouldClose(handle, GLFW_TRUE);
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -44,6 +44,8 @@ class GlfwWindow : public Window
 
 	void process_events() override;
 
+	void sample_input() override;
+
 	void close() override;
 
 	float get_dpi_factor() const override;
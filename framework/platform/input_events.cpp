@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,7 +20,8 @@
 namespace vkb
 {
 InputEvent::InputEvent(EventSource source) :
-    source{source}
+    source{source},
+    timestamp{std::chrono::steady_clock::now()}
 {
 }
 
@@ -29,6 +30,11 @@ EventSource InputEvent::get_source() const
 	return source;
 }
 
+std::chrono::steady_clock::time_point InputEvent::get_timestamp() const
+{
+	return timestamp;
+}
+
 KeyInputEvent::KeyInputEvent(KeyCode code, KeyAction action) :
     InputEvent{EventSource::Keyboard},
     code{code},
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 
@@ -38,8 +39,15 @@ class InputEvent
 
 	EventSource get_source() const;
 
+	/**
+	 * @brief Returns when the event was received from the window system
+	 */
+	std::chrono::steady_clock::time_point get_timestamp() const;
+
   private:
 	EventSource source;
+
+	std::chrono::steady_clock::time_point timestamp;
 };
 
 enum class KeyCode
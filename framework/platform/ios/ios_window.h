@@ -65,6 +65,11 @@ class IosWindow : public Window
 
 	float get_dpi_factor() const override;
 
+	/**
+	 * @brief The frames are started by the display link of the view controller, so their presents are already due on a vsync
+	 */
+	bool paces_presents() const override;
+
 	std::vector<const char *> get_required_surface_extensions() const override;
     
     VulkanView * get_vulkan_view() {return view;}
@@ -72,6 +72,11 @@ float IosWindow::get_dpi_factor() const
     return [[UIScreen mainScreen] nativeScale] * (([[UIDevice currentDevice] userInterfaceIdiom] == UIUserInterfaceIdiomPad) ? 132 : 163);
 }
 
+bool IosWindow::paces_presents() const
+{
+	return properties.mode != Mode::Headless;
+}
+
 std::vector<const char *> IosWindow::get_required_surface_extensions() const
 {
 	return {VK_EXT_METAL_SURFACE_EXTENSION_NAME};
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -56,7 +56,7 @@ ExitCode Platform::initialize(const std::vector<Plugin *> &plugins)
 {
 	auto sinks = get_platform_sinks();
 
-	auto logger = std::make_shared<spdlog::logger>("logger", sinks.begin(), sinks.end());
+	auto logger = logging::create_logger("logger", sinks, logging::get_async_options());
 
 #ifdef VKB_DEBUG
 	logger->set_level(spdlog::level::debug);
@@ -248,6 +248,8 @@ void Platform::update()
 
 	if (focused || always_render)
 	{
+		auto frame_start = std::chrono::steady_clock::now();
+
 		on_update(delta_time);
 
 		if (fixed_simulation_fps)
@@ -258,7 +260,16 @@ void Platform::update()
 		active_app->update_overlay(delta_time, [=]() {
 			on_update_ui_overlay(*active_app->get_drawer());
 		});
+		updating = true;
 		active_app->update(delta_time);
+		updating = false;
+
+		if (pending_resize)
+		{
+			auto extent = *pending_resize;
+			pending_resize.reset();
+			resize(extent.width, extent.height);
+		}
 
 		if (auto *app = dynamic_cast<VulkanSample<vkb::BindingType::Cpp> *>(active_app.get()))
 		{
@@ -274,9 +285,25 @@ void Platform::update()
 				on_post_draw(app->get_render_context());
 			}
 		}
+
+		on_frame_work(std::chrono::steady_clock::now() - frame_start);
 	}
 }
 
+void Platform::on_frame_work(std::chrono::steady_clock::duration)
+{
+}
+
+int32_t Platform::get_thermal_status()
+{
+	return -1;
+}
+
+float Platform::get_thermal_headroom()
+{
+	return -1.0f;
+}
+
 void Platform::terminate(ExitCode code)
 {
 	if (code == ExitCode::Help)
@@ -312,10 +339,11 @@ void Platform::terminate(ExitCode code)
 	active_app.reset();
 	window.reset();
 
-	spdlog::drop_all();
-
 	on_platform_close();
 
+	// Plugins may still log when the platform closes
+	logging::shutdown();
+
 #ifdef PLATFORM__WINDOWS
 	// Halt on all unsuccessful exit codes unless ForceClose is in use
 	if (code != ExitCode::Success && !using_plugin<::plugins::ForceClose>())
@@ -440,9 +468,13 @@ bool Platform::start_app()
 
 		auto app_id = active_app->get_name();
 
+		on_app_close(app_id);
 		active_app->finish();
 	}
 
+	Timer load_timer;
+	load_timer.start();
+
 	active_app = requested_app_info->create();
 
 	active_app->set_name(requested_app_info->id);
@@ -459,11 +491,18 @@ bool Platform::start_app()
 		return false;
 	}
 
+	app_load_time = static_cast<float>(load_timer.stop());
+
 	on_app_start(requested_app_info->id);
 
 	return true;
 }
 
+float Platform::get_app_load_time() const
+{
+	return app_load_time;
+}
+
 void Platform::input_event(const InputEvent &input_event)
 {
 	if (process_input_events && active_app)
@@ -485,6 +524,12 @@ void Platform::input_event(const InputEvent &input_event)
 
 void Platform::resize(uint32_t width, uint32_t height)
 {
+	if (updating)
+	{
+		pending_resize = Window::Extent{width, height};
+		return;
+	}
+
 	auto extent = Window::Extent{std::max<uint32_t>(width, MIN_WINDOW_WIDTH), std::max<uint32_t>(height, MIN_WINDOW_HEIGHT)};
 	if ((window) && (width > 0) && (height > 0))
 	{
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,8 +17,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -102,6 +104,10 @@ class Platform
 
 	std::string &get_last_error();
 
+	/**
+	 * @brief Resizes the window and the active app
+	 *        Resizes received while the app updates, when its input is sampled, are applied once the update is done.
+	 */
 	virtual void resize(uint32_t width, uint32_t height);
 
 	virtual void input_event(const InputEvent &input_event);
@@ -130,6 +136,11 @@ class Platform
 
 	bool start_app();
 
+	/**
+	 * @return The time the active app took to be created and prepared, in seconds
+	 */
+	float get_app_load_time() const;
+
 	void force_simulation_fps(float fps);
 
 	// Force the application to always render even if it is not in focus
@@ -141,6 +152,16 @@ class Platform
 
 	void on_post_draw(RenderContext &context);
 
+	/**
+	 * @return The thermal status of the device, from none (0) to shutdown (6) as the system reports it, or -1 if unknown
+	 */
+	virtual int32_t get_thermal_status();
+
+	/**
+	 * @return How close the device is to severe throttling, 1.0 being the point where it throttles, or a negative value if unknown
+	 */
+	virtual float get_thermal_headroom();
+
 	static const uint32_t MIN_WINDOW_WIDTH;
 	static const uint32_t MIN_WINDOW_HEIGHT;
 
@@ -164,6 +185,12 @@ class Platform
 	 */
 	virtual void create_window(const Window::Properties &properties) = 0;
 
+	/**
+	 * @brief Called once the app updated and drew a frame, e.g. to report its work duration to the system
+	 * @param frame_duration The time the frame took, including the time it waited for the GPU or the display
+	 */
+	virtual void on_frame_work(std::chrono::steady_clock::duration frame_duration);
+
 	void on_update(float delta_time);
 	void on_app_error(const std::string &app_id);
 	void on_app_start(const std::string &app_id);
@@ -182,6 +209,13 @@ class Platform
   private:
 	Timer timer;
 
+	/// Whether the active app is updating, a frame may be in flight then
+	bool updating{false};
+
+	float app_load_time{0.0f};
+
+	std::optional<Window::Extent> pending_resize;
+
 	const apps::AppInfo *requested_app{nullptr};
 
 	std::vector<Plugin *> plugins;
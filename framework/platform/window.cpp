@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2023, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -30,6 +30,10 @@ void Window::process_events()
 {
 }
 
+void Window::sample_input()
+{
+}
+
 Window::Extent Window::resize(const Extent &new_extent)
 {
 	if (properties.resizable)
@@ -51,6 +55,15 @@ float Window::get_content_scale_factor() const
 	return 1.0f;
 }
 
+bool Window::paces_presents() const
+{
+	return false;
+}
+
+void Window::pace_present() const
+{
+}
+
 Window::Mode Window::get_window_mode() const
 {
 	return properties.mode;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2023, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -108,6 +108,13 @@ class Window
 	 */
 	virtual void process_events();
 
+	/**
+	 * @brief Delivers the pending input events, in the middle of a frame right before the input is used
+	 *        Resizes received meanwhile are applied once the frame is done, see Platform::resize.
+	 *        Windows whose events only come with process_events() keep the input of the last call to it.
+	 */
+	virtual void sample_input();
+
 	/**
 	 * @brief Requests to close the window
 	 */
@@ -143,6 +150,17 @@ class Window
 	virtual bool get_display_present_info(VkDisplayPresentInfoKHR *info,
 	                                      uint32_t src_width, uint32_t src_height) const;
 
+	/**
+	 * @return Whether pace_present() aligns the presents with the vsync of the display
+	 */
+	virtual bool paces_presents() const;
+
+	/**
+	 * @brief Blocks until the next present is due, called right before presenting with a FIFO present mode
+	 *        Windows which do not pace the presents return right away, leaving it to the presentation engine.
+	 */
+	virtual void pace_present() const;
+
 	virtual std::vector<const char *> get_required_surface_extensions() const = 0;
 
 	const Extent &get_extent() const;
@@ -0,0 +1,127 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/attachment_allocator.h"
+
+#include "common/error.h"
+#include "core/device.h"
+
+namespace vkb
+{
+AttachmentAllocator::AttachmentAllocator(Device &device) :
+    device{device}
+{
+}
+
+AttachmentAllocator::~AttachmentAllocator()
+{
+	// The images aliasing the allocations must have been destroyed already
+	for (auto &alias_group : alias_groups)
+	{
+		for (auto allocation : alias_group.second)
+		{
+			allocated::untrack_allocation(allocation);
+			vmaFreeMemory(allocated::get_memory_allocator(), allocation);
+		}
+	}
+}
+
+core::Image AttachmentAllocator::create_image(const std::string &alias_group, core::ImageBuilder &builder)
+{
+	// The memory requirements of an image only depend on its description, query them from a temporary image
+	VkImage probe_image{VK_NULL_HANDLE};
+	VK_CHECK(vkCreateImage(device.get_handle(), &builder.create_info, nullptr, &probe_image));
+
+	VkMemoryRequirements requirements{};
+	vkGetImageMemoryRequirements(device.get_handle(), probe_image, &requirements);
+	vkDestroyImage(device.get_handle(), probe_image, nullptr);
+
+	auto &allocations = alias_groups[alias_group];
+
+	VmaAllocation allocation = find_allocation(allocations, requirements);
+	if (allocation == VK_NULL_HANDLE)
+	{
+		allocation = allocate(requirements, builder.create_info.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
+		allocations.push_back(allocation);
+	}
+
+	return builder.with_alias_allocation(allocation).build(device);
+}
+
+VkDeviceSize AttachmentAllocator::get_allocated_size() const
+{
+	VkDeviceSize size = 0;
+
+	for (auto &alias_group : alias_groups)
+	{
+		for (auto allocation : alias_group.second)
+		{
+			VmaAllocationInfo allocation_info{};
+			vmaGetAllocationInfo(allocated::get_memory_allocator(), allocation, &allocation_info);
+			size += allocation_info.size;
+		}
+	}
+
+	return size;
+}
+
+VmaAllocation AttachmentAllocator::find_allocation(const std::vector<VmaAllocation> &allocations, const VkMemoryRequirements &requirements) const
+{
+	for (auto allocation : allocations)
+	{
+		VmaAllocationInfo allocation_info{};
+		vmaGetAllocationInfo(allocated::get_memory_allocator(), allocation, &allocation_info);
+
+		if (allocation_info.size >= requirements.size &&
+		    allocation_info.offset % requirements.alignment == 0 &&
+		    (requirements.memoryTypeBits & (1u << allocation_info.memoryType)))
+		{
+			return allocation;
+		}
+	}
+
+	return VK_NULL_HANDLE;
+}
+
+VmaAllocation AttachmentAllocator::allocate(const VkMemoryRequirements &requirements, bool transient)
+{
+	VmaAllocationCreateInfo alloc_create_info{};
+	alloc_create_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	alloc_create_info.pUserData     = reinterpret_cast<void *>(static_cast<uintptr_t>(allocated::MemoryTag::RenderTarget));
+
+	// Only transient images can be bound to lazily allocated memory, so the memory type matches the images of the group
+	if (transient)
+	{
+		alloc_create_info.preferredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+	}
+
+	VmaAllocation     allocation{VK_NULL_HANDLE};
+	VmaAllocationInfo allocation_info{};
+
+	VkResult result = vmaAllocateMemory(allocated::get_memory_allocator(), &requirements, &alloc_create_info, &allocation, &allocation_info);
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot allocate attachment memory"};
+	}
+
+	allocated::track_allocation(allocation);
+
+	LOGI("Allocated {} bytes of {}attachment memory", allocation_info.size, transient ? "transient " : "");
+
+	return allocation;
+}
+}        // namespace vkb
@@ -0,0 +1,79 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/image.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Allocates the memory of render target attachments, sharing it between the attachments of an alias group
+ *
+ * The attachments of an alias group must have disjoint lifetimes, like the attachment of the same name in each RenderFrame:
+ * the frames are recorded one after the other on the graphics queue, and each frame starts by transitioning its attachments
+ * from the undefined layout, after the attachment writes of the previous frames.
+ * The content of an attachment is therefore undefined at the start of each frame.
+ *
+ * Transient attachments prefer lazily allocated memory, which tile based GPUs may never back with physical memory.
+ *
+ * The allocations of a group only grow, they are freed with the allocator.
+ */
+class AttachmentAllocator
+{
+  public:
+	AttachmentAllocator(Device &device);
+
+	AttachmentAllocator(const AttachmentAllocator &) = delete;
+
+	AttachmentAllocator(AttachmentAllocator &&) = delete;
+
+	~AttachmentAllocator();
+
+	AttachmentAllocator &operator=(const AttachmentAllocator &) = delete;
+
+	AttachmentAllocator &operator=(AttachmentAllocator &&) = delete;
+
+	/**
+	 * @brief Creates an attachment bound to the memory of its alias group
+	 * @param alias_group The name of the group, as an example "gbuffer_albedo"
+	 * @param builder The description of the image, its VMA usage and flags are not used, it is bound to the group allocation
+	 */
+	core::Image create_image(const std::string &alias_group, core::ImageBuilder &builder);
+
+	/**
+	 * @return The size of the memory allocated for all alias groups
+	 */
+	VkDeviceSize get_allocated_size() const;
+
+  private:
+	VmaAllocation find_allocation(const std::vector<VmaAllocation> &allocations, const VkMemoryRequirements &requirements) const;
+
+	VmaAllocation allocate(const VkMemoryRequirements &requirements, bool transient);
+
+	Device &device;
+
+	std::map<std::string, std::vector<VmaAllocation>> alias_groups;
+};
+}        // namespace vkb
@@ -0,0 +1,438 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/cascaded_shadow_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "common/utils.h"
+#include "core/allocated.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "core/util/hash.hpp"
+#include "rendering/render_context.h"
+#include "rendering/subpasses/shadow_subpass.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/orthographic_camera.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "scene_graph/components/skin.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+#include "scene_graph/scene_snapshot.h"
+
+namespace vkb
+{
+namespace
+{
+/// Step the radius of the slices is rounded up to, so that float noise does not change the extent of the cascades
+constexpr float RADIUS_STEP = 1.0f / 16.0f;
+
+/**
+ * @return Whether two boxes overlap
+ */
+bool overlaps(const glm::vec3 &min_a, const glm::vec3 &max_a, const glm::vec3 &min_b, const glm::vec3 &max_b)
+{
+	return glm::all(glm::lessThanEqual(min_a, max_b)) && glm::all(glm::lessThanEqual(min_b, max_a));
+}
+}        // namespace
+
+std::atomic<uint32_t> CascadedShadowMap::total_drawn_cascade_count{0};
+
+CascadedShadowMap::CascadedShadowMap(RenderContext &render_context, sg::Scene &scene, uint32_t cascade_count, uint32_t resolution) :
+    render_context{render_context},
+    scene{scene},
+    cascade_count{cascade_count},
+    resolution{resolution}
+{
+	if (cascade_count == 0 || cascade_count > MAX_CASCADES)
+	{
+		throw std::runtime_error{"Cascaded shadow maps support 1 to " + std::to_string(MAX_CASCADES) + " cascades"};
+	}
+
+	auto &device = render_context.get_device();
+
+	VkFormat depth_format = get_suitable_depth_format(device.get_gpu().get_handle());
+
+	{
+		allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
+
+		atlas = std::make_unique<core::Image>(device,
+		                                      VkExtent3D{resolution, resolution, 1},
+		                                      depth_format,
+		                                      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		                                      VMA_MEMORY_USAGE_GPU_ONLY,
+		                                      VK_SAMPLE_COUNT_1_BIT,
+		                                      1,
+		                                      cascade_count);
+		atlas->set_debug_name("CascadedShadowMap: atlas");
+	}
+
+	atlas_view = std::make_unique<core::ImageView>(*atlas, VK_IMAGE_VIEW_TYPE_2D_ARRAY, depth_format);
+	atlas_view->set_debug_name("CascadedShadowMap: atlas view");
+
+	// Depth is reversed, so the fragments nearer to the light than the map are greater and lit.
+	// Outside of a cascade the sampler clamps to the border, which compares as lit.
+	VkFilter filter = VK_FILTER_LINEAR;
+	make_filters_valid(device.get_gpu().get_handle(), depth_format, &filter);
+
+	VkSamplerCreateInfo sampler_info{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+	sampler_info.minFilter     = filter;
+	sampler_info.magFilter     = filter;
+	sampler_info.addressModeU  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+	sampler_info.addressModeV  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+	sampler_info.addressModeW  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+	sampler_info.borderColor   = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+	sampler_info.compareEnable = VK_TRUE;
+	sampler_info.compareOp     = VK_COMPARE_OP_GREATER_OR_EQUAL;
+
+	sampler = std::make_unique<core::Sampler>(device, sampler_info);
+	sampler->set_debug_name("CascadedShadowMap: sampler");
+
+	cascades.resize(cascade_count);
+
+	for (uint32_t i = 0; i < cascade_count; ++i)
+	{
+		auto &cascade = cascades[i];
+
+		// The cameras of the cascades are not part of the scene, their nodes have no parent
+		cascade.node   = std::make_unique<sg::Node>(0, "shadow_cascade_" + std::to_string(i));
+		cascade.camera = std::make_unique<sg::OrthographicCamera>("shadow_cascade_camera_" + std::to_string(i));
+		cascade.camera->set_node(*cascade.node);
+		cascade.node->set_component(*cascade.camera);
+
+		std::vector<core::ImageView> views;
+		views.emplace_back(*atlas, VK_IMAGE_VIEW_TYPE_2D, depth_format, 0, i, 1, 1);
+		cascade.render_target = std::make_unique<RenderTarget>(std::move(views));
+
+		auto subpass = std::make_unique<ShadowSubpass>(render_context,
+		                                               ShaderSource{"shadows/shadowmap.vert"},
+		                                               ShaderSource{"shadows/shadowmap.frag"},
+		                                               scene,
+		                                               *cascade.camera);
+		cascade.subpass = subpass.get();
+
+		cascade.render_pipeline = std::make_unique<RenderPipeline>();
+		cascade.render_pipeline->add_subpass(std::move(subpass));
+
+		// The layers of cached cascades are stored to be sampled in the next frames
+		cascade.render_pipeline->set_load_store({{VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE}});
+
+		VkClearValue clear_value{};
+		clear_value.depthStencil = {0.0f, ~0U};
+		cascade.render_pipeline->set_clear_value({clear_value});
+	}
+}
+
+CascadedShadowMap::~CascadedShadowMap() = default;
+
+void CascadedShadowMap::set_split_lambda(float lambda)
+{
+	split_lambda = glm::clamp(lambda, 0.0f, 1.0f);
+}
+
+void CascadedShadowMap::set_shadow_distance(float distance)
+{
+	shadow_distance = distance;
+}
+
+void CascadedShadowMap::set_first_cached_cascade(uint32_t cascade)
+{
+	first_cached_cascade = cascade;
+}
+
+void CascadedShadowMap::set_cache_margin(float margin)
+{
+	cache_margin = std::max(margin, 0.0f);
+
+	invalidate();
+}
+
+void CascadedShadowMap::invalidate()
+{
+	for (auto &cascade : cascades)
+	{
+		cascade.half_extent = 0.0f;
+		cascade.dirty       = true;
+	}
+}
+
+bool CascadedShadowMap::fit_cascade(Cascade &cascade, const glm::vec3 &light_space_center, float radius, float margin, const glm::vec2 &depth_range)
+{
+	float half_extent = radius * (1.0f + margin);
+
+	// The box is kept while it holds the slice and the casters of the scene
+	bool holds_slice = half_extent == cascade.half_extent &&
+	                   std::abs(light_space_center.x - cascade.center.x) + radius <= half_extent &&
+	                   std::abs(light_space_center.y - cascade.center.y) + radius <= half_extent;
+	bool holds_depth = depth_range.x >= cascade.min_depth && depth_range.y <= cascade.max_depth;
+
+	if (holds_slice && holds_depth)
+	{
+		return false;
+	}
+
+	// Moving the box by whole texels keeps the rasterization of static casters the same
+	float texel_size = 2.0f * half_extent / static_cast<float>(resolution);
+
+	cascade.half_extent = half_extent;
+	cascade.center      = glm::vec3(glm::round(glm::vec2(light_space_center) / texel_size) * texel_size, 0.0f);
+
+	float depth_margin = (depth_range.y - depth_range.x) * margin + RADIUS_STEP;
+	cascade.min_depth  = depth_range.x - depth_margin;
+	cascade.max_depth  = depth_range.y + depth_margin;
+
+	// The camera is at the center of the box in light space, looking along the light
+	glm::mat4 light_to_world = glm::transpose(light_rotation);
+
+	auto &transform = cascade.node->get_transform();
+	transform.set_translation(glm::vec3(light_to_world * glm::vec4(cascade.center, 1.0f)));
+	transform.set_rotation(glm::quat_cast(light_to_world));
+
+	// Points nearer to the light have a greater light space depth, and the camera looks down its negative z axis
+	cascade.camera->set_left(-half_extent);
+	cascade.camera->set_right(half_extent);
+	cascade.camera->set_bottom(-half_extent);
+	cascade.camera->set_top(half_extent);
+	cascade.camera->set_near_plane(-cascade.max_depth);
+	cascade.camera->set_far_plane(-cascade.min_depth);
+
+	return true;
+}
+
+void CascadedShadowMap::update(sg::PerspectiveCamera &camera, sg::Light &light, const sg::SceneSnapshot *snapshot)
+{
+	auto light_state = sg::get_node_state(snapshot, *light.get_node());
+
+	glm::vec3 direction = glm::normalize(light_state.rotation * light.get_properties().direction);
+
+	if (direction != light_direction)
+	{
+		light_direction = direction;
+
+		glm::vec3 up   = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		light_rotation = glm::lookAt(glm::vec3(0.0f), direction, up);
+
+		invalidate();
+	}
+
+	// Light space bounds of all the casters, to find the depth range of the cascades and the casters in each of them
+	casters.clear();
+
+	glm::vec2 depth_range{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+
+	for (auto mesh : scene.get_components<sg::Mesh>())
+	{
+		for (auto node : mesh->get_nodes())
+		{
+			auto world_matrix = sg::get_node_state(snapshot, *node).world_matrix;
+
+			glm::mat4 light_matrix = light_rotation * world_matrix;
+
+			const sg::AABB &mesh_bounds = mesh->get_bounds();
+
+			sg::AABB light_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
+			light_bounds.transform(light_matrix);
+
+			casters.push_back({node, world_matrix, light_bounds.get_min(), light_bounds.get_max(), node->has_component<sg::Skin>()});
+
+			depth_range.x = std::min(depth_range.x, light_bounds.get_min().z);
+			depth_range.y = std::max(depth_range.y, light_bounds.get_max().z);
+		}
+	}
+
+	if (casters.empty())
+	{
+		depth_range = glm::vec2(0.0f);
+	}
+
+	// Practical split scheme, blending logarithmic and uniform splits of the view depth
+	float near_plane = camera.get_near_plane();
+	float far_plane  = camera.get_far_plane();
+	if (shadow_distance > 0.0f)
+	{
+		far_plane = std::min(far_plane, shadow_distance);
+	}
+
+	float tan_half_fov_y = std::tan(camera.get_field_of_view() * 0.5f);
+	float tan_half_fov_x = tan_half_fov_y * camera.get_aspect_ratio();
+	float corner_scale   = tan_half_fov_x * tan_half_fov_x + tan_half_fov_y * tan_half_fov_y;
+
+	glm::mat4 camera_world = glm::inverse(sg::get_view(snapshot, camera));
+
+	float split_near = near_plane;
+
+	for (uint32_t i = 0; i < cascade_count; ++i)
+	{
+		auto &cascade = cascades[i];
+
+		float fraction     = static_cast<float>(i + 1) / static_cast<float>(cascade_count);
+		float log_split    = near_plane * std::pow(far_plane / near_plane, fraction);
+		float linear_split = near_plane + (far_plane - near_plane) * fraction;
+		float split_far    = split_lambda * log_split + (1.0f - split_lambda) * linear_split;
+
+		// The sphere around the slice on the view axis, whose radius does not change with the camera orientation
+		glm::vec4 center = camera_world * glm::vec4(0.0f, 0.0f, -0.5f * (split_near + split_far), 1.0f);
+
+		float half_depth = 0.5f * (split_far - split_near);
+		float radius     = std::sqrt(half_depth * half_depth + split_far * split_far * corner_scale);
+		radius           = std::ceil(radius / RADIUS_STEP) * RADIUS_STEP;
+
+		glm::vec3 light_space_center = glm::vec3(light_rotation * center);
+
+		bool cached = i >= first_cached_cascade;
+
+		if (fit_cascade(cascade, light_space_center, radius, cached ? cache_margin : 0.0f, depth_range) || !cached)
+		{
+			cascade.dirty = true;
+		}
+
+		if (cached)
+		{
+			// A cached cascade is drawn again once the casters in its box move, are added or removed
+			glm::vec3 box_min{glm::vec2(cascade.center) - cascade.half_extent, cascade.min_depth};
+			glm::vec3 box_max{glm::vec2(cascade.center) + cascade.half_extent, cascade.max_depth};
+
+			size_t caster_hash = 0;
+			bool   skinned     = false;
+
+			for (auto &caster : casters)
+			{
+				if (overlaps(caster.min, caster.max, box_min, box_max))
+				{
+					hash_combine(caster_hash, caster.node);
+					hash_combine_bytes(caster_hash, caster.world_matrix);
+					skinned |= caster.skinned;
+				}
+			}
+
+			if (skinned || caster_hash != cascade.caster_hash)
+			{
+				cascade.caster_hash = caster_hash;
+				cascade.dirty       = true;
+			}
+		}
+
+		uniform.light_matrices[i] = vulkan_style_projection(cascade.camera->get_projection()) * cascade.camera->get_view();
+		uniform.split_depths[i]   = split_far;
+
+		split_near = split_far;
+	}
+
+	uniform.cascade_count = glm::uvec4(cascade_count, 0, 0, 0);
+}
+
+void CascadedShadowMap::draw(CommandBuffer &command_buffer)
+{
+	drawn_cascade_count = 0;
+
+	for (auto &cascade : cascades)
+	{
+		if (!cascade.dirty)
+		{
+			continue;
+		}
+
+		ScopedDebugLabel debug_label{command_buffer, "Shadow cascade"};
+
+		auto &view = cascade.render_target->get_views()[0];
+
+		// The previous contents of the layer are cleared, but the previous frames may still be sampling it
+		{
+			ImageMemoryBarrier memory_barrier{};
+			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			memory_barrier.src_access_mask = 0;
+			memory_barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+			command_buffer.image_memory_barrier(view, memory_barrier);
+		}
+
+		VkViewport viewport{};
+		viewport.width    = static_cast<float>(resolution);
+		viewport.height   = static_cast<float>(resolution);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		command_buffer.set_viewport(0, {viewport});
+
+		VkRect2D scissor{};
+		scissor.extent = {resolution, resolution};
+		command_buffer.set_scissor(0, {scissor});
+
+		cascade.render_pipeline->draw(command_buffer, *cascade.render_target);
+		command_buffer.end_render_pass();
+
+		{
+			ImageMemoryBarrier memory_barrier{};
+			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			memory_barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+			command_buffer.image_memory_barrier(view, memory_barrier);
+		}
+
+		cascade.dirty = false;
+		drawn_cascade_count++;
+	}
+
+	total_drawn_cascade_count.fetch_add(drawn_cascade_count, std::memory_order_relaxed);
+}
+
+void CascadedShadowMap::bind(CommandBuffer &command_buffer, uint32_t set, uint32_t atlas_binding, uint32_t uniform_binding)
+{
+	command_buffer.bind_image(*atlas_view, *sampler, set, atlas_binding, 0);
+
+	auto uniform_buffer = render_context.get_active_frame().allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(CascadedShadowUniform));
+	uniform_buffer.update(uniform);
+
+	command_buffer.bind_buffer(uniform_buffer.get_buffer(), uniform_buffer.get_offset(), uniform_buffer.get_size(), set, uniform_binding, 0);
+}
+
+const CascadedShadowUniform &CascadedShadowMap::get_uniform() const
+{
+	return uniform;
+}
+
+const core::ImageView &CascadedShadowMap::get_view() const
+{
+	return *atlas_view;
+}
+
+const core::Sampler &CascadedShadowMap::get_sampler() const
+{
+	return *sampler;
+}
+
+uint32_t CascadedShadowMap::get_drawn_cascade_count() const
+{
+	return drawn_cascade_count;
+}
+
+uint32_t CascadedShadowMap::take_drawn_cascade_count()
+{
+	return total_drawn_cascade_count.exchange(0);
+}
+}        // namespace vkb
@@ -0,0 +1,264 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/sampler.h"
+#include "rendering/render_pipeline.h"
+#include "rendering/render_target.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class RenderContext;
+class ShadowSubpass;
+
+namespace sg
+{
+class Light;
+class Node;
+class OrthographicCamera;
+class PerspectiveCamera;
+class Scene;
+class SceneSnapshot;
+}        // namespace sg
+
+/**
+ * @brief Cascade matrices and splits, read by the shaders including cascaded_shadows.h
+ */
+struct alignas(16) CascadedShadowUniform
+{
+	/// Light view projection of each cascade, mapping to its layer of the atlas, see CascadedShadowMap::MAX_CASCADES
+	glm::mat4 light_matrices[4];
+
+	/// View space distance at which each cascade ends
+	glm::vec4 split_depths;
+
+	/// x number of cascades
+	glm::uvec4 cascade_count;
+};
+
+/**
+ * @brief Cascaded shadow maps of a directional light, with the distant cascades cached across frames
+ *
+ * The view frustum of the camera is split in depth with the practical split scheme, which blends logarithmic and
+ * uniform splits, see set_split_lambda(). Each slice is bounded by a sphere, so that the extent of its cascade does
+ * not change as the camera rotates, and the cascade is centered on it in steps of a texel of the shadow map, so that
+ * the shadow edges do not shimmer as the camera moves.
+ *
+ * All the cascades share an atlas: a depth image with one array layer per cascade, each rendered by a ShadowSubpass
+ * of its own looking at the scene through an orthographic camera.
+ *
+ * The cascades from set_first_cached_cascade() onwards cover most of the scene and are cached. Their box is larger
+ * than their slice by a margin, and they keep it as long as the slice stays inside. They are only drawn again when
+ * their box moves, when the light changes, or when a mesh node casting shadows in their box moves, is added or removed.
+ * Skinned nodes may move without their transform changing, the cascades holding any are drawn every frame.
+ * The nearer cascades are drawn every frame.
+ *
+ * Shaders read the cascades by including cascaded_shadows.h, with bind() at set 0, bindings 5 and 9.
+ */
+class CascadedShadowMap
+{
+  public:
+	static constexpr uint32_t MAX_CASCADES = 4;
+
+	/**
+	 * @param render_context The render context recording the shadows
+	 * @param scene The scene casting shadows
+	 * @param cascade_count The number of cascades, at most MAX_CASCADES
+	 * @param resolution The width and height of the shadow map of each cascade
+	 */
+	CascadedShadowMap(RenderContext &render_context, sg::Scene &scene, uint32_t cascade_count = MAX_CASCADES, uint32_t resolution = 2048);
+
+	CascadedShadowMap(const CascadedShadowMap &) = delete;
+
+	CascadedShadowMap(CascadedShadowMap &&) = delete;
+
+	~CascadedShadowMap();
+
+	CascadedShadowMap &operator=(const CascadedShadowMap &) = delete;
+
+	CascadedShadowMap &operator=(CascadedShadowMap &&) = delete;
+
+	/**
+	 * @brief Sets the blend between logarithmic and uniform splits, 1 is fully logarithmic, 0.9 by default
+	 */
+	void set_split_lambda(float lambda);
+
+	/**
+	 * @brief Sets the view space distance past which there are no shadows, 0 for the far plane of the camera, the default
+	 */
+	void set_shadow_distance(float distance);
+
+	/**
+	 * @brief Sets the first cascade which is cached, the ones before it are drawn every frame, 1 by default
+	 *        Set it to the cascade count to draw all the cascades every frame.
+	 */
+	void set_first_cached_cascade(uint32_t cascade);
+
+	/**
+	 * @brief Sets how much larger than their slice the boxes of the cached cascades are, 0.25 by default
+	 *        A larger margin draws the cached cascades less often, at a lower shadow resolution.
+	 */
+	void set_cache_margin(float margin);
+
+	/**
+	 * @brief Draws all the cascades again on the next draw(), e.g. once materials or meshes of the scene changed
+	 */
+	void invalidate();
+
+	/**
+	 * @brief Fits the cascades to the view of a camera, and finds the ones which need to be drawn again
+	 * @param camera The camera viewing the shadows
+	 * @param light The directional light casting the shadows
+	 * @param snapshot The scene snapshot the frame is recorded from, nullptr to read the live scene
+	 */
+	void update(sg::PerspectiveCamera &camera, sg::Light &light, const sg::SceneSnapshot *snapshot = nullptr);
+
+	/**
+	 * @brief Records the cascades found by the last update(), outside of a render pass
+	 *        The whole atlas is then in the shader read only layout for the fragment shaders.
+	 */
+	void draw(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Binds the atlas with a comparison sampler, and the uniform of the last update()
+	 * @param command_buffer The command buffer to bind to
+	 * @param set The descriptor set to bind to
+	 * @param atlas_binding The binding of the atlas
+	 * @param uniform_binding The binding of the uniform
+	 */
+	void bind(CommandBuffer &command_buffer, uint32_t set, uint32_t atlas_binding, uint32_t uniform_binding);
+
+	const CascadedShadowUniform &get_uniform() const;
+
+	/**
+	 * @return A view on all the layers of the atlas
+	 */
+	const core::ImageView &get_view() const;
+
+	const core::Sampler &get_sampler() const;
+
+	/**
+	 * @return The number of cascades drawn by the last draw()
+	 */
+	uint32_t get_drawn_cascade_count() const;
+
+	/**
+	 * @brief Takes the number of cascades drawn by all the shadow maps since the last call, for the stats
+	 */
+	static uint32_t take_drawn_cascade_count();
+
+  private:
+	struct Cascade
+	{
+		std::unique_ptr<sg::Node> node;
+
+		std::unique_ptr<sg::OrthographicCamera> camera;
+
+		std::unique_ptr<RenderTarget> render_target;
+
+		std::unique_ptr<RenderPipeline> render_pipeline;
+
+		ShadowSubpass *subpass{nullptr};
+
+		/// Center of the box in light space, and its half extent in x and y
+		glm::vec3 center{0.0f};
+
+		float half_extent{0.0f};
+
+		/// Light space depth range of the box
+		float min_depth{0.0f};
+
+		float max_depth{0.0f};
+
+		/// Hash of the shadow casters in the box when it was last drawn
+		size_t caster_hash{0};
+
+		bool dirty{true};
+	};
+
+	/**
+	 * @brief Moves the box of a cascade to the slice bounded by a sphere, snapped to texels, unless it still holds it
+	 * @param margin How much larger than the slice the box is, relative to its radius
+	 * @param depth_range The light space depth range of the casters of the scene
+	 * @return Whether the box moved
+	 */
+	bool fit_cascade(Cascade &cascade, const glm::vec3 &light_space_center, float radius, float margin, const glm::vec2 &depth_range);
+
+	RenderContext &render_context;
+
+	sg::Scene &scene;
+
+	uint32_t cascade_count;
+
+	uint32_t resolution;
+
+	float split_lambda{0.9f};
+
+	float shadow_distance{0.0f};
+
+	uint32_t first_cached_cascade{1};
+
+	float cache_margin{0.25f};
+
+	std::unique_ptr<core::Image> atlas;
+
+	std::unique_ptr<core::ImageView> atlas_view;
+
+	std::unique_ptr<core::Sampler> sampler;
+
+	std::vector<Cascade> cascades;
+
+	/// Direction of the light of the last update(), all the cascades are drawn again when it changes
+	glm::vec3 light_direction{0.0f};
+
+	/// Rotation from world space to light space, looking along the light direction
+	glm::mat4 light_rotation{1.0f};
+
+	struct Caster
+	{
+		const sg::Node *node;
+
+		glm::mat4 world_matrix;
+
+		/// Light space bounds
+		glm::vec3 min;
+
+		glm::vec3 max;
+
+		bool skinned;
+	};
+
+	/// Mesh nodes of the scene as of the last update(), reused across frames
+	std::vector<Caster> casters;
+
+	uint32_t drawn_cascade_count{0};
+
+	static std::atomic<uint32_t> total_drawn_cascade_count;
+
+	CascadedShadowUniform uniform{};
+};
+}        // namespace vkb
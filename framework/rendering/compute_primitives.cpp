@@ -0,0 +1,430 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/compute_primitives.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "common/utils.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "glsl_compiler.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr uint32_t RADIX = 1 << ComputePrimitives::RADIX_BITS;
+
+/// Workgroups of the first pass of a reduction at most, so that a single workgroup reduces their results quickly
+constexpr uint32_t REDUCE_MAX_WORKGROUPS = 1024;
+
+/// Values reduced per invocation at least in the first pass, so that small arrays are reduced in a single pass
+constexpr uint32_t REDUCE_VALUES_PER_INVOCATION = 4;
+
+/// Same layout as Parameters in the radix shaders
+struct RadixParameters
+{
+	uint32_t count;
+
+	uint32_t shift;
+};
+
+inline uint32_t divide_rounding_up(uint32_t value, uint32_t divisor)
+{
+	return (value + divisor - 1) / divisor;
+}
+
+/**
+ * @return The size of the subgroups of the physical device, which must support Vulkan 1.1
+ */
+uint32_t get_subgroup_size(Device &device)
+{
+	VkPhysicalDeviceSubgroupProperties subgroup_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES};
+
+	VkPhysicalDeviceProperties2KHR properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+	properties.pNext = &subgroup_properties;
+	vkGetPhysicalDeviceProperties2KHR(device.get_gpu().get_handle(), &properties);
+
+	return subgroup_properties.subgroupSize;
+}
+
+void read_barrier(CommandBuffer &command_buffer, const core::Buffer &buffer)
+{
+	command_buffer.buffer_transition(buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+}
+
+void write_barrier(CommandBuffer &command_buffer, const core::Buffer &buffer)
+{
+	command_buffer.buffer_transition(buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+void bind_storage_buffer(CommandBuffer &command_buffer, const core::Buffer &buffer, uint32_t binding)
+{
+	command_buffer.bind_buffer(buffer, 0, buffer.get_size(), 0, binding, 0);
+}
+}        // namespace
+
+ComputePrimitives::ComputePrimitives(Device &device, uint32_t max_count, uint32_t api_version) :
+    device{device},
+    max_count{std::max(max_count, 1U)},
+    subgroup_arithmetic{supports_subgroup_arithmetic(device, api_version) && get_subgroup_size(device) >= MIN_SUBGROUP_SIZE},
+    max_group_count_x{device.get_gpu().get_properties().limits.maxComputeWorkGroupCount[0]},
+    reduce_shader{"compute_primitives_reduce.comp"},
+    scan_shader{"compute_primitives_scan.comp"},
+    scan_add_shader{"compute_primitives_scan_add.comp"},
+    compact_shader{"compute_primitives_compact.comp"},
+    radix_histogram_shader{"compute_primitives_radix_histogram.comp"},
+    radix_scatter_shader{"compute_primitives_radix_scatter.comp"}
+{
+	if (subgroup_arithmetic)
+	{
+		base_variant.add_define("SUBGROUP_ARITHMETIC");
+	}
+
+	reduce_min_variant = base_variant;
+	reduce_min_variant.add_define("REDUCE_MIN");
+
+	reduce_max_variant = base_variant;
+	reduce_max_variant.add_define("REDUCE_MAX");
+
+	count_nonzero_variant = base_variant;
+	count_nonzero_variant.add_define("COUNT_NONZERO");
+
+	sort_values_variant = base_variant;
+	sort_values_variant.add_define("SORT_VALUES");
+
+	// The modules are compiled here, so that the recording finds them in the resource cache. Subgroup operations need
+	// SPIR-V 1.3, the target of Vulkan 1.1.
+	auto target_language         = GLSLCompiler::get_target_language();
+	auto target_language_version = GLSLCompiler::get_target_language_version();
+	if (subgroup_arithmetic)
+	{
+		GLSLCompiler::set_target_environment(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
+	}
+
+	auto &resource_cache = device.get_resource_cache();
+
+	const std::vector<std::pair<const ShaderSource *, const ShaderVariant *>> shaders = {
+	    {&reduce_shader, &base_variant},
+	    {&reduce_shader, &reduce_min_variant},
+	    {&reduce_shader, &reduce_max_variant},
+	    {&scan_shader, &base_variant},
+	    {&scan_shader, &count_nonzero_variant},
+	    {&scan_add_shader, &base_variant},
+	    {&compact_shader, &base_variant},
+	    {&radix_histogram_shader, &base_variant},
+	    {&radix_scatter_shader, &base_variant},
+	    {&radix_scatter_shader, &sort_values_variant}};
+
+	for (auto &shader : shaders)
+	{
+		resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, *shader.first, *shader.second);
+	}
+
+	GLSLCompiler::set_target_environment(target_language, target_language_version);
+
+	// The scans of the radix sort histograms have a count per digit for every block of keys
+	uint32_t scan_count = std::max(this->max_count, RADIX * divide_rounding_up(this->max_count, WORKGROUP_SIZE));
+
+	// A level per scan of the sums of the blocks of the previous level, down to a single block
+	do
+	{
+		scan_count = divide_rounding_up(scan_count, SCAN_BLOCK_SIZE);
+
+		auto block_sums = std::make_unique<core::Buffer>(device, scan_count * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY, 0);
+		block_sums->set_debug_name(fmt::format("ComputePrimitives: scan block sums {}", scan_block_sums.size()));
+		scan_block_sums.push_back(std::move(block_sums));
+	} while (scan_count > 1);
+}
+
+bool ComputePrimitives::uses_subgroup_arithmetic() const
+{
+	return subgroup_arithmetic;
+}
+
+uint32_t ComputePrimitives::get_max_count() const
+{
+	return max_count;
+}
+
+void ComputePrimitives::reduce(CommandBuffer &command_buffer, const core::Buffer &input, uint32_t count, const core::Buffer &output, ReduceOperation operation)
+{
+	if (count > max_count)
+	{
+		throw std::runtime_error("ComputePrimitives: reduction of more elements than the maximum count");
+	}
+
+	const ShaderVariant &variant = operation == ReduceOperation::Min ? reduce_min_variant :
+	                               operation == ReduceOperation::Max ? reduce_max_variant :
+	                                                                   base_variant;
+
+	ScopedDebugLabel debug_label{command_buffer, "ComputePrimitives: reduce"};
+
+	uint32_t group_count = std::clamp(divide_rounding_up(count, WORKGROUP_SIZE * REDUCE_VALUES_PER_INVOCATION), 1U, REDUCE_MAX_WORKGROUPS);
+
+	bind_shader(command_buffer, reduce_shader, variant);
+
+	read_barrier(command_buffer, input);
+
+	if (group_count == 1)
+	{
+		write_barrier(command_buffer, output);
+
+		bind_storage_buffer(command_buffer, input, 0);
+		bind_storage_buffer(command_buffer, output, 1);
+		command_buffer.push_constants(count);
+		command_buffer.dispatch(1, 1, 1);
+		return;
+	}
+
+	auto &partials = request_scratch_buffer(reduce_partials, REDUCE_MAX_WORKGROUPS * sizeof(uint32_t), "ComputePrimitives: reduce partials");
+
+	write_barrier(command_buffer, partials);
+
+	bind_storage_buffer(command_buffer, input, 0);
+	bind_storage_buffer(command_buffer, partials, 1);
+	command_buffer.push_constants(count);
+	command_buffer.dispatch(group_count, 1, 1);
+
+	// A single workgroup reduces the results of the workgroups
+	read_barrier(command_buffer, partials);
+	write_barrier(command_buffer, output);
+
+	bind_storage_buffer(command_buffer, partials, 0);
+	bind_storage_buffer(command_buffer, output, 1);
+	command_buffer.push_constants(group_count);
+	command_buffer.dispatch(1, 1, 1);
+}
+
+void ComputePrimitives::exclusive_scan(CommandBuffer &command_buffer, const core::Buffer &input, const core::Buffer &output, uint32_t count)
+{
+	if (count > max_count)
+	{
+		throw std::runtime_error("ComputePrimitives: scan of more elements than the maximum count");
+	}
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	ScopedDebugLabel debug_label{command_buffer, "ComputePrimitives: exclusive scan"};
+
+	record_scan(command_buffer, input, output, count, 0, base_variant);
+}
+
+void ComputePrimitives::compact(CommandBuffer &command_buffer, const core::Buffer &input, const core::Buffer &flags, uint32_t count, const core::Buffer &output, const core::Buffer &output_count)
+{
+	if (count > max_count)
+	{
+		throw std::runtime_error("ComputePrimitives: compaction of more elements than the maximum count");
+	}
+
+	ScopedDebugLabel debug_label{command_buffer, "ComputePrimitives: compact"};
+
+	if (count == 0)
+	{
+		// No invocation would write the count
+		command_buffer.buffer_transition(output_count, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+
+		uint32_t zero = 0;
+		command_buffer.update_buffer(output_count, 0, reinterpret_cast<const uint8_t *>(&zero), sizeof(zero));
+		return;
+	}
+
+	auto &offsets = request_scratch_buffer(compact_offsets, max_count * sizeof(uint32_t), "ComputePrimitives: compact offsets");
+
+	// The flags are counted as 0 or 1 by the first level of the scan only
+	record_scan(command_buffer, flags, offsets, count, 0, count_nonzero_variant);
+
+	read_barrier(command_buffer, input);
+	read_barrier(command_buffer, flags);
+	read_barrier(command_buffer, offsets);
+	write_barrier(command_buffer, output);
+	write_barrier(command_buffer, output_count);
+
+	bind_shader(command_buffer, compact_shader, base_variant);
+	bind_storage_buffer(command_buffer, input, 0);
+	bind_storage_buffer(command_buffer, flags, 1);
+	bind_storage_buffer(command_buffer, offsets, 2);
+	bind_storage_buffer(command_buffer, output, 3);
+	bind_storage_buffer(command_buffer, output_count, 4);
+	command_buffer.push_constants(count);
+	dispatch_blocks(command_buffer, divide_rounding_up(count, WORKGROUP_SIZE));
+}
+
+void ComputePrimitives::radix_sort(CommandBuffer &command_buffer, const core::Buffer &keys, uint32_t count, const core::Buffer *values, uint32_t key_bits)
+{
+	if (count > max_count)
+	{
+		throw std::runtime_error("ComputePrimitives: sort of more elements than the maximum count");
+	}
+
+	uint32_t pass_count = divide_rounding_up(std::min(key_bits, 32U), RADIX_BITS);
+
+	if (count <= 1 || pass_count == 0)
+	{
+		return;
+	}
+
+	ScopedDebugLabel debug_label{command_buffer, "ComputePrimitives: radix sort"};
+
+	uint32_t block_count     = divide_rounding_up(count, WORKGROUP_SIZE);
+	uint32_t histogram_count = RADIX * block_count;
+
+	VkDeviceSize scratch_size = max_count * sizeof(uint32_t);
+
+	auto &histogram = request_scratch_buffer(sort_histogram, RADIX * divide_rounding_up(max_count, WORKGROUP_SIZE) * sizeof(uint32_t), "ComputePrimitives: sort histogram");
+
+	const core::Buffer *source_keys        = &keys;
+	const core::Buffer *destination_keys   = &request_scratch_buffer(sort_keys, scratch_size, "ComputePrimitives: sort keys");
+	const core::Buffer *source_values      = values;
+	const core::Buffer *destination_values = values ? &request_scratch_buffer(sort_values, scratch_size, "ComputePrimitives: sort values") : nullptr;
+
+	const ShaderVariant &scatter_variant = values ? sort_values_variant : base_variant;
+
+	for (uint32_t pass = 0; pass < pass_count; ++pass)
+	{
+		RadixParameters parameters{count, pass * RADIX_BITS};
+
+		read_barrier(command_buffer, *source_keys);
+		write_barrier(command_buffer, histogram);
+
+		bind_shader(command_buffer, radix_histogram_shader, base_variant);
+		bind_storage_buffer(command_buffer, *source_keys, 0);
+		bind_storage_buffer(command_buffer, histogram, 1);
+		command_buffer.push_constants(parameters);
+		dispatch_blocks(command_buffer, block_count);
+
+		// The first element of each digit of each block
+		record_scan(command_buffer, histogram, histogram, histogram_count, 0, base_variant);
+
+		read_barrier(command_buffer, histogram);
+		write_barrier(command_buffer, *destination_keys);
+
+		bind_shader(command_buffer, radix_scatter_shader, scatter_variant);
+		bind_storage_buffer(command_buffer, *source_keys, 0);
+		bind_storage_buffer(command_buffer, *destination_keys, 1);
+		bind_storage_buffer(command_buffer, histogram, 2);
+
+		if (values)
+		{
+			read_barrier(command_buffer, *source_values);
+			write_barrier(command_buffer, *destination_values);
+
+			bind_storage_buffer(command_buffer, *source_values, 3);
+			bind_storage_buffer(command_buffer, *destination_values, 4);
+		}
+
+		command_buffer.push_constants(parameters);
+		dispatch_blocks(command_buffer, block_count);
+
+		std::swap(source_keys, destination_keys);
+		std::swap(source_values, destination_values);
+	}
+
+	// After an odd number of passes the result is in the scratch buffers
+	if (source_keys != &keys)
+	{
+		command_buffer.buffer_transition(*source_keys, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+		command_buffer.buffer_transition(keys, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+		command_buffer.copy_buffer(*source_keys, keys, count * sizeof(uint32_t));
+
+		if (values)
+		{
+			command_buffer.buffer_transition(*source_values, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+			command_buffer.buffer_transition(*values, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+			command_buffer.copy_buffer(*source_values, *values, count * sizeof(uint32_t));
+		}
+	}
+}
+
+void ComputePrimitives::record_scan(CommandBuffer &command_buffer, const core::Buffer &input, const core::Buffer &output, uint32_t count, size_t level, const ShaderVariant &variant)
+{
+	uint32_t block_count = divide_rounding_up(count, SCAN_BLOCK_SIZE);
+
+	auto &block_sums = *scan_block_sums[level];
+
+	read_barrier(command_buffer, input);
+	write_barrier(command_buffer, output);
+	write_barrier(command_buffer, block_sums);
+
+	bind_shader(command_buffer, scan_shader, variant);
+	bind_storage_buffer(command_buffer, input, 0);
+	bind_storage_buffer(command_buffer, output, 1);
+	bind_storage_buffer(command_buffer, block_sums, 2);
+	command_buffer.push_constants(count);
+	dispatch_blocks(command_buffer, block_count);
+
+	if (block_count == 1)
+	{
+		return;
+	}
+
+	// The scanned sums of the blocks are the offsets of the blocks
+	record_scan(command_buffer, block_sums, block_sums, block_count, level + 1, base_variant);
+
+	read_barrier(command_buffer, block_sums);
+	write_barrier(command_buffer, output);
+
+	bind_shader(command_buffer, scan_add_shader, base_variant);
+	bind_storage_buffer(command_buffer, output, 0);
+	bind_storage_buffer(command_buffer, block_sums, 1);
+	command_buffer.push_constants(count);
+	dispatch_blocks(command_buffer, block_count);
+}
+
+void ComputePrimitives::bind_shader(CommandBuffer &command_buffer, const ShaderSource &shader, const ShaderVariant &variant)
+{
+	auto &resource_cache  = device.get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, shader, variant);
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+}
+
+void ComputePrimitives::dispatch_blocks(CommandBuffer &command_buffer, uint32_t block_count)
+{
+	if (block_count == 0)
+	{
+		return;
+	}
+
+	// The shaders skip the workgroups past the last block
+	uint32_t group_count_x = std::min(block_count, max_group_count_x);
+
+	command_buffer.dispatch(group_count_x, divide_rounding_up(block_count, group_count_x), 1);
+}
+
+const core::Buffer &ComputePrimitives::request_scratch_buffer(std::unique_ptr<core::Buffer> &buffer, VkDeviceSize size, const char *name)
+{
+	if (!buffer)
+	{
+		buffer = std::make_unique<core::Buffer>(device, size,
+		                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                        VMA_MEMORY_USAGE_GPU_ONLY, 0);
+		buffer->set_debug_name(name);
+	}
+
+	return *buffer;
+}
+}        // namespace vkb
@@ -0,0 +1,187 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/shader_module.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+
+/**
+ * @brief Parallel reductions, prefix sums, stream compactions and radix sorts of arrays of uints in compute shaders
+ *
+ * The shaders share the workgroup reductions and scans of compute_primitives.h, which use subgroup arithmetic where the
+ * physical device supports it in compute shaders with subgroups of at least MIN_SUBGROUP_SIZE invocations, and trees
+ * in shared memory otherwise. Both paths give the same results.
+ *
+ * The commands are recorded to a vkb::CommandBuffer, outside of a render pass. The buffers are synchronized with
+ * CommandBuffer::buffer_transition(), so the accesses of the caller to them must be tracked the same way, and the
+ * results are read after a transition to their next use. The scratch buffers sized for the largest arrays are owned by
+ * this object, so the commands of two calls must not run at the same time on different queues.
+ */
+class ComputePrimitives
+{
+  public:
+	/// Invocations of the workgroups of the shaders, same as WORKGROUP_SIZE in compute_primitives.h
+	static constexpr uint32_t WORKGROUP_SIZE = 256;
+
+	/// Values scanned by a workgroup, same as SCAN_BLOCK_SIZE in compute_primitives_scan.comp
+	static constexpr uint32_t SCAN_BLOCK_SIZE = WORKGROUP_SIZE * 4;
+
+	/// Bits of the keys sorted per pass of the radix sort, same as RADIX_BITS in the radix shaders
+	static constexpr uint32_t RADIX_BITS = 4;
+
+	/// Smaller subgroups use the shared memory path, as adding up the results of so many subgroups is slower
+	static constexpr uint32_t MIN_SUBGROUP_SIZE = 4;
+
+	enum class ReduceOperation
+	{
+		Add,
+		Min,
+		Max
+	};
+
+	/**
+	 * @param device The device to create the resources with
+	 * @param max_count The largest number of elements of the arrays processed, which sizes the scratch buffers
+	 * @param api_version The Vulkan version of the instance, subgroup arithmetic needs version 1.1
+	 */
+	ComputePrimitives(Device &device, uint32_t max_count, uint32_t api_version = VK_API_VERSION_1_0);
+
+	ComputePrimitives(const ComputePrimitives &) = delete;
+
+	ComputePrimitives(ComputePrimitives &&) = delete;
+
+	~ComputePrimitives() = default;
+
+	ComputePrimitives &operator=(const ComputePrimitives &) = delete;
+
+	ComputePrimitives &operator=(ComputePrimitives &&) = delete;
+
+	bool uses_subgroup_arithmetic() const;
+
+	uint32_t get_max_count() const;
+
+	/**
+	 * @brief Records the reduction of an array to its first element of output, the identity of the operation if empty
+	 * @param input A storage buffer of count uints
+	 * @param output A storage buffer of at least one uint
+	 */
+	void reduce(CommandBuffer &command_buffer, const core::Buffer &input, uint32_t count, const core::Buffer &output, ReduceOperation operation = ReduceOperation::Add);
+
+	/**
+	 * @brief Records the exclusive prefix sum of an array, each output element is the sum of the input elements before it
+	 * @param input A storage buffer of count uints
+	 * @param output A storage buffer of count uints, which may be input
+	 */
+	void exclusive_scan(CommandBuffer &command_buffer, const core::Buffer &input, const core::Buffer &output, uint32_t count);
+
+	/**
+	 * @brief Records the compaction of the elements of an array whose flag is not 0 to the first elements of output,
+	 *        in their order
+	 * @param input A storage buffer of count uints
+	 * @param flags A storage buffer of count uints
+	 * @param output A storage buffer of count uints, other than input
+	 * @param output_count A storage buffer of at least one uint, to which the number of elements kept is written
+	 */
+	void compact(CommandBuffer &command_buffer, const core::Buffer &input, const core::Buffer &flags, uint32_t count, const core::Buffer &output, const core::Buffer &output_count);
+
+	/**
+	 * @brief Records the stable sort of an array of keys in place, and of the values of the keys if any
+	 * @param keys A storage buffer of count uints, with the transfer usages if key_bits / RADIX_BITS is odd
+	 * @param values A storage buffer of count uints moved with their keys, with the same usages as keys, or nullptr
+	 * @param key_bits The low bits of the keys to sort by, rounded up to a multiple of RADIX_BITS
+	 */
+	void radix_sort(CommandBuffer &command_buffer, const core::Buffer &keys, uint32_t count, const core::Buffer *values = nullptr, uint32_t key_bits = 32);
+
+  private:
+	/**
+	 * @brief Records a level of the scan, and the levels of the sums of its blocks recursively
+	 */
+	void record_scan(CommandBuffer &command_buffer, const core::Buffer &input, const core::Buffer &output, uint32_t count, size_t level, const ShaderVariant &variant);
+
+	/**
+	 * @brief Binds the pipeline layout of a shader, for the push constants and buffers bound next
+	 */
+	void bind_shader(CommandBuffer &command_buffer, const ShaderSource &shader, const ShaderVariant &variant);
+
+	/**
+	 * @brief Dispatches a workgroup per block, split over x and y above the group count limit of x
+	 */
+	void dispatch_blocks(CommandBuffer &command_buffer, uint32_t block_count);
+
+	/**
+	 * @brief Returns a scratch buffer of size bytes, created on first use
+	 *        Its size only depends on max_count, so it is never created again while commands may still use it.
+	 */
+	const core::Buffer &request_scratch_buffer(std::unique_ptr<core::Buffer> &buffer, VkDeviceSize size, const char *name);
+
+	Device &device;
+
+	uint32_t max_count;
+
+	bool subgroup_arithmetic{false};
+
+	uint32_t max_group_count_x;
+
+	ShaderSource reduce_shader;
+
+	ShaderSource scan_shader;
+
+	ShaderSource scan_add_shader;
+
+	ShaderSource compact_shader;
+
+	ShaderSource radix_histogram_shader;
+
+	ShaderSource radix_scatter_shader;
+
+	/// Without any definition but SUBGROUP_ARITHMETIC where supported
+	ShaderVariant base_variant;
+
+	ShaderVariant reduce_min_variant;
+
+	ShaderVariant reduce_max_variant;
+
+	ShaderVariant count_nonzero_variant;
+
+	ShaderVariant sort_values_variant;
+
+	/// Partial results of the workgroups of the first pass of a reduction
+	std::unique_ptr<core::Buffer> reduce_partials;
+
+	/// Sums of the blocks of each level of a scan, the last level fits in a single block
+	std::vector<std::unique_ptr<core::Buffer>> scan_block_sums;
+
+	std::unique_ptr<core::Buffer> compact_offsets;
+
+	/// The other half of the ping-pong of the keys and values between the passes of the radix sort
+	std::unique_ptr<core::Buffer> sort_keys;
+
+	std::unique_ptr<core::Buffer> sort_values;
+
+	std::unique_ptr<core::Buffer> sort_histogram;
+};
+}        // namespace vkb
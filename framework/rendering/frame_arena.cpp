@@ -0,0 +1,113 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace vkb
+{
+std::atomic<uint32_t> FrameArena::heap_allocation_count{0};
+
+std::atomic<size_t> FrameArena::allocated_bytes{0};
+
+FrameArena::FrameArena(size_t block_size) :
+    block_size{block_size}
+{
+}
+
+void *FrameArena::allocate(size_t size, size_t alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two");
+
+	if (blocks.empty())
+	{
+		add_block(size + alignment - 1);
+	}
+
+	while (true)
+	{
+		auto &block = blocks[current_block];
+
+		auto base    = reinterpret_cast<uintptr_t>(block.data.get());
+		auto aligned = (base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+		auto end     = static_cast<size_t>(aligned - base) + size;
+
+		if (end <= block.size)
+		{
+			offset     = end;
+			peak_usage = std::max(peak_usage, previous_blocks_usage + offset);
+
+			allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+			return reinterpret_cast<void *>(aligned);
+		}
+
+		// Blocks after the current one only exist within a frame, reset() merges them
+		previous_blocks_usage += offset;
+		add_block(size + alignment - 1);
+	}
+}
+
+void FrameArena::reset()
+{
+	if (blocks.size() > 1)
+	{
+		// The next frame allocates a single block as large as all the blocks of this one
+		size_t total_size = 0;
+		for (auto &block : blocks)
+		{
+			total_size += block.size;
+		}
+
+		blocks.clear();
+		block_size = total_size;
+	}
+
+	current_block         = 0;
+	offset                = 0;
+	previous_blocks_usage = 0;
+}
+
+size_t FrameArena::get_peak_usage() const
+{
+	return peak_usage;
+}
+
+uint32_t FrameArena::take_heap_allocation_count()
+{
+	return heap_allocation_count.exchange(0);
+}
+
+size_t FrameArena::take_allocated_bytes()
+{
+	return allocated_bytes.exchange(0);
+}
+
+void FrameArena::add_block(size_t min_size)
+{
+	size_t size = std::max(block_size, min_size);
+
+	blocks.push_back({std::make_unique<uint8_t[]>(size), size});
+
+	current_block = blocks.size() - 1;
+	offset        = 0;
+
+	heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+}
+}        // namespace vkb
@@ -0,0 +1,164 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief A linear allocator for the temporaries of a frame, like the descriptor writes and attachment infos gathered
+ *        while recording commands
+ *
+ * Allocations move a pointer forward in a block and are never freed individually, all of them are released at once by
+ * reset(). When a block is full another one is allocated, and reset() replaces the blocks with a single block as large
+ * as all of them, so once the frames reach a steady state the arena no longer allocates heap memory.
+ *
+ * An arena is not thread safe, each recording thread uses the arena of its thread index, see RenderFrame::get_arena().
+ */
+class FrameArena
+{
+  public:
+	/// Size in bytes of the first block of an arena, unless set otherwise
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	FrameArena(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+	FrameArena(const FrameArena &) = delete;
+
+	FrameArena(FrameArena &&) = default;
+
+	~FrameArena() = default;
+
+	FrameArena &operator=(const FrameArena &) = delete;
+
+	FrameArena &operator=(FrameArena &&) = default;
+
+	/**
+	 * @brief Allocates memory valid until the next reset()
+	 * @param size Size in bytes
+	 * @param alignment Alignment in bytes, a power of two
+	 * @return The allocated memory, never null
+	 */
+	void *allocate(size_t size, size_t alignment);
+
+	/**
+	 * @brief Releases all the allocations, and merges the blocks if more than one was needed
+	 */
+	void reset();
+
+	/**
+	 * @return The largest number of bytes allocated between two resets
+	 */
+	size_t get_peak_usage() const;
+
+	/**
+	 * @brief Returns the number of heap allocations of all arenas since the last call, and resets it
+	 */
+	static uint32_t take_heap_allocation_count();
+
+	/**
+	 * @brief Returns the number of bytes allocated from all arenas since the last call, and resets it
+	 */
+	static size_t take_allocated_bytes();
+
+  private:
+	struct Block
+	{
+		std::unique_ptr<uint8_t[]> data;
+
+		size_t size{0};
+	};
+
+	size_t block_size;
+
+	std::vector<Block> blocks;
+
+	/// Index of the block allocations are made from
+	size_t current_block{0};
+
+	/// Offset of the first free byte of the current block
+	size_t offset{0};
+
+	/// Bytes used in the blocks before the current one
+	size_t previous_blocks_usage{0};
+
+	size_t peak_usage{0};
+
+	void add_block(size_t min_size);
+
+	static std::atomic<uint32_t> heap_allocation_count;
+
+	static std::atomic<size_t> allocated_bytes;
+};
+
+/**
+ * @brief A standard allocator backed by a FrameArena, deallocation is a no-op as the memory is released by FrameArena::reset()
+ */
+template <typename T>
+class ArenaAllocator
+{
+  public:
+	using value_type = T;
+
+	ArenaAllocator(FrameArena &arena) noexcept :
+	    arena{&arena}
+	{}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other) noexcept :
+	    arena{other.get_arena()}
+	{}
+
+	T *allocate(size_t count)
+	{
+		return static_cast<T *>(arena->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T *, size_t) noexcept
+	{}
+
+	FrameArena *get_arena() const noexcept
+	{
+		return arena;
+	}
+
+  private:
+	FrameArena *arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept
+{
+	return lhs.get_arena() == rhs.get_arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+/// A vector whose elements live in a FrameArena, it must not outlive the next reset of the arena
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}        // namespace vkb
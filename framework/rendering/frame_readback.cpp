@@ -0,0 +1,294 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/frame_readback.h"
+
+#include <algorithm>
+
+#include "core/buffer.h"
+#include "core/command_pool.h"
+#include "core/device.h"
+#include "filesystem/legacy.h"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief Replaces the A component with 255 (removes transparency), and swaps the R and B components if the format is BGR
+ */
+void convert_to_rgba(uint8_t *data, uint32_t width, uint32_t height, bool swizzle)
+{
+	for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i, data += 4)
+	{
+		if (swizzle)
+		{
+			std::swap(data[0], data[2]);
+		}
+		data[3] = 255;
+	}
+}
+}        // namespace
+
+FrameReadback::FrameReadback(RenderContext &render_context, uint32_t ring_size) :
+    render_context{render_context},
+    slots(std::max(ring_size, 1u))
+{
+	auto &device = render_context.get_device();
+
+	uint32_t queue_family_index = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_family_index();
+
+	VkFenceCreateInfo fence_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+
+	for (auto &slot : slots)
+	{
+		slot.command_pool = std::make_unique<CommandPool>(device, queue_family_index);
+		VK_CHECK(vkCreateFence(device.get_handle(), &fence_info, nullptr, &slot.fence));
+	}
+}
+
+FrameReadback::~FrameReadback()
+{
+	try
+	{
+		flush();
+	}
+	catch (const std::exception &e)
+	{
+		LOGE("Frame readback failed: {}", e.what());
+	}
+
+	for (auto &slot : slots)
+	{
+		vkDestroyFence(render_context.get_device().get_handle(), slot.fence, nullptr);
+	}
+}
+
+void FrameReadback::capture(const std::string &filename)
+{
+	auto &slot = acquire_slot();
+
+	slot.filename = filename;
+	slot.on_read  = nullptr;
+	record_copy(slot);
+}
+
+void FrameReadback::capture(ReadCallback on_read)
+{
+	auto &slot = acquire_slot();
+
+	slot.filename.clear();
+	slot.on_read = std::move(on_read);
+	record_copy(slot);
+}
+
+void FrameReadback::update()
+{
+	for (auto &slot : slots)
+	{
+		if (slot.state == SlotState::Copying && vkGetFenceStatus(render_context.get_device().get_handle(), slot.fence) == VK_SUCCESS)
+		{
+			start_encoding(slot);
+		}
+
+		if (slot.state == SlotState::Encoding && slot.encoding.is_done())
+		{
+			slot.state = SlotState::Free;
+
+			// Rethrows the exception of the encoding, if any
+			encoder.wait(slot.encoding);
+		}
+	}
+}
+
+void FrameReadback::flush()
+{
+	for (auto &slot : slots)
+	{
+		wait(slot);
+	}
+}
+
+uint32_t FrameReadback::get_pending_count() const
+{
+	return static_cast<uint32_t>(std::count_if(slots.begin(), slots.end(), [](const Slot &slot) { return slot.state != SlotState::Free; }));
+}
+
+FrameReadback::Slot &FrameReadback::acquire_slot()
+{
+	assert(render_context.get_format() == VK_FORMAT_R8G8B8A8_UNORM ||
+	       render_context.get_format() == VK_FORMAT_B8G8R8A8_UNORM ||
+	       render_context.get_format() == VK_FORMAT_R8G8B8A8_SRGB ||
+	       render_context.get_format() == VK_FORMAT_B8G8R8A8_SRGB);
+
+	auto &slot = slots[next_slot];
+	next_slot  = (next_slot + 1) % slots.size();
+
+	// Only stalls when captures are requested faster than they are written
+	wait(slot);
+
+	return slot;
+}
+
+void FrameReadback::record_copy(Slot &slot)
+{
+	auto &device = render_context.get_device();
+
+	// We want the last completed frame since we don't want to be reading from an incomplete framebuffer
+	auto &frame = render_context.get_last_rendered_frame();
+	assert(!frame.get_render_target().get_views().empty());
+	auto &src_image_view = frame.get_render_target().get_views()[0];
+
+	slot.width  = render_context.get_surface_extent().width;
+	slot.height = render_context.get_surface_extent().height;
+
+	// Check if framebuffer images are in a BGR format
+	auto bgr_formats = {VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_B8G8R8A8_SNORM};
+	slot.swizzle     = std::find(bgr_formats.begin(), bgr_formats.end(), src_image_view.get_format()) != bgr_formats.end();
+
+	VkDeviceSize dst_size = static_cast<VkDeviceSize>(slot.width) * slot.height * 4;
+
+	// The buffer is kept across captures, and only recreated when the swapchain is resized
+	if (!slot.buffer || slot.buffer->get_size() != dst_size)
+	{
+		slot.buffer = std::make_unique<core::Buffer>(device,
+		                                             dst_size,
+		                                             VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                             VMA_MEMORY_USAGE_GPU_TO_CPU,
+		                                             VMA_ALLOCATION_CREATE_MAPPED_BIT);
+	}
+
+	slot.command_pool->reset_pool();
+	auto &cmd_buf = slot.command_pool->request_command_buffer();
+
+	cmd_buf.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	// Enable destination buffer to be written to
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		cmd_buf.buffer_memory_barrier(*slot.buffer, 0, dst_size, memory_barrier);
+	}
+
+	// Enable framebuffer image view to be read from
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout     = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		memory_barrier.new_layout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		cmd_buf.image_memory_barrier(src_image_view, memory_barrier);
+	}
+
+	// Copy framebuffer image memory
+	VkBufferImageCopy image_copy_region{};
+	image_copy_region.bufferRowLength             = slot.width;
+	image_copy_region.bufferImageHeight           = slot.height;
+	image_copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_copy_region.imageSubresource.layerCount = 1;
+	image_copy_region.imageExtent.width           = slot.width;
+	image_copy_region.imageExtent.height          = slot.height;
+	image_copy_region.imageExtent.depth           = 1;
+
+	cmd_buf.copy_image_to_buffer(src_image_view.get_image(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *slot.buffer, {image_copy_region});
+
+	// Enable destination buffer to map memory
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_HOST_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
+
+		cmd_buf.buffer_memory_barrier(*slot.buffer, 0, dst_size, memory_barrier);
+	}
+
+	// Revert back the framebuffer image view from transfer to present
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		memory_barrier.new_layout     = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		cmd_buf.image_memory_barrier(src_image_view, memory_barrier);
+	}
+
+	cmd_buf.end();
+
+	VK_CHECK(vkResetFences(device.get_handle(), 1, &slot.fence));
+
+	// The copy runs on the physical device that rendered the frame, which matters over a device group
+	uint32_t                   device_mask    = render_context.get_frame_device_mask();
+	VkCommandBuffer            cmd_buf_handle = cmd_buf.get_handle();
+	VkDeviceGroupSubmitInfoKHR device_group_info{VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR};
+	device_group_info.commandBufferCount        = 1;
+	device_group_info.pCommandBufferDeviceMasks = &device_mask;
+
+	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+	submit_info.pNext              = device.get_device_group_size() > 1 ? &device_group_info : nullptr;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &cmd_buf_handle;
+
+	device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).submit({submit_info}, slot.fence);
+
+	slot.state = SlotState::Copying;
+}
+
+void FrameReadback::start_encoding(Slot &slot)
+{
+	// Mapped on the rendering thread, the worker only touches the mapped memory
+	slot.buffer->invalidate();
+	uint8_t *data = slot.buffer->map();
+
+	slot.encoding = encoder.submit([data, filename = slot.filename, on_read = slot.on_read, width = slot.width, height = slot.height, swizzle = slot.swizzle]() {
+		convert_to_rgba(data, width, height, swizzle);
+
+		if (on_read)
+		{
+			on_read(data, width, height);
+		}
+		else
+		{
+			fs::write_image(data, filename, width, height, 4, width * 4);
+		}
+	});
+
+	slot.state = SlotState::Encoding;
+}
+
+void FrameReadback::wait(Slot &slot)
+{
+	if (slot.state == SlotState::Copying)
+	{
+		VK_CHECK(vkWaitForFences(render_context.get_device().get_handle(), 1, &slot.fence, VK_TRUE, UINT64_MAX));
+		start_encoding(slot);
+	}
+
+	if (slot.state == SlotState::Encoding)
+	{
+		slot.state = SlotState::Free;
+		encoder.wait(slot.encoding);
+	}
+}
+}        // namespace vkb
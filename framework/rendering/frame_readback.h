@@ -0,0 +1,161 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <core/util/job_system.hpp>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class CommandPool;
+class RenderContext;
+
+namespace core
+{
+class Buffer;
+}
+
+/**
+ * @brief Reads rendered frames back to PNG files, or to callbacks, without stalling the rendering thread
+ *
+ * Each capture copies the last rendered swapchain image into a buffer of a ring, with a submission signalling the fence of
+ * the buffer. update() polls the fences, and hands the buffers whose copy is done to a worker thread, which converts and
+ * encodes them. A buffer returns to the ring once its file is written. The rendering thread only waits when every buffer of
+ * the ring is in flight, so captures every few frames leave the measured frame times alone.
+ *
+ * The worker thread belongs to the readback, rather than to JobSystem::get(), so that encoding never runs on threads
+ * recording frames. The swapchain format must be an 8-bit RGBA or BGRA format.
+ */
+class FrameReadback
+{
+  public:
+	static constexpr uint32_t DEFAULT_RING_SIZE = 3;
+
+	/// Called on the worker thread with the RGBA pixels of a capture, which are only valid during the call
+	using ReadCallback = std::function<void(const uint8_t *pixels, uint32_t width, uint32_t height)>;
+
+	/**
+	 * @param render_context The render context whose frames are captured, it must outlive the readback
+	 * @param ring_size The number of captures in flight before capture() waits for the oldest one
+	 */
+	FrameReadback(RenderContext &render_context, uint32_t ring_size = DEFAULT_RING_SIZE);
+
+	FrameReadback(const FrameReadback &) = delete;
+
+	FrameReadback(FrameReadback &&) = delete;
+
+	/**
+	 * @brief Finishes the captures in flight
+	 */
+	~FrameReadback();
+
+	FrameReadback &operator=(const FrameReadback &) = delete;
+
+	FrameReadback &operator=(FrameReadback &&) = delete;
+
+	/**
+	 * @brief Submits the copy of the last rendered frame, to be written to a PNG file once it is done
+	 * @param filename The name of the file, as for fs::write_image
+	 */
+	void capture(const std::string &filename);
+
+	/**
+	 * @brief Submits the copy of the last rendered frame, to be handed to a callback instead of written to a file
+	 *        Callbacks are called in the order of the captures.
+	 */
+	void capture(ReadCallback on_read);
+
+	/**
+	 * @brief Starts encoding the captures whose copy is done and recycles the buffers of the files written, without waiting
+	 *        Meant to be called once per frame. Rethrows the exception of a failed encoding, if any.
+	 */
+	void update();
+
+	/**
+	 * @brief Waits for every capture in flight to be written
+	 */
+	void flush();
+
+	/**
+	 * @return The number of captures not written yet
+	 */
+	uint32_t get_pending_count() const;
+
+  private:
+	enum class SlotState
+	{
+		Free,
+		Copying,
+		Encoding
+	};
+
+	struct Slot
+	{
+		std::unique_ptr<core::Buffer> buffer;
+
+		std::unique_ptr<CommandPool> command_pool;
+
+		VkFence fence{VK_NULL_HANDLE};
+
+		SlotState state{SlotState::Free};
+
+		std::string filename;
+
+		/// Replaces writing the file if set
+		ReadCallback on_read;
+
+		uint32_t width{0};
+
+		uint32_t height{0};
+
+		/// Whether the red and blue components are swapped, for BGRA formats
+		bool swizzle{false};
+
+		JobHandle encoding;
+	};
+
+	RenderContext &render_context;
+
+	std::vector<Slot> slots;
+
+	/// Slot of the next capture, the slots are used in order so that it is always the oldest one
+	size_t next_slot{0};
+
+	JobSystem encoder{1};
+
+	/**
+	 * @brief Returns the slot of the next capture, once it is free
+	 */
+	Slot &acquire_slot();
+
+	void record_copy(Slot &slot);
+
+	void start_encoding(Slot &slot);
+
+	/**
+	 * @brief Waits for the slot to be free, encoding it first if its copy is in flight
+	 */
+	void wait(Slot &slot);
+};
+}        // namespace vkb
@@ -0,0 +1,200 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_timeline.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/error.h"
+#include "common/strings.h"
+#include "core/device.h"
+#include "core/util/logging.hpp"
+#include "core/util/profiling.hpp"
+
+namespace vkb
+{
+namespace
+{
+std::vector<VkTimeDomainEXT> get_time_domains(Device &device)
+{
+	uint32_t domain_count = 0;
+	VK_CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(device.get_gpu().get_handle(), &domain_count, nullptr));
+	std::vector<VkTimeDomainEXT> domains(domain_count);
+	VK_CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(device.get_gpu().get_handle(), &domain_count, domains.data()));
+
+	return domains;
+}
+}        // namespace
+
+FrameTimeline::FrameTimeline(Device &device, uint32_t frame_count) :
+    device{device},
+    timestamp_period{device.get_gpu().get_properties().limits.timestampPeriod},
+    frames(frame_count)
+{
+	auto domains = get_time_domains(device);
+
+	// std::chrono::steady_clock is CLOCK_MONOTONIC where that domain is available, otherwise the CPU time is taken around the call
+	monotonic_domain = std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT) != domains.end();
+
+	calibrate();
+}
+
+bool FrameTimeline::is_supported(Device &device)
+{
+	if (!device.is_enabled(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+	{
+		return false;
+	}
+
+	auto domains = get_time_domains(device);
+
+	return std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != domains.end();
+}
+
+void FrameTimeline::begin_frame(uint32_t frame_index, uint64_t acquire_begin, uint64_t acquire_end)
+{
+	if (frame_index >= frames.size())
+	{
+		return;
+	}
+
+	auto &frame         = frames[frame_index];
+	frame               = {};
+	frame.sequence      = next_sequence++;
+	frame.acquire_begin = acquire_begin;
+	frame.acquire_end   = acquire_end;
+}
+
+void FrameTimeline::submit(uint32_t frame_index, uint64_t submit_time)
+{
+	if (frame_index >= frames.size() || frames[frame_index].sequence == 0 || frames[frame_index].submit_time != 0)
+	{
+		return;
+	}
+
+	frames[frame_index].submit_time = submit_time;
+	submissions.emplace_back(frames[frame_index].sequence, submit_time);
+}
+
+void FrameTimeline::present(uint32_t frame_index, uint64_t present_begin, uint64_t present_end)
+{
+	if (frame_index >= frames.size())
+	{
+		return;
+	}
+
+	frames[frame_index].present_begin = present_begin;
+	frames[frame_index].present_end   = present_end;
+}
+
+void FrameTimeline::retire_frame(uint32_t frame_index, uint64_t gpu_begin, uint64_t gpu_end)
+{
+	if (frame_index >= frames.size())
+	{
+		return;
+	}
+
+	auto frame = std::exchange(frames[frame_index], {});
+
+	if (frame.sequence == 0 || frame.submit_time == 0 || gpu_end < gpu_begin)
+	{
+		return;
+	}
+
+	if (profiling::now() - calibration_cpu_time > CALIBRATION_INTERVAL)
+	{
+		calibrate();
+	}
+
+	uint64_t gpu_start_time = to_cpu_time(gpu_begin);
+	uint64_t gpu_end_time   = to_cpu_time(gpu_end);
+
+	// The later frames the CPU had submitted when the GPU started this one, the frames are submitted in sequence order
+	uint32_t frames_ahead = 0;
+	for (auto &submission : submissions)
+	{
+		if (submission.first > frame.sequence && submission.second <= gpu_start_time)
+		{
+			frames_ahead++;
+		}
+	}
+
+	while (!submissions.empty() && submissions.front().first <= frame.sequence)
+	{
+		submissions.pop_front();
+	}
+
+	// The GPU was idle since the previous frame ended, because of the CPU until the frame was submitted, then waiting for its semaphores
+	if (last_gpu_end != 0 && gpu_start_time > last_gpu_end)
+	{
+		uint64_t queued_since = std::max(last_gpu_end, frame.submit_time);
+
+		measurements.gpu_idle_times += static_cast<double>(gpu_start_time - last_gpu_end) * 1e-9;
+
+		if (gpu_start_time > queued_since)
+		{
+			measurements.queue_bubble_times += static_cast<double>(gpu_start_time - queued_since) * 1e-9;
+		}
+	}
+
+	last_gpu_end = std::max(last_gpu_end, gpu_end_time);
+
+	measurements.frames_ahead += frames_ahead;
+	measurements.acquire_times += static_cast<double>(frame.acquire_end - frame.acquire_begin) * 1e-9;
+	measurements.present_times += static_cast<double>(frame.present_end - frame.present_begin) * 1e-9;
+	measurements.frame_count++;
+}
+
+FrameTimeline::Measurements FrameTimeline::take_measurements()
+{
+	return std::exchange(measurements, {});
+}
+
+void FrameTimeline::calibrate()
+{
+	std::vector<VkCalibratedTimestampInfoEXT> timestamp_infos{{VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, nullptr, VK_TIME_DOMAIN_DEVICE_EXT}};
+	if (monotonic_domain)
+	{
+		timestamp_infos.push_back({VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, nullptr, VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT});
+	}
+
+	std::vector<uint64_t> timestamps(timestamp_infos.size());
+	uint64_t              max_deviation = 0;
+
+	uint64_t before = profiling::now();
+	VkResult result = vkGetCalibratedTimestampsEXT(device.get_handle(), static_cast<uint32_t>(timestamp_infos.size()), timestamp_infos.data(), timestamps.data(), &max_deviation);
+	uint64_t after  = profiling::now();
+
+	// The previous calibration is kept, and tried again on the next retired frame
+	if (result != VK_SUCCESS)
+	{
+		LOGW("Cannot calibrate the GPU timestamps: {}", to_string(result));
+		return;
+	}
+
+	calibration_gpu_timestamp = timestamps[0];
+	calibration_cpu_time      = monotonic_domain ? timestamps[1] : before + (after - before) / 2;
+}
+
+uint64_t FrameTimeline::to_cpu_time(uint64_t gpu_timestamp) const
+{
+	double ticks = static_cast<double>(gpu_timestamp) - static_cast<double>(calibration_gpu_timestamp);
+
+	return static_cast<uint64_t>(static_cast<double>(calibration_cpu_time) + ticks * timestamp_period);
+}
+}        // namespace vkb
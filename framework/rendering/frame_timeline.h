@@ -0,0 +1,157 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Puts the CPU and GPU events of the frames on a single timeline, to find where the pipeline of frames drains
+ *
+ * The RenderContext reports when it acquires, first submits and presents each frame on the CPU, and the timestamps the
+ * GPU wrote before and after the submissions of the frame once it retired, see RenderContext::set_frame_timeline(). The
+ * GPU timestamps are mapped to the CPU clock with VK_EXT_calibrated_timestamps, calibrated again every second so that
+ * the drift between the clocks does not add up.
+ *
+ * Each retired frame then tells how many frames the CPU had submitted ahead of it when the GPU started it, how long the
+ * GPU was idle since the previous frame, and which part of that idle time the frame was already submitted, waiting for
+ * a semaphore such as the acquire of its image, rather than for the CPU.
+ */
+class FrameTimeline
+{
+  public:
+	/// Time after which the clocks are calibrated again, in nanoseconds
+	static constexpr uint64_t CALIBRATION_INTERVAL = 1000000000;
+
+	/// Measurements summed over the frames retired since they were last taken, times in seconds
+	struct Measurements
+	{
+		/// Frames submitted after a frame by the time the GPU started it, 0 when the GPU waited for the CPU
+		double frames_ahead{0.0};
+
+		/// Times the GPU was idle between the end of a frame and the start of the next one
+		double gpu_idle_times{0.0};
+
+		/// Parts of the idle times when the next frame was already submitted
+		double queue_bubble_times{0.0};
+
+		/// Times the CPU spent acquiring the swapchain images
+		double acquire_times{0.0};
+
+		/// Times the CPU spent presenting
+		double present_times{0.0};
+
+		uint32_t frame_count{0};
+	};
+
+	/**
+	 * @param device The device, which must have VK_EXT_calibrated_timestamps enabled, see is_supported()
+	 * @param frame_count The number of frames of the render context
+	 */
+	FrameTimeline(Device &device, uint32_t frame_count);
+
+	/**
+	 * @return Whether the device can calibrate its timestamps against the CPU clock
+	 */
+	static bool is_supported(Device &device);
+
+	/**
+	 * @brief Starts the timeline of a frame, once the previous use of the frame retired
+	 * @param acquire_begin CPU time before acquiring the swapchain image, see profiling::now()
+	 * @param acquire_end CPU time after acquiring the swapchain image, the same as acquire_begin without a swapchain
+	 */
+	void begin_frame(uint32_t frame_index, uint64_t acquire_begin, uint64_t acquire_end);
+
+	/**
+	 * @brief Records the first submission of a frame to the graphics queue, later ones are ignored
+	 */
+	void submit(uint32_t frame_index, uint64_t submit_time);
+
+	void present(uint32_t frame_index, uint64_t present_begin, uint64_t present_end);
+
+	/**
+	 * @brief Measures a frame once it retired, before begin_frame() reuses it
+	 * @param gpu_begin Timestamp written before the submissions of the frame, in ticks of the device
+	 * @param gpu_end Timestamp written after the submissions of the frame
+	 */
+	void retire_frame(uint32_t frame_index, uint64_t gpu_begin, uint64_t gpu_end);
+
+	/**
+	 * @return The measurements of the frames retired since the last call
+	 */
+	Measurements take_measurements();
+
+  private:
+	struct Frame
+	{
+		/// Number of the frame since the timeline started, 0 if the frame did not begin
+		uint64_t sequence{0};
+
+		uint64_t acquire_begin{0};
+
+		uint64_t acquire_end{0};
+
+		/// Time of the first submission, 0 if the frame was not submitted
+		uint64_t submit_time{0};
+
+		uint64_t present_begin{0};
+
+		uint64_t present_end{0};
+	};
+
+	/**
+	 * @brief Samples the device and CPU clocks together
+	 */
+	void calibrate();
+
+	/**
+	 * @return The CPU time of a GPU timestamp
+	 */
+	uint64_t to_cpu_time(uint64_t gpu_timestamp) const;
+
+	Device &device;
+
+	double timestamp_period;
+
+	/// Whether the device calibrates against CLOCK_MONOTONIC, the clock of std::chrono::steady_clock
+	bool monotonic_domain{false};
+
+	uint64_t calibration_gpu_timestamp{0};
+
+	uint64_t calibration_cpu_time{0};
+
+	std::vector<Frame> frames;
+
+	uint64_t next_sequence{1};
+
+	/// Sequences and first submission times of the recently submitted frames, oldest first
+	std::deque<std::pair<uint64_t, uint64_t>> submissions;
+
+	/// CPU time the last retired frame ended on the GPU, 0 before the first one
+	uint64_t last_gpu_end{0};
+
+	Measurements measurements;
+};
+}        // namespace vkb
@@ -0,0 +1,210 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/gpu_profiler.h"
+
+#include <algorithm>
+
+#include "core/command_buffer.h"
+#include "core/device.h"
+
+namespace vkb
+{
+static_assert(sizeof(GpuProfiler::PipelineStatistics) == 7 * sizeof(uint64_t), "The statistics are read as the results of a query");
+
+double GpuProfiler::PipelineStatistics::get_vertex_reuse() const
+{
+	return vertex_shader_invocations > 0 ? static_cast<double>(input_assembly_vertices) / static_cast<double>(vertex_shader_invocations) : 0.0;
+}
+
+double GpuProfiler::PipelineStatistics::get_overdraw(const VkExtent2D &extent) const
+{
+	uint64_t pixel_count = static_cast<uint64_t>(extent.width) * extent.height;
+	return pixel_count > 0 ? static_cast<double>(fragment_shader_invocations) / static_cast<double>(pixel_count) : 0.0;
+}
+
+GpuProfiler::GpuProfiler(Device &device, uint32_t frame_count, uint32_t max_scopes, uint32_t max_depth, bool pipeline_statistics) :
+    max_scopes{max_scopes},
+    max_depth{max_depth},
+    timestamp_period{device.get_gpu().get_properties().limits.timestampPeriod},
+    frames(frame_count)
+{
+	VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+	query_pool_info.queryCount = frame_count * max_scopes * 2;
+
+	query_pool = std::make_unique<QueryPool>(device, query_pool_info);
+
+	if (pipeline_statistics)
+	{
+		VkQueryPoolCreateInfo statistics_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		statistics_pool_info.queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		statistics_pool_info.queryCount         = frame_count * max_scopes;
+		statistics_pool_info.pipelineStatistics = PIPELINE_STATISTICS;
+
+		statistics_pool = std::make_unique<QueryPool>(device, statistics_pool_info);
+	}
+}
+
+void GpuProfiler::begin_frame(uint32_t frame_index)
+{
+	std::lock_guard<std::mutex> lock{scopes_mutex};
+
+	// The swapchain may have more images than when the profiler was created, those frames are not measured
+	active_frame_index = std::min(frame_index, static_cast<uint32_t>(frames.size()) - 1);
+	frame_measured     = frame_index < frames.size();
+
+	if (!frame_measured)
+	{
+		return;
+	}
+
+	auto &frame = frames[active_frame_index];
+
+	if (frame.reset_recorded && !frame.scopes.empty())
+	{
+		read_results(frame, frame_index * max_scopes);
+	}
+
+	frame.scopes.clear();
+	frame.open_scopes.clear();
+	frame.reset_recorded = false;
+}
+
+bool GpuProfiler::needs_reset() const
+{
+	return frame_measured && !frames[active_frame_index].reset_recorded;
+}
+
+void GpuProfiler::record_reset(CommandBuffer &command_buffer)
+{
+	command_buffer.reset_query_pool(*query_pool, active_frame_index * max_scopes * 2, max_scopes * 2);
+	if (statistics_pool)
+	{
+		command_buffer.reset_query_pool(*statistics_pool, active_frame_index * max_scopes, max_scopes);
+	}
+	frames[active_frame_index].reset_recorded = true;
+}
+
+bool GpuProfiler::begin_scope(VkCommandBuffer command_buffer, const char *name, VkCommandBufferLevel level)
+{
+	std::lock_guard<std::mutex> lock{scopes_mutex};
+
+	auto &frame       = frames[active_frame_index];
+	auto &open_scopes = frame.open_scopes[command_buffer];
+
+	if (!frame_measured || open_scopes.size() >= max_depth || frame.scopes.size() >= max_scopes)
+	{
+		return false;
+	}
+
+	uint32_t scope_index = static_cast<uint32_t>(frame.scopes.size());
+	frame.scopes.push_back({name, static_cast<uint32_t>(open_scopes.size())});
+	open_scopes.push_back(scope_index);
+
+	vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool->get_handle(), (active_frame_index * max_scopes + scope_index) * 2);
+
+	// Pipeline statistics queries do not nest, and the secondary command buffers inherit the ones of the primary command buffer
+	if (statistics_pool && open_scopes.size() == 1 && level == VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+	{
+		frame.scopes.back().has_statistics = true;
+		vkCmdBeginQuery(command_buffer, statistics_pool->get_handle(), active_frame_index * max_scopes + scope_index, 0);
+	}
+
+	return true;
+}
+
+void GpuProfiler::end_scope(VkCommandBuffer command_buffer)
+{
+	std::lock_guard<std::mutex> lock{scopes_mutex};
+
+	auto &open_scopes = frames[active_frame_index].open_scopes[command_buffer];
+	assert(!open_scopes.empty() && "The command buffer has no open scope");
+
+	uint32_t scope_index = open_scopes.back();
+	open_scopes.pop_back();
+
+	if (frames[active_frame_index].scopes[scope_index].has_statistics)
+	{
+		vkCmdEndQuery(command_buffer, statistics_pool->get_handle(), active_frame_index * max_scopes + scope_index);
+	}
+
+	vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool->get_handle(), (active_frame_index * max_scopes + scope_index) * 2 + 1);
+}
+
+const std::vector<GpuProfiler::Scope> &GpuProfiler::get_scopes() const
+{
+	return scopes;
+}
+
+uint64_t GpuProfiler::get_frames_read() const
+{
+	return frames_read;
+}
+
+VkQueryPipelineStatisticFlags GpuProfiler::get_pipeline_statistics() const
+{
+	return statistics_pool ? statistics_pool->get_pipeline_statistics() : 0;
+}
+
+void GpuProfiler::read_results(FrameScopes &frame, uint32_t first_scope)
+{
+	std::vector<uint64_t> timestamps(frame.scopes.size() * 2);
+
+	// Scopes of command buffers which were not submitted have no results, the frame is skipped then
+	if (query_pool->get_results(first_scope * 2, static_cast<uint32_t>(timestamps.size()), timestamps.size() * sizeof(uint64_t), timestamps.data(),
+	                            sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+	{
+		return;
+	}
+
+	// The statistics of a scope are read on their own, as the scopes without statistics leave their queries unavailable
+	for (uint32_t i = 0; i < frame.scopes.size(); i++)
+	{
+		auto &scope = frame.scopes[i];
+		if (scope.has_statistics &&
+		    statistics_pool->get_results(first_scope + i, 1, sizeof(PipelineStatistics), &scope.statistics, sizeof(PipelineStatistics), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+		{
+			return;
+		}
+	}
+
+	bool same_scopes = scopes.size() == frame.scopes.size();
+	for (size_t i = 0; same_scopes && i < scopes.size(); i++)
+	{
+		same_scopes = scopes[i].depth == frame.scopes[i].depth && scopes[i].name == frame.scopes[i].name;
+	}
+
+	if (!same_scopes)
+	{
+		scopes = frame.scopes;
+	}
+
+	for (size_t i = 0; i < scopes.size(); i++)
+	{
+		double time = static_cast<double>(timestamps[i * 2 + 1] - timestamps[i * 2]) * timestamp_period * 1e-9;
+
+		scopes[i].time            = same_scopes ? scopes[i].time + (time - scopes[i].time) * SMOOTHING_FACTOR : time;
+		scopes[i].begin_timestamp = timestamps[i * 2];
+		scopes[i].end_timestamp   = timestamps[i * 2 + 1];
+		scopes[i].has_statistics  = frame.scopes[i].has_statistics;
+		scopes[i].statistics      = frame.scopes[i].statistics;
+	}
+
+	frames_read++;
+}
+}        // namespace vkb
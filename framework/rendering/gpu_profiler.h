@@ -0,0 +1,219 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/query_pool.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+
+/**
+ * @brief Measures the GPU time of the scopes of the frames, as the scopes of ScopedDebugLabel on CommandBuffer objects
+ *
+ * Each frame in flight owns a range of a timestamp query pool, a scope writes a timestamp when it begins and when it ends.
+ * The range of a frame is reset by the first submission of the frame, and its results are read once the frame is waited
+ * for again, frames in flight later, so reading them never stalls. The scopes must therefore be recorded to command buffers
+ * submitted to the graphics queue of the RenderContext, with RenderContext::submit.
+ *
+ * The scopes nest by command buffer, up to a maximum depth, so as an example the subpasses of a render pipeline and their
+ * draw groups are measured, but not each mesh. Scopes beyond the maximum count of a frame are not measured.
+ *
+ * The profiler can also count the pipeline statistics of the outermost scopes of the primary command buffers, such as the
+ * subpasses of a render pipeline and the passes of a postprocessing pipeline, with a second query pool read with the
+ * timestamps. Pipeline statistics queries do not nest, so the inner scopes are only timed. The secondary command buffers
+ * inherit the queries, so the draws recorded in parallel are counted with their subpass. Queries within multiview render
+ * passes take one query per view, so the statistics must not be counted with render targets of several views.
+ */
+class GpuProfiler
+{
+  public:
+	static constexpr uint32_t DEFAULT_MAX_SCOPES = 128;
+
+	static constexpr uint32_t DEFAULT_MAX_DEPTH = 2;
+
+	/// Weight of the last frame in the smoothed times of the scopes
+	static constexpr double SMOOTHING_FACTOR = 0.1;
+
+	/// Statistics counted with pipeline statistics, in the order of the members of PipelineStatistics
+	static constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+	    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+	    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+	    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+	    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+	/**
+	 * @brief Pipeline statistics of a scope, see PIPELINE_STATISTICS
+	 */
+	struct PipelineStatistics
+	{
+		uint64_t input_assembly_vertices{0};
+
+		uint64_t input_assembly_primitives{0};
+
+		uint64_t vertex_shader_invocations{0};
+
+		/// Primitives which reached the clipping stage, after the vertex processing
+		uint64_t clipping_invocations{0};
+
+		/// Primitives output by the clipping stage, the ones passed to the rasterizer
+		uint64_t clipping_primitives{0};
+
+		uint64_t fragment_shader_invocations{0};
+
+		uint64_t compute_shader_invocations{0};
+
+		/**
+		 * @return The vertices assembled per vertex shader invocation, above 1 when the post-transform cache reuses vertices
+		 */
+		double get_vertex_reuse() const;
+
+		/**
+		 * @return The fragment shader invocations per pixel of an extent, which includes the helper invocations, and the
+		 *         invocations of the samples for sample rate shading
+		 */
+		double get_overdraw(const VkExtent2D &extent) const;
+	};
+
+	struct Scope
+	{
+		std::string name;
+
+		/// Number of enclosing scopes
+		uint32_t depth{0};
+
+		/// GPU time of the scope in seconds, smoothed over the frames with the same scopes
+		double time{0.0};
+
+		/// Timestamps of the scope in the last frame read back, in ticks of the device timestamp counter
+		uint64_t begin_timestamp{0};
+
+		uint64_t end_timestamp{0};
+
+		/// Whether the pipeline statistics of the scope are counted, only for the outermost scopes of primary command buffers
+		bool has_statistics{false};
+
+		/// Pipeline statistics of the scope in the last frame read back
+		PipelineStatistics statistics{};
+	};
+
+	/**
+	 * @param device The device to create the query pools with, its graphics queue must support timestamps
+	 * @param frame_count The number of frames in flight
+	 * @param pipeline_statistics Whether to count the pipeline statistics of the outermost scopes, which needs the
+	 *        pipelineStatisticsQuery and inheritedQueries features of the device
+	 */
+	GpuProfiler(Device &device, uint32_t frame_count, uint32_t max_scopes = DEFAULT_MAX_SCOPES, uint32_t max_depth = DEFAULT_MAX_DEPTH,
+	            bool pipeline_statistics = false);
+
+	GpuProfiler(const GpuProfiler &) = delete;
+
+	GpuProfiler(GpuProfiler &&) = delete;
+
+	~GpuProfiler() = default;
+
+	GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+	GpuProfiler &operator=(GpuProfiler &&) = delete;
+
+	/**
+	 * @brief Reads the results of the last use of a frame, which must have been waited for, and starts recording its scopes
+	 */
+	void begin_frame(uint32_t frame_index);
+
+	/**
+	 * @return Whether the queries of the active frame were not reset yet
+	 */
+	bool needs_reset() const;
+
+	/**
+	 * @brief Records the reset of the queries of the active frame, to be submitted before the command buffers writing them
+	 */
+	void record_reset(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Begins a scope in a command buffer of the active frame
+	 * @param level The level of the command buffer, the pipeline statistics are only counted in primary command buffers
+	 * @return Whether the scope is measured, in which case it must be ended with end_scope
+	 */
+	bool begin_scope(VkCommandBuffer command_buffer, const char *name, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+	void end_scope(VkCommandBuffer command_buffer);
+
+	/**
+	 * @return The scopes of the last frame read back, in the order they began
+	 */
+	const std::vector<Scope> &get_scopes() const;
+
+	/**
+	 * @return The number of frames read back, it changes whenever the scopes are updated
+	 */
+	uint64_t get_frames_read() const;
+
+	/**
+	 * @return The statistics counted by the pipeline statistics queries, 0 if they are not counted
+	 */
+	VkQueryPipelineStatisticFlags get_pipeline_statistics() const;
+
+  private:
+	struct FrameScopes
+	{
+		/// Names and depths of the measured scopes, whose timestamps are at twice their index, and statistics at their index
+		std::vector<Scope> scopes;
+
+		/// Indices of the open scopes of each command buffer
+		std::unordered_map<VkCommandBuffer, std::vector<uint32_t>> open_scopes;
+
+		bool reset_recorded{false};
+	};
+
+	void read_results(FrameScopes &frame, uint32_t first_query);
+
+	std::unique_ptr<QueryPool> query_pool;
+
+	/// Pipeline statistics of each scope, null if they are not counted
+	std::unique_ptr<QueryPool> statistics_pool;
+
+	uint32_t max_scopes;
+
+	uint32_t max_depth;
+
+	double timestamp_period;
+
+	std::vector<FrameScopes> frames;
+
+	uint32_t active_frame_index{0};
+
+	bool frame_measured{false};
+
+	std::vector<Scope> scopes;
+
+	uint64_t frames_read{0};
+
+	/// Scopes may be recorded from several threads
+	std::mutex scopes_mutex;
+};
+}        // namespace vkb
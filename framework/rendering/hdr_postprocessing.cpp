@@ -0,0 +1,496 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/hdr_postprocessing.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "common/utils.h"
+#include "common/vk_initializers.h"
+#include "core/device.h"
+#include "filesystem/legacy.h"
+#include "glsl_compiler.h"
+
+namespace vkb
+{
+namespace
+{
+/// Texels of the HDR image on each side of a workgroup of hdr_luminance.comp, 16x16 invocations reading 2x2 texels
+constexpr uint32_t LUMINANCE_TILE_SIZE = 32;
+
+/// Texels of the first bloom level reduced by a workgroup of mipmap_generation.comp on each side
+constexpr uint32_t DOWNSAMPLE_TILE_SIZE = 64;
+
+/// Storage image bindings of mipmap_generation.comp
+constexpr uint32_t DOWNSAMPLE_LEVEL_COUNT = 12;
+
+/// Same layout as Parameters in mipmap_generation.comp
+struct DownsampleParameters
+{
+	glm::uvec2 source_extent;
+
+	uint32_t level_count;
+
+	uint32_t workgroup_count;
+
+	uint32_t srgb;
+};
+
+VkShaderModule create_shader_module(Device &device, const std::string &file, VkShaderStageFlagBits stage, const ShaderVariant &variant)
+{
+	GLSLCompiler glsl_compiler;
+
+	std::vector<uint32_t> spirv;
+	std::string           info_log;
+
+	if (!glsl_compiler.compile_to_spirv(stage, fs::read_shader_binary(file), "main", variant, spirv, info_log))
+	{
+		throw std::runtime_error("Failed to compile " + file + ": " + info_log);
+	}
+
+	VkShaderModuleCreateInfo module_create_info{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+	module_create_info.codeSize = spirv.size() * sizeof(uint32_t);
+	module_create_info.pCode    = spirv.data();
+
+	VkShaderModule shader_module;
+	VK_CHECK(vkCreateShaderModule(device.get_handle(), &module_create_info, nullptr, &shader_module));
+
+	return shader_module;
+}
+
+VkPipelineShaderStageCreateInfo shader_stage_create_info(VkShaderStageFlagBits stage, VkShaderModule shader_module)
+{
+	VkPipelineShaderStageCreateInfo stage_create_info{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
+	stage_create_info.stage  = stage;
+	stage_create_info.module = shader_module;
+	stage_create_info.pName  = "main";
+	return stage_create_info;
+}
+
+void buffer_barrier(VkCommandBuffer command_buffer, VkBuffer buffer, VkAccessFlags src_access_mask, VkAccessFlags dst_access_mask,
+                    VkPipelineStageFlags src_stage_mask, VkPipelineStageFlags dst_stage_mask)
+{
+	VkBufferMemoryBarrier barrier = initializers::buffer_memory_barrier();
+	barrier.srcAccessMask         = src_access_mask;
+	barrier.dstAccessMask         = dst_access_mask;
+	barrier.buffer                = buffer;
+	barrier.offset                = 0;
+	barrier.size                  = VK_WHOLE_SIZE;
+
+	vkCmdPipelineBarrier(command_buffer, src_stage_mask, dst_stage_mask, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+}        // namespace
+
+HDRPostProcessing::HDRPostProcessing(Device &device, uint32_t api_version) :
+    device{device},
+    subgroup_reduction{supports_subgroup_arithmetic(device, api_version)}
+{
+	parameter_buffer = std::make_unique<core::Buffer>(device, sizeof(Parameters), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	parameter_buffer->set_debug_name("HDRPostProcessing: parameter buffer");
+
+	histogram_buffer = std::make_unique<core::Buffer>(device, HISTOGRAM_BIN_COUNT * sizeof(uint32_t),
+	                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY, 0);
+	histogram_buffer->set_debug_name("HDRPostProcessing: histogram buffer");
+
+	// An exposure of 0 makes the first frame use the measured exposure rather than adapt to it
+	exposure_buffer = std::make_unique<core::Buffer>(device, sizeof(Exposure), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+	exposure_buffer->set_debug_name("HDRPostProcessing: exposure buffer");
+	exposure_buffer->convert_and_update(Exposure{});
+	exposure_buffer->flush();
+
+	counter_buffer = std::make_unique<core::Buffer>(device, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	counter_buffer->set_debug_name("HDRPostProcessing: counter buffer");
+	counter_buffer->convert_and_update(0U);
+
+	VkSamplerCreateInfo sampler_create_info = initializers::sampler_create_info();
+	sampler_create_info.magFilter           = VK_FILTER_LINEAR;
+	sampler_create_info.minFilter           = VK_FILTER_LINEAR;
+	sampler_create_info.mipmapMode          = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	sampler_create_info.addressModeU        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.addressModeV        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.addressModeW        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.maxLod              = VK_LOD_CLAMP_NONE;
+	sampler_create_info.borderColor         = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+	VK_CHECK(vkCreateSampler(device.get_handle(), &sampler_create_info, nullptr, &linear_sampler));
+
+	std::vector<VkDescriptorSetLayoutBinding> bindings = {
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0),
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1),
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 2),
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 3),
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 4),
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 5)};
+	VkDescriptorSetLayoutCreateInfo layout_create_info = initializers::descriptor_set_layout_create_info(bindings);
+	VK_CHECK(vkCreateDescriptorSetLayout(device.get_handle(), &layout_create_info, nullptr, &descriptor_set_layout));
+
+	std::vector<VkDescriptorSetLayoutBinding> downsample_bindings = {
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 0),
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, DOWNSAMPLE_LEVEL_COUNT),
+	    initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 2)};
+	layout_create_info = initializers::descriptor_set_layout_create_info(downsample_bindings);
+	VK_CHECK(vkCreateDescriptorSetLayout(device.get_handle(), &layout_create_info, nullptr, &downsample_set_layout));
+
+	std::vector<VkDescriptorPoolSize> pool_sizes = {
+	    initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2),
+	    initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3),
+	    initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 + 1 + DOWNSAMPLE_LEVEL_COUNT),
+	    initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1)};
+	VkDescriptorPoolCreateInfo pool_create_info = initializers::descriptor_pool_create_info(pool_sizes, 2);
+	VK_CHECK(vkCreateDescriptorPool(device.get_handle(), &pool_create_info, nullptr, &descriptor_pool));
+
+	VkDescriptorSetAllocateInfo allocate_info = initializers::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_layout, 1);
+	VK_CHECK(vkAllocateDescriptorSets(device.get_handle(), &allocate_info, &descriptor_set));
+
+	allocate_info = initializers::descriptor_set_allocate_info(descriptor_pool, &downsample_set_layout, 1);
+	VK_CHECK(vkAllocateDescriptorSets(device.get_handle(), &allocate_info, &downsample_set));
+
+	VkPipelineLayoutCreateInfo pipeline_layout_create_info = initializers::pipeline_layout_create_info(&descriptor_set_layout);
+	VK_CHECK(vkCreatePipelineLayout(device.get_handle(), &pipeline_layout_create_info, nullptr, &pipeline_layout));
+
+	VkPushConstantRange push_constant_range            = initializers::push_constant_range(VK_SHADER_STAGE_COMPUTE_BIT, sizeof(DownsampleParameters), 0);
+	pipeline_layout_create_info                        = initializers::pipeline_layout_create_info(&downsample_set_layout);
+	pipeline_layout_create_info.pushConstantRangeCount = 1;
+	pipeline_layout_create_info.pPushConstantRanges    = &push_constant_range;
+	VK_CHECK(vkCreatePipelineLayout(device.get_handle(), &pipeline_layout_create_info, nullptr, &downsample_pipeline_layout));
+
+	create_compute_pipelines();
+
+	update(0.0f);
+}
+
+HDRPostProcessing::~HDRPostProcessing()
+{
+	VkDevice device_handle = device.get_handle();
+
+	destroy_bloom_chain();
+
+	vkDestroyPipeline(device_handle, luminance_pipeline, nullptr);
+	vkDestroyPipeline(device_handle, exposure_pipeline, nullptr);
+	vkDestroyPipeline(device_handle, downsample_pipeline, nullptr);
+	vkDestroyPipeline(device_handle, tonemap_pipeline, nullptr);
+	vkDestroyPipelineLayout(device_handle, pipeline_layout, nullptr);
+	vkDestroyPipelineLayout(device_handle, downsample_pipeline_layout, nullptr);
+	vkDestroyDescriptorPool(device_handle, descriptor_pool, nullptr);
+	vkDestroyDescriptorSetLayout(device_handle, descriptor_set_layout, nullptr);
+	vkDestroyDescriptorSetLayout(device_handle, downsample_set_layout, nullptr);
+	vkDestroySampler(device_handle, linear_sampler, nullptr);
+}
+
+void HDRPostProcessing::set_input(VkImageView view, VkExtent2D extent)
+{
+	hdr_view   = view;
+	hdr_extent = extent;
+
+	destroy_bloom_chain();
+	create_bloom_chain();
+	update_descriptor_sets();
+}
+
+void HDRPostProcessing::set_render_pass(VkRenderPass render_pass, uint32_t subpass)
+{
+	if (tonemap_pipeline != VK_NULL_HANDLE)
+	{
+		vkDestroyPipeline(device.get_handle(), tonemap_pipeline, nullptr);
+	}
+
+	VkPipelineInputAssemblyStateCreateInfo input_assembly_state = initializers::pipeline_input_assembly_state_create_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, 0, VK_FALSE);
+	VkPipelineRasterizationStateCreateInfo rasterization_state  = initializers::pipeline_rasterization_state_create_info(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+	VkPipelineColorBlendAttachmentState    blend_attachment     = initializers::pipeline_color_blend_attachment_state(0xf, VK_FALSE);
+	VkPipelineColorBlendStateCreateInfo    color_blend_state    = initializers::pipeline_color_blend_state_create_info(1, &blend_attachment);
+	VkPipelineDepthStencilStateCreateInfo  depth_stencil_state  = initializers::pipeline_depth_stencil_state_create_info(VK_FALSE, VK_FALSE, VK_COMPARE_OP_ALWAYS);
+	VkPipelineViewportStateCreateInfo      viewport_state       = initializers::pipeline_viewport_state_create_info(1, 1);
+	VkPipelineMultisampleStateCreateInfo   multisample_state    = initializers::pipeline_multisample_state_create_info(VK_SAMPLE_COUNT_1_BIT);
+	std::vector<VkDynamicState>            dynamic_states       = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+	VkPipelineDynamicStateCreateInfo       dynamic_state        = initializers::pipeline_dynamic_state_create_info(dynamic_states);
+
+	// The fullscreen triangle is generated from the vertex index
+	VkPipelineVertexInputStateCreateInfo vertex_input_state = initializers::pipeline_vertex_input_state_create_info();
+
+	std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages = {
+	    shader_stage_create_info(VK_SHADER_STAGE_VERTEX_BIT, create_shader_module(device, "postprocessing/postprocessing.vert", VK_SHADER_STAGE_VERTEX_BIT, {})),
+	    shader_stage_create_info(VK_SHADER_STAGE_FRAGMENT_BIT, create_shader_module(device, "hdr_tonemap.frag", VK_SHADER_STAGE_FRAGMENT_BIT, {}))};
+
+	VkGraphicsPipelineCreateInfo pipeline_create_info = initializers::pipeline_create_info(pipeline_layout, render_pass);
+	pipeline_create_info.subpass                      = subpass;
+	pipeline_create_info.pVertexInputState            = &vertex_input_state;
+	pipeline_create_info.pInputAssemblyState          = &input_assembly_state;
+	pipeline_create_info.pRasterizationState          = &rasterization_state;
+	pipeline_create_info.pColorBlendState             = &color_blend_state;
+	pipeline_create_info.pMultisampleState            = &multisample_state;
+	pipeline_create_info.pViewportState               = &viewport_state;
+	pipeline_create_info.pDepthStencilState           = &depth_stencil_state;
+	pipeline_create_info.pDynamicState                = &dynamic_state;
+	pipeline_create_info.stageCount                   = static_cast<uint32_t>(shader_stages.size());
+	pipeline_create_info.pStages                      = shader_stages.data();
+
+	VK_CHECK(vkCreateGraphicsPipelines(device.get_handle(), VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &tonemap_pipeline));
+
+	for (auto &shader_stage : shader_stages)
+	{
+		vkDestroyShaderModule(device.get_handle(), shader_stage.module, nullptr);
+	}
+}
+
+void HDRPostProcessing::update(float delta_time)
+{
+	exposure_buffer->invalidate();
+	measured_exposure = *reinterpret_cast<const Exposure *>(exposure_buffer->get_data());
+
+	uint32_t bloom_level_count = settings.bloom && bloom_image ? bloom_image->get_subresource().mipLevel : 0;
+
+	Parameters parameters{};
+	parameters.hdr_extent          = {hdr_extent.width, hdr_extent.height};
+	parameters.bloom_extent        = bloom_image ? glm::uvec2{bloom_image->get_extent().width, bloom_image->get_extent().height} : glm::uvec2{0};
+	parameters.min_log_luminance   = settings.min_log_luminance;
+	parameters.log_luminance_range = std::max(settings.max_log_luminance - settings.min_log_luminance, 0.001f);
+	parameters.delta_time          = delta_time;
+	parameters.adaptation_speed    = settings.adaptation_speed;
+	parameters.exposure            = settings.exposure;
+	parameters.bloom_threshold     = settings.bloom_threshold;
+	parameters.bloom_knee          = settings.bloom_knee;
+	parameters.bloom_intensity     = settings.bloom_intensity;
+	parameters.auto_exposure       = settings.auto_exposure ? 1 : 0;
+	parameters.bloom_level_count   = bloom_level_count;
+
+	parameter_buffer->convert_and_update(parameters);
+	parameter_buffer->flush();
+}
+
+void HDRPostProcessing::process(VkCommandBuffer command_buffer)
+{
+	if (!bloom_image)
+	{
+		return;
+	}
+
+	VkImageSubresourceRange bloom_range{VK_IMAGE_ASPECT_COLOR_BIT, 0, bloom_image->get_subresource().mipLevel, 0, 1};
+
+	// The previous contents of the bloom chain are all overwritten
+	VkImageMemoryBarrier image_barrier = initializers::image_memory_barrier();
+	image_barrier.srcAccessMask        = 0;
+	image_barrier.dstAccessMask        = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	image_barrier.oldLayout            = VK_IMAGE_LAYOUT_UNDEFINED;
+	image_barrier.newLayout            = VK_IMAGE_LAYOUT_GENERAL;
+	image_barrier.image                = bloom_image->get_handle();
+	image_barrier.subresourceRange     = bloom_range;
+	vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+	// The histogram of the previous frame has been read by its exposure pass
+	buffer_barrier(command_buffer, histogram_buffer->get_handle(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+	               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+	vkCmdFillBuffer(command_buffer, histogram_buffer->get_handle(), 0, VK_WHOLE_SIZE, 0);
+	buffer_barrier(command_buffer, histogram_buffer->get_handle(), VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+	               VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, luminance_pipeline);
+	vkCmdDispatch(command_buffer, (hdr_extent.width + LUMINANCE_TILE_SIZE - 1) / LUMINANCE_TILE_SIZE, (hdr_extent.height + LUMINANCE_TILE_SIZE - 1) / LUMINANCE_TILE_SIZE, 1);
+
+	buffer_barrier(command_buffer, histogram_buffer->get_handle(), VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+	               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+	// The exposure of the previous frame has been read by its tonemap, and by the host
+	buffer_barrier(command_buffer, exposure_buffer->get_handle(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+	               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, exposure_pipeline);
+	vkCmdDispatch(command_buffer, 1, 1, 1);
+
+	uint32_t level_count = bloom_range.levelCount;
+	if (level_count > 1)
+	{
+		image_barrier.srcAccessMask    = VK_ACCESS_SHADER_WRITE_BIT;
+		image_barrier.dstAccessMask    = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		image_barrier.oldLayout        = VK_IMAGE_LAYOUT_GENERAL;
+		image_barrier.newLayout        = VK_IMAGE_LAYOUT_GENERAL;
+		image_barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+		auto &bloom_extent = bloom_image->get_extent();
+
+		DownsampleParameters parameters{};
+		parameters.source_extent   = {bloom_extent.width, bloom_extent.height};
+		parameters.level_count     = level_count - 1;
+		parameters.workgroup_count = ((bloom_extent.width + DOWNSAMPLE_TILE_SIZE - 1) / DOWNSAMPLE_TILE_SIZE) * ((bloom_extent.height + DOWNSAMPLE_TILE_SIZE - 1) / DOWNSAMPLE_TILE_SIZE);
+		parameters.srgb            = 0;
+
+		vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, downsample_pipeline_layout, 0, 1, &downsample_set, 0, nullptr);
+		vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, downsample_pipeline);
+		vkCmdPushConstants(command_buffer, downsample_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(parameters), &parameters);
+		vkCmdDispatch(command_buffer, parameters.workgroup_count, 1, 1);
+	}
+
+	image_barrier.srcAccessMask    = VK_ACCESS_SHADER_WRITE_BIT;
+	image_barrier.dstAccessMask    = VK_ACCESS_SHADER_READ_BIT;
+	image_barrier.oldLayout        = VK_IMAGE_LAYOUT_GENERAL;
+	image_barrier.newLayout        = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	image_barrier.subresourceRange = bloom_range;
+	vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+	buffer_barrier(command_buffer, exposure_buffer->get_handle(), VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+	               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+	buffer_barrier(command_buffer, exposure_buffer->get_handle(), VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
+	               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+}
+
+void HDRPostProcessing::draw(VkCommandBuffer command_buffer)
+{
+	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, tonemap_pipeline);
+	vkCmdDraw(command_buffer, 3, 1, 0, 0);
+}
+
+HDRPostProcessing::Settings &HDRPostProcessing::get_settings()
+{
+	return settings;
+}
+
+float HDRPostProcessing::get_exposure() const
+{
+	return measured_exposure.exposure;
+}
+
+float HDRPostProcessing::get_average_luminance() const
+{
+	return measured_exposure.average_luminance;
+}
+
+bool HDRPostProcessing::uses_subgroup_reduction() const
+{
+	return subgroup_reduction;
+}
+
+void HDRPostProcessing::create_compute_pipelines()
+{
+	ShaderVariant luminance_variant;
+	luminance_pipeline = create_compute_pipeline("hdr_luminance.comp", luminance_variant, pipeline_layout);
+
+	ShaderVariant exposure_variant;
+	if (subgroup_reduction)
+	{
+		exposure_variant.add_define("SUBGROUP_REDUCTION");
+
+		// Subgroup operations need SPIR-V 1.3, the target of Vulkan 1.1
+		auto target_language         = GLSLCompiler::get_target_language();
+		auto target_language_version = GLSLCompiler::get_target_language_version();
+		GLSLCompiler::set_target_environment(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
+
+		exposure_pipeline = create_compute_pipeline("hdr_exposure.comp", exposure_variant, pipeline_layout);
+
+		GLSLCompiler::set_target_environment(target_language, target_language_version);
+	}
+	else
+	{
+		exposure_pipeline = create_compute_pipeline("hdr_exposure.comp", exposure_variant, pipeline_layout);
+	}
+
+	ShaderVariant downsample_variant;
+	downsample_variant.add_define("FLOAT_LEVELS");
+	downsample_pipeline = create_compute_pipeline("mipmap_generation.comp", downsample_variant, downsample_pipeline_layout);
+}
+
+VkPipeline HDRPostProcessing::create_compute_pipeline(const std::string &file, const ShaderVariant &variant, VkPipelineLayout layout)
+{
+	VkShaderModule shader_module = create_shader_module(device, file, VK_SHADER_STAGE_COMPUTE_BIT, variant);
+
+	VkComputePipelineCreateInfo pipeline_create_info = initializers::compute_pipeline_create_info(layout);
+	pipeline_create_info.stage                       = shader_stage_create_info(VK_SHADER_STAGE_COMPUTE_BIT, shader_module);
+
+	VkPipeline pipeline;
+	VK_CHECK(vkCreateComputePipelines(device.get_handle(), VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline));
+
+	vkDestroyShaderModule(device.get_handle(), shader_module, nullptr);
+
+	return pipeline;
+}
+
+void HDRPostProcessing::create_bloom_chain()
+{
+	VkExtent3D extent{std::max((hdr_extent.width + 1) / 2, 1U), std::max((hdr_extent.height + 1) / 2, 1U), 1};
+
+	uint32_t level_count = 1;
+	while (level_count < MAX_BLOOM_LEVELS && (std::max(extent.width, extent.height) >> level_count) > 0)
+	{
+		++level_count;
+	}
+
+	// The chain is recreated on resize, recycling the images of the sizes used before
+	core::ImageBuilder builder{extent};
+	builder.with_format(VK_FORMAT_R16G16B16A16_SFLOAT)
+	    .with_usage(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+	    .with_mip_levels(level_count)
+	    .with_vma_usage(VMA_MEMORY_USAGE_GPU_ONLY)
+	    .with_debug_name("HDRPostProcessing: bloom chain");
+
+	bloom_image = std::make_unique<core::Image>(device.get_transient_resource_pool().request_image(builder));
+
+	bloom_view = std::make_unique<core::ImageView>(*bloom_image, VK_IMAGE_VIEW_TYPE_2D);
+
+	for (uint32_t level = 0; level < level_count; ++level)
+	{
+		bloom_level_views.push_back(std::make_unique<core::ImageView>(*bloom_image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_UNDEFINED, level, 0, 1, 1));
+	}
+}
+
+void HDRPostProcessing::destroy_bloom_chain()
+{
+	bloom_level_views.clear();
+	bloom_view.reset();
+
+	if (bloom_image)
+	{
+		device.get_transient_resource_pool().release_image(std::move(*bloom_image));
+		bloom_image.reset();
+	}
+}
+
+void HDRPostProcessing::update_descriptor_sets()
+{
+	VkDescriptorImageInfo  hdr_descriptor         = initializers::descriptor_image_info(linear_sampler, hdr_view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	VkDescriptorBufferInfo histogram_descriptor   = {histogram_buffer->get_handle(), 0, VK_WHOLE_SIZE};
+	VkDescriptorBufferInfo exposure_descriptor    = {exposure_buffer->get_handle(), 0, VK_WHOLE_SIZE};
+	VkDescriptorImageInfo  bloom_level_descriptor = initializers::descriptor_image_info(VK_NULL_HANDLE, bloom_level_views[0]->get_handle(), VK_IMAGE_LAYOUT_GENERAL);
+	VkDescriptorImageInfo  bloom_descriptor       = initializers::descriptor_image_info(linear_sampler, bloom_view->get_handle(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	VkDescriptorBufferInfo parameter_descriptor   = {parameter_buffer->get_handle(), 0, VK_WHOLE_SIZE};
+	VkDescriptorBufferInfo counter_descriptor     = {counter_buffer->get_handle(), 0, VK_WHOLE_SIZE};
+
+	// The bindings past the generated levels are not accessed, but must be valid
+	uint32_t                                                  last_level = static_cast<uint32_t>(bloom_level_views.size()) - 1;
+	std::array<VkDescriptorImageInfo, DOWNSAMPLE_LEVEL_COUNT> downsample_level_descriptors;
+	for (uint32_t i = 0; i < DOWNSAMPLE_LEVEL_COUNT; ++i)
+	{
+		auto &level_view                = bloom_level_views[std::min(i + 1, last_level)];
+		downsample_level_descriptors[i] = initializers::descriptor_image_info(VK_NULL_HANDLE, level_view->get_handle(), VK_IMAGE_LAYOUT_GENERAL);
+	}
+
+	std::vector<VkWriteDescriptorSet> writes = {
+	    initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, &hdr_descriptor),
+	    initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, &histogram_descriptor),
+	    initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2, &exposure_descriptor),
+	    initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 3, &bloom_level_descriptor),
+	    initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4, &bloom_descriptor),
+	    initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 5, &parameter_descriptor),
+	    initializers::write_descriptor_set(downsample_set, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0, &bloom_level_descriptor),
+	    initializers::write_descriptor_set(downsample_set, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, downsample_level_descriptors.data(), DOWNSAMPLE_LEVEL_COUNT),
+	    initializers::write_descriptor_set(downsample_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2, &counter_descriptor)};
+
+	vkUpdateDescriptorSets(device.get_handle(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+}        // namespace vkb
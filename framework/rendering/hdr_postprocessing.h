@@ -0,0 +1,252 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/shader_module.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Compute based HDR post-processing, with histogram auto-exposure, bloom and a fused tonemap and composite
+ *
+ * process() records the compute passes reading the HDR color image. hdr_luminance.comp bins the log luminance of the
+ * texels into a histogram in shared memory, merged into a buffer once per workgroup, and writes the bright parts of
+ * each 2x2 texels to the first level of a half resolution bloom chain. hdr_exposure.comp reduces the histogram to the
+ * average luminance, with subgroup reductions where supported, and adapts the exposure towards it over time. The
+ * bloom chain is then downsampled in a single dispatch by mipmap_generation.comp.
+ *
+ * draw() records the fused tonemap and composite as a fullscreen triangle in the caller's render pass: hdr_tonemap.frag
+ * upsamples the levels of the bloom chain with a tent filter while adding them to the HDR color, then applies the
+ * exposure and a filmic curve. There is no upsampling pass.
+ *
+ * The commands are recorded to Vulkan command buffer handles, so that ApiVulkanSample samples can use it as well as
+ * samples recording vkb::CommandBuffer objects. The settings are read from a single uniform buffer written by
+ * update(), the GPU may see them one frame early when frames are in flight, which is harmless for these values.
+ */
+class HDRPostProcessing
+{
+  public:
+	/// Bins of the luminance histogram, the first one counts the texels too dark to be measured
+	static constexpr uint32_t HISTOGRAM_BIN_COUNT = 256;
+
+	/// Levels of the bloom chain at most, the first one is half the resolution of the HDR image
+	static constexpr uint32_t MAX_BLOOM_LEVELS = 6;
+
+	struct Settings
+	{
+		bool auto_exposure{true};
+
+		/// Exposure when auto exposure is disabled, otherwise a factor of the measured exposure
+		float exposure{1.0f};
+
+		/// Speed at which the exposure adapts to the luminance of the scene, per second
+		float adaptation_speed{1.5f};
+
+		/// Range of the histogram, in log2 of the luminance
+		float min_log_luminance{-8.0f};
+
+		float max_log_luminance{6.0f};
+
+		bool bloom{true};
+
+		/// Luminance above which texels contribute to the bloom, with a soft knee of threshold * knee below it
+		float bloom_threshold{1.0f};
+
+		float bloom_knee{0.5f};
+
+		float bloom_intensity{0.1f};
+	};
+
+	/**
+	 * @param device The device to create the resources with
+	 * @param api_version The Vulkan version of the instance, the exposure uses subgroup reductions from version 1.1
+	 */
+	explicit HDRPostProcessing(Device &device, uint32_t api_version = VK_API_VERSION_1_0);
+
+	HDRPostProcessing(const HDRPostProcessing &) = delete;
+
+	HDRPostProcessing(HDRPostProcessing &&) = delete;
+
+	~HDRPostProcessing();
+
+	HDRPostProcessing &operator=(const HDRPostProcessing &) = delete;
+
+	HDRPostProcessing &operator=(HDRPostProcessing &&) = delete;
+
+	/**
+	 * @brief Sets the HDR color image read by process() and draw(), and creates the bloom chain for its extent
+	 *        The device must be idle, as on a resize.
+	 * @param hdr_view A view on a single level 2D color image with the sampled usage, in the shader read only layout
+	 *                 and made visible to the compute shader stage when process() runs
+	 * @param extent The extent of the image
+	 */
+	void set_input(VkImageView hdr_view, VkExtent2D extent);
+
+	/**
+	 * @brief Creates the tonemap pipeline for a subpass of a render pass, with a single color attachment
+	 *        It must be called again if the render pass is created again.
+	 */
+	void set_render_pass(VkRenderPass render_pass, uint32_t subpass = 0);
+
+	/**
+	 * @brief Writes the settings and the frame time to the uniform buffer read by the recorded commands, and reads
+	 *        back the exposure written by the last frame completed on the GPU
+	 */
+	void update(float delta_time);
+
+	/**
+	 * @brief Records the histogram, exposure and bloom passes, outside of a render pass
+	 */
+	void process(VkCommandBuffer command_buffer);
+
+	/**
+	 * @brief Records the tonemap and composite in the current subpass, whose viewport and scissor are set by the caller
+	 */
+	void draw(VkCommandBuffer command_buffer);
+
+	Settings &get_settings();
+
+	/**
+	 * @return The exposure read back by the last update()
+	 */
+	float get_exposure() const;
+
+	/**
+	 * @return The average luminance read back by the last update()
+	 */
+	float get_average_luminance() const;
+
+	/**
+	 * @return Whether the histogram is reduced with subgroup operations rather than through shared memory only
+	 */
+	bool uses_subgroup_reduction() const;
+
+  private:
+	/// Same layout as Parameters in the HDR post-processing shaders
+	struct Parameters
+	{
+		glm::uvec2 hdr_extent;
+
+		glm::uvec2 bloom_extent;
+
+		float min_log_luminance;
+
+		float log_luminance_range;
+
+		float delta_time;
+
+		float adaptation_speed;
+
+		float exposure;
+
+		float bloom_threshold;
+
+		float bloom_knee;
+
+		float bloom_intensity;
+
+		uint32_t auto_exposure;
+
+		uint32_t bloom_level_count;
+	};
+
+	/// Same layout as Exposure in hdr_exposure.comp and hdr_tonemap.frag
+	struct Exposure
+	{
+		float exposure;
+
+		float average_luminance;
+	};
+
+	void create_compute_pipelines();
+
+	void create_bloom_chain();
+
+	void destroy_bloom_chain();
+
+	void update_descriptor_sets();
+
+	VkPipeline create_compute_pipeline(const std::string &file, const ShaderVariant &variant, VkPipelineLayout layout);
+
+	Device &device;
+
+	bool subgroup_reduction{false};
+
+	Settings settings;
+
+	VkImageView hdr_view{VK_NULL_HANDLE};
+
+	VkExtent2D hdr_extent{};
+
+	std::unique_ptr<core::Buffer> parameter_buffer;
+
+	std::unique_ptr<core::Buffer> histogram_buffer;
+
+	/// Read back by get_exposure() and get_average_luminance()
+	std::unique_ptr<core::Buffer> exposure_buffer;
+
+	/// Counter of the last workgroup of mipmap_generation.comp
+	std::unique_ptr<core::Buffer> counter_buffer;
+
+	Exposure measured_exposure{};
+
+	std::unique_ptr<core::Image> bloom_image;
+
+	/// View on all the levels, sampled by the tonemap
+	std::unique_ptr<core::ImageView> bloom_view;
+
+	/// Storage views on each level
+	std::vector<std::unique_ptr<core::ImageView>> bloom_level_views;
+
+	VkSampler linear_sampler{VK_NULL_HANDLE};
+
+	VkDescriptorPool descriptor_pool{VK_NULL_HANDLE};
+
+	/// Layout shared by the luminance, exposure and tonemap passes
+	VkDescriptorSetLayout descriptor_set_layout{VK_NULL_HANDLE};
+
+	VkDescriptorSetLayout downsample_set_layout{VK_NULL_HANDLE};
+
+	VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
+
+	VkDescriptorSet downsample_set{VK_NULL_HANDLE};
+
+	VkPipelineLayout pipeline_layout{VK_NULL_HANDLE};
+
+	VkPipelineLayout downsample_pipeline_layout{VK_NULL_HANDLE};
+
+	VkPipeline luminance_pipeline{VK_NULL_HANDLE};
+
+	VkPipeline exposure_pipeline{VK_NULL_HANDLE};
+
+	VkPipeline downsample_pipeline{VK_NULL_HANDLE};
+
+	VkPipeline tonemap_pipeline{VK_NULL_HANDLE};
+};
+}        // namespace vkb
@@ -0,0 +1,203 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/hiz_pyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/utils.h"
+#include "core/allocated.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+/// Same layout as Parameters in hiz_depth.comp
+struct Parameters
+{
+	glm::uvec2 depth_extent;
+
+	glm::uvec2 pyramid_extent;
+};
+
+/// Invocations of hiz_depth.comp on each side of a workgroup
+constexpr uint32_t GROUP_SIZE = 8;
+
+uint32_t previous_power_of_two(uint32_t value)
+{
+	uint32_t power = 1;
+	while (power * 2 <= value)
+	{
+		power *= 2;
+	}
+	return power;
+}
+}        // namespace
+
+HiZPyramid::HiZPyramid(Device &device) :
+    device{device},
+    shader{"hiz_depth.comp"},
+    mip_generator{device, MipGenerator::Reduction::Min}
+{
+	device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, shader);
+
+	VkSamplerCreateInfo sampler_info{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+	sampler_info.magFilter    = VK_FILTER_NEAREST;
+	sampler_info.minFilter    = VK_FILTER_NEAREST;
+	sampler_info.mipmapMode   = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.maxLod       = VK_LOD_CLAMP_NONE;
+
+	sampler = std::make_unique<core::Sampler>(device, sampler_info);
+	sampler->set_debug_name("HiZPyramid: sampler");
+}
+
+void HiZPyramid::build(CommandBuffer &command_buffer, const core::ImageView &depth_view, VkPipelineStageFlags stage_mask)
+{
+	auto &extent = depth_view.get_image().get_extent();
+	if (!image || extent.width != depth_extent.width || extent.height != depth_extent.height)
+	{
+		create(command_buffer, extent, stage_mask);
+	}
+
+	ScopedDebugLabel debug_label{command_buffer, "Hi-Z pyramid"};
+
+	// The first level is written again, its previous contents are not needed
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = stage_mask | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(*first_level_view, memory_barrier);
+	}
+
+	auto &resource_cache  = device.get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, shader);
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	command_buffer.bind_image(depth_view, *sampler, 0, 0, 0);
+	command_buffer.bind_image(*first_level_view, 0, 1, 0);
+
+	auto pyramid_extent = get_extent();
+
+	Parameters parameters{};
+	parameters.depth_extent   = {depth_extent.width, depth_extent.height};
+	parameters.pyramid_extent = {pyramid_extent.width, pyramid_extent.height};
+	command_buffer.push_constants(parameters);
+
+	command_buffer.dispatch((pyramid_extent.width + GROUP_SIZE - 1) / GROUP_SIZE, (pyramid_extent.height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+
+	// The mip generator reduces the next levels from the first one
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(*first_level_view, memory_barrier);
+	}
+
+	mip_generator.generate(command_buffer, *view, stage_mask | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+}
+
+bool HiZPyramid::is_built() const
+{
+	return image != nullptr;
+}
+
+const core::ImageView &HiZPyramid::get_view() const
+{
+	assert(view && "The pyramid was not built");
+	return *view;
+}
+
+const core::Sampler &HiZPyramid::get_sampler() const
+{
+	return *sampler;
+}
+
+VkExtent2D HiZPyramid::get_extent() const
+{
+	return {image->get_extent().width, image->get_extent().height};
+}
+
+uint32_t HiZPyramid::get_level_count() const
+{
+	return image->get_subresource().mipLevel;
+}
+
+void HiZPyramid::create(CommandBuffer &command_buffer, const VkExtent3D &extent, VkPipelineStageFlags stage_mask)
+{
+	if (image)
+	{
+		// Resizes are rare, the frames in flight may still read the pyramid
+		device.wait_idle();
+		mip_generator.clear();
+
+		first_level_view.reset();
+		view.reset();
+		image.reset();
+	}
+
+	depth_extent = extent;
+
+	VkExtent3D pyramid_extent{previous_power_of_two(extent.width), previous_power_of_two(extent.height), 1};
+	uint32_t   level_count = static_cast<uint32_t>(std::log2(std::max(pyramid_extent.width, pyramid_extent.height))) + 1;
+
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
+
+	image = std::make_unique<core::Image>(device,
+	                                      pyramid_extent,
+	                                      VK_FORMAT_R32_SFLOAT,
+	                                      VK_IMAGE_USAGE_SAMPLED_BIT | MipGenerator::get_image_usage(),
+	                                      VMA_MEMORY_USAGE_GPU_ONLY,
+	                                      VK_SAMPLE_COUNT_1_BIT,
+	                                      level_count);
+	image->set_debug_name("HiZPyramid: image");
+
+	view = std::make_unique<core::ImageView>(*image, VK_IMAGE_VIEW_TYPE_2D);
+	view->set_debug_name("HiZPyramid: view");
+
+	first_level_view = std::make_unique<core::ImageView>(*image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R32_SFLOAT, 0, 0, 1, 1);
+	first_level_view->set_debug_name("HiZPyramid: first level view");
+
+	// The generation expects all the levels in the shader read only layout
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+	memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	memory_barrier.src_access_mask = 0;
+	memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+	memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	memory_barrier.dst_stage_mask  = stage_mask | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+	command_buffer.image_memory_barrier(*view, memory_barrier);
+}
+}        // namespace vkb
@@ -0,0 +1,112 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "common/vk_common.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/sampler.h"
+#include "core/shader_module.h"
+#include "rendering/mip_generator.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+
+/**
+ * @brief A hierarchical depth pyramid, whose texels hold the farthest depth of the texels they cover
+ *
+ * The first level has the largest power of two extent within the depth image, and hiz_depth.comp reduces the up to
+ * 3x3 depth texels covered by each of its texels. The MipGenerator then reduces it to the next levels, down to 1x1.
+ * Since depth is reversed, the farthest depth is the minimum, and a bounding volume whose nearest depth is below the
+ * texels it covers is occluded.
+ *
+ * The pyramid is an R32_SFLOAT image, read with texelFetch() through get_view() and get_sampler().
+ */
+class HiZPyramid
+{
+  public:
+	explicit HiZPyramid(Device &device);
+
+	HiZPyramid(const HiZPyramid &) = delete;
+
+	HiZPyramid(HiZPyramid &&) = delete;
+
+	~HiZPyramid() = default;
+
+	HiZPyramid &operator=(const HiZPyramid &) = delete;
+
+	HiZPyramid &operator=(HiZPyramid &&) = delete;
+
+	/**
+	 * @brief Records the reduction of a depth image to the pyramid, which is created again if the extent changed
+	 * @param command_buffer A command buffer of a queue family supporting compute
+	 * @param depth_view A view on the depth aspect of a depth image, in the shader read only layout
+	 * @param stage_mask Stages reading the pyramid, before and after it is built
+	 */
+	void build(CommandBuffer &command_buffer, const core::ImageView &depth_view, VkPipelineStageFlags stage_mask);
+
+	/**
+	 * @return Whether the pyramid was built at least once
+	 */
+	bool is_built() const;
+
+	/**
+	 * @return A view on all the levels, in the shader read only layout once built
+	 */
+	const core::ImageView &get_view() const;
+
+	/**
+	 * @return A sampler for the pyramid, with nearest filtering
+	 */
+	const core::Sampler &get_sampler() const;
+
+	/**
+	 * @return The extent of the first level
+	 */
+	VkExtent2D get_extent() const;
+
+	uint32_t get_level_count() const;
+
+  private:
+	/**
+	 * @brief Creates the image of the pyramid for a depth image extent, and leaves it in the shader read only layout
+	 */
+	void create(CommandBuffer &command_buffer, const VkExtent3D &depth_extent, VkPipelineStageFlags stage_mask);
+
+	Device &device;
+
+	ShaderSource shader;
+
+	MipGenerator mip_generator;
+
+	VkExtent3D depth_extent{};
+
+	std::unique_ptr<core::Image> image;
+
+	std::unique_ptr<core::ImageView> view;
+
+	/// Storage view written by hiz_depth.comp
+	std::unique_ptr<core::ImageView> first_level_view;
+
+	std::unique_ptr<core::Sampler> sampler;
+};
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -25,6 +25,8 @@ namespace rendering
 {
 vk::Format HPPRenderContext::DEFAULT_VK_FORMAT = vk::Format::eR8G8B8A8Srgb;
 
+uint32_t HPPRenderContext::HEADLESS_FRAME_COUNT = 1;
+
 HPPRenderContext::HPPRenderContext(vkb::core::HPPDevice                    &device,
                                    vk::SurfaceKHR                           surface,
                                    const vkb::Window                       &window,
@@ -49,10 +51,22 @@ HPPRenderContext::HPPRenderContext(vkb::core::HPPDevice                    &devi
 	}
 }
 
+HPPRenderContext::~HPPRenderContext()
+{
+	// Destroyed after the render targets of the frames, which have views of their images
+	for (auto &replaced_swapchain : replaced_swapchains)
+	{
+		device.get_retire_queue().retire(std::move(replaced_swapchain));
+	}
+}
+
 void HPPRenderContext::prepare(size_t thread_count, vkb::rendering::HPPRenderTarget::CreateFunc create_render_target_func)
 {
 	device.get_handle().waitIdle();
 
+	// The attachments created by the render target function are attributed to render targets
+	vkb::allocated::ScopedMemoryTag memory_tag{vkb::allocated::MemoryTag::RenderTarget};
+
 	if (swapchain)
 	{
 		surface_extent = swapchain->get_extent();
@@ -68,17 +82,20 @@ void HPPRenderContext::prepare(size_t thread_count, vkb::rendering::HPPRenderTar
 	}
 	else
 	{
-		// Otherwise, create a single RenderFrame
+		// Otherwise, create the offscreen RenderFrames
 		swapchain = nullptr;
 
-		auto color_image = vkb::core::HPPImage{device,
-		                                       vk::Extent3D{surface_extent.width, surface_extent.height, 1},
-		                                       DEFAULT_VK_FORMAT,        // We can use any format here that we like
-		                                       vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
-		                                       VMA_MEMORY_USAGE_GPU_ONLY};
+		for (uint32_t i = 0; i < std::max(HEADLESS_FRAME_COUNT, 1u); ++i)
+		{
+			auto color_image = vkb::core::HPPImage{device,
+			                                       vk::Extent3D{surface_extent.width, surface_extent.height, 1},
+			                                       DEFAULT_VK_FORMAT,        // We can use any format here that we like
+			                                       vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+			                                       VMA_MEMORY_USAGE_GPU_ONLY};
 
-		auto render_target = create_render_target_func(std::move(color_image));
-		frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
+			auto render_target = create_render_target_func(std::move(color_image));
+			frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
+		}
 	}
 
 	this->create_render_target_func = create_render_target_func;
@@ -168,6 +185,8 @@ void HPPRenderContext::recreate()
 {
 	LOGI("Recreated swapchain");
 
+	vkb::allocated::ScopedMemoryTag memory_tag{vkb::allocated::MemoryTag::RenderTarget};
+
 	vk::Extent2D swapchain_extent = swapchain->get_extent();
 	vk::Extent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
 
@@ -316,6 +335,11 @@ void HPPRenderContext::begin_frame()
 			return;
 		}
 	}
+	else
+	{
+		// Without a swapchain to pick the next image, the offscreen frames are used in turn
+		active_frame_index = (active_frame_index + 1) % static_cast<uint32_t>(frames.size());
+	}
 
 	// Now the frame is active again
 	frame_active = true;
@@ -359,6 +383,16 @@ void HPPRenderContext::submit(const vkb::core::HPPQueue &queue, const std::vecto
 
 	vk::SubmitInfo submit_info(nullptr, nullptr, cmd_buf_handles);
 
+	// Without a swapchain the frames alternate between the GPUs of a device group
+	std::vector<uint32_t>        command_buffer_device_masks;
+	vk::DeviceGroupSubmitInfoKHR device_group_info;
+	if (!swapchain && device.get_device_group_size() > 1)
+	{
+		command_buffer_device_masks.assign(cmd_buf_handles.size(), get_frame_device_mask());
+		device_group_info.setCommandBufferDeviceMasks(command_buffer_device_masks);
+		submit_info.pNext = &device_group_info;
+	}
+
 	vk::Fence fence = frame.request_fence();
 
 	queue.get_handle().submit(submit_info, fence);
@@ -386,6 +420,13 @@ void HPPRenderContext::end_frame(vk::Semaphore semaphore)
 			present_info.pNext = &disp_present_info;
 		}
 
+		// FIFO presents are paced by the window if it can, e.g. with the Choreographer on Android
+		vk::PresentModeKHR present_mode = swapchain->get_present_mode();
+		if (present_mode == vk::PresentModeKHR::eFifo || present_mode == vk::PresentModeKHR::eFifoRelaxed)
+		{
+			window.pace_present();
+		}
+
 		vk::Result result;
 		try
 		{
@@ -460,6 +501,8 @@ void HPPRenderContext::recreate_swapchain()
 	device.get_handle().waitIdle();
 	device.get_resource_cache().clear_framebuffers();
 
+	vkb::allocated::ScopedMemoryTag memory_tag{vkb::allocated::MemoryTag::RenderTarget};
+
 	vk::Extent2D swapchain_extent = swapchain->get_extent();
 	vk::Extent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
 
@@ -496,6 +539,16 @@ uint32_t HPPRenderContext::get_active_frame_index() const
 	return active_frame_index;
 }
 
+uint32_t HPPRenderContext::get_frame_device_mask() const
+{
+	if (swapchain || device.get_device_group_size() <= 1)
+	{
+		return 1u;
+	}
+
+	return 1u << (active_frame_index % device.get_device_group_size());
+}
+
 std::vector<std::unique_ptr<vkb::rendering::HPPRenderFrame>> &HPPRenderContext::get_render_frames()
 {
 	return frames;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2022-2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2022-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,11 +17,22 @@
 
 #pragma once
 
+#include <common/glm_common.h>
 #include <core/hpp_device.h>
+#include <core/hpp_query_pool.h>
 #include <core/hpp_swapchain.h>
+#include <memory_defragmenter.h>
 #include <platform/window.h>
+#include <rendering/frame_timeline.h>
+#include <rendering/gpu_profiler.h>
+#include <rendering/resolution_controller.h>
+#include <rendering/shading_rate_controller.h>
 #include <rendering/hpp_render_frame.h>
 
+#include <chrono>
+#include <deque>
+#include <map>
+
 namespace vkb
 {
 namespace rendering
@@ -37,6 +48,9 @@ class HPPRenderContext
 	// The format to use for the RenderTargets if a swapchain isn't created
 	static vk::Format DEFAULT_VK_FORMAT;
 
+	// The number of RenderFrames created if a swapchain isn't created, read by prepare()
+	static uint32_t HEADLESS_FRAME_COUNT;
+
 	/**
 	 * @brief Constructor
 	 * @param device A valid device
@@ -58,7 +72,7 @@ class HPPRenderContext
 
 	HPPRenderContext(HPPRenderContext &&) = delete;
 
-	virtual ~HPPRenderContext() = default;
+	virtual ~HPPRenderContext();
 
 	HPPRenderContext &operator=(const HPPRenderContext &) = delete;
 
@@ -191,6 +205,13 @@ class HPPRenderContext
 
 	uint32_t get_active_frame_index() const;
 
+	/**
+	 * @brief Returns the device mask the active frame is submitted with
+	 *        In headless mode over a device group, frames alternate between the physical devices of the group
+	 * @return A mask with a single bit set, 1 unless the device spans more than one physical device
+	 */
+	uint32_t get_frame_device_mask() const;
+
 	std::vector<std::unique_ptr<HPPRenderFrame>> &get_render_frames();
 
 	/**
@@ -236,6 +257,116 @@ class HPPRenderContext
 	vk::SurfaceTransformFlagBitsKHR pre_transform{vk::SurfaceTransformFlagBitsKHR::eIdentity};
 
 	size_t thread_count{1};
+
+	/// Mirrors vkb::RenderContext, timeline frame sync and chained multi-queue submissions are not supported by the hpp framework
+	bool timeline_frame_sync{false};
+
+	uint32_t max_frames_in_flight{2};
+
+	std::map<const vkb::core::HPPQueue *, std::pair<vk::Semaphore, uint64_t>> queue_timelines;
+
+	std::vector<std::map<vk::Semaphore, uint64_t>> frame_timeline_values;
+
+	std::deque<std::map<vk::Semaphore, uint64_t>> frames_in_flight;
+
+	const vkb::core::HPPQueue *compute_queue{nullptr};
+
+	const vkb::core::HPPQueue *transfer_queue{nullptr};
+
+	std::map<const vkb::core::HPPQueue *, std::vector<std::pair<vk::Semaphore, vk::PipelineStageFlags>>> chained_waits;
+
+	/// Mirrors vkb::RenderContext, the low latency mode and GPU frame timing are not supported by the hpp framework
+	struct PresentLatencies
+	{
+		double   present_intervals{0.0};
+		uint32_t present_interval_count{0};
+		double   input_to_photon_latencies{0.0};
+		uint32_t input_to_photon_latency_count{0};
+		double   event_to_photon_latencies{0.0};
+		uint32_t event_to_photon_latency_count{0};
+	};
+
+	struct PresentInputTime
+	{
+		uint64_t                              present_id;
+		std::chrono::steady_clock::time_point sample_time;
+		std::chrono::steady_clock::time_point event_time;
+	};
+
+	bool low_latency_mode{false};
+
+	std::chrono::microseconds target_latency{0};
+
+	vk::SwapchainKHR present_wait_swapchain;
+
+	uint64_t present_id{0};
+
+	std::deque<PresentInputTime> present_input_times;
+
+	std::chrono::steady_clock::time_point frame_input_time;
+
+	std::chrono::steady_clock::time_point frame_event_time;
+
+	std::chrono::steady_clock::time_point last_present_time;
+
+	double present_interval{0.0};
+
+	PresentLatencies present_latencies;
+
+	std::unique_ptr<vkb::core::HPPQueryPool> gpu_timestamp_pool;
+
+	std::vector<bool> gpu_timestamps_written;
+
+	double gpu_frame_time{0.0};
+
+	/// Mirrors vkb::RenderContext, the frame timeline is not supported by the hpp framework
+	std::unique_ptr<vkb::FrameTimeline> frame_timeline;
+
+	uint64_t acquire_begin_time{0};
+
+	uint64_t acquire_end_time{0};
+
+	std::unique_ptr<vkb::GpuProfiler> gpu_profiler;
+
+	/// Mirrors vkb::RenderContext, pipeline statistics are not supported by the hpp framework
+	bool gpu_pipeline_statistics{false};
+
+	/// Mirrors vkb::RenderContext, fragment shading rates are not supported by the hpp framework
+	std::unique_ptr<vkb::ShadingRateController> shading_rate_controller;
+
+	/// Mirrors vkb::RenderContext, dynamic resolution is not supported by the hpp framework
+	std::unique_ptr<vkb::ResolutionController> resolution_controller;
+
+	/// Mirrors vkb::RenderContext, projection jitter is not supported by the hpp framework
+	glm::vec2 projection_jitter{0.0f};
+
+	/// Mirrors vkb::RenderContext, memory defragmentation is not supported by the hpp framework
+	std::unique_ptr<vkb::MemoryDefragmenter> memory_defragmenter;
+
+	double defragmentation_idle_gpu_time{0.0};
+
+	/// Mirrors vkb::RenderContext, render targets are not rebuilt lazily by the hpp framework
+	std::vector<bool> stale_render_targets;
+
+	std::vector<std::unique_ptr<vkb::core::HPPSwapchain>> replaced_swapchains;
+
+	/// Mirrors vkb::RenderContext, frame capture and replay are not supported by the hpp framework
+	enum class FrameCaptureState
+	{
+		None,
+		Capturing,
+		Captured
+	};
+
+	FrameCaptureState frame_capture_state{FrameCaptureState::None};
+
+	std::vector<std::vector<vk::CommandBuffer>> captured_submissions;
+
+	std::vector<bool> captured_frames;
+
+	bool captured_gpu_timestamps{false};
+
+	double replay_submit_time{0.0};
 };
 
 }        // namespace rendering
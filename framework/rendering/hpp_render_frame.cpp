@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -49,6 +49,9 @@ HPPRenderFrame::HPPRenderFrame(vkb::core::HPPDevice &device, std::unique_ptr<vkb
 	{
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, vkb::core::HPPDescriptorPool>>());
 		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, vkb::core::HPPDescriptorSet>>());
+		descriptor_set_last_use.push_back(std::make_unique<std::unordered_map<std::size_t, uint64_t>>());
+		resolved_descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, std::size_t>>());
+		arenas.emplace_back();
 	}
 }
 
@@ -80,6 +83,33 @@ vkb::HPPBufferAllocation HPPRenderFrame::allocate_buffer(const vk::BufferUsageFl
 	return buffer_block->allocate(to_u32(size));
 }
 
+vkb::HPPBufferAllocation HPPRenderFrame::allocate_buffer_array(const vk::BufferUsageFlags usage, const vk::DeviceSize element_size, uint32_t element_count, size_t thread_index)
+{
+	assert(thread_index < thread_count && "Thread index is out of bounds");
+
+	auto buffer_pool_it = buffer_pools.find(usage);
+	if (buffer_pool_it == buffer_pools.end())
+	{
+		LOGE("No buffer pool for buffer usage " + vk::to_string(usage));
+		return vkb::HPPBufferAllocation{};
+	}
+
+	assert(thread_index < buffer_pool_it->second.size());
+	auto &buffer_pool  = buffer_pool_it->second[thread_index].first;
+	auto &buffer_block = buffer_pool_it->second[thread_index].second;
+
+	vk::DeviceSize size = buffer_pool.get_element_stride(element_size) * element_count;
+
+	bool want_minimal_block = buffer_allocation_strategy == BufferAllocationStrategy::OneAllocationPerBuffer;
+
+	if (want_minimal_block || !buffer_block || !buffer_block->can_allocate(size))
+	{
+		buffer_block = &buffer_pool.request_buffer_block(size, want_minimal_block);
+	}
+
+	return buffer_block->allocate_array(element_size, element_count);
+}
+
 void HPPRenderFrame::clear_descriptors()
 {
 	for (auto &desc_sets_per_thread : descriptor_sets)
@@ -120,37 +150,19 @@ std::vector<uint32_t> HPPRenderFrame::collect_bindings_to_update(const vkb::core
 std::vector<std::unique_ptr<vkb::core::HPPCommandPool>> &HPPRenderFrame::get_command_pools(const vkb::core::HPPQueue             &queue,
                                                                                            vkb::core::HPPCommandBuffer::ResetMode reset_mode)
 {
-	auto command_pool_it = command_pools.find(queue.get_family_index());
+	// Pools of each reset mode coexist, so that mixing reset modes does not recreate them
+	auto &queue_command_pools = command_pools[{queue.get_family_index(), reset_mode}];
 
-	if (command_pool_it != command_pools.end())
+	if (queue_command_pools.empty())
 	{
-		assert(!command_pool_it->second.empty());
-		if (command_pool_it->second[0]->get_reset_mode() != reset_mode)
+		queue_command_pools.reserve(thread_count);
+		for (size_t i = 0; i < thread_count; i++)
 		{
-			device.get_handle().waitIdle();
-
-			// Delete pools
-			command_pools.erase(command_pool_it);
-		}
-		else
-		{
-			return command_pool_it->second;
+			queue_command_pools.push_back(std::make_unique<vkb::core::HPPCommandPool>(device, queue.get_family_index(), this, i, reset_mode));
 		}
 	}
 
-	bool inserted                       = false;
-	std::tie(command_pool_it, inserted) = command_pools.emplace(queue.get_family_index(), std::vector<std::unique_ptr<vkb::core::HPPCommandPool>>{});
-	if (!inserted)
-	{
-		throw std::runtime_error("Failed to insert command pool");
-	}
-
-	for (size_t i = 0; i < thread_count; i++)
-	{
-		command_pool_it->second.push_back(std::make_unique<vkb::core::HPPCommandPool>(device, queue.get_family_index(), this, i, reset_mode));
-	}
-
-	return command_pool_it->second;
+	return queue_command_pools;
 }
 
 vkb::core::HPPDevice &HPPRenderFrame::get_device()
@@ -293,6 +305,53 @@ void HPPRenderFrame::set_descriptor_management_strategy(DescriptorManagementStra
 	descriptor_management_strategy = new_strategy;
 }
 
+DescriptorManagementStrategy HPPRenderFrame::get_descriptor_management_strategy() const
+{
+	return descriptor_management_strategy;
+}
+
+size_t HPPRenderFrame::get_thread_count() const
+{
+	return thread_count;
+}
+
+void HPPRenderFrame::set_buffer_pool_trim_policy(vk::DeviceSize high_water_mark, uint32_t idle_reset_limit)
+{
+	for (auto &buffer_pools_per_usage : buffer_pools)
+	{
+		for (auto &buffer_pool : buffer_pools_per_usage.second)
+		{
+			buffer_pool.first.set_trim_policy(static_cast<VkDeviceSize>(high_water_mark), idle_reset_limit);
+		}
+	}
+}
+
+vk::DeviceSize HPPRenderFrame::get_buffer_pool_peak_usage(vk::BufferUsageFlags usage) const
+{
+	vk::DeviceSize peak_usage = 0;
+
+	auto buffer_pool_it = buffer_pools.find(usage);
+	if (buffer_pool_it != buffer_pools.end())
+	{
+		for (auto &buffer_pool : buffer_pool_it->second)
+		{
+			peak_usage += static_cast<vk::DeviceSize>(buffer_pool.first.get_peak_usage());
+		}
+	}
+
+	return peak_usage;
+}
+
+void HPPRenderFrame::set_scaled_render_target(std::unique_ptr<vkb::rendering::HPPRenderTarget> &&render_target)
+{
+	scaled_render_target = std::move(render_target);
+}
+
+vkb::rendering::HPPRenderTarget *HPPRenderFrame::get_scaled_render_target()
+{
+	return scaled_render_target.get();
+}
+
 void HPPRenderFrame::update_descriptor_sets(size_t thread_index)
 {
 	assert(thread_index < descriptor_sets.size());
@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2021-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,12 +17,19 @@
 
 #pragma once
 
+#include <atomic>
 #include <core/hpp_device.h>
 #include <hpp_semaphore_pool.h>
+#include <rendering/frame_arena.h>
 #include <vulkan/vulkan_hash.hpp>
 
 namespace vkb
 {
+namespace sg
+{
+class SceneSnapshot;
+}
+
 namespace rendering
 {
 enum class BufferAllocationStrategy
@@ -90,6 +97,16 @@ class HPPRenderFrame
 	 */
 	vkb::HPPBufferAllocation allocate_buffer(vk::BufferUsageFlags usage, vk::DeviceSize size, size_t thread_index = 0);
 
+	/**
+	 * @brief Allocates an array whose elements start at offsets aligned for the usage
+	 * @param usage Usage of the buffer
+	 * @param element_size Size in bytes of one element
+	 * @param element_count Number of elements
+	 * @param thread_index Index of the buffer pool to be used by the current thread
+	 * @return The requested array allocation, it may be empty
+	 */
+	vkb::HPPBufferAllocation allocate_buffer_array(vk::BufferUsageFlags usage, vk::DeviceSize element_size, uint32_t element_count, size_t thread_index = 0);
+
 	/**
 	 * @brief Requests a command buffer to the command pool of the active frame
 	 *        A frame should be active at the moment of requesting it
@@ -117,6 +134,33 @@ class HPPRenderFrame
 	 */
 	void set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy);
 
+	DescriptorManagementStrategy get_descriptor_management_strategy() const;
+
+	/**
+	 * @return The number of threads the frame allocates resource pools for
+	 */
+	size_t get_thread_count() const;
+
+	/**
+	 * @brief Sets the trim policy of every buffer pool of the frame, see vkb::BufferPool::set_trim_policy
+	 */
+	void set_buffer_pool_trim_policy(vk::DeviceSize high_water_mark, uint32_t idle_reset_limit);
+
+	/**
+	 * @return The peak number of bytes allocated in a frame from the buffer pools of the given usage, summed over all threads
+	 */
+	vk::DeviceSize get_buffer_pool_peak_usage(vk::BufferUsageFlags usage) const;
+
+	/**
+	 * @brief Sets the render target the scene is rendered to when its resolution is scaled, see vkb::RenderFrame::set_scaled_render_target
+	 */
+	void set_scaled_render_target(std::unique_ptr<vkb::rendering::HPPRenderTarget> &&render_target);
+
+	/**
+	 * @return The render target the scene is rendered to when its resolution is scaled, null if it is not
+	 */
+	vkb::rendering::HPPRenderTarget *get_scaled_render_target();
+
 	/**
 	 * @brief Called when the swapchain changes
 	 * @param render_target A new render target with updated images
@@ -132,8 +176,7 @@ class HPPRenderFrame
 	/**
 	 * @brief Retrieve the frame's command pool(s)
 	 * @param queue The queue command buffers will be submitted on
-	 * @param reset_mode Indicate how the command buffers will be reset after execution,
-	 *        may trigger a pool re-creation to set necessary flags
+	 * @param reset_mode Indicate how the command buffers will be reset after execution
 	 * @return The frame's command pool(s)
 	 */
 	std::vector<std::unique_ptr<vkb::core::HPPCommandPool>> &get_command_pools(const vkb::core::HPPQueue             &queue,
@@ -153,8 +196,8 @@ class HPPRenderFrame
 
 	vkb::core::HPPDevice &device;
 
-	/// Commands pools associated to the frame
-	std::map<uint32_t, std::vector<std::unique_ptr<vkb::core::HPPCommandPool>>> command_pools;
+	/// Commands pools associated to the frame, by queue family index and reset mode
+	std::map<std::pair<uint32_t, vkb::core::HPPCommandBuffer::ResetMode>, std::vector<std::unique_ptr<vkb::core::HPPCommandPool>>> command_pools;
 
 	/// Descriptor pools for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, vkb::core::HPPDescriptorPool>>> descriptor_pools;
@@ -162,6 +205,23 @@ class HPPRenderFrame
 	/// Descriptor sets for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, vkb::core::HPPDescriptorSet>>> descriptor_sets;
 
+	/// Mirrors vkb::RenderFrame, eviction of unused descriptor sets is not supported by the hpp framework
+	std::vector<std::unique_ptr<std::unordered_map<std::size_t, uint64_t>>> descriptor_set_last_use;
+
+	/// Mirrors vkb::RenderFrame, resolving descriptor sets by resources is not supported by the hpp framework
+	std::vector<std::unique_ptr<std::unordered_map<std::size_t, std::size_t>>> resolved_descriptor_sets;
+
+	uint64_t reset_count{0};
+
+	/// Mirrors vkb::RenderFrame::DEFAULT_DESCRIPTOR_SET_MAX_UNUSED_FRAMES
+	uint32_t descriptor_set_max_unused_frames{8};
+
+	std::atomic<size_t> descriptor_set_cache_size{0};
+
+	std::atomic<uint32_t> descriptor_set_cache_hits{0};
+
+	std::atomic<uint32_t> descriptor_set_cache_misses{0};
+
 	vkb::HPPFencePool fence_pool;
 
 	vkb::HPPSemaphorePool semaphore_pool;
@@ -170,11 +230,21 @@ class HPPRenderFrame
 
 	std::unique_ptr<vkb::rendering::HPPRenderTarget> swapchain_render_target;
 
+	std::unique_ptr<vkb::rendering::HPPRenderTarget> scaled_render_target;
+
 	BufferAllocationStrategy buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
 	std::map<vk::BufferUsageFlags, std::vector<std::pair<vkb::HPPBufferPool, vkb::HPPBufferBlock *>>> buffer_pools;
+
+	/// Mirrors vkb::RenderFrame, frame arenas are not supported by the hpp framework
+	std::vector<vkb::FrameArena> arenas;
+
+	const vkb::sg::SceneSnapshot *scene_snapshot{nullptr};
+
+	/// Mirrors vkb::RenderFrame, frame replay is not supported by the hpp framework
+	bool replayable{false};
 };
 }        // namespace rendering
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2021-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -33,6 +33,11 @@ namespace rendering
 class HPPRenderPipeline : private vkb::RenderPipeline
 {
   public:
+	using vkb::RenderPipeline::set_job_system;
+	using vkb::RenderPipeline::set_attachment_validation;
+	using vkb::RenderPipeline::set_last_subpass_secondary;
+	using vkb::RenderPipeline::set_multisampling;
+
 	void add_subpass(std::unique_ptr<vkb::rendering::subpasses::HPPForwardSubpass> &&subpass)
 	{
 		vkb::RenderPipeline::add_subpass(std::move(subpass));
@@ -46,6 +51,11 @@ class HPPRenderPipeline : private vkb::RenderPipeline
 		                          reinterpret_cast<vkb::RenderTarget &>(render_target),
 		                          static_cast<VkSubpassContents>(contents));
 	}
+
+	vk::SubpassContents get_last_subpass_contents() const
+	{
+		return static_cast<vk::SubpassContents>(vkb::RenderPipeline::get_last_subpass_contents());
+	}
 };
 }        // namespace rendering
 }        // namespace vkb
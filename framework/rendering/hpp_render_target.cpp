@@ -62,6 +62,7 @@ HPPRenderTarget::HPPRenderTarget(std::vector<core::HPPImage> &&images_) :
 	{
 		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Extent size is not unique"};
 	}
+	render_extent = extent;
 
 	for (auto &image : images)
 	{
@@ -92,6 +93,7 @@ HPPRenderTarget::HPPRenderTarget(std::vector<core::HPPImageView> &&image_views)
 	{
 		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Extent size is not unique"};
 	}
+	render_extent = extent;
 
 	for (auto &view : views)
 	{
@@ -105,6 +107,18 @@ const vk::Extent2D &HPPRenderTarget::get_extent() const
 	return extent;
 }
 
+void HPPRenderTarget::set_render_extent(const vk::Extent2D &render_extent_)
+{
+	assert(render_extent_.width <= extent.width && render_extent_.height <= extent.height && "The render extent exceeds the images");
+
+	render_extent = render_extent_;
+}
+
+const vk::Extent2D &HPPRenderTarget::get_render_extent() const
+{
+	return render_extent;
+}
+
 const std::vector<core::HPPImageView> &HPPRenderTarget::get_views() const
 {
 	return views;
@@ -44,10 +44,11 @@ struct HPPAttachment
 	    usage{usage}
 	{}
 
-	vk::Format              format         = vk::Format::eUndefined;
-	vk::SampleCountFlagBits samples        = vk::SampleCountFlagBits::e1;
-	vk::ImageUsageFlags     usage          = vk::ImageUsageFlagBits::eSampled;
-	vk::ImageLayout         initial_layout = vk::ImageLayout::eUndefined;
+	vk::Format              format                    = vk::Format::eUndefined;
+	vk::SampleCountFlagBits samples                   = vk::SampleCountFlagBits::e1;
+	vk::ImageUsageFlags     usage                     = vk::ImageUsageFlagBits::eSampled;
+	vk::ImageLayout         initial_layout            = vk::ImageLayout::eUndefined;
+	uint32_t                compressed_bits_per_pixel = 0;        // Mirrors vkb::Attachment, fixed-rate compression is not supported by the hpp framework
 };
 
 /**
@@ -75,6 +76,8 @@ class HPPRenderTarget
 	HPPRenderTarget &operator=(HPPRenderTarget &&other) noexcept = delete;
 
 	const vk::Extent2D                    &get_extent() const;
+	void                                   set_render_extent(const vk::Extent2D &render_extent);
+	const vk::Extent2D                    &get_render_extent() const;
 	const std::vector<core::HPPImageView> &get_views() const;
 	const std::vector<HPPAttachment>      &get_attachments() const;
 
@@ -104,6 +107,8 @@ class HPPRenderTarget
 	std::vector<HPPAttachment>      attachments;
 	std::vector<uint32_t>           input_attachments  = {};         // By default there are no input attachments
 	std::vector<uint32_t>           output_attachments = {0};        // By default the output attachments is attachment 0
+	vk::Extent2D                    render_extent;
+	uint32_t                        view_count         = 1;          // Mirrors vkb::RenderTarget, multiview is not supported by the hpp framework
 };
 }        // namespace rendering
 }        // namespace vkb
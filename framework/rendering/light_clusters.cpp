@@ -0,0 +1,183 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/light_clusters.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/utils.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "rendering/render_frame.h"
+#include "rendering/subpass.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+#include "scene_graph/scene_snapshot.h"
+
+namespace vkb
+{
+namespace
+{
+/// Scale of the distance in the attenuation of apply_point_light(), see lighting.h
+constexpr float POINT_LIGHT_DISTANCE_SCALE = 0.005f;
+
+constexpr uint32_t CLUSTER_COUNT = LightClusters::CLUSTER_GRID_X * LightClusters::CLUSTER_GRID_Y * LightClusters::CLUSTER_GRID_Z;
+
+/**
+ * @return The radius of the sphere out of which the light has no contribution, negative if there is none
+ */
+float get_light_radius(const Light &light)
+{
+	float range = light.direction.w;
+	if (range > 0.0f)
+	{
+		return range;
+	}
+
+	if (light.position.w != static_cast<float>(sg::LightType::Point))
+	{
+		return -1.0f;
+	}
+
+	// Solves intensity * color / (distance * scale)^2 = cutoff for the brightest channel
+	glm::vec3 color     = glm::vec3(light.color);
+	float     intensity = light.color.w * std::max(color.r, std::max(color.g, color.b));
+
+	return std::sqrt(std::max(intensity, 0.0f) / LightClusters::LIGHT_CUTOFF) / POINT_LIGHT_DISTANCE_SCALE;
+}
+}        // namespace
+
+std::vector<std::string> LightClusters::get_definitions()
+{
+	return {"CLUSTERED_LIGHTING", "MAX_LIGHTS_PER_CLUSTER " + std::to_string(MAX_LIGHTS_PER_CLUSTER) + "U"};
+}
+
+LightClusters::LightClusters(Device &device) :
+    device{device},
+    cull_shader{"clustered_light_cull.comp"}
+{
+	cull_variant.add_definitions(get_definitions());
+
+	device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, cull_shader, cull_variant);
+
+	cluster_lights_buffer = std::make_unique<core::Buffer>(device,
+	                                                       CLUSTER_COUNT * (MAX_LIGHTS_PER_CLUSTER + 1) * sizeof(uint32_t),
+	                                                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	                                                       VMA_MEMORY_USAGE_GPU_ONLY);
+	cluster_lights_buffer->set_debug_name("LightClusters: cluster lights buffer");
+}
+
+void LightClusters::cull(CommandBuffer &command_buffer, RenderFrame &render_frame, size_t thread_index, sg::PerspectiveCamera &camera, const sg::ComponentView<sg::Light> &scene_lights)
+{
+	// Transforms are read from the snapshot the frame is recorded from, if any
+	auto snapshot = render_frame.get_scene_snapshot();
+
+	glm::mat4 view = sg::get_view(snapshot, camera);
+
+	std::vector<Light>     lights;
+	std::vector<glm::vec4> light_bounds;
+
+	for (auto scene_light : scene_lights)
+	{
+		if (scene_light->get_light_type() != sg::LightType::Point && scene_light->get_light_type() != sg::LightType::Spot)
+		{
+			continue;
+		}
+
+		const auto &properties = scene_light->get_properties();
+		auto        transform  = sg::get_node_state(snapshot, *scene_light->get_node());
+
+		// Same layout as Subpass::allocate_lights()
+		Light light{{transform.translation, static_cast<float>(scene_light->get_light_type())},
+		            {properties.color, properties.intensity},
+		            {transform.rotation * properties.direction, properties.range},
+		            {properties.inner_cone_angle, properties.outer_cone_angle}};
+
+		lights.push_back(light);
+		light_bounds.emplace_back(glm::vec3(view * glm::vec4(transform.translation, 1.0f)), get_light_radius(light));
+	}
+
+	glm::mat4 projection = sg::get_projection(snapshot, camera);
+
+	float near_plane = camera.get_near_plane();
+	float far_plane  = camera.get_far_plane();
+	float log_depth  = std::log(far_plane / near_plane);
+
+	ClusterUniform cluster_uniform{};
+	cluster_uniform.view          = view;
+	cluster_uniform.projection    = glm::vec4(projection[0][0], projection[1][1], projection[2][0], projection[2][1]);
+	cluster_uniform.depth_slicing = glm::vec4(near_plane, far_plane, CLUSTER_GRID_Z / log_depth, -(CLUSTER_GRID_Z * std::log(near_plane)) / log_depth);
+	cluster_uniform.grid          = glm::uvec4(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, to_u32(lights.size()));
+
+	// Bindings of empty buffers are not valid, the shaders read no light from them
+	light_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, std::max<size_t>(lights.size(), 1) * sizeof(Light), thread_index);
+	light_buffer.update(reinterpret_cast<const uint8_t *>(lights.data()), lights.size() * sizeof(Light));
+
+	auto light_bounds_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, std::max<size_t>(light_bounds.size(), 1) * sizeof(glm::vec4), thread_index);
+	light_bounds_buffer.update(reinterpret_cast<const uint8_t *>(light_bounds.data()), light_bounds.size() * sizeof(glm::vec4));
+
+	cluster_uniform_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(ClusterUniform), thread_index);
+	cluster_uniform_buffer.update(cluster_uniform);
+
+	ScopedDebugLabel cull_debug_label{command_buffer, "Clustered light culling"};
+
+	// The fragments of the previous frame may still read the clusters
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+
+		command_buffer.buffer_memory_barrier(*cluster_lights_buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+	}
+
+	auto &resource_cache  = device.get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, cull_shader, cull_variant);
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	command_buffer.bind_buffer(cluster_uniform_buffer.get_buffer(), cluster_uniform_buffer.get_offset(), cluster_uniform_buffer.get_size(), 0, 0, 0);
+	command_buffer.bind_buffer(light_bounds_buffer.get_buffer(), light_bounds_buffer.get_offset(), light_bounds_buffer.get_size(), 0, 1, 0);
+	command_buffer.bind_buffer(*cluster_lights_buffer, 0, cluster_lights_buffer->get_size(), 0, 2, 0);
+
+	command_buffer.dispatch((CLUSTER_COUNT + 63) / 64, 1, 1);
+
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+
+		command_buffer.buffer_memory_barrier(*cluster_lights_buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+	}
+}
+
+void LightClusters::bind(CommandBuffer &command_buffer, uint32_t set, uint32_t first_binding)
+{
+	assert(!cluster_uniform_buffer.empty() && "The lights must be culled first");
+
+	command_buffer.bind_buffer(cluster_uniform_buffer.get_buffer(), cluster_uniform_buffer.get_offset(), cluster_uniform_buffer.get_size(), set, first_binding, 0);
+	command_buffer.bind_buffer(light_buffer.get_buffer(), light_buffer.get_offset(), light_buffer.get_size(), set, first_binding + 1, 0);
+	command_buffer.bind_buffer(*cluster_lights_buffer, 0, cluster_lights_buffer->get_size(), set, first_binding + 2, 0);
+}
+}        // namespace vkb
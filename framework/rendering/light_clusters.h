@@ -0,0 +1,138 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer_pool.h"
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/shader_module.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+class RenderFrame;
+
+namespace sg
+{
+class Light;
+class PerspectiveCamera;
+
+template <class T>
+class ComponentView;
+}        // namespace sg
+
+/**
+ * @brief Cluster grid parameters, read by clustered_light_cull.comp and the shaders including clustered_lighting.h
+ */
+struct alignas(16) ClusterUniform
+{
+	glm::mat4 view;
+
+	/// x, y scales and x, y offsets of the projection
+	glm::vec4 projection;
+
+	/// Near and far depths, scale and bias of the slice of a log depth
+	glm::vec4 depth_slicing;
+
+	/// xyz number of clusters, w number of lights
+	glm::uvec4 grid;
+};
+
+/**
+ * @brief Bins the point and spot lights of a scene into the clusters of a camera view, on the GPU
+ *
+ * The view frustum is divided into a grid of clusters: screen tiles, each split into depth slices spaced exponentially
+ * between the near and far planes of the camera. cull() records a compute shader which tests the bounding sphere of
+ * every point and spot light against the bounding box of every cluster, and lists the lights of each cluster in a
+ * storage buffer. It must be recorded outside of a render pass, before the shaders reading the clusters.
+ *
+ * The bounding sphere of a light has its range as radius, or if the light has none, the distance past which its
+ * attenuated intensity is below LIGHT_CUTOFF. Spot lights without range are not attenuated, they are in every cluster.
+ * A cluster holds at most MAX_LIGHTS_PER_CLUSTER lights, the next ones are dropped.
+ *
+ * Shaders read the clusters by including clustered_lighting.h, with get_definitions().
+ */
+class LightClusters
+{
+  public:
+	static constexpr uint32_t CLUSTER_GRID_X = 16;
+
+	static constexpr uint32_t CLUSTER_GRID_Y = 9;
+
+	static constexpr uint32_t CLUSTER_GRID_Z = 24;
+
+	static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 127;
+
+	/// Fraction of the light color under which an unbounded point light is considered to have no contribution
+	static constexpr float LIGHT_CUTOFF = 1.0f / 256.0f;
+
+	/**
+	 * @return The definitions of the shaders reading the clusters
+	 */
+	static std::vector<std::string> get_definitions();
+
+	LightClusters(Device &device);
+
+	LightClusters(const LightClusters &) = delete;
+
+	LightClusters(LightClusters &&) = delete;
+
+	LightClusters &operator=(const LightClusters &) = delete;
+
+	LightClusters &operator=(LightClusters &&) = delete;
+
+	/**
+	 * @brief Records the binning of the point and spot lights into the clusters, the other lights are ignored
+	 * @param command_buffer The command buffer to record to, outside of a render pass
+	 * @param render_frame The frame to allocate the light buffers from
+	 * @param thread_index The thread of the frame resources
+	 * @param camera The camera viewing the lights
+	 * @param scene_lights The lights of the scene
+	 */
+	void cull(CommandBuffer &command_buffer, RenderFrame &render_frame, size_t thread_index, sg::PerspectiveCamera &camera, const sg::ComponentView<sg::Light> &scene_lights);
+
+	/**
+	 * @brief Binds the cluster uniform, the lights and the cluster light lists of the last cull()
+	 * @param command_buffer The command buffer to bind to
+	 * @param set The descriptor set to bind to
+	 * @param first_binding The binding of the cluster uniform, the next two bindings are the ones of the lights and the light lists
+	 */
+	void bind(CommandBuffer &command_buffer, uint32_t set, uint32_t first_binding);
+
+  private:
+	Device &device;
+
+	ShaderSource cull_shader;
+
+	ShaderVariant cull_variant;
+
+	/// Written by the culling shader every frame
+	std::unique_ptr<core::Buffer> cluster_lights_buffer;
+
+	/// Cluster uniform and point and spot lights of the last cull()
+	BufferAllocation cluster_uniform_buffer;
+
+	BufferAllocation light_buffer;
+};
+}        // namespace vkb
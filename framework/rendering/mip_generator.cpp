@@ -0,0 +1,236 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/mip_generator.h"
+
+#include <algorithm>
+
+#include "common/utils.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "core/image.h"
+
+namespace vkb
+{
+namespace
+{
+/// Texels of the first level reduced by a workgroup on each side
+constexpr uint32_t TILE_SIZE = 64;
+
+/// Same layout as Parameters in mipmap_generation.comp
+struct Parameters
+{
+	glm::uvec2 source_extent;
+
+	uint32_t level_count;
+
+	uint32_t workgroup_count;
+
+	uint32_t srgb;
+};
+
+bool has_storage_support(Device &device, VkFormat format)
+{
+	return device.get_gpu().get_format_properties(format).optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+}
+}        // namespace
+
+bool MipGenerator::is_supported(Device &device, VkFormat format, Reduction reduction)
+{
+	if (reduction == Reduction::Min)
+	{
+		return format == VK_FORMAT_R32_SFLOAT && has_storage_support(device, format);
+	}
+
+	switch (format)
+	{
+		case VK_FORMAT_R8G8B8A8_UNORM:
+			return true;
+		case VK_FORMAT_R8G8B8A8_SRGB:
+			// The levels are written through UNORM views, which the sRGB format may need the extended usage for
+			return has_storage_support(device, format) || device.is_enabled(VK_KHR_MAINTENANCE_2_EXTENSION_NAME);
+		default:
+			return false;
+	}
+}
+
+VkImageUsageFlags MipGenerator::get_image_usage()
+{
+	return VK_IMAGE_USAGE_STORAGE_BIT;
+}
+
+VkImageCreateFlags MipGenerator::get_image_flags(Device &device, VkFormat format)
+{
+	if (format != VK_FORMAT_R8G8B8A8_SRGB)
+	{
+		return 0;
+	}
+
+	VkImageCreateFlags flags = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+	if (!has_storage_support(device, format))
+	{
+		flags |= VK_IMAGE_CREATE_EXTENDED_USAGE_BIT_KHR;
+	}
+
+	return flags;
+}
+
+MipGenerator::MipGenerator(Device &device, Reduction reduction) :
+    device{device},
+    shader{"mipmap_generation.comp"}
+{
+	if (reduction == Reduction::Min)
+	{
+		shader_variant.add_define("MIN_REDUCTION");
+	}
+
+	device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, shader, shader_variant);
+
+	counter_buffer = std::make_unique<core::Buffer>(device, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	counter_buffer->set_debug_name("MipGenerator: counter buffer");
+	counter_buffer->convert_and_update(0U);
+}
+
+void MipGenerator::generate(CommandBuffer &command_buffer, const core::ImageView &image_view, VkPipelineStageFlags stage_mask)
+{
+	// The views of the levels must be on the image itself
+	auto &image = const_cast<core::Image &>(image_view.get_image());
+
+	uint32_t level_count = image_view.get_subresource_range().levelCount;
+	if (level_count <= 1)
+	{
+		return;
+	}
+
+	bool srgb = image.get_format() == VK_FORMAT_R8G8B8A8_SRGB;
+
+	ScopedDebugLabel debug_label{command_buffer, "Mipmap generation"};
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = stage_mask;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(image_view, memory_barrier);
+	}
+
+	// The last dispatch recorded with the counter may not have reset it yet
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+		command_buffer.buffer_memory_barrier(*counter_buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+	}
+
+	auto &resource_cache  = device.get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, shader, shader_variant);
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	auto    &extent       = image.get_extent();
+	uint32_t base_level   = image_view.get_subresource_range().baseMipLevel;
+	uint32_t source_level = 0;
+
+	while (source_level + 1 < level_count)
+	{
+		VkExtent2D source_extent{std::max(extent.width >> (base_level + source_level), 1U), std::max(extent.height >> (base_level + source_level), 1U)};
+
+		uint32_t workgroup_columns = (source_extent.width + TILE_SIZE - 1) / TILE_SIZE;
+		uint32_t workgroup_rows    = (source_extent.height + TILE_SIZE - 1) / TILE_SIZE;
+
+		uint32_t dispatch_levels = std::min(level_count - 1 - source_level, MAX_DISPATCH_LEVELS);
+
+		// The last workgroup reduces the 6th level as a single tile
+		if (workgroup_columns > TILE_SIZE || workgroup_rows > TILE_SIZE)
+		{
+			dispatch_levels = std::min(dispatch_levels, MAX_DISPATCH_LEVELS / 2);
+		}
+
+		command_buffer.bind_image(request_level_view(image, base_level + source_level), 0, 0, 0);
+
+		// The array elements past the generated levels are not accessed, but must be valid
+		for (uint32_t i = 0; i < MAX_DISPATCH_LEVELS; ++i)
+		{
+			auto level = source_level + 1 + std::min(i, dispatch_levels - 1);
+			command_buffer.bind_image(request_level_view(image, base_level + level), 0, 1, i);
+		}
+
+		command_buffer.bind_buffer(*counter_buffer, 0, counter_buffer->get_size(), 0, 2, 0);
+
+		Parameters parameters{};
+		parameters.source_extent   = {source_extent.width, source_extent.height};
+		parameters.level_count     = dispatch_levels;
+		parameters.workgroup_count = workgroup_columns * workgroup_rows;
+		parameters.srgb            = srgb ? 1 : 0;
+		command_buffer.push_constants(parameters);
+
+		command_buffer.dispatch(parameters.workgroup_count, 1, 1);
+
+		source_level += dispatch_levels;
+
+		// The next dispatch reads the last level of this one
+		if (source_level + 1 < level_count)
+		{
+			ImageMemoryBarrier memory_barrier{};
+			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_GENERAL;
+			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_GENERAL;
+			memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+			command_buffer.image_memory_barrier(image_view, memory_barrier);
+
+			BufferMemoryBarrier counter_barrier{};
+			counter_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			counter_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			counter_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+			counter_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+			command_buffer.buffer_memory_barrier(*counter_buffer, 0, VK_WHOLE_SIZE, counter_barrier);
+		}
+	}
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = stage_mask;
+
+		command_buffer.image_memory_barrier(image_view, memory_barrier);
+	}
+}
+
+core::ImageView &MipGenerator::request_level_view(core::Image &image, uint32_t level)
+{
+	// sRGB levels are written through UNORM views
+	VkFormat format = image.get_format() == VK_FORMAT_R8G8B8A8_SRGB ? VK_FORMAT_R8G8B8A8_UNORM : image.get_format();
+
+	return device.get_resource_cache().request_image_view(image, VK_IMAGE_VIEW_TYPE_2D, format, level, 0, 1, 1);
+}
+}        // namespace vkb
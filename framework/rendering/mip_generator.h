@@ -0,0 +1,111 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/image_view.h"
+#include "core/shader_module.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+
+/**
+ * @brief Generates the mip chains of images on the GPU, with up to MAX_DISPATCH_LEVELS levels per compute dispatch
+ *
+ * Each workgroup of mipmap_generation.comp reduces a 64x64 tile of the first level to the next 6 levels through shared
+ * memory, and the last workgroup to complete reduces the 6th level to the next 6. Unlike a chain of blits, there is no
+ * barrier between the levels. Texels are box filtered, in linear space for sRGB images, or reduced to their minimum
+ * for depth pyramids, see HiZPyramid.
+ *
+ * The images must have been created with get_image_usage() and get_image_flags(), see sg::Image::create_vk_image().
+ * The views of the levels are requested from the resource cache, so they live as long as their image and are reused by
+ * later generations. It is not thread safe.
+ */
+class MipGenerator
+{
+  public:
+	/// Levels generated by a dispatch at most
+	static constexpr uint32_t MAX_DISPATCH_LEVELS = 12;
+
+	/// How the 2x2 texels of a level are reduced to a texel of the next one
+	enum class Reduction
+	{
+		/// Box filter of RGBA8 images
+		Average,
+
+		/// Minimum of R32_SFLOAT images, the farthest depth in the reversed depth range
+		Min
+	};
+
+	/**
+	 * @return Whether the images of a format can have their mip chain generated on a device, with a reduction
+	 */
+	static bool is_supported(Device &device, VkFormat format, Reduction reduction = Reduction::Average);
+
+	/**
+	 * @return The usage images need to have their mip chain generated
+	 */
+	static VkImageUsageFlags get_image_usage();
+
+	/**
+	 * @return The create flags images of a format need to have their mip chain generated
+	 */
+	static VkImageCreateFlags get_image_flags(Device &device, VkFormat format);
+
+	explicit MipGenerator(Device &device, Reduction reduction = Reduction::Average);
+
+	MipGenerator(const MipGenerator &) = delete;
+
+	MipGenerator(MipGenerator &&) = delete;
+
+	~MipGenerator() = default;
+
+	MipGenerator &operator=(const MipGenerator &) = delete;
+
+	MipGenerator &operator=(MipGenerator &&) = delete;
+
+	/**
+	 * @brief Records the generation of the levels of an image from its first one
+	 * @param command_buffer A command buffer of a queue family supporting compute
+	 * @param image_view A view on all the levels of a 2D image, whose first level was uploaded and which is in the
+	 *                   shader read only layout, as left by an upload for fragment shaders. It is left so.
+	 * @param stage_mask Stages reading the image, before and after the generation
+	 */
+	void generate(CommandBuffer &command_buffer, const core::ImageView &image_view, VkPipelineStageFlags stage_mask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+  private:
+	/**
+	 * @brief Returns the storage view on a level of an image, shared through the resource cache and owned by the image
+	 */
+	core::ImageView &request_level_view(core::Image &image, uint32_t level);
+
+	Device &device;
+
+	ShaderSource shader;
+
+	ShaderVariant shader_variant;
+
+	/// Counts the completed workgroups of a dispatch, reset to 0 by the last one
+	std::unique_ptr<core::Buffer> counter_buffer;
+};
+}        // namespace vkb
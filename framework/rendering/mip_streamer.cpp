@@ -0,0 +1,482 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/mip_streamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "common/logging.h"
+#include "common/utils.h"
+#include "core/device.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "scene_graph/components/aabb.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/components/texture.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+#include "scene_graph/scene_snapshot.h"
+
+namespace vkb
+{
+namespace
+{
+/// Distance under which the camera is considered inside of a mesh, which then needs the finest level
+constexpr float MIN_MESH_DISTANCE = 0.01f;
+}        // namespace
+
+MipStreamer::MipStreamer(Device &device, UploadManager &upload_manager, VkDeviceSize memory_budget, uint32_t frame_count) :
+    device{device},
+    upload_manager{upload_manager},
+    memory_budget{memory_budget},
+    frame_count{frame_count}
+{
+}
+
+MipStreamer::~MipStreamer()
+{
+	// The upload manager references the pending images until they are acquired, and the frames in flight the retired ones
+	upload_manager.finish();
+	device.wait_idle();
+}
+
+VkDeviceSize MipStreamer::get_chain_size(const StreamedImage &image, uint32_t base_level)
+{
+	VkDeviceSize size = 0;
+	for (uint32_t level = base_level; level < image.level_sizes.size(); ++level)
+	{
+		size += image.level_sizes[level];
+	}
+
+	return size;
+}
+
+void MipStreamer::add(sg::Scene &scene_)
+{
+	scene = &scene_;
+
+	for (auto image : scene->get_components<sg::Image>())
+	{
+		if (image->get_data().empty())
+		{
+			throw std::runtime_error("MipStreamer: " + image->get_name() + " has no texel data, see GLTFLoader::set_streamed_textures()");
+		}
+
+		auto &extent = image->get_extent();
+		auto  format = image->get_format();
+
+		// Without mipmaps there is nothing to stream
+		if (image->get_mipmaps().size() == 1 && std::max(extent.width, extent.height) > INITIAL_EXTENT && sg::can_generate_mipmaps(format))
+		{
+			image->generate_mipmaps();
+		}
+
+		auto &mipmaps = image->get_mipmaps();
+
+		StreamedImage streamed_image{};
+		streamed_image.image = image;
+
+		// The levels are stored in order of size in the texel data, either smallest or largest first
+		for (auto &mipmap : mipmaps)
+		{
+			VkDeviceSize end = image->get_data().size();
+			for (auto &other_mipmap : mipmaps)
+			{
+				if (other_mipmap.offset > mipmap.offset)
+				{
+					end = std::min<VkDeviceSize>(end, other_mipmap.offset);
+				}
+			}
+			streamed_image.level_sizes.push_back(end - mipmap.offset);
+		}
+
+		// Arrays and cube maps are resident entirely
+		uint32_t base_level = to_u32(mipmaps.size()) - 1;
+		if (image->get_layers() > 1)
+		{
+			base_level = 0;
+		}
+		else
+		{
+			while (base_level > 0 && std::max(mipmaps[base_level - 1].extent.width, mipmaps[base_level - 1].extent.height) <= INITIAL_EXTENT)
+			{
+				--base_level;
+			}
+		}
+
+		streamed_image.base_level   = to_u32(mipmaps.size());
+		streamed_image.target_level = streamed_image.base_level;
+		streamed_image.needed_level = base_level;
+
+		images.push_back(std::move(streamed_image));
+
+		request_levels(images.back(), base_level);
+	}
+
+	upload_manager.finish();
+
+	for (auto &image : images)
+	{
+		image.image->swap_vk_image(image.pending_image, image.pending_image_view);
+		image.base_level = image.target_level;
+	}
+
+	LOGI("MipStreamer: {} images, {:.1f} MiB resident", images.size(), get_resident_size() / (1024.0f * 1024.0f));
+}
+
+void MipStreamer::request_levels(StreamedImage &image, uint32_t base_level)
+{
+	assert(!image.pending_image && "The image is already pending");
+
+	auto &scene_image = *image.image;
+	auto &mipmaps     = scene_image.get_mipmaps();
+	auto  level_count = to_u32(mipmaps.size()) - base_level;
+
+	{
+		allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::SceneTexture};
+
+		image.pending_image = std::make_unique<core::Image>(device,
+		                                                    mipmaps[base_level].extent,
+		                                                    scene_image.get_format(),
+		                                                    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+		                                                    VMA_MEMORY_USAGE_GPU_ONLY,
+		                                                    VK_SAMPLE_COUNT_1_BIT,
+		                                                    level_count,
+		                                                    scene_image.get_layers());
+	}
+	image.pending_image->set_debug_name(fmt::format("{} from level {}", scene_image.get_name(), base_level));
+
+	image.pending_image_view = std::make_unique<core::ImageView>(*image.pending_image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_UNDEFINED, 0, 0, 0, 0, scene_image.get_components());
+	image.pending_image_view->set_debug_name("View on " + image.pending_image->get_debug_name());
+
+	// The levels from the base one are contiguous in the texel data
+	VkDeviceSize begin = std::numeric_limits<VkDeviceSize>::max();
+	VkDeviceSize end   = 0;
+	for (uint32_t level = base_level; level < mipmaps.size(); ++level)
+	{
+		begin = std::min<VkDeviceSize>(begin, mipmaps[level].offset);
+		end   = std::max<VkDeviceSize>(end, mipmaps[level].offset + image.level_sizes[level]);
+	}
+
+	std::vector<VkBufferImageCopy> copy_regions;
+	for (uint32_t level = base_level; level < mipmaps.size(); ++level)
+	{
+		VkBufferImageCopy copy_region{};
+		copy_region.bufferOffset              = mipmaps[level].offset - begin;
+		copy_region.imageSubresource          = image.pending_image_view->get_subresource_layers();
+		copy_region.imageSubresource.mipLevel = level - base_level;
+		copy_region.imageExtent               = mipmaps[level].extent;
+		copy_regions.push_back(copy_region);
+	}
+
+	upload_manager.upload_image(*image.pending_image_view,
+	                            scene_image.get_data().data() + begin,
+	                            end - begin,
+	                            copy_regions,
+	                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                            VK_ACCESS_SHADER_READ_BIT);
+
+	committed_size = committed_size + get_chain_size(image, base_level) - get_chain_size(image, image.target_level);
+
+	image.target_level = base_level;
+}
+
+void MipStreamer::estimate_needed_levels(sg::Camera &camera, uint32_t viewport_height, const sg::SceneSnapshot *snapshot)
+{
+	std::unordered_map<const sg::Image *, StreamedImage *> image_lookup;
+	for (auto &image : images)
+	{
+		image.screen_size = 0.0f;
+		image_lookup[image.image] = &image;
+	}
+
+	glm::mat4 view             = sg::get_view(snapshot, camera);
+	float     projection_scale = std::abs(sg::get_projection(snapshot, camera)[1][1]) * viewport_height * 0.5f;
+
+	for (auto mesh : scene->get_components<sg::Mesh>())
+	{
+		float screen_size = 0.0f;
+
+		for (auto node : mesh->get_nodes())
+		{
+			sg::AABB bounds = mesh->get_bounds();
+			bounds.transform(sg::get_node_state(snapshot, *node).world_matrix);
+
+			float radius = glm::length(bounds.get_max() - bounds.get_min()) * 0.5f;
+			float depth  = -(view * glm::vec4(bounds.get_center(), 1.0f)).z;
+
+			if (depth + radius <= 0.0f)
+			{
+				// Behind the camera
+				continue;
+			}
+
+			float distance = depth - radius;
+			if (distance < MIN_MESH_DISTANCE)
+			{
+				screen_size = std::numeric_limits<float>::max();
+				break;
+			}
+
+			screen_size = std::max(screen_size, 2.0f * radius * projection_scale / distance);
+		}
+
+		if (screen_size == 0.0f)
+		{
+			continue;
+		}
+
+		for (auto sub_mesh : mesh->get_submeshes())
+		{
+			auto material = sub_mesh->get_material();
+			if (!material)
+			{
+				continue;
+			}
+
+			for (auto &texture : material->textures)
+			{
+				auto image = image_lookup.find(texture.second->get_image());
+				if (image != image_lookup.end())
+				{
+					image->second->screen_size = std::max(image->second->screen_size, screen_size);
+				}
+			}
+		}
+	}
+
+	for (auto &image : images)
+	{
+		auto level_count = to_u32(image.level_sizes.size());
+
+		if (image.image->get_layers() > 1)
+		{
+			image.needed_level = 0;
+			continue;
+		}
+
+		if (image.screen_size == 0.0f)
+		{
+			image.needed_level = level_count - 1;
+			continue;
+		}
+
+		// The texture is assumed to map once onto the mesh, with one texel per pixel
+		auto &extent = image.image->get_extent();
+		float level  = std::floor(std::log2(std::max(extent.width, extent.height) / image.screen_size));
+
+		image.needed_level = static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(level_count - 1)));
+	}
+}
+
+VkDeviceSize MipStreamer::get_available_budget() const
+{
+	const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+	vmaGetMemoryProperties(allocated::get_memory_allocator(), &memory_properties);
+
+	std::vector<VmaBudget> budgets(memory_properties->memoryHeapCount);
+	vmaGetHeapBudgets(allocated::get_memory_allocator(), budgets.data());
+
+	VkDeviceSize excess_usage = 0;
+	for (uint32_t heap_index = 0; heap_index < memory_properties->memoryHeapCount; ++heap_index)
+	{
+		if (!(memory_properties->memoryHeaps[heap_index].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+		{
+			continue;
+		}
+
+		auto usage_limit = static_cast<VkDeviceSize>(budgets[heap_index].budget * HEAP_BUDGET_USAGE);
+		if (budgets[heap_index].usage > usage_limit)
+		{
+			excess_usage += budgets[heap_index].usage - usage_limit;
+		}
+	}
+
+	if (excess_usage == 0)
+	{
+		return memory_budget;
+	}
+
+	return std::min(memory_budget, committed_size > excess_usage ? committed_size - excess_usage : 0);
+}
+
+void MipStreamer::update(CommandBuffer &command_buffer, sg::Camera &camera, uint32_t viewport_height, const sg::SceneSnapshot *snapshot)
+{
+	assert(scene && "The textures of a scene must be added first");
+
+	++update_count;
+
+	while (!retired_images.empty() && retired_images.front().retire_update + frame_count <= update_count)
+	{
+		retired_images.pop_front();
+	}
+
+	// Swaps in the images whose copies completed
+	std::vector<StreamedImage *> completed_images;
+	uint32_t                     pending_count = 0;
+	for (auto &image : images)
+	{
+		if (image.pending_image)
+		{
+			if (upload_manager.is_complete(image.token))
+			{
+				completed_images.push_back(&image);
+			}
+			else
+			{
+				++pending_count;
+			}
+		}
+	}
+
+	if (!completed_images.empty())
+	{
+		upload_manager.acquire(command_buffer);
+
+		for (auto image : completed_images)
+		{
+			image->image->swap_vk_image(image->pending_image, image->pending_image_view);
+			image->base_level = image->target_level;
+
+			retired_images.push_back({std::move(image->pending_image), std::move(image->pending_image_view), update_count});
+		}
+	}
+
+	estimate_needed_levels(camera, viewport_height, snapshot);
+
+	auto budget = get_available_budget();
+
+	std::vector<StreamedImage *> requested_images;
+
+	auto request = [&](StreamedImage &image, uint32_t base_level) {
+		request_levels(image, base_level);
+		requested_images.push_back(&image);
+		++pending_count;
+	};
+
+	// The images with the most levels they do not need, then the smallest on screen, are downgraded first
+	auto downgrade = [&]() {
+		StreamedImage *downgraded_image = nullptr;
+		for (auto &image : images)
+		{
+			if (image.pending_image || image.target_level + 1 >= image.level_sizes.size() || image.image->get_layers() > 1)
+			{
+				continue;
+			}
+
+			if (!downgraded_image)
+			{
+				downgraded_image = &image;
+				continue;
+			}
+
+			int excess_levels            = static_cast<int>(image.needed_level) - static_cast<int>(image.target_level);
+			int downgraded_excess_levels = static_cast<int>(downgraded_image->needed_level) - static_cast<int>(downgraded_image->target_level);
+			if (excess_levels > downgraded_excess_levels || (excess_levels == downgraded_excess_levels && image.screen_size < downgraded_image->screen_size))
+			{
+				downgraded_image = &image;
+			}
+		}
+
+		if (!downgraded_image)
+		{
+			return false;
+		}
+
+		request(*downgraded_image, std::max(downgraded_image->needed_level, downgraded_image->target_level + 1));
+		return true;
+	};
+
+	// The memory pressure comes first, the budget may have dropped below the resident images
+	while (committed_size > budget && pending_count < MAX_PENDING_UPLOADS && downgrade())
+	{
+	}
+
+	// Then the images needing more detail, the largest on screen first
+	std::vector<StreamedImage *> upgraded_images;
+	for (auto &image : images)
+	{
+		if (!image.pending_image && image.needed_level < image.target_level)
+		{
+			upgraded_images.push_back(&image);
+		}
+	}
+
+	std::sort(upgraded_images.begin(), upgraded_images.end(), [](const StreamedImage *a, const StreamedImage *b) { return a->screen_size > b->screen_size; });
+
+	for (auto image : upgraded_images)
+	{
+		if (pending_count >= MAX_PENDING_UPLOADS)
+		{
+			break;
+		}
+
+		// Downgraded to make room for a previous image
+		if (image->pending_image)
+		{
+			continue;
+		}
+
+		// Makes room from the images with levels they do not need
+		auto cost = get_chain_size(*image, image->needed_level) - get_chain_size(*image, image->target_level);
+		while (committed_size + cost > budget && pending_count + 1 < MAX_PENDING_UPLOADS &&
+		       std::any_of(images.begin(), images.end(), [](const StreamedImage &other) { return !other.pending_image && other.needed_level > other.target_level; }) &&
+		       downgrade())
+		{
+		}
+
+		// The finest level which fits, if any
+		for (uint32_t level = image->needed_level; level < image->target_level; ++level)
+		{
+			if (committed_size + get_chain_size(*image, level) - get_chain_size(*image, image->target_level) <= budget)
+			{
+				request(*image, level);
+				break;
+			}
+		}
+	}
+
+	if (!requested_images.empty())
+	{
+		auto token = upload_manager.flush();
+		for (auto image : requested_images)
+		{
+			image->token = token;
+		}
+	}
+}
+
+VkDeviceSize MipStreamer::get_resident_size() const
+{
+	VkDeviceSize size = 0;
+	for (auto &image : images)
+	{
+		size += get_chain_size(image, image.base_level);
+	}
+
+	return size;
+}
+}        // namespace vkb
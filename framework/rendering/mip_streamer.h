@@ -0,0 +1,186 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "upload_manager.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+
+namespace core
+{
+class Image;
+class ImageView;
+}        // namespace core
+
+namespace sg
+{
+class Camera;
+class Image;
+class Scene;
+class SceneSnapshot;
+}        // namespace sg
+
+/**
+ * @brief Streams the mip levels of the scene textures within a memory budget, without sparse residency
+ *
+ * add() creates the images of a scene with their smallest levels only, up to INITIAL_EXTENT texels, from the texel
+ * data the images keep on the CPU, see GLTFLoader::set_streamed_textures().
+ *
+ * Each frame, update() estimates the level each image needs from the screen size of the meshes sampling it. Images
+ * needing finer levels are recreated with the longer mip chain, uploaded asynchronously by the UploadManager, and
+ * replace the previous images once the copies completed. Since a non-sparse image cannot grow, a smaller image rather
+ * than a LOD clamp keeps the memory of the levels which are not resident.
+ *
+ * The images stay within the budget of the streamer, and within the heap budgets reported by VMA, which follow
+ * VK_EXT_memory_budget if the device enabled it. When either is exceeded, the images needing the least detail are
+ * downgraded first.
+ */
+class MipStreamer
+{
+  public:
+	/// Largest extent of the levels add() uploads
+	static constexpr uint32_t INITIAL_EXTENT = 64;
+
+	/// Images being recreated at the same time at most
+	static constexpr uint32_t MAX_PENDING_UPLOADS = 4;
+
+	/// Fraction of the heap budgets the device memory usage stays under
+	static constexpr float HEAP_BUDGET_USAGE = 0.9f;
+
+	/**
+	 * @param upload_manager The manager uploading the levels, it must outlive the streamer
+	 * @param memory_budget The device memory of the streamed images
+	 * @param frame_count The number of frames in flight, which may sample replaced images
+	 */
+	MipStreamer(Device &device, UploadManager &upload_manager, VkDeviceSize memory_budget, uint32_t frame_count);
+
+	MipStreamer(const MipStreamer &) = delete;
+
+	MipStreamer(MipStreamer &&) = delete;
+
+	~MipStreamer();
+
+	MipStreamer &operator=(const MipStreamer &) = delete;
+
+	MipStreamer &operator=(MipStreamer &&) = delete;
+
+	/**
+	 * @brief Creates the Vulkan images of a scene loaded with streamed textures, with their smallest levels
+	 * @param scene The scene, its images must not have a Vulkan image yet and must outlive the streamer
+	 */
+	void add(sg::Scene &scene);
+
+	/**
+	 * @brief Swaps in the images whose upload completed, and requests the levels the camera view needs
+	 * @param command_buffer A command buffer of the graphics queue, outside of a render pass and before the sampling
+	 * @param camera The camera the scene is rendered with
+	 * @param viewport_height The height of the viewport in pixels
+	 * @param snapshot The scene snapshot the frame is recorded from, nullptr to read the live scene
+	 */
+	void update(CommandBuffer &command_buffer, sg::Camera &camera, uint32_t viewport_height, const sg::SceneSnapshot *snapshot = nullptr);
+
+	/**
+	 * @return The device memory of the resident levels
+	 */
+	VkDeviceSize get_resident_size() const;
+
+  private:
+	struct StreamedImage
+	{
+		sg::Image *image;
+
+		/// Per level, its size in the texel data
+		std::vector<VkDeviceSize> level_sizes;
+
+		/// The finest resident level
+		uint32_t base_level;
+
+		/// The finest level of the pending image, or base_level
+		uint32_t target_level;
+
+		/// The finest level the last update() estimated the image needs
+		uint32_t needed_level;
+
+		/// The screen size in pixels of the largest mesh sampling the image
+		float screen_size{0.0f};
+
+		UploadManager::Token token{0};
+
+		std::shared_ptr<core::Image> pending_image;
+
+		std::shared_ptr<core::ImageView> pending_image_view;
+	};
+
+	struct RetiredImage
+	{
+		std::shared_ptr<core::Image> image;
+
+		std::shared_ptr<core::ImageView> image_view;
+
+		uint64_t retire_update;
+	};
+
+	/**
+	 * @return The size of the levels from a base level
+	 */
+	static VkDeviceSize get_chain_size(const StreamedImage &image, uint32_t base_level);
+
+	/**
+	 * @brief Creates the image with the levels from a base level and adds their upload to the current batch
+	 */
+	void request_levels(StreamedImage &image, uint32_t base_level);
+
+	/**
+	 * @brief Estimates the level each image needs from the meshes in view
+	 */
+	void estimate_needed_levels(sg::Camera &camera, uint32_t viewport_height, const sg::SceneSnapshot *snapshot);
+
+	/**
+	 * @return The budget of the images, lowered by the device memory usage over the heap budgets
+	 */
+	VkDeviceSize get_available_budget() const;
+
+	Device &device;
+
+	UploadManager &upload_manager;
+
+	VkDeviceSize memory_budget;
+
+	uint32_t frame_count;
+
+	uint64_t update_count{0};
+
+	sg::Scene *scene{nullptr};
+
+	std::vector<StreamedImage> images;
+
+	/// Size of the chains of the images, from their target level
+	VkDeviceSize committed_size{0};
+
+	/// Replaced images the frames in flight may still sample
+	std::deque<RetiredImage> retired_images;
+};
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,8 @@
 
 #include "pipeline_state.h"
 
+#include "common/resource_caching.h"
+
 bool operator==(const VkVertexInputAttributeDescription &lhs, const VkVertexInputAttributeDescription &rhs)
 {
 	return std::tie(lhs.binding, lhs.format, lhs.location, lhs.offset) == std::tie(rhs.binding, rhs.format, rhs.location, rhs.offset);
@@ -82,8 +84,163 @@ bool operator!=(const vkb::ColorBlendState &lhs, const vkb::ColorBlendState &rhs
 	                   });
 }
 
+bool operator!=(const vkb::RenderingState &lhs, const vkb::RenderingState &rhs)
+{
+	return std::tie(lhs.depth_attachment_format, lhs.stencil_attachment_format, lhs.depth_stencil_input_index) !=
+	           std::tie(rhs.depth_attachment_format, rhs.stencil_attachment_format, rhs.depth_stencil_input_index) ||
+	       lhs.color_attachment_formats != rhs.color_attachment_formats ||
+	       lhs.color_attachment_locations != rhs.color_attachment_locations ||
+	       lhs.color_attachment_input_indices != rhs.color_attachment_input_indices;
+}
+
 namespace vkb
 {
+namespace
+{
+size_t hash_sub_state(const PipelineLayout &pipeline_layout)
+{
+	size_t result = 0;
+
+	hash_combine(result, pipeline_layout.get_handle());
+
+	for (auto shader_module : pipeline_layout.get_shader_modules())
+	{
+		hash_combine(result, shader_module->get_id());
+	}
+
+	return result;
+}
+
+size_t hash_sub_state(const VertexInputState &vertex_input_state)
+{
+	size_t result = 0;
+
+	// The descriptions are plain data without padding, so the arrays are hashed in one pass each
+	hash_combine_bytes(result, vertex_input_state.attributes.data(), vertex_input_state.attributes.size());
+	hash_combine_bytes(result, vertex_input_state.bindings.data(), vertex_input_state.bindings.size());
+
+	return result;
+}
+
+size_t hash_sub_state(const InputAssemblyState &input_assembly_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, input_assembly_state.primitive_restart_enable);
+	hash_combine(result, static_cast<std::underlying_type<VkPrimitiveTopology>::type>(input_assembly_state.topology));
+
+	return result;
+}
+
+size_t hash_sub_state(const ViewportState &viewport_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, viewport_state.viewport_count);
+	hash_combine(result, viewport_state.scissor_count);
+
+	return result;
+}
+
+size_t hash_sub_state(const RasterizationState &rasterization_state, DynamicPipelineStateFlags dynamic_state_flags)
+{
+	size_t result = 0;
+
+	if (!(dynamic_state_flags & DYNAMIC_PIPELINE_STATE_RASTERIZATION_BIT))
+	{
+		hash_combine(result, rasterization_state.cull_mode);
+		hash_combine(result, static_cast<std::underlying_type<VkFrontFace>::type>(rasterization_state.front_face));
+	}
+
+	hash_combine(result, rasterization_state.depth_bias_enable);
+	hash_combine(result, rasterization_state.depth_clamp_enable);
+	hash_combine(result, static_cast<std::underlying_type<VkPolygonMode>::type>(rasterization_state.polygon_mode));
+	hash_combine(result, rasterization_state.rasterizer_discard_enable);
+
+	return result;
+}
+
+size_t hash_sub_state(const MultisampleState &multisample_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, multisample_state.alpha_to_coverage_enable);
+	hash_combine(result, multisample_state.alpha_to_one_enable);
+	hash_combine(result, multisample_state.min_sample_shading);
+	hash_combine(result, static_cast<std::underlying_type<VkSampleCountFlagBits>::type>(multisample_state.rasterization_samples));
+	hash_combine(result, multisample_state.sample_shading_enable);
+	hash_combine(result, multisample_state.sample_mask);
+
+	return result;
+}
+
+size_t hash_sub_state(const DepthStencilState &depth_stencil_state, DynamicPipelineStateFlags dynamic_state_flags)
+{
+	size_t result = 0;
+
+	if (dynamic_state_flags & DYNAMIC_PIPELINE_STATE_DEPTH_STENCIL_BIT)
+	{
+		return result;
+	}
+
+	hash_combine(result, depth_stencil_state.back);
+	hash_combine(result, depth_stencil_state.depth_bounds_test_enable);
+	hash_combine(result, static_cast<std::underlying_type<VkCompareOp>::type>(depth_stencil_state.depth_compare_op));
+	hash_combine(result, depth_stencil_state.depth_test_enable);
+	hash_combine(result, depth_stencil_state.depth_write_enable);
+	hash_combine(result, depth_stencil_state.front);
+	hash_combine(result, depth_stencil_state.stencil_test_enable);
+
+	return result;
+}
+
+size_t hash_sub_state(const ColorBlendState &color_blend_state, DynamicPipelineStateFlags dynamic_state_flags)
+{
+	size_t result = 0;
+
+	hash_combine(result, static_cast<std::underlying_type<VkLogicOp>::type>(color_blend_state.logic_op));
+	hash_combine(result, color_blend_state.logic_op_enable);
+
+	if (dynamic_state_flags & DYNAMIC_PIPELINE_STATE_COLOR_BLEND_BIT)
+	{
+		// Only the number of attachments is baked into the pipeline
+		hash_combine(result, color_blend_state.attachments.size());
+		return result;
+	}
+
+	hash_combine_bytes(result, color_blend_state.attachments.data(), color_blend_state.attachments.size());
+
+	return result;
+}
+
+size_t hash_sub_state(const RenderingState &rendering_state)
+{
+	size_t result = 0;
+
+	for (auto format : rendering_state.color_attachment_formats)
+	{
+		hash_combine(result, static_cast<std::underlying_type<VkFormat>::type>(format));
+	}
+
+	hash_combine(result, static_cast<std::underlying_type<VkFormat>::type>(rendering_state.depth_attachment_format));
+	hash_combine(result, static_cast<std::underlying_type<VkFormat>::type>(rendering_state.stencil_attachment_format));
+
+	for (auto location : rendering_state.color_attachment_locations)
+	{
+		hash_combine(result, location);
+	}
+
+	for (auto input_index : rendering_state.color_attachment_input_indices)
+	{
+		hash_combine(result, input_index);
+	}
+
+	hash_combine(result, rendering_state.depth_stencil_input_index);
+
+	return result;
+}
+}        // namespace
+
 void SpecializationConstantState::reset()
 {
 	if (dirty)
@@ -128,6 +285,11 @@ const std::map<uint32_t, std::vector<uint8_t>> &SpecializationConstantState::get
 	return specialization_constant_state;
 }
 
+PipelineState::PipelineState()
+{
+	update_hashes();
+}
+
 void PipelineState::reset()
 {
 	clear_dirty();
@@ -151,6 +313,23 @@ void PipelineState::reset()
 	color_blend_state = {};
 
 	subpass_index = {0U};
+
+	rendering_state = {};
+
+	update_hashes();
+}
+
+void PipelineState::update_hashes()
+{
+	pipeline_layout_hash = pipeline_layout ? hash_sub_state(*pipeline_layout) : 0;
+	vertex_input_hash    = hash_sub_state(vertex_input_state);
+	input_assembly_hash  = hash_sub_state(input_assembly_state);
+	rasterization_hash   = hash_sub_state(rasterization_state, dynamic_state_flags);
+	viewport_hash        = hash_sub_state(viewport_state);
+	multisample_hash     = hash_sub_state(multisample_state);
+	depth_stencil_hash   = hash_sub_state(depth_stencil_state, dynamic_state_flags);
+	color_blend_hash     = hash_sub_state(color_blend_state, dynamic_state_flags);
+	rendering_hash       = hash_sub_state(rendering_state);
 }
 
 void PipelineState::set_pipeline_layout(PipelineLayout &new_pipeline_layout)
@@ -159,14 +338,16 @@ void PipelineState::set_pipeline_layout(PipelineLayout &new_pipeline_layout)
 	{
 		if (pipeline_layout->get_handle() != new_pipeline_layout.get_handle())
 		{
-			pipeline_layout = &new_pipeline_layout;
+			pipeline_layout      = &new_pipeline_layout;
+			pipeline_layout_hash = hash_sub_state(new_pipeline_layout);
 
 			dirty = true;
 		}
 	}
 	else
 	{
-		pipeline_layout = &new_pipeline_layout;
+		pipeline_layout      = &new_pipeline_layout;
+		pipeline_layout_hash = hash_sub_state(new_pipeline_layout);
 
 		dirty = true;
 	}
@@ -206,6 +387,7 @@ void PipelineState::set_vertex_input_state(const VertexInputState &new_vertex_in
 	if (vertex_input_state != new_vertex_input_state)
 	{
 		vertex_input_state = new_vertex_input_state;
+		vertex_input_hash  = hash_sub_state(vertex_input_state);
 
 		dirty = true;
 	}
@@ -216,6 +398,7 @@ void PipelineState::set_input_assembly_state(const InputAssemblyState &new_input
 	if (input_assembly_state != new_input_assembly_state)
 	{
 		input_assembly_state = new_input_assembly_state;
+		input_assembly_hash  = hash_sub_state(input_assembly_state);
 
 		dirty = true;
 	}
@@ -226,6 +409,7 @@ void PipelineState::set_rasterization_state(const RasterizationState &new_raster
 	if (rasterization_state != new_rasterization_state)
 	{
 		rasterization_state = new_rasterization_state;
+		rasterization_hash  = hash_sub_state(rasterization_state, dynamic_state_flags);
 
 		dirty = true;
 	}
@@ -236,6 +420,7 @@ void PipelineState::set_viewport_state(const ViewportState &new_viewport_state)
 	if (viewport_state != new_viewport_state)
 	{
 		viewport_state = new_viewport_state;
+		viewport_hash  = hash_sub_state(viewport_state);
 
 		dirty = true;
 	}
@@ -246,6 +431,7 @@ void PipelineState::set_multisample_state(const MultisampleState &new_multisampl
 	if (multisample_state != new_multisample_state)
 	{
 		multisample_state = new_multisample_state;
+		multisample_hash  = hash_sub_state(multisample_state);
 
 		dirty = true;
 	}
@@ -256,6 +442,7 @@ void PipelineState::set_depth_stencil_state(const DepthStencilState &new_depth_s
 	if (depth_stencil_state != new_depth_stencil_state)
 	{
 		depth_stencil_state = new_depth_stencil_state;
+		depth_stencil_hash  = hash_sub_state(depth_stencil_state, dynamic_state_flags);
 
 		dirty = true;
 	}
@@ -266,6 +453,7 @@ void PipelineState::set_color_blend_state(const ColorBlendState &new_color_blend
 	if (color_blend_state != new_color_blend_state)
 	{
 		color_blend_state = new_color_blend_state;
+		color_blend_hash  = hash_sub_state(color_blend_state, dynamic_state_flags);
 
 		dirty = true;
 	}
@@ -281,6 +469,17 @@ void PipelineState::set_subpass_index(uint32_t new_subpass_index)
 	}
 }
 
+void PipelineState::set_rendering_state(const RenderingState &new_rendering_state)
+{
+	if (rendering_state != new_rendering_state)
+	{
+		rendering_state = new_rendering_state;
+		rendering_hash  = hash_sub_state(rendering_state);
+
+		dirty = true;
+	}
+}
+
 const PipelineLayout &PipelineState::get_pipeline_layout() const
 {
 	assert(pipeline_layout && "Graphics state Pipeline layout is not set");
@@ -337,6 +536,107 @@ uint32_t PipelineState::get_subpass_index() const
 	return subpass_index;
 }
 
+const RenderingState &PipelineState::get_rendering_state() const
+{
+	return rendering_state;
+}
+
+void PipelineState::set_dynamic_state_flags(DynamicPipelineStateFlags flags)
+{
+	if (dynamic_state_flags != flags)
+	{
+		dynamic_state_flags = flags;
+		update_hashes();
+
+		dirty = true;
+	}
+}
+
+DynamicPipelineStateFlags PipelineState::get_dynamic_state_flags() const
+{
+	return dynamic_state_flags;
+}
+
+size_t PipelineState::get_hash() const
+{
+	size_t result = pipeline_layout_hash;
+
+	// For graphics only, dynamic rendering passes have no render pass
+	if (render_pass)
+	{
+		hash_combine(result, render_pass->get_handle());
+	}
+	else
+	{
+		hash_combine(result, rendering_hash);
+	}
+
+	hash_combine(result, specialization_constant_state);
+	hash_combine(result, subpass_index);
+	hash_combine(result, dynamic_state_flags);
+	hash_combine(result, vertex_input_hash);
+	hash_combine(result, input_assembly_hash);
+	hash_combine(result, viewport_hash);
+	hash_combine(result, rasterization_hash);
+	hash_combine(result, multisample_hash);
+	hash_combine(result, depth_stencil_hash);
+	hash_combine(result, color_blend_hash);
+
+	return result;
+}
+
+size_t PipelineState::get_library_hash(VkGraphicsPipelineLibraryFlagBitsEXT library_part) const
+{
+	size_t result = 0;
+
+	hash_combine(result, static_cast<std::underlying_type<VkGraphicsPipelineLibraryFlagBitsEXT>::type>(library_part));
+	hash_combine(result, dynamic_state_flags);
+
+	if (library_part == VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT)
+	{
+		hash_combine(result, vertex_input_hash);
+		hash_combine(result, input_assembly_hash);
+
+		return result;
+	}
+
+	// The other parts depend on the render pass
+	if (render_pass)
+	{
+		hash_combine(result, render_pass->get_handle());
+	}
+	else
+	{
+		hash_combine(result, rendering_hash);
+	}
+
+	hash_combine(result, subpass_index);
+
+	switch (library_part)
+	{
+		case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+			hash_combine(result, pipeline_layout_hash);
+			hash_combine(result, specialization_constant_state);
+			hash_combine(result, viewport_hash);
+			hash_combine(result, rasterization_hash);
+			break;
+		case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+			hash_combine(result, pipeline_layout_hash);
+			hash_combine(result, specialization_constant_state);
+			hash_combine(result, multisample_hash);
+			hash_combine(result, depth_stencil_hash);
+			break;
+		case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+			hash_combine(result, multisample_hash);
+			hash_combine(result, color_blend_hash);
+			break;
+		default:
+			break;
+	}
+
+	return result;
+}
+
 bool PipelineState::is_dirty() const
 {
 	return dirty || specialization_constant_state.is_dirty();
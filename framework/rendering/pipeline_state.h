@@ -133,6 +133,27 @@ struct ColorBlendState
 	std::vector<ColorBlendAttachmentState> attachments;
 };
 
+/**
+ * @brief The attachments of a dynamic rendering pass, which graphics pipelines are created for when there is no render pass
+ */
+struct RenderingState
+{
+	std::vector<VkFormat> color_attachment_formats;
+
+	VkFormat depth_attachment_format{VK_FORMAT_UNDEFINED};
+
+	VkFormat stencil_attachment_format{VK_FORMAT_UNDEFINED};
+
+	/// Fragment output location of each color attachment, or VK_ATTACHMENT_UNUSED, empty unless the pass reads attachments with local read
+	std::vector<uint32_t> color_attachment_locations;
+
+	/// Input attachment index of each color attachment, or VK_ATTACHMENT_UNUSED, empty unless the pass reads attachments with local read
+	std::vector<uint32_t> color_attachment_input_indices;
+
+	/// Input attachment index of the depth stencil attachment, VK_ATTACHMENT_UNUSED if it is not read
+	uint32_t depth_stencil_input_index{VK_ATTACHMENT_UNUSED};
+};
+
 /// Helper class to create specialization constants for a Vulkan pipeline. The state tracks a pipeline globally, and not per shader. Two shaders using the same constant_id will have the same data.
 class SpecializationConstantState
 {
@@ -170,9 +191,26 @@ inline void SpecializationConstantState::set_constant<bool>(std::uint32_t consta
 	set_constant(constant_id, to_bytes(static_cast<std::uint32_t>(data)));
 }
 
+/**
+ * @brief Groups of pipeline state which can be set on the command buffer instead of being baked into pipelines
+ */
+enum DynamicPipelineStateFlagBits : uint32_t
+{
+	/// Cull mode and front face, with VK_EXT_extended_dynamic_state
+	DYNAMIC_PIPELINE_STATE_RASTERIZATION_BIT = 0x00000001,
+	/// All of the depth stencil state, with VK_EXT_extended_dynamic_state
+	DYNAMIC_PIPELINE_STATE_DEPTH_STENCIL_BIT = 0x00000002,
+	/// Blend enable, blend equation and write mask of the color attachments, with VK_EXT_extended_dynamic_state3
+	DYNAMIC_PIPELINE_STATE_COLOR_BLEND_BIT = 0x00000004
+};
+
+using DynamicPipelineStateFlags = uint32_t;
+
 class PipelineState
 {
   public:
+	PipelineState();
+
 	void reset();
 
 	void set_pipeline_layout(PipelineLayout &pipeline_layout);
@@ -197,6 +235,11 @@ class PipelineState
 
 	void set_subpass_index(uint32_t subpass_index);
 
+	/**
+	 * @brief Sets the attachments pipelines are created for, used instead of the render pass if none is set
+	 */
+	void set_rendering_state(const RenderingState &rendering_state);
+
 	const PipelineLayout &get_pipeline_layout() const;
 
 	const RenderPass *get_render_pass() const;
@@ -219,11 +262,40 @@ class PipelineState
 
 	uint32_t get_subpass_index() const;
 
+	const RenderingState &get_rendering_state() const;
+
+	/**
+	 * @brief Sets which groups of state are dynamic
+	 *        Dynamic state is left out of the hash, so pipelines only differing by it are shared,
+	 *        and must be set on the command buffer whenever the pipeline state is flushed.
+	 *        The flags are kept across reset().
+	 */
+	void set_dynamic_state_flags(DynamicPipelineStateFlags flags);
+
+	DynamicPipelineStateFlags get_dynamic_state_flags() const;
+
 	bool is_dirty() const;
 
 	void clear_dirty();
 
+	/**
+	 * @brief Hash of the whole state, identifying the pipeline it describes
+	 *        The hashes of the sub-states are updated when they change, so this only combines them.
+	 */
+	size_t get_hash() const;
+
+	/**
+	 * @brief Hash of the parts of the state used by one part of a graphics pipeline library
+	 * @param library_part One of the VK_EXT_graphics_pipeline_library parts
+	 */
+	size_t get_library_hash(VkGraphicsPipelineLibraryFlagBitsEXT library_part) const;
+
   private:
+	/**
+	 * @brief Recomputes the hashes of all the sub-states
+	 */
+	void update_hashes();
+
 	bool dirty{false};
 
 	PipelineLayout *pipeline_layout{nullptr};
@@ -247,5 +319,27 @@ class PipelineState
 	ColorBlendState color_blend_state{};
 
 	uint32_t subpass_index{0U};
+
+	RenderingState rendering_state{};
+
+	DynamicPipelineStateFlags dynamic_state_flags{0};
+
+	size_t pipeline_layout_hash{0};
+
+	size_t vertex_input_hash{0};
+
+	size_t input_assembly_hash{0};
+
+	size_t rasterization_hash{0};
+
+	size_t viewport_hash{0};
+
+	size_t multisample_hash{0};
+
+	size_t depth_stencil_hash{0};
+
+	size_t color_blend_hash{0};
+
+	size_t rendering_hash{0};
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -106,6 +106,9 @@ void PostProcessingComputePass::transition_images(CommandBuffer &command_buffer,
 	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, cs_source, cs_variant);
 	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
 
+	// All of the transitions of the pass are recorded in a single barrier command
+	command_buffer.begin_barrier_batch();
+
 	for (const auto &sampled : sampled_images)
 	{
 		if (const uint32_t *attachment = sampled.second.get_target_attachment())
@@ -162,7 +165,7 @@ void PostProcessingComputePass::transition_images(CommandBuffer &command_buffer,
 			}
 
 			const bool readable = !(resource->qualifiers & ShaderResourceQualifiers::NonReadable);
-			const bool writable = !(resource->qualifiers & ShaderResourceQualifiers::NonReadable);
+			const bool writable = !(resource->qualifiers & ShaderResourceQualifiers::NonWritable);
 
 			vkb::ImageMemoryBarrier barrier;
 			barrier.old_layout = storage_rt->get_layout(*attachment);
@@ -193,6 +196,8 @@ void PostProcessingComputePass::transition_images(CommandBuffer &command_buffer,
 			storage_rt->set_layout(*attachment, barrier.new_layout);
 		}
 	}
+
+	command_buffer.flush_barriers();
 }
 
 void PostProcessingComputePass::draw(CommandBuffer &command_buffer, RenderTarget &default_render_target)
@@ -233,6 +238,13 @@ void PostProcessingComputePass::draw(CommandBuffer &command_buffer, RenderTarget
 		if (auto layout_binding = bindings.get_layout_binding(it.first))
 		{
 			const auto &view = it.second.get_image_view(default_render_target);
+
+			// The swapchain images only have the STORAGE usage if it was requested, see RenderContext::enable_swapchain_storage()
+			if (!(view.get_image().get_usage() & VK_IMAGE_USAGE_STORAGE_BIT))
+			{
+				throw std::runtime_error("Image bound to storage image '" + it.first + "' of a compute pass lacks the STORAGE usage");
+			}
+
 			command_buffer.bind_image(view, 0, layout_binding->binding, 0);
 		}
 	}
@@ -257,6 +269,26 @@ void PostProcessingComputePass::draw(CommandBuffer &command_buffer, RenderTarget
 	command_buffer.dispatch(n_workgroups.x, n_workgroups.y, n_workgroups.z);
 }
 
+std::unordered_set<uint32_t> PostProcessingComputePass::get_referenced_attachments(const RenderTarget &render_target, const RenderTarget &default_render_target)
+{
+	std::unordered_set<uint32_t> referenced_attachments;
+
+	for (const auto *images : {&sampled_images, &storage_images})
+	{
+		for (const auto &it : *images)
+		{
+			const uint32_t *attachment = it.second.get_target_attachment();
+			const auto     *image_rt   = it.second.get_render_target();
+			if (attachment && (image_rt ? image_rt : &default_render_target) == &render_target)
+			{
+				referenced_attachments.insert(*attachment);
+			}
+		}
+	}
+
+	return referenced_attachments;
+}
+
 PostProcessingComputePass::BarrierInfo PostProcessingComputePass::get_src_barrier_info() const
 {
 	BarrierInfo info{};
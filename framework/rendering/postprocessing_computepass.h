@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -47,6 +47,8 @@ class PostProcessingComputePass : public PostProcessingPass<PostProcessingComput
 	void prepare(CommandBuffer &command_buffer, RenderTarget &default_render_target) override;
 	void draw(CommandBuffer &command_buffer, RenderTarget &default_render_target) override;
 
+	std::unordered_set<uint32_t> get_referenced_attachments(const RenderTarget &render_target, const RenderTarget &default_render_target) override;
+
 	/**
 	 * @brief Sets the number of workgroups to be dispatched each draw().
 	 */
@@ -96,6 +98,10 @@ class PostProcessingComputePass : public PostProcessingPass<PostProcessingComput
 	/**
 	 * @brief Changes (or adds) the storage image at name for this step.
 	 * @remarks Images from RenderTarget attachments are automatically transitioned to GENERAL layout if needed.
+	 * @remarks Binding attachment 0 of the default RenderTarget writes the swapchain image directly, instead of rendering
+	 *          the result with an extra fragment pass; the swapchain needs the STORAGE usage,
+	 *          see RenderContext::enable_swapchain_storage(). The image is left in GENERAL layout, which
+	 *          VulkanSample transitions for presentation.
 	 */
 	PostProcessingComputePass &bind_storage_image(const std::string &name, core::SampledImage &&new_image);
 
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2022, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -21,6 +21,7 @@
 #include "render_context.h"
 #include "render_target.h"
 #include <functional>
+#include <unordered_set>
 
 namespace vkb
 {
@@ -63,6 +64,15 @@ class PostProcessingPassBase
 	virtual void draw(CommandBuffer &command_buffer, RenderTarget &default_render_target)
 	{}
 
+	/**
+	 * @brief Returns the indices of the attachments of render_target that this pass reads or writes.
+	 * @remarks Passes that do not explicitly have a vkb::RenderTarget set use default_render_target.
+	 */
+	virtual std::unordered_set<uint32_t> get_referenced_attachments(const RenderTarget &render_target, const RenderTarget &default_render_target)
+	{
+		return {};
+	}
+
 	/**
 	 * @brief A functor ran in the context of this renderpass.
 	 * @see set_pre_draw_func(), set_post_draw_func()
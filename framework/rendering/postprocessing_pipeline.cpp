@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -18,6 +18,7 @@
 #include "postprocessing_pipeline.h"
 
 #include "common/utils.h"
+#include "postprocessing_renderpass.h"
 
 namespace vkb
 {
@@ -28,9 +29,12 @@ PostProcessingPipeline::PostProcessingPipeline(RenderContext &render_context, Sh
 
 void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &default_render_target)
 {
-	for (current_pass_index = 0; current_pass_index < passes.size(); current_pass_index++)
+	fuse_render_passes(default_render_target);
+
+	for (current_pass_index = 0; current_pass_index < passes.size(); current_pass_index += fused_pass_counts[current_pass_index] + 1)
 	{
-		auto &pass = *passes[current_pass_index];
+		auto        &pass       = *passes[current_pass_index];
+		const size_t last_index = current_pass_index + fused_pass_counts[current_pass_index];
 
 		if (pass.debug_name.empty())
 		{
@@ -38,12 +42,17 @@ void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &d
 		}
 		ScopedDebugLabel marker{command_buffer, pass.debug_name.c_str()};
 
-		if (!pass.prepared)
+		// Passes fused into this one are drawn within its renderpass, so they are prepared first
+		for (size_t i = current_pass_index; i <= last_index; i++)
 		{
-			ScopedDebugLabel marker{command_buffer, "Prepare"};
+			auto &prepared_pass = *passes[i];
+			if (!prepared_pass.prepared)
+			{
+				ScopedDebugLabel marker{command_buffer, "Prepare"};
 
-			pass.prepare(command_buffer, default_render_target);
-			pass.prepared = true;
+				prepared_pass.prepare(command_buffer, default_render_target);
+				prepared_pass.prepared = true;
+			}
 		}
 
 		if (pass.pre_draw)
@@ -55,15 +64,173 @@ void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &d
 
 		pass.draw(command_buffer, default_render_target);
 
-		if (pass.post_draw)
+		// Only the last of fused passes may have a post-draw hook
+		auto &last_pass = *passes[last_index];
+		if (last_pass.post_draw)
 		{
 			ScopedDebugLabel marker{command_buffer, "Post-draw"};
 
-			pass.post_draw();
+			last_pass.post_draw();
 		}
 	}
 
 	current_pass_index = 0;
 }
 
+void PostProcessingPipeline::fuse_render_passes(RenderTarget &default_render_target)
+{
+	fused_pass_counts.assign(passes.size(), 0);
+
+	for (size_t first = 0; first < passes.size(); first += fused_pass_counts[first] + 1)
+	{
+		auto *pass = dynamic_cast<PostProcessingRenderPass *>(passes[first].get());
+		if (pass == nullptr)
+		{
+			continue;
+		}
+
+		std::vector<PostProcessingRenderPass *> fused_passes;
+		AttachmentSet                           transient_attachments;
+
+		if (pass_fusion)
+		{
+			const RenderTarget &render_target = pass->render_target ? *pass->render_target : default_render_target;
+
+			AttachmentSet sampled_attachments, output_attachments;
+			collect_fusion_attachments(*pass, render_target, sampled_attachments, output_attachments);
+
+			for (size_t next_index = first + 1; next_index < passes.size(); next_index++)
+			{
+				auto *next = dynamic_cast<PostProcessingRenderPass *>(passes[next_index].get());
+				if (next == nullptr || (next->render_target ? next->render_target : &default_render_target) != &render_target ||
+				    passes[next_index - 1]->post_draw || next->pre_draw)
+				{
+					break;
+				}
+
+				// Sampling an attachment written within the same renderpass is a feedback loop,
+				// it may only be read as an input attachment
+				AttachmentSet next_sampled_attachments, next_output_attachments;
+				collect_fusion_attachments(*next, render_target, next_sampled_attachments, next_output_attachments);
+
+				auto intersects = [](const AttachmentSet &a, const AttachmentSet &b) {
+					return std::any_of(a.begin(), a.end(), [&b](uint32_t attachment) { return b.find(attachment) != b.end(); });
+				};
+				if (intersects(next_sampled_attachments, output_attachments) || intersects(sampled_attachments, next_output_attachments))
+				{
+					break;
+				}
+
+				sampled_attachments.insert(next_sampled_attachments.begin(), next_sampled_attachments.end());
+				output_attachments.insert(next_output_attachments.begin(), next_output_attachments.end());
+				fused_passes.push_back(next);
+			}
+
+			fused_pass_counts[first] = fused_passes.size();
+			transient_attachments    = find_transient_attachments(first, fused_passes.size(), render_target, default_render_target);
+		}
+
+		pass->set_fused_passes(std::move(fused_passes), std::move(transient_attachments));
+	}
+}
+
+void PostProcessingPipeline::collect_fusion_attachments(PostProcessingRenderPass &pass, const RenderTarget &render_target,
+                                                        AttachmentSet &sampled_attachments, AttachmentSet &output_attachments)
+{
+	for (auto &step_ptr : pass.pipeline.get_subpasses())
+	{
+		auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+		for (auto &it : step.get_sampled_images())
+		{
+			// Images sampled without a render target are sampled from the one of the pass
+			const uint32_t *attachment = it.second.get_target_attachment();
+			const auto     *image_rt   = it.second.get_render_target();
+			if (attachment && (image_rt == nullptr || image_rt == &render_target))
+			{
+				sampled_attachments.insert(*attachment);
+			}
+		}
+
+		for (uint32_t it : step.get_output_attachments())
+		{
+			output_attachments.insert(it);
+		}
+	}
+}
+
+AttachmentSet PostProcessingPipeline::find_transient_attachments(size_t first, size_t count, const RenderTarget &render_target, const RenderTarget &default_render_target)
+{
+	AttachmentSet          written_attachments, input_attachments, kept_attachments;
+	PostProcessingSubpass *last_step = nullptr;
+
+	for (size_t i = first; i <= first + count; i++)
+	{
+		for (auto &step_ptr : get_pass<PostProcessingRenderPass>(i).pipeline.get_subpasses())
+		{
+			auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+			for (auto &it : step.get_input_attachments())
+			{
+				// An attachment read before being written needs its previous contents
+				if (written_attachments.find(it.second) != written_attachments.end())
+				{
+					input_attachments.insert(it.second);
+				}
+				else
+				{
+					kept_attachments.insert(it.second);
+				}
+			}
+
+			for (auto &it : step.get_sampled_images())
+			{
+				const uint32_t *attachment = it.second.get_target_attachment();
+				const auto     *image_rt   = it.second.get_render_target();
+				if (attachment && (image_rt == nullptr || image_rt == &render_target))
+				{
+					kept_attachments.insert(*attachment);
+				}
+			}
+
+			for (uint32_t it : step.get_output_attachments())
+			{
+				written_attachments.insert(it);
+			}
+
+			last_step = &step;
+		}
+	}
+
+	// The outputs of the last step are the results of the renderpass
+	if (last_step != nullptr)
+	{
+		for (uint32_t it : last_step->get_output_attachments())
+		{
+			kept_attachments.insert(it);
+		}
+	}
+
+	// Attachments used by any other pass, including the passes before this one in the next frame
+	for (size_t i = 0; i < passes.size(); i++)
+	{
+		if (i < first || i > first + count)
+		{
+			auto referenced_attachments = passes[i]->get_referenced_attachments(render_target, default_render_target);
+			kept_attachments.insert(referenced_attachments.begin(), referenced_attachments.end());
+		}
+	}
+
+	AttachmentSet transient_attachments;
+	for (uint32_t it : input_attachments)
+	{
+		if (kept_attachments.find(it) == kept_attachments.end())
+		{
+			transient_attachments.insert(it);
+		}
+	}
+
+	return transient_attachments;
+}
+
 }        // namespace vkb
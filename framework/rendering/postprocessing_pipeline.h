@@ -1,4 +1,4 @@
-/* Copyright (c) 2020, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -51,6 +51,25 @@ class PostProcessingPipeline
 	 */
 	void draw(CommandBuffer &command_buffer, RenderTarget &default_render_target);
 
+	/**
+	 * @brief Sets whether consecutive vkb::PostProcessingRenderPass are fused into a single renderpass, which is the default.
+	 *        A pass is drawn as further subpasses of the previous one if they render to the same render target,
+	 *        no pre-draw or post-draw hook runs between them, and neither samples an attachment that the other writes.
+	 *        Attachments written and then only read as input attachments within a renderpass are neither loaded nor stored,
+	 *        so they stay on-chip on tile-based GPUs, unless another pass of the pipeline uses them.
+	 * @remarks Disable fusion if such attachments are read outside of this pipeline.
+	 *          Compute passes run arbitrary shaders and are never fused, a single shader must be written to merge them.
+	 */
+	inline void set_pass_fusion(bool enabled)
+	{
+		pass_fusion = enabled;
+	}
+
+	inline bool get_pass_fusion() const
+	{
+		return pass_fusion;
+	}
+
 	/**
 	 * @brief Gets all of the passes in the pipeline.
 	 */
@@ -100,6 +119,27 @@ class PostProcessingPipeline
 	ShaderSource                                         triangle_vs;
 	std::vector<std::unique_ptr<PostProcessingPassBase>> passes{};
 	size_t                                               current_pass_index{0};
+	bool                                                 pass_fusion{true};
+
+	/// Number of the following passes that are fused into the renderpass of each pass
+	std::vector<size_t> fused_pass_counts{};
+
+	/**
+	 * @brief Groups consecutive render passes which can be fused, and sets the passes fused into the first one of each group.
+	 */
+	void fuse_render_passes(RenderTarget &default_render_target);
+
+	/**
+	 * @brief Collects the attachments of render_target that the steps of a render pass sample, and those they write.
+	 */
+	static void collect_fusion_attachments(PostProcessingRenderPass &pass, const RenderTarget &render_target,
+	                                       std::unordered_set<uint32_t> &sampled_attachments, std::unordered_set<uint32_t> &output_attachments);
+
+	/**
+	 * @brief Finds the attachments of render_target that the fused passes first to first + count use only within their renderpass:
+	 *        written by a step, then read as input attachments by the following ones, and not used by any other pass.
+	 */
+	std::unordered_set<uint32_t> find_transient_attachments(size_t first, size_t count, const RenderTarget &render_target, const RenderTarget &default_render_target);
 };
 
 }        // namespace vkb
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2024, Arm Limited and Contributors
+/* Copyright (c) 2021-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -237,7 +237,8 @@ void PostProcessingRenderPass::update_load_stores(
     const AttachmentSet        &output_attachments,
     const RenderTarget         &fallback_render_target)
 {
-	if (!load_stores_dirty)
+	// The steps of fused passes change without marking this pass dirty
+	if (!load_stores_dirty && fused_passes.empty())
 	{
 		return;
 	}
@@ -258,10 +259,16 @@ void PostProcessingRenderPass::update_load_stores(
 			                                     uint32_t attachment = pair.second & ATTACHMENT_BITMASK;
 			                                     return attachment == j && sampled_rt == &render_target;
 		                                     }) != sampled_attachments.end();
-		const bool is_output  = output_attachments.find(j) != output_attachments.end();
+		const bool is_output    = output_attachments.find(j) != output_attachments.end();
+		const bool is_transient = transient_attachments.find(j) != transient_attachments.end();
 
 		VkAttachmentLoadOp load;
-		if (is_input || is_sampled)
+		if (is_transient)
+		{
+			// Written before being read as an input attachment, and never used outside of this renderpass
+			load = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		}
+		else if (is_input || is_sampled)
 		{
 			load = VK_ATTACHMENT_LOAD_OP_LOAD;
 		}
@@ -275,7 +282,7 @@ void PostProcessingRenderPass::update_load_stores(
 		}
 
 		VkAttachmentStoreOp store;
-		if (is_output)
+		if (is_output && !is_transient)
 		{
 			store = VK_ATTACHMENT_STORE_OP_STORE;
 		}
@@ -346,6 +353,9 @@ void PostProcessingRenderPass::transition_attachments(
 	fallback_barrier_src.image_write_access = 0;
 	auto prev_pass_barrier_info             = get_predecessor_src_barrier_info(fallback_barrier_src);
 
+	// All of the transitions of the pass are recorded in a single barrier command
+	command_buffer.begin_barrier_batch();
+
 	for (uint32_t input : input_attachments)
 	{
 		const VkImageLayout prev_layout = render_target.get_layout(input);
@@ -453,16 +463,14 @@ void PostProcessingRenderPass::transition_attachments(
 		render_target.set_layout(output, output_layout);
 	}
 
+	command_buffer.flush_barriers();
+
 	// NOTE: Unused attachments might be carried over to other render passes,
 	//       so we don't want to transition them to UNDEFINED layout here
 }
 
-void PostProcessingRenderPass::prepare_draw(CommandBuffer &command_buffer, RenderTarget &fallback_render_target)
+void PostProcessingRenderPass::collect_attachments(AttachmentSet &input_attachments, SampledAttachmentSet &sampled_attachments, AttachmentSet &output_attachments)
 {
-	// Collect all input, output, and sampled-from attachments from all subpasses (steps)
-	AttachmentSet        input_attachments, output_attachments;
-	SampledAttachmentSet sampled_attachments;
-
 	for (auto &step_ptr : pipeline.get_subpasses())
 	{
 		auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
@@ -494,6 +502,19 @@ void PostProcessingRenderPass::prepare_draw(CommandBuffer &command_buffer, Rende
 			output_attachments.insert(it);
 		}
 	}
+}
+
+void PostProcessingRenderPass::prepare_draw(CommandBuffer &command_buffer, RenderTarget &fallback_render_target)
+{
+	// Collect all input, output, and sampled-from attachments from all subpasses (steps), including those of fused passes
+	AttachmentSet        input_attachments, output_attachments;
+	SampledAttachmentSet sampled_attachments;
+
+	collect_attachments(input_attachments, sampled_attachments, output_attachments);
+	for (auto *fused_pass : fused_passes)
+	{
+		fused_pass->collect_attachments(input_attachments, sampled_attachments, output_attachments);
+	}
 
 	transition_attachments(input_attachments, sampled_attachments, output_attachments,
 	                       command_buffer, fallback_render_target);
@@ -501,10 +522,8 @@ void PostProcessingRenderPass::prepare_draw(CommandBuffer &command_buffer, Rende
 	                   fallback_render_target);
 }
 
-void PostProcessingRenderPass::draw(CommandBuffer &command_buffer, RenderTarget &default_render_target)
+void PostProcessingRenderPass::update_uniform_buffer()
 {
-	prepare_draw(command_buffer, default_render_target);
-
 	if (!uniform_data.empty())
 	{
 		// Allocate a buffer (using the buffer pool from the active frame to store uniform values) and bind it
@@ -512,13 +531,72 @@ void PostProcessingRenderPass::draw(CommandBuffer &command_buffer, RenderTarget
 		uniform_buffer_alloc = std::make_shared<BufferAllocation>(render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, uniform_data.size()));
 		uniform_buffer_alloc->update(uniform_data);
 	}
+}
+
+void PostProcessingRenderPass::set_fused_passes(std::vector<PostProcessingRenderPass *> &&passes, AttachmentSet &&new_transient_attachments)
+{
+	if (passes != fused_passes || new_transient_attachments != transient_attachments)
+	{
+		fused_passes          = std::move(passes);
+		transient_attachments = std::move(new_transient_attachments);
+		load_stores_dirty     = true;
+	}
+}
 
-	// Update render target for this draw
+AttachmentSet PostProcessingRenderPass::get_referenced_attachments(const RenderTarget &target, const RenderTarget &default_render_target)
+{
+	const RenderTarget *pass_render_target = render_target ? render_target : &default_render_target;
+
+	AttachmentSet referenced_attachments;
+
+	for (auto &step_ptr : pipeline.get_subpasses())
+	{
+		auto &step = *dynamic_cast<PostProcessingSubpass *>(step_ptr.get());
+
+		if (pass_render_target == &target)
+		{
+			for (auto &it : step.get_input_attachments())
+			{
+				referenced_attachments.insert(it.second);
+			}
+
+			for (uint32_t it : step.get_output_attachments())
+			{
+				referenced_attachments.insert(it);
+			}
+		}
+
+		for (auto &it : step.get_sampled_images())
+		{
+			const uint32_t *attachment = it.second.get_target_attachment();
+			const auto     *image_rt   = it.second.get_render_target();
+			if (attachment && (image_rt ? image_rt : pass_render_target) == &target)
+			{
+				referenced_attachments.insert(*attachment);
+			}
+		}
+	}
+
+	return referenced_attachments;
+}
+
+void PostProcessingRenderPass::draw(CommandBuffer &command_buffer, RenderTarget &default_render_target)
+{
+	prepare_draw(command_buffer, default_render_target);
+
+	// Update render target for this draw, fused passes render to the same one
 	draw_render_target = render_target ? render_target : &default_render_target;
+	update_uniform_buffer();
+
+	for (auto *fused_pass : fused_passes)
+	{
+		fused_pass->draw_render_target = draw_render_target;
+		fused_pass->update_uniform_buffer();
+	}
 
 	// Set appropriate viewport & scissor for this RT
 	{
-		auto &extent = draw_render_target->get_extent();
+		auto &extent = draw_render_target->get_render_extent();
 
 		VkViewport viewport{};
 		viewport.width    = static_cast<float>(extent.width);
@@ -532,14 +610,34 @@ void PostProcessingRenderPass::draw(CommandBuffer &command_buffer, RenderTarget
 		command_buffer.set_scissor(0, {scissor});
 	}
 
+	// The steps of fused passes are lent to the pipeline of this pass for the draw,
+	// they still bind the uniforms and samplers of their own pass
+	auto        &subpasses         = pipeline.get_subpasses();
+	const size_t own_subpass_count = subpasses.size();
+	for (auto *fused_pass : fused_passes)
+	{
+		for (auto &subpass : fused_pass->pipeline.get_subpasses())
+		{
+			subpasses.push_back(std::move(subpass));
+		}
+	}
+
 	// Finally draw all subpasses
 	pipeline.draw(command_buffer, *draw_render_target);
 
-	if (parent->get_current_pass_index() < (parent->get_passes().size() - 1))
+	auto lent_subpass = subpasses.begin() + own_subpass_count;
+	for (auto *fused_pass : fused_passes)
+	{
+		for (auto &subpass : fused_pass->pipeline.get_subpasses())
+		{
+			subpass = std::move(*lent_subpass++);
+		}
+	}
+	subpasses.resize(own_subpass_count);
+
+	if (parent->get_current_pass_index() + fused_passes.size() < (parent->get_passes().size() - 1))
 	{
 		// Leave the last renderpass open for user modification (e.g., drawing GUI)
 		command_buffer.end_render_pass();
 	}
 }
-
-}        // namespace vkb
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -220,6 +220,7 @@ class PostProcessingRenderPass : public PostProcessingPass<PostProcessingRenderP
 {
   public:
 	friend class PostProcessingSubpass;
+	friend class PostProcessingPipeline;
 
 	PostProcessingRenderPass(PostProcessingPipeline *parent, std::unique_ptr<core::Sampler> &&default_sampler = nullptr);
 
@@ -231,6 +232,8 @@ class PostProcessingRenderPass : public PostProcessingPass<PostProcessingRenderP
 
 	void draw(CommandBuffer &command_buffer, RenderTarget &default_render_target) override;
 
+	AttachmentSet get_referenced_attachments(const RenderTarget &render_target, const RenderTarget &default_render_target) override;
+
 	/**
 	 * @brief Gets the step at the given index.
 	 */
@@ -305,11 +308,28 @@ class PostProcessingRenderPass : public PostProcessingPass<PostProcessingRenderP
 	                        const AttachmentSet        &output_attachments,
 	                        const RenderTarget         &fallback_render_target);
 
+	/**
+	 * @brief Collect the input, sampled and output attachments of the steps of this pass.
+	 */
+	void collect_attachments(AttachmentSet &input_attachments, SampledAttachmentSet &sampled_attachments, AttachmentSet &output_attachments);
+
 	/**
 	 * @brief Transition images and prepare load/stores before draw()ing.
 	 */
 	void prepare_draw(CommandBuffer &command_buffer, RenderTarget &fallback_render_target);
 
+	/**
+	 * @brief Allocate the uniform buffer of this pass for the current frame, if it has uniform data.
+	 */
+	void update_uniform_buffer();
+
+	/**
+	 * @brief Sets the passes whose steps are drawn as further subpasses of the renderpass of this pass,
+	 *        and the attachments only used within that renderpass, which are neither loaded nor stored.
+	 * @see PostProcessingPipeline::set_pass_fusion()
+	 */
+	void set_fused_passes(std::vector<PostProcessingRenderPass *> &&passes, AttachmentSet &&transient_attachments);
+
 	BarrierInfo get_src_barrier_info() const override;
 	BarrierInfo get_dst_barrier_info() const override;
 
@@ -321,6 +341,9 @@ class PostProcessingRenderPass : public PostProcessingPass<PostProcessingRenderP
 	bool                              load_stores_dirty{true};
 	std::vector<uint8_t>              uniform_data{};
 	std::shared_ptr<BufferAllocation> uniform_buffer_alloc{};
+
+	std::vector<PostProcessingRenderPass *> fused_passes{};
+	AttachmentSet                           transient_attachments{};
 };
 
 }        // namespace vkb
@@ -0,0 +1,355 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/ray_query_shadows.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "common/utils.h"
+#include "core/allocated.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "rendering/ray_tracing_scene.h"
+#include "rendering/render_context.h"
+#include "rendering/subpass.h"
+#include "rendering/subpasses/shadow_subpass.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene_snapshot.h"
+
+namespace vkb
+{
+namespace
+{
+/// Same layout as Parameters in ray_query_shadows.comp
+struct TraceParameters
+{
+	glm::mat4 inverse_view_proj;
+
+	/// xyz direction towards the light, w tangent of its angular radius
+	glm::vec4 light_direction;
+
+	glm::vec4 camera_position;
+
+	/// Device address of the top-level acceleration structure, as two 32-bit halves
+	glm::uvec2 acceleration_structure;
+
+	glm::uvec2 extent;
+
+	uint32_t frame_index;
+};
+
+/// Same layout as Parameters in ray_query_shadows_denoise.comp
+struct DenoiseParameters
+{
+	glm::uvec2 extent;
+};
+
+/// Invocations of the compute shaders on each side of a workgroup
+constexpr uint32_t GROUP_SIZE = 8;
+
+/// Format of the visibility and the mask, holding the visibility and the depth of each texel
+constexpr VkFormat MASK_FORMAT = VK_FORMAT_R32G32_SFLOAT;
+}        // namespace
+
+std::atomic<uint64_t> RayQueryShadows::ray_count{0};
+
+bool RayQueryShadows::is_supported(const Device &device)
+{
+	return device.is_enabled(VK_KHR_RAY_QUERY_EXTENSION_NAME) && device.is_enabled(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME);
+}
+
+uint64_t RayQueryShadows::take_ray_count()
+{
+	return ray_count.exchange(0);
+}
+
+RayQueryShadows::RayQueryShadows(RenderContext &render_context, sg::Scene &scene, sg::Camera &camera, RayTracingScene &ray_tracing_scene, uint32_t downscale) :
+    render_context{render_context},
+    scene{scene},
+    camera{camera},
+    ray_tracing_scene{ray_tracing_scene},
+    downscale{std::max(downscale, 1U)},
+    trace_shader{"ray_query_shadows.comp"},
+    denoise_shader{"ray_query_shadows_denoise.comp"}
+{
+	auto &device = render_context.get_device();
+
+	if (!is_supported(device))
+	{
+		throw std::runtime_error{"Ray query shadows need VK_KHR_ray_query and VK_KHR_acceleration_structure"};
+	}
+
+	device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, trace_shader);
+	device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, denoise_shader);
+
+	// The depth is the one of the camera, rendered without bias
+	auto subpass = std::make_unique<ShadowSubpass>(render_context,
+	                                               ShaderSource{"shadows/shadowmap.vert"},
+	                                               ShaderSource{"shadows/shadowmap.frag"},
+	                                               scene,
+	                                               camera);
+	subpass->set_depth_bias(0.0f, 0.0f, 0.0f);
+
+	depth_pipeline = std::make_unique<RenderPipeline>();
+	depth_pipeline->add_subpass(std::move(subpass));
+	depth_pipeline->set_load_store({{VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE}});
+
+	VkClearValue clear_value{};
+	clear_value.depthStencil = {0.0f, ~0U};
+	depth_pipeline->set_clear_value({clear_value});
+
+	// All the images are read with texelFetch()
+	VkSamplerCreateInfo sampler_info{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+	sampler_info.magFilter    = VK_FILTER_NEAREST;
+	sampler_info.minFilter    = VK_FILTER_NEAREST;
+	sampler_info.mipmapMode   = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+	sampler = std::make_unique<core::Sampler>(device, sampler_info);
+	sampler->set_debug_name("RayQueryShadows: sampler");
+
+	create(render_context.get_surface_extent());
+}
+
+RayQueryShadows::~RayQueryShadows() = default;
+
+void RayQueryShadows::set_light_angular_radius(float radius)
+{
+	light_angular_radius = radius;
+}
+
+void RayQueryShadows::create(const VkExtent2D &new_surface_extent)
+{
+	auto &device       = render_context.get_device();
+	auto &retire_queue = device.get_retire_queue();
+
+	// The frames in flight may still read the previous images
+	retire_queue.retire(std::move(depth_target));
+	retire_queue.retire(std::move(visibility_view));
+	retire_queue.retire(std::move(visibility));
+	retire_queue.retire(std::move(mask_view));
+	retire_queue.retire(std::move(mask));
+
+	surface_extent = new_surface_extent;
+	extent         = {std::max((surface_extent.width + downscale - 1) / downscale, 1U),
+	                  std::max((surface_extent.height + downscale - 1) / downscale, 1U)};
+
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
+
+	std::vector<core::Image> images;
+	images.emplace_back(device,
+	                    VkExtent3D{extent.width, extent.height, 1},
+	                    get_suitable_depth_format(device.get_gpu().get_handle()),
+	                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+	                    VMA_MEMORY_USAGE_GPU_ONLY);
+	images.back().set_debug_name("RayQueryShadows: depth");
+	depth_target = std::make_unique<RenderTarget>(std::move(images));
+
+	visibility = std::make_unique<core::Image>(device,
+	                                           VkExtent3D{extent.width, extent.height, 1},
+	                                           MASK_FORMAT,
+	                                           VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+	                                           VMA_MEMORY_USAGE_GPU_ONLY);
+	visibility->set_debug_name("RayQueryShadows: visibility");
+
+	visibility_view = std::make_unique<core::ImageView>(*visibility, VK_IMAGE_VIEW_TYPE_2D);
+	visibility_view->set_debug_name("RayQueryShadows: visibility view");
+
+	mask = std::make_unique<core::Image>(device,
+	                                     VkExtent3D{extent.width, extent.height, 1},
+	                                     MASK_FORMAT,
+	                                     VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+	                                     VMA_MEMORY_USAGE_GPU_ONLY);
+	mask->set_debug_name("RayQueryShadows: mask");
+
+	mask_view = std::make_unique<core::ImageView>(*mask, VK_IMAGE_VIEW_TYPE_2D);
+	mask_view->set_debug_name("RayQueryShadows: mask view");
+}
+
+void RayQueryShadows::trace(CommandBuffer &command_buffer, sg::Light &light, const sg::SceneSnapshot *snapshot)
+{
+	const auto &new_surface_extent = render_context.get_surface_extent();
+	if (new_surface_extent.width != surface_extent.width || new_surface_extent.height != surface_extent.height)
+	{
+		create(new_surface_extent);
+	}
+
+	ScopedDebugLabel debug_label{command_buffer, "Ray query shadows"};
+
+	auto &depth_view = depth_target->get_views()[0];
+
+	// Depth prepass at the extent of the mask, the previous frames may still be reading the depth and the mask
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+		command_buffer.image_memory_barrier(depth_view, memory_barrier);
+	}
+
+	VkViewport viewport{};
+	viewport.width    = static_cast<float>(extent.width);
+	viewport.height   = static_cast<float>(extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	command_buffer.set_viewport(0, {viewport});
+
+	VkRect2D scissor{};
+	scissor.extent = extent;
+	command_buffer.set_scissor(0, {scissor});
+
+	depth_pipeline->draw(command_buffer, *depth_target);
+	command_buffer.end_render_pass();
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(depth_view, memory_barrier);
+	}
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(*visibility_view, memory_barrier);
+	}
+
+	auto &resource_cache = render_context.get_device().get_resource_cache();
+
+	uint32_t group_count_x = (extent.width + GROUP_SIZE - 1) / GROUP_SIZE;
+	uint32_t group_count_y = (extent.height + GROUP_SIZE - 1) / GROUP_SIZE;
+
+	// Tracing, from the position of each depth texel towards the light
+	{
+		auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, trace_shader);
+		auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+		command_buffer.bind_pipeline_layout(pipeline_layout);
+
+		command_buffer.bind_image(depth_view, *sampler, 0, 0, 0);
+		command_buffer.bind_image(*visibility_view, 0, 1, 0);
+
+		auto light_state = sg::get_node_state(snapshot, *light.get_node());
+		auto view        = sg::get_view(snapshot, camera);
+		auto view_proj   = vulkan_style_projection(sg::get_projection(snapshot, camera)) * view;
+
+		uint64_t acceleration_structure = ray_tracing_scene.get_top_level_acceleration_structure().get_device_address();
+
+		TraceParameters parameters{};
+		parameters.inverse_view_proj      = glm::inverse(view_proj);
+		parameters.light_direction        = glm::vec4(-glm::normalize(light_state.rotation * light.get_properties().direction), std::tan(light_angular_radius));
+		parameters.camera_position        = glm::inverse(view)[3];
+		parameters.acceleration_structure = {static_cast<uint32_t>(acceleration_structure), static_cast<uint32_t>(acceleration_structure >> 32)};
+		parameters.extent                 = {extent.width, extent.height};
+		parameters.frame_index            = frame_index++;
+		command_buffer.push_constants(parameters);
+
+		command_buffer.dispatch(group_count_x, group_count_y, 1);
+	}
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(*visibility_view, memory_barrier);
+	}
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(*mask_view, memory_barrier);
+	}
+
+	// Depth aware blur of the visibility
+	{
+		auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, denoise_shader);
+		auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+		command_buffer.bind_pipeline_layout(pipeline_layout);
+
+		command_buffer.bind_image(*visibility_view, *sampler, 0, 0, 0);
+		command_buffer.bind_image(*mask_view, 0, 1, 0);
+
+		DenoiseParameters parameters{};
+		parameters.extent = {extent.width, extent.height};
+		command_buffer.push_constants(parameters);
+
+		command_buffer.dispatch(group_count_x, group_count_y, 1);
+	}
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(*mask_view, memory_barrier);
+	}
+
+	ray_count.fetch_add(static_cast<uint64_t>(extent.width) * extent.height, std::memory_order_relaxed);
+}
+
+void RayQueryShadows::bind(CommandBuffer &command_buffer, uint32_t set, uint32_t binding)
+{
+	command_buffer.bind_image(*mask_view, *sampler, set, binding, 0);
+}
+
+std::vector<std::string> RayQueryShadows::get_definitions() const
+{
+	return {"RAY_QUERY_SHADOWS", "RAY_QUERY_SHADOW_SCALE " + std::to_string(downscale)};
+}
+
+const core::ImageView &RayQueryShadows::get_view() const
+{
+	return *mask_view;
+}
+}        // namespace vkb
@@ -0,0 +1,171 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/sampler.h"
+#include "core/shader_module.h"
+#include "rendering/render_pipeline.h"
+#include "rendering/render_target.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+class RayTracingScene;
+class RenderContext;
+
+namespace sg
+{
+class Camera;
+class Light;
+class Scene;
+class SceneSnapshot;
+}        // namespace sg
+
+/**
+ * @brief Shadows of a directional light traced with ray queries at a reduced resolution, instead of a shadow map
+ *
+ * trace() renders the depth of the scene seen by the camera at a fraction of the surface extent, see the downscale
+ * of the constructor. ray_query_shadows.comp then traces a ray towards the light from each of its texels against the
+ * top-level structure of a RayTracingScene, within a cone of the angular radius of the light for soft shadows, and
+ * ray_query_shadows_denoise.comp filters the visibility with a depth aware blur. The resulting mask holds the
+ * visibility and the depth of each texel, so that the fragment shaders upsample it with the depth of their fragment.
+ *
+ * The acceleration structure is read by its device address, so the RayTracingScene must be kept up to date by the
+ * application, see RayTracingScene::update(), and must not be rebuilt while frames in flight trace it.
+ *
+ * Shaders read the mask by including ray_query_shadows.h, with get_definitions() and bind() at set 0, binding 5.
+ */
+class RayQueryShadows
+{
+  public:
+	/**
+	 * @return Whether the device traces ray queries against acceleration structures
+	 */
+	static bool is_supported(const Device &device);
+
+	/**
+	 * @brief Takes the number of rays traced since the last call, for the stats
+	 */
+	static uint64_t take_ray_count();
+
+	/**
+	 * @param render_context Render context, the mask follows the extent of its surface
+	 * @param scene Scene whose depth is rendered, the same as the one of the ray tracing scene
+	 * @param camera Camera the scene is seen from
+	 * @param ray_tracing_scene Acceleration structures of the scene, built
+	 * @param downscale Ratio of the surface extent to the extent of the mask
+	 */
+	RayQueryShadows(RenderContext &render_context, sg::Scene &scene, sg::Camera &camera, RayTracingScene &ray_tracing_scene, uint32_t downscale = 2);
+
+	RayQueryShadows(const RayQueryShadows &) = delete;
+
+	RayQueryShadows(RayQueryShadows &&) = delete;
+
+	~RayQueryShadows();
+
+	RayQueryShadows &operator=(const RayQueryShadows &) = delete;
+
+	RayQueryShadows &operator=(RayQueryShadows &&) = delete;
+
+	/**
+	 * @brief Sets the angular radius of the light in radians, zero for hard shadows
+	 */
+	void set_light_angular_radius(float radius);
+
+	/**
+	 * @brief Records the depth prepass, the tracing and the denoising of the shadows of a light, outside of a render pass
+	 *        The mask is left in the shader read only layout for the fragment shaders.
+	 * @param command_buffer A command buffer of a queue family supporting graphics and compute
+	 * @param light A directional light
+	 * @param snapshot The scene state to read the light and camera from, or null for the live scene
+	 */
+	void trace(CommandBuffer &command_buffer, sg::Light &light, const sg::SceneSnapshot *snapshot = nullptr);
+
+	/**
+	 * @brief Binds the mask of the last trace(), read with texelFetch()
+	 */
+	void bind(CommandBuffer &command_buffer, uint32_t set, uint32_t binding);
+
+	/**
+	 * @return The definitions of the shader variants including ray_query_shadows.h
+	 */
+	std::vector<std::string> get_definitions() const;
+
+	/**
+	 * @return A view on the mask, with the visibility in r and the depth in g
+	 */
+	const core::ImageView &get_view() const;
+
+  private:
+	/**
+	 * @brief Creates the depth and mask images for the surface extent, retiring the previous ones
+	 */
+	void create(const VkExtent2D &surface_extent);
+
+	static std::atomic<uint64_t> ray_count;
+
+	RenderContext &render_context;
+
+	sg::Scene &scene;
+
+	sg::Camera &camera;
+
+	RayTracingScene &ray_tracing_scene;
+
+	uint32_t downscale;
+
+	float light_angular_radius{0.0f};
+
+	ShaderSource trace_shader;
+
+	ShaderSource denoise_shader;
+
+	/// Surface extent the images were created for
+	VkExtent2D surface_extent{};
+
+	/// Extent of the depth and of the mask
+	VkExtent2D extent{};
+
+	std::unique_ptr<RenderTarget> depth_target;
+
+	std::unique_ptr<RenderPipeline> depth_pipeline;
+
+	/// Visibility traced by ray_query_shadows.comp, before denoising
+	std::unique_ptr<core::Image> visibility;
+
+	std::unique_ptr<core::ImageView> visibility_view;
+
+	std::unique_ptr<core::Image> mask;
+
+	std::unique_ptr<core::ImageView> mask_view;
+
+	std::unique_ptr<core::Sampler> sampler;
+
+	/// Varies the jitter of the rays across frames
+	uint32_t frame_index{0};
+};
+}        // namespace vkb
@@ -0,0 +1,231 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/ray_tracing_scene.h"
+
+#include <algorithm>
+
+#include "common/glm_common.h"
+#include "common/utils.h"
+#include "core/acceleration_structure_builder.h"
+#include "core/device.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/components/transform.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr VkBuildAccelerationStructureFlagsKHR TOP_LEVEL_BUILD_FLAGS = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+
+/**
+ * @return A sum of the transform versions of a node and its ancestors, which changes when its world matrix does
+ */
+uint32_t get_transform_version(sg::Node &node)
+{
+	uint32_t version = 0;
+	for (auto ancestor = &node; ancestor; ancestor = ancestor->get_parent())
+	{
+		version += ancestor->get_transform().get_version();
+	}
+
+	return version;
+}
+
+/**
+ * @brief Adds the triangles of a submesh to a bottom-level structure
+ * @return Whether the submesh has triangles
+ */
+bool add_sub_mesh(core::AccelerationStructure &acceleration_structure, sg::SubMesh &sub_mesh)
+{
+	VkDeviceSize        position_offset = 0;
+	auto                position_buffer = sub_mesh.get_vertex_buffer(sg::VertexAttributeSlot::Position, position_offset);
+	sg::VertexAttribute position;
+	if (!position_buffer || !sub_mesh.get_attribute(sg::VertexAttributeSlot::Position, position) || sub_mesh.vertices_count == 0)
+	{
+		return false;
+	}
+
+	// The offsets of the submesh within shared buffers are part of the addresses
+	uint64_t vertex_address = position_buffer->get_device_address() + position_offset + position.offset +
+	                          static_cast<int64_t>(sub_mesh.vertex_offset) * position.stride;
+
+	uint64_t    index_address  = 0;
+	uint32_t    triangle_count = sub_mesh.vertices_count / 3;
+	VkIndexType index_type     = VK_INDEX_TYPE_NONE_KHR;
+
+	if (auto index_buffer = sub_mesh.get_index_buffer())
+	{
+		VkDeviceSize index_size = sub_mesh.index_type == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+
+		index_address  = index_buffer->get_device_address() + sub_mesh.index_offset + sub_mesh.first_index * index_size;
+		triangle_count = sub_mesh.vertex_indices / 3;
+		index_type     = sub_mesh.index_type;
+	}
+
+	if (triangle_count == 0)
+	{
+		return false;
+	}
+
+	// Blended and masked materials need any hit shaders
+	auto               material = sub_mesh.get_material();
+	VkGeometryFlagsKHR flags    = !material || material->alpha_mode == sg::AlphaMode::Opaque ? VK_GEOMETRY_OPAQUE_BIT_KHR : 0;
+
+	std::unique_ptr<core::Buffer> no_buffer;
+	acceleration_structure.add_triangle_geometry(no_buffer, no_buffer, no_buffer,
+	                                             triangle_count,
+	                                             sub_mesh.vertices_count - 1,
+	                                             position.stride,
+	                                             0,
+	                                             position.format,
+	                                             flags,
+	                                             vertex_address,
+	                                             index_address,
+	                                             0,
+	                                             index_type);
+
+	return true;
+}
+}        // namespace
+
+RayTracingScene::RayTracingScene(Device &device, sg::Scene &scene) :
+    device{device},
+    scene{scene}
+{
+}
+
+void RayTracingScene::build(VkQueue queue)
+{
+	bottom_level_acceleration_structures.clear();
+	instances.clear();
+
+	core::AccelerationStructureBuilder builder{device};
+
+	for (auto mesh : scene.get_components<sg::Mesh>())
+	{
+		auto acceleration_structure = std::make_unique<core::AccelerationStructure>(device, VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR);
+
+		bool has_triangles = false;
+		for (auto sub_mesh : mesh->get_submeshes())
+		{
+			has_triangles |= add_sub_mesh(*acceleration_structure, *sub_mesh);
+		}
+
+		if (!has_triangles || mesh->get_nodes().empty())
+		{
+			continue;
+		}
+
+		builder.add(*acceleration_structure);
+
+		for (auto node : mesh->get_nodes())
+		{
+			instances.push_back({node, bottom_level_acceleration_structures.size(), 0});
+		}
+
+		bottom_level_acceleration_structures.push_back(std::move(acceleration_structure));
+	}
+
+	// The instances reference the bottom-level structures once compacted
+	builder.build(queue);
+
+	// Bindings of empty buffers are not valid, the top-level structure reads no instance from it
+	instance_buffer = std::make_unique<core::Buffer>(device,
+	                                                 std::max<size_t>(instances.size(), 1) * sizeof(VkAccelerationStructureInstanceKHR),
+	                                                 VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+	                                                 VMA_MEMORY_USAGE_CPU_TO_GPU);
+	instance_buffer->set_debug_name("RayTracingScene: instance buffer");
+
+	for (uint32_t i = 0; i < instances.size(); ++i)
+	{
+		write_instance(i);
+	}
+
+	top_level_acceleration_structure = std::make_unique<core::AccelerationStructure>(device, VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR);
+	top_level_acceleration_structure->add_instance_geometry(instance_buffer, get_instance_count());
+	top_level_acceleration_structure->build(queue, TOP_LEVEL_BUILD_FLAGS);
+}
+
+uint32_t RayTracingScene::update(VkQueue queue)
+{
+	assert(top_level_acceleration_structure && "The scene must be built first");
+
+	uint32_t updated_count = 0;
+	for (uint32_t i = 0; i < instances.size(); ++i)
+	{
+		if (instances[i].transform_version != get_transform_version(*instances[i].node))
+		{
+			write_instance(i);
+			updated_count++;
+		}
+	}
+
+	if (updated_count > 0)
+	{
+		top_level_acceleration_structure->build(queue, TOP_LEVEL_BUILD_FLAGS, VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR);
+	}
+
+	return updated_count;
+}
+
+const core::AccelerationStructure &RayTracingScene::get_top_level_acceleration_structure() const
+{
+	assert(top_level_acceleration_structure && "The scene must be built first");
+	return *top_level_acceleration_structure;
+}
+
+uint32_t RayTracingScene::get_instance_count() const
+{
+	return to_u32(instances.size());
+}
+
+sg::Node &RayTracingScene::get_instance_node(uint32_t instance_index) const
+{
+	return *instances.at(instance_index).node;
+}
+
+void RayTracingScene::write_instance(uint32_t instance_index)
+{
+	auto &instance = instances[instance_index];
+
+	instance.transform_version = get_transform_version(*instance.node);
+
+	// Row major 3x4, from the column major world matrix
+	glm::mat4 world_matrix = instance.node->get_transform().get_world_matrix();
+
+	VkAccelerationStructureInstanceKHR acceleration_structure_instance{};
+	for (uint32_t row = 0; row < 3; ++row)
+	{
+		for (uint32_t column = 0; column < 4; ++column)
+		{
+			acceleration_structure_instance.transform.matrix[row][column] = world_matrix[column][row];
+		}
+	}
+	acceleration_structure_instance.instanceCustomIndex                    = instance_index;
+	acceleration_structure_instance.mask                                   = 0xFF;
+	acceleration_structure_instance.instanceShaderBindingTableRecordOffset = 0;
+	acceleration_structure_instance.flags                                  = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
+	acceleration_structure_instance.accelerationStructureReference         = bottom_level_acceleration_structures[instance.acceleration_structure_index]->get_device_address();
+
+	instance_buffer->update(&acceleration_structure_instance, sizeof(acceleration_structure_instance), instance_index * sizeof(acceleration_structure_instance));
+}
+}        // namespace vkb
@@ -0,0 +1,118 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/acceleration_structure.h"
+#include "core/buffer.h"
+
+namespace vkb
+{
+class Device;
+
+namespace sg
+{
+class Node;
+class Scene;
+}        // namespace sg
+
+/**
+ * @brief The acceleration structures of a scene graph, to ray trace any sg::Scene
+ *
+ * build() creates a bottom-level structure per sg::Mesh, with a triangle geometry per submesh, and a top-level structure
+ * with an instance per node of each mesh. The submesh geometry must be readable as a build input, see
+ * GLTFLoader::set_ray_tracing_geometry().
+ *
+ * update() refits the top-level structure to the transforms of the nodes. Only the instances whose node, or an ancestor of
+ * it, changed its transform since the last update are written, and nothing is built if no transform changed.
+ *
+ * The instance custom index is the index of the instance, see get_instance_node(). Like AccelerationStructure::build(),
+ * building submits to the queue and waits for the device, so the structures must not be in use by the device.
+ */
+class RayTracingScene
+{
+  public:
+	/**
+	 * @param device The device to build on, with VK_KHR_acceleration_structure enabled
+	 * @param scene The scene to ray trace, its meshes must not change for the lifetime of the ray tracing scene
+	 */
+	RayTracingScene(Device &device, sg::Scene &scene);
+
+	RayTracingScene(const RayTracingScene &) = delete;
+
+	RayTracingScene(RayTracingScene &&) = delete;
+
+	RayTracingScene &operator=(const RayTracingScene &) = delete;
+
+	RayTracingScene &operator=(RayTracingScene &&) = delete;
+
+	/**
+	 * @brief Builds the bottom-level structures of the meshes, compacted, then the top-level structure
+	 * @param queue Queue to use for the build process
+	 */
+	void build(VkQueue queue);
+
+	/**
+	 * @brief Refits the top-level structure to the instance transforms which changed
+	 * @param queue Queue to use for the build process
+	 * @return The number of instances updated
+	 */
+	uint32_t update(VkQueue queue);
+
+	const core::AccelerationStructure &get_top_level_acceleration_structure() const;
+
+	uint32_t get_instance_count() const;
+
+	/**
+	 * @return The node of an instance, whose index is the instance custom index
+	 */
+	sg::Node &get_instance_node(uint32_t instance_index) const;
+
+  private:
+	struct Instance
+	{
+		sg::Node *node;
+
+		/// Index of the bottom-level structure of the mesh of the node
+		size_t acceleration_structure_index;
+
+		/// Transform versions of the node and its ancestors at the last write
+		uint32_t transform_version;
+	};
+
+	/**
+	 * @brief Writes an instance to the instance buffer, with the current transform of its node
+	 */
+	void write_instance(uint32_t instance_index);
+
+	Device &device;
+
+	sg::Scene &scene;
+
+	std::vector<std::unique_ptr<core::AccelerationStructure>> bottom_level_acceleration_structures;
+
+	std::unique_ptr<core::AccelerationStructure> top_level_acceleration_structure;
+
+	std::vector<Instance> instances;
+
+	std::unique_ptr<core::Buffer> instance_buffer;
+};
+}        // namespace vkb
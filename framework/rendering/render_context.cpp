@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,12 +17,20 @@
 
 #include "render_context.h"
 
+#include "core/util/profiling.hpp"
 #include "platform/window.h"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <thread>
+
 namespace vkb
 {
 VkFormat RenderContext::DEFAULT_VK_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
 
+uint32_t RenderContext::HEADLESS_FRAME_COUNT = 1;
+
 RenderContext::RenderContext(Device                                &device,
                              VkSurfaceKHR                           surface,
                              const Window                          &window,
@@ -47,12 +55,43 @@ RenderContext::RenderContext(Device                                &device,
 			swapchain = std::make_unique<Swapchain>(device, surface, present_mode, present_mode_priority_list, surface_format_priority_list);
 		}
 	}
+
+	// Work alongside graphics goes to dedicated queue families if the device has them
+	auto get_async_queue = [&device, this](VkQueueFlagBits queue_flag) -> const Queue & {
+		uint32_t queue_family_index = device.get_queue_family_index(queue_flag);
+		return queue_family_index == queue.get_family_index() ? queue : device.get_queue(queue_family_index, 0);
+	};
+
+	compute_queue  = &get_async_queue(VK_QUEUE_COMPUTE_BIT);
+	transfer_queue = &get_async_queue(VK_QUEUE_TRANSFER_BIT);
+}
+
+RenderContext::~RenderContext()
+{
+	if (gpu_profiler)
+	{
+		device.set_gpu_profiler(nullptr);
+	}
+
+	for (auto &queue_timeline : queue_timelines)
+	{
+		vkDestroySemaphore(device.get_handle(), queue_timeline.second.first, nullptr);
+	}
+
+	// Destroyed after the stale render targets of the frames, which have views of their images
+	for (auto &replaced_swapchain : replaced_swapchains)
+	{
+		device.get_retire_queue().retire(std::move(replaced_swapchain));
+	}
 }
 
 void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create_render_target_func)
 {
 	device.wait_idle();
 
+	// The attachments created by the render target function are attributed to render targets
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
+
 	if (swapchain)
 	{
 		surface_extent = swapchain->get_extent();
@@ -72,17 +111,20 @@ void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create
 	}
 	else
 	{
-		// Otherwise, create a single RenderFrame
+		// Otherwise, create the offscreen RenderFrames
 		swapchain = nullptr;
 
-		auto color_image = core::Image{device,
-		                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
-		                               DEFAULT_VK_FORMAT,        // We can use any format here that we like
-		                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-		                               VMA_MEMORY_USAGE_GPU_ONLY};
+		for (uint32_t i = 0; i < std::max(HEADLESS_FRAME_COUNT, 1u); ++i)
+		{
+			auto color_image = core::Image{device,
+			                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
+			                               DEFAULT_VK_FORMAT,        // We can use any format here that we like
+			                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			                               VMA_MEMORY_USAGE_GPU_ONLY};
 
-		auto render_target = create_render_target_func(std::move(color_image));
-		frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			auto render_target = create_render_target_func(std::move(color_image));
+			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+		}
 	}
 
 	this->create_render_target_func = create_render_target_func;
@@ -110,11 +152,7 @@ void RenderContext::update_swapchain(const VkExtent2D &extent)
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
-
-	swapchain = std::make_unique<Swapchain>(*swapchain, extent);
-
-	recreate();
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, extent));
 }
 
 void RenderContext::update_swapchain(const uint32_t image_count)
@@ -125,13 +163,7 @@ void RenderContext::update_swapchain(const uint32_t image_count)
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
-
-	device.wait_idle();
-
-	swapchain = std::make_unique<Swapchain>(*swapchain, image_count);
-
-	recreate();
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, image_count));
 }
 
 void RenderContext::update_swapchain(const std::set<VkImageUsageFlagBits> &image_usage_flags)
@@ -142,11 +174,49 @@ void RenderContext::update_swapchain(const std::set<VkImageUsageFlagBits> &image
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, image_usage_flags));
+}
+
+bool RenderContext::is_swapchain_storage_supported() const
+{
+	if (!swapchain)
+	{
+		return false;
+	}
+
+	VkSurfaceCapabilitiesKHR surface_capabilities{};
+	VK_CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device.get_gpu().get_handle(), swapchain->get_surface(), &surface_capabilities));
 
-	swapchain = std::make_unique<Swapchain>(*swapchain, image_usage_flags);
+	const VkFormatProperties format_properties = device.get_gpu().get_format_properties(swapchain->get_format());
 
-	recreate();
+	return (surface_capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) &&
+	       (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT);
+}
+
+bool RenderContext::enable_swapchain_storage()
+{
+	if (!is_swapchain_storage_supported())
+	{
+		return false;
+	}
+
+	const VkImageUsageFlags usage = swapchain->get_usage();
+
+	if (!(usage & VK_IMAGE_USAGE_STORAGE_BIT))
+	{
+		std::set<VkImageUsageFlagBits> image_usage_flags{VK_IMAGE_USAGE_STORAGE_BIT};
+		for (uint32_t bit = 0; bit < 32; ++bit)
+		{
+			if (usage & (1u << bit))
+			{
+				image_usage_flags.insert(static_cast<VkImageUsageFlagBits>(1u << bit));
+			}
+		}
+
+		update_swapchain(image_usage_flags);
+	}
+
+	return true;
 }
 
 void RenderContext::update_swapchain(const VkExtent2D &extent, const VkSurfaceTransformFlagBitsKHR transform)
@@ -157,8 +227,6 @@ void RenderContext::update_swapchain(const VkExtent2D &extent, const VkSurfaceTr
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
-
 	auto width  = extent.width;
 	auto height = extent.height;
 	if (transform == VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR || transform == VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR)
@@ -167,12 +235,10 @@ void RenderContext::update_swapchain(const VkExtent2D &extent, const VkSurfaceTr
 		std::swap(width, height);
 	}
 
-	swapchain = std::make_unique<Swapchain>(*swapchain, VkExtent2D{width, height}, transform);
-
 	// Save the preTransform attribute for future rotations
 	pre_transform = transform;
 
-	recreate();
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, VkExtent2D{width, height}, transform));
 }
 
 void RenderContext::update_swapchain(const VkImageCompressionFlagsEXT compression, const VkImageCompressionFixedRateFlagsEXT compression_fixed_rate)
@@ -183,45 +249,116 @@ void RenderContext::update_swapchain(const VkImageCompressionFlagsEXT compressio
 		return;
 	}
 
-	device.get_resource_cache().clear_framebuffers();
-
-	swapchain = std::make_unique<Swapchain>(*swapchain, compression, compression_fixed_rate);
-
-	recreate();
+	replace_swapchain(std::make_unique<Swapchain>(*swapchain, compression, compression_fixed_rate));
 }
 
 void RenderContext::recreate()
 {
 	LOGI("Recreated swapchain");
 
-	VkExtent2D swapchain_extent = swapchain->get_extent();
-	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
+	// The captured frames render to the images of the replaced swapchain
+	if (frame_capture_state != FrameCaptureState::None)
+	{
+		LOGW("The swapchain was recreated, dropping the captured frames");
+		end_frame_capture();
+	}
 
-	auto frame_it = frames.begin();
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
 
-	for (auto &image_handle : swapchain->get_images())
-	{
-		core::Image swapchain_image{device, image_handle,
-		                            extent,
-		                            swapchain->get_format(),
-		                            swapchain->get_usage()};
+	// The render targets of the existing frames are rebuilt when the frames are next acquired,
+	// so that a resize does not build them all at once, see update_render_target()
+	size_t image_count = swapchain->get_images().size();
 
-		auto render_target = create_render_target_func(std::move(swapchain_image));
+	stale_render_targets.assign(frames.size(), false);
+	std::fill_n(stale_render_targets.begin(), std::min(frames.size(), image_count), true);
 
-		if (frame_it != frames.end())
-		{
-			(*frame_it)->update_render_target(std::move(render_target));
-		}
-		else
+	// Create new frames if the new swapchain has more images than current frames
+	while (frames.size() < image_count)
+	{
+		frames.emplace_back(std::make_unique<RenderFrame>(device, create_swapchain_render_target(to_u32(frames.size())), thread_count));
+		stale_render_targets.push_back(false);
+
+		if (resolution_controller)
 		{
-			// Create a new frame if the new swapchain has more images than current frames
-			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			frames.back()->set_scaled_render_target(create_scaled_render_target(*frames.back()));
 		}
+	}
+
+	// The replaced render targets evict their framebuffers once they are destroyed
+	device.get_resource_cache().next_generation();
+}
+
+void RenderContext::replace_swapchain(std::unique_ptr<Swapchain> &&new_swapchain)
+{
+	auto old_swapchain = std::exchange(swapchain, std::move(new_swapchain));
+
+	recreate();
+
+	// The frames in flight may still render to and present the images of the old swapchain,
+	// and the stale render targets have views of them until they are rebuilt
+	replaced_swapchains.push_back(std::move(old_swapchain));
+	retire_replaced_swapchains();
+}
+
+std::unique_ptr<RenderTarget> RenderContext::create_swapchain_render_target(uint32_t image_index)
+{
+	VkExtent2D swapchain_extent = swapchain->get_extent();
+
+	core::Image swapchain_image{device, swapchain->get_images()[image_index],
+	                            VkExtent3D{swapchain_extent.width, swapchain_extent.height, 1},
+	                            swapchain->get_format(),
+	                            swapchain->get_usage()};
+
+	return create_render_target_func(std::move(swapchain_image));
+}
+
+void RenderContext::update_render_target(uint32_t frame_index)
+{
+	if (frame_index >= stale_render_targets.size() || !stale_render_targets[frame_index])
+	{
+		return;
+	}
+
+	VKB_PROFILE_SCOPE("RenderContext::update_render_target");
+
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
+
+	// The frames retire the render targets they replace
+	auto &frame = *frames[frame_index];
+	frame.update_render_target(create_swapchain_render_target(frame_index));
+
+	if (resolution_controller)
+	{
+		frame.set_scaled_render_target(create_scaled_render_target(frame));
+	}
+
+	stale_render_targets[frame_index] = false;
+
+	retire_replaced_swapchains();
+}
+
+void RenderContext::update_render_targets()
+{
+	for (uint32_t frame_index = 0; frame_index < stale_render_targets.size(); ++frame_index)
+	{
+		update_render_target(frame_index);
+	}
+}
+
+void RenderContext::retire_replaced_swapchains()
+{
+	if (std::find(stale_render_targets.begin(), stale_render_targets.end(), true) != stale_render_targets.end())
+	{
+		return;
+	}
 
-		++frame_it;
+	// The render targets were retired first, so their views are destroyed before the images
+	for (auto &replaced_swapchain : replaced_swapchains)
+	{
+		device.get_retire_queue().retire(std::move(replaced_swapchain));
 	}
 
-	device.get_resource_cache().clear_framebuffers();
+	replaced_swapchains.clear();
 }
 
 bool RenderContext::handle_surface_changes(bool force_update)
@@ -249,9 +386,7 @@ bool RenderContext::handle_surface_changes(bool force_update)
 	    surface_properties.currentExtent.height != surface_extent.height ||
 	    force_update)
 	{
-		// Recreate swapchain
-		device.wait_idle();
-
+		// Recreate swapchain, the frames in flight keep the old one until they retired
 		update_swapchain(surface_properties.currentExtent, pre_transform);
 
 		surface_extent = surface_properties.currentExtent;
@@ -306,6 +441,8 @@ void RenderContext::submit(const std::vector<CommandBuffer *> &command_buffers)
 
 void RenderContext::begin_frame()
 {
+	VKB_PROFILE_SCOPE("RenderContext::begin_frame");
+
 	// Only handle surface changes if a swapchain exists
 	if (swapchain)
 	{
@@ -317,10 +454,19 @@ void RenderContext::begin_frame()
 	assert(active_frame_index < frames.size());
 	auto &prev_frame = *frames[active_frame_index];
 
+	// Throttle the CPU before acquiring, so that it runs at most max_frames_in_flight - 1 frames ahead of the GPU
+	while (timeline_frame_sync && frames_in_flight.size() >= max_frames_in_flight)
+	{
+		wait_timeline_values(frames_in_flight.front());
+		frames_in_flight.pop_front();
+	}
+
 	// We will use the acquired semaphore in a different frame context,
 	// so we need to hold ownership.
 	acquired_semaphore = prev_frame.request_semaphore_with_ownership();
 
+	acquire_begin_time = profiling::now();
+
 	if (swapchain)
 	{
 		auto result = swapchain->acquire_next_image(active_frame_index, acquired_semaphore, VK_NULL_HANDLE);
@@ -341,182 +487,1060 @@ void RenderContext::begin_frame()
 			return;
 		}
 	}
+	else
+	{
+		// Without a swapchain to pick the next image, the offscreen frames are used in turn
+		active_frame_index = (active_frame_index + 1) % to_u32(frames.size());
+	}
+
+	acquire_end_time = profiling::now();
 
 	// Now the frame is active again
 	frame_active = true;
 
+	if (frame_capture_state == FrameCaptureState::Capturing)
+	{
+		// A frame captured before is recorded again, so it is first reset as usual
+		get_active_frame().set_replayable(false);
+		captured_frames[active_frame_index] = false;
+		captured_submissions[active_frame_index].clear();
+	}
+
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
-}
-
-VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
-{
-	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
-	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
-	RenderFrame &frame = get_active_frame();
-
-	VkSemaphore signal_semaphore = frame.request_semaphore();
-
-	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-
-	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
-	submit_info.pCommandBuffers    = cmd_buf_handles.data();
-
-	if (wait_semaphore != VK_NULL_HANDLE)
+	if (frame_capture_state == FrameCaptureState::Capturing)
 	{
-		submit_info.waitSemaphoreCount = 1;
-		submit_info.pWaitSemaphores    = &wait_semaphore;
-		submit_info.pWaitDstStageMask  = &wait_pipeline_stage;
+		get_active_frame().set_replayable(true);
 	}
 
-	submit_info.signalSemaphoreCount = 1;
-	submit_info.pSignalSemaphores    = &signal_semaphore;
-
-	VkFence fence = frame.request_fence();
-
-	queue.submit({submit_info}, fence);
+	// Once every frame was waited for, the resources released before them are no longer in use,
+	// unless the captured frames still use them
+	if (frame_capture_state == FrameCaptureState::None)
+	{
+		device.get_transient_resource_pool().next_frame(to_u32(frames.size()));
+		device.get_retire_queue().next_frame(to_u32(frames.size()));
+	}
 
-	return signal_semaphore;
-}
+	// A frame acquired for the first time since the swapchain was replaced gets its new render target
+	update_render_target(active_frame_index);
 
-void RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers)
-{
-	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
-	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
+	// The timestamps of the frame are available once it retired
+	double retired_gpu_frame_time{0.0};
+	if (gpu_timestamp_pool && active_frame_index < gpu_timestamps_written.size() && gpu_timestamps_written[active_frame_index])
+	{
+		std::array<uint64_t, 2> timestamps{};
 
-	RenderFrame &frame = get_active_frame();
+		if (gpu_timestamp_pool->get_results(active_frame_index * 2, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			gpu_frame_time = retired_gpu_frame_time = static_cast<double>(timestamps[1] - timestamps[0]) * device.get_gpu().get_properties().limits.timestampPeriod * 1e-9;
 
-	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+			if (frame_timeline)
+			{
+				frame_timeline->retire_frame(active_frame_index, timestamps[0], timestamps[1]);
+			}
+		}
 
-	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
-	submit_info.pCommandBuffers    = cmd_buf_handles.data();
+		gpu_timestamps_written[active_frame_index] = false;
+	}
 
-	VkFence fence = frame.request_fence();
+	if (frame_timeline)
+	{
+		frame_timeline->begin_frame(active_frame_index, acquire_begin_time, acquire_end_time);
+	}
 
-	queue.submit({submit_info}, fence);
-}
+	// Nothing is recorded yet, and an idle GPU has time for the copies of a pass
+	if (frame_capture_state == FrameCaptureState::None && memory_defragmenter && retired_gpu_frame_time > 0.0 && retired_gpu_frame_time < defragmentation_idle_gpu_time && memory_defragmenter->is_needed())
+	{
+		VKB_PROFILE_SCOPE("RenderContext::defragment_memory");
 
-void RenderContext::wait_frame()
-{
-	RenderFrame &frame = get_active_frame();
-	frame.reset();
-}
+		device.wait_idle();
 
-void RenderContext::end_frame(VkSemaphore semaphore)
-{
-	assert(frame_active && "Frame is not active, please call begin_frame");
+		if (memory_defragmenter->run_pass() > 0)
+		{
+			// The descriptor sets of the frames may refer to the destroyed image views, whose handles can be reused
+			for (auto &frame : frames)
+			{
+				frame->clear_descriptors();
+			}
+		}
+	}
 
-	if (swapchain)
+	if (gpu_profiler)
 	{
-		VkSwapchainKHR vk_swapchain = swapchain->get_handle();
-
-		VkPresentInfoKHR present_info{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
-
-		present_info.waitSemaphoreCount = 1;
-		present_info.pWaitSemaphores    = &semaphore;
-		present_info.swapchainCount     = 1;
-		present_info.pSwapchains        = &vk_swapchain;
-		present_info.pImageIndices      = &active_frame_index;
+		gpu_profiler->begin_frame(active_frame_index);
 
-		VkDisplayPresentInfoKHR disp_present_info{};
-		if (device.is_extension_supported(VK_KHR_DISPLAY_SWAPCHAIN_EXTENSION_NAME) &&
-		    window.get_display_present_info(&disp_present_info, surface_extent.width, surface_extent.height))
+		if (shading_rate_controller)
 		{
-			// Add display present info if supported and wanted
-			present_info.pNext = &disp_present_info;
+			shading_rate_controller->update(*gpu_profiler);
 		}
 
-		VkResult result = queue.present(present_info);
-
-		if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
+		if (resolution_controller)
 		{
-			handle_surface_changes();
+			resolution_controller->update(*gpu_profiler);
 		}
 	}
 
-	// Frame is not active anymore
-	if (acquired_semaphore)
+	if (auto *scaled_render_target = get_active_frame().get_scaled_render_target())
 	{
-		release_owned_semaphore(acquired_semaphore);
-		acquired_semaphore = VK_NULL_HANDLE;
+		scaled_render_target->set_render_extent(resolution_controller->get_render_extent(scaled_render_target->get_extent()));
 	}
-	frame_active = false;
-}
 
-VkSemaphore RenderContext::consume_acquired_semaphore()
-{
-	assert(frame_active && "Frame is not active, please call begin_frame");
-	auto sem           = acquired_semaphore;
-	acquired_semaphore = VK_NULL_HANDLE;
-	return sem;
+	// No command buffers are being recorded, so pipelines and shaders compiled in the background can be swapped in,
+	// unless the captured frames still use the ones they replace
+	if (frame_capture_state == FrameCaptureState::None)
+	{
+		device.get_resource_cache().update_optimized_pipelines();
+		device.get_resource_cache().update_shader_hot_reload();
+	}
 }
 
-RenderFrame &RenderContext::get_active_frame()
+VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
 {
-	assert(frame_active && "Frame is not active, please call begin_frame");
-	assert(active_frame_index < frames.size());
-	return *frames[active_frame_index];
-}
+	VkSemaphore signal_semaphore = get_active_frame().request_semaphore();
 
-uint32_t RenderContext::get_active_frame_index()
-{
-	assert(frame_active && "Frame is not active, please call begin_frame");
-	return active_frame_index;
-}
+	if (wait_semaphore != VK_NULL_HANDLE)
+	{
+		submit_to_queue(queue, command_buffers, {wait_semaphore}, {wait_pipeline_stage}, signal_semaphore);
+	}
+	else
+	{
+		submit_to_queue(queue, command_buffers, {}, {}, signal_semaphore);
+	}
 
-RenderFrame &RenderContext::get_last_rendered_frame()
-{
-	assert(!frame_active && "Frame is still active, please call end_frame");
-	assert(active_frame_index < frames.size());
-	return *frames[active_frame_index];
+	return signal_semaphore;
 }
 
-VkSemaphore RenderContext::request_semaphore()
+void RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers)
 {
-	RenderFrame &frame = get_active_frame();
-	return frame.request_semaphore();
+	submit_to_queue(queue, command_buffers, {}, {}, VK_NULL_HANDLE);
 }
 
-VkSemaphore RenderContext::request_semaphore_with_ownership()
+void RenderContext::submit_chained(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, const Queue &wait_queue, VkPipelineStageFlags wait_stages)
 {
-	RenderFrame &frame = get_active_frame();
-	return frame.request_semaphore_with_ownership();
-}
+	VkSemaphore signal_semaphore = get_active_frame().request_semaphore();
 
-void RenderContext::release_owned_semaphore(VkSemaphore semaphore)
-{
-	RenderFrame &frame = get_active_frame();
-	frame.release_owned_semaphore(semaphore);
-}
+	submit_to_queue(queue, command_buffers, {}, {}, signal_semaphore);
 
-Device &RenderContext::get_device()
-{
-	return device;
+	chained_waits[&wait_queue].emplace_back(signal_semaphore, wait_stages);
 }
 
-void RenderContext::recreate_swapchain()
+void RenderContext::submit_to_queue(const Queue                        &queue,
+                                    const std::vector<CommandBuffer *> &command_buffers,
+                                    std::vector<VkSemaphore>            wait_semaphores,
+                                    std::vector<VkPipelineStageFlags>   wait_stages,
+                                    VkSemaphore                         signal_semaphore)
 {
-	device.wait_idle();
-	device.get_resource_cache().clear_framebuffers();
-
-	VkExtent2D swapchain_extent = swapchain->get_extent();
-	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
-
-	auto frame_it = frames.begin();
+	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
+	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
-	for (auto &image_handle : swapchain->get_images())
+	// Timestamps are written when the commands submitted before them reach the stage, so they bracket the frame submissions
+	if (gpu_timestamp_pool && &queue == &this->queue && !command_buffers.empty() && active_frame_index < gpu_timestamps_written.size())
 	{
-		core::Image swapchain_image{device, image_handle,
-		                            extent,
-		                            swapchain->get_format(),
-		                            swapchain->get_usage()};
+		auto reset_mode = command_buffers[0]->get_command_pool().get_reset_mode();
 
-		auto render_target = create_render_target_func(std::move(swapchain_image));
-		(*frame_it)->update_render_target(std::move(render_target));
+		if (!gpu_timestamps_written[active_frame_index])
+		{
+			if (frame_timeline)
+			{
+				frame_timeline->submit(active_frame_index, profiling::now());
+			}
+
+			auto &start_command_buffer = record_gpu_timestamp(queue, reset_mode, active_frame_index * 2, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+			cmd_buf_handles.insert(cmd_buf_handles.begin(), start_command_buffer.get_handle());
+
+			gpu_timestamps_written[active_frame_index] = true;
+		}
+
+		auto &end_command_buffer = record_gpu_timestamp(queue, reset_mode, active_frame_index * 2 + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+		cmd_buf_handles.push_back(end_command_buffer.get_handle());
+	}
+
+	// The queries of the profiled scopes are reset before the first submission of the frame runs
+	if (gpu_profiler && &queue == &this->queue && !command_buffers.empty() && gpu_profiler->needs_reset())
+	{
+		auto &reset_command_buffer = get_active_frame().request_command_buffer(queue, command_buffers[0]->get_command_pool().get_reset_mode());
+
+		reset_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		gpu_profiler->record_reset(reset_command_buffer);
+		reset_command_buffer.end();
+
+		cmd_buf_handles.insert(cmd_buf_handles.begin(), reset_command_buffer.get_handle());
+	}
+
+	// Frames are replayed with a single submission to the graphics queue
+	if (frame_capture_state == FrameCaptureState::Capturing && frame_active)
+	{
+		if (&queue != &this->queue)
+		{
+			LOGW("A frame was submitted to another queue than the graphics one, the frames are not captured");
+			end_frame_capture();
+		}
+		else
+		{
+			auto &submissions = captured_submissions[active_frame_index];
+			submissions.insert(submissions.end(), cmd_buf_handles.begin(), cmd_buf_handles.end());
+		}
+	}
+
+	submit_handles_to_queue(queue, cmd_buf_handles, std::move(wait_semaphores), std::move(wait_stages), signal_semaphore);
+}
+
+void RenderContext::submit_handles_to_queue(const Queue                        &queue,
+                                            const std::vector<VkCommandBuffer> &cmd_buf_handles,
+                                            std::vector<VkSemaphore>            wait_semaphores,
+                                            std::vector<VkPipelineStageFlags>   wait_stages,
+                                            VkSemaphore                         signal_semaphore)
+{
+	RenderFrame &frame = get_active_frame();
+
+	auto chained_waits_it = chained_waits.find(&queue);
+	if (chained_waits_it != chained_waits.end())
+	{
+		for (auto &chained_wait : chained_waits_it->second)
+		{
+			wait_semaphores.push_back(chained_wait.first);
+			wait_stages.push_back(chained_wait.second);
+		}
+		chained_waits.erase(chained_waits_it);
+	}
+
+	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+
+	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
+	submit_info.pCommandBuffers    = cmd_buf_handles.data();
+	submit_info.waitSemaphoreCount = to_u32(wait_semaphores.size());
+	submit_info.pWaitSemaphores    = wait_semaphores.data();
+	submit_info.pWaitDstStageMask  = wait_stages.data();
+
+	std::vector<VkSemaphore> signal_semaphores;
+	std::vector<uint64_t>    signal_values;
+
+	if (signal_semaphore != VK_NULL_HANDLE)
+	{
+		signal_semaphores.push_back(signal_semaphore);
+		signal_values.push_back(0);
+	}
+
+	VkTimelineSemaphoreSubmitInfoKHR timeline_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+	VkFence                          fence = VK_NULL_HANDLE;
+
+	if (timeline_frame_sync)
+	{
+		// The values of the binary semaphores are ignored
+		auto timeline = next_timeline_value(queue);
+		signal_semaphores.push_back(timeline.first);
+		signal_values.push_back(timeline.second);
+
+		timeline_info.signalSemaphoreValueCount = to_u32(signal_values.size());
+		timeline_info.pSignalSemaphoreValues    = signal_values.data();
+		submit_info.pNext                       = &timeline_info;
+	}
+	else
+	{
+		fence = frame.request_fence();
+	}
+
+	submit_info.signalSemaphoreCount = to_u32(signal_semaphores.size());
+	submit_info.pSignalSemaphores    = signal_semaphores.data();
+
+	// Without a swapchain the frames alternate between the GPUs of a device group
+	VkDeviceGroupSubmitInfoKHR device_group_info{VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR};
+	std::vector<uint32_t>      wait_device_indices;
+	std::vector<uint32_t>      command_buffer_device_masks;
+	std::vector<uint32_t>      signal_device_indices;
+
+	if (!swapchain && device.get_device_group_size() > 1)
+	{
+		uint32_t device_index = active_frame_index % device.get_device_group_size();
+
+		wait_device_indices.assign(wait_semaphores.size(), device_index);
+		command_buffer_device_masks.assign(cmd_buf_handles.size(), get_frame_device_mask());
+		signal_device_indices.assign(signal_semaphores.size(), device_index);
+
+		device_group_info.waitSemaphoreCount            = to_u32(wait_device_indices.size());
+		device_group_info.pWaitSemaphoreDeviceIndices   = wait_device_indices.data();
+		device_group_info.commandBufferCount            = to_u32(command_buffer_device_masks.size());
+		device_group_info.pCommandBufferDeviceMasks     = command_buffer_device_masks.data();
+		device_group_info.signalSemaphoreCount          = to_u32(signal_device_indices.size());
+		device_group_info.pSignalSemaphoreDeviceIndices = signal_device_indices.data();
+		device_group_info.pNext                         = submit_info.pNext;
+		submit_info.pNext                               = &device_group_info;
+	}
+
+	queue.submit({submit_info}, fence);
+}
+
+uint32_t RenderContext::get_frame_device_mask() const
+{
+	if (swapchain || device.get_device_group_size() <= 1)
+	{
+		return 1u;
+	}
+
+	return 1u << (active_frame_index % device.get_device_group_size());
+}
+
+CommandBuffer &RenderContext::request_command_buffer(const Queue &queue, CommandBuffer::ResetMode reset_mode)
+{
+	return get_active_frame().request_command_buffer(queue, reset_mode);
+}
+
+const Queue &RenderContext::get_graphics_queue() const
+{
+	return queue;
+}
+
+const Queue &RenderContext::get_compute_queue() const
+{
+	return *compute_queue;
+}
+
+const Queue &RenderContext::get_transfer_queue() const
+{
+	return *transfer_queue;
+}
+
+bool RenderContext::has_async_compute() const
+{
+	return compute_queue->get_family_index() != queue.get_family_index();
+}
+
+void RenderContext::wait_frame()
+{
+	RenderFrame &frame = get_active_frame();
+
+	if (active_frame_index < frame_timeline_values.size())
+	{
+		wait_timeline_values(frame_timeline_values[active_frame_index]);
+		frame_timeline_values[active_frame_index].clear();
+	}
+
+	frame.reset();
+}
+
+void RenderContext::set_timeline_frame_sync(bool enable, uint32_t new_max_frames_in_flight)
+{
+	assert(!frame_active && "Frame is still active, please call end_frame");
+
+	if (enable && !device.uses_timeline_semaphores())
+	{
+		LOGW("Timeline semaphores are not enabled on the device, keeping fence frame sync.");
+		return;
+	}
+
+	if (enable != timeline_frame_sync)
+	{
+		// Submissions tracked one way are not waited for the other way
+		device.wait_idle();
+
+		frame_timeline_values.clear();
+		frames_in_flight.clear();
+	}
+
+	timeline_frame_sync  = enable;
+	max_frames_in_flight = std::max(new_max_frames_in_flight, 1u);
+}
+
+bool RenderContext::uses_timeline_frame_sync() const
+{
+	return timeline_frame_sync;
+}
+
+std::pair<VkSemaphore, uint64_t> RenderContext::next_timeline_value(const Queue &queue)
+{
+	auto it = queue_timelines.find(&queue);
+
+	if (it == queue_timelines.end())
+	{
+		VkSemaphoreTypeCreateInfoKHR type_info{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR};
+		type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+
+		VkSemaphoreCreateInfo create_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+		create_info.pNext = &type_info;
+
+		VkSemaphore semaphore{VK_NULL_HANDLE};
+		VK_CHECK(vkCreateSemaphore(device.get_handle(), &create_info, nullptr, &semaphore));
+
+		it = queue_timelines.emplace(&queue, std::make_pair(semaphore, uint64_t{0})).first;
+	}
+
+	auto &timeline = it->second;
+	++timeline.second;
+
+	if (frame_timeline_values.size() < frames.size())
+	{
+		frame_timeline_values.resize(frames.size());
+	}
+	frame_timeline_values[active_frame_index][timeline.first] = timeline.second;
+
+	return timeline;
+}
+
+void RenderContext::wait_timeline_values(const TimelineValues &values)
+{
+	if (values.empty())
+	{
+		return;
+	}
+
+	std::vector<VkSemaphore> semaphores;
+	std::vector<uint64_t>    semaphore_values;
+
+	for (auto &value : values)
+	{
+		semaphores.push_back(value.first);
+		semaphore_values.push_back(value.second);
+	}
+
+	VkSemaphoreWaitInfoKHR wait_info{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR};
+	wait_info.semaphoreCount = to_u32(semaphores.size());
+	wait_info.pSemaphores    = semaphores.data();
+	wait_info.pValues        = semaphore_values.data();
+
+	// Returns right away for frames the GPU already retired
+	VK_CHECK(vkWaitSemaphoresKHR(device.get_handle(), &wait_info, std::numeric_limits<uint64_t>::max()));
+}
+
+void RenderContext::end_frame(VkSemaphore semaphore)
+{
+	VKB_PROFILE_SCOPE("RenderContext::end_frame");
+
+	assert(frame_active && "Frame is not active, please call begin_frame");
+
+	if (swapchain)
+	{
+		VkSwapchainKHR vk_swapchain = swapchain->get_handle();
+
+		VkPresentInfoKHR present_info{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+
+		present_info.waitSemaphoreCount = 1;
+		present_info.pWaitSemaphores    = &semaphore;
+		present_info.swapchainCount     = 1;
+		present_info.pSwapchains        = &vk_swapchain;
+		present_info.pImageIndices      = &active_frame_index;
+
+		VkDisplayPresentInfoKHR disp_present_info{};
+		if (device.is_extension_supported(VK_KHR_DISPLAY_SWAPCHAIN_EXTENSION_NAME) &&
+		    window.get_display_present_info(&disp_present_info, surface_extent.width, surface_extent.height))
+		{
+			// Add display present info if supported and wanted
+			present_info.pNext = &disp_present_info;
+		}
+
+		VkPresentIdKHR present_id_info{VK_STRUCTURE_TYPE_PRESENT_ID_KHR};
+		if (low_latency_mode)
+		{
+			// Present identifiers only increase within a swapchain
+			if (present_wait_swapchain != vk_swapchain)
+			{
+				present_wait_swapchain = vk_swapchain;
+				present_id             = 0;
+				present_input_times.clear();
+				last_present_time = {};
+			}
+
+			present_input_times.push_back({++present_id, frame_input_time, frame_event_time});
+			frame_event_time = {};
+
+			present_id_info.pNext          = present_info.pNext;
+			present_id_info.swapchainCount = 1;
+			present_id_info.pPresentIds    = &present_id;
+			present_info.pNext             = &present_id_info;
+		}
+
+		// Without present wait, FIFO presents are paced by the window if it can, e.g. with the Choreographer on Android
+		if (!low_latency_mode && window.paces_presents())
+		{
+			VkPresentModeKHR present_mode = swapchain->get_present_mode();
+			if (present_mode == VK_PRESENT_MODE_FIFO_KHR || present_mode == VK_PRESENT_MODE_FIFO_RELAXED_KHR)
+			{
+				window.pace_present();
+				record_paced_present();
+			}
+		}
+
+		uint64_t present_begin_time = profiling::now();
+
+		VkResult result = queue.present(present_info);
+
+		if (frame_timeline)
+		{
+			frame_timeline->present(active_frame_index, present_begin_time, profiling::now());
+		}
+
+		if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
+		{
+			handle_surface_changes();
+		}
+	}
+
+	// The frame semaphores are reused once the frame retired, so each one must have been waited for
+	assert(chained_waits.empty() && "A chained submission was not waited for in the frame");
+
+	if (timeline_frame_sync && active_frame_index < frame_timeline_values.size())
+	{
+		frames_in_flight.push_back(frame_timeline_values[active_frame_index]);
+	}
+
+	if (frame_capture_state == FrameCaptureState::Capturing)
+	{
+		captured_frames[active_frame_index] = true;
+
+		if (std::all_of(captured_frames.begin(), captured_frames.end(), [](bool captured) { return captured; }))
+		{
+			LOGI("Captured {} frames for replay", captured_frames.size());
+			frame_capture_state = FrameCaptureState::Captured;
+		}
+	}
+
+	// Frame is not active anymore
+	if (acquired_semaphore)
+	{
+		release_owned_semaphore(acquired_semaphore);
+		acquired_semaphore = VK_NULL_HANDLE;
+	}
+	frame_active = false;
+
+	if (low_latency_mode)
+	{
+		pace_frame();
+	}
+}
+
+bool RenderContext::set_low_latency_mode(bool enable, std::chrono::microseconds new_target_latency)
+{
+	if (enable && (!swapchain || !device.uses_present_wait()))
+	{
+		LOGW("Present wait is not enabled on the device, the low latency mode is not available.");
+		return false;
+	}
+
+	low_latency_mode = enable;
+	target_latency   = new_target_latency;
+
+	present_wait_swapchain = VK_NULL_HANDLE;
+	present_latencies      = {};
+	present_interval       = 0.0;
+	last_present_time      = {};
+	frame_input_time       = std::chrono::steady_clock::now();
+
+	return low_latency_mode;
+}
+
+bool RenderContext::uses_low_latency_mode() const
+{
+	return low_latency_mode;
+}
+
+void RenderContext::set_frame_input_time(std::chrono::steady_clock::time_point sample_time, std::chrono::steady_clock::time_point event_time)
+{
+	frame_input_time = sample_time;
+	frame_event_time = event_time;
+}
+
+RenderContext::PresentLatencies RenderContext::take_present_latencies()
+{
+	return std::exchange(present_latencies, {});
+}
+
+const Window &RenderContext::get_window() const
+{
+	return window;
+}
+
+void RenderContext::set_gpu_frame_timing(bool enable)
+{
+	assert(!frame_active && "Frame is still active, please call end_frame");
+
+	if (!enable)
+	{
+		// The frames in flight may still write to the pool
+		device.get_retire_queue().retire(std::move(gpu_timestamp_pool));
+		gpu_timestamps_written.clear();
+		gpu_frame_time = 0.0;
+		frame_timeline.reset();
+		return;
+	}
+
+	if (!device.get_gpu().get_properties().limits.timestampComputeAndGraphics)
+	{
+		LOGW("Timestamps are not supported by the graphics queue, the GPU frame times are not measured.");
+		return;
+	}
+
+	// There may be more frames after the swapchain is recreated, those are not measured
+	if (!gpu_timestamp_pool)
+	{
+		VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+		query_pool_info.queryCount = to_u32(frames.size() * 2);
+
+		gpu_timestamp_pool = std::make_unique<QueryPool>(device, query_pool_info);
+		gpu_timestamps_written.assign(frames.size(), false);
+	}
+}
+
+double RenderContext::take_gpu_frame_time()
+{
+	return std::exchange(gpu_frame_time, 0.0);
+}
+
+void RenderContext::begin_frame_capture()
+{
+	assert(!frame_active && "Frames are captured from the next one, please call end_frame");
+
+	end_frame_capture();
+
+	frame_capture_state     = FrameCaptureState::Capturing;
+	captured_gpu_timestamps = gpu_timestamp_pool != nullptr;
+	captured_submissions.assign(frames.size(), {});
+	captured_frames.assign(frames.size(), false);
+}
+
+bool RenderContext::is_capturing_frames() const
+{
+	return frame_capture_state == FrameCaptureState::Capturing;
+}
+
+bool RenderContext::has_frame_capture() const
+{
+	return frame_capture_state == FrameCaptureState::Captured;
+}
+
+bool RenderContext::replay_frame()
+{
+	assert(has_frame_capture() && "No frames were captured, please call begin_frame_capture");
+
+	begin_frame();
+
+	if (acquired_semaphore == VK_NULL_HANDLE)
+	{
+		throw std::runtime_error("Couldn't begin frame");
+	}
 
-		++frame_it;
+	if (!has_frame_capture())
+	{
+		return false;
+	}
+
+	uint64_t submit_begin_time = profiling::now();
+
+	// The captured command buffers write the timestamps again
+	if (captured_gpu_timestamps && gpu_timestamp_pool && active_frame_index < gpu_timestamps_written.size())
+	{
+		if (frame_timeline)
+		{
+			frame_timeline->submit(active_frame_index, submit_begin_time);
+		}
+
+		gpu_timestamps_written[active_frame_index] = true;
+	}
+
+	VkSemaphore render_semaphore = VK_NULL_HANDLE;
+
+	if (swapchain)
+	{
+		render_semaphore = get_active_frame().request_semaphore();
+		submit_handles_to_queue(queue, captured_submissions[active_frame_index], {acquired_semaphore}, {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT}, render_semaphore);
+	}
+	else
+	{
+		submit_handles_to_queue(queue, captured_submissions[active_frame_index], {}, {}, VK_NULL_HANDLE);
+	}
+
+	end_frame(render_semaphore);
+
+	replay_submit_time = static_cast<double>(profiling::now() - submit_begin_time) * 1e-9;
+
+	return true;
+}
+
+double RenderContext::get_replay_submit_time() const
+{
+	return replay_submit_time;
+}
+
+void RenderContext::end_frame_capture()
+{
+	for (auto &frame : frames)
+	{
+		frame->set_replayable(false);
+	}
+
+	frame_capture_state = FrameCaptureState::None;
+	captured_submissions.clear();
+	captured_frames.clear();
+}
+
+bool RenderContext::set_frame_timeline(bool enable)
+{
+	if (!enable)
+	{
+		frame_timeline.reset();
+		return false;
+	}
+
+	if (!FrameTimeline::is_supported(device))
+	{
+		LOGW("VK_EXT_calibrated_timestamps is not enabled on the device, the frame timeline is not available.");
+		return false;
+	}
+
+	set_gpu_frame_timing(true);
+
+	if (!gpu_timestamp_pool)
+	{
+		return false;
+	}
+
+	if (!frame_timeline)
+	{
+		frame_timeline = std::make_unique<FrameTimeline>(device, to_u32(frames.size()));
+	}
+
+	return true;
+}
+
+FrameTimeline::Measurements RenderContext::take_frame_timeline_measurements()
+{
+	return frame_timeline ? frame_timeline->take_measurements() : FrameTimeline::Measurements{};
+}
+
+void RenderContext::set_gpu_profiling(bool enable)
+{
+	assert(!frame_active && "Frame is still active, please call end_frame");
+
+	if (!enable)
+	{
+		// The frames in flight may still write to the pools of the profiler
+		if (gpu_profiler)
+		{
+			device.set_gpu_profiler(nullptr);
+		}
+
+		device.get_retire_queue().retire(std::move(gpu_profiler));
+		return;
+	}
+
+	if (!device.get_gpu().get_properties().limits.timestampComputeAndGraphics)
+	{
+		LOGW("Timestamps are not supported by the graphics queue, the GPU scopes are not measured.");
+		return;
+	}
+
+	// There may be more frames after the swapchain is recreated, those are not measured
+	if (!gpu_profiler)
+	{
+		gpu_profiler = std::make_unique<GpuProfiler>(device, to_u32(frames.size()), GpuProfiler::DEFAULT_MAX_SCOPES, GpuProfiler::DEFAULT_MAX_DEPTH,
+		                                             gpu_pipeline_statistics);
+		device.set_gpu_profiler(gpu_profiler.get());
+	}
+}
+
+void RenderContext::set_gpu_pipeline_statistics(bool enable)
+{
+	assert(!frame_active && "Frame is still active, please call end_frame");
+
+	auto &features = device.get_gpu().get_requested_features();
+	if (enable && (!features.pipelineStatisticsQuery || !features.inheritedQueries))
+	{
+		LOGW("The pipelineStatisticsQuery and inheritedQueries features are not enabled, the pipeline statistics are not counted.");
+		enable = false;
+	}
+
+	bool profiling = gpu_profiler != nullptr;
+
+	// The query pools of the profiler are created with it
+	if (profiling && enable != gpu_pipeline_statistics)
+	{
+		set_gpu_profiling(false);
+	}
+
+	gpu_pipeline_statistics = enable;
+
+	if (profiling || enable)
+	{
+		set_gpu_profiling(true);
+	}
+}
+
+const GpuProfiler *RenderContext::get_gpu_profiler() const
+{
+	return gpu_profiler.get();
+}
+
+void RenderContext::set_memory_defragmentation(double idle_gpu_time, VkDeviceSize max_bytes_per_pass)
+{
+	if (idle_gpu_time <= 0.0)
+	{
+		memory_defragmenter.reset();
+		return;
+	}
+
+	set_gpu_frame_timing(true);
+
+	defragmentation_idle_gpu_time = idle_gpu_time;
+	memory_defragmenter           = std::make_unique<MemoryDefragmenter>(device, allocated::MemoryTag::SceneTexture, max_bytes_per_pass, std::numeric_limits<uint32_t>::max());
+}
+
+const MemoryDefragmenter *RenderContext::get_memory_defragmenter() const
+{
+	return memory_defragmenter.get();
+}
+
+void RenderContext::set_shading_rate_target(double target_gpu_time)
+{
+	if (target_gpu_time <= 0.0)
+	{
+		shading_rate_controller.reset();
+		return;
+	}
+
+	if (!device.uses_fragment_shading_rates())
+	{
+		LOGW("Fragment shading rates are not used by the device, the shading rate is not adapted.");
+		return;
+	}
+
+	set_gpu_profiling(true);
+
+	if (!shading_rate_controller)
+	{
+		shading_rate_controller = std::make_unique<ShadingRateController>(device, target_gpu_time);
+	}
+	else
+	{
+		shading_rate_controller->set_target_gpu_time(target_gpu_time);
+	}
+}
+
+ShadingRateController *RenderContext::get_shading_rate_controller()
+{
+	return shading_rate_controller.get();
+}
+
+VkExtent2D RenderContext::get_fragment_shading_rate() const
+{
+	return shading_rate_controller ? shading_rate_controller->get_rate() : VkExtent2D{1, 1};
+}
+
+void RenderContext::set_resolution_target(double target_gpu_time, float min_scale)
+{
+	if (target_gpu_time <= 0.0)
+	{
+		if (resolution_controller)
+		{
+			resolution_controller.reset();
+			update_scaled_render_targets();
+		}
+		return;
+	}
+
+	set_gpu_profiling(true);
+
+	if (!resolution_controller)
+	{
+		resolution_controller = std::make_unique<ResolutionController>(target_gpu_time, min_scale);
+		update_scaled_render_targets();
+	}
+	else
+	{
+		resolution_controller->set_target_gpu_time(target_gpu_time);
+		resolution_controller->set_min_scale(min_scale);
+	}
+}
+
+ResolutionController *RenderContext::get_resolution_controller()
+{
+	return resolution_controller.get();
+}
+
+void RenderContext::set_projection_jitter(const glm::vec2 &jitter)
+{
+	projection_jitter = jitter;
+}
+
+const glm::vec2 &RenderContext::get_projection_jitter() const
+{
+	return projection_jitter;
+}
+
+void RenderContext::update_scaled_render_targets()
+{
+	// The scaled render targets take the extent of the render targets, which must be up to date
+	update_render_targets();
+
+	// A previous frame may still render to the targets, the frames retire them
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
+
+	for (auto &frame : frames)
+	{
+		frame->set_scaled_render_target(resolution_controller ? create_scaled_render_target(*frame) : nullptr);
+	}
+}
+
+std::unique_ptr<RenderTarget> RenderContext::create_scaled_render_target(RenderFrame &frame)
+{
+	// The scene is rendered to the first image, then sampled to upscale it to the swapchain image
+	const auto &extent = frame.get_render_target().get_extent();
+	core::Image color_image{device,
+	                        VkExtent3D{extent.width, extent.height, 1},
+	                        get_format(),
+	                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+	                        VMA_MEMORY_USAGE_GPU_ONLY};
+
+	return create_render_target_func(std::move(color_image));
+}
+
+CommandBuffer &RenderContext::record_gpu_timestamp(const Queue &queue, CommandBuffer::ResetMode reset_mode, uint32_t query, VkPipelineStageFlagBits pipeline_stage)
+{
+	auto &command_buffer = get_active_frame().request_command_buffer(queue, reset_mode);
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	command_buffer.reset_query_pool(*gpu_timestamp_pool, query, 1);
+	command_buffer.write_timestamp(pipeline_stage, *gpu_timestamp_pool, query);
+	command_buffer.end();
+
+	return command_buffer;
+}
+
+void RenderContext::record_paced_present()
+{
+	// Paced presents are due on a vsync, so the intervals between them are the intervals they are displayed at
+	auto now = std::chrono::steady_clock::now();
+
+	if (last_present_time != std::chrono::steady_clock::time_point{})
+	{
+		present_latencies.present_intervals += std::chrono::duration<double>(now - last_present_time).count();
+		present_latencies.present_interval_count++;
+	}
+	last_present_time = now;
+}
+
+void RenderContext::pace_frame()
+{
+	// The swapchain may have been recreated since the present, its identifiers are gone with it
+	if (!swapchain || swapchain->get_handle() != present_wait_swapchain || present_id < 2)
+	{
+		frame_input_time = std::chrono::steady_clock::now();
+		return;
+	}
+
+	// Waiting for the previous present leaves at most one frame queued, the one just presented
+	uint64_t wait_id = present_id - 1;
+	VkResult result  = vkWaitForPresentKHR(device.get_handle(), present_wait_swapchain, wait_id, PRESENT_WAIT_TIMEOUT);
+
+	auto now = std::chrono::steady_clock::now();
+
+	// Minimized windows and out of date swapchains time out or fail, the frames are not paced then
+	if (result != VK_SUCCESS)
+	{
+		frame_input_time = now;
+		return;
+	}
+
+	while (!present_input_times.empty() && present_input_times.front().present_id <= wait_id)
+	{
+		auto &input_time = present_input_times.front();
+		if (input_time.present_id == wait_id)
+		{
+			present_latencies.input_to_photon_latencies += std::chrono::duration<double>(now - input_time.sample_time).count();
+			present_latencies.input_to_photon_latency_count++;
+
+			if (input_time.event_time != std::chrono::steady_clock::time_point{})
+			{
+				present_latencies.event_to_photon_latencies += std::chrono::duration<double>(now - input_time.event_time).count();
+				present_latencies.event_to_photon_latency_count++;
+			}
+		}
+		present_input_times.pop_front();
+	}
+
+	if (last_present_time != std::chrono::steady_clock::time_point{})
+	{
+		double interval = std::chrono::duration<double>(now - last_present_time).count();
+
+		present_latencies.present_intervals += interval;
+		present_latencies.present_interval_count++;
+
+		present_interval = present_interval == 0.0 ? interval : 0.9 * present_interval + 0.1 * interval;
+	}
+	last_present_time = now;
+
+	// The frame just presented is displayed one interval later, the next frame one interval after it
+	auto display_time = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(2.0 * present_interval));
+	auto input_time   = display_time - target_latency;
+
+	if (input_time > now)
+	{
+		std::this_thread::sleep_until(input_time);
 	}
+
+	frame_input_time = std::chrono::steady_clock::now();
+}
+
+VkSemaphore RenderContext::consume_acquired_semaphore()
+{
+	assert(frame_active && "Frame is not active, please call begin_frame");
+	auto sem           = acquired_semaphore;
+	acquired_semaphore = VK_NULL_HANDLE;
+	return sem;
+}
+
+RenderFrame &RenderContext::get_active_frame()
+{
+	assert(frame_active && "Frame is not active, please call begin_frame");
+	assert(active_frame_index < frames.size());
+	return *frames[active_frame_index];
+}
+
+uint32_t RenderContext::get_active_frame_index()
+{
+	assert(frame_active && "Frame is not active, please call begin_frame");
+	return active_frame_index;
+}
+
+RenderFrame &RenderContext::get_last_rendered_frame()
+{
+	assert(!frame_active && "Frame is still active, please call end_frame");
+	assert(active_frame_index < frames.size());
+	update_render_target(active_frame_index);
+	return *frames[active_frame_index];
+}
+
+VkSemaphore RenderContext::request_semaphore()
+{
+	RenderFrame &frame = get_active_frame();
+	return frame.request_semaphore();
+}
+
+VkSemaphore RenderContext::request_semaphore_with_ownership()
+{
+	RenderFrame &frame = get_active_frame();
+	return frame.request_semaphore_with_ownership();
+}
+
+void RenderContext::release_owned_semaphore(VkSemaphore semaphore)
+{
+	RenderFrame &frame = get_active_frame();
+	frame.release_owned_semaphore(semaphore);
+}
+
+Device &RenderContext::get_device()
+{
+	return device;
+}
+
+void RenderContext::recreate_swapchain()
+{
+	// The render targets of all frames are rebuilt at once, as the render target function may have changed
+	stale_render_targets.assign(frames.size(), false);
+	std::fill_n(stale_render_targets.begin(), std::min(frames.size(), swapchain->get_images().size()), true);
+
+	update_render_targets();
+
+	device.get_resource_cache().next_generation();
 }
 
 bool RenderContext::has_swapchain()
@@ -542,6 +1566,9 @@ uint32_t RenderContext::get_active_frame_index() const
 
 std::vector<std::unique_ptr<RenderFrame>> &RenderContext::get_render_frames()
 {
+	// The render targets of the frames are expected to match the swapchain
+	update_render_targets();
+
 	return frames;
 }
 
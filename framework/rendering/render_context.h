@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -30,11 +30,20 @@
 #include "core/render_pass.h"
 #include "core/shader_module.h"
 #include "core/swapchain.h"
+#include "memory_defragmenter.h"
+#include "rendering/frame_timeline.h"
+#include "rendering/gpu_profiler.h"
 #include "rendering/pipeline_state.h"
 #include "rendering/render_frame.h"
 #include "rendering/render_target.h"
+#include "rendering/resolution_controller.h"
+#include "rendering/shading_rate_controller.h"
 #include "resource_cache.h"
 
+#include <chrono>
+#include <deque>
+#include <map>
+
 namespace vkb
 {
 class Window;
@@ -52,7 +61,8 @@ class Window;
  * swapchain. A RenderFrame will then be created for each Swapchain image.
  *
  * For headless rendering (no swapchain), the RenderContext can be given a valid Device, and
- * a width and height. A single RenderFrame will then be created.
+ * a width and height. HEADLESS_FRAME_COUNT RenderFrames will then be created, each with its own
+ * offscreen color image, and the frames are used in turn so that they can be in flight together.
  */
 class RenderContext
 {
@@ -60,6 +70,38 @@ class RenderContext
 	// The format to use for the RenderTargets if a swapchain isn't created
 	static VkFormat DEFAULT_VK_FORMAT;
 
+	// The number of RenderFrames created if a swapchain isn't created, read by prepare()
+	static uint32_t HEADLESS_FRAME_COUNT;
+
+	// The number of frames in flight with timeline frame sync, unless set otherwise
+	static constexpr uint32_t DEFAULT_MAX_FRAMES_IN_FLIGHT = 2;
+
+	// How long end_frame waits for a present to be displayed in the low latency mode, in nanoseconds
+	static constexpr uint64_t PRESENT_WAIT_TIMEOUT = 100000000;
+
+	// The memory a memory defragmentation pass moves, unless set otherwise
+	static constexpr VkDeviceSize DEFAULT_DEFRAGMENTATION_BYTES_PER_PASS = 16 * 1024 * 1024;
+
+	/// Latencies measured in the low latency mode, summed over the presents displayed since they were last taken.
+	/// Presents paced by the window only measure the present intervals, see Window::pace_present().
+	struct PresentLatencies
+	{
+		/// Times between the display of consecutive presents, in seconds
+		double present_intervals{0.0};
+
+		uint32_t present_interval_count{0};
+
+		/// Times between sampling the input of a frame and its display, in seconds, see set_frame_input_time()
+		double input_to_photon_latencies{0.0};
+
+		uint32_t input_to_photon_latency_count{0};
+
+		/// Times between the oldest input event a frame applied and its display, in seconds, only for frames with events
+		double event_to_photon_latencies{0.0};
+
+		uint32_t event_to_photon_latency_count{0};
+	};
+
 	/**
 	 * @brief Constructor
 	 * @param device A valid device
@@ -82,7 +124,7 @@ class RenderContext
 
 	RenderContext(RenderContext &&) = delete;
 
-	virtual ~RenderContext() = default;
+	virtual ~RenderContext();
 
 	RenderContext &operator=(const RenderContext &) = delete;
 
@@ -127,6 +169,19 @@ class RenderContext
 	 */
 	void update_swapchain(const VkImageCompressionFlagsEXT compression, const VkImageCompressionFixedRateFlagsEXT compression_fixed_rate);
 
+	/**
+	 * @returns True if the swapchain images can be written as storage images, i.e. the surface supports the STORAGE usage
+	 *          and the format of the swapchain has the STORAGE_IMAGE feature, which sRGB formats usually lack
+	 */
+	bool is_swapchain_storage_supported() const;
+
+	/**
+	 * @brief Adds the STORAGE usage to the swapchain images if it is supported, so that a compute pass can write the final
+	 *        image of a frame without a full screen fragment pass, see PostProcessingComputePass::bind_storage_image()
+	 * @returns True if the swapchain images have the STORAGE usage
+	 */
+	bool enable_swapchain_storage();
+
 	/**
 	 * @returns True if a valid swapchain exists in the RenderContext
 	 */
@@ -134,11 +189,13 @@ class RenderContext
 
 	/**
 	 * @brief Recreates the RenderFrames, called after every update
+	 *        The render targets of the existing frames are rebuilt when each frame is next acquired, or all at once
+	 *        by get_render_frames(), so that in-flight frames keep rendering to the previous swapchain meanwhile.
 	 */
 	void recreate();
 
 	/**
-	 * @brief Recreates the swapchain
+	 * @brief Recreates the render targets of all frames from the swapchain images
 	 */
 	void recreate_swapchain();
 
@@ -174,11 +231,232 @@ class RenderContext
 	 */
 	void submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers);
 
+	/**
+	 * @brief Submits command buffers to a queue, chained before the next submission of the frame to another queue
+	 *        The submission waits for the submissions chained to its queue, like every submission of the frame,
+	 *        and signals a semaphore which the next submission of the frame to wait_queue waits for at wait_stages.
+	 *        Every chained submission must be waited for before the frame ends.
+	 * @param queue The queue to submit to, e.g. get_compute_queue()
+	 * @param command_buffers Command buffers containing recorded commands
+	 * @param wait_queue The queue of the submission depending on this one
+	 * @param wait_stages The stages of that submission which wait for this one
+	 */
+	void submit_chained(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, const Queue &wait_queue, VkPipelineStageFlags wait_stages);
+
+	/**
+	 * @brief Requests a command buffer from the command pools of the active frame for a queue, e.g. the compute or transfer queue
+	 */
+	CommandBuffer &request_command_buffer(const Queue &queue, CommandBuffer::ResetMode reset_mode = CommandBuffer::ResetMode::ResetPool);
+
+	/**
+	 * @return The queue frames are submitted and presented on
+	 */
+	const Queue &get_graphics_queue() const;
+
+	/**
+	 * @return A queue of a dedicated compute queue family if the device has one, for work overlapping with graphics, else the graphics queue
+	 */
+	const Queue &get_compute_queue() const;
+
+	/**
+	 * @return A queue of a dedicated transfer queue family if the device has one, else a queue of the graphics family
+	 */
+	const Queue &get_transfer_queue() const;
+
+	/**
+	 * @return Whether the compute queue is of another queue family than the graphics queue, so that its work can run alongside graphics
+	 */
+	bool has_async_compute() const;
+
 	/**
 	 * @brief Waits a frame to finish its rendering
 	 */
 	virtual void wait_frame();
 
+	/**
+	 * @brief Sets whether submissions are tracked with a timeline semaphore per queue instead of a fence per submission
+	 *        In timeline mode, a frame is retired once the timelines reached the values its submissions signal, and
+	 *        begin_frame() blocks until at most max_frames_in_flight - 1 earlier frames are still executing.
+	 *        Requires Device::uses_timeline_semaphores(), and must be called while no frame is active.
+	 * @param enable If true, timeline semaphores are used, otherwise fences from the frame FencePool
+	 * @param max_frames_in_flight How many frames may be in flight at once, the swapchain image count limits it too
+	 */
+	void set_timeline_frame_sync(bool enable, uint32_t max_frames_in_flight = DEFAULT_MAX_FRAMES_IN_FLIGHT);
+
+	bool uses_timeline_frame_sync() const;
+
+	/**
+	 * @brief Paces the frames to hold an input to photon latency, with VK_KHR_present_wait
+	 *
+	 *        After presenting, end_frame() waits for the previous present to be displayed, so that at most one frame
+	 *        is queued for presentation. It then sleeps until the input of the next frame, sampled once end_frame()
+	 *        returns, is expected to be displayed target_latency later. A target lower than the time it takes to render
+	 *        a frame does not sleep.
+	 *
+	 *        Requires a swapchain and a device using present wait, see Device::uses_present_wait.
+	 * @param enable Whether to pace the frames
+	 * @param target_latency The latency to hold between sampling the input of a frame and its display
+	 * @return Whether the low latency mode is enabled
+	 */
+	bool set_low_latency_mode(bool enable, std::chrono::microseconds target_latency = std::chrono::microseconds{0});
+
+	bool uses_low_latency_mode() const;
+
+	/**
+	 * @brief Returns the latencies measured since the last call, see set_low_latency_mode()
+	 */
+	PresentLatencies take_present_latencies();
+
+	/**
+	 * @brief Returns the window the context presents to
+	 */
+	const Window &get_window() const;
+
+	/**
+	 * @brief Records when the input of the active frame was sampled, by default when the previous end_frame() returned
+	 * @param sample_time Time the input was sampled at
+	 * @param event_time Time the oldest input event the frame applies was received at, or none if it has no event
+	 */
+	void set_frame_input_time(std::chrono::steady_clock::time_point sample_time,
+	                          std::chrono::steady_clock::time_point event_time = {});
+
+	/**
+	 * @brief Measures the GPU time of each frame, with timestamps written before the first and after each submission
+	 *        of the frame to the graphics queue
+	 *        The time includes the idle gaps between the submissions of the frame.
+	 */
+	void set_gpu_frame_timing(bool enable);
+
+	/**
+	 * @return The GPU time in seconds of the last frame which retired since the last call, 0 if none did
+	 */
+	double take_gpu_frame_time();
+
+	/**
+	 * @brief Puts the acquire, first submission and present of each frame on the CPU, and its GPU frame timing timestamps,
+	 *        on a single timeline, see FrameTimeline. This enables set_gpu_frame_timing().
+	 *        Requires VK_EXT_calibrated_timestamps, which the device enables where it is supported.
+	 * @return Whether the frame timeline is enabled
+	 */
+	bool set_frame_timeline(bool enable);
+
+	/**
+	 * @return The measurements of the frames which retired since the last call, empty if set_frame_timeline() is not enabled
+	 */
+	FrameTimeline::Measurements take_frame_timeline_measurements();
+
+	/**
+	 * @brief Measures the GPU time of the scopes of ScopedDebugLabel on the command buffers of the frames, see GpuProfiler
+	 *        The command buffers must be submitted to the graphics queue of the context with submit().
+	 */
+	void set_gpu_profiling(bool enable);
+
+	/**
+	 * @brief Counts the pipeline statistics of the outermost scopes measured by the GPU profiler, such as the subpasses and
+	 *        the postprocessing passes, see GpuProfiler::Scope::statistics. Enabling them enables GPU profiling.
+	 *        The device must enable the pipelineStatisticsQuery and inheritedQueries features.
+	 */
+	void set_gpu_pipeline_statistics(bool enable);
+
+	/**
+	 * @return The profiler of the frames, null if set_gpu_profiling() is not enabled
+	 */
+	const GpuProfiler *get_gpu_profiler() const;
+
+	/**
+	 * @brief Adapts the fragment shading rate of the subpasses rendering the scene to hold a GPU time target, see ShadingRateController
+	 *        The time is measured with the GPU profiler, which this enables. The device must use fragment shading rates,
+	 *        see Device::uses_fragment_shading_rates().
+	 * @param target_gpu_time The target in seconds, or 0 to shade at the full rate
+	 */
+	void set_shading_rate_target(double target_gpu_time);
+
+	/**
+	 * @return The controller of the fragment shading rate, null if set_shading_rate_target() is not set
+	 */
+	ShadingRateController *get_shading_rate_controller();
+
+	/**
+	 * @return The rate the subpasses rendering the scene shade at, see CommandBuffer::set_fragment_shading_rate
+	 */
+	VkExtent2D get_fragment_shading_rate() const;
+
+	/**
+	 * @brief Adapts the resolution the scene is rendered at to hold a GPU time target, see ResolutionController
+	 *        Each frame gets a scaled render target, created with the render target function from an image of the
+	 *        extent and format of the swapchain, whose render extent is set with the scale at the start of the frame.
+	 *        The images are not recreated when the scale changes. The time is measured with the GPU profiler, which this enables.
+	 * @param target_gpu_time The target in seconds, or 0 to render at the resolution of the swapchain
+	 * @param min_scale The lowest scale of the resolution
+	 */
+	void set_resolution_target(double target_gpu_time, float min_scale = ResolutionController::DEFAULT_MIN_SCALE);
+
+	/**
+	 * @return The controller of the resolution, null if set_resolution_target() is not set
+	 */
+	ResolutionController *get_resolution_controller();
+
+	/**
+	 * @brief Sets the offset of the projection of the subpasses rendering the scene, for temporal anti-aliasing
+	 *        Geometry subpasses translate the camera projection by it, see TemporalAntiAliasing::next_jitter().
+	 * @param jitter The offset in clip space, where the render extent spans 2 units, 0 not to jitter
+	 */
+	void set_projection_jitter(const glm::vec2 &jitter);
+
+	const glm::vec2 &get_projection_jitter() const;
+
+	/**
+	 * @brief Compacts the memory of the scene textures on idle frames, see MemoryDefragmenter
+	 *        A pass runs at the start of a frame when the GPU time of the last retired frame was below a threshold and a
+	 *        pool is fragmented. It waits for the device, and clears the descriptor sets of the frames if images moved.
+	 *        The time is measured with the GPU frame timing, which this enables.
+	 * @param idle_gpu_time The GPU time in seconds below which a frame is idle, or 0 to stop defragmenting
+	 * @param max_bytes_per_pass The most memory a pass moves
+	 */
+	void set_memory_defragmentation(double idle_gpu_time, VkDeviceSize max_bytes_per_pass = DEFAULT_DEFRAGMENTATION_BYTES_PER_PASS);
+
+	/**
+	 * @return The defragmenter of the scene textures, null if set_memory_defragmentation() is not set
+	 */
+	const MemoryDefragmenter *get_memory_defragmenter() const;
+
+	/**
+	 * @brief Starts capturing the frames for replay, see replay_frame()
+	 *        A frame is captured for each render frame, the latest one to acquire it, and its command buffers are kept with
+	 *        what they refer to, see RenderFrame::set_replayable(). Only frames which submit to the graphics queue alone are
+	 *        captured, and recreating the swapchain drops the capture. The settings of the context must not change meanwhile.
+	 */
+	void begin_frame_capture();
+
+	/**
+	 * @return Whether the frames are being captured, until a frame was captured for each render frame
+	 */
+	bool is_capturing_frames() const;
+
+	/**
+	 * @return Whether a frame was captured for each render frame, so that they can be replayed
+	 */
+	bool has_frame_capture() const;
+
+	/**
+	 * @brief Acquires the next frame, and submits the command buffers captured for it again in a single submission, then presents it
+	 *        Nothing is recorded, and nothing the captured frames use is moved or released: memory is not defragmented,
+	 *        the pipelines and shaders compiled in the background are not swapped in, and retired resources are kept.
+	 * @return Whether the frame was replayed, false if the capture was dropped when acquiring it, in which case the frame
+	 *         is active and is recorded as usual
+	 */
+	bool replay_frame();
+
+	/**
+	 * @return The CPU time in seconds of the submission and present of the last replayed frame
+	 */
+	double get_replay_submit_time() const;
+
+	/**
+	 * @brief Drops the captured frames, which are reset as usual when they are next acquired
+	 */
+	void end_frame_capture();
+
 	void end_frame(VkSemaphore semaphore);
 
 	/**
@@ -219,6 +497,16 @@ class RenderContext
 
 	uint32_t get_active_frame_index() const;
 
+	/**
+	 * @brief Returns the device mask the active frame is submitted with
+	 *        In headless mode over a device group, frames alternate between the physical devices of the group
+	 * @return A mask with a single bit set, 1 unless the device spans more than one physical device
+	 */
+	uint32_t get_frame_device_mask() const;
+
+	/**
+	 * @brief Returns the frames, after rebuilding the render targets not rebuilt since the swapchain was replaced, see recreate()
+	 */
 	std::vector<std::unique_ptr<RenderFrame>> &get_render_frames();
 
 	/**
@@ -236,6 +524,75 @@ class RenderContext
 	VkExtent2D surface_extent;
 
   private:
+	/// Timeline values to wait for, per timeline semaphore
+	using TimelineValues = std::map<VkSemaphore, uint64_t>;
+
+	/**
+	 * @brief Returns the timeline semaphore of a queue, and the value its next submission signals
+	 */
+	std::pair<VkSemaphore, uint64_t> next_timeline_value(const Queue &queue);
+
+	void wait_timeline_values(const TimelineValues &values);
+
+	/**
+	 * @brief Replaces the swapchain and recreates the render targets, the old swapchain is retired once the frames in flight are done with it
+	 */
+	void replace_swapchain(std::unique_ptr<Swapchain> &&new_swapchain);
+
+	/**
+	 * @brief Waits for the previous present to be displayed, measures its latencies and sleeps until the input of the next frame is due
+	 */
+	void pace_frame();
+
+	/**
+	 * @brief Measures the interval since the previous present paced by the window, see Window::pace_present()
+	 */
+	void record_paced_present();
+
+	/**
+	 * @brief Records a command buffer of the active frame writing a GPU frame timing timestamp
+	 */
+	CommandBuffer &record_gpu_timestamp(const Queue &queue, CommandBuffer::ResetMode reset_mode, uint32_t query, VkPipelineStageFlagBits pipeline_stage);
+
+	/**
+	 * @brief Submits to a queue, after the submissions chained to it, and signals the timeline of the queue or a fence of the frame
+	 */
+	void submit_to_queue(const Queue                        &queue,
+	                     const std::vector<CommandBuffer *> &command_buffers,
+	                     std::vector<VkSemaphore>            wait_semaphores,
+	                     std::vector<VkPipelineStageFlags>   wait_stages,
+	                     VkSemaphore                         signal_semaphore);
+
+	/**
+	 * @brief Submits command buffer handles to a queue, the part of submit_to_queue() shared with replay_frame()
+	 */
+	void submit_handles_to_queue(const Queue                        &queue,
+	                             const std::vector<VkCommandBuffer> &cmd_buf_handles,
+	                             std::vector<VkSemaphore>            wait_semaphores,
+	                             std::vector<VkPipelineStageFlags>   wait_stages,
+	                             VkSemaphore                         signal_semaphore);
+
+	/**
+	 * @brief Creates the scaled render targets of the frames if the resolution is adapted, else destroys them
+	 */
+	void update_scaled_render_targets();
+
+	std::unique_ptr<RenderTarget> create_scaled_render_target(RenderFrame &frame);
+
+	std::unique_ptr<RenderTarget> create_swapchain_render_target(uint32_t image_index);
+
+	/**
+	 * @brief Rebuilds the render target of a frame from the swapchain if it was not since the swapchain was replaced
+	 */
+	void update_render_target(uint32_t frame_index);
+
+	void update_render_targets();
+
+	/**
+	 * @brief Retires the replaced swapchains once no render target refers to their images
+	 */
+	void retire_replaced_swapchains();
+
 	Device &device;
 
 	const Window &window;
@@ -264,6 +621,118 @@ class RenderContext
 	VkSurfaceTransformFlagBitsKHR pre_transform{VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR};
 
 	size_t thread_count{1};
+
+	bool timeline_frame_sync{false};
+
+	uint32_t max_frames_in_flight{DEFAULT_MAX_FRAMES_IN_FLIGHT};
+
+	/// Timeline semaphore and last signaled value of each queue submitted to
+	std::map<const Queue *, std::pair<VkSemaphore, uint64_t>> queue_timelines;
+
+	/// Values signaled by the submissions of each frame, since it was last waited for
+	std::vector<TimelineValues> frame_timeline_values;
+
+	/// Values signaled by the frames which ended, oldest first
+	std::deque<TimelineValues> frames_in_flight;
+
+	const Queue *compute_queue{nullptr};
+
+	const Queue *transfer_queue{nullptr};
+
+	/// Semaphores signaled by chained submissions, and the stages waiting for them, per queue of the next submission
+	std::map<const Queue *, std::vector<std::pair<VkSemaphore, VkPipelineStageFlags>>> chained_waits;
+
+	bool low_latency_mode{false};
+
+	std::chrono::microseconds target_latency{0};
+
+	/// Swapchain the present identifiers belong to, they restart with each swapchain
+	VkSwapchainKHR present_wait_swapchain{VK_NULL_HANDLE};
+
+	/// Identifier of the last present
+	uint64_t present_id{0};
+
+	struct PresentInputTime
+	{
+		uint64_t present_id;
+
+		std::chrono::steady_clock::time_point sample_time;
+
+		std::chrono::steady_clock::time_point event_time;
+	};
+
+	/// Times of the input of each present not displayed yet, oldest first
+	std::deque<PresentInputTime> present_input_times;
+
+	/// Time the input of the active frame was sampled at
+	std::chrono::steady_clock::time_point frame_input_time;
+
+	/// Time the oldest input event of the active frame was received at, if it has any
+	std::chrono::steady_clock::time_point frame_event_time;
+
+	/// Time the last present waited for was displayed at, or the last paced present was due at
+	std::chrono::steady_clock::time_point last_present_time;
+
+	/// Moving average of the present interval, in seconds
+	double present_interval{0.0};
+
+	PresentLatencies present_latencies;
+
+	/// Start and end timestamps of each frame, see set_gpu_frame_timing()
+	std::unique_ptr<QueryPool> gpu_timestamp_pool;
+
+	/// Whether the start timestamp of each frame was written since it was last read
+	std::vector<bool> gpu_timestamps_written;
+
+	double gpu_frame_time{0.0};
+
+	std::unique_ptr<FrameTimeline> frame_timeline;
+
+	/// CPU times around the acquire of the active frame, see set_frame_timeline()
+	uint64_t acquire_begin_time{0};
+
+	uint64_t acquire_end_time{0};
+
+	std::unique_ptr<GpuProfiler> gpu_profiler;
+
+	/// See set_gpu_pipeline_statistics()
+	bool gpu_pipeline_statistics{false};
+
+	std::unique_ptr<ShadingRateController> shading_rate_controller;
+
+	std::unique_ptr<ResolutionController> resolution_controller;
+
+	glm::vec2 projection_jitter{0.0f};
+
+	std::unique_ptr<MemoryDefragmenter> memory_defragmenter;
+
+	double defragmentation_idle_gpu_time{0.0};
+
+	/// Frames whose render target refers to a replaced swapchain, rebuilt when they are next acquired
+	std::vector<bool> stale_render_targets;
+
+	/// Swapchains replaced while stale render targets refer to them
+	std::vector<std::unique_ptr<Swapchain>> replaced_swapchains;
+
+	enum class FrameCaptureState
+	{
+		None,
+		Capturing,
+		Captured
+	};
+
+	FrameCaptureState frame_capture_state{FrameCaptureState::None};
+
+	/// Command buffers submitted by each captured frame in submission order, see begin_frame_capture()
+	std::vector<std::vector<VkCommandBuffer>> captured_submissions;
+
+	/// Whether a frame was captured for each render frame
+	std::vector<bool> captured_frames;
+
+	/// Whether the captured frames write the GPU frame timing timestamps
+	bool captured_gpu_timestamps{false};
+
+	double replay_submit_time{0.0};
 };
 
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -29,7 +29,13 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
     swapchain_render_target{std::move(render_target)},
     thread_count{thread_count}
 {
-	for (auto &usage_it : supported_usage_map)
+	auto usage_map = supported_usage_map;
+	if (device.uses_descriptor_buffers())
+	{
+		usage_map.emplace(DESCRIPTOR_BUFFER_USAGE, 1);
+	}
+
+	for (auto &usage_it : usage_map)
 	{
 		std::vector<std::pair<BufferPool, BufferBlock *>> usage_buffer_pools;
 		for (size_t i = 0; i < thread_count; ++i)
@@ -49,6 +55,9 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
 	{
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorPool>>());
 		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorSet>>());
+		descriptor_set_last_use.push_back(std::make_unique<std::unordered_map<std::size_t, uint64_t>>());
+		resolved_descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, std::size_t>>());
+		arenas.emplace_back();
 	}
 }
 
@@ -59,7 +68,8 @@ Device &RenderFrame::get_device()
 
 void RenderFrame::update_render_target(std::unique_ptr<RenderTarget> &&render_target)
 {
-	swapchain_render_target = std::move(render_target);
+	// The frames in flight may still render to the previous target
+	device.get_retire_queue().retire(std::exchange(swapchain_render_target, std::move(render_target)));
 }
 
 void RenderFrame::reset()
@@ -68,6 +78,13 @@ void RenderFrame::reset()
 
 	fence_pool.reset();
 
+	// The recorded commands are submitted again, so only the synchronization of the frame starts over
+	if (replayable)
+	{
+		semaphore_pool.reset();
+		return;
+	}
+
 	for (auto &command_pools_per_queue : command_pools)
 	{
 		for (auto &command_pool : command_pools_per_queue.second)
@@ -87,48 +104,90 @@ void RenderFrame::reset()
 
 	semaphore_pool.reset();
 
+	for (auto &arena : arenas)
+	{
+		arena.reset();
+	}
+
+	// The snapshot is set again by the caller recording the frame, if any
+	scene_snapshot = nullptr;
+
+	++reset_count;
+
 	if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectly)
 	{
 		clear_descriptors();
 	}
+	else if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::EvictUnused)
+	{
+		evict_unused_descriptor_sets();
+	}
+
+	size_t cache_size = 0;
+	for (auto &thread_descriptor_sets : descriptor_sets)
+	{
+		cache_size += thread_descriptor_sets->size();
+	}
+	descriptor_set_cache_size = cache_size;
 }
 
-std::vector<std::unique_ptr<CommandPool>> &RenderFrame::get_command_pools(const Queue &queue, CommandBuffer::ResetMode reset_mode)
+void RenderFrame::evict_unused_descriptor_sets()
 {
-	auto command_pool_it = command_pools.find(queue.get_family_index());
-
-	if (command_pool_it != command_pools.end())
+	for (size_t thread_index = 0; thread_index < descriptor_sets.size(); ++thread_index)
 	{
-		assert(!command_pool_it->second.empty());
-		if (command_pool_it->second[0]->get_reset_mode() != reset_mode)
+		auto &thread_descriptor_sets = *descriptor_sets[thread_index];
+		auto &last_use               = *descriptor_set_last_use[thread_index];
+
+		size_t cache_size = thread_descriptor_sets.size();
+
+		for (auto descriptor_set_it = thread_descriptor_sets.begin(); descriptor_set_it != thread_descriptor_sets.end();)
 		{
-			device.wait_idle();
+			auto last_use_it = last_use.find(descriptor_set_it->first);
+
+			// Sets cached before switching strategies count as used now
+			if (last_use_it == last_use.end())
+			{
+				last_use.emplace(descriptor_set_it->first, reset_count);
+				++descriptor_set_it;
+			}
+			else if (reset_count - last_use_it->second > descriptor_set_max_unused_frames)
+			{
+				// The fence of the frame was waited on, so the GPU is done with the set
+				auto &descriptor_set = descriptor_set_it->second;
+				descriptor_set.get_descriptor_pool().release(descriptor_set.get_handle());
 
-			// Delete pools
-			command_pools.erase(command_pool_it);
+				last_use.erase(last_use_it);
+				descriptor_set_it = thread_descriptor_sets.erase(descriptor_set_it);
+			}
+			else
+			{
+				++descriptor_set_it;
+			}
 		}
-		else
+
+		// Resources of evicted sets would map to them until requested again, they are forgotten instead
+		if (thread_descriptor_sets.size() != cache_size)
 		{
-			return command_pool_it->second;
+			resolved_descriptor_sets[thread_index]->clear();
 		}
 	}
+}
 
-	std::vector<std::unique_ptr<CommandPool>> queue_command_pools;
-	for (size_t i = 0; i < thread_count; i++)
-	{
-		queue_command_pools.push_back(std::make_unique<CommandPool>(device, queue.get_family_index(), this, i, reset_mode));
-	}
-
-	auto res_ins_it = command_pools.emplace(queue.get_family_index(), std::move(queue_command_pools));
+std::vector<std::unique_ptr<CommandPool>> &RenderFrame::get_command_pools(const Queue &queue, CommandBuffer::ResetMode reset_mode)
+{
+	// Pools of each reset mode coexist, so that mixing reset modes does not recreate them
+	auto &queue_command_pools = command_pools[{queue.get_family_index(), reset_mode}];
 
-	if (!res_ins_it.second)
+	if (queue_command_pools.empty())
 	{
-		throw std::runtime_error("Failed to insert command pool");
+		queue_command_pools.reserve(thread_count);
+		for (size_t i = 0; i < thread_count; i++)
+		{
+			queue_command_pools.push_back(std::make_unique<CommandPool>(device, queue.get_family_index(), this, i, reset_mode));
+		}
 	}
 
-	command_pool_it = res_ins_it.first;
-
-	return command_pool_it->second;
+	return queue_command_pools;
 }
 
 std::vector<uint32_t> RenderFrame::collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos)
@@ -193,15 +252,24 @@ const RenderTarget &RenderFrame::get_render_target_const() const
 	return *swapchain_render_target;
 }
 
+void RenderFrame::set_scaled_render_target(std::unique_ptr<RenderTarget> &&render_target)
+{
+	device.get_retire_queue().retire(std::exchange(scaled_render_target, std::move(render_target)));
+}
+
+RenderTarget *RenderFrame::get_scaled_render_target()
+{
+	return scaled_render_target.get();
+}
+
 CommandBuffer &RenderFrame::request_command_buffer(const Queue &queue, CommandBuffer::ResetMode reset_mode, VkCommandBufferLevel level, size_t thread_index)
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
 
+	// The pools are in the order of their thread
 	auto &command_pools = get_command_pools(queue, reset_mode);
 
-	auto command_pool_it = std::find_if(command_pools.begin(), command_pools.end(), [&thread_index](std::unique_ptr<CommandPool> &cmd_pool) { return cmd_pool->get_thread_index() == thread_index; });
-
-	return (*command_pool_it)->request_command_buffer(level);
+	return command_pools[thread_index]->request_command_buffer(level);
 }
 
 VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos, bool update_after_bind, size_t thread_index)
@@ -210,7 +278,7 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 
 	assert(thread_index < descriptor_pools.size());
 	auto &descriptor_pool = request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
-	if (descriptor_management_strategy == DescriptorManagementStrategy::StoreInCache)
+	if (descriptor_management_strategy != DescriptorManagementStrategy::CreateDirectly)
 	{
 		// The bindings we want to update before binding, if empty we update all bindings
 		std::vector<uint32_t> bindings_to_update;
@@ -221,8 +289,8 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 		}
 
 		// Request a descriptor set from the render frame, and write the buffer infos and image infos of all the specified bindings
-		assert(thread_index < descriptor_sets.size());
-		auto &descriptor_set = request_resource(device, nullptr, *descriptor_sets[thread_index], descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+		std::size_t descriptor_set_hash{0U};
+		auto       &descriptor_set = request_cached_descriptor_set(descriptor_set_layout, descriptor_pool, buffer_infos, image_infos, thread_index, descriptor_set_hash);
 		descriptor_set.update(bindings_to_update);
 		return descriptor_set.get_handle();
 	}
@@ -235,6 +303,92 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 	}
 }
 
+VkDescriptorSet RenderFrame::find_descriptor_set(size_t resources_hash, size_t thread_index)
+{
+	assert(thread_index < thread_count && "Thread index is out of bounds");
+
+	if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectly)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	auto &thread_resolved_descriptor_sets = *resolved_descriptor_sets[thread_index];
+
+	auto resolved_it = thread_resolved_descriptor_sets.find(resources_hash);
+	if (resolved_it == thread_resolved_descriptor_sets.end())
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	auto &thread_descriptor_sets = *descriptor_sets[thread_index];
+
+	auto descriptor_set_it = thread_descriptor_sets.find(resolved_it->second);
+	if (descriptor_set_it == thread_descriptor_sets.end())
+	{
+		thread_resolved_descriptor_sets.erase(resolved_it);
+		return VK_NULL_HANDLE;
+	}
+
+	descriptor_set_cache_hits.fetch_add(1, std::memory_order_relaxed);
+
+	if (descriptor_management_strategy == DescriptorManagementStrategy::EvictUnused)
+	{
+		(*descriptor_set_last_use[thread_index])[resolved_it->second] = reset_count;
+	}
+
+	// The set was written when it was requested, and its infos have not changed since
+	return descriptor_set_it->second.get_handle();
+}
+
+VkDescriptorSet RenderFrame::request_descriptor_set(size_t resources_hash, const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos, size_t thread_index)
+{
+	if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectly)
+	{
+		return request_descriptor_set(descriptor_set_layout, buffer_infos, image_infos, false, thread_index);
+	}
+
+	assert(thread_index < thread_count && "Thread index is out of bounds");
+
+	auto &descriptor_pool = request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
+
+	std::size_t descriptor_set_hash{0U};
+	auto       &descriptor_set = request_cached_descriptor_set(descriptor_set_layout, descriptor_pool, buffer_infos, image_infos, thread_index, descriptor_set_hash);
+	descriptor_set.update();
+
+	(*resolved_descriptor_sets[thread_index])[resources_hash] = descriptor_set_hash;
+
+	return descriptor_set.get_handle();
+}
+
+DescriptorSet &RenderFrame::request_cached_descriptor_set(const DescriptorSetLayout &descriptor_set_layout, DescriptorPool &descriptor_pool, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos, size_t thread_index, size_t &descriptor_set_hash)
+{
+	assert(thread_index < descriptor_sets.size());
+	auto &thread_descriptor_sets = *descriptor_sets[thread_index];
+
+	// Same hash as request_resource() below
+	descriptor_set_hash = 0;
+	hash_param(descriptor_set_hash, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+
+	auto descriptor_set_it = thread_descriptor_sets.find(descriptor_set_hash);
+	if (descriptor_set_it != thread_descriptor_sets.end())
+	{
+		descriptor_set_cache_hits.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+	{
+		descriptor_set_cache_misses.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (descriptor_management_strategy == DescriptorManagementStrategy::EvictUnused)
+	{
+		(*descriptor_set_last_use[thread_index])[descriptor_set_hash] = reset_count;
+	}
+
+	return descriptor_set_it != thread_descriptor_sets.end() ?
+	           descriptor_set_it->second :
+	           request_resource(device, nullptr, thread_descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+}
+
 void RenderFrame::update_descriptor_sets(size_t thread_index)
 {
 	assert(thread_index < descriptor_sets.size());
@@ -252,6 +406,16 @@ void RenderFrame::clear_descriptors()
 		desc_sets_per_thread->clear();
 	}
 
+	for (auto &last_use_per_thread : descriptor_set_last_use)
+	{
+		last_use_per_thread->clear();
+	}
+
+	for (auto &resolved_per_thread : resolved_descriptor_sets)
+	{
+		resolved_per_thread->clear();
+	}
+
 	for (auto &desc_pools_per_thread : descriptor_pools)
 	{
 		for (auto &desc_pool : *desc_pools_per_thread)
@@ -271,6 +435,85 @@ void RenderFrame::set_descriptor_management_strategy(DescriptorManagementStrateg
 	descriptor_management_strategy = new_strategy;
 }
 
+DescriptorManagementStrategy RenderFrame::get_descriptor_management_strategy() const
+{
+	return descriptor_management_strategy;
+}
+
+void RenderFrame::set_descriptor_set_max_unused_frames(uint32_t max_unused_frames)
+{
+	descriptor_set_max_unused_frames = max_unused_frames;
+}
+
+size_t RenderFrame::get_descriptor_set_cache_size() const
+{
+	return descriptor_set_cache_size.load(std::memory_order_relaxed);
+}
+
+std::pair<uint32_t, uint32_t> RenderFrame::take_descriptor_set_cache_counts()
+{
+	return {descriptor_set_cache_hits.exchange(0), descriptor_set_cache_misses.exchange(0)};
+}
+
+size_t RenderFrame::get_thread_count() const
+{
+	return thread_count;
+}
+
+void RenderFrame::set_buffer_pool_trim_policy(VkDeviceSize high_water_mark, uint32_t idle_reset_limit)
+{
+	for (auto &buffer_pools_per_usage : buffer_pools)
+	{
+		for (auto &buffer_pool : buffer_pools_per_usage.second)
+		{
+			buffer_pool.first.set_trim_policy(high_water_mark, idle_reset_limit);
+		}
+	}
+}
+
+VkDeviceSize RenderFrame::get_buffer_pool_peak_usage(VkBufferUsageFlags usage) const
+{
+	VkDeviceSize peak_usage = 0;
+
+	auto buffer_pool_it = buffer_pools.find(usage);
+	if (buffer_pool_it != buffer_pools.end())
+	{
+		for (auto &buffer_pool : buffer_pool_it->second)
+		{
+			peak_usage += buffer_pool.first.get_peak_usage();
+		}
+	}
+
+	return peak_usage;
+}
+
+FrameArena &RenderFrame::get_arena(size_t thread_index)
+{
+	assert(thread_index < arenas.size() && "Thread index is out of bounds");
+
+	return arenas[thread_index];
+}
+
+void RenderFrame::set_scene_snapshot(const sg::SceneSnapshot *snapshot)
+{
+	scene_snapshot = snapshot;
+}
+
+const sg::SceneSnapshot *RenderFrame::get_scene_snapshot() const
+{
+	return scene_snapshot;
+}
+
+void RenderFrame::set_replayable(bool replayable_)
+{
+	replayable = replayable_;
+}
+
+bool RenderFrame::is_replayable() const
+{
+	return replayable;
+}
+
 BufferAllocation RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, const VkDeviceSize size, size_t thread_index)
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
@@ -298,4 +541,32 @@ BufferAllocation RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, co
 
 	return buffer_block->allocate(to_u32(size));
 }
+
+BufferAllocation RenderFrame::allocate_buffer_array(const VkBufferUsageFlags usage, const VkDeviceSize element_size, uint32_t element_count, size_t thread_index)
+{
+	assert(thread_index < thread_count && "Thread index is out of bounds");
+
+	auto buffer_pool_it = buffer_pools.find(usage);
+	if (buffer_pool_it == buffer_pools.end())
+	{
+		LOGE("No buffer pool for buffer usage {}", usage);
+		return BufferAllocation{};
+	}
+
+	assert(thread_index < buffer_pool_it->second.size());
+	auto &buffer_pool  = buffer_pool_it->second[thread_index].first;
+	auto &buffer_block = buffer_pool_it->second[thread_index].second;
+
+	// The block alignment is the same for the whole pool, so the size of the array is known before picking a block
+	VkDeviceSize size = buffer_pool.get_element_stride(element_size) * element_count;
+
+	bool want_minimal_block = buffer_allocation_strategy == BufferAllocationStrategy::OneAllocationPerBuffer;
+
+	if (want_minimal_block || !buffer_block || !buffer_block->can_allocate(size))
+	{
+		buffer_block = &buffer_pool.request_buffer_block(size, want_minimal_block);
+	}
+
+	return buffer_block->allocate_array(element_size, element_count);
+}
 }        // namespace vkb
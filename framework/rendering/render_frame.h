@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -29,11 +29,19 @@
 #include "core/query_pool.h"
 #include "core/queue.h"
 #include "fence_pool.h"
+#include "rendering/frame_arena.h"
 #include "rendering/render_target.h"
 #include "semaphore_pool.h"
 
+#include <atomic>
+
 namespace vkb
 {
+namespace sg
+{
+class SceneSnapshot;
+}
+
 enum BufferAllocationStrategy
 {
 	OneAllocationPerBuffer,
@@ -43,7 +51,9 @@ enum BufferAllocationStrategy
 enum DescriptorManagementStrategy
 {
 	StoreInCache,
-	CreateDirectly
+	CreateDirectly,
+	/// Like StoreInCache, but descriptor sets unused for a number of frames are evicted and their handles reused
+	EvictUnused
 };
 
 /**
@@ -67,6 +77,11 @@ class RenderFrame
 	 */
 	static constexpr uint32_t BUFFER_POOL_BLOCK_SIZE = 256;
 
+	/**
+	 * @brief Default number of frames a cached descriptor set can go unused before it is evicted, see DescriptorManagementStrategy::EvictUnused
+	 */
+	static constexpr uint32_t DEFAULT_DESCRIPTOR_SET_MAX_UNUSED_FRAMES = 8;
+
 	// A map of the supported usages to a multiplier for the BUFFER_POOL_BLOCK_SIZE
 	const std::unordered_map<VkBufferUsageFlags, uint32_t> supported_usage_map = {
 	    {VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 1},
@@ -74,6 +89,13 @@ class RenderFrame
 	    {VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 1},
 	    {VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1}};
 
+	/**
+	 * @brief Usage of the buffer pools descriptors are written to, if Device::uses_descriptor_buffers()
+	 */
+	static constexpr VkBufferUsageFlags DESCRIPTOR_BUFFER_USAGE = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+	                                                              VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+	                                                              VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
 	RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_target, size_t thread_count = 1);
 
 	RenderFrame(const RenderFrame &) = delete;
@@ -108,6 +130,17 @@ class RenderFrame
 
 	const RenderTarget &get_render_target_const() const;
 
+	/**
+	 * @brief Sets the render target the scene is rendered to when its resolution is scaled, see RenderContext::set_resolution_target()
+	 * @param render_target A render target of the extent of the swapchain one, whose first image is sampled, or null
+	 */
+	void set_scaled_render_target(std::unique_ptr<RenderTarget> &&render_target);
+
+	/**
+	 * @return The render target the scene is rendered to when its resolution is scaled, null if it is not
+	 */
+	RenderTarget *get_scaled_render_target();
+
 	/**
 	 * @brief Requests a command buffer to the command pool of the active frame
 	 *        A frame should be active at the moment of requesting it
@@ -129,6 +162,25 @@ class RenderFrame
 	                                       bool                                      update_after_bind,
 	                                       size_t                                    thread_index = 0);
 
+	/**
+	 * @brief Looks up the descriptor set last requested for a hash of resources, without building their descriptor infos
+	 * @param resources_hash Hash of the descriptor set layout and of the resources the set is written from
+	 * @param thread_index Index of the descriptor pools to be used by the current thread
+	 * @return The descriptor set, or a null handle if none was requested for the hash or it was evicted since
+	 */
+	VkDescriptorSet find_descriptor_set(size_t resources_hash, size_t thread_index = 0);
+
+	/**
+	 * @brief Same as the other request_descriptor_set() without update after bind, the set is then found by find_descriptor_set()
+	 *        with the hash of the resources
+	 * @param resources_hash Hash of the descriptor set layout and of the resources the infos are written from
+	 */
+	VkDescriptorSet request_descriptor_set(size_t                                    resources_hash,
+	                                       const DescriptorSetLayout &               descriptor_set_layout,
+	                                       const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                                       const BindingMap<VkDescriptorImageInfo> & image_infos,
+	                                       size_t                                    thread_index = 0);
+
 	void clear_descriptors();
 
 	/**
@@ -143,6 +195,39 @@ class RenderFrame
 	 */
 	void set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy);
 
+	DescriptorManagementStrategy get_descriptor_management_strategy() const;
+
+	/**
+	 * @brief Sets after how many uses of the frame an unused descriptor set is evicted, with DescriptorManagementStrategy::EvictUnused
+	 */
+	void set_descriptor_set_max_unused_frames(uint32_t max_unused_frames);
+
+	/**
+	 * @return The number of descriptor sets cached by the frame, as of its last reset
+	 */
+	size_t get_descriptor_set_cache_size() const;
+
+	/**
+	 * @brief Returns the descriptor set cache hits and misses since the last call, and resets them
+	 * @return A pair of the hit count and the miss count
+	 */
+	std::pair<uint32_t, uint32_t> take_descriptor_set_cache_counts();
+
+	/**
+	 * @return The number of threads the frame allocates resource pools for
+	 */
+	size_t get_thread_count() const;
+
+	/**
+	 * @brief Sets the trim policy of every buffer pool of the frame, see BufferPool::set_trim_policy
+	 */
+	void set_buffer_pool_trim_policy(VkDeviceSize high_water_mark, uint32_t idle_reset_limit);
+
+	/**
+	 * @return The peak number of bytes allocated in a frame from the buffer pools of the given usage, summed over all threads
+	 */
+	VkDeviceSize get_buffer_pool_peak_usage(VkBufferUsageFlags usage) const;
+
 	/**
 	 * @param usage Usage of the buffer
 	 * @param size Amount of memory required
@@ -151,25 +236,77 @@ class RenderFrame
 	 */
 	BufferAllocation allocate_buffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index = 0);
 
+	/**
+	 * @brief Allocates an array whose elements start at offsets aligned for the usage, e.g. to fill
+	 *        the per-object slices of a dynamic uniform buffer with a single update_elements() call
+	 * @param usage Usage of the buffer
+	 * @param element_size Size in bytes of one element
+	 * @param element_count Number of elements
+	 * @param thread_index Index of the buffer pool to be used by the current thread
+	 * @return The requested array allocation, it may be empty
+	 */
+	BufferAllocation allocate_buffer_array(VkBufferUsageFlags usage, VkDeviceSize element_size, uint32_t element_count, size_t thread_index = 0);
+
 	/**
 	 * @brief Updates all the descriptor sets in the current frame at a specific thread index
 	 */
 	void update_descriptor_sets(size_t thread_index = 0);
 
+	/**
+	 * @param thread_index Index of the thread which records with the arena
+	 * @return The arena of the thread for the temporaries of the frame, its allocations are released when the frame is reset
+	 */
+	FrameArena &get_arena(size_t thread_index = 0);
+
+	/**
+	 * @brief Sets the scene snapshot the frame is recorded from, or null to read the live scene
+	 *        The snapshot is owned by the caller and must outlive the recording of the frame. It is cleared by reset().
+	 */
+	void set_scene_snapshot(const sg::SceneSnapshot *snapshot);
+
+	/**
+	 * @return The scene snapshot the frame is recorded from, or null without frame pipelining, see sg::get_node_state()
+	 */
+	const sg::SceneSnapshot *get_scene_snapshot() const;
+
+	/**
+	 * @brief Keeps what the frame records so that it can be submitted again, see RenderContext::begin_frame_capture()
+	 *        The command buffers begun from the frame are then not one time submit, and reset() only waits for the frame
+	 *        and resets its fences and semaphores, keeping its command buffers, buffer allocations and descriptor sets.
+	 */
+	void set_replayable(bool replayable);
+
+	bool is_replayable() const;
+
   private:
 	Device &device;
 
 	/**
 	 * @brief Retrieve the frame's command pool(s)
 	 * @param queue The queue command buffers will be submitted on
-	 * @param reset_mode Indicate how the command buffers will be reset after execution,
-	 *        may trigger a pool re-creation to set necessary flags
-	 * @return The frame's command pool(s)
+	 * @param reset_mode Indicate how the command buffers will be reset after execution
+	 * @return The frame's command pools of the queue family and reset mode, one per thread
 	 */
 	std::vector<std::unique_ptr<CommandPool>> &get_command_pools(const Queue &queue, CommandBuffer::ResetMode reset_mode);
 
-	/// Commands pools associated to the frame
-	std::map<uint32_t, std::vector<std::unique_ptr<CommandPool>>> command_pools;
+	/**
+	 * @brief Requests a descriptor set from the cache of the thread
+	 * @param descriptor_set_hash Set to the hash the descriptor set is cached with
+	 */
+	DescriptorSet &request_cached_descriptor_set(const DescriptorSetLayout &               descriptor_set_layout,
+	                                             DescriptorPool &                          descriptor_pool,
+	                                             const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                                             const BindingMap<VkDescriptorImageInfo> & image_infos,
+	                                             size_t                                    thread_index,
+	                                             size_t &                                  descriptor_set_hash);
+
+	/**
+	 * @brief Returns the descriptor sets unused for more than descriptor_set_max_unused_frames to their pools
+	 */
+	void evict_unused_descriptor_sets();
+
+	/// Commands pools associated to the frame, by queue family index and reset mode
+	std::map<std::pair<uint32_t, CommandBuffer::ResetMode>, std::vector<std::unique_ptr<CommandPool>>> command_pools;
 
 	/// Descriptor pools for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorPool>>> descriptor_pools;
@@ -177,6 +314,23 @@ class RenderFrame
 	/// Descriptor sets for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorSet>>> descriptor_sets;
 
+	/// Number of the last reset at which each descriptor set was requested, with DescriptorManagementStrategy::EvictUnused
+	std::vector<std::unique_ptr<std::unordered_map<std::size_t, uint64_t>>> descriptor_set_last_use;
+
+	/// Hash of the descriptor set last requested for each hash of resources, see find_descriptor_set()
+	std::vector<std::unique_ptr<std::unordered_map<std::size_t, std::size_t>>> resolved_descriptor_sets;
+
+	/// Number of times the frame was reset
+	uint64_t reset_count{0};
+
+	uint32_t descriptor_set_max_unused_frames{DEFAULT_DESCRIPTOR_SET_MAX_UNUSED_FRAMES};
+
+	std::atomic<size_t> descriptor_set_cache_size{0};
+
+	std::atomic<uint32_t> descriptor_set_cache_hits{0};
+
+	std::atomic<uint32_t> descriptor_set_cache_misses{0};
+
 	FencePool fence_pool;
 
 	SemaphorePool semaphore_pool;
@@ -185,11 +339,21 @@ class RenderFrame
 
 	std::unique_ptr<RenderTarget> swapchain_render_target;
 
+	std::unique_ptr<RenderTarget> scaled_render_target;
+
 	BufferAllocationStrategy     buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
 	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPool, BufferBlock *>>> buffer_pools;
 
+	/// Arenas for the temporaries of the frame, one per thread
+	std::vector<FrameArena> arenas;
+
+	const sg::SceneSnapshot *scene_snapshot{nullptr};
+
+	/// Set by set_replayable()
+	bool replayable{false};
+
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -27,8 +27,13 @@
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
 
+#include <core/util/job_system.hpp>
+
 namespace vkb
 {
+std::atomic<uint64_t> RenderPipeline::total_saved_read_bytes{0};
+std::atomic<uint64_t> RenderPipeline::total_saved_write_bytes{0};
+
 RenderPipeline::RenderPipeline(std::vector<std::unique_ptr<Subpass>> &&subpasses_) :
     subpasses{std::move(subpasses_)}
 {
@@ -86,6 +91,267 @@ void RenderPipeline::set_clear_value(const std::vector<VkClearValue> &cv)
 	clear_value = cv;
 }
 
+void RenderPipeline::set_job_system(JobSystem *job_system_)
+{
+	job_system = job_system_;
+}
+
+void RenderPipeline::set_last_subpass_secondary(bool last_subpass_secondary_)
+{
+	last_subpass_secondary = last_subpass_secondary_;
+}
+
+void RenderPipeline::set_attachment_validation(AttachmentValidation attachment_validation_)
+{
+	attachment_validation = attachment_validation_;
+}
+
+uint32_t RenderPipeline::set_multisampling(const MultisampleConfig &config)
+{
+	assert(!subpasses.empty() && "Subpasses should be added before setting multisampling");
+
+	auto &device             = subpasses.front()->get_render_context().get_device();
+	auto  depth_resolve_mode = RenderTarget::get_depth_resolve_mode(device, config.depth_resolve_mode);
+
+	uint32_t color_resolve = config.sample_resolved ? RenderTarget::MS_COLOR_RESOLVE_ATTACHMENT : RenderTarget::MS_SWAPCHAIN_ATTACHMENT;
+	Subpass *depth_subpass = nullptr;
+
+	for (auto &subpass : subpasses)
+	{
+		subpass->set_sample_count(config.samples);
+
+		auto outputs = subpass->get_output_attachments();
+		std::replace(outputs.begin(), outputs.end(), RenderTarget::MS_SWAPCHAIN_ATTACHMENT, RenderTarget::MS_COLOR_ATTACHMENT);
+		subpass->set_output_attachments(outputs);
+
+		subpass->set_color_resolve_attachments({});
+		subpass->set_depth_stencil_resolve_attachment(VK_ATTACHMENT_UNUSED);
+		subpass->set_depth_stencil_resolve_mode(VK_RESOLVE_MODE_NONE);
+
+		if (!subpass->get_disable_depth_stencil_attachment())
+		{
+			depth_subpass = subpass.get();
+		}
+	}
+
+	// Resolving in the render pass lets tile-based GPUs write only the resolved attachments to memory
+	subpasses.back()->set_color_resolve_attachments({color_resolve});
+	if (depth_subpass && depth_resolve_mode != VK_RESOLVE_MODE_NONE)
+	{
+		depth_subpass->set_depth_stencil_resolve_attachment(RenderTarget::MS_DEPTH_RESOLVE_ATTACHMENT);
+		depth_subpass->set_depth_stencil_resolve_mode(depth_resolve_mode);
+	}
+
+	load_store = std::vector<LoadStoreInfo>(5, {VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_DONT_CARE});
+	load_store[color_resolve].store_op = VK_ATTACHMENT_STORE_OP_STORE;
+
+	uint32_t sampled_depth = RenderTarget::MS_DEPTH_RESOLVE_ATTACHMENT;
+	if (depth_resolve_mode == VK_RESOLVE_MODE_NONE)
+	{
+		// Multisampled depth cannot be resolved outside the render pass, so it has to be stored to be read
+		sampled_depth = RenderTarget::MS_DEPTH_ATTACHMENT;
+	}
+	if (config.sample_resolved)
+	{
+		load_store[sampled_depth].store_op = VK_ATTACHMENT_STORE_OP_STORE;
+	}
+
+	clear_value = std::vector<VkClearValue>(5);
+	for (uint32_t i : {RenderTarget::MS_SWAPCHAIN_ATTACHMENT, RenderTarget::MS_COLOR_ATTACHMENT, RenderTarget::MS_COLOR_RESOLVE_ATTACHMENT})
+	{
+		clear_value[i].color = {0.0f, 0.0f, 0.0f, 1.0f};
+	}
+	for (uint32_t i : {RenderTarget::MS_DEPTH_ATTACHMENT, RenderTarget::MS_DEPTH_RESOLVE_ATTACHMENT})
+	{
+		clear_value[i].depthStencil = {0.0f, ~0U};
+	}
+
+	return sampled_depth;
+}
+
+void RenderPipeline::set_motion_vectors()
+{
+	load_store = std::vector<LoadStoreInfo>(3, {VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE});
+
+	clear_value                                                 = std::vector<VkClearValue>(3);
+	clear_value[RenderTarget::MV_COLOR_ATTACHMENT].color        = {0.0f, 0.0f, 0.0f, 1.0f};
+	clear_value[RenderTarget::MV_DEPTH_ATTACHMENT].depthStencil = {0.0f, ~0U};
+	clear_value[RenderTarget::MV_VELOCITY_ATTACHMENT].color     = {0.0f, 0.0f, 0.0f, 0.0f};
+}
+
+std::pair<uint64_t, uint64_t> RenderPipeline::take_saved_bandwidth()
+{
+	return {total_saved_read_bytes.exchange(0), total_saved_write_bytes.exchange(0)};
+}
+
+void RenderPipeline::validate_attachments(const RenderTarget &render_target)
+{
+	const auto &attachments = render_target.get_attachments();
+	const auto &extent      = render_target.get_render_extent();
+
+	size_t configuration{0};
+	hash_combine(configuration, &render_target);
+	hash_combine(configuration, extent.width);
+	hash_combine(configuration, extent.height);
+	hash_combine(configuration, static_cast<uint32_t>(attachment_validation));
+	for (auto &info : load_store)
+	{
+		hash_combine(configuration, static_cast<uint32_t>(info.load_op));
+		hash_combine(configuration, static_cast<uint32_t>(info.store_op));
+	}
+	for (auto &subpass : subpasses)
+	{
+		hash_combine(configuration, subpass->get_input_attachments().size());
+		for (uint32_t input : subpass->get_input_attachments())
+		{
+			hash_combine(configuration, input);
+		}
+		hash_combine(configuration, subpass->get_output_attachments().size());
+		for (uint32_t output : subpass->get_output_attachments())
+		{
+			hash_combine(configuration, output);
+		}
+		hash_combine(configuration, subpass->get_disable_depth_stencil_attachment());
+	}
+
+	if (configuration == validated_configuration)
+	{
+		return;
+	}
+	validated_configuration = configuration;
+
+	struct AttachmentUse
+	{
+		bool written{false};
+		bool written_first_as_color{false};
+		bool read_before_written{false};
+		bool read_after_written{false};
+		bool kept{false};
+	};
+	std::vector<AttachmentUse> uses(attachments.size());
+
+	// Subpasses use the first depth attachment unless they disable it
+	auto depth_it = std::find_if(attachments.begin(), attachments.end(), [](const Attachment &attachment) { return is_depth_format(attachment.format); });
+
+	for (size_t i = 0; i < subpasses.size(); ++i)
+	{
+		auto &subpass = *subpasses[i];
+
+		for (uint32_t input : subpass.get_input_attachments())
+		{
+			if (input < uses.size())
+			{
+				uses[input].read_after_written |= uses[input].written;
+				uses[input].read_before_written |= !uses[input].written;
+			}
+		}
+
+		for (uint32_t output : subpass.get_output_attachments())
+		{
+			if (output < uses.size())
+			{
+				uses[output].written_first_as_color |= !uses[output].written && !uses[output].read_before_written;
+				uses[output].written = true;
+
+				// The outputs of the last subpass are the results of the render pass
+				uses[output].kept |= i + 1 == subpasses.size();
+			}
+		}
+
+		if (!subpass.get_disable_depth_stencil_attachment() && depth_it != attachments.end())
+		{
+			uses[depth_it - attachments.begin()].written = true;
+		}
+
+		// Resolve attachments are meant to be stored
+		for (uint32_t resolve : subpass.get_color_resolve_attachments())
+		{
+			if (resolve < uses.size())
+			{
+				uses[resolve].kept = true;
+			}
+		}
+		if (subpass.get_depth_stencil_resolve_attachment() < uses.size())
+		{
+			uses[subpass.get_depth_stencil_resolve_attachment()].kept = true;
+		}
+	}
+
+	saved_read_bytes  = 0;
+	saved_write_bytes = 0;
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(uses.size()) && i < load_store.size(); ++i)
+	{
+		const auto    &attachment = attachments[i];
+		auto          &info       = load_store[i];
+		const uint64_t pixels     = static_cast<uint64_t>(extent.width) * extent.height * attachment.samples;
+		const uint64_t size       = pixels * std::max(get_bits_per_pixel(attachment.format), 0) / 8;
+
+		if ((attachment.usage & VK_IMAGE_USAGE_STORAGE_BIT) && attachment_validation != AttachmentValidation::Disabled)
+		{
+			LOGW("Render pipeline: attachment {} has storage usage, which prevents framebuffer compression on many GPUs", i);
+		}
+
+		auto      &use     = uses[i];
+		const bool on_chip = use.read_after_written && !use.read_before_written && !use.kept;
+
+		// Fixed-rate compressed attachments are loaded and stored at their compressed size, see RenderTarget::create_attachment_image()
+		if (attachment.compressed_bits_per_pixel > 0 && !on_chip)
+		{
+			const uint64_t compressed_size = pixels * attachment.compressed_bits_per_pixel / 8;
+			const uint64_t saved_size      = size > compressed_size ? size - compressed_size : 0;
+			if (info.load_op == VK_ATTACHMENT_LOAD_OP_LOAD)
+			{
+				saved_read_bytes += saved_size;
+			}
+			if (info.store_op == VK_ATTACHMENT_STORE_OP_STORE)
+			{
+				saved_write_bytes += saved_size;
+			}
+		}
+
+		if (!on_chip)
+		{
+			continue;
+		}
+
+		if (info.load_op == VK_ATTACHMENT_LOAD_OP_LOAD && use.written_first_as_color && attachment_validation != AttachmentValidation::Disabled)
+		{
+			LOGW("Render pipeline: attachment {} is loaded, although a subpass writes it before it is read", i);
+			if (attachment_validation == AttachmentValidation::Fix)
+			{
+				info.load_op = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			}
+		}
+
+		if (info.store_op == VK_ATTACHMENT_STORE_OP_STORE && attachment_validation != AttachmentValidation::Disabled)
+		{
+			LOGW("Render pipeline: attachment {} is stored, although it is only read as an input attachment within the render pass", i);
+			if (attachment_validation == AttachmentValidation::Fix)
+			{
+				info.store_op = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			}
+		}
+
+		// Neither loaded nor stored, its memory is never accessed, but transient images may only be used as attachments
+		const VkImageUsageFlags attachment_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+		                                           VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		if (info.load_op != VK_ATTACHMENT_LOAD_OP_LOAD && info.store_op == VK_ATTACHMENT_STORE_OP_DONT_CARE &&
+		    !(attachment.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) && !(attachment.usage & ~attachment_usage) &&
+		    attachment_validation != AttachmentValidation::Disabled)
+		{
+			LOGW("Render pipeline: attachment {} could be created with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, in lazily allocated memory", i);
+		}
+
+		// Sampling it from a next render pass would read it, and it is not written either if it is not stored
+		saved_read_bytes += size;
+		if (info.store_op == VK_ATTACHMENT_STORE_OP_DONT_CARE)
+		{
+			saved_write_bytes += size;
+		}
+	}
+}
+
 void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_target, VkSubpassContents contents)
 {
 	assert(!subpasses.empty() && "Render pipeline should contain at least one sub-pass");
@@ -96,6 +362,15 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 		clear_value.push_back({0.0f, 0.0f, 0.0f, 1.0f});
 	}
 
+	validate_attachments(render_target);
+	total_saved_read_bytes.fetch_add(saved_read_bytes, std::memory_order_relaxed);
+	total_saved_write_bytes.fetch_add(saved_write_bytes, std::memory_order_relaxed);
+
+	for (auto &subpass : subpasses)
+	{
+		subpass->pre_draw(command_buffer);
+	}
+
 	for (size_t i = 0; i < subpasses.size(); ++i)
 	{
 		active_subpass_index = i;
@@ -104,27 +379,68 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 
 		subpass->update_render_target_attachments(render_target);
 
+		// Only the first subpass follows the requested contents, the following ones are recorded inline
+		VkSubpassContents subpass_contents = i == 0 ? contents : VK_SUBPASS_CONTENTS_INLINE;
+
+		// Retained secondary command buffers are recorded on this thread, and only when they are out of date
+		bool record_retained = subpass->retains_draws();
+
+		// Workers need their own frame resources, thread index 0 belongs to the recording thread
+		bool record_parallel = !record_retained && job_system && job_system->get_worker_count() > 0 && subpass_contents == VK_SUBPASS_CONTENTS_INLINE &&
+		                       subpass->supports_parallel_recording() &&
+		                       subpass->get_render_context().get_active_frame().get_thread_count() > job_system->get_worker_count();
+
+		subpass->set_recording_job_system(record_parallel ? job_system : nullptr);
+
+		bool record_secondary = last_subpass_secondary && !record_retained && !record_parallel && i + 1 == subpasses.size() &&
+		                        subpass_contents == VK_SUBPASS_CONTENTS_INLINE;
+
+		if (record_retained || record_parallel || record_secondary)
+		{
+			subpass_contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+		}
+
 		if (i == 0)
 		{
-			command_buffer.begin_render_pass(render_target, load_store, clear_value, subpasses, contents);
+			command_buffer.begin_render_pass(render_target, load_store, clear_value, subpasses, subpass_contents);
 		}
 		else
 		{
-			command_buffer.next_subpass();
+			command_buffer.next_subpass(subpass_contents);
 		}
 
+		last_subpass_contents = subpass_contents;
+
 		if (subpass->get_debug_name().empty())
 		{
 			subpass->set_debug_name(fmt::format("RP subpass #{}", i));
 		}
 		ScopedDebugLabel subpass_debug_label{command_buffer, subpass->get_debug_name().c_str()};
 
-		subpass->draw(command_buffer);
+		if (record_secondary)
+		{
+			auto &secondary_command_buffer = command_buffer.get_command_pool().request_command_buffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+			secondary_command_buffer.continue_render_pass(command_buffer);
+			subpass->draw(secondary_command_buffer);
+			secondary_command_buffer.end();
+
+			command_buffer.execute_commands(secondary_command_buffer);
+		}
+		else
+		{
+			subpass->draw(command_buffer);
+		}
 	}
 
 	active_subpass_index = 0;
 }
 
+VkSubpassContents RenderPipeline::get_last_subpass_contents() const
+{
+	return last_subpass_contents;
+}
+
 std::unique_ptr<Subpass> &RenderPipeline::get_active_subpass()
 {
 	return subpasses[active_subpass_index];
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -23,8 +23,25 @@
 #include "rendering/render_frame.h"
 #include "rendering/subpass.h"
 
+#include <atomic>
+
 namespace vkb
 {
+class JobSystem;
+
+/**
+ * @brief How a RenderPipeline checks the attachments that can stay on-chip, see RenderPipeline::set_attachment_validation()
+ */
+enum class AttachmentValidation
+{
+	/// No check
+	Disabled,
+	/// A warning is logged for each wasteful load/store operation or missing transient usage
+	Warn,
+	/// Wasteful load/store operations are also changed
+	Fix
+};
+
 /**
  * @brief A RenderPipeline is a sequence of Subpass objects.
  * Subpass holds shaders and can draw the core::sg::Scene.
@@ -35,6 +52,9 @@ namespace vkb
  * GeometrySubpass -> Processes Scene for Shaders, use by itself if shader requires no lighting
  * ForwardSubpass -> Binds lights at the beginning of a GeometrySubpass to create Forward Rendering, should be used with most default shaders
  * LightingSubpass -> Holds a Global Light uniform, Can be combined with GeometrySubpass to create Deferred Rendering
+ * IndirectSubpass -> Culls and draws the Scene from the GPU with indirect draws, with the lighting of ForwardSubpass
+ *
+ * With a job system set, subpasses supporting it are recorded into secondary command buffers in parallel.
  */
 class RenderPipeline
 {
@@ -84,11 +104,67 @@ class RenderPipeline
 
 	std::vector<std::unique_ptr<Subpass>> &get_subpasses();
 
+	/**
+	 * @brief Sets the job system used to record subpasses in parallel, or nullptr to record every subpass inline
+	 *        The render context must be prepared with more threads than the job system has workers,
+	 *        otherwise the subpasses are recorded inline.
+	 */
+	void set_job_system(JobSystem *job_system);
+
+	/**
+	 * @brief Sets whether the last subpass, when it would be recorded inline, is recorded in a secondary command buffer instead
+	 *        The commands recorded after draw() in the last subpass must then be secondary command buffers too,
+	 *        which lets them be recorded once and executed again, like a retained GUI.
+	 */
+	void set_last_subpass_secondary(bool last_subpass_secondary);
+
+	/**
+	 * @brief Sets how the attachments written by a subpass, then only read as input attachments by the following ones, are checked.
+	 *        Such attachments, like a G-buffer, can stay on-chip on tile-based GPUs: they need not be stored, nor loaded,
+	 *        and they can be transient attachments in lazily allocated memory. Warn is the default.
+	 * @remarks Fix assumes that these attachments are not read after the render pass, it overrides set_load_store().
+	 */
+	void set_attachment_validation(AttachmentValidation attachment_validation);
+
+	/**
+	 * @brief Sets up the subpasses and load/store operations to draw to render targets from RenderTarget::create_multisampled_func()
+	 *        The subpasses outputting to the swapchain render to the multisampled color instead, and the last one resolves it on tile.
+	 *        The depth is resolved by the last subpass using it, when the device supports a depth resolve mode. Only the attachments
+	 *        read afterwards are stored. Call it again after changing the subpasses.
+	 * @return The attachment holding the depth that a following render pass can sample if config.sample_resolved is set: the resolved
+	 *         depth, or the multisampled depth if the device cannot resolve it
+	 */
+	uint32_t set_multisampling(const MultisampleConfig &config);
+
+	/**
+	 * @brief Sets up the load/store operations to draw to render targets from RenderTarget::create_motion_vectors_func()
+	 *        The color, depth and velocity are cleared and stored, so that a temporal resolve can sample them after the pass.
+	 *        The subpasses writing velocity are set with GeometrySubpass::set_motion_vectors().
+	 */
+	void set_motion_vectors();
+
+	/**
+	 * @brief Returns the estimated external memory bytes read and written that attachments kept on-chip saved since the last call,
+	 *        compared to storing them in a render pass and sampling them in the next one, plus those saved by fixed-rate
+	 *        compressed attachments compared to uncompressed ones, and resets them
+	 */
+	static std::pair<uint64_t, uint64_t> take_saved_bandwidth();
+
 	/**
 	 * @brief Record draw commands for each Subpass
+	 *        The pre_draw() commands of every subpass are recorded first, before beginning the render pass.
+	 *        With a job system set, subpasses which support parallel recording and would otherwise be recorded inline
+	 *        begin with secondary command buffer contents, and execute the secondary command buffers they record.
+	 *        The same goes for the last subpass if set_last_subpass_secondary() is set, and for the subpasses whose
+	 *        Subpass::retains_draws() is true, which execute the secondary command buffers they retain.
 	 */
 	void draw(CommandBuffer &command_buffer, RenderTarget &render_target, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
+	/**
+	 * @return The contents of the last subpass recorded by draw(), which any further commands in that subpass must match
+	 */
+	VkSubpassContents get_last_subpass_contents() const;
+
 	/**
 	 * @return Subpass currently being recorded, or the first one
 	 *         if drawing has not started
@@ -105,5 +181,29 @@ class RenderPipeline
 	std::vector<VkClearValue> clear_value = std::vector<VkClearValue>(2);
 
 	size_t active_subpass_index{0};
+
+	JobSystem *job_system{nullptr};
+
+	bool last_subpass_secondary{false};
+
+	VkSubpassContents last_subpass_contents{VK_SUBPASS_CONTENTS_INLINE};
+
+	AttachmentValidation attachment_validation{AttachmentValidation::Warn};
+
+	/// Hash of the render target, subpass attachments and load/store operations last validated
+	size_t validated_configuration{0};
+
+	/// Estimated bytes saved on each draw by the attachments kept on-chip or fixed-rate compressed
+	uint64_t saved_read_bytes{0};
+	uint64_t saved_write_bytes{0};
+
+	static std::atomic<uint64_t> total_saved_read_bytes;
+	static std::atomic<uint64_t> total_saved_write_bytes;
+
+	/**
+	 * @brief Checks the load/store operations and the usage of the attachments that stay on-chip, when the configuration changed,
+	 *        and estimates the bandwidth they save
+	 */
+	void validate_attachments(const RenderTarget &render_target);
 };
 }        // namespace vkb
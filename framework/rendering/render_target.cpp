@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,7 +17,10 @@
 
 #include "rendering/render_target.h"
 
+#include "common/strings.h"
 #include "core/device.h"
+#include "core/util/logging.hpp"
+#include "rendering/attachment_allocator.h"
 
 namespace vkb
 {
@@ -30,6 +33,84 @@ struct CompareExtent2D
 		return !(lhs.width == rhs.width && lhs.height == rhs.height) && (lhs.width < rhs.width && lhs.height < rhs.height);
 	}
 };
+
+/**
+ * @return The number of components of the color formats which fixed-rate compression is commonly supported for, 0 for the others
+ */
+uint32_t get_fixed_rate_component_count(VkFormat format)
+{
+	switch (format)
+	{
+		case VK_FORMAT_R8_UNORM:
+		case VK_FORMAT_R8_SRGB:
+		case VK_FORMAT_R16_SFLOAT:
+			return 1;
+		case VK_FORMAT_R8G8_UNORM:
+		case VK_FORMAT_R8G8_SRGB:
+		case VK_FORMAT_R16G16_SFLOAT:
+			return 2;
+		case VK_FORMAT_R5G6B5_UNORM_PACK16:
+		case VK_FORMAT_R8G8B8_UNORM:
+		case VK_FORMAT_R8G8B8_SRGB:
+		case VK_FORMAT_B8G8R8_UNORM:
+		case VK_FORMAT_B8G8R8_SRGB:
+		case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+			return 3;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+		case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
+		case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @return The bits per component of a single fixed-rate flag
+ */
+uint32_t get_fixed_rate_bits_per_component(VkImageCompressionFixedRateFlagBitsEXT flag)
+{
+	// VK_IMAGE_COMPRESSION_FIXED_RATE_1BPC_BIT_EXT is the first bit, and each following bit adds one bit per component
+	uint32_t bits_per_component = 1;
+	for (uint32_t bit = static_cast<uint32_t>(flag); bit > 1; bit >>= 1)
+	{
+		++bits_per_component;
+	}
+
+	return bits_per_component;
+}
+
+/**
+ * @return The bits per pixel of an attachment image once compressed, 0 if it is not fixed-rate compressed
+ */
+uint32_t get_compressed_bits_per_pixel(const core::Image &image)
+{
+	auto &device = image.get_device();
+
+	if (!device.is_enabled(VK_EXT_IMAGE_COMPRESSION_CONTROL_EXTENSION_NAME) || is_depth_format(image.get_format()) ||
+	    (image.get_usage() & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT))
+	{
+		return 0;
+	}
+
+	uint32_t component_count = get_fixed_rate_component_count(image.get_format());
+	if (component_count == 0)
+	{
+		return 0;
+	}
+
+	auto fixed_rates = fixed_rate_compression_flags_to_vector(image.get_applied_compression().imageCompressionFixedRateFlags);
+	if (fixed_rates.empty())
+	{
+		return 0;
+	}
+
+	return get_fixed_rate_bits_per_component(fixed_rates.front()) * component_count;
+}
 }        // namespace
 
 Attachment::Attachment(VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage) :
@@ -39,12 +120,12 @@ Attachment::Attachment(VkFormat format, VkSampleCountFlagBits samples, VkImageUs
 {
 }
 const RenderTarget::CreateFunc RenderTarget::DEFAULT_CREATE_FUNC = [](core::Image &&swapchain_image) -> std::unique_ptr<RenderTarget> {
-	VkFormat depth_format = get_suitable_depth_format(swapchain_image.get_device().get_gpu().get_handle());
+	VkFormat depth_format = get_suitable_depth_format(swapchain_image.get_device().get_gpu());
 
-	core::Image depth_image{swapchain_image.get_device(), swapchain_image.get_extent(),
-	                        depth_format,
-	                        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
-	                        VMA_MEMORY_USAGE_GPU_ONLY};
+	// The compression of the swapchain images is requested when creating the swapchain, see Swapchain
+	core::Image depth_image = create_attachment_image(swapchain_image.get_device(), swapchain_image.get_extent(), depth_format,
+	                                                  VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+	                                                  AttachmentCompressionPolicy{});
 
 	std::vector<core::Image> images;
 	images.push_back(std::move(swapchain_image));
@@ -53,6 +134,232 @@ const RenderTarget::CreateFunc RenderTarget::DEFAULT_CREATE_FUNC = [](core::Imag
 	return std::make_unique<RenderTarget>(std::move(images));
 };
 
+RenderTarget::CreateFunc RenderTarget::create_motion_vectors_func()
+{
+	return [](core::Image &&color_image) -> std::unique_ptr<RenderTarget> {
+		auto &device = color_image.get_device();
+		auto &extent = color_image.get_extent();
+
+		VkFormat depth_format = get_suitable_depth_format(device.get_gpu());
+
+		// The depth is sampled to pick the velocity of the closest neighbor, which keeps the edges of moving objects sharp
+		core::Image depth_image = create_attachment_image(device, extent, depth_format,
+		                                                  VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		                                                  AttachmentCompressionPolicy{});
+
+		core::Image velocity_image = create_attachment_image(device, extent, VELOCITY_FORMAT,
+		                                                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		                                                     AttachmentCompressionPolicy{});
+
+		// Same order as the MV_*_ATTACHMENT indices
+		std::vector<core::Image> images;
+		images.push_back(std::move(color_image));
+		images.push_back(std::move(depth_image));
+		images.push_back(std::move(velocity_image));
+
+		return std::make_unique<RenderTarget>(std::move(images));
+	};
+}
+
+RenderTarget::CreateFunc RenderTarget::create_gbuffer_func(const GBufferConfig &config)
+{
+	return [config](core::Image &&swapchain_image) -> std::unique_ptr<RenderTarget> {
+		auto &device = swapchain_image.get_device();
+		auto &extent = swapchain_image.get_extent();
+
+		VkFormat depth_format = get_suitable_depth_format(device.get_gpu());
+
+		auto formats = get_gbuffer_formats(config.layout);
+
+		VkImageUsageFlags usage = VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+		if (config.transient)
+		{
+			usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		}
+
+		auto &attachment_allocator = device.get_attachment_allocator();
+
+		core::Image depth_image = attachment_allocator.create_image(
+		    "gbuffer_depth",
+		    core::ImageBuilder(extent)
+		        .with_format(depth_format)
+		        .with_usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | usage));
+
+		core::Image albedo_image = attachment_allocator.create_image(
+		    "gbuffer_albedo",
+		    core::ImageBuilder(extent)
+		        .with_format(formats.first)
+		        .with_usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | usage));
+
+		core::Image normal_image = attachment_allocator.create_image(
+		    "gbuffer_normal",
+		    core::ImageBuilder(extent)
+		        .with_format(formats.second)
+		        .with_usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | usage));
+
+		// Same order as the GB_*_ATTACHMENT indices
+		std::vector<core::Image> images;
+		images.push_back(std::move(swapchain_image));
+		images.push_back(std::move(depth_image));
+		images.push_back(std::move(albedo_image));
+		images.push_back(std::move(normal_image));
+
+		if (config.light_accumulation)
+		{
+			// The light may be read by a following subpass or sampled by a following render pass, so it is never transient
+			images.push_back(attachment_allocator.create_image(
+			    "gbuffer_light",
+			    core::ImageBuilder(extent)
+			        .with_format(LIGHT_FORMAT)
+			        .with_usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)));
+		}
+
+		return std::make_unique<RenderTarget>(std::move(images));
+	};
+}
+
+std::pair<VkFormat, VkFormat> RenderTarget::get_gbuffer_formats(GBufferLayout layout)
+{
+	if (layout == GBufferLayout::Full)
+	{
+		return {VK_FORMAT_R32G32B32A32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+	}
+
+	// The packed layout has the same formats, the octahedral normal only needs two components which leaves the third for the roughness
+	return {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_A2B10G10R10_UNORM_PACK32};
+}
+
+RenderTarget::CreateFunc RenderTarget::create_multisampled_func(const MultisampleConfig &config)
+{
+	return [config](core::Image &&swapchain_image) -> std::unique_ptr<RenderTarget> {
+		auto &device = swapchain_image.get_device();
+		auto &extent = swapchain_image.get_extent();
+
+		VkFormat color_format = swapchain_image.get_format();
+		VkFormat depth_format = get_suitable_depth_format(device.get_gpu());
+
+		bool depth_resolved = get_depth_resolve_mode(device, config.depth_resolve_mode) != VK_RESOLVE_MODE_NONE;
+
+		// Multisampled attachments are resolved on tile and discarded, unless the depth cannot be resolved and is sampled instead
+		VkImageUsageFlags depth_usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		depth_usage |= (config.sample_resolved && !depth_resolved) ? VK_IMAGE_USAGE_SAMPLED_BIT : VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+		// Resolve attachments not read afterwards are transient, which should leave them without memory on tile-based GPUs
+		VkImageUsageFlags color_resolve_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		color_resolve_usage |= config.sample_resolved ? VK_IMAGE_USAGE_SAMPLED_BIT : VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+		VkImageUsageFlags depth_resolve_usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		depth_resolve_usage |= (config.sample_resolved && depth_resolved) ? VK_IMAGE_USAGE_SAMPLED_BIT : VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+		core::Image depth_image{device, extent, depth_format, depth_usage, VMA_MEMORY_USAGE_GPU_ONLY, config.samples};
+
+		core::Image color_image{device, extent, color_format,
+		                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+		                        VMA_MEMORY_USAGE_GPU_ONLY, config.samples};
+
+		core::Image color_resolve_image = create_attachment_image(device, extent, color_format, color_resolve_usage, config.resolve_compression);
+
+		core::Image depth_resolve_image{device, extent, depth_format, depth_resolve_usage, VMA_MEMORY_USAGE_GPU_ONLY};
+
+		// Same order as the MS_*_ATTACHMENT indices, the multisampled depth being the first depth attachment is the default
+		// depth attachment of the subpasses
+		std::vector<core::Image> images;
+		images.push_back(std::move(swapchain_image));
+		images.push_back(std::move(depth_image));
+		images.push_back(std::move(color_image));
+		images.push_back(std::move(color_resolve_image));
+		images.push_back(std::move(depth_resolve_image));
+
+		return std::make_unique<RenderTarget>(std::move(images));
+	};
+}
+
+VkResolveModeFlagBits RenderTarget::get_depth_resolve_mode(Device &device, VkResolveModeFlagBits preferred)
+{
+	if (!device.is_enabled(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME) ||
+	    !device.get_gpu().get_instance().is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		return VK_RESOLVE_MODE_NONE;
+	}
+
+	VkPhysicalDeviceDepthStencilResolvePropertiesKHR depth_resolve_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEPTH_STENCIL_RESOLVE_PROPERTIES_KHR};
+	VkPhysicalDeviceProperties2KHR                   gpu_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+	gpu_properties.pNext = &depth_resolve_properties;
+	vkGetPhysicalDeviceProperties2KHR(device.get_gpu().get_handle(), &gpu_properties);
+
+	if (depth_resolve_properties.supportedDepthResolveModes & preferred)
+	{
+		return preferred;
+	}
+
+	// Sample zero is always supported when the extension is
+	return VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+}
+
+core::Image RenderTarget::create_attachment_image(Device &device, const VkExtent3D &extent, VkFormat format, VkImageUsageFlags usage,
+                                                  const AttachmentCompressionPolicy &policy, VkSampleCountFlagBits samples)
+{
+	core::ImageBuilder builder{extent};
+	builder.with_format(format)
+	    .with_usage(usage)
+	    .with_sample_count(samples)
+	    .with_vma_usage(VMA_MEMORY_USAGE_GPU_ONLY)
+	    .with_memory_tag(allocated::MemoryTag::RenderTarget);
+
+	auto &resource_pool = device.get_transient_resource_pool();
+
+	if (usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+	{
+		return resource_pool.request_image(builder);
+	}
+
+	if ((usage & VK_IMAGE_USAGE_STORAGE_BIT) && policy.compression != AttachmentCompression::Disabled)
+	{
+		LOGW("Render target: {} attachment has storage usage, which prevents framebuffer compression on many GPUs", to_string(format));
+	}
+
+	if (policy.compression == AttachmentCompression::Default || !device.is_enabled(VK_EXT_IMAGE_COMPRESSION_CONTROL_EXTENSION_NAME))
+	{
+		return resource_pool.request_image(builder);
+	}
+
+	VkImageCompressionControlEXT        compression_control{VK_STRUCTURE_TYPE_IMAGE_COMPRESSION_CONTROL_EXT};
+	VkImageCompressionFixedRateFlagsEXT fixed_rate{VK_IMAGE_COMPRESSION_FIXED_RATE_NONE_EXT};
+
+	if (policy.compression == AttachmentCompression::Disabled)
+	{
+		compression_control.flags = VK_IMAGE_COMPRESSION_DISABLED_EXT;
+	}
+	else
+	{
+		// Rates are listed from the lowest bitrate, so the first one allowed by the policy saves the most bandwidth
+		auto supported = query_supported_fixed_rate_compression(device.get_gpu().get_handle(), builder.create_info);
+		for (auto rate : fixed_rate_compression_flags_to_vector(supported.imageCompressionFixedRateFlags))
+		{
+			if (get_fixed_rate_bits_per_component(rate) >= policy.min_fixed_rate_bits_per_component)
+			{
+				fixed_rate = rate;
+				break;
+			}
+		}
+
+		if (fixed_rate == VK_IMAGE_COMPRESSION_FIXED_RATE_NONE_EXT)
+		{
+			LOGI("Render target: {} attachment does not support fixed-rate compression of at least {} bits per component, using default compression",
+			     to_string(format), policy.min_fixed_rate_bits_per_component);
+			return builder.build(device);
+		}
+
+		compression_control.flags                        = VK_IMAGE_COMPRESSION_FIXED_RATE_EXPLICIT_EXT;
+		compression_control.compressionControlPlaneCount = 1;
+		compression_control.pFixedRateFlags              = &fixed_rate;
+	}
+
+	builder.with_extension<VkImageCompressionControlEXT>(compression_control);
+
+	return builder.build(device);
+}
+
 vkb::RenderTarget::RenderTarget(std::vector<core::Image> &&images) :
     device{images.back().get_device()},
     images{std::move(images)}
@@ -73,7 +380,8 @@ vkb::RenderTarget::RenderTarget(std::vector<core::Image> &&images) :
 		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Extent size is not unique"};
 	}
 
-	extent = *unique_extent.begin();
+	extent        = *unique_extent.begin();
+	render_extent = extent;
 
 	for (auto &image : this->images)
 	{
@@ -82,9 +390,11 @@ vkb::RenderTarget::RenderTarget(std::vector<core::Image> &&images) :
 			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Image type is not 2D"};
 		}
 
-		views.emplace_back(image, VK_IMAGE_VIEW_TYPE_2D);
+		// Layered images are rendered to with multiview, see set_view_count()
+		views.emplace_back(image, image.get_array_layer_count() > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D);
 
 		attachments.emplace_back(Attachment{image.get_format(), image.get_sample_count(), image.get_usage()});
+		attachments.back().compressed_bits_per_pixel = get_compressed_bits_per_pixel(image);
 	}
 }
 
@@ -111,7 +421,8 @@ vkb::RenderTarget::RenderTarget(std::vector<core::ImageView> &&image_views) :
 	{
 		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Extent size is not unique"};
 	}
-	extent = *unique_extent.begin();
+	extent        = *unique_extent.begin();
+	render_extent = extent;
 
 	for (auto &view : views)
 	{
@@ -120,11 +431,35 @@ vkb::RenderTarget::RenderTarget(std::vector<core::ImageView> &&image_views) :
 	}
 }
 
+RenderTarget::~RenderTarget()
+{
+	device.get_resource_cache().evict_framebuffers(views);
+
+	// The images created by create_attachment_image() are recycled by the next render targets, as on resize
+	views.clear();
+	for (auto &image : images)
+	{
+		device.get_transient_resource_pool().release_image(std::move(image));
+	}
+}
+
 const VkExtent2D &RenderTarget::get_extent() const
 {
 	return extent;
 }
 
+void RenderTarget::set_render_extent(const VkExtent2D &render_extent_)
+{
+	assert(render_extent_.width <= extent.width && render_extent_.height <= extent.height && "The render extent exceeds the images");
+
+	render_extent = render_extent_;
+}
+
+const VkExtent2D &RenderTarget::get_render_extent() const
+{
+	return render_extent;
+}
+
 const std::vector<core::ImageView> &RenderTarget::get_views() const
 {
 	return views;
@@ -165,4 +500,29 @@ VkImageLayout RenderTarget::get_layout(uint32_t attachment) const
 	return attachments[attachment].initial_layout;
 }
 
+void RenderTarget::set_view_count(uint32_t view_count_)
+{
+	assert(view_count_ >= 1 && view_count_ <= 32 && "The view count must fit in a view mask");
+
+	for (auto &view : views)
+	{
+		if (view.get_subresource_range().layerCount < view_count_)
+		{
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Render target views have fewer layers than the view count"};
+		}
+	}
+
+	view_count = view_count_;
+}
+
+uint32_t RenderTarget::get_view_count() const
+{
+	return view_count;
+}
+
+uint32_t RenderTarget::get_view_mask() const
+{
+	return view_count > 1 ? static_cast<uint32_t>((uint64_t{1} << view_count) - 1) : 0;
+}
+
 }        // namespace vkb
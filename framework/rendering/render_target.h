@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -40,11 +40,92 @@ struct Attachment
 
 	VkImageLayout initial_layout{VK_IMAGE_LAYOUT_UNDEFINED};
 
+	/// Bits per pixel of the image with the fixed-rate compression applied to it, 0 if it is not fixed-rate compressed
+	uint32_t compressed_bits_per_pixel{0};
+
 	Attachment() = default;
 
 	Attachment(VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage);
 };
 
+/**
+ * @brief Compression requested for the image of an attachment, see RenderTarget::create_attachment_image()
+ */
+enum class AttachmentCompression
+{
+	/// Lossless framebuffer compression, if the implementation supports it for the image
+	Default,
+
+	/// Lossy fixed-rate compression, falls back to Default if the image does not support a rate allowed by the policy
+	FixedRate,
+
+	/// No compression, for images accessed in ways which compression does not support
+	Disabled
+};
+
+/**
+ * @brief Compression policy of an attachment, fixed-rate compression requires VK_EXT_image_compression_control
+ */
+struct AttachmentCompressionPolicy
+{
+	AttachmentCompression compression{AttachmentCompression::Default};
+
+	/// Lowest fixed-rate bitrate allowed, in bits per component, the lowest supported rate above it is picked
+	uint32_t min_fixed_rate_bits_per_component{4};
+};
+
+/**
+ * @brief Multisampling of the render targets created by RenderTarget::create_multisampled_func(),
+ *        and of the render pipelines drawing to them, see RenderPipeline::set_multisampling()
+ */
+struct MultisampleConfig
+{
+	/// Must be supported by the framebuffer color and depth sample counts of the device
+	VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_4_BIT};
+
+	/// Preferred depth resolve mode, see RenderTarget::get_depth_resolve_mode()
+	VkResolveModeFlagBits depth_resolve_mode{VK_RESOLVE_MODE_SAMPLE_ZERO_BIT};
+
+	/// Whether a following render pass, like postprocessing, samples the resolved color and depth instead of presenting the color
+	bool sample_resolved{false};
+
+	/// Compression of the resolved color when it is sampled, the other attachments are transient
+	AttachmentCompressionPolicy resolve_compression{};
+};
+
+/**
+ * @brief Layout of the G-buffer of the render targets created by RenderTarget::create_gbuffer_func()
+ *        The deferred subpasses must be told which layout they draw to, see GeometrySubpass::set_gbuffer_layout() and
+ *        LightingSubpass::set_gbuffer_layout().
+ */
+enum class GBufferLayout
+{
+	/// RGBA8 albedo, and RGB10A2 normal remapped to [0, 1], 64 bits per pixel
+	Default,
+
+	/// RGBA32F albedo and normal, 256 bits per pixel, which do not fit in the tile storage of most mobile GPUs
+	Full,
+
+	/// RGBA8 albedo with the metallic factor in alpha, and RGB10A2 octahedral normal with the roughness in blue, 64 bits per pixel
+	Packed
+};
+
+/**
+ * @brief G-buffer of the render targets created by RenderTarget::create_gbuffer_func()
+ */
+struct GBufferConfig
+{
+	GBufferLayout layout{GBufferLayout::Packed};
+
+	/// Whether the G-buffer attachments are transient, so that they never need memory on tile-based GPUs
+	bool transient{true};
+
+	/// Whether to add an R11G11B10 light accumulation attachment, which the lighting subpass writes instead of the swapchain
+	/// image, for a following subpass or render pass to read. The load store and clear values of the render pipeline need
+	/// a fifth entry for it.
+	bool light_accumulation{false};
+};
+
 /**
  * @brief RenderTarget contains three vectors for: core::Image, core::ImageView and Attachment.
  * The first two are Vulkan images and corresponding image views respectively.
@@ -61,6 +142,84 @@ class RenderTarget
 
 	static const CreateFunc DEFAULT_CREATE_FUNC;
 
+	/// Attachments of the render targets created by create_multisampled_func()
+	static constexpr uint32_t MS_SWAPCHAIN_ATTACHMENT     = 0;
+	static constexpr uint32_t MS_DEPTH_ATTACHMENT         = 1;
+	static constexpr uint32_t MS_COLOR_ATTACHMENT         = 2;
+	static constexpr uint32_t MS_COLOR_RESOLVE_ATTACHMENT = 3;
+	static constexpr uint32_t MS_DEPTH_RESOLVE_ATTACHMENT = 4;
+
+	/// Attachments of the render targets created by create_motion_vectors_func()
+	static constexpr uint32_t MV_COLOR_ATTACHMENT    = 0;
+	static constexpr uint32_t MV_DEPTH_ATTACHMENT    = 1;
+	static constexpr uint32_t MV_VELOCITY_ATTACHMENT = 2;
+
+	/// Format of the velocity attachment, the motion of each pixel since the previous frame in UV units
+	static constexpr VkFormat VELOCITY_FORMAT = VK_FORMAT_R16G16_SFLOAT;
+
+	/// Attachments of the render targets created by create_gbuffer_func(), the ones LightingSubpass reads
+	static constexpr uint32_t GB_SWAPCHAIN_ATTACHMENT = 0;
+	static constexpr uint32_t GB_DEPTH_ATTACHMENT     = 1;
+	static constexpr uint32_t GB_ALBEDO_ATTACHMENT    = 2;
+	static constexpr uint32_t GB_NORMAL_ATTACHMENT    = 3;
+	static constexpr uint32_t GB_LIGHT_ATTACHMENT     = 4;
+
+	/// Format of the light accumulation attachment, half the size of RGBA16F for the unsigned light values
+	static constexpr VkFormat LIGHT_FORMAT = VK_FORMAT_B10G11R11_UFLOAT_PACK32;
+
+	/**
+	 * @brief Returns a function creating multisampled render targets, meant to be resolved on tile by the last subpass
+	 *        The multisampled color and depth are transient attachments in lazily allocated memory, so that they never
+	 *        need to be backed by memory on tile-based GPUs. The single-sampled resolve attachments are sampled if
+	 *        config.sample_resolved is set, and transient otherwise. If the device cannot resolve depth, the multisampled
+	 *        depth is sampled instead.
+	 */
+	static CreateFunc create_multisampled_func(const MultisampleConfig &config);
+
+	/**
+	 * @brief Returns a function creating render targets for temporal techniques, with a velocity attachment
+	 *        The color, depth and velocity are all sampled after the render pass, see TemporalAntiAliasing, so the color
+	 *        should not be a swapchain image: it is meant for the scaled render targets of RenderContext::set_resolution_target().
+	 *        Geometry subpasses write the velocity with GeometrySubpass::set_motion_vectors().
+	 */
+	static CreateFunc create_motion_vectors_func();
+
+	/**
+	 * @brief Returns a function creating render targets for deferred rendering, with the G-buffer attachments of the layout
+	 *        The G-buffer is only used within a frame, so its memory is shared by the render targets of all frames, see
+	 *        AttachmentAllocator. Its attachments are read as input attachments, and stored only by pipelines which need to.
+	 *        The color, depth and albedo with the normal fit in 128 bits per pixel with the Default and Packed layouts, which
+	 *        lets drivers of tile-based GPUs merge the geometry and lighting subpasses without spilling to memory.
+	 */
+	static CreateFunc create_gbuffer_func(const GBufferConfig &config);
+
+	/**
+	 * @return The formats of the albedo and normal attachments of a G-buffer layout
+	 */
+	static std::pair<VkFormat, VkFormat> get_gbuffer_formats(GBufferLayout layout);
+
+	/**
+	 * @brief Returns the depth resolve mode to use on the device, the preferred one if it is supported, or
+	 *        VK_RESOLVE_MODE_NONE if VK_KHR_depth_stencil_resolve is not enabled
+	 */
+	static VkResolveModeFlagBits get_depth_resolve_mode(Device &device, VkResolveModeFlagBits preferred);
+
+	/**
+	 * @brief Creates the image of an attachment with a compression policy
+	 *        Transient images are never stored, so their compression is left to the implementation. Usage flags which prevent
+	 *        framebuffer compression on common GPUs, like VK_IMAGE_USAGE_STORAGE_BIT, are reported.
+	 *        Images without a compression request are recycled through the transient resource pool of the device, to which
+	 *        render targets release their images on destruction.
+	 * @param device The device
+	 * @param extent The extent of the image
+	 * @param format The format of the image
+	 * @param usage The usage of the image
+	 * @param policy The compression requested for the image
+	 * @param samples The sample count of the image
+	 */
+	static core::Image create_attachment_image(Device &device, const VkExtent3D &extent, VkFormat format, VkImageUsageFlags usage,
+	                                           const AttachmentCompressionPolicy &policy, VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
+
 	RenderTarget(std::vector<core::Image> &&images);
 
 	RenderTarget(std::vector<core::ImageView> &&image_views);
@@ -69,12 +228,26 @@ class RenderTarget
 
 	RenderTarget(RenderTarget &&) = delete;
 
+	/**
+	 * @brief Evicts the framebuffers using the views from the resource cache
+	 */
+	~RenderTarget();
+
 	RenderTarget &operator=(const RenderTarget &other) noexcept = delete;
 
 	RenderTarget &operator=(RenderTarget &&other) noexcept = delete;
 
 	const VkExtent2D &get_extent() const;
 
+	/**
+	 * @brief Sets the extent rendered to, from the origin of the images, which is their whole extent by default
+	 *        Render passes begun on the target are limited to it, so the resolution can change without recreating the images.
+	 * @param render_extent The extent, at most get_extent()
+	 */
+	void set_render_extent(const VkExtent2D &render_extent);
+
+	const VkExtent2D &get_render_extent() const;
+
 	const std::vector<core::ImageView> &get_views() const;
 
 	const std::vector<Attachment> &get_attachments() const;
@@ -101,8 +274,24 @@ class RenderTarget
 
 	VkImageLayout get_layout(uint32_t attachment) const;
 
+	/**
+	 * @brief Sets the number of views rendered at once with VK_KHR_multiview, each to a layer of the attachments
+	 *        Images with several layers, like the ones of an XR swapchain with a layer per eye, are viewed as arrays, and the
+	 *        render passes begun on the target render view i to layer i of all attachments. The device must enable the
+	 *        multiview feature.
+	 * @param view_count The number of views, at most the layers of the images, 1 to disable multiview
+	 */
+	void set_view_count(uint32_t view_count);
+
+	uint32_t get_view_count() const;
+
+	/**
+	 * @return The view mask of the subpasses rendering to the target, 0 if multiview is disabled
+	 */
+	uint32_t get_view_mask() const;
+
   private:
-	Device const &device;
+	Device &device;
 
 	VkExtent2D extent{};
 
@@ -117,5 +306,11 @@ class RenderTarget
 
 	/// By default the output attachments is attachment 0
 	std::vector<uint32_t> output_attachments = {0};
+
+	/// See set_render_extent()
+	VkExtent2D render_extent{};
+
+	/// See set_view_count()
+	uint32_t view_count{1};
 };
 }        // namespace vkb
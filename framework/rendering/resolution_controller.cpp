@@ -0,0 +1,116 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/resolution_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/util/logging.hpp"
+#include "rendering/gpu_profiler.h"
+
+namespace vkb
+{
+ResolutionController::ResolutionController(double target_gpu_time, float min_scale) :
+    target_gpu_time{target_gpu_time}
+{
+	set_min_scale(min_scale);
+}
+
+void ResolutionController::set_target_gpu_time(double target_gpu_time_)
+{
+	target_gpu_time = target_gpu_time_;
+}
+
+double ResolutionController::get_target_gpu_time() const
+{
+	return target_gpu_time;
+}
+
+void ResolutionController::set_min_scale(float min_scale_)
+{
+	assert(min_scale_ > 0.0f && min_scale_ <= 1.0f && "The scale must be in ]0, 1]");
+
+	min_scale = min_scale_;
+	scale     = std::max(scale, min_scale);
+}
+
+float ResolutionController::get_min_scale() const
+{
+	return min_scale;
+}
+
+void ResolutionController::set_measured_scope(const std::string &name)
+{
+	measured_scope = name;
+}
+
+void ResolutionController::update(const GpuProfiler &profiler)
+{
+	if (profiler.get_frames_read() == last_frames_read)
+	{
+		return;
+	}
+
+	last_frames_read = profiler.get_frames_read();
+
+	if (++frames_since_change < SETTLE_FRAMES)
+	{
+		return;
+	}
+
+	double gpu_time = 0.0;
+
+	for (auto &scope : profiler.get_scopes())
+	{
+		if (measured_scope.empty() ? scope.depth == 0 : scope.name == measured_scope)
+		{
+			gpu_time += scope.time;
+		}
+	}
+
+	if (gpu_time <= 0.0 || std::abs(gpu_time - target_gpu_time) <= target_gpu_time * MARGIN)
+	{
+		return;
+	}
+
+	float new_scale = std::clamp(scale * static_cast<float>(std::sqrt(target_gpu_time / gpu_time)), min_scale, 1.0f);
+
+	if (new_scale != scale)
+	{
+		scale               = new_scale;
+		frames_since_change = 0;
+
+		LOGD("GPU time {:.2f} ms for a target of {:.2f} ms, rendering at {:.0f}%", gpu_time * 1000.0, target_gpu_time * 1000.0, scale * 100.0f);
+	}
+}
+
+float ResolutionController::get_scale() const
+{
+	return scale;
+}
+
+VkExtent2D ResolutionController::get_render_extent(const VkExtent2D &extent) const
+{
+	auto scale_dimension = [this](uint32_t dimension) {
+		uint32_t scaled = static_cast<uint32_t>(std::ceil(dimension * scale / EXTENT_ALIGNMENT)) * EXTENT_ALIGNMENT;
+		return std::clamp(scaled, std::min(dimension, EXTENT_ALIGNMENT), dimension);
+	};
+
+	return {scale_dimension(extent.width), scale_dimension(extent.height)};
+}
+}        // namespace vkb
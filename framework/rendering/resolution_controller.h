@@ -0,0 +1,94 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class GpuProfiler;
+
+/**
+ * @brief Adapts the resolution the scene is rendered at to hold a GPU time target
+ *
+ * The resolution is a scale of the extent of the frame, applied to both dimensions. Each time the GpuProfiler reads back
+ * a frame, the measured GPU time is compared to the target: outside of a margin around it, the scale is changed by the
+ * square root of their ratio, as the time of fill rate bound content follows the number of pixels. A change is only made
+ * once the smoothed times of the profiler had several frames to follow the previous one.
+ */
+class ResolutionController
+{
+  public:
+	static constexpr float DEFAULT_MIN_SCALE = 0.5f;
+
+	/// Fraction of the target the time may differ from it by before the scale is changed
+	static constexpr double MARGIN = 0.1;
+
+	/// Number of frames read back after a change before the next one
+	static constexpr uint32_t SETTLE_FRAMES = 8;
+
+	/// The dimensions of the scaled extents are multiples of it, so they only take a few values
+	static constexpr uint32_t EXTENT_ALIGNMENT = 8;
+
+	/**
+	 * @param target_gpu_time The target in seconds
+	 * @param min_scale The lowest scale, in ]0, 1]
+	 */
+	ResolutionController(double target_gpu_time, float min_scale = DEFAULT_MIN_SCALE);
+
+	void set_target_gpu_time(double target_gpu_time);
+
+	double get_target_gpu_time() const;
+
+	void set_min_scale(float min_scale);
+
+	float get_min_scale() const;
+
+	/**
+	 * @brief Sets the scope of the GpuProfiler the time of is held, empty to hold the time of all top level scopes
+	 */
+	void set_measured_scope(const std::string &name);
+
+	/**
+	 * @brief Adapts the scale to the last frame read back by the profiler, if it read one since the last update
+	 */
+	void update(const GpuProfiler &profiler);
+
+	float get_scale() const;
+
+	/**
+	 * @return The extent to render at, for a frame of the given extent
+	 */
+	VkExtent2D get_render_extent(const VkExtent2D &extent) const;
+
+  private:
+	float scale{1.0f};
+
+	double target_gpu_time;
+
+	float min_scale;
+
+	std::string measured_scope;
+
+	uint64_t last_frames_read{0};
+
+	uint32_t frames_since_change{0};
+};
+}        // namespace vkb
@@ -0,0 +1,140 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/shading_rate_controller.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "core/device.h"
+#include "core/util/logging.hpp"
+#include "rendering/gpu_profiler.h"
+
+namespace vkb
+{
+ShadingRateController::ShadingRateController(Device &device, double target_gpu_time) :
+    target_gpu_time{target_gpu_time}
+{
+	assert(device.uses_fragment_shading_rates() && "The device does not use fragment shading rates");
+
+	uint32_t count = 0;
+	vkGetPhysicalDeviceFragmentShadingRatesKHR(device.get_gpu().get_handle(), &count, nullptr);
+
+	std::vector<VkPhysicalDeviceFragmentShadingRateKHR> supported_rates(count, {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_KHR});
+	vkGetPhysicalDeviceFragmentShadingRatesKHR(device.get_gpu().get_handle(), &count, supported_rates.data());
+
+	// Whatever the GPU supports, 1x1 always is
+	rates.push_back({1, 1});
+
+	for (auto &supported_rate : supported_rates)
+	{
+		if (!(supported_rate.sampleCounts & VK_SAMPLE_COUNT_1_BIT))
+		{
+			continue;
+		}
+
+		auto &size = supported_rate.fragmentSize;
+		auto  it   = std::find_if(rates.begin(), rates.end(), [&size](const VkExtent2D &rate) { return rate.width * rate.height == size.width * size.height; });
+
+		if (it == rates.end())
+		{
+			rates.push_back(size);
+		}
+		else if (std::abs(static_cast<int32_t>(size.width) - static_cast<int32_t>(size.height)) <
+		         std::abs(static_cast<int32_t>(it->width) - static_cast<int32_t>(it->height)))
+		{
+			*it = size;
+		}
+	}
+
+	std::sort(rates.begin(), rates.end(), [](const VkExtent2D &lhs, const VkExtent2D &rhs) { return lhs.width * lhs.height < rhs.width * rhs.height; });
+}
+
+void ShadingRateController::set_target_gpu_time(double target_gpu_time_)
+{
+	target_gpu_time = target_gpu_time_;
+}
+
+double ShadingRateController::get_target_gpu_time() const
+{
+	return target_gpu_time;
+}
+
+void ShadingRateController::set_measured_scope(const std::string &name)
+{
+	measured_scope = name;
+}
+
+void ShadingRateController::update(const GpuProfiler &profiler)
+{
+	if (profiler.get_frames_read() == last_frames_read)
+	{
+		return;
+	}
+
+	last_frames_read = profiler.get_frames_read();
+
+	if (++frames_since_change < SETTLE_FRAMES)
+	{
+		return;
+	}
+
+	double gpu_time = 0.0;
+
+	for (auto &scope : profiler.get_scopes())
+	{
+		if (measured_scope.empty() ? scope.depth == 0 : scope.name == measured_scope)
+		{
+			gpu_time += scope.time;
+		}
+	}
+
+	if (gpu_time <= 0.0)
+	{
+		return;
+	}
+
+	size_t new_rate_index = rate_index;
+
+	if (gpu_time > target_gpu_time * (1.0 + COARSEN_MARGIN) && rate_index + 1 < rates.size())
+	{
+		++new_rate_index;
+	}
+	else if (gpu_time < target_gpu_time * (1.0 - REFINE_MARGIN) && rate_index > 0)
+	{
+		--new_rate_index;
+	}
+
+	if (new_rate_index != rate_index)
+	{
+		rate_index          = new_rate_index;
+		frames_since_change = 0;
+
+		LOGD("GPU time {:.2f} ms for a target of {:.2f} ms, shading at {}x{}", gpu_time * 1000.0, target_gpu_time * 1000.0, rates[rate_index].width, rates[rate_index].height);
+	}
+}
+
+const VkExtent2D &ShadingRateController::get_rate() const
+{
+	return rates[rate_index];
+}
+
+const std::vector<VkExtent2D> &ShadingRateController::get_rates() const
+{
+	return rates;
+}
+}        // namespace vkb
@@ -0,0 +1,92 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+class GpuProfiler;
+
+/**
+ * @brief Adapts the fragment shading rate of the subpasses rendering the scene to hold a GPU time target
+ *
+ * The rates are the ones the GPU supports without multisampling, one per fragment area from 1x1 up, preferring square ones.
+ * Each time the GpuProfiler reads back a frame, the measured GPU time is compared to the target: the rate is made
+ * coarser when the time is over the target, and finer when it is well under it. A change is only made once the
+ * smoothed times of the profiler had several frames to follow the previous one.
+ *
+ * Coarser rates shade fewer fragments, which only reduces the GPU time of fill rate bound content.
+ */
+class ShadingRateController
+{
+  public:
+	/// Fraction of the target the time may exceed it by before the rate is made coarser
+	static constexpr double COARSEN_MARGIN = 0.05;
+
+	/// Fraction of the target the time must be under it by before the rate is made finer
+	static constexpr double REFINE_MARGIN = 0.2;
+
+	/// Number of frames read back after a change before the next one
+	static constexpr uint32_t SETTLE_FRAMES = 16;
+
+	/**
+	 * @param device The device, which must use fragment shading rates
+	 * @param target_gpu_time The target in seconds
+	 */
+	ShadingRateController(Device &device, double target_gpu_time);
+
+	void set_target_gpu_time(double target_gpu_time);
+
+	double get_target_gpu_time() const;
+
+	/**
+	 * @brief Sets the scope of the GpuProfiler the time of is held, empty to hold the time of all top level scopes
+	 */
+	void set_measured_scope(const std::string &name);
+
+	/**
+	 * @brief Adapts the rate to the last frame read back by the profiler, if it read one since the last update
+	 */
+	void update(const GpuProfiler &profiler);
+
+	const VkExtent2D &get_rate() const;
+
+	/**
+	 * @return The rates the controller chooses from, from the finest to the coarsest
+	 */
+	const std::vector<VkExtent2D> &get_rates() const;
+
+  private:
+	std::vector<VkExtent2D> rates;
+
+	size_t rate_index{0};
+
+	double target_gpu_time;
+
+	std::string measured_scope;
+
+	uint64_t last_frames_read{0};
+
+	uint32_t frames_since_change{0};
+};
+}        // namespace vkb
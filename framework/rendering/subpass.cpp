@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -46,6 +46,32 @@ void Subpass::update_render_target_attachments(RenderTarget &render_target)
 {
 	render_target.set_input_attachments(input_attachments);
 	render_target.set_output_attachments(output_attachments);
+
+	this->render_target = &render_target;
+}
+
+RenderTarget *Subpass::get_render_target() const
+{
+	return render_target;
+}
+
+void Subpass::pre_draw(CommandBuffer &command_buffer)
+{
+}
+
+bool Subpass::supports_parallel_recording() const
+{
+	return false;
+}
+
+void Subpass::set_recording_job_system(JobSystem *job_system)
+{
+	recording_job_system = job_system;
+}
+
+bool Subpass::retains_draws() const
+{
+	return false;
 }
 
 RenderContext &Subpass::get_render_context()
@@ -138,6 +164,40 @@ LightingState &Subpass::get_lighting_state()
 	return lighting_state;
 }
 
+const sg::SceneSnapshot *Subpass::get_scene_snapshot() const
+{
+	return render_context.get_active_frame().get_scene_snapshot();
+}
+
+PersistentLightBuffer &Subpass::request_light_buffer(VkDeviceSize size, size_t slot_count)
+{
+	auto &frame_light_buffers = lighting_state.frame_light_buffers;
+
+	// The number of render frames only changes once the device is idle
+	frame_light_buffers.resize(render_context.get_render_frames().size());
+
+	auto &light_buffer = frame_light_buffers[render_context.get_active_frame_index()];
+
+	if (!light_buffer.buffer || light_buffer.buffer->get_size() != size)
+	{
+		light_buffer.buffer = std::make_unique<core::Buffer>(render_context.get_device(), size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+		light_buffer.slots.assign(slot_count, {});
+	}
+
+	return light_buffer;
+}
+
+void Subpass::update_light(PersistentLightBuffer &light_buffer, size_t slot, VkDeviceSize offset, sg::Light &scene_light, uint32_t transform_version, const Light &light)
+{
+	auto version = std::make_tuple(&scene_light, scene_light.get_version(), transform_version);
+
+	if (light_buffer.slots[slot] != version)
+	{
+		light_buffer.buffer->update(&light, sizeof(Light), offset);
+		light_buffer.slots[slot] = version;
+	}
+}
+
 const std::string &Subpass::get_debug_name() const
 {
 	return debug_name;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,20 +17,27 @@
 
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <tuple>
+
 #include "buffer_pool.h"
 #include "common/helpers.h"
+#include "core/buffer.h"
 #include "core/shader_module.h"
 #include "rendering/pipeline_state.h"
 #include "rendering/render_context.h"
 #include "rendering/render_frame.h"
 #include "scene_graph/components/light.h"
 #include "scene_graph/node.h"
+#include "scene_graph/scene_snapshot.h"
 
 #include "common/glm_common.h"
 
 namespace vkb
 {
 class CommandBuffer;
+class JobSystem;
 
 struct alignas(16) Light
 {
@@ -40,6 +47,18 @@ struct alignas(16) Light
 	glm::vec2 info;             // (only used for spot lights) info.x represents light inner cone angle, info.y represents light outer cone angle
 };
 
+/**
+ * @brief A light uniform buffer of a render frame, kept across the frames rendered with it
+ *        Only the lights which changed since the render frame last used the buffer are uploaded to it.
+ */
+struct PersistentLightBuffer
+{
+	std::unique_ptr<core::Buffer> buffer;
+
+	/// The light last written to each slot of the buffer, with the versions of the light and of its transform then
+	std::vector<std::tuple<const sg::Light *, uint32_t, uint32_t>> slots;
+};
+
 struct LightingState
 {
 	std::vector<Light> directional_lights;
@@ -49,6 +68,9 @@ struct LightingState
 	std::vector<Light> spot_lights;
 
 	BufferAllocation light_buffer;
+
+	/// The light buffers of the render frames, see Subpass::allocate_lights()
+	std::vector<PersistentLightBuffer> frame_light_buffers;
 };
 
 /**
@@ -92,12 +114,43 @@ class Subpass
 	 */
 	void update_render_target_attachments(RenderTarget &render_target);
 
+	/**
+	 * @return The render target of the render pass the subpass is drawn in, as of the last update_render_target_attachments()
+	 */
+	RenderTarget *get_render_target() const;
+
 	/**
 	 * @brief Draw virtual function
 	 * @param command_buffer Command buffer to use to record draw commands
 	 */
 	virtual void draw(CommandBuffer &command_buffer) = 0;
 
+	/**
+	 * @brief Records the commands draw() depends on which cannot be recorded within a render pass, such as compute dispatches
+	 *        This function is called by the RenderPipeline for every subpass before beginning the render pass.
+	 * @param command_buffer Command buffer the render pass is recorded to
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Whether draw() can record its commands into secondary command buffers on a job system,
+	 *        see set_recording_job_system(). Subpasses record inline only by default.
+	 */
+	virtual bool supports_parallel_recording() const;
+
+	/**
+	 * @brief Sets the job system draw() records secondary command buffers on, or nullptr to record inline
+	 *        This is set by the RenderPipeline before each draw, and only for subpasses supporting parallel recording.
+	 *        Jobs allocate their frame resources with the thread index given by JobSystem::get_thread_index().
+	 */
+	void set_recording_job_system(JobSystem *job_system);
+
+	/**
+	 * @brief Whether draw() only executes secondary command buffers, which it retains across frames
+	 *        The RenderPipeline then begins the subpass with secondary command buffer contents. False by default.
+	 */
+	virtual bool retains_draws() const;
+
 	RenderContext &get_render_context();
 
 	const ShaderSource &get_vertex_shader() const;
@@ -134,20 +187,30 @@ class Subpass
 
 	LightingState &get_lighting_state();
 
+	/**
+	 * @return The scene snapshot the active frame is recorded from, or null to read the live scene
+	 *         Subpasses read transforms and cameras through it, see sg::get_node_state().
+	 */
+	const sg::SceneSnapshot *get_scene_snapshot() const;
+
 	const std::string &get_debug_name() const;
 
 	void set_debug_name(const std::string &name);
 
 	/**
 	 * @brief Prepares the lighting state to have its lights
+	 *        The lights are written to a buffer of the active render frame which is kept across frames,
+	 *        only the lights whose type, properties or transform changed since the frame last used it are uploaded.
+	 *        As the buffer is read when the frame is submitted, it must be called at most once per frame.
 	 *
 	 * @tparam A light structure that has 'directional_lights', 'point_lights' and 'spot_light' array fields defined.
+	 * @tparam Lights A range of light pointers, such as a std::vector or a sg::ComponentView of sg::Light
 	 * @param scene_lights All of the light components from the scene graph
 	 * @param light_count The maximum amount of lights allowed for any given type of light.
 	 */
-	template <typename T>
-	void allocate_lights(const std::vector<sg::Light *> &scene_lights,
-	                     size_t                          light_count)
+	template <typename T, typename Lights>
+	void allocate_lights(const Lights &scene_lights,
+	                     size_t        light_count)
 	{
 		assert(scene_lights.size() <= (light_count * sg::LightType::Max) && "Exceeding Max Light Capacity");
 
@@ -155,38 +218,46 @@ class Subpass
 		lighting_state.point_lights.clear();
 		lighting_state.spot_lights.clear();
 
+		auto &light_buffer = request_light_buffer(sizeof(T), light_count * sg::LightType::Max);
+
 		for (auto &scene_light : scene_lights)
 		{
 			const auto &properties = scene_light->get_properties();
-			auto       &transform  = scene_light->get_node()->get_transform();
+			auto        transform  = sg::get_node_state(get_scene_snapshot(), *scene_light->get_node());
 
-			Light light{{transform.get_translation(), static_cast<float>(scene_light->get_light_type())},
+			Light light{{transform.translation, static_cast<float>(scene_light->get_light_type())},
 			            {properties.color, properties.intensity},
-			            {transform.get_rotation() * properties.direction, properties.range},
+			            {transform.rotation * properties.direction, properties.range},
 			            {properties.inner_cone_angle, properties.outer_cone_angle}};
 
 			switch (scene_light->get_light_type())
 			{
 				case sg::LightType::Directional:
 				{
-					if (lighting_state.directional_lights.size() < light_count)
+					size_t index = lighting_state.directional_lights.size();
+					if (index < light_count)
 					{
+						update_light(light_buffer, index, offsetof(T, directional_lights) + index * sizeof(Light), *scene_light, transform.version, light);
 						lighting_state.directional_lights.push_back(light);
 					}
 					break;
 				}
 				case sg::LightType::Point:
 				{
-					if (lighting_state.point_lights.size() < light_count)
+					size_t index = lighting_state.point_lights.size();
+					if (index < light_count)
 					{
+						update_light(light_buffer, light_count + index, offsetof(T, point_lights) + index * sizeof(Light), *scene_light, transform.version, light);
 						lighting_state.point_lights.push_back(light);
 					}
 					break;
 				}
 				case sg::LightType::Spot:
 				{
-					if (lighting_state.spot_lights.size() < light_count)
+					size_t index = lighting_state.spot_lights.size();
+					if (index < light_count)
 					{
+						update_light(light_buffer, 2 * light_count + index, offsetof(T, spot_lights) + index * sizeof(Light), *scene_light, transform.version, light);
 						lighting_state.spot_lights.push_back(light);
 					}
 					break;
@@ -196,15 +267,7 @@ class Subpass
 			}
 		}
 
-		T light_info;
-
-		std::copy(lighting_state.directional_lights.begin(), lighting_state.directional_lights.end(), light_info.directional_lights);
-		std::copy(lighting_state.point_lights.begin(), lighting_state.point_lights.end(), light_info.point_lights);
-		std::copy(lighting_state.spot_lights.begin(), lighting_state.spot_lights.end(), light_info.spot_lights);
-
-		auto &render_frame          = get_render_context().get_active_frame();
-		lighting_state.light_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(T));
-		lighting_state.light_buffer.update(light_info);
+		lighting_state.light_buffer = BufferAllocation{*light_buffer.buffer, sizeof(T), 0};
 	}
 
   protected:
@@ -218,7 +281,24 @@ class Subpass
 	/// The structure containing all the requested render-ready lights for the scene
 	LightingState lighting_state{};
 
+	/// Job system to record the next draw() on, if any
+	JobSystem *recording_job_system{nullptr};
+
+	/// See get_render_target()
+	RenderTarget *render_target{nullptr};
+
   private:
+	/**
+	 * @return The light buffer of the active render frame, recreated with empty slots if it does not have the size given
+	 */
+	PersistentLightBuffer &request_light_buffer(VkDeviceSize size, size_t slot_count);
+
+	/**
+	 * @brief Writes a light to a slot of a light buffer, unless the slot already has this version of the light
+	 * @param transform_version Version of the transform the light was read from, see sg::Transform::get_version()
+	 */
+	void update_light(PersistentLightBuffer &light_buffer, size_t slot, VkDeviceSize offset, sg::Light &scene_light, uint32_t transform_version, const Light &light);
+
 	std::string debug_name{};
 
 	ShaderSource vertex_shader;
@@ -0,0 +1,101 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/clustered_forward_subpass.h"
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+#include <stdexcept>
+
+namespace vkb
+{
+namespace
+{
+sg::PerspectiveCamera &get_perspective_camera(sg::Camera &camera)
+{
+	auto perspective_camera = dynamic_cast<sg::PerspectiveCamera *>(&camera);
+	if (!perspective_camera)
+	{
+		throw std::runtime_error("ClusteredForwardSubpass requires a perspective camera");
+	}
+
+	return *perspective_camera;
+}
+}        // namespace
+
+ClusteredForwardSubpass::ClusteredForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
+    ForwardSubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    perspective_camera{get_perspective_camera(camera)}
+{
+}
+
+void ClusteredForwardSubpass::prepare()
+{
+	for (auto &mesh : meshes)
+	{
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			sub_mesh->get_mut_shader_variant().add_definitions(LightClusters::get_definitions());
+		}
+	}
+
+	// Adds the lighting definitions and builds the shader variants
+	ForwardSubpass::prepare();
+
+	if (!light_clusters)
+	{
+		light_clusters = std::make_unique<LightClusters>(render_context.get_device());
+	}
+}
+
+void ClusteredForwardSubpass::pre_draw(CommandBuffer &command_buffer)
+{
+	ForwardSubpass::pre_draw(command_buffer);
+
+	light_clusters->cull(command_buffer, get_render_context().get_active_frame(), thread_index, perspective_camera, scene.get_component_view<sg::Light>());
+}
+
+void ClusteredForwardSubpass::draw(CommandBuffer &command_buffer)
+{
+	// Only the directional lights are in the lighting state, so that the shader variant does not depend on the number of other lights
+	std::vector<sg::Light *> directional_lights;
+	for (auto scene_light : scene.get_component_view<sg::Light>())
+	{
+		if (scene_light->get_light_type() == sg::LightType::Directional)
+		{
+			directional_lights.push_back(scene_light);
+		}
+	}
+
+	allocate_lights<ForwardLights>(directional_lights, MAX_FORWARD_LIGHT_COUNT);
+	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
+
+	light_clusters->bind(command_buffer, 0, 6);
+
+	bind_shadows(command_buffer);
+
+	GeometrySubpass::draw(command_buffer);
+}
+}        // namespace vkb
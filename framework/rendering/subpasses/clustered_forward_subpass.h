@@ -0,0 +1,72 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/light_clusters.h"
+#include "rendering/subpasses/forward_subpass.h"
+
+namespace vkb
+{
+namespace sg
+{
+class PerspectiveCamera;
+}        // namespace sg
+
+/**
+ * @brief This subpass forward renders a Scene with any number of point and spot lights, binned into clusters on the GPU
+ *
+ * Each frame, before the render pass, the point and spot lights are binned into the clusters of the camera view,
+ * see LightClusters. Fragments then only shade the lights of their cluster.
+ *
+ * Directional lights are shaded by every fragment, up to MAX_FORWARD_LIGHT_COUNT like in ForwardSubpass.
+ * The fragment shader must support the CLUSTERED_LIGHTING definition, like base.frag. The camera must be a
+ * sg::PerspectiveCamera.
+ */
+class ClusteredForwardSubpass : public ForwardSubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass for clustered forward rendering
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source
+	 * @param fragment_shader Fragment shader source, compiled with the CLUSTERED_LIGHTING definition
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera used to look at the scene, a sg::PerspectiveCamera
+	 */
+	ClusteredForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~ClusteredForwardSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Bins the point and spot lights of the scene into the clusters
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Record draw commands
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+  private:
+	sg::PerspectiveCamera &perspective_camera;
+
+	std::unique_ptr<LightClusters> light_clusters;
+};
+}        // namespace vkb
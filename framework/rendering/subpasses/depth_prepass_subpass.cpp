@@ -0,0 +1,107 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/depth_prepass_subpass.h"
+
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "core/physical_device.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/sub_mesh.h"
+
+namespace vkb
+{
+DepthPrepassSubpass::DepthPrepassSubpass(RenderContext &render_context, sg::Scene &scene, sg::Camera &camera) :
+    GeometrySubpass{render_context, ShaderSource{"depth_prepass.vert"}, ShaderSource{"depth_prepass.frag"}, scene, camera}
+{
+	// Only the depth attachment is written
+	set_output_attachments({});
+
+	culling_stats = false;
+}
+
+void DepthPrepassSubpass::prepare()
+{
+	enabled = mode == DepthPrepassMode::Enabled;
+	if (mode == DepthPrepassMode::Automatic)
+	{
+		enabled = select_depth_prepass(render_context.get_device().get_gpu());
+	}
+
+	GeometrySubpass::prepare();
+}
+
+void DepthPrepassSubpass::draw(CommandBuffer &command_buffer)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	GeometrySubpass::draw(command_buffer);
+}
+
+void DepthPrepassSubpass::set_mode(DepthPrepassMode mode_)
+{
+	mode = mode_;
+}
+
+bool DepthPrepassSubpass::is_enabled() const
+{
+	return enabled;
+}
+
+bool DepthPrepassSubpass::select_depth_prepass(const PhysicalDevice &gpu)
+{
+	switch (gpu.get_properties().vendorID)
+	{
+		case 0x13B5:        // Arm
+		case 0x5143:        // Qualcomm
+		case 0x1010:        // Imagination
+		case 0x106B:        // Apple
+			return false;
+		default:
+			return true;
+	}
+}
+
+bool DepthPrepassSubpass::is_prepassed(const sg::SubMesh &sub_mesh)
+{
+	return sub_mesh.get_material()->alpha_mode == sg::AlphaMode::Opaque;
+}
+
+PipelineLayout &DepthPrepassSubpass::prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules)
+{
+	// Only the vertex shader is needed to draw depth
+	assert(!shader_modules.empty());
+
+	return GeometrySubpass::prepare_pipeline_layout(command_buffer, {shader_modules[0]});
+}
+
+void DepthPrepassSubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+{
+	// No push constants are used in the pre-pass
+}
+
+void DepthPrepassSubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t lod, uint32_t instance_count)
+{
+	if (is_prepassed(sub_mesh))
+	{
+		GeometrySubpass::draw_submesh_command(command_buffer, sub_mesh, lod, instance_count);
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,111 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/subpasses/geometry_subpass.h"
+
+namespace vkb
+{
+class PhysicalDevice;
+
+/**
+ * @brief Whether a DepthPrepassSubpass draws the depth of the scene before it is shaded
+ */
+enum class DepthPrepassMode
+{
+	/// Chosen for the device by DepthPrepassSubpass::select_depth_prepass()
+	Automatic,
+
+	Disabled,
+
+	Enabled
+};
+
+/**
+ * @brief Draws the depth of the opaque objects of a Scene before a ForwardSubpass shades them, see ForwardSubpass::set_depth_prepass()
+ *
+ * The front-to-back sort of the draws is per node, so heavy materials of overlapping meshes are still shaded several
+ * times per pixel. The pre-pass lays down the depth with position-only draws, each submesh binding only its position
+ * stream of the packed vertex data, then the forward subpass tests the depth for equality without writing it, so that
+ * each pixel is shaded once. Materials with AlphaMode::Mask discard fragments by their texture, so they are not
+ * drawn in the pre-pass, and neither are transparent ones.
+ *
+ * The subpass must come first in the render pipeline, with the same depth attachment as the forward subpass, and
+ * it has no color outputs. depth_prepass.vert computes the position exactly like base.vert, both invariant, so that
+ * the depths of the two subpasses are equal. The camera and scene must be the same as those of the forward subpass.
+ */
+class DepthPrepassSubpass : public GeometrySubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass drawing the depth of the scene with depth_prepass.vert
+	 * @param render_context Render context
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera used to look at the scene
+	 */
+	DepthPrepassSubpass(RenderContext &render_context, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~DepthPrepassSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Draws the depth of the opaque objects, if the pre-pass is enabled
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Sets whether the pre-pass draws, Automatic by default, takes effect on the next prepare()
+	 */
+	void set_mode(DepthPrepassMode mode);
+
+	/**
+	 * @return Whether the pre-pass draws, Automatic resolved for the device by prepare()
+	 */
+	bool is_enabled() const;
+
+	/**
+	 * @brief Chooses whether a pre-pass pays off on a GPU
+	 *        Tile-based GPUs of Arm, Qualcomm, Imagination and Apple already remove most hidden fragments before shading them,
+	 *        so drawing the geometry twice costs more vertex work and bandwidth than it saves. Others shade fragments in
+	 *        submission order, and save the shading of every overdrawn fragment.
+	 */
+	static bool select_depth_prepass(const PhysicalDevice &gpu);
+
+	/**
+	 * @return Whether a submesh is drawn in the pre-pass, and tested for equal depth in the forward subpass
+	 */
+	static bool is_prepassed(const sg::SubMesh &sub_mesh);
+
+  protected:
+	virtual PipelineLayout &prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules) override;
+
+	virtual void prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh) override;
+
+	/**
+	 * @brief Skips the draws of the submeshes which are not prepassed
+	 */
+	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t lod, uint32_t instance_count) override;
+
+  private:
+	DepthPrepassMode mode{DepthPrepassMode::Automatic};
+
+	/// Resolved on prepare
+	bool enabled{false};
+};
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2020, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -19,19 +19,42 @@
 
 #include "common/utils.h"
 #include "common/vk_common.h"
+#include "rendering/cascaded_shadow_map.h"
+#include "rendering/ray_query_shadows.h"
+#include "rendering/subpasses/depth_prepass_subpass.h"
 #include "rendering/render_context.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
+#include "scene_graph/components/light.h"
 #include "scene_graph/components/material.h"
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
+#include "scene_graph/components/perspective_camera.h"
 #include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
 
+#include <stdexcept>
+
 namespace vkb
 {
+namespace
+{
+sg::Light *find_shadow_casting_light(sg::Scene &scene)
+{
+	for (auto light : scene.get_component_view<sg::Light>())
+	{
+		if (light->get_light_type() == sg::LightType::Directional)
+		{
+			return light;
+		}
+	}
+
+	return nullptr;
+}
+}        // namespace
+
 ForwardSubpass::ForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
     GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera}
 {
@@ -39,7 +62,31 @@ ForwardSubpass::ForwardSubpass(RenderContext &render_context, ShaderSource &&ver
 
 void ForwardSubpass::prepare()
 {
-	auto &device = render_context.get_device();
+	prepare_bindless_materials();
+	prepare_constant_data_strategy();
+
+	draw_definitions.clear();
+
+	if (ray_query_shadows)
+	{
+		shadow_technique = ShadowTechnique::RayQuery;
+		draw_definitions = ray_query_shadows->get_definitions();
+	}
+	else if (shadow_map)
+	{
+		if (!dynamic_cast<sg::PerspectiveCamera *>(&camera))
+		{
+			throw std::runtime_error("Cascaded shadow maps require a perspective camera");
+		}
+
+		shadow_technique = ShadowTechnique::ShadowMap;
+		draw_definitions = {"CASCADED_SHADOWS"};
+	}
+	else
+	{
+		shadow_technique = ShadowTechnique::None;
+	}
+
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
@@ -50,18 +97,111 @@ void ForwardSubpass::prepare()
 			variant.add_definitions({"MAX_LIGHT_COUNT " + std::to_string(MAX_FORWARD_LIGHT_COUNT)});
 
 			variant.add_definitions(light_type_definitions);
-
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
 		}
 	}
+
+	prepare_shader_modules();
+}
+
+void ForwardSubpass::pre_draw(CommandBuffer &command_buffer)
+{
+	GeometrySubpass::pre_draw(command_buffer);
+
+	if (shadow_technique == ShadowTechnique::None)
+	{
+		return;
+	}
+
+	auto light = find_shadow_casting_light(scene);
+	if (!light)
+	{
+		return;
+	}
+
+	if (shadow_technique == ShadowTechnique::RayQuery)
+	{
+		ray_query_shadows->trace(command_buffer, *light, get_scene_snapshot());
+	}
+	else
+	{
+		ScopedDebugLabel debug_label{command_buffer, "Shadow maps"};
+
+		shadow_map->update(static_cast<sg::PerspectiveCamera &>(camera), *light, get_scene_snapshot());
+		shadow_map->draw(command_buffer);
+	}
 }
 
 void ForwardSubpass::draw(CommandBuffer &command_buffer)
 {
-	allocate_lights<ForwardLights>(scene.get_components<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+	allocate_lights<ForwardLights>(scene.get_component_view<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
 	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
 
+	bind_shadows(command_buffer);
+
 	GeometrySubpass::draw(command_buffer);
 }
+
+void ForwardSubpass::set_shadow_map(CascadedShadowMap *shadow_map_)
+{
+	shadow_map = shadow_map_;
+}
+
+void ForwardSubpass::set_ray_query_shadows(RayQueryShadows *ray_query_shadows_)
+{
+	ray_query_shadows = ray_query_shadows_;
+}
+
+ShadowTechnique ForwardSubpass::get_shadow_technique() const
+{
+	return shadow_technique;
+}
+
+void ForwardSubpass::set_depth_prepass(DepthPrepassSubpass *depth_prepass_)
+{
+	depth_prepass = depth_prepass_;
+}
+
+void ForwardSubpass::bind_shadows(CommandBuffer &command_buffer)
+{
+	switch (shadow_technique)
+	{
+		case ShadowTechnique::ShadowMap:
+			shadow_map->bind(command_buffer, 0, 5, 9);
+			break;
+		case ShadowTechnique::RayQuery:
+			ray_query_shadows->bind(command_buffer, 0, 5);
+			break;
+		default:
+			return;
+	}
+
+	// The shadows were recorded with viewports of their own
+	const auto &extent = command_buffer.get_current_render_pass().render_area;
+
+	VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+	command_buffer.set_viewport(0, {viewport});
+
+	VkRect2D scissor{{0, 0}, extent};
+	command_buffer.set_scissor(0, {scissor});
+}
+
+void ForwardSubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t lod, uint32_t instance_count)
+{
+	// Transparent draws set their own depth state
+	if (depth_prepass && depth_prepass->is_enabled() && sub_mesh.get_material()->alpha_mode != sg::AlphaMode::Blend)
+	{
+		DepthStencilState depth_stencil_state = get_depth_stencil_state();
+
+		if (DepthPrepassSubpass::is_prepassed(sub_mesh))
+		{
+			// The pre-pass wrote the depth of the closest surfaces, only their fragments are shaded
+			depth_stencil_state.depth_write_enable = VK_FALSE;
+			depth_stencil_state.depth_compare_op   = VK_COMPARE_OP_EQUAL;
+		}
+
+		command_buffer.set_depth_stencil_state(depth_stencil_state);
+	}
+
+	GeometrySubpass::draw_submesh_command(command_buffer, sub_mesh, lod, instance_count);
+}
 }        // namespace vkb
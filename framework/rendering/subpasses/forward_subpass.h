@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2022, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -25,6 +25,10 @@
 
 namespace vkb
 {
+class CascadedShadowMap;
+class DepthPrepassSubpass;
+class RayQueryShadows;
+
 namespace sg
 {
 class Scene;
@@ -41,8 +45,22 @@ struct alignas(16) ForwardLights
 	Light spot_lights[MAX_FORWARD_LIGHT_COUNT];
 };
 
+/**
+ * @brief Shadows of the first directional light of the scene in the forward subpasses
+ */
+enum class ShadowTechnique
+{
+	None,
+	ShadowMap,
+	RayQuery
+};
+
 /**
  * @brief This subpass is responsible for rendering a Scene
+ *
+ * The first directional light may cast shadows, with either cascaded shadow maps or ray query shadows, which are
+ * recorded in pre_draw(). The fragment shader must then support the CASCADED_SHADOWS and RAY_QUERY_SHADOWS definitions,
+ * like base.frag.
  */
 class ForwardSubpass : public GeometrySubpass
 {
@@ -61,10 +79,59 @@ class ForwardSubpass : public GeometrySubpass
 
 	virtual void prepare() override;
 
+	/**
+	 * @brief Draws the shadow maps or traces the shadows of the first directional light, if any
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer) override;
+
 	/**
 	 * @brief Record draw commands
 	 */
 	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Shades the first directional light with cascaded shadow maps, to be set before prepare()
+	 *        The camera must be a sg::PerspectiveCamera.
+	 */
+	void set_shadow_map(CascadedShadowMap *shadow_map);
+
+	/**
+	 * @brief Shades the first directional light with ray query shadows, to be set before prepare()
+	 *        They take precedence over a shadow map, which can be set as a fallback for devices without ray queries.
+	 */
+	void set_ray_query_shadows(RayQueryShadows *ray_query_shadows);
+
+	/**
+	 * @return The shadow technique chosen by prepare()
+	 */
+	ShadowTechnique get_shadow_technique() const;
+
+	/**
+	 * @brief Tests the depth laid down by a pre-pass for equality without writing it, nullptr by default
+	 *        When the pre-pass is enabled, the submeshes it draws are only shaded where they are visible, the others are
+	 *        drawn with the depth state of the subpass. The pre-pass must come before this subpass in the render pipeline.
+	 */
+	void set_depth_prepass(DepthPrepassSubpass *depth_prepass);
+
+  protected:
+	/**
+	 * @brief Binds the shadows recorded by pre_draw(), and restores the viewport and scissor of the render pass
+	 */
+	void bind_shadows(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Sets the depth test of the opaque draws when there is a depth pre-pass
+	 */
+	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t lod, uint32_t instance_count) override;
+
+  private:
+	CascadedShadowMap *shadow_map{nullptr};
+
+	RayQueryShadows *ray_query_shadows{nullptr};
+
+	ShadowTechnique shadow_technique{ShadowTechnique::None};
+
+	DepthPrepassSubpass *depth_prepass{nullptr};
 };
 
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,20 +16,97 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+#include "common/resource_caching.h"
 #include "common/utils.h"
 #include "common/vk_common.h"
+#include "core/util/logging.hpp"
+#include "core/util/profiling.hpp"
+#include "geometry/frustum.h"
+#include "glsl_compiler.h"
 #include "rendering/render_context.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
+#include "scene_graph/components/lod_group.h"
 #include "scene_graph/components/material.h"
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "scene_graph/components/skin.h"
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
+#include "scene_graph/scene_bvh.h"
+
+#include <core/util/job_system.hpp>
+
+#include <algorithm>
+#include <map>
+#include <unordered_set>
 
 namespace vkb
 {
+namespace
+{
+/**
+ * @brief Sets the box the quantized positions of the mesh drawn are decoded with
+ */
+void set_position_quantization(GlobalUniform &global_uniform, const sg::Mesh *mesh)
+{
+	if (mesh)
+	{
+		global_uniform.position_offset = glm::vec4(mesh->get_position_offset(), 0.0f);
+		global_uniform.position_scale  = glm::vec4(mesh->get_position_scale(), 0.0f);
+	}
+}
+
+/**
+ * @brief Push constants of occlusion_box.vert
+ */
+struct OcclusionBox
+{
+	glm::mat4 view_proj;
+
+	glm::vec4 box_min;
+
+	glm::vec4 box_max;
+};
+
+/**
+ * @brief Model matrices of an instance read with INSTANCING, see base.vert
+ */
+struct InstanceTransform
+{
+	glm::mat4 model;
+
+	glm::mat4 previous_model;
+};
+
+/**
+ * @return The front face of the draws of a node, inverted if the node is flipped
+ */
+VkFrontFace get_front_face(const sg::SceneSnapshot *snapshot, sg::Node &node)
+{
+	const auto scale = sg::get_node_state(snapshot, node).scale;
+	return scale.x * scale.y * scale.z < 0 ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+}
+
+/**
+ * @return The number of indices, or vertices if not indexed, of the opaque submeshes of a mesh
+ */
+uint32_t get_opaque_index_count(const sg::Mesh &mesh)
+{
+	uint32_t index_count = 0;
+	for (auto &sub_mesh : mesh.get_submeshes())
+	{
+		if (sub_mesh->get_material()->alpha_mode != sg::AlphaMode::Blend)
+		{
+			index_count += sub_mesh->vertex_indices != 0 ? sub_mesh->vertex_indices : sub_mesh->vertices_count;
+		}
+	}
+	return index_count;
+}
+}        // namespace
+
 GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
     Subpass{render_context, std::move(vertex_source), std::move(fragment_source)},
     meshes{scene_.get_components<sg::Mesh>()},
@@ -40,130 +117,1493 @@ GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&v
 
 void GeometrySubpass::prepare()
 {
-	// Build all shader variance upfront
+	prepare_bindless_materials();
+	prepare_constant_data_strategy();
+
 	auto &device = render_context.get_device();
+
+	float16_variant = float16_arithmetic && device.uses_float16_arithmetic();
+
+	vertex_pulling_variant = vertex_pulling;
+
+	// Instanced runs span several nodes, which neither a retained slot nor an occlusion predicate can be given
+	instancing_variant = instancing && !occlusion_predicates;
+
+	// Slots are assigned again to the mesh nodes, so the results of the frames in flight are not read
+	occlusion_slots.clear();
+	previous_occlusion_frame       = ~0U;
+	occlusion_predicates_supported = false;
+
+	if (occlusion_predicates)
+	{
+		auto conditional_rendering_features = device.get_gpu().find_requested_extension_features<VkPhysicalDeviceConditionalRenderingFeaturesEXT>(
+		    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT);
+
+		if (!device.is_enabled(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME) || conditional_rendering_features == nullptr ||
+		    !conditional_rendering_features->conditionalRendering)
+		{
+			LOGW("Occlusion predicates need VK_EXT_conditional_rendering and the conditionalRendering feature, drawing every mesh");
+		}
+		else
+		{
+			occlusion_predicates_supported = true;
+
+			if (!occlusion_box_vertex_shader)
+			{
+				occlusion_box_vertex_shader   = std::make_unique<ShaderSource>("occlusion_box.vert");
+				occlusion_box_fragment_shader = std::make_unique<ShaderSource>("occlusion_box.frag");
+			}
+		}
+	}
+
+	prepare_shader_modules();
+}
+
+void GeometrySubpass::set_bindless_materials(bool enabled, bool update_after_bind)
+{
+	bindless_materials         = enabled;
+	bindless_update_after_bind = update_after_bind;
+}
+
+void GeometrySubpass::set_float16_arithmetic(bool enabled)
+{
+	float16_arithmetic = enabled;
+}
+
+void GeometrySubpass::set_occlusion_predicates(bool enabled, uint32_t min_index_count)
+{
+	occlusion_predicates      = enabled;
+	occlusion_min_index_count = min_index_count;
+}
+
+void GeometrySubpass::set_vertex_pulling(bool enabled)
+{
+	vertex_pulling = enabled;
+}
+
+void GeometrySubpass::set_instancing(bool enabled)
+{
+	instancing = enabled;
+}
+
+void GeometrySubpass::set_gbuffer_layout(GBufferLayout layout)
+{
+	gbuffer_layout = layout;
+}
+
+void GeometrySubpass::set_motion_vectors(bool enabled)
+{
+	motion_vectors = enabled;
+
+	auto outputs = get_output_attachments();
+	outputs.erase(std::remove(outputs.begin(), outputs.end(), RenderTarget::MV_VELOCITY_ATTACHMENT), outputs.end());
+	if (enabled)
+	{
+		outputs.resize(1);
+		outputs.push_back(RenderTarget::MV_VELOCITY_ATTACHMENT);
+	}
+	set_output_attachments(outputs);
+
+	has_view_proj_history = false;
+}
+
+void GeometrySubpass::set_views(const std::vector<CameraView> &views_)
+{
+	assert(views_.size() <= MAX_VIEW_COUNT && "Too many views for the multiview uniform");
+
+	views = views_;
+}
+
+bool GeometrySubpass::uses_vertex_pulling(const sg::SubMesh &sub_mesh) const
+{
+	return vertex_pulling_variant && sub_mesh.pulled_vertex_buffer != nullptr;
+}
+
+bool GeometrySubpass::uses_instancing(const sg::SubMesh &sub_mesh) const
+{
+	return instancing_variant && sub_mesh.get_material()->alpha_mode != sg::AlphaMode::Blend;
+}
+
+bool GeometrySubpass::uses_occlusion_predicates() const
+{
+	return occlusion_predicates && occlusion_predicates_supported;
+}
+
+void GeometrySubpass::pre_draw(CommandBuffer &command_buffer)
+{
+	if (uses_occlusion_predicates())
+	{
+		copy_occlusion_predicates(command_buffer);
+	}
+}
+
+void GeometrySubpass::set_constant_data_strategy(ConstantDataStrategy strategy)
+{
+	requested_constant_data_strategy = strategy;
+}
+
+ConstantDataStrategy GeometrySubpass::get_constant_data_strategy() const
+{
+	return constant_data_strategy;
+}
+
+ConstantDataStrategy GeometrySubpass::select_constant_data_strategy(const PhysicalDevice &gpu)
+{
+	switch (gpu.get_properties().vendorID)
+	{
+		case 0x13B5:
+			// Arm
+			return ConstantDataStrategy::DescriptorSets;
+		default:
+			return ConstantDataStrategy::DynamicDescriptorSets;
+	}
+}
+
+void GeometrySubpass::prepare_constant_data_strategy()
+{
+	constant_data_strategy = requested_constant_data_strategy;
+	if (constant_data_strategy == ConstantDataStrategy::Automatic)
+	{
+		constant_data_strategy = select_constant_data_strategy(render_context.get_device().get_gpu());
+	}
+
+	if (constant_data_strategy == ConstantDataStrategy::DynamicDescriptorSets)
+	{
+		resource_mode_map["GlobalUniform"] = ShaderResourceMode::Dynamic;
+	}
+	else
+	{
+		resource_mode_map.erase("GlobalUniform");
+	}
+}
+
+void GeometrySubpass::prepare_bindless_materials()
+{
+	bindless_textures.clear();
+	bindless_texture_arrays.clear();
+	bindless_material_uniforms.clear();
+	resource_mode_map.erase("material_textures");
+	resource_mode_map.erase("material_texture_arrays");
+
+	if (!bindless_materials)
+	{
+		return;
+	}
+
+	auto &gpu = render_context.get_device().get_gpu();
+
+	if (!gpu.get_requested_features().shaderSampledImageArrayDynamicIndexing)
+	{
+		LOGW("Bindless materials need the shaderSampledImageArrayDynamicIndexing feature, binding textures per draw");
+		return;
+	}
+
+	std::unordered_map<const sg::Texture *, int32_t> texture_indices;
+	std::vector<sg::Texture *>                       textures;
+
+	// Textures packed in the same texture array with the same sampler share a binding
+	std::map<std::pair<const core::ImageView *, const core::Sampler *>, int32_t> texture_array_indices;
+	std::vector<sg::Texture *>                                                   texture_arrays;
+
+	auto get_texture_index = [&](const sg::Material &material, const std::string &name) -> int32_t {
+		auto texture_it = material.textures.find(name);
+		if (texture_it == material.textures.end())
+		{
+			return -1;
+		}
+
+		auto image = texture_it->second->get_image();
+		if (image && image->get_vk_array_view())
+		{
+			auto key      = std::make_pair(image->get_vk_array_view(), &texture_it->second->get_sampler()->vk_sampler);
+			auto array_it = texture_array_indices.find(key);
+			if (array_it == texture_array_indices.end())
+			{
+				array_it = texture_array_indices.emplace(key, static_cast<int32_t>(texture_arrays.size())).first;
+				texture_arrays.push_back(texture_it->second);
+			}
+
+			// See material_texture_arrays in base.frag
+			return array_it->second | static_cast<int32_t>((image->get_array_layer() + 1) << 16);
+		}
+
+		auto index_it = texture_indices.find(texture_it->second);
+		if (index_it == texture_indices.end())
+		{
+			index_it = texture_indices.emplace(texture_it->second, static_cast<int32_t>(textures.size())).first;
+			textures.push_back(texture_it->second);
+		}
+
+		return index_it->second;
+	};
+
+	for (auto &mesh : meshes)
+	{
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			auto material = sub_mesh->get_material();
+
+			if (material == nullptr || bindless_material_uniforms.count(material) != 0)
+			{
+				continue;
+			}
+
+			BindlessMaterialUniform uniform{};
+			uniform.base_color_texture_index         = get_texture_index(*material, "base_color_texture");
+			uniform.normal_texture_index             = get_texture_index(*material, "normal_texture");
+			uniform.metallic_roughness_texture_index = get_texture_index(*material, "metallic_roughness_texture");
+			uniform.occlusion_texture_index          = get_texture_index(*material, "occlusion_texture");
+			uniform.emissive_texture_index           = get_texture_index(*material, "emissive_texture");
+
+			bindless_material_uniforms.emplace(material, uniform);
+		}
+	}
+
+	auto binding_count = textures.size() + texture_arrays.size();
+
+	if (binding_count == 0)
+	{
+		bindless_material_uniforms.clear();
+		return;
+	}
+
+	auto &limits = gpu.get_properties().limits;
+
+	if (!bindless_update_after_bind &&
+	    (binding_count > limits.maxPerStageDescriptorSamplers || binding_count > limits.maxPerStageDescriptorSampledImages))
+	{
+		LOGW("Bindless materials: the scene has {} textures, more than a shader stage can sample, binding textures per draw", binding_count);
+		bindless_material_uniforms.clear();
+		return;
+	}
+
+	bindless_textures       = std::move(textures);
+	bindless_texture_arrays = std::move(texture_arrays);
+
+	if (bindless_update_after_bind)
+	{
+		resource_mode_map["material_textures"]       = ShaderResourceMode::UpdateAfterBind;
+		resource_mode_map["material_texture_arrays"] = ShaderResourceMode::UpdateAfterBind;
+	}
+}
+
+bool GeometrySubpass::uses_bindless_materials() const
+{
+	return !bindless_textures.empty() || !bindless_texture_arrays.empty();
+}
+
+ShaderVariant GeometrySubpass::get_draw_variant(const sg::SubMesh &sub_mesh) const
+{
+	ShaderVariant variant = sub_mesh.get_shader_variant();
+
+	if (uses_bindless_materials())
+	{
+		variant.add_definitions({"BINDLESS_MATERIALS", "MATERIAL_TEXTURE_COUNT " + std::to_string(bindless_textures.size())});
+
+		if (!bindless_texture_arrays.empty())
+		{
+			variant.add_definitions({"MATERIAL_TEXTURE_ARRAY_COUNT " + std::to_string(bindless_texture_arrays.size())});
+		}
+	}
+
+	if (float16_variant)
+	{
+		variant.add_define("FP16_ARITHMETIC");
+	}
+
+	if (uses_vertex_pulling(sub_mesh))
+	{
+		variant.add_define("VERTEX_PULLING");
+	}
+
+	if (uses_instancing(sub_mesh))
+	{
+		variant.add_define("INSTANCING");
+	}
+
+	if (motion_vectors)
+	{
+		variant.add_define("MOTION_VECTORS");
+	}
+
+	if (gbuffer_layout == GBufferLayout::Packed)
+	{
+		variant.add_define("PACKED_GBUFFER");
+	}
+
+	if (uses_multiview())
+	{
+		variant.add_define("MULTIVIEW");
+	}
+
+	if (!draw_definitions.empty())
+	{
+		variant.add_definitions(draw_definitions);
+	}
+
+	return variant;
+}
+
+void GeometrySubpass::prepare_shader_modules()
+{
+	VKB_PROFILE_SCOPE("Prepare shader modules");
+
+	// Submeshes sharing a material mostly share a variant, so each distinct one is compiled once
+	std::vector<ShaderVariant> variants;
+	std::unordered_set<size_t>    variant_ids;
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
 		{
-			auto &variant     = sub_mesh->get_shader_variant();
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			auto variant = get_draw_variant(*sub_mesh);
+			if (variant_ids.insert(variant.get_id()).second)
+			{
+				variants.push_back(std::move(variant));
+			}
+		}
+	}
+
+	auto &resource_cache = render_context.get_device().get_resource_cache();
+
+	// Keeps the glslang symbol tables alive across the compilations, instead of rebuilding them for every module
+	GLSLCompiler::ProcessScope glslang_process;
+
+	// Modules are built outside of the resource cache lock, one job per variant and stage
+	JobSystem::get().parallel_for(variants.size() * 2, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			auto &variant = variants[i / 2];
+			if (i % 2 == 0)
+			{
+				resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
+			}
+			else
+			{
+				resource_cache.request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			}
 		}
+	});
+}
+
+void GeometrySubpass::bind_bindless_materials(CommandBuffer &command_buffer)
+{
+	// Streamed textures switch images once resident, so the current ones are bound every time
+	for (size_t i = 0; i < bindless_textures.size(); ++i)
+	{
+		auto texture = bindless_textures[i];
+		command_buffer.bind_image(texture->get_image()->get_vk_image_view(), texture->get_sampler()->vk_sampler, 1, 0, to_u32(i));
+	}
+
+	for (size_t i = 0; i < bindless_texture_arrays.size(); ++i)
+	{
+		auto texture = bindless_texture_arrays[i];
+		command_buffer.bind_image(*texture->get_image()->get_vk_array_view(), texture->get_sampler()->vk_sampler, 1, 1, to_u32(i));
+	}
+}
+
+void GeometrySubpass::prepare_bindless_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+{
+	auto uniform_it = bindless_material_uniforms.find(sub_mesh.get_material());
+	if (uniform_it == bindless_material_uniforms.end())
+	{
+		return;
+	}
+
+	auto uniform = uniform_it->second;
+
+	// The factors are read at draw time, as they may be changed
+	if (auto pbr_material = dynamic_cast<const sg::PBRMaterial *>(sub_mesh.get_material()))
+	{
+		uniform.base_color_factor = pbr_material->base_color_factor;
+		uniform.metallic_factor   = pbr_material->metallic_factor;
+		uniform.roughness_factor  = pbr_material->roughness_factor;
+	}
+
+	command_buffer.push_constants(uniform);
+}
+
+std::atomic<uint32_t> GeometrySubpass::visible_draw_count{0};
+std::atomic<uint32_t> GeometrySubpass::culled_draw_count{0};
+
+void GeometrySubpass::cull_mesh_nodes()
+{
+	mesh_nodes.clear();
+	mesh_node_bounds.clear();
+
+	auto snapshot = get_scene_snapshot();
+
+	auto camera_transform = sg::get_node_state(snapshot, *camera.get_node()).world_matrix;
+	auto projection       = sg::get_projection(snapshot, camera);
+
+	for (auto &mesh : meshes)
+	{
+		for (auto &node : mesh->get_nodes())
+		{
+			auto node_transform = sg::get_node_state(snapshot, *node).world_matrix;
+
+			const sg::AABB &mesh_bounds = mesh->get_bounds();
+
+			sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
+			world_bounds.transform(node_transform);
+
+			float distance = glm::length(glm::vec3(camera_transform[3]) - world_bounds.get_center());
+
+			sg::Mesh *draw_mesh = mesh;
+			bool      drawn     = true;
+
+			if (node->has_component<sg::LodGroup>())
+			{
+				auto &lod_group = node->get_component<sg::LodGroup>();
+				auto &levels    = lod_group.get_levels();
+
+				float radius      = glm::length(world_bounds.get_max() - world_bounds.get_min()) * 0.5f;
+				float screen_size = sg::LodGroup::get_screen_size(world_bounds.get_center(), radius, glm::vec3(camera_transform[3]), projection);
+
+				auto &node_lod = node_lods[node];
+				node_lod.level = lod_group.select_level(screen_size, node_lod.level);
+
+				// Nodes smaller than the coarsest level are not drawn
+				drawn = node_lod.level < levels.size();
+				if (drawn)
+				{
+					draw_mesh            = levels[node_lod.level].mesh;
+					node_lod.mesh        = draw_mesh;
+					node_lod.submesh_lod = levels[node_lod.level].submesh_lod;
+				}
+			}
+
+			mesh_nodes.push_back({draw_mesh, node, distance, drawn});
+			mesh_node_bounds.push_back(world_bounds.get_min(), world_bounds.get_max());
+		}
+	}
+
+	if (!frustum_culling)
+	{
+		return;
+	}
+
+	Frustum frustum;
+	if (uses_multiview())
+	{
+		// A single frustum containing all the views, so that the draws are culled once for all of them
+		frustum.update(current_view_projs);
+	}
+	else
+	{
+		frustum.update(projection * sg::get_view(snapshot, camera));
+	}
+
+	// With frame pipelining the live scene, which the hierarchy follows, is updated while the snapshot is recorded
+	auto bvh = snapshot ? nullptr : scene.get_bvh();
+	if (bvh)
+	{
+		bvh_visible_nodes.clear();
+		bvh->query_frustum(frustum, bvh_visible_nodes);
+		std::sort(bvh_visible_nodes.begin(), bvh_visible_nodes.end());
+
+		mesh_node_visibility.resize(mesh_nodes.size());
+		for (size_t i = 0; i < mesh_nodes.size(); ++i)
+		{
+			mesh_node_visibility[i] = std::binary_search(bvh_visible_nodes.begin(), bvh_visible_nodes.end(), mesh_nodes[i].node);
+		}
+	}
+	else
+	{
+		mesh_node_bounds.cull(frustum, mesh_node_visibility, &JobSystem::get());
+	}
+
+	uint32_t visible_draws = 0;
+	uint32_t culled_draws  = 0;
+
+	for (size_t i = 0; i < mesh_nodes.size(); ++i)
+	{
+		auto &mesh_node = mesh_nodes[i];
+
+		// Nodes dropped by the level of detail selection are neither visible nor culled
+		if (!mesh_node.visible)
+		{
+			continue;
+		}
+
+		// The joints may move skinned vertices anywhere outside of the bounds of the mesh
+		mesh_node.visible = mesh_node_visibility[i] != 0 || mesh_node.node->has_component<sg::Skin>();
+
+		if (mesh_node.visible)
+		{
+			visible_draws += to_u32(mesh_node.mesh->get_submeshes().size());
+		}
+		else
+		{
+			culled_draws += to_u32(mesh_node.mesh->get_submeshes().size());
+		}
+	}
+
+	if (culling_stats)
+	{
+		visible_draw_count += visible_draws;
+		culled_draw_count += culled_draws;
+	}
+}
+
+sg::Mesh *GeometrySubpass::get_draw_mesh(sg::Node &node) const
+{
+	auto lod_it = node_lods.find(&node);
+	if (lod_it != node_lods.end() && lod_it->second.mesh)
+	{
+		return lod_it->second.mesh;
+	}
+
+	return node.has_component<sg::Mesh>() ? &node.get_component<sg::Mesh>() : nullptr;
+}
+
+uint32_t GeometrySubpass::get_submesh_lod(const sg::Node &node) const
+{
+	if (node_lods.empty())
+	{
+		return 0;
+	}
+
+	auto lod_it = node_lods.find(&node);
+
+	return lod_it != node_lods.end() ? lod_it->second.submesh_lod : 0;
+}
+
+void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes, std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
+{
+	cull_mesh_nodes();
+
+	for (auto &mesh_node : mesh_nodes)
+	{
+		if (!mesh_node.visible)
+		{
+			continue;
+		}
+
+		for (auto &sub_mesh : mesh_node.mesh->get_submeshes())
+		{
+			if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
+			{
+				transparent_nodes.emplace(mesh_node.distance, std::make_pair(mesh_node.node, sub_mesh));
+			}
+			else
+			{
+				opaque_nodes.emplace(mesh_node.distance, std::make_pair(mesh_node.node, sub_mesh));
+			}
+		}
+	}
+}
+
+void GeometrySubpass::get_sorted_draws(DrawList &opaque_draws, DrawList &transparent_draws)
+{
+	opaque_draws.clear();
+	transparent_draws.clear();
+
+	cull_mesh_nodes();
+
+	for (auto &mesh_node : mesh_nodes)
+	{
+		if (!mesh_node.visible)
+		{
+			continue;
+		}
+
+		auto node = mesh_node.node;
+
+		uint64_t depth_bits = to_sortable_bits(mesh_node.distance);
+
+		for (auto &sub_mesh : mesh_node.mesh->get_submeshes())
+		{
+			auto material = sub_mesh->get_material();
+
+			if (material->alpha_mode == sg::AlphaMode::Blend)
+			{
+				transparent_draws.push_back(depth_bits, std::make_pair(node, sub_mesh));
+			}
+			else
+			{
+				// Sort key layout: [63:48] pipeline state, [47:32] material, [31:0] depth
+				// With instancing: [31:16] submesh, [15:0] coarse depth, so that the draws of a submesh follow each other
+				size_t state_hash = 0;
+				hash_combine(state_hash, sub_mesh->get_shader_variant().get_id());
+				for (auto &constant : sub_mesh->get_shader_variant().get_specialization_constants())
+				{
+					hash_combine(state_hash, constant.second);
+				}
+				hash_combine(state_hash, sub_mesh->get_vertex_layout_hash());
+				hash_combine(state_hash, material->double_sided);
+
+				size_t material_hash = std::hash<const sg::Material *>{}(material);
+
+				uint64_t key = (static_cast<uint64_t>(state_hash & 0xffff) << 48) |
+				               (static_cast<uint64_t>(material_hash & 0xffff) << 32);
+
+				if (instancing_variant)
+				{
+					size_t sub_mesh_hash = std::hash<const sg::SubMesh *>{}(sub_mesh);
+
+					key |= (static_cast<uint64_t>(sub_mesh_hash & 0xffff) << 16) | (depth_bits >> 16);
+				}
+				else
+				{
+					key |= depth_bits;
+				}
+
+				opaque_draws.push_back(key, std::make_pair(node, sub_mesh));
+			}
+		}
+	}
+
+	opaque_draws.sort();
+	transparent_draws.sort();
+}
+
+void GeometrySubpass::draw(CommandBuffer &command_buffer)
+{
+	VKB_PROFILE_SCOPE("GeometrySubpass::draw");
+
+	// The draws are recorded once for all the views of the render target
+	view_count = get_render_target() ? get_render_target()->get_view_count() : 1;
+	assert(view_count <= MAX_VIEW_COUNT && "The render target has more views than the multiview uniform");
+
+	// The draw infos refer to the buffers and textures of the submeshes, which may have been replaced
+	if (scene.get_component_generation() != draw_info_generation)
+	{
+		draw_info_index.clear();
+		draw_infos.clear();
+		draw_info_generation = scene.get_component_generation();
+	}
+
+	if (uses_multiview())
+	{
+		update_multiview_uniform();
+	}
+
+	get_sorted_draws(opaque_draws, transparent_draws);
+
+	update_joint_matrices();
+
+	if (motion_vectors)
+	{
+		auto      snapshot  = get_scene_snapshot();
+		glm::mat4 view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(sg::get_projection(snapshot, camera)) * sg::get_view(snapshot, camera);
+
+		// The first frame has no history, so it has no motion
+		previous_view_proj    = has_view_proj_history ? current_view_proj : view_proj;
+		current_view_proj     = view_proj;
+		has_view_proj_history = true;
+	}
+
+	begin_instance_uniforms(command_buffer, opaque_draws.size() + transparent_draws.size());
+
+	if (uses_bindless_materials())
+	{
+		bind_bindless_materials(command_buffer);
+	}
+
+	if (retains_draws())
+	{
+		record_draws_retained(command_buffer);
+	}
+	else if (recording_job_system)
+	{
+		record_draws_parallel(command_buffer, *recording_job_system);
+	}
+	else
+	{
+		// The scene is shaded at the adaptive rate of the render context, what is drawn after it at the full rate
+		command_buffer.set_fragment_shading_rate(get_render_context().get_fragment_shading_rate());
+
+		record_opaque_draws(command_buffer, 0, opaque_draws.size(), thread_index);
+
+		record_transparent_draws(command_buffer, thread_index);
+
+		command_buffer.set_fragment_shading_rate({1, 1});
+
+		if (uses_occlusion_predicates())
+		{
+			record_occlusion_queries(command_buffer);
+		}
+	}
+
+	end_instance_uniforms();
+
+	multiview_uniform = BufferAllocation{};
+}
+
+bool GeometrySubpass::supports_parallel_recording() const
+{
+	// The queries and predicates of the frame are recorded with the draws of a single command buffer
+	return !uses_occlusion_predicates();
+}
+
+void GeometrySubpass::set_retained_draws(bool enabled)
+{
+	retained_draws = enabled;
+}
+
+bool GeometrySubpass::retains_draws() const
+{
+	// The descriptor sets bound by the retained command buffers must outlive them, which only the descriptor set cache of the frame guarantees
+	return retained_draws && !uses_occlusion_predicates() && !instancing_variant && !uses_multiview() && !render_context.get_device().uses_descriptor_buffers() &&
+	       render_context.get_active_frame().get_descriptor_management_strategy() == DescriptorManagementStrategy::StoreInCache;
+}
+
+void GeometrySubpass::record_opaque_draws(CommandBuffer &command_buffer, size_t draw_start, size_t draw_end, size_t thread_index)
+{
+	// Draw opaque objects grouped by state, front-to-back within each group
+	ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
+
+	BoundGeometry bound_geometry;
+
+	for (size_t i = draw_start; i < draw_end;)
+	{
+		auto &draw = opaque_draws[i];
+
+		// The instances of a run are drawn with the uniform of its first node, only their model matrices differ
+		size_t run_end = uses_instancing(*draw.value.second) ? find_instance_run(i, draw_end) : i + 1;
+
+		update_uniform(command_buffer, *draw.value.first, thread_index);
+
+		bind_joint_matrices(command_buffer, *draw.value.first);
+
+		if (uses_instancing(*draw.value.second))
+		{
+			bind_instance_transforms(command_buffer, i, run_end, thread_index);
+		}
+
+		VkFrontFace front_face = get_front_face(get_scene_snapshot(), *draw.value.first);
+
+		// Only the draw is discarded if the mesh was hidden, the state bound before it is kept for the next draws
+		VkDeviceSize predicate_offset = uses_occlusion_predicates() ? find_occlusion_predicate(*draw.value.first) : VK_WHOLE_SIZE;
+
+		if (predicate_offset != VK_WHOLE_SIZE)
+		{
+			command_buffer.begin_conditional_rendering(*occlusion_frames[render_context.get_active_frame_index()].predicates, predicate_offset);
+		}
+
+		draw_submesh(command_buffer, *draw.value.second, front_face, &bound_geometry, get_submesh_lod(*draw.value.first), to_u32(run_end - i));
+
+		if (predicate_offset != VK_WHOLE_SIZE)
+		{
+			command_buffer.end_conditional_rendering();
+		}
+
+		i = run_end;
+	}
+}
+
+size_t GeometrySubpass::find_instance_run(size_t draw_start, size_t draw_end) const
+{
+	auto &first = opaque_draws[draw_start].value;
+
+	// Skinned nodes bind joint matrices of their own
+	if (first.first->has_component<sg::Skin>())
+	{
+		return draw_start + 1;
+	}
+
+	auto        snapshot   = get_scene_snapshot();
+	VkFrontFace front_face = get_front_face(snapshot, *first.first);
+	uint32_t    lod        = get_submesh_lod(*first.first);
+
+	size_t run_end = draw_start + 1;
+	for (; run_end < draw_end; ++run_end)
+	{
+		auto &draw = opaque_draws[run_end].value;
+
+		if (draw.second != first.second || draw.first->has_component<sg::Skin>() ||
+		    get_submesh_lod(*draw.first) != lod || get_front_face(snapshot, *draw.first) != front_face)
+		{
+			break;
+		}
+	}
+
+	return run_end;
+}
+
+void GeometrySubpass::bind_instance_transforms(CommandBuffer &command_buffer, size_t draw_start, size_t draw_end, size_t thread_index)
+{
+	auto &render_frame = get_render_context().get_active_frame();
+
+	size_t size = (draw_end - draw_start) * sizeof(InstanceTransform);
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, size, thread_index);
+
+	auto transforms = reinterpret_cast<InstanceTransform *>(allocation.map(size));
+	if (!transforms)
+	{
+		return;
+	}
+
+	auto snapshot = get_scene_snapshot();
+
+	for (size_t i = draw_start; i < draw_end; ++i)
+	{
+		auto state = sg::get_node_state(snapshot, *opaque_draws[i].value.first);
+
+		transforms[i - draw_start] = {state.world_matrix, state.previous_world_matrix};
+	}
+
+	allocation.flush();
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, INSTANCE_BINDING, 0);
+}
+
+void GeometrySubpass::record_transparent_draws(CommandBuffer &command_buffer, size_t thread_index)
+{
+	// Enable alpha blending
+	ColorBlendAttachmentState color_blend_attachment{};
+	color_blend_attachment.blend_enable           = VK_TRUE;
+	color_blend_attachment.src_color_blend_factor = VK_BLEND_FACTOR_SRC_ALPHA;
+	color_blend_attachment.dst_color_blend_factor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	color_blend_attachment.src_alpha_blend_factor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+	ColorBlendState color_blend_state{};
+	color_blend_state.attachments.resize(get_output_attachments().size());
+	for (auto &it : color_blend_state.attachments)
+	{
+		it = color_blend_attachment;
+	}
+	if (motion_vectors && color_blend_state.attachments.size() > 1)
+	{
+		// The velocity of the opaque surfaces behind is kept, blending it would be meaningless
+		color_blend_state.attachments[1].color_write_mask = 0;
+	}
+	command_buffer.set_color_blend_state(color_blend_state);
+
+	command_buffer.set_depth_stencil_state(get_depth_stencil_state());
+
+	// Draw transparent objects in back-to-front order
+	ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
+
+	BoundGeometry bound_geometry;
+
+	for (auto draw_it = transparent_draws.rbegin(); draw_it != transparent_draws.rend(); draw_it++)
+	{
+		update_uniform(command_buffer, *draw_it->value.first, thread_index);
+
+		bind_joint_matrices(command_buffer, *draw_it->value.first);
+
+		draw_submesh(command_buffer, *draw_it->value.second, VK_FRONT_FACE_COUNTER_CLOCKWISE, &bound_geometry, get_submesh_lod(*draw_it->value.first));
+	}
+}
+
+void GeometrySubpass::copy_occlusion_predicates(CommandBuffer &command_buffer)
+{
+	auto &device = render_context.get_device();
+
+	occlusion_frames.resize(render_context.get_render_frames().size());
+
+	uint32_t frame_index = render_context.get_active_frame_index();
+	auto    &frame       = occlusion_frames[frame_index];
+
+	if (!frame.query_pool)
+	{
+		VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		query_pool_info.queryType  = VK_QUERY_TYPE_OCCLUSION;
+		query_pool_info.queryCount = MAX_OCCLUSION_QUERIES;
+
+		frame.query_pool = std::make_unique<QueryPool>(device, query_pool_info);
+		frame.predicates = std::make_unique<core::Buffer>(device,
+		                                                  MAX_OCCLUSION_QUERIES * sizeof(uint32_t),
+		                                                  VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                                  VMA_MEMORY_USAGE_GPU_ONLY);
+		frame.predicates->set_debug_name("GeometrySubpass: occlusion predicates");
+
+		frame.queried.resize(MAX_OCCLUSION_QUERIES, 0);
+		frame.predicated.resize(MAX_OCCLUSION_QUERIES, 0);
+	}
+
+	std::fill(frame.predicated.begin(), frame.predicated.end(), 0);
+
+	// With a single frame, the queries would be reset right after being copied, so nothing is predicated
+	if (previous_occlusion_frame < occlusion_frames.size() && previous_occlusion_frame != frame_index)
+	{
+		auto &previous_frame = occlusion_frames[previous_occlusion_frame];
+
+		// The previous frame was submitted first, so the copy waits for its queries on the GPU, and the CPU never does.
+		// Queries which were not recorded never become available, so only the runs of recorded ones are copied.
+		bool     copied    = false;
+		uint32_t run_start = 0;
+		for (uint32_t slot = 0; slot <= MAX_OCCLUSION_QUERIES; ++slot)
+		{
+			if (slot < MAX_OCCLUSION_QUERIES && previous_frame.queried[slot])
+			{
+				frame.predicated[slot] = 1;
+				continue;
+			}
+
+			if (run_start < slot)
+			{
+				command_buffer.copy_query_pool_results(*previous_frame.query_pool, run_start, slot - run_start,
+				                                       *frame.predicates, run_start * sizeof(uint32_t), sizeof(uint32_t),
+				                                       VK_QUERY_RESULT_WAIT_BIT);
+				copied = true;
+			}
+
+			run_start = slot + 1;
+		}
+
+		if (copied)
+		{
+			BufferMemoryBarrier memory_barrier{};
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT;
+			memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT;
+
+			command_buffer.buffer_memory_barrier(*frame.predicates, 0, VK_WHOLE_SIZE, memory_barrier);
+		}
+	}
+
+	// The results of the frame were copied by the frame after it, which was waited for before this one became active again
+	command_buffer.reset_query_pool(*frame.query_pool, 0, MAX_OCCLUSION_QUERIES);
+	std::fill(frame.queried.begin(), frame.queried.end(), 0);
+
+	previous_occlusion_frame = frame_index;
+}
+
+VkDeviceSize GeometrySubpass::find_occlusion_predicate(const sg::Node &node) const
+{
+	auto slot_it = occlusion_slots.find(&node);
+	if (slot_it == occlusion_slots.end())
+	{
+		return VK_WHOLE_SIZE;
+	}
+
+	auto &frame = occlusion_frames[render_context.get_active_frame_index()];
+
+	return frame.predicated[slot_it->second] ? slot_it->second * sizeof(uint32_t) : VK_WHOLE_SIZE;
+}
+
+void GeometrySubpass::record_occlusion_queries(CommandBuffer &command_buffer)
+{
+	ScopedDebugLabel occlusion_debug_label{command_buffer, "Occlusion queries"};
+
+	auto &frame          = occlusion_frames[render_context.get_active_frame_index()];
+	auto &resource_cache = command_buffer.get_device().get_resource_cache();
+
+	auto &vert_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, *occlusion_box_vertex_shader);
+	auto &frag_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, *occlusion_box_fragment_shader);
+	auto &pipeline_layout    = resource_cache.request_pipeline_layout({&vert_shader_module, &frag_shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+	command_buffer.set_vertex_input_state({});
+
+	// The boxes are tested against the depth of the opaque draws, and leave the attachments untouched
+	ColorBlendState color_blend_state{};
+	color_blend_state.attachments.resize(get_output_attachments().size());
+	for (auto &attachment : color_blend_state.attachments)
+	{
+		attachment.color_write_mask = 0;
+	}
+	command_buffer.set_color_blend_state(color_blend_state);
+
+	DepthStencilState depth_stencil_state  = get_depth_stencil_state();
+	depth_stencil_state.depth_write_enable = VK_FALSE;
+	command_buffer.set_depth_stencil_state(depth_stencil_state);
+
+	RasterizationState rasterization_state = base_rasterization_state;
+	rasterization_state.cull_mode          = VK_CULL_MODE_NONE;
+	command_buffer.set_rasterization_state(rasterization_state);
+
+	MultisampleState multisample_state{};
+	multisample_state.rasterization_samples = sample_count;
+	command_buffer.set_multisample_state(multisample_state);
+
+	auto snapshot        = get_scene_snapshot();
+	auto camera_position = glm::vec3(sg::get_node_state(snapshot, *camera.get_node()).world_matrix[3]);
+
+	// A box clipped by the near plane may pass no sample while the mesh is in view, so the boxes around the camera are not tested.
+	// Twice the near plane distance covers the corners of the near plane for the usual fields of view.
+	float near_margin = 0.0f;
+	if (auto perspective_camera = dynamic_cast<sg::PerspectiveCamera *>(&camera))
+	{
+		near_margin = 2.0f * perspective_camera->get_near_plane();
+	}
+
+	OcclusionBox occlusion_box{};
+	occlusion_box.view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(sg::get_projection(snapshot, camera)) * sg::get_view(snapshot, camera);
+
+	for (size_t i = 0; i < mesh_nodes.size(); ++i)
+	{
+		auto &mesh_node = mesh_nodes[i];
+
+		// Skinned vertices may be anywhere outside of the bounds of the mesh
+		if (!mesh_node.visible || mesh_node.node->has_component<sg::Skin>() || get_opaque_index_count(*mesh_node.mesh) < occlusion_min_index_count)
+		{
+			continue;
+		}
+
+		glm::vec3 box_min = mesh_node_bounds.get_min(i);
+		glm::vec3 box_max = mesh_node_bounds.get_max(i);
+
+		if (glm::all(glm::greaterThan(camera_position, box_min - near_margin)) && glm::all(glm::lessThan(camera_position, box_max + near_margin)))
+		{
+			continue;
+		}
+
+		auto slot_it = occlusion_slots.find(mesh_node.node);
+		if (slot_it == occlusion_slots.end())
+		{
+			if (occlusion_slots.size() >= MAX_OCCLUSION_QUERIES)
+			{
+				continue;
+			}
+
+			slot_it = occlusion_slots.emplace(mesh_node.node, to_u32(occlusion_slots.size())).first;
+		}
+
+		occlusion_box.box_min = glm::vec4(box_min, 0.0f);
+		occlusion_box.box_max = glm::vec4(box_max, 0.0f);
+		command_buffer.push_constants(occlusion_box);
+
+		command_buffer.begin_query(*frame.query_pool, slot_it->second, 0);
+		command_buffer.draw(36, 1, 0, 0);
+		command_buffer.end_query(*frame.query_pool, slot_it->second);
+
+		frame.queried[slot_it->second] = 1;
 	}
 }
 
-void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes, std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
+void GeometrySubpass::record_draws_parallel(CommandBuffer &primary_command_buffer, JobSystem &job_system)
 {
-	auto camera_transform = camera.get_node()->get_transform().get_world_matrix();
+	auto &render_frame = get_render_context().get_active_frame();
 
-	for (auto &mesh : meshes)
+	// Secondary command buffers come from the same queue family and kind of pool as the primary
+	auto &primary_command_pool = primary_command_buffer.get_command_pool();
+	auto &queue                = primary_command_buffer.get_device().get_queue(primary_command_pool.get_queue_family_index(), 0);
+	auto  reset_mode           = primary_command_pool.get_reset_mode();
+
+	// Split the opaque draws in contiguous ranges, so the state sorting is mostly preserved within each secondary
+	size_t opaque_draw_count = opaque_draws.size();
+	size_t range_count       = std::min(job_system.get_worker_count() + 1, (opaque_draw_count + MIN_DRAWS_PER_SECONDARY_COMMAND_BUFFER - 1) / MIN_DRAWS_PER_SECONDARY_COMMAND_BUFFER);
+
+	// Transparent objects must be blended in order, so they are recorded by a single job after the opaque ones
+	size_t secondary_count = range_count + (transparent_draws.empty() ? 0 : 1);
+
+	std::vector<CommandBuffer *> secondary_command_buffers(secondary_count, nullptr);
+	std::vector<JobHandle>       jobs;
+	jobs.reserve(secondary_count);
+
+	for (size_t secondary_index = 0; secondary_index < secondary_count; ++secondary_index)
 	{
-		for (auto &node : mesh->get_nodes())
-		{
-			auto node_transform = node->get_transform().get_world_matrix();
+		jobs.push_back(job_system.submit([this, &render_frame, &queue, reset_mode, &primary_command_buffer, &secondary_command_buffers, secondary_index, range_count, opaque_draw_count]() {
+			// Every thread, the one recording the primary included, has its own frame resources
+			size_t thread_index = JobSystem::get_thread_index();
 
-			const sg::AABB &mesh_bounds = mesh->get_bounds();
+			auto &secondary_command_buffer = render_frame.request_command_buffer(queue, reset_mode, VK_COMMAND_BUFFER_LEVEL_SECONDARY, thread_index);
 
-			sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
-			world_bounds.transform(node_transform);
+			secondary_command_buffer.continue_render_pass(primary_command_buffer);
 
-			float distance = glm::length(glm::vec3(camera_transform[3]) - world_bounds.get_center());
+			// Only the secondaries drawing the scene use the adaptive rate, the primary does not record in the subpass
+			secondary_command_buffer.set_fragment_shading_rate(get_render_context().get_fragment_shading_rate());
 
-			for (auto &sub_mesh : mesh->get_submeshes())
+			if (secondary_index < range_count)
 			{
-				if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
-				{
-					transparent_nodes.emplace(distance, std::make_pair(node, sub_mesh));
-				}
-				else
-				{
-					opaque_nodes.emplace(distance, std::make_pair(node, sub_mesh));
-				}
+				record_opaque_draws(secondary_command_buffer,
+				                    opaque_draw_count * secondary_index / range_count,
+				                    opaque_draw_count * (secondary_index + 1) / range_count,
+				                    thread_index);
 			}
-		}
+			else
+			{
+				record_transparent_draws(secondary_command_buffer, thread_index);
+			}
+
+			secondary_command_buffer.end();
+
+			secondary_command_buffers[secondary_index] = &secondary_command_buffer;
+		}));
+	}
+
+	job_system.wait(jobs);
+
+	if (!secondary_command_buffers.empty())
+	{
+		primary_command_buffer.execute_commands(secondary_command_buffers);
 	}
 }
 
-void GeometrySubpass::draw(CommandBuffer &command_buffer)
+void GeometrySubpass::record_draws_retained(CommandBuffer &primary_command_buffer)
 {
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> opaque_nodes;
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> transparent_nodes;
+	auto &render_frame        = get_render_context().get_active_frame();
+	auto &render_pass_binding = primary_command_buffer.get_current_render_pass();
+
+	auto &primary_command_pool = primary_command_buffer.get_command_pool();
+	auto &queue                = primary_command_buffer.get_device().get_queue(primary_command_pool.get_queue_family_index(), 0);
+	auto  reset_mode           = primary_command_pool.get_reset_mode();
+
+	auto &retained_frame = get_retained_frame(render_frame, primary_command_pool.get_queue_family_index());
+
+	std::vector<CommandBuffer *> secondary_command_buffers;
 
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
+	// Without a slot for each opaque draw, their uniforms are allocated when recording, and they cannot be retained
+	size_t opaque_draw_count = opaque_draws.size();
+	bool   retainable        = opaque_draw_count <= instance_uniform_capacity;
 
-	// Draw opaque objects in front-to-back order
+	// The draws are summed up, so that the same draws in another order match the recorded ones
+	size_t draws_hash = 0;
+	if (retainable)
 	{
-		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
+		for (auto &draw : opaque_draws)
+		{
+			draws_hash += hash_retained_draw(*draw.value.first, *draw.value.second);
+		}
+	}
+
+	// The framebuffer is inherited, its handle changes along with the render target
+	size_t key = draws_hash;
+	hash_combine(key, opaque_draw_count);
+	hash_combine(key, render_pass_binding.render_pass->get_handle());
+	hash_combine(key, render_pass_binding.framebuffer->get_handle());
+	hash_combine(key, render_pass_binding.render_area);
+	hash_combine(key, primary_command_buffer.get_current_subpass_index());
+	hash_combine(key, primary_command_buffer.hash_resource_bindings());
+	hash_combine(key, instance_uniforms.empty() ? VK_NULL_HANDLE : instance_uniforms.get_buffer().get_handle());
+	hash_combine(key, instance_uniforms.get_offset());
+	hash_combine(key, joint_matrices_hash);
+	// Moved images have new view handles, which the descriptor sets of the recorded draws do not refer to
+	hash_combine(key, allocated::get_move_generation());
+	hash_combine(key, get_render_context().get_fragment_shading_rate());
+	hash_combine(key, sample_count);
+	hash_combine(key, base_rasterization_state.polygon_mode);
+	hash_combine(key, base_rasterization_state.cull_mode);
+	// The inherited pipeline statistics must include the ones of the queries active around the draws
+	auto *gpu_profiler = get_render_context().get_device().get_gpu_profiler();
+	hash_combine(key, gpu_profiler ? gpu_profiler->get_pipeline_statistics() : 0);
+
+	if (!retainable)
+	{
+		retained_frame.key = 0;
+
+		auto &secondary_command_buffer = render_frame.request_command_buffer(queue, reset_mode, VK_COMMAND_BUFFER_LEVEL_SECONDARY, thread_index);
+
+		secondary_command_buffer.continue_render_pass(primary_command_buffer);
+		secondary_command_buffer.set_fragment_shading_rate(get_render_context().get_fragment_shading_rate());
+
+		record_opaque_draws(secondary_command_buffer, 0, opaque_draw_count, thread_index);
 
-		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		secondary_command_buffer.end();
+
+		secondary_command_buffers.push_back(&secondary_command_buffer);
+	}
+	else if (key != retained_frame.key)
+	{
+		VKB_PROFILE_SCOPE("GeometrySubpass::record_draws_retained");
+
+		retained_frame.draws.clear();
+		for (auto &draw : opaque_draws)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			retained_frame.draws.push_back(draw.value);
+		}
+
+		// The fence of the frame was waited on, so the GPU is done with the command buffer
+		auto &retained_command_buffer = *retained_frame.command_buffer;
+
+		retained_command_buffer.reset(CommandBuffer::ResetMode::ResetIndividually);
+		retained_command_buffer.continue_render_pass(primary_command_buffer);
+		retained_command_buffer.set_fragment_shading_rate(get_render_context().get_fragment_shading_rate());
+
+		record_opaque_draws(retained_command_buffer, 0, opaque_draw_count, thread_index);
 
-			// Invert the front face if the mesh was flipped
-			const auto &scale      = node_it->second.first->get_transform().get_scale();
-			bool        flipped    = scale.x * scale.y * scale.z < 0;
-			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		retained_command_buffer.end();
 
-			draw_submesh(command_buffer, *node_it->second.second, front_face);
+		retained_frame.key = key;
+
+		secondary_command_buffers.push_back(&retained_command_buffer);
+	}
+	else if (opaque_draw_count > 0)
+	{
+		// The recorded draws bind the slots in their recorded order, which only need their uniforms written
+		for (uint32_t slot = 0; slot < opaque_draw_count; ++slot)
+		{
+			write_instance_uniform(*retained_frame.draws[slot].first, slot);
 		}
+		instance_uniform_count = to_u32(opaque_draw_count);
+
+		secondary_command_buffers.push_back(retained_frame.command_buffer);
 	}
 
-	// Enable alpha blending
-	ColorBlendAttachmentState color_blend_attachment{};
-	color_blend_attachment.blend_enable           = VK_TRUE;
-	color_blend_attachment.src_color_blend_factor = VK_BLEND_FACTOR_SRC_ALPHA;
-	color_blend_attachment.dst_color_blend_factor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-	color_blend_attachment.src_alpha_blend_factor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	if (!transparent_draws.empty())
+	{
+		auto &secondary_command_buffer = render_frame.request_command_buffer(queue, reset_mode, VK_COMMAND_BUFFER_LEVEL_SECONDARY, thread_index);
 
-	ColorBlendState color_blend_state{};
-	color_blend_state.attachments.resize(get_output_attachments().size());
-	for (auto &it : color_blend_state.attachments)
+		secondary_command_buffer.continue_render_pass(primary_command_buffer);
+		secondary_command_buffer.set_fragment_shading_rate(get_render_context().get_fragment_shading_rate());
+
+		record_transparent_draws(secondary_command_buffer, thread_index);
+
+		secondary_command_buffer.end();
+
+		secondary_command_buffers.push_back(&secondary_command_buffer);
+	}
+
+	if (!secondary_command_buffers.empty())
 	{
-		it = color_blend_attachment;
+		primary_command_buffer.execute_commands(secondary_command_buffers);
 	}
-	command_buffer.set_color_blend_state(color_blend_state);
+}
 
-	command_buffer.set_depth_stencil_state(get_depth_stencil_state());
+GeometrySubpass::RetainedFrame &GeometrySubpass::get_retained_frame(RenderFrame &render_frame, uint32_t queue_family_index)
+{
+	auto it = std::find_if(retained_frames.begin(), retained_frames.end(),
+	                       [&render_frame](const RetainedFrame &retained_frame) { return retained_frame.render_frame == &render_frame; });
 
-	// Draw transparent objects in back-to-front order
+	if (it != retained_frames.end())
 	{
-		ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
+		return *it;
+	}
 
-		for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
-		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+	// The frames of a render context are never destroyed, only updated with new render targets
+	RetainedFrame retained_frame;
+	retained_frame.render_frame   = &render_frame;
+	retained_frame.command_pool   = std::make_unique<CommandPool>(render_context.get_device(), queue_family_index, &render_frame, thread_index,
+	                                                              CommandBuffer::ResetMode::ResetIndividually);
+	retained_frame.command_buffer = &retained_frame.command_pool->request_command_buffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
 
-			draw_submesh(command_buffer, *node_it->second.second);
+	retained_frames.push_back(std::move(retained_frame));
+
+	return retained_frames.back();
+}
+
+size_t GeometrySubpass::hash_retained_draw(sg::Node &node, sg::SubMesh &sub_mesh) const
+{
+	auto material = sub_mesh.get_material();
+
+	const auto  scale   = sg::get_node_state(get_scene_snapshot(), node).scale;
+	bool        flipped = scale.x * scale.y * scale.z < 0;
+
+	size_t result = 0;
+	hash_combine(result, render_context.get_device().get_resource_cache().get_shader_generation());
+	hash_combine(result, &node);
+	hash_combine(result, &sub_mesh);
+	hash_combine(result, get_submesh_lod(node));
+	hash_combine(result, flipped);
+	hash_combine(result, material);
+	hash_combine(result, sub_mesh.get_shader_variant().get_id());
+	hash_combine(result, uses_vertex_pulling(sub_mesh));
+
+	// Streamed textures replace their image views
+	if (!uses_bindless_materials())
+	{
+		for (auto &texture : material->textures)
+		{
+			hash_combine(result, texture.second->get_image()->get_vk_image_view().get_handle());
+			hash_combine(result, texture.second->get_sampler()->vk_sampler.get_handle());
 		}
 	}
+
+	return result;
+}
+
+void GeometrySubpass::begin_instance_uniforms(CommandBuffer &command_buffer, size_t draw_count)
+{
+	end_instance_uniforms();
+
+	if (draw_count == 0)
+	{
+		return;
+	}
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	// Every slot has to start at a valid (dynamic) uniform buffer offset
+	instance_uniforms = render_frame.allocate_buffer_array(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GlobalUniform), to_u32(draw_count), thread_index);
+
+	if (!instance_uniforms.empty())
+	{
+		instance_uniform_capacity = instance_uniforms.get_element_count();
+	}
+}
+
+void GeometrySubpass::end_instance_uniforms()
+{
+	instance_uniforms         = BufferAllocation{};
+	instance_uniform_capacity = 0;
+	instance_uniform_count    = 0;
 }
 
 void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index)
 {
+	if (uses_multiview())
+	{
+		command_buffer.bind_buffer(multiview_uniform.get_buffer(), multiview_uniform.get_offset(), multiview_uniform.get_size(), 0, MULTIVIEW_BINDING, 0);
+	}
+
+	// Write straight into the next slot of the per-frame instance block, if there is one left
+	uint32_t slot = instance_uniform_count++;
+	if (slot < instance_uniform_capacity)
+	{
+		VkDeviceSize offset = write_instance_uniform(node, slot);
+
+		command_buffer.bind_buffer(instance_uniforms.get_buffer(), offset, sizeof(GlobalUniform), 0, 1, 0);
+
+		return;
+	}
+
 	GlobalUniform global_uniform;
 
-	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
+	auto snapshot = get_scene_snapshot();
+	auto view     = sg::get_view(snapshot, camera);
 
-	auto &render_frame = get_render_context().get_active_frame();
+	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(sg::get_projection(snapshot, camera)) * view;
 
-	auto &transform = node.get_transform();
+	global_uniform.model = sg::get_node_state(snapshot, node).world_matrix;
 
-	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GlobalUniform), thread_index);
+	set_temporal_matrices(global_uniform, node);
 
-	global_uniform.model = transform.get_world_matrix();
+	set_position_quantization(global_uniform, get_draw_mesh(node));
 
-	global_uniform.camera_position = glm::vec3(glm::inverse(camera.get_view())[3]);
+	global_uniform.camera_position = glm::vec3(glm::inverse(view)[3]);
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GlobalUniform), thread_index);
 
 	allocation.update(global_uniform);
 
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
 }
 
-void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face)
+void GeometrySubpass::set_temporal_matrices(GlobalUniform &global_uniform, sg::Node &node) const
+{
+	auto &jitter = render_context.get_projection_jitter();
+	if (jitter != glm::vec2(0.0f))
+	{
+		global_uniform.camera_view_proj = glm::translate(glm::mat4(1.0f), glm::vec3(jitter, 0.0f)) * global_uniform.camera_view_proj;
+	}
+	global_uniform.jitter = glm::vec4(jitter, 0.0f, 0.0f);
+
+	if (motion_vectors)
+	{
+		global_uniform.previous_model            = sg::get_node_state(get_scene_snapshot(), node).previous_world_matrix;
+		global_uniform.previous_camera_view_proj = previous_view_proj;
+	}
+}
+
+bool GeometrySubpass::uses_multiview() const
+{
+	return view_count > 1;
+}
+
+void GeometrySubpass::update_multiview_uniform()
+{
+	auto snapshot   = get_scene_snapshot();
+	auto view       = sg::get_view(snapshot, camera);
+	auto projection = sg::get_projection(snapshot, camera);
+
+	// The first frame, or the first one with another number of views, has no history, so it has no motion
+	std::vector<glm::mat4> previous_view_projs = std::move(current_view_projs);
+	bool                   has_history         = previous_view_projs.size() == view_count;
+
+	current_view_projs.resize(view_count);
+
+	auto &jitter = render_context.get_projection_jitter();
+
+	MultiviewUniform multiview{};
+	for (uint32_t i = 0; i < view_count; ++i)
+	{
+		glm::mat4 view_matrix     = i < views.size() ? views[i].view_from_camera * view : view;
+		glm::mat4 view_projection = i < views.size() ? views[i].projection : projection;
+
+		current_view_projs[i] = camera.get_pre_rotation() * vkb::vulkan_style_projection(view_projection) * view_matrix;
+
+		multiview.view_proj[i]          = glm::translate(glm::mat4(1.0f), glm::vec3(jitter, 0.0f)) * current_view_projs[i];
+		multiview.previous_view_proj[i] = has_history ? previous_view_projs[i] : current_view_projs[i];
+		multiview.camera_position[i]    = glm::inverse(view_matrix)[3];
+	}
+
+	multiview_uniform = get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(MultiviewUniform), thread_index);
+	multiview_uniform.update(multiview);
+}
+
+void GeometrySubpass::update_joint_matrices()
+{
+	joint_matrices.clear();
+	joint_matrices_hash = 0;
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	std::vector<glm::mat4> matrices;
+
+	auto update_node = [&](sg::Node &node) {
+		if (!node.has_component<sg::Skin>() || joint_matrices.count(&node))
+		{
+			return;
+		}
+
+		node.get_component<sg::Skin>().get_joint_matrices(node, matrices, get_scene_snapshot());
+		if (matrices.empty())
+		{
+			return;
+		}
+
+		auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, matrices.size() * sizeof(glm::mat4), thread_index);
+		if (allocation.empty())
+		{
+			return;
+		}
+
+		allocation.update(reinterpret_cast<const uint8_t *>(matrices.data()), matrices.size() * sizeof(glm::mat4));
+
+		hash_combine(joint_matrices_hash, &node);
+		hash_combine(joint_matrices_hash, allocation.get_buffer().get_handle());
+		hash_combine(joint_matrices_hash, allocation.get_offset());
+
+		joint_matrices.emplace(&node, std::move(allocation));
+	};
+
+	for (auto &draw : opaque_draws)
+	{
+		update_node(*draw.value.first);
+	}
+
+	for (auto &draw : transparent_draws)
+	{
+		update_node(*draw.value.first);
+	}
+}
+
+void GeometrySubpass::bind_joint_matrices(CommandBuffer &command_buffer, sg::Node &node)
+{
+	auto it = joint_matrices.find(&node);
+	if (it == joint_matrices.end())
+	{
+		return;
+	}
+
+	auto &allocation = it->second;
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 3, 0);
+}
+
+VkDeviceSize GeometrySubpass::write_instance_uniform(sg::Node &node, uint32_t slot)
 {
-	auto &device = command_buffer.get_device();
+	GlobalUniform global_uniform;
+
+	auto snapshot = get_scene_snapshot();
+	auto view     = sg::get_view(snapshot, camera);
+
+	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(sg::get_projection(snapshot, camera)) * view;
+
+	global_uniform.model = sg::get_node_state(snapshot, node).world_matrix;
+
+	set_temporal_matrices(global_uniform, node);
+
+	set_position_quantization(global_uniform, get_draw_mesh(node));
+
+	global_uniform.camera_position = glm::vec3(glm::inverse(view)[3]);
+
+	uint32_t offset = instance_uniforms.get_dynamic_offset(slot);
+
+	instance_uniforms.update(global_uniform, offset);
+
+	return instance_uniforms.get_offset() + offset;
+}
 
+void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face, BoundGeometry *bound_geometry, uint32_t lod, uint32_t instance_count)
+{
 	ScopedDebugLabel submesh_debug_label{command_buffer, sub_mesh.get_name().c_str()};
 
 	prepare_pipeline_state(command_buffer, front_face, sub_mesh.get_material()->double_sided);
@@ -172,41 +1612,159 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	multisample_state.rasterization_samples = sample_count;
 	command_buffer.set_multisample_state(multisample_state);
 
-	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_shader_variant());
-	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
-
-	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
-
-	auto &pipeline_layout = prepare_pipeline_layout(command_buffer, shader_modules);
+	auto &draw_info       = get_draw_info(command_buffer, sub_mesh);
+	auto &pipeline_layout = *draw_info.pipeline_layout;
 
 	command_buffer.bind_pipeline_layout(pipeline_layout);
 
-	if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+	// Features of the submesh which share the shader modules of the variant
+	for (auto &constant : sub_mesh.get_shader_variant().get_specialization_constants())
+	{
+		command_buffer.set_specialization_constant(constant.first, constant.second);
+	}
+
+	// Shaders without the bindless fields still get the factors
+	if (uses_bindless_materials() && pipeline_layout.get_push_constant_range_stage(sizeof(BindlessMaterialUniform)) != 0)
+	{
+		prepare_bindless_push_constants(command_buffer, sub_mesh);
+	}
+	else if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
 	{
 		prepare_push_constants(command_buffer, sub_mesh);
 	}
 
-	DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
+	for (auto &texture_binding : draw_info.texture_bindings)
+	{
+		command_buffer.bind_image(texture_binding.second->get_image()->get_vk_image_view(),
+		                          texture_binding.second->get_sampler()->vk_sampler,
+		                          0, texture_binding.first, 0);
+	}
+
+	// Pulled vertices are all in the same buffer, so the descriptor set of the draw does not change
+	if (uses_vertex_pulling(sub_mesh))
+	{
+		command_buffer.bind_buffer(*sub_mesh.pulled_vertex_buffer, 0, sub_mesh.pulled_vertex_buffer->get_size(), 0, PULLED_VERTEX_BINDING, 0);
+	}
+
+	command_buffer.set_vertex_input_state(draw_info.vertex_input_state);
+
+	for (auto &run : draw_info.vertex_buffer_runs)
+	{
+		bool bound = bound_geometry != nullptr && bound_geometry->vertex_buffers.size() >= run.first_binding + run.buffers.size();
+
+		for (size_t i = 0; bound && i < run.buffers.size(); ++i)
+		{
+			auto &vertex_buffer = bound_geometry->vertex_buffers[run.first_binding + i];
+			bound               = vertex_buffer.first == run.buffers[i].get().get_handle() && vertex_buffer.second == run.offsets[i];
+		}
+
+		if (bound)
+		{
+			continue;
+		}
+
+		command_buffer.bind_vertex_buffers(run.first_binding, run.buffers, run.offsets);
+
+		if (bound_geometry)
+		{
+			if (bound_geometry->vertex_buffers.size() < run.first_binding + run.buffers.size())
+			{
+				bound_geometry->vertex_buffers.resize(run.first_binding + run.buffers.size(), {VK_NULL_HANDLE, 0});
+			}
+
+			for (size_t i = 0; i < run.buffers.size(); ++i)
+			{
+				bound_geometry->vertex_buffers[run.first_binding + i] = {run.buffers[i].get().get_handle(), run.offsets[i]};
+			}
+		}
+	}
+
+	auto index_buffer = sub_mesh.get_index_buffer();
+
+	if (sub_mesh.vertex_indices != 0 && index_buffer != nullptr)
+	{
+		if (bound_geometry == nullptr ||
+		    bound_geometry->index_buffer != index_buffer->get_handle() ||
+		    bound_geometry->index_offset != sub_mesh.index_offset ||
+		    bound_geometry->index_type != sub_mesh.index_type)
+		{
+			command_buffer.bind_index_buffer(*index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
+
+			if (bound_geometry)
+			{
+				bound_geometry->index_buffer = index_buffer->get_handle();
+				bound_geometry->index_offset = sub_mesh.index_offset;
+				bound_geometry->index_type   = sub_mesh.index_type;
+			}
+		}
+	}
+
+	draw_submesh_command(command_buffer, sub_mesh, lod, instance_count);
+}
+
+const SubMeshDrawInfo &GeometrySubpass::get_draw_info(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+{
+	auto &variant        = sub_mesh.get_shader_variant();
+	auto &resource_cache = command_buffer.get_device().get_resource_cache();
+
+	size_t key = 0;
+	hash_combine(key, resource_cache.get_shader_generation());
+	hash_combine(key, sub_mesh.get_id());
+	hash_combine(key, sub_mesh.get_material()->get_id());
+	hash_combine(key, variant.get_id());
+	hash_combine(key, get_vertex_shader().get_id());
+	hash_combine(key, get_fragment_shader().get_id());
+	hash_combine(key, bindless_textures.size());
+	hash_combine(key, bindless_texture_arrays.size());
+	hash_combine(key, constant_data_strategy);
+	hash_combine(key, vertex_pulling_variant);
+	hash_combine(key, instancing_variant);
+	hash_combine(key, uses_multiview());
+
+	if (auto draw_info = draw_info_index.find(key))
+	{
+		return *draw_info;
+	}
+
+	std::lock_guard<std::mutex> guard(draw_info_mutex);
+
+	// Another recording thread may have resolved the same submesh in the meantime
+	if (auto draw_info = draw_info_index.find(key))
+	{
+		return *draw_info;
+	}
+
+	auto draw_variant = get_draw_variant(sub_mesh);
+
+	auto &vert_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), draw_variant);
+	auto &frag_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), draw_variant);
+
+	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
+
+	SubMeshDrawInfo draw_info;
+	draw_info.pipeline_layout = &prepare_pipeline_layout(command_buffer, shader_modules);
+
+	DescriptorSetLayout &descriptor_set_layout = draw_info.pipeline_layout->get_descriptor_set_layout(0);
 
 	for (auto &texture : sub_mesh.get_material()->textures)
 	{
 		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
 		{
-			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
-			                          texture.second->get_sampler()->vk_sampler,
-			                          0, layout_binding->binding, 0);
+			draw_info.texture_bindings.emplace_back(layout_binding->binding, texture.second);
 		}
 	}
 
-	auto vertex_input_resources = pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT);
+	draw_info.vertex_input_resources = draw_info.pipeline_layout->get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT);
 
-	VertexInputState vertex_input_state;
-
-	for (auto &input_resource : vertex_input_resources)
+	// Resolve the vertex attributes and buffers once, each shader input location gets its own binding
+	for (auto &input_resource : draw_info.vertex_input_resources)
 	{
+		auto slot = sg::get_vertex_attribute_slot(input_resource.name);
+
 		sg::VertexAttribute attribute;
 
-		if (!sub_mesh.get_attribute(input_resource.name, attribute))
+		bool found = slot != sg::VertexAttributeSlot::Count ? sub_mesh.get_attribute(slot, attribute) : sub_mesh.get_attribute(input_resource.name, attribute);
+		if (!found)
 		{
 			continue;
 		}
@@ -217,33 +1775,36 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 		vertex_attribute.location = input_resource.location;
 		vertex_attribute.offset   = attribute.offset;
 
-		vertex_input_state.attributes.push_back(vertex_attribute);
+		draw_info.vertex_input_state.attributes.push_back(vertex_attribute);
 
 		VkVertexInputBindingDescription vertex_binding{};
 		vertex_binding.binding = input_resource.location;
 		vertex_binding.stride  = attribute.stride;
 
-		vertex_input_state.bindings.push_back(vertex_binding);
-	}
-
-	command_buffer.set_vertex_input_state(vertex_input_state);
+		draw_info.vertex_input_state.bindings.push_back(vertex_binding);
 
-	// Find submesh vertex buffers matching the shader input attribute names
-	for (auto &input_resource : vertex_input_resources)
-	{
-		const auto &buffer_iter = sub_mesh.vertex_buffers.find(input_resource.name);
+		VkDeviceSize offset = 0;
+		auto         buffer = slot != sg::VertexAttributeSlot::Count ? sub_mesh.get_vertex_buffer(slot, offset) : sub_mesh.get_vertex_buffer(input_resource.name, offset);
 
-		if (buffer_iter != sub_mesh.vertex_buffers.end())
+		if (buffer == nullptr)
 		{
-			std::vector<std::reference_wrapper<const core::Buffer>> buffers;
-			buffers.emplace_back(std::ref(buffer_iter->second));
+			continue;
+		}
 
-			// Bind vertex buffers only for the attribute locations defined
-			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
+		auto &runs = draw_info.vertex_buffer_runs;
+		if (runs.empty() || runs.back().first_binding + runs.back().buffers.size() != input_resource.location)
+		{
+			runs.push_back({input_resource.location});
 		}
+
+		runs.back().buffers.emplace_back(std::cref(*buffer));
+		runs.back().offsets.push_back(offset);
 	}
 
-	draw_submesh_command(command_buffer, sub_mesh);
+	draw_infos.push_back(std::move(draw_info));
+	draw_info_index.insert(key, &draw_infos.back());
+
+	return draw_infos.back();
 }
 
 void GeometrySubpass::prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
@@ -286,29 +1847,26 @@ void GeometrySubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::
 	pbr_material_uniform.metallic_factor   = pbr_material->metallic_factor;
 	pbr_material_uniform.roughness_factor  = pbr_material->roughness_factor;
 
-	auto data = to_bytes(pbr_material_uniform);
-
-	if (!data.empty())
-	{
-		command_buffer.push_constants(data);
-	}
+	command_buffer.push_constants(pbr_material_uniform);
 }
 
-void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t lod, uint32_t instance_count)
 {
+	// Pulled vertices are indexed from the base of the submesh in the pulled vertex buffer
+	int32_t vertex_offset = uses_vertex_pulling(sub_mesh) ? sub_mesh.pulled_vertex_offset : sub_mesh.vertex_offset;
+
 	// Draw submesh indexed if indices exists
 	if (sub_mesh.vertex_indices != 0)
 	{
-		// Bind index buffer of submesh
-		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
+		// The levels of detail are ranges of the index data drawn with the same vertices
+		auto indices = sub_mesh.get_lod_indices(lod);
 
-		// Draw submesh using indexed data
-		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, 0);
+		command_buffer.draw_indexed(indices.second, instance_count, indices.first, vertex_offset, 0);
 	}
 	else
 	{
 		// Draw submesh using vertices only
-		command_buffer.draw(sub_mesh.vertices_count, 1, 0, 0);
+		command_buffer.draw(sub_mesh.vertices_count, instance_count, static_cast<uint32_t>(vertex_offset), 0);
 	}
 }
 
@@ -316,4 +1874,14 @@ void GeometrySubpass::set_thread_index(uint32_t index)
 {
 	thread_index = index;
 }
+
+void GeometrySubpass::set_frustum_culling(bool enabled)
+{
+	frustum_culling = enabled;
+}
+
+std::pair<uint32_t, uint32_t> GeometrySubpass::take_culling_counts()
+{
+	return {visible_draw_count.exchange(0), culled_draw_count.exchange(0)};
+}
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -21,17 +21,28 @@
 
 #include "common/glm_common.h"
 
+#include "core/command_pool.h"
+#include "core/util/read_mostly_map.hpp"
+#include "core/util/sort_key_list.hpp"
+#include "geometry/aabb_batch.h"
 #include "rendering/subpass.h"
 
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
 namespace vkb
 {
 namespace sg
 {
 class Scene;
 class Node;
+class Material;
 class Mesh;
 class SubMesh;
 class Camera;
+class Texture;
 }        // namespace sg
 
 /**
@@ -44,6 +55,64 @@ struct alignas(16) GlobalUniform
 	glm::mat4 camera_view_proj;
 
 	glm::vec3 camera_position;
+
+	/// Box of the quantized positions of the mesh, see sg::Mesh::get_position_offset(), read with QUANTIZED_POSITION
+	alignas(16) glm::vec4 position_offset{0.0f};
+
+	glm::vec4 position_scale{1.0f};
+
+	/// Model matrix of the previous frame, read with MOTION_VECTORS
+	glm::mat4 previous_model{1.0f};
+
+	/// Camera matrix of the previous frame without jitter, read with MOTION_VECTORS
+	glm::mat4 previous_camera_view_proj{1.0f};
+
+	/// Clip space offset camera_view_proj is jittered by in xy, see RenderContext::set_projection_jitter()
+	glm::vec4 jitter{0.0f};
+};
+
+/// Most views drawn at once with multiview, see GeometrySubpass::set_views() and multiview.h
+constexpr uint32_t MAX_VIEW_COUNT{4};
+
+/**
+ * @brief Camera matrices of the views drawn with MULTIVIEW, indexed by gl_ViewIndex, see multiview.h
+ */
+struct alignas(16) MultiviewUniform
+{
+	glm::mat4 view_proj[MAX_VIEW_COUNT];
+
+	/// Matrices of the previous frame without jitter, read with MOTION_VECTORS
+	glm::mat4 previous_view_proj[MAX_VIEW_COUNT];
+
+	glm::vec4 camera_position[MAX_VIEW_COUNT];
+};
+
+/**
+ * @brief A view drawn from the camera of a geometry subpass with multiview, such as an eye of a stereo pair
+ */
+struct CameraView
+{
+	/// Transform from the space of the camera to the space of the view, such as the offset of an eye from the head
+	glm::mat4 view_from_camera{1.0f};
+
+	/// Projection of the view, with the conventions of sg::Camera::get_projection(), such as the asymmetric frustum of an eye
+	glm::mat4 projection{1.0f};
+};
+
+/**
+ * @brief How geometry subpasses bind the GlobalUniform of each draw, see GeometrySubpass::set_constant_data_strategy()
+ *        The constant_data sample compares these methods, and more which need shaders of their own.
+ */
+enum class ConstantDataStrategy
+{
+	/// Chosen for the device by GeometrySubpass::select_constant_data_strategy()
+	Automatic,
+
+	/// One descriptor set per draw, each pointing at the uniform of the draw
+	DescriptorSets,
+
+	/// A dynamic uniform buffer, so that draws share a descriptor set and bind their uniform with a dynamic offset
+	DynamicDescriptorSets
 };
 
 /**
@@ -58,6 +127,60 @@ struct PBRMaterialUniform
 	float roughness_factor;
 };
 
+/**
+ * @brief PBR material uniform for base shader with bindless materials, see GeometrySubpass::set_bindless_materials()
+ *        The texture indices are -1 for the textures the material does not have.
+ */
+struct BindlessMaterialUniform
+{
+	glm::vec4 base_color_factor;
+
+	float metallic_factor;
+
+	float roughness_factor;
+
+	int32_t base_color_texture_index;
+
+	int32_t normal_texture_index;
+
+	int32_t metallic_roughness_texture_index;
+
+	int32_t occlusion_texture_index;
+
+	int32_t emissive_texture_index;
+};
+
+/**
+ * @brief Vertex buffers bound to consecutive bindings
+ */
+struct VertexBufferRun
+{
+	uint32_t first_binding{0};
+
+	std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+
+	std::vector<VkDeviceSize> offsets;
+};
+
+/**
+ * @brief Pipeline state resolved for drawing a submesh with the shaders of a subpass
+ */
+struct SubMeshDrawInfo
+{
+	PipelineLayout *pipeline_layout{nullptr};
+
+	/// Binding index of each material texture used by the pipeline layout
+	std::vector<std::pair<uint32_t, sg::Texture *>> texture_bindings;
+
+	std::vector<ShaderResource> vertex_input_resources;
+
+	/// Attributes of the submesh read by the vertex shader, one binding per shader input location
+	VertexInputState vertex_input_state;
+
+	/// Vertex buffers of the submesh for the bindings of vertex_input_state
+	std::vector<VertexBufferRun> vertex_buffer_runs;
+};
+
 /**
  * @brief This subpass is responsible for rendering a Scene
  */
@@ -78,20 +201,221 @@ class GeometrySubpass : public Subpass
 
 	virtual void prepare() override;
 
+	/**
+	 * @brief Copies the occlusion query results of the previous frame to the predicates, if occlusion predicates are used
+	 *        Subclasses overriding pre_draw() should call GeometrySubpass::pre_draw() first.
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer) override;
+
 	/**
 	 * @brief Record draw commands
 	 */
 	virtual void draw(CommandBuffer &command_buffer) override;
 
+	/**
+	 * @brief Geometry subpasses can split their draws across secondary command buffers
+	 *        Subclasses overriding draw() without calling GeometrySubpass::draw() should return false.
+	 */
+	virtual bool supports_parallel_recording() const override;
+
 	/**
 	 * @brief Thread index to use for allocating resources
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Enables or disables culling mesh nodes against the camera frustum, enabled by default
+	 *        With sg::Scene::set_bvh_enabled(), the nodes are found by querying the hierarchy instead of testing each one,
+	 *        unless the draws are recorded from a SceneSnapshot, as the hierarchy follows the live scene.
+	 */
+	void set_frustum_culling(bool enabled);
+
+	/**
+	 * @brief Enables or disables bindless materials, disabled by default, takes effect on the next prepare()
+	 *        The textures of all the scene materials are put in one descriptor array, material_textures at set 1, binding 0,
+	 *        which is bound once per draw() instead of binding the material textures of every draw. Draws pass the indices
+	 *        of their textures in the array with a BindlessMaterialUniform push constant. The shaders are compiled with the
+	 *        BINDLESS_MATERIALS and MATERIAL_TEXTURE_COUNT definitions, which base.frag supports. Textures packed in texture
+	 *        arrays, see GLTFLoader::set_texture_arrays(), are bound once per array and sampler in material_texture_arrays
+	 *        at binding 1, with the MATERIAL_TEXTURE_ARRAY_COUNT definition, and their indices hold their layer.
+	 *        Requires the shaderSampledImageArrayDynamicIndexing feature. Without it, or if the scene has more textures than
+	 *        a shader stage can sample, draws bind their material textures as usual.
+	 * @param enabled Whether to use bindless materials
+	 * @param update_after_bind Creates the array with the update-after-bind flag, which lifts the per stage sampler limit
+	 *        on many devices. Requires VK_EXT_descriptor_indexing, with descriptorBindingSampledImageUpdateAfterBind enabled.
+	 */
+	void set_bindless_materials(bool enabled, bool update_after_bind = false);
+
+	/**
+	 * @brief Sets how the GlobalUniform of each draw is bound, Automatic by default, takes effect on the next prepare()
+	 *        The uniforms are written to the same per-frame block whatever the strategy, only their descriptors differ.
+	 */
+	void set_constant_data_strategy(ConstantDataStrategy strategy);
+
+	/**
+	 * @return The strategy the draws are recorded with, Automatic resolved to the one chosen for the device
+	 */
+	ConstantDataStrategy get_constant_data_strategy() const;
+
+	/**
+	 * @brief Chooses the fastest way to bind the uniforms of the draws on a GPU, from the measurements of the constant_data sample
+	 *        Arm Mali GPUs spend more time binding dynamic offsets than they save, others save the descriptor set of every draw.
+	 */
+	static ConstantDataStrategy select_constant_data_strategy(const PhysicalDevice &gpu);
+
+	/**
+	 * @brief Enables or disables half precision shading, enabled by default, takes effect on the next prepare()
+	 *        The shaders are compiled with the FP16_ARITHMETIC definition, which base.frag supports, if the device supports
+	 *        it, see Device::uses_float16_arithmetic(). Positions are kept in full precision.
+	 */
+	void set_float16_arithmetic(bool enabled);
+
+	/**
+	 * @brief Enables or disables retaining the opaque draws in a secondary command buffer per frame, disabled by default
+	 *        The opaque draws are recorded again only when the set of visible draws, their materials and pipeline state,
+	 *        the resources bound before the draw or the render target change. Otherwise the command buffer recorded for
+	 *        the frame is executed again, once the GlobalUniform of every draw is written in place, so the camera and the
+	 *        nodes can move without recording. As long as the visible draws are the same, they keep their recorded order.
+	 *        Transparent draws are sorted every frame, so they are recorded in a secondary command buffer of their own.
+	 *        Requires the descriptor set cache of the frame, see DescriptorManagementStrategy::StoreInCache, and no
+	 *        descriptor buffers, otherwise the draws are recorded as usual. Material factors are captured when recording,
+	 *        and subclasses overriding update_uniform() should not enable it.
+	 */
+	void set_retained_draws(bool enabled);
+
+	/**
+	 * @brief Whether the opaque draws are retained this frame, see set_retained_draws()
+	 *        Subclasses overriding draw() without calling GeometrySubpass::draw() should return false.
+	 */
+	virtual bool retains_draws() const override;
+
+	/**
+	 * @brief Enables or disables skipping the heavy meshes hidden in the previous frame, disabled by default, takes effect on the next prepare()
+	 *        After the draws, the bounding box of every mesh node with at least min_index_count opaque indices is tested against
+	 *        the depth with an occlusion query. The next frame copies the results to a buffer on the GPU, and draws the opaque
+	 *        submeshes of each tested node in a conditional rendering block reading its result, so that hidden meshes are skipped
+	 *        without the CPU waiting for the queries. A mesh coming into view is drawn one frame late.
+	 *        Requires VK_EXT_conditional_rendering with the conditionalRendering feature, otherwise every mesh is drawn.
+	 *        The draws are then recorded on the primary command buffer, as they are neither retained nor split across threads.
+	 */
+	void set_occlusion_predicates(bool enabled, uint32_t min_index_count = 10000);
+
+	/**
+	 * @brief Enables or disables vertex pulling, disabled by default, takes effect on the next prepare()
+	 *        The submeshes with vertices packed by GLTFLoader::set_vertex_pulling() are drawn with the VERTEX_PULLING definition,
+	 *        which base.vert supports: the vertex shader reads the packed vertices from a storage buffer at set 0, binding 7,
+	 *        at gl_VertexIndex, and each draw passes the base of its vertices as its vertex offset. Their pipelines have no
+	 *        vertex input state, so submeshes of all vertex layouts share them, and no vertex buffers are bound.
+	 *        Other submeshes are drawn with their vertex attributes. Subpasses with vertex shaders of their own should keep it disabled.
+	 */
+	void set_vertex_pulling(bool enabled);
+
+	/**
+	 * @brief Enables or disables instancing of repeated submeshes, disabled by default, takes effect on the next prepare()
+	 *        The opaque draws are sorted so that the draws of the same submesh follow each other, and each run of them is
+	 *        recorded as a single instanced draw. The opaque submeshes are drawn with the INSTANCING definition, which base.vert
+	 *        supports: the vertex shader reads the model matrices of the nodes from a storage buffer at set 0, binding 14,
+	 *        at gl_InstanceIndex. Skinned nodes are drawn one at a time, as their joint matrices differ.
+	 *        Draws are then neither retained nor predicated by occlusion queries. Subpasses with vertex shaders of their
+	 *        own should keep it disabled.
+	 */
+	void set_instancing(bool enabled);
+
+	/**
+	 * @brief Enables or disables writing motion vectors, disabled by default, takes effect on the next prepare()
+	 *        The draws are compiled with the MOTION_VECTORS definition, which base.vert and base.frag support, and write the
+	 *        screen space velocity from the previous frame to RenderTarget::MV_VELOCITY_ATTACHMENT, appended as output 1 of
+	 *        the subpass, see RenderTarget::create_motion_vectors_func(). The previous positions are found with the previous
+	 *        world matrices of the nodes, so skinned meshes move with their node but not with their joints. Transparent draws
+	 *        do not write velocity.
+	 */
+	void set_motion_vectors(bool enabled);
+
+	/**
+	 * @brief Sets the layout of the G-buffer drawn to, GBufferLayout::Default by default, takes effect on the next prepare()
+	 *        The draws of the packed layout are compiled with the PACKED_GBUFFER definition, which deferred/geometry.frag
+	 *        supports, see RenderTarget::create_gbuffer_func().
+	 */
+	void set_gbuffer_layout(GBufferLayout layout);
+
+	/**
+	 * @brief Sets the views drawn when the render target renders several views at once, see RenderTarget::set_view_count()
+	 *        The draws are then recorded once for all views with the MULTIVIEW definition, which base.vert, pbr.frag,
+	 *        depth_prepass.vert and deferred/geometry.vert support: the shaders read the camera matrices of each view from
+	 *        a uniform buffer at set 0, binding 15, at gl_ViewIndex, see multiview.h. The mesh nodes are culled once against
+	 *        a frustum containing all the views. Views missing from the list are drawn from the camera itself.
+	 *        Draws are then not retained. Subpasses with vertex shaders of their own should not draw to multiview targets.
+	 * @param views The views, at most MAX_VIEW_COUNT
+	 */
+	void set_views(const std::vector<CameraView> &views);
+
+	/**
+	 * @brief Returns the number of submesh draws which passed and failed frustum culling
+	 *        in the geometry subpasses drawing the camera view since the last call, and resets the counts.
+	 *        Shadow and depth prepasses are not counted, nor are the nodes dropped by the level of detail selection.
+	 * @return A pair of the visible and the culled draw counts
+	 */
+	static std::pair<uint32_t, uint32_t> take_culling_counts();
+
   protected:
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
-	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
+	/**
+	 * @brief Allocates a single per-frame uniform block with room for the GlobalUniform of draw_count draws
+	 *        Until end_instance_uniforms() is called, update_uniform() copies each GlobalUniform into the
+	 *        next slot of this block and binds it at the slot offset, instead of allocating per node.
+	 *        Once the block is full, update_uniform() falls back to one allocation per node.
+	 */
+	void begin_instance_uniforms(CommandBuffer &command_buffer, size_t draw_count);
+
+	void end_instance_uniforms();
+
+	/**
+	 * @brief Records the opaque draws in [draw_start, draw_end) of the sorted draw list
+	 */
+	void record_opaque_draws(CommandBuffer &command_buffer, size_t draw_start, size_t draw_end, size_t thread_index);
+
+	/**
+	 * @brief Enables alpha blending, then records the transparent draws back-to-front
+	 */
+	void record_transparent_draws(CommandBuffer &command_buffer, size_t thread_index);
+
+	/**
+	 * @brief Records the sorted draws into secondary command buffers as jobs, then executes them in order
+	 *        The opaque draws are split in contiguous ranges, one per thread, and the transparent draws are recorded
+	 *        by a single job. Bindings made on the primary command buffer before the draw are carried over.
+	 */
+	void record_draws_parallel(CommandBuffer &primary_command_buffer, JobSystem &job_system);
+
+	/**
+	 * @brief Executes the retained opaque draws of the active frame, recording them again if they are out of date,
+	 *        then records and executes the transparent draws, see set_retained_draws()
+	 */
+	void record_draws_retained(CommandBuffer &primary_command_buffer);
+
+	/**
+	 * @brief Geometry buffers bound on a command buffer by the previous draws
+	 *        Submeshes sharing buffers, such as the ones packed by GLTFLoader::set_pack_geometry(), are then drawn without rebinding them.
+	 */
+	struct BoundGeometry
+	{
+		/// Buffer and offset bound at each vertex binding
+		std::vector<std::pair<VkBuffer, VkDeviceSize>> vertex_buffers;
+
+		VkBuffer index_buffer{VK_NULL_HANDLE};
+
+		VkDeviceSize index_offset{0};
+
+		VkIndexType index_type{VK_INDEX_TYPE_MAX_ENUM};
+	};
+
+	/**
+	 * @brief Binds the state and geometry of a submesh, then records its draw
+	 * @param bound_geometry Geometry already bound on the command buffer, updated by the draw, nullptr to bind all of it
+	 * @param lod Level of detail of the submesh to draw, see sg::SubMesh::get_lod_indices()
+	 * @param instance_count Number of instances to draw, more than one only with the transforms bound by bind_instance_transforms()
+	 */
+	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE, BoundGeometry *bound_geometry = nullptr, uint32_t lod = 0, uint32_t instance_count = 1);
 
 	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
 
@@ -99,7 +423,69 @@ class GeometrySubpass : public Subpass
 
 	virtual void prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
 
-	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
+	/**
+	 * @brief Records the draw of instance_count instances of a level of detail of a submesh, once its vertex and index buffers are bound
+	 */
+	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t lod, uint32_t instance_count);
+
+	/**
+	 * @brief Returns the shader modules, pipeline layout, texture and vertex bindings used to draw a submesh
+	 *        The result is computed once and reused until the submesh shader variant or material,
+	 *        or the subpass shaders, change. Safe to call from multiple recording threads.
+	 *        The vertex buffers of a submesh must not be replaced once it has been drawn.
+	 */
+	const SubMeshDrawInfo &get_draw_info(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Collects the textures of the materials of the meshes in the bindless array,
+	 *        if bindless materials are enabled and supported
+	 */
+	void prepare_bindless_materials();
+
+	/**
+	 * @return Whether prepare_bindless_materials() put textures in the bindless arrays
+	 */
+	bool uses_bindless_materials() const;
+
+	/**
+	 * @brief Resolves the constant data strategy, and sets the resource mode of the GlobalUniform for it
+	 */
+	void prepare_constant_data_strategy();
+
+	/**
+	 * @return The shader variant to draw a submesh with: the one of the submesh, plus the bindless definitions if they are used
+	 */
+	ShaderVariant get_draw_variant(const sg::SubMesh &sub_mesh) const;
+
+	/**
+	 * @brief Builds the shader modules of the draw variants of all the submeshes before the first frame,
+	 *        the distinct variants are compiled in parallel on the JobSystem::get() workers
+	 */
+	void prepare_shader_modules();
+
+	/**
+	 * @brief Binds the bindless texture array, with the current image of every texture
+	 */
+	void bind_bindless_materials(CommandBuffer &command_buffer);
+
+	void prepare_bindless_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Computes the world space bounds and camera distance of every mesh node, selects the level of detail
+	 *        of the nodes with a sg::LodGroup, and culls the nodes against the camera frustum
+	 */
+	void cull_mesh_nodes();
+
+	/**
+	 * @return The mesh a node is drawn with in the current frame: the one of the level of detail selected by
+	 *         cull_mesh_nodes() if the node has a sg::LodGroup, otherwise its sg::Mesh, nullptr if it has none
+	 */
+	sg::Mesh *get_draw_mesh(sg::Node &node) const;
+
+	/**
+	 * @return The level of detail the submeshes of a node are drawn at in the current frame, see sg::LodLevel::submesh_lod
+	 */
+	uint32_t get_submesh_lod(const sg::Node &node) const;
 
 	/**
 	 * @brief Sorts objects based on distance from camera and classifies them
@@ -108,6 +494,15 @@ class GeometrySubpass : public Subpass
 	void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
 	                      std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
 
+	using DrawList = SortKeyList<std::pair<sg::Node *, sg::SubMesh *>>;
+
+	/**
+	 * @brief Classifies objects into opaque and transparent and sorts them into the lists provided
+	 *        Opaque objects are ordered by pipeline state, then material, then front-to-back.
+	 *        Transparent objects are ordered front-to-back, so should be drawn in reverse.
+	 */
+	void get_sorted_draws(DrawList &opaque_draws, DrawList &transparent_draws);
+
 	sg::Camera &camera;
 
 	std::vector<sg::Mesh *> meshes;
@@ -117,6 +512,299 @@ class GeometrySubpass : public Subpass
 	uint32_t thread_index{0};
 
 	vkb::RasterizationState base_rasterization_state{};
+
+	struct MeshNode
+	{
+		/// Mesh of the level of detail drawn, see get_draw_mesh()
+		sg::Mesh *mesh;
+
+		sg::Node *node;
+
+		float distance;
+
+		bool visible;
+	};
+
+	/// Mesh nodes of the scene as of the last call to cull_mesh_nodes
+	std::vector<MeshNode> mesh_nodes;
+
+	/// World space bounds of mesh_nodes, in the same order
+	AABBBatch mesh_node_bounds;
+
+	std::vector<uint8_t> mesh_node_visibility;
+
+	/// Mesh nodes found in the frustum by the bounding volume hierarchy of the scene, sorted
+	std::vector<sg::Node *> bvh_visible_nodes;
+
+	/// Level of detail of a node with a sg::LodGroup, see sg::LodGroup::select_level()
+	struct NodeLod
+	{
+		uint32_t level{0};
+
+		sg::Mesh *mesh{nullptr};
+
+		uint32_t submesh_lod{0};
+	};
+
+	/// Levels of detail of the nodes with a sg::LodGroup, kept across frames as the previous levels of the hysteresis
+	std::unordered_map<const sg::Node *, NodeLod> node_lods;
+
+	bool frustum_culling{true};
+
+	/// Whether the culling results are added to take_culling_counts(), disabled by the passes drawing the scene a second time
+	bool culling_stats{true};
+
+	/// Set by set_motion_vectors()
+	bool motion_vectors{false};
+
+	/// Set by set_gbuffer_layout()
+	GBufferLayout gbuffer_layout{GBufferLayout::Default};
+
+	/// Camera matrices without jitter of the previous and current draw(), see set_motion_vectors()
+	glm::mat4 previous_view_proj{1.0f};
+
+	glm::mat4 current_view_proj{1.0f};
+
+	bool has_view_proj_history{false};
+
+	/// Resolved on draw, the views of the render target drawn to, see set_views()
+	uint32_t view_count{1};
+
+	/// Definitions of subclasses added to the shader variant of every draw, to be set before prepare_shader_modules()
+	std::vector<std::string> draw_definitions;
+
+	/// Draw lists reused across frames so that sorting does not allocate
+	DrawList opaque_draws;
+
+	DrawList transparent_draws;
+
+  private:
+	/// Below this many opaque draws per worker, recording in parallel costs more than it saves
+	static constexpr size_t MIN_DRAWS_PER_SECONDARY_COMMAND_BUFFER{64};
+
+	struct RetainedFrame
+	{
+		RenderFrame *render_frame{nullptr};
+
+		std::unique_ptr<CommandPool> command_pool;
+
+		CommandBuffer *command_buffer{nullptr};
+
+		/// Opaque draws in the order they were recorded
+		std::vector<std::pair<sg::Node *, sg::SubMesh *>> draws;
+
+		/// Hash of what the command buffer was recorded for, zero if it was not recorded
+		size_t key{0};
+	};
+
+	/**
+	 * @return The retained command buffer of a frame, created on first use with a pool of the queue family
+	 */
+	RetainedFrame &get_retained_frame(RenderFrame &render_frame, uint32_t queue_family_index);
+
+	/**
+	 * @return A hash of an opaque draw and of the pipeline state and resources its commands depend on
+	 */
+	size_t hash_retained_draw(sg::Node &node, sg::SubMesh &sub_mesh) const;
+
+	/**
+	 * @brief Uploads the joint matrices of the skinned nodes in the draw lists, once per frame before recording the draws
+	 */
+	void update_joint_matrices();
+
+	/**
+	 * @brief Binds the joint matrices of a node for the skinning in the vertex shader, if the node has a skin
+	 */
+	void bind_joint_matrices(CommandBuffer &command_buffer, sg::Node &node);
+
+	/**
+	 * @brief Jitters the camera matrix of a draw, and sets the matrices of the previous frame read with MOTION_VECTORS
+	 */
+	void set_temporal_matrices(GlobalUniform &global_uniform, sg::Node &node) const;
+
+	/**
+	 * @return Whether the draws are recorded once for several views, see set_views()
+	 */
+	bool uses_multiview() const;
+
+	/**
+	 * @brief Uploads the camera matrices of the views drawn this frame, once per frame before culling and recording the draws
+	 */
+	void update_multiview_uniform();
+
+	/**
+	 * @return Whether a submesh is drawn with vertex pulling, see set_vertex_pulling()
+	 */
+	bool uses_vertex_pulling(const sg::SubMesh &sub_mesh) const;
+
+	/**
+	 * @return Whether a submesh is drawn with instancing, see set_instancing()
+	 */
+	bool uses_instancing(const sg::SubMesh &sub_mesh) const;
+
+	/**
+	 * @return The end of the run of opaque draws from draw_start which are drawn as instances of a single draw, see set_instancing()
+	 */
+	size_t find_instance_run(size_t draw_start, size_t draw_end) const;
+
+	/**
+	 * @brief Uploads the model matrices of the nodes of the opaque draws in [draw_start, draw_end), and binds them for INSTANCING
+	 */
+	void bind_instance_transforms(CommandBuffer &command_buffer, size_t draw_start, size_t draw_end, size_t thread_index);
+
+	/**
+	 * @return Whether the heavy meshes are drawn with occlusion predicates this frame, see set_occlusion_predicates()
+	 */
+	bool uses_occlusion_predicates() const;
+
+	/**
+	 * @brief Copies the occlusion query results of the previous frame to the predicates of the active frame,
+	 *        and resets the queries of the active frame, outside of the render pass
+	 */
+	void copy_occlusion_predicates(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Finds the predicate of a node in the active frame
+	 * @return The offset of the predicate in the predicate buffer of the frame, or VK_WHOLE_SIZE if the node is drawn unconditionally
+	 */
+	VkDeviceSize find_occlusion_predicate(const sg::Node &node) const;
+
+	/**
+	 * @brief Records an occlusion query drawing the bounding box of each visible heavy mesh node, once the opaque draws are recorded
+	 */
+	void record_occlusion_queries(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Writes the GlobalUniform of a node into a slot of the per-frame instance block
+	 * @return The offset of the slot in the buffer of the block
+	 */
+	VkDeviceSize write_instance_uniform(sg::Node &node, uint32_t slot);
+
+	/// Memoized draw infos, indexed by the identifiers of the submesh and material and everything that affects the resolved pipeline objects
+	ReadMostlyMap<SubMeshDrawInfo> draw_info_index;
+
+	std::deque<SubMeshDrawInfo> draw_infos;
+
+	std::mutex draw_info_mutex;
+
+	/// Component generation of the scene the draw infos were resolved for, see sg::Scene::get_component_generation()
+	uint64_t draw_info_generation{0};
+
+	/// Set by set_bindless_materials()
+	bool bindless_materials{false};
+
+	bool bindless_update_after_bind{false};
+
+	/// Set by set_float16_arithmetic()
+	bool float16_arithmetic{true};
+
+	/// Resolved on prepare, whether the shaders are compiled with FP16_ARITHMETIC
+	bool float16_variant{false};
+
+	/// Binding of the packed vertices read with VERTEX_PULLING, see base.vert
+	static constexpr uint32_t PULLED_VERTEX_BINDING{7};
+
+	/// Set by set_vertex_pulling()
+	bool vertex_pulling{false};
+
+	/// Resolved on prepare, whether the submeshes with packed vertices are drawn with VERTEX_PULLING
+	bool vertex_pulling_variant{false};
+
+	/// Binding of the model matrices read with INSTANCING, see base.vert
+	static constexpr uint32_t INSTANCE_BINDING{14};
+
+	/// Set by set_instancing()
+	bool instancing{false};
+
+	/// Resolved on prepare, whether the opaque submeshes are drawn with INSTANCING
+	bool instancing_variant{false};
+
+	/// Binding of the camera matrices of the views read with MULTIVIEW, see multiview.h
+	static constexpr uint32_t MULTIVIEW_BINDING{15};
+
+	/// Set by set_views()
+	std::vector<CameraView> views;
+
+	/// Matrices of the views uploaded by update_multiview_uniform(), bound with the GlobalUniform of every draw
+	BufferAllocation multiview_uniform;
+
+	/// Matrices of the views without jitter of the last draw() with multiview, culled against and kept for set_motion_vectors()
+	std::vector<glm::mat4> current_view_projs;
+
+	/// Set by set_constant_data_strategy()
+	ConstantDataStrategy requested_constant_data_strategy{ConstantDataStrategy::Automatic};
+
+	/// Resolved on prepare, never Automatic
+	ConstantDataStrategy constant_data_strategy{ConstantDataStrategy::DescriptorSets};
+
+	/// Textures in the bindless array, empty if bindless materials are not used
+	std::vector<sg::Texture *> bindless_textures;
+
+	/// A texture of each texture array and sampler in the bindless array of texture arrays
+	std::vector<sg::Texture *> bindless_texture_arrays;
+
+	/// Push constants of each material, with the texture indices in the bindless array
+	std::unordered_map<const sg::Material *, BindlessMaterialUniform> bindless_material_uniforms;
+
+	/// Per-frame block holding the GlobalUniform of every draw, see begin_instance_uniforms()
+	BufferAllocation instance_uniforms;
+
+	uint32_t instance_uniform_capacity{0};
+
+	/// Next free slot, atomic since draws may be recorded from several threads
+	std::atomic<uint32_t> instance_uniform_count{0};
+
+	/// Joint matrices of the skinned nodes drawn this frame, see update_joint_matrices()
+	std::unordered_map<const sg::Node *, BufferAllocation> joint_matrices;
+
+	/// Hash of where joint_matrices are, as the retained draws bind them there
+	size_t joint_matrices_hash{0};
+
+	/// Set by set_retained_draws()
+	bool retained_draws{false};
+
+	std::vector<RetainedFrame> retained_frames;
+
+	/// Heavy mesh nodes tested at most, the size of the query pool and predicate buffer of each frame
+	static constexpr uint32_t MAX_OCCLUSION_QUERIES{1024};
+
+	struct OcclusionFrame
+	{
+		std::unique_ptr<QueryPool> query_pool;
+
+		/// A 32-bit predicate per query slot, holding the results of the queries of the previous frame
+		std::unique_ptr<core::Buffer> predicates;
+
+		/// Whether the query of each slot was recorded in the frame
+		std::vector<uint8_t> queried;
+
+		/// Whether the predicate of each slot holds a result in the frame
+		std::vector<uint8_t> predicated;
+	};
+
+	/// Set by set_occlusion_predicates()
+	bool occlusion_predicates{false};
+
+	uint32_t occlusion_min_index_count{0};
+
+	/// Resolved on prepare, whether the device supports conditional rendering
+	bool occlusion_predicates_supported{false};
+
+	std::unique_ptr<ShaderSource> occlusion_box_vertex_shader;
+
+	std::unique_ptr<ShaderSource> occlusion_box_fragment_shader;
+
+	std::vector<OcclusionFrame> occlusion_frames;
+
+	/// Query slot of each tested mesh node, kept across frames so that the results of a frame are found in the next one
+	std::unordered_map<const sg::Node *, uint32_t> occlusion_slots;
+
+	/// Index of the frame which recorded the queries read by the active frame
+	uint32_t previous_occlusion_frame{~0U};
+
+	static std::atomic<uint32_t> visible_draw_count;
+
+	static std::atomic<uint32_t> culled_draw_count;
 };
 
 }        // namespace vkb
@@ -0,0 +1,942 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/indirect_subpass.h"
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "core/allocated.h"
+#include "core/util/logging.hpp"
+#include "geometry/frustum.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/lod_group.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/sampler.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/components/texture.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief Culling shader parameters, see indirect_cull.comp
+ */
+struct alignas(16) CullUniform
+{
+	glm::vec4 frustum_planes[6];
+
+	uint32_t draw_count;
+
+	/// Hi-Z pyramid of the late occlusion culling phase
+	uint32_t pyramid_level_count;
+
+	glm::uvec2 pyramid_extent;
+
+	glm::mat4 view_proj;
+
+	/// World space position of the camera, for the screen sizes of the levels of detail
+	glm::vec4 camera_position;
+
+	/// Terms of the projection the screen sizes are computed from, see sg::LodGroup::get_screen_size()
+	glm::vec4 lod_projection;
+};
+
+/// Bindings of indirect_cull.comp
+constexpr uint32_t VISIBILITY_BINDING  = 4;
+constexpr uint32_t HIZ_PYRAMID_BINDING = 5;
+constexpr uint32_t COUNT_BINDING       = 6;
+constexpr uint32_t LOD_BINDING         = 7;
+
+bool is_host_readable(const core::Buffer &buffer)
+{
+	return (buffer.get_memory_properties() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+/**
+ * @brief Whether a vertex attribute has the format expected by indirect_geometry.vert, with data the host can read
+ *        Optional attributes may also be absent, in which case they are merged as zeros.
+ */
+bool is_attribute_mergeable(sg::SubMesh &sub_mesh, sg::VertexAttributeSlot slot, VkFormat format, uint32_t format_size, bool required)
+{
+	sg::VertexAttribute attribute;
+	if (!sub_mesh.get_attribute(slot, attribute))
+	{
+		return !required;
+	}
+
+	VkDeviceSize offset = 0;
+	auto         buffer = sub_mesh.get_vertex_buffer(slot, offset);
+	if (attribute.format != format || buffer == nullptr || !is_host_readable(*buffer) || sub_mesh.vertex_offset < 0)
+	{
+		return false;
+	}
+
+	VkDeviceSize stride = attribute.stride ? attribute.stride : format_size;
+	return offset + attribute.offset + (sub_mesh.vertex_offset + sub_mesh.vertices_count - 1) * stride + format_size <= buffer->get_size();
+}
+
+template <typename T>
+void append_attribute(sg::SubMesh &sub_mesh, sg::VertexAttributeSlot slot, std::vector<T> &data)
+{
+	size_t first_vertex = data.size();
+	data.resize(first_vertex + sub_mesh.vertices_count, T{0.0f});
+
+	sg::VertexAttribute attribute;
+	VkDeviceSize        offset = 0;
+	auto                buffer = sub_mesh.get_vertex_buffer(slot, offset);
+	if (!sub_mesh.get_attribute(slot, attribute) || buffer == nullptr)
+	{
+		return;
+	}
+
+	bool was_mapped = buffer->mapped();
+
+	// Packed submeshes start at their vertex offset within the shared buffer
+	size_t         stride      = attribute.stride ? attribute.stride : sizeof(T);
+	const uint8_t *vertex_data = buffer->map() + offset + attribute.offset + sub_mesh.vertex_offset * stride;
+
+	for (size_t i = 0; i < sub_mesh.vertices_count; ++i)
+	{
+		std::memcpy(&data[first_vertex + i], vertex_data + i * stride, sizeof(T));
+	}
+
+	if (!was_mapped)
+	{
+		buffer->unmap();
+	}
+}
+
+/**
+ * @return The number of indices of a submesh, including the ones of its levels of detail which follow the full detail
+ */
+uint32_t get_index_count(const sg::SubMesh &sub_mesh)
+{
+	uint32_t index_count = sub_mesh.vertex_indices;
+	for (auto &lod : sub_mesh.lods)
+	{
+		index_count = std::max(index_count, lod.first_index + lod.index_count);
+	}
+
+	return index_count;
+}
+
+/**
+ * @brief Whether the levels of detail of the nodes of a mesh only draw the simplified levels of its submeshes
+ */
+bool has_mergeable_lods(sg::Mesh &mesh)
+{
+	for (auto node : mesh.get_nodes())
+	{
+		if (!node->has_component<sg::LodGroup>())
+		{
+			continue;
+		}
+
+		for (auto &level : node->get_component<sg::LodGroup>().get_levels())
+		{
+			if (level.mesh != &mesh)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Sets the levels of detail of a draw from the sg::LodGroup of its node, a node without one keeps the full detail
+ * @param info Draw info of the submesh within the merged buffers, see IndirectSubpass::merge_sub_mesh()
+ */
+void set_draw_lods(IndirectDrawInfo &info, const sg::SubMesh &sub_mesh, sg::Node &node)
+{
+	info.lod_count          = 1;
+	info.lod_first_index[0] = info.first_index;
+	info.lod_index_count[0] = info.index_count;
+	info.lod_screen_size[0] = 0.0f;
+
+	if (!node.has_component<sg::LodGroup>() || sub_mesh.vertex_indices == 0)
+	{
+		return;
+	}
+
+	auto &levels = node.get_component<sg::LodGroup>().get_levels();
+	if (levels.empty())
+	{
+		return;
+	}
+
+	info.lod_count = std::min(to_u32(levels.size()), IndirectDrawInfo::MAX_LOD_COUNT);
+
+	for (uint32_t i = 0; i < info.lod_count; ++i)
+	{
+		// Indices of the levels are merged along with the full detail, at the same offsets
+		auto indices = sub_mesh.get_lod_indices(levels[i].submesh_lod);
+
+		info.lod_first_index[i] = info.first_index + indices.first - sub_mesh.first_index;
+		info.lod_index_count[i] = indices.second;
+		info.lod_screen_size[i] = levels[i].screen_size;
+	}
+
+	// The coarser levels are drawn at the last one, which is then culled below the coarsest screen size
+	info.lod_screen_size[info.lod_count - 1] = levels.back().screen_size;
+}
+
+template <typename T>
+std::unique_ptr<core::Buffer> create_device_buffer(CommandBuffer &command_buffer, const std::vector<T> &data, VkBufferUsageFlags usage, std::vector<core::Buffer> &staging_buffers)
+{
+	auto &device = command_buffer.get_device();
+
+	staging_buffers.push_back(core::Buffer::create_staging_buffer(device, data));
+
+	auto buffer = std::make_unique<core::Buffer>(device, data.size() * sizeof(T), usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+
+	command_buffer.copy_buffer(staging_buffers.back(), *buffer, data.size() * sizeof(T));
+
+	return buffer;
+}
+}        // namespace
+
+std::atomic<uint32_t> IndirectSubpass::occlusion_visible_count{0};
+std::atomic<uint32_t> IndirectSubpass::occluded_count{0};
+
+IndirectSubpass::IndirectSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
+    ForwardSubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    indirect_vertex_shader{"indirect_geometry.vert"},
+    cull_shader{"indirect_cull.comp"}
+{
+	early_cull_variant.add_define("EARLY_PHASE");
+	late_cull_variant.add_define("LATE_PHASE");
+}
+
+void IndirectSubpass::prepare()
+{
+	// Prepare again from the whole scene
+	meshes.insert(meshes.end(), indirect_meshes.begin(), indirect_meshes.end());
+	indirect_meshes.clear();
+	draws.clear();
+	batches.clear();
+
+	// Adds the lighting definitions to the variants of all submeshes
+	ForwardSubpass::prepare();
+
+	auto &device   = render_context.get_device();
+	auto  features = device.get_gpu().get_requested_features();
+
+	multi_draw_indirect = features.multiDrawIndirect;
+
+	if (!features.drawIndirectFirstInstance)
+	{
+		LOGW("IndirectSubpass: drawIndirectFirstInstance is not enabled, drawing every mesh directly");
+		return;
+	}
+
+	// The draws of a mesh node are merged only if all of its submeshes can be, so that meshes are drawn by a single path
+	std::vector<sg::Mesh *> direct_meshes;
+	for (auto mesh : meshes)
+	{
+		bool mergeable = !mesh->get_nodes().empty() && has_mergeable_lods(*mesh);
+		for (auto sub_mesh : mesh->get_submeshes())
+		{
+			mergeable = mergeable && sub_mesh->get_material()->alpha_mode != sg::AlphaMode::Blend && can_merge(*sub_mesh);
+		}
+
+		(mergeable ? indirect_meshes : direct_meshes).push_back(mesh);
+	}
+	meshes = std::move(direct_meshes);
+
+	MergedGeometry geometry;
+
+	for (auto mesh : indirect_meshes)
+	{
+		for (auto sub_mesh : mesh->get_submeshes())
+		{
+			auto info = merge_sub_mesh(*sub_mesh, geometry);
+
+			for (auto node : mesh->get_nodes())
+			{
+				// Invert the front face if the mesh was flipped
+				const auto &scale      = node->get_transform().get_scale();
+				bool        flipped    = scale.x * scale.y * scale.z < 0;
+				VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+				draws.push_back({node, sub_mesh, front_face, info});
+
+				set_draw_lods(draws.back().info, *sub_mesh, *node);
+			}
+
+			// Build the shader variant upfront, like the direct draws
+			auto &resource_cache = device.get_resource_cache();
+			resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, indirect_vertex_shader, sub_mesh->get_shader_variant());
+		}
+	}
+
+	if (draws.empty())
+	{
+		return;
+	}
+
+	// Group the draws by the state they need bound
+	std::stable_sort(draws.begin(), draws.end(), [](const IndirectDraw &lhs, const IndirectDraw &rhs) {
+		return std::make_tuple(lhs.sub_mesh->get_material(), lhs.sub_mesh->get_shader_variant().get_id(), lhs.front_face) <
+		       std::make_tuple(rhs.sub_mesh->get_material(), rhs.sub_mesh->get_shader_variant().get_id(), rhs.front_face);
+	});
+
+	for (uint32_t i = 0; i < to_u32(draws.size()); ++i)
+	{
+		auto &draw = draws[i];
+
+		if (batches.empty() ||
+		    batches.back().sub_mesh->get_material() != draw.sub_mesh->get_material() ||
+		    batches.back().sub_mesh->get_shader_variant().get_id() != draw.sub_mesh->get_shader_variant().get_id() ||
+		    batches.back().front_face != draw.front_face)
+		{
+			batches.push_back({draw.sub_mesh, draw.front_face, i, 0});
+		}
+
+		batches.back().draw_count++;
+	}
+
+	upload(geometry);
+
+	LOGI("IndirectSubpass: {} draws in {} batches, {} meshes drawn directly", draws.size(), batches.size(), meshes.size());
+}
+
+bool IndirectSubpass::can_merge(sg::SubMesh &sub_mesh)
+{
+	if (sub_mesh.vertices_count == 0 ||
+	    !is_attribute_mergeable(sub_mesh, sg::VertexAttributeSlot::Position, VK_FORMAT_R32G32B32_SFLOAT, sizeof(glm::vec3), true) ||
+	    !is_attribute_mergeable(sub_mesh, sg::VertexAttributeSlot::Texcoord0, VK_FORMAT_R32G32_SFLOAT, sizeof(glm::vec2), false) ||
+	    !is_attribute_mergeable(sub_mesh, sg::VertexAttributeSlot::Normal, VK_FORMAT_R32G32B32_SFLOAT, sizeof(glm::vec3), false))
+	{
+		return false;
+	}
+
+	if (sub_mesh.vertex_indices == 0)
+	{
+		return true;
+	}
+
+	VkDeviceSize index_size = sub_mesh.index_type == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+
+	auto index_buffer = sub_mesh.get_index_buffer();
+
+	return index_buffer && is_host_readable(*index_buffer) &&
+	       (sub_mesh.index_type == VK_INDEX_TYPE_UINT16 || sub_mesh.index_type == VK_INDEX_TYPE_UINT32) &&
+	       sub_mesh.index_offset + (sub_mesh.first_index + get_index_count(sub_mesh)) * index_size <= index_buffer->get_size();
+}
+
+IndirectDrawInfo IndirectSubpass::merge_sub_mesh(sg::SubMesh &sub_mesh, MergedGeometry &geometry)
+{
+	IndirectDrawInfo info{};
+	info.first_index   = to_u32(geometry.indices.size());
+	info.vertex_offset = static_cast<int32_t>(geometry.positions.size());
+
+	append_attribute(sub_mesh, sg::VertexAttributeSlot::Position, geometry.positions);
+	append_attribute(sub_mesh, sg::VertexAttributeSlot::Texcoord0, geometry.texcoords);
+	append_attribute(sub_mesh, sg::VertexAttributeSlot::Normal, geometry.normals);
+
+	// Indices are relative to the first vertex of the submesh, the draw offsets them
+	if (sub_mesh.vertex_indices != 0)
+	{
+		auto &buffer     = *sub_mesh.get_index_buffer();
+		bool  was_mapped = buffer.mapped();
+
+		VkDeviceSize   index_size = sub_mesh.index_type == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+		const uint8_t *index_data = buffer.map() + sub_mesh.index_offset + sub_mesh.first_index * index_size;
+
+		// The levels of detail follow the full detail, and are merged with it
+		uint32_t index_count = get_index_count(sub_mesh);
+
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			if (sub_mesh.index_type == VK_INDEX_TYPE_UINT32)
+			{
+				uint32_t index;
+				std::memcpy(&index, index_data + i * sizeof(uint32_t), sizeof(uint32_t));
+				geometry.indices.push_back(index);
+			}
+			else
+			{
+				uint16_t index;
+				std::memcpy(&index, index_data + i * sizeof(uint16_t), sizeof(uint16_t));
+				geometry.indices.push_back(index);
+			}
+		}
+
+		if (!was_mapped)
+		{
+			buffer.unmap();
+		}
+
+		info.index_count = sub_mesh.vertex_indices;
+	}
+	else
+	{
+		for (uint32_t i = 0; i < sub_mesh.vertices_count; ++i)
+		{
+			geometry.indices.push_back(i);
+		}
+
+		info.index_count = sub_mesh.vertices_count;
+	}
+
+	glm::vec3 min_position{std::numeric_limits<float>::max()};
+	glm::vec3 max_position{std::numeric_limits<float>::lowest()};
+	for (size_t i = info.vertex_offset; i < geometry.positions.size(); ++i)
+	{
+		min_position = glm::min(min_position, geometry.positions[i]);
+		max_position = glm::max(max_position, geometry.positions[i]);
+	}
+
+	info.bounding_sphere = glm::vec4((min_position + max_position) * 0.5f, glm::length(max_position - min_position) * 0.5f);
+
+	return info;
+}
+
+void IndirectSubpass::upload(const MergedGeometry &geometry)
+{
+	auto &device = render_context.get_device();
+
+	std::vector<IndirectDrawInfo> draw_infos;
+	draw_infos.reserve(draws.size());
+	for (auto &draw : draws)
+	{
+		draw_infos.push_back(draw.info);
+	}
+
+	std::vector<core::Buffer> staging_buffers;
+
+	auto &command_buffer = device.request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+	position_buffer  = create_device_buffer(command_buffer, geometry.positions, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, staging_buffers);
+	texcoord_buffer  = create_device_buffer(command_buffer, geometry.texcoords, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, staging_buffers);
+	normal_buffer    = create_device_buffer(command_buffer, geometry.normals, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, staging_buffers);
+	index_buffer     = create_device_buffer(command_buffer, geometry.indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, staging_buffers);
+	draw_info_buffer = create_device_buffer(command_buffer, draw_infos, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, staging_buffers);
+
+	command_buffer.end();
+
+	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+	queue.submit(command_buffer, device.request_fence());
+
+	device.get_fence_pool().wait();
+	device.get_fence_pool().reset();
+	device.get_command_pool().reset_pool();
+
+	position_buffer->set_debug_name("IndirectSubpass: position buffer");
+	texcoord_buffer->set_debug_name("IndirectSubpass: texcoord_0 buffer");
+	normal_buffer->set_debug_name("IndirectSubpass: normal buffer");
+	index_buffer->set_debug_name("IndirectSubpass: index buffer");
+	draw_info_buffer->set_debug_name("IndirectSubpass: draw info buffer");
+
+	draw_command_buffer = std::make_unique<core::Buffer>(device,
+	                                                     draws.size() * sizeof(VkDrawIndexedIndirectCommand),
+	                                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+	                                                     VMA_MEMORY_USAGE_GPU_ONLY);
+	draw_command_buffer->set_debug_name("IndirectSubpass: draw command buffer");
+
+	occluder_command_buffer = std::make_unique<core::Buffer>(device,
+	                                                         draws.size() * sizeof(VkDrawIndexedIndirectCommand),
+	                                                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+	                                                         VMA_MEMORY_USAGE_GPU_ONLY);
+	occluder_command_buffer->set_debug_name("IndirectSubpass: occluder command buffer");
+
+	// No draw is visible before the first late phase
+	visibility_buffer = std::make_unique<core::Buffer>(device, draws.size() * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	visibility_buffer->update(std::vector<uint32_t>(draws.size(), 0));
+	visibility_buffer->set_debug_name("IndirectSubpass: visibility buffer");
+
+	// Draws start at their full detail
+	lod_buffer = std::make_unique<core::Buffer>(device, draws.size() * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	lod_buffer->update(std::vector<uint32_t>(draws.size(), 0));
+	lod_buffer->set_debug_name("IndirectSubpass: level of detail buffer");
+}
+
+void IndirectSubpass::pre_draw(CommandBuffer &command_buffer)
+{
+	ForwardSubpass::pre_draw(command_buffer);
+
+	instance_buffer = BufferAllocation{};
+
+	if (draws.empty())
+	{
+		return;
+	}
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	instance_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, draws.size() * sizeof(glm::mat4), thread_index);
+
+	auto models = reinterpret_cast<glm::mat4 *>(instance_buffer.map(draws.size() * sizeof(glm::mat4)));
+	if (!models)
+	{
+		instance_buffer = BufferAllocation{};
+		return;
+	}
+
+	auto snapshot   = get_scene_snapshot();
+	auto view       = sg::get_view(snapshot, camera);
+	auto projection = sg::get_projection(snapshot, camera);
+
+	for (size_t i = 0; i < draws.size(); ++i)
+	{
+		models[i] = sg::get_node_state(snapshot, *draws[i].node).world_matrix;
+	}
+
+	instance_buffer.flush();
+
+	CullUniform cull_uniform{};
+	cull_uniform.draw_count      = to_u32(draws.size());
+	cull_uniform.view_proj       = camera.get_pre_rotation() * vkb::vulkan_style_projection(projection) * view;
+	cull_uniform.camera_position = sg::get_node_state(snapshot, *camera.get_node()).world_matrix[3];
+	cull_uniform.lod_projection  = glm::vec4(std::abs(projection[1][1]), std::abs(projection[2][3]), projection[3][3], 0.0f);
+
+	if (frustum_culling)
+	{
+		Frustum frustum;
+		frustum.update(projection * view);
+		std::copy(frustum.get_planes().begin(), frustum.get_planes().end(), cull_uniform.frustum_planes);
+	}
+	else
+	{
+		// Planes every sphere is in front of
+		std::fill(std::begin(cull_uniform.frustum_planes), std::end(cull_uniform.frustum_planes), glm::vec4(0.0f, 0.0f, 0.0f, std::numeric_limits<float>::max()));
+	}
+
+	ScopedDebugLabel cull_debug_label{command_buffer, "Indirect draw culling"};
+
+	auto &resource_cache = command_buffer.get_device().get_resource_cache();
+
+	auto dispatch_culling = [&](const ShaderVariant &variant, const core::Buffer &commands) {
+		auto cull_allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(CullUniform), thread_index);
+		cull_allocation.update(cull_uniform);
+
+		// The draws of the previous frame may still read the commands
+		{
+			BufferMemoryBarrier memory_barrier{};
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			memory_barrier.src_access_mask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+
+			command_buffer.buffer_memory_barrier(commands, 0, VK_WHOLE_SIZE, memory_barrier);
+		}
+
+		auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, cull_shader, variant);
+		auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+		command_buffer.bind_pipeline_layout(pipeline_layout);
+
+		command_buffer.bind_buffer(*draw_info_buffer, 0, draw_info_buffer->get_size(), 0, 0, 0);
+		command_buffer.bind_buffer(instance_buffer.get_buffer(), instance_buffer.get_offset(), instance_buffer.get_size(), 0, 1, 0);
+		command_buffer.bind_buffer(commands, 0, commands.get_size(), 0, 2, 0);
+		command_buffer.bind_buffer(cull_allocation.get_buffer(), cull_allocation.get_offset(), cull_allocation.get_size(), 0, 3, 0);
+		command_buffer.bind_buffer(*lod_buffer, 0, lod_buffer->get_size(), 0, LOD_BINDING, 0);
+
+		// The previous dispatch selected the levels of detail this one starts from
+		{
+			BufferMemoryBarrier memory_barrier{};
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+			command_buffer.buffer_memory_barrier(*lod_buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+		}
+
+		if (occlusion_culling)
+		{
+			command_buffer.bind_buffer(*visibility_buffer, 0, visibility_buffer->get_size(), 0, VISIBILITY_BINDING, 0);
+		}
+
+		command_buffer.dispatch((cull_uniform.draw_count + 63) / 64, 1, 1);
+
+		{
+			BufferMemoryBarrier memory_barrier{};
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+			memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+			command_buffer.buffer_memory_barrier(commands, 0, VK_WHOLE_SIZE, memory_barrier);
+		}
+	};
+
+	if (!occlusion_culling)
+	{
+		dispatch_culling(ShaderVariant{}, *draw_command_buffer);
+		return;
+	}
+
+	read_occlusion_counts();
+
+	// The late phase of the previous frame wrote the visibility
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+
+		command_buffer.buffer_memory_barrier(*visibility_buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+	}
+
+	dispatch_culling(early_cull_variant, *occluder_command_buffer);
+
+	record_occluder_depth(command_buffer);
+
+	cull_uniform.pyramid_level_count = hiz_pyramid->get_level_count();
+	cull_uniform.pyramid_extent      = {hiz_pyramid->get_extent().width, hiz_pyramid->get_extent().height};
+
+	// The late phase writes the visibility the early phase read
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+
+		command_buffer.buffer_memory_barrier(*visibility_buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+	}
+
+	auto &count_buffer = *occlusion_count_buffers[render_context.get_active_frame_index()];
+
+	// The late phase binds the pyramid and the counts on top of the bindings of the early one
+	command_buffer.bind_image(hiz_pyramid->get_view(), hiz_pyramid->get_sampler(), 0, HIZ_PYRAMID_BINDING, 0);
+	command_buffer.bind_buffer(count_buffer, 0, count_buffer.get_size(), 0, COUNT_BINDING, 0);
+
+	dispatch_culling(late_cull_variant, *draw_command_buffer);
+
+	// The counts are read once the frame completed
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_HOST_READ_BIT;
+
+		command_buffer.buffer_memory_barrier(count_buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+	}
+}
+
+void IndirectSubpass::set_occlusion_culling(bool enabled)
+{
+	occlusion_culling = enabled;
+}
+
+std::pair<uint32_t, uint32_t> IndirectSubpass::take_occlusion_counts()
+{
+	return {occlusion_visible_count.exchange(0), occluded_count.exchange(0)};
+}
+
+void IndirectSubpass::read_occlusion_counts()
+{
+	auto &device = render_context.get_device();
+
+	occlusion_count_buffers.resize(render_context.get_render_frames().size());
+
+	auto &count_buffer = occlusion_count_buffers[render_context.get_active_frame_index()];
+	if (!count_buffer)
+	{
+		count_buffer = std::make_unique<core::Buffer>(device, 2 * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+		count_buffer->set_debug_name("IndirectSubpass: occlusion count buffer");
+	}
+	else
+	{
+		// The frame was waited for before it became active again
+		std::array<uint32_t, 2> counts;
+		count_buffer->invalidate();
+		std::memcpy(counts.data(), count_buffer->get_data(), sizeof(counts));
+
+		occlusion_visible_count += counts[0];
+		occluded_count += counts[1];
+	}
+
+	count_buffer->update(std::array<uint32_t, 2>{0, 0});
+}
+
+void IndirectSubpass::record_occluder_depth(CommandBuffer &command_buffer)
+{
+	auto &device = render_context.get_device();
+
+	const auto &extent = render_context.get_surface_extent();
+	if (!occluder_target || occluder_target->get_extent().width != extent.width || occluder_target->get_extent().height != extent.height)
+	{
+		if (occluder_target)
+		{
+			// Resizes are rare, the frames in flight may still read the target
+			device.wait_idle();
+		}
+
+		allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
+
+		std::vector<core::Image> images;
+		images.emplace_back(device,
+		                    VkExtent3D{extent.width, extent.height, 1},
+		                    get_suitable_depth_format(device.get_gpu(), true),
+		                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		                    VMA_MEMORY_USAGE_GPU_ONLY);
+		images.back().set_debug_name("IndirectSubpass: occluder depth");
+
+		occluder_target = std::make_unique<RenderTarget>(std::move(images));
+	}
+
+	if (!hiz_pyramid)
+	{
+		hiz_pyramid = std::make_unique<HiZPyramid>(device);
+	}
+
+	ScopedDebugLabel occluder_debug_label{command_buffer, "Occluder depth"};
+
+	auto &depth_view = occluder_target->get_views()[0];
+
+	// The late phase of the previous frame read the depth
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+		command_buffer.image_memory_barrier(depth_view, memory_barrier);
+		occluder_target->set_layout(0, memory_barrier.new_layout);
+	}
+
+	auto &resource_cache = device.get_resource_cache();
+
+	auto &render_pass = resource_cache.request_render_pass(occluder_target->get_attachments(),
+	                                                       {{VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE}},
+	                                                       {SubpassInfo{}});
+	auto &framebuffer = resource_cache.request_framebuffer(*occluder_target, render_pass);
+
+	// The farthest depth in the reversed depth range
+	VkClearValue clear_value{};
+	clear_value.depthStencil = {0.0f, ~0U};
+
+	command_buffer.begin_render_pass(*occluder_target, render_pass, framebuffer, {clear_value});
+
+	VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+	command_buffer.set_viewport(0, {viewport});
+
+	VkRect2D scissor{{0, 0}, extent};
+	command_buffer.set_scissor(0, {scissor});
+
+	bind_merged_geometry(command_buffer);
+
+	auto &vert_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, indirect_vertex_shader, occluder_variant);
+	auto &pipeline_layout    = resource_cache.request_pipeline_layout({&vert_shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+	command_buffer.set_depth_stencil_state(DepthStencilState{});
+
+	for (auto &batch : batches)
+	{
+		// The holes of alpha masked surfaces are not in their depth
+		auto material = batch.sub_mesh->get_material();
+		if (material->alpha_mode != sg::AlphaMode::Opaque)
+		{
+			continue;
+		}
+
+		prepare_pipeline_state(command_buffer, batch.front_face, material->double_sided);
+
+		// The occluder target is single sampled
+		command_buffer.set_multisample_state(MultisampleState{});
+
+		draw_batch(command_buffer, *occluder_command_buffer, batch);
+	}
+
+	command_buffer.end_render_pass();
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(depth_view, memory_barrier);
+		occluder_target->set_layout(0, memory_barrier.new_layout);
+	}
+
+	hiz_pyramid->build(command_buffer, depth_view, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+}
+
+void IndirectSubpass::draw(CommandBuffer &command_buffer)
+{
+	allocate_lights<ForwardLights>(scene.get_component_view<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
+
+	if (!instance_buffer.empty())
+	{
+		// The occluder depth pass of pre_draw() set its own viewport
+		if (occlusion_culling)
+		{
+			const auto &extent = command_buffer.get_current_render_pass().render_area;
+
+			VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+			command_buffer.set_viewport(0, {viewport});
+
+			VkRect2D scissor{{0, 0}, extent};
+			command_buffer.set_scissor(0, {scissor});
+		}
+
+		record_indirect_draws(command_buffer);
+	}
+
+	// The lights are already bound
+	if (!meshes.empty())
+	{
+		GeometrySubpass::draw(command_buffer);
+	}
+
+	instance_buffer = BufferAllocation{};
+}
+
+bool IndirectSubpass::supports_parallel_recording() const
+{
+	return false;
+}
+
+bool IndirectSubpass::retains_draws() const
+{
+	return false;
+}
+
+void IndirectSubpass::record_indirect_draws(CommandBuffer &command_buffer)
+{
+	ScopedDebugLabel indirect_debug_label{command_buffer, "Indirect draws"};
+
+	bind_merged_geometry(command_buffer);
+
+	auto &resource_cache = command_buffer.get_device().get_resource_cache();
+
+	for (auto &batch : batches)
+	{
+		auto &sub_mesh  = *batch.sub_mesh;
+		auto &draw_info = batch.draw_info;
+
+		if (!draw_info.pipeline_layout)
+		{
+			auto &variant = sub_mesh.get_shader_variant();
+
+			auto &vert_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, indirect_vertex_shader, variant);
+			auto &frag_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+
+			draw_info.pipeline_layout = &prepare_pipeline_layout(command_buffer, {&vert_shader_module, &frag_shader_module});
+
+			DescriptorSetLayout &descriptor_set_layout = draw_info.pipeline_layout->get_descriptor_set_layout(0);
+
+			for (auto &texture : sub_mesh.get_material()->textures)
+			{
+				if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+				{
+					draw_info.texture_bindings.emplace_back(layout_binding->binding, texture.second);
+				}
+			}
+		}
+
+		prepare_pipeline_state(command_buffer, batch.front_face, sub_mesh.get_material()->double_sided);
+
+		command_buffer.bind_pipeline_layout(*draw_info.pipeline_layout);
+
+		if (draw_info.pipeline_layout->get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+		{
+			prepare_push_constants(command_buffer, sub_mesh);
+		}
+
+		for (auto &texture_binding : draw_info.texture_bindings)
+		{
+			command_buffer.bind_image(texture_binding.second->get_image()->get_vk_image_view(),
+			                          texture_binding.second->get_sampler()->vk_sampler,
+			                          0, texture_binding.first, 0);
+		}
+
+		draw_batch(command_buffer, *draw_command_buffer, batch);
+	}
+}
+
+void IndirectSubpass::bind_merged_geometry(CommandBuffer &command_buffer)
+{
+	auto snapshot = get_scene_snapshot();
+	auto view     = sg::get_view(snapshot, camera);
+
+	GlobalUniform global_uniform;
+	global_uniform.model            = glm::mat4(1.0f);
+	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(sg::get_projection(snapshot, camera)) * view;
+	global_uniform.camera_position  = glm::vec3(glm::inverse(view)[3]);
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GlobalUniform), thread_index);
+	allocation.update(global_uniform);
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
+	command_buffer.bind_buffer(instance_buffer.get_buffer(), instance_buffer.get_offset(), instance_buffer.get_size(), 0, 5, 0);
+
+	// Matches the inputs of indirect_geometry.vert, with one binding per location like the direct draws
+	VertexInputState vertex_input_state;
+	vertex_input_state.bindings   = {{0, sizeof(glm::vec3), VK_VERTEX_INPUT_RATE_VERTEX},
+	                                 {1, sizeof(glm::vec2), VK_VERTEX_INPUT_RATE_VERTEX},
+	                                 {2, sizeof(glm::vec3), VK_VERTEX_INPUT_RATE_VERTEX}};
+	vertex_input_state.attributes = {{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0},
+	                                 {1, 1, VK_FORMAT_R32G32_SFLOAT, 0},
+	                                 {2, 2, VK_FORMAT_R32G32B32_SFLOAT, 0}};
+	command_buffer.set_vertex_input_state(vertex_input_state);
+
+	std::vector<std::reference_wrapper<const core::Buffer>> vertex_buffers{*position_buffer, *texcoord_buffer, *normal_buffer};
+	command_buffer.bind_vertex_buffers(0, vertex_buffers, {0, 0, 0});
+	command_buffer.bind_index_buffer(*index_buffer, 0, VK_INDEX_TYPE_UINT32);
+}
+
+void IndirectSubpass::draw_batch(CommandBuffer &command_buffer, const core::Buffer &commands, const Batch &batch)
+{
+	uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+
+	if (multi_draw_indirect)
+	{
+		command_buffer.draw_indexed_indirect(commands, batch.first_draw * stride, batch.draw_count, stride);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < batch.draw_count; ++i)
+		{
+			command_buffer.draw_indexed_indirect(commands, (batch.first_draw + i) * stride, 1, stride);
+		}
+	}
+}
+}        // namespace vkb
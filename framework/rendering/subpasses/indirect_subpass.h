@@ -0,0 +1,270 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/hiz_pyramid.h"
+#include "rendering/render_target.h"
+#include "rendering/subpasses/forward_subpass.h"
+
+namespace vkb
+{
+/**
+ * @brief Per draw data read by the culling shader, see indirect_cull.comp
+ */
+struct alignas(16) IndirectDrawInfo
+{
+	/// Levels of detail a draw selects from on the GPU, the coarsest levels of larger sg::LodGroup are merged into the last one
+	static constexpr uint32_t MAX_LOD_COUNT = 4;
+
+	uint32_t index_count;
+
+	uint32_t first_index;
+
+	int32_t vertex_offset;
+
+	/// Number of levels of detail, one for the draws without a sg::LodGroup
+	uint32_t lod_count;
+
+	/// Center in model space, and radius
+	glm::vec4 bounding_sphere;
+
+	/// Index data of each level of detail, within the merged index buffer
+	glm::uvec4 lod_first_index;
+
+	glm::uvec4 lod_index_count;
+
+	/// Smallest screen size of each level of detail, see sg::LodLevel::screen_size
+	glm::vec4 lod_screen_size;
+};
+
+/**
+ * @brief This subpass forward renders a Scene with draws culled and generated on the GPU
+ *
+ * On prepare, the geometry of the scene submeshes is merged into shared vertex and index buffers,
+ * and every submesh of every mesh node becomes one indexed indirect draw. Each frame, a compute shader
+ * culls the draws against the camera frustum before the render pass, then one multi draw indirect is
+ * recorded per pipeline state and material.
+ *
+ * Merged draws are rendered with indirect_geometry.vert, which has the outputs of base.vert, and the fragment shader given.
+ * Meshes which cannot be merged, such as transparent ones or ones with unsupported vertex formats, are drawn by
+ * the ForwardSubpass path with both shaders given.
+ *
+ * With set_occlusion_culling(), the draws hidden behind others are culled as well, in two phases on the GPU.
+ *
+ * Nodes with a sg::LodGroup select their level of detail in the culling shader, with the same screen sizes and hysteresis
+ * as the CPU draws, see sg::LodGroup::select_level(). The levels of detail of merged draws are the simplified levels of
+ * their submeshes, nodes with levels drawing other meshes are drawn by the ForwardSubpass path.
+ *
+ * The meshes and nodes of the scene are captured on prepare, node transforms can change afterwards.
+ * Merging requires the drawIndirectFirstInstance feature. Without the multiDrawIndirect feature,
+ * every draw is issued as its own indirect draw.
+ */
+class IndirectSubpass : public ForwardSubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass for GPU-driven forward rendering
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source, for the meshes which are not merged
+	 * @param fragment_shader Fragment shader source
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera used to look at the scene
+	 */
+	IndirectSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~IndirectSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Writes the model matrices of the draws, and dispatches the culling shader
+	 *        With occlusion culling, the occluder depth and its Hi-Z pyramid are also rendered here.
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Record draw commands
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Indirect draws are recorded inline
+	 */
+	virtual bool supports_parallel_recording() const override;
+
+	/**
+	 * @brief Indirect draws are not retained
+	 */
+	virtual bool retains_draws() const override;
+
+	/**
+	 * @brief Enables two phase occlusion culling of the merged draws
+	 *
+	 * The early phase keeps the draws in the frustum which were visible in the previous frame, and renders their depth
+	 * to an occluder target of the subpass, without the alpha masked ones whose depth has holes. The target is reduced
+	 * to a HiZPyramid, then the late phase tests every draw in the frustum against it. The draws which are not occluded,
+	 * including the ones disoccluded since the previous frame, are the ones drawn by the subpass and visible in the
+	 * next early phase. The late phase counts are read back for the stats, see take_occlusion_counts().
+	 */
+	void set_occlusion_culling(bool enabled);
+
+	/**
+	 * @brief Returns the numbers of draws which were visible and occluded in the late culling phase of every
+	 *        IndirectSubpass since the last call, counted once the frames completed, and resets them
+	 */
+	static std::pair<uint32_t, uint32_t> take_occlusion_counts();
+
+  private:
+	struct IndirectDraw
+	{
+		sg::Node *node;
+
+		sg::SubMesh *sub_mesh;
+
+		VkFrontFace front_face;
+
+		IndirectDrawInfo info;
+	};
+
+	/// Consecutive draws sharing a pipeline state and material
+	struct Batch
+	{
+		sg::SubMesh *sub_mesh;
+
+		VkFrontFace front_face;
+
+		uint32_t first_draw;
+
+		uint32_t draw_count;
+
+		/// Resolved on first use, see record_indirect_draws()
+		SubMeshDrawInfo draw_info;
+	};
+
+	/// Vertex and index data of the merged submeshes, before upload
+	struct MergedGeometry
+	{
+		std::vector<glm::vec3> positions;
+
+		std::vector<glm::vec2> texcoords;
+
+		std::vector<glm::vec3> normals;
+
+		std::vector<uint32_t> indices;
+	};
+
+	/**
+	 * @brief Whether the vertex format of the submesh is supported, and its data can be read by the host
+	 */
+	static bool can_merge(sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Appends the geometry of a submesh to the merged geometry
+	 * @return The draw info of the submesh within the merged buffers
+	 */
+	static IndirectDrawInfo merge_sub_mesh(sg::SubMesh &sub_mesh, MergedGeometry &geometry);
+
+	/**
+	 * @brief Uploads the merged geometry and the draw infos to device local buffers
+	 */
+	void upload(const MergedGeometry &geometry);
+
+	/**
+	 * @brief Binds the merged geometry and the model matrices of the draws for indirect_geometry.vert
+	 */
+	void bind_merged_geometry(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Records the indirect draws of a batch, from the commands written by a culling dispatch
+	 */
+	void draw_batch(CommandBuffer &command_buffer, const core::Buffer &commands, const Batch &batch);
+
+	/**
+	 * @brief Renders the draws of the early culling phase to the occluder target, and builds its Hi-Z pyramid
+	 */
+	void record_occluder_depth(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Adds the late phase counts of the frames which last used the active frame to the totals, and resets them
+	 */
+	void read_occlusion_counts();
+
+	void record_indirect_draws(CommandBuffer &command_buffer);
+
+	ShaderSource indirect_vertex_shader;
+
+	ShaderSource cull_shader;
+
+	/// Variants of cull_shader for the occlusion culling phases
+	ShaderVariant early_cull_variant;
+
+	ShaderVariant late_cull_variant;
+
+	/// Variant of indirect_vertex_shader for the occluder depth
+	ShaderVariant occluder_variant;
+
+	/// Meshes drawn indirectly, the other ones are left in meshes
+	std::vector<sg::Mesh *> indirect_meshes;
+
+	/// Ordered by batch
+	std::vector<IndirectDraw> draws;
+
+	std::vector<Batch> batches;
+
+	std::unique_ptr<core::Buffer> position_buffer;
+
+	std::unique_ptr<core::Buffer> texcoord_buffer;
+
+	std::unique_ptr<core::Buffer> normal_buffer;
+
+	std::unique_ptr<core::Buffer> index_buffer;
+
+	std::unique_ptr<core::Buffer> draw_info_buffer;
+
+	/// Written by the culling shader every frame
+	std::unique_ptr<core::Buffer> draw_command_buffer;
+
+	/// Model matrices of the draws for the current frame
+	BufferAllocation instance_buffer;
+
+	bool multi_draw_indirect{false};
+
+	bool occlusion_culling{false};
+
+	/// Written by the early culling phase, for the occluder depth
+	std::unique_ptr<core::Buffer> occluder_command_buffer;
+
+	/// Whether each draw was visible in the late culling phase of the previous frame
+	std::unique_ptr<core::Buffer> visibility_buffer;
+
+	/// Level of detail of each draw, selected by the culling shader from the one of the previous frame
+	std::unique_ptr<core::Buffer> lod_buffer;
+
+	/// Depth of the early culling phase draws, created on first use at the surface extent
+	std::unique_ptr<RenderTarget> occluder_target;
+
+	std::unique_ptr<HiZPyramid> hiz_pyramid;
+
+	/// Visible and occluded counts of the late culling phase, per render frame
+	std::vector<std::unique_ptr<core::Buffer>> occlusion_count_buffers;
+
+	static std::atomic<uint32_t> occlusion_visible_count;
+
+	static std::atomic<uint32_t> occluded_count;
+};
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,8 +20,11 @@
 #include "buffer_pool.h"
 #include "rendering/render_context.h"
 #include "scene_graph/components/camera.h"
+#include "scene_graph/components/perspective_camera.h"
 #include "scene_graph/scene.h"
 
+#include <stdexcept>
+
 namespace vkb
 {
 LightingSubpass::LightingSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Camera &cam, sg::Scene &scene_) :
@@ -36,15 +39,86 @@ void LightingSubpass::prepare()
 	lighting_variant.add_definitions({"MAX_LIGHT_COUNT " + std::to_string(MAX_DEFERRED_LIGHT_COUNT)});
 
 	lighting_variant.add_definitions(light_type_definitions);
+
+	if (perspective_camera)
+	{
+		lighting_variant.add_definitions(LightClusters::get_definitions());
+
+		if (!light_clusters)
+		{
+			light_clusters = std::make_unique<LightClusters>(render_context.get_device());
+		}
+	}
+
+	if (float16_arithmetic && render_context.get_device().uses_float16_arithmetic())
+	{
+		lighting_variant.add_define("FP16_ARITHMETIC");
+	}
+
+	if (gbuffer_layout == GBufferLayout::Packed)
+	{
+		lighting_variant.add_define("PACKED_GBUFFER");
+	}
+
 	// Build all shaders upfront
 	auto &resource_cache = render_context.get_device().get_resource_cache();
 	resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), lighting_variant);
 	resource_cache.request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), lighting_variant);
 }
 
+void LightingSubpass::set_clustered_lighting(bool enable)
+{
+	perspective_camera = nullptr;
+
+	if (enable)
+	{
+		perspective_camera = dynamic_cast<sg::PerspectiveCamera *>(&camera);
+		if (!perspective_camera)
+		{
+			throw std::runtime_error("Clustered lighting requires a perspective camera");
+		}
+	}
+}
+
+void LightingSubpass::set_float16_arithmetic(bool enable)
+{
+	float16_arithmetic = enable;
+}
+
+void LightingSubpass::set_gbuffer_layout(GBufferLayout layout)
+{
+	gbuffer_layout = layout;
+}
+
+void LightingSubpass::pre_draw(CommandBuffer &command_buffer)
+{
+	if (light_clusters)
+	{
+		light_clusters->cull(command_buffer, get_render_context().get_active_frame(), 0, *perspective_camera, scene.get_component_view<sg::Light>());
+	}
+}
+
 void LightingSubpass::draw(CommandBuffer &command_buffer)
 {
-	allocate_lights<DeferredLights>(scene.get_components<sg::Light>(), MAX_DEFERRED_LIGHT_COUNT);
+	if (light_clusters)
+	{
+		// Only the directional lights are in the lighting state, so that the shader variant does not depend on the number of other lights
+		std::vector<sg::Light *> directional_lights;
+		for (auto scene_light : scene.get_component_view<sg::Light>())
+		{
+			if (scene_light->get_light_type() == sg::LightType::Directional)
+			{
+				directional_lights.push_back(scene_light);
+			}
+		}
+
+		allocate_lights<DeferredLights>(directional_lights, MAX_DEFERRED_LIGHT_COUNT);
+		light_clusters->bind(command_buffer, 0, 6);
+	}
+	else
+	{
+		allocate_lights<DeferredLights>(scene.get_component_view<sg::Light>(), MAX_DEFERRED_LIGHT_COUNT);
+	}
 	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
 
 	// Get shaders from cache
@@ -62,19 +136,20 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	assert(pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT).empty());
 	command_buffer.set_vertex_input_state({});
 
-	// Get image views of the attachments
-	auto &render_target = get_render_context().get_active_frame().get_render_target();
+	// Get image views of the attachments, of the render target drawn to which may not be the one of the frame
+	assert(get_render_target() && "The render target must be set");
+	auto &render_target = *get_render_target();
 	auto &target_views  = render_target.get_views();
 	assert(3 < target_views.size());
 
 	// Bind depth, albedo, and normal as input attachments
-	auto &depth_view = target_views[1];
+	auto &depth_view = target_views[RenderTarget::GB_DEPTH_ATTACHMENT];
 	command_buffer.bind_input(depth_view, 0, 0, 0);
 
-	auto &albedo_view = target_views[2];
+	auto &albedo_view = target_views[RenderTarget::GB_ALBEDO_ATTACHMENT];
 	command_buffer.bind_input(albedo_view, 0, 1, 0);
 
-	auto &normal_view = target_views[3];
+	auto &normal_view = target_views[RenderTarget::GB_NORMAL_ATTACHMENT];
 	command_buffer.bind_input(normal_view, 0, 2, 0);
 
 	// Set cull mode to front as full screen triangle is clock-wise
@@ -85,12 +160,13 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	// Populate uniform values
 	LightUniform light_uniform;
 
-	// Inverse resolution
-	light_uniform.inv_resolution.x = 1.0f / render_target.get_extent().width;
-	light_uniform.inv_resolution.y = 1.0f / render_target.get_extent().height;
+	// Inverse resolution, of the area rendered to
+	light_uniform.inv_resolution.x = 1.0f / render_target.get_render_extent().width;
+	light_uniform.inv_resolution.y = 1.0f / render_target.get_render_extent().height;
 
 	// Inverse view projection
-	light_uniform.inv_view_proj = glm::inverse(vulkan_style_projection(camera.get_projection()) * camera.get_view());
+	auto snapshot               = get_scene_snapshot();
+	light_uniform.inv_view_proj = glm::inverse(vulkan_style_projection(sg::get_projection(snapshot, camera)) * sg::get_view(snapshot, camera));
 
 	// Allocate a buffer using the buffer pool from the active frame to store uniform values and bind it
 	auto &render_frame = get_render_context().get_active_frame();
@@ -98,7 +174,11 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	allocation.update(light_uniform);
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 3, 0);
 
-	// Draw full screen triangle triangle
+	// Draw full screen triangle triangle, at the adaptive shading rate of the render context
+	command_buffer.set_fragment_shading_rate(get_render_context().get_fragment_shading_rate());
+
 	command_buffer.draw(3, 1, 0, 0);
+
+	command_buffer.set_fragment_shading_rate({1, 1});
 }
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "buffer_pool.h"
+#include "rendering/light_clusters.h"
 #include "rendering/subpass.h"
 
 #include "common/glm_common.h"
@@ -31,6 +32,7 @@ namespace sg
 {
 class Camera;
 class Light;
+class PerspectiveCamera;
 class Scene;
 }        // namespace sg
 
@@ -54,6 +56,11 @@ struct alignas(16) DeferredLights
 
 /**
  * @brief Lighting pass of Deferred Rendering
+ *
+ * By default every pixel is shaded by every light, up to MAX_DEFERRED_LIGHT_COUNT per type.
+ * With clustered lighting, the point and spot lights are binned into the clusters of the camera view before the
+ * render pass, see LightClusters, and each pixel only shades the lights of its cluster. There is then no limit on
+ * the number of point and spot lights.
  */
 class LightingSubpass : public Subpass
 {
@@ -62,14 +69,51 @@ class LightingSubpass : public Subpass
 
 	virtual void prepare() override;
 
+	/**
+	 * @brief Bins the point and spot lights into the clusters, if clustered lighting is enabled
+	 */
+	void pre_draw(CommandBuffer &command_buffer) override;
+
 	void draw(CommandBuffer &command_buffer) override;
 
+	/**
+	 * @brief Enables the culling of the point and spot lights into clusters, before prepare()
+	 *        The camera must be a sg::PerspectiveCamera, and the fragment shader must support the CLUSTERED_LIGHTING definition,
+	 *        like deferred/lighting.frag.
+	 */
+	void set_clustered_lighting(bool enable);
+
+	/**
+	 * @brief Enables or disables half precision shading, enabled by default, before prepare()
+	 *        The fragment shader is compiled with the FP16_ARITHMETIC definition, which deferred/lighting.frag supports,
+	 *        if the device supports it, see Device::uses_float16_arithmetic().
+	 */
+	void set_float16_arithmetic(bool enable);
+
+	/**
+	 * @brief Sets the layout of the G-buffer read, GBufferLayout::Default by default, before prepare()
+	 *        The fragment shader of the packed layout is compiled with the PACKED_GBUFFER definition, which deferred/lighting.frag
+	 *        supports, see RenderTarget::create_gbuffer_func().
+	 */
+	void set_gbuffer_layout(GBufferLayout layout);
+
   private:
 	sg::Camera &camera;
 
 	sg::Scene &scene;
 
 	ShaderVariant lighting_variant;
+
+	/// The camera if clustered lighting is enabled
+	sg::PerspectiveCamera *perspective_camera{nullptr};
+
+	std::unique_ptr<LightClusters> light_clusters;
+
+	/// Set by set_float16_arithmetic()
+	bool float16_arithmetic{true};
+
+	/// Set by set_gbuffer_layout()
+	GBufferLayout gbuffer_layout{GBufferLayout::Default};
 };
 
 }        // namespace vkb
@@ -0,0 +1,410 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/meshlet_subpass.h"
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "core/util/logging.hpp"
+#include "geometry/frustum.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/sampler.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/components/texture.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace vkb
+{
+namespace
+{
+/// Meshlets culled by a task shader workgroup, MESHLET_TASK_GROUP_SIZE in meshlet_shared.h
+constexpr uint32_t TASK_GROUP_SIZE = 32;
+
+/// See MESHLET_DRAW_CONE_CULLING in meshlet_shared.h
+constexpr uint32_t DRAW_CONE_CULLING = 1;
+
+/**
+ * @brief Culling shader parameters, see meshlet_geometry.task
+ */
+struct alignas(16) MeshletCullUniform
+{
+	glm::vec4 frustum_planes[6];
+};
+
+template <typename T>
+std::unique_ptr<core::Buffer> create_device_buffer(CommandBuffer &command_buffer, const std::vector<T> &data, std::vector<core::Buffer> &staging_buffers)
+{
+	auto &device = command_buffer.get_device();
+
+	// Storage buffers cannot be empty
+	T            empty_data{};
+	const void  *source = data.empty() ? static_cast<const void *>(&empty_data) : data.data();
+	VkDeviceSize size   = data.empty() ? sizeof(T) : data.size() * sizeof(T);
+
+	staging_buffers.push_back(core::Buffer::create_staging_buffer(device, size, source));
+
+	auto buffer = std::make_unique<core::Buffer>(device, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+
+	command_buffer.copy_buffer(staging_buffers.back(), *buffer, size);
+
+	return buffer;
+}
+}        // namespace
+
+MeshletSubpass::MeshletSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
+    ForwardSubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    task_shader{"meshlet_geometry.task"},
+    mesh_shader{"meshlet_geometry.mesh"}
+{
+}
+
+void MeshletSubpass::prepare()
+{
+	// Prepare again from the whole scene
+	meshes.insert(meshes.end(), meshlet_meshes.begin(), meshlet_meshes.end());
+	meshlet_meshes.clear();
+	draws.clear();
+	draw_infos.clear();
+
+	// Adds the lighting definitions to the variants of all submeshes
+	ForwardSubpass::prepare();
+
+	auto &device = render_context.get_device();
+
+	if (!device.uses_mesh_shaders())
+	{
+		LOGW("MeshletSubpass: mesh shaders are not enabled, drawing every mesh with the vertex shader");
+		return;
+	}
+
+	if (!zero_buffer)
+	{
+		zero_buffer = std::make_unique<core::Buffer>(device, 4 * sizeof(float), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+		zero_buffer->update(std::vector<float>(4, 0.0f));
+		zero_buffer->set_debug_name("MeshletSubpass: zero buffer");
+	}
+
+	uint32_t max_task_group_count = device.get_mesh_shader_properties().maxTaskWorkGroupCount[0];
+
+	MeshletGeometry geometry;
+
+	// The draws of a mesh node are meshlets only if all of its submeshes can be, so that meshes are drawn by a single path
+	std::vector<sg::Mesh *> direct_meshes;
+	for (auto mesh : meshes)
+	{
+		std::vector<MeshletDraw> sub_mesh_draws;
+
+		bool drawable = !mesh->get_nodes().empty();
+		for (auto sub_mesh : mesh->get_submeshes())
+		{
+			MeshletDraw draw{nullptr, sub_mesh, VK_FRONT_FACE_COUNTER_CLOCKWISE, 0};
+
+			uint32_t meshlet_count = to_u32(sub_mesh->meshlets.meshlets.size());
+
+			drawable = drawable && meshlet_count > 0 && (meshlet_count + TASK_GROUP_SIZE - 1) / TASK_GROUP_SIZE <= max_task_group_count &&
+			           sub_mesh->get_material()->alpha_mode != sg::AlphaMode::Blend &&
+			           find_attribute(*sub_mesh, sg::VertexAttributeSlot::Position, VK_FORMAT_R32G32B32_SFLOAT, true, draw.position) &&
+			           find_attribute(*sub_mesh, sg::VertexAttributeSlot::Normal, VK_FORMAT_R32G32B32_SFLOAT, false, draw.normal) &&
+			           find_attribute(*sub_mesh, sg::VertexAttributeSlot::Texcoord0, VK_FORMAT_R32G32_SFLOAT, false, draw.texcoord);
+
+			sub_mesh_draws.push_back(draw);
+		}
+
+		if (!drawable)
+		{
+			direct_meshes.push_back(mesh);
+			continue;
+		}
+
+		meshlet_meshes.push_back(mesh);
+
+		for (auto &draw : sub_mesh_draws)
+		{
+			auto &sub_mesh_geometry = draw.sub_mesh->meshlets;
+
+			// The meshlets of all the submeshes share the buffers
+			draw.first_meshlet = to_u32(geometry.meshlets.size());
+			for (auto meshlet : sub_mesh_geometry.meshlets)
+			{
+				meshlet.first_vertex += to_u32(geometry.vertices.size());
+				meshlet.first_triangle += to_u32(geometry.triangles.size());
+				geometry.meshlets.push_back(meshlet);
+			}
+			geometry.vertices.insert(geometry.vertices.end(), sub_mesh_geometry.vertices.begin(), sub_mesh_geometry.vertices.end());
+			geometry.triangles.insert(geometry.triangles.end(), sub_mesh_geometry.triangles.begin(), sub_mesh_geometry.triangles.end());
+
+			for (auto node : mesh->get_nodes())
+			{
+				// Invert the front face if the mesh was flipped
+				const auto &scale = node->get_transform().get_scale();
+				bool        flipped = scale.x * scale.y * scale.z < 0;
+
+				draw.node       = node;
+				draw.front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+				draws.push_back(draw);
+			}
+
+			// Build the shader variant upfront, like the direct draws
+			auto &resource_cache = device.get_resource_cache();
+			resource_cache.request_shader_module(VK_SHADER_STAGE_TASK_BIT_EXT, task_shader, draw.sub_mesh->get_shader_variant());
+			resource_cache.request_shader_module(VK_SHADER_STAGE_MESH_BIT_EXT, mesh_shader, draw.sub_mesh->get_shader_variant());
+		}
+	}
+	meshes = std::move(direct_meshes);
+
+	if (draws.empty())
+	{
+		return;
+	}
+
+	// Group the draws by the state they need bound
+	std::stable_sort(draws.begin(), draws.end(), [](const MeshletDraw &lhs, const MeshletDraw &rhs) {
+		return std::make_tuple(lhs.sub_mesh->get_material(), lhs.sub_mesh->get_shader_variant().get_id(), lhs.front_face) <
+		       std::make_tuple(rhs.sub_mesh->get_material(), rhs.sub_mesh->get_shader_variant().get_id(), rhs.front_face);
+	});
+
+	upload(geometry);
+
+	LOGI("MeshletSubpass: {} draws of {} meshlets, {} meshes drawn directly", draws.size(), geometry.meshlets.size(), meshes.size());
+}
+
+bool MeshletSubpass::find_attribute(sg::SubMesh &sub_mesh, sg::VertexAttributeSlot slot, VkFormat format, bool required, MeshletAttribute &attribute)
+{
+	sg::VertexAttribute vertex_attribute;
+	VkDeviceSize        offset = 0;
+	auto                buffer = sub_mesh.get_vertex_buffer(slot, offset);
+	if (!sub_mesh.get_attribute(slot, vertex_attribute) || buffer == nullptr)
+	{
+		attribute = {zero_buffer.get(), 0, 0};
+		return !required;
+	}
+
+	// Read as arrays of floats
+	offset += vertex_attribute.offset;
+	if (vertex_attribute.format != format || offset % sizeof(float) != 0 || vertex_attribute.stride % sizeof(float) != 0)
+	{
+		return false;
+	}
+
+	attribute = {buffer, to_u32(offset / sizeof(float)), vertex_attribute.stride / to_u32(sizeof(float))};
+	return true;
+}
+
+void MeshletSubpass::upload(const MeshletGeometry &geometry)
+{
+	auto &device = render_context.get_device();
+
+	std::vector<core::Buffer> staging_buffers;
+
+	auto &command_buffer = device.request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+	meshlet_buffer          = create_device_buffer(command_buffer, geometry.meshlets, staging_buffers);
+	meshlet_vertex_buffer   = create_device_buffer(command_buffer, geometry.vertices, staging_buffers);
+	meshlet_triangle_buffer = create_device_buffer(command_buffer, geometry.triangles, staging_buffers);
+
+	command_buffer.end();
+
+	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+	queue.submit(command_buffer, device.request_fence());
+
+	device.get_fence_pool().wait();
+	device.get_fence_pool().reset();
+	device.get_command_pool().reset_pool();
+
+	meshlet_buffer->set_debug_name("MeshletSubpass: meshlet buffer");
+	meshlet_vertex_buffer->set_debug_name("MeshletSubpass: meshlet vertex buffer");
+	meshlet_triangle_buffer->set_debug_name("MeshletSubpass: meshlet triangle buffer");
+}
+
+void MeshletSubpass::draw(CommandBuffer &command_buffer)
+{
+	allocate_lights<ForwardLights>(scene.get_component_view<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
+
+	if (!draws.empty())
+	{
+		record_meshlet_draws(command_buffer);
+	}
+
+	// The lights are already bound
+	if (!meshes.empty())
+	{
+		GeometrySubpass::draw(command_buffer);
+	}
+}
+
+bool MeshletSubpass::supports_parallel_recording() const
+{
+	return false;
+}
+
+bool MeshletSubpass::retains_draws() const
+{
+	return false;
+}
+
+void MeshletSubpass::record_meshlet_draws(CommandBuffer &command_buffer)
+{
+	ScopedDebugLabel meshlet_debug_label{command_buffer, "Meshlet draws"};
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	auto draw_allocation = render_frame.allocate_buffer_array(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(MeshletDrawUniform), to_u32(draws.size()), thread_index);
+	if (draw_allocation.empty())
+	{
+		return;
+	}
+
+	auto snapshot   = render_frame.get_scene_snapshot();
+	auto view       = sg::get_view(snapshot, camera);
+	auto projection = sg::get_projection(snapshot, camera);
+
+	// The model matrices are in the draw uniforms
+	GlobalUniform global_uniform;
+	global_uniform.model            = glm::mat4(1.0f);
+	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(projection) * view;
+	global_uniform.camera_position  = glm::vec3(glm::inverse(view)[3]);
+
+	auto global_allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GlobalUniform), thread_index);
+	global_allocation.update(global_uniform);
+
+	MeshletCullUniform cull_uniform{};
+	if (frustum_culling)
+	{
+		Frustum frustum;
+		frustum.update(projection * view);
+		std::copy(frustum.get_planes().begin(), frustum.get_planes().end(), cull_uniform.frustum_planes);
+	}
+	else
+	{
+		// Planes every sphere is in front of
+		std::fill(std::begin(cull_uniform.frustum_planes), std::end(cull_uniform.frustum_planes), glm::vec4(0.0f, 0.0f, 0.0f, std::numeric_limits<float>::max()));
+	}
+
+	auto cull_allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(MeshletCullUniform), thread_index);
+	cull_allocation.update(cull_uniform);
+
+	// Bindings of meshlet_shared.h and meshlet_geometry.task and .mesh
+	command_buffer.bind_buffer(global_allocation.get_buffer(), global_allocation.get_offset(), global_allocation.get_size(), 0, 1, 0);
+	command_buffer.bind_buffer(cull_allocation.get_buffer(), cull_allocation.get_offset(), cull_allocation.get_size(), 0, 11, 0);
+	command_buffer.bind_buffer(*meshlet_buffer, 0, meshlet_buffer->get_size(), 0, 12, 0);
+	command_buffer.bind_buffer(*meshlet_vertex_buffer, 0, meshlet_vertex_buffer->get_size(), 0, 13, 0);
+	command_buffer.bind_buffer(*meshlet_triangle_buffer, 0, meshlet_triangle_buffer->get_size(), 0, 14, 0);
+
+	// Mesh shading pipelines have no vertex input
+	command_buffer.set_vertex_input_state({});
+
+	auto &resource_cache = command_buffer.get_device().get_resource_cache();
+
+	glm::vec3 camera_position = global_uniform.camera_position;
+
+	const sg::SubMesh *bound_sub_mesh   = nullptr;
+	VkFrontFace        bound_front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+	for (uint32_t i = 0; i < to_u32(draws.size()); ++i)
+	{
+		auto &draw     = draws[i];
+		auto &sub_mesh = *draw.sub_mesh;
+
+		// Draws are sorted, so the state is bound again only when it changes
+		if (!bound_sub_mesh ||
+		    bound_sub_mesh->get_material() != sub_mesh.get_material() ||
+		    bound_sub_mesh->get_shader_variant().get_id() != sub_mesh.get_shader_variant().get_id() ||
+		    bound_front_face != draw.front_face)
+		{
+			auto &draw_info = draw_infos[&sub_mesh];
+
+			if (!draw_info.pipeline_layout)
+			{
+				auto &variant = sub_mesh.get_shader_variant();
+
+				auto &task_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_TASK_BIT_EXT, task_shader, variant);
+				auto &mesh_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_MESH_BIT_EXT, mesh_shader, variant);
+				auto &frag_shader_module = resource_cache.request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+
+				draw_info.pipeline_layout = &prepare_pipeline_layout(command_buffer, {&task_shader_module, &mesh_shader_module, &frag_shader_module});
+
+				DescriptorSetLayout &descriptor_set_layout = draw_info.pipeline_layout->get_descriptor_set_layout(0);
+
+				for (auto &texture : sub_mesh.get_material()->textures)
+				{
+					if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+					{
+						draw_info.texture_bindings.emplace_back(layout_binding->binding, texture.second);
+					}
+				}
+			}
+
+			prepare_pipeline_state(command_buffer, draw.front_face, sub_mesh.get_material()->double_sided);
+
+			command_buffer.bind_pipeline_layout(*draw_info.pipeline_layout);
+
+			if (draw_info.pipeline_layout->get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+			{
+				prepare_push_constants(command_buffer, sub_mesh);
+			}
+
+			for (auto &texture_binding : draw_info.texture_bindings)
+			{
+				command_buffer.bind_image(texture_binding.second->get_image()->get_vk_image_view(),
+				                          texture_binding.second->get_sampler()->vk_sampler,
+				                          0, texture_binding.first, 0);
+			}
+
+			bound_sub_mesh   = &sub_mesh;
+			bound_front_face = draw.front_face;
+		}
+
+		glm::mat4 model = sg::get_node_state(snapshot, *draw.node).world_matrix;
+
+		MeshletDrawUniform draw_uniform{};
+		draw_uniform.model           = model;
+		draw_uniform.camera_position = glm::inverse(model) * glm::vec4(camera_position, 1.0f);
+		draw_uniform.first_meshlet   = draw.first_meshlet;
+		draw_uniform.meshlet_count   = to_u32(sub_mesh.meshlets.meshlets.size());
+		draw_uniform.vertex_offset   = sub_mesh.vertex_offset;
+		draw_uniform.flags           = sub_mesh.get_material()->double_sided ? 0 : DRAW_CONE_CULLING;
+		draw_uniform.position_offset = draw.position.offset;
+		draw_uniform.position_stride = draw.position.stride;
+		draw_uniform.normal_offset   = draw.normal.offset;
+		draw_uniform.normal_stride   = draw.normal.stride;
+		draw_uniform.texcoord_offset = draw.texcoord.offset;
+		draw_uniform.texcoord_stride = draw.texcoord.stride;
+
+		draw_allocation.update(draw_uniform, draw_allocation.get_dynamic_offset(i));
+
+		command_buffer.bind_buffer(draw_allocation.get_buffer(), draw_allocation.get_offset() + draw_allocation.get_dynamic_offset(i), sizeof(MeshletDrawUniform), 0, 10, 0);
+		command_buffer.bind_buffer(*draw.position.buffer, 0, draw.position.buffer->get_size(), 0, 15, 0);
+		command_buffer.bind_buffer(*draw.normal.buffer, 0, draw.normal.buffer->get_size(), 0, 16, 0);
+		command_buffer.bind_buffer(*draw.texcoord.buffer, 0, draw.texcoord.buffer->get_size(), 0, 17, 0);
+
+		command_buffer.draw_mesh_tasks((draw_uniform.meshlet_count + TASK_GROUP_SIZE - 1) / TASK_GROUP_SIZE, 1, 1);
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,171 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/subpasses/forward_subpass.h"
+
+namespace vkb
+{
+/**
+ * @brief Per draw data read by the task and mesh shaders, see meshlet_shared.h
+ */
+struct alignas(16) MeshletDrawUniform
+{
+	glm::mat4 model;
+
+	/// Camera position in the space of the model, for the normal cone tests
+	glm::vec4 camera_position;
+
+	uint32_t first_meshlet;
+
+	uint32_t meshlet_count;
+
+	int32_t vertex_offset;
+
+	uint32_t flags;
+
+	/// Offsets and strides of the vertex attributes in their buffers, counted in floats
+	uint32_t position_offset;
+
+	uint32_t position_stride;
+
+	uint32_t normal_offset;
+
+	uint32_t normal_stride;
+
+	uint32_t texcoord_offset;
+
+	uint32_t texcoord_stride;
+};
+
+/**
+ * @brief This subpass forward renders a Scene with mesh shaders, as meshlets culled on the GPU
+ *
+ * The submeshes drawn must have meshlets, built on load with GLTFLoader::set_meshlet_geometry(), which also creates
+ * their vertex buffers as storage buffers.
+ * On prepare, the meshlets of all these submeshes are uploaded to shared device local buffers.
+ *
+ * Every submesh of every mesh node is drawn with one mesh tasks command. The task shader, meshlet_geometry.task, culls
+ * each meshlet against the camera frustum and by its normal cone, then meshlet_geometry.mesh, which has the outputs of
+ * base.vert, emits the vertices and triangles of the visible ones for the fragment shader given. The vertices are read
+ * straight from the vertex buffers of the submeshes, so packed geometry is bound once for all its submeshes.
+ *
+ * Meshes which cannot be drawn as meshlets, such as transparent ones, ones without meshlets or with unsupported vertex
+ * formats, are drawn by the ForwardSubpass path with both shaders given, as is the whole scene without
+ * Device::uses_mesh_shaders(). The mesh shaders need a SPIR-V 1.4 target, see GLSLCompiler::set_target_environment().
+ *
+ * The meshes and nodes of the scene are captured on prepare, node transforms can change afterwards.
+ */
+class MeshletSubpass : public ForwardSubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass for mesh shader forward rendering
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source, for the meshes which are not drawn as meshlets
+	 * @param fragment_shader Fragment shader source
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera used to look at the scene
+	 */
+	MeshletSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~MeshletSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Record draw commands
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Meshlet draws are recorded inline
+	 */
+	virtual bool supports_parallel_recording() const override;
+
+	/**
+	 * @brief Meshlet draws are not retained
+	 */
+	virtual bool retains_draws() const override;
+
+  private:
+	/// Vertex attribute of a submesh, as read by the mesh shader
+	struct MeshletAttribute
+	{
+		core::Buffer *buffer{nullptr};
+
+		/// Counted in floats
+		uint32_t offset{0};
+
+		uint32_t stride{0};
+	};
+
+	struct MeshletDraw
+	{
+		sg::Node *node;
+
+		sg::SubMesh *sub_mesh;
+
+		VkFrontFace front_face;
+
+		uint32_t first_meshlet;
+
+		MeshletAttribute position;
+
+		MeshletAttribute normal;
+
+		MeshletAttribute texcoord;
+	};
+
+	/**
+	 * @brief Finds how the mesh shader reads an attribute of a submesh
+	 * @param required Whether the attribute must be present, absent attributes are read as zeros
+	 * @return Whether the attribute is a storage buffer of floats in the given format, or absent and not required
+	 */
+	bool find_attribute(sg::SubMesh &sub_mesh, sg::VertexAttributeSlot slot, VkFormat format, bool required, MeshletAttribute &attribute);
+
+	/**
+	 * @brief Uploads the meshlets of the submeshes drawn to device local buffers
+	 */
+	void upload(const MeshletGeometry &geometry);
+
+	void record_meshlet_draws(CommandBuffer &command_buffer);
+
+	ShaderSource task_shader;
+
+	ShaderSource mesh_shader;
+
+	/// Meshes drawn as meshlets, the other ones are left in meshes
+	std::vector<sg::Mesh *> meshlet_meshes;
+
+	/// Ordered by pipeline state and material
+	std::vector<MeshletDraw> draws;
+
+	/// Resolved on first use of each submesh, see record_meshlet_draws()
+	std::unordered_map<const sg::SubMesh *, SubMeshDrawInfo> draw_infos;
+
+	std::unique_ptr<core::Buffer> meshlet_buffer;
+
+	std::unique_ptr<core::Buffer> meshlet_vertex_buffer;
+
+	std::unique_ptr<core::Buffer> meshlet_triangle_buffer;
+
+	/// Read in place of the optional attributes which are absent
+	std::unique_ptr<core::Buffer> zero_buffer;
+};
+}        // namespace vkb
@@ -0,0 +1,74 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/shadow_subpass.h"
+
+#include "core/command_buffer.h"
+#include "core/device.h"
+
+namespace vkb
+{
+ShadowSubpass::ShadowSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene, sg::Camera &camera) :
+    GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene, camera}
+{
+	culling_stats = false;
+}
+
+void ShadowSubpass::set_depth_bias(float constant_factor, float clamp, float slope_factor)
+{
+	depth_bias_constant_factor = constant_factor;
+	depth_bias_clamp           = clamp;
+	depth_bias_slope_factor    = slope_factor;
+}
+
+void ShadowSubpass::prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
+{
+	// Depth bias pushes the primitives further away from the light taking their slope into account,
+	// which avoids self-shadowing caused by the precision of the depth comparisons in the lighting pass
+	RasterizationState rasterization_state{};
+	rasterization_state.front_face        = front_face;
+	rasterization_state.depth_bias_enable = VK_TRUE;
+
+	if (double_sided_material)
+	{
+		rasterization_state.cull_mode = VK_CULL_MODE_NONE;
+	}
+
+	command_buffer.set_rasterization_state(rasterization_state);
+	command_buffer.set_depth_bias(depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor);
+
+	MultisampleState multisample_state{};
+	multisample_state.rasterization_samples = sample_count;
+	command_buffer.set_multisample_state(multisample_state);
+}
+
+PipelineLayout &ShadowSubpass::prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules)
+{
+	// Only the vertex shader is needed to render depth
+	assert(!shader_modules.empty());
+	auto vertex_shader_module = shader_modules[0];
+
+	vertex_shader_module->set_resource_mode("GlobalUniform", ShaderResourceMode::Dynamic);
+
+	return command_buffer.get_device().get_resource_cache().request_pipeline_layout({vertex_shader_module});
+}
+
+void ShadowSubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+{
+	// No push constants are used in the shadow pass
+}
+}        // namespace vkb
@@ -0,0 +1,64 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/subpasses/geometry_subpass.h"
+
+namespace vkb
+{
+/**
+ * @brief Renders the depth of a Scene as seen from a light, for shadow mapping
+ *
+ * Only the vertex shader is used to build the pipeline layout, with the GlobalUniform as a dynamic uniform buffer,
+ * and no push constants are pushed. The primitives are pushed away from the light with a depth bias, see set_depth_bias().
+ */
+class ShadowSubpass : public GeometrySubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass rendering the depth of the scene from a light
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source, such as shadows/shadowmap.vert
+	 * @param fragment_shader Fragment shader source, such as shadows/shadowmap.frag
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera of the light
+	 */
+	ShadowSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~ShadowSubpass() = default;
+
+	/**
+	 * @brief Sets the depth bias applied to the primitives, with reversed depth the factors are negative
+	 */
+	void set_depth_bias(float constant_factor, float clamp, float slope_factor);
+
+  protected:
+	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material) override;
+
+	virtual PipelineLayout &prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules) override;
+
+	virtual void prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh) override;
+
+  private:
+	float depth_bias_constant_factor{-1.4f};
+
+	float depth_bias_clamp{0.0f};
+
+	float depth_bias_slope_factor{-1.7f};
+};
+}        // namespace vkb
@@ -0,0 +1,272 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/temporal_anti_aliasing.h"
+
+#include "common/utils.h"
+#include "core/allocated.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "rendering/render_target.h"
+
+namespace vkb
+{
+namespace
+{
+/// Same layout as Parameters in taa_resolve.comp
+struct Parameters
+{
+	/// Render extent over the extent of the scene images
+	glm::vec2 scene_uv_scale;
+
+	/// Jitter of the scene in texture coordinates of the render extent
+	glm::vec2 jitter_uv;
+
+	glm::uvec2 render_extent;
+
+	glm::uvec2 output_extent;
+
+	float feedback;
+
+	uint32_t history_valid;
+};
+
+/// Invocations of taa_resolve.comp on each side of a workgroup
+constexpr uint32_t GROUP_SIZE = 8;
+
+/// Phases of the jitter sequence, enough to cover a texel evenly without repeating too slowly for the history
+constexpr uint32_t JITTER_PHASES = 8;
+
+float halton(uint32_t index, uint32_t base)
+{
+	float result   = 0.0f;
+	float fraction = 1.0f;
+	while (index > 0)
+	{
+		fraction /= static_cast<float>(base);
+		result += fraction * static_cast<float>(index % base);
+		index /= base;
+	}
+	return result;
+}
+}        // namespace
+
+TemporalAntiAliasing::TemporalAntiAliasing(Device &device) :
+    device{device},
+    shader{"taa_resolve.comp"}
+{
+	device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, shader);
+
+	VkSamplerCreateInfo sampler_info{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+	sampler_info.magFilter    = VK_FILTER_LINEAR;
+	sampler_info.minFilter    = VK_FILTER_LINEAR;
+	sampler_info.mipmapMode   = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+	linear_sampler = std::make_unique<core::Sampler>(device, sampler_info);
+	linear_sampler->set_debug_name("TemporalAntiAliasing: linear sampler");
+
+	// Depth and velocity are not interpolated across the edges of objects
+	sampler_info.magFilter = VK_FILTER_NEAREST;
+	sampler_info.minFilter = VK_FILTER_NEAREST;
+
+	nearest_sampler = std::make_unique<core::Sampler>(device, sampler_info);
+	nearest_sampler->set_debug_name("TemporalAntiAliasing: nearest sampler");
+}
+
+glm::vec2 TemporalAntiAliasing::next_jitter(const VkExtent2D &render_extent)
+{
+	jitter_index = (jitter_index + 1) % JITTER_PHASES;
+
+	// Offsets within the texel, centered on its middle
+	glm::vec2 offset{halton(jitter_index + 1, 2) - 0.5f, halton(jitter_index + 1, 3) - 0.5f};
+
+	jitter = {2.0f * offset.x / render_extent.width, 2.0f * offset.y / render_extent.height};
+
+	return jitter;
+}
+
+const core::ImageView &TemporalAntiAliasing::resolve(CommandBuffer &command_buffer, RenderTarget &scene_render_target, const VkExtent2D &extent)
+{
+	if (!history_images[0] || extent.width != output_extent.width || extent.height != output_extent.height)
+	{
+		create(extent);
+	}
+
+	ScopedDebugLabel debug_label{command_buffer, "Temporal anti-aliasing"};
+
+	auto &scene_views = scene_render_target.get_views();
+	assert(scene_views.size() > RenderTarget::MV_VELOCITY_ATTACHMENT && "The scene must be rendered with RenderTarget::create_motion_vectors_func()");
+
+	auto &history_view  = *history_views[write_index ^ 1];
+	auto &resolved_view = *history_views[write_index];
+
+	command_buffer.begin_barrier_batch();
+
+	for (uint32_t attachment : {RenderTarget::MV_COLOR_ATTACHMENT, RenderTarget::MV_DEPTH_ATTACHMENT, RenderTarget::MV_VELOCITY_ATTACHMENT})
+	{
+		if (scene_render_target.get_layout(attachment) == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+		{
+			continue;
+		}
+
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = scene_render_target.get_layout(attachment);
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		if (is_depth_format(scene_views[attachment].get_format()))
+		{
+			memory_barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		}
+		else
+		{
+			memory_barrier.src_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		}
+
+		command_buffer.image_memory_barrier(scene_views[attachment], memory_barrier);
+		scene_render_target.set_layout(attachment, memory_barrier.new_layout);
+	}
+
+	if (!history_valid)
+	{
+		// The history is not read by the shader, but it is bound in the layout it is read with
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(history_view, memory_barrier);
+	}
+
+	{
+		// The resolved image of the frame before the previous one may still be sampled by its upscale
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(resolved_view, memory_barrier);
+	}
+
+	command_buffer.flush_barriers();
+
+	auto &resource_cache  = device.get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, shader);
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	command_buffer.bind_image(scene_views[RenderTarget::MV_COLOR_ATTACHMENT], *linear_sampler, 0, 0, 0);
+	command_buffer.bind_image(scene_views[RenderTarget::MV_DEPTH_ATTACHMENT], *nearest_sampler, 0, 1, 0);
+	command_buffer.bind_image(scene_views[RenderTarget::MV_VELOCITY_ATTACHMENT], *nearest_sampler, 0, 2, 0);
+	command_buffer.bind_image(history_view, *linear_sampler, 0, 3, 0);
+	command_buffer.bind_image(resolved_view, 0, 4, 0);
+
+	const auto &scene_extent  = scene_render_target.get_extent();
+	const auto &render_extent = scene_render_target.get_render_extent();
+
+	Parameters parameters{};
+	parameters.scene_uv_scale = {static_cast<float>(render_extent.width) / scene_extent.width, static_cast<float>(render_extent.height) / scene_extent.height};
+	parameters.jitter_uv      = jitter * 0.5f;
+	parameters.render_extent  = {render_extent.width, render_extent.height};
+	parameters.output_extent  = {output_extent.width, output_extent.height};
+	parameters.feedback       = feedback;
+	parameters.history_valid  = history_valid ? 1 : 0;
+	command_buffer.push_constants(parameters);
+
+	command_buffer.dispatch((output_extent.width + GROUP_SIZE - 1) / GROUP_SIZE, (output_extent.height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+
+	{
+		// Read by the upscale, then as the history of the next resolve
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_GENERAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		command_buffer.image_memory_barrier(resolved_view, memory_barrier);
+	}
+
+	history_valid = true;
+	write_index ^= 1;
+
+	return resolved_view;
+}
+
+void TemporalAntiAliasing::reset()
+{
+	history_valid = false;
+}
+
+void TemporalAntiAliasing::set_feedback(float feedback_)
+{
+	feedback = feedback_;
+}
+
+const core::Sampler &TemporalAntiAliasing::get_sampler() const
+{
+	return *linear_sampler;
+}
+
+void TemporalAntiAliasing::create(const VkExtent2D &extent)
+{
+	if (history_images[0])
+	{
+		// Resizes are rare, the frames in flight may still read the history
+		device.wait_idle();
+
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			history_views[i].reset();
+			history_images[i].reset();
+		}
+	}
+
+	output_extent = extent;
+	history_valid = false;
+	write_index   = 0;
+
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::RenderTarget};
+
+	for (uint32_t i = 0; i < 2; ++i)
+	{
+		history_images[i] = std::make_unique<core::Image>(device,
+		                                                  VkExtent3D{extent.width, extent.height, 1},
+		                                                  VK_FORMAT_R16G16B16A16_SFLOAT,
+		                                                  VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+		                                                  VMA_MEMORY_USAGE_GPU_ONLY);
+		history_images[i]->set_debug_name("TemporalAntiAliasing: history " + std::to_string(i));
+
+		history_views[i] = std::make_unique<core::ImageView>(*history_images[i], VK_IMAGE_VIEW_TYPE_2D);
+		history_views[i]->set_debug_name("TemporalAntiAliasing: history view " + std::to_string(i));
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,129 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/sampler.h"
+#include "core/shader_module.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+class RenderTarget;
+
+/**
+ * @brief Temporal anti-aliasing and upscaling of a scene rendered with jittered projections and motion vectors
+ *
+ * Each frame the scene is rendered with the projection offset by next_jitter(), a Halton (2, 3) sequence of sub-texel
+ * offsets, to a render target from RenderTarget::create_motion_vectors_func(), with GeometrySubpass::set_motion_vectors().
+ * resolve() then accumulates it at the output resolution with taa_resolve.comp: the history of the previous frame is
+ * reprojected with the velocity of the closest texel of the 3x3 neighborhood, clamped to the colors of the neighborhood
+ * to reject stale samples, and blended with the current frame. As the jitter moves every frame, the history converges to
+ * a supersampled image, so a scene rendered at a lower resolution is upscaled with more detail than by filtering.
+ *
+ * The history is kept in two RGBA16F images at the output extent, which are written and read in turn.
+ */
+class TemporalAntiAliasing
+{
+  public:
+	explicit TemporalAntiAliasing(Device &device);
+
+	TemporalAntiAliasing(const TemporalAntiAliasing &) = delete;
+
+	TemporalAntiAliasing(TemporalAntiAliasing &&) = delete;
+
+	~TemporalAntiAliasing() = default;
+
+	TemporalAntiAliasing &operator=(const TemporalAntiAliasing &) = delete;
+
+	TemporalAntiAliasing &operator=(TemporalAntiAliasing &&) = delete;
+
+	/**
+	 * @brief Advances the jitter sequence, to be passed to RenderContext::set_projection_jitter() before rendering the frame
+	 * @param render_extent The extent the scene is rendered at
+	 * @return The clip space offset of the projection, within half a texel of the render extent
+	 */
+	glm::vec2 next_jitter(const VkExtent2D &render_extent);
+
+	/**
+	 * @brief Records the resolve of the scene into the history, which is created again if the output extent changed
+	 *        The color, depth and velocity attachments of the scene are transitioned to the shader read only layout.
+	 * @param command_buffer A command buffer of a queue family supporting compute, outside of a render pass
+	 * @param scene_render_target The render target the scene was rendered to with the last jitter, in its render extent
+	 * @param output_extent The extent of the resolved image
+	 * @return A view on the resolved image, in the shader read only layout, valid until the next resolve
+	 */
+	const core::ImageView &resolve(CommandBuffer &command_buffer, RenderTarget &scene_render_target, const VkExtent2D &output_extent);
+
+	/**
+	 * @brief Discards the history, e.g. on a camera cut, so that the next frame is resolved from the current samples only
+	 */
+	void reset();
+
+	/**
+	 * @brief Sets how much of the history is kept each frame, 0.9 by default
+	 *        Higher values smooth more but blur fast motion, lower values converge faster but let more aliasing through.
+	 */
+	void set_feedback(float feedback);
+
+	/**
+	 * @return A sampler for the resolved image, with linear filtering
+	 */
+	const core::Sampler &get_sampler() const;
+
+  private:
+	/**
+	 * @brief Creates the history images for an output extent
+	 */
+	void create(const VkExtent2D &output_extent);
+
+	Device &device;
+
+	ShaderSource shader;
+
+	/// Phase of the jitter sequence, and the jitter of the frame being rendered
+	uint32_t jitter_index{0};
+
+	glm::vec2 jitter{0.0f};
+
+	float feedback{0.9f};
+
+	/// Whether the image read as history holds a previous frame
+	bool history_valid{false};
+
+	VkExtent2D output_extent{};
+
+	std::array<std::unique_ptr<core::Image>, 2> history_images;
+
+	std::array<std::unique_ptr<core::ImageView>, 2> history_views;
+
+	/// Index of the history image written by the next resolve, the other one is read
+	uint32_t write_index{0};
+
+	std::unique_ptr<core::Sampler> linear_sampler;
+
+	std::unique_ptr<core::Sampler> nearest_sampler;
+};
+}        // namespace vkb
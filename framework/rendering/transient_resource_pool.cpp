@@ -0,0 +1,211 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/transient_resource_pool.h"
+
+#include <algorithm>
+
+#include "common/helpers.h"
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+void hash_allocation(size_t &key, const VmaAllocationCreateInfo &alloc_create_info)
+{
+	hash_combine(key, static_cast<uint32_t>(alloc_create_info.usage));
+	hash_combine(key, alloc_create_info.flags);
+	hash_combine(key, alloc_create_info.requiredFlags);
+	hash_combine(key, alloc_create_info.preferredFlags);
+	hash_combine(key, alloc_create_info.memoryTypeBits);
+	hash_combine(key, alloc_create_info.pool);
+	hash_combine(key, alloc_create_info.pUserData);
+}
+
+void hash_queue_families(size_t &key, uint32_t count, const uint32_t *families)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		hash_combine(key, families[i]);
+	}
+}
+}        // namespace
+
+TransientResourcePool::TransientResourcePool(Device &device) :
+    device{device}
+{
+}
+
+core::Image TransientResourcePool::request_image(const core::ImageBuilder &builder)
+{
+	const auto &create_info = builder.create_info;
+
+	if (create_info.pNext || builder.alias_allocation != VK_NULL_HANDLE || (create_info.flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT))
+	{
+		return builder.build(device);
+	}
+
+	size_t key = 0;
+	hash_combine(key, create_info.flags);
+	hash_combine(key, static_cast<uint32_t>(create_info.imageType));
+	hash_combine(key, static_cast<uint32_t>(create_info.format));
+	hash_combine(key, create_info.extent.width);
+	hash_combine(key, create_info.extent.height);
+	hash_combine(key, create_info.extent.depth);
+	hash_combine(key, create_info.mipLevels);
+	hash_combine(key, create_info.arrayLayers);
+	hash_combine(key, static_cast<uint32_t>(create_info.samples));
+	hash_combine(key, static_cast<uint32_t>(create_info.tiling));
+	hash_combine(key, create_info.usage);
+	hash_combine(key, static_cast<uint32_t>(create_info.sharingMode));
+	hash_queue_families(key, create_info.queueFamilyIndexCount, create_info.pQueueFamilyIndices);
+	hash_allocation(key, builder.alloc_create_info);
+
+	size_t index = find_available(released_images, key);
+	if (index == released_images.size())
+	{
+		++created_count;
+
+		core::Image image = builder.build(device);
+		requested_images[image.get_handle()] = key;
+		return image;
+	}
+
+	++recycled_count;
+
+	core::Image image{std::move(*released_images[index].resource)};
+	released_images.erase(released_images.begin() + index);
+
+	image.set_subresource_state({0, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS}, core::ImageSubresourceState{});
+	if (!builder.debug_name.empty())
+	{
+		image.set_debug_name(builder.debug_name);
+	}
+
+	requested_images[image.get_handle()] = key;
+	return image;
+}
+
+core::Buffer TransientResourcePool::request_buffer(const core::BufferBuilder &builder)
+{
+	const auto &create_info = builder.create_info;
+
+	if (create_info.pNext)
+	{
+		return builder.build(device);
+	}
+
+	size_t key = 0;
+	hash_combine(key, create_info.flags);
+	hash_combine(key, create_info.size);
+	hash_combine(key, create_info.usage);
+	hash_combine(key, static_cast<uint32_t>(create_info.sharingMode));
+	hash_queue_families(key, create_info.queueFamilyIndexCount, create_info.pQueueFamilyIndices);
+	hash_allocation(key, builder.alloc_create_info);
+
+	size_t index = find_available(released_buffers, key);
+	if (index == released_buffers.size())
+	{
+		++created_count;
+
+		core::Buffer buffer = builder.build(device);
+		requested_buffers[buffer.get_handle()] = key;
+		return buffer;
+	}
+
+	++recycled_count;
+
+	core::Buffer buffer{std::move(*released_buffers[index].resource)};
+	released_buffers.erase(released_buffers.begin() + index);
+
+	buffer.set_state(core::BufferState{});
+	if (!builder.debug_name.empty())
+	{
+		buffer.set_debug_name(builder.debug_name);
+	}
+
+	requested_buffers[buffer.get_handle()] = key;
+	return buffer;
+}
+
+void TransientResourcePool::release_image(core::Image &&image)
+{
+	auto it = requested_images.find(image.get_handle());
+	if (it == requested_images.end())
+	{
+		core::Image destroyed{std::move(image)};
+		return;
+	}
+
+	// The views were destroyed with the resources which used the image
+	image.get_views().clear();
+
+	released_images.push_back({it->second, frame_index, std::make_unique<core::Image>(std::move(image))});
+	requested_images.erase(it);
+}
+
+void TransientResourcePool::release_buffer(core::Buffer &&buffer)
+{
+	auto it = requested_buffers.find(buffer.get_handle());
+	if (it == requested_buffers.end())
+	{
+		core::Buffer destroyed{std::move(buffer)};
+		return;
+	}
+
+	released_buffers.push_back({it->second, frame_index, std::make_unique<core::Buffer>(std::move(buffer))});
+	requested_buffers.erase(it);
+}
+
+void TransientResourcePool::next_frame(uint32_t frames_in_flight_)
+{
+	++frame_index;
+	frames_in_flight = frames_in_flight_;
+
+	auto is_unused = [this](const auto &released) { return frame_index - released.frame > max_unused_frames; };
+
+	released_images.erase(std::remove_if(released_images.begin(), released_images.end(), is_unused), released_images.end());
+	released_buffers.erase(std::remove_if(released_buffers.begin(), released_buffers.end(), is_unused), released_buffers.end());
+}
+
+void TransientResourcePool::set_max_unused_frames(uint32_t max_unused_frames_)
+{
+	max_unused_frames = max_unused_frames_;
+}
+
+std::pair<uint32_t, uint32_t> TransientResourcePool::get_recycled_and_created_count() const
+{
+	return {recycled_count, created_count};
+}
+
+void TransientResourcePool::clear()
+{
+	released_images.clear();
+	released_buffers.clear();
+}
+
+template <typename Resource>
+size_t TransientResourcePool::find_available(const std::vector<Released<Resource>> &released, size_t key) const
+{
+	auto it = std::find_if(released.begin(), released.end(), [this, key](const Released<Resource> &resource) {
+		return resource.key == key && frame_index - resource.frame >= frames_in_flight;
+	});
+
+	return std::distance(released.begin(), it);
+}
+}        // namespace vkb
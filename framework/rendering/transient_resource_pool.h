@@ -0,0 +1,145 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/image.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Recycles the images and buffers of transient resources, like postprocessing images and render target attachments
+ *        recreated on resize, so that recreating them does not allocate memory again
+ *
+ * Resources are requested with a builder, and released to the pool instead of being destroyed. A released resource goes
+ * back to the resources of its description once the frames which may still use it retired, see next_frame(), and is
+ * destroyed if it is not requested again for a number of frames.
+ *
+ * The contents of a recycled resource are undefined, and its tracked state is reset, so images start in the undefined layout.
+ */
+class TransientResourcePool
+{
+  public:
+	/// Number of frames a released resource stays in the pool before it is destroyed, unless set otherwise
+	static constexpr uint32_t DEFAULT_MAX_UNUSED_FRAMES = 120;
+
+	TransientResourcePool(Device &device);
+
+	TransientResourcePool(const TransientResourcePool &) = delete;
+
+	TransientResourcePool(TransientResourcePool &&) = delete;
+
+	~TransientResourcePool() = default;
+
+	TransientResourcePool &operator=(const TransientResourcePool &) = delete;
+
+	TransientResourcePool &operator=(TransientResourcePool &&) = delete;
+
+	/**
+	 * @brief Returns a released image of the description of the builder, or creates one
+	 *        Builders with extension structures or an alias allocation, and sparse images, always create an image, which is
+	 *        destroyed on release.
+	 */
+	core::Image request_image(const core::ImageBuilder &builder);
+
+	/**
+	 * @brief Returns a released buffer of the description of the builder, or creates one
+	 *        Builders with extension structures always create a buffer, which is destroyed on release.
+	 */
+	core::Buffer request_buffer(const core::BufferBuilder &builder);
+
+	/**
+	 * @brief Returns an image to the pool, images which were not requested from it are destroyed
+	 *        Its views must have been destroyed.
+	 */
+	void release_image(core::Image &&image);
+
+	/**
+	 * @brief Returns a buffer to the pool, buffers which were not requested from it are destroyed
+	 */
+	void release_buffer(core::Buffer &&buffer);
+
+	/**
+	 * @brief Starts a frame: the resources released frames_in_flight frames ago can be requested again, and the resources
+	 *        unused for longer than the limit are destroyed
+	 *        RenderContext calls this once it waited for the frame.
+	 * @param frames_in_flight The number of frames the GPU may still be processing
+	 */
+	void next_frame(uint32_t frames_in_flight);
+
+	/**
+	 * @param max_unused_frames The number of frames a released resource stays in the pool before it is destroyed
+	 */
+	void set_max_unused_frames(uint32_t max_unused_frames);
+
+	/**
+	 * @return The number of requests which recycled a resource and which created one, since the pool was created
+	 */
+	std::pair<uint32_t, uint32_t> get_recycled_and_created_count() const;
+
+	/**
+	 * @brief Destroys the released resources
+	 */
+	void clear();
+
+  private:
+	template <typename Resource>
+	struct Released
+	{
+		size_t key;
+
+		uint64_t frame;
+
+		std::unique_ptr<Resource> resource;
+	};
+
+	/**
+	 * @return The index in released of a resource of a description which the GPU no longer uses, the size of released if there is none
+	 */
+	template <typename Resource>
+	size_t find_available(const std::vector<Released<Resource>> &released, size_t key) const;
+
+	Device &device;
+
+	uint32_t max_unused_frames{DEFAULT_MAX_UNUSED_FRAMES};
+
+	uint64_t frame_index{0};
+
+	uint32_t frames_in_flight{1};
+
+	/// Descriptions of the resources requested from the pool, by handle
+	std::unordered_map<VkImage, size_t> requested_images;
+
+	std::unordered_map<VkBuffer, size_t> requested_buffers;
+
+	/// Released resources, from the oldest release
+	std::vector<Released<core::Image>> released_images;
+
+	std::vector<Released<core::Buffer>> released_buffers;
+
+	uint32_t recycled_count{0};
+
+	uint32_t created_count{0};
+};
+}        // namespace vkb
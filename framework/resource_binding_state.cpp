@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,13 +17,20 @@
 
 #include "resource_binding_state.h"
 
+#include "common/helpers.h"
+
+#include <tuple>
+
 namespace vkb
 {
 void ResourceBindingState::reset()
 {
 	clear_dirty();
 
-	resource_sets.clear();
+	for (auto &resource_set : resource_sets)
+	{
+		resource_set.reset();
+	}
 }
 
 bool ResourceBindingState::is_dirty()
@@ -38,46 +45,61 @@ void ResourceBindingState::clear_dirty()
 
 void ResourceBindingState::clear_dirty(uint32_t set)
 {
-	resource_sets[set].clear_dirty();
+	if (set < resource_sets.size())
+	{
+		resource_sets[set].clear_dirty();
+	}
 }
 
 void ResourceBindingState::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_buffer(buffer, offset, range, binding, array_element);
+	get_resource_set(set).bind_buffer(buffer, offset, range, binding, array_element);
 
 	dirty = true;
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, sampler, binding, array_element);
+	get_resource_set(set).bind_image(image_view, sampler, binding, array_element);
 
 	dirty = true;
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, binding, array_element);
+	get_resource_set(set).bind_image(image_view, binding, array_element);
 
 	dirty = true;
 }
 
 void ResourceBindingState::bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_input(image_view, binding, array_element);
+	get_resource_set(set).bind_input(image_view, binding, array_element);
 
 	dirty = true;
 }
 
-const std::unordered_map<uint32_t, ResourceSet> &ResourceBindingState::get_resource_sets()
+const std::vector<ResourceSet> &ResourceBindingState::get_resource_sets() const
 {
 	return resource_sets;
 }
 
+ResourceSet &ResourceBindingState::get_resource_set(uint32_t set)
+{
+	if (set >= resource_sets.size())
+	{
+		resource_sets.resize(set + 1);
+	}
+
+	return resource_sets[set];
+}
+
 void ResourceSet::reset()
 {
 	clear_dirty();
 
+	hash = 0;
+
 	resource_bindings.clear();
 }
 
@@ -86,6 +108,11 @@ bool ResourceSet::is_dirty() const
 	return dirty;
 }
 
+bool ResourceSet::empty() const
+{
+	return resource_bindings.empty();
+}
+
 void ResourceSet::clear_dirty()
 {
 	dirty = false;
@@ -93,48 +120,115 @@ void ResourceSet::clear_dirty()
 
 void ResourceSet::clear_dirty(uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty = false;
+	get_resource_binding(binding, array_element).info.dirty = false;
 }
 
 void ResourceSet::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty  = true;
-	resource_bindings[binding][array_element].buffer = &buffer;
-	resource_bindings[binding][array_element].offset = offset;
-	resource_bindings[binding][array_element].range  = range;
+	auto &resource_binding = get_resource_binding(binding, array_element);
+
+	resource_binding.info.dirty  = true;
+	resource_binding.info.buffer = &buffer;
+	resource_binding.info.offset = offset;
+	resource_binding.info.range  = range;
+
+	update_hash(resource_binding);
 
 	dirty = true;
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = &sampler;
+	auto &resource_binding = get_resource_binding(binding, array_element);
+
+	resource_binding.info.dirty      = true;
+	resource_binding.info.image_view = &image_view;
+	resource_binding.info.sampler    = &sampler;
+
+	update_hash(resource_binding);
 
 	dirty = true;
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = nullptr;
+	auto &resource_binding = get_resource_binding(binding, array_element);
+
+	resource_binding.info.dirty      = true;
+	resource_binding.info.image_view = &image_view;
+	resource_binding.info.sampler    = nullptr;
+
+	update_hash(resource_binding);
 
 	dirty = true;
 }
 
 void ResourceSet::bind_input(const core::ImageView &image_view, const uint32_t binding, const uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
+	auto &resource_binding = get_resource_binding(binding, array_element);
+
+	resource_binding.info.dirty      = true;
+	resource_binding.info.image_view = &image_view;
+
+	update_hash(resource_binding);
 
 	dirty = true;
 }
 
-const BindingMap<ResourceInfo> &ResourceSet::get_resource_bindings() const
+const std::vector<ResourceBinding> &ResourceSet::get_resource_bindings() const
 {
 	return resource_bindings;
 }
 
+size_t ResourceSet::get_hash() const
+{
+	return hash;
+}
+
+ResourceBinding &ResourceSet::get_resource_binding(uint32_t binding, uint32_t array_element)
+{
+	// Resources are usually bound in order, so the binding is most often the last one or appended
+	if (resource_bindings.empty() ||
+	    std::tie(resource_bindings.back().binding, resource_bindings.back().array_element) < std::tie(binding, array_element))
+	{
+		resource_bindings.push_back({binding, array_element});
+		return resource_bindings.back();
+	}
+
+	auto it = std::lower_bound(resource_bindings.begin(), resource_bindings.end(), std::make_pair(binding, array_element),
+	                           [](const ResourceBinding &resource_binding, const std::pair<uint32_t, uint32_t> &key) {
+		                           return std::tie(resource_binding.binding, resource_binding.array_element) < std::tie(key.first, key.second);
+	                           });
+
+	if (it == resource_bindings.end() || it->binding != binding || it->array_element != array_element)
+	{
+		it = resource_bindings.insert(it, {binding, array_element});
+	}
+
+	return *it;
+}
+
+void ResourceSet::update_hash(ResourceBinding &resource_binding)
+{
+	// Bindings are combined with a xor, so that one can be replaced without going through the others
+	hash ^= resource_binding.hash;
+
+	auto &info = resource_binding.info;
+
+	size_t binding_hash = 0;
+	hash_combine(binding_hash, resource_binding.binding);
+	hash_combine(binding_hash, resource_binding.array_element);
+	hash_combine(binding_hash, info.buffer ? info.buffer->get_handle() : VK_NULL_HANDLE);
+	hash_combine(binding_hash, info.range);
+	hash_combine(binding_hash, info.image_view ? info.image_view->get_handle() : VK_NULL_HANDLE);
+	hash_combine(binding_hash, info.sampler ? info.sampler->get_handle() : VK_NULL_HANDLE);
+
+	resource_binding.dynamic_hash = binding_hash;
+
+	hash_combine(binding_hash, info.offset);
+
+	resource_binding.hash = binding_hash;
+
+	hash ^= resource_binding.hash;
+}
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -44,11 +44,31 @@ struct ResourceInfo
 	const core::Sampler *sampler{nullptr};
 };
 
+/**
+ * @brief A resource bound to an array element of a binding
+ */
+struct ResourceBinding
+{
+	uint32_t binding{0};
+
+	uint32_t array_element{0};
+
+	ResourceInfo info;
+
+	/// Hash of the binding, array element and resource handles
+	size_t hash{0};
+
+	/// Same as hash without the offset, which is not written to descriptors of dynamic buffers
+	size_t dynamic_hash{0};
+};
+
 /**
  * @brief A resource set is a set of bindings containing resources that were bound 
  *        by a command buffer.
  *
- * The ResourceSet has a one to one mapping with a DescriptorSet.
+ * The ResourceSet has a one to one mapping with a DescriptorSet. Bindings are kept in a flat array sorted by binding
+ * and array element, which keeps its capacity when the set is reset, and the hash of the set is updated as resources
+ * are bound, so that looking up the descriptor set of the resources does not depend on the number of bindings.
  */
 class ResourceSet
 {
@@ -57,6 +77,8 @@ class ResourceSet
 
 	bool is_dirty() const;
 
+	bool empty() const;
+
 	void clear_dirty();
 
 	void clear_dirty(uint32_t binding, uint32_t array_element);
@@ -69,12 +91,32 @@ class ResourceSet
 
 	void bind_input(const core::ImageView &image_view, uint32_t binding, uint32_t array_element);
 
-	const BindingMap<ResourceInfo> &get_resource_bindings() const;
+	/**
+	 * @return The bound resources, sorted by binding and array element
+	 */
+	const std::vector<ResourceBinding> &get_resource_bindings() const;
+
+	/**
+	 * @return The combined hash of all the bound resources
+	 */
+	size_t get_hash() const;
 
   private:
 	bool dirty{false};
 
-	BindingMap<ResourceInfo> resource_bindings;
+	size_t hash{0};
+
+	std::vector<ResourceBinding> resource_bindings;
+
+	/**
+	 * @brief Finds the resource bound to an array element of a binding, or inserts an empty one in order
+	 */
+	ResourceBinding &get_resource_binding(uint32_t binding, uint32_t array_element);
+
+	/**
+	 * @brief Recomputes the hashes of a resource binding after its resource changed, and replaces it in the hash of the set
+	 */
+	void update_hash(ResourceBinding &resource_binding);
 };
 
 /**
@@ -102,11 +144,17 @@ class ResourceBindingState
 
 	void bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element);
 
-	const std::unordered_map<uint32_t, ResourceSet> &get_resource_sets();
+	/**
+	 * @return The resource sets indexed by set, those without resources are empty
+	 */
+	const std::vector<ResourceSet> &get_resource_sets() const;
 
   private:
 	bool dirty{false};
 
-	std::unordered_map<uint32_t, ResourceSet> resource_sets;
+	/// Reset sets keep their storage, so that binding the same resources again does not allocate
+	std::vector<ResourceSet> resource_sets;
+
+	ResourceSet &get_resource_set(uint32_t set);
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,21 +17,87 @@
 
 #include "resource_cache.h"
 
+#include "common/resource_cache_lookup.h"
 #include "common/resource_caching.h"
+#include "common/strings.h"
 #include "core/device.h"
+#include "core/image_view.h"
+#include "core/util/profiling.hpp"
+#include "filesystem/legacy.h"
+
+#include <algorithm>
+
+#include <ctpl_stl.h>
 
 namespace vkb
 {
 namespace
 {
+/**
+ * @brief Hashes the contents of a shader file and of the files it includes, as ShaderModule expands them
+ */
+uint64_t hash_shader_file(const std::string &filename, uint64_t seed = 0)
+{
+	auto source = fs::read_shader(filename);
+
+	uint64_t hash = hash_bytes(source.data(), source.size(), seed);
+
+	for (auto &line : split(source, '\n'))
+	{
+		if (line.find("#include \"") == 0)
+		{
+			std::string include_path = line.substr(10);
+			hash                     = hash_shader_file(include_path.substr(0, include_path.find('"')), hash);
+		}
+	}
+
+	return hash;
+}
+
+template <class T, class... A>
+T &request_resource(Device                             &device,
+                    ResourceRecord                     &recorder,
+                    std::mutex                         &resource_mutex,
+                    std::atomic<uint32_t>              &contention_count,
+                    ReadMostlyMap<T>                   &index,
+                    std::unordered_map<std::size_t, T> &resources,
+                    A &...args)
+{
+	std::size_t hash{0U};
+	hash_param(hash, args...);
+
+	return common::request_indexed_resource(hash, resource_mutex, contention_count, index, [&]() -> T & {
+		return request_resource(device, &recorder, resources, args...);
+	});
+}
+
+/**
+ * @brief Variant of request_resource which builds a missing object outside of the resource lock, see common::request_concurrent_resource()
+ */
 template <class T, class... A>
-T &request_resource(Device &device, ResourceRecord &recorder, std::mutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, A &... args)
+T &request_resource(Device                             &device,
+                    ResourceRecord                     &recorder,
+                    std::mutex                         &recorder_mutex,
+                    std::mutex                         &resource_mutex,
+                    std::atomic<uint32_t>              &contention_count,
+                    ReadMostlyMap<T>                   &index,
+                    std::unordered_map<std::size_t, T> &resources,
+                    A &...args)
 {
-	std::lock_guard<std::mutex> guard(resource_mutex);
+	std::size_t hash{0U};
+	hash_param(hash, args...);
+
+	return common::request_concurrent_resource(
+	    hash, resource_mutex, contention_count, index, resources,
+	    [&]() { return T(device, args...); },
+	    [&](T &resource) {
+		    std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
 
-	auto &res = request_resource(device, &recorder, resources, args...);
+		    RecordHelper<T, A...> record_helper;
 
-	return res;
+		    size_t record_index = record_helper.record(recorder, args...);
+		    record_helper.index(recorder, record_index, resource);
+	    });
 }
 }        // namespace
 
@@ -40,13 +106,70 @@ ResourceCache::ResourceCache(Device &device) :
 {
 }
 
+ResourceCache::~ResourceCache()
+{
+	wait_shader_poll();
+	wait_warmup();
+	wait_pipeline_compilations();
+	wait_optimized_pipelines();
+}
+
 void ResourceCache::warmup(const std::vector<uint8_t> &data)
 {
-	recorder.set_data(data);
+	wait_warmup();
+
+	{
+		std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+		recorder.set_data(data);
+	}
 
 	replayer.play(*this, recorder);
 }
 
+std::shared_future<void> ResourceCache::warmup_async(const std::vector<uint8_t> &data, uint32_t thread_count, ResourceReplay::ProgressCallback progress_callback)
+{
+	wait_warmup();
+
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	if (!warmup_thread_pool || warmup_thread_pool->size() != static_cast<int>(thread_count))
+	{
+		warmup_thread_pool = std::make_unique<ctpl::thread_pool>(thread_count);
+	}
+
+	{
+		std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+		recorder.set_data(data);
+	}
+
+	// The replay reads its own copy of the data, as the requests of other threads keep recording while it runs
+	warmup_future = std::async(std::launch::async, [this, data, progress_callback]() {
+		               replayer.play_parallel(*this, data, *warmup_thread_pool, progress_callback);
+	               }).share();
+
+	return warmup_future;
+}
+
+void ResourceCache::wait_warmup()
+{
+	if (warmup_future.valid())
+	{
+		try
+		{
+			warmup_future.get();
+		}
+		catch (const std::exception &e)
+		{
+			LOGE("Resource cache warmup failed: {}", e.what());
+		}
+
+		warmup_future = {};
+	}
+}
+
 std::vector<uint8_t> ResourceCache::serialize()
 {
 	return recorder.get_data();
@@ -55,59 +178,626 @@ std::vector<uint8_t> ResourceCache::serialize()
 void ResourceCache::set_pipeline_cache(VkPipelineCache new_pipeline_cache)
 {
 	pipeline_cache = new_pipeline_cache;
+	worker_pipeline_caches.clear();
+}
+
+void ResourceCache::set_worker_pipeline_caches(const std::vector<VkPipelineCache> &new_worker_pipeline_caches)
+{
+	worker_pipeline_caches = new_worker_pipeline_caches;
+}
+
+VkPipelineCache ResourceCache::get_thread_pipeline_cache() const
+{
+	size_t thread_index = JobSystem::get_thread_index();
+
+	if (thread_index > 0 && thread_index <= worker_pipeline_caches.size())
+	{
+		return worker_pipeline_caches[thread_index - 1];
+	}
+
+	return pipeline_cache;
 }
 
 ShaderModule &ResourceCache::request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant)
 {
 	std::string entry_point{"main"};
-	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
+
+	// Requests for modules of a reloaded source get the modules of its new version
+	if (shader_generation > 0)
+	{
+		std::unique_lock<std::mutex> guard(shader_hot_reload_mutex);
+
+		auto reloaded_it = reloaded_shader_sources.find(glsl_source.get_filename());
+		if (reloaded_it != reloaded_shader_sources.end() && reloaded_it->second.original_id == glsl_source.get_id())
+		{
+			// Reloaded sources are only replaced between frames
+			auto &reloaded_source = reloaded_it->second.source;
+			guard.unlock();
+
+			return request_resource(device, recorder, recorder_mutex, shader_module_mutex, lock_contention_count, index.shader_modules, state.shader_modules, stage, reloaded_source, entry_point, shader_variant);
+		}
+	}
+
+	return request_resource(device, recorder, recorder_mutex, shader_module_mutex, lock_contention_count, index.shader_modules, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
 }
 
 PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules)
 {
-	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
+	return request_resource(device, recorder, recorder_mutex, pipeline_layout_mutex, lock_contention_count, index.pipeline_layouts, state.pipeline_layouts, shader_modules);
 }
 
 DescriptorSetLayout &ResourceCache::request_descriptor_set_layout(const uint32_t                     set_index,
                                                                   const std::vector<ShaderModule *> &shader_modules,
                                                                   const std::vector<ShaderResource> &set_resources)
 {
-	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	return request_resource(device, recorder, recorder_mutex, descriptor_set_layout_mutex, lock_contention_count, index.descriptor_set_layouts, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
 }
 
 GraphicsPipeline &ResourceCache::request_graphics_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, graphics_pipeline_mutex, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	if (device.uses_graphics_pipeline_libraries())
+	{
+		return request_linked_graphics_pipeline(pipeline_state);
+	}
+
+	return request_resource(device, recorder, recorder_mutex, graphics_pipeline_mutex, lock_contention_count, index.graphics_pipelines, state.graphics_pipelines, get_thread_pipeline_cache(), pipeline_state);
+}
+
+void ResourceCache::set_pipeline_compile_mode(PipelineCompileMode mode, PipelineFallbackFunction fallback)
+{
+	pipeline_compile_mode = mode;
+	pipeline_fallback     = std::move(fallback);
+}
+
+PipelineCompileMode ResourceCache::get_pipeline_compile_mode() const
+{
+	return pipeline_compile_mode;
+}
+
+GraphicsPipeline *ResourceCache::request_graphics_pipeline_async(PipelineState &pipeline_state)
+{
+	std::size_t hash{0U};
+	hash_param(hash, pipeline_cache, pipeline_state);
+
+	if (GraphicsPipeline *res = index.graphics_pipelines.find(hash))
+	{
+		return res;
+	}
+
+	pipeline_compile_stall_count++;
+
+	std::lock_guard<std::mutex> guard(pipeline_compilation_mutex);
+
+	if (pipeline_compilations.count(hash) || failed_pipeline_compilations.count(hash))
+	{
+		return nullptr;
+	}
+
+	// The job waits for the lock until its handle is registered
+	auto compile = [this, hash, pipeline_state]() mutable {
+		bool failed = false;
+
+		try
+		{
+			request_graphics_pipeline(pipeline_state);
+		}
+		catch (const std::exception &e)
+		{
+			LOGE("Asynchronous pipeline compilation failed: {}", e.what());
+			failed = true;
+		}
+
+		std::lock_guard<std::mutex> guard(pipeline_compilation_mutex);
+
+		pipeline_compilations.erase(hash);
+
+		if (failed)
+		{
+			failed_pipeline_compilations.insert(hash);
+		}
+
+		pipeline_compile_queue_depth--;
+	};
+
+	pipeline_compile_queue_depth++;
+	pipeline_compilations.emplace(hash, JobSystem::get().submit(compile));
+
+	return nullptr;
+}
+
+GraphicsPipeline *ResourceCache::request_fallback_graphics_pipeline(PipelineState &pipeline_state)
+{
+	if (!pipeline_fallback)
+	{
+		return nullptr;
+	}
+
+	PipelineState fallback_state = pipeline_state;
+
+	if (!pipeline_fallback(fallback_state))
+	{
+		return nullptr;
+	}
+
+	return &request_graphics_pipeline(fallback_state);
+}
+
+void ResourceCache::wait_pipeline_compilations()
+{
+	std::vector<JobHandle> compilations;
+
+	{
+		std::lock_guard<std::mutex> guard(pipeline_compilation_mutex);
+
+		for (auto &compilation : pipeline_compilations)
+		{
+			compilations.push_back(compilation.second);
+		}
+	}
+
+	JobSystem::get().wait(compilations);
+}
+
+void ResourceCache::set_shader_hot_reload(bool enabled)
+{
+	if (!enabled)
+	{
+		wait_shader_poll();
+	}
+
+	shader_hot_reload = enabled;
+}
+
+bool ResourceCache::is_shader_hot_reload_enabled() const
+{
+	return shader_hot_reload;
+}
+
+void ResourceCache::update_shader_hot_reload()
+{
+	{
+		std::lock_guard<std::mutex> guard(shader_hot_reload_mutex);
+
+		if (!pending_shader_sources.empty())
+		{
+			for (auto &pending_source : pending_shader_sources)
+			{
+				LOGI("Reloaded shader \"{}\"", pending_source.first);
+				reloaded_shader_sources[pending_source.first] = std::move(pending_source.second);
+			}
+
+			pending_shader_sources.clear();
+			shader_generation++;
+		}
+	}
+
+	if (!shader_hot_reload || (shader_poll_job.is_valid() && !shader_poll_job.is_done()))
+	{
+		return;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	if (now - last_shader_poll < std::chrono::milliseconds(SHADER_POLL_INTERVAL_MS))
+	{
+		return;
+	}
+
+	last_shader_poll = now;
+	shader_poll_job  = JobSystem::get().submit([this]() { poll_shader_sources(); });
+}
+
+uint32_t ResourceCache::get_shader_generation() const
+{
+	return shader_generation;
+}
+
+void ResourceCache::poll_shader_sources()
+{
+	VKB_PROFILE_SCOPE("Poll shader sources");
+
+	// Modules are never removed while a poll is running, see wait_shader_poll()
+	std::unordered_map<std::string, std::vector<const ShaderModule *>> file_modules;
+
+	{
+		auto guard = common::lock_resource(shader_module_mutex, lock_contention_count);
+
+		for (auto &shader_module : state.shader_modules)
+		{
+			if (!shader_module.second.get_source_filename().empty())
+			{
+				file_modules[shader_module.second.get_source_filename()].push_back(&shader_module.second);
+			}
+		}
+	}
+
+	for (auto &file : file_modules)
+	{
+		auto &filename = file.first;
+
+		if (unwatched_shader_files.count(filename) > 0)
+		{
+			continue;
+		}
+
+		auto watched_it = watched_shader_files.find(filename);
+
+		try
+		{
+			uint64_t signature = hash_shader_file(filename);
+
+			if (watched_it == watched_shader_files.end())
+			{
+				ShaderSource source{filename};
+				watched_shader_files.emplace(filename, WatchedShaderFile{source.get_id(), source.get_id(), signature});
+				continue;
+			}
+
+			auto &watched = watched_it->second;
+			if (watched.signature == signature)
+			{
+				continue;
+			}
+
+			// A source which fails to compile is not tried again until it changes
+			watched.signature = signature;
+
+			ShaderSource source{filename};
+
+			// Variants are built once, the modules of the previous versions of the source share them
+			std::unordered_set<size_t> built_modules;
+
+			for (auto *shader_module : file.second)
+			{
+				if (shader_module->get_source_id() != watched.original_id && shader_module->get_source_id() != watched.current_id)
+				{
+					continue;
+				}
+
+				VkShaderStageFlagBits stage       = shader_module->get_stage();
+				std::string           entry_point = shader_module->get_entry_point();
+				auto                 &variant     = shader_module->get_shader_variant();
+
+				size_t key = 0;
+				hash_combine(key, static_cast<uint32_t>(stage));
+				hash_combine(key, entry_point);
+				hash_combine(key, variant.get_id());
+
+				if (built_modules.insert(key).second)
+				{
+					request_resource(device, recorder, recorder_mutex, shader_module_mutex, lock_contention_count, index.shader_modules, state.shader_modules, stage, source, entry_point, variant);
+				}
+			}
+
+			watched.current_id = source.get_id();
+
+			std::lock_guard<std::mutex> guard(shader_hot_reload_mutex);
+			pending_shader_sources[filename] = ReloadedShaderSource{watched.original_id, std::move(source)};
+		}
+		catch (const std::exception &e)
+		{
+			if (watched_it == watched_shader_files.end())
+			{
+				// Not loaded from a file, e.g. a source set by the application
+				unwatched_shader_files.insert(filename);
+			}
+			else
+			{
+				LOGE("Failed to reload shader \"{}\": {}", filename, e.what());
+			}
+		}
+	}
+}
+
+void ResourceCache::wait_shader_poll()
+{
+	if (shader_poll_job.is_valid())
+	{
+		JobSystem::get().wait(shader_poll_job);
+		shader_poll_job = {};
+	}
+}
+
+uint32_t ResourceCache::get_pipeline_compile_queue_depth() const
+{
+	return pipeline_compile_queue_depth;
+}
+
+uint32_t ResourceCache::take_pipeline_compile_stall_count()
+{
+	return pipeline_compile_stall_count.exchange(0);
+}
+
+GraphicsPipeline &ResourceCache::request_linked_graphics_pipeline(PipelineState &pipeline_state)
+{
+	// Hashed as request_resource does, so that recorded pipelines are found again on replay
+	std::size_t hash{0U};
+	hash_param(hash, pipeline_cache, pipeline_state);
+
+	if (GraphicsPipeline *res = index.graphics_pipelines.find(hash))
+	{
+		return *res;
+	}
+
+	std::vector<VkPipeline> libraries;
+
+	const auto &shader_modules = pipeline_state.get_pipeline_layout().get_shader_modules();
+
+	bool mesh_shading = std::any_of(shader_modules.begin(), shader_modules.end(), [](const ShaderModule *shader_module) {
+		return shader_module->get_stage() == VK_SHADER_STAGE_MESH_BIT_EXT;
+	});
+
+	for (auto library_part : {VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+	                          VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+	                          VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+	                          VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT})
+	{
+		// Mesh shading pipelines are linked without a vertex input interface
+		if (mesh_shading && library_part == VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT)
+		{
+			continue;
+		}
+
+		libraries.push_back(request_graphics_pipeline_library(pipeline_state, library_part).get_handle());
+	}
+
+	LOGD("Linking cache object ({})", typeid(GraphicsPipeline).name());
+
+	GraphicsPipeline pipeline(device, get_thread_pipeline_cache(), pipeline_state, libraries, false);
+
+	auto guard = common::lock_resource(graphics_pipeline_mutex, lock_contention_count);
+
+	auto res_ins_it = state.graphics_pipelines.emplace(hash, std::move(pipeline));
+
+	if (res_ins_it.second)
+	{
+		index.graphics_pipelines.insert(hash, &res_ins_it.first->second);
+
+		{
+			std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+
+			RecordHelper<GraphicsPipeline, VkPipelineCache, PipelineState> record_helper;
+
+			size_t record_index = record_helper.record(recorder, pipeline_cache, pipeline_state);
+			record_helper.index(recorder, record_index, res_ins_it.first->second);
+		}
+
+		if (!pipeline_optimization_thread_pool)
+		{
+			pipeline_optimization_thread_pool = std::make_unique<ctpl::thread_pool>(1);
+		}
+
+		auto optimize = [this, hash, pipeline_state, libraries](size_t) mutable {
+			GraphicsPipeline optimized_pipeline(device, pipeline_cache, pipeline_state, libraries, true);
+
+			std::lock_guard<std::mutex> optimized_guard(optimized_pipeline_mutex);
+			optimized_pipelines.emplace_back(hash, std::move(optimized_pipeline));
+		};
+
+		std::lock_guard<std::mutex> optimized_guard(optimized_pipeline_mutex);
+		pipeline_optimizations.push_back(pipeline_optimization_thread_pool->push(optimize));
+	}
+
+	return res_ins_it.first->second;
+}
+
+GraphicsPipelineLibrary &ResourceCache::request_graphics_pipeline_library(PipelineState &pipeline_state, VkGraphicsPipelineLibraryFlagBitsEXT library_part)
+{
+	std::size_t hash = pipeline_state.get_library_hash(library_part);
+
+	if (GraphicsPipelineLibrary *res = index.graphics_pipeline_libraries.find(hash))
+	{
+		return *res;
+	}
+
+	LOGD("Building cache object ({})", typeid(GraphicsPipelineLibrary).name());
+
+	GraphicsPipelineLibrary library(device, get_thread_pipeline_cache(), pipeline_state, library_part);
+
+	auto guard = common::lock_resource(graphics_pipeline_library_mutex, lock_contention_count);
+
+	auto res_ins_it = state.graphics_pipeline_libraries.emplace(hash, std::move(library));
+
+	if (res_ins_it.second)
+	{
+		index.graphics_pipeline_libraries.insert(hash, &res_ins_it.first->second);
+	}
+
+	return res_ins_it.first->second;
 }
 
 ComputePipeline &ResourceCache::request_compute_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, compute_pipeline_mutex, state.compute_pipelines, pipeline_cache, pipeline_state);
+	return request_resource(device, recorder, recorder_mutex, compute_pipeline_mutex, lock_contention_count, index.compute_pipelines, state.compute_pipelines, get_thread_pipeline_cache(), pipeline_state);
+}
+
+ShaderObject &ResourceCache::request_shader_object(const PipelineLayout              &pipeline_layout,
+                                                   const ShaderModule                &shader_module,
+                                                   const SpecializationConstantState &specialization_constant_state)
+{
+	std::size_t hash{0U};
+	hash_combine(hash, pipeline_layout.get_handle());
+	hash_combine(hash, shader_module.get_id());
+	hash_combine(hash, specialization_constant_state);
+
+	if (ShaderObject *res = index.shader_objects.find(hash))
+	{
+		return *res;
+	}
+
+	LOGD("Building cache object ({})", typeid(ShaderObject).name());
+
+	ShaderObject shader_object(device, pipeline_layout, shader_module, specialization_constant_state);
+
+	auto guard = common::lock_resource(shader_object_mutex, lock_contention_count);
+
+	auto res_ins_it = state.shader_objects.emplace(hash, std::move(shader_object));
+
+	if (res_ins_it.second)
+	{
+		index.shader_objects.insert(hash, &res_ins_it.first->second);
+	}
+
+	return res_ins_it.first->second;
 }
 
 DescriptorSet &ResourceCache::request_descriptor_set(DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos)
 {
-	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, state.descriptor_pools, descriptor_set_layout);
-	return request_resource(device, recorder, descriptor_set_mutex, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, lock_contention_count, index.descriptor_pools, state.descriptor_pools, descriptor_set_layout);
+	return request_resource(device, recorder, descriptor_set_mutex, lock_contention_count, index.descriptor_sets, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
 }
 
 RenderPass &ResourceCache::request_render_pass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses)
 {
-	return request_resource(device, recorder, render_pass_mutex, state.render_passes, attachments, load_store_infos, subpasses);
+	return request_resource(device, recorder, recorder_mutex, render_pass_mutex, lock_contention_count, index.render_passes, state.render_passes, attachments, load_store_infos, subpasses);
 }
 
 Framebuffer &ResourceCache::request_framebuffer(const RenderTarget &render_target, const RenderPass &render_pass)
 {
-	return request_resource(device, recorder, framebuffer_mutex, state.framebuffers, render_target, render_pass);
+	return request_resource(device, recorder, framebuffer_mutex, lock_contention_count, index.framebuffers, state.framebuffers, render_target, render_pass);
+}
+
+core::Sampler &ResourceCache::request_sampler(const VkSamplerCreateInfo &info)
+{
+	return request_resource(device, recorder, sampler_mutex, lock_contention_count, index.samplers, state.samplers, info);
+}
+
+core::ImageView &ResourceCache::request_image_view(core::Image &image, VkImageViewType view_type, VkFormat format,
+                                                   uint32_t base_mip_level, uint32_t base_array_layer,
+                                                   uint32_t n_mip_levels, uint32_t n_array_layers,
+                                                   const VkComponentMapping &components)
+{
+	// Resolved as ImageView does, so that requests relying on the defaults share the views of explicit ones
+	if (format == VK_FORMAT_UNDEFINED)
+	{
+		format = image.get_format();
+	}
+	if (n_mip_levels == 0)
+	{
+		n_mip_levels = image.get_subresource().mipLevel;
+	}
+	if (n_array_layers == 0)
+	{
+		n_array_layers = image.get_subresource().arrayLayer;
+	}
+
+	std::size_t hash{0U};
+	hash_param(hash, static_cast<std::underlying_type<VkImageViewType>::type>(view_type), static_cast<std::underlying_type<VkFormat>::type>(format),
+	           base_mip_level, base_array_layer, n_mip_levels, n_array_layers, components);
+
+	auto guard = common::lock_resource(image_view_mutex, lock_contention_count);
+
+	auto &shared_views = image.get_shared_views();
+
+	auto view_it = shared_views.find(hash);
+
+	if (view_it == shared_views.end())
+	{
+		view_it = shared_views.emplace(hash, std::make_unique<core::ImageView>(image, view_type, format, base_mip_level, base_array_layer, n_mip_levels, n_array_layers, components)).first;
+	}
+
+	return *view_it->second;
+}
+
+void ResourceCache::update_optimized_pipelines()
+{
+	std::vector<std::pair<std::size_t, GraphicsPipeline>> ready_pipelines;
+
+	{
+		std::lock_guard<std::mutex> optimized_guard(optimized_pipeline_mutex);
+
+		if (pipeline_optimizations.empty() && optimized_pipelines.empty())
+		{
+			return;
+		}
+
+		ready_pipelines.swap(optimized_pipelines);
+
+		// Surface the errors of finished compilations, the linked pipelines remain in use for those
+		auto is_ready = [](std::future<void> &optimization) {
+			if (optimization.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				return false;
+			}
+
+			try
+			{
+				optimization.get();
+			}
+			catch (const std::exception &e)
+			{
+				LOGE("Optimized pipeline compilation failed: {}", e.what());
+			}
+
+			return true;
+		};
+
+		pipeline_optimizations.erase(std::remove_if(pipeline_optimizations.begin(), pipeline_optimizations.end(), is_ready), pipeline_optimizations.end());
+	}
+
+	for (auto &ready_pipeline : ready_pipelines)
+	{
+		if (GraphicsPipeline *pipeline = index.graphics_pipelines.find(ready_pipeline.first))
+		{
+			pipeline->replace_handle(std::move(ready_pipeline.second));
+		}
+	}
+}
+
+void ResourceCache::wait_optimized_pipelines()
+{
+	std::vector<std::future<void>> optimizations;
+
+	{
+		std::lock_guard<std::mutex> optimized_guard(optimized_pipeline_mutex);
+		optimizations.swap(pipeline_optimizations);
+	}
+
+	for (auto &optimization : optimizations)
+	{
+		try
+		{
+			optimization.get();
+		}
+		catch (const std::exception &e)
+		{
+			LOGE("Optimized pipeline compilation failed: {}", e.what());
+		}
+	}
 }
 
 void ResourceCache::clear_pipelines()
 {
+	wait_pipeline_compilations();
+	wait_optimized_pipelines();
+
+	failed_pipeline_compilations.clear();
+
+	optimized_pipelines.clear();
+
+	index.graphics_pipelines.clear();
+	index.graphics_pipeline_libraries.clear();
+	index.compute_pipelines.clear();
+	index.shader_objects.clear();
 	state.graphics_pipelines.clear();
+	state.graphics_pipeline_libraries.clear();
 	state.compute_pipelines.clear();
+	state.shader_objects.clear();
 }
 
 void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &old_views, const std::vector<core::ImageView> &new_views)
+{
+	std::vector<VkImageView> old_handles;
+	std::vector<VkImageView> new_handles;
+	for (size_t i = 0; i < old_views.size(); ++i)
+	{
+		old_handles.push_back(old_views[i].get_handle());
+		new_handles.push_back(new_views[i].get_handle());
+	}
+
+	update_descriptor_sets(old_handles, new_handles);
+}
+
+void ResourceCache::update_descriptor_sets(const std::vector<VkImageView> &old_views, const std::vector<VkImageView> &new_views)
 {
 	// Find descriptor sets referring to the old image view
 	std::vector<VkWriteDescriptorSet> set_updates;
@@ -115,8 +805,8 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 
 	for (size_t i = 0; i < old_views.size(); ++i)
 	{
-		auto &old_view = old_views[i];
-		auto &new_view = new_views[i];
+		VkImageView old_view = old_views[i];
+		VkImageView new_view = new_views[i];
 
 		for (auto &kd_pair : state.descriptor_sets)
 		{
@@ -135,13 +825,13 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 					auto &array_element = ai_pair.first;
 					auto &image_info    = ai_pair.second;
 
-					if (image_info.imageView == old_view.get_handle())
+					if (image_info.imageView == old_view)
 					{
 						// Save key to remove old descriptor set
 						matches.insert(key);
 
 						// Update image info with new view
-						image_info.imageView = new_view.get_handle();
+						image_info.imageView = new_view;
 
 						// Save struct for writing the update later
 						{
@@ -190,20 +880,173 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 		// Add (key, resource) to the cache
 		state.descriptor_sets.emplace(new_key, std::move(descriptor_set));
 	}
+
+	// Moved descriptor sets live at new addresses, so the lookup index has to be rebuilt
+	if (!matches.empty())
+	{
+		index.descriptor_sets.clear();
+		for (auto &kd_pair : state.descriptor_sets)
+		{
+			index.descriptor_sets.insert(kd_pair.first, &kd_pair.second);
+		}
+	}
 }
 
 void ResourceCache::clear_framebuffers()
 {
+	index.framebuffers.clear();
 	state.framebuffers.clear();
 }
 
+void ResourceCache::clear_descriptor_sets()
+{
+	index.descriptor_sets.clear();
+	state.descriptor_sets.clear();
+}
+
+void ResourceCache::evict_framebuffers(const std::vector<core::ImageView> &image_views)
+{
+	std::unordered_set<VkImageView> evicted_views;
+	for (auto &image_view : image_views)
+	{
+		evicted_views.insert(image_view.get_handle());
+	}
+
+	std::lock_guard<std::mutex> guard(framebuffer_mutex);
+
+	size_t framebuffer_count = state.framebuffers.size();
+
+	for (auto it = state.framebuffers.begin(); it != state.framebuffers.end();)
+	{
+		auto &attachments = it->second.get_attachments();
+
+		if (std::none_of(attachments.begin(), attachments.end(), [&evicted_views](VkImageView attachment) { return evicted_views.count(attachment) > 0; }))
+		{
+			++it;
+			continue;
+		}
+
+		// The render pass was in use during this generation
+		render_pass_generations[it->second.get_render_pass()] = generation;
+
+		it = state.framebuffers.erase(it);
+	}
+
+	if (state.framebuffers.size() != framebuffer_count)
+	{
+		common::rebuild_index(index.framebuffers, state.framebuffers);
+	}
+}
+
+void ResourceCache::next_generation()
+{
+	// Background work may hold pointers to render passes
+	wait_warmup();
+	wait_pipeline_compilations();
+	wait_optimized_pipelines();
+
+	for (auto &framebuffer : state.framebuffers)
+	{
+		render_pass_generations[framebuffer.second.get_render_pass()] = generation;
+	}
+
+	std::unordered_set<const RenderPass *> evicted_render_passes;
+
+	for (auto &render_pass : state.render_passes)
+	{
+		// Render passes seen for the first time start their unused generations now
+		auto generation_it = render_pass_generations.emplace(render_pass.second.get_handle(), generation).first;
+
+		if (generation - generation_it->second >= MAX_UNUSED_RENDER_PASS_GENERATIONS)
+		{
+			evicted_render_passes.insert(&render_pass.second);
+			render_pass_generations.erase(generation_it);
+		}
+	}
+
+	generation++;
+
+	if (evicted_render_passes.empty())
+	{
+		return;
+	}
+
+	// Pipelines are hashed on render pass handles, which a new render pass may reuse
+	auto uses_evicted_render_pass = [&evicted_render_passes](const Pipeline &pipeline) {
+		return evicted_render_passes.count(pipeline.get_state().get_render_pass()) > 0;
+	};
+
+	// The frames in flight may still use the evicted objects, so they are retired instead of destroyed
+	auto &retire_queue = device.get_retire_queue();
+
+	auto retire_if = [&retire_queue](auto &resources, auto &&predicate) {
+		for (auto it = resources.begin(); it != resources.end();)
+		{
+			if (predicate(it->second))
+			{
+				retire_queue.retire(std::move(it->second));
+				it = resources.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	};
+
+	retire_if(state.graphics_pipelines, uses_evicted_render_pass);
+	retire_if(state.graphics_pipeline_libraries, uses_evicted_render_pass);
+
+	// Pipelines can't be move assigned, so the kept optimized pipelines are moved to a new vector
+	std::vector<std::pair<std::size_t, GraphicsPipeline>> kept_optimized_pipelines;
+	kept_optimized_pipelines.reserve(optimized_pipelines.size());
+	for (auto &optimized_pipeline : optimized_pipelines)
+	{
+		if (uses_evicted_render_pass(optimized_pipeline.second))
+		{
+			retire_queue.retire(std::move(optimized_pipeline.second));
+		}
+		else
+		{
+			kept_optimized_pipelines.emplace_back(optimized_pipeline.first, std::move(optimized_pipeline.second));
+		}
+	}
+	optimized_pipelines.swap(kept_optimized_pipelines);
+
+	// Retired after the pipelines created with them
+	retire_if(state.render_passes, [&evicted_render_passes](const RenderPass &render_pass) {
+		return evicted_render_passes.count(&render_pass) > 0;
+	});
+
+	common::rebuild_index(index.graphics_pipelines, state.graphics_pipelines);
+	common::rebuild_index(index.graphics_pipeline_libraries, state.graphics_pipeline_libraries);
+	common::rebuild_index(index.render_passes, state.render_passes);
+
+	LOGD("Evicted {} render passes unused for {} generations", evicted_render_passes.size(), MAX_UNUSED_RENDER_PASS_GENERATIONS);
+}
+
 void ResourceCache::clear()
 {
+	wait_shader_poll();
+	wait_warmup();
+	wait_pipeline_compilations();
+	wait_optimized_pipelines();
+
+	index.shader_modules.clear();
+	index.pipeline_layouts.clear();
+	index.descriptor_sets.clear();
+	index.descriptor_pools.clear();
+	index.descriptor_set_layouts.clear();
+	index.render_passes.clear();
 	state.shader_modules.clear();
 	state.pipeline_layouts.clear();
 	state.descriptor_sets.clear();
+	state.descriptor_pools.clear();
 	state.descriptor_set_layouts.clear();
 	state.render_passes.clear();
+	index.samplers.clear();
+	state.samplers.clear();
+	render_pass_generations.clear();
 	clear_pipelines();
 	clear_framebuffers();
 }
@@ -212,4 +1055,9 @@ const ResourceCacheState &ResourceCache::get_internal_state() const
 {
 	return state;
 }
+
+uint32_t ResourceCache::get_lock_contention_count() const
+{
+	return lock_contention_count;
+}
 }        // namespace vkb
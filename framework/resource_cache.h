@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,8 +17,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "common/helpers.h"
@@ -27,15 +33,34 @@
 #include "core/descriptor_set_layout.h"
 #include "core/framebuffer.h"
 #include "core/pipeline.h"
+#include "core/sampler.h"
+#include "core/shader_object.h"
 #include "resource_record.h"
 #include "resource_replay.h"
 
+#include "core/util/job_system.hpp"
+#include "core/util/read_mostly_map.hpp"
+
 namespace vkb
 {
 class Device;
+class HPPResourceCache;
+
+/**
+ * @brief How graphics pipelines missing from the cache are created when command buffers flush their state
+ */
+enum class PipelineCompileMode
+{
+	/// Created on the recording thread, which waits for it
+	Inline,
+
+	/// Compiled on the job system, draws use a fallback pipeline or are skipped until it is ready
+	Async
+};
 
 namespace core
 {
+class Image;
 class ImageView;
 }
 
@@ -57,11 +82,47 @@ struct ResourceCacheState
 
 	std::unordered_map<std::size_t, GraphicsPipeline> graphics_pipelines;
 
+	std::unordered_map<std::size_t, GraphicsPipelineLibrary> graphics_pipeline_libraries;
+
 	std::unordered_map<std::size_t, ComputePipeline> compute_pipelines;
 
+	std::unordered_map<std::size_t, ShaderObject> shader_objects;
+
 	std::unordered_map<std::size_t, DescriptorSet> descriptor_sets;
 
 	std::unordered_map<std::size_t, Framebuffer> framebuffers;
+
+	std::unordered_map<std::size_t, core::Sampler> samplers;
+};
+
+/**
+ * @brief Lock-free lookup indices into the maps of ResourceCacheState, so that cache hits never take a lock
+ */
+struct ResourceCacheIndex
+{
+	ReadMostlyMap<ShaderModule> shader_modules;
+
+	ReadMostlyMap<PipelineLayout> pipeline_layouts;
+
+	ReadMostlyMap<DescriptorSetLayout> descriptor_set_layouts;
+
+	ReadMostlyMap<DescriptorPool> descriptor_pools;
+
+	ReadMostlyMap<RenderPass> render_passes;
+
+	ReadMostlyMap<GraphicsPipeline> graphics_pipelines;
+
+	ReadMostlyMap<GraphicsPipelineLibrary> graphics_pipeline_libraries;
+
+	ReadMostlyMap<ComputePipeline> compute_pipelines;
+
+	ReadMostlyMap<ShaderObject> shader_objects;
+
+	ReadMostlyMap<DescriptorSet> descriptor_sets;
+
+	ReadMostlyMap<Framebuffer> framebuffers;
+
+	ReadMostlyMap<core::Sampler> samplers;
 };
 
 /**
@@ -75,10 +136,23 @@ struct ResourceCacheState
  * the cache on app startup by creating all necessary objects.
  * The cache holds pointers to objects and has a mapping from such pointers to hashes.
  * It can only be destroyed in bulk, single elements cannot be removed.
+ *
+ * Lookups of existing objects are lock-free. The per-type mutexes are only taken when an
+ * object has to be inserted, and contention on them is counted for the Stats overlay.
+ *
+ * If the device uses graphics pipeline libraries, graphics pipelines are linked from libraries cached
+ * per part of the pipeline state, which is fast. Optimized pipelines are then compiled in the background,
+ * and take over from the linked ones in update_optimized_pipelines().
  */
 class ResourceCache
 {
   public:
+	/// Number of generations a render pass without framebuffers stays in the cache
+	static constexpr uint64_t MAX_UNUSED_RENDER_PASS_GENERATIONS = 2;
+
+	/// Minimum time between two polls of the shader source files, see set_shader_hot_reload()
+	static constexpr uint32_t SHADER_POLL_INTERVAL_MS = 500;
+
 	ResourceCache(Device &device);
 
 	ResourceCache(const ResourceCache &) = delete;
@@ -89,12 +163,39 @@ class ResourceCache
 
 	ResourceCache &operator=(ResourceCache &&) = delete;
 
+	~ResourceCache();
+
 	void warmup(const std::vector<uint8_t> &data);
 
+	/**
+	 * @brief Warms up the cache in the background, building independent objects in parallel
+	 *        The cache can be used while the warmup is running, see ResourceReplay::play_parallel
+	 * @param data The serialized resource record
+	 * @param thread_count The number of worker threads, 0 uses the hardware concurrency
+	 * @param progress_callback Optional callback, invoked from the worker threads after each created object
+	 * @return A future which becomes ready once every recorded object has been created
+	 */
+	std::shared_future<void> warmup_async(const std::vector<uint8_t> &data, uint32_t thread_count = 0, ResourceReplay::ProgressCallback progress_callback = {});
+
+	/**
+	 * @brief Blocks until a pending warmup_async has finished
+	 */
+	void wait_warmup();
+
 	std::vector<uint8_t> serialize();
 
+	/**
+	 * @brief Sets the pipeline cache pipelines are created with, and drops the worker pipeline caches
+	 */
 	void set_pipeline_cache(VkPipelineCache pipeline_cache);
 
+	/**
+	 * @brief Sets the pipeline caches used instead of the main one by pipelines created on JobSystem workers
+	 *        The cache of a worker is indexed by JobSystem::get_thread_index() - 1, workers without one use the main cache.
+	 *        Must be called after set_pipeline_cache(), while no pipelines are being requested.
+	 */
+	void set_worker_pipeline_caches(const std::vector<VkPipelineCache> &worker_pipeline_caches);
+
 	ShaderModule &request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant = {});
 
 	PipelineLayout &request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules);
@@ -105,8 +206,45 @@ class ResourceCache
 
 	GraphicsPipeline &request_graphics_pipeline(PipelineState &pipeline_state);
 
+	/**
+	 * @brief Modifies a copy of a pipeline state into the one of its fallback, e.g. by setting the pipeline layout of a simpler shader variant
+	 *        The fallback must be compatible with the descriptor sets and push constants of the original state.
+	 * @return False if draws should be skipped instead
+	 */
+	using PipelineFallbackFunction = std::function<bool(PipelineState &)>;
+
+	/**
+	 * @brief Sets how command buffers get graphics pipelines missing from the cache
+	 * @param fallback Used in PipelineCompileMode::Async, draws are skipped while their pipeline compiles if empty
+	 */
+	void set_pipeline_compile_mode(PipelineCompileMode mode, PipelineFallbackFunction fallback = {});
+
+	PipelineCompileMode get_pipeline_compile_mode() const;
+
+	/**
+	 * @brief Looks up a graphics pipeline without waiting for it to be created
+	 *        A missing pipeline is compiled on the job system, and returned by later requests once it is ready.
+	 * @return The pipeline, or nullptr while it is being compiled
+	 */
+	GraphicsPipeline *request_graphics_pipeline_async(PipelineState &pipeline_state);
+
+	/**
+	 * @brief Requests the fallback of a pipeline state which is not compiled yet, see set_pipeline_compile_mode()
+	 *        Fallback pipelines are created inline, there should only be a few of them.
+	 * @return The fallback pipeline, or nullptr if the draw should be skipped
+	 */
+	GraphicsPipeline *request_fallback_graphics_pipeline(PipelineState &pipeline_state);
+
 	ComputePipeline &request_compute_pipeline(PipelineState &pipeline_state);
 
+	/**
+	 * @brief Requests the shader object of one of the shader modules of the pipeline layout
+	 *        Shader objects are not recorded, they are cheap to create compared to pipelines.
+	 */
+	ShaderObject &request_shader_object(const PipelineLayout              &pipeline_layout,
+	                                    const ShaderModule                &shader_module,
+	                                    const SpecializationConstantState &specialization_constant_state);
+
 	DescriptorSet &request_descriptor_set(DescriptorSetLayout &                     descriptor_set_layout,
 	                                      const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
 	                                      const BindingMap<VkDescriptorImageInfo> & image_infos);
@@ -118,6 +256,72 @@ class ResourceCache
 	Framebuffer &request_framebuffer(const RenderTarget &render_target,
 	                                 const RenderPass &  render_pass);
 
+	/**
+	 * @brief Requests a sampler shared by every request of the same create info, as drivers limit the number of samplers
+	 *        Samplers are not recorded, and live until the cache is cleared.
+	 * @param info Creation details, structures chained to pNext are not hashed so samplers needing them must not be shared
+	 */
+	core::Sampler &request_sampler(const VkSamplerCreateInfo &info);
+
+	/**
+	 * @brief Requests a view of an image shared by every request of the same parameters, see core::ImageView
+	 *        The views are owned by the image, and destroyed with it. Unlike other requests this one takes a lock.
+	 */
+	core::ImageView &request_image_view(core::Image &image, VkImageViewType view_type, VkFormat format = VK_FORMAT_UNDEFINED,
+	                                    uint32_t base_mip_level = 0, uint32_t base_array_layer = 0,
+	                                    uint32_t n_mip_levels = 0, uint32_t n_array_layers = 0,
+	                                    const VkComponentMapping &components = {});
+
+	/**
+	 * @brief Swaps in the optimized graphics pipelines compiled in the background since the last call
+	 *        The render context calls this when beginning a frame, it must not be called while command buffers are being recorded.
+	 */
+	void update_optimized_pipelines();
+
+	/**
+	 * @brief Blocks until the pending background compilations of optimized graphics pipelines have finished
+	 */
+	void wait_optimized_pipelines();
+
+	/**
+	 * @brief Blocks until the pending asynchronous compilations of graphics pipelines have finished
+	 */
+	void wait_pipeline_compilations();
+
+	/**
+	 * @brief Enables or disables hot reloading of the GLSL sources of the shader modules, disabled by default
+	 *        While enabled, the source files of the cached shader modules, and the files they include, are polled on the
+	 *        job system. The modules of a changed file are compiled again on a worker with the new source, and the
+	 *        new source is swapped in by update_shader_hot_reload(). Modules of a source which fails to compile are kept.
+	 */
+	void set_shader_hot_reload(bool enabled);
+
+	bool is_shader_hot_reload_enabled() const;
+
+	/**
+	 * @brief Swaps in the shader sources compiled again since the last call, and starts polling the source files if due
+	 *        Requests for modules of a reloaded source then get the modules of the new source, so only the pipeline layouts
+	 *        and pipelines using them are built again, the previous ones stay in the cache until it is cleared.
+	 *        The render context calls this when beginning a frame, it must not be called while command buffers are being recorded.
+	 */
+	void update_shader_hot_reload();
+
+	/**
+	 * @brief Incremented by update_shader_hot_reload() when it swaps in sources, so that objects caching shader modules
+	 *        or pipeline layouts know when to request them again
+	 */
+	uint32_t get_shader_generation() const;
+
+	/**
+	 * @brief Number of graphics pipelines queued or being compiled asynchronously
+	 */
+	uint32_t get_pipeline_compile_queue_depth() const;
+
+	/**
+	 * @brief Number of requests which could not use their pipeline as it was not compiled yet, since the last call
+	 */
+	uint32_t take_pipeline_compile_stall_count();
+
 	void clear_pipelines();
 
 	/// @brief Update those descriptor sets referring to old views
@@ -125,13 +329,90 @@ class ResourceCache
 	/// @param new_views New image views to be referred
 	void update_descriptor_sets(const std::vector<core::ImageView> &old_views, const std::vector<core::ImageView> &new_views);
 
+	/// @brief Update those descriptor sets referring to old image view handles, like the views of images moved by MemoryDefragmenter
+	/// @param old_views Old image view handles referred by descriptor sets
+	/// @param new_views New image view handles to be referred
+	void update_descriptor_sets(const std::vector<VkImageView> &old_views, const std::vector<VkImageView> &new_views);
+
 	void clear_framebuffers();
 
+	/**
+	 * @brief Destroys the descriptor sets, which refer to the buffers and image views of the sample using the device
+	 *        Samples handing their device over to the next one call this, see DeviceHandover.
+	 */
+	void clear_descriptor_sets();
+
+	/**
+	 * @brief Destroys the framebuffers referencing any of the image views, which are about to be destroyed
+	 *        Render targets call this on destruction, it must not be called while command buffers are being recorded.
+	 */
+	void evict_framebuffers(const std::vector<core::ImageView> &image_views);
+
+	/**
+	 * @brief Starts a new generation of the cache, evicting the render passes which no framebuffer used
+	 *        during the last MAX_UNUSED_RENDER_PASS_GENERATIONS generations, along with their graphics pipelines
+	 *        The render context calls this when it recreates the swapchain, once the new render targets exist.
+	 */
+	void next_generation();
+
 	void clear();
 
 	const ResourceCacheState &get_internal_state() const;
 
+	/**
+	 * @brief Number of times a request had to wait for another thread holding a resource lock
+	 */
+	uint32_t get_lock_contention_count() const;
+
   private:
+	/// Mirrors the members of this class, so it needs the shader hot reload types
+	friend class HPPResourceCache;
+
+	GraphicsPipeline &request_linked_graphics_pipeline(PipelineState &pipeline_state);
+
+	GraphicsPipelineLibrary &request_graphics_pipeline_library(PipelineState &pipeline_state, VkGraphicsPipelineLibraryFlagBitsEXT library_part);
+
+	/**
+	 * @brief The pipeline cache of the calling thread, see set_worker_pipeline_caches()
+	 */
+	VkPipelineCache get_thread_pipeline_cache() const;
+
+	/**
+	 * @brief Compiles the modules of the watched source files which changed since they were last compiled, see set_shader_hot_reload()
+	 *        Runs on the job system, one poll at a time.
+	 */
+	void poll_shader_sources();
+
+	/**
+	 * @brief Blocks until a pending poll of the shader source files has finished
+	 */
+	void wait_shader_poll();
+
+	/**
+	 * @brief A source file of shader modules, polled while hot reload is enabled
+	 */
+	struct WatchedShaderFile
+	{
+		/// Id of the source loaded from the file when it started being watched, the modules of other sources with the same file name are left alone
+		size_t original_id{0};
+
+		/// Id of the source the modules were last compiled from
+		size_t current_id{0};
+
+		/// Hash of the contents of the file and of the files it includes, when they were last compiled
+		uint64_t signature{0};
+	};
+
+	/**
+	 * @brief A source compiled again by poll_shader_sources()
+	 */
+	struct ReloadedShaderSource
+	{
+		size_t original_id{0};
+
+		ShaderSource source;
+	};
+
 	Device &device;
 
 	ResourceRecord recorder;
@@ -140,8 +421,75 @@ class ResourceCache
 
 	VkPipelineCache pipeline_cache{VK_NULL_HANDLE};
 
+	std::vector<VkPipelineCache> worker_pipeline_caches;
+
 	ResourceCacheState state;
 
+	ResourceCacheIndex index;
+
+	std::atomic<uint32_t> lock_contention_count{0};
+
+	/// Incremented by next_generation()
+	uint64_t generation{0};
+
+	/// Last generation in which a framebuffer used each render pass
+	std::unordered_map<VkRenderPass, uint64_t> render_pass_generations;
+
+	std::unique_ptr<ctpl::thread_pool> warmup_thread_pool;
+
+	std::shared_future<void> warmup_future;
+
+	/// Compiles the optimized graphics pipelines, on a single thread to leave the others to the application
+	std::unique_ptr<ctpl::thread_pool> pipeline_optimization_thread_pool;
+
+	std::vector<std::future<void>> pipeline_optimizations;
+
+	/// Optimized graphics pipelines waiting to be swapped in, by hash
+	std::vector<std::pair<std::size_t, GraphicsPipeline>> optimized_pipelines;
+
+	std::mutex optimized_pipeline_mutex;
+
+	PipelineCompileMode pipeline_compile_mode{PipelineCompileMode::Inline};
+
+	PipelineFallbackFunction pipeline_fallback;
+
+	/// Asynchronous compilations in flight, by pipeline hash
+	std::unordered_map<std::size_t, JobHandle> pipeline_compilations;
+
+	/// Pipelines which failed to compile asynchronously, they keep using their fallback
+	std::unordered_set<std::size_t> failed_pipeline_compilations;
+
+	std::mutex pipeline_compilation_mutex;
+
+	std::atomic<uint32_t> pipeline_compile_queue_depth{0};
+
+	std::atomic<uint32_t> pipeline_compile_stall_count{0};
+
+	std::atomic<bool> shader_hot_reload{false};
+
+	std::atomic<uint32_t> shader_generation{0};
+
+	/// Only accessed by poll_shader_sources(), by file name
+	std::unordered_map<std::string, WatchedShaderFile> watched_shader_files;
+
+	/// Only accessed by poll_shader_sources(), files of sources which could not be read, e.g. sources set by the application
+	std::unordered_set<std::string> unwatched_shader_files;
+
+	/// Compiled by poll_shader_sources(), waiting to be swapped in, by file name
+	std::unordered_map<std::string, ReloadedShaderSource> pending_shader_sources;
+
+	/// Sources requests are redirected to, by file name
+	std::unordered_map<std::string, ReloadedShaderSource> reloaded_shader_sources;
+
+	/// Guards pending_shader_sources and reloaded_shader_sources
+	std::mutex shader_hot_reload_mutex;
+
+	JobHandle shader_poll_job;
+
+	std::chrono::steady_clock::time_point last_shader_poll;
+
+	std::mutex recorder_mutex;
+
 	std::mutex descriptor_set_mutex;
 
 	std::mutex pipeline_layout_mutex;
@@ -152,10 +500,19 @@ class ResourceCache
 
 	std::mutex graphics_pipeline_mutex;
 
+	std::mutex graphics_pipeline_library_mutex;
+
 	std::mutex render_pass_mutex;
 
 	std::mutex compute_pipeline_mutex;
 
+	std::mutex shader_object_mutex;
+
 	std::mutex framebuffer_mutex;
+
+	std::mutex sampler_mutex;
+
+	/// Guards the shared views of all images
+	std::mutex image_view_mutex;
 };
 }        // namespace vkb
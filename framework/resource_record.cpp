@@ -106,11 +106,17 @@ size_t ResourceRecord::register_render_pass(const std::vector<Attachment> &attac
 
 size_t ResourceRecord::register_graphics_pipeline(VkPipelineCache /*pipeline_cache*/, PipelineState &pipeline_state)
 {
-	graphics_pipeline_indices.push_back(graphics_pipeline_indices.size());
-
 	auto &pipeline_layout = pipeline_state.get_pipeline_layout();
 	auto  render_pass     = pipeline_state.get_render_pass();
 
+	// Pipelines of dynamic rendering passes are not recorded, the replay only builds pipelines for render passes
+	if (!render_pass)
+	{
+		return graphics_pipeline_indices.size();
+	}
+
+	graphics_pipeline_indices.push_back(graphics_pipeline_indices.size());
+
 	write(stream,
 	      ResourceType::GraphicsPipeline,
 	      pipeline_layout_to_index.at(&pipeline_layout),
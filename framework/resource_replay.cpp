@@ -22,6 +22,11 @@
 #include "rendering/pipeline_state.h"
 #include "resource_cache.h"
 
+#include <atomic>
+#include <future>
+
+#include <ctpl_stl.h>
+
 namespace vkb
 {
 namespace
@@ -89,132 +94,277 @@ void ResourceReplay::play(ResourceCache &resource_cache, ResourceRecord &recorde
 	}
 }
 
+void ResourceReplay::play_parallel(ResourceCache &resource_cache, const std::vector<uint8_t> &data, ctpl::thread_pool &thread_pool, const ProgressCallback &progress_callback)
+{
+	std::istringstream stream{std::string{data.begin(), data.end()}};
+
+	std::vector<ShaderModuleInfo>     shader_module_infos;
+	std::vector<PipelineLayoutInfo>   pipeline_layout_infos;
+	std::vector<RenderPassInfo>       render_pass_infos;
+	std::vector<GraphicsPipelineInfo> graphics_pipeline_infos;
+
+	// Parse the whole stream up front, so that objects can be grouped by dependency
+	while (true)
+	{
+		ResourceType resource_type;
+		read(stream, resource_type);
+
+		if (stream.eof())
+		{
+			break;
+		}
+
+		switch (resource_type)
+		{
+			case ResourceType::ShaderModule:
+				shader_module_infos.push_back(read_shader_module(stream));
+				break;
+			case ResourceType::PipelineLayout:
+				pipeline_layout_infos.push_back(read_pipeline_layout(stream));
+				break;
+			case ResourceType::RenderPass:
+				render_pass_infos.push_back(read_render_pass(stream));
+				break;
+			case ResourceType::GraphicsPipeline:
+				graphics_pipeline_infos.push_back(read_graphics_pipeline(stream));
+				break;
+			default:
+				// The stream cannot be resynchronized after an unknown command
+				LOGE("Replay command not supported.");
+				return;
+		}
+	}
+
+	// Indices in the stream are relative to this replay only
+	shader_modules.clear();
+	pipeline_layouts.clear();
+	render_passes.clear();
+	graphics_pipelines.clear();
+
+	shader_modules.resize(shader_module_infos.size());
+	pipeline_layouts.resize(pipeline_layout_infos.size());
+	render_passes.resize(render_pass_infos.size());
+	graphics_pipelines.resize(graphics_pipeline_infos.size());
+
+	const size_t        total = shader_modules.size() + pipeline_layouts.size() + render_passes.size() + graphics_pipelines.size();
+	std::atomic<size_t> completed{0};
+
+	std::vector<std::future<void>> tasks;
+
+	auto schedule = [&](auto &&build) {
+		tasks.push_back(thread_pool.push([&, build](size_t) {
+			build();
+
+			size_t count = ++completed;
+			if (progress_callback)
+			{
+				progress_callback(count, total);
+			}
+		}));
+	};
+
+	// Wait for the whole group, and rethrow the first error once every task has finished
+	auto wait = [&]() {
+		std::exception_ptr error;
+		for (auto &task : tasks)
+		{
+			try
+			{
+				task.get();
+			}
+			catch (...)
+			{
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+			}
+		}
+		tasks.clear();
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	};
+
+	// Shader modules and render passes have no dependencies
+	for (size_t i = 0; i < shader_module_infos.size(); ++i)
+	{
+		schedule([&, i]() { shader_modules[i] = &build_shader_module(resource_cache, shader_module_infos[i]); });
+	}
+	for (size_t i = 0; i < render_pass_infos.size(); ++i)
+	{
+		schedule([&, i]() { render_passes[i] = &build_render_pass(resource_cache, render_pass_infos[i]); });
+	}
+	wait();
+
+	// Pipeline layouts depend on shader modules
+	for (size_t i = 0; i < pipeline_layout_infos.size(); ++i)
+	{
+		schedule([&, i]() { pipeline_layouts[i] = &build_pipeline_layout(resource_cache, pipeline_layout_infos[i]); });
+	}
+	wait();
+
+	// Graphics pipelines depend on pipeline layouts and render passes
+	for (size_t i = 0; i < graphics_pipeline_infos.size(); ++i)
+	{
+		schedule([&, i]() { graphics_pipelines[i] = &build_graphics_pipeline(resource_cache, graphics_pipeline_infos[i]); });
+	}
+	wait();
+}
+
 void ResourceReplay::create_shader_module(ResourceCache &resource_cache, std::istringstream &stream)
 {
-	VkShaderStageFlagBits    stage{};
+	auto &shader_module = build_shader_module(resource_cache, read_shader_module(stream));
+
+	shader_modules.push_back(&shader_module);
+}
+
+void ResourceReplay::create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream)
+{
+	auto &pipeline_layout = build_pipeline_layout(resource_cache, read_pipeline_layout(stream));
+
+	pipeline_layouts.push_back(&pipeline_layout);
+}
+
+void ResourceReplay::create_render_pass(ResourceCache &resource_cache, std::istringstream &stream)
+{
+	auto &render_pass = build_render_pass(resource_cache, read_render_pass(stream));
+
+	render_passes.push_back(&render_pass);
+}
+
+void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream)
+{
+	auto &graphics_pipeline = build_graphics_pipeline(resource_cache, read_graphics_pipeline(stream));
+
+	graphics_pipelines.push_back(&graphics_pipeline);
+}
+
+ResourceReplay::ShaderModuleInfo ResourceReplay::read_shader_module(std::istringstream &stream)
+{
 	std::string              glsl_source;
 	std::string              entry_point;
 	std::string              preamble;
 	std::vector<std::string> processes;
 
+	ShaderModuleInfo info{};
+
 	read(stream,
-	     stage,
+	     info.stage,
 	     glsl_source,
 	     entry_point,
 	     preamble);
 
 	read_processes(stream, processes);
 
-	ShaderSource shader_source{};
-	shader_source.set_source(std::move(glsl_source));
-	ShaderVariant shader_variant(std::move(preamble), std::move(processes));
+	info.shader_source.set_source(std::move(glsl_source));
+	info.shader_variant = ShaderVariant(std::move(preamble), std::move(processes));
 
-	auto &shader_module = resource_cache.request_shader_module(stage, shader_source, shader_variant);
-
-	shader_modules.push_back(&shader_module);
+	return info;
 }
 
-void ResourceReplay::create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream)
+ResourceReplay::PipelineLayoutInfo ResourceReplay::read_pipeline_layout(std::istringstream &stream)
 {
-	std::vector<size_t> shader_indices;
+	PipelineLayoutInfo info{};
 
 	read(stream,
-	     shader_indices);
-
-	std::vector<ShaderModule *> shader_stages(shader_indices.size());
-	std::transform(shader_indices.begin(),
-	               shader_indices.end(),
-	               shader_stages.begin(),
-	               [&](size_t shader_index) {
-		               assert(shader_index < shader_modules.size());
-		               return shader_modules[shader_index];
-	               });
+	     info.shader_indices);
 
-	auto &pipeline_layout = resource_cache.request_pipeline_layout(shader_stages);
-
-	pipeline_layouts.push_back(&pipeline_layout);
+	return info;
 }
 
-void ResourceReplay::create_render_pass(ResourceCache &resource_cache, std::istringstream &stream)
+ResourceReplay::RenderPassInfo ResourceReplay::read_render_pass(std::istringstream &stream)
 {
-	std::vector<Attachment>    attachments;
-	std::vector<LoadStoreInfo> load_store_infos;
-	std::vector<SubpassInfo>   subpasses;
+	RenderPassInfo info{};
 
 	read(stream,
-	     attachments,
-	     load_store_infos);
+	     info.attachments,
+	     info.load_store_infos);
 
-	read_subpass_info(stream, subpasses);
+	read_subpass_info(stream, info.subpasses);
 
-	auto &render_pass = resource_cache.request_render_pass(attachments, load_store_infos, subpasses);
-
-	render_passes.push_back(&render_pass);
+	return info;
 }
 
-void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream)
+ResourceReplay::GraphicsPipelineInfo ResourceReplay::read_graphics_pipeline(std::istringstream &stream)
 {
-	size_t   pipeline_layout_index{};
-	size_t   render_pass_index{};
-	uint32_t subpass_index{};
+	GraphicsPipelineInfo info{};
 
 	read(stream,
-	     pipeline_layout_index,
-	     render_pass_index,
-	     subpass_index);
+	     info.pipeline_layout_index,
+	     info.render_pass_index,
+	     info.subpass_index);
 
-	std::map<uint32_t, std::vector<uint8_t>> specialization_constant_state{};
 	read(stream,
-	     specialization_constant_state);
-
-	VertexInputState vertex_input_state{};
+	     info.specialization_constant_state);
 
 	read(stream,
-	     vertex_input_state.attributes,
-	     vertex_input_state.bindings);
+	     info.vertex_input_state.attributes,
+	     info.vertex_input_state.bindings);
 
-	InputAssemblyState input_assembly_state{};
-	RasterizationState rasterization_state{};
-	ViewportState      viewport_state{};
-	MultisampleState   multisample_state{};
-	DepthStencilState  depth_stencil_state{};
+	read(stream,
+	     info.input_assembly_state,
+	     info.rasterization_state,
+	     info.viewport_state,
+	     info.multisample_state,
+	     info.depth_stencil_state);
 
 	read(stream,
-	     input_assembly_state,
-	     rasterization_state,
-	     viewport_state,
-	     multisample_state,
-	     depth_stencil_state);
+	     info.color_blend_state.logic_op,
+	     info.color_blend_state.logic_op_enable,
+	     info.color_blend_state.attachments);
+
+	return info;
+}
 
-	ColorBlendState color_blend_state{};
+ShaderModule &ResourceReplay::build_shader_module(ResourceCache &resource_cache, const ShaderModuleInfo &info)
+{
+	return resource_cache.request_shader_module(info.stage, info.shader_source, info.shader_variant);
+}
 
-	read(stream,
-	     color_blend_state.logic_op,
-	     color_blend_state.logic_op_enable,
-	     color_blend_state.attachments);
+PipelineLayout &ResourceReplay::build_pipeline_layout(ResourceCache &resource_cache, const PipelineLayoutInfo &info)
+{
+	std::vector<ShaderModule *> shader_stages(info.shader_indices.size());
+	std::transform(info.shader_indices.begin(),
+	               info.shader_indices.end(),
+	               shader_stages.begin(),
+	               [&](size_t shader_index) {
+		               assert(shader_index < shader_modules.size());
+		               return shader_modules[shader_index];
+	               });
+
+	return resource_cache.request_pipeline_layout(shader_stages);
+}
 
+RenderPass &ResourceReplay::build_render_pass(ResourceCache &resource_cache, const RenderPassInfo &info)
+{
+	return resource_cache.request_render_pass(info.attachments, info.load_store_infos, info.subpasses);
+}
+
+GraphicsPipeline &ResourceReplay::build_graphics_pipeline(ResourceCache &resource_cache, const GraphicsPipelineInfo &info)
+{
 	PipelineState pipeline_state{};
-	assert(pipeline_layout_index < pipeline_layouts.size());
-	pipeline_state.set_pipeline_layout(*pipeline_layouts[pipeline_layout_index]);
-	assert(render_pass_index < render_passes.size());
-	pipeline_state.set_render_pass(*render_passes[render_pass_index]);
+	assert(info.pipeline_layout_index < pipeline_layouts.size());
+	pipeline_state.set_pipeline_layout(*pipeline_layouts[info.pipeline_layout_index]);
+	assert(info.render_pass_index < render_passes.size());
+	pipeline_state.set_render_pass(*render_passes[info.render_pass_index]);
 
-	for (auto &item : specialization_constant_state)
+	for (auto &item : info.specialization_constant_state)
 	{
 		pipeline_state.set_specialization_constant(item.first, item.second);
 	}
 
-	pipeline_state.set_subpass_index(subpass_index);
-	pipeline_state.set_vertex_input_state(vertex_input_state);
-	pipeline_state.set_input_assembly_state(input_assembly_state);
-	pipeline_state.set_rasterization_state(rasterization_state);
-	pipeline_state.set_viewport_state(viewport_state);
-	pipeline_state.set_multisample_state(multisample_state);
-	pipeline_state.set_depth_stencil_state(depth_stencil_state);
-	pipeline_state.set_color_blend_state(color_blend_state);
-
-	auto &graphics_pipeline = resource_cache.request_graphics_pipeline(pipeline_state);
+	pipeline_state.set_subpass_index(info.subpass_index);
+	pipeline_state.set_vertex_input_state(info.vertex_input_state);
+	pipeline_state.set_input_assembly_state(info.input_assembly_state);
+	pipeline_state.set_rasterization_state(info.rasterization_state);
+	pipeline_state.set_viewport_state(info.viewport_state);
+	pipeline_state.set_multisample_state(info.multisample_state);
+	pipeline_state.set_depth_stencil_state(info.depth_stencil_state);
+	pipeline_state.set_color_blend_state(info.color_blend_state);
 
-	graphics_pipelines.push_back(&graphics_pipeline);
+	return resource_cache.request_graphics_pipeline(pipeline_state);
 }
 }        // namespace vkb
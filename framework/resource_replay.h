@@ -17,8 +17,15 @@
 
 #pragma once
 
+#include <functional>
+
 #include "resource_record.h"
 
+namespace ctpl
+{
+class thread_pool;
+}
+
 namespace vkb
 {
 class ResourceCache;
@@ -29,11 +36,61 @@ class ResourceCache;
 class ResourceReplay
 {
   public:
+	/// Called with the number of created objects and the total number of recorded objects
+	using ProgressCallback = std::function<void(size_t completed, size_t total)>;
+
 	ResourceReplay();
 
 	void play(ResourceCache &resource_cache, ResourceRecord &recorder);
 
+	/**
+	 * @brief Replays the recorded stream on a thread pool
+	 *
+	 * The stream is parsed up front and split by dependency: shader modules and render passes
+	 * first, then pipeline layouts, then graphics pipelines. Objects within a group are
+	 * independent and are created in parallel. Blocks until every object has been created.
+	 * @param resource_cache The cache to create the objects in
+	 * @param data The serialized stream, a copy as the cache keeps recording to its record while the objects are created
+	 * @param thread_pool The pool to create the objects on
+	 * @param progress_callback Optional callback, invoked from the worker threads after each object
+	 */
+	void play_parallel(ResourceCache &resource_cache, const std::vector<uint8_t> &data, ctpl::thread_pool &thread_pool, const ProgressCallback &progress_callback = {});
+
   protected:
+	struct ShaderModuleInfo
+	{
+		VkShaderStageFlagBits stage{};
+		ShaderSource          shader_source;
+		ShaderVariant         shader_variant;
+	};
+
+	struct PipelineLayoutInfo
+	{
+		std::vector<size_t> shader_indices;
+	};
+
+	struct RenderPassInfo
+	{
+		std::vector<Attachment>    attachments;
+		std::vector<LoadStoreInfo> load_store_infos;
+		std::vector<SubpassInfo>   subpasses;
+	};
+
+	struct GraphicsPipelineInfo
+	{
+		size_t                                   pipeline_layout_index{};
+		size_t                                   render_pass_index{};
+		uint32_t                                 subpass_index{};
+		std::map<uint32_t, std::vector<uint8_t>> specialization_constant_state;
+		VertexInputState                         vertex_input_state;
+		InputAssemblyState                       input_assembly_state;
+		RasterizationState                       rasterization_state;
+		ViewportState                            viewport_state;
+		MultisampleState                         multisample_state;
+		DepthStencilState                        depth_stencil_state;
+		ColorBlendState                          color_blend_state;
+	};
+
 	void create_shader_module(ResourceCache &resource_cache, std::istringstream &stream);
 
 	void create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream);
@@ -42,6 +99,22 @@ class ResourceReplay
 
 	void create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream);
 
+	ShaderModuleInfo read_shader_module(std::istringstream &stream);
+
+	PipelineLayoutInfo read_pipeline_layout(std::istringstream &stream);
+
+	RenderPassInfo read_render_pass(std::istringstream &stream);
+
+	GraphicsPipelineInfo read_graphics_pipeline(std::istringstream &stream);
+
+	ShaderModule &build_shader_module(ResourceCache &resource_cache, const ShaderModuleInfo &info);
+
+	PipelineLayout &build_pipeline_layout(ResourceCache &resource_cache, const PipelineLayoutInfo &info);
+
+	RenderPass &build_render_pass(ResourceCache &resource_cache, const RenderPassInfo &info);
+
+	GraphicsPipeline &build_graphics_pipeline(ResourceCache &resource_cache, const GraphicsPipelineInfo &info);
+
   private:
 	using ResourceFunc = std::function<void(ResourceCache &, std::istringstream &)>;
 
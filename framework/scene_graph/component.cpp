@@ -18,6 +18,7 @@
 #include "component.h"
 
 #include <algorithm>
+#include <atomic>
 
 #include "node.h"
 
@@ -25,13 +26,33 @@ namespace vkb
 {
 namespace sg
 {
+namespace
+{
+size_t next_component_id()
+{
+	static std::atomic<size_t> next_id{0};
+
+	return next_id++;
+}
+}        // namespace
+
+Component::Component() :
+    id{next_component_id()}
+{}
+
 Component::Component(const std::string &name) :
-    name{name}
+    name{name},
+    id{next_component_id()}
 {}
 
 const std::string &Component::get_name() const
 {
 	return name;
 }
+
+size_t Component::get_id() const
+{
+	return id;
+}
 }        // namespace sg
 }        // namespace vkb
@@ -32,7 +32,7 @@ class Node;
 class Component
 {
   public:
-	Component() = default;
+	Component();
 
 	Component(const std::string &name);
 
@@ -42,10 +42,18 @@ class Component
 
 	const std::string &get_name() const;
 
+	/**
+	 * @return An identifier unique to the component for the lifetime of the application, which is not reused
+	 *         when the component is destroyed, unlike its address
+	 */
+	size_t get_id() const;
+
 	virtual std::type_index get_type() = 0;
 
   private:
 	std::string name;
+
+	size_t id;
 };
 }        // namespace sg
 }        // namespace vkb
@@ -49,7 +49,8 @@ std::unique_ptr<vkb::scene_graph::components::HPPImage> HPPImage::load(const std
 {
 	std::unique_ptr<vkb::scene_graph::components::HPPImage> image{nullptr};
 
-	auto data = fs::read_asset(uri);
+	// The decoders read the file in place, the image only owns the decoded data
+	auto file = fs::map_asset(uri);
 
 	// Get extension
 	auto extension = get_extension(uri);
@@ -58,17 +59,17 @@ std::unique_ptr<vkb::scene_graph::components::HPPImage> HPPImage::load(const std
 	if (extension == "png" || extension == "jpg")
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(reinterpret_cast<vkb::scene_graph::components::HPPImage *>(
-		    std::make_unique<vkb::sg::Stb>(name, data, static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
+		    std::make_unique<vkb::sg::Stb>(name, file->data(), file->size(), static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
 	}
 	else if (extension == "astc")
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(
-		    reinterpret_cast<vkb::scene_graph::components::HPPImage *>(std::make_unique<vkb::sg::Astc>(name, data).release()));
+		    reinterpret_cast<vkb::scene_graph::components::HPPImage *>(std::make_unique<vkb::sg::Astc>(name, file->data(), file->size()).release()));
 	}
 	else if ((extension == "ktx") || (extension == "ktx2"))
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(reinterpret_cast<vkb::scene_graph::components::HPPImage *>(
-		    std::make_unique<vkb::sg::Ktx>(name, data, static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
+		    std::make_unique<vkb::sg::Ktx>(name, file->data(), file->size(), static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
 	}
 
 	return image;
@@ -202,7 +203,9 @@ void HPPImage::create_vk_image(vkb::core::HPPDevice &device, vk::ImageViewType i
 {
 	assert(!vk_image && !vk_image_view && "Vulkan HPPImage already constructed");
 
-	vk_image = std::make_unique<vkb::core::HPPImage>(device,
+	vkb::allocated::ScopedMemoryTag memory_tag{vkb::allocated::MemoryTag::SceneTexture};
+
+	vk_image = std::make_shared<vkb::core::HPPImage>(device,
 	                                                 get_extent(),
 	                                                 format,
 	                                                 vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
@@ -214,7 +217,7 @@ void HPPImage::create_vk_image(vkb::core::HPPDevice &device, vk::ImageViewType i
 	                                                 flags);
 	vk_image->set_debug_name(get_name());
 
-	vk_image_view = std::make_unique<vkb::core::HPPImageView>(*vk_image, image_view_type);
+	vk_image_view = std::make_shared<vkb::core::HPPImageView>(*vk_image, image_view_type, vk::Format::eUndefined, 0, 0, 0, 0, components);
 	vk_image_view->set_debug_name("View on " + get_name());
 }
 
@@ -230,7 +233,7 @@ void HPPImage::generate_mipmaps()
 	auto extent      = get_extent();
 	auto next_width  = std::max<uint32_t>(1u, extent.width / 2);
 	auto next_height = std::max<uint32_t>(1u, extent.height / 2);
-	auto channels    = 4;
+	auto channels    = vk::blockSize(format);
 	auto next_size   = next_width * next_height * channels;
 
 	while (true)
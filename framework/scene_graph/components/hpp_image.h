@@ -96,8 +96,12 @@ class HPPImage : public vkb::sg::Component
 	uint32_t                                             layers = 1;
 	std::vector<vkb::scene_graph::components::HPPMipmap> mipmaps{{}};
 	std::vector<std::vector<vk::DeviceSize>>             offsets;        // Offsets stored like offsets[array_layer][mipmap_layer]
-	std::unique_ptr<vkb::core::HPPImage>                 vk_image;
-	std::unique_ptr<vkb::core::HPPImageView>             vk_image_view;
+	std::shared_ptr<vkb::core::HPPImage>                 vk_image;
+	std::shared_ptr<vkb::core::HPPImageView>             vk_image_view;
+	std::shared_ptr<vkb::core::HPPImageView>             vk_array_view;                   // mirrors vkb::sg::Image, see Image::set_array_layer
+	uint32_t                                             array_layer          = 0;        // mirrors vkb::sg::Image, see Image::set_array_layer
+	size_t                                               pending_payload_size = 0;        // mirrors vkb::sg::Image, see Image::write_payload
+	vk::ComponentMapping                                 components;                      // mirrors vkb::sg::Image, see Image::get_components
 };
 
 } // namespace vkb::scene_graph::components
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,8 @@
 
 #include "image.h"
 
+#include <array>
+#include <cmath>
 #include <mutex>
 
 #include "common/error.h"
@@ -26,6 +28,7 @@
 
 #include "common/utils.h"
 #include "filesystem/legacy.h"
+#include "rendering/mip_generator.h"
 #include "scene_graph/components/image/astc.h"
 #include "scene_graph/components/image/ktx.h"
 #include "scene_graph/components/image/stb.h"
@@ -66,6 +69,30 @@ bool is_astc(const VkFormat format)
 	        format == VK_FORMAT_ASTC_12x12_SRGB_BLOCK);
 }
 
+// Number of channels of the 8-bit formats whose texels are processed on the CPU, 0 for other formats
+static uint32_t get_8bit_channel_count(VkFormat fmt)
+{
+	switch (fmt)
+	{
+		case VK_FORMAT_R8_UNORM:
+		case VK_FORMAT_R8_SRGB:
+			return 1;
+		case VK_FORMAT_R8G8_UNORM:
+		case VK_FORMAT_R8G8_SRGB:
+			return 2;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+bool can_generate_mipmaps(VkFormat format)
+{
+	return get_8bit_channel_count(format) != 0;
+}
+
 // When the color-space of a loaded image is unknown (from KTX1 for example) we
 // may want to assume that the loaded data is in sRGB format (since it usually is).
 // In those cases, this helper will get called which will force an existing unorm
@@ -170,6 +197,43 @@ void Image::clear_data()
 	data.shrink_to_fit();
 }
 
+size_t Image::get_payload_size() const
+{
+	return pending_payload_size > 0 ? pending_payload_size : data.size();
+}
+
+void Image::write_payload(uint8_t *dst)
+{
+	if (pending_payload_size > 0)
+	{
+		write_pending_payload(dst);
+		pending_payload_size = 0;
+	}
+	else
+	{
+		std::memcpy(dst, data.data(), data.size());
+	}
+}
+
+void Image::resolve_payload()
+{
+	if (pending_payload_size > 0)
+	{
+		data.resize(pending_payload_size);
+		write_payload(data.data());
+	}
+}
+
+void Image::set_pending_payload(size_t size)
+{
+	pending_payload_size = size;
+}
+
+void Image::write_pending_payload(uint8_t *dst)
+{
+	throw std::runtime_error{"Image " + get_name() + " has no pending payload"};
+}
+
 VkFormat Image::get_format() const
 {
 	return format;
@@ -196,23 +260,50 @@ const std::vector<std::vector<VkDeviceSize>> &Image::get_offsets() const
 	return offsets;
 }
 
-void Image::create_vk_image(Device &device, VkImageViewType image_view_type, VkImageCreateFlags flags)
+void Image::create_vk_image(Device &device, VkImageViewType image_view_type, VkImageCreateFlags flags, bool allocate_mip_chain, VkImageUsageFlags usage)
 {
 	assert(!vk_image && !vk_image_view && "Vulkan image already constructed");
 
+	allocated::ScopedMemoryTag memory_tag{allocated::MemoryTag::SceneTexture};
+
+	// Sampling single and two channel sRGB formats is optional
+	auto channel_count = get_8bit_channel_count(format);
+	if (channel_count != 0 && channel_count < 4 && !device.is_image_format_supported(format))
+	{
+		expand_to_rgba();
+	}
+
+	bool generates_mip_chain = allocate_mip_chain && mipmaps.size() == 1 && layers == 1 && image_view_type == VK_IMAGE_VIEW_TYPE_2D;
+	if (generates_mip_chain && !MipGenerator::is_supported(device, format) && can_generate_mipmaps(format) && !data.empty())
+	{
+		// The MipGenerator only writes RGBA, the levels of images of fewer channels are generated on the CPU
+		generate_mipmaps();
+	}
+
+	auto              mip_levels  = to_u32(mipmaps.size());
+	VkImageUsageFlags image_usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | usage;
+
+	auto &extent = get_extent();
+	if (generates_mip_chain && mip_levels == 1 && MipGenerator::is_supported(device, format))
+	{
+		mip_levels = static_cast<uint32_t>(std::floor(std::log2(std::max(extent.width, extent.height)))) + 1;
+		image_usage |= MipGenerator::get_image_usage();
+		flags |= MipGenerator::get_image_flags(device, format);
+	}
+
 	vk_image = std::make_unique<core::Image>(device,
-	                                         get_extent(),
+	                                         extent,
 	                                         format,
-	                                         VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+	                                         image_usage,
 	                                         VMA_MEMORY_USAGE_GPU_ONLY,
 	                                         VK_SAMPLE_COUNT_1_BIT,
-	                                         to_u32(mipmaps.size()),
+	                                         mip_levels,
 	                                         layers,
 	                                         VK_IMAGE_TILING_OPTIMAL,
 	                                         flags);
 	vk_image->set_debug_name(get_name());
 
-	vk_image_view = std::make_unique<core::ImageView>(*vk_image, image_view_type);
+	vk_image_view = std::make_unique<core::ImageView>(*vk_image, image_view_type, VK_FORMAT_UNDEFINED, 0, 0, 0, 0, components);
 	vk_image_view->set_debug_name("View on " + get_name());
 }
 
@@ -228,6 +319,63 @@ const core::ImageView &Image::get_vk_image_view() const
 	return *vk_image_view;
 }
 
+bool Image::needs_mip_generation() const
+{
+	return vk_image && vk_image->get_subresource().mipLevel > mipmaps.size();
+}
+
+void Image::swap_vk_image(std::shared_ptr<core::Image> &image, std::shared_ptr<core::ImageView> &image_view)
+{
+	assert(image && image_view && &image_view->get_image() == image.get() && "The view must be on the image");
+
+	vk_image.swap(image);
+	vk_image_view.swap(image_view);
+
+	vk_array_view.reset();
+	array_layer = 0;
+}
+
+std::unique_ptr<Image> Image::share(const std::string &name) const
+{
+	auto image = std::make_unique<Image>(name, std::vector<uint8_t>{}, std::vector<Mipmap>{mipmaps});
+
+	image->format        = format;
+	image->layers        = layers;
+	image->offsets       = offsets;
+	image->components    = components;
+	image->vk_image      = vk_image;
+	image->vk_image_view = vk_image_view;
+	image->vk_array_view = vk_array_view;
+	image->array_layer   = array_layer;
+
+	return image;
+}
+
+void Image::set_array_layer(const std::shared_ptr<core::Image> &array_image, const std::shared_ptr<core::ImageView> &array_view, uint32_t layer)
+{
+	assert(vk_image_view && layers == 1 && "The image must be a single layer image with a view");
+	assert(&array_view->get_image() == array_image.get() && layer < array_image->get_array_layer_count() && "The layer must be in the array");
+
+	auto format = vk_image_view->get_format();
+
+	vk_image      = array_image;
+	vk_image_view = std::make_shared<core::ImageView>(*vk_image, VK_IMAGE_VIEW_TYPE_2D, format, 0, layer, 0, 1, components);
+	vk_image_view->set_debug_name("View on " + get_name());
+
+	vk_array_view = array_view;
+	array_layer   = layer;
+}
+
+const core::ImageView *Image::get_vk_array_view() const
+{
+	return vk_array_view.get();
+}
+
+uint32_t Image::get_array_layer() const
+{
+	return array_layer;
+}
+
 Mipmap &Image::get_mipmap(const size_t index)
 {
 	assert(index < mipmaps.size());
@@ -235,13 +383,12 @@ Mipmap &Image::get_mipmap(const size_t index)
 }
 
 // Note that this function returns the required size for ALL mip levels, *including* the base level.
-uint32_t get_required_mipmaps_size(const VkExtent3D &extent)
+uint32_t get_required_mipmaps_size(const VkExtent3D &extent, uint32_t channels)
 {
-	constexpr uint32_t channels = 4;
-	auto               width    = std::max<uint32_t>(1, extent.width);
-	auto               height   = std::max<uint32_t>(1, extent.height);
-	auto               size     = width * height * channels;
-	auto               result   = size;
+	auto width  = std::max<uint32_t>(1, extent.width);
+	auto height = std::max<uint32_t>(1, extent.height);
+	auto size   = width * height * channels;
+	auto result = size;
 	while (size != channels)
 	{
 		width  = std::max<uint32_t>(1u, width >> 1);
@@ -264,12 +411,14 @@ void Image::generate_mipmaps()
 	auto extent      = get_extent();
 	auto next_width  = std::max<uint32_t>(1u, extent.width / 2);
 	auto next_height = std::max<uint32_t>(1u, extent.height / 2);
-	auto channels    = 4;
+	auto channels    = get_8bit_channel_count(format);
 	auto next_size   = next_width * next_height * channels;
 
+	assert(channels != 0 && "Mipmaps are only generated for 8-bit formats of 1, 2 or 4 channels");
+
 	// Allocate for all the mips at once.  The function returns the total size needed for the
 	// existing base mip as well as all the mips that will be generated.
-	data.reserve(get_required_mipmaps_size(extent));
+	data.reserve(get_required_mipmaps_size(extent, channels));
 
 	while (true)
 	{
@@ -356,31 +505,98 @@ void Image::coerce_format_to_srgb()
 	format = maybe_coerce_to_srgb(format);
 }
 
+const VkComponentMapping &Image::get_components() const
+{
+	return components;
+}
+
+void Image::set_components(const VkComponentMapping &c)
+{
+	components = c;
+}
+
+bool Image::expand_to_rgba()
+{
+	auto channels = get_8bit_channel_count(format);
+	if (channels == 0 || channels == 4 || data.empty())
+	{
+		return false;
+	}
+
+	// Source channel of each RGBA channel, or the constant value of ZERO and ONE and of the channels the format lacks
+	std::array<int32_t, 4> sources;
+	std::array<uint8_t, 4> constants;
+
+	const VkComponentSwizzle swizzles[4] = {components.r, components.g, components.b, components.a};
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		auto swizzle = swizzles[i] == VK_COMPONENT_SWIZZLE_IDENTITY ? static_cast<VkComponentSwizzle>(VK_COMPONENT_SWIZZLE_R + i) : swizzles[i];
+
+		int32_t source = swizzle >= VK_COMPONENT_SWIZZLE_R ? static_cast<int32_t>(swizzle - VK_COMPONENT_SWIZZLE_R) : -1;
+		sources[i]     = source < static_cast<int32_t>(channels) ? source : -1;
+		constants[i]   = (swizzle == VK_COMPONENT_SWIZZLE_ONE || (source == 3 && sources[i] == -1)) ? 255 : 0;
+	}
+
+	std::vector<uint8_t> expanded(data.size() / channels * 4);
+	for (size_t texel = 0; texel < data.size() / channels; ++texel)
+	{
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			expanded[texel * 4 + i] = sources[i] >= 0 ? data[texel * channels + sources[i]] : constants[i];
+		}
+	}
+
+	data = std::move(expanded);
+
+	for (auto &mipmap : mipmaps)
+	{
+		mipmap.offset = mipmap.offset / channels * 4;
+	}
+
+	for (auto &layer_offsets : offsets)
+	{
+		for (auto &offset : layer_offsets)
+		{
+			offset = offset / channels * 4;
+		}
+	}
+
+	format     = (format == VK_FORMAT_R8_SRGB || format == VK_FORMAT_R8G8_SRGB) ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+	components = {};
+
+	return true;
+}
+
 std::unique_ptr<Image> Image::load(const std::string &name, const std::string &uri,
-                                   ContentType content_type)
+                                   ContentType content_type, bool defer_payload)
 {
-	std::unique_ptr<Image> image{nullptr};
+	// The decoders read the file in place, the image only owns the decoded data
+	return load(name, uri, fs::map_asset(uri), content_type, defer_payload);
+}
 
-	auto data = fs::read_asset(uri);
+std::unique_ptr<Image> Image::load(const std::string &name, const std::string &uri, filesystem::MappedFilePtr file,
+                                   ContentType content_type, bool defer_payload)
+{
+	std::unique_ptr<Image> image{nullptr};
 
 	// Get extension
 	auto extension = get_extension(uri);
 
 	if (extension == "png" || extension == "jpg")
 	{
-		image = std::make_unique<Stb>(name, data, content_type);
+		image = std::make_unique<Stb>(name, file->data(), file->size(), content_type);
 	}
 	else if (extension == "astc")
 	{
-		image = std::make_unique<Astc>(name, data);
+		image = defer_payload ? std::make_unique<Astc>(name, file) : std::make_unique<Astc>(name, file->data(), file->size());
 	}
 	else if (extension == "ktx")
 	{
-		image = std::make_unique<Ktx>(name, data, content_type);
+		image = defer_payload ? std::make_unique<Ktx>(name, file, content_type) : std::make_unique<Ktx>(name, file->data(), file->size(), content_type);
 	}
 	else if (extension == "ktx2")
 	{
-		image = std::make_unique<Ktx>(name, data, content_type);
+		image = defer_payload ? std::make_unique<Ktx>(name, file, content_type) : std::make_unique<Ktx>(name, file->data(), file->size(), content_type);
 	}
 
 	return image;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -26,10 +26,13 @@
 
 #include "core/image.h"
 #include "core/image_view.h"
+#include "filesystem/filesystem.hpp"
 #include "scene_graph/component.h"
 
 namespace vkb
 {
+class TextureRegistry;
+
 namespace sg
 {
 /**
@@ -38,6 +41,12 @@ namespace sg
  */
 bool is_astc(VkFormat format);
 
+/**
+ * @param format Vulkan format
+ * @return Whether Image::generate_mipmaps() supports the format, i.e. 8-bit formats of 1, 2 or 4 channels
+ */
+bool can_generate_mipmaps(VkFormat format);
+
 /**
  * @brief Mipmap information
  */
@@ -72,7 +81,18 @@ class Image : public Component
 
 	Image(const std::string &name, std::vector<uint8_t> &&data = {}, std::vector<Mipmap> &&mipmaps = {{}});
 
-	static std::unique_ptr<Image> load(const std::string &name, const std::string &uri, ContentType content_type);
+	/**
+	 * @param defer_payload If true, KTX and ASTC texel data is left in the mapped file until write_payload(),
+	 *                      so that it can be decoded or copied straight into staging memory
+	 */
+	static std::unique_ptr<Image> load(const std::string &name, const std::string &uri, ContentType content_type, bool defer_payload = false);
+
+	/**
+	 * @brief Loads an image from the contents of its file, such as a file read ahead of decoding
+	 * @param uri The path of the file, which gives the format of the image
+	 * @param file The contents of the file
+	 */
+	static std::unique_ptr<Image> load(const std::string &name, const std::string &uri, filesystem::MappedFilePtr file, ContentType content_type, bool defer_payload = false);
 
 	virtual ~Image() = default;
 
@@ -82,6 +102,22 @@ class Image : public Component
 
 	void clear_data();
 
+	/**
+	 * @brief Size in bytes of the texel data, including a payload still pending in the source file
+	 */
+	size_t get_payload_size() const;
+
+	/**
+	 * @brief Writes the texel data to a region of get_payload_size() bytes, such as a mapped staging buffer
+	 *        A pending payload is decoded or copied straight from its source, which is released once written.
+	 */
+	void write_payload(uint8_t *dst);
+
+	/**
+	 * @brief Moves a pending payload into get_data(), for code processing the texels on the CPU
+	 */
+	void resolve_payload();
+
 	VkFormat get_format() const;
 
 	const VkExtent3D &get_extent() const;
@@ -94,12 +130,68 @@ class Image : public Component
 
 	void generate_mipmaps();
 
-	void create_vk_image(Device &device, VkImageViewType image_view_type = VK_IMAGE_VIEW_TYPE_2D, VkImageCreateFlags flags = 0);
+	/**
+	 * @brief The swizzle of the views on the image, such as to read images decoded with fewer than four channels as RGBA
+	 */
+	const VkComponentMapping &get_components() const;
+
+	/**
+	 * @brief Expands the texels of an image of one or two 8-bit channels to RGBA with its swizzle, for devices which
+	 *        can't sample its format, such as R8_SRGB. create_vk_image() calls it for such formats.
+	 * @return Whether the image was expanded
+	 */
+	bool expand_to_rgba();
+
+	/**
+	 * @param allocate_mip_chain If the image has a single level, allocates its whole mip chain for a MipGenerator to
+	 *                           generate once the first level is uploaded, if it supports the format
+	 * @param usage Usage of the image besides sampling and uploads, such as being copied to a texture array
+	 */
+	void create_vk_image(Device &device, VkImageViewType image_view_type = VK_IMAGE_VIEW_TYPE_2D, VkImageCreateFlags flags = 0, bool allocate_mip_chain = false,
+	                     VkImageUsageFlags usage = 0);
 
 	const core::Image &get_vk_image() const;
 
 	const core::ImageView &get_vk_image_view() const;
 
+	/**
+	 * @return Whether the Vulkan image has levels past the mipmaps of the image, to generate on the GPU
+	 */
+	bool needs_mip_generation() const;
+
+	/**
+	 * @brief Replaces the Vulkan image and its view, such as by a chain of fewer mip levels, see MipStreamer
+	 *        The previous ones are moved to the parameters, for the caller to keep them until the GPU is done with them.
+	 *        Other images sharing the previous ones keep them, see share().
+	 */
+	void swap_vk_image(std::shared_ptr<core::Image> &image, std::shared_ptr<core::ImageView> &image_view);
+
+	/**
+	 * @brief Creates an image of the same format, extent, mipmaps and swizzle, which shares the Vulkan image and view of this one
+	 *        but not its texel data, such as for another scene using the same texture, see TextureRegistry.
+	 *        The Vulkan image is released with the last image sharing it, and replacing it in one image with swap_vk_image()
+	 *        leaves the others untouched, so shared images are only copied once they are written.
+	 */
+	std::unique_ptr<Image> share(const std::string &name) const;
+
+	/**
+	 * @brief Makes the image a layer of a 2D array image, which holds images of the same format, extent and levels
+	 *        Its view then only sees its layer, so it is sampled as before, while get_vk_image() is the whole array.
+	 *        The texels must have been copied to the layer, see GLTFLoader::set_texture_arrays().
+	 * @param array_view A 2D array view on all the layers, shared by the images of the array
+	 */
+	void set_array_layer(const std::shared_ptr<core::Image> &array_image, const std::shared_ptr<core::ImageView> &array_view, uint32_t layer);
+
+	/**
+	 * @return The 2D array view on the texture array holding the image, or nullptr if the image is not packed in one
+	 */
+	const core::ImageView *get_vk_array_view() const;
+
+	/**
+	 * @return The layer of the image in its texture array, see set_array_layer()
+	 */
+	uint32_t get_array_layer() const;
+
 	void coerce_format_to_srgb();
 
   protected:
@@ -109,6 +201,8 @@ class Image : public Component
 
 	void set_format(VkFormat format);
 
+	void set_components(const VkComponentMapping &components);
+
 	void set_width(uint32_t width);
 
 	void set_height(uint32_t height);
@@ -123,7 +217,17 @@ class Image : public Component
 
 	std::vector<Mipmap> &get_mut_mipmaps();
 
+	/**
+	 * @brief Marks the texel data as pending in the source, to be written by write_pending_payload() on demand
+	 */
+	void set_pending_payload(size_t size);
+
+	virtual void write_pending_payload(uint8_t *dst);
+
   private:
+	/// Keeps only weak references to the Vulkan images it shares
+	friend class vkb::TextureRegistry;
+
 	std::vector<uint8_t> data;
 
 	VkFormat format{VK_FORMAT_UNDEFINED};
@@ -135,9 +239,18 @@ class Image : public Component
 	// Offsets stored like offsets[array_layer][mipmap_layer]
 	std::vector<std::vector<VkDeviceSize>> offsets;
 
-	std::unique_ptr<core::Image> vk_image;
+	std::shared_ptr<core::Image> vk_image;
+
+	std::shared_ptr<core::ImageView> vk_image_view;
+
+	/// Set if the image is a layer of a texture array
+	std::shared_ptr<core::ImageView> vk_array_view;
+
+	uint32_t array_layer{0};
+
+	size_t pending_payload_size{0};
 
-	std::unique_ptr<core::ImageView> vk_image_view;
+	VkComponentMapping components{};
 };
 
 }        // namespace sg
@@ -17,11 +17,17 @@
 
 #include "scene_graph/components/image/astc.h"
 
+#include <cstring>
 #include <mutex>
+#include <string_view>
 
 #include "common/error.h"
 
 #include "common/glm_common.h"
+#include "common/helpers.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+#include <core/util/job_system.hpp>
 #if defined(_WIN32) || defined(_WIN64)
 // Windows.h defines IGNORE, so we must #undef it to avoid clashes with astc header
 #	undef IGNORE
@@ -34,6 +40,106 @@ namespace vkb
 {
 namespace sg
 {
+namespace
+{
+// Bump the version whenever the entry layout or the decoder settings change
+constexpr uint32_t ASTC_CACHE_MAGIC   = 0x43414b56;        // "VKAC"
+constexpr uint32_t ASTC_CACHE_VERSION = 1;
+
+struct AstcCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t depth;
+};
+
+inline filesystem::Path get_cache_directory()
+{
+	return filesystem::get()->temp_directory() / "vulkan_samples" / "astc_cache";
+}
+
+inline filesystem::Path get_cache_entry_path(size_t key)
+{
+	return get_cache_directory() / fmt::format("{:016x}.astcd", key);
+}
+
+/**
+ * @brief Reads the decoded texels of a previous run, if they were cached for the same compressed data
+ */
+inline bool load_cached(size_t key, const VkExtent3D &extent, uint8_t *decoded_data)
+{
+	try
+	{
+		auto fs   = filesystem::get();
+		auto path = get_cache_entry_path(key);
+
+		if (!fs->is_file(path))
+		{
+			return false;
+		}
+
+		auto file = fs->map_file(path);
+
+		AstcCacheHeader header{};
+		if (file->size() < sizeof(header))
+		{
+			return false;
+		}
+		std::memcpy(&header, file->data(), sizeof(header));
+
+		size_t decoded_size = static_cast<size_t>(extent.width) * extent.height * extent.depth * 4;
+
+		if (header.magic != ASTC_CACHE_MAGIC || header.version != ASTC_CACHE_VERSION ||
+		    header.width != extent.width || header.height != extent.height || header.depth != extent.depth ||
+		    file->size() != sizeof(header) + decoded_size)
+		{
+			LOGW("Discarding stale astc cache entry {}", path.string());
+			return false;
+		}
+
+		std::memcpy(decoded_data, file->data() + sizeof(header), decoded_size);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read astc cache entry: {}", e.what());
+		return false;
+	}
+
+	return true;
+}
+
+inline void store_cached(size_t key, const VkExtent3D &extent, const uint8_t *decoded_data, size_t decoded_size)
+{
+	AstcCacheHeader header{ASTC_CACHE_MAGIC, ASTC_CACHE_VERSION, extent.width, extent.height, extent.depth};
+
+	std::vector<uint8_t> data(sizeof(header) + decoded_size);
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), decoded_data, decoded_size);
+
+	try
+	{
+		auto fs        = filesystem::get();
+		auto directory = get_cache_directory();
+		if (!fs->is_directory(directory.parent_path()))
+		{
+			fs->create_directory(directory.parent_path());
+		}
+		if (!fs->is_directory(directory))
+		{
+			fs->create_directory(directory);
+		}
+
+		fs->write_file_atomic(get_cache_entry_path(key), data);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write astc cache entry: {}", e.what());
+	}
+}
+}        // namespace
+
 BlockDim to_blockdim(const VkFormat format)
 {
 	switch (format)
@@ -96,11 +202,57 @@ struct AstcHeader
 	uint8_t zsize[3];        // block count is inferred
 };
 
+namespace
+{
+void read_header(const uint8_t *data, size_t size, BlockDim &blockdim, VkExtent3D &extent)
+{
+	if (size < sizeof(AstcHeader))
+	{
+		throw std::runtime_error{"Error reading astc: invalid memory"};
+	}
+	AstcHeader header{};
+	std::memcpy(&header, data, sizeof(AstcHeader));
+	uint32_t magicval = header.magic[0] + 256 * static_cast<uint32_t>(header.magic[1]) + 65536 * static_cast<uint32_t>(header.magic[2]) + 16777216 * static_cast<uint32_t>(header.magic[3]);
+	if (magicval != MAGIC_FILE_CONSTANT)
+	{
+		throw std::runtime_error{"Error reading astc: invalid magic"};
+	}
+
+	blockdim = {
+	    /* xdim = */ header.blockdim_x,
+	    /* ydim = */ header.blockdim_y,
+	    /* zdim = */ header.blockdim_z};
+
+	extent = {
+	    /* width  = */ static_cast<uint32_t>(header.xsize[0] + 256 * header.xsize[1] + 65536 * header.xsize[2]),
+	    /* height = */ static_cast<uint32_t>(header.ysize[0] + 256 * header.ysize[1] + 65536 * header.ysize[2]),
+	    /* depth  = */ static_cast<uint32_t>(header.zsize[0] + 256 * header.zsize[1] + 65536 * header.zsize[2])};
+
+	if (extent.width == 0 || extent.height == 0 || extent.depth == 0)
+	{
+		throw std::runtime_error{"Error reading astc: invalid size"};
+	}
+}
+}        // namespace
+
 void Astc::init()
 {
 }
 
 void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *compressed_data, uint32_t compressed_size)
+{
+	auto &decoded_data = get_mut_data();
+	decoded_data.resize(static_cast<size_t>(extent.width) * extent.height * extent.depth * 4);
+
+	decode_into(blockdim, extent, compressed_data, compressed_size, decoded_data.data());
+
+	set_format(VK_FORMAT_R8G8B8A8_SRGB);
+	set_width(extent.width);
+	set_height(extent.height);
+	set_depth(extent.depth);
+}
+
+void Astc::decode_into(BlockDim blockdim, VkExtent3D extent, const uint8_t *compressed_data, uint32_t compressed_size, uint8_t *decoded_data)
 {
 	// Actual decoding
 	astcenc_swizzle swizzle = {ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A};
@@ -125,9 +277,30 @@ void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *compresse
 		throw std::runtime_error{"Error reading astc: invalid size"};
 	}
 
-	// Allocate working state given config and thread_count
+	// Decoding is slow, so the result is cached on disk for the next runs, keyed by the compressed data
+	size_t cache_key = std::hash<std::string_view>{}(std::string_view{reinterpret_cast<const char *>(compressed_data), compressed_size});
+	hash_combine(cache_key, blockdim.x);
+	hash_combine(cache_key, blockdim.y);
+	hash_combine(cache_key, blockdim.z);
+	hash_combine(cache_key, extent.width);
+	hash_combine(cache_key, extent.height);
+	hash_combine(cache_key, extent.depth);
+
+	if (load_cached(cache_key, extent, decoded_data))
+	{
+		return;
+	}
+
+	// Allocate working state for the calling thread and every job system worker
+	auto  &job_system   = JobSystem::get();
+	size_t thread_count = job_system.get_worker_count() + 1;
+
 	astcenc_context *astc_context;
-	astcenc_context_alloc(&astc_config, 1, &astc_context);
+	atscresult = astcenc_context_alloc(&astc_config, static_cast<unsigned int>(thread_count), &astc_context);
+	if (atscresult != ASTCENC_SUCCESS)
+	{
+		throw std::runtime_error{"Error allocating astc context"};
+	}
 
 	astcenc_image decoded{};
 	decoded.dim_x     = extent.width;
@@ -135,25 +308,31 @@ void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *compresse
 	decoded.dim_z     = extent.depth;
 	decoded.data_type = ASTCENC_TYPE_U8;
 
-	// allocate storage for the decoded image
-	// The astcenc_decompress_image function will write directly to the image data vector
-	auto  uncompressed_size = decoded.dim_x * decoded.dim_y * decoded.dim_z * 4;
-	auto &decoded_data      = get_mut_data();
-	decoded_data.resize(uncompressed_size);
-	void *data_ptr = static_cast<void *>(decoded_data.data());
-	decoded.data   = &data_ptr;
+	// The astcenc_decompress_image function will write directly to the destination
+	size_t uncompressed_size = static_cast<size_t>(decoded.dim_x) * decoded.dim_y * decoded.dim_z * 4;
+	void  *data_ptr          = static_cast<void *>(decoded_data);
+	decoded.data             = &data_ptr;
 
-	atscresult = astcenc_decompress_image(astc_context, compressed_data, compressed_size, &decoded, &swizzle, 0);
-	if (atscresult != ASTCENC_SUCCESS)
+	// Every thread index joins the same decompression, the blocks are shared out among the threads taking part
+	std::vector<astcenc_error> results(thread_count, ASTCENC_SUCCESS);
+	job_system.parallel_for(thread_count, 1, [&](size_t begin, size_t end) {
+		for (size_t thread_index = begin; thread_index < end; ++thread_index)
+		{
+			results[thread_index] = astcenc_decompress_image(astc_context, compressed_data, compressed_size, &decoded, &swizzle, static_cast<unsigned int>(thread_index));
+		}
+	});
+
+	astcenc_context_free(astc_context);
+
+	for (auto result : results)
 	{
-		throw std::runtime_error("Error decoding astc");
+		if (result != ASTCENC_SUCCESS)
+		{
+			throw std::runtime_error("Error decoding astc");
+		}
 	}
-	astcenc_context_free(astc_context);
 
-	set_format(VK_FORMAT_R8G8B8A8_SRGB);
-	set_width(decoded.dim_x);
-	set_height(decoded.dim_y);
-	set_depth(decoded.dim_z);
+	store_cached(cache_key, extent, decoded_data, uncompressed_size);
 }
 
 Astc::Astc(const Image &image) :
@@ -176,34 +355,44 @@ Astc::Astc(const Image &image) :
 }
 
 Astc::Astc(const std::string &name, const std::vector<uint8_t> &data) :
+    Astc{name, data.data(), data.size()}
+{}
+
+Astc::Astc(const std::string &name, const uint8_t *data, size_t size) :
     Image{name}
 {
 	init();
 
-	// Read header
-	if (data.size() < sizeof(AstcHeader))
-	{
-		throw std::runtime_error{"Error reading astc: invalid memory"};
-	}
-	AstcHeader header{};
-	std::memcpy(&header, data.data(), sizeof(AstcHeader));
-	uint32_t magicval = header.magic[0] + 256 * static_cast<uint32_t>(header.magic[1]) + 65536 * static_cast<uint32_t>(header.magic[2]) + 16777216 * static_cast<uint32_t>(header.magic[3]);
-	if (magicval != MAGIC_FILE_CONSTANT)
-	{
-		throw std::runtime_error{"Error reading astc: invalid magic"};
-	}
+	VkExtent3D extent{};
+	read_header(data, size, blockdim, extent);
 
-	BlockDim blockdim = {
-	    /* xdim = */ header.blockdim_x,
-	    /* ydim = */ header.blockdim_y,
-	    /* zdim = */ header.blockdim_z};
+	decode(blockdim, extent, data + sizeof(AstcHeader), to_u32(size - sizeof(AstcHeader)));
+}
 
-	VkExtent3D extent = {
-	    /* width  = */ static_cast<uint32_t>(header.xsize[0] + 256 * header.xsize[1] + 65536 * header.xsize[2]),
-	    /* height = */ static_cast<uint32_t>(header.ysize[0] + 256 * header.ysize[1] + 65536 * header.ysize[2]),
-	    /* depth  = */ static_cast<uint32_t>(header.zsize[0] + 256 * header.zsize[1] + 65536 * header.zsize[2])};
+Astc::Astc(const std::string &name, filesystem::MappedFilePtr file) :
+    Image{name},
+    file{std::move(file)}
+{
+	init();
+
+	VkExtent3D extent{};
+	read_header(this->file->data(), this->file->size(), blockdim, extent);
+
+	set_format(VK_FORMAT_R8G8B8A8_SRGB);
+	set_width(extent.width);
+	set_height(extent.height);
+	set_depth(extent.depth);
+
+	set_pending_payload(static_cast<size_t>(extent.width) * extent.height * extent.depth * 4);
+}
+
+void Astc::write_pending_payload(uint8_t *dst)
+{
+	assert(file && "ASTC payload already written");
+
+	decode_into(blockdim, get_extent(), file->data() + sizeof(AstcHeader), to_u32(file->size() - sizeof(AstcHeader)), dst);
 
-	decode(blockdim, extent, data.data() + sizeof(AstcHeader), to_u32(data.size() - sizeof(AstcHeader)));
+	file.reset();
 }
 
 }        // namespace sg
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "common/vk_common.h"
+#include "filesystem/filesystem.hpp"
 #include "scene_graph/components/image.h"
 
 namespace vkb
@@ -47,21 +48,50 @@ class Astc : public Image
 	 */
 	Astc(const std::string &name, const std::vector<uint8_t> &data);
 
+	/**
+	 * @brief Decodes ASTC data with an ASTC header, which the image does not own, such as a mapped file
+	 * @param name Name of the component
+	 * @param data ASTC data with header
+	 * @param size Size of the data in bytes
+	 */
+	Astc(const std::string &name, const uint8_t *data, size_t size);
+
+	/**
+	 * @brief Reads the header of an ASTC file, the data is decoded once written by write_payload()
+	 * @param name Name of the component
+	 * @param file ASTC file with header
+	 */
+	Astc(const std::string &name, filesystem::MappedFilePtr file);
+
 	virtual ~Astc() = default;
 
+  protected:
+	void write_pending_payload(uint8_t *dst) override;
+
   private:
 	/**
-	 * @brief Decodes ASTC data
+	 * @brief Decodes ASTC data into the image data
 	 * @param blockdim Dimensions of the block
 	 * @param extent Extent of the image
 	 * @param data Pointer to ASTC image data
 	 */
 	void decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data, uint32_t size);
 
+	/**
+	 * @brief Decodes ASTC data to RGBA8 texels
+	 * @param dst Destination of extent.width * extent.height * extent.depth * 4 bytes
+	 */
+	void decode_into(BlockDim blockdim, VkExtent3D extent, const uint8_t *data, uint32_t size, uint8_t *dst);
+
 	/**
 	 * @brief Initializes ASTC library
 	 */
 	void init();
+
+	/// Source of a pending payload
+	filesystem::MappedFilePtr file;
+
+	BlockDim blockdim{};
 };
 }        // namespace sg
 }        // namespace vkb
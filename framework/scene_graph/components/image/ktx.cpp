@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  * Copyright (c) 2019-2024, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -18,7 +18,14 @@
 
 #include "scene_graph/components/image/ktx.h"
 
+#include <atomic>
+#include <cstring>
+#include <string_view>
+
 #include "common/error.h"
+#include "common/helpers.h"
+#include "core/physical_device.h"
+#include "core/util/logging.hpp"
 
 #include <ktx.h>
 #include <ktxvulkan.h>
@@ -27,6 +34,160 @@ namespace vkb
 {
 namespace sg
 {
+namespace
+{
+std::atomic<uint32_t> transcode_format{KTX_TTF_RGBA32};
+
+// Bump the version whenever the entry layout or the transcoder settings change
+constexpr uint32_t KTX_CACHE_MAGIC   = 0x4b545856;        // "VKTK"
+constexpr uint32_t KTX_CACHE_VERSION = 1;
+
+/// Followed by the mipmaps, the offsets of each layer's levels and the texels
+struct KtxCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t depth;
+	uint32_t layers;
+	uint32_t level_count;
+	uint32_t offset_layer_count;
+	uint64_t data_size;
+};
+
+/**
+ * @brief A transcoded texture read back from the cache
+ */
+struct TranscodedTexture
+{
+	KtxCacheHeader header;
+
+	std::vector<Mipmap> mipmaps;
+
+	std::vector<std::vector<VkDeviceSize>> offsets;
+
+	std::vector<uint8_t> data;
+};
+
+inline filesystem::Path get_cache_directory()
+{
+	return filesystem::get()->temp_directory() / "vulkan_samples" / "ktx_cache";
+}
+
+inline filesystem::Path get_cache_entry_path(size_t key)
+{
+	return get_cache_directory() / fmt::format("{:016x}.ktxt", key);
+}
+
+/**
+ * @brief Reads the transcoded texels of a previous run, if they were cached for the same supercompressed data and format
+ */
+inline bool load_cached(size_t key, TranscodedTexture &texture)
+{
+	try
+	{
+		auto fs   = filesystem::get();
+		auto path = get_cache_entry_path(key);
+
+		if (!fs->is_file(path))
+		{
+			return false;
+		}
+
+		auto file = fs->map_file(path);
+
+		auto &header = texture.header;
+		if (file->size() < sizeof(header))
+		{
+			return false;
+		}
+		std::memcpy(&header, file->data(), sizeof(header));
+
+		size_t mipmaps_size = header.level_count * sizeof(Mipmap);
+		size_t offsets_size = static_cast<size_t>(header.offset_layer_count) * header.level_count * sizeof(VkDeviceSize);
+
+		if (header.magic != KTX_CACHE_MAGIC || header.version != KTX_CACHE_VERSION ||
+		    file->size() != sizeof(header) + mipmaps_size + offsets_size + header.data_size)
+		{
+			LOGW("Discarding stale ktx cache entry {}", path.string());
+			return false;
+		}
+
+		auto entry_data = file->data() + sizeof(header);
+
+		texture.mipmaps.resize(header.level_count);
+		std::memcpy(texture.mipmaps.data(), entry_data, mipmaps_size);
+		entry_data += mipmaps_size;
+
+		texture.offsets.resize(header.offset_layer_count);
+		for (auto &layer_offsets : texture.offsets)
+		{
+			layer_offsets.resize(header.level_count);
+			std::memcpy(layer_offsets.data(), entry_data, header.level_count * sizeof(VkDeviceSize));
+			entry_data += header.level_count * sizeof(VkDeviceSize);
+		}
+
+		texture.data.assign(entry_data, entry_data + header.data_size);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read ktx cache entry: {}", e.what());
+		return false;
+	}
+
+	return true;
+}
+
+inline void store_cached(size_t key, const Image &image)
+{
+	const auto &mipmaps = image.get_mipmaps();
+	const auto &offsets = image.get_offsets();
+	const auto &extent  = image.get_extent();
+
+	KtxCacheHeader header{KTX_CACHE_MAGIC, KTX_CACHE_VERSION, static_cast<uint32_t>(image.get_format()),
+	                      extent.width, extent.height, extent.depth, image.get_layers(),
+	                      to_u32(mipmaps.size()), to_u32(offsets.size()), image.get_data().size()};
+
+	std::vector<uint8_t> data(sizeof(header));
+	std::memcpy(data.data(), &header, sizeof(header));
+
+	auto append = [&data](const void *bytes, size_t size) {
+		auto first = reinterpret_cast<const uint8_t *>(bytes);
+		data.insert(data.end(), first, first + size);
+	};
+
+	append(mipmaps.data(), mipmaps.size() * sizeof(Mipmap));
+	for (auto &layer_offsets : offsets)
+	{
+		assert(layer_offsets.size() == mipmaps.size());
+		append(layer_offsets.data(), layer_offsets.size() * sizeof(VkDeviceSize));
+	}
+	append(image.get_data().data(), image.get_data().size());
+
+	try
+	{
+		auto fs        = filesystem::get();
+		auto directory = get_cache_directory();
+		if (!fs->is_directory(directory.parent_path()))
+		{
+			fs->create_directory(directory.parent_path());
+		}
+		if (!fs->is_directory(directory))
+		{
+			fs->create_directory(directory);
+		}
+
+		fs->write_file_atomic(get_cache_entry_path(key), data);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write ktx cache entry: {}", e.what());
+	}
+}
+}        // namespace
+
 struct CallbackData final
 {
 	ktxTexture          *texture;
@@ -65,20 +226,119 @@ static ktx_error_code_e KTX_APIENTRY optimal_tiling_callback(int          mip_le
 	return KTX_SUCCESS;
 }
 
+void Ktx::select_transcode_format(const PhysicalDevice &gpu)
+{
+	const auto &features = gpu.get_features();
+
+	ktx_transcode_fmt_e format = KTX_TTF_RGBA32;
+	if (features.textureCompressionASTC_LDR)
+	{
+		format = KTX_TTF_ASTC_4x4_RGBA;
+	}
+	else if (features.textureCompressionBC)
+	{
+		format = KTX_TTF_BC7_RGBA;
+	}
+	else if (features.textureCompressionETC2)
+	{
+		format = KTX_TTF_ETC2_RGBA;
+	}
+
+	transcode_format = format;
+}
+
 Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType content_type) :
+    Ktx{name, data.data(), data.size(), content_type}
+{}
+
+Ktx::Ktx(const std::string &name, const uint8_t *data, size_t size, ContentType content_type) :
     Image{name}
 {
-	auto data_buffer = reinterpret_cast<const ktx_uint8_t *>(data.data());
-	auto data_size   = static_cast<ktx_size_t>(data.size());
+	load(data, size, content_type, false);
+}
+
+Ktx::Ktx(const std::string &name, filesystem::MappedFilePtr file, ContentType content_type) :
+    Image{name},
+    file{std::move(file)}
+{
+	load(this->file->data(), this->file->size(), content_type, true);
+}
+
+Ktx::~Ktx()
+{
+	if (texture)
+	{
+		ktxTexture_Destroy(texture);
+	}
+}
+
+void Ktx::write_pending_payload(uint8_t *dst)
+{
+	assert(texture && "KTX payload already written");
 
-	ktxTexture *texture;
-	auto        load_ktx_result = ktxTexture_CreateFromMemory(data_buffer,
-	                                                          data_size,
-	                                                          KTX_TEXTURE_CREATE_NO_FLAGS,
-	                                                          &texture);
+	auto load_data_result = ktxTexture_LoadImageData(texture, dst, texture->dataSize);
+
+	ktxTexture_Destroy(texture);
+	texture = nullptr;
+	file.reset();
+
+	if (load_data_result != KTX_SUCCESS)
+	{
+		throw std::runtime_error{"Error loading KTX image data: " + get_name()};
+	}
+}
+
+void Ktx::load(const uint8_t *data, size_t size, ContentType content_type, bool defer_payload)
+{
+	auto data_buffer = reinterpret_cast<const ktx_uint8_t *>(data);
+	auto data_size   = static_cast<ktx_size_t>(size);
+
+	auto load_ktx_result = ktxTexture_CreateFromMemory(data_buffer,
+	                                                   data_size,
+	                                                   KTX_TEXTURE_CREATE_NO_FLAGS,
+	                                                   &texture);
 	if (load_ktx_result != KTX_SUCCESS)
 	{
-		throw std::runtime_error{"Error loading KTX texture: " + name};
+		texture = nullptr;
+		throw std::runtime_error{"Error loading KTX texture: " + get_name()};
+	}
+
+	// Transcoding is slow, so the result is cached on disk for the next runs, keyed by the supercompressed data
+	bool   transcoded = false;
+	size_t cache_key  = 0;
+	if (texture->classId == ktxTexture2_c && ktxTexture2_NeedsTranscoding(reinterpret_cast<ktxTexture2 *>(texture)))
+	{
+		auto format = static_cast<ktx_transcode_fmt_e>(transcode_format.load());
+
+		cache_key = std::hash<std::string_view>{}(std::string_view{reinterpret_cast<const char *>(data), size});
+		hash_combine(cache_key, static_cast<uint32_t>(format));
+
+		TranscodedTexture cached;
+		if (load_cached(cache_key, cached))
+		{
+			ktxTexture_Destroy(texture);
+			texture = nullptr;
+			file.reset();
+
+			set_data(cached.data.data(), cached.data.size());
+			set_format(static_cast<VkFormat>(cached.header.format));
+			set_width(cached.header.width);
+			set_height(cached.header.height);
+			set_depth(cached.header.depth);
+			set_layers(cached.header.layers);
+			get_mut_mipmaps() = std::move(cached.mipmaps);
+			set_offsets(cached.offsets);
+			return;
+		}
+
+		// Loads and transcodes every level, layer and face, the texel data is then in memory
+		auto transcode_result = ktxTexture2_TranscodeBasis(reinterpret_cast<ktxTexture2 *>(texture), format, 0);
+		if (transcode_result != KTX_SUCCESS)
+		{
+			throw std::runtime_error{"Error transcoding KTX texture: " + get_name()};
+		}
+
+		transcoded = true;
 	}
 
 	if (texture->pData)
@@ -86,6 +346,11 @@ Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType
 		// Already loaded
 		set_data(texture->pData, texture->dataSize);
 	}
+	else if (defer_payload)
+	{
+		// Loaded from the file once the destination is known, see write_pending_payload()
+		set_pending_payload(texture->dataSize);
+	}
 	else
 	{
 		// Load
@@ -95,7 +360,7 @@ Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType
 		auto load_data_result = ktxTexture_LoadImageData(texture, mut_data.data(), size);
 		if (load_data_result != KTX_SUCCESS)
 		{
-			throw std::runtime_error{"Error loading KTX image data: " + name};
+			throw std::runtime_error{"Error loading KTX image data: " + get_name()};
 		}
 	}
 
@@ -176,7 +441,18 @@ Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType
 		set_offsets(offsets);
 	}
 
-	ktxTexture_Destroy(texture);
+	if (transcoded)
+	{
+		store_cached(cache_key, *this);
+	}
+
+	// A pending payload still reads from the texture
+	if (!defer_payload || texture->pData)
+	{
+		ktxTexture_Destroy(texture);
+		texture = nullptr;
+		file.reset();
+	}
 }
 
 }        // namespace sg
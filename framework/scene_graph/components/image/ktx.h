@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,18 +17,56 @@
 
 #pragma once
 
+#include "filesystem/filesystem.hpp"
 #include "scene_graph/components/image.h"
 
+struct ktxTexture;
+
 namespace vkb
 {
+class PhysicalDevice;
+
 namespace sg
 {
+/**
+ * @brief A KTX or KTX2 image
+ *
+ * Basis Universal supercompressed KTX2 textures are transcoded on load, to the format chosen by
+ * select_transcode_format(). The transcoded texels are cached on disk, so that later runs skip transcoding.
+ */
 class Ktx : public Image
 {
   public:
+	/**
+	 * @brief Selects the format that the supercompressed textures loaded afterwards, on any thread, are transcoded to:
+	 *        the first one the GPU samples out of ASTC 4x4, BC7 and ETC2, else RGBA8 which is also the default
+	 */
+	static void select_transcode_format(const PhysicalDevice &gpu);
+
 	Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType content_type);
 
-	virtual ~Ktx() = default;
+	/**
+	 * @brief Loads KTX data which the image does not own, such as a mapped file
+	 */
+	Ktx(const std::string &name, const uint8_t *data, size_t size, ContentType content_type);
+
+	/**
+	 * @brief Reads the KTX header and level layout, the texel data stays in the file until written by write_payload()
+	 */
+	Ktx(const std::string &name, filesystem::MappedFilePtr file, ContentType content_type);
+
+	virtual ~Ktx();
+
+  protected:
+	void write_pending_payload(uint8_t *dst) override;
+
+  private:
+	void load(const uint8_t *data, size_t size, ContentType content_type, bool defer_payload);
+
+	/// Source of a pending payload, kept alive while the texture reads from it
+	filesystem::MappedFilePtr file;
+
+	ktxTexture *texture{nullptr};
 };
 
 }        // namespace sg
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -25,6 +25,10 @@ namespace vkb
 namespace sg
 {
 Stb::Stb(const std::string &name, const std::vector<uint8_t> &data, ContentType content_type) :
+    Stb{name, data.data(), data.size(), content_type}
+{}
+
+Stb::Stb(const std::string &name, const uint8_t *data, size_t size, ContentType content_type) :
     Image{name}
 {
 	int width;
@@ -32,8 +36,15 @@ Stb::Stb(const std::string &name, const std::vector<uint8_t> &data, ContentType
 	int comp;
 	int req_comp = 4;
 
-	auto data_buffer = reinterpret_cast<const stbi_uc *>(data.data());
-	auto data_size   = static_cast<int>(data.size());
+	auto data_buffer = reinterpret_cast<const stbi_uc *>(data);
+	auto data_size   = static_cast<int>(size);
+
+	// Grayscale images, such as masks and roughness maps, keep their channels and are read as RGBA through the swizzle
+	// of their view. Color images are still expanded, as sampling single and two channel sRGB formats is optional.
+	if (content_type != Color && stbi_info_from_memory(data_buffer, data_size, &width, &height, &comp) && comp <= 2)
+	{
+		req_comp = comp;
+	}
 
 	auto raw_data = stbi_load_from_memory(data_buffer, data_size, &width, &height, &comp, req_comp);
 
@@ -45,7 +56,21 @@ Stb::Stb(const std::string &name, const std::vector<uint8_t> &data, ContentType
 	set_data(raw_data, width * height * req_comp);
 	stbi_image_free(raw_data);
 
-	set_format(content_type == Color ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM);
+	switch (req_comp)
+	{
+		case 1:
+			set_format(VK_FORMAT_R8_UNORM);
+			set_components({VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE});
+			break;
+		case 2:
+			set_format(VK_FORMAT_R8G8_UNORM);
+			set_components({VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G});
+			break;
+		default:
+			set_format(content_type == Color ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM);
+			break;
+	}
+
 	set_width(to_u32(width));
 	set_height(to_u32(height));
 	set_depth(1u);
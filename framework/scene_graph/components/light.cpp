@@ -33,6 +33,7 @@ std::type_index Light::get_type()
 void Light::set_node(Node &n)
 {
 	node = &n;
+	version++;
 }
 
 Node *Light::get_node()
@@ -43,6 +44,7 @@ Node *Light::get_node()
 void Light::set_light_type(const LightType &type)
 {
 	this->light_type = type;
+	version++;
 }
 
 const LightType &Light::get_light_type()
@@ -53,6 +55,7 @@ const LightType &Light::get_light_type()
 void Light::set_properties(const LightProperties &properties)
 {
 	this->properties = properties;
+	version++;
 }
 
 const LightProperties &Light::get_properties()
@@ -60,5 +63,10 @@ const LightProperties &Light::get_properties()
 	return properties;
 }
 
+uint32_t Light::get_version() const
+{
+	return version;
+}
+
 }        // namespace sg
 }        // namespace vkb
@@ -80,12 +80,19 @@ class Light : public Component
 
 	const LightProperties &get_properties();
 
+	/**
+	 * @return A counter incremented each time the type, properties or node of the light change
+	 */
+	uint32_t get_version() const;
+
   private:
 	Node *node{nullptr};
 
 	LightType light_type;
 
 	LightProperties properties;
+
+	uint32_t version{0};
 };
 
 }        // namespace sg
@@ -0,0 +1,85 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lod_group.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "common/helpers.h"
+
+namespace vkb
+{
+namespace sg
+{
+LodGroup::LodGroup(const std::string &name) :
+    Component{name}
+{}
+
+std::type_index LodGroup::get_type()
+{
+	return typeid(LodGroup);
+}
+
+void LodGroup::add_level(Mesh &mesh, uint32_t submesh_lod, float screen_size)
+{
+	assert((levels.empty() || screen_size <= levels.back().screen_size) && "Levels are added from the finest to the coarsest");
+
+	levels.push_back({&mesh, submesh_lod, screen_size});
+}
+
+const std::vector<LodLevel> &LodGroup::get_levels() const
+{
+	return levels;
+}
+
+uint32_t LodGroup::select_level(float screen_size, uint32_t current_level) const
+{
+	uint32_t level_count = to_u32(levels.size());
+	uint32_t level       = std::min(current_level, level_count);
+
+	while (level < level_count && screen_size < levels[level].screen_size * (1.0f - HYSTERESIS))
+	{
+		++level;
+	}
+
+	while (level > 0 && screen_size > levels[level - 1].screen_size * (1.0f + HYSTERESIS))
+	{
+		--level;
+	}
+
+	return level;
+}
+
+float LodGroup::get_screen_size(const glm::vec3 &center, float radius, const glm::vec3 &camera_position, const glm::mat4 &projection)
+{
+	// The clip w of a perspective projection grows with the distance, the one of an orthographic projection is one
+	float distance = glm::length(center - camera_position);
+	float w        = std::abs(projection[2][3]) * distance + projection[3][3];
+
+	if (w <= radius * std::abs(projection[2][3]))
+	{
+		// The camera is within the sphere
+		return std::numeric_limits<float>::max();
+	}
+
+	return radius * std::abs(projection[1][1]) / w;
+}
+}        // namespace sg
+}        // namespace vkb
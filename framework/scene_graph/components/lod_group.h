@@ -0,0 +1,97 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "common/glm_common.h"
+#include "scene_graph/component.h"
+
+namespace vkb
+{
+namespace sg
+{
+class Mesh;
+
+/**
+ * @brief A level of detail of a LodGroup
+ */
+struct LodLevel
+{
+	/// Mesh drawn at this level, the mesh of the node for the simplified levels of its submeshes
+	Mesh *mesh;
+
+	/// Level of SubMesh::lods drawn for each submesh of the mesh, 0 for the full detail
+	uint32_t submesh_lod;
+
+	/// Smallest screen size the level is drawn at, see LodGroup::get_screen_size()
+	float screen_size;
+};
+
+/**
+ * @brief The levels of detail of a mesh node, set on the node next to the Mesh it draws at full detail
+ *
+ * Levels are ordered from the finest to the coarsest, with decreasing screen sizes. A node whose screen size is below the
+ * one of its coarsest level is not drawn, so a coarsest level with a screen size of zero is always drawn.
+ * The level of a node moves to a coarser one only once its screen size is a margin below the threshold, and back to a
+ * finer one once it is the same margin above, so that nodes near a threshold do not switch levels every frame.
+ */
+class LodGroup : public Component
+{
+  public:
+	/// Relative margin around the screen size thresholds of the levels
+	static constexpr float HYSTERESIS = 0.1f;
+
+	LodGroup(const std::string &name);
+
+	virtual ~LodGroup() = default;
+
+	virtual std::type_index get_type() override;
+
+	/**
+	 * @brief Appends a level, coarser than the previous ones
+	 */
+	void add_level(Mesh &mesh, uint32_t submesh_lod, float screen_size);
+
+	const std::vector<LodLevel> &get_levels() const;
+
+	/**
+	 * @brief Selects the level to draw a node at
+	 * @param screen_size The screen size of the node
+	 * @param current_level The level the node was drawn at in the previous frame
+	 * @return The index of the level, or the number of levels if the node is not drawn
+	 */
+	uint32_t select_level(float screen_size, uint32_t current_level) const;
+
+	/**
+	 * @brief Computes the screen size of a bounding sphere: the fraction of the viewport height its diameter covers
+	 * @param center Center of the sphere in world space
+	 * @param radius Radius of the sphere
+	 * @param camera_position Position of the camera in world space
+	 * @param projection Projection matrix of the camera, perspective or orthographic
+	 */
+	static float get_screen_size(const glm::vec3 &center, float radius, const glm::vec3 &camera_position, const glm::mat4 &projection);
+
+  private:
+	std::vector<LodLevel> levels;
+};
+}        // namespace sg
+}        // namespace vkb
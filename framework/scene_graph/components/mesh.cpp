@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -40,6 +40,22 @@ const AABB &Mesh::get_bounds() const
 	return bounds;
 }
 
+void Mesh::set_position_quantization(const glm::vec3 &offset, const glm::vec3 &scale)
+{
+	position_offset = offset;
+	position_scale  = scale;
+}
+
+const glm::vec3 &Mesh::get_position_offset() const
+{
+	return position_offset;
+}
+
+const glm::vec3 &Mesh::get_position_scale() const
+{
+	return position_scale;
+}
+
 void Mesh::add_submesh(SubMesh &submesh)
 {
 	submeshes.push_back(&submesh);
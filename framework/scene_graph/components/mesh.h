@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -44,6 +44,21 @@ class Mesh : public Component
 
 	const AABB &get_bounds() const;
 
+	/**
+	 * @brief Sets the box the quantized positions of the submeshes are normalized in, see VertexQuantization::Compressed
+	 */
+	void set_position_quantization(const glm::vec3 &offset, const glm::vec3 &scale);
+
+	/**
+	 * @return The model space position of the quantized position zero, zero if the positions are not quantized
+	 */
+	const glm::vec3 &get_position_offset() const;
+
+	/**
+	 * @return The model space extent of the quantized positions, one if the positions are not quantized
+	 */
+	const glm::vec3 &get_position_scale() const;
+
 	void add_submesh(SubMesh &submesh);
 
 	const std::vector<SubMesh *> &get_submeshes() const;
@@ -55,6 +70,10 @@ class Mesh : public Component
   private:
 	AABB bounds;
 
+	glm::vec3 position_offset{0.0f};
+
+	glm::vec3 position_scale{1.0f};
+
 	std::vector<SubMesh *> submeshes;
 
 	std::vector<Node *> nodes;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -23,7 +23,13 @@ namespace sg
 {
 Sampler::Sampler(const std::string &name, core::Sampler &&vk_sampler) :
     Component{name},
-    vk_sampler{std::move(vk_sampler)}
+    owned_sampler{std::make_unique<core::Sampler>(std::move(vk_sampler))},
+    vk_sampler{*owned_sampler}
+{}
+
+Sampler::Sampler(const std::string &name, core::Sampler &vk_sampler) :
+    Component{name},
+    vk_sampler{vk_sampler}
 {}
 
 std::type_index Sampler::get_type()
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -34,13 +34,23 @@ class Sampler : public Component
   public:
 	Sampler(const std::string &name, core::Sampler &&vk_sampler);
 
+	/**
+	 * @brief Refers to a sampler owned by someone else, such as one shared through ResourceCache::request_sampler()
+	 */
+	Sampler(const std::string &name, core::Sampler &vk_sampler);
+
 	Sampler(Sampler &&other) = default;
 
 	virtual ~Sampler() = default;
 
 	virtual std::type_index get_type() override;
 
-	core::Sampler vk_sampler;
+  private:
+	/// Set if the component owns its sampler
+	std::unique_ptr<core::Sampler> owned_sampler;
+
+  public:
+	core::Sampler &vk_sampler;
 };
 }        // namespace sg
 }        // namespace vkb
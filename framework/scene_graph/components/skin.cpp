@@ -0,0 +1,69 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "skin.h"
+
+#include <cassert>
+
+#include "scene_graph/node.h"
+#include "scene_graph/scene_snapshot.h"
+
+namespace vkb
+{
+namespace sg
+{
+Skin::Skin(const std::string &name) :
+    Component{name}
+{}
+
+std::type_index Skin::get_type()
+{
+	return typeid(Skin);
+}
+
+void Skin::set_joints(std::vector<Node *> &&new_joints, std::vector<glm::mat4> &&new_inverse_bind_matrices)
+{
+	assert(new_joints.size() == new_inverse_bind_matrices.size() && "Every joint needs an inverse bind matrix");
+
+	joints                = std::move(new_joints);
+	inverse_bind_matrices = std::move(new_inverse_bind_matrices);
+}
+
+const std::vector<Node *> &Skin::get_joints() const
+{
+	return joints;
+}
+
+const std::vector<glm::mat4> &Skin::get_inverse_bind_matrices() const
+{
+	return inverse_bind_matrices;
+}
+
+void Skin::get_joint_matrices(Node &node, std::vector<glm::mat4> &joint_matrices, const SceneSnapshot *snapshot) const
+{
+	// The skinned vertices are placed by the joints only, so the transform of the node is undone
+	glm::mat4 inverse_world_matrix = glm::inverse(get_node_state(snapshot, node).world_matrix);
+
+	joint_matrices.resize(joints.size());
+
+	for (size_t i = 0; i < joints.size(); ++i)
+	{
+		joint_matrices[i] = inverse_world_matrix * get_node_state(snapshot, *joints[i]).world_matrix * inverse_bind_matrices[i];
+	}
+}
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,72 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "common/glm_common.h"
+#include "scene_graph/component.h"
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+class SceneSnapshot;
+
+/**
+ * @brief The joints deforming a skinned mesh, set on the nodes of the mesh
+ *        Vertices reference up to four joints through their joints_0 attribute, weighted by their weights_0 attribute.
+ */
+class Skin : public Component
+{
+  public:
+	Skin(const std::string &name);
+
+	virtual ~Skin() = default;
+
+	virtual std::type_index get_type() override;
+
+	/**
+	 * @param joints The nodes of the joints
+	 * @param inverse_bind_matrices Transform from model space to the space of each joint in the bind pose
+	 */
+	void set_joints(std::vector<Node *> &&joints, std::vector<glm::mat4> &&inverse_bind_matrices);
+
+	const std::vector<Node *> &get_joints() const;
+
+	const std::vector<glm::mat4> &get_inverse_bind_matrices() const;
+
+	/**
+	 * @brief Computes the matrices of the joints in the model space of a node of the mesh, so that the
+	 *        skinned vertices are transformed by the world matrix of the node as any other vertex
+	 * @param node The node drawing the mesh
+	 * @param joint_matrices Set to one matrix per joint
+	 * @param snapshot The scene snapshot to read the transforms from, or null to read the live nodes
+	 */
+	void get_joint_matrices(Node &node, std::vector<glm::mat4> &joint_matrices, const SceneSnapshot *snapshot = nullptr) const;
+
+  private:
+	std::vector<Node *> joints;
+
+	std::vector<glm::mat4> inverse_bind_matrices;
+};
+}        // namespace sg
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2021, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,9 @@
 
 #include "sub_mesh.h"
 
+#include <algorithm>
+
+#include "common/helpers.h"
 #include "material.h"
 #include "rendering/subpass.h"
 
@@ -24,6 +27,25 @@ namespace vkb
 {
 namespace sg
 {
+namespace
+{
+const std::array<std::string, VERTEX_ATTRIBUTE_SLOT_COUNT> vertex_attribute_slot_names{
+    "position", "normal", "tangent", "texcoord_0", "texcoord_1", "color_0", "joints_0", "weights_0"};
+}        // namespace
+
+VertexAttributeSlot get_vertex_attribute_slot(const std::string &name)
+{
+	auto name_it = std::find(vertex_attribute_slot_names.begin(), vertex_attribute_slot_names.end(), name);
+
+	return static_cast<VertexAttributeSlot>(name_it - vertex_attribute_slot_names.begin());
+}
+
+const std::string &get_vertex_attribute_name(VertexAttributeSlot slot)
+{
+	assert(slot < VertexAttributeSlot::Count);
+	return vertex_attribute_slot_names[static_cast<size_t>(slot)];
+}
+
 SubMesh::SubMesh(const std::string &name) :
     Component{name}
 {}
@@ -33,10 +55,76 @@ std::type_index SubMesh::get_type()
 	return typeid(SubMesh);
 }
 
+core::Buffer *SubMesh::get_vertex_buffer(const std::string &name, VkDeviceSize &offset)
+{
+	auto buffer_it = vertex_buffers.find(name);
+	if (buffer_it != vertex_buffers.end())
+	{
+		offset = 0;
+		return &buffer_it->second;
+	}
+
+	auto shared_it = shared_vertex_buffers.find(name);
+	if (shared_it != shared_vertex_buffers.end())
+	{
+		offset = shared_it->second.offset;
+		return shared_it->second.buffer.get();
+	}
+
+	return nullptr;
+}
+
+core::Buffer *SubMesh::get_vertex_buffer(VertexAttributeSlot slot, VkDeviceSize &offset)
+{
+	if ((slot_mask & (1u << static_cast<std::uint32_t>(slot))) == 0)
+	{
+		return nullptr;
+	}
+
+	return get_vertex_buffer(get_vertex_attribute_name(slot), offset);
+}
+
+core::Buffer *SubMesh::get_index_buffer()
+{
+	return index_buffer ? index_buffer.get() : shared_index_buffer.get();
+}
+
+std::pair<std::uint32_t, std::uint32_t> SubMesh::get_lod_indices(std::uint32_t lod) const
+{
+	if (lod == 0 || lods.empty())
+	{
+		return {first_index, vertex_indices};
+	}
+
+	auto &level = lods[std::min<size_t>(lod, lods.size()) - 1];
+
+	return {first_index + level.first_index, level.index_count};
+}
+
 void SubMesh::set_attribute(const std::string &attribute_name, const VertexAttribute &attribute)
 {
 	vertex_attributes[attribute_name] = attribute;
 
+	auto slot = get_vertex_attribute_slot(attribute_name);
+	if (slot != VertexAttributeSlot::Count)
+	{
+		slot_attributes[static_cast<size_t>(slot)] = attribute;
+		slot_mask |= 1u << static_cast<std::uint32_t>(slot);
+	}
+
+	// Summed so that the hash does not depend on the order of the attributes
+	vertex_layout_hash = 0;
+	for (auto &named_attribute : vertex_attributes)
+	{
+		size_t attribute_hash = 0;
+		hash_combine(attribute_hash, named_attribute.first);
+		hash_combine(attribute_hash, static_cast<std::underlying_type<VkFormat>::type>(named_attribute.second.format));
+		hash_combine(attribute_hash, named_attribute.second.stride);
+		hash_combine(attribute_hash, named_attribute.second.offset);
+
+		vertex_layout_hash += attribute_hash;
+	}
+
 	compute_shader_variant();
 }
 
@@ -54,6 +142,23 @@ bool SubMesh::get_attribute(const std::string &attribute_name, VertexAttribute &
 	return true;
 }
 
+bool SubMesh::get_attribute(VertexAttributeSlot slot, VertexAttribute &attribute) const
+{
+	if ((slot_mask & (1u << static_cast<std::uint32_t>(slot))) == 0)
+	{
+		return false;
+	}
+
+	attribute = slot_attributes[static_cast<size_t>(slot)];
+
+	return true;
+}
+
+size_t SubMesh::get_vertex_layout_hash() const
+{
+	return vertex_layout_hash;
+}
+
 void SubMesh::set_material(const Material &new_material)
 {
 	material = &new_material;
@@ -92,6 +197,17 @@ void SubMesh::compute_shader_variant()
 		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::toupper);
 		shader_variant.add_define("HAS_" + attrib_name);
 	}
+
+	// Attributes compressed by GLTFLoader, see VertexQuantization::Compressed, are decoded by the vertex shaders.
+	// The attributes are read with the same types either way, so the constants are always set and submeshes share shader modules.
+	VertexAttribute attribute;
+	bool            quantized_position = get_attribute(VertexAttributeSlot::Position, attribute) && attribute.format == VK_FORMAT_R16G16B16A16_UNORM;
+	bool            octahedral_normal  = get_attribute(VertexAttributeSlot::Normal, attribute) && attribute.format == VK_FORMAT_R16G16_SNORM;
+	bool            octahedral_tangent = get_attribute(VertexAttributeSlot::Tangent, attribute) && attribute.format == VK_FORMAT_R16G16_SNORM;
+
+	shader_variant.set_specialization_constant(static_cast<uint32_t>(SubMeshSpecializationConstant::QuantizedPosition), quantized_position);
+	shader_variant.set_specialization_constant(static_cast<uint32_t>(SubMeshSpecializationConstant::OctahedralNormal), octahedral_normal);
+	shader_variant.set_specialization_constant(static_cast<uint32_t>(SubMeshSpecializationConstant::OctahedralTangent), octahedral_tangent);
 }
 
 ShaderVariant &SubMesh::get_mut_shader_variant()
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2021, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,15 +17,19 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 #include <typeinfo>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "common/vk_common.h"
 #include "core/buffer.h"
 #include "core/shader_module.h"
+#include "geometry/mesh_optimizer.h"
+#include "geometry/meshlets.h"
 #include "scene_graph/component.h"
 
 namespace vkb
@@ -43,6 +47,57 @@ struct VertexAttribute
 	std::uint32_t offset = 0;
 };
 
+/**
+ * @brief Fixed slots of the standard vertex attributes, named after the glTF attributes in lowercase
+ *        Resolving an attribute name to its slot once allows looking the attribute up by index afterwards.
+ *        Attributes with other names are only found by name.
+ */
+enum class VertexAttributeSlot : std::uint32_t
+{
+	Position,
+	Normal,
+	Tangent,
+	Texcoord0,
+	Texcoord1,
+	Color0,
+	Joints0,
+	Weights0,
+	Count
+};
+
+constexpr size_t VERTEX_ATTRIBUTE_SLOT_COUNT = static_cast<size_t>(VertexAttributeSlot::Count);
+
+/**
+ * @brief Ids of the specialization constants the scene shaders declare for the compressed attributes of a submesh, see
+ *        VertexQuantization::Compressed. Ids start at 100 so that samples can use lower ones in their shaders.
+ */
+enum class SubMeshSpecializationConstant : std::uint32_t
+{
+	QuantizedPosition = 100,
+	OctahedralNormal,
+	OctahedralTangent
+};
+
+/**
+ * @return The slot of an attribute name, VertexAttributeSlot::Count if it is not a standard attribute
+ */
+VertexAttributeSlot get_vertex_attribute_slot(const std::string &name);
+
+/**
+ * @return The name of the attribute of a slot, e.g. "texcoord_0"
+ */
+const std::string &get_vertex_attribute_name(VertexAttributeSlot slot);
+
+/**
+ * @brief Vertex or index data of a submesh within a buffer shared with other submeshes
+ */
+struct SharedBufferRange
+{
+	std::shared_ptr<core::Buffer> buffer;
+
+	VkDeviceSize offset = 0;
+};
+
 class SubMesh : public Component
 {
   public:
@@ -56,6 +111,12 @@ class SubMesh : public Component
 
 	std::uint32_t index_offset = 0;
 
+	/// First index of the submesh, counted from index_offset
+	std::uint32_t first_index = 0;
+
+	/// Added to the vertex indices, or first vertex if the submesh is not indexed
+	std::int32_t vertex_offset = 0;
+
 	std::uint32_t vertices_count = 0;
 
 	std::uint32_t vertex_indices = 0;
@@ -64,10 +125,63 @@ class SubMesh : public Component
 
 	std::unique_ptr<core::Buffer> index_buffer;
 
+	/// Vertex buffers shared with other submeshes, used for the attributes without a buffer in vertex_buffers
+	std::unordered_map<std::string, SharedBufferRange> shared_vertex_buffers;
+
+	/// Index buffer shared with other submeshes, used if index_buffer is not set
+	std::shared_ptr<core::Buffer> shared_index_buffer;
+
+	/// Meshlets of the triangles of the submesh, empty unless built on load, see GLTFLoader::set_meshlet_geometry()
+	MeshletGeometry meshlets;
+
+	/// Simplified levels of detail, drawn from the index data after the vertex_indices of the full detail, coarsest last,
+	/// empty unless built on load, see GLTFLoader::set_mesh_optimization()
+	std::vector<MeshLod> lods;
+
+	/// Vertices packed for vertex pulling, shared with the other submeshes of the scene, nullptr unless built on load,
+	/// see GLTFLoader::set_vertex_pulling()
+	std::shared_ptr<core::Buffer> pulled_vertex_buffer;
+
+	/// Vertex offset to draw with so that gl_VertexIndex indexes the vertices of the submesh in pulled_vertex_buffer
+	std::int32_t pulled_vertex_offset = 0;
+
+	/**
+	 * @brief Finds the buffer holding the data of an attribute, owned by the submesh or shared
+	 * @param name Name of the attribute
+	 * @param offset Set to the offset of the attribute data within the buffer
+	 * @return The buffer, nullptr if there is none for the attribute
+	 */
+	core::Buffer *get_vertex_buffer(const std::string &name, VkDeviceSize &offset);
+
+	core::Buffer *get_vertex_buffer(VertexAttributeSlot slot, VkDeviceSize &offset);
+
+	/**
+	 * @return The index buffer, owned by the submesh or shared, nullptr if there is none
+	 */
+	core::Buffer *get_index_buffer();
+
+	/**
+	 * @brief Finds the index data of a level of detail, see lods
+	 * @param lod Level of detail, 0 for the full detail, the coarsest level if the submesh has fewer levels
+	 * @return The first index of the level, counted from index_offset, and its index count
+	 */
+	std::pair<std::uint32_t, std::uint32_t> get_lod_indices(std::uint32_t lod) const;
+
 	void set_attribute(const std::string &name, const VertexAttribute &attribute);
 
 	bool get_attribute(const std::string &name, VertexAttribute &attribute) const;
 
+	/**
+	 * @brief Looks up the attribute of a slot, without hashing its name
+	 */
+	bool get_attribute(VertexAttributeSlot slot, VertexAttribute &attribute) const;
+
+	/**
+	 * @return A hash of the names, formats, strides and offsets of the attributes,
+	 *         equal for submeshes which need the same vertex input state
+	 */
+	size_t get_vertex_layout_hash() const;
+
 	void set_material(const Material &material);
 
 	const Material *get_material() const;
@@ -79,6 +193,14 @@ class SubMesh : public Component
   private:
 	std::unordered_map<std::string, VertexAttribute> vertex_attributes;
 
+	/// Attributes of the standard slots, also found in vertex_attributes
+	std::array<VertexAttribute, VERTEX_ATTRIBUTE_SLOT_COUNT> slot_attributes;
+
+	/// Bit per slot with an attribute in slot_attributes
+	std::uint32_t slot_mask{0};
+
+	size_t vertex_layout_hash{0};
+
 	const Material *material{nullptr};
 
 	ShaderVariant shader_variant;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -45,6 +45,8 @@ void Transform::set_translation(const glm::vec3 &new_translation)
 {
 	translation = new_translation;
 
+	version++;
+
 	invalidate_world_matrix();
 }
 
@@ -52,6 +54,8 @@ void Transform::set_rotation(const glm::quat &new_rotation)
 {
 	rotation = new_rotation;
 
+	version++;
+
 	invalidate_world_matrix();
 }
 
@@ -59,6 +63,8 @@ void Transform::set_scale(const glm::vec3 &new_scale)
 {
 	scale = new_scale;
 
+	version++;
+
 	invalidate_world_matrix();
 }
 
@@ -83,6 +89,8 @@ void Transform::set_matrix(const glm::mat4 &matrix)
 	glm::vec4 perspective;
 	glm::decompose(matrix, scale, rotation, translation, skew, perspective);
 
+	version++;
+
 	invalidate_world_matrix();
 }
 
@@ -102,7 +110,44 @@ glm::mat4 Transform::get_world_matrix()
 
 void Transform::invalidate_world_matrix()
 {
+	// Descendants of a dirty node are always dirty too, so there is nothing left to propagate
+	if (update_world_matrix)
+	{
+		return;
+	}
+
 	update_world_matrix = true;
+
+	for (auto child : node.get_children())
+	{
+		child->get_transform().invalidate_world_matrix();
+	}
+}
+
+bool Transform::is_world_matrix_dirty() const
+{
+	return update_world_matrix;
+}
+
+void Transform::set_world_matrix(const glm::mat4 &new_world_matrix)
+{
+	world_matrix        = new_world_matrix;
+	update_world_matrix = false;
+}
+
+const glm::mat4 &Transform::get_previous_world_matrix() const
+{
+	return previous_world_matrix;
+}
+
+void Transform::set_previous_world_matrix(const glm::mat4 &new_previous_world_matrix)
+{
+	previous_world_matrix = new_previous_world_matrix;
+}
+
+uint32_t Transform::get_version() const
+{
+	return version;
 }
 
 void Transform::update_world_transform()
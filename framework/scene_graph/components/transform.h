@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -67,10 +67,38 @@ class Transform : public Component
 	/**
 	 * @brief Marks the world transform invalid if any of
 	 *        the local transform are changed or the parent
-	 *        world transform has changed.
+	 *        world transform has changed. The world transforms
+	 *        of all descendants are invalidated as well.
 	 */
 	void invalidate_world_matrix();
 
+	/**
+	 * @return True if the world matrix has to be recomputed
+	 */
+	bool is_world_matrix_dirty() const;
+
+	/**
+	 * @brief Stores a world matrix computed by the caller and marks it valid
+	 *        Used by Scene::update_world_matrices, which updates a whole scene in parent before child order
+	 */
+	void set_world_matrix(const glm::mat4 &world_matrix);
+
+	/**
+	 * @return The world matrix of the previous Scene::update_world_matrices() call, for motion vectors
+	 *         It is the current world matrix until the scene was updated twice with the node.
+	 */
+	const glm::mat4 &get_previous_world_matrix() const;
+
+	/**
+	 * @brief Keeps the world matrix of the previous update, set by Scene::update_world_matrices
+	 */
+	void set_previous_world_matrix(const glm::mat4 &previous_world_matrix);
+
+	/**
+	 * @return A counter incremented each time the local transform changes, to detect changes without comparing it
+	 */
+	uint32_t get_version() const;
+
   private:
 	Node &node;
 
@@ -82,8 +110,12 @@ class Transform : public Component
 
 	glm::mat4 world_matrix = glm::mat4(1.0);
 
+	glm::mat4 previous_world_matrix = glm::mat4(1.0);
+
 	bool update_world_matrix = false;
 
+	uint32_t version = 0;
+
 	void update_world_transform();
 };
 
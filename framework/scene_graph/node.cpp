@@ -57,6 +57,8 @@ Node *Node::get_parent() const
 void Node::add_child(Node &child)
 {
 	children.push_back(&child);
+
+	child.get_transform().invalidate_world_matrix();
 }
 
 const std::vector<Node *> &Node::get_children() const
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -61,7 +61,8 @@ class Node
 	template <class T>
 	inline T &get_component()
 	{
-		return dynamic_cast<T &>(get_component(typeid(T)));
+		// Components are found by their type, so the cast can not fail
+		return static_cast<T &>(get_component(typeid(T)));
 	}
 
 	Component &get_component(const std::type_index index);
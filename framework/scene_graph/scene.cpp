@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2023, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,8 +17,11 @@
 
 #include "scene.h"
 
+#include <future>
 #include <queue>
 
+#include <core/util/job_system.hpp>
+
 #include "component.h"
 #include "components/sub_mesh.h"
 #include "node.h"
@@ -45,21 +48,28 @@ void Scene::set_nodes(std::vector<std::unique_ptr<Node>> &&n)
 {
 	assert(nodes.empty() && "Scene nodes were already set");
 	nodes = std::move(n);
+
+	invalidate_transform_order();
 }
 
 void Scene::add_node(std::unique_ptr<Node> &&n)
 {
 	nodes.emplace_back(std::move(n));
+
+	invalidate_transform_order();
 }
 
 void Scene::add_child(Node &child)
 {
 	root->add_child(child);
+
+	invalidate_transform_order();
 }
 
 std::unique_ptr<Component> Scene::get_model(uint32_t index)
 {
 	auto meshes = std::move(components.at(typeid(SubMesh)));
+	update_component_pointers(typeid(SubMesh));
 
 	assert(index < meshes.size());
 	return std::move(meshes[index]);
@@ -69,23 +79,30 @@ void Scene::add_component(std::unique_ptr<Component> &&component, Node &node)
 {
 	node.set_component(*component);
 
-	if (component)
-	{
-		components[component->get_type()].push_back(std::move(component));
-	}
+	// The node may have become a mesh node
+	bvh_dirty = true;
+
+	add_component(std::move(component));
 }
 
 void Scene::add_component(std::unique_ptr<Component> &&component)
 {
 	if (component)
 	{
-		components[component->get_type()].push_back(std::move(component));
+		auto type_info = component->get_type();
+
+		component_pointers[type_info].push_back(component.get());
+		components[type_info].push_back(std::move(component));
+
+		component_generation++;
 	}
 }
 
 void Scene::set_components(const std::type_index &type_info, std::vector<std::unique_ptr<Component>> &&new_components)
 {
 	components[type_info] = std::move(new_components);
+
+	update_component_pointers(type_info);
 }
 
 const std::vector<std::unique_ptr<Component>> &Scene::get_components(const std::type_index &type_info) const
@@ -99,41 +116,244 @@ bool Scene::has_component(const std::type_index &type_info) const
 	return (component != components.end() && !component->second.empty());
 }
 
+uint64_t Scene::get_component_generation() const
+{
+	return component_generation;
+}
+
 Node *Scene::find_node(const std::string &node_name)
 {
-	for (auto root_node : root->get_children())
+	if (node_names_dirty)
 	{
-		std::queue<sg::Node *> traverse_nodes{};
-		traverse_nodes.push(root_node);
+		node_names.clear();
 
-		while (!traverse_nodes.empty())
+		for (auto root_node : root->get_children())
 		{
-			auto node = traverse_nodes.front();
-			traverse_nodes.pop();
+			std::queue<sg::Node *> traverse_nodes{};
+			traverse_nodes.push(root_node);
 
-			if (node->get_name() == node_name)
+			while (!traverse_nodes.empty())
 			{
-				return node;
-			}
+				auto node = traverse_nodes.front();
+				traverse_nodes.pop();
 
-			for (auto child_node : node->get_children())
-			{
-				traverse_nodes.push(child_node);
+				// Keeps the first node of a name, like the search it replaces
+				node_names.emplace(node->get_name(), node);
+
+				for (auto child_node : node->get_children())
+				{
+					traverse_nodes.push(child_node);
+				}
 			}
 		}
+
+		node_names_dirty = false;
 	}
 
-	return nullptr;
+	auto it = node_names.find(node_name);
+
+	return it != node_names.end() ? it->second : nullptr;
 }
 
 void Scene::set_root_node(Node &node)
 {
 	root = &node;
+
+	invalidate_transform_order();
 }
 
 Node &Scene::get_root_node()
 {
 	return *root;
 }
+
+void Scene::update_world_matrices(JobSystem *job_system)
+{
+	// Levels narrower than this are not worth the cost of dispatching to the job system
+	const size_t parallel_level_width = 1024;
+
+	// The matrices of the last update are the previous world matrices of the nodes, unless the order changed since
+	bool has_history = !transform_order_dirty && !world_matrices.empty();
+
+	build_transform_order();
+
+	world_matrices.resize(transform_order.size());
+	world_matrix_changes.resize(transform_order.size());
+
+	auto update_range = [this, has_history](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			auto &transform = transform_order[i]->get_transform();
+
+			if (has_history)
+			{
+				transform.set_previous_world_matrix(world_matrices[i]);
+			}
+
+			world_matrix_changes[i] = transform.is_world_matrix_dirty() || !has_history;
+
+			if (transform.is_world_matrix_dirty())
+			{
+				int32_t parent = transform_parents[i];
+
+				// Parents live in an earlier level, so their matrix is already up to date
+				glm::mat4 world_matrix = transform.get_matrix();
+				if (parent >= 0)
+				{
+					world_matrix = world_matrices[parent] * world_matrix;
+				}
+
+				transform.set_world_matrix(world_matrix);
+			}
+
+			world_matrices[i] = transform.get_world_matrix();
+
+			if (!has_history)
+			{
+				transform.set_previous_world_matrix(world_matrices[i]);
+			}
+		}
+	};
+
+	for (size_t level = 0; level + 1 < transform_level_offsets.size(); ++level)
+	{
+		size_t level_begin = transform_level_offsets[level];
+		size_t level_end   = transform_level_offsets[level + 1];
+		size_t level_width = level_end - level_begin;
+
+		if (!job_system || job_system->get_worker_count() == 0 || level_width < parallel_level_width)
+		{
+			update_range(level_begin, level_end);
+			continue;
+		}
+
+		// The level is done once parallel_for returns, before the next level reads its matrices
+		job_system->parallel_for(level_width, parallel_level_width / 2, [&update_range, level_begin](size_t begin, size_t end) {
+			update_range(level_begin + begin, level_begin + end);
+		});
+	}
+
+	if (bvh)
+	{
+		if (bvh_dirty)
+		{
+			bvh->build(*this);
+			bvh_dirty = false;
+		}
+		else
+		{
+			bvh->refit(*this, job_system);
+		}
+	}
+}
+
+const std::vector<glm::mat4> &Scene::get_world_matrices() const
+{
+	return world_matrices;
+}
+
+const std::vector<uint8_t> &Scene::get_world_matrix_changes() const
+{
+	return world_matrix_changes;
+}
+
+void Scene::set_bvh_enabled(bool enabled)
+{
+	if (!enabled)
+	{
+		bvh.reset();
+	}
+	else if (!bvh)
+	{
+		bvh       = std::make_unique<SceneBVH>();
+		bvh_dirty = true;
+	}
+}
+
+const SceneBVH *Scene::get_bvh() const
+{
+	return bvh && !bvh_dirty ? bvh.get() : nullptr;
+}
+
+const std::vector<Node *> &Scene::get_transform_order()
+{
+	build_transform_order();
+
+	return transform_order;
+}
+
+void Scene::invalidate_transform_order()
+{
+	transform_order_dirty = true;
+	node_names_dirty      = true;
+	bvh_dirty             = true;
+}
+
+void Scene::update_component_pointers(const std::type_index &type_info)
+{
+	auto &pointers = component_pointers[type_info];
+	pointers.clear();
+
+	for (auto &component : components[type_info])
+	{
+		pointers.push_back(component.get());
+	}
+
+	component_generation++;
+}
+
+void Scene::build_transform_order()
+{
+	if (!transform_order_dirty)
+	{
+		return;
+	}
+
+	transform_order.clear();
+	transform_parents.clear();
+	transform_level_offsets.clear();
+
+	std::unordered_map<const Node *, int32_t> node_indices;
+
+	// Every node without a parent starts a hierarchy, this includes the root node and any detached nodes
+	for (auto &node : nodes)
+	{
+		if (!node->get_parent())
+		{
+			node_indices[node.get()] = static_cast<int32_t>(transform_order.size());
+			transform_order.push_back(node.get());
+			transform_parents.push_back(-1);
+		}
+	}
+
+	size_t level_begin = 0;
+	while (level_begin < transform_order.size())
+	{
+		size_t level_end = transform_order.size();
+		transform_level_offsets.push_back(level_begin);
+
+		for (size_t i = level_begin; i < level_end; ++i)
+		{
+			for (auto child : transform_order[i]->get_children())
+			{
+				// Follow the same parent links as Transform, and guard against a node listed as a child of several parents
+				if (child->get_parent() != transform_order[i] || node_indices.count(child))
+				{
+					continue;
+				}
+
+				node_indices[child] = static_cast<int32_t>(transform_order.size());
+				transform_order.push_back(child);
+				transform_parents.push_back(static_cast<int32_t>(i));
+			}
+		}
+
+		level_begin = level_end;
+	}
+
+	transform_level_offsets.push_back(transform_order.size());
+
+	transform_order_dirty = false;
+}
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
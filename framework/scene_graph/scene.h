@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2020, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -18,23 +18,171 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <typeindex>
 #include <unordered_map>
 #include <vector>
 
+#include "common/glm_common.h"
 #include "scene_graph/components/light.h"
 #include "scene_graph/components/texture.h"
+#include "scene_graph/scene_bvh.h"
 
 namespace vkb
 {
+class JobSystem;
+
 namespace sg
 {
 class Node;
 class Component;
 class SubMesh;
 
+/**
+ * @brief A typed view of the components of one type in a Scene
+ *        It reads the contiguous component pointers kept by the scene, so it neither allocates nor casts dynamically.
+ *        The view is invalidated when components of its type are added, set or taken from the scene.
+ */
+template <class T>
+class ComponentView
+{
+  public:
+	class Iterator
+	{
+	  public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type        = T *;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = T *const *;
+		using reference         = T *;
+
+		Iterator() = default;
+
+		explicit Iterator(Component *const *component) :
+		    component{component}
+		{}
+
+		T *operator*() const
+		{
+			return static_cast<T *>(*component);
+		}
+
+		T *operator[](difference_type offset) const
+		{
+			return static_cast<T *>(component[offset]);
+		}
+
+		Iterator &operator++()
+		{
+			++component;
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			return Iterator{component++};
+		}
+
+		Iterator &operator--()
+		{
+			--component;
+			return *this;
+		}
+
+		Iterator operator--(int)
+		{
+			return Iterator{component--};
+		}
+
+		Iterator &operator+=(difference_type offset)
+		{
+			component += offset;
+			return *this;
+		}
+
+		Iterator &operator-=(difference_type offset)
+		{
+			component -= offset;
+			return *this;
+		}
+
+		Iterator operator+(difference_type offset) const
+		{
+			return Iterator{component + offset};
+		}
+
+		Iterator operator-(difference_type offset) const
+		{
+			return Iterator{component - offset};
+		}
+
+		difference_type operator-(const Iterator &other) const
+		{
+			return component - other.component;
+		}
+
+		bool operator==(const Iterator &other) const
+		{
+			return component == other.component;
+		}
+
+		bool operator!=(const Iterator &other) const
+		{
+			return component != other.component;
+		}
+
+		bool operator<(const Iterator &other) const
+		{
+			return component < other.component;
+		}
+
+	  private:
+		Component *const *component{nullptr};
+	};
+
+	ComponentView() = default;
+
+	ComponentView(Component *const *components, size_t count) :
+	    components{components},
+	    count{count}
+	{}
+
+	Iterator begin() const
+	{
+		return Iterator{components};
+	}
+
+	Iterator end() const
+	{
+		return Iterator{components + count};
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	T *operator[](size_t index) const
+	{
+		assert(index < count);
+		return static_cast<T *>(components[index]);
+	}
+
+  private:
+	Component *const *components{nullptr};
+
+	size_t count{0};
+};
+
 /// @brief A collection of nodes organized in a tree structure.
 ///		   It can contain more than one root node.
 class Scene
@@ -92,23 +240,29 @@ class Scene
 
 	/**
 	 * @return List of pointers to components casted to the given template type
+	 * @note Prefer get_component_view() in code running every frame, as this allocates the list
 	 */
 	template <class T>
 	std::vector<T *> get_components() const
 	{
-		std::vector<T *> result;
-		if (has_component(typeid(T)))
-		{
-			auto &scene_components = get_components(typeid(T));
+		auto view = get_component_view<T>();
+
+		return std::vector<T *>(view.begin(), view.end());
+	}
 
-			result.resize(scene_components.size());
-			std::transform(scene_components.begin(), scene_components.end(), result.begin(),
-			               [](const std::unique_ptr<Component> &component) -> T * {
-				               return dynamic_cast<T *>(component.get());
-			               });
+	/**
+	 * @return A view of the components of the given template type, which does not allocate
+	 */
+	template <class T>
+	ComponentView<T> get_component_view() const
+	{
+		auto it = component_pointers.find(typeid(T));
+		if (it == component_pointers.end())
+		{
+			return {};
 		}
 
-		return result;
+		return ComponentView<T>{it->second.data(), it->second.size()};
 	}
 
 	/**
@@ -124,13 +278,70 @@ class Scene
 
 	bool has_component(const std::type_index &type_info) const;
 
+	/**
+	 * @return A counter incremented whenever components are added to or removed from the scene,
+	 *         for the caches of per-component data to be discarded
+	 */
+	uint64_t get_component_generation() const;
+
+	/**
+	 * @return The first node of the name below the root node, or nullptr if there is none
+	 *         The nodes are indexed by name on the first call after the hierarchy changed, call invalidate_transform_order()
+	 *         after reparenting nodes directly.
+	 */
 	Node *find_node(const std::string &name);
 
 	void set_root_node(Node &node);
 
 	Node &get_root_node();
 
+	/**
+	 * @brief Recomputes the world matrices of all nodes, visiting parents before their children
+	 *        Only nodes whose world transform was invalidated are recomputed. The results are
+	 *        stored in each node Transform and in a contiguous array, see get_world_matrices().
+	 *        The matrices of the previous call are kept as the previous world matrices of the transforms.
+	 * @param job_system If given, hierarchy levels wider than a threshold are updated in parallel
+	 */
+	void update_world_matrices(JobSystem *job_system = nullptr);
+
+	/**
+	 * @return The world matrices of the last update_world_matrices() call, in the order of get_transform_order()
+	 */
+	const std::vector<glm::mat4> &get_world_matrices() const;
+
+	/**
+	 * @return For each node in the order of get_transform_order(), 1 if the last update_world_matrices() call recomputed
+	 *         its world matrix and 0 otherwise
+	 */
+	const std::vector<uint8_t> &get_world_matrix_changes() const;
+
+	/**
+	 * @brief Enables or disables the bounding volume hierarchy of the mesh nodes, disabled by default
+	 *        Once enabled, it is built on the next update_world_matrices() call, and refit by the following ones.
+	 *        Adding nodes or components to the scene rebuilds it.
+	 */
+	void set_bvh_enabled(bool enabled);
+
+	/**
+	 * @return The bounding volume hierarchy of the mesh nodes, or nullptr if it is not enabled or not built since the scene changed
+	 */
+	const SceneBVH *get_bvh() const;
+
+	/**
+	 * @return All nodes of the scene in parent before child order
+	 */
+	const std::vector<Node *> &get_transform_order();
+
+	/**
+	 * @brief Forces the transform order to be rebuilt, call after reparenting nodes directly
+	 */
+	void invalidate_transform_order();
+
   private:
+	void build_transform_order();
+
+	void update_component_pointers(const std::type_index &type_info);
+
 	std::string name;
 
 	/// List of all the nodes
@@ -139,6 +350,38 @@ class Scene
 	Node *root{nullptr};
 
 	std::unordered_map<std::type_index, std::vector<std::unique_ptr<Component>>> components;
+
+	/// Contiguous pointers to the components of each type, in the order of components, read by get_component_view()
+	std::unordered_map<std::type_index, std::vector<Component *>> component_pointers;
+
+	/// See get_component_generation()
+	uint64_t component_generation{0};
+
+	/// All nodes in breadth first order, so that every level of the hierarchy is contiguous
+	std::vector<Node *> transform_order;
+
+	/// Index into transform_order of the parent of each node, or -1 for roots
+	std::vector<int32_t> transform_parents;
+
+	/// Offsets into transform_order at which each hierarchy level starts, plus the total count
+	std::vector<size_t> transform_level_offsets;
+
+	std::vector<glm::mat4> world_matrices;
+
+	/// See get_world_matrix_changes()
+	std::vector<uint8_t> world_matrix_changes;
+
+	bool transform_order_dirty{true};
+
+	/// Nodes by name for find_node(), the first one in traversal order for names used several times
+	std::unordered_map<std::string, Node *> node_names;
+
+	bool node_names_dirty{true};
+
+	/// Set by set_bvh_enabled()
+	std::unique_ptr<SceneBVH> bvh;
+
+	bool bvh_dirty{true};
 };
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
@@ -0,0 +1,528 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scene_bvh.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "common/helpers.h"
+#include "geometry/frustum.h"
+#include "scene_graph/components/aabb.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/skin.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace sg
+{
+namespace
+{
+float get_surface_area(const glm::vec3 &min, const glm::vec3 &max)
+{
+	glm::vec3 extent = glm::max(max - min, glm::vec3(0.0f));
+	return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+/**
+ * @return Whether a box is on the inner side of every plane of a frustum
+ */
+bool intersects(const Frustum &frustum, const glm::vec3 &min, const glm::vec3 &max)
+{
+	for (auto &plane : frustum.get_planes())
+	{
+		// Only the corner furthest along the plane normal needs testing, as in AABBBatch::cull()
+		glm::vec3 corner{plane.x > 0.0f ? max.x : min.x, plane.y > 0.0f ? max.y : min.y, plane.z > 0.0f ? max.z : min.z};
+
+		if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool intersects(const glm::vec3 &center, float radius, const glm::vec3 &min, const glm::vec3 &max)
+{
+	glm::vec3 offset = center - glm::clamp(center, min, max);
+	return glm::dot(offset, offset) <= radius * radius;
+}
+
+/**
+ * @return The distance at which a ray enters a box, or infinity if it misses the box up to max_distance
+ */
+float intersect_ray(const glm::vec3 &origin, const glm::vec3 &inv_direction, float max_distance, const glm::vec3 &min, const glm::vec3 &max)
+{
+	glm::vec3 t0 = (min - origin) * inv_direction;
+	glm::vec3 t1 = (max - origin) * inv_direction;
+
+	glm::vec3 t_near = glm::min(t0, t1);
+	glm::vec3 t_far  = glm::max(t0, t1);
+
+	float enter = std::max(std::max(t_near.x, t_near.y), std::max(t_near.z, 0.0f));
+	float exit  = std::min(std::min(t_far.x, t_far.y), std::min(t_far.z, max_distance));
+
+	return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+}
+}        // namespace
+
+SceneBVH::~SceneBVH()
+{
+	wait_rebuild();
+}
+
+void SceneBVH::build(Scene &scene)
+{
+	wait_rebuild();
+	rebuild.reset();
+
+	items.clear();
+	item_order_indices.clear();
+	item_min.clear();
+	item_max.clear();
+	unbounded_nodes.clear();
+
+	auto &transform_order = scene.get_transform_order();
+
+	for (size_t i = 0; i < transform_order.size(); ++i)
+	{
+		auto node = transform_order[i];
+
+		if (!node->has_component<Mesh>())
+		{
+			continue;
+		}
+
+		if (node->has_component<Skin>())
+		{
+			unbounded_nodes.push_back(node);
+			continue;
+		}
+
+		const AABB &mesh_bounds = node->get_component<Mesh>().get_bounds();
+
+		AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
+		auto world_matrix = node->get_transform().get_world_matrix();
+		world_bounds.transform(world_matrix);
+
+		items.push_back(node);
+		item_order_indices.push_back(static_cast<uint32_t>(i));
+		item_min.push_back(world_bounds.get_min());
+		item_max.push_back(world_bounds.get_max());
+	}
+
+	tree       = build_tree(item_min, item_max);
+	build_area = tree.area;
+}
+
+void SceneBVH::refit(Scene &scene, JobSystem *job_system)
+{
+	// A finished rebuild replaces the tree, then it is refit to the nodes which moved since the bounds were copied
+	bool rebuilt = false;
+	if (rebuild && rebuild_job.is_done())
+	{
+		tree       = std::move(rebuild->tree);
+		build_area = tree.area;
+		rebuild.reset();
+		rebuild_job = {};
+		rebuilt     = true;
+	}
+
+	auto &changes         = scene.get_world_matrix_changes();
+	auto &transform_order = scene.get_transform_order();
+
+	std::vector<uint32_t> changed_items;
+	for (uint32_t i = 0; i < to_u32(items.size()); ++i)
+	{
+		uint32_t order_index = item_order_indices[i];
+
+		if (order_index < changes.size() && changes[order_index])
+		{
+			const AABB &mesh_bounds = items[i]->get_component<Mesh>().get_bounds();
+
+			AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
+			auto world_matrix = transform_order[order_index]->get_transform().get_world_matrix();
+			world_bounds.transform(world_matrix);
+
+			item_min[i] = world_bounds.get_min();
+			item_max[i] = world_bounds.get_max();
+
+			changed_items.push_back(i);
+		}
+	}
+
+	if (tree.nodes.empty())
+	{
+		return;
+	}
+
+	// Walking up from many leaves visits the upper nodes many times, refitting the whole tree is cheaper then
+	if (rebuilt || changed_items.size() * 4 > items.size())
+	{
+		refit_all();
+	}
+	else
+	{
+		for (auto item : changed_items)
+		{
+			refit_path(tree.item_leaves[item]);
+		}
+	}
+
+	if (rebuild || get_cost_ratio() <= REBUILD_COST_RATIO)
+	{
+		return;
+	}
+
+	if (!job_system || job_system->get_worker_count() == 0)
+	{
+		tree       = build_tree(item_min, item_max);
+		build_area = tree.area;
+		return;
+	}
+
+	rebuild           = std::make_shared<Rebuild>();
+	rebuild->item_min = item_min;
+	rebuild->item_max = item_max;
+
+	rebuild_job_system = job_system;
+	rebuild_job        = job_system->submit([state = rebuild]() { state->tree = build_tree(state->item_min, state->item_max); });
+}
+
+void SceneBVH::query_frustum(const Frustum &frustum, std::vector<Node *> &result) const
+{
+	result.insert(result.end(), unbounded_nodes.begin(), unbounded_nodes.end());
+
+	if (tree.nodes.empty())
+	{
+		return;
+	}
+
+	// The median splits halve the nodes, so the depth of the tree stays far below the size of the stack
+	uint32_t stack[64];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0)
+	{
+		auto &node = tree.nodes[stack[--stack_size]];
+
+		if (!intersects(frustum, node.min, node.max))
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; ++i)
+			{
+				uint32_t item = tree.items[i];
+				if (intersects(frustum, item_min[item], item_max[item]))
+				{
+					result.push_back(items[item]);
+				}
+			}
+			continue;
+		}
+
+		stack[stack_size++] = node.first;
+		stack[stack_size++] = node.first + 1;
+	}
+}
+
+void SceneBVH::query_sphere(const glm::vec3 &center, float radius, std::vector<Node *> &result) const
+{
+	result.insert(result.end(), unbounded_nodes.begin(), unbounded_nodes.end());
+
+	if (tree.nodes.empty())
+	{
+		return;
+	}
+
+	uint32_t stack[64];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0)
+	{
+		auto &node = tree.nodes[stack[--stack_size]];
+
+		if (!intersects(center, radius, node.min, node.max))
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; ++i)
+			{
+				uint32_t item = tree.items[i];
+				if (intersects(center, radius, item_min[item], item_max[item]))
+				{
+					result.push_back(items[item]);
+				}
+			}
+			continue;
+		}
+
+		stack[stack_size++] = node.first;
+		stack[stack_size++] = node.first + 1;
+	}
+}
+
+Node *SceneBVH::query_ray(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, float *distance) const
+{
+	if (tree.nodes.empty())
+	{
+		return nullptr;
+	}
+
+	// Infinite components of the inverse direction give the right slab distances for axis aligned rays
+	glm::vec3 inv_direction = 1.0f / direction;
+
+	Node *closest_node     = nullptr;
+	float closest_distance = max_distance;
+
+	uint32_t stack[64];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0)
+	{
+		auto &node = tree.nodes[stack[--stack_size]];
+
+		if (intersect_ray(origin, inv_direction, closest_distance, node.min, node.max) > closest_distance)
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; ++i)
+			{
+				uint32_t item       = tree.items[i];
+				float    item_enter = intersect_ray(origin, inv_direction, closest_distance, item_min[item], item_max[item]);
+				if (item_enter < closest_distance)
+				{
+					closest_node     = items[item];
+					closest_distance = item_enter;
+				}
+			}
+			continue;
+		}
+
+		// The nearer child is visited first, so that the farther one is more likely to be skipped
+		auto &left  = tree.nodes[node.first];
+		auto &right = tree.nodes[node.first + 1];
+
+		float left_enter  = intersect_ray(origin, inv_direction, closest_distance, left.min, left.max);
+		float right_enter = intersect_ray(origin, inv_direction, closest_distance, right.min, right.max);
+
+		stack[stack_size++] = left_enter < right_enter ? node.first + 1 : node.first;
+		stack[stack_size++] = left_enter < right_enter ? node.first : node.first + 1;
+	}
+
+	if (closest_node && distance)
+	{
+		*distance = closest_distance;
+	}
+
+	return closest_node;
+}
+
+size_t SceneBVH::get_node_count() const
+{
+	return items.size();
+}
+
+float SceneBVH::get_cost_ratio() const
+{
+	return build_area > 0.0f ? tree.area / build_area : 1.0f;
+}
+
+SceneBVH::Tree SceneBVH::build_tree(const std::vector<glm::vec3> &item_min, const std::vector<glm::vec3> &item_max)
+{
+	Tree tree;
+
+	uint32_t item_count = to_u32(item_min.size());
+	if (item_count == 0)
+	{
+		return tree;
+	}
+
+	tree.items.resize(item_count);
+	std::iota(tree.items.begin(), tree.items.end(), 0u);
+	tree.item_leaves.resize(item_count);
+
+	std::vector<glm::vec3> centers(item_count);
+	for (uint32_t i = 0; i < item_count; ++i)
+	{
+		centers[i] = (item_min[i] + item_max[i]) * 0.5f;
+	}
+
+	// A binary tree with leaves of at least one item has fewer than twice as many nodes as items
+	tree.nodes.reserve(2 * item_count);
+	tree.parents.reserve(2 * item_count);
+
+	tree.nodes.push_back({});
+	tree.nodes[0].first = 0;
+	tree.nodes[0].count = item_count;
+	tree.parents.push_back(0);
+
+	// Each node is split at the median of the item centers along its widest axis, the nodes to split hold their item range
+	std::vector<uint32_t> pending{0};
+
+	while (!pending.empty())
+	{
+		uint32_t index = pending.back();
+		pending.pop_back();
+
+		uint32_t first = tree.nodes[index].first;
+		uint32_t count = tree.nodes[index].count;
+
+		glm::vec3 bounds_min{std::numeric_limits<float>::max()};
+		glm::vec3 bounds_max{std::numeric_limits<float>::lowest()};
+		glm::vec3 center_min{std::numeric_limits<float>::max()};
+		glm::vec3 center_max{std::numeric_limits<float>::lowest()};
+
+		for (uint32_t i = first; i < first + count; ++i)
+		{
+			uint32_t item = tree.items[i];
+
+			bounds_min = glm::min(bounds_min, item_min[item]);
+			bounds_max = glm::max(bounds_max, item_max[item]);
+			center_min = glm::min(center_min, centers[item]);
+			center_max = glm::max(center_max, centers[item]);
+		}
+
+		tree.nodes[index].min = bounds_min;
+		tree.nodes[index].max = bounds_max;
+		tree.area += get_surface_area(bounds_min, bounds_max);
+
+		if (count <= MAX_LEAF_SIZE)
+		{
+			for (uint32_t i = first; i < first + count; ++i)
+			{
+				tree.item_leaves[tree.items[i]] = index;
+			}
+			continue;
+		}
+
+		glm::vec3 extent = center_max - center_min;
+
+		int axis = extent.y > extent.x ? 1 : 0;
+		axis     = extent.z > extent[axis] ? 2 : axis;
+
+		uint32_t middle = first + count / 2;
+
+		std::nth_element(tree.items.begin() + first, tree.items.begin() + middle, tree.items.begin() + first + count,
+		                 [&centers, axis](uint32_t a, uint32_t b) { return centers[a][axis] < centers[b][axis]; });
+
+		uint32_t child = to_u32(tree.nodes.size());
+
+		tree.nodes.push_back({});
+		tree.nodes.back().first = first;
+		tree.nodes.back().count = middle - first;
+
+		tree.nodes.push_back({});
+		tree.nodes.back().first = middle;
+		tree.nodes.back().count = first + count - middle;
+
+		tree.parents.push_back(index);
+		tree.parents.push_back(index);
+
+		tree.nodes[index].first = child;
+		tree.nodes[index].count = 0;
+
+		pending.push_back(child);
+		pending.push_back(child + 1);
+	}
+
+	return tree;
+}
+
+void SceneBVH::refit_all()
+{
+	// Children come after their parent, so visiting the nodes backwards updates children first
+	for (size_t i = tree.nodes.size(); i-- > 0;)
+	{
+		update_bounds(to_u32(i));
+	}
+}
+
+void SceneBVH::refit_path(uint32_t leaf)
+{
+	uint32_t node = leaf;
+
+	while (update_bounds(node) && node != 0)
+	{
+		node = tree.parents[node];
+	}
+}
+
+bool SceneBVH::update_bounds(uint32_t index)
+{
+	auto &node = tree.nodes[index];
+
+	glm::vec3 bounds_min{std::numeric_limits<float>::max()};
+	glm::vec3 bounds_max{std::numeric_limits<float>::lowest()};
+
+	if (node.count > 0)
+	{
+		for (uint32_t i = node.first; i < node.first + node.count; ++i)
+		{
+			bounds_min = glm::min(bounds_min, item_min[tree.items[i]]);
+			bounds_max = glm::max(bounds_max, item_max[tree.items[i]]);
+		}
+	}
+	else
+	{
+		auto &left  = tree.nodes[node.first];
+		auto &right = tree.nodes[node.first + 1];
+
+		bounds_min = glm::min(left.min, right.min);
+		bounds_max = glm::max(left.max, right.max);
+	}
+
+	if (bounds_min == node.min && bounds_max == node.max)
+	{
+		return false;
+	}
+
+	tree.area += get_surface_area(bounds_min, bounds_max) - get_surface_area(node.min, node.max);
+
+	node.min = bounds_min;
+	node.max = bounds_max;
+
+	return true;
+}
+
+void SceneBVH::wait_rebuild()
+{
+	if (rebuild_job.is_valid() && rebuild_job_system)
+	{
+		rebuild_job_system->wait(rebuild_job);
+	}
+
+	rebuild_job = {};
+}
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,204 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <core/util/job_system.hpp>
+
+#include "common/glm_common.h"
+
+namespace vkb
+{
+class Frustum;
+
+namespace sg
+{
+class Node;
+class Scene;
+
+/**
+ * @brief A bounding volume hierarchy over the world bounds of the mesh nodes of a scene, see Scene::set_bvh_enabled()
+ *
+ * The hierarchy is built once, then refit by every Scene::update_world_matrices() for the nodes whose world matrix changed:
+ * the bounds of their leaves are recomputed and propagated towards the root, so that a few moving nodes only update their
+ * paths in the tree. Refitting keeps the tree valid, but its boxes grow and overlap as nodes move apart. Once the surface
+ * area of its boxes exceeds the one of the last build by REBUILD_COST_RATIO, a new tree is built on the JobSystem from a
+ * copy of the bounds, and it replaces the refit one on a later update.
+ *
+ * The joints of skinned nodes may move their vertices anywhere outside of the bounds of their mesh, so they are not in the
+ * tree and every frustum and sphere query returns them.
+ *
+ * The hierarchy follows the live scene, so with frame pipelining it is ahead of the SceneSnapshot read by the recording.
+ */
+class SceneBVH
+{
+  public:
+	/// Maximum number of mesh nodes in a leaf
+	static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+	/// Ratio of the surface area of a refit tree to the one of its build above which it is rebuilt
+	static constexpr float REBUILD_COST_RATIO = 1.5f;
+
+	SceneBVH() = default;
+
+	SceneBVH(const SceneBVH &) = delete;
+
+	SceneBVH(SceneBVH &&) = delete;
+
+	/**
+	 * @brief Waits for the background rebuild, if any
+	 */
+	~SceneBVH();
+
+	SceneBVH &operator=(const SceneBVH &) = delete;
+
+	SceneBVH &operator=(SceneBVH &&) = delete;
+
+	/**
+	 * @brief Builds the hierarchy from the mesh nodes of the scene, whose world matrices must be up to date
+	 */
+	void build(Scene &scene);
+
+	/**
+	 * @brief Refits the leaves of the nodes whose world matrix changed in the last Scene::update_world_matrices()
+	 * @param job_system If given, the hierarchy is rebuilt on it in the background once its quality degrades,
+	 *        otherwise it is rebuilt immediately
+	 */
+	void refit(Scene &scene, JobSystem *job_system = nullptr);
+
+	/**
+	 * @brief Appends the mesh nodes whose bounds intersect a frustum
+	 */
+	void query_frustum(const Frustum &frustum, std::vector<Node *> &result) const;
+
+	/**
+	 * @brief Appends the mesh nodes whose bounds intersect a sphere, as an example the range of a point light
+	 */
+	void query_sphere(const glm::vec3 &center, float radius, std::vector<Node *> &result) const;
+
+	/**
+	 * @brief Finds the mesh node whose bounds are entered first by a ray, skinned nodes are not tested
+	 *        Only the bounds are tested, so picking a precise triangle needs a test against the submeshes of the node.
+	 * @param origin The origin of the ray
+	 * @param direction The direction of the ray, distances are in units of its length
+	 * @param max_distance The distance beyond which bounds are not tested
+	 * @param[out] distance If given, set to the distance at which the ray enters the bounds of the node
+	 * @return The node, or nullptr if the ray does not hit any bounds
+	 */
+	Node *query_ray(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, float *distance = nullptr) const;
+
+	/**
+	 * @return The number of mesh nodes in the tree
+	 */
+	size_t get_node_count() const;
+
+	/**
+	 * @return The ratio of the surface area of the tree to the one of its last build, see REBUILD_COST_RATIO
+	 */
+	float get_cost_ratio() const;
+
+  private:
+	struct Bounds
+	{
+		glm::vec3 min{0.0f};
+
+		/// Index of the first child for internal nodes, whose second child follows it, or of the first item for leaves
+		uint32_t first{0};
+
+		glm::vec3 max{0.0f};
+
+		/// Number of items of a leaf, 0 for internal nodes
+		uint32_t count{0};
+	};
+
+	struct Tree
+	{
+		/// The root first, children always come after their parent
+		std::vector<Bounds> nodes;
+
+		/// Indices into the items of the tree, each leaf owning a contiguous range
+		std::vector<uint32_t> items;
+
+		/// Parent of each node, the root has no parent
+		std::vector<uint32_t> parents;
+
+		/// Leaf of each item
+		std::vector<uint32_t> item_leaves;
+
+		/// Sum of the surface areas of the nodes
+		float area{0.0f};
+	};
+
+	/// State of a rebuild on the job system, shared with its job
+	struct Rebuild
+	{
+		std::vector<glm::vec3> item_min;
+
+		std::vector<glm::vec3> item_max;
+
+		Tree tree;
+	};
+
+	static Tree build_tree(const std::vector<glm::vec3> &item_min, const std::vector<glm::vec3> &item_max);
+
+	/**
+	 * @brief Recomputes the bounds of all nodes from the bounds of the items, children before their parents
+	 */
+	void refit_all();
+
+	/**
+	 * @brief Recomputes the bounds of a leaf and of its ancestors, until they do not change
+	 */
+	void refit_path(uint32_t leaf);
+
+	/**
+	 * @brief Recomputes the bounds of a node from its items or children, and updates the area of the tree
+	 * @return Whether the bounds changed
+	 */
+	bool update_bounds(uint32_t node);
+
+	void wait_rebuild();
+
+	/// Mesh nodes of the tree, their index into the transform order of the scene and their world bounds
+	std::vector<Node *> items;
+
+	std::vector<uint32_t> item_order_indices;
+
+	std::vector<glm::vec3> item_min;
+
+	std::vector<glm::vec3> item_max;
+
+	/// Skinned mesh nodes, returned by every frustum and sphere query
+	std::vector<Node *> unbounded_nodes;
+
+	Tree tree;
+
+	/// Surface area of the tree when it was built
+	float build_area{0.0f};
+
+	std::shared_ptr<Rebuild> rebuild;
+
+	JobHandle rebuild_job;
+
+	JobSystem *rebuild_job_system{nullptr};
+};
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,122 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scene_snapshot.h"
+
+#include "scene_graph/components/camera.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace sg
+{
+void SceneSnapshot::capture(Scene &scene)
+{
+	const auto &transform_order = scene.get_transform_order();
+
+	if (transform_order != nodes)
+	{
+		nodes = transform_order;
+
+		node_indices.clear();
+		node_indices.reserve(nodes.size());
+		for (size_t i = 0; i < nodes.size(); ++i)
+		{
+			node_indices[nodes[i]] = i;
+		}
+	}
+
+	node_states.resize(nodes.size());
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		auto &transform = nodes[i]->get_transform();
+
+		node_states[i] = {transform.get_world_matrix(), transform.get_previous_world_matrix(), transform.get_translation(), transform.get_rotation(), transform.get_scale(), transform.get_version()};
+	}
+
+	camera_states.clear();
+
+	if (scene.has_component<Camera>())
+	{
+		for (auto camera : scene.get_components<Camera>())
+		{
+			if (camera->get_node())
+			{
+				camera_states[camera] = {camera->get_view(), camera->get_projection()};
+			}
+		}
+	}
+}
+
+const SceneSnapshot::NodeState *SceneSnapshot::find(const Node &node) const
+{
+	auto it = node_indices.find(&node);
+
+	return it != node_indices.end() ? &node_states[it->second] : nullptr;
+}
+
+const SceneSnapshot::CameraState *SceneSnapshot::find(const Camera &camera) const
+{
+	auto it = camera_states.find(&camera);
+
+	return it != camera_states.end() ? &it->second : nullptr;
+}
+
+SceneSnapshot::NodeState get_node_state(const SceneSnapshot *snapshot, Node &node)
+{
+	if (snapshot)
+	{
+		if (auto state = snapshot->find(node))
+		{
+			return *state;
+		}
+	}
+
+	auto &transform = node.get_transform();
+
+	return {transform.get_world_matrix(), transform.get_previous_world_matrix(), transform.get_translation(), transform.get_rotation(), transform.get_scale(), transform.get_version()};
+}
+
+glm::mat4 get_view(const SceneSnapshot *snapshot, Camera &camera)
+{
+	if (snapshot)
+	{
+		if (auto state = snapshot->find(camera))
+		{
+			return state->view;
+		}
+	}
+
+	return camera.get_view();
+}
+
+glm::mat4 get_projection(const SceneSnapshot *snapshot, Camera &camera)
+{
+	if (snapshot)
+	{
+		if (auto state = snapshot->find(camera))
+		{
+			return state->projection;
+		}
+	}
+
+	return camera.get_projection();
+}
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,113 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "common/glm_common.h"
+#include <glm/gtx/quaternion.hpp>
+
+namespace vkb
+{
+namespace sg
+{
+class Camera;
+class Node;
+class Scene;
+
+/**
+ * @brief A copy of the scene state read while recording a frame: the transforms of the nodes and the matrices of the cameras
+ *
+ * With frame pipelining the scene of the next frame is updated while the current frame is recorded, so the recording
+ * reads the snapshot taken at the end of the previous scene update instead of the live nodes, see
+ * VulkanSample::set_frame_pipelining(). Readers go through get_node_state(), get_view() and get_projection(), which
+ * fall back to the live scene when there is no snapshot.
+ */
+class SceneSnapshot
+{
+  public:
+	struct NodeState
+	{
+		glm::mat4 world_matrix;
+
+		/// See Transform::get_previous_world_matrix()
+		glm::mat4 previous_world_matrix;
+
+		glm::vec3 translation;
+
+		glm::quat rotation;
+
+		glm::vec3 scale;
+
+		/// See Transform::get_version()
+		uint32_t version;
+	};
+
+	struct CameraState
+	{
+		glm::mat4 view;
+
+		glm::mat4 projection;
+	};
+
+	/**
+	 * @brief Copies the state of all nodes and cameras of the scene
+	 *        The world matrices must be up to date, see Scene::update_world_matrices().
+	 */
+	void capture(Scene &scene);
+
+	/**
+	 * @return The state of the node, or nullptr if the node was added after the capture
+	 */
+	const NodeState *find(const Node &node) const;
+
+	/**
+	 * @return The state of the camera, or nullptr if the camera was added after the capture
+	 */
+	const CameraState *find(const Camera &camera) const;
+
+  private:
+	/// Nodes of the last capture, in the transform order of the scene
+	std::vector<Node *> nodes;
+
+	/// Index into nodes and node_states of each node, rebuilt only when the transform order changes
+	std::unordered_map<const Node *, size_t> node_indices;
+
+	std::vector<NodeState> node_states;
+
+	std::unordered_map<const Camera *, CameraState> camera_states;
+};
+
+/**
+ * @return The state of the node in the snapshot, or its live state if snapshot is null or does not hold it
+ */
+SceneSnapshot::NodeState get_node_state(const SceneSnapshot *snapshot, Node &node);
+
+/**
+ * @return The view matrix of the camera in the snapshot, or its live one if snapshot is null or does not hold it
+ */
+glm::mat4 get_view(const SceneSnapshot *snapshot, Camera &camera);
+
+/**
+ * @return The projection matrix of the camera in the snapshot, or its live one if snapshot is null or does not hold it
+ */
+glm::mat4 get_projection(const SceneSnapshot *snapshot, Camera &camera);
+}        // namespace sg
+}        // namespace vkb
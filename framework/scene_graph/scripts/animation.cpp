@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2023, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,12 +17,46 @@
 
 #include "animation.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include <core/util/job_system.hpp>
+
 #include "scene_graph/node.h"
 
 namespace vkb
 {
 namespace sg
 {
+namespace
+{
+// Channels evaluated by each job, animations with fewer channels are evaluated on the calling thread
+const size_t channel_grain_size = 256;
+
+/**
+ * @brief Finds the keyframe interval containing time, which must be within the keyframes
+ *        Playback moves forward by small steps, so the interval of the previous update and the next ones are tried first.
+ */
+uint32_t find_keyframe(const float *times, uint32_t time_count, float time, uint32_t cursor)
+{
+	if (cursor + 1 < time_count && times[cursor] <= time)
+	{
+		for (uint32_t i = cursor; i + 1 < time_count && i < cursor + 2; ++i)
+		{
+			if (time <= times[i + 1])
+			{
+				return i;
+			}
+		}
+	}
+
+	auto     upper = std::upper_bound(times, times + time_count, time);
+	uint32_t index = static_cast<uint32_t>(upper - times);
+
+	return std::min(index > 0 ? index - 1 : 0, time_count - 2);
+}
+}        // namespace
+
 Animation::Animation(const std::string &name) :
     Script{name}
 {
@@ -36,6 +70,8 @@ Animation::Animation(const Animation &other) :
 void Animation::add_channel(Node &node, const AnimationTarget &target, const AnimationSampler &sampler)
 {
 	channels.push_back({node, target, sampler});
+
+	batch_dirty = true;
 }
 
 void Animation::update(float delta_time)
@@ -46,125 +82,222 @@ void Animation::update(float delta_time)
 		current_time -= end_time;
 	}
 
-	for (auto &channel : channels)
+	if (batch_dirty)
+	{
+		build_batch();
+	}
+
+	size_t channel_count = batch.nodes.size();
+
+	auto &job_system = JobSystem::get();
+
+	job_system.parallel_for(channel_count, channel_grain_size, [this](size_t begin, size_t end) {
+		evaluate_channels(begin, end);
+	});
+
+	job_system.parallel_for(batch.slerp_count, channel_grain_size, [this](size_t begin, size_t end) {
+		slerp_channels(begin, end);
+	});
+
+	// The setters invalidate the world matrices of the subtrees, which is not safe to do concurrently
+	for (size_t i = 0; i < channel_count; ++i)
 	{
-		for (size_t i = 0; i < channel.sampler.inputs.size() - 1; ++i)
+		if (!batch.active[i])
 		{
-			if ((current_time >= channel.sampler.inputs[i]) && (current_time <= channel.sampler.inputs[i + 1]))
+			continue;
+		}
+
+		auto &transform = batch.nodes[i]->get_transform();
+
+		glm::vec4 result = batch.results[i];
+		if (i < batch.slerp_count)
+		{
+			result = {batch.slerp_results[0][i], batch.slerp_results[1][i], batch.slerp_results[2][i], batch.slerp_results[3][i]};
+		}
+
+		switch (batch.targets[i])
+		{
+			case Translation:
+			{
+				transform.set_translation(glm::vec3(result));
+				break;
+			}
+			case Rotation:
 			{
-				float time = (current_time - channel.sampler.inputs[i]) / (channel.sampler.inputs[i + 1] - channel.sampler.inputs[i]);
+				transform.set_rotation(glm::normalize(glm::quat(result.w, result.x, result.y, result.z)));
+				break;
+			}
+			case Scale:
+			{
+				transform.set_scale(glm::vec3(result));
+				break;
+			}
+		}
+	}
+}
+
+void Animation::build_batch()
+{
+	batch = {};
+
+	// Linear rotations first, so that they are slerped over contiguous arrays
+	std::vector<const AnimationChannel *> ordered_channels;
+	for (auto &channel : channels)
+	{
+		if (channel.target == Rotation && channel.sampler.type == AnimationType::Linear)
+		{
+			ordered_channels.push_back(&channel);
+		}
+	}
+
+	batch.slerp_count = ordered_channels.size();
 
-				auto &transform = channel.node.get_transform();
+	for (auto &channel : channels)
+	{
+		if (channel.target != Rotation || channel.sampler.type != AnimationType::Linear)
+		{
+			ordered_channels.push_back(&channel);
+		}
+	}
+
+	for (auto channel : ordered_channels)
+	{
+		batch.nodes.push_back(&channel->node);
+		batch.targets.push_back(channel->target);
+		batch.types.push_back(channel->sampler.type);
+
+		batch.first_times.push_back(static_cast<uint32_t>(batch.times.size()));
+		batch.time_counts.push_back(static_cast<uint32_t>(channel->sampler.inputs.size()));
+		batch.first_outputs.push_back(static_cast<uint32_t>(batch.outputs.size()));
+
+		batch.times.insert(batch.times.end(), channel->sampler.inputs.begin(), channel->sampler.inputs.end());
+		batch.outputs.insert(batch.outputs.end(), channel->sampler.outputs.begin(), channel->sampler.outputs.end());
+	}
+
+	size_t channel_count = ordered_channels.size();
+
+	batch.cursors.resize(channel_count, 0);
+	batch.results.resize(channel_count);
+	batch.active.resize(channel_count, 0);
+
+	for (size_t component = 0; component < 4; ++component)
+	{
+		batch.slerp_from[component].resize(batch.slerp_count);
+		batch.slerp_to[component].resize(batch.slerp_count);
+		batch.slerp_results[component].resize(batch.slerp_count);
+	}
+	batch.slerp_factors.resize(batch.slerp_count);
+
+	batch_dirty = false;
+}
+
+void Animation::evaluate_channels(size_t begin, size_t end)
+{
+	for (size_t i = begin; i < end; ++i)
+	{
+		const float *times      = batch.times.data() + batch.first_times[i];
+		uint32_t     time_count = batch.time_counts[i];
+
+		// Channels hold their last value outside of their keyframes
+		batch.active[i] = time_count >= 2 && current_time >= times[0] && current_time <= times[time_count - 1];
+		if (!batch.active[i])
+		{
+			continue;
+		}
+
+		uint32_t key     = find_keyframe(times, time_count, current_time, batch.cursors[i]);
+		batch.cursors[i] = key;
+
+		float time = (current_time - times[key]) / (times[key + 1] - times[key]);
 
-				if (channel.sampler.type == AnimationType::Linear)
+		const glm::vec4 *outputs = batch.outputs.data() + batch.first_outputs[i];
+
+		switch (batch.types[i])
+		{
+			case AnimationType::Linear:
+			{
+				if (i < batch.slerp_count)
 				{
-					switch (channel.target)
+					for (glm::length_t component = 0; component < 4; ++component)
 					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(glm::mix(channel.sampler.outputs[i],
-							                                             channel.sampler.outputs[i + 1],
-							                                             time)));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = channel.sampler.outputs[i].x;
-							q1.y = channel.sampler.outputs[i].y;
-							q1.z = channel.sampler.outputs[i].z;
-							q1.w = channel.sampler.outputs[i].w;
-
-							glm::quat q2;
-							q2.x = channel.sampler.outputs[i + 1].x;
-							q2.y = channel.sampler.outputs[i + 1].y;
-							q2.z = channel.sampler.outputs[i + 1].z;
-							q2.w = channel.sampler.outputs[i + 1].w;
-
-							transform.set_rotation(glm::normalize(glm::slerp(q1, q2, time)));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(glm::mix(channel.sampler.outputs[i],
-							                                       channel.sampler.outputs[i + 1],
-							                                       time)));
-						}
+						batch.slerp_from[component][i] = outputs[key][component];
+						batch.slerp_to[component][i]   = outputs[key + 1][component];
 					}
+					batch.slerp_factors[i] = time;
 				}
-				else if (channel.sampler.type == AnimationType::Step)
+				else
 				{
-					switch (channel.target)
-					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(channel.sampler.outputs[i]));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = channel.sampler.outputs[i].x;
-							q1.y = channel.sampler.outputs[i].y;
-							q1.z = channel.sampler.outputs[i].z;
-							q1.w = channel.sampler.outputs[i].w;
-
-							transform.set_rotation(glm::normalize(q1));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(channel.sampler.outputs[i]));
-						}
-					}
+					batch.results[i] = glm::mix(outputs[key], outputs[key + 1], time);
 				}
-				else if (channel.sampler.type == AnimationType::CubicSpline)
-				{
-					float delta = channel.sampler.inputs[i + 1] - channel.sampler.inputs[i];
-
-					glm::vec4 p0 = channel.sampler.outputs[i * 3 + 1];              // Starting point
-					glm::vec4 p1 = channel.sampler.outputs[(i + 1) * 3 + 1];        // Ending point
+				break;
+			}
+			case AnimationType::Step:
+			{
+				batch.results[i] = outputs[key];
+				break;
+			}
+			case AnimationType::CubicSpline:
+			{
+				float delta = times[key + 1] - times[key];
 
-					glm::vec4 m0 = delta * channel.sampler.outputs[i * 3 + 2];              // Delta time * out tangent
-					glm::vec4 m1 = delta * channel.sampler.outputs[(i + 1) * 3 + 0];        // Delta time * in tangent of next point
+				glm::vec4 p0 = outputs[key * 3 + 1];              // Starting point
+				glm::vec4 p1 = outputs[(key + 1) * 3 + 1];        // Ending point
 
-					// This equation is taken from the GLTF 2.0 specification Appendix C (https://github.com/KhronosGroup/glTF/tree/main/specification/2.0#appendix-c-spline-interpolation)
-					glm::vec4 result = (2.0f * glm::pow(time, 3.0f) - 3.0f * glm::pow(time, 2.0f) + 1.0f) * p0 + (glm::pow(time, 3.0f) - 2.0f * glm::pow(time, 2.0f) + time) * m0 + (-2.0f * glm::pow(time, 3.0f) + 3.0f * glm::pow(time, 2.0f)) * p1 + (glm::pow(time, 3.0f) - glm::pow(time, 2.0f)) * m1;
+				glm::vec4 m0 = delta * outputs[key * 3 + 2];              // Delta time * out tangent
+				glm::vec4 m1 = delta * outputs[(key + 1) * 3 + 0];        // Delta time * in tangent of next point
 
-					auto &transform = channel.node.get_transform();
+				float time2 = time * time;
+				float time3 = time2 * time;
 
-					switch (channel.target)
-					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(result));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = result.x;
-							q1.y = result.y;
-							q1.z = result.z;
-							q1.w = result.w;
-
-							transform.set_rotation(glm::normalize(q1));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(result));
-						}
-					}
-				}
+				// This equation is taken from the GLTF 2.0 specification Appendix C (https://github.com/KhronosGroup/glTF/tree/main/specification/2.0#appendix-c-spline-interpolation)
+				batch.results[i] = (2.0f * time3 - 3.0f * time2 + 1.0f) * p0 + (time3 - 2.0f * time2 + time) * m0 + (-2.0f * time3 + 3.0f * time2) * p1 + (time3 - time2) * m1;
+				break;
 			}
 		}
 	}
 }
 
+void Animation::slerp_channels(size_t begin, size_t end)
+{
+	const float *from_x = batch.slerp_from[0].data();
+	const float *from_y = batch.slerp_from[1].data();
+	const float *from_z = batch.slerp_from[2].data();
+	const float *from_w = batch.slerp_from[3].data();
+	const float *to_x   = batch.slerp_to[0].data();
+	const float *to_y   = batch.slerp_to[1].data();
+	const float *to_z   = batch.slerp_to[2].data();
+	const float *to_w   = batch.slerp_to[3].data();
+	const float *factor = batch.slerp_factors.data();
+	float       *q_x    = batch.slerp_results[0].data();
+	float       *q_y    = batch.slerp_results[1].data();
+	float       *q_z    = batch.slerp_results[2].data();
+	float       *q_w    = batch.slerp_results[3].data();
+
+	// Branch free over arrays so that the compiler vectorizes the loop. The interpolation factor is corrected with a
+	// polynomial fit, so that the normalized lerp closely follows the constant angular velocity of a slerp.
+	for (size_t i = begin; i < end; ++i)
+	{
+		float cos_angle = from_x[i] * to_x[i] + from_y[i] * to_y[i] + from_z[i] * to_z[i] + from_w[i] * to_w[i];
+		float d         = std::abs(cos_angle);
+		float t         = factor[i];
+
+		float a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+		float b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+		float k = a * (t - 0.5f) * (t - 0.5f) + b;
+
+		float corrected = t + t * (t - 0.5f) * (t - 1.0f) * k;
+
+		// Take the shortest path, through the opposite of the target quaternion when they are more than half a turn apart
+		float from_weight = 1.0f - corrected;
+		float to_weight   = cos_angle < 0.0f ? -corrected : corrected;
+
+		q_x[i] = from_x[i] * from_weight + to_x[i] * to_weight;
+		q_y[i] = from_y[i] * from_weight + to_y[i] * to_weight;
+		q_z[i] = from_z[i] * from_weight + to_z[i] * to_weight;
+		q_w[i] = from_w[i] * from_weight + to_w[i] * to_weight;
+	}
+}
+
 void Animation::update_times(float new_start_time, float new_end_time)
 {
 	if (new_start_time < start_time)
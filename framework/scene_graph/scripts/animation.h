@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -62,6 +64,56 @@ struct AnimationChannel
 	AnimationSampler sampler;
 };
 
+/**
+ * @brief The channels of an animation laid out as a structure of arrays, so that they are evaluated in batches
+ *        Linear rotation channels come first, so that their slerps run over contiguous arrays.
+ */
+struct AnimationChannelBatch
+{
+	std::vector<Node *> nodes;
+
+	std::vector<AnimationTarget> targets;
+
+	std::vector<AnimationType> types;
+
+	/// First keyframe time of each channel in times, and first output in outputs
+	std::vector<uint32_t> first_times;
+
+	std::vector<uint32_t> time_counts;
+
+	std::vector<uint32_t> first_outputs;
+
+	std::vector<float> times;
+
+	std::vector<glm::vec4> outputs;
+
+	/// Keyframe interval found by the last update of each channel, where the next search starts
+	std::vector<uint32_t> cursors;
+
+	/// Value of each channel at the current time, only written to the nodes where active is set
+	/// The linear rotation channels are in slerp_results instead.
+	std::vector<glm::vec4> results;
+
+	std::vector<uint8_t> active;
+
+	/// Number of linear rotation channels
+	size_t slerp_count{0};
+
+	/// Quaternions and factor of the keyframe interval of the linear rotation channels, one array per component
+	std::array<std::vector<float>, 4> slerp_from;
+
+	std::array<std::vector<float>, 4> slerp_to;
+
+	std::vector<float> slerp_factors;
+
+	std::array<std::vector<float>, 4> slerp_results;
+};
+
+/**
+ * @brief Plays the channels of an animation on the transforms of their nodes
+ *        Channels are evaluated in parallel on the job system, starting their keyframe search from the interval of the
+ *        previous update, then written to the transforms, whose world matrices are updated by Scene::update_world_matrices().
+ */
 class Animation : public Script
 {
   public:
@@ -76,8 +128,19 @@ class Animation : public Script
 	void add_channel(Node &node, const AnimationTarget &target, const AnimationSampler &sampler);
 
   private:
+	void build_batch();
+
+	void evaluate_channels(size_t begin, size_t end);
+
+	void slerp_channels(size_t begin, size_t end);
+
 	std::vector<AnimationChannel> channels;
 
+	AnimationChannelBatch batch;
+
+	/// Set when channels changed since the batch was built
+	bool batch_dirty{true};
+
 	float current_time{0.0f};
 
 	float start_time{std::numeric_limits<float>::max()};
@@ -0,0 +1,508 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shader_cache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#include "common/helpers.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+#include "filesystem/legacy.h"
+#include "glsl_compiler.h"
+
+namespace vkb
+{
+namespace
+{
+// Bump the version whenever the entry layout or the reflection output changes
+constexpr uint32_t SHADER_CACHE_MAGIC   = 0x43534b56;        // "VKSC"
+constexpr uint32_t SHADER_CACHE_VERSION = 2;
+
+// Bundles hold entries in the format of the on-disk cache, so they share its version
+constexpr uint32_t SHADER_BUNDLE_MAGIC = 0x42534b56;        // "VKSB"
+
+constexpr const char *DEFAULT_SHADER_BUNDLE = "shaders.vksb";
+
+inline filesystem::Path get_cache_directory()
+{
+	return filesystem::get()->temp_directory() / "vulkan_samples" / "shader_cache";
+}
+
+inline void write_resource(std::ostringstream &os, const ShaderResource &resource)
+{
+	write(os,
+	      resource.stages,
+	      resource.type,
+	      resource.mode,
+	      resource.set,
+	      resource.binding,
+	      resource.location,
+	      resource.input_attachment_index,
+	      resource.vec_size,
+	      resource.columns,
+	      resource.array_size,
+	      resource.offset,
+	      resource.size,
+	      resource.runtime_array_stride,
+	      resource.constant_id,
+	      resource.qualifiers,
+	      resource.name);
+}
+
+inline void read_resource(std::istringstream &is, ShaderResource &resource)
+{
+	read(is,
+	     resource.stages,
+	     resource.type,
+	     resource.mode,
+	     resource.set,
+	     resource.binding,
+	     resource.location,
+	     resource.input_attachment_index,
+	     resource.vec_size,
+	     resource.columns,
+	     resource.array_size,
+	     resource.offset,
+	     resource.size,
+	     resource.runtime_array_stride,
+	     resource.constant_id,
+	     resource.qualifiers,
+	     resource.name);
+}
+
+inline std::string serialize_entry(const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources)
+{
+	std::ostringstream os;
+	write(os, SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, spirv, resources.size());
+	for (auto &resource : resources)
+	{
+		write_resource(os, resource);
+	}
+	return os.str();
+}
+
+/**
+ * @brief Reads an entry, returns false if it is corrupt or was written by another version
+ */
+inline bool deserialize_entry(const std::string &entry, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources)
+{
+	std::istringstream is{entry};
+
+	uint32_t magic   = 0;
+	uint32_t version = 0;
+	read(is, magic, version);
+
+	if (!is || magic != SHADER_CACHE_MAGIC || version != SHADER_CACHE_VERSION)
+	{
+		return false;
+	}
+
+	std::vector<uint32_t> entry_spirv;
+	read(is, entry_spirv);
+
+	size_t resource_count = 0;
+	read(is, resource_count);
+
+	if (!is || entry_spirv.empty())
+	{
+		return false;
+	}
+
+	std::vector<ShaderResource> entry_resources(resource_count);
+	for (auto &resource : entry_resources)
+	{
+		read_resource(is, resource);
+	}
+
+	if (!is)
+	{
+		return false;
+	}
+
+	spirv     = std::move(entry_spirv);
+	resources = std::move(entry_resources);
+	return true;
+}
+
+/**
+ * @brief Runs spirv-opt on a module, the bindings and specialization constants are kept so the reflection stays valid
+ */
+bool optimize_spirv(const std::string &optimizer, std::vector<uint32_t> &spirv)
+{
+	auto fs        = filesystem::get();
+	auto directory = fs->temp_directory() / "vulkan_samples";
+	if (!fs->is_directory(directory))
+	{
+		fs->create_directory(directory);
+	}
+
+	auto input_path  = directory / "shader_bundle_input.spv";
+	auto output_path = directory / "shader_bundle_output.spv";
+
+	fs->write_file(input_path, std::vector<uint8_t>{reinterpret_cast<const uint8_t *>(spirv.data()),
+	                                                reinterpret_cast<const uint8_t *>(spirv.data() + spirv.size())});
+
+	auto command = fmt::format("\"{}\" -O --preserve-bindings --preserve-spec-constants \"{}\" -o \"{}\"",
+	                           optimizer, input_path.string(), output_path.string());
+	if (std::system(command.c_str()) != 0 || !fs->is_file(output_path))
+	{
+		return false;
+	}
+
+	auto data = fs->read_file_binary(output_path);
+	if (data.empty() || data.size() % sizeof(uint32_t) != 0)
+	{
+		return false;
+	}
+
+	spirv.resize(data.size() / sizeof(uint32_t));
+	std::memcpy(spirv.data(), data.data(), data.size());
+	return true;
+}
+}        // namespace
+
+ShaderCache::ShaderCache()
+{
+#ifdef VKB_SHADER_BUNDLE_ONLY
+	bundle_only = true;
+#endif
+}
+
+ShaderCache &ShaderCache::get()
+{
+	static ShaderCache cache;
+	return cache;
+}
+
+void ShaderCache::set_enabled(bool enabled_)
+{
+	enabled = enabled_;
+}
+
+bool ShaderCache::is_enabled() const
+{
+	return enabled;
+}
+
+Hash128 ShaderCache::compute_key(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const std::vector<uint8_t> &expanded_source, const std::string &entry_point, const ShaderVariant &shader_variant) const
+{
+	Hash128 key;
+
+	hash_combine(key, static_cast<uint32_t>(stage));
+	hash_combine(key, entry_point);
+	hash_combine(key, glsl_source.get_id());
+	hash_combine(key, expanded_source);
+
+	// The preamble is hashed rather than the variant id, which only has the width of size_t
+	// Runtime array sizes are left out, so that variants which only differ by them share an entry
+	hash_combine(key, shader_variant.get_preamble());
+
+	hash_combine(key, static_cast<uint32_t>(GLSLCompiler::get_target_language()));
+	hash_combine(key, static_cast<uint32_t>(GLSLCompiler::get_target_language_version()));
+
+	return key;
+}
+
+bool ShaderCache::load(const Hash128 &key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources)
+{
+	if (bundle_only)
+	{
+		// Bundles loaded explicitly take the place of the default one
+		std::call_once(default_bundle_flag, [this]() {
+			bool has_bundle = false;
+			{
+				std::lock_guard<std::mutex> lock{bundle_mutex};
+				has_bundle = !bundle_entries.empty();
+			}
+			if (!has_bundle)
+			{
+				load_bundle(fs::path::get(fs::path::Shaders, DEFAULT_SHADER_BUNDLE));
+			}
+		});
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{bundle_mutex};
+
+		auto it = bundle_entries.find(key);
+		if (it != bundle_entries.end() && deserialize_entry(it->second, spirv, resources))
+		{
+			if (bundle_recording)
+			{
+				recorded_entries[key] = it->second;
+			}
+
+			hit_count++;
+			return true;
+		}
+	}
+
+	if (bundle_only)
+	{
+		miss_count++;
+		return false;
+	}
+
+	if (!enabled)
+	{
+		return false;
+	}
+
+	auto fs   = filesystem::get();
+	auto path = get_entry_path(key);
+
+	if (!fs->is_file(path))
+	{
+		miss_count++;
+		return false;
+	}
+
+	try
+	{
+		auto        data = fs->read_file_binary(path);
+		std::string entry{data.begin(), data.end()};
+
+		if (!deserialize_entry(entry, spirv, resources))
+		{
+			LOGD("Discarding outdated or corrupt shader cache entry {}", path);
+			miss_count++;
+			return false;
+		}
+
+		record(key, entry);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read shader cache entry {}: {}", path, e.what());
+		miss_count++;
+		return false;
+	}
+
+	hit_count++;
+	return true;
+}
+
+void ShaderCache::store(const Hash128 &key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources)
+{
+	auto entry = serialize_entry(spirv, resources);
+
+	record(key, entry);
+
+	if (!enabled)
+	{
+		return;
+	}
+
+	try
+	{
+		auto fs        = filesystem::get();
+		auto directory = get_cache_directory();
+		if (!fs->is_directory(directory.parent_path()))
+		{
+			fs->create_directory(directory.parent_path());
+		}
+		if (!fs->is_directory(directory))
+		{
+			fs->create_directory(directory);
+		}
+
+		fs->write_file_atomic(get_entry_path(key), std::vector<uint8_t>{entry.begin(), entry.end()});
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write shader cache entry: {}", e.what());
+	}
+}
+
+void ShaderCache::clear()
+{
+	std::error_code ec;
+	std::filesystem::remove_all(get_cache_directory(), ec);
+
+	if (ec)
+	{
+		LOGW("Failed to clear shader cache: {}", ec.message());
+	}
+}
+
+bool ShaderCache::load_bundle(const std::string &path)
+{
+	auto fs = filesystem::get();
+	if (!fs->is_file(path))
+	{
+		LOGW("Shader bundle {} not found", path);
+		return false;
+	}
+
+	std::unordered_map<Hash128, std::string> entries;
+
+	try
+	{
+		auto               data = fs->read_file_binary(path);
+		std::istringstream is{std::string{data.begin(), data.end()}};
+
+		uint32_t magic       = 0;
+		uint32_t version     = 0;
+		size_t   entry_count = 0;
+		read(is, magic, version, entry_count);
+
+		if (!is || magic != SHADER_BUNDLE_MAGIC || version != SHADER_CACHE_VERSION)
+		{
+			LOGE("Shader bundle {} is invalid or was written by another version", path);
+			return false;
+		}
+
+		for (size_t i = 0; i < entry_count && is; ++i)
+		{
+			Hash128     key;
+			std::string entry;
+			read(is, key.low, key.high, entry);
+			entries.emplace(key, std::move(entry));
+		}
+
+		if (!is)
+		{
+			LOGE("Shader bundle {} is truncated", path);
+			return false;
+		}
+	}
+	catch (const std::exception &e)
+	{
+		LOGE("Failed to read shader bundle {}: {}", path, e.what());
+		return false;
+	}
+
+	LOGI("Loaded {} shaders from bundle {}", entries.size(), path);
+
+	std::lock_guard<std::mutex> lock{bundle_mutex};
+	for (auto &entry : entries)
+	{
+		bundle_entries[entry.first] = std::move(entry.second);
+	}
+
+	return true;
+}
+
+void ShaderCache::set_bundle_recording(bool recording)
+{
+	std::lock_guard<std::mutex> lock{bundle_mutex};
+
+	bundle_recording = recording;
+}
+
+bool ShaderCache::write_bundle(const std::string &path, const std::string &optimizer)
+{
+	std::unordered_map<Hash128, std::string> entries;
+	{
+		std::lock_guard<std::mutex> lock{bundle_mutex};
+		entries = recorded_entries;
+	}
+
+	// Sort the entries so that bundles of the same shaders are identical
+	std::map<std::pair<uint64_t, uint64_t>, std::string *> sorted_entries;
+	for (auto &entry : entries)
+	{
+		sorted_entries[{entry.first.high, entry.first.low}] = &entry.second;
+	}
+
+	std::ostringstream os;
+	write(os, SHADER_BUNDLE_MAGIC, SHADER_CACHE_VERSION, sorted_entries.size());
+
+	for (auto &sorted_entry : sorted_entries)
+	{
+		auto &entry = *sorted_entry.second;
+
+		if (!optimizer.empty())
+		{
+			std::vector<uint32_t>       spirv;
+			std::vector<ShaderResource> resources;
+			if (deserialize_entry(entry, spirv, resources))
+			{
+				if (optimize_spirv(optimizer, spirv))
+				{
+					entry = serialize_entry(spirv, resources);
+				}
+				else
+				{
+					LOGW("Failed to optimize shader {:016x}{:016x} with {}, keeping it unoptimized", sorted_entry.first.first, sorted_entry.first.second, optimizer);
+				}
+			}
+		}
+
+		write(os, sorted_entry.first.second, sorted_entry.first.first, entry);
+	}
+
+	try
+	{
+		auto str = os.str();
+		filesystem::get()->write_file(path, std::vector<uint8_t>{str.begin(), str.end()});
+	}
+	catch (const std::exception &e)
+	{
+		LOGE("Failed to write shader bundle {}: {}", path, e.what());
+		return false;
+	}
+
+	LOGI("Wrote {} shaders to bundle {}", sorted_entries.size(), path);
+	return true;
+}
+
+void ShaderCache::set_bundle_only(bool bundle_only_)
+{
+#ifdef VKB_SHADER_BUNDLE_ONLY
+	if (!bundle_only_)
+	{
+		LOGW("Shaders can only be loaded from bundles in builds with VKB_SHADER_BUNDLE_ONLY");
+		return;
+	}
+#endif
+	bundle_only = bundle_only_;
+}
+
+bool ShaderCache::is_bundle_only() const
+{
+	return bundle_only;
+}
+
+uint32_t ShaderCache::get_hit_count() const
+{
+	return hit_count;
+}
+
+uint32_t ShaderCache::get_miss_count() const
+{
+	return miss_count;
+}
+
+std::string ShaderCache::get_entry_path(const Hash128 &key) const
+{
+	return (get_cache_directory() / fmt::format("{:016x}{:016x}.spvc", key.high, key.low)).string();
+}
+
+void ShaderCache::record(const Hash128 &key, const std::string &entry)
+{
+	std::lock_guard<std::mutex> lock{bundle_mutex};
+
+	if (bundle_recording)
+	{
+		recorded_entries[key] = entry;
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,159 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/shader_module.h"
+#include <core/util/hash.hpp>
+
+namespace vkb
+{
+/**
+ * @brief Persistent, content-addressed cache of compiled SPIR-V and the matching reflection results
+ *
+ * Every entry is keyed on a 128-bit hash of the shader stage, entry point, source, variant and the GLSLCompiler
+ * target environment, and stored as a single file in the temporary storage directory.
+ * The runtime array sizes of the variant are not part of the key, the reflected sizes count no runtime array element,
+ * see SPIRVReflection::apply_runtime_array_sizes().
+ * A hit lets ShaderModule skip both the GLSL compilation and the SPIR-V reflection.
+ *
+ * Entries can also be packed into a shader bundle, a single file which is looked up before the on-disk cache.
+ * Bundles are written by a run of the samples which records the entries it uses, see the shader bundle plugin, and
+ * let release builds with VKB_SHADER_BUNDLE_ONLY ship without compiling GLSL at runtime.
+ */
+class ShaderCache
+{
+  public:
+	/**
+	 * @brief Access the process wide shader cache
+	 */
+	static ShaderCache &get();
+
+	ShaderCache(const ShaderCache &) = delete;
+
+	ShaderCache(ShaderCache &&) = delete;
+
+	ShaderCache &operator=(const ShaderCache &) = delete;
+
+	ShaderCache &operator=(ShaderCache &&) = delete;
+
+	/**
+	 * @brief Enables or disables the cache, a disabled cache neither loads nor stores entries
+	 */
+	void set_enabled(bool enabled);
+
+	bool is_enabled() const;
+
+	/**
+	 * @brief Computes the cache key of a shader, wide enough for collisions between entries to be negligible
+	 * @param stage The Vulkan shader stage flag
+	 * @param glsl_source The shader source
+	 * @param expanded_source The source after include expansion, so that edits to included files are detected
+	 * @param entry_point The entrypoint function name of the shader stage
+	 * @param shader_variant The shader variant
+	 */
+	Hash128 compute_key(VkShaderStageFlagBits       stage,
+	                    const ShaderSource         &glsl_source,
+	                    const std::vector<uint8_t> &expanded_source,
+	                    const std::string          &entry_point,
+	                    const ShaderVariant        &shader_variant) const;
+
+	/**
+	 * @brief Looks up a cache entry
+	 * @param key The key computed by compute_key
+	 * @param[out] spirv The cached SPIR-V code
+	 * @param[out] resources The cached reflected shader resources
+	 * @return True on a hit, false otherwise
+	 */
+	bool load(const Hash128 &key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources);
+
+	/**
+	 * @brief Stores a cache entry, failures are logged and otherwise ignored
+	 */
+	void store(const Hash128 &key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources);
+
+	/**
+	 * @brief Removes every entry from the on-disk cache
+	 */
+	void clear();
+
+	/**
+	 * @brief Loads a shader bundle, whose entries are then looked up before the on-disk cache
+	 * @param path The path of a bundle written by write_bundle()
+	 * @return True if the bundle was loaded, false if it is missing or invalid
+	 */
+	bool load_bundle(const std::string &path);
+
+	/**
+	 * @brief Enables or disables recording of the entries which are loaded or stored, to be packed by write_bundle()
+	 */
+	void set_bundle_recording(bool recording);
+
+	/**
+	 * @brief Packs the entries recorded since set_bundle_recording() into a shader bundle
+	 * @param path The path of the bundle
+	 * @param optimizer Optional path of a spirv-opt executable, which is run on the SPIR-V of every entry
+	 * @return True on success, errors are logged
+	 */
+	bool write_bundle(const std::string &path, const std::string &optimizer = "");
+
+	/**
+	 * @brief In bundle only mode, shaders which are missing from the loaded bundles are errors rather than compiled
+	 *        It is always on in builds with VKB_SHADER_BUNDLE_ONLY, which load shaders/shaders.vksb on first use.
+	 */
+	void set_bundle_only(bool bundle_only);
+
+	bool is_bundle_only() const;
+
+	uint32_t get_hit_count() const;
+
+	uint32_t get_miss_count() const;
+
+  private:
+	ShaderCache();
+
+	std::string get_entry_path(const Hash128 &key) const;
+
+	void record(const Hash128 &key, const std::string &entry);
+
+	bool enabled{true};
+
+	bool bundle_only{false};
+
+	bool bundle_recording{false};
+
+	std::once_flag default_bundle_flag;
+
+	/// Guards the bundle entries, as shader modules are created from several threads
+	std::mutex bundle_mutex;
+
+	std::unordered_map<Hash128, std::string> bundle_entries;
+
+	std::unordered_map<Hash128, std::string> recorded_entries;
+
+	std::atomic<uint32_t> hit_count{0};
+
+	std::atomic<uint32_t> miss_count{0};
+};
+}        // namespace vkb
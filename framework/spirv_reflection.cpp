@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,10 +17,18 @@
 
 #include "spirv_reflection.h"
 
+#include <mutex>
+
+#include <core/util/hash.hpp>
+
 namespace vkb
 {
 namespace
 {
+// Reflected resources of every SPIR-V module parsed so far, shared by the variants which only differ by runtime array sizes
+std::mutex                                               reflection_cache_mutex;
+std::unordered_map<Hash128, std::vector<ShaderResource>> reflection_cache;
+
 template <ShaderResourceType T>
 inline void read_shader_resource(const spirv_cross::Compiler &compiler,
                                  VkShaderStageFlagBits        stage,
@@ -128,6 +136,9 @@ inline void read_resource_size(const spirv_cross::Compiler &compiler,
 	}
 
 	shader_resource.size = to_u32(compiler.get_declared_struct_size_runtime_array(spirv_type, array_size));
+
+	// Blocks without a runtime array have the same size whatever the element count
+	shader_resource.runtime_array_stride = to_u32(compiler.get_declared_struct_size_runtime_array(spirv_type, array_size + 1)) - shader_resource.size;
 }
 
 inline void read_resource_size(const spirv_cross::Compiler &    compiler,
@@ -355,7 +366,7 @@ inline void read_shader_resource<ShaderResourceType::BufferStorage>(const spirv_
 
 	for (auto &resource : storage_resources)
 	{
-		ShaderResource shader_resource;
+		ShaderResource shader_resource{};
 		shader_resource.type   = ShaderResourceType::BufferStorage;
 		shader_resource.stages = stage;
 		shader_resource.name   = resource.name;
@@ -372,8 +383,23 @@ inline void read_shader_resource<ShaderResourceType::BufferStorage>(const spirv_
 }
 }        // namespace
 
-bool SPIRVReflection::reflect_shader_resources(VkShaderStageFlagBits stage, const std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources, const ShaderVariant &variant)
+bool SPIRVReflection::reflect_shader_resources(VkShaderStageFlagBits stage, const std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources)
 {
+	Hash128 key;
+	hash_combine(key, static_cast<uint32_t>(stage));
+	hash_combine(key, spirv);
+
+	{
+		std::lock_guard<std::mutex> lock{reflection_cache_mutex};
+
+		auto it = reflection_cache.find(key);
+		if (it != reflection_cache.end())
+		{
+			resources.insert(resources.end(), it->second.begin(), it->second.end());
+			return true;
+		}
+	}
+
 	spirv_cross::CompilerGLSL compiler{spirv};
 
 	auto opts                     = compiler.get_common_options();
@@ -381,13 +407,60 @@ bool SPIRVReflection::reflect_shader_resources(VkShaderStageFlagBits stage, cons
 
 	compiler.set_common_options(opts);
 
-	parse_shader_resources(compiler, stage, resources, variant);
-	parse_push_constants(compiler, stage, resources, variant);
-	parse_specialization_constants(compiler, stage, resources, variant);
+	// Reflect without runtime array elements, the sizes of a variant are added by apply_runtime_array_sizes()
+	ShaderVariant               base_variant;
+	std::vector<ShaderResource> reflected_resources;
+
+	parse_shader_resources(compiler, stage, reflected_resources, base_variant);
+	parse_push_constants(compiler, stage, reflected_resources, base_variant);
+	parse_specialization_constants(compiler, stage, reflected_resources, base_variant);
+
+	resources.insert(resources.end(), reflected_resources.begin(), reflected_resources.end());
+
+	std::lock_guard<std::mutex> lock{reflection_cache_mutex};
+	reflection_cache.emplace(key, std::move(reflected_resources));
 
 	return true;
 }
 
+bool SPIRVReflection::reflect_shader_resources(VkShaderStageFlagBits stage, const std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources, const ShaderVariant &variant)
+{
+	std::vector<ShaderResource> reflected_resources;
+	if (!reflect_shader_resources(stage, spirv, reflected_resources))
+	{
+		return false;
+	}
+
+	apply_runtime_array_sizes(reflected_resources, variant);
+
+	resources.insert(resources.end(), reflected_resources.begin(), reflected_resources.end());
+
+	return true;
+}
+
+void SPIRVReflection::apply_runtime_array_sizes(std::vector<ShaderResource> &resources, const ShaderVariant &variant)
+{
+	auto &runtime_array_sizes = variant.get_runtime_array_sizes();
+	if (runtime_array_sizes.empty())
+	{
+		return;
+	}
+
+	for (auto &resource : resources)
+	{
+		if (resource.runtime_array_stride == 0)
+		{
+			continue;
+		}
+
+		auto it = runtime_array_sizes.find(resource.name);
+		if (it != runtime_array_sizes.end())
+		{
+			resource.size += to_u32(it->second * resource.runtime_array_stride);
+		}
+	}
+}
+
 void SPIRVReflection::parse_shader_resources(const spirv_cross::Compiler &compiler, VkShaderStageFlagBits stage, std::vector<ShaderResource> &resources, const ShaderVariant &variant)
 {
 	read_shader_resource<ShaderResourceType::Input>(compiler, stage, resources, variant);
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -34,6 +34,15 @@ namespace vkb
 class SPIRVReflection
 {
   public:
+	/// @brief Reflects shader resources from SPIRV code, the results are cached so that each module is only parsed once
+	///        The sizes of the buffers which end in a runtime array count no element of it, see apply_runtime_array_sizes()
+	/// @param stage The Vulkan shader stage flag
+	/// @param spirv The SPIRV code of shader
+	/// @param[out] resources The list of reflected shader resources
+	bool reflect_shader_resources(VkShaderStageFlagBits        stage,
+	                              const std::vector<uint32_t> &spirv,
+	                              std::vector<ShaderResource> &resources);
+
 	/// @brief Reflects shader resources from SPIRV code
 	/// @param stage The Vulkan shader stage flag
 	/// @param spirv The SPIRV code of shader
@@ -44,6 +53,11 @@ class SPIRVReflection
 	                              std::vector<ShaderResource> &resources,
 	                              const ShaderVariant         &variant);
 
+	/// @brief Adds the runtime array elements of a variant to the sizes of the buffers which end in a runtime array
+	/// @param resources Shader resources reflected without runtime array elements
+	/// @param variant ShaderVariant which specifies the size of the runtime arrays
+	static void apply_runtime_array_sizes(std::vector<ShaderResource> &resources, const ShaderVariant &variant);
+
   private:
 	void parse_shader_resources(const spirv_cross::Compiler &compiler,
 	                            VkShaderStageFlagBits        stage,
@@ -0,0 +1,84 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bottleneck.h"
+
+namespace vkb
+{
+namespace
+{
+// Stalls of more than this fraction of the active cycles hold the GPU back more than any of its units
+constexpr double BANDWIDTH_STALL_RATIO = 0.1;
+
+// Texture units issuing for more than this fraction of the fragment cycles of each core limit the fragment work
+constexpr double TEXTURE_ISSUE_RATIO = 0.5;
+
+// A GPU busy for less than this fraction of the frame waits for the CPU
+constexpr double CPU_BOUND_GPU_UTILIZATION = 0.75;
+}        // namespace
+
+Bottleneck classify_gpu_bottleneck(const GpuBottleneckCounters &counters)
+{
+	if (counters.gpu_cycles <= 0.0)
+	{
+		return Bottleneck::unknown;
+	}
+
+	if (counters.bus_stall_cycles > BANDWIDTH_STALL_RATIO * counters.gpu_cycles)
+	{
+		return Bottleneck::bandwidth;
+	}
+
+	if (counters.vertex_cycles > counters.fragment_cycles)
+	{
+		return Bottleneck::vertex;
+	}
+
+	if (counters.fragment_cycles <= 0.0)
+	{
+		return Bottleneck::unknown;
+	}
+
+	double texture_issue = counters.texture_cycles / (counters.fragment_cycles * counters.shader_core_count);
+
+	return texture_issue > TEXTURE_ISSUE_RATIO ? Bottleneck::texture : Bottleneck::fragment;
+}
+
+bool is_cpu_bound(double frame_time, double gpu_time)
+{
+	return frame_time > 0.0 && gpu_time > 0.0 && gpu_time < CPU_BOUND_GPU_UTILIZATION * frame_time;
+}
+
+const char *to_string(Bottleneck bottleneck)
+{
+	switch (bottleneck)
+	{
+		case Bottleneck::cpu:
+			return "CPU-bound";
+		case Bottleneck::vertex:
+			return "vertex-bound";
+		case Bottleneck::fragment:
+			return "fragment-bound";
+		case Bottleneck::texture:
+			return "texture-bound";
+		case Bottleneck::bandwidth:
+			return "bandwidth-bound";
+		default:
+			return "unknown";
+	}
+}
+}        // namespace vkb
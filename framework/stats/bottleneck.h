@@ -0,0 +1,97 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vkb
+{
+/**
+ * @brief The unit which limits the frame rate, the one optimizations should go to first
+ */
+enum class Bottleneck
+{
+	unknown,
+	cpu,
+	vertex,
+	fragment,
+	texture,
+	bandwidth
+};
+
+/// Number of values of Bottleneck
+constexpr size_t BOTTLENECK_COUNT = static_cast<size_t>(Bottleneck::bandwidth) + 1;
+
+/**
+ * @brief The bottleneck of a frame, and the pass the GPU spent the most time on, where the work to reduce most likely is
+ */
+struct FrameBottleneck
+{
+	Bottleneck bottleneck{Bottleneck::unknown};
+
+	/// Name of the top level scope of the GPU profiler which took the most GPU time, empty without the profiler
+	std::string pass;
+
+	/// GPU time of the pass, in seconds
+	double pass_time{0.0};
+};
+
+/**
+ * @brief Hardware counters of the GPU over the same interval, as rates or totals as long as they all are the same
+ */
+struct GpuBottleneckCounters
+{
+	/// Cycles the GPU was active
+	double gpu_cycles{0.0};
+
+	/// Cycles the vertex and compute queue, and the fragment queue were active
+	double vertex_cycles{0.0};
+
+	double fragment_cycles{0.0};
+
+	/// Cycles the texture units issued, summed over the shader cores
+	double texture_cycles{0.0};
+
+	uint32_t shader_core_count{1};
+
+	/// Cycles the reads and writes of the external memory bus stalled
+	double bus_stall_cycles{0.0};
+};
+
+/**
+ * @brief Classifies the unit of the GPU which limits it, from its hardware counters
+ *        Stalls of the memory bus weigh over the shader work, as they hold back every stage. The busier queue is the
+ *        limit otherwise, fragment work being limited by the texture units when they issue for most of it.
+ * @return The bottleneck, or Bottleneck::unknown if the GPU was idle
+ */
+Bottleneck classify_gpu_bottleneck(const GpuBottleneckCounters &counters);
+
+/**
+ * @brief Checks whether the GPU waited for the CPU in the frame
+ * @param frame_time The time between the frames, in seconds
+ * @param gpu_time The time the GPU was busy with the frame, in seconds
+ */
+bool is_cpu_bound(double frame_time, double gpu_time);
+
+/**
+ * @return A short name for the bottleneck, e.g. "fragment-bound"
+ */
+const char *to_string(Bottleneck bottleneck);
+}        // namespace vkb
@@ -0,0 +1,64 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "command_buffer_stats_provider.h"
+
+#include "core/command_buffer.h"
+#include "rendering/frame_arena.h"
+
+namespace vkb
+{
+CommandBufferStatsProvider::CommandBufferStatsProvider(std::set<StatIndex> &requested_stats)
+{
+	for (auto index : {StatIndex::skipped_pipeline_binds, StatIndex::frame_arena_allocated_bytes, StatIndex::frame_arena_heap_allocations})
+	{
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+
+	// Discard whatever was counted before the stats were requested
+	CommandBuffer::take_skipped_pipeline_bind_count();
+	FrameArena::take_allocated_bytes();
+	FrameArena::take_heap_allocation_count();
+}
+
+bool CommandBufferStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters CommandBufferStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	res[StatIndex::skipped_pipeline_binds].result = CommandBuffer::take_skipped_pipeline_bind_count();
+
+	// Heap allocations only happen while the arenas grow, a steady frame makes none
+	res[StatIndex::frame_arena_allocated_bytes].result  = static_cast<double>(FrameArena::take_allocated_bytes());
+	res[StatIndex::frame_arena_heap_allocations].result = FrameArena::take_heap_allocation_count();
+
+	return res;
+}
+}        // namespace vkb
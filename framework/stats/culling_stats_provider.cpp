@@ -0,0 +1,80 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "culling_stats_provider.h"
+
+#include "rendering/subpasses/geometry_subpass.h"
+#include "rendering/subpasses/indirect_subpass.h"
+
+namespace vkb
+{
+CullingStatsProvider::CullingStatsProvider(std::set<StatIndex> &requested_stats)
+{
+	for (auto index : {StatIndex::visible_draws, StatIndex::culled_draws, StatIndex::occlusion_visible_draws, StatIndex::occluded_draws})
+	{
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+
+	// Discard whatever was counted before the stats were requested
+	GeometrySubpass::take_culling_counts();
+	IndirectSubpass::take_occlusion_counts();
+}
+
+bool CullingStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters CullingStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	auto culling_counts = GeometrySubpass::take_culling_counts();
+
+	if (is_available(StatIndex::visible_draws))
+	{
+		res[StatIndex::visible_draws].result = culling_counts.first;
+	}
+
+	if (is_available(StatIndex::culled_draws))
+	{
+		res[StatIndex::culled_draws].result = culling_counts.second;
+	}
+
+	auto occlusion_counts = IndirectSubpass::take_occlusion_counts();
+
+	if (is_available(StatIndex::occlusion_visible_draws))
+	{
+		res[StatIndex::occlusion_visible_draws].result = occlusion_counts.first;
+	}
+
+	if (is_available(StatIndex::occluded_draws))
+	{
+		res[StatIndex::occluded_draws].result = occlusion_counts.second;
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,85 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_timeline_stats_provider.h"
+
+#include <algorithm>
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+namespace
+{
+const std::set<StatIndex> frame_timeline_stats{StatIndex::frames_ahead_of_gpu, StatIndex::gpu_idle_time, StatIndex::queue_bubble_time,
+                                               StatIndex::acquire_time, StatIndex::present_time};
+}        // namespace
+
+FrameTimelineStatsProvider::FrameTimelineStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	bool requested = std::any_of(frame_timeline_stats.begin(), frame_timeline_stats.end(), [&requested_stats](StatIndex index) { return requested_stats.count(index) > 0; });
+
+	if (!requested || !render_context.set_frame_timeline(true))
+	{
+		return;
+	}
+
+	for (auto index : frame_timeline_stats)
+	{
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+}
+
+bool FrameTimelineStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters FrameTimelineStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	auto measurements = render_context.take_frame_timeline_measurements();
+
+	if (measurements.frame_count > 0)
+	{
+		double frame_count = measurements.frame_count;
+
+		prev_values[StatIndex::frames_ahead_of_gpu] = measurements.frames_ahead / frame_count;
+		prev_values[StatIndex::gpu_idle_time]       = measurements.gpu_idle_times / frame_count;
+		prev_values[StatIndex::queue_bubble_time]   = measurements.queue_bubble_times / frame_count;
+		prev_values[StatIndex::acquire_time]        = measurements.acquire_times / frame_count;
+		prev_values[StatIndex::present_time]        = measurements.present_times / frame_count;
+	}
+
+	for (auto index : supported_stats)
+	{
+		res[index].result = prev_values[index];
+	}
+
+	return res;
+}
+}        // namespace vkb
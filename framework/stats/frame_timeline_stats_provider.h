@@ -0,0 +1,61 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "stats_provider.h"
+
+namespace vkb
+{
+class RenderContext;
+
+/**
+ * @brief Provides the measurements of the frame timeline of a RenderContext, which it enables when one of its stats
+ *        is requested, see RenderContext::set_frame_timeline
+ */
+class FrameTimelineStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a FrameTimelineStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 * @param render_context The render context to measure the frames of
+	 */
+	FrameTimelineStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context);
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+  private:
+	RenderContext &render_context;
+
+	std::set<StatIndex> supported_stats;
+
+	/// Means of the last frames retired, reported again by samples without a retired frame
+	std::map<StatIndex, double> prev_values;
+};
+}        // namespace vkb
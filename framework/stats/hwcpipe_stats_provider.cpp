@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2020-2024, Broadcom Inc.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -18,6 +18,8 @@
 
 #include "hwcpipe_stats_provider.h"
 
+#include <algorithm>
+
 namespace
 {
 const char *get_product_family_name(hwcpipe::device::product_id::gpu_family f)
@@ -52,6 +54,7 @@ HWCPipeStatsProvider::HWCPipeStatsProvider(std::set<StatIndex> &requested_stats)
 	    {StatIndex::gpu_killed_tiles,      {hwcpipe_counter::MaliFragTileKill}},
 	    {StatIndex::gpu_fragment_cycles,   {hwcpipe_counter::MaliFragQueueActiveCy, {MaliFragActiveCy, MaliMainIterActiveCy}}},
 	    {StatIndex::gpu_fragment_jobs,     {hwcpipe_counter::MaliFragQueueJob, {MaliFragIterJob, MaliMainIterJob}}},
+	    {StatIndex::gpu_fragment_threads,  {hwcpipe_counter::MaliFragThread}},
 	    {StatIndex::gpu_ext_reads,         {hwcpipe_counter::MaliExtBusRdBt}},
 	    {StatIndex::gpu_ext_writes,        {hwcpipe_counter::MaliExtBusWrBt}},
 	    {StatIndex::gpu_ext_read_stalls,   {hwcpipe_counter::MaliExtBusRdStallCy}},
@@ -131,6 +134,21 @@ HWCPipeStatsProvider::HWCPipeStatsProvider(std::set<StatIndex> &requested_stats)
 		}
 	}
 
+	if (requested_stats.count(StatIndex::gpu_bottleneck) && gpu)
+	{
+		shader_core_count    = static_cast<uint32_t>(gpu.num_shader_cores());
+		bottleneck_supported = add_bottleneck_counters(config);
+		if (bottleneck_supported)
+		{
+			requested_stats.erase(StatIndex::gpu_bottleneck);
+			LOGI("HWCPipe: enabled the bottleneck classification");
+		}
+		else
+		{
+			LOGE("HWCPipe: the bottleneck classification counters are not supported by this GPU.");
+		}
+	}
+
 	// Remove any supported stats from the requested set.
 	// Subsequent providers will then only look for things that aren't already supported.
 	for (const auto &iter : stat_data)
@@ -142,7 +160,7 @@ HWCPipeStatsProvider::HWCPipeStatsProvider(std::set<StatIndex> &requested_stats)
 
 	sampler = std::make_unique<hwcpipe::sampler<>>(config);
 
-	if (stat_data_count > 0)
+	if (stat_data_count > 0 || bottleneck_supported)
 	{
 		ec = sampler->start_sampling();
 		if (ec)
@@ -156,7 +174,7 @@ HWCPipeStatsProvider::~HWCPipeStatsProvider()
 {
 	std::error_code ec;
 
-	if (stat_data_count > 0)
+	if (stat_data_count > 0 || bottleneck_supported)
 	{
 		ec = sampler->stop_sampling();
 		if (ec)
@@ -166,9 +184,48 @@ HWCPipeStatsProvider::~HWCPipeStatsProvider()
 	}
 }
 
+bool HWCPipeStatsProvider::add_bottleneck_counters(hwcpipe::sampler_config &config)
+{
+	// Counters already added for a stat, or the fallback which replaced them, are read as they are
+	auto add_counter = [this, &config](hwcpipe_counter counter, std::initializer_list<hwcpipe_counter> fallbacks, hwcpipe_counter &added) {
+		for (auto &iter : stat_data)
+		{
+			if (iter.second.counter == counter || std::find(fallbacks.begin(), fallbacks.end(), iter.second.counter) != fallbacks.end())
+			{
+				added = iter.second.counter;
+				return true;
+			}
+		}
+
+		if (!config.add_counter(counter))
+		{
+			added = counter;
+			return true;
+		}
+
+		for (auto fallback : fallbacks)
+		{
+			if (!config.add_counter(fallback))
+			{
+				added = fallback;
+				return true;
+			}
+		}
+
+		return false;
+	};
+
+	return add_counter(hwcpipe_counter::MaliGPUActiveCy, {}, bottleneck_counters.gpu_cycles) &&
+	       add_counter(hwcpipe_counter::MaliNonFragQueueActiveCy, {MaliNonFragActiveCy, MaliBinningIterActiveCy}, bottleneck_counters.vertex_cycles) &&
+	       add_counter(hwcpipe_counter::MaliFragQueueActiveCy, {MaliFragActiveCy, MaliMainIterActiveCy}, bottleneck_counters.fragment_cycles) &&
+	       add_counter(hwcpipe_counter::MaliTexIssueCy, {}, bottleneck_counters.texture_cycles) &&
+	       add_counter(hwcpipe_counter::MaliExtBusRdStallCy, {}, bottleneck_counters.read_stall_cycles) &&
+	       add_counter(hwcpipe_counter::MaliExtBusWrStallCy, {}, bottleneck_counters.write_stall_cycles);
+}
+
 bool HWCPipeStatsProvider::is_available(StatIndex index) const
 {
-	return stat_data.find(index) != stat_data.end();
+	return stat_data.find(index) != stat_data.end() || (index == StatIndex::gpu_bottleneck && bottleneck_supported);
 }
 
 const StatGraphData &HWCPipeStatsProvider::get_graph_data(StatIndex index) const
@@ -200,11 +257,29 @@ static double get_gpu_counter_value(const hwcpipe::counter_sample &sample)
 	}
 }
 
+double HWCPipeStatsProvider::sample_bottleneck()
+{
+	auto get_value = [this](hwcpipe_counter counter) {
+		hwcpipe::counter_sample sample;
+		return sampler->get_counter_value(counter, sample) ? 0.0 : get_gpu_counter_value(sample);
+	};
+
+	GpuBottleneckCounters counters;
+	counters.gpu_cycles        = get_value(bottleneck_counters.gpu_cycles);
+	counters.vertex_cycles     = get_value(bottleneck_counters.vertex_cycles);
+	counters.fragment_cycles   = get_value(bottleneck_counters.fragment_cycles);
+	counters.texture_cycles    = get_value(bottleneck_counters.texture_cycles);
+	counters.shader_core_count = shader_core_count;
+	counters.bus_stall_cycles  = get_value(bottleneck_counters.read_stall_cycles) + get_value(bottleneck_counters.write_stall_cycles);
+
+	return static_cast<double>(classify_gpu_bottleneck(counters));
+}
+
 StatsProvider::Counters HWCPipeStatsProvider::sample(float delta_time)
 {
 	Counters res;
 
-	if (stat_data_count < 1)
+	if (stat_data_count < 1 && !bottleneck_supported)
 	{
 		return res;
 	}
@@ -261,6 +336,11 @@ StatsProvider::Counters HWCPipeStatsProvider::sample(float delta_time)
 
 			res[index].result = d;
 		}
+
+		if (bottleneck_supported)
+		{
+			res[StatIndex::gpu_bottleneck].result = sample_bottleneck();
+		}
 	}
 
 	return res;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2020-2024, Broadcom Inc.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -21,6 +21,7 @@
 #include "common/error.h"
 #include "common/vk_common.h"
 
+#include "bottleneck.h"
 #include "stats_provider.h"
 
 VKBP_DISABLE_WARNINGS()
@@ -51,6 +52,17 @@ class HWCPipeStatsProvider : public StatsProvider
 
 	using StatDataMap = std::unordered_map<StatIndex, StatData, StatIndexHash>;
 
+	/// The counters read by the bottleneck classification, see classify_gpu_bottleneck()
+	struct BottleneckCounterIds
+	{
+		hwcpipe_counter gpu_cycles;
+		hwcpipe_counter vertex_cycles;
+		hwcpipe_counter fragment_cycles;
+		hwcpipe_counter texture_cycles;
+		hwcpipe_counter read_stall_cycles;
+		hwcpipe_counter write_stall_cycles;
+	};
+
   public:
 	/**
 	 * @brief Constructs a HWCPipeStateProvider
@@ -89,6 +101,17 @@ class HWCPipeStatsProvider : public StatsProvider
 	Counters continuous_sample(float delta_time) override;
 
   private:
+	/**
+	 * @brief Adds the counters of the bottleneck classification to the sampler configuration
+	 * @return Whether the GPU has all of them
+	 */
+	bool add_bottleneck_counters(hwcpipe::sampler_config &config);
+
+	/**
+	 * @return The bottleneck of the GPU over the last sample, as a Bottleneck value
+	 */
+	double sample_bottleneck();
+
 	std::unique_ptr<hwcpipe::sampler<>> sampler;
 
 	size_t stat_data_count{0};
@@ -98,6 +121,13 @@ class HWCPipeStatsProvider : public StatsProvider
 
 	// Counter sampling configuration
 	CounterSamplingConfig sampling_config;
+
+	// Whether the gpu_bottleneck stat was requested and its counters are available
+	bool bottleneck_supported{false};
+
+	BottleneckCounterIds bottleneck_counters{};
+
+	uint32_t shader_core_count{1};
 };
 
 }        // namespace vkb
@@ -0,0 +1,105 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "latency_stats_provider.h"
+
+#include "core/device.h"
+#include "platform/window.h"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+LatencyStatsProvider::LatencyStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	// The latencies can only be measured with present wait, they are zero until the low latency mode is enabled
+	if (render_context.get_device().uses_present_wait())
+	{
+		for (auto index : {StatIndex::present_interval, StatIndex::input_to_photon_latency, StatIndex::event_to_photon_latency})
+		{
+			if (requested_stats.erase(index))
+			{
+				supported_stats.insert(index);
+			}
+		}
+	}
+	// Presents paced by the window are due on a vsync, so their intervals are measured without present wait
+	else if (render_context.get_window().paces_presents())
+	{
+		if (requested_stats.erase(StatIndex::present_interval))
+		{
+			supported_stats.insert(StatIndex::present_interval);
+		}
+	}
+	else
+	{
+		return;
+	}
+
+	// Discard whatever was measured before the stats were requested
+	render_context.take_present_latencies();
+}
+
+bool LatencyStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters LatencyStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	auto latencies = render_context.take_present_latencies();
+
+	if (latencies.present_interval_count > 0)
+	{
+		prev_present_interval = latencies.present_intervals / latencies.present_interval_count;
+	}
+
+	if (latencies.input_to_photon_latency_count > 0)
+	{
+		prev_input_to_photon_latency = latencies.input_to_photon_latencies / latencies.input_to_photon_latency_count;
+	}
+
+	if (latencies.event_to_photon_latency_count > 0)
+	{
+		prev_event_to_photon_latency = latencies.event_to_photon_latencies / latencies.event_to_photon_latency_count;
+	}
+
+	if (is_available(StatIndex::present_interval))
+	{
+		res[StatIndex::present_interval].result = prev_present_interval;
+	}
+
+	if (is_available(StatIndex::input_to_photon_latency))
+	{
+		res[StatIndex::input_to_photon_latency].result = prev_input_to_photon_latency;
+	}
+
+	if (is_available(StatIndex::event_to_photon_latency))
+	{
+		res[StatIndex::event_to_photon_latency].result = prev_event_to_photon_latency;
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,144 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_stats_provider.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "core/allocated.h"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr std::pair<StatIndex, allocated::MemoryTag> tagged_stats[] = {
+    {StatIndex::buffer_pool_memory, allocated::MemoryTag::BufferPool},
+    {StatIndex::render_target_memory, allocated::MemoryTag::RenderTarget},
+    {StatIndex::scene_texture_memory, allocated::MemoryTag::SceneTexture},
+    {StatIndex::scene_geometry_memory, allocated::MemoryTag::SceneGeometry},
+    {StatIndex::staging_memory, allocated::MemoryTag::Staging},
+    {StatIndex::other_memory, allocated::MemoryTag::Other}};
+}        // namespace
+
+MemoryStatsProvider::MemoryStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	for (auto index : {StatIndex::device_memory_usage, StatIndex::device_memory_budget, StatIndex::direct_upload_memory, StatIndex::buffer_pool_peak_usage})
+	{
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+
+	for (auto &tagged_stat : tagged_stats)
+	{
+		if (requested_stats.erase(tagged_stat.first))
+		{
+			supported_stats.insert(tagged_stat.first);
+		}
+	}
+
+	direct_upload_graph_data = default_graph_data(StatIndex::direct_upload_memory);
+	direct_upload_graph_data.name += std::string(" (") + allocated::to_string(allocated::get_memory_architecture()) + ")";
+}
+
+bool MemoryStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters MemoryStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	// The usage and budget of the heaps include the memory allocated outside of VMA, the budget is estimated without VK_EXT_memory_budget
+	const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+	vmaGetMemoryProperties(allocated::get_memory_allocator(), &memory_properties);
+
+	std::vector<VmaBudget> budgets(memory_properties->memoryHeapCount);
+	vmaGetHeapBudgets(allocated::get_memory_allocator(), budgets.data());
+
+	VkDeviceSize usage  = 0;
+	VkDeviceSize budget = 0;
+	for (auto &heap_budget : budgets)
+	{
+		usage += heap_budget.usage;
+		budget += heap_budget.budget;
+	}
+
+	if (is_available(StatIndex::device_memory_usage))
+	{
+		res[StatIndex::device_memory_usage].result = static_cast<double>(usage);
+	}
+
+	if (is_available(StatIndex::device_memory_budget))
+	{
+		res[StatIndex::device_memory_budget].result = static_cast<double>(budget);
+	}
+
+	for (auto &tagged_stat : tagged_stats)
+	{
+		if (is_available(tagged_stat.first))
+		{
+			res[tagged_stat.first].result = static_cast<double>(allocated::get_tagged_memory_usage(tagged_stat.second));
+		}
+	}
+
+	if (is_available(StatIndex::direct_upload_memory))
+	{
+		res[StatIndex::direct_upload_memory].result = static_cast<double>(allocated::get_direct_upload_memory_usage());
+	}
+
+	if (is_available(StatIndex::buffer_pool_peak_usage))
+	{
+		// The frames are used in turn, the largest of their peaks is what a frame needs
+		VkDeviceSize peak_usage = 0;
+		for (auto &render_frame : render_context.get_render_frames())
+		{
+			peak_usage = std::max(peak_usage, render_frame->get_buffer_pool_peak_usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT));
+		}
+
+		res[StatIndex::buffer_pool_peak_usage].result = static_cast<double>(peak_usage);
+	}
+
+	return res;
+}
+
+const StatGraphData &MemoryStatsProvider::get_graph_data(StatIndex index) const
+{
+	if (index == StatIndex::direct_upload_memory)
+	{
+		return direct_upload_graph_data;
+	}
+
+	return StatsProvider::get_graph_data(index);
+}
+
+StatsProvider::Counters MemoryStatsProvider::continuous_sample(float delta_time)
+{
+	return sample(delta_time);
+}
+}        // namespace vkb
@@ -0,0 +1,69 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render_pipeline_stats_provider.h"
+
+#include "rendering/render_pipeline.h"
+
+namespace vkb
+{
+RenderPipelineStatsProvider::RenderPipelineStatsProvider(std::set<StatIndex> &requested_stats)
+{
+	for (auto index : {StatIndex::ext_read_bytes_saved, StatIndex::ext_write_bytes_saved})
+	{
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+
+	// Discard whatever was counted before the stats were requested
+	RenderPipeline::take_saved_bandwidth();
+}
+
+bool RenderPipelineStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters RenderPipelineStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	auto saved_bandwidth = RenderPipeline::take_saved_bandwidth();
+
+	// Per second, like the measured external bytes
+	double scale = delta_time != 0.0f ? 1.0 / delta_time : 0.0;
+
+	if (is_available(StatIndex::ext_read_bytes_saved))
+	{
+		res[StatIndex::ext_read_bytes_saved].result = static_cast<double>(saved_bandwidth.first) * scale;
+	}
+
+	if (is_available(StatIndex::ext_write_bytes_saved))
+	{
+		res[StatIndex::ext_write_bytes_saved].result = static_cast<double>(saved_bandwidth.second) * scale;
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,54 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "stats_provider.h"
+
+namespace vkb
+{
+/**
+ * @brief Provides the external memory bandwidth that render pipelines save by keeping attachments on-chip
+ *
+ * These are estimates from the size of the attachments, to compare with the measured external read and write bytes.
+ */
+class RenderPipelineStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a RenderPipelineStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 */
+	RenderPipelineStatsProvider(std::set<StatIndex> &requested_stats);
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+  private:
+	std::set<StatIndex> supported_stats;
+};
+}        // namespace vkb
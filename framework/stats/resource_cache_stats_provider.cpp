@@ -0,0 +1,138 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "resource_cache_stats_provider.h"
+
+#include "core/descriptor_pool.h"
+#include "core/device.h"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+ResourceCacheStatsProvider::ResourceCacheStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	for (auto index : {StatIndex::resource_cache_contention, StatIndex::descriptor_set_cache_size, StatIndex::descriptor_set_cache_hit_rate,
+	                   StatIndex::descriptor_pool_growths, StatIndex::pipeline_compile_queue_depth, StatIndex::pipeline_compile_stalls})
+	{
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+
+	prev_lock_contention_count = render_context.get_device().get_resource_cache().get_lock_contention_count();
+
+	// Discard whatever was counted before the stats were requested
+	if (is_available(StatIndex::descriptor_set_cache_hit_rate))
+	{
+		for (auto &render_frame : render_context.get_render_frames())
+		{
+			render_frame->take_descriptor_set_cache_counts();
+		}
+	}
+
+	if (is_available(StatIndex::pipeline_compile_stalls))
+	{
+		render_context.get_device().get_resource_cache().take_pipeline_compile_stall_count();
+	}
+
+	if (is_available(StatIndex::descriptor_pool_growths))
+	{
+		DescriptorPool::take_growth_count();
+	}
+}
+
+bool ResourceCacheStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters ResourceCacheStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	if (is_available(StatIndex::resource_cache_contention))
+	{
+		uint32_t lock_contention_count = render_context.get_device().get_resource_cache().get_lock_contention_count();
+
+		// The count is cumulative, report the number of contended lock acquisitions per second
+		if (delta_time != 0.0f)
+		{
+			res[StatIndex::resource_cache_contention].result = (lock_contention_count - prev_lock_contention_count) / delta_time;
+		}
+		else
+		{
+			res[StatIndex::resource_cache_contention].result = 0.0;
+		}
+
+		prev_lock_contention_count = lock_contention_count;
+	}
+
+	if (is_available(StatIndex::descriptor_set_cache_size) || is_available(StatIndex::descriptor_set_cache_hit_rate))
+	{
+		size_t   cache_size = 0;
+		uint32_t hits       = 0;
+		uint32_t misses     = 0;
+
+		for (auto &render_frame : render_context.get_render_frames())
+		{
+			cache_size += render_frame->get_descriptor_set_cache_size();
+
+			auto counts = render_frame->take_descriptor_set_cache_counts();
+			hits += counts.first;
+			misses += counts.second;
+		}
+
+		if (is_available(StatIndex::descriptor_set_cache_size))
+		{
+			res[StatIndex::descriptor_set_cache_size].result = static_cast<double>(cache_size);
+		}
+
+		if (is_available(StatIndex::descriptor_set_cache_hit_rate))
+		{
+			res[StatIndex::descriptor_set_cache_hit_rate].result = hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+		}
+	}
+
+	if (is_available(StatIndex::descriptor_pool_growths))
+	{
+		// Pools grow while new sets are needed, and merge when they are reset, a steady frame creates none
+		res[StatIndex::descriptor_pool_growths].result = DescriptorPool::take_growth_count();
+	}
+
+	auto &resource_cache = render_context.get_device().get_resource_cache();
+
+	if (is_available(StatIndex::pipeline_compile_queue_depth))
+	{
+		res[StatIndex::pipeline_compile_queue_depth].result = resource_cache.get_pipeline_compile_queue_depth();
+	}
+
+	if (is_available(StatIndex::pipeline_compile_stalls))
+	{
+		// Sampled once per frame, so this is the number of draws which could not use their pipeline this frame
+		res[StatIndex::pipeline_compile_stalls].result = resource_cache.take_pipeline_compile_stall_count();
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,50 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sampling_stats_provider.h"
+
+#include "stats/stats.h"
+
+namespace vkb
+{
+SamplingStatsProvider::SamplingStatsProvider(std::set<StatIndex> &requested_stats, const Stats &stats) :
+    stats{stats}
+{
+	if (requested_stats.erase(StatIndex::stats_sampling_time))
+	{
+		supported_stats.insert(StatIndex::stats_sampling_time);
+	}
+}
+
+bool SamplingStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters SamplingStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (!supported_stats.empty())
+	{
+		// The time of the previous update, the current one is still being measured
+		res[StatIndex::stats_sampling_time].result = stats.get_sampling_time();
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,71 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shadow_stats_provider.h"
+
+#include "rendering/cascaded_shadow_map.h"
+#include "rendering/ray_query_shadows.h"
+
+namespace vkb
+{
+ShadowStatsProvider::ShadowStatsProvider(std::set<StatIndex> &requested_stats)
+{
+	for (auto index : {StatIndex::shadow_cascades_drawn, StatIndex::shadow_rays})
+	{
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+
+	// Discard whatever was counted before the stats were requested
+	CascadedShadowMap::take_drawn_cascade_count();
+	RayQueryShadows::take_ray_count();
+}
+
+bool ShadowStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters ShadowStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	auto drawn_cascade_count = CascadedShadowMap::take_drawn_cascade_count();
+
+	if (is_available(StatIndex::shadow_cascades_drawn))
+	{
+		res[StatIndex::shadow_cascades_drawn].result = drawn_cascade_count;
+	}
+
+	auto ray_count = RayQueryShadows::take_ray_count();
+
+	// The rays are reported per second
+	if (is_available(StatIndex::shadow_rays))
+	{
+		res[StatIndex::shadow_rays].result = delta_time != 0.0f ? ray_count / delta_time : 0.0;
+	}
+
+	return res;
+}
+}        // namespace vkb
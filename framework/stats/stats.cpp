@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2024, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2020-2024, Broadcom Inc.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -17,12 +17,27 @@
  */
 
 #include "stats/stats.h"
+
+#include <cmath>
+
 #include "core/device.h"
+#include "rendering/gpu_profiler.h"
+#include "rendering/render_context.h"
 
+#include "command_buffer_stats_provider.h"
+#include "culling_stats_provider.h"
 #include "frame_time_stats_provider.h"
+#include "frame_timeline_stats_provider.h"
+#include "latency_stats_provider.h"
+#include "memory_stats_provider.h"
+#include "render_pipeline_stats_provider.h"
+#include "sampling_stats_provider.h"
+#include "shadow_stats_provider.h"
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 #	include "hwcpipe_stats_provider.h"
+#	include "thermal_stats_provider.h"
 #endif
+#include "resource_cache_stats_provider.h"
 #include "vulkan_stats_provider.h"
 
 namespace vkb
@@ -69,10 +84,23 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 #endif
 	providers.emplace_back(std::make_unique<VulkanStatsProvider>(stats, sampling_config, render_context));
+	providers.emplace_back(std::make_unique<ResourceCacheStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<CullingStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<ShadowStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<CommandBufferStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<RenderPipelineStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<LatencyStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<FrameTimelineStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<MemoryStatsProvider>(stats, render_context));
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+	providers.emplace_back(std::make_unique<ThermalStatsProvider>(stats));
+#endif
+	providers.emplace_back(std::make_unique<SamplingStatsProvider>(stats, *this));
 
-	// In continuous sampling mode we still need to update the frame times as if we are polling
-	// Store the frame time provider here so we can easily access it later.
-	frame_time_provider = providers[0].get();
+	// In continuous sampling modes we still need to update the frame times and the sampling time as if we are polling
+	// Store their providers here so we can easily access them later.
+	frame_time_provider    = providers.front().get();
+	sampling_time_provider = providers.back().get();
 
 	for (const auto &stat : requested_stats)
 	{
@@ -91,6 +119,17 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 		// Reduce smoothing for continuous sampling
 		alpha_smoothing = 0.6f;
 	}
+	else if (sampling_config.mode == CounterSamplingMode::FrameDriven)
+	{
+		frame_driven_interval = sampling_config.interval;
+
+		for (auto &p : providers)
+		{
+			p->continuous_sample(0.0f);
+		}
+
+		alpha_smoothing = 0.6f;
+	}
 
 	for (const auto &stat_index : requested_stats)
 	{
@@ -140,8 +179,58 @@ static void add_smoothed_value(std::vector<float> &values, float value, float al
 	values.back() = value * alpha + *(values.end() - 2) * (1.0f - alpha);
 }
 
+const GpuProfiler *Stats::get_gpu_profiler() const
+{
+	return render_context.get_gpu_profiler();
+}
+
+FrameBottleneck Stats::get_bottleneck() const
+{
+	FrameBottleneck result;
+
+	double gpu_time = 0.0;
+	if (auto *gpu_profiler = get_gpu_profiler())
+	{
+		for (auto &scope : gpu_profiler->get_scopes())
+		{
+			if (scope.depth > 0)
+			{
+				continue;
+			}
+
+			gpu_time += scope.time;
+			if (scope.time > result.pass_time)
+			{
+				result.pass      = scope.name;
+				result.pass_time = scope.time;
+			}
+		}
+	}
+
+	if (is_cpu_bound(frame_time, gpu_time))
+	{
+		result.bottleneck = Bottleneck::cpu;
+	}
+	else if (is_available(StatIndex::gpu_bottleneck))
+	{
+		auto &data = get_data(StatIndex::gpu_bottleneck);
+		if (!data.empty())
+		{
+			result.bottleneck = static_cast<Bottleneck>(std::lround(data.back()));
+		}
+	}
+
+	return result;
+}
+
 void Stats::update(float delta_time)
 {
+	// The delta time may be fixed by the platform, the bottleneck compares the GPU time with the actual frame time
+	frame_time = main_timer.tick<Timer::Seconds>();
+
+	Timer sampling_timer;
+	sampling_timer.start();
+
 	switch (sampling_config.mode)
 	{
 		case CounterSamplingMode::Polling:
@@ -158,69 +247,105 @@ void Stats::update(float delta_time)
 		}
 		case CounterSamplingMode::Continuous:
 		{
-			// Check that we have no pending samples to be shown
-			if (pending_samples.size() == 0)
+			// Move the samples of the worker thread out of the ring, so it can keep sampling
+			StatsProvider::Counters sample;
+			while (continuous_samples.try_pop(sample))
 			{
-				std::unique_lock<std::mutex> lock(continuous_sampling_mutex);
-				if (!should_add_to_continuous_samples)
-				{
-					// If we have no pending samples, we let the worker thread
-					// capture samples for the next frame
-					should_add_to_continuous_samples = true;
-				}
-				else
-				{
-					// The worker thread has captured a frame, so we stop it
-					// and read the samples
-					should_add_to_continuous_samples = false;
-					pending_samples.clear();
-					std::swap(pending_samples, continuous_samples);
-				}
+				pending_samples.push_back(std::move(sample));
 			}
 
-			if (pending_samples.size() == 0)
-			{
-				return;
-			}
+			push_pending_samples(delta_time);
+			break;
+		}
+		case CounterSamplingMode::FrameDriven:
+		{
+			frame_driven_sample(delta_time);
+			push_pending_samples(delta_time);
+			break;
+		}
+	}
 
-			// Ensure the number of pending samples is capped at a reasonable value
-			if (pending_samples.size() > 100)
-			{
-				// Prefer later samples over new samples.
-				std::move(pending_samples.end() - 100, pending_samples.end(), pending_samples.begin());
-				pending_samples.erase(pending_samples.begin() + 100, pending_samples.end());
+	sampling_time = static_cast<float>(sampling_timer.stop());
+}
 
-				// If we get to this point, we're not reading samples fast enough, nudge a little ahead.
-				fractional_pending_samples += 1.0f;
-			}
+void Stats::frame_driven_sample(float delta_time)
+{
+	frame_driven_elapsed += delta_time;
 
-			// Compute the number of samples to show this frame
-			float floating_sample_count = sampling_config.speed * delta_time * static_cast<float>(buffer_size) + fractional_pending_samples;
+	if (frame_driven_elapsed < std::chrono::duration_cast<std::chrono::duration<float>>(frame_driven_interval).count())
+	{
+		return;
+	}
 
-			// Keep track of the fractional value to avoid speeding up or slowing down too much due to rounding errors.
-			// Generally we push very few samples per frame, so this matters.
-			fractional_pending_samples = floating_sample_count - std::floor(floating_sample_count);
+	Timer sample_timer;
+	sample_timer.start();
 
-			auto sample_count = static_cast<size_t>(floating_sample_count);
+	StatsProvider::Counters sample;
+	for (auto &p : providers)
+	{
+		StatsProvider::Counters s = p->continuous_sample(frame_driven_elapsed);
+		sample.insert(s.begin(), s.end());
+	}
+	pending_samples.push_back(std::move(sample));
 
-			// Clamp the number of samples
-			sample_count = std::max<size_t>(1, std::min<size_t>(sample_count, pending_samples.size()));
+	frame_driven_elapsed = 0.0f;
 
-			// Get the frame time stats (not a continuous stat)
-			StatsProvider::Counters frame_time_sample = frame_time_provider->sample(delta_time);
+	// Sample less often while the providers exceed the budget, and back off towards the configured interval once they are well below it
+	auto time = std::chrono::duration<double>(sample_timer.stop());
+	if (time > sampling_config.budget)
+	{
+		frame_driven_interval = std::max<std::chrono::microseconds>(frame_driven_interval * 2, std::chrono::milliseconds{1});
+	}
+	else if (time < sampling_config.budget / 2 && frame_driven_interval > sampling_config.interval)
+	{
+		frame_driven_interval = std::max<std::chrono::microseconds>(frame_driven_interval / 2, sampling_config.interval);
+	}
+}
 
-			// Push the samples to circular buffers
-			std::for_each(pending_samples.begin(), pending_samples.begin() + sample_count, [this, frame_time_sample](auto &s) {
-				// Write the correct frame time into the continuous stats
-				s.insert(frame_time_sample.begin(), frame_time_sample.end());
-				// Then push the sample to the counters list
-				this->push_sample(s);
-			});
-			pending_samples.erase(pending_samples.begin(), pending_samples.begin() + sample_count);
+void Stats::push_pending_samples(float delta_time)
+{
+	if (pending_samples.size() == 0)
+	{
+		return;
+	}
 
-			break;
-		}
+	// Ensure the number of pending samples is capped at a reasonable value
+	if (pending_samples.size() > 100)
+	{
+		// Prefer later samples over new samples.
+		std::move(pending_samples.end() - 100, pending_samples.end(), pending_samples.begin());
+		pending_samples.erase(pending_samples.begin() + 100, pending_samples.end());
+
+		// If we get to this point, we're not reading samples fast enough, nudge a little ahead.
+		fractional_pending_samples += 1.0f;
 	}
+
+	// Compute the number of samples to show this frame
+	float floating_sample_count = sampling_config.speed * delta_time * static_cast<float>(buffer_size) + fractional_pending_samples;
+
+	// Keep track of the fractional value to avoid speeding up or slowing down too much due to rounding errors.
+	// Generally we push very few samples per frame, so this matters.
+	fractional_pending_samples = floating_sample_count - std::floor(floating_sample_count);
+
+	auto sample_count = static_cast<size_t>(floating_sample_count);
+
+	// Clamp the number of samples
+	sample_count = std::max<size_t>(1, std::min<size_t>(sample_count, pending_samples.size()));
+
+	// Get the frame time and sampling time stats (not continuous stats)
+	StatsProvider::Counters frame_sample = frame_time_provider->sample(delta_time);
+
+	StatsProvider::Counters sampling_time_sample = sampling_time_provider->sample(delta_time);
+	frame_sample.insert(sampling_time_sample.begin(), sampling_time_sample.end());
+
+	// Push the samples to circular buffers
+	std::for_each(pending_samples.begin(), pending_samples.begin() + sample_count, [this, &frame_sample](auto &s) {
+		// Write the correct frame time into the continuous stats
+		s.insert(frame_sample.begin(), frame_sample.end());
+		// Then push the sample to the counters list
+		this->push_sample(s);
+	});
+	pending_samples.erase(pending_samples.begin(), pending_samples.begin() + sample_count);
 }
 
 void Stats::continuous_sampling_worker(std::future<void> should_terminate)
@@ -252,14 +377,8 @@ void Stats::continuous_sampling_worker(std::future<void> should_terminate)
 			sample.insert(s.begin(), s.end());
 		}
 
-		// Add the new sample to the vector of continuous samples
-		{
-			std::unique_lock<std::mutex> lock(continuous_sampling_mutex);
-			if (should_add_to_continuous_samples)
-			{
-				continuous_samples.push_back(sample);
-			}
-		}
+		// Hand the sample over to the main thread, it is dropped if the main thread is not keeping up
+		continuous_samples.try_push(std::move(sample));
 	}
 }
 
@@ -279,7 +398,8 @@ void Stats::push_sample(const StatsProvider::Counters &sample)
 
 		float measurement = static_cast<float>(smp->second.result);
 
-		add_smoothed_value(values, measurement, alpha_smoothing);
+		// The bottleneck is a category, blending it with the previous ones would show a different category
+		add_smoothed_value(values, measurement, idx == StatIndex::gpu_bottleneck ? 1.0f : alpha_smoothing);
 	}
 }
 
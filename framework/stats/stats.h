@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2022, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2020-2022, Broadcom Inc.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -25,6 +25,8 @@
 #include <set>
 #include <vector>
 
+#include "bottleneck.h"
+#include "core/util/spsc_ring.hpp"
 #include "stats_common.h"
 #include "stats_provider.h"
 #include "timer.h"
@@ -33,6 +35,7 @@ namespace vkb
 {
 class Device;
 class CommandBuffer;
+class GpuProfiler;
 class RenderContext;
 
 /*
@@ -56,7 +59,7 @@ class Stats
 	/**
 	 * @brief Request specific set of stats to be collected
 	 * @param requested_stats Set of stats to be collected if available
-	 * @param sampling_config Sampling mode configuration (polling or continuous)
+	 * @param sampling_config Sampling mode configuration (polling, continuous or frame driven)
 	 */
 	void request_stats(const std::set<StatIndex> &requested_stats,
 	                   CounterSamplingConfig      sampling_config = {CounterSamplingMode::Polling});
@@ -99,6 +102,35 @@ class Stats
 		return requested_stats;
 	}
 
+	/**
+	 * @return The profiler of the GPU time of the scopes of the frames, null if RenderContext::set_gpu_profiling is not enabled
+	 */
+	const GpuProfiler *get_gpu_profiler() const;
+
+	/**
+	 * @brief Classifies the bottleneck of the last frame, and attributes it to the pass which took the most GPU time
+	 *        The frame is CPU-bound if the GPU profiler measured the GPU busy for only part of it, see is_cpu_bound().
+	 *        Otherwise the bottleneck is the one classified from the hardware counters of the GPU, if the
+	 *        StatIndex::gpu_bottleneck stat is available.
+	 */
+	FrameBottleneck get_bottleneck() const;
+
+	/**
+	 * @return The time in seconds the previous update() spent sampling the providers on the calling thread
+	 */
+	float get_sampling_time() const
+	{
+		return sampling_time;
+	}
+
+	/**
+	 * @return The interval at which counters are sampled in frame driven mode, lengthened while the sampling exceeds its budget
+	 */
+	std::chrono::microseconds get_sampling_interval() const
+	{
+		return frame_driven_interval;
+	}
+
 	/**
 	 * @brief Update statistics, must be called after every frame
 	 * @param delta_time Time since last update
@@ -143,6 +175,9 @@ class Stats
 	/// Provider that tracks frame times
 	StatsProvider *frame_time_provider;
 
+	/// Provider that reports the sampling time
+	StatsProvider *sampling_time_provider;
+
 	/// A list of stats providers to use in priority order
 	std::vector<std::unique_ptr<StatsProvider>> providers;
 
@@ -170,14 +205,8 @@ class Stats
 	/// Promise to stop the worker thread
 	std::unique_ptr<std::promise<void>> stop_worker;
 
-	/// A mutex for accessing measurements during continuous sampling
-	std::mutex continuous_sampling_mutex;
-
-	/// The samples read during continuous sampling
-	std::vector<StatsProvider::Counters> continuous_samples;
-
-	/// A flag specifying if the worker thread should add entries to continuous_samples
-	bool should_add_to_continuous_samples{false};
+	/// The samples read by the worker thread, the worker drops its samples while the ring is full
+	SpscRing<StatsProvider::Counters> continuous_samples{128};
 
 	/// The samples waiting to be displayed
 	std::vector<StatsProvider::Counters> pending_samples;
@@ -185,10 +214,28 @@ class Stats
 	/// A value which helps keep a steady pace of continuous samples output.
 	float fractional_pending_samples{0.0f};
 
+	/// The current sampling interval of the frame driven mode
+	std::chrono::microseconds frame_driven_interval{0};
+
+	/// Time since the last sample of the frame driven mode
+	float frame_driven_elapsed{0.0f};
+
+	/// Time in seconds the last update() spent sampling
+	float sampling_time{0.0f};
+
+	/// Time in seconds between the last two calls to update()
+	double frame_time{0.0};
+
 	/// The worker thread function for continuous sampling;
 	/// it adds a new entry to continuous_samples at every interval
 	void continuous_sampling_worker(std::future<void> should_terminate);
 
+	/// Takes a continuous sample of the providers in frame driven mode, adapting the interval to the sampling budget
+	void frame_driven_sample(float delta_time);
+
+	/// Pushes the pending samples due this frame, along with the per-frame stats
+	void push_pending_samples(float delta_time);
+
 	/// Updates circular buffers for CPU and GPU counters
 	void push_sample(const StatsProvider::Counters &sample);
 };
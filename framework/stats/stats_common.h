@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2022, Arm Limited and Contributors
+/* Copyright (c) 2018-2026, Arm Limited and Contributors
  * Copyright (c) 2020-2022, Broadcom Inc.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -56,6 +56,7 @@ enum class StatIndex
 	gpu_killed_tiles,
 	gpu_fragment_jobs,
 	gpu_fragment_cycles,
+	gpu_fragment_threads,
 	gpu_ext_reads,
 	gpu_ext_writes,
 	gpu_ext_read_stalls,
@@ -63,6 +64,58 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+
+	ext_read_bytes_saved,
+	ext_write_bytes_saved,
+
+	resource_cache_contention,
+
+	visible_draws,
+	culled_draws,
+	occlusion_visible_draws,
+	occluded_draws,
+
+	shadow_cascades_drawn,
+	shadow_rays,
+
+	descriptor_set_cache_size,
+	descriptor_set_cache_hit_rate,
+	descriptor_pool_growths,
+
+	skipped_pipeline_binds,
+	frame_arena_allocated_bytes,
+	frame_arena_heap_allocations,
+
+	pipeline_compile_queue_depth,
+	pipeline_compile_stalls,
+
+	present_interval,
+	input_to_photon_latency,
+	event_to_photon_latency,
+
+	frames_ahead_of_gpu,
+	gpu_idle_time,
+	queue_bubble_time,
+	acquire_time,
+	present_time,
+
+	stats_sampling_time,
+
+	device_memory_usage,
+	device_memory_budget,
+	buffer_pool_memory,
+	buffer_pool_peak_usage,
+	render_target_memory,
+	scene_texture_memory,
+	scene_geometry_memory,
+	staging_memory,
+	other_memory,
+	direct_upload_memory,
+
+	thermal_status,
+	thermal_headroom,
+
+	gpu_bottleneck,
 };
 
 struct StatIndexHash
@@ -91,18 +144,23 @@ enum class CounterSamplingMode
 	/// Sample counters only when calling update()
 	Polling,
 	/// Sample counters continuously, update circular buffers when calling update()
-	Continuous
+	Continuous,
+	/// Sample counters continuously from update() at the sampling interval, without a sampling thread
+	FrameDriven
 };
 
 struct CounterSamplingConfig
 {
-	/// Sampling mode (polling or continuous)
+	/// Sampling mode (polling, continuous or frame driven)
 	CounterSamplingMode mode;
 
-	/// Sampling interval in continuous mode
+	/// Sampling interval in continuous and frame driven modes
 	std::chrono::milliseconds interval{1};
 
-	/// Speed of circular buffer updates in continuous mode;
+	/// Sampling time per update() in frame driven mode, the interval is lengthened while the sampling exceeds it
+	std::chrono::microseconds budget{200};
+
+	/// Speed of circular buffer updates in continuous and frame driven modes;
 	/// at speed = 1.0f a new sample is displayed over 1 second.
 	float speed{0.5f};
 };
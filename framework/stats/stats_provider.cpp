@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2023, Broadcom Inc. and Contributors
+/* Copyright (c) 2020-2026, Broadcom Inc. and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -47,6 +47,7 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_killed_tiles,      {"Tiles killed by CRC match",                   "{:4.1f} k/s",   static_cast<float>(1e-3)}},
     {StatIndex::gpu_fragment_jobs,     {"Fragment Jobs",                               "{:4.0f}/s"}},
     {StatIndex::gpu_fragment_cycles,   {"Fragment Cycles",                             "{:4.1f} M/s",   static_cast<float>(1e-6)}},
+    {StatIndex::gpu_fragment_threads,  {"Fragment Threads",                            "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_tex_cycles,        {"Shader Texture Cycles",                       "{:4.0f} k/s",   static_cast<float>(1e-3)}},
     {StatIndex::gpu_ext_reads,         {"External Reads",                              "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_writes,        {"External Writes",                             "{:4.1f} M/s",   static_cast<float>(1e-6)}},
@@ -54,6 +55,46 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_ext_write_stalls,  {"External Write Stalls",                       "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_bytes,    {"External Read Bytes",                         "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
     {StatIndex::gpu_ext_write_bytes,   {"External Write Bytes",                        "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::ext_read_bytes_saved,  {"Est. External Read Bytes Saved",              "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::ext_write_bytes_saved, {"Est. External Write Bytes Saved",             "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+
+    {StatIndex::resource_cache_contention, {"Resource Cache Contention",               "{:4.0f}/s"}},
+    {StatIndex::visible_draws,         {"Visible Draws",                               "{:4.0f}"}},
+    {StatIndex::culled_draws,          {"Culled Draws",                                "{:4.0f}"}},
+    {StatIndex::occlusion_visible_draws, {"Occlusion Visible Draws",                   "{:4.0f}"}},
+    {StatIndex::occluded_draws,        {"Occluded Draws",                              "{:4.0f}"}},
+    {StatIndex::shadow_cascades_drawn, {"Shadow Cascades Drawn",                       "{:4.0f}"}},
+    {StatIndex::shadow_rays,           {"Shadow Rays",                                 "{:4.1f} M/s",   static_cast<float>(1e-6)}},
+    {StatIndex::descriptor_set_cache_size,     {"Cached Descriptor Sets",          "{:4.0f}"}},
+    {StatIndex::descriptor_set_cache_hit_rate, {"Descriptor Set Cache Hit Rate",   "{:3.1f}%",      100.0f,                       true,     100.0f}},
+    {StatIndex::descriptor_pool_growths,       {"Descriptor Pool Growths",         "{:4.0f}"}},
+    {StatIndex::skipped_pipeline_binds,        {"Skipped Pipeline Binds",          "{:4.0f}"}},
+    {StatIndex::frame_arena_allocated_bytes,   {"Frame Arena Allocations",         "{:4.1f} KiB",   1.0f / 1024.0f}},
+    {StatIndex::frame_arena_heap_allocations,  {"Frame Arena Heap Allocations",    "{:4.0f}"}},
+    {StatIndex::pipeline_compile_queue_depth,  {"Queued Pipeline Compiles",        "{:4.0f}"}},
+    {StatIndex::pipeline_compile_stalls,       {"Pipeline Compile Stalls",         "{:4.0f}"}},
+    {StatIndex::present_interval,              {"Present Interval",                "{:3.1f} ms",    1000.0f}},
+    {StatIndex::input_to_photon_latency,       {"Input to Photon Latency",         "{:3.1f} ms",    1000.0f}},
+    {StatIndex::event_to_photon_latency,       {"Event to Photon Latency",         "{:3.1f} ms",    1000.0f}},
+    {StatIndex::frames_ahead_of_gpu,           {"CPU Frames Ahead of GPU",         "{:3.1f}"}},
+    {StatIndex::gpu_idle_time,                 {"GPU Idle Time",                   "{:3.2f} ms",    1000.0f}},
+    {StatIndex::queue_bubble_time,             {"Queue Bubble Time",               "{:3.2f} ms",    1000.0f}},
+    {StatIndex::acquire_time,                  {"Acquire Time",                    "{:3.2f} ms",    1000.0f}},
+    {StatIndex::present_time,                  {"Present Time",                    "{:3.2f} ms",    1000.0f}},
+    {StatIndex::stats_sampling_time,           {"Stats Sampling Time",             "{:3.2f} ms",    1000.0f}},
+    {StatIndex::device_memory_usage,           {"Device Memory Usage",             "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::device_memory_budget,          {"Device Memory Budget",            "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::buffer_pool_memory,            {"Buffer Pool Memory",              "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::buffer_pool_peak_usage,        {"Uniform Buffer Pool Peak Usage",  "{:4.1f} KiB",   1.0f / 1024.0f}},
+    {StatIndex::render_target_memory,          {"Render Target Memory",            "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::scene_texture_memory,          {"Scene Texture Memory",            "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::scene_geometry_memory,         {"Scene Geometry Memory",           "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::staging_memory,                {"Staging Memory",                  "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::other_memory,                  {"Other Memory",                    "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::direct_upload_memory,          {"Direct Upload Memory",            "{:4.1f} MiB",   1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::thermal_status,                {"Thermal Status",                  "{:1.0f}",       1.0f,                         true,     6.0f}},
+    {StatIndex::thermal_headroom,              {"Thermal Headroom",                "{:3.0f}%",      100.0f}},
+    {StatIndex::gpu_bottleneck,                {"GPU Bottleneck",                  "{:1.0f}",       1.0f,                         true,     5.0f}},
     // clang-format on
 };
 
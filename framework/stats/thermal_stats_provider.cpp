@@ -0,0 +1,67 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thermal_stats_provider.h"
+
+namespace vkb
+{
+ThermalStatsProvider::ThermalStatsProvider(std::set<StatIndex> &requested_stats)
+{
+	// The system only reports the status from API 30 and the headroom from API 31
+	if (thermal_monitor.get_status() == AndroidThermalMonitor::UNKNOWN_STATUS)
+	{
+		return;
+	}
+
+	if (requested_stats.erase(StatIndex::thermal_status))
+	{
+		supported_stats.insert(StatIndex::thermal_status);
+	}
+
+	if (thermal_monitor.get_headroom() >= 0.0f && requested_stats.erase(StatIndex::thermal_headroom))
+	{
+		supported_stats.insert(StatIndex::thermal_headroom);
+	}
+}
+
+bool ThermalStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) > 0;
+}
+
+StatsProvider::Counters ThermalStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (is_available(StatIndex::thermal_status))
+	{
+		res[StatIndex::thermal_status].result = thermal_monitor.get_status();
+	}
+
+	if (is_available(StatIndex::thermal_headroom))
+	{
+		res[StatIndex::thermal_headroom].result = thermal_monitor.get_headroom();
+	}
+
+	return res;
+}
+
+StatsProvider::Counters ThermalStatsProvider::continuous_sample(float delta_time)
+{
+	return sample(delta_time);
+}
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2023, Broadcom Inc. and Contributors
+/* Copyright (c) 2020-2026, Broadcom Inc. and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -21,6 +21,7 @@
 #include "rendering/render_context.h"
 #include "vulkan_stats_provider.h"
 
+#include <cstring>
 #include <regex>
 
 namespace vkb
@@ -246,25 +247,26 @@ bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 		return false;
 	}
 
+	// The results of a frame are read once available, frames later, so the rings have spare slices for late results
+	uint32_t slice_count = num_framebuffers * 2;
+
 	// We will need a query pool to report the stats back to us
+	// The ring resets it on the host, which is valid for performance queries unlike resets in the command buffer,
+	// as those may need multiple passes
 	VkQueryPoolCreateInfo pool_create_info{};
 	pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
 	pool_create_info.pNext      = &perf_create_info;
 	pool_create_info.queryType  = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
-	pool_create_info.queryCount = num_framebuffers;
-
-	query_pool = std::make_unique<QueryPool>(device, pool_create_info);
+	pool_create_info.queryCount = 1;
 
-	if (!query_pool)
-	{
-		LOGW("Failed to create performance query pool");
-		return false;
-	}
+	results.resize(counter_indices.size());
 
-	// Reset the query pool before first use. We cannot do these in the command buffer
-	// as that is invalid usage for performance queries due to the potential for multiple
-	// passes being required.
-	query_pool->host_reset(0, num_framebuffers);
+	query_ring = std::make_unique<QueryRing>(device, pool_create_info, slice_count,
+	                                         sizeof(VkPerformanceCounterResultKHR) * counter_indices.size(), 0,
+	                                         [this](const uint8_t *data) {
+		                                         std::memcpy(results.data(), data, results.size() * sizeof(VkPerformanceCounterResultKHR));
+		                                         results_ready = true;
+	                                         });
 
 	if (has_timestamps)
 	{
@@ -274,9 +276,14 @@ bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 		VkQueryPoolCreateInfo timestamp_pool_create_info{};
 		timestamp_pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
 		timestamp_pool_create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
-		timestamp_pool_create_info.queryCount = num_framebuffers * 2;        // 2 timestamps per frame (start & end)
-
-		timestamp_pool = std::make_unique<QueryPool>(device, timestamp_pool_create_info);
+		timestamp_pool_create_info.queryCount = 2;        // 2 timestamps per frame (start & end)
+
+		timestamp_ring = std::make_unique<QueryRing>(device, timestamp_pool_create_info, slice_count, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT,
+		                                             [this](const uint8_t *data) {
+			                                             uint64_t timestamps[2];
+			                                             std::memcpy(timestamps, data, sizeof(timestamps));
+			                                             gpu_delta_time = timestamp_period * static_cast<float>(timestamps[1] - timestamps[0]) * 0.000000001f;
+		                                             });
 	}
 
 	return true;
@@ -284,8 +291,8 @@ bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 
 bool VulkanStatsProvider::is_supported(const CounterSamplingConfig &sampling_config) const
 {
-	// Continuous sampling mode cannot be supported by VK_KHR_performance_query
-	if (sampling_config.mode == CounterSamplingMode::Continuous)
+	// Continuous sampling modes cannot be supported by VK_KHR_performance_query
+	if (sampling_config.mode != CounterSamplingMode::Polling)
 	{
 		return false;
 	}
@@ -337,29 +344,35 @@ const StatGraphData &VulkanStatsProvider::get_graph_data(StatIndex index) const
 
 void VulkanStatsProvider::begin_sampling(CommandBuffer &cb)
 {
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-	if (timestamp_pool)
+	// Polls the timestamps before the performance queries, so that the delta time matches the counters read back
+	if (timestamp_ring)
 	{
 		// We use TimestampQueries when available to provide a more accurate delta_time.
 		// This counters are from a single command buffer execution, but the passed
 		// delta time is a frame-to-frame s/w measure. A timestamp query in the the cmd
 		// buffer gives the actual elapsed time where the counters were measured.
-		cb.reset_query_pool(*timestamp_pool, active_frame_idx * 2, 1);
-		cb.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *timestamp_pool,
-		                   active_frame_idx * 2);
+		timestamps_active = timestamp_ring->begin_slice();
+		if (timestamps_active)
+		{
+			cb.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamp_ring->get_query_pool(),
+			                   timestamp_ring->get_first_query());
+		}
 	}
 
-	if (query_pool)
+	if (query_ring)
 	{
-		cb.begin_query(*query_pool, active_frame_idx, static_cast<VkQueryControlFlags>(0));
+		// Without a free slice, every slice is waiting for its results and this command buffer is not sampled
+		query_active = query_ring->begin_slice();
+		if (query_active)
+		{
+			cb.begin_query(query_ring->get_query_pool(), query_ring->get_first_query(), static_cast<VkQueryControlFlags>(0));
+		}
 	}
 }
 
 void VulkanStatsProvider::end_sampling(CommandBuffer &cb)
 {
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-
-	if (query_pool)
+	if (query_active)
 	{
 		// Perform a barrier to ensure all previous commands complete before ending the query
 		// This does not block later commands from executing as we use BOTTOM_OF_PIPE in the
@@ -368,16 +381,19 @@ void VulkanStatsProvider::end_sampling(CommandBuffer &cb)
 		                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
 		                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
 		                     0, 0, nullptr, 0, nullptr, 0, nullptr);
-		cb.end_query(*query_pool, active_frame_idx);
+		cb.end_query(query_ring->get_query_pool(), query_ring->get_first_query());
 
-		++queries_ready;
+		query_ring->end_slice();
+		query_active = false;
 	}
 
-	if (timestamp_pool)
+	if (timestamps_active)
 	{
-		cb.reset_query_pool(*timestamp_pool, active_frame_idx * 2 + 1, 1);
-		cb.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *timestamp_pool,
-		                   active_frame_idx * 2 + 1);
+		cb.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamp_ring->get_query_pool(),
+		                   timestamp_ring->get_first_query() + 1);
+
+		timestamp_ring->end_slice();
+		timestamps_active = false;
 	}
 }
 
@@ -406,52 +422,20 @@ static double get_counter_value(const VkPerformanceCounterResultKHR &result,
 
 float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
 {
-	if (!timestamp_pool)
-	{
-		return sw_delta_time;
-	}
-
-	float delta_time = sw_delta_time;
-
-	// Query the timestamps to get an accurate delta time
-	std::array<uint64_t, 2> timestamps;
-
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-
-	VkResult r = timestamp_pool->get_results(active_frame_idx * 2, 2,
-	                                         timestamps.size() * sizeof(uint64_t),
-	                                         timestamps.data(), sizeof(uint64_t),
-	                                         VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT);
-	if (r == VK_SUCCESS)
-	{
-		float elapsed_ns = timestamp_period * static_cast<float>(timestamps[1] - timestamps[0]);
-		delta_time       = elapsed_ns * 0.000000001f;
-	}
-
-	return delta_time;
+	// The timestamps of the command buffer the counters were read back for
+	return gpu_delta_time > 0.0f ? gpu_delta_time : sw_delta_time;
 }
 
 StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 {
 	Counters out;
-	if (!query_pool || queries_ready == 0)
+	// The results of the sampled command buffers arrive frames later, the counters are only updated when they do
+	if (!query_ring || !results_ready)
 	{
 		return out;
 	}
 
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-
-	VkDeviceSize stride = sizeof(VkPerformanceCounterResultKHR) * counter_indices.size();
-
-	std::vector<VkPerformanceCounterResultKHR> results(counter_indices.size());
-
-	VkResult r = query_pool->get_results(active_frame_idx, 1,
-	                                     results.size() * sizeof(VkPerformanceCounterResultKHR),
-	                                     results.data(), stride, VK_QUERY_RESULT_WAIT_BIT);
-	if (r != VK_SUCCESS)
-	{
-		return out;
-	}
+	results_ready = false;
 
 	// Use timestamps to get a more accurate delta if available
 	delta_time = get_best_delta_time(delta_time);
@@ -494,11 +478,6 @@ StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 		}
 	}
 
-	// Now reset the query we just fetched the results from
-	query_pool->host_reset(active_frame_idx, 1);
-
-	--queries_ready;
-
 	return out;
 }
 
@@ -17,7 +17,7 @@
 
 #pragma once
 
-#include "core/query_pool.h"
+#include "core/query_ring.h"
 #include "stats_provider.h"
 
 namespace vkb
@@ -135,8 +135,8 @@ class VulkanStatsProvider : public StatsProvider
 	// The render context
 	RenderContext &render_context;
 
-	// The query pool for the performance queries
-	std::unique_ptr<QueryPool> query_pool;
+	// The performance queries, read back frames later so that sampling never stalls
+	std::unique_ptr<QueryRing> query_ring;
 
 	// Do we support timestamp queries
 	bool has_timestamps{false};
@@ -144,8 +144,8 @@ class VulkanStatsProvider : public StatsProvider
 	// The timestamp period
 	float timestamp_period{1.0f};
 
-	// Query pool for timestamps
-	std::unique_ptr<QueryPool> timestamp_pool;
+	// Timestamps at the beginning and the end of the sampled command buffers
+	std::unique_ptr<QueryRing> timestamp_ring;
 
 	// Map of vendor specific stat data
 	VendorStatMap vendor_data;
@@ -156,8 +156,19 @@ class VulkanStatsProvider : public StatsProvider
 	// An ordered list of the Vulkan counter ids
 	std::vector<uint32_t> counter_indices;
 
-	// How many queries have been ended?
-	uint32_t queries_ready = 0;
+	// Whether the sampled command buffer being recorded writes a slice of each ring
+	bool query_active{false};
+
+	bool timestamps_active{false};
+
+	// The results of the last performance query read back, in the order of counter_indices
+	std::vector<VkPerformanceCounterResultKHR> results;
+
+	// Whether results were read back since the last sample
+	bool results_ready{false};
+
+	// The GPU time of the last sampled command buffer read back, 0 if unknown
+	float gpu_delta_time{0.0f};
 };
 
 }        // namespace vkb
@@ -0,0 +1,186 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <set>
+#include <thread>
+
+#include <core/util/job_system.hpp>
+
+#include "geometry/frustum.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+#include "scene_graph/scene_bvh.h"
+
+using namespace vkb;
+
+namespace
+{
+/**
+ * @brief A scene of unit cubes laid out along the x axis, 4 units apart, in front of an orthographic view
+ */
+struct CubeRow
+{
+	sg::Scene scene{"cube row"};
+
+	std::vector<sg::Node *> nodes;
+
+	explicit CubeRow(size_t node_count)
+	{
+		auto root = std::make_unique<sg::Node>(0, "root");
+		scene.set_root_node(*root);
+
+		auto mesh = std::make_unique<sg::Mesh>("cube");
+		mesh->update_bounds({glm::vec3(-0.5f), glm::vec3(0.5f)});
+
+		for (size_t i = 0; i < node_count; ++i)
+		{
+			auto node = std::make_unique<sg::Node>(i + 1, "cube " + std::to_string(i));
+			node->set_parent(*root);
+			node->set_component(*mesh);
+			mesh->add_node(*node);
+			scene.add_child(*node);
+
+			nodes.push_back(node.get());
+			scene.add_node(std::move(node));
+
+			move(i, 4.0f * i);
+		}
+
+		scene.add_node(std::move(root));
+		scene.add_component(std::move(mesh));
+	}
+
+	void move(size_t index, float x)
+	{
+		nodes[index]->get_transform().set_translation(glm::vec3(x, 0.0f, -5.0f));
+	}
+
+	/**
+	 * @return The nodes the hierarchy finds in the view of the x range [left, right]
+	 */
+	std::set<sg::Node *> query(float left, float right) const
+	{
+		Frustum frustum;
+		frustum.update(glm::ortho(left, right, -1.0f, 1.0f, 0.1f, 10.0f));
+
+		std::vector<sg::Node *> result;
+		scene.get_bvh()->query_frustum(frustum, result);
+
+		return {result.begin(), result.end()};
+	}
+
+	/**
+	 * @return The nodes whose cube overlaps the x range [left, right], tested one by one
+	 */
+	std::set<sg::Node *> expected(float left, float right) const
+	{
+		std::set<sg::Node *> result;
+		for (auto node : nodes)
+		{
+			float x = node->get_transform().get_translation().x;
+			if (x + 0.5f >= left && x - 0.5f <= right)
+			{
+				result.insert(node);
+			}
+		}
+		return result;
+	}
+};
+}        // namespace
+
+TEST_CASE("vkb::sg::SceneBVH is built by the first update", "[scene_graph]")
+{
+	CubeRow row{32};
+	row.scene.set_bvh_enabled(true);
+
+	REQUIRE(row.scene.get_bvh() == nullptr);
+
+	row.scene.update_world_matrices();
+
+	REQUIRE(row.scene.get_bvh() != nullptr);
+	REQUIRE(row.scene.get_bvh()->get_node_count() == 32);
+	REQUIRE(row.scene.get_bvh()->get_cost_ratio() == 1.0f);
+
+	REQUIRE(row.query(-1.0f, 9.0f) == std::set<sg::Node *>{row.nodes[0], row.nodes[1], row.nodes[2]});
+	REQUIRE(row.query(50.0f, 90.0f) == row.expected(50.0f, 90.0f));
+	REQUIRE(row.query(200.0f, 300.0f).empty());
+}
+
+TEST_CASE("vkb::sg::SceneBVH refits the nodes which moved", "[scene_graph]")
+{
+	CubeRow row{32};
+	row.scene.set_bvh_enabled(true);
+	row.scene.update_world_matrices();
+
+	// Few nodes move by little, so their leaves are refit without degrading the tree enough for a rebuild
+	row.move(0, -20.0f);
+	row.move(5, 3.0f);
+	row.scene.update_world_matrices();
+
+	auto bvh = row.scene.get_bvh();
+	REQUIRE(bvh->get_cost_ratio() > 1.0f);
+	REQUIRE(bvh->get_cost_ratio() <= sg::SceneBVH::REBUILD_COST_RATIO);
+
+	REQUIRE(row.query(-1.0f, 9.0f) == std::set<sg::Node *>{row.nodes[1], row.nodes[2], row.nodes[5]});
+	REQUIRE(row.query(-21.0f, -19.0f) == std::set<sg::Node *>{row.nodes[0]});
+	REQUIRE(row.query(19.0f, 21.0f).empty());
+}
+
+TEST_CASE("vkb::sg::SceneBVH is rebuilt once the nodes are shuffled", "[scene_graph]")
+{
+	CubeRow row{32};
+	row.scene.set_bvh_enabled(true);
+	row.scene.update_world_matrices();
+
+	// Every leaf ends up spanning the whole row
+	for (size_t i = 0; i < row.nodes.size(); ++i)
+	{
+		row.move(i, 4.0f * ((i * 7) % row.nodes.size()));
+	}
+
+	SECTION("immediately without a job system")
+	{
+		row.scene.update_world_matrices();
+
+		REQUIRE(row.scene.get_bvh()->get_cost_ratio() == 1.0f);
+	}
+
+	SECTION("in the background with a job system")
+	{
+		JobSystem job_system{2};
+
+		row.scene.update_world_matrices(&job_system);
+
+		// The refit tree answers the queries until the rebuild replaces it
+		REQUIRE(row.query(-1.0f, 9.0f) == row.expected(-1.0f, 9.0f));
+
+		for (int i = 0; i < 1000 && row.scene.get_bvh()->get_cost_ratio() > sg::SceneBVH::REBUILD_COST_RATIO; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			row.scene.update_world_matrices(&job_system);
+		}
+
+		REQUIRE(row.scene.get_bvh()->get_cost_ratio() == 1.0f);
+	}
+
+	REQUIRE(row.query(-1.0f, 9.0f) == row.expected(-1.0f, 9.0f));
+	REQUIRE(row.query(30.0f, 70.0f) == row.expected(30.0f, 70.0f));
+}
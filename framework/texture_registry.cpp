@@ -0,0 +1,83 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "texture_registry.h"
+
+#include "scene_graph/components/image.h"
+
+namespace vkb
+{
+std::unique_ptr<sg::Image> TextureRegistry::find(const Hash128 &content_hash, const std::string &name)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto entry_it = entries.find(content_hash);
+	if (entry_it == entries.end())
+	{
+		return nullptr;
+	}
+
+	auto vk_image      = entry_it->second.vk_image.lock();
+	auto vk_image_view = entry_it->second.vk_image_view.lock();
+	auto vk_array_view = entry_it->second.vk_array_view.lock();
+
+	// Images packed in a texture array keep its view alive along with their own
+	if (!vk_image || !vk_image_view)
+	{
+		// The scenes of the image were all released
+		entries.erase(entry_it);
+		return nullptr;
+	}
+
+	auto image = entry_it->second.description->share(name);
+
+	image->vk_image      = std::move(vk_image);
+	image->vk_image_view = std::move(vk_image_view);
+	image->vk_array_view = std::move(vk_array_view);
+
+	shared_count++;
+
+	return image;
+}
+
+void TextureRegistry::add(const Hash128 &content_hash, const sg::Image &image)
+{
+	assert(image.vk_image && image.vk_image_view && "The Vulkan image must be created");
+
+	Entry entry;
+	entry.description   = image.share(image.get_name());
+	entry.vk_image      = image.vk_image;
+	entry.vk_image_view = image.vk_image_view;
+	entry.vk_array_view = image.vk_array_view;
+
+	// The description must not keep the Vulkan image alive
+	entry.description->vk_image.reset();
+	entry.description->vk_image_view.reset();
+	entry.description->vk_array_view.reset();
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	entries[content_hash] = std::move(entry);
+}
+
+size_t TextureRegistry::get_shared_count() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return shared_count;
+}
+}        // namespace vkb
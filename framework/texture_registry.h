@@ -0,0 +1,96 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "core/util/hash.hpp"
+
+namespace vkb
+{
+namespace core
+{
+class Image;
+class ImageView;
+}        // namespace core
+
+namespace sg
+{
+class Image;
+}        // namespace sg
+
+/**
+ * @brief Shares the Vulkan images of textures of the same content across the scenes loaded on a device, see Device::get_texture_registry()
+ *
+ * Images are keyed by a hash of their encoded content, so that loading the same texture again, from the same file or from another
+ * file with identical bytes, costs no decode, upload or memory. The registry only keeps weak references: a Vulkan image is
+ * released with the last sg::Image sharing it, see sg::Image::share().
+ */
+class TextureRegistry
+{
+  public:
+	TextureRegistry() = default;
+
+	TextureRegistry(const TextureRegistry &) = delete;
+
+	TextureRegistry(TextureRegistry &&) = delete;
+
+	TextureRegistry &operator=(const TextureRegistry &) = delete;
+
+	TextureRegistry &operator=(TextureRegistry &&) = delete;
+
+	/**
+	 * @return A new image sharing the resident Vulkan image of the content, or null if no image of the content is alive
+	 */
+	std::unique_ptr<sg::Image> find(const Hash128 &content_hash, const std::string &name);
+
+	/**
+	 * @brief Registers an image for the loads of the same content to share its Vulkan image
+	 *        The Vulkan image must be resident and ready for sampling.
+	 */
+	void add(const Hash128 &content_hash, const sg::Image &image);
+
+	/**
+	 * @return The number of images shared by find() so far
+	 */
+	size_t get_shared_count() const;
+
+  private:
+	struct Entry
+	{
+		/// The format, extent, mipmaps and swizzle of the image, without its Vulkan image
+		std::unique_ptr<sg::Image> description;
+
+		std::weak_ptr<core::Image> vk_image;
+
+		std::weak_ptr<core::ImageView> vk_image_view;
+
+		/// Set if the image is a layer of a texture array, see sg::Image::set_array_layer()
+		std::weak_ptr<core::ImageView> vk_array_view;
+	};
+
+	mutable std::mutex mutex;
+
+	std::unordered_map<Hash128, Entry> entries;
+
+	size_t shared_count{0};
+};
+}        // namespace vkb
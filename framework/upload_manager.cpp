@@ -0,0 +1,335 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "upload_manager.h"
+
+#include <algorithm>
+
+#include "common/error.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+
+namespace vkb
+{
+UploadManager::UploadManager(Device &device, VkDeviceSize staging_ring_size) :
+    device{device},
+    queue{device.get_queue(device.get_queue_family_index(VK_QUEUE_TRANSFER_BIT), 0)},
+    graphics_queue_family{device.get_suitable_graphics_queue().get_family_index()},
+    staging_ring{core::Buffer::create_staging_buffer(device, staging_ring_size, nullptr)}
+{
+	// Offsets of buffer to image copies must be multiples of the texel block size, which is at most 16 bytes
+	staging_alignment = std::max(staging_alignment, device.get_gpu().get_properties().limits.optimalBufferCopyOffsetAlignment);
+}
+
+UploadManager::~UploadManager()
+{
+	// The batches in flight read from the staging buffers
+	for (auto &batch : submitted_batches)
+	{
+		batch->fence_pool->wait();
+	}
+}
+
+void UploadManager::upload_buffer(core::Buffer &buffer, const void *data, VkDeviceSize size, VkDeviceSize offset,
+                                  VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask)
+{
+	// Buffers created mapped are host visible, and the submission of their first use makes the host writes visible
+	if (buffer.mapped())
+	{
+		buffer.update(data, static_cast<size_t>(size), static_cast<size_t>(offset));
+		return;
+	}
+
+	auto staging = stage(data, size);
+
+	auto &command_buffer = get_command_buffer();
+
+	VkBufferCopy copy_region{staging.second, offset, size};
+	vkCmdCopyBuffer(command_buffer.get_handle(), staging.first->get_handle(), buffer.get_handle(), 1, &copy_region);
+
+	BufferMemoryBarrier memory_barrier{};
+	memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	memory_barrier.src_access_mask  = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memory_barrier.dst_stage_mask   = dst_stage_mask;
+	memory_barrier.dst_access_mask  = dst_access_mask;
+	memory_barrier.old_queue_family = queue.get_family_index();
+	memory_barrier.new_queue_family = graphics_queue_family;
+
+	command_buffer.release_ownership(buffer, offset, size, memory_barrier);
+
+	get_current_batch().buffer_acquires.push_back({&buffer, offset, size, memory_barrier});
+}
+
+void UploadManager::upload_image(const core::ImageView &image_view, const void *data, VkDeviceSize size, const std::vector<VkBufferImageCopy> &regions,
+                                 VkImageLayout new_layout, VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask)
+{
+	auto staging = stage(data, size);
+
+	auto &command_buffer = get_command_buffer();
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		command_buffer.image_memory_barrier(image_view, memory_barrier);
+	}
+
+	std::vector<VkBufferImageCopy> staging_regions = regions;
+	for (auto &staging_region : staging_regions)
+	{
+		staging_region.bufferOffset += staging.second;
+	}
+
+	command_buffer.copy_buffer_to_image(*staging.first, image_view.get_image(), staging_regions);
+
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	memory_barrier.new_layout       = new_layout;
+	memory_barrier.src_access_mask  = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memory_barrier.dst_access_mask  = dst_access_mask;
+	memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	memory_barrier.dst_stage_mask   = dst_stage_mask;
+	memory_barrier.old_queue_family = queue.get_family_index();
+	memory_barrier.new_queue_family = graphics_queue_family;
+
+	command_buffer.release_ownership(image_view, memory_barrier);
+
+	get_current_batch().image_acquires.push_back({&image_view, memory_barrier});
+}
+
+UploadManager::Token UploadManager::flush()
+{
+	if (!current_batch || current_batch->command_buffer == nullptr)
+	{
+		return next_token - 1;
+	}
+
+	current_batch->command_buffer->end();
+
+	VK_CHECK(queue.submit(*current_batch->command_buffer, current_batch->fence_pool->request_fence()));
+
+	Token token = current_batch->token;
+	submitted_batches.push_back(std::move(current_batch));
+	next_token++;
+
+	return token;
+}
+
+bool UploadManager::is_complete(Token token)
+{
+	retire_batches();
+
+	return token <= completed_token;
+}
+
+void UploadManager::wait(Token token)
+{
+	if (current_batch && token >= current_batch->token)
+	{
+		flush();
+	}
+
+	retire_batches(token);
+}
+
+void UploadManager::acquire(CommandBuffer &command_buffer)
+{
+	retire_batches();
+
+	if (buffer_acquires.empty() && image_acquires.empty())
+	{
+		return;
+	}
+
+	command_buffer.begin_barrier_batch();
+
+	for (auto &buffer_acquire : buffer_acquires)
+	{
+		command_buffer.acquire_ownership(*buffer_acquire.buffer, buffer_acquire.offset, buffer_acquire.size, buffer_acquire.memory_barrier);
+	}
+
+	for (auto &image_acquire : image_acquires)
+	{
+		command_buffer.acquire_ownership(*image_acquire.image_view, image_acquire.memory_barrier);
+	}
+
+	command_buffer.flush_barriers();
+
+	buffer_acquires.clear();
+	image_acquires.clear();
+}
+
+void UploadManager::finish()
+{
+	wait(flush());
+
+	if (buffer_acquires.empty() && image_acquires.empty())
+	{
+		return;
+	}
+
+	CommandPool graphics_command_pool{device, graphics_queue_family};
+	FencePool   graphics_fence_pool{device};
+
+	auto &command_buffer = graphics_command_pool.request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+	acquire(command_buffer);
+
+	command_buffer.end();
+
+	VK_CHECK(device.get_suitable_graphics_queue().submit(command_buffer, graphics_fence_pool.request_fence()));
+
+	graphics_fence_pool.wait();
+}
+
+const Queue &UploadManager::get_queue() const
+{
+	return queue;
+}
+
+std::pair<const core::Buffer *, VkDeviceSize> UploadManager::stage(const void *data, VkDeviceSize size)
+{
+	if (size > staging_ring.get_size())
+	{
+		auto &batch = get_current_batch();
+		batch.staging_buffers.push_back(std::make_unique<core::Buffer>(core::Buffer::create_staging_buffer(device, size, data)));
+		return {batch.staging_buffers.back().get(), 0};
+	}
+
+	VkDeviceSize offset = allocate_staging_ring(size);
+
+	staging_ring.update(data, static_cast<size_t>(size), static_cast<size_t>(offset));
+
+	return {&staging_ring, offset};
+}
+
+VkDeviceSize UploadManager::allocate_staging_ring(VkDeviceSize size)
+{
+	VkDeviceSize ring_size = staging_ring.get_size();
+
+	while (true)
+	{
+		if (staging_ring_used == 0)
+		{
+			staging_ring_head = 0;
+		}
+
+		VkDeviceSize offset  = (staging_ring_head + staging_alignment - 1) / staging_alignment * staging_alignment;
+		VkDeviceSize padding = offset - staging_ring_head;
+
+		// The end of the ring is skipped if the region does not fit there
+		if (offset + size > ring_size)
+		{
+			offset  = 0;
+			padding = ring_size - staging_ring_head;
+		}
+
+		if (staging_ring_used + padding + size <= ring_size)
+		{
+			staging_ring_head = offset + size;
+			staging_ring_used += padding + size;
+			get_current_batch().staging_ring_size += padding + size;
+			return offset;
+		}
+
+		// The oldest batch frees the start of the used region, submit the current one if it is the only one using the ring
+		if (submitted_batches.empty())
+		{
+			flush();
+		}
+
+		assert(!submitted_batches.empty() && "The staging ring is used by no batch");
+		retire_batches(submitted_batches.front()->token);
+	}
+}
+
+UploadManager::Batch &UploadManager::get_current_batch()
+{
+	if (!current_batch)
+	{
+		if (free_batches.empty())
+		{
+			current_batch               = std::make_unique<Batch>();
+			current_batch->command_pool = std::make_unique<CommandPool>(device, queue.get_family_index());
+			current_batch->fence_pool   = std::make_unique<FencePool>(device);
+		}
+		else
+		{
+			current_batch = std::move(free_batches.back());
+			free_batches.pop_back();
+		}
+
+		current_batch->token = next_token;
+	}
+
+	return *current_batch;
+}
+
+CommandBuffer &UploadManager::get_command_buffer()
+{
+	auto &batch = get_current_batch();
+
+	if (batch.command_buffer == nullptr)
+	{
+		batch.command_buffer = &batch.command_pool->request_command_buffer();
+		batch.command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+	}
+
+	return *batch.command_buffer;
+}
+
+void UploadManager::retire_batches(Token wait_token)
+{
+	while (!submitted_batches.empty())
+	{
+		auto &batch = *submitted_batches.front();
+
+		if (batch.token <= wait_token)
+		{
+			batch.fence_pool->wait();
+		}
+		else if (batch.fence_pool->wait(0) != VK_SUCCESS)
+		{
+			break;
+		}
+
+		staging_ring_used -= batch.staging_ring_size;
+		completed_token = batch.token;
+
+		buffer_acquires.insert(buffer_acquires.end(), batch.buffer_acquires.begin(), batch.buffer_acquires.end());
+		image_acquires.insert(image_acquires.end(), batch.image_acquires.begin(), batch.image_acquires.end());
+
+		batch.fence_pool->reset();
+		batch.command_pool->reset_pool();
+		batch.command_buffer    = nullptr;
+		batch.staging_ring_size = 0;
+		batch.staging_buffers.clear();
+		batch.buffer_acquires.clear();
+		batch.image_acquires.clear();
+
+		free_batches.push_back(std::move(submitted_batches.front()));
+		submitted_batches.pop_front();
+	}
+}
+}        // namespace vkb
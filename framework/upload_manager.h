@@ -0,0 +1,224 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/command_pool.h"
+#include "core/image_view.h"
+#include "fence_pool.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+class Queue;
+
+/**
+ * @brief Uploads data to buffers and images from a staging ring, on a queue of the transfer queue family
+ *
+ * Uploads are recorded into the current batch, and flush() submits it as one submission, returning a token which
+ * tells when its copies completed. The staging ring is reused once the batches using it completed, uploads larger
+ * than the ring get a staging buffer of their own.
+ *
+ * If the transfer queue family is not the graphics one, the ownership of the uploaded resources is released to the
+ * graphics queue family. Either way the resources of completed batches must be acquired with acquire(), on a command
+ * buffer of the graphics queue, before they are used. The resources must stay alive until then.
+ *
+ * The manager is not thread safe.
+ */
+class UploadManager
+{
+  public:
+	/// Identifies the uploads of a batch, tokens of later batches are greater
+	using Token = uint64_t;
+
+	static constexpr VkDeviceSize DEFAULT_STAGING_RING_SIZE = 32 * 1024 * 1024;
+
+	UploadManager(Device &device, VkDeviceSize staging_ring_size = DEFAULT_STAGING_RING_SIZE);
+
+	UploadManager(const UploadManager &) = delete;
+
+	UploadManager(UploadManager &&) = delete;
+
+	/**
+	 * @brief Waits for the submitted batches, the uploads which were not flushed are dropped
+	 */
+	~UploadManager();
+
+	UploadManager &operator=(const UploadManager &) = delete;
+
+	UploadManager &operator=(UploadManager &&) = delete;
+
+	/**
+	 * @brief Stages data and adds its copy to a buffer region to the current batch
+	 *        The region must not be in use by the GPU. Mapped buffers, such as the static buffers of unified memory,
+	 *        are written in place instead, see allocated::apply_upload_policy().
+	 * @param buffer The buffer to upload to, it must have the transfer destination usage
+	 * @param data The data to upload
+	 * @param size The size of the data in bytes
+	 * @param offset The offset of the region in the buffer
+	 * @param dst_stage_mask The stages of the first use of the buffer on the graphics queue
+	 * @param dst_access_mask The accesses of the first use of the buffer on the graphics queue
+	 */
+	void upload_buffer(core::Buffer &buffer, const void *data, VkDeviceSize size, VkDeviceSize offset,
+	                   VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask);
+
+	/**
+	 * @brief Stages data and adds its copy to the subresources of an image view to the current batch
+	 *        The previous contents of the subresources are discarded.
+	 * @param image_view The subresources to upload to, their image must have the transfer destination usage
+	 * @param data The data to upload
+	 * @param size The size of the data in bytes
+	 * @param regions The copies of the data to the subresources, with buffer offsets relative to data
+	 * @param new_layout The layout the subresources are left in
+	 * @param dst_stage_mask The stages of the first use of the image on the graphics queue
+	 * @param dst_access_mask The accesses of the first use of the image on the graphics queue
+	 */
+	void upload_image(const core::ImageView &image_view, const void *data, VkDeviceSize size, const std::vector<VkBufferImageCopy> &regions,
+	                  VkImageLayout new_layout, VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask);
+
+	/**
+	 * @brief Submits the current batch to the transfer queue
+	 * @return The token of the batch, or of the last submitted batch if the current one is empty
+	 */
+	Token flush();
+
+	/**
+	 * @return Whether the copies of a batch completed, without blocking
+	 */
+	bool is_complete(Token token);
+
+	/**
+	 * @brief Waits for the copies of a batch to complete, flushing the current batch if the token is its own
+	 */
+	void wait(Token token);
+
+	/**
+	 * @brief Records the acquire barriers of the resources of the completed batches, after which the graphics queue can use them
+	 * @param command_buffer A command buffer of the graphics queue, outside of a render pass
+	 */
+	void acquire(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Flushes and waits for every upload, then acquires the resources with a submission to the graphics queue
+	 */
+	void finish();
+
+	const Queue &get_queue() const;
+
+  private:
+	struct BufferAcquire
+	{
+		const core::Buffer *buffer;
+
+		VkDeviceSize offset;
+
+		VkDeviceSize size;
+
+		BufferMemoryBarrier memory_barrier;
+	};
+
+	struct ImageAcquire
+	{
+		const core::ImageView *image_view;
+
+		ImageMemoryBarrier memory_barrier;
+	};
+
+	struct Batch
+	{
+		Token token{0};
+
+		std::unique_ptr<CommandPool> command_pool;
+
+		std::unique_ptr<FencePool> fence_pool;
+
+		CommandBuffer *command_buffer{nullptr};
+
+		/// Bytes of the staging ring used by the batch, including alignment padding
+		VkDeviceSize staging_ring_size{0};
+
+		/// Staging buffers of the uploads larger than the ring
+		std::vector<core::BufferPtr> staging_buffers;
+
+		std::vector<BufferAcquire> buffer_acquires;
+
+		std::vector<ImageAcquire> image_acquires;
+	};
+
+	/**
+	 * @brief Stages data in the ring, or in a staging buffer of its own if it does not fit
+	 * @return The buffer holding the data, and the offset of the data in it
+	 */
+	std::pair<const core::Buffer *, VkDeviceSize> stage(const void *data, VkDeviceSize size);
+
+	/**
+	 * @return The offset of a region of the staging ring, waiting for earlier batches to complete if it is full
+	 */
+	VkDeviceSize allocate_staging_ring(VkDeviceSize size);
+
+	/**
+	 * @return The current batch, taken from the free batches if there is none
+	 */
+	Batch &get_current_batch();
+
+	/**
+	 * @return The command buffer of the current batch, begun on the first upload
+	 */
+	CommandBuffer &get_command_buffer();
+
+	/**
+	 * @brief Recycles the submitted batches which completed, oldest first, keeping their acquires
+	 * @param wait_token Waits for the batches up to this token to complete
+	 */
+	void retire_batches(Token wait_token = 0);
+
+	Device &device;
+
+	const Queue &queue;
+
+	uint32_t graphics_queue_family;
+
+	core::Buffer staging_ring;
+
+	VkDeviceSize staging_ring_head{0};
+
+	VkDeviceSize staging_ring_used{0};
+
+	VkDeviceSize staging_alignment{16};
+
+	std::unique_ptr<Batch> current_batch;
+
+	std::deque<std::unique_ptr<Batch>> submitted_batches;
+
+	std::vector<std::unique_ptr<Batch>> free_batches;
+
+	Token next_token{1};
+
+	Token completed_token{0};
+
+	std::vector<BufferAcquire> buffer_acquires;
+
+	std::vector<ImageAcquire> image_acquires;
+};
+}        // namespace vkb
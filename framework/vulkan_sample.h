@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  * Copyright (c) 2021-2024, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -19,12 +19,25 @@
 #pragma once
 
 #include "common/hpp_utils.h"
+#include "device_handover.h"
 #include "hpp_gltf_loader.h"
 #include "hpp_gui.h"
+#include "persistent_pipeline_cache.h"
 #include "platform/application.h"
 #include "rendering/hpp_render_pipeline.h"
+#include "rendering/mip_streamer.h"
+#include "rendering/postprocessing_pipeline.h"
+#include "rendering/postprocessing_renderpass.h"
+#include "rendering/temporal_anti_aliasing.h"
 #include "scene_graph/components/camera.h"
+#include "scene_graph/scene_snapshot.h"
 #include "scene_graph/scripts/animation.h"
+#include "shader_cache.h"
+
+#include <core/util/job_system.hpp>
+
+#include <array>
+#include <chrono>
 
 #if defined(PLATFORM__MACOS)
 #include <TargetConditionals.h>
@@ -82,6 +95,11 @@ namespace vkb
  * - setting up a barrier for the Swapchain transition to present
  * - submitting the CommandBuffer and end the Frame (present)
  *
+ * @subsection frame_pipelining Frame pipelining
+ * With set_frame_pipelining_enable(), the scripts and animations of the next frame run on a JobSystem worker while
+ * the current frame is recorded. The frame is recorded from the sg::SceneSnapshot captured at the end of the
+ * previous scene update, which its RenderFrame points to, so that subpasses never read a node being updated.
+ *
  * @subsection draw_swapchain Draw swapchain renderpass
  * The function starts and ends a RenderPass which includes setting up viewport, scissors,
  * blend state (etc.) and calling draw_scene.
@@ -151,7 +169,15 @@ class VulkanSample : public vkb::Application
 	Configuration           &get_configuration();
 	RenderContextType       &get_render_context();
 	RenderContextType const &get_render_context() const;
+	sg::Scene               &get_scene();
+	StatsType               &get_stats();
 	bool                     has_render_context() const;
+	bool                     has_scene();
+
+	/**
+	 * @return The streamer of the scene textures, or nullptr if they are not streamed, see set_mip_streaming_budget()
+	 */
+	vkb::MipStreamer *get_mip_streamer();
 
 	/// <summary>
 	/// PROTECTED VIRTUAL INTERFACE
@@ -181,6 +207,8 @@ class VulkanSample : public vkb::Application
 
 	/**
 	 * @brief Prepares the render target and draws to it, calling draw_renderpass
+	 *        If the resolution is adapted, the scene is instead rendered to the scaled render target of the frame with render(),
+	 *        then upscaled to the render target, on which the GUI is drawn.
 	 * @param command_buffer The command buffer to record the commands to
 	 * @param render_target The render target that is being drawn to
 	 */
@@ -198,6 +226,13 @@ class VulkanSample : public vkb::Application
 	 */
 	virtual void draw_renderpass(CommandBufferType &command_buffer, RenderTargetType &render_target);
 
+	/**
+	 * @brief Returns the render target the scene is drawn to
+	 *        It is the scaled render target of the active frame if the resolution is adapted, see RenderContext::set_resolution_target(),
+	 *        else the render target of the frame.
+	 */
+	RenderTargetType &get_scene_render_target();
+
 	/**
 	 * @brief Get additional sample-specific instance layers.
 	 *
@@ -265,8 +300,6 @@ class VulkanSample : public vkb::Application
 	InstanceType const                   &get_instance() const;
 	RenderPipelineType                   &get_render_pipeline();
 	RenderPipelineType const             &get_render_pipeline() const;
-	sg::Scene                            &get_scene();
-	StatsType                            &get_stats();
 	SurfaceType                           get_surface() const;
 	std::vector<SurfaceFormatType>       &get_surface_priority_list();
 	std::vector<SurfaceFormatType> const &get_surface_priority_list() const;
@@ -274,7 +307,6 @@ class VulkanSample : public vkb::Application
 	bool                                  has_instance() const;
 	bool                                  has_gui() const;
 	bool                                  has_render_pipeline() const;
-	bool                                  has_scene();
 
 	/**
 	 * @brief Loads the scene
@@ -283,6 +315,14 @@ class VulkanSample : public vkb::Application
 	 */
 	void load_scene(const std::string &path);
 
+	/**
+	 * @brief Loads the scene without waiting for its images, which stream in during the following updates
+	 *        Textures sample a placeholder until their image is resident, see GLTFLoader::read_scene_from_file_async.
+	 *
+	 * @param path The path of the glTF file
+	 */
+	void load_scene_async(const std::string &path);
+
 	/**
 	 * @brief Additional sample initialization
 	 */
@@ -302,6 +342,78 @@ class VulkanSample : public vkb::Application
 	 */
 	void set_high_priority_graphics_queue_enable(bool enable);
 
+	/**
+	 * @brief Sets whether the render pipeline subpasses are recorded in parallel on the job system, see RenderPipeline::set_job_system.
+	 * Needs to be called before prepare(), and only applies to samples using the default prepare_render_context() and render().
+	 * @param enable If true, subpasses supporting it are recorded on the JobSystem::get() workers.
+	 * Default state is false, where everything is recorded inline on the main thread.
+	 */
+	void set_parallel_recording_enable(bool enable);
+
+	/**
+	 * @brief Sets whether the scene of the next frame is updated while the current frame is recorded, see update().
+	 * Only applies to samples with the C bindings which use the default update(). Their subpasses read the scene
+	 * through Subpass::get_scene_snapshot(), as the live scene is updated on a JobSystem::get() worker meanwhile.
+	 * @param enable If true, frames are recorded from a snapshot of the scene taken at the end of the previous update,
+	 * which adds one frame of latency. Default state is false, where the scene is updated then the frame recorded.
+	 */
+	void set_frame_pipelining_enable(bool enable);
+
+	/**
+	 * @brief Sets whether the scene is resolved with temporal anti-aliasing when the resolution is adapted, see TemporalAntiAliasing.
+	 * The scene is then rendered with a jittered projection, see RenderContext::set_projection_jitter(), and accumulated at the
+	 * resolution of the frame before the GUI is drawn, instead of being upscaled by filtering. The sample must render the scene
+	 * to scaled render targets from RenderTarget::create_motion_vectors_func(), with RenderPipeline::set_motion_vectors() and
+	 * GeometrySubpass::set_motion_vectors().
+	 * @param enable If true, the scene is resolved with temporal anti-aliasing. Default state is false.
+	 */
+	void set_temporal_anti_aliasing_enable(bool enable);
+
+	/**
+	 * @brief Sets whether the pipeline cache of the device is loaded on prepare() and saved on finish(), see PersistentPipelineCache.
+	 * Needs to be called before prepare().
+	 * @param enable If true, pipelines are created with a cache which persists across runs of the sample.
+	 * Default state is true.
+	 */
+	void set_pipeline_cache_persistence_enable(bool enable);
+
+	/**
+	 * @brief Sets whether the sample takes over the instance, device and pipeline cache of the previous one, and hands them
+	 * over to the next one, when DeviceHandover::get() is enabled. Only applies to samples with the C bindings.
+	 * Needs to be called before prepare(), samples overriding create_instance() or create_device() disable it.
+	 * @param enable If true, the Vulkan objects are shared with the samples run before and after which require the same ones.
+	 * Default state is true.
+	 */
+	void set_device_sharing_enable(bool enable);
+
+	/**
+	 * @brief Sets the device memory budget the scene textures are streamed within, see MipStreamer. Only applies to samples
+	 * with the C bindings. Needs to be called before load_scene(), which then creates the images with their smallest levels,
+	 * and the finer levels stream in as the camera set with set_mip_streaming_camera() gets closer to the meshes.
+	 * @param memory_budget The device memory of the streamed textures. Default is 0, where the textures are uploaded whole.
+	 */
+	void set_mip_streaming_budget(VkDeviceSize memory_budget);
+
+	/**
+	 * @brief Sets the camera the levels of the streamed textures are estimated for, see set_mip_streaming_budget()
+	 * @param camera The camera the scene is rendered with, nullptr to stop streaming
+	 */
+	void set_mip_streaming_camera(sg::Camera *camera);
+
+	/**
+	 * @brief Sets whether load_scene() builds the meshlets of the submeshes, for a MeshletSubpass to draw them with mesh shaders,
+	 * see GLTFLoader::set_meshlet_geometry(). Needs to be called before load_scene().
+	 * @param enable If true, the vertex and index buffers of the scene are also created as storage buffers. Default state is false.
+	 */
+	void set_meshlet_geometry_enable(bool enable);
+
+	/**
+	 * @brief Sets whether load_scene() creates the geometry of the scene as acceleration structure build inputs, for a RayTracingScene,
+	 * see GLTFLoader::set_ray_tracing_geometry(). Needs to be called before load_scene().
+	 * @param enable If true, the vertex and index buffers of the scene have device addresses. Default state is false.
+	 */
+	void set_ray_tracing_geometry_enable(bool enable);
+
 	void set_render_context(std::unique_ptr<RenderContextType> &&render_context);
 
 	void set_render_pipeline(std::unique_ptr<RenderPipelineType> &&render_pipeline);
@@ -323,6 +435,12 @@ class VulkanSample : public vkb::Application
 	 */
 	void update_scene(float delta_time);
 
+	/**
+	 * @brief Delivers the pending input events of the window, called by update() once the frame can be recorded,
+	 *        so that the camera update and the commands which read it use input as recent as possible
+	 */
+	void sample_input();
+
 	/**
 	 * @brief Update counter values
 	 * @param delta_time
@@ -338,10 +456,27 @@ class VulkanSample : public vkb::Application
 	/// PRIVATE INTERFACE
 	/// </summary>
   private:
+	/** @brief The state of the scene a frame is recorded from with frame pipelining, and the input it was updated with. */
+	struct FrameSnapshot
+	{
+		sg::SceneSnapshot scene;
+
+		std::chrono::steady_clock::time_point input_time;
+
+		std::chrono::steady_clock::time_point event_time;
+
+		bool captured{false};
+	};
+
+	void        capture_frame_snapshot(FrameSnapshot &frame_snapshot);
 	void        create_render_context_impl(const std::vector<vk::SurfaceFormatKHR> &surface_priority_list);
 	void        draw_impl(vkb::core::HPPCommandBuffer &command_buffer, vkb::rendering::HPPRenderTarget &render_target);
 	void        draw_renderpass_impl(vkb::core::HPPCommandBuffer &command_buffer, vkb::rendering::HPPRenderTarget &render_target);
+	void        draw_scaled(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &scaled_render_target, vkb::RenderTarget &render_target);
+	void        record_frame(vkb::core::HPPCommandBuffer &command_buffer);
 	void        render_impl(vkb::core::HPPCommandBuffer &command_buffer);
+	void        update_pipelined(float delta_time);
+	void        update_scene_nodes(float delta_time);
 	static void set_viewport_and_scissor_impl(vkb::core::HPPCommandBuffer const &command_buffer, vk::Extent2D const &extent);
 
 	/**
@@ -387,8 +522,33 @@ class VulkanSample : public vkb::Application
 	 */
 	std::unique_ptr<sg::Scene> scene;
 
+	/**
+	 * @brief The loader streaming the scene images in, if any
+	 */
+	std::unique_ptr<vkb::HPPGLTFLoader> scene_loader;
+
+	/**
+	 * @brief Uploads the levels of the streamed textures, see set_mip_streaming_budget()
+	 */
+	std::unique_ptr<vkb::UploadManager> mip_upload_manager;
+
+	/**
+	 * @brief Streams the levels of the scene textures, if set_mip_streaming_budget() set a budget
+	 */
+	std::unique_ptr<vkb::MipStreamer> mip_streamer;
+
 	std::unique_ptr<vkb::HPPGui> gui;
 
+	/**
+	 * @brief Upscales the scene to the render target of the frame when the resolution is adapted
+	 */
+	std::unique_ptr<vkb::PostProcessingPipeline> upscale_pipeline;
+
+	/**
+	 * @brief Resolves the scene with its history before the upscale, see set_temporal_anti_aliasing_enable()
+	 */
+	std::unique_ptr<vkb::TemporalAntiAliasing> temporal_resolve;
+
 	std::unique_ptr<vkb::stats::HPPStats> stats;
 
 	static constexpr float STATS_VIEW_RESET_TIME{10.0f};        // 10 seconds
@@ -422,7 +582,51 @@ class VulkanSample : public vkb::Application
 	/** @brief Whether or not we want a high priority graphics queue. */
 	bool high_priority_graphics_queue{false};
 
+	/** @brief Whether or not the render pipeline is recorded in parallel on the job system. */
+	bool parallel_recording{false};
+
+	/** @brief Whether or not the pipeline cache persists across runs of the sample. */
+	bool pipeline_cache_persistence{true};
+
+	/** @brief Whether or not the scene of the next frame is updated while the current frame is recorded. */
+	bool frame_pipelining{false};
+
+	/** @brief Whether or not the scene is resolved with temporal anti-aliasing when the resolution is adapted. */
+	bool temporal_anti_aliasing{false};
+
+	/** @brief Whether or not the instance and device are shared with the previous and next samples. */
+	bool device_sharing{true};
+
+	/** @brief The device memory budget of the streamed scene textures, 0 if they are not streamed. */
+	VkDeviceSize mip_streaming_budget{0};
+
+	/** @brief The camera the levels of the streamed textures are estimated for. */
+	sg::Camera *mip_streaming_camera{nullptr};
+
+	/** @brief Whether or not the scene is loaded with meshlets. */
+	bool meshlet_geometry{false};
+
+	/** @brief Whether or not the scene is loaded with geometry to build acceleration structures from. */
+	bool ray_tracing_geometry{false};
+
+	/** @brief What the instance of the sample was created with, to hand it over. */
+	DeviceHandover::InstanceRequirements instance_requirements;
+
+	/** @brief What the device of the sample was created with, to hand it over. */
+	DeviceHandover::DeviceRequirements device_requirements;
+
+	/** @brief Double buffered, the scene update writes one while the frame is recorded from the other. */
+	std::array<FrameSnapshot, 2> frame_snapshots;
+
+	/** @brief Index of the snapshot the next scene update is captured to. */
+	size_t next_frame_snapshot{0};
+
+	std::unique_ptr<vkb::PersistentPipelineCache> pipeline_cache;
+
 	std::unique_ptr<vkb::core::HPPDebugUtils> debug_utils;
+
+	/** @brief Time the oldest input event not applied by a frame yet was received at, for the event to photon latency. */
+	std::chrono::steady_clock::time_point pending_input_event_time;
 };
 
 template <vkb::BindingType bindingType>
@@ -433,10 +637,33 @@ inline VulkanSample<bindingType>::~VulkanSample()
 		device->get_handle().waitIdle();
 	}
 
+	scene_loader.reset();
+	mip_streamer.reset();
+	mip_upload_manager.reset();
 	scene.reset();
 	stats.reset();
 	gui.reset();
+	upscale_pipeline.reset();
+	temporal_resolve.reset();
 	render_context.reset();
+
+	if constexpr (bindingType == BindingType::C)
+	{
+		auto &handover = DeviceHandover::get();
+		if (handover.is_enabled() && device_sharing && device)
+		{
+			// The next sample takes the device over, without the resources referring to the ones of this sample
+			auto &resource_cache = get_device().get_resource_cache();
+			resource_cache.clear_framebuffers();
+			resource_cache.clear_descriptor_sets();
+			get_device().get_retire_queue().clear();
+
+			handover.hand_over(std::move(instance), surface, instance_requirements, std::move(device), std::move(pipeline_cache), device_requirements);
+			return;
+		}
+	}
+
+	pipeline_cache.reset();
 	device.reset();
 
 	if (surface)
@@ -524,7 +751,24 @@ inline void VulkanSample<bindingType>::draw(CommandBufferType &command_buffer, R
 	}
 	else
 	{
-		draw_impl(reinterpret_cast<vkb::core::HPPCommandBuffer &>(command_buffer), reinterpret_cast<vkb::rendering::HPPRenderTarget &>(render_target));
+		auto &frame                = get_render_context().get_active_frame();
+		auto *scaled_render_target = frame.get_scaled_render_target();
+
+		if (mip_streamer && mip_streaming_camera)
+		{
+			// The levels are copied and swapped in before the render pass samples them
+			const auto &extent = scaled_render_target ? scaled_render_target->get_render_extent() : render_target.get_extent();
+			mip_streamer->update(command_buffer, *mip_streaming_camera, extent.height, frame.get_scene_snapshot());
+		}
+
+		if (scaled_render_target)
+		{
+			draw_scaled(command_buffer, *scaled_render_target, render_target);
+		}
+		else
+		{
+			draw_impl(reinterpret_cast<vkb::core::HPPCommandBuffer &>(command_buffer), reinterpret_cast<vkb::rendering::HPPRenderTarget &>(render_target));
+		}
 	}
 }
 
@@ -535,10 +779,11 @@ inline void VulkanSample<bindingType>::draw_impl(vkb::core::HPPCommandBuffer &co
 
 	{
 		// Image 0 is the swapchain
+		// The attachments may alias the memory of the attachments of the previous frames, wait for their writes
 		vkb::common::HPPImageMemoryBarrier memory_barrier{};
 		memory_barrier.old_layout      = vk::ImageLayout::eUndefined;
 		memory_barrier.new_layout      = vk::ImageLayout::eColorAttachmentOptimal;
-		memory_barrier.src_access_mask = {};
+		memory_barrier.src_access_mask = vk::AccessFlagBits::eColorAttachmentWrite;
 		memory_barrier.dst_access_mask = vk::AccessFlagBits::eColorAttachmentWrite;
 		memory_barrier.src_stage_mask  = vk::PipelineStageFlagBits::eColorAttachmentOutput;
 		memory_barrier.dst_stage_mask  = vk::PipelineStageFlagBits::eColorAttachmentOutput;
@@ -558,9 +803,9 @@ inline void VulkanSample<bindingType>::draw_impl(vkb::core::HPPCommandBuffer &co
 		vkb::common::HPPImageMemoryBarrier memory_barrier{};
 		memory_barrier.old_layout      = vk::ImageLayout::eUndefined;
 		memory_barrier.new_layout      = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-		memory_barrier.src_access_mask = {};
+		memory_barrier.src_access_mask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
 		memory_barrier.dst_access_mask = vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-		memory_barrier.src_stage_mask  = vk::PipelineStageFlagBits::eTopOfPipe;
+		memory_barrier.src_stage_mask  = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
 		memory_barrier.dst_stage_mask  = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
 
 		command_buffer.image_memory_barrier(views[1], memory_barrier);
@@ -577,11 +822,14 @@ inline void VulkanSample<bindingType>::draw_impl(vkb::core::HPPCommandBuffer &co
 	}
 
 	{
+		// The swapchain is in GENERAL layout if a compute pass wrote it last, see vkb::PostProcessingComputePass
+		const bool written_by_compute = render_target.get_layout(0) == vk::ImageLayout::eGeneral;
+
 		vkb::common::HPPImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = vk::ImageLayout::eColorAttachmentOptimal;
+		memory_barrier.old_layout      = render_target.get_layout(0);
 		memory_barrier.new_layout      = vk::ImageLayout::ePresentSrcKHR;
-		memory_barrier.src_access_mask = vk::AccessFlagBits::eColorAttachmentWrite;
-		memory_barrier.src_stage_mask  = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		memory_barrier.src_access_mask = written_by_compute ? vk::AccessFlagBits::eShaderWrite : vk::AccessFlagBits::eColorAttachmentWrite;
+		memory_barrier.src_stage_mask  = written_by_compute ? vk::PipelineStageFlagBits::eComputeShader : vk::PipelineStageFlagBits::eColorAttachmentOutput;
 		memory_barrier.dst_stage_mask  = vk::PipelineStageFlagBits::eBottomOfPipe;
 
 		command_buffer.image_memory_barrier(views[0], memory_barrier);
@@ -589,6 +837,131 @@ inline void VulkanSample<bindingType>::draw_impl(vkb::core::HPPCommandBuffer &co
 	}
 }
 
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::draw_scaled(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &scaled_render_target, vkb::RenderTarget &render_target)
+{
+	auto &scaled_views = scaled_render_target.get_views();
+
+	{
+		// The previous frame sampled the scene image, and the attachments may alias the memory of those of the previous frames
+		command_buffer.begin_barrier_batch();
+
+		for (uint32_t i = 0; i < scaled_views.size(); ++i)
+		{
+			vkb::ImageMemoryBarrier memory_barrier{};
+			memory_barrier.old_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			if (vkb::is_depth_format(scaled_views[i].get_format()))
+			{
+				memory_barrier.new_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+				memory_barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+				memory_barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+				memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+				memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			}
+			else
+			{
+				memory_barrier.new_layout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+				memory_barrier.src_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+				memory_barrier.dst_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+				memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+				memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			}
+
+			command_buffer.image_memory_barrier(scaled_views[i], memory_barrier);
+			scaled_render_target.set_layout(i, memory_barrier.new_layout);
+		}
+
+		command_buffer.flush_barriers();
+	}
+
+	// The scene is rendered in the render extent of the scaled target, any GUI is drawn at the resolution of the frame
+	if (render_pipeline)
+	{
+		render_pipeline->set_last_subpass_secondary(false);
+	}
+
+	if (temporal_anti_aliasing)
+	{
+		if (!temporal_resolve)
+		{
+			temporal_resolve = std::make_unique<vkb::TemporalAntiAliasing>(get_render_context().get_device());
+		}
+
+		get_render_context().set_projection_jitter(temporal_resolve->next_jitter(scaled_render_target.get_render_extent()));
+	}
+	else
+	{
+		get_render_context().set_projection_jitter(glm::vec2(0.0f));
+	}
+
+	set_viewport_and_scissor(command_buffer, scaled_render_target.get_render_extent());
+	render(command_buffer);
+	command_buffer.end_render_pass();
+
+	if (!upscale_pipeline)
+	{
+		upscale_pipeline = std::make_unique<vkb::PostProcessingPipeline>(get_render_context(), vkb::ShaderSource{"postprocessing/postprocessing.vert"});
+		upscale_pipeline->add_pass().add_subpass(vkb::ShaderSource{"postprocessing/upscale.frag"}).set_debug_name("Upscale");
+	}
+
+	struct UpscaleParameters
+	{
+		glm::vec2 uv_scale;
+		glm::vec2 max_uv;
+	};
+
+	const auto &extent        = scaled_render_target.get_extent();
+	const auto &render_extent = scaled_render_target.get_render_extent();
+
+	UpscaleParameters parameters;
+
+	if (temporal_anti_aliasing)
+	{
+		// The resolved image is at the resolution of the frame, so the upscale only copies it
+		const auto &output_extent = render_target.get_extent();
+		const auto &resolved_view = temporal_resolve->resolve(command_buffer, scaled_render_target, output_extent);
+
+		parameters.uv_scale = {1.0f, 1.0f};
+		parameters.max_uv   = {1.0f - 0.5f / output_extent.width, 1.0f - 0.5f / output_extent.height};
+
+		upscale_pipeline->get_pass(0).get_subpass(0).bind_sampled_image("scene_sampler", {resolved_view}).set_push_constants(parameters);
+	}
+	else
+	{
+		parameters.uv_scale = {static_cast<float>(render_extent.width) / extent.width, static_cast<float>(render_extent.height) / extent.height};
+		parameters.max_uv   = {(render_extent.width - 0.5f) / extent.width, (render_extent.height - 0.5f) / extent.height};
+
+		// The scene image is transitioned to be sampled by the pass
+		upscale_pipeline->get_pass(0).get_subpass(0).bind_sampled_image("scene_sampler", {0, &scaled_render_target}).set_push_constants(parameters);
+	}
+
+	// The last pass leaves the render pass open
+	upscale_pipeline->draw(command_buffer, render_target);
+
+	if (gui)
+	{
+		gui->draw(reinterpret_cast<vkb::core::HPPCommandBuffer &>(command_buffer));
+	}
+
+	command_buffer.end_render_pass();
+
+	{
+		// The swapchain is in GENERAL layout if a compute pass wrote it last, see vkb::PostProcessingComputePass
+		const bool written_by_compute = render_target.get_layout(0) == VK_IMAGE_LAYOUT_GENERAL;
+
+		vkb::ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = render_target.get_layout(0);
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		memory_barrier.src_access_mask = written_by_compute ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		memory_barrier.src_stage_mask  = written_by_compute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+		command_buffer.image_memory_barrier(render_target.get_views()[0], memory_barrier);
+		render_target.set_layout(0, memory_barrier.new_layout);
+	}
+}
+
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::draw_gui()
 {
@@ -611,21 +984,44 @@ inline void VulkanSample<bindingType>::draw_renderpass(CommandBufferType &comman
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::draw_renderpass_impl(vkb::core::HPPCommandBuffer &command_buffer, vkb::rendering::HPPRenderTarget &render_target)
 {
+	// A retained GUI is a secondary command buffer, which the last subpass must have the contents for
+	if (render_pipeline)
+	{
+		render_pipeline->set_last_subpass_secondary(gui && vkb::HPPGui::retained);
+	}
+
 	if constexpr (bindingType == BindingType::Cpp)
 	{
-		set_viewport_and_scissor(command_buffer, render_target.get_extent());
+		set_viewport_and_scissor(command_buffer, render_target.get_render_extent());
 		render(command_buffer);
 	}
 	else
 	{
 		set_viewport_and_scissor(reinterpret_cast<vkb::CommandBuffer const &>(command_buffer),
-		                         reinterpret_cast<VkExtent2D const &>(render_target.get_extent()));
+		                         reinterpret_cast<VkExtent2D const &>(render_target.get_render_extent()));
 		render(reinterpret_cast<vkb::CommandBuffer &>(command_buffer));
 	}
 
 	if (gui)
 	{
-		gui->draw(command_buffer);
+		if (render_pipeline && render_pipeline->get_last_subpass_contents() == vk::SubpassContents::eSecondaryCommandBuffers)
+		{
+			// The last subpass was recorded in secondary command buffers, so the GUI has to be recorded in one as well, unless it is retained in one
+			if (!vkb::HPPGui::retained || !gui->draw_retained(command_buffer))
+			{
+				auto &gui_command_buffer = command_buffer.get_command_pool().request_command_buffer(vk::CommandBufferLevel::eSecondary);
+
+				gui_command_buffer.continue_render_pass(command_buffer);
+				gui->draw(gui_command_buffer);
+				gui_command_buffer.end();
+
+				command_buffer.execute_commands(gui_command_buffer);
+			}
+		}
+		else
+		{
+			gui->draw(command_buffer);
+		}
 	}
 
 	command_buffer.get_handle().endRenderPass();
@@ -636,10 +1032,29 @@ inline void VulkanSample<bindingType>::finish()
 {
 	Parent::finish();
 
+	auto &shader_cache = ShaderCache::get();
+	if (shader_cache.is_enabled())
+	{
+		LOGI("Shader cache: {} hits, {} misses", shader_cache.get_hit_count(), shader_cache.get_miss_count());
+	}
+
 	if (device)
 	{
 		device->get_handle().waitIdle();
 	}
+
+	if (pipeline_cache)
+	{
+		if constexpr (bindingType == BindingType::C)
+		{
+			// Pipelines still compiling in the background would be missing from the saved cache
+			auto &resource_cache = get_device().get_resource_cache();
+			resource_cache.wait_pipeline_compilations();
+			resource_cache.wait_optimized_pipelines();
+		}
+
+		pipeline_cache->save();
+	}
 }
 
 template <vkb::BindingType bindingType>
@@ -820,6 +1235,12 @@ inline typename VulkanSample<bindingType>::RenderPipelineType &VulkanSample<bind
 	}
 }
 
+template <vkb::BindingType bindingType>
+inline vkb::MipStreamer *VulkanSample<bindingType>::get_mip_streamer()
+{
+	return mip_streamer.get();
+}
+
 template <vkb::BindingType bindingType>
 inline sg::Scene &VulkanSample<bindingType>::get_scene()
 {
@@ -900,6 +1321,11 @@ inline void VulkanSample<bindingType>::input_event(const InputEvent &input_event
 {
 	Parent::input_event(input_event);
 
+	if (pending_input_event_time == std::chrono::steady_clock::time_point{})
+	{
+		pending_input_event_time = input_event.get_timestamp();
+	}
+
 	bool gui_captures_event = false;
 
 	if (gui)
@@ -911,7 +1337,7 @@ inline void VulkanSample<bindingType>::input_event(const InputEvent &input_event
 	{
 		if (scene && scene->has_component<sg::Script>())
 		{
-			auto scripts = scene->get_components<sg::Script>();
+			auto scripts = scene->get_component_view<sg::Script>();
 
 			for (auto script : scripts)
 			{
@@ -934,8 +1360,18 @@ inline void VulkanSample<bindingType>::input_event(const InputEvent &input_event
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::load_scene(const std::string &path)
 {
+	// A scene still streaming in is replaced
+	scene_loader.reset();
+	mip_streamer.reset();
+
 	vkb::HPPGLTFLoader loader(*device);
 
+	// The streamer creates the images from the texels kept on the CPU
+	const bool streamed_textures = bindingType == BindingType::C && mip_streaming_budget != 0;
+	loader.set_streamed_textures(streamed_textures);
+	loader.set_meshlet_geometry(meshlet_geometry);
+	loader.set_ray_tracing_geometry(ray_tracing_geometry);
+
 	scene = loader.read_scene_from_file(path);
 
 	if (!scene)
@@ -943,6 +1379,38 @@ inline void VulkanSample<bindingType>::load_scene(const std::string &path)
 		LOGE("Cannot load scene: {}", path.c_str());
 		throw std::runtime_error("Cannot load scene: " + path);
 	}
+
+	if constexpr (bindingType == BindingType::C)
+	{
+		if (streamed_textures)
+		{
+			if (!mip_upload_manager)
+			{
+				mip_upload_manager = std::make_unique<vkb::UploadManager>(get_device());
+			}
+
+			mip_streamer = std::make_unique<vkb::MipStreamer>(get_device(), *mip_upload_manager, mip_streaming_budget, to_u32(get_render_context().get_render_frames().size()));
+			mip_streamer->add(*scene);
+		}
+	}
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::load_scene_async(const std::string &path)
+{
+	// The textures are not streamed by levels while the whole images stream in
+	mip_streamer.reset();
+
+	scene_loader = std::make_unique<vkb::HPPGLTFLoader>(*device);
+
+	scene = scene_loader->read_scene_from_file_async(path);
+
+	if (!scene)
+	{
+		scene_loader.reset();
+		LOGE("Cannot load scene: {}", path.c_str());
+		throw std::runtime_error("Cannot load scene: " + path);
+	}
 }
 
 template <vkb::BindingType bindingType>
@@ -995,28 +1463,82 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 	}
 #endif
 
-	if constexpr (bindingType == BindingType::Cpp)
+	if (vkb::core::HPPInstance::use_device_group)
+	{
+		add_instance_extension(VK_KHR_DEVICE_GROUP_CREATION_EXTENSION_NAME, /*optional=*/true);
+	}
+
+	instance_requirements = {api_version, headless};
+	for (auto &extension : get_instance_extensions())
+	{
+		instance_requirements.extensions[extension.first] = extension.second;
+	}
+	for (auto *layer : get_validation_layers())
 	{
-		instance = create_instance(headless);
+		instance_requirements.layers.push_back(layer);
+	}
+
+	auto &handover            = DeviceHandover::get();
+	bool  instance_taken_over = false;
+	if (bindingType == BindingType::C && device_sharing)
+	{
+		instance_taken_over = handover.take_instance(instance_requirements, instance, surface);
 	}
 	else
 	{
-		instance.reset(reinterpret_cast<vkb::core::HPPInstance *>(create_instance(headless).release()));
+		// A window only has one surface, so the objects of the previous sample are released first
+		handover.release();
+	}
+
+	if (!instance_taken_over)
+	{
+		if constexpr (bindingType == BindingType::Cpp)
+		{
+			instance = create_instance(headless);
+		}
+		else
+		{
+			instance.reset(reinterpret_cast<vkb::core::HPPInstance *>(create_instance(headless).release()));
+		}
 	}
 
 	// initialize C++-Bindings default dispatcher, second step
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(instance->get_handle());
 
-	// Getting a valid vulkan surface from the platform
-	surface = static_cast<vk::SurfaceKHR>(window->create_surface(reinterpret_cast<vkb::Instance &>(*instance)));
-	if (!surface)
+	if (!instance_taken_over)
 	{
-		throw std::runtime_error("Failed to create window surface.");
+		// Getting a valid vulkan surface from the platform
+		surface = static_cast<vk::SurfaceKHR>(window->create_surface(reinterpret_cast<vkb::Instance &>(*instance)));
+		if (!surface)
+		{
+			throw std::runtime_error("Failed to create window surface.");
+		}
 	}
 
 	auto &gpu = instance->get_suitable_gpu(surface);
 	gpu.set_high_priority_graphics_queue_enable(high_priority_graphics_queue);
 
+	if (instance_taken_over)
+	{
+		// The features requested by the previous sample are requested again by this one
+		reinterpret_cast<vkb::PhysicalDevice &>(gpu).reset_requested_features();
+	}
+
+	// Only headless frames alternate between the GPUs of the group, with a swapchain every GPU renders every frame
+	if (vkb::core::HPPInstance::use_device_group)
+	{
+		auto device_group = instance->get_device_group(gpu.get_handle());
+		if (device_group.size() > 1)
+		{
+			gpu.set_device_group(device_group);
+			add_device_extension(VK_KHR_DEVICE_GROUP_EXTENSION_NAME, /*optional=*/true);
+		}
+		else
+		{
+			LOGW("A device group was requested, but {} is not part of a group of several GPUs", gpu.get_properties().deviceName.data());
+		}
+	}
+
 	// Request to enable ASTC
 	if (gpu.get_features().textureCompressionASTC_LDR)
 	{
@@ -1045,7 +1567,20 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 	}
 
 #ifdef VKB_VULKAN_DEBUG
-	if (!debug_utils)
+	// Labels and object names cost CPU time in every command buffer, even when nothing reads them, so they are only
+	// recorded for debugging tools, and for the validation layers which name the objects in their messages
+#	ifdef VKB_VALIDATION_LAYERS
+	bool debug_tool_active = true;
+#	else
+	bool debug_tool_active = vkb::is_debug_tool_active(static_cast<VkPhysicalDevice>(gpu.get_handle()));
+#	endif
+
+	if (!debug_tool_active)
+	{
+		LOGI("Vulkan debug utils disabled, no debugging tool is active");
+		debug_utils.reset();
+	}
+	else if (!debug_utils)
 	{
 		std::vector<vk::ExtensionProperties> available_device_extensions = gpu.get_handle().enumerateDeviceExtensionProperties();
 		auto                                 debugExtensionIt =
@@ -1061,7 +1596,7 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 		}
 	}
 
-	if (!debug_utils)
+	if (debug_tool_active && !debug_utils)
 	{
 		LOGW("Vulkan debug utils were requested, but no extension that provides them was found");
 	}
@@ -1072,18 +1607,64 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 		debug_utils = std::make_unique<vkb::core::HPPDummyDebugUtils>();
 	}
 
-	if constexpr (bindingType == BindingType::Cpp)
+	bool device_taken_over = false;
+	if constexpr (bindingType == BindingType::C)
 	{
-		device = create_device(gpu);
+		auto &c_gpu = reinterpret_cast<vkb::PhysicalDevice &>(gpu);
+
+		device_requirements = {};
+		for (auto &extension : get_device_extensions())
+		{
+			device_requirements.extensions[extension.first] = extension.second;
+		}
+		device_requirements.features                     = c_gpu.get_requested_feature_bytes();
+		device_requirements.high_priority_graphics_queue = high_priority_graphics_queue;
+		device_requirements.device_group                 = c_gpu.get_device_group();
+
+		if (instance_taken_over)
+		{
+			device_taken_over = handover.take_device(device_requirements, device, pipeline_cache);
+		}
 	}
-	else
+
+	if (!device_taken_over)
 	{
-		device.reset(reinterpret_cast<vkb::core::HPPDevice *>(create_device(reinterpret_cast<vkb::PhysicalDevice &>(gpu)).release()));
+		if constexpr (bindingType == BindingType::Cpp)
+		{
+			device = create_device(gpu);
+		}
+		else
+		{
+			device.reset(reinterpret_cast<vkb::core::HPPDevice *>(create_device(reinterpret_cast<vkb::PhysicalDevice &>(gpu)).release()));
+		}
 	}
 
 	// initialize C++-Bindings default dispatcher, optional third step
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(device->get_handle());
 
+	// A device taken over keeps the pipeline cache it was created with
+	if (pipeline_cache_persistence && !pipeline_cache)
+	{
+		// Workers get caches of their own, so that parallel pipeline creation does not contend on the main one
+		size_t worker_cache_count = bindingType == BindingType::C ? JobSystem::get().get_worker_count() : 0;
+
+		pipeline_cache = std::make_unique<vkb::PersistentPipelineCache>(static_cast<VkDevice>(device->get_handle()),
+		                                                                static_cast<const VkPhysicalDeviceProperties &>(device->get_gpu().get_properties()),
+		                                                                get_name(),
+		                                                                worker_cache_count);
+
+		auto &resource_cache = get_device().get_resource_cache();
+		if constexpr (bindingType == BindingType::Cpp)
+		{
+			resource_cache.set_pipeline_cache(vk::PipelineCache{pipeline_cache->get_handle()});
+		}
+		else
+		{
+			resource_cache.set_pipeline_cache(pipeline_cache->get_handle());
+			resource_cache.set_worker_pipeline_caches(pipeline_cache->get_worker_handles());
+		}
+	}
+
 	create_render_context();
 	prepare_render_context();
 
@@ -1112,7 +1693,24 @@ inline void VulkanSample<bindingType>::create_gui(const Window &window, StatsTyp
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::prepare_render_context()
 {
-	render_context->prepare();
+	// One set of frame resources for the main thread, and one per job system worker recording
+	render_context->prepare(parallel_recording ? JobSystem::get().get_worker_count() + 1 : 1);
+}
+
+template <vkb::BindingType bindingType>
+inline typename VulkanSample<bindingType>::RenderTargetType &VulkanSample<bindingType>::get_scene_render_target()
+{
+	if constexpr (bindingType == BindingType::Cpp)
+	{
+		return render_context->get_active_frame().get_render_target();
+	}
+	else
+	{
+		auto &render_frame         = get_render_context().get_active_frame();
+		auto *scaled_render_target = render_frame.get_scaled_render_target();
+
+		return scaled_render_target ? *scaled_render_target : render_frame.get_render_target();
+	}
 }
 
 template <vkb::BindingType bindingType>
@@ -1133,7 +1731,8 @@ inline void VulkanSample<bindingType>::render_impl(vkb::core::HPPCommandBuffer &
 {
 	if (render_pipeline)
 	{
-		render_pipeline->draw(command_buffer, render_context->get_active_frame().get_render_target());
+		render_pipeline->set_job_system(parallel_recording ? &JobSystem::get() : nullptr);
+		render_pipeline->draw(command_buffer, reinterpret_cast<vkb::rendering::HPPRenderTarget &>(get_scene_render_target()));
 	}
 }
 
@@ -1163,7 +1762,7 @@ inline bool VulkanSample<bindingType>::resize(uint32_t width, uint32_t height)
 
 	if (scene && scene->has_component<sg::Script>())
 	{
-		auto scripts = scene->get_components<sg::Script>();
+		auto scripts = scene->get_component_view<sg::Script>();
 
 		for (auto script : scripts)
 		{
@@ -1190,6 +1789,72 @@ inline void VulkanSample<bindingType>::set_high_priority_graphics_queue_enable(b
 	high_priority_graphics_queue = enable;
 }
 
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_parallel_recording_enable(bool enable)
+{
+	parallel_recording = enable;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_frame_pipelining_enable(bool enable)
+{
+	frame_pipelining = enable;
+
+	// A snapshot left from a previous run of the pipeline would be recorded once
+	for (auto &frame_snapshot : frame_snapshots)
+	{
+		frame_snapshot.captured = false;
+	}
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_temporal_anti_aliasing_enable(bool enable)
+{
+	temporal_anti_aliasing = enable;
+
+	// The history of a previous run of the resolve does not match the frames rendered meanwhile
+	if (temporal_resolve)
+	{
+		temporal_resolve->reset();
+	}
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_pipeline_cache_persistence_enable(bool enable)
+{
+	pipeline_cache_persistence = enable;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_device_sharing_enable(bool enable)
+{
+	device_sharing = enable;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_mip_streaming_budget(VkDeviceSize memory_budget)
+{
+	mip_streaming_budget = memory_budget;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_mip_streaming_camera(sg::Camera *camera)
+{
+	mip_streaming_camera = camera;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_meshlet_geometry_enable(bool enable)
+{
+	meshlet_geometry = enable;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_ray_tracing_geometry_enable(bool enable)
+{
+	ray_tracing_geometry = enable;
+}
+
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::set_render_context(std::unique_ptr<RenderContextType> &&rc)
 {
@@ -1239,15 +1904,113 @@ inline void VulkanSample<bindingType>::set_viewport_and_scissor_impl(vkb::core::
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::update(float delta_time)
 {
-	update_scene(delta_time);
+	if constexpr (bindingType == BindingType::C)
+	{
+		// The captured frames are submitted again as they were, without updating the scene, see RenderContext::begin_frame_capture()
+		auto &context = get_render_context();
+		if (context.has_frame_capture() && context.replay_frame())
+		{
+			return;
+		}
+
+		if (frame_pipelining)
+		{
+			update_pipelined(delta_time);
+			return;
+		}
+	}
 
 	update_gui(delta_time);
 
+	// Waiting for a free frame is often the longest part of an update, so the scene is updated after it
 	auto &command_buffer = render_context->begin();
 
+	sample_input();
+
+	update_scene(delta_time);
+
 	// Collect the performance data for the sample graphs
 	update_stats(delta_time);
 
+	record_frame(command_buffer);
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::update_pipelined(float delta_time)
+{
+	// The first frame has no snapshot to be recorded from yet, so its scene is updated up front
+	if (!frame_snapshots[next_frame_snapshot].captured)
+	{
+		sample_input();
+		update_scene(delta_time);
+		capture_frame_snapshot(frame_snapshots[next_frame_snapshot]);
+	}
+
+	auto &recorded_snapshot = frame_snapshots[next_frame_snapshot];
+	auto &updated_snapshot  = frame_snapshots[1 - next_frame_snapshot];
+	next_frame_snapshot     = 1 - next_frame_snapshot;
+
+	// The GUI and the scripts receive their input on this thread, before the scene update starts
+	update_gui(delta_time);
+
+	sample_input();
+
+	auto &job_system = JobSystem::get();
+
+	// The recording of this frame uses the frame resources of this thread, so it is the scene update which runs on a worker
+	auto scene_update = job_system.submit([this, &updated_snapshot, delta_time]() {
+		update_scene_nodes(delta_time);
+		capture_frame_snapshot(updated_snapshot);
+	});
+
+	// The job references the snapshots, so it must finish before an exception leaves this function
+	try
+	{
+		auto &command_buffer = render_context->begin();
+
+		auto &active_context = get_render_context();
+		active_context.get_active_frame().set_scene_snapshot(&recorded_snapshot.scene);
+		active_context.set_frame_input_time(recorded_snapshot.input_time, recorded_snapshot.event_time);
+
+		update_stats(delta_time);
+
+		record_frame(command_buffer);
+	}
+	catch (...)
+	{
+		try
+		{
+			job_system.wait(scene_update);
+		}
+		catch (...)
+		{
+		}
+		throw;
+	}
+
+	job_system.wait(scene_update);
+
+	// Streaming adds resources to the scene, so it only runs while no frame is recorded from it
+	if (scene_loader && scene_loader->update_streaming())
+	{
+		scene_loader.reset();
+	}
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::capture_frame_snapshot(FrameSnapshot &frame_snapshot)
+{
+	if (scene)
+	{
+		frame_snapshot.scene.capture(*scene);
+	}
+
+	frame_snapshot.captured = true;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::record_frame(vkb::core::HPPCommandBuffer &command_buffer)
+{
 	command_buffer.begin(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 	stats->begin_sampling(command_buffer);
 
@@ -1318,15 +2081,51 @@ inline void VulkanSample<bindingType>::update_gui(float delta_time)
 	}
 }
 
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::sample_input()
+{
+	if (window)
+	{
+		window->sample_input();
+	}
+
+	auto sample_time = std::chrono::steady_clock::now();
+
+	if (frame_pipelining)
+	{
+		// Set on the render context once the frame recorded from the scene updated with this input is begun
+		auto &frame_snapshot      = frame_snapshots[next_frame_snapshot];
+		frame_snapshot.input_time = sample_time;
+		frame_snapshot.event_time = pending_input_event_time;
+	}
+	else if constexpr (bindingType == BindingType::C)
+	{
+		get_render_context().set_frame_input_time(sample_time, pending_input_event_time);
+	}
+
+	pending_input_event_time = {};
+}
+
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::update_scene(float delta_time)
+{
+	if (scene_loader && scene_loader->update_streaming())
+	{
+		scene_loader.reset();
+	}
+
+	update_scene_nodes(delta_time);
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::update_scene_nodes(float delta_time)
 {
 	if (scene)
 	{
 		// Update scripts
 		if (scene->has_component<sg::Script>())
 		{
-			auto scripts = scene->get_components<sg::Script>();
+			auto scripts = scene->get_component_view<sg::Script>();
 
 			for (auto script : scripts)
 			{
@@ -1337,13 +2136,16 @@ inline void VulkanSample<bindingType>::update_scene(float delta_time)
 		// Update animations
 		if (scene->has_component<sg::Animation>())
 		{
-			auto animations = scene->get_components<sg::Animation>();
+			auto animations = scene->get_component_view<sg::Animation>();
 
 			for (auto animation : animations)
 			{
 				animation->update(delta_time);
 			}
 		}
+
+		// Resolve all world matrices once, in parent before child order, instead of lazily per draw
+		scene->update_world_matrices(&JobSystem::get());
 	}
 }
 
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,13 +16,45 @@
  */
 
 /*
- * Compute shader N-body simulation using two passes and shared compute shader memory
+ * Compute shader N-body simulation using two passes and shared compute shader memory,
+ * or a spatial grid built on the GPU each step for large particle counts
  */
 
 #include "compute_nbody.h"
 
+#include <numeric>
+
 #include "benchmark_mode/benchmark_mode.h"
 
+namespace
+{
+// Particles per attractor selectable in the UI
+const std::vector<uint32_t> particle_count_options = {PARTICLES_PER_ATTRACTOR, 4 * PARTICLES_PER_ATTRACTOR, BENCHMARK_PARTICLES_PER_ATTRACTOR};
+
+// Fixed domain of the spatial grid, particles outside of it are kept in its border cells
+const glm::vec3 grid_origin = glm::vec3(-16.0f);
+const float     grid_extent = 32.0f;
+
+// Number of steps between two throughput reports in benchmark mode
+const uint32_t benchmark_report_steps = 100;
+
+void compute_to_compute_barrier(VkCommandBuffer command_buffer)
+{
+	VkMemoryBarrier memory_barrier = vkb::initializers::memory_barrier();
+	memory_barrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+	memory_barrier.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+	vkCmdPipelineBarrier(
+	    command_buffer,
+	    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	    VK_FLAGS_NONE,
+	    1, &memory_barrier,
+	    0, nullptr,
+	    0, nullptr);
+}
+}        // namespace
+
 ComputeNBody::ComputeNBody()
 {
 	title       = "Compute shader N-body system";
@@ -53,9 +85,34 @@ ComputeNBody::~ComputeNBody()
 		vkDestroyDescriptorSetLayout(get_device().get_handle(), compute.descriptor_set_layout, nullptr);
 		vkDestroyPipeline(get_device().get_handle(), compute.pipeline_calculate, nullptr);
 		vkDestroyPipeline(get_device().get_handle(), compute.pipeline_integrate, nullptr);
+		if (spatial_grid_available)
+		{
+			vkDestroyPipeline(get_device().get_handle(), compute.pipeline_grid_count, nullptr);
+			for (auto pipeline : compute.pipeline_grid_scan)
+			{
+				vkDestroyPipeline(get_device().get_handle(), pipeline, nullptr);
+			}
+			vkDestroyPipeline(get_device().get_handle(), compute.pipeline_grid_scatter, nullptr);
+			vkDestroyPipeline(get_device().get_handle(), compute.pipeline_grid_aggregate, nullptr);
+			vkDestroyPipeline(get_device().get_handle(), compute.pipeline_grid_calculate, nullptr);
+		}
+		if (compute.query_pool != VK_NULL_HANDLE)
+		{
+			vkDestroyQueryPool(get_device().get_handle(), compute.query_pool, nullptr);
+		}
 		vkDestroySemaphore(get_device().get_handle(), compute.semaphore, nullptr);
 		vkDestroyCommandPool(get_device().get_handle(), compute.command_pool, nullptr);
 
+		// Spatial grid
+		grid.cell_counts.reset();
+		grid.cell_starts.reset();
+		grid.block_sums.reset();
+		grid.particle_cells.reset();
+		grid.sorted_positions.reset();
+		grid.sorted_indices.reset();
+		grid.cell_masses.reset();
+		grid.interactions.reset();
+
 		vkDestroySampler(get_device().get_handle(), textures.particle.sampler, nullptr);
 		vkDestroySampler(get_device().get_handle(), textures.gradient.sampler, nullptr);
 	}
@@ -199,11 +256,104 @@ void ComputeNBody::build_compute_command_buffer()
 		    0, nullptr);
 	}
 
-	// First pass: Calculate particle movement
-	// -------------------------------------------------------------------------------------------------------
-	vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_calculate);
+	if (compute.query_pool != VK_NULL_HANDLE)
+	{
+		vkCmdResetQueryPool(compute.command_buffer, compute.query_pool, 0, 2);
+		vkCmdWriteTimestamp(compute.command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, compute.query_pool, 0);
+	}
+
 	vkCmdBindDescriptorSets(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_layout, 0, 1, &compute.descriptor_set, 0, 0);
-	vkCmdDispatch(compute.command_buffer, num_particles / work_group_size, 1, 1);
+
+	if (use_spatial_grid())
+	{
+		uint32_t particle_groups = (num_particles + work_group_size - 1) / work_group_size;
+		uint32_t cell_count      = grid_dimension * grid_dimension * grid_dimension;
+		uint32_t coarse_count    = cell_count / (grid_brick_size * grid_brick_size * grid_brick_size);
+		uint32_t scan_blocks     = (cell_count + scan_block_size - 1) / scan_block_size;
+
+		GridParameters parameters{};
+		parameters.origin    = grid_origin;
+		parameters.cell_size = grid_extent / grid_dimension;
+		parameters.level     = 0;
+		vkCmdPushConstants(compute.command_buffer, compute.pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(parameters), &parameters);
+
+		// The cell counts are accumulated with atomics, so they start from zero each step
+		vkCmdFillBuffer(compute.command_buffer, grid.cell_counts->get_handle(), 0, VK_WHOLE_SIZE, 0);
+
+		VkMemoryBarrier fill_barrier = vkb::initializers::memory_barrier();
+		fill_barrier.srcAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+		fill_barrier.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(
+		    compute.command_buffer,
+		    VK_PIPELINE_STAGE_TRANSFER_BIT,
+		    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		    VK_FLAGS_NONE,
+		    1, &fill_barrier,
+		    0, nullptr,
+		    0, nullptr);
+
+		// Build the grid: count the particles of each cell, prefix sum the counts and sort the particles by cell
+		// -------------------------------------------------------------------------------------------------------
+		vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_grid_count);
+		vkCmdDispatch(compute.command_buffer, particle_groups, 1, 1);
+		compute_to_compute_barrier(compute.command_buffer);
+
+		vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_grid_scan[0]);
+		vkCmdDispatch(compute.command_buffer, scan_blocks, 1, 1);
+		compute_to_compute_barrier(compute.command_buffer);
+
+		vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_grid_scan[1]);
+		vkCmdDispatch(compute.command_buffer, 1, 1, 1);
+		compute_to_compute_barrier(compute.command_buffer);
+
+		vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_grid_scan[2]);
+		vkCmdDispatch(compute.command_buffer, scan_blocks, 1, 1);
+		compute_to_compute_barrier(compute.command_buffer);
+
+		vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_grid_scatter);
+		vkCmdDispatch(compute.command_buffer, particle_groups, 1, 1);
+		compute_to_compute_barrier(compute.command_buffer);
+
+		// Center of mass of the fine cells, then of the coarse cells
+		// -------------------------------------------------------------------------------------------------------
+		vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_grid_aggregate);
+		vkCmdDispatch(compute.command_buffer, (cell_count + work_group_size - 1) / work_group_size, 1, 1);
+		compute_to_compute_barrier(compute.command_buffer);
+
+		parameters.level = 1;
+		vkCmdPushConstants(compute.command_buffer, compute.pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(parameters), &parameters);
+		vkCmdDispatch(compute.command_buffer, (coarse_count + work_group_size - 1) / work_group_size, 1, 1);
+		compute_to_compute_barrier(compute.command_buffer);
+
+		// Calculate particle movement from the neighbouring particles and the centers of mass of the other cells
+		// -------------------------------------------------------------------------------------------------------
+		vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_grid_calculate);
+		vkCmdDispatch(compute.command_buffer, particle_groups, 1, 1);
+
+		// Make the interaction counts available to the host
+		VkBufferMemoryBarrier host_barrier = vkb::initializers::buffer_memory_barrier();
+		host_barrier.buffer                = grid.interactions->get_handle();
+		host_barrier.size                  = grid.interactions->get_size();
+		host_barrier.srcAccessMask         = VK_ACCESS_SHADER_WRITE_BIT;
+		host_barrier.dstAccessMask         = VK_ACCESS_HOST_READ_BIT;
+		host_barrier.srcQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
+		host_barrier.dstQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
+		vkCmdPipelineBarrier(
+		    compute.command_buffer,
+		    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		    VK_PIPELINE_STAGE_HOST_BIT,
+		    VK_FLAGS_NONE,
+		    0, nullptr,
+		    1, &host_barrier,
+		    0, nullptr);
+	}
+	else
+	{
+		// First pass: Calculate particle movement
+		// -------------------------------------------------------------------------------------------------------
+		vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_calculate);
+		vkCmdDispatch(compute.command_buffer, num_particles / work_group_size, 1, 1);
+	}
 
 	// Add memory barrier to ensure that the computer shader has finished writing to the buffer
 	VkBufferMemoryBarrier memory_barrier = vkb::initializers::buffer_memory_barrier();
@@ -228,6 +378,11 @@ void ComputeNBody::build_compute_command_buffer()
 	vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_integrate);
 	vkCmdDispatch(compute.command_buffer, num_particles / work_group_size, 1, 1);
 
+	if (compute.query_pool != VK_NULL_HANDLE)
+	{
+		vkCmdWriteTimestamp(compute.command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, compute.query_pool, 1);
+	}
+
 	// Release
 	if (graphics.queue_family_index != compute.queue_family_index)
 	{
@@ -275,7 +430,7 @@ void ComputeNBody::prepare_storage_buffers()
 	};
 #endif
 
-	num_particles = static_cast<uint32_t>(attractors.size()) * PARTICLES_PER_ATTRACTOR;
+	num_particles = static_cast<uint32_t>(attractors.size()) * particles_per_attractor;
 
 	// Initial particle positions
 	std::vector<Particle> particle_buffer(num_particles);
@@ -285,9 +440,9 @@ void ComputeNBody::prepare_storage_buffers()
 
 	for (uint32_t i = 0; i < static_cast<uint32_t>(attractors.size()); i++)
 	{
-		for (uint32_t j = 0; j < PARTICLES_PER_ATTRACTOR; j++)
+		for (uint32_t j = 0; j < particles_per_attractor; j++)
 		{
-			Particle &particle = particle_buffer[i * PARTICLES_PER_ATTRACTOR + j];
+			Particle &particle = particle_buffer[i * particles_per_attractor + j];
 
 			// First particle in group as heavy center of gravity
 			if (j == 0)
@@ -362,12 +517,37 @@ void ComputeNBody::prepare_storage_buffers()
 	get_device().flush_command_buffer(copy_command, queue, true);
 }
 
+// Setup the buffers the spatial grid is built in each step
+void ComputeNBody::prepare_grid_buffers()
+{
+	VkDeviceSize cell_count   = grid_dimension * grid_dimension * grid_dimension;
+	VkDeviceSize coarse_count = cell_count / (grid_brick_size * grid_brick_size * grid_brick_size);
+
+	auto create_storage_buffer = [this](VkDeviceSize size, VkBufferUsageFlags usage = 0) {
+		return std::make_unique<vkb::core::Buffer>(get_device(), size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | usage, VMA_MEMORY_USAGE_GPU_ONLY);
+	};
+
+	grid.cell_counts      = create_storage_buffer(cell_count * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+	grid.cell_starts      = create_storage_buffer(cell_count * sizeof(uint32_t));
+	grid.block_sums       = create_storage_buffer(((cell_count + scan_block_size - 1) / scan_block_size) * sizeof(uint32_t));
+	grid.particle_cells   = create_storage_buffer(num_particles * sizeof(glm::uvec2));
+	grid.sorted_positions = create_storage_buffer(num_particles * sizeof(glm::vec4));
+	grid.sorted_indices   = create_storage_buffer(num_particles * sizeof(uint32_t));
+	grid.cell_masses      = create_storage_buffer((cell_count + coarse_count) * sizeof(glm::vec4));
+
+	// Read back by the host to measure the throughput of the simulation
+	grid.interactions = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                        ((num_particles + work_group_size - 1) / work_group_size) * sizeof(uint32_t),
+	                                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	                                                        VMA_MEMORY_USAGE_GPU_TO_CPU);
+}
+
 void ComputeNBody::setup_descriptor_pool()
 {
 	std::vector<VkDescriptorPoolSize> pool_sizes =
 	    {
 	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2),
-	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1),
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 9),
 	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2)};
 
 	VkDescriptorPoolCreateInfo descriptor_pool_create_info =
@@ -527,6 +707,7 @@ void ComputeNBody::prepare_pipelines()
 void ComputeNBody::prepare_graphics()
 {
 	prepare_storage_buffers();
+	prepare_grid_buffers();
 	prepare_uniform_buffers();
 	setup_descriptor_set_layout();
 	prepare_pipelines();
@@ -558,6 +739,12 @@ void ComputeNBody::prepare_compute()
 	        1),
 	};
 
+	// Bindings 2 to 9 : Spatial grid storage buffers
+	for (uint32_t binding = 2; binding <= 9; binding++)
+	{
+		set_layout_bindings.push_back(vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, binding));
+	}
+
 	VkDescriptorSetLayoutCreateInfo descriptor_layout =
 	    vkb::initializers::descriptor_set_layout_create_info(
 	        set_layout_bindings.data(),
@@ -570,6 +757,11 @@ void ComputeNBody::prepare_compute()
 	        &compute.descriptor_set_layout,
 	        1);
 
+	// The spatial grid passes pass the grid parameters as push constants
+	VkPushConstantRange push_constant_range            = vkb::initializers::push_constant_range(VK_SHADER_STAGE_COMPUTE_BIT, sizeof(GridParameters), 0);
+	pipeline_layout_create_info.pushConstantRangeCount = 1;
+	pipeline_layout_create_info.pPushConstantRanges    = &push_constant_range;
+
 	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &pipeline_layout_create_info, nullptr, &compute.pipeline_layout));
 
 	VkDescriptorSetAllocateInfo alloc_info =
@@ -580,24 +772,7 @@ void ComputeNBody::prepare_compute()
 
 	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &alloc_info, &compute.descriptor_set));
 
-	VkDescriptorBufferInfo            storage_buffer_descriptor = create_descriptor(*compute.storage_buffer);
-	VkDescriptorBufferInfo            uniform_buffer_descriptor = create_descriptor(*compute.uniform_buffer);
-	std::vector<VkWriteDescriptorSet> compute_write_descriptor_sets =
-	    {
-	        // Binding 0 : Particle position storage buffer
-	        vkb::initializers::write_descriptor_set(
-	            compute.descriptor_set,
-	            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-	            0,
-	            &storage_buffer_descriptor),
-	        // Binding 1 : Uniform buffer
-	        vkb::initializers::write_descriptor_set(
-	            compute.descriptor_set,
-	            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-	            1,
-	            &uniform_buffer_descriptor)};
-
-	vkUpdateDescriptorSets(get_device().get_handle(), static_cast<uint32_t>(compute_write_descriptor_sets.size()), compute_write_descriptor_sets.data(), 0, NULL);
+	update_compute_descriptor_set();
 
 	// Create pipelines
 	VkComputePipelineCreateInfo compute_pipeline_create_info = vkb::initializers::compute_pipeline_create_info(compute.pipeline_layout, 0);
@@ -634,6 +809,59 @@ void ComputeNBody::prepare_compute()
 
 	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &compute.pipeline_calculate));
 
+	// Spatial grid passes, which share their specialization constants
+	struct GridSpecializationData
+	{
+		uint32_t workgroup_size;
+		uint32_t grid_dimension;
+		float    gravity;
+		float    power;
+		float    soften;
+		uint32_t brick_size;
+		uint32_t scan_pass;
+	} grid_specialization_data;
+
+	std::vector<VkSpecializationMapEntry> grid_specialization_map_entries = {
+	    vkb::initializers::specialization_map_entry(0, offsetof(GridSpecializationData, workgroup_size), sizeof(uint32_t)),
+	    vkb::initializers::specialization_map_entry(1, offsetof(GridSpecializationData, grid_dimension), sizeof(uint32_t)),
+	    vkb::initializers::specialization_map_entry(2, offsetof(GridSpecializationData, gravity), sizeof(float)),
+	    vkb::initializers::specialization_map_entry(3, offsetof(GridSpecializationData, power), sizeof(float)),
+	    vkb::initializers::specialization_map_entry(4, offsetof(GridSpecializationData, soften), sizeof(float)),
+	    vkb::initializers::specialization_map_entry(5, offsetof(GridSpecializationData, brick_size), sizeof(uint32_t)),
+	    vkb::initializers::specialization_map_entry(6, offsetof(GridSpecializationData, scan_pass), sizeof(uint32_t))};
+
+	grid_specialization_data.workgroup_size = work_group_size;
+	grid_specialization_data.grid_dimension = grid_dimension;
+	grid_specialization_data.gravity        = specialization_data.gravity;
+	grid_specialization_data.power          = specialization_data.power;
+	grid_specialization_data.soften         = specialization_data.soften;
+	grid_specialization_data.brick_size     = grid_brick_size;
+	grid_specialization_data.scan_pass      = 0;
+
+	VkSpecializationInfo grid_specialization_info =
+	    vkb::initializers::specialization_info(static_cast<uint32_t>(grid_specialization_map_entries.size()), grid_specialization_map_entries.data(), sizeof(grid_specialization_data), &grid_specialization_data);
+
+	auto create_grid_pipeline = [&](const std::string &file, VkPipeline &pipeline) {
+		compute_pipeline_create_info.stage                     = load_shader("compute_nbody", file, VK_SHADER_STAGE_COMPUTE_BIT);
+		compute_pipeline_create_info.stage.pSpecializationInfo = &grid_specialization_info;
+		VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &pipeline));
+	};
+
+	// The simulation stays in all pairs mode with HLSL
+	spatial_grid_available = get_shading_language() == vkb::ShadingLanguage::GLSL;
+	if (spatial_grid_available)
+	{
+		create_grid_pipeline("particle_grid_count.comp", compute.pipeline_grid_count);
+		for (uint32_t pass = 0; pass < 3; pass++)
+		{
+			grid_specialization_data.scan_pass = pass;
+			create_grid_pipeline("particle_grid_scan.comp", compute.pipeline_grid_scan[pass]);
+		}
+		create_grid_pipeline("particle_grid_scatter.comp", compute.pipeline_grid_scatter);
+		create_grid_pipeline("particle_grid_aggregate.comp", compute.pipeline_grid_aggregate);
+		create_grid_pipeline("particle_grid_calculate.comp", compute.pipeline_grid_calculate);
+	}
+
 	// 2nd pass - Particle integration
 	compute_pipeline_create_info.stage = load_shader("compute_nbody", "particle_integrate.comp", VK_SHADER_STAGE_COMPUTE_BIT);
 
@@ -645,10 +873,21 @@ void ComputeNBody::prepare_compute()
 	compute_pipeline_create_info.stage.pSpecializationInfo = &specialization_info;
 	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &compute.pipeline_integrate));
 
+	// Timestamps around the compute commands measure the throughput of the simulation, if the compute queue supports them
+	if (get_device().get_gpu().get_properties().limits.timestampPeriod > 0.0f &&
+	    get_device().get_gpu().get_queue_family_properties()[compute.queue_family_index].timestampValidBits > 0)
+	{
+		VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+		query_pool_info.queryCount = 2;
+		VK_CHECK(vkCreateQueryPool(get_device().get_handle(), &query_pool_info, nullptr, &compute.query_pool));
+	}
+
 	// Separate command pool as queue family for compute may be different than graphics
 	VkCommandPoolCreateInfo command_pool_create_info = {};
 	command_pool_create_info.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	command_pool_create_info.queueFamilyIndex        = get_device().get_queue_family_index(VK_QUEUE_COMPUTE_BIT);
+	command_pool_create_info.flags                   = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 	VK_CHECK(vkCreateCommandPool(get_device().get_handle(), &command_pool_create_info, nullptr, &compute.command_pool));
 
 	// Create a command buffer for compute operations
@@ -674,89 +913,216 @@ void ComputeNBody::prepare_compute()
 	// Build a single command buffer containing the compute dispatch commands
 	build_compute_command_buffer();
 
-	// If necessary, acquire and immediately release the storage buffer, so that the initial acquire
-	// from the graphics command buffers are matched up properly.
-	if (graphics.queue_family_index != compute.queue_family_index)
+	transfer_storage_buffer_ownership();
+}
+
+void ComputeNBody::update_compute_descriptor_set()
+{
+	std::array<VkDescriptorBufferInfo, 10> buffer_descriptors = {
+	    create_descriptor(*compute.storage_buffer),
+	    create_descriptor(*compute.uniform_buffer),
+	    create_descriptor(*grid.cell_counts),
+	    create_descriptor(*grid.cell_starts),
+	    create_descriptor(*grid.block_sums),
+	    create_descriptor(*grid.particle_cells),
+	    create_descriptor(*grid.sorted_positions),
+	    create_descriptor(*grid.sorted_indices),
+	    create_descriptor(*grid.cell_masses),
+	    create_descriptor(*grid.interactions)};
+
+	std::vector<VkWriteDescriptorSet> compute_write_descriptor_sets;
+	for (uint32_t binding = 0; binding < static_cast<uint32_t>(buffer_descriptors.size()); binding++)
 	{
-		VkCommandBuffer transfer_command;
+		// Binding 0 : Particle position storage buffer
+		// Binding 1 : Uniform buffer
+		// Bindings 2 to 9 : Spatial grid storage buffers
+		compute_write_descriptor_sets.push_back(
+		    vkb::initializers::write_descriptor_set(
+		        compute.descriptor_set,
+		        binding == 1 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		        binding,
+		        &buffer_descriptors[binding]));
+	}
 
-		// Create a transient command buffer for setting up the initial buffer transfer state
-		VkCommandBufferAllocateInfo command_buffer_allocate_info =
-		    vkb::initializers::command_buffer_allocate_info(
-		        compute.command_pool,
-		        VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-		        1);
+	vkUpdateDescriptorSets(get_device().get_handle(), static_cast<uint32_t>(compute_write_descriptor_sets.size()), compute_write_descriptor_sets.data(), 0, NULL);
+}
 
-		VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &command_buffer_allocate_info, &transfer_command));
+// If necessary, acquire and immediately release the storage buffer, so that the initial acquire
+// from the graphics command buffers are matched up properly.
+void ComputeNBody::transfer_storage_buffer_ownership()
+{
+	if (graphics.queue_family_index == compute.queue_family_index)
+	{
+		return;
+	}
 
-		VkCommandBufferBeginInfo command_buffer_info{};
-		command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		VK_CHECK(vkBeginCommandBuffer(transfer_command, &command_buffer_info));
+	VkCommandBuffer transfer_command;
 
-		VkBufferMemoryBarrier acquire_buffer_barrier =
-		    {
-		        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-		        nullptr,
-		        0,
-		        VK_ACCESS_SHADER_WRITE_BIT,
-		        graphics.queue_family_index,
-		        compute.queue_family_index,
-		        compute.storage_buffer->get_handle(),
-		        0,
-		        compute.storage_buffer->get_size()};
-		vkCmdPipelineBarrier(
-		    transfer_command,
-		    VK_PIPELINE_STAGE_TRANSFER_BIT,
-		    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-		    0,
-		    0, nullptr,
-		    1, &acquire_buffer_barrier,
-		    0, nullptr);
+	// Create a transient command buffer for setting up the initial buffer transfer state
+	VkCommandBufferAllocateInfo command_buffer_allocate_info =
+	    vkb::initializers::command_buffer_allocate_info(
+	        compute.command_pool,
+	        VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+	        1);
 
-		VkBufferMemoryBarrier release_buffer_barrier =
-		    {
-		        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-		        nullptr,
-		        VK_ACCESS_SHADER_WRITE_BIT,
-		        0,
-		        compute.queue_family_index,
-		        graphics.queue_family_index,
-		        compute.storage_buffer->get_handle(),
-		        0,
-		        compute.storage_buffer->get_size()};
-		vkCmdPipelineBarrier(
-		    transfer_command,
-		    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-		    VK_PIPELINE_STAGE_TRANSFER_BIT,
-		    0,
-		    0, nullptr,
-		    1, &release_buffer_barrier,
-		    0, nullptr);
+	VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &command_buffer_allocate_info, &transfer_command));
+
+	VkCommandBufferBeginInfo command_buffer_info{};
+	command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	VK_CHECK(vkBeginCommandBuffer(transfer_command, &command_buffer_info));
+
+	VkBufferMemoryBarrier acquire_buffer_barrier =
+	    {
+	        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+	        nullptr,
+	        0,
+	        VK_ACCESS_SHADER_WRITE_BIT,
+	        graphics.queue_family_index,
+	        compute.queue_family_index,
+	        compute.storage_buffer->get_handle(),
+	        0,
+	        compute.storage_buffer->get_size()};
+	vkCmdPipelineBarrier(
+	    transfer_command,
+	    VK_PIPELINE_STAGE_TRANSFER_BIT,
+	    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	    0,
+	    0, nullptr,
+	    1, &acquire_buffer_barrier,
+	    0, nullptr);
+
+	VkBufferMemoryBarrier release_buffer_barrier =
+	    {
+	        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+	        nullptr,
+	        VK_ACCESS_SHADER_WRITE_BIT,
+	        0,
+	        compute.queue_family_index,
+	        graphics.queue_family_index,
+	        compute.storage_buffer->get_handle(),
+	        0,
+	        compute.storage_buffer->get_size()};
+	vkCmdPipelineBarrier(
+	    transfer_command,
+	    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	    VK_PIPELINE_STAGE_TRANSFER_BIT,
+	    0,
+	    0, nullptr,
+	    1, &release_buffer_barrier,
+	    0, nullptr);
+
+	// Copied from Device::flush_command_buffer, which we can't use because it would be
+	// working with the wrong command pool
+	VK_CHECK(vkEndCommandBuffer(transfer_command));
+
+	// Submit compute commands
+	VkSubmitInfo submit_info{};
+	submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &transfer_command;
+
+	// Create fence to ensure that the command buffer has finished executing
+	VkFenceCreateInfo fence_info{};
+	fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fence_info.flags = VK_FLAGS_NONE;
+
+	VkFence fence;
+	VK_CHECK(vkCreateFence(get_device().get_handle(), &fence_info, nullptr, &fence));
+	// Submit to the *compute* queue
+	VkResult result = vkQueueSubmit(compute.queue, 1, &submit_info, fence);
+	// Wait for the fence to signal that command buffer has finished executing
+	VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &fence, VK_TRUE, DEFAULT_FENCE_TIMEOUT));
+	vkDestroyFence(get_device().get_handle(), fence, nullptr);
+
+	vkFreeCommandBuffers(get_device().get_handle(), compute.command_pool, 1, &transfer_command);
+}
+
+// Recreate the particles and the spatial grid buffers after a change of the particle count
+void ComputeNBody::reset_particles()
+{
+	get_device().wait_idle();
+
+	prepare_storage_buffers();
+	prepare_grid_buffers();
+	update_compute_descriptor_set();
+	transfer_storage_buffer_ownership();
+
+	build_compute_command_buffer();
+	rebuild_command_buffers();
+
+	compute.results_pending = false;
+	statistics              = {};
+}
 
-		// Copied from Device::flush_command_buffer, which we can't use because it would be
-		// working with the wrong command pool
-		VK_CHECK(vkEndCommandBuffer(transfer_command));
-
-		// Submit compute commands
-		VkSubmitInfo submit_info{};
-		submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submit_info.commandBufferCount = 1;
-		submit_info.pCommandBuffers    = &transfer_command;
-
-		// Create fence to ensure that the command buffer has finished executing
-		VkFenceCreateInfo fence_info{};
-		fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fence_info.flags = VK_FLAGS_NONE;
-
-		VkFence fence;
-		VK_CHECK(vkCreateFence(get_device().get_handle(), &fence_info, nullptr, &fence));
-		// Submit to the *compute* queue
-		VkResult result = vkQueueSubmit(compute.queue, 1, &submit_info, fence);
-		// Wait for the fence to signal that command buffer has finished executing
-		VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &fence, VK_TRUE, DEFAULT_FENCE_TIMEOUT));
-		vkDestroyFence(get_device().get_handle(), fence, nullptr);
-
-		vkFreeCommandBuffers(get_device().get_handle(), compute.command_pool, 1, &transfer_command);
+bool ComputeNBody::use_spatial_grid() const
+{
+	if (!spatial_grid_available)
+	{
+		return false;
+	}
+
+	switch (simulation_mode)
+	{
+		case SimulationMode::AllPairs:
+			return false;
+		case SimulationMode::SpatialGrid:
+			return true;
+		default:
+			return num_particles > spatial_grid_particle_threshold;
+	}
+}
+
+// Read the timestamps and interaction counts of the last compute submission, which has completed
+void ComputeNBody::read_compute_results()
+{
+	if (!compute.results_pending || compute.query_pool == VK_NULL_HANDLE)
+	{
+		return;
+	}
+	compute.results_pending = false;
+
+	std::array<uint64_t, 2> timestamps{};
+	if (vkGetQueryPoolResults(get_device().get_handle(), compute.query_pool, 0, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+	{
+		return;
+	}
+	statistics.step_time = static_cast<double>(timestamps[1] - timestamps[0]) * get_device().get_gpu().get_properties().limits.timestampPeriod * 1e-9;
+
+	if (use_spatial_grid())
+	{
+		grid.interactions->invalidate();
+
+		const uint32_t *interactions = reinterpret_cast<const uint32_t *>(grid.interactions->map());
+		uint32_t        group_count  = (num_particles + work_group_size - 1) / work_group_size;
+
+		statistics.interactions = std::accumulate(interactions, interactions + group_count, uint64_t{0});
+	}
+	else
+	{
+		statistics.interactions = static_cast<uint64_t>(num_particles) * num_particles;
+	}
+
+	if (statistics.step_time > 0.0)
+	{
+		statistics.interactions_per_second = statistics.interactions / statistics.step_time;
+	}
+
+	if (lock_simulation_speed)
+	{
+		statistics.accumulated_time += statistics.step_time;
+		statistics.accumulated_interactions += statistics.interactions;
+		if (++statistics.accumulated_steps == benchmark_report_steps)
+		{
+			LOGI("{} particles, {} mode: {:.3f} ms per step, {:.3e} interactions per second",
+			     num_particles,
+			     use_spatial_grid() ? "spatial grid" : "all pairs",
+			     1000.0 * statistics.accumulated_time / statistics.accumulated_steps,
+			     statistics.accumulated_interactions / statistics.accumulated_time);
+
+			statistics.accumulated_time         = 0.0;
+			statistics.accumulated_interactions = 0;
+			statistics.accumulated_steps        = 0;
+		}
 	}
 }
 
@@ -813,6 +1179,9 @@ void ComputeNBody::draw()
 
 	ApiVulkanSample::submit_frame();
 
+	// The graphics queue is idle and the graphics submission waited for the last compute submission
+	read_compute_results();
+
 	// Wait for rendering finished
 	VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
@@ -826,6 +1195,7 @@ void ComputeNBody::draw()
 	compute_submit_info.signalSemaphoreCount = 1;
 	compute_submit_info.pSignalSemaphores    = &compute.semaphore;
 	VK_CHECK(vkQueueSubmit(compute.queue, 1, &compute_submit_info, VK_NULL_HANDLE));
+	compute.results_pending = true;
 }
 
 bool ComputeNBody::prepare(const vkb::ApplicationOptions &options)
@@ -843,6 +1213,13 @@ bool ComputeNBody::prepare(const vkb::ApplicationOptions &options)
 	// Same for shared data size for passing data between shader invocations
 	shared_data_size = std::min(static_cast<uint32_t>(1024), static_cast<uint32_t>(get_device().get_gpu().get_properties().limits.maxComputeSharedMemorySize / sizeof(glm::vec4)));
 
+	// Benchmark mode stress tests the compute throughput with the largest particle count
+	if (options.benchmark_enabled)
+	{
+		particle_count_index    = static_cast<int32_t>(particle_count_options.size()) - 1;
+		particles_per_attractor = particle_count_options[particle_count_index];
+	}
+
 	load_assets();
 	setup_descriptor_pool();
 	prepare_graphics();
@@ -873,6 +1250,41 @@ bool ComputeNBody::resize(const uint32_t width, const uint32_t height)
 	return true;
 }
 
+void ComputeNBody::on_update_ui_overlay(vkb::Drawer &drawer)
+{
+	if (drawer.header("Settings"))
+	{
+		std::vector<std::string> particle_counts;
+		for (auto count : particle_count_options)
+		{
+			particle_counts.push_back(std::to_string(count * (num_particles / particles_per_attractor)));
+		}
+		if (drawer.combo_box("Particles", &particle_count_index, particle_counts))
+		{
+			particles_per_attractor = particle_count_options[particle_count_index];
+			reset_particles();
+		}
+		if (spatial_grid_available)
+		{
+			int32_t mode = static_cast<int32_t>(simulation_mode);
+			if (drawer.combo_box("Simulation", &mode, {"Automatic", "All pairs", "Spatial grid"}))
+			{
+				simulation_mode = static_cast<SimulationMode>(mode);
+				VK_CHECK(vkQueueWaitIdle(compute.queue));
+				build_compute_command_buffer();
+				compute.results_pending = false;
+				statistics              = {};
+			}
+		}
+	}
+	if (compute.query_pool != VK_NULL_HANDLE && drawer.header("Statistics"))
+	{
+		drawer.text("Mode: %s", use_spatial_grid() ? "spatial grid" : "all pairs");
+		drawer.text("Step: %.3f ms", 1000.0 * statistics.step_time);
+		drawer.text("Interactions: %.3e per second", statistics.interactions_per_second);
+	}
+}
+
 std::unique_ptr<vkb::Application> create_compute_nbody()
 {
 	return std::make_unique<ComputeNBody>();
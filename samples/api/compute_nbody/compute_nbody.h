@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,7 +16,8 @@
  */
 
 /*
- * Compute shader N-body simulation using two passes and shared compute shader memory
+ * Compute shader N-body simulation using two passes and shared compute shader memory,
+ * or a spatial grid built on the GPU each step for large particle counts
  */
 
 #pragma once
@@ -30,12 +31,41 @@
 #	define PARTICLES_PER_ATTRACTOR 4 * 1024
 #endif
 
+#if defined(__ANDROID__)
+#	define BENCHMARK_PARTICLES_PER_ATTRACTOR 48 * 1024
+#else
+// Stress test compute throughput with more than a million particles
+#	define BENCHMARK_PARTICLES_PER_ATTRACTOR 192 * 1024
+#endif
+
 class ComputeNBody : public ApiVulkanSample
 {
   public:
+	enum class SimulationMode : int32_t
+	{
+		Automatic,
+		AllPairs,
+		SpatialGrid
+	};
+
+	// Above this particle count the automatic mode switches from all pairs to the spatial grid
+	static constexpr uint32_t spatial_grid_particle_threshold = 64 * 1024;
+
+	// Number of fine cells of the spatial grid along each axis, and of fine cells along each axis of a coarse cell
+	static constexpr uint32_t grid_dimension  = 64;
+	static constexpr uint32_t grid_brick_size = 4;
+
+	// Must match the workgroup size and items per invocation of particle_grid_scan.comp
+	static constexpr uint32_t scan_block_size = 128 * 16;
+
 	uint32_t num_particles;
-	uint32_t work_group_size  = 128;
-	uint32_t shared_data_size = 1024;
+	uint32_t particles_per_attractor = PARTICLES_PER_ATTRACTOR;
+	uint32_t work_group_size         = 128;
+	uint32_t shared_data_size        = 1024;
+
+	SimulationMode simulation_mode = SimulationMode::Automatic;
+	int32_t        particle_count_index{0};
+	bool           spatial_grid_available{false};        // The spatial grid shaders are only available in GLSL
 
 	struct
 	{
@@ -75,11 +105,18 @@ class ComputeNBody : public ApiVulkanSample
 		VkPipelineLayout                   pipeline_layout;              // Layout of the compute pipeline
 		VkPipeline                         pipeline_calculate;           // Compute pipeline for N-Body velocity calculation (1st pass)
 		VkPipeline                         pipeline_integrate;           // Compute pipeline for euler integration (2nd pass)
+		VkPipeline                         pipeline_grid_count;          // Spatial grid: Counts the particles of each cell
+		VkPipeline                         pipeline_grid_scan[3];        // Spatial grid: Prefix sum of the cell counts, one pipeline per scan pass
+		VkPipeline                         pipeline_grid_scatter;        // Spatial grid: Sorts the particles by cell
+		VkPipeline                         pipeline_grid_aggregate;      // Spatial grid: Center of mass of the fine and coarse cells
+		VkPipeline                         pipeline_grid_calculate;      // Spatial grid: N-Body velocity calculation
 		VkPipeline                         blur;
 		VkPipelineLayout                   pipeline_layout_blur;
 		VkDescriptorSetLayout              descriptor_set_layout_blur;
 		VkDescriptorSet                    descriptor_set_blur;
 		uint32_t                           queue_family_index;
+		VkQueryPool                        query_pool{VK_NULL_HANDLE};   // Timestamps of the start and end of the compute commands
+		bool                               results_pending{false};       // Whether a submission wrote results that were not read yet
 		struct ComputeUBO
 		{                              // Compute shader uniform block object
 			float   delta_time;        //		Frame delta time
@@ -87,6 +124,38 @@ class ComputeNBody : public ApiVulkanSample
 		} ubo;
 	} compute;
 
+	// Buffers of the spatial grid, only used by the compute queue
+	struct
+	{
+		std::unique_ptr<vkb::core::Buffer> cell_counts;             // Particle count of each fine cell
+		std::unique_ptr<vkb::core::Buffer> cell_starts;             // Index of the first sorted particle of each fine cell
+		std::unique_ptr<vkb::core::Buffer> block_sums;              // Totals of the blocks of the prefix sum
+		std::unique_ptr<vkb::core::Buffer> particle_cells;          // Cell of each particle and its slot in the cell
+		std::unique_ptr<vkb::core::Buffer> sorted_positions;        // Particle positions sorted by cell
+		std::unique_ptr<vkb::core::Buffer> sorted_indices;          // Particle indices sorted by cell
+		std::unique_ptr<vkb::core::Buffer> cell_masses;             // Center of mass of the fine cells, then of the coarse cells
+		std::unique_ptr<vkb::core::Buffer> interactions;            // Interactions computed by each workgroup, read back by the host
+	} grid;
+
+	// Push constants of the spatial grid passes
+	struct GridParameters
+	{
+		glm::vec3 origin;
+		float     cell_size;
+		uint32_t  level;
+	};
+
+	// Throughput of the simulation, measured with timestamps around the compute commands
+	struct
+	{
+		double   step_time{0.0};                     // GPU time of the last step in seconds
+		uint64_t interactions{0};                    // Particle interactions of the last step
+		double   interactions_per_second{0.0};
+		double   accumulated_time{0.0};              // Totals since the last benchmark report
+		uint64_t accumulated_interactions{0};
+		uint32_t accumulated_steps{0};
+	} statistics;
+
 	// SSBO particle declaration
 	struct Particle
 	{
@@ -101,6 +170,12 @@ class ComputeNBody : public ApiVulkanSample
 	void         build_command_buffers() override;
 	void         build_compute_command_buffer();
 	void         prepare_storage_buffers();
+	void         prepare_grid_buffers();
+	void         transfer_storage_buffer_ownership();
+	void         update_compute_descriptor_set();
+	void         read_compute_results();
+	void         reset_particles();
+	bool         use_spatial_grid() const;
 	void         setup_descriptor_pool();
 	void         setup_descriptor_set_layout();
 	void         setup_descriptor_set();
@@ -114,6 +189,7 @@ class ComputeNBody : public ApiVulkanSample
 	bool         prepare(const vkb::ApplicationOptions &options) override;
 	virtual void render(float delta_time) override;
 	virtual bool resize(const uint32_t width, const uint32_t height) override;
+	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
 };
 
 std::unique_ptr<vkb::Application> create_compute_nbody();
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -39,11 +39,6 @@ DynamicUniformBuffers ::~DynamicUniformBuffers()
 {
 	if (has_device())
 	{
-		if (ubo_data_dynamic.model)
-		{
-			aligned_free(ubo_data_dynamic.model);
-		}
-
 		// Clean up used Vulkan resources
 		// Note : Inherited destructor cleans up resources stored in base class
 		vkDestroyPipeline(get_device().get_handle(), pipeline, nullptr);
@@ -53,32 +48,6 @@ DynamicUniformBuffers ::~DynamicUniformBuffers()
 	}
 }
 
-// Wrapper functions for aligned memory allocation
-// There is currently no standard for this in C++ that works across all platforms and vendors, so we abstract this
-void *DynamicUniformBuffers::aligned_alloc(size_t size, size_t alignment)
-{
-	void *data = nullptr;
-#if defined(_MSC_VER) || defined(__MINGW32__)
-	data = _aligned_malloc(size, alignment);
-#else
-	int res = posix_memalign(&data, alignment, size);
-	if (res != 0)
-	{
-		data = nullptr;
-	}
-#endif
-	return data;
-}
-
-void DynamicUniformBuffers::aligned_free(void *data)
-{
-#if defined(_MSC_VER) || defined(__MINGW32__)
-	_aligned_free(data);
-#else
-	free(data);
-#endif
-}
-
 void DynamicUniformBuffers::build_command_buffers()
 {
 	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
@@ -120,7 +89,7 @@ void DynamicUniformBuffers::build_command_buffers()
 		for (uint32_t j = 0; j < OBJECT_INSTANCES; j++)
 		{
 			// One dynamic offset per dynamic descriptor to offset into the ubo containing all model matrices
-			uint32_t dynamic_offset = j * static_cast<uint32_t>(dynamic_alignment);
+			uint32_t dynamic_offset = dynamic_allocation.get_dynamic_offset(j);
 			// Bind the descriptor set for rendering a mesh using the dynamic offset
 			vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_set, 1, &dynamic_offset);
 
@@ -276,8 +245,8 @@ void DynamicUniformBuffers::setup_descriptor_set()
 
 	VkDescriptorBufferInfo view_buffer_descriptor = create_descriptor(*uniform_buffers.view);
 
-	// Pass the  actual dynamic alignment as the descriptor's size
-	VkDescriptorBufferInfo dynamic_buffer_descriptor = create_descriptor(*uniform_buffers.dynamic, dynamic_alignment);
+	// Pass the actual dynamic alignment as the descriptor's size
+	VkDescriptorBufferInfo dynamic_buffer_descriptor{dynamic_allocation.get_buffer().get_handle(), dynamic_allocation.get_offset(), dynamic_allocation.get_element_stride()};
 
 	std::vector<VkWriteDescriptorSet> write_descriptor_sets = {
 	    // Binding 0 : Projection/View matrix uniform buffer
@@ -381,25 +350,6 @@ void DynamicUniformBuffers::prepare_pipelines()
 // Prepare and initialize uniform buffer containing shader uniforms
 void DynamicUniformBuffers::prepare_uniform_buffers()
 {
-	// Allocate data for the dynamic uniform buffer object
-	// We allocate this manually as the alignment of the offset differs between GPUs
-
-	// Calculate required alignment based on minimum device offset alignment
-	size_t min_ubo_alignment = static_cast<size_t>(get_device().get_gpu().get_properties().limits.minUniformBufferOffsetAlignment);
-	dynamic_alignment        = sizeof(glm::mat4);
-	if (min_ubo_alignment > 0)
-	{
-		dynamic_alignment = (dynamic_alignment + min_ubo_alignment - 1) & ~(min_ubo_alignment - 1);
-	}
-
-	size_t buffer_size = OBJECT_INSTANCES * dynamic_alignment;
-
-	ubo_data_dynamic.model = static_cast<glm::mat4 *>(aligned_alloc(buffer_size, dynamic_alignment));
-	assert(ubo_data_dynamic.model);
-
-	std::cout << "minUniformBufferOffsetAlignment = " << min_ubo_alignment << std::endl;
-	std::cout << "dynamicAlignment = " << dynamic_alignment << std::endl;
-
 	// Vertex shader uniform buffer block
 
 	// Static shared uniform buffer object with projection and view matrix
@@ -408,10 +358,16 @@ void DynamicUniformBuffers::prepare_uniform_buffers()
 	                                                           VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
 	                                                           VMA_MEMORY_USAGE_CPU_TO_GPU);
 
-	uniform_buffers.dynamic = std::make_unique<vkb::core::Buffer>(get_device(),
-	                                                              buffer_size,
-	                                                              VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-	                                                              VMA_MEMORY_USAGE_CPU_TO_GPU);
+	// Dynamic uniform buffer with one model matrix per object
+	// The pool rounds the size of each matrix up to minUniformBufferOffsetAlignment, its blocks are sized to the allocation
+	dynamic_buffer_pool = std::make_unique<vkb::BufferPool>(get_device(), 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+	dynamic_allocation  = dynamic_buffer_pool->allocate_array(sizeof(glm::mat4), OBJECT_INSTANCES);
+	assert(!dynamic_allocation.empty());
+
+	model_matrices.resize(OBJECT_INSTANCES);
+
+	std::cout << "minUniformBufferOffsetAlignment = " << get_device().get_gpu().get_properties().limits.minUniformBufferOffsetAlignment << std::endl;
+	std::cout << "dynamicAlignment = " << dynamic_allocation.get_element_stride() << std::endl;
 
 	// Prepare per-object matrices with offsets and random rotations
 	std::default_random_engine      rnd_engine(lock_simulation_speed ? 0 : static_cast<unsigned>(time(nullptr)));
@@ -460,8 +416,7 @@ void DynamicUniformBuffers::update_dynamic_uniform_buffer(float delta_time, bool
 				auto fz    = static_cast<float>(z);
 				auto index = x * dim * dim + y * dim + z;
 
-				// Aligned offset
-				auto model_mat = (glm::mat4 *) (((uint64_t) ubo_data_dynamic.model + (index * dynamic_alignment)));
+				auto model_mat = &model_matrices[index];
 
 				// Update rotations
 				rotations[index] += animation_timer * rotation_speeds[index];
@@ -480,10 +435,8 @@ void DynamicUniformBuffers::update_dynamic_uniform_buffer(float delta_time, bool
 
 	animation_timer = 0.0f;
 
-	uniform_buffers.dynamic->update(ubo_data_dynamic.model, static_cast<size_t>(uniform_buffers.dynamic->get_size()));
-
-	// Flush to make changes visible to the device
-	uniform_buffers.dynamic->flush();
+	// Copy all matrices to their aligned offsets, this also flushes to make the changes visible to the device
+	dynamic_allocation.update_elements(model_matrices);
 }
 
 bool DynamicUniformBuffers::prepare(const vkb::ApplicationOptions &options)
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -29,15 +29,12 @@
 #pragma once
 
 #include "api_vulkan_sample.h"
+#include "buffer_pool.h"
 
 #define OBJECT_INSTANCES 125
 
 class DynamicUniformBuffers : public ApiVulkanSample
 {
-  private:
-	void *aligned_alloc(size_t size, size_t alignment);
-	void  aligned_free(void *data);
-
   public:
 	struct Vertex
 	{
@@ -52,7 +49,6 @@ class DynamicUniformBuffers : public ApiVulkanSample
 	struct UniformBuffers
 	{
 		std::unique_ptr<vkb::core::Buffer> view;
-		std::unique_ptr<vkb::core::Buffer> dynamic;
 	} uniform_buffers;
 
 	struct UboVS
@@ -65,12 +61,13 @@ class DynamicUniformBuffers : public ApiVulkanSample
 	glm::vec3 rotations[OBJECT_INSTANCES];
 	glm::vec3 rotation_speeds[OBJECT_INSTANCES];
 
+	// Tightly packed per-object matrices, written to the dynamic uniform buffer in one go
+	std::vector<glm::mat4> model_matrices;
+
 	// One big uniform buffer that contains all matrices
-	// Note that we need to manually allocate the data to cope for GPU-specific uniform buffer offset alignments
-	struct UboDataDynamic
-	{
-		glm::mat4 *model = nullptr;
-	} ubo_data_dynamic;
+	// The pool places each matrix at an offset matching the GPU-specific uniform buffer offset alignment
+	std::unique_ptr<vkb::BufferPool> dynamic_buffer_pool;
+	vkb::BufferAllocation            dynamic_allocation;
 
 	VkPipeline            pipeline;
 	VkPipelineLayout      pipeline_layout;
@@ -79,8 +76,6 @@ class DynamicUniformBuffers : public ApiVulkanSample
 
 	float animation_timer = 0.0f;
 
-	size_t dynamic_alignment = 0;
-
 	DynamicUniformBuffers();
 	~DynamicUniformBuffers();
 	void         build_command_buffers() override;
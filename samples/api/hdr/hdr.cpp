@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -26,12 +26,22 @@
 HDR::HDR()
 {
 	title = "High dynamic range rendering";
+
+	// The compute post-processing reduces the luminance histogram with subgroup operations from Vulkan 1.1
+	set_api_version(VK_API_VERSION_1_1);
 }
 
 HDR::~HDR()
 {
 	if (has_device())
 	{
+		postprocessing.reset();
+
+		if (statistics.query_pool != VK_NULL_HANDLE)
+		{
+			vkDestroyQueryPool(get_device().get_handle(), statistics.query_pool, nullptr);
+		}
+
 		vkDestroyPipeline(get_device().get_handle(), pipelines.skybox, nullptr);
 		vkDestroyPipeline(get_device().get_handle(), pipelines.reflect, nullptr);
 		vkDestroyPipeline(get_device().get_handle(), pipelines.composition, nullptr);
@@ -139,10 +149,23 @@ void HDR::build_command_buffers()
 			vkCmdEndRenderPass(draw_cmd_buffers[i]);
 		}
 
+		// The post-processing is measured from the end of the scene to the start of the UI
+		if (statistics.query_pool != VK_NULL_HANDLE)
+		{
+			vkCmdResetQueryPool(draw_cmd_buffers[i], statistics.query_pool, 0, 2);
+			vkCmdWriteTimestamp(draw_cmd_buffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, statistics.query_pool, 0);
+		}
+
+		// Compute post-processing: histogram, exposure and bloom chain, tonemapped in the final pass
+		if (compute_postprocessing)
+		{
+			postprocessing->process(draw_cmd_buffers[i]);
+		}
+
 		/*
 		    Second render pass: First bloom pass
 		*/
-		if (bloom)
+		if (bloom && !compute_postprocessing)
 		{
 			VkClearValue clear_values[2];
 			clear_values[0].color        = {{0.0f, 0.0f, 0.0f, 0.0f}};
@@ -202,17 +225,29 @@ void HDR::build_command_buffers()
 			VkRect2D scissor = vkb::initializers::rect2D(width, height, 0, 0);
 			vkCmdSetScissor(draw_cmd_buffers[i], 0, 1, &scissor);
 
-			vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.composition, 0, 1, &descriptor_sets.composition, 0, NULL);
+			if (compute_postprocessing)
+			{
+				postprocessing->draw(draw_cmd_buffers[i]);
+			}
+			else
+			{
+				vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.composition, 0, 1, &descriptor_sets.composition, 0, NULL);
+
+				// Scene
+				vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.composition);
+				vkCmdDraw(draw_cmd_buffers[i], 3, 1, 0, 0);
 
-			// Scene
-			vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.composition);
-			vkCmdDraw(draw_cmd_buffers[i], 3, 1, 0, 0);
+				// Bloom
+				if (bloom)
+				{
+					vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.bloom[0]);
+					vkCmdDraw(draw_cmd_buffers[i], 3, 1, 0, 0);
+				}
+			}
 
-			// Bloom
-			if (bloom)
+			if (statistics.query_pool != VK_NULL_HANDLE)
 			{
-				vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.bloom[0]);
-				vkCmdDraw(draw_cmd_buffers[i], 3, 1, 0, 0);
+				vkCmdWriteTimestamp(draw_cmd_buffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, statistics.query_pool, 1);
 			}
 
 			draw_ui(draw_cmd_buffers[i]);
@@ -368,12 +403,12 @@ void HDR::prepare_offscreen_buffer()
 
 		dependencies[1].srcSubpass      = 0;
 		dependencies[1].dstSubpass      = VK_SUBPASS_EXTERNAL;
-		dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+		dependencies[1].dependencyFlags = 0;
 		// End of write to attachment
 		dependencies[1].srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-		// Attachment later read using sampler in 'composition' pipeline
-		dependencies[1].dstStageMask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		// Attachment later read using sampler in 'composition' pipeline, or in the compute post-processing
+		dependencies[1].dstStageMask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 		dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
 		VkRenderPassCreateInfo render_pass_create_info = {};
@@ -883,6 +918,22 @@ void HDR::draw()
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
 	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
 	ApiVulkanSample::submit_frame();
+
+	read_statistics();
+}
+
+void HDR::read_statistics()
+{
+	// The queue is idle after the submission, the results of the frame are available
+	if (statistics.query_pool != VK_NULL_HANDLE)
+	{
+		std::array<uint64_t, 2> timestamps{};
+		if (vkGetQueryPoolResults(get_device().get_handle(), statistics.query_pool, 0, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			float time = static_cast<float>(timestamps[1] - timestamps[0]) * get_device().get_gpu().get_properties().limits.timestampPeriod / 1000000.0f;
+			(compute_postprocessing ? statistics.compute_time : statistics.fragment_time) = time;
+		}
+	}
 }
 
 bool HDR::prepare(const vkb::ApplicationOptions &options)
@@ -899,6 +950,19 @@ bool HDR::prepare(const vkb::ApplicationOptions &options)
 	// Note: Using reversed depth-buffer for increased precision, so Znear and Zfar are flipped
 	camera.set_perspective(60.0f, static_cast<float>(width) / static_cast<float>(height), 256.0f, 0.1f);
 
+	// The compute post-processing shaders are GLSL only
+	compute_postprocessing_available = get_shading_language() == vkb::ShadingLanguage::GLSL;
+
+	// Timestamps around the post-processing measure the GPU time of each mode, if the graphics queue supports them
+	if (get_device().get_gpu().get_properties().limits.timestampPeriod > 0.0f &&
+	    get_device().get_gpu().get_queue_family_properties()[get_device().get_queue_family_index(VK_QUEUE_GRAPHICS_BIT)].timestampValidBits > 0)
+	{
+		VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+		query_pool_info.queryCount = 2;
+		VK_CHECK(vkCreateQueryPool(get_device().get_handle(), &query_pool_info, nullptr, &statistics.query_pool));
+	}
+
 	load_assets();
 	prepare_uniform_buffers();
 	prepare_offscreen_buffer();
@@ -906,6 +970,12 @@ bool HDR::prepare(const vkb::ApplicationOptions &options)
 	prepare_pipelines();
 	setup_descriptor_pool();
 	setup_descriptor_sets();
+	if (compute_postprocessing_available)
+	{
+		postprocessing = std::make_unique<vkb::HDRPostProcessing>(get_device(), VK_API_VERSION_1_1);
+		postprocessing->set_input(offscreen.color[0].view, {static_cast<uint32_t>(offscreen.width), static_cast<uint32_t>(offscreen.height)});
+		postprocessing->set_render_pass(render_pass);
+	}
 	build_command_buffers();
 	prepared = true;
 	return true;
@@ -917,6 +987,10 @@ void HDR::render(float delta_time)
 	{
 		return;
 	}
+	if (compute_postprocessing)
+	{
+		postprocessing->update(delta_time);
+	}
 	draw();
 	if (camera.updated)
 	{
@@ -933,19 +1007,54 @@ void HDR::on_update_ui_overlay(vkb::Drawer &drawer)
 			update_uniform_buffers();
 			rebuild_command_buffers();
 		}
-		if (drawer.input_float("Exposure", &ubo_params.exposure, 0.025f, "%.3f"))
+		if (compute_postprocessing_available && drawer.checkbox("Compute post-processing", &compute_postprocessing))
 		{
+			ubo_params.hdr_output = compute_postprocessing ? 1 : 0;
 			update_params();
+			rebuild_command_buffers();
 		}
-		if (drawer.checkbox("Bloom", &bloom))
+		if (compute_postprocessing)
 		{
-			rebuild_command_buffers();
+			auto &settings = postprocessing->get_settings();
+			drawer.checkbox("Auto exposure", &settings.auto_exposure);
+			drawer.input_float(settings.auto_exposure ? "Exposure bias" : "Exposure", &settings.exposure, 0.025f, "%.3f");
+			drawer.checkbox("Bloom", &settings.bloom);
+		}
+		else
+		{
+			if (drawer.input_float("Exposure", &ubo_params.exposure, 0.025f, "%.3f"))
+			{
+				update_params();
+			}
+			if (drawer.checkbox("Bloom", &bloom))
+			{
+				rebuild_command_buffers();
+			}
 		}
 		if (drawer.checkbox("Skybox", &display_skybox))
 		{
 			rebuild_command_buffers();
 		}
 	}
+
+	if (drawer.header("Statistics"))
+	{
+		if (compute_postprocessing)
+		{
+			drawer.text("Average luminance: %.3f", postprocessing->get_average_luminance());
+			drawer.text("Exposure: %.3f", postprocessing->get_exposure());
+			drawer.text("Histogram reduction: %s", postprocessing->uses_subgroup_reduction() ? "subgroup" : "shared memory");
+		}
+		// The time of the other mode is the last one measured
+		if (statistics.query_pool != VK_NULL_HANDLE)
+		{
+			drawer.text("Fragment post-processing: %.2f ms", statistics.fragment_time);
+			if (compute_postprocessing_available)
+			{
+				drawer.text("Compute post-processing: %.2f ms", statistics.compute_time);
+			}
+		}
+	}
 }
 
 bool HDR::resize(const uint32_t width, const uint32_t height)
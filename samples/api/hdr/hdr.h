@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "api_vulkan_sample.h"
+#include "rendering/hdr_postprocessing.h"
 
 class HDR : public ApiVulkanSample
 {
@@ -29,6 +30,10 @@ class HDR : public ApiVulkanSample
 	bool bloom          = true;
 	bool display_skybox = true;
 
+	// Tonemapping, auto exposure and bloom in compute passes, instead of the fragment passes of the sample
+	bool compute_postprocessing           = false;
+	bool compute_postprocessing_available = false;
+
 	struct
 	{
 		Texture envmap;
@@ -59,9 +64,20 @@ class HDR : public ApiVulkanSample
 
 	struct UBOParams
 	{
-		float exposure = 1.0f;
+		float    exposure   = 1.0f;
+		uint32_t hdr_output = 0;        // Whether the scene is written without exposure nor bright pass, for the compute post-processing
 	} ubo_params;
 
+	std::unique_ptr<vkb::HDRPostProcessing> postprocessing;
+
+	// GPU time of the post-processing in each mode, measured with timestamps
+	struct
+	{
+		VkQueryPool query_pool{VK_NULL_HANDLE};
+		float       fragment_time{0.0f};        // In milliseconds, 0 until measured
+		float       compute_time{0.0f};
+	} statistics;
+
 	struct
 	{
 		VkPipeline skybox;
@@ -142,6 +158,7 @@ class HDR : public ApiVulkanSample
 	void         update_uniform_buffers();
 	void         update_params();
 	void         draw();
+	void         read_statistics();
 	bool         prepare(const vkb::ApplicationOptions &options) override;
 	virtual void render(float delta_time) override;
 	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
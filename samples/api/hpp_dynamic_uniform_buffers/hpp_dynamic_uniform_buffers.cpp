@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2024, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2021-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -40,11 +40,6 @@ HPPDynamicUniformBuffers ::~HPPDynamicUniformBuffers()
 {
 	if (has_device() && get_device().get_handle())
 	{
-		if (ubo_data_dynamic.model)
-		{
-			aligned_free(ubo_data_dynamic.model);
-		}
-
 		vk::Device device = get_device().get_handle();
 
 		// Clean up used Vulkan resources
@@ -55,32 +50,6 @@ HPPDynamicUniformBuffers ::~HPPDynamicUniformBuffers()
 	}
 }
 
-// Wrapper functions for aligned memory allocation
-// There is currently no standard for this in C++ that works across all platforms and vendors, so we abstract this
-void *HPPDynamicUniformBuffers::aligned_alloc(size_t size, size_t alignment)
-{
-	void *data = nullptr;
-#if defined(_MSC_VER) || defined(__MINGW32__)
-	data = _aligned_malloc(size, alignment);
-#else
-	int res = posix_memalign(&data, alignment, size);
-	if (res != 0)
-	{
-		data = nullptr;
-	}
-#endif
-	return data;
-}
-
-void HPPDynamicUniformBuffers::aligned_free(void *data)
-{
-#if defined(_MSC_VER) || defined(__MINGW32__)
-	_aligned_free(data);
-#else
-	free(data);
-#endif
-}
-
 bool HPPDynamicUniformBuffers::prepare(const vkb::ApplicationOptions &options)
 {
 	assert(!prepared);
@@ -136,7 +105,7 @@ void HPPDynamicUniformBuffers::build_command_buffers()
 		for (uint32_t j = 0; j < OBJECT_INSTANCES; j++)
 		{
 			// One dynamic offset per dynamic descriptor to offset into the ubo containing all model matrices
-			uint32_t dynamic_offset = j * static_cast<uint32_t>(dynamic_alignment);
+			uint32_t dynamic_offset = dynamic_allocation.get_dynamic_offset(j);
 
 			// Bind the descriptor set for rendering a mesh using the dynamic offset
 			command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0, descriptor_set, dynamic_offset);
@@ -280,33 +249,22 @@ void HPPDynamicUniformBuffers::prepare_camera()
 // Prepare and initialize uniform buffer containing shader uniforms
 void HPPDynamicUniformBuffers::prepare_uniform_buffers()
 {
-	// Allocate data for the dynamic uniform buffer object
-	// We allocate this manually as the alignment of the offset differs between GPUs
-
-	// Calculate required alignment based on minimum device offset alignment
-	vk::DeviceSize min_ubo_alignment = get_device().get_gpu().get_handle().getProperties().limits.minUniformBufferOffsetAlignment;
-	dynamic_alignment                = sizeof(glm::mat4);
-	if (min_ubo_alignment > 0)
-	{
-		dynamic_alignment = (dynamic_alignment + min_ubo_alignment - 1) & ~(min_ubo_alignment - 1);
-	}
-
-	size_t buffer_size = OBJECT_INSTANCES * dynamic_alignment;
-
-	ubo_data_dynamic.model = static_cast<glm::mat4 *>(aligned_alloc(buffer_size, dynamic_alignment));
-	assert(ubo_data_dynamic.model);
-
-	std::cout << "minUniformBufferOffsetAlignment = " << min_ubo_alignment << std::endl;
-	std::cout << "dynamicAlignment = " << dynamic_alignment << std::endl;
-
 	// Vertex shader uniform buffer block
 
 	// Static shared uniform buffer object with projection and view matrix
 	uniform_buffers.view =
 	    std::make_unique<vkb::core::HPPBuffer>(get_device(), sizeof(ubo_vs), vk::BufferUsageFlagBits::eUniformBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU);
 
-	uniform_buffers.dynamic =
-	    std::make_unique<vkb::core::HPPBuffer>(get_device(), buffer_size, vk::BufferUsageFlagBits::eUniformBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	// Dynamic uniform buffer with one model matrix per object
+	// The pool rounds the size of each matrix up to minUniformBufferOffsetAlignment, its blocks are sized to the allocation
+	dynamic_buffer_pool = std::make_unique<vkb::HPPBufferPool>(get_device(), 0, vk::BufferUsageFlagBits::eUniformBuffer);
+	dynamic_allocation  = dynamic_buffer_pool->allocate_array(sizeof(glm::mat4), OBJECT_INSTANCES);
+	assert(dynamic_allocation.get_element_count() == OBJECT_INSTANCES);
+
+	model_matrices.resize(OBJECT_INSTANCES);
+
+	std::cout << "minUniformBufferOffsetAlignment = " << get_device().get_gpu().get_handle().getProperties().limits.minUniformBufferOffsetAlignment << std::endl;
+	std::cout << "dynamicAlignment = " << dynamic_allocation.get_element_stride() << std::endl;
 
 	// Prepare per-object matrices with offsets and random rotations
 	std::default_random_engine      rnd_engine(lock_simulation_speed ? 0 : static_cast<unsigned>(time(nullptr)));
@@ -324,7 +282,7 @@ void HPPDynamicUniformBuffers::prepare_uniform_buffers()
 void HPPDynamicUniformBuffers::update_descriptor_set()
 {
 	vk::DescriptorBufferInfo view_buffer_descriptor(uniform_buffers.view->get_handle(), 0, VK_WHOLE_SIZE);
-	vk::DescriptorBufferInfo dynamic_buffer_descriptor(uniform_buffers.dynamic->get_handle(), 0, dynamic_alignment);
+	vk::DescriptorBufferInfo dynamic_buffer_descriptor(dynamic_allocation.get_buffer().get_handle(), dynamic_allocation.get_offset(), dynamic_allocation.get_element_stride());
 
 	std::array<vk::WriteDescriptorSet, 2> write_descriptor_sets = {
 	    {// Binding 0 : Projection/View matrix uniform buffer
@@ -360,8 +318,7 @@ void HPPDynamicUniformBuffers::update_dynamic_uniform_buffer(float delta_time, b
 				auto fz    = static_cast<float>(z);
 				auto index = x * dim * dim + y * dim + z;
 
-				// Aligned offset
-				auto model_mat = (glm::mat4 *) (((uint64_t) ubo_data_dynamic.model + (index * dynamic_alignment)));
+				auto model_mat = &model_matrices[index];
 
 				// Update rotations
 				rotations[index] += animation_timer * rotation_speeds[index];
@@ -380,10 +337,8 @@ void HPPDynamicUniformBuffers::update_dynamic_uniform_buffer(float delta_time, b
 
 	animation_timer = 0.0f;
 
-	uniform_buffers.dynamic->update(ubo_data_dynamic.model, static_cast<size_t>(uniform_buffers.dynamic->get_size()));
-
-	// Flush to make changes visible to the device
-	uniform_buffers.dynamic->flush();
+	// Copy all matrices to their aligned offsets, this also flushes to make the changes visible to the device
+	dynamic_allocation.update_elements(model_matrices);
 }
 
 void HPPDynamicUniformBuffers::update_uniform_buffers()
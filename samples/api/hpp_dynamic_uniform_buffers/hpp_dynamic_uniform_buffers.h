@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2021-2026, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -30,6 +30,7 @@
 
 #include <core/hpp_buffer.h>
 #include <hpp_api_vulkan_sample.h>
+#include <hpp_buffer_pool.h>
 
 #define OBJECT_INSTANCES 125
 
@@ -40,13 +41,6 @@ class HPPDynamicUniformBuffers : public HPPApiVulkanSample
 	~HPPDynamicUniformBuffers();
 
   private:
-	// One big uniform buffer that contains all matrices
-	// Note that we need to manually allocate the data to cope for GPU-specific uniform buffer offset alignments
-	struct UboDataDynamic
-	{
-		glm::mat4 *model = nullptr;
-	};
-
 	struct UboVS
 	{
 		glm::mat4 projection;
@@ -56,7 +50,6 @@ class HPPDynamicUniformBuffers : public HPPApiVulkanSample
 	struct UniformBuffers
 	{
 		std::unique_ptr<vkb::core::HPPBuffer> view;
-		std::unique_ptr<vkb::core::HPPBuffer> dynamic;
 	};
 
 	struct Vertex
@@ -65,10 +58,6 @@ class HPPDynamicUniformBuffers : public HPPApiVulkanSample
 		float color[3];
 	};
 
-  private:
-	static void *aligned_alloc(size_t size, size_t alignment);
-	static void  aligned_free(void *data);
-
   private:
 	// from vkb::Application
 	bool prepare(const vkb::ApplicationOptions &options) override;
@@ -93,14 +82,15 @@ class HPPDynamicUniformBuffers : public HPPApiVulkanSample
 	float                                 animation_timer = 0.0f;
 	vk::DescriptorSet                     descriptor_set;
 	vk::DescriptorSetLayout               descriptor_set_layout;
-	size_t                                dynamic_alignment = 0;
+	vkb::HPPBufferAllocation              dynamic_allocation;         // One big uniform buffer that contains all matrices, each at an aligned offset
+	std::unique_ptr<vkb::HPPBufferPool>   dynamic_buffer_pool;        // Copes with the GPU-specific uniform buffer offset alignment
 	std::unique_ptr<vkb::core::HPPBuffer> index_buffer;
 	uint32_t                              index_count = 0;
+	std::vector<glm::mat4>                model_matrices;        // Tightly packed per-object matrices, copied to the dynamic allocation in one go
 	vk::Pipeline                          pipeline;
 	vk::PipelineLayout                    pipeline_layout;
 	glm::vec3                             rotations[OBJECT_INSTANCES];        // Store random per-object rotations
 	glm::vec3                             rotation_speeds[OBJECT_INSTANCES];
-	UboDataDynamic                        ubo_data_dynamic;
 	UboVS                                 ubo_vs;
 	UniformBuffers                        uniform_buffers;
 	std::unique_ptr<vkb::core::HPPBuffer> vertex_buffer;
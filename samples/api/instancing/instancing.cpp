@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,16 +16,31 @@
  */
 
 /*
- * Instanced mesh rendering, uses a separate vertex buffer for instanced data
+ * Instanced mesh rendering, uses a separate vertex buffer for instanced data,
+ * optionally culled on the GPU into compacted per-LOD instance buffers drawn indirectly
  */
 
 #include "instancing.h"
 
+#include <map>
+
 #include "benchmark_mode/benchmark_mode.h"
+#include "geometry/frustum.h"
+
+namespace
+{
+const std::vector<uint32_t> instance_count_options = {INSTANCE_COUNT, MAX_INSTANCE_COUNT / 16, MAX_INSTANCE_COUNT / 4, MAX_INSTANCE_COUNT};
+
+// Radius of the coarser rock meshes, close to the size of the rock model
+const float lod_mesh_radius = 0.6f;
+}        // namespace
 
 Instancing::Instancing()
 {
 	title = "Instanced mesh rendering";
+
+	// Skips the indirect draws of the LODs without visible instances
+	add_device_extension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME, /*optional=*/true);
 }
 
 Instancing::~Instancing()
@@ -37,6 +52,16 @@ Instancing::~Instancing()
 		vkDestroyPipeline(get_device().get_handle(), pipelines.starfield, nullptr);
 		vkDestroyPipelineLayout(get_device().get_handle(), pipeline_layout, nullptr);
 		vkDestroyDescriptorSetLayout(get_device().get_handle(), descriptor_set_layout, nullptr);
+		if (culling.pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(get_device().get_handle(), culling.pipeline, nullptr);
+			vkDestroyPipelineLayout(get_device().get_handle(), culling.pipeline_layout, nullptr);
+			vkDestroyDescriptorSetLayout(get_device().get_handle(), culling.descriptor_set_layout, nullptr);
+		}
+		if (statistics.query_pool != VK_NULL_HANDLE)
+		{
+			vkDestroyQueryPool(get_device().get_handle(), statistics.query_pool, nullptr);
+		}
 		vkDestroySampler(get_device().get_handle(), textures.rocks.sampler, nullptr);
 		vkDestroySampler(get_device().get_handle(), textures.planet.sampler, nullptr);
 	}
@@ -64,6 +89,11 @@ void Instancing::request_gpu_features(vkb::PhysicalDevice &gpu)
 	{
 		requested_features.textureCompressionETC2 = VK_TRUE;
 	}
+	// The indirect draws of the LODs start at their own slots of the visible instance buffer
+	if (gpu.get_features().drawIndirectFirstInstance)
+	{
+		requested_features.drawIndirectFirstInstance = VK_TRUE;
+	}
 };
 
 void Instancing::build_command_buffers()
@@ -88,6 +118,18 @@ void Instancing::build_command_buffers()
 
 		VK_CHECK(vkBeginCommandBuffer(draw_cmd_buffers[i], &command_buffer_begin_info));
 
+		// Timestamps around the scene compare the GPU time of brute force and culled instancing
+		if (statistics.query_pool != VK_NULL_HANDLE)
+		{
+			vkCmdResetQueryPool(draw_cmd_buffers[i], statistics.query_pool, 0, 2);
+			vkCmdWriteTimestamp(draw_cmd_buffers[i], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, statistics.query_pool, 0);
+		}
+
+		if (gpu_culling)
+		{
+			record_culling(draw_cmd_buffers[i]);
+		}
+
 		vkCmdBeginRenderPass(draw_cmd_buffers[i], &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
 		VkViewport viewport = vkb::initializers::viewport(static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f);
@@ -113,22 +155,42 @@ void Instancing::build_command_buffers()
 		vkCmdDrawIndexed(draw_cmd_buffers[i], models.planet->vertex_indices, 1, 0, 0, 0);
 
 		// Instanced rocks
-		auto &rock_vertex_buffer = models.rock->vertex_buffers.at("vertex_buffer");
-		auto &rock_index_buffer  = models.rock->index_buffer;
 		vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.instanced_rocks, 0, NULL);
 		vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.instanced_rocks);
-		// Binding point 0 : Mesh vertex buffer
-		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, rock_vertex_buffer.get(), offsets);
-		// Binding point 1 : Instance data buffer
-		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, &instance_buffer.buffer->get_handle(), offsets);
-		vkCmdBindIndexBuffer(draw_cmd_buffers[i], rock_index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
-		// Render instances
-		vkCmdDrawIndexed(draw_cmd_buffers[i], models.rock->vertex_indices, INSTANCE_COUNT, 0, 0, 0);
+		if (gpu_culling)
+		{
+			draw_culled_rocks(draw_cmd_buffers[i]);
+		}
+		else
+		{
+			auto &rock_vertex_buffer = models.rock->vertex_buffers.at("vertex_buffer");
+			auto &rock_index_buffer  = models.rock->index_buffer;
+			// Binding point 0 : Mesh vertex buffer
+			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, rock_vertex_buffer.get(), offsets);
+			// Binding point 1 : Instance data buffer
+			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, &instance_buffer.buffer->get_handle(), offsets);
+			vkCmdBindIndexBuffer(draw_cmd_buffers[i], rock_index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
+			// Render instances
+			vkCmdDrawIndexed(draw_cmd_buffers[i], models.rock->vertex_indices, instance_count, 0, 0, 0);
+		}
+
+		if (statistics.query_pool != VK_NULL_HANDLE)
+		{
+			vkCmdWriteTimestamp(draw_cmd_buffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, statistics.query_pool, 1);
+		}
 
 		draw_ui(draw_cmd_buffers[i]);
 
 		vkCmdEndRenderPass(draw_cmd_buffers[i]);
 
+		// The visible instance counts are shown in the UI
+		if (gpu_culling)
+		{
+			VkBufferCopy copy_region = {};
+			copy_region.size         = lod_count * sizeof(VkDrawIndexedIndirectCommand);
+			vkCmdCopyBuffer(draw_cmd_buffers[i], culling.draw_commands->get_handle(), culling.readback->get_handle(), 1, &copy_region);
+		}
+
 		VK_CHECK(vkEndCommandBuffer(draw_cmd_buffers[i]));
 	}
 }
@@ -150,18 +212,19 @@ void Instancing::load_assets()
 
 void Instancing::setup_descriptor_pool()
 {
-	// Example uses one ubo
+	// Example uses one ubo for rendering, and one ubo and four storage buffers for culling
 	std::vector<VkDescriptorPoolSize> pool_sizes =
 	    {
-	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2),
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 3),
 	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2),
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4),
 	    };
 
 	VkDescriptorPoolCreateInfo descriptor_pool_create_info =
 	    vkb::initializers::descriptor_pool_create_info(
 	        vkb::to_u32(pool_sizes.size()),
 	        pool_sizes.data(),
-	        2);
+	        3);
 
 	VK_CHECK(vkCreateDescriptorPool(get_device().get_handle(), &descriptor_pool_create_info, nullptr, &descriptor_pool));
 }
@@ -362,14 +425,14 @@ void Instancing::prepare_pipelines()
 void Instancing::prepare_instance_data()
 {
 	std::vector<InstanceData> instance_data;
-	instance_data.resize(INSTANCE_COUNT);
+	instance_data.resize(instance_count);
 
 	std::default_random_engine              rnd_generator(lock_simulation_speed ? 0 : static_cast<unsigned>(time(nullptr)));
 	std::uniform_real_distribution<float>   uniform_dist(0.0, 1.0);
 	std::uniform_int_distribution<uint32_t> rnd_texture_index(0, textures.rocks.image->get_vk_image().get_array_layer_count());
 
 	// Distribute rocks randomly on two different rings
-	for (auto i = 0; i < INSTANCE_COUNT / 2; i++)
+	for (uint32_t i = 0; i < instance_count / 2; i++)
 	{
 		glm::vec2 ring0{7.0f, 11.0f};
 		glm::vec2 ring1{14.0f, 18.0f};
@@ -388,11 +451,11 @@ void Instancing::prepare_instance_data()
 		// Outer ring
 		rho                                                                 = sqrt((pow(ring1[1], 2.0f) - pow(ring1[0], 2.0f)) * uniform_dist(rnd_generator) + pow(ring1[0], 2.0f));
 		theta                                                               = 2.0f * glm::pi<float>() * uniform_dist(rnd_generator);
-		instance_data[static_cast<size_t>(i + INSTANCE_COUNT / 2)].pos      = glm::vec3(rho * cos(theta), uniform_dist(rnd_generator) * 0.5f - 0.25f, rho * sin(theta));
-		instance_data[static_cast<size_t>(i + INSTANCE_COUNT / 2)].rot      = glm::vec3(glm::pi<float>() * uniform_dist(rnd_generator), glm::pi<float>() * uniform_dist(rnd_generator), glm::pi<float>() * uniform_dist(rnd_generator));
-		instance_data[static_cast<size_t>(i + INSTANCE_COUNT / 2)].scale    = 1.5f + uniform_dist(rnd_generator) - uniform_dist(rnd_generator);
-		instance_data[static_cast<size_t>(i + INSTANCE_COUNT / 2)].texIndex = rnd_texture_index(rnd_generator);
-		instance_data[static_cast<size_t>(i + INSTANCE_COUNT / 2)].scale *= 0.75f;
+		instance_data[static_cast<size_t>(i + instance_count / 2)].pos      = glm::vec3(rho * cos(theta), uniform_dist(rnd_generator) * 0.5f - 0.25f, rho * sin(theta));
+		instance_data[static_cast<size_t>(i + instance_count / 2)].rot      = glm::vec3(glm::pi<float>() * uniform_dist(rnd_generator), glm::pi<float>() * uniform_dist(rnd_generator), glm::pi<float>() * uniform_dist(rnd_generator));
+		instance_data[static_cast<size_t>(i + instance_count / 2)].scale    = 1.5f + uniform_dist(rnd_generator) - uniform_dist(rnd_generator);
+		instance_data[static_cast<size_t>(i + instance_count / 2)].texIndex = rnd_texture_index(rnd_generator);
+		instance_data[static_cast<size_t>(i + instance_count / 2)].scale *= 0.75f;
 	}
 
 	instance_buffer.size = instance_data.size() * sizeof(InstanceData);
@@ -404,7 +467,11 @@ void Instancing::prepare_instance_data()
 
 	vkb::core::Buffer staging_buffer = vkb::core::Buffer::create_staging_buffer(get_device(), instance_data);
 
-	instance_buffer.buffer = std::make_unique<vkb::core::Buffer>(get_device(), instance_buffer.size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	// The culling pass reads the instance data as a storage buffer
+	instance_buffer.buffer = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                             instance_buffer.size,
+	                                                             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                             VMA_MEMORY_USAGE_GPU_ONLY);
 
 	// Copy to staging buffer
 	VkCommandBuffer copy_command = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
@@ -425,6 +492,255 @@ void Instancing::prepare_instance_data()
 	instance_buffer.descriptor.offset = 0;
 }
 
+void Instancing::prepare_rock_lods()
+{
+	// Icosahedron on the unit sphere, with counter-clockwise faces like the glTF models
+	const float            t         = (1.0f + sqrtf(5.0f)) / 2.0f;
+	std::vector<glm::vec3> positions = {
+	    {-1.0f, t, 0.0f}, {1.0f, t, 0.0f}, {-1.0f, -t, 0.0f}, {1.0f, -t, 0.0f}, {0.0f, -1.0f, t}, {0.0f, 1.0f, t}, {0.0f, -1.0f, -t}, {0.0f, 1.0f, -t}, {t, 0.0f, -1.0f}, {t, 0.0f, 1.0f}, {-t, 0.0f, -1.0f}, {-t, 0.0f, 1.0f}};
+	std::vector<uint32_t> indices = {
+	    0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+	    3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1};
+	for (auto &position : positions)
+	{
+		position = glm::normalize(position);
+	}
+
+	// The coarsest LOD is the icosahedron, each finer one splits its triangles in four
+	for (uint32_t lod = lod_count - 1; lod > 0; lod--)
+	{
+		if (lod < lod_count - 1)
+		{
+			std::map<std::pair<uint32_t, uint32_t>, uint32_t> midpoints;
+
+			auto get_midpoint = [&](uint32_t a, uint32_t b) {
+				auto key = std::make_pair(std::min(a, b), std::max(a, b));
+				auto it  = midpoints.find(key);
+				if (it != midpoints.end())
+				{
+					return it->second;
+				}
+				positions.push_back(glm::normalize(positions[a] + positions[b]));
+				return midpoints[key] = vkb::to_u32(positions.size() - 1);
+			};
+
+			std::vector<uint32_t> subdivided_indices;
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				uint32_t a  = indices[i];
+				uint32_t b  = indices[i + 1];
+				uint32_t c  = indices[i + 2];
+				uint32_t ab = get_midpoint(a, b);
+				uint32_t bc = get_midpoint(b, c);
+				uint32_t ca = get_midpoint(c, a);
+				subdivided_indices.insert(subdivided_indices.end(), {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca});
+			}
+			indices = std::move(subdivided_indices);
+		}
+
+		std::vector<Vertex> vertices;
+		for (auto &position : positions)
+		{
+			Vertex vertex{};
+			vertex.pos    = position * lod_mesh_radius;
+			vertex.normal = position;
+			vertex.uv     = glm::vec2(0.5f + atan2f(position.z, position.x) / (2.0f * glm::pi<float>()), 0.5f - asinf(position.y) / glm::pi<float>());
+			vertices.push_back(vertex);
+		}
+
+		vkb::core::Buffer vertex_staging_buffer = vkb::core::Buffer::create_staging_buffer(get_device(), vertices);
+		vkb::core::Buffer index_staging_buffer  = vkb::core::Buffer::create_staging_buffer(get_device(), indices);
+
+		auto mesh            = std::make_unique<vkb::sg::SubMesh>();
+		mesh->index_type     = VK_INDEX_TYPE_UINT32;
+		mesh->vertices_count = vkb::to_u32(vertices.size());
+		mesh->vertex_indices = vkb::to_u32(indices.size());
+
+		mesh->index_buffer = std::make_unique<vkb::core::Buffer>(get_device(),
+		                                                         indices.size() * sizeof(uint32_t),
+		                                                         VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                                         VMA_MEMORY_USAGE_GPU_ONLY);
+		mesh->vertex_buffers.insert(std::make_pair("vertex_buffer",
+		                                           vkb::core::Buffer(get_device(),
+		                                                             vertices.size() * sizeof(Vertex),
+		                                                             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                                             VMA_MEMORY_USAGE_GPU_ONLY)));
+
+		VkCommandBuffer copy_command = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+
+		VkBufferCopy copy_region = {};
+		copy_region.size         = vertex_staging_buffer.get_size();
+		vkCmdCopyBuffer(copy_command, vertex_staging_buffer.get_handle(), mesh->vertex_buffers.at("vertex_buffer").get_handle(), 1, &copy_region);
+		copy_region.size = index_staging_buffer.get_size();
+		vkCmdCopyBuffer(copy_command, index_staging_buffer.get_handle(), mesh->index_buffer->get_handle(), 1, &copy_region);
+
+		get_device().flush_command_buffer(copy_command, queue, true);
+
+		models.rock_lods[lod - 1] = std::move(mesh);
+	}
+}
+
+vkb::sg::SubMesh &Instancing::get_rock_lod(uint32_t lod)
+{
+	return lod == 0 ? *models.rock : *models.rock_lods[lod - 1];
+}
+
+void Instancing::prepare_culling()
+{
+	std::vector<VkDescriptorSetLayoutBinding> set_layout_bindings =
+	    {
+	        // Binding 0 : Culling uniform buffer
+	        vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 0),
+	        // Binding 1 : All instances
+	        vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1),
+	        // Binding 2 : Visible instances, compacted by LOD
+	        vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 2),
+	        // Binding 3 : Indirect draw of each LOD
+	        vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 3),
+	        // Binding 4 : Draw count of each LOD
+	        vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 4),
+	    };
+
+	VkDescriptorSetLayoutCreateInfo descriptor_layout_create_info =
+	    vkb::initializers::descriptor_set_layout_create_info(set_layout_bindings.data(), vkb::to_u32(set_layout_bindings.size()));
+	VK_CHECK(vkCreateDescriptorSetLayout(get_device().get_handle(), &descriptor_layout_create_info, nullptr, &culling.descriptor_set_layout));
+
+	VkPipelineLayoutCreateInfo pipeline_layout_create_info = vkb::initializers::pipeline_layout_create_info(&culling.descriptor_set_layout, 1);
+	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &pipeline_layout_create_info, nullptr, &culling.pipeline_layout));
+
+	VkDescriptorSetAllocateInfo descriptor_set_alloc_info = vkb::initializers::descriptor_set_allocate_info(descriptor_pool, &culling.descriptor_set_layout, 1);
+	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &descriptor_set_alloc_info, &culling.descriptor_set));
+
+	VkComputePipelineCreateInfo compute_pipeline_create_info = vkb::initializers::compute_pipeline_create_info(culling.pipeline_layout, 0);
+	compute_pipeline_create_info.stage                       = load_shader("instancing", "cull.comp", VK_SHADER_STAGE_COMPUTE_BIT);
+	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &culling.pipeline));
+
+	culling.draw_indirect_count = get_device().is_enabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+	prepare_culling_buffers();
+}
+
+void Instancing::prepare_culling_buffers()
+{
+	// Each LOD has room for all instances, its draw starts at its own slots
+	culling.visible_instances = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                                static_cast<VkDeviceSize>(instance_count) * lod_count * sizeof(InstanceData),
+	                                                                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	                                                                VMA_MEMORY_USAGE_GPU_ONLY);
+
+	culling.draw_commands = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                            lod_count * sizeof(VkDrawIndexedIndirectCommand),
+	                                                            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                            VMA_MEMORY_USAGE_GPU_ONLY);
+
+	culling.draw_counts = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                          lod_count * sizeof(uint32_t),
+	                                                          VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                          VMA_MEMORY_USAGE_GPU_ONLY);
+
+	culling.readback = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                       lod_count * sizeof(VkDrawIndexedIndirectCommand),
+	                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
+
+	// The draws start without instances, followed by the draw counts of the LODs
+	std::array<VkDrawIndexedIndirectCommand, lod_count> draw_commands{};
+	for (uint32_t lod = 0; lod < lod_count; lod++)
+	{
+		draw_commands[lod].indexCount    = get_rock_lod(lod).vertex_indices;
+		draw_commands[lod].firstInstance = lod * instance_count;
+	}
+	std::array<uint32_t, lod_count> draw_counts{};
+
+	culling.initial_draws = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                            sizeof(draw_commands) + sizeof(draw_counts),
+	                                                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	                                                            VMA_MEMORY_USAGE_CPU_TO_GPU);
+	culling.initial_draws->update(draw_commands);
+	culling.initial_draws->update(draw_counts, sizeof(draw_commands));
+
+	VkDescriptorBufferInfo uniform_descriptor           = create_descriptor(*uniform_buffers.culling);
+	VkDescriptorBufferInfo instances_descriptor         = create_descriptor(*instance_buffer.buffer);
+	VkDescriptorBufferInfo visible_instances_descriptor = create_descriptor(*culling.visible_instances);
+	VkDescriptorBufferInfo draw_commands_descriptor     = create_descriptor(*culling.draw_commands);
+	VkDescriptorBufferInfo draw_counts_descriptor       = create_descriptor(*culling.draw_counts);
+
+	std::vector<VkWriteDescriptorSet> write_descriptor_sets = {
+	    vkb::initializers::write_descriptor_set(culling.descriptor_set, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &uniform_descriptor),
+	    vkb::initializers::write_descriptor_set(culling.descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, &instances_descriptor),
+	    vkb::initializers::write_descriptor_set(culling.descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2, &visible_instances_descriptor),
+	    vkb::initializers::write_descriptor_set(culling.descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3, &draw_commands_descriptor),
+	    vkb::initializers::write_descriptor_set(culling.descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4, &draw_counts_descriptor)};
+	vkUpdateDescriptorSets(get_device().get_handle(), vkb::to_u32(write_descriptor_sets.size()), write_descriptor_sets.data(), 0, NULL);
+}
+
+void Instancing::record_culling(VkCommandBuffer command_buffer)
+{
+	// Reset the draws, the culling pass then adds the visible instances to the draw of their LOD
+	std::array<VkBufferCopy, 2> copy_regions = {{{0, 0, lod_count * sizeof(VkDrawIndexedIndirectCommand)},
+	                                             {lod_count * sizeof(VkDrawIndexedIndirectCommand), 0, lod_count * sizeof(uint32_t)}}};
+	vkCmdCopyBuffer(command_buffer, culling.initial_draws->get_handle(), culling.draw_commands->get_handle(), 1, &copy_regions[0]);
+	vkCmdCopyBuffer(command_buffer, culling.initial_draws->get_handle(), culling.draw_counts->get_handle(), 1, &copy_regions[1]);
+
+	std::array<VkBufferMemoryBarrier, 3> barriers;
+	barriers.fill(vkb::initializers::buffer_memory_barrier());
+	barriers[0].buffer = culling.draw_commands->get_handle();
+	barriers[1].buffer = culling.draw_counts->get_handle();
+	barriers[2].buffer = culling.visible_instances->get_handle();
+	for (auto &barrier : barriers)
+	{
+		barrier.size          = VK_WHOLE_SIZE;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	}
+	// Only the draws and counts were reset, the visible instances are simply overwritten
+	vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 2, barriers.data(), 0, nullptr);
+
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, culling.pipeline);
+	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, culling.pipeline_layout, 0, 1, &culling.descriptor_set, 0, nullptr);
+	vkCmdDispatch(command_buffer, (instance_count + 63) / 64, 1, 1);
+
+	// The draws read the compacted instances as vertex attributes, and the draws and counts as indirect parameters
+	for (auto &barrier : barriers)
+	{
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	}
+	barriers[0].dstAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+	barriers[2].dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+	vkCmdPipelineBarrier(command_buffer,
+	                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	                     VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                     0, 0, nullptr, vkb::to_u32(barriers.size()), barriers.data(), 0, nullptr);
+}
+
+void Instancing::draw_culled_rocks(VkCommandBuffer command_buffer)
+{
+	VkDeviceSize offsets[1] = {0};
+
+	// Binding point 1 : Visible instances, the draw of each LOD starts at its own slots
+	vkCmdBindVertexBuffers(command_buffer, 1, 1, &culling.visible_instances->get_handle(), offsets);
+
+	for (uint32_t lod = 0; lod < lod_count; lod++)
+	{
+		auto &mesh = get_rock_lod(lod);
+		// Binding point 0 : Mesh vertex buffer of the LOD
+		vkCmdBindVertexBuffers(command_buffer, 0, 1, mesh.vertex_buffers.at("vertex_buffer").get(), offsets);
+		vkCmdBindIndexBuffer(command_buffer, mesh.index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
+
+		VkDeviceSize draw_offset = lod * sizeof(VkDrawIndexedIndirectCommand);
+		if (culling.draw_indirect_count)
+		{
+			vkCmdDrawIndexedIndirectCountKHR(command_buffer, culling.draw_commands->get_handle(), draw_offset, culling.draw_counts->get_handle(), lod * sizeof(uint32_t), 1, sizeof(VkDrawIndexedIndirectCommand));
+		}
+		else
+		{
+			// Without the draw counts, the draws of the LODs without visible instances have an instance count of 0
+			vkCmdDrawIndexedIndirect(command_buffer, culling.draw_commands->get_handle(), draw_offset, 1, sizeof(VkDrawIndexedIndirectCommand));
+		}
+	}
+}
+
 void Instancing::prepare_uniform_buffers()
 {
 	uniform_buffers.scene = std::make_unique<vkb::core::Buffer>(get_device(),
@@ -432,6 +748,11 @@ void Instancing::prepare_uniform_buffers()
 	                                                            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
 	                                                            VMA_MEMORY_USAGE_CPU_TO_GPU);
 
+	uniform_buffers.culling = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                              sizeof(ubo_culling),
+	                                                              VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+	                                                              VMA_MEMORY_USAGE_CPU_TO_GPU);
+
 	update_uniform_buffer(0.0f);
 }
 
@@ -447,6 +768,68 @@ void Instancing::update_uniform_buffer(float delta_time)
 	}
 
 	uniform_buffers.scene->convert_and_update(ubo_vs);
+
+	update_culling_uniform_buffer();
+}
+
+void Instancing::update_culling_uniform_buffer()
+{
+	// The rocks are culled with the matrix they are rendered with, planes are in world space
+	vkb::Frustum frustum;
+	frustum.update(camera.matrices.perspective * camera.matrices.view);
+	std::copy(frustum.get_planes().begin(), frustum.get_planes().end(), ubo_culling.frustum_planes);
+
+	ubo_culling.camera_position = glm::inverse(camera.matrices.view)[3];
+	ubo_culling.glob_speed      = ubo_vs.glob_speed;
+	ubo_culling.instance_count  = instance_count;
+
+	uniform_buffers.culling->convert_and_update(ubo_culling);
+}
+
+void Instancing::change_instance_count()
+{
+	get_device().wait_idle();
+
+	instance_count = instance_count_options[instance_count_index];
+	prepare_instance_data();
+
+	if (gpu_culling_available)
+	{
+		prepare_culling_buffers();
+	}
+
+	// The times measured at the previous instance count are not comparable anymore
+	statistics.brute_force_time = 0.0f;
+	statistics.gpu_culling_time = 0.0f;
+	statistics.visible_instances.fill(0);
+
+	update_culling_uniform_buffer();
+	rebuild_command_buffers();
+}
+
+void Instancing::read_statistics()
+{
+	// The queue is idle after each frame, the results of the frame are available
+	if (statistics.query_pool != VK_NULL_HANDLE)
+	{
+		std::array<uint64_t, 2> timestamps{};
+		if (vkGetQueryPoolResults(get_device().get_handle(), statistics.query_pool, 0, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			float time = static_cast<float>(timestamps[1] - timestamps[0]) * get_device().get_gpu().get_properties().limits.timestampPeriod / 1000000.0f;
+			(gpu_culling ? statistics.gpu_culling_time : statistics.brute_force_time) = time;
+		}
+	}
+
+	if (gpu_culling)
+	{
+		culling.readback->invalidate();
+		auto *draw_commands = reinterpret_cast<const VkDrawIndexedIndirectCommand *>(culling.readback->map());
+		for (uint32_t lod = 0; lod < lod_count; lod++)
+		{
+			statistics.visible_instances[lod] = draw_commands[lod].instanceCount;
+		}
+		culling.readback->unmap();
+	}
 }
 
 void Instancing::draw()
@@ -461,6 +844,8 @@ void Instancing::draw()
 	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
 
 	ApiVulkanSample::submit_frame();
+
+	read_statistics();
 }
 
 bool Instancing::prepare(const vkb::ApplicationOptions &options)
@@ -476,13 +861,39 @@ bool Instancing::prepare(const vkb::ApplicationOptions &options)
 	camera.set_rotation(glm::vec3(-17.2f, -4.7f, 0.0f));
 	camera.set_translation(glm::vec3(5.5f, -1.85f, -18.5f));
 
+	// The culling shader is GLSL only, and the draw of each LOD starts at its own slots of the visible instances
+	gpu_culling_available = get_shading_language() == vkb::ShadingLanguage::GLSL && get_device().get_gpu().get_features().drawIndirectFirstInstance;
+
+	// Benchmark mode stress tests the largest instance count, culled on the GPU if possible
+	if (options.benchmark_enabled)
+	{
+		instance_count_index = static_cast<int32_t>(instance_count_options.size()) - 1;
+		instance_count       = instance_count_options[instance_count_index];
+		gpu_culling          = gpu_culling_available;
+	}
+
+	// Timestamps around the scene measure the GPU time of each mode, if the graphics queue supports them
+	if (get_device().get_gpu().get_properties().limits.timestampPeriod > 0.0f &&
+	    get_device().get_gpu().get_queue_family_properties()[get_device().get_queue_family_index(VK_QUEUE_GRAPHICS_BIT)].timestampValidBits > 0)
+	{
+		VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+		query_pool_info.queryCount = 2;
+		VK_CHECK(vkCreateQueryPool(get_device().get_handle(), &query_pool_info, nullptr, &statistics.query_pool));
+	}
+
 	load_assets();
+	prepare_rock_lods();
 	prepare_instance_data();
 	prepare_uniform_buffers();
 	setup_descriptor_set_layout();
 	prepare_pipelines();
 	setup_descriptor_pool();
 	setup_descriptor_set();
+	if (gpu_culling_available)
+	{
+		prepare_culling();
+	}
 	build_command_buffers();
 	prepared = true;
 	return true;
@@ -503,9 +914,46 @@ void Instancing::render(float delta_time)
 
 void Instancing::on_update_ui_overlay(vkb::Drawer &drawer)
 {
+	if (drawer.header("Settings"))
+	{
+		std::vector<std::string> instance_counts;
+		for (auto count : instance_count_options)
+		{
+			instance_counts.push_back(std::to_string(count));
+		}
+		if (drawer.combo_box("Instances", &instance_count_index, instance_counts))
+		{
+			change_instance_count();
+		}
+		if (gpu_culling_available && drawer.checkbox("GPU culling", &gpu_culling))
+		{
+			rebuild_command_buffers();
+		}
+	}
+
 	if (drawer.header("Statistics"))
 	{
-		drawer.text("Instances: %d", INSTANCE_COUNT);
+		drawer.text("Instances: %d", instance_count);
+		if (gpu_culling)
+		{
+			for (uint32_t lod = 0; lod < lod_count; lod++)
+			{
+				drawer.text("LOD %d: %d visible", lod, statistics.visible_instances[lod]);
+			}
+		}
+		// The time of the other mode is the last one measured, at the same instance count
+		if (statistics.query_pool != VK_NULL_HANDLE)
+		{
+			drawer.text("Brute force: %.2f ms", statistics.brute_force_time);
+			if (gpu_culling_available)
+			{
+				drawer.text("GPU culling: %.2f ms", statistics.gpu_culling_time);
+			}
+			if (statistics.brute_force_time > 0.0f && statistics.gpu_culling_time > 0.0f)
+			{
+				drawer.text("Speedup: %.1fx", statistics.brute_force_time / statistics.gpu_culling_time);
+			}
+		}
 	}
 }
 
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,7 +16,8 @@
  */
 
 /*
- * Instanced mesh rendering, uses a separate vertex buffer for instanced data
+ * Instanced mesh rendering, uses a separate vertex buffer for instanced data,
+ * optionally culled on the GPU into compacted per-LOD instance buffers drawn indirectly
  */
 
 #pragma once
@@ -29,9 +30,27 @@
 #	define INSTANCE_COUNT 8192
 #endif
 
+#if defined(__ANDROID__)
+#	define MAX_INSTANCE_COUNT 256 * 1024
+#else
+// Scales to millions of instances, the GPU culling mode only draws the visible ones
+#	define MAX_INSTANCE_COUNT 2048 * 1024
+#endif
+
 class Instancing : public ApiVulkanSample
 {
   public:
+	// Number of meshes of decreasing detail a rock is drawn with, depending on its distance to the camera
+	static constexpr uint32_t lod_count = 3;
+
+	// Radius of the sphere bounding a rock at scale 1, used to cull the instances
+	static constexpr float rock_radius = 1.0f;
+
+	uint32_t instance_count = INSTANCE_COUNT;
+	int32_t  instance_count_index{0};
+	bool     gpu_culling{false};
+	bool     gpu_culling_available{false};        // The culling shader is only available in GLSL
+
 	struct Textures
 	{
 		Texture rocks;
@@ -42,6 +61,8 @@ class Instancing : public ApiVulkanSample
 	{
 		std::unique_ptr<vkb::sg::SubMesh> rock;
 		std::unique_ptr<vkb::sg::SubMesh> planet;
+		// Coarser meshes of the rock from LOD 1 on, icospheres with less triangles the further they are
+		std::array<std::unique_ptr<vkb::sg::SubMesh>, lod_count - 1> rock_lods;
 	} models;
 
 	// Per-instance data block
@@ -72,8 +93,43 @@ class Instancing : public ApiVulkanSample
 	struct UniformBuffers
 	{
 		std::unique_ptr<vkb::core::Buffer> scene;
+		std::unique_ptr<vkb::core::Buffer> culling;
 	} uniform_buffers;
 
+	struct UBOCulling
+	{
+		glm::vec4 frustum_planes[6];
+		glm::vec4 camera_position;
+		glm::vec4 lod_distances = glm::vec4(16.0f, 32.0f, 0.0f, 0.0f);        // Distances to the camera from which LOD 1 and 2 are used
+		float     glob_speed    = 0.0f;
+		float     rock_radius   = Instancing::rock_radius;
+		uint32_t  instance_count = INSTANCE_COUNT;
+	} ubo_culling;
+
+	// GPU culling: a compute pass writes the visible instances, compacted by LOD, and the indirect draw of each LOD
+	struct Culling
+	{
+		std::unique_ptr<vkb::core::Buffer> visible_instances;        // Visible instance data, instance_count slots per LOD
+		std::unique_ptr<vkb::core::Buffer> draw_commands;            // One indexed indirect draw per LOD
+		std::unique_ptr<vkb::core::Buffer> draw_counts;              // One draw count per LOD, 0 if no instance is visible at that LOD
+		std::unique_ptr<vkb::core::Buffer> initial_draws;            // Draw commands and counts before culling, copied at the start of each frame
+		std::unique_ptr<vkb::core::Buffer> readback;                 // Draw commands of the last frame, read back for the statistics
+		VkPipeline                         pipeline{VK_NULL_HANDLE};
+		VkPipelineLayout                   pipeline_layout{VK_NULL_HANDLE};
+		VkDescriptorSetLayout              descriptor_set_layout{VK_NULL_HANDLE};
+		VkDescriptorSet                    descriptor_set{VK_NULL_HANDLE};
+		bool                               draw_indirect_count{false};        // Whether empty LODs are skipped with vkCmdDrawIndexedIndirectCountKHR
+	} culling;
+
+	// GPU time of the frame in each mode, measured with timestamps, and visible instances of each LOD
+	struct
+	{
+		VkQueryPool                     query_pool{VK_NULL_HANDLE};
+		float                           brute_force_time{0.0f};        // In milliseconds, 0 until measured
+		float                           gpu_culling_time{0.0f};
+		std::array<uint32_t, lod_count> visible_instances{};
+	} statistics;
+
 	VkPipelineLayout pipeline_layout;
 	struct Pipelines
 	{
@@ -99,13 +155,23 @@ class Instancing : public ApiVulkanSample
 	void         setup_descriptor_set();
 	void         prepare_pipelines();
 	void         prepare_instance_data();
+	void         prepare_rock_lods();
+	void         prepare_culling();
+	void         prepare_culling_buffers();
 	void         prepare_uniform_buffers();
 	void         update_uniform_buffer(float delta_time);
+	void         update_culling_uniform_buffer();
+	void         change_instance_count();
+	void         read_statistics();
+	void         record_culling(VkCommandBuffer command_buffer);
+	void         draw_culled_rocks(VkCommandBuffer command_buffer);
 	void         draw();
 	bool         prepare(const vkb::ApplicationOptions &options) override;
 	virtual void render(float delta_time) override;
 	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
 	virtual bool resize(const uint32_t width, const uint32_t height) override;
+
+	vkb::sg::SubMesh &get_rock_lod(uint32_t lod);
 };
 
 std::unique_ptr<vkb::Application> create_instancing();
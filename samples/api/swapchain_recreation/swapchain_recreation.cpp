@@ -1,4 +1,4 @@
-/* Copyright (c) 2023-2024, Google
+/* Copyright (c) 2023-2026, Google
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -892,6 +892,9 @@ VkDevice SwapchainRecreation::get_device_handle()
 
 SwapchainRecreation::SwapchainRecreation()
 {
+	// The state of the sample is set up when its device is created, see create_device()
+	set_device_sharing_enable(false);
+
 	const char *use_maintenance1 = std::getenv("USE_MAINTENANCE1");
 
 	if ((use_maintenance1 == nullptr) || (strcmp(use_maintenance1, "no") != 0))
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -23,6 +23,37 @@
 
 #include "heightmap.h"
 
+namespace
+{
+// Value of the lattice point of a noise, in [0, 1]
+float lattice_value(int64_t x, int64_t y)
+{
+	uint32_t hash = static_cast<uint32_t>(x) * 0x8da6b343u ^ static_cast<uint32_t>(y) * 0xd8163841u;
+	hash          = (hash ^ (hash >> 15)) * 0x2c1b3c6du;
+	hash          = (hash ^ (hash >> 12)) * 0x297a2d39u;
+	return static_cast<float>(hash ^ (hash >> 15)) / 4294967295.0f;
+}
+
+float value_noise(double x, double y)
+{
+	double x0 = std::floor(x);
+	double y0 = std::floor(y);
+
+	// Smoothstep of the position in the lattice cell
+	float tx = static_cast<float>(x - x0);
+	float ty = static_cast<float>(y - y0);
+	tx       = tx * tx * (3.0f - 2.0f * tx);
+	ty       = ty * ty * (3.0f - 2.0f * ty);
+
+	int64_t ix = static_cast<int64_t>(x0);
+	int64_t iy = static_cast<int64_t>(y0);
+
+	return glm::mix(glm::mix(lattice_value(ix, iy), lattice_value(ix + 1, iy), tx),
+	                glm::mix(lattice_value(ix, iy + 1), lattice_value(ix + 1, iy + 1), tx),
+	                ty);
+}
+}        // namespace
+
 TerrainTessellation::TerrainTessellation()
 {
 	title = "Dynamic terrain tessellation";
@@ -61,6 +92,22 @@ TerrainTessellation::~TerrainTessellation()
 		{
 			vkDestroyQueryPool(get_device().get_handle(), query_pool, nullptr);
 		}
+
+		if (streamed_lod_available)
+		{
+			vkDestroyPipeline(get_device().get_handle(), lod.quadtree_pipeline, nullptr);
+			vkDestroyPipeline(get_device().get_handle(), lod.draw_pipeline, nullptr);
+			if (lod.wireframe_pipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(get_device().get_handle(), lod.wireframe_pipeline, nullptr);
+			}
+			vkDestroyPipelineLayout(get_device().get_handle(), lod.quadtree_layout, nullptr);
+			vkDestroyPipelineLayout(get_device().get_handle(), lod.draw_layout, nullptr);
+			vkDestroyDescriptorSetLayout(get_device().get_handle(), lod.quadtree_set_layout, nullptr);
+			vkDestroyDescriptorSetLayout(get_device().get_handle(), lod.draw_set_layout, nullptr);
+			vkDestroySampler(get_device().get_handle(), lod.atlas_sampler, nullptr);
+			vkDestroyCommandPool(get_device().get_handle(), lod.command_pool, nullptr);
+		}
 	}
 }
 
@@ -238,11 +285,23 @@ void TerrainTessellation::build_command_buffers()
 			vkCmdBeginQuery(draw_cmd_buffers[i], query_pool, 0, 0);
 		}
 		// Render
-		vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, wireframe ? pipelines.wireframe : pipelines.terrain);
-		vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.terrain, 0, 1, &descriptor_sets.terrain, 0, NULL);
-		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, terrain.vertices->get(), offsets);
-		vkCmdBindIndexBuffer(draw_cmd_buffers[i], terrain.indices->get_handle(), 0, VK_INDEX_TYPE_UINT32);
-		vkCmdDrawIndexed(draw_cmd_buffers[i], terrain.index_count, 1, 0, 0, 0);
+		if (terrain_mode == TerrainMode::StreamedLOD)
+		{
+			// One instance per quadtree node selected by the compute passes of the frame
+			vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, wireframe ? lod.wireframe_pipeline : lod.draw_pipeline);
+			vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, lod.draw_layout, 0, 1, &lod.draw_set, 0, NULL);
+			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, lod.grid_vertices->get(), offsets);
+			vkCmdBindIndexBuffer(draw_cmd_buffers[i], lod.grid_indices->get_handle(), 0, VK_INDEX_TYPE_UINT16);
+			vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], lod.draw_command->get_handle(), 0, 1, sizeof(VkDrawIndexedIndirectCommand));
+		}
+		else
+		{
+			vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, wireframe ? pipelines.wireframe : pipelines.terrain);
+			vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.terrain, 0, 1, &descriptor_sets.terrain, 0, NULL);
+			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, terrain.vertices->get(), offsets);
+			vkCmdBindIndexBuffer(draw_cmd_buffers[i], terrain.indices->get_handle(), 0, VK_INDEX_TYPE_UINT32);
+			vkCmdDrawIndexed(draw_cmd_buffers[i], terrain.index_count, 1, 0, 0, 0);
+		}
 		if (get_device().get_gpu().get_features().pipelineStatisticsQuery)
 		{
 			// End pipeline statistics query
@@ -369,18 +428,368 @@ void TerrainTessellation::generate_terrain()
 	get_device().flush_command_buffer(copy_command, queue, true);
 }
 
+// Height of the streamed terrain at a position in [0, 1] over it: the source heightmap repeated, with finer detail
+// added by a few octaves of value noise, as if the terrain had been sampled at a higher resolution
+float TerrainTessellation::sample_streamed_height(double u, double v) const
+{
+	float height = 0.9f * lod.source->sample(static_cast<float>(u * LOD_SOURCE_REPEATS), static_cast<float>(v * LOD_SOURCE_REPEATS));
+
+	double frequency = static_cast<double>(LOD_SOURCE_REPEATS) * lod.source->get_dimension() / 4.0;
+	float  amplitude = 0.02f;
+	for (uint32_t octave = 0; octave < 4; ++octave)
+	{
+		height += amplitude * (value_noise(u * frequency, v * frequency) - 0.5f);
+		frequency *= 2.0;
+		amplitude *= 0.5f;
+	}
+
+	return glm::clamp(height, 0.0f, 1.0f);
+}
+
+void TerrainTessellation::prepare_streamed_terrain()
+{
+	const uint32_t tile_resolution = LOD_TILE_QUADS + 1;
+
+	// Only the small source heightmap is loaded at once, the tiles of the streamed terrain are generated from it on demand,
+	// where an application would read them from a tiled file
+	lod.source  = std::make_unique<vkb::HeightMap>("textures/terrain_heightmap_r16.ktx", 1);
+	lod.pyramid = std::make_unique<vkb::HeightMapPyramid>(
+	    get_device(), LOD_LEVEL_COUNT, tile_resolution, LOD_SLOT_COUNT, LOD_LOADS_PER_FRAME,
+	    [this, tile_resolution](uint32_t level, uint32_t x, uint32_t y, std::vector<uint16_t> &samples) {
+		    double tile_size = 1.0 / static_cast<double>(1u << level);
+		    for (uint32_t j = 0; j < tile_resolution; ++j)
+		    {
+			    for (uint32_t i = 0; i < tile_resolution; ++i)
+			    {
+				    double u = (x + static_cast<double>(i) / LOD_TILE_QUADS) * tile_size;
+				    double v = (y + static_cast<double>(j) / LOD_TILE_QUADS) * tile_size;
+
+				    samples[i + j * tile_resolution] = static_cast<uint16_t>(sample_streamed_height(u, v) * 65535.0f + 0.5f);
+			    }
+		    }
+	    });
+
+	// Grid drawn for every node, with the vertices at the samples of its tile
+	std::vector<glm::vec2> grid_vertices;
+	for (uint32_t y = 0; y < tile_resolution; ++y)
+	{
+		for (uint32_t x = 0; x < tile_resolution; ++x)
+		{
+			grid_vertices.emplace_back(static_cast<float>(x), static_cast<float>(y));
+		}
+	}
+
+	std::vector<uint16_t> grid_indices;
+	for (uint32_t y = 0; y < LOD_TILE_QUADS; ++y)
+	{
+		for (uint32_t x = 0; x < LOD_TILE_QUADS; ++x)
+		{
+			uint16_t corner = static_cast<uint16_t>(x + y * tile_resolution);
+			grid_indices.insert(grid_indices.end(), {corner, static_cast<uint16_t>(corner + tile_resolution), static_cast<uint16_t>(corner + 1),
+			                                         static_cast<uint16_t>(corner + 1), static_cast<uint16_t>(corner + tile_resolution), static_cast<uint16_t>(corner + tile_resolution + 1)});
+		}
+	}
+	lod.grid_index_count = static_cast<uint32_t>(grid_indices.size());
+
+	vkb::core::Buffer vertex_staging = vkb::core::Buffer::create_staging_buffer(get_device(), grid_vertices);
+	vkb::core::Buffer index_staging  = vkb::core::Buffer::create_staging_buffer(get_device(), grid_indices);
+
+	lod.grid_vertices = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                        vertex_staging.get_size(),
+	                                                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                        VMA_MEMORY_USAGE_GPU_ONLY);
+	lod.grid_indices  = std::make_unique<vkb::core::Buffer>(get_device(),
+                                                           index_staging.get_size(),
+                                                           VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                           VMA_MEMORY_USAGE_GPU_ONLY);
+
+	VkCommandBuffer copy_command = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+
+	VkBufferCopy copy_region = {};
+	copy_region.size         = vertex_staging.get_size();
+	vkCmdCopyBuffer(copy_command, vertex_staging.get_handle(), lod.grid_vertices->get_handle(), 1, &copy_region);
+	copy_region.size = index_staging.get_size();
+	vkCmdCopyBuffer(copy_command, index_staging.get_handle(), lod.grid_indices->get_handle(), 1, &copy_region);
+
+	get_device().flush_command_buffer(copy_command, queue, true);
+
+	// Buffers written by the quadtree passes
+	for (auto &node_list : lod.node_lists)
+	{
+		node_list = std::make_unique<vkb::core::Buffer>(get_device(),
+		                                                sizeof(NodeListHeader) + LOD_MAX_NODES * sizeof(glm::uvec2),
+		                                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                                VMA_MEMORY_USAGE_GPU_ONLY);
+	}
+
+	// Host visible to read back the number of nodes drawn
+	lod.draw_command = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                       sizeof(VkDrawIndexedIndirectCommand),
+	                                                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
+
+	lod.instances = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                    LOD_MAX_INSTANCES * sizeof(glm::uvec4),
+	                                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	                                                    VMA_MEMORY_USAGE_GPU_ONLY);
+
+	lod.uniform_buffer = std::make_unique<vkb::core::Buffer>(get_device(),
+	                                                         sizeof(ubo_lod),
+	                                                         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+	                                                         VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+	// Tiles include their edges, so they are sampled without wrapping
+	VkFilter filter = VK_FILTER_LINEAR;
+	vkb::make_filters_valid(get_device().get_gpu().get_handle(), VK_FORMAT_R16_UNORM, &filter);
+
+	VkSamplerCreateInfo sampler_create_info = vkb::initializers::sampler_create_info();
+	sampler_create_info.magFilter           = filter;
+	sampler_create_info.minFilter           = filter;
+	sampler_create_info.mipmapMode          = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	sampler_create_info.addressModeU        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.addressModeV        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.addressModeW        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.maxLod              = 0.0f;
+	sampler_create_info.borderColor         = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+	VK_CHECK(vkCreateSampler(get_device().get_handle(), &sampler_create_info, nullptr, &lod.atlas_sampler));
+
+	// Quadtree passes
+	std::vector<VkDescriptorSetLayoutBinding> set_layout_bindings = {
+	    // Binding 0 : Shared ubo
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 0),
+	    // Binding 1 : Tile table
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1),
+	    // Binding 2 : Nodes of the level
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 2),
+	    // Binding 3 : Nodes of the next level
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 3),
+	    // Binding 4 : Indirect draw command
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 4),
+	    // Binding 5 : Nodes to draw
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 5),
+	};
+
+	VkDescriptorSetLayoutCreateInfo descriptor_layout = vkb::initializers::descriptor_set_layout_create_info(set_layout_bindings.data(), static_cast<uint32_t>(set_layout_bindings.size()));
+	VK_CHECK(vkCreateDescriptorSetLayout(get_device().get_handle(), &descriptor_layout, nullptr, &lod.quadtree_set_layout));
+
+	VkPushConstantRange        push_constant_range         = vkb::initializers::push_constant_range(VK_SHADER_STAGE_COMPUTE_BIT, sizeof(uint32_t), 0);
+	VkPipelineLayoutCreateInfo pipeline_layout_create_info = vkb::initializers::pipeline_layout_create_info(&lod.quadtree_set_layout, 1);
+	pipeline_layout_create_info.pushConstantRangeCount     = 1;
+	pipeline_layout_create_info.pPushConstantRanges        = &push_constant_range;
+	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &pipeline_layout_create_info, nullptr, &lod.quadtree_layout));
+
+	std::array<uint32_t, 3>                 quadtree_constants = {LOD_LEVEL_COUNT, LOD_MAX_NODES, LOD_MAX_INSTANCES};
+	std::array<VkSpecializationMapEntry, 3> quadtree_entries   = {
+        vkb::initializers::specialization_map_entry(0, 0, sizeof(uint32_t)),
+        vkb::initializers::specialization_map_entry(1, sizeof(uint32_t), sizeof(uint32_t)),
+        vkb::initializers::specialization_map_entry(2, 2 * sizeof(uint32_t), sizeof(uint32_t))};
+	VkSpecializationInfo quadtree_specialization = vkb::initializers::specialization_info(static_cast<uint32_t>(quadtree_entries.size()), quadtree_entries.data(), sizeof(quadtree_constants), quadtree_constants.data());
+
+	VkComputePipelineCreateInfo compute_pipeline_create_info = vkb::initializers::compute_pipeline_create_info(lod.quadtree_layout, 0);
+	compute_pipeline_create_info.stage                       = load_shader("terrain_tessellation", "terrain_lod_quadtree.comp", VK_SHADER_STAGE_COMPUTE_BIT);
+	compute_pipeline_create_info.stage.pSpecializationInfo   = &quadtree_specialization;
+	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &lod.quadtree_pipeline));
+
+	// Terrain draw
+	set_layout_bindings = {
+	    // Binding 0 : Shared ubo
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0),
+	    // Binding 1 : Tile atlas
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_VERTEX_BIT, 1),
+	    // Binding 2 : Terrain texture array layers
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 2),
+	    // Binding 3 : Nodes to draw
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT, 3),
+	};
+
+	descriptor_layout = vkb::initializers::descriptor_set_layout_create_info(set_layout_bindings.data(), static_cast<uint32_t>(set_layout_bindings.size()));
+	VK_CHECK(vkCreateDescriptorSetLayout(get_device().get_handle(), &descriptor_layout, nullptr, &lod.draw_set_layout));
+
+	pipeline_layout_create_info = vkb::initializers::pipeline_layout_create_info(&lod.draw_set_layout, 1);
+	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &pipeline_layout_create_info, nullptr, &lod.draw_layout));
+
+	VkPipelineInputAssemblyStateCreateInfo input_assembly_state = vkb::initializers::pipeline_input_assembly_state_create_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, 0, VK_FALSE);
+
+	// The terrain is a heightfield, mostly seen from above, culling would save little
+	VkPipelineRasterizationStateCreateInfo rasterization_state = vkb::initializers::pipeline_rasterization_state_create_info(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, 0);
+
+	VkPipelineColorBlendAttachmentState blend_attachment_state = vkb::initializers::pipeline_color_blend_attachment_state(0xf, VK_FALSE);
+	VkPipelineColorBlendStateCreateInfo color_blend_state      = vkb::initializers::pipeline_color_blend_state_create_info(1, &blend_attachment_state);
+
+	// Note: Using reversed depth-buffer for increased precision, so Greater depth values are kept
+	VkPipelineDepthStencilStateCreateInfo depth_stencil_state = vkb::initializers::pipeline_depth_stencil_state_create_info(VK_TRUE, VK_TRUE, VK_COMPARE_OP_GREATER);
+	VkPipelineViewportStateCreateInfo     viewport_state      = vkb::initializers::pipeline_viewport_state_create_info(1, 1, 0);
+	VkPipelineMultisampleStateCreateInfo  multisample_state   = vkb::initializers::pipeline_multisample_state_create_info(VK_SAMPLE_COUNT_1_BIT, 0);
+
+	std::vector<VkDynamicState>      dynamic_state_enables = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_LINE_WIDTH};
+	VkPipelineDynamicStateCreateInfo dynamic_state         = vkb::initializers::pipeline_dynamic_state_create_info(dynamic_state_enables.data(), static_cast<uint32_t>(dynamic_state_enables.size()), 0);
+
+	VkVertexInputBindingDescription      vertex_input_binding   = vkb::initializers::vertex_input_binding_description(0, sizeof(glm::vec2), VK_VERTEX_INPUT_RATE_VERTEX);
+	VkVertexInputAttributeDescription    vertex_input_attribute = vkb::initializers::vertex_input_attribute_description(0, 0, VK_FORMAT_R32G32_SFLOAT, 0);        // Grid position
+	VkPipelineVertexInputStateCreateInfo vertex_input_state     = vkb::initializers::pipeline_vertex_input_state_create_info();
+	vertex_input_state.vertexBindingDescriptionCount            = 1;
+	vertex_input_state.pVertexBindingDescriptions               = &vertex_input_binding;
+	vertex_input_state.vertexAttributeDescriptionCount          = 1;
+	vertex_input_state.pVertexAttributeDescriptions             = &vertex_input_attribute;
+
+	uint32_t                 tile_quads       = LOD_TILE_QUADS;
+	VkSpecializationMapEntry tile_quads_entry = vkb::initializers::specialization_map_entry(0, 0, sizeof(uint32_t));
+	VkSpecializationInfo     vertex_specialization = vkb::initializers::specialization_info(1, &tile_quads_entry, sizeof(tile_quads), &tile_quads);
+
+	std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages;
+	shader_stages[0]                     = load_shader("terrain_tessellation", "terrain_lod.vert", VK_SHADER_STAGE_VERTEX_BIT);
+	shader_stages[0].pSpecializationInfo = &vertex_specialization;
+	shader_stages[1]                     = load_shader("terrain_tessellation", "terrain_lod.frag", VK_SHADER_STAGE_FRAGMENT_BIT);
+
+	VkGraphicsPipelineCreateInfo pipeline_create_info = vkb::initializers::pipeline_create_info(lod.draw_layout, render_pass, 0);
+	pipeline_create_info.pVertexInputState            = &vertex_input_state;
+	pipeline_create_info.pInputAssemblyState          = &input_assembly_state;
+	pipeline_create_info.pRasterizationState          = &rasterization_state;
+	pipeline_create_info.pColorBlendState             = &color_blend_state;
+	pipeline_create_info.pMultisampleState            = &multisample_state;
+	pipeline_create_info.pViewportState               = &viewport_state;
+	pipeline_create_info.pDepthStencilState           = &depth_stencil_state;
+	pipeline_create_info.pDynamicState                = &dynamic_state;
+	pipeline_create_info.stageCount                   = static_cast<uint32_t>(shader_stages.size());
+	pipeline_create_info.pStages                      = shader_stages.data();
+
+	VK_CHECK(vkCreateGraphicsPipelines(get_device().get_handle(), pipeline_cache, 1, &pipeline_create_info, nullptr, &lod.draw_pipeline));
+
+	if (get_device().get_gpu().get_features().fillModeNonSolid)
+	{
+		rasterization_state.polygonMode = VK_POLYGON_MODE_LINE;
+		VK_CHECK(vkCreateGraphicsPipelines(get_device().get_handle(), pipeline_cache, 1, &pipeline_create_info, nullptr, &lod.wireframe_pipeline));
+	}
+
+	// Descriptor sets, from the pool of setup_descriptor_pool()
+	std::array<VkDescriptorSetLayout, 2> quadtree_set_layouts = {lod.quadtree_set_layout, lod.quadtree_set_layout};
+	VkDescriptorSetAllocateInfo          alloc_info           = vkb::initializers::descriptor_set_allocate_info(descriptor_pool, quadtree_set_layouts.data(), 2);
+	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &alloc_info, lod.quadtree_sets));
+
+	VkDescriptorBufferInfo uniform_descriptor      = create_descriptor(*lod.uniform_buffer);
+	VkDescriptorBufferInfo tile_table_descriptor   = create_descriptor(lod.pyramid->get_tile_table());
+	VkDescriptorBufferInfo draw_command_descriptor = create_descriptor(*lod.draw_command);
+	VkDescriptorBufferInfo instances_descriptor    = create_descriptor(*lod.instances);
+
+	for (uint32_t i = 0; i < 2; ++i)
+	{
+		VkDescriptorBufferInfo input_descriptor  = create_descriptor(*lod.node_lists[i]);
+		VkDescriptorBufferInfo output_descriptor = create_descriptor(*lod.node_lists[1 - i]);
+
+		std::vector<VkWriteDescriptorSet> write_descriptor_sets = {
+		    vkb::initializers::write_descriptor_set(lod.quadtree_sets[i], VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &uniform_descriptor),
+		    vkb::initializers::write_descriptor_set(lod.quadtree_sets[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, &tile_table_descriptor),
+		    vkb::initializers::write_descriptor_set(lod.quadtree_sets[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2, &input_descriptor),
+		    vkb::initializers::write_descriptor_set(lod.quadtree_sets[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3, &output_descriptor),
+		    vkb::initializers::write_descriptor_set(lod.quadtree_sets[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4, &draw_command_descriptor),
+		    vkb::initializers::write_descriptor_set(lod.quadtree_sets[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5, &instances_descriptor),
+		};
+		vkUpdateDescriptorSets(get_device().get_handle(), static_cast<uint32_t>(write_descriptor_sets.size()), write_descriptor_sets.data(), 0, NULL);
+	}
+
+	alloc_info = vkb::initializers::descriptor_set_allocate_info(descriptor_pool, &lod.draw_set_layout, 1);
+	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &alloc_info, &lod.draw_set));
+
+	VkDescriptorImageInfo atlas_descriptor  = vkb::initializers::descriptor_image_info(lod.atlas_sampler, lod.pyramid->get_atlas_view().get_handle(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	VkDescriptorImageInfo layers_descriptor = create_descriptor(textures.terrain_array);
+
+	std::vector<VkWriteDescriptorSet> write_descriptor_sets = {
+	    vkb::initializers::write_descriptor_set(lod.draw_set, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &uniform_descriptor),
+	    vkb::initializers::write_descriptor_set(lod.draw_set, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &atlas_descriptor),
+	    vkb::initializers::write_descriptor_set(lod.draw_set, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2, &layers_descriptor),
+	    vkb::initializers::write_descriptor_set(lod.draw_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3, &instances_descriptor),
+	};
+	vkUpdateDescriptorSets(get_device().get_handle(), static_cast<uint32_t>(write_descriptor_sets.size()), write_descriptor_sets.data(), 0, NULL);
+
+	VkCommandPoolCreateInfo command_pool_create_info = {};
+	command_pool_create_info.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	command_pool_create_info.queueFamilyIndex        = get_device().get_queue_family_index(VK_QUEUE_GRAPHICS_BIT);
+	command_pool_create_info.flags                   = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	VK_CHECK(vkCreateCommandPool(get_device().get_handle(), &command_pool_create_info, nullptr, &lod.command_pool));
+
+	VkCommandBufferAllocateInfo command_buffer_allocate_info = vkb::initializers::command_buffer_allocate_info(lod.command_pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1);
+	VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &command_buffer_allocate_info, &lod.command_buffer));
+}
+
+// Records the streaming of the tiles around the camera, then the quadtree passes selecting the nodes to draw
+void TerrainTessellation::record_streamed_terrain_update()
+{
+	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
+	command_buffer_begin_info.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	VK_CHECK(vkBeginCommandBuffer(lod.command_buffer, &command_buffer_begin_info));
+
+	// The previous frame was waited for in submit_frame(), so its reads of the tile table and of the atlas are done
+	lod.tiles_loaded = lod.pyramid->update(lod.command_buffer, glm::vec3(ubo_lod.viewer), ubo_lod.split_factor);
+
+	auto memory_barrier = [this](VkPipelineStageFlags src_stage_mask, VkPipelineStageFlags dst_stage_mask, VkAccessFlags src_access_mask, VkAccessFlags dst_access_mask) {
+		VkMemoryBarrier barrier = vkb::initializers::memory_barrier();
+		barrier.srcAccessMask   = src_access_mask;
+		barrier.dstAccessMask   = dst_access_mask;
+		vkCmdPipelineBarrier(lod.command_buffer, src_stage_mask, dst_stage_mask, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	};
+
+	// The first level is the root alone
+	struct
+	{
+		NodeListHeader header;
+		glm::uvec2     node;
+	} root{{{1, 1, 1}, 1}, glm::uvec2(0)};
+	vkCmdUpdateBuffer(lod.command_buffer, lod.node_lists[0]->get_handle(), 0, sizeof(root), &root);
+
+	VkDrawIndexedIndirectCommand draw_command{lod.grid_index_count, 0, 0, 0, 0};
+	vkCmdUpdateBuffer(lod.command_buffer, lod.draw_command->get_handle(), 0, sizeof(draw_command), &draw_command);
+
+	vkCmdBindPipeline(lod.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, lod.quadtree_pipeline);
+
+	const NodeListHeader empty_list{{0, 1, 1}, 0};
+	for (uint32_t level = 0; level < LOD_LEVEL_COUNT; ++level)
+	{
+		uint32_t input = level % 2;
+
+		if (level > 0)
+		{
+			// The output list was the input of the previous pass
+			memory_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+		}
+		vkCmdUpdateBuffer(lod.command_buffer, lod.node_lists[1 - input]->get_handle(), 0, sizeof(empty_list), &empty_list);
+
+		memory_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+
+		vkCmdBindDescriptorSets(lod.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, lod.quadtree_layout, 0, 1, &lod.quadtree_sets[input], 0, nullptr);
+		vkCmdPushConstants(lod.command_buffer, lod.quadtree_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &level);
+		vkCmdDispatchIndirect(lod.command_buffer, lod.node_lists[input]->get_handle(), 0);
+
+		memory_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+	}
+
+	// The draw command and the nodes to draw are read by the draw command buffer, submitted next
+	memory_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+
+	VK_CHECK(vkEndCommandBuffer(lod.command_buffer));
+}
+
 void TerrainTessellation::setup_descriptor_pool()
 {
 	std::vector<VkDescriptorPoolSize> pool_sizes =
 	    {
 	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 3),
 	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3)};
+	uint32_t max_sets = 2;
+
+	if (streamed_lod_available)
+	{
+		// Two quadtree sets with a uniform buffer and five storage buffers, and the streamed terrain set
+		pool_sizes[0].descriptorCount += 3;
+		pool_sizes[1].descriptorCount += 2;
+		pool_sizes.push_back(vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 11));
+		max_sets += 3;
+	}
 
 	VkDescriptorPoolCreateInfo descriptor_pool_create_info =
 	    vkb::initializers::descriptor_pool_create_info(
 	        static_cast<uint32_t>(pool_sizes.size()),
 	        pool_sizes.data(),
-	        2);
+	        max_sets);
 
 	VK_CHECK(vkCreateDescriptorPool(get_device().get_handle(), &descriptor_pool_create_info, nullptr, &descriptor_pool));
 }
@@ -669,6 +1078,21 @@ void TerrainTessellation::update_uniform_buffers()
 	// Skysphere vertex shader
 	ubo_vs.mvp = camera.matrices.perspective * glm::mat4(glm::mat3(camera.matrices.view));
 	uniform_buffers.skysphere_vertex->convert_and_update(ubo_vs.mvp);
+
+	// Streamed terrain
+	if (lod.uniform_buffer)
+	{
+		ubo_lod.projection = camera.matrices.perspective;
+		ubo_lod.modelview  = camera.matrices.view;
+		memcpy(ubo_lod.frustum_planes, frustum.get_planes().data(), sizeof(glm::vec4) * 6);
+
+		// Position of the camera over the terrain, and its distance to the slab of the terrain heights, normalized by the terrain size
+		glm::vec3 position      = glm::inverse(camera.matrices.view)[3];
+		float     vertical_dist = std::max(0.0f, std::max(-ubo_lod.height_scale - position.y, position.y));
+		ubo_lod.viewer          = glm::vec4(position.x / ubo_lod.terrain_size + 0.5f, position.z / ubo_lod.terrain_size + 0.5f, vertical_dist / ubo_lod.terrain_size, 0.0f);
+
+		lod.uniform_buffer->convert_and_update(ubo_lod);
+	}
 }
 
 void TerrainTessellation::draw()
@@ -679,6 +1103,15 @@ void TerrainTessellation::draw()
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
 
+	// The streaming and the quadtree passes of the streamed terrain run before its draw
+	std::array<VkCommandBuffer, 2> command_buffers = {lod.command_buffer, draw_cmd_buffers[current_buffer]};
+	if (terrain_mode == TerrainMode::StreamedLOD)
+	{
+		record_streamed_terrain_update();
+		submit_info.commandBufferCount = static_cast<uint32_t>(command_buffers.size());
+		submit_info.pCommandBuffers    = command_buffers.data();
+	}
+
 	// Submit to queue
 	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
 
@@ -689,6 +1122,13 @@ void TerrainTessellation::draw()
 	}
 
 	ApiVulkanSample::submit_frame();
+
+	if (terrain_mode == TerrainMode::StreamedLOD)
+	{
+		// submit_frame() waited for the queue, so the draw command of this frame is complete
+		lod.draw_command->invalidate();
+		memcpy(&lod.nodes_drawn, lod.draw_command->get_data() + offsetof(VkDrawIndexedIndirectCommand, instanceCount), sizeof(uint32_t));
+	}
 }
 
 bool TerrainTessellation::prepare(const vkb::ApplicationOptions &options)
@@ -711,11 +1151,17 @@ bool TerrainTessellation::prepare(const vkb::ApplicationOptions &options)
 	{
 		setup_query_result_buffer();
 	}
+	streamed_lod_available = get_shading_language() == vkb::ShadingLanguage::GLSL;
+
 	prepare_uniform_buffers();
 	setup_descriptor_set_layouts();
 	prepare_pipelines();
 	setup_descriptor_pool();
 	setup_descriptor_sets();
+	if (streamed_lod_available)
+	{
+		prepare_streamed_terrain();
+	}
 	build_command_buffers();
 	prepared = true;
 	return true;
@@ -735,15 +1181,52 @@ void TerrainTessellation::view_changed()
 	update_uniform_buffers();
 }
 
+void TerrainTessellation::set_terrain_mode(TerrainMode mode)
+{
+	terrain_mode = mode;
+
+	// Note: Using reversed depth-buffer for increased precision, so Znear and Zfar are flipped
+	if (terrain_mode == TerrainMode::StreamedLOD)
+	{
+		camera.set_perspective(60.0f, static_cast<float>(width) / static_cast<float>(height), 16384.0f, 0.5f);
+		camera.set_translation(glm::vec3(0.0f, 260.0f, 0.0f));
+		camera.translation_speed = 100.0f;
+	}
+	else
+	{
+		camera.set_perspective(60.0f, static_cast<float>(width) / static_cast<float>(height), 512.0f, 0.1f);
+		camera.set_translation(glm::vec3(18.0f, 22.5f, 57.5f));
+		camera.translation_speed = 7.5f;
+	}
+
+	update_uniform_buffers();
+	rebuild_command_buffers();
+}
+
 void TerrainTessellation::on_update_ui_overlay(vkb::Drawer &drawer)
 {
 	if (drawer.header("Settings"))
 	{
-		if (drawer.checkbox("Tessellation", &tessellation))
+		if (streamed_lod_available)
+		{
+			int32_t mode = static_cast<int32_t>(terrain_mode);
+			if (drawer.combo_box("Terrain", &mode, {"Tessellated", "Streamed LOD"}))
+			{
+				set_terrain_mode(static_cast<TerrainMode>(mode));
+			}
+		}
+		if (terrain_mode == TerrainMode::StreamedLOD)
+		{
+			if (drawer.slider_float("Split factor", &ubo_lod.split_factor, 1.5f, 4.0f))
+			{
+				update_uniform_buffers();
+			}
+		}
+		else if (drawer.checkbox("Tessellation", &tessellation))
 		{
 			update_uniform_buffers();
 		}
-		if (drawer.input_float("Factor", &ubo_tess.tessellation_factor, 0.05f, "%.2f"))
+		if (terrain_mode == TerrainMode::Tessellated && drawer.input_float("Factor", &ubo_tess.tessellation_factor, 0.05f, "%.2f"))
 		{
 			update_uniform_buffers();
 		}
@@ -763,6 +1246,15 @@ void TerrainTessellation::on_update_ui_overlay(vkb::Drawer &drawer)
 			drawer.text("TE invocations: %d", pipeline_stats[1]);
 		}
 	}
+	if (terrain_mode == TerrainMode::StreamedLOD)
+	{
+		if (drawer.header("Streaming"))
+		{
+			drawer.text("Resident tiles: %d / %d", lod.pyramid->get_resident_count(), LOD_SLOT_COUNT);
+			drawer.text("Tiles loaded: %d", lod.tiles_loaded);
+			drawer.text("Nodes drawn: %d", lod.nodes_drawn);
+		}
+	}
 }
 
 std::unique_ptr<vkb::Application> create_terrain_tessellation()
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -24,12 +24,26 @@
 #include "api_vulkan_sample.h"
 #include "core/buffer.h"
 #include "geometry/frustum.h"
+#include "heightmap.h"
+#include "heightmap_pyramid.h"
 
 class TerrainTessellation : public ApiVulkanSample
 {
   public:
-	bool wireframe    = false;
-	bool tessellation = true;
+	enum class TerrainMode
+	{
+		// The heightmap texture, tessellated per patch
+		Tessellated,
+		// A heightmap larger than memory, streamed as a pyramid of tiles and drawn as a quadtree built on the GPU
+		StreamedLOD
+	};
+
+	bool        wireframe    = false;
+	bool        tessellation = true;
+	TerrainMode terrain_mode = TerrainMode::Tessellated;
+
+	// The streamed terrain is only available with GLSL shaders
+	bool streamed_lod_available = false;
 
 	struct
 	{
@@ -112,6 +126,70 @@ class TerrainTessellation : public ApiVulkanSample
 	// View frustum passed to tessellation control shader for culling
 	vkb::Frustum frustum;
 
+	// Streamed terrain, the quadtree nodes are drawn as grids of LOD_TILE_QUADS x LOD_TILE_QUADS quads
+	static constexpr uint32_t LOD_LEVEL_COUNT     = 10;
+	static constexpr uint32_t LOD_TILE_QUADS      = 32;
+	static constexpr uint32_t LOD_SLOT_COUNT      = 512;
+	static constexpr uint32_t LOD_LOADS_PER_FRAME = 8;
+	static constexpr uint32_t LOD_MAX_NODES       = 4096;
+	static constexpr uint32_t LOD_MAX_INSTANCES   = 4096;
+	// Times the source heightmap is repeated on a side of the streamed terrain, with finer detail added
+	static constexpr uint32_t LOD_SOURCE_REPEATS = 16;
+
+	// Shared by the quadtree compute shader and the streamed terrain shaders
+	struct
+	{
+		glm::mat4 projection;
+		glm::mat4 modelview;
+		glm::vec4 frustum_planes[6];
+		glm::vec4 viewer;
+		glm::vec4 light_dir    = glm::vec4(glm::normalize(glm::vec3(-0.4f, -1.0f, 0.3f)), 0.0f);
+		float     terrain_size = 8192.0f;
+		float     height_scale = 160.0f;
+		float     split_factor = 2.5f;
+	} ubo_lod;
+
+	struct NodeListHeader
+	{
+		VkDispatchIndirectCommand dispatch;
+		uint32_t                  count;
+	};
+
+	struct
+	{
+		std::unique_ptr<vkb::HeightMap>        source;
+		std::unique_ptr<vkb::HeightMapPyramid> pyramid;
+		VkSampler                              atlas_sampler = VK_NULL_HANDLE;
+
+		std::unique_ptr<vkb::core::Buffer> grid_vertices;
+		std::unique_ptr<vkb::core::Buffer> grid_indices;
+		uint32_t                           grid_index_count = 0;
+
+		// Ping-pong lists of the nodes of a level, each with the dispatch size of its level pass
+		std::unique_ptr<vkb::core::Buffer> node_lists[2];
+		std::unique_ptr<vkb::core::Buffer> draw_command;
+		std::unique_ptr<vkb::core::Buffer> instances;
+		std::unique_ptr<vkb::core::Buffer> uniform_buffer;
+
+		VkDescriptorSetLayout quadtree_set_layout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout draw_set_layout     = VK_NULL_HANDLE;
+		VkPipelineLayout      quadtree_layout     = VK_NULL_HANDLE;
+		VkPipelineLayout      draw_layout         = VK_NULL_HANDLE;
+		VkPipeline            quadtree_pipeline   = VK_NULL_HANDLE;
+		VkPipeline            draw_pipeline       = VK_NULL_HANDLE;
+		VkPipeline            wireframe_pipeline  = VK_NULL_HANDLE;
+		// Set i reads node list i and writes the other one
+		VkDescriptorSet quadtree_sets[2];
+		VkDescriptorSet draw_set;
+
+		// Records the streaming and the quadtree of each frame, submitted before the draw command buffer
+		VkCommandPool   command_pool   = VK_NULL_HANDLE;
+		VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+
+		uint32_t tiles_loaded = 0;
+		uint32_t nodes_drawn  = 0;
+	} lod;
+
 	TerrainTessellation();
 	~TerrainTessellation();
 	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
@@ -127,6 +205,10 @@ class TerrainTessellation : public ApiVulkanSample
 	void         prepare_uniform_buffers();
 	void         update_uniform_buffers();
 	void         draw();
+	float        sample_streamed_height(double u, double v) const;
+	void         prepare_streamed_terrain();
+	void         record_streamed_terrain_update();
+	void         set_terrain_mode(TerrainMode mode);
 	bool         prepare(const vkb::ApplicationOptions &options) override;
 	virtual void render(float delta_time) override;
 	virtual void view_changed() override;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -26,6 +26,12 @@ TextureLoading::TextureLoading()
 	zoom     = -2.5f;
 	rotation = {0.0f, 15.0f, 0.0f};
 	title    = "Texture loading";
+
+	// The uniform buffer has a slice per swapchain image, so the CPU may record ahead of the GPU
+	set_frames_in_flight(2);
+
+	// A change of the gui records the command buffer of one image per frame
+	set_lazy_command_buffer_rebuild(true);
 }
 
 TextureLoading::~TextureLoading()
@@ -45,7 +51,6 @@ TextureLoading::~TextureLoading()
 
 	vertex_buffer.reset();
 	index_buffer.reset();
-	uniform_buffer_vs.reset();
 }
 
 // Enable physical device features required for this example
@@ -413,6 +418,14 @@ void TextureLoading::destroy_texture(Texture texture)
 }
 
 void TextureLoading::build_command_buffers()
+{
+	for (uint32_t i = 0; i < draw_cmd_buffers.size(); ++i)
+	{
+		build_command_buffer(i);
+	}
+}
+
+void TextureLoading::build_command_buffer(uint32_t index)
 {
 	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
 
@@ -429,36 +442,37 @@ void TextureLoading::build_command_buffers()
 	render_pass_begin_info.clearValueCount          = 2;
 	render_pass_begin_info.pClearValues             = clear_values;
 
-	for (int32_t i = 0; i < draw_cmd_buffers.size(); ++i)
-	{
-		// Set target frame buffer
-		render_pass_begin_info.framebuffer = framebuffers[i];
+	// Set target frame buffer
+	render_pass_begin_info.framebuffer = framebuffers[index];
 
-		VK_CHECK(vkBeginCommandBuffer(draw_cmd_buffers[i], &command_buffer_begin_info));
+	VkCommandBuffer command_buffer = draw_cmd_buffers[index];
 
-		vkCmdBeginRenderPass(draw_cmd_buffers[i], &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+	VK_CHECK(vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info));
 
-		VkViewport viewport = vkb::initializers::viewport(static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f);
-		vkCmdSetViewport(draw_cmd_buffers[i], 0, 1, &viewport);
+	vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
-		VkRect2D scissor = vkb::initializers::rect2D(width, height, 0, 0);
-		vkCmdSetScissor(draw_cmd_buffers[i], 0, 1, &scissor);
+	VkViewport viewport = vkb::initializers::viewport(static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f);
+	vkCmdSetViewport(command_buffer, 0, 1, &viewport);
 
-		vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_set, 0, NULL);
-		vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.solid);
+	VkRect2D scissor = vkb::initializers::rect2D(width, height, 0, 0);
+	vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 
-		VkDeviceSize offsets[1] = {0};
-		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, vertex_buffer->get(), offsets);
-		vkCmdBindIndexBuffer(draw_cmd_buffers[i], index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
+	// Each command buffer reads the slice of the uniform buffer of its swapchain image
+	uint32_t dynamic_offset = uniform_ring_vs->get_dynamic_offset(index);
+	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_set, 1, &dynamic_offset);
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.solid);
 
-		vkCmdDrawIndexed(draw_cmd_buffers[i], index_count, 1, 0, 0, 0);
+	VkDeviceSize offsets[1] = {0};
+	vkCmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffer->get(), offsets);
+	vkCmdBindIndexBuffer(command_buffer, index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
 
-		draw_ui(draw_cmd_buffers[i]);
+	vkCmdDrawIndexed(command_buffer, index_count, 1, 0, 0, 0);
 
-		vkCmdEndRenderPass(draw_cmd_buffers[i]);
+	draw_ui(command_buffer);
 
-		VK_CHECK(vkEndCommandBuffer(draw_cmd_buffers[i]));
-	}
+	vkCmdEndRenderPass(command_buffer);
+
+	VK_CHECK(vkEndCommandBuffer(command_buffer));
 }
 
 void TextureLoading::draw()
@@ -514,7 +528,7 @@ void TextureLoading::setup_descriptor_pool()
 	// Example uses one ubo and one image sampler
 	std::vector<VkDescriptorPoolSize> pool_sizes =
 	    {
-	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1),
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1),
 	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1)};
 
 	VkDescriptorPoolCreateInfo descriptor_pool_create_info =
@@ -532,7 +546,7 @@ void TextureLoading::setup_descriptor_set_layout()
 	    {
 	        // Binding 0 : Vertex shader uniform buffer
 	        vkb::initializers::descriptor_set_layout_binding(
-	            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
 	            VK_SHADER_STAGE_VERTEX_BIT,
 	            0),
 	        // Binding 1 : Fragment shader image sampler
@@ -566,7 +580,7 @@ void TextureLoading::setup_descriptor_set()
 
 	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &alloc_info, &descriptor_set));
 
-	VkDescriptorBufferInfo buffer_descriptor = create_descriptor(*uniform_buffer_vs);
+	VkDescriptorBufferInfo buffer_descriptor = uniform_ring_vs->get_descriptor();
 
 	// Setup a descriptor image info for the current texture to be used as a combined image sampler
 	VkDescriptorImageInfo image_descriptor;
@@ -579,7 +593,7 @@ void TextureLoading::setup_descriptor_set()
 	        // Binding 0 : Vertex shader uniform buffer
 	        vkb::initializers::write_descriptor_set(
 	            descriptor_set,
-	            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
 	            0,
 	            &buffer_descriptor),
 	        // Binding 1 : Fragment shader texture sampler
@@ -689,10 +703,7 @@ void TextureLoading::prepare_pipelines()
 void TextureLoading::prepare_uniform_buffers()
 {
 	// Vertex shader uniform buffer block
-	uniform_buffer_vs = std::make_unique<vkb::core::Buffer>(get_device(),
-	                                                        sizeof(ubo_vs),
-	                                                        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-	                                                        VMA_MEMORY_USAGE_CPU_TO_GPU);
+	uniform_ring_vs = &create_uniform_ring(sizeof(ubo_vs));
 
 	update_uniform_buffers();
 }
@@ -710,7 +721,7 @@ void TextureLoading::update_uniform_buffers()
 
 	ubo_vs.view_pos = glm::vec4(0.0f, 0.0f, -zoom, 0.0f);
 
-	uniform_buffer_vs->convert_and_update(ubo_vs);
+	update_uniform_ring(*uniform_ring_vs, ubo_vs);
 }
 
 bool TextureLoading::prepare(const vkb::ApplicationOptions &options)
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -53,7 +53,7 @@ class TextureLoading : public ApiVulkanSample
 	std::unique_ptr<vkb::core::Buffer> index_buffer;
 	uint32_t                           index_count;
 
-	std::unique_ptr<vkb::core::Buffer> uniform_buffer_vs;
+	UniformRing *uniform_ring_vs = nullptr;
 
 	struct
 	{
@@ -78,6 +78,7 @@ class TextureLoading : public ApiVulkanSample
 	void         load_texture();
 	void         destroy_texture(Texture texture);
 	void         build_command_buffers() override;
+	void         build_command_buffer(uint32_t index) override;
 	void         draw();
 	void         generate_quad();
 	void         setup_descriptor_pool();
@@ -1,4 +1,4 @@
-/* Copyright (c) 2023-2024, Sascha Willems
+/* Copyright (c) 2023-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,82 +20,9 @@
 #include "common/vk_common.h"
 #include "gui.h"
 
+#include <array>
 #include <sstream>
 
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-#	include <aclapi.h>
-#	include <dxgi1_2.h>
-#endif
-
-#ifdef _WIN32
-// On Windows, we need to enable some security settings to allow api interop
-// The spec states: For handles of the following types: VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT The implementation must ensure the access rights allow read and write access to the memory.
-// This class sets up the structures required for tis
-class WinSecurityAttributes
-{
-  private:
-	SECURITY_ATTRIBUTES  security_attributes;
-	PSECURITY_DESCRIPTOR security_descriptor;
-
-  public:
-	WinSecurityAttributes();
-	~WinSecurityAttributes();
-	SECURITY_ATTRIBUTES *operator&();
-};
-
-WinSecurityAttributes::WinSecurityAttributes()
-{
-	security_descriptor = (PSECURITY_DESCRIPTOR) calloc(1, SECURITY_DESCRIPTOR_MIN_LENGTH + 2 * sizeof(void **));
-
-	PSID *ppSID = (PSID *) ((PBYTE) security_descriptor + SECURITY_DESCRIPTOR_MIN_LENGTH);
-	PACL *ppACL = (PACL *) ((PBYTE) ppSID + sizeof(PSID *));
-
-	InitializeSecurityDescriptor(security_descriptor, SECURITY_DESCRIPTOR_REVISION);
-
-	SID_IDENTIFIER_AUTHORITY sid_identifier_authority = SECURITY_WORLD_SID_AUTHORITY;
-	AllocateAndInitializeSid(&sid_identifier_authority, 1, SECURITY_WORLD_RID, 0, 0, 0, 0, 0, 0, 0, ppSID);
-
-	EXPLICIT_ACCESS explicit_access{};
-	ZeroMemory(&explicit_access, sizeof(EXPLICIT_ACCESS));
-	explicit_access.grfAccessPermissions = STANDARD_RIGHTS_ALL | SPECIFIC_RIGHTS_ALL;
-	explicit_access.grfAccessMode        = SET_ACCESS;
-	explicit_access.grfInheritance       = INHERIT_ONLY;
-	explicit_access.Trustee.TrusteeForm  = TRUSTEE_IS_SID;
-	explicit_access.Trustee.TrusteeType  = TRUSTEE_IS_WELL_KNOWN_GROUP;
-	explicit_access.Trustee.ptstrName    = (LPTSTR) *ppSID;
-	SetEntriesInAcl(1, &explicit_access, nullptr, ppACL);
-
-	SetSecurityDescriptorDacl(security_descriptor, TRUE, *ppACL, FALSE);
-
-	security_attributes.nLength              = sizeof(SECURITY_ATTRIBUTES);
-	security_attributes.lpSecurityDescriptor = security_descriptor;
-	security_attributes.bInheritHandle       = TRUE;
-}
-
-SECURITY_ATTRIBUTES *WinSecurityAttributes::operator&()
-{
-	return &security_attributes;
-}
-
-WinSecurityAttributes::~WinSecurityAttributes()
-{
-	PSID *ppSID = (PSID *) ((PBYTE) security_descriptor + SECURITY_DESCRIPTOR_MIN_LENGTH);
-	PACL *ppACL = (PACL *) ((PBYTE) ppSID + sizeof(PSID *));
-
-	if (*ppSID)
-	{
-		FreeSid(*ppSID);
-	}
-
-	if (*ppACL)
-	{
-		LocalFree(*ppACL);
-	}
-
-	free(security_descriptor);
-}
-#endif
-
 OpenCLInterop::OpenCLInterop()
 {
 	zoom  = -3.5f;
@@ -118,32 +45,42 @@ OpenCLInterop::OpenCLInterop()
 	add_instance_extension(VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME);
 	add_instance_extension(VK_KHR_EXTERNAL_SEMAPHORE_CAPABILITIES_EXTENSION_NAME);
 	add_instance_extension(VK_KHR_EXTERNAL_FENCE_CAPABILITIES_EXTENSION_NAME);
+
+	// The command buffers bind the image displayed by the frame, so the one of the acquired image is recorded when the frame starts
+	set_lazy_command_buffer_rebuild(true);
 }
 
 OpenCLInterop::~OpenCLInterop()
 {
+	if (opencl_objects.initialized)
+	{
+		// OpenCL may still be filling images of the ring
+		clFinish(opencl_objects.command_queue);
+	}
+
 	if (has_device())
 	{
+		get_device().wait_idle();
+
 		vkDestroyPipeline(get_device().get_handle(), pipeline, nullptr);
 		vkDestroyPipelineLayout(get_device().get_handle(), pipeline_layout, nullptr);
 		vkDestroyDescriptorSetLayout(get_device().get_handle(), descriptor_set_layout, nullptr);
-		vkDestroyFence(get_device().get_handle(), rendering_finished_fence, nullptr);
-		vkDestroySemaphore(get_device().get_handle(), cl_update_vk_semaphore, nullptr);
-		vkDestroySemaphore(get_device().get_handle(), vk_update_cl_semaphore, nullptr);
-		vkDestroySampler(get_device().get_handle(), shared_image.sampler, nullptr);
-		vkDestroyImageView(get_device().get_handle(), shared_image.view, nullptr);
-		vkDestroyImage(get_device().get_handle(), shared_image.image, nullptr);
-		vkFreeMemory(get_device().get_handle(), shared_image.memory, nullptr);
+		vkDestroySampler(get_device().get_handle(), shared_image_sampler, nullptr);
 	}
 
 	if (opencl_objects.initialized)
 	{
-		clReleaseMemObject(opencl_objects.image);
+		for (auto &slot : opencl_objects.slots)
+		{
+			clReleaseMemObject(slot.image);
+			clReleaseSemaphoreKHR(slot.produced);
+			clReleaseSemaphoreKHR(slot.consumed);
+		}
 		clReleaseContext(opencl_objects.context);
-		clReleaseSemaphoreKHR(opencl_objects.cl_update_vk_semaphore);
-		clReleaseSemaphoreKHR(opencl_objects.vk_update_cl_semaphore);
 	}
 
+	shared_images.reset();
+
 	unload_opencl();
 }
 
@@ -156,66 +93,84 @@ void OpenCLInterop::render(float delta_time)
 
 	total_time_passed += delta_time;
 
-	// Wait until the Vulkan command buffer displaying the image has finished execution, so we can start writing to it from OpenCL
-	vkWaitForFences(get_device().get_handle(), 1, &rendering_finished_fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
-	vkResetFences(get_device().get_handle(), 1, &rendering_finished_fence);
+	// Display the oldest image OpenCL filled, the command buffer of the acquired image is recorded again to bind it
+	displayed_slot = shared_images->begin_consume();
+	rebuild_command_buffers();
 
 	ApiVulkanSample::prepare_frame();
 
-	std::vector<VkPipelineStageFlags> wait_stages{};
-	std::vector<VkSemaphore>          wait_semaphores{};
-	std::vector<VkSemaphore>          signal_semaphores{};
-
-	VkSubmitInfo submit_info       = {};
-	submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
-	submit_info.commandBufferCount = 1;
-
-	// As we have no way to manually signal the semaphores, we need to distinguish between the first and consecutive submits
-	// The first submit can't wait on the (yet) unsignaled OpenCL semaphore, so we only wait for that after the first submit
+	auto &slot = shared_images->get_slot(displayed_slot);
 
-	if (first_submit)
-	{
-		first_submit      = false;
-		wait_stages       = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-		wait_semaphores   = {semaphores.acquired_image_ready};
-		signal_semaphores = {semaphores.render_complete, vk_update_cl_semaphore};
-	}
-	else
-	{
-		wait_stages       = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
-		wait_semaphores   = {semaphores.acquired_image_ready, cl_update_vk_semaphore};
-		signal_semaphores = {semaphores.render_complete, vk_update_cl_semaphore};
-	}
+	// The ring only hands out slots whose produced semaphore was signaled, so every frame waits for OpenCL to have filled its image,
+	// and lets OpenCL fill the image again once the frame is done with it
+	std::array<VkPipelineStageFlags, 2> wait_stages{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT};
+	std::array<VkSemaphore, 2>          wait_semaphores{semaphores.acquired_image_ready, slot.produced->get_handle()};
+	std::array<VkSemaphore, 2>          signal_semaphores{semaphores.render_complete, slot.consumed->get_handle()};
 
+	VkSubmitInfo submit_info         = {};
+	submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.pCommandBuffers      = &draw_cmd_buffers[current_buffer];
+	submit_info.commandBufferCount   = 1;
 	submit_info.pWaitDstStageMask    = wait_stages.data();
-	submit_info.waitSemaphoreCount   = static_cast<uint32_t>(wait_semaphores.size());
+	submit_info.waitSemaphoreCount   = vkb::to_u32(wait_semaphores.size());
 	submit_info.pWaitSemaphores      = wait_semaphores.data();
-	submit_info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
+	submit_info.signalSemaphoreCount = vkb::to_u32(signal_semaphores.size());
 	submit_info.pSignalSemaphores    = signal_semaphores.data();
 
-	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, rendering_finished_fence));
+	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
+
+	shared_images->end_consume();
+
+	// OpenCL fills the freed image while Vulkan renders this frame, before the frame is presented and waited for
+	produce_shared_images();
 
 	ApiVulkanSample::submit_frame();
 
-	// Update the image from OpenCL
+	throughput_time += delta_time;
+	if (throughput_time >= 1.0f)
+	{
+		uint64_t produced_count   = shared_images->get_produced_count();
+		shared_images_per_second  = static_cast<float>(produced_count - throughput_produced_count) / throughput_time;
+		throughput_produced_count = produced_count;
+		throughput_time           = 0.0f;
+	}
+}
+
+void OpenCLInterop::produce_shared_images()
+{
+	bool wait_consumed = false;
+
+	while (shared_images->can_produce())
+	{
+		uint32_t slot_index = shared_images->begin_produce(wait_consumed);
+		auto    &slot       = opencl_objects.slots[slot_index];
 
-	// To make sure OpenCL won't start updating the image until Vulkan has finished rendering to it, we wait for the Vulkan->OpenCL semaphore
-	CL_CHECK(clEnqueueWaitSemaphoresKHR(opencl_objects.command_queue, 1, &opencl_objects.vk_update_cl_semaphore, nullptr, 0, nullptr, nullptr));
-	// We also need to acquire the image (resource) so we can update it with OpenCL
-	CL_CHECK(clEnqueueAcquireExternalMemObjectsKHR(opencl_objects.command_queue, 1, &opencl_objects.image, 0, nullptr, nullptr));
+		// To make sure OpenCL won't start updating the image until Vulkan has finished displaying it, we wait for the consumed semaphore.
+		// Images which were never displayed have no signal to wait for.
+		if (wait_consumed)
+		{
+			CL_CHECK(clEnqueueWaitSemaphoresKHR(opencl_objects.command_queue, 1, &slot.consumed, nullptr, 0, nullptr, nullptr));
+		}
+		// We also need to acquire the image (resource) so we can update it with OpenCL
+		CL_CHECK(clEnqueueAcquireExternalMemObjectsKHR(opencl_objects.command_queue, 1, &slot.image, 0, nullptr, nullptr));
 
-	std::array<size_t, 2> global_size = {shared_image.width, shared_image.height};
-	std::array<size_t, 2> local_size  = {16, 16};
+		std::array<size_t, 2> global_size = {shared_image_width, shared_image_height};
+		std::array<size_t, 2> local_size  = {16, 16};
 
-	CL_CHECK(clSetKernelArg(opencl_objects.kernel, 0, sizeof(cl_mem), &opencl_objects.image));
-	CL_CHECK(clSetKernelArg(opencl_objects.kernel, 1, sizeof(float), &total_time_passed));
-	CL_CHECK(clEnqueueNDRangeKernel(opencl_objects.command_queue, opencl_objects.kernel, global_size.size(), nullptr, global_size.data(), local_size.data(), 0, nullptr, nullptr));
+		CL_CHECK(clSetKernelArg(opencl_objects.kernel, 0, sizeof(cl_mem), &slot.image));
+		CL_CHECK(clSetKernelArg(opencl_objects.kernel, 1, sizeof(float), &total_time_passed));
+		CL_CHECK(clEnqueueNDRangeKernel(opencl_objects.command_queue, opencl_objects.kernel, global_size.size(), nullptr, global_size.data(), local_size.data(), 0, nullptr, nullptr));
 
-	// Release the image (resource) to Vulkan
-	CL_CHECK(clEnqueueReleaseExternalMemObjectsKHR(opencl_objects.command_queue, 1, &opencl_objects.image, 0, nullptr, nullptr));
-	// Signal a semaphore that the next Vulkan frame can wait on (first_submit != false)
-	CL_CHECK(clEnqueueSignalSemaphoresKHR(opencl_objects.command_queue, 1, &opencl_objects.cl_update_vk_semaphore, nullptr, 0, nullptr, nullptr));
+		// Release the image (resource) to Vulkan
+		CL_CHECK(clEnqueueReleaseExternalMemObjectsKHR(opencl_objects.command_queue, 1, &slot.image, 0, nullptr, nullptr));
+		// Signal the semaphore the frame displaying the image waits for
+		CL_CHECK(clEnqueueSignalSemaphoresKHR(opencl_objects.command_queue, 1, &slot.produced, nullptr, 0, nullptr, nullptr));
+
+		shared_images->end_produce();
+	}
+
+	// Starts the work without waiting for it, so that it runs alongside the rendering of Vulkan
+	CL_CHECK(clFlush(opencl_objects.command_queue));
 }
 
 void OpenCLInterop::view_changed()
@@ -224,6 +179,14 @@ void OpenCLInterop::view_changed()
 }
 
 void OpenCLInterop::build_command_buffers()
+{
+	for (uint32_t i = 0; i < draw_cmd_buffers.size(); i++)
+	{
+		build_command_buffer(i);
+	}
+}
+
+void OpenCLInterop::build_command_buffer(uint32_t index)
 {
 	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
 
@@ -239,35 +202,45 @@ void OpenCLInterop::build_command_buffers()
 	render_pass_begin_info.renderArea.extent.height = height;
 	render_pass_begin_info.clearValueCount          = 2;
 	render_pass_begin_info.pClearValues             = clear_values;
+	render_pass_begin_info.framebuffer              = framebuffers[index];
 
-	for (int32_t i = 0; i < draw_cmd_buffers.size(); i++)
-	{
-		render_pass_begin_info.framebuffer = framebuffers[i];
+	auto command_buffer = draw_cmd_buffers[index];
+
+	VK_CHECK(vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info));
 
-		VK_CHECK(vkBeginCommandBuffer(draw_cmd_buffers[i], &command_buffer_begin_info));
+	vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
-		vkCmdBeginRenderPass(draw_cmd_buffers[i], &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+	VkViewport viewport = vkb::initializers::viewport((float) width, (float) height, 0.0f, 1.0f);
+	vkCmdSetViewport(command_buffer, 0, 1, &viewport);
 
-		VkViewport viewport = vkb::initializers::viewport((float) width, (float) height, 0.0f, 1.0f);
-		vkCmdSetViewport(draw_cmd_buffers[i], 0, 1, &viewport);
+	VkRect2D scissor = vkb::initializers::rect2D(static_cast<int32_t>(width), static_cast<int32_t>(height), 0, 0);
+	vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 
-		VkRect2D scissor = vkb::initializers::rect2D(static_cast<int32_t>(width), static_cast<int32_t>(height), 0, 0);
-		vkCmdSetScissor(draw_cmd_buffers[i], 0, 1, &scissor);
+	// Each image of the ring has its own descriptor set
+	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets[displayed_slot], 0, nullptr);
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
-		vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
-		vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	VkDeviceSize offsets[1] = {0};
+	vkCmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffer->get(), offsets);
+	vkCmdBindIndexBuffer(command_buffer, index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
 
-		VkDeviceSize offsets[1] = {0};
-		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, vertex_buffer->get(), offsets);
-		vkCmdBindIndexBuffer(draw_cmd_buffers[i], index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
+	vkCmdDrawIndexed(command_buffer, index_count, 1, 0, 0, 0);
 
-		vkCmdDrawIndexed(draw_cmd_buffers[i], index_count, 1, 0, 0, 0);
+	draw_ui(command_buffer);
 
-		draw_ui(draw_cmd_buffers[i]);
+	vkCmdEndRenderPass(command_buffer);
 
-		vkCmdEndRenderPass(draw_cmd_buffers[i]);
+	VK_CHECK(vkEndCommandBuffer(command_buffer));
+}
 
-		VK_CHECK(vkEndCommandBuffer(draw_cmd_buffers[i]));
+void OpenCLInterop::on_update_ui_overlay(vkb::Drawer &drawer)
+{
+	if (drawer.header("Shared images"))
+	{
+		// Each image is written by OpenCL and read by Vulkan in place, without copies
+		float megabytes_per_second = shared_images_per_second * shared_image_width * shared_image_height * 4 / (1024.0f * 1024.0f);
+		drawer.text("Ring of %u images", shared_image_count);
+		drawer.text("%.1f images/s, %.1f MB/s", shared_images_per_second, megabytes_per_second);
 	}
 }
 
@@ -307,12 +280,12 @@ void OpenCLInterop::setup_descriptor_pool()
 {
 	std::vector<VkDescriptorPoolSize> pool_sizes =
 	    {
-	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1),
-	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1)};
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, shared_image_count),
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, shared_image_count)};
 
 	VkDescriptorPoolCreateInfo descriptor_pool_create_info = vkb::initializers::descriptor_pool_create_info(static_cast<uint32_t>(pool_sizes.size()),
 	                                                                                                        pool_sizes.data(),
-	                                                                                                        2);
+	                                                                                                        shared_image_count);
 
 	VK_CHECK(vkCreateDescriptorPool(get_device().get_handle(), &descriptor_pool_create_info, nullptr, &descriptor_pool));
 }
@@ -333,24 +306,29 @@ void OpenCLInterop::setup_descriptor_set_layout()
 
 void OpenCLInterop::setup_descriptor_set()
 {
-	VkDescriptorSetAllocateInfo alloc_info = vkb::initializers::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_layout, 1);
-	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &alloc_info, &descriptor_set));
+	descriptor_sets.resize(shared_image_count);
 
 	VkDescriptorBufferInfo buffer_descriptor = create_descriptor(*uniform_buffer_vs);
 
-	// Setup a descriptor image info for the current texture to be used as a combined image sampler
-	VkDescriptorImageInfo image_descriptor{};
-	image_descriptor.imageView   = shared_image.view;
-	image_descriptor.sampler     = shared_image.sampler;
-	image_descriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-	std::vector<VkWriteDescriptorSet> write_descriptor_sets{
-	    // Binding 0 : Vertex shader uniform buffer
-	    vkb::initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &buffer_descriptor),
-	    // Binding 1 : Fragment shader texture sampler
-	    vkb::initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &image_descriptor),
-	};
-	vkUpdateDescriptorSets(get_device().get_handle(), vkb::to_u32(write_descriptor_sets.size()), write_descriptor_sets.data(), 0, nullptr);
+	for (uint32_t i = 0; i < shared_image_count; i++)
+	{
+		VkDescriptorSetAllocateInfo alloc_info = vkb::initializers::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_layout, 1);
+		VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &alloc_info, &descriptor_sets[i]));
+
+		// Setup a descriptor image info for the image of the slot to be used as a combined image sampler
+		VkDescriptorImageInfo image_descriptor{};
+		image_descriptor.imageView   = shared_images->get_slot(i).image->get_view();
+		image_descriptor.sampler     = shared_image_sampler;
+		image_descriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		std::vector<VkWriteDescriptorSet> write_descriptor_sets{
+		    // Binding 0 : Vertex shader uniform buffer
+		    vkb::initializers::write_descriptor_set(descriptor_sets[i], VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &buffer_descriptor),
+		    // Binding 1 : Fragment shader texture sampler
+		    vkb::initializers::write_descriptor_set(descriptor_sets[i], VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &image_descriptor),
+		};
+		vkUpdateDescriptorSets(get_device().get_handle(), vkb::to_u32(write_descriptor_sets.size()), write_descriptor_sets.data(), 0, nullptr);
+	}
 }
 
 void OpenCLInterop::prepare_pipelines()
@@ -464,72 +442,10 @@ void OpenCLInterop::update_uniform_buffers()
 	uniform_buffer_vs->convert_and_update(ubo_vs);
 }
 
-// These functions wraps the platform specific functions to get platform handles for Vulkan memory objects (e.g. the memory backing the image) and semaphores
-
-#ifdef _WIN32
-HANDLE OpenCLInterop::get_vulkan_memory_handle(VkDeviceMemory memory)
-{
-	HANDLE                        handle;
-	VkMemoryGetWin32HandleInfoKHR win32_handle_info{};
-	win32_handle_info.sType      = VK_STRUCTURE_TYPE_MEMORY_GET_WIN32_HANDLE_INFO_KHR;
-	win32_handle_info.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT_KHR;
-	win32_handle_info.memory     = memory;
-	vkGetMemoryWin32HandleKHR(get_device().get_handle(), &win32_handle_info, &handle);
-	return handle;
-}
-
-HANDLE OpenCLInterop::get_vulkan_semaphore_handle(VkSemaphore &sempahore)
+void OpenCLInterop::prepare_shared_images()
 {
-	HANDLE                           handle;
-	VkSemaphoreGetWin32HandleInfoKHR win32_handle_info{};
-	win32_handle_info.sType      = VK_STRUCTURE_TYPE_SEMAPHORE_GET_WIN32_HANDLE_INFO_KHR;
-	win32_handle_info.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_WIN32_BIT;
-	win32_handle_info.semaphore  = sempahore;
-	vkGetSemaphoreWin32HandleKHR(get_device().get_handle(), &win32_handle_info, &handle);
-	return handle;
-}
-#else
-int OpenCLInterop::get_vulkan_memory_handle(VkDeviceMemory memory)
-{
-	int fd;
-	VkMemoryGetFdInfoKHR fd_info{};
-	fd_info.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
-	fd_info.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
-	fd_info.memory = memory;
-	vkGetMemoryFdKHR(get_device().get_handle(), &fd_info, &fd);
-	return fd;
-}
-
-int OpenCLInterop::get_vulkan_semaphore_handle(VkSemaphore &sempahore)
-{
-	int fd;
-	VkSemaphoreGetFdInfoKHR fd_info{};
-	fd_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR;
-	fd_info.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
-	fd_info.semaphore = sempahore;
-	vkGetSemaphoreFdKHR(get_device().get_handle(), &fd_info, &fd);
-	return fd;
-}
-#endif
-
-void OpenCLInterop::prepare_shared_image()
-{
-	// This texture will be shared between both APIs: OpenCL fills it and Vulkan uses it for rendering
-	shared_image.width  = 512;
-	shared_image.height = 512;
-
-	// We need to select the external handle type based on our target platform
-	// Note: Windows 8 and older requires the _KMT suffixed handle type, which we don't support in this sample
-	VkExternalMemoryHandleTypeFlagBits external_handle_type{};
-#ifdef _WIN32
-	external_handle_type = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT_KHR;
-#else
-	external_handle_type = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
-#endif
-
-	auto device_handle = get_device().get_handle();
-
-	// Setting up Vulkan resources (image, memory, image view and sampler)
+	// The images of the ring are shared between both APIs: OpenCL fills them and Vulkan uses them for rendering
+	// The external memory and semaphore handles are created and exported by the framework, with the opaque handle types of the platform
 
 	VkImageCreateInfo image_create_info = vkb::initializers::image_create_info();
 	image_create_info.imageType         = VK_IMAGE_TYPE_2D;
@@ -538,39 +454,10 @@ void OpenCLInterop::prepare_shared_image()
 	image_create_info.arrayLayers       = 1;
 	image_create_info.samples           = VK_SAMPLE_COUNT_1_BIT;
 	image_create_info.tiling            = VK_IMAGE_TILING_OPTIMAL;
-	image_create_info.extent            = {shared_image.width, shared_image.height, 1};
+	image_create_info.extent            = {shared_image_width, shared_image_height, 1};
 	image_create_info.usage             = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
-	VkExternalMemoryImageCreateInfo external_memory_image_info{};
-	external_memory_image_info.sType       = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO;
-	external_memory_image_info.handleTypes = external_handle_type;
-
-	image_create_info.pNext = &external_memory_image_info;
-	VK_CHECK(vkCreateImage(get_device().get_handle(), &image_create_info, nullptr, &shared_image.image));
-
-	VkMemoryRequirements memory_requirements{};
-	vkGetImageMemoryRequirements(get_device().get_handle(), shared_image.image, &memory_requirements);
-
-	VkExportMemoryAllocateInfoKHR export_memory_allocate_info{};
-	export_memory_allocate_info.sType       = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO_KHR;
-	export_memory_allocate_info.handleTypes = external_handle_type;
-
-#ifdef _WIN32
-	WinSecurityAttributes            win_security_attributes;
-	VkExportMemoryWin32HandleInfoKHR export_memory_win32_handle_info{};
-	export_memory_win32_handle_info.sType       = VK_STRUCTURE_TYPE_EXPORT_MEMORY_WIN32_HANDLE_INFO_KHR;
-	export_memory_win32_handle_info.pAttributes = &win_security_attributes;
-	export_memory_win32_handle_info.dwAccess    = DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE;
-	export_memory_allocate_info.pNext           = &export_memory_win32_handle_info;
-#endif
-
-	VkMemoryAllocateInfo memory_allocate_info = vkb::initializers::memory_allocate_info();
-	memory_allocate_info.pNext                = &export_memory_allocate_info;
-	memory_allocate_info.allocationSize       = memory_requirements.size;
-	memory_allocate_info.memoryTypeIndex      = get_device().get_memory_type(memory_requirements.memoryTypeBits, 0);
-
-	VK_CHECK(vkAllocateMemory(device_handle, &memory_allocate_info, nullptr, &shared_image.memory));
-	VK_CHECK(vkBindImageMemory(device_handle, shared_image.image, shared_image.memory, 0));
+	shared_images = std::make_unique<vkb::SharedResourceRing>(get_device(), shared_image_count, image_create_info);
 
 	// Calculate valid filter and mipmap modes
 	VkFilter            filter      = VK_FILTER_LINEAR;
@@ -583,14 +470,7 @@ void OpenCLInterop::prepare_shared_image()
 	sampler_create_info.mipmapMode  = mipmap_mode;
 	sampler_create_info.maxLod      = (float) 1;
 	sampler_create_info.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
-	vkCreateSampler(device_handle, &sampler_create_info, nullptr, &shared_image.sampler);
-
-	VkImageViewCreateInfo view_create_info{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
-	view_create_info.viewType         = VK_IMAGE_VIEW_TYPE_2D;
-	view_create_info.image            = shared_image.image;
-	view_create_info.format           = VK_FORMAT_R8G8B8A8_UNORM;
-	view_create_info.subresourceRange = VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-	vkCreateImageView(device_handle, &view_create_info, nullptr, &shared_image.view);
+	VK_CHECK(vkCreateSampler(get_device().get_handle(), &sampler_create_info, nullptr, &shared_image_sampler));
 
 	VkCommandBuffer copy_command = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
 
@@ -600,139 +480,94 @@ void OpenCLInterop::prepare_shared_image()
 	subresource_range.levelCount              = 1;
 	subresource_range.layerCount              = 1;
 
-	VkImageMemoryBarrier image_memory_barrier = vkb::initializers::image_memory_barrier();
-	image_memory_barrier.image                = shared_image.image;
-	image_memory_barrier.subresourceRange     = subresource_range;
-	image_memory_barrier.srcAccessMask        = 0;
-	image_memory_barrier.dstAccessMask        = VK_ACCESS_SHADER_READ_BIT;
-	image_memory_barrier.oldLayout            = VK_IMAGE_LAYOUT_UNDEFINED;
-	image_memory_barrier.newLayout            = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-	vkCmdPipelineBarrier(
-	    copy_command,
-	    VK_PIPELINE_STAGE_TRANSFER_BIT,
-	    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-	    0,
-	    0, nullptr,
-	    0, nullptr,
-	    1, &image_memory_barrier);
+	for (uint32_t i = 0; i < shared_image_count; i++)
+	{
+		VkImageMemoryBarrier image_memory_barrier = vkb::initializers::image_memory_barrier();
+		image_memory_barrier.image                = shared_images->get_slot(i).image->get_handle();
+		image_memory_barrier.subresourceRange     = subresource_range;
+		image_memory_barrier.srcAccessMask        = 0;
+		image_memory_barrier.dstAccessMask        = VK_ACCESS_SHADER_READ_BIT;
+		image_memory_barrier.oldLayout            = VK_IMAGE_LAYOUT_UNDEFINED;
+		image_memory_barrier.newLayout            = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		vkCmdPipelineBarrier(
+		    copy_command,
+		    VK_PIPELINE_STAGE_TRANSFER_BIT,
+		    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		    0,
+		    0, nullptr,
+		    0, nullptr,
+		    1, &image_memory_barrier);
+	}
 
 	get_device().flush_command_buffer(copy_command, queue, true);
 
-	// Import the image into OpenCL
-
-	std::vector<cl_mem_properties> mem_properties;
-
-#ifdef _WIN32
-	HANDLE handle = get_vulkan_memory_handle(shared_image.memory);
-	mem_properties.push_back((cl_mem_properties) CL_EXTERNAL_MEMORY_HANDLE_OPAQUE_WIN32_KHR);
-	mem_properties.push_back((cl_mem_properties) handle);
-#else
-	int fd = get_vulkan_memory_handle(shared_image.memory);
-	mem_properties.push_back((cl_mem_properties) CL_EXTERNAL_MEMORY_HANDLE_OPAQUE_FD_KHR);
-	mem_properties.push_back((cl_mem_properties) fd);
-#endif
-	mem_properties.push_back((cl_mem_properties) CL_MEM_DEVICE_HANDLE_LIST_KHR);
-	mem_properties.push_back((cl_mem_properties) opencl_objects.device_id);
-	mem_properties.push_back((cl_mem_properties) CL_MEM_DEVICE_HANDLE_LIST_END_KHR);
-	mem_properties.push_back(0);
+	// Import the images and the semaphores of the slots into OpenCL
 
 	cl_image_format cl_img_fmt{};
 	cl_img_fmt.image_channel_order     = CL_RGBA;
 	cl_img_fmt.image_channel_data_type = CL_UNSIGNED_INT8;
 
 	cl_image_desc cl_img_desc{};
-	cl_img_desc.image_width       = shared_image.width;
-	cl_img_desc.image_height      = shared_image.height;
+	cl_img_desc.image_width       = shared_image_width;
+	cl_img_desc.image_height      = shared_image_height;
 	cl_img_desc.image_type        = CL_MEM_OBJECT_IMAGE2D;
 	cl_img_desc.image_slice_pitch = cl_img_desc.image_row_pitch * cl_img_desc.image_height;
 	cl_img_desc.num_mip_levels    = 1;
 	cl_img_desc.buffer            = nullptr;
 
-	int cl_result;
-	opencl_objects.image = clCreateImageWithProperties(opencl_objects.context,
-	                                                   mem_properties.data(),
-	                                                   CL_MEM_READ_WRITE,
-	                                                   &cl_img_fmt,
-	                                                   &cl_img_desc,
-	                                                   NULL,
-	                                                   &cl_result);
-	CL_CHECK(cl_result);
-}
-
-void OpenCLInterop::prepare_sync_objects()
-{
-	// Just as the image, we also create the semaphores in Vulkan and export them
-	VkExportSemaphoreCreateInfoKHR export_semaphore_create_info{};
-	export_semaphore_create_info.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO_KHR;
-
 #ifdef _WIN32
-	WinSecurityAttributes               win_security_attributes;
-	VkExportSemaphoreWin32HandleInfoKHR export_semaphore_handle_info{};
-	export_semaphore_handle_info.sType       = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_WIN32_HANDLE_INFO_KHR;
-	export_semaphore_handle_info.pAttributes = &win_security_attributes;
-	export_semaphore_handle_info.dwAccess    = DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE;
-
-	export_semaphore_create_info.pNext       = &export_semaphore_handle_info;
-	export_semaphore_create_info.handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_WIN32_BIT;
+	const cl_mem_properties           memory_handle_type    = CL_EXTERNAL_MEMORY_HANDLE_OPAQUE_WIN32_KHR;
+	const cl_semaphore_properties_khr semaphore_handle_type = CL_SEMAPHORE_HANDLE_OPAQUE_WIN32_KHR;
 #else
-	export_semaphore_create_info.handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+	const cl_mem_properties           memory_handle_type    = CL_EXTERNAL_MEMORY_HANDLE_OPAQUE_FD_KHR;
+	const cl_semaphore_properties_khr semaphore_handle_type = CL_SEMAPHORE_HANDLE_OPAQUE_FD_KHR;
 #endif
 
-	VkSemaphoreCreateInfo semaphore_create_info{};
-	semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-	semaphore_create_info.pNext = &export_semaphore_create_info;
-
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &cl_update_vk_semaphore));
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &vk_update_cl_semaphore));
-
-	// We also need a fence for the Vulkan side of things, which is not shared with OpenCL
-	VkFenceCreateInfo fence_create_info = vkb::initializers::fence_create_info(VK_FENCE_CREATE_SIGNALED_BIT);
-	vkCreateFence(get_device().get_handle(), &fence_create_info, nullptr, &rendering_finished_fence);
-
-	// Import the Vulkan sempahores into OpenCL
-	std::vector<cl_semaphore_properties_khr> semaphore_properties{
-	    (cl_semaphore_properties_khr) CL_SEMAPHORE_TYPE_KHR,
-	    (cl_semaphore_properties_khr) CL_SEMAPHORE_TYPE_BINARY_KHR,
-	    (cl_semaphore_properties_khr) CL_SEMAPHORE_DEVICE_HANDLE_LIST_KHR,
-	    (cl_semaphore_properties_khr) opencl_objects.device_id,
-	    (cl_semaphore_properties_khr) CL_SEMAPHORE_DEVICE_HANDLE_LIST_END_KHR,
+	auto import_semaphore = [&](const vkb::ExternalSemaphore &semaphore) {
+		std::vector<cl_semaphore_properties_khr> semaphore_properties{
+		    (cl_semaphore_properties_khr) CL_SEMAPHORE_TYPE_KHR,
+		    (cl_semaphore_properties_khr) CL_SEMAPHORE_TYPE_BINARY_KHR,
+		    (cl_semaphore_properties_khr) CL_SEMAPHORE_DEVICE_HANDLE_LIST_KHR,
+		    (cl_semaphore_properties_khr) opencl_objects.device_id,
+		    (cl_semaphore_properties_khr) CL_SEMAPHORE_DEVICE_HANDLE_LIST_END_KHR,
+		    semaphore_handle_type,
+		    (cl_semaphore_properties_khr) semaphore.export_handle(),
+		    0};
+
+		cl_int           cl_result;
+		cl_semaphore_khr cl_semaphore = clCreateSemaphoreWithPropertiesKHR(opencl_objects.context, semaphore_properties.data(), &cl_result);
+		CL_CHECK(cl_result);
+		return cl_semaphore;
 	};
 
-	// CL to VK semaphore
-
-#ifdef _WIN32
-	semaphore_properties.push_back((cl_semaphore_properties_khr) CL_SEMAPHORE_HANDLE_OPAQUE_WIN32_KHR);
-	HANDLE handle = get_vulkan_semaphore_handle(cl_update_vk_semaphore);
-	semaphore_properties.push_back((cl_semaphore_properties_khr) handle);
-#else
-	semaphore_properties.push_back((cl_semaphore_properties_khr) CL_SEMAPHORE_HANDLE_OPAQUE_FD_KHR);
-	int fd = get_vulkan_semaphore_handle(cl_update_vk_semaphore);
-	semaphore_properties.push_back((cl_semaphore_properties_khr) fd);
-#endif
-	semaphore_properties.push_back(0);
-
-	cl_int cl_result;
-
-	opencl_objects.cl_update_vk_semaphore = clCreateSemaphoreWithPropertiesKHR(opencl_objects.context, semaphore_properties.data(), &cl_result);
-	CL_CHECK(cl_result);
+	opencl_objects.slots.resize(shared_image_count);
 
-	// Remove the last two entries so we can push the next handle and zero terminator to the properties list and re-use the other values
-	semaphore_properties.pop_back();
-	semaphore_properties.pop_back();
-
-	// VK to CL semaphore
-#ifdef _WIN32
-	handle = get_vulkan_semaphore_handle(vk_update_cl_semaphore);
-	semaphore_properties.push_back((cl_semaphore_properties_khr) handle);
-#else
-	fd = get_vulkan_semaphore_handle(vk_update_cl_semaphore);
-	semaphore_properties.push_back((cl_semaphore_properties_khr) fd);
-#endif
-	semaphore_properties.push_back(0);
-
-	opencl_objects.vk_update_cl_semaphore = clCreateSemaphoreWithPropertiesKHR(opencl_objects.context, semaphore_properties.data(), &cl_result);
-	CL_CHECK(cl_result);
+	for (uint32_t i = 0; i < shared_image_count; i++)
+	{
+		auto &slot = shared_images->get_slot(i);
+
+		std::vector<cl_mem_properties> mem_properties{
+		    memory_handle_type,
+		    (cl_mem_properties) slot.image->export_memory_handle(),
+		    (cl_mem_properties) CL_MEM_DEVICE_HANDLE_LIST_KHR,
+		    (cl_mem_properties) opencl_objects.device_id,
+		    (cl_mem_properties) CL_MEM_DEVICE_HANDLE_LIST_END_KHR,
+		    0};
+
+		int cl_result;
+		opencl_objects.slots[i].image = clCreateImageWithProperties(opencl_objects.context,
+		                                                            mem_properties.data(),
+		                                                            CL_MEM_READ_WRITE,
+		                                                            &cl_img_fmt,
+		                                                            &cl_img_desc,
+		                                                            NULL,
+		                                                            &cl_result);
+		CL_CHECK(cl_result);
+
+		opencl_objects.slots[i].produced = import_semaphore(*slot.produced);
+		opencl_objects.slots[i].consumed = import_semaphore(*slot.consumed);
+	}
 }
 
 void OpenCLInterop::prepare_opencl_resources()
@@ -893,17 +728,20 @@ bool OpenCLInterop::prepare(const vkb::ApplicationOptions &options)
 	}
 
 	prepare_opencl_resources();
-	prepare_sync_objects();
-	prepare_shared_image();
+	prepare_shared_images();
 	generate_quad();
 	prepare_uniform_buffers();
 	setup_descriptor_set_layout();
 	prepare_pipelines();
 	setup_descriptor_pool();
 	setup_descriptor_set();
-	build_command_buffers();
 
 	opencl_objects.initialized = true;
+
+	// OpenCL starts filling the ring before the first frame consumes it
+	produce_shared_images();
+
+	build_command_buffers();
 	prepared                   = true;
 	return true;
 }
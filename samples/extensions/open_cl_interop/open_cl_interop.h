@@ -1,4 +1,4 @@
-/* Copyright (c) 2023-2024, Sascha Willems
+/* Copyright (c) 2023-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "api_vulkan_sample.h"
+#include "core/external_memory.h"
 #include "rendering/render_pipeline.h"
 #include "scene_graph/components/camera.h"
 
@@ -47,12 +48,14 @@ class OpenCLInterop : public ApiVulkanSample
 	void render(float delta_time) override;
 	void view_changed() override;
 	void build_command_buffers() override;
+	void build_command_buffer(uint32_t index) override;
+	void on_update_ui_overlay(vkb::Drawer &drawer) override;
 
   private:
 	void prepare_pipelines();
 	void prepare_opencl_resources();
-	void prepare_shared_image();
-	void prepare_sync_objects();
+	void prepare_shared_images();
+	void produce_shared_images();
 	void generate_quad();
 	void setup_descriptor_pool();
 	void setup_descriptor_set_layout();
@@ -60,14 +63,6 @@ class OpenCLInterop : public ApiVulkanSample
 	void prepare_uniform_buffers();
 	void update_uniform_buffers();
 
-#ifdef _WIN32
-	HANDLE get_vulkan_memory_handle(VkDeviceMemory memory);
-	HANDLE get_vulkan_semaphore_handle(VkSemaphore &sempahore);
-#else
-	int get_vulkan_memory_handle(VkDeviceMemory memory);
-	int get_vulkan_semaphore_handle(VkSemaphore &sempahore);
-#endif
-
 	struct VertexStructure
 	{
 		float pos[3];
@@ -75,18 +70,16 @@ class OpenCLInterop : public ApiVulkanSample
 		float normal[3];
 	};
 
-	struct SharedImage
-	{
-		uint32_t       width{0};
-		uint32_t       height{0};
-		VkImage        image{VK_NULL_HANDLE};
-		VkDeviceMemory memory{VK_NULL_HANDLE};
-		VkDeviceSize   size{0};
-		VkDeviceSize   allocationSize{0};
-		VkSampler      sampler{VK_NULL_HANDLE};
-		VkImageView    view{VK_NULL_HANDLE};
+	// OpenCL fills one image of the ring while Vulkan displays another
+	static constexpr uint32_t shared_image_count{3};
+	static constexpr uint32_t shared_image_width{512};
+	static constexpr uint32_t shared_image_height{512};
+
+	std::unique_ptr<vkb::SharedResourceRing> shared_images;
+	VkSampler                                shared_image_sampler{VK_NULL_HANDLE};
 
-	} shared_image;
+	// The slot of the ring displayed by the current frame
+	uint32_t displayed_slot{0};
 
 	struct UniformBufferData
 	{
@@ -95,38 +88,41 @@ class OpenCLInterop : public ApiVulkanSample
 		glm::vec4 view_pos;
 	} ubo_vs;
 
-	struct OpenCLObjects
+	// The image and the semaphores of a slot of the ring, imported into OpenCL
+	struct OpenCLSlot
 	{
-		cl_context       context{nullptr};
-		cl_device_id     device_id{nullptr};
-		cl_command_queue command_queue{nullptr};
-		cl_program       program{nullptr};
-		cl_kernel        kernel{nullptr};
 		cl_mem           image{nullptr};
-		cl_semaphore_khr cl_update_vk_semaphore{nullptr};
-		cl_semaphore_khr vk_update_cl_semaphore{nullptr};
-		bool             initialized{false};
-	} opencl_objects{};
+		cl_semaphore_khr produced{nullptr};
+		cl_semaphore_khr consumed{nullptr};
+	};
 
-	bool first_submit{true};
+	struct OpenCLObjects
+	{
+		cl_context              context{nullptr};
+		cl_device_id            device_id{nullptr};
+		cl_command_queue        command_queue{nullptr};
+		cl_program              program{nullptr};
+		cl_kernel               kernel{nullptr};
+		std::vector<OpenCLSlot> slots;
+		bool                    initialized{false};
+	} opencl_objects{};
 
-	VkPipeline            pipeline{VK_NULL_HANDLE};
-	VkPipelineLayout      pipeline_layout{VK_NULL_HANDLE};
-	VkDescriptorSet       descriptor_set{VK_NULL_HANDLE};
-	VkDescriptorSetLayout descriptor_set_layout{VK_NULL_HANDLE};
+	VkPipeline                   pipeline{VK_NULL_HANDLE};
+	VkPipelineLayout             pipeline_layout{VK_NULL_HANDLE};
+	std::vector<VkDescriptorSet> descriptor_sets;
+	VkDescriptorSetLayout        descriptor_set_layout{VK_NULL_HANDLE};
 
 	std::unique_ptr<vkb::core::Buffer> vertex_buffer;
 	std::unique_ptr<vkb::core::Buffer> index_buffer;
 	uint32_t                           index_count{0};
 	std::unique_ptr<vkb::core::Buffer> uniform_buffer_vs;
 
-	// @todo: rename
-	VkSemaphore cl_update_vk_semaphore{VK_NULL_HANDLE};
-	VkSemaphore vk_update_cl_semaphore{VK_NULL_HANDLE};
-
-	VkFence rendering_finished_fence{VK_NULL_HANDLE};
-
 	float total_time_passed{0};
+
+	// Throughput of the shared path, images produced by OpenCL and displayed by Vulkan per second
+	float    throughput_time{0.0f};
+	uint64_t throughput_produced_count{0};
+	float    shared_images_per_second{0.0f};
 };
 
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_open_cl_interop();
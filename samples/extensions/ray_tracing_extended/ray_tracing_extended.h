@@ -26,6 +26,7 @@
 #include "api_vulkan_sample.h"
 #include "glsl_compiler.h"
 #include <core/acceleration_structure.h>
+#include <core/acceleration_structure_builder.h>
 
 class RaytracingExtended : public ApiVulkanSample
 {
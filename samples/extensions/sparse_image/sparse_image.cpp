@@ -17,18 +17,30 @@
 
 #include "sparse_image.h"
 
+#include <iterator>
+#include <limits>
+
 SparseImage::SparseImage()
 {
 	title = "Sparse Image";
 	setup_camera();
+
+	// The binds of the sparse queue are ordered with the graphics queue by timeline semaphores
+	add_instance_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+	add_device_extension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
 }
 
 SparseImage::~SparseImage()
 {
 	if (has_device())
 	{
-		vkDestroySemaphore(get_device().get_handle(), submit_semaphore, nullptr);
-		vkDestroySemaphore(get_device().get_handle(), bound_semaphore, nullptr);
+		vkDeviceWaitIdle(get_device().get_handle());
+		for (auto &submission : pending_submissions)
+		{
+			vkFreeCommandBuffers(get_device().get_handle(), get_device().get_command_pool().get_handle(), 1U, &submission.command_buffer);
+		}
+		vkDestroySemaphore(get_device().get_handle(), sparse_bind_scheduler.render_timeline, nullptr);
+		vkDestroySemaphore(get_device().get_handle(), sparse_bind_scheduler.bind_timeline, nullptr);
 		vkDestroyPipeline(get_device().get_handle(), sample_pipeline, nullptr);
 		vkDestroyPipelineLayout(get_device().get_handle(), sample_pipeline_layout, nullptr);
 		vkDestroyDescriptorSetLayout(get_device().get_handle(), descriptor_set_layout, nullptr);
@@ -179,56 +191,192 @@ void SparseImage::setup_camera()
 }
 
 /**
- * 	@brief Fill up the information on how the sparse image should be bound and call vkQueueBindSparse.
+ * 	@brief Allocate memory for the pages required and not bound yet, release the pages not required anymore, and queue the changed binds.
+ * 	       At most budget pages are newly bound, in the order of the page table, which is the order the pages are uploaded in.
  */
-void SparseImage::bind_sparse_image()
+void SparseImage::schedule_sparse_binds(size_t budget)
 {
+	auto &scheduler = sparse_bind_scheduler;
+
 	for (size_t page_index = 0U; page_index < virtual_texture.page_table.size(); page_index++)
 	{
 		auto &page = virtual_texture.page_table[page_index];
+		auto &bind = virtual_texture.sparse_image_memory_bind[page_index];
+
 		if (!page.gen_mip_required && page.render_required_set.empty())
 		{
-			virtual_texture.sparse_image_memory_bind[page_index].memory = VK_NULL_HANDLE;
+			// Valid pages keep their memory until free_unused_memory() releases it, they may be required again before
+			if (page.valid)
+			{
+				continue;
+			}
+
+			// A page released before its data was uploaded still holds its allocation
+			if (page.page_memory_info.memory_sector)
+			{
+				page.page_memory_info.memory_sector->available_offsets.insert(page.page_memory_info.offset);
+				page.page_memory_info.memory_sector->virt_page_indices.erase(page_index);
+				scheduler.released_sectors.push_back(std::move(page.page_memory_info.memory_sector));
+			}
+
+			if (bind.memory != VK_NULL_HANDLE)
+			{
+				bind.memory                         = VK_NULL_HANDLE;
+				scheduler.pending_binds[page_index] = bind;
+			}
+			continue;
+		}
+
+		if (page.valid || page.page_memory_info.memory_sector)
+		{
 			continue;
 		}
 
-		if (page.valid)
+		if (budget == 0U)
 		{
 			continue;
 		}
+		budget--;
 
 		virtual_texture.memory_allocations.get_allocation(page.page_memory_info, page_index);
 
-		virtual_texture.sparse_image_memory_bind[page_index].memory       = page.page_memory_info.memory_sector->memory;
-		virtual_texture.sparse_image_memory_bind[page_index].memoryOffset = page.page_memory_info.offset;
+		bind.memory                         = page.page_memory_info.memory_sector->memory;
+		bind.memoryOffset                   = page.page_memory_info.offset;
+		scheduler.pending_binds[page_index] = bind;
+	}
+}
+
+/**
+ * 	@brief Submit the binds queued since the last batch in a single vkQueueBindSparse, without waiting for it on the host.
+ */
+void SparseImage::submit_sparse_binds()
+{
+	auto &scheduler = sparse_bind_scheduler;
+
+	if (scheduler.pending_binds.empty())
+	{
+		return;
 	}
 
-	VkBindSparseInfo bind_sparse_info = vkb::initializers::bind_sparse_info();
-	bind_sparse_info.bufferBindCount  = 0U;
-	bind_sparse_info.pBufferBinds     = nullptr;
+	std::vector<VkSparseImageMemoryBind> binds;
+	binds.reserve(scheduler.pending_binds.size());
+	for (auto &pending_bind : scheduler.pending_binds)
+	{
+		binds.push_back(pending_bind.second);
+	}
 
 	VkSparseImageMemoryBindInfo sparse_image_memory_bind_info{};
 	sparse_image_memory_bind_info.image     = virtual_texture.texture_image;
-	sparse_image_memory_bind_info.bindCount = static_cast<uint32_t>(virtual_texture.sparse_image_memory_bind.size());
-	sparse_image_memory_bind_info.pBinds    = virtual_texture.sparse_image_memory_bind.data();
+	sparse_image_memory_bind_info.bindCount = static_cast<uint32_t>(binds.size());
+	sparse_image_memory_bind_info.pBinds    = binds.data();
+
+	// The old memory of the pages may still be read by the graphics submissions so far
+	uint64_t wait_value   = scheduler.render_value;
+	uint64_t signal_value = ++scheduler.bind_value;
+
+	VkTimelineSemaphoreSubmitInfoKHR timeline_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+	timeline_info.waitSemaphoreValueCount   = 1U;
+	timeline_info.pWaitSemaphoreValues      = &wait_value;
+	timeline_info.signalSemaphoreValueCount = 1U;
+	timeline_info.pSignalSemaphoreValues    = &signal_value;
+
+	VkBindSparseInfo bind_sparse_info     = vkb::initializers::bind_sparse_info();
+	bind_sparse_info.pNext                = &timeline_info;
+	bind_sparse_info.imageBindCount       = 1U;
+	bind_sparse_info.pImageBinds          = &sparse_image_memory_bind_info;
+	bind_sparse_info.waitSemaphoreCount   = 1U;
+	bind_sparse_info.pWaitSemaphores      = &scheduler.render_timeline;
+	bind_sparse_info.signalSemaphoreCount = 1U;
+	bind_sparse_info.pSignalSemaphores    = &scheduler.bind_timeline;
 
-	bind_sparse_info.imageBindCount = 1U;
-	bind_sparse_info.pImageBinds    = &sparse_image_memory_bind_info;
+	VK_CHECK(vkQueueBindSparse(sparse_queue, 1U, &bind_sparse_info, VK_NULL_HANDLE));
 
-	bind_sparse_info.signalSemaphoreCount = 1U;
-	bind_sparse_info.pSignalSemaphores    = &bound_semaphore;
-	bind_sparse_info.waitSemaphoreCount   = 1U;
-	bind_sparse_info.pWaitSemaphores      = &submit_semaphore;
+	scheduler.pending_binds.clear();
 
-	VkFence           fence;
-	VkFenceCreateInfo fence_info{};
-	fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-	fence_info.flags = VK_FLAGS_NONE;
+	if (!scheduler.released_sectors.empty())
+	{
+		scheduler.retired_sectors.emplace_back(signal_value, std::move(scheduler.released_sectors));
+		scheduler.released_sectors.clear();
+	}
+}
 
-	VK_CHECK(vkCreateFence(get_device().get_handle(), &fence_info, nullptr, &fence));
-	vkQueueBindSparse(sparse_queue, 1U, &bind_sparse_info, fence);
-	VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &fence, VK_TRUE, DEFAULT_FENCE_TIMEOUT));
-	vkDestroyFence(get_device().get_handle(), fence, nullptr);
+/**
+ * 	@brief Submit a command buffer updating the texture to the graphics queue, after the binds submitted so far.
+ * 	       The command buffer and its staging buffer are released by retire_submissions() once the GPU is done with them.
+ */
+void SparseImage::submit_texture_update(VkCommandBuffer command_buffer, std::unique_ptr<vkb::core::Buffer> staging_buffer)
+{
+	auto &scheduler = sparse_bind_scheduler;
+
+	submit_sparse_binds();
+
+	VK_CHECK(vkEndCommandBuffer(command_buffer));
+
+	uint64_t wait_value   = scheduler.bind_value;
+	uint64_t signal_value = ++scheduler.render_value;
+
+	VkTimelineSemaphoreSubmitInfoKHR timeline_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+	timeline_info.waitSemaphoreValueCount   = 1U;
+	timeline_info.pWaitSemaphoreValues      = &wait_value;
+	timeline_info.signalSemaphoreValueCount = 1U;
+	timeline_info.pSignalSemaphoreValues    = &signal_value;
+
+	VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+	VkSubmitInfo update_submit_info         = vkb::initializers::submit_info();
+	update_submit_info.pNext                = &timeline_info;
+	update_submit_info.waitSemaphoreCount   = 1U;
+	update_submit_info.pWaitSemaphores      = &scheduler.bind_timeline;
+	update_submit_info.pWaitDstStageMask    = &wait_stage_mask;
+	update_submit_info.commandBufferCount   = 1U;
+	update_submit_info.pCommandBuffers      = &command_buffer;
+	update_submit_info.signalSemaphoreCount = 1U;
+	update_submit_info.pSignalSemaphores    = &scheduler.render_timeline;
+
+	VK_CHECK(vkQueueSubmit(queue, 1U, &update_submit_info, VK_NULL_HANDLE));
+
+	pending_submissions.push_back({signal_value, command_buffer, std::move(staging_buffer)});
+}
+
+/**
+ * 	@brief Release the command buffers, staging buffers and memory sectors the GPU is done with.
+ */
+void SparseImage::retire_submissions()
+{
+	auto &scheduler = sparse_bind_scheduler;
+
+	uint64_t render_value = 0U;
+	VK_CHECK(vkGetSemaphoreCounterValueKHR(get_device().get_handle(), scheduler.render_timeline, &render_value));
+
+	while (!pending_submissions.empty() && pending_submissions.front().render_value <= render_value)
+	{
+		vkFreeCommandBuffers(get_device().get_handle(), get_device().get_command_pool().get_handle(), 1U, &pending_submissions.front().command_buffer);
+		pending_submissions.pop_front();
+	}
+
+	uint64_t bind_value = 0U;
+	VK_CHECK(vkGetSemaphoreCounterValueKHR(get_device().get_handle(), scheduler.bind_timeline, &bind_value));
+
+	while (!scheduler.retired_sectors.empty() && scheduler.retired_sectors.front().first <= bind_value)
+	{
+		scheduler.retired_sectors.pop_front();
+	}
+}
+
+/**
+ * 	@brief Create the timeline semaphores ordering the binds of the sparse queue with the graphics queue.
+ */
+void SparseImage::create_timeline_semaphores()
+{
+	VkSemaphoreTypeCreateInfoKHR type_create_info{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR};
+	type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+	type_create_info.initialValue  = 0U;
+
+	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
+	semaphore_create_info.pNext                 = &type_create_info;
+
+	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &sparse_bind_scheduler.bind_timeline));
+	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &sparse_bind_scheduler.render_timeline));
 }
 
 /**
@@ -533,17 +681,35 @@ void SparseImage::process_texture_blocks()
 }
 
 /**
- * 	@brief Bind the image, update all of the required pages by either loading the original data via staging buffer or generating mipmaps.
+ * 	@brief Bind the image, update the required pages by either loading the original data via staging buffer or generating mipmaps.
+ * 	       At most pages_per_frame pages are updated, in order so that the pages a mip is generated from are updated first,
+ * 	       the others are left in the update_set for the next frames.
  */
 void SparseImage::update_and_generate()
 {
-	bind_sparse_image();
+	schedule_sparse_binds(pages_per_frame);
 	uint8_t current_mip_level = 0xFF;
 
 	std::vector<uint8_t> temp_buffer(virtual_texture.page_size);
 
+	// The pages bound so far, up to the first one whose bind is left for a later frame
+	std::vector<size_t> update_pages;
+	for (auto page_index : virtual_texture.update_set)
+	{
+		if (update_pages.size() == pages_per_frame || !virtual_texture.page_table[page_index].page_memory_info.memory_sector)
+		{
+			break;
+		}
+		update_pages.push_back(page_index);
+	}
+
+	if (update_pages.empty())
+	{
+		return;
+	}
+
 	size_t level_zero_count = std::count_if(
-	    virtual_texture.update_set.begin(), virtual_texture.update_set.end(), [this](auto page_index) { return get_mip_level(page_index) == 0; });
+	    update_pages.begin(), update_pages.end(), [this](auto page_index) { return get_mip_level(page_index) == 0; });
 	size_t level_zero_index = 0;
 
 	std::unique_ptr<vkb::core::Buffer> multi_page_buffer;
@@ -554,7 +720,7 @@ void SparseImage::update_and_generate()
 
 	VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
 
-	for (auto page_index : virtual_texture.update_set)
+	for (auto page_index : update_pages)
 	{
 		uint8_t mip_level = get_mip_level(page_index);
 
@@ -654,7 +820,7 @@ void SparseImage::update_and_generate()
 			virtual_texture.page_table[page_index].valid = true;
 		}
 	}
-	virtual_texture.update_set.clear();
+	virtual_texture.update_set.erase(virtual_texture.update_set.begin(), std::next(virtual_texture.update_set.begin(), update_pages.size()));
 
 	VkImageSubresourceRange subresource_range{};
 
@@ -674,11 +840,14 @@ void SparseImage::update_and_generate()
 		}
 	}
 
-	get_device().flush_command_buffer(command_buffer, queue, true);
+	submit_texture_update(command_buffer, std::move(multi_page_buffer));
 
-	for (auto &page : virtual_texture.page_table)
+	if (virtual_texture.update_set.empty())
 	{
-		page.gen_mip_required = false;
+		for (auto &page : virtual_texture.page_table)
+		{
+			page.gen_mip_required = false;
+		}
 	}
 }
 
@@ -687,6 +856,8 @@ void SparseImage::update_and_generate()
  */
 void SparseImage::free_unused_memory()
 {
+	auto &scheduler = sparse_bind_scheduler;
+
 	for (size_t page_index = 0U; page_index < virtual_texture.page_table.size(); page_index++)
 	{
 		auto &page = virtual_texture.page_table[page_index];
@@ -695,7 +866,7 @@ void SparseImage::free_unused_memory()
 			page.valid  = false;
 			auto result = page.page_memory_info.memory_sector->available_offsets.insert(page.page_memory_info.offset);
 			page.page_memory_info.memory_sector->virt_page_indices.erase(page_index);
-			page.page_memory_info.memory_sector.reset();
+			scheduler.released_sectors.push_back(std::move(page.page_memory_info.memory_sector));
 		}
 	}
 
@@ -774,40 +945,38 @@ void SparseImage::free_unused_memory()
 
 		vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, subresource_range);
 		vkCmdCopyImageToBuffer(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, reallocation_buffer->get_handle(), static_cast<uint32_t>(copy_infos.size()), copy_infos.data());
-		get_device().flush_command_buffer(command_buffer, queue, true);
+		submit_texture_update(command_buffer);
 
-		std::vector<std::shared_ptr<MemSector>> temp_sectors;
+		// The old sectors are read by the copy above, they are released once the binds moving their pages are done
 		for (auto &page_index : pages_to_reallocate)
 		{
 			auto &page = virtual_texture.page_table[page_index];
 
-			temp_sectors.push_back(page.page_memory_info.memory_sector);
-
 			page.page_memory_info.memory_sector->virt_page_indices.erase(page_index);
-			page.page_memory_info.memory_sector.reset();
+			scheduler.released_sectors.push_back(std::move(page.page_memory_info.memory_sector));
 			page.valid = false;
 		}
 
+		// The pages moved hold data, so they are all bound again whatever the budget
 		sectors.sort(MemSectorCompare());
-		bind_sparse_image();
+		schedule_sparse_binds(std::numeric_limits<size_t>::max());
 
 		command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
 
 		vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range);
 		vkCmdCopyBufferToImage(command_buffer, reallocation_buffer->get_handle(), virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copy_infos.size()), copy_infos.data());
 		vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
-		get_device().flush_command_buffer(command_buffer, queue, true);
+		submit_texture_update(command_buffer, std::move(reallocation_buffer));
 
 		for (auto &page_index : pages_to_reallocate)
 		{
 			virtual_texture.page_table[page_index].valid = true;
 		}
-		temp_sectors.clear();
 	}
 	else
 	{
 		sectors.sort(MemSectorCompare());
-		bind_sparse_image();
+		schedule_sparse_binds(pages_per_frame);
 	}
 }
 
@@ -822,12 +991,11 @@ void SparseImage::load_least_detailed_level()
 	{
 		process_texture_blocks();
 	}
-	VkSubmitInfo submit_info         = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-	submit_info.signalSemaphoreCount = 1;
-	submit_info.pSignalSemaphores    = &submit_semaphore;
-	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
 
-	update_and_generate();
+	do
+	{
+		update_and_generate();
+	} while (!virtual_texture.update_set.empty());
 }
 
 /**
@@ -842,14 +1010,14 @@ void SparseImage::process_stage(Stages next_stage)
 			break;
 
 		case Stages::CalculateMipsTable:
-			bind_sparse_image();
+			schedule_sparse_binds(pages_per_frame);
 			calculate_mips_table();
 			frame_counter_per_transfer = 0U;
 			this->next_stage           = Stages::CompareMipsTable;
 			break;
 
 		case Stages::CompareMipsTable:
-			bind_sparse_image();
+			schedule_sparse_binds(pages_per_frame);
 			compare_mips_table();
 			if (update_required)
 			{
@@ -879,14 +1047,17 @@ void SparseImage::process_stage(Stages next_stage)
 			break;
 
 		case Stages::ProcessTextureBlocks:
-			bind_sparse_image();
+			schedule_sparse_binds(pages_per_frame);
 			process_texture_blocks();
 			this->next_stage = Stages::UpdateAndGenerate;
 			break;
 
 		case Stages::UpdateAndGenerate:
 			update_and_generate();
-			this->next_stage = Stages::FreeMemory;
+			if (virtual_texture.update_set.empty())
+			{
+				this->next_stage = Stages::FreeMemory;
+			}
 			break;
 
 		default:
@@ -900,14 +1071,30 @@ void SparseImage::process_stage(Stages next_stage)
  */
 void SparseImage::draw()
 {
+	auto &scheduler = sparse_bind_scheduler;
+
+	// The binds queued by the stage of this frame go in one batch
+	submit_sparse_binds();
+
 	ApiVulkanSample::prepare_frame();
 	submit_info.commandBufferCount = 1U;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
 
-	std::array<VkPipelineStageFlags, 2U> wait_stage_masks  = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-	std::array<VkSemaphore, 2U>          wait_semaphores   = {bound_semaphore, semaphores.acquired_image_ready};
-	std::array<VkSemaphore, 2U>          signal_semaphores = {submit_semaphore, semaphores.render_complete};
+	std::array<VkPipelineStageFlags, 2U> wait_stage_masks  = {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+	std::array<VkSemaphore, 2U>          wait_semaphores   = {scheduler.bind_timeline, semaphores.acquired_image_ready};
+	std::array<VkSemaphore, 2U>          signal_semaphores = {scheduler.render_timeline, semaphores.render_complete};
 
+	// The values of the binary semaphores are ignored
+	std::array<uint64_t, 2U> wait_values   = {scheduler.bind_value, 0U};
+	std::array<uint64_t, 2U> signal_values = {++scheduler.render_value, 0U};
+
+	VkTimelineSemaphoreSubmitInfoKHR timeline_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+	timeline_info.waitSemaphoreValueCount   = static_cast<uint32_t>(wait_values.size());
+	timeline_info.pWaitSemaphoreValues      = wait_values.data();
+	timeline_info.signalSemaphoreValueCount = static_cast<uint32_t>(signal_values.size());
+	timeline_info.pSignalSemaphoreValues    = signal_values.data();
+
+	submit_info.pNext              = &timeline_info;
 	submit_info.waitSemaphoreCount = wait_semaphores.size();
 
 	submit_info.pWaitSemaphores      = wait_semaphores.data();
@@ -916,6 +1103,7 @@ void SparseImage::draw()
 	submit_info.pSignalSemaphores    = signal_semaphores.data();
 
 	VK_CHECK(vkQueueSubmit(queue, 1U, &submit_info, VK_NULL_HANDLE));
+	submit_info.pNext = nullptr;
 	ApiVulkanSample::submit_frame();
 }
 
@@ -925,6 +1113,9 @@ void SparseImage::render(float delta_time)
 	{
 		return;
 	}
+
+	retire_submissions();
+
 	if (camera.updated)
 	{
 		update_mvp();
@@ -1381,6 +1572,9 @@ void SparseImage::request_gpu_features(vkb::PhysicalDevice &gpu)
 	{
 		throw std::runtime_error("Sparse binding not supported");
 	}
+
+	auto &timeline_semaphore_features = gpu.request_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR);
+	timeline_semaphore_features.timelineSemaphore = VK_TRUE;
 }
 
 /**
@@ -1564,9 +1758,7 @@ void SparseImage::create_sparse_texture_image()
 	//==================================================================================================
 	// Synchronization primitives
 
-	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &submit_semaphore));
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &bound_semaphore));
+	create_timeline_semaphores();
 }
 
 /**
@@ -1609,6 +1801,7 @@ void SparseImage::on_update_ui_overlay(vkb::Drawer &drawer)
 		drawer.checkbox("Memory defragmentation", &memory_defragmentation);
 		drawer.checkbox("Update prioritization", &frame_counter_feature);
 		drawer.slider_int("Blocks per cycle", reinterpret_cast<int32_t *>(&blocks_to_update_per_cycle), 1, 50);
+		drawer.slider_int("Pages per frame", reinterpret_cast<int32_t *>(&pages_per_frame), 1, 256);
 		drawer.slider_int("Vertical blocks", reinterpret_cast<int32_t *>(&num_vertical_blocks_upd), 1, 100);
 		drawer.slider_int("Horizontal blocks", reinterpret_cast<int32_t *>(&num_horizontal_blocks_upd), 1, 100);
 	}
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <deque>
+#include <map>
+
 #include "api_vulkan_sample.h"
 
 class SparseImage : public ApiVulkanSample
@@ -256,6 +259,39 @@ class SparseImage : public ApiVulkanSample
 		std::vector<VkSparseImageMemoryBind> sparse_image_memory_bind;
 	};
 
+	/**
+	 * @brief Coalesces the binds and unbinds of the pages of the virtual texture across frames into batched vkQueueBindSparse calls
+	 *        A batch waits for the graphics submissions before it, which may still read the old memory of its pages, and the graphics
+	 *        submissions after it wait for it, both through timeline semaphores, so that neither queue waits on the host.
+	 */
+	struct SparseBindScheduler
+	{
+		// Binds of the pages changed since the last batch, by page index, a later change of a page replaces the earlier one
+		std::map<size_t, VkSparseImageMemoryBind> pending_binds;
+
+		// Memory sectors of the pages unbound since the last batch, kept alive until the batch unbinding them is done
+		std::vector<std::shared_ptr<MemSector>> released_sectors;
+
+		// Memory sectors released by each batch, with the value of the bind timeline it signals
+		std::deque<std::pair<uint64_t, std::vector<std::shared_ptr<MemSector>>>> retired_sectors;
+
+		// Signalled by the batches of binds
+		VkSemaphore bind_timeline = VK_NULL_HANDLE;
+		uint64_t    bind_value    = 0U;
+
+		// Signalled by the submissions of the graphics queue
+		VkSemaphore render_timeline = VK_NULL_HANDLE;
+		uint64_t    render_value    = 0U;
+	};
+
+	// Command buffer submitted to the graphics queue to update the texture, and its staging buffer, until the GPU is done with them
+	struct PendingSubmission
+	{
+		uint64_t                           render_value   = 0U;
+		VkCommandBuffer                    command_buffer = VK_NULL_HANDLE;
+		std::unique_ptr<vkb::core::Buffer> staging_buffer;
+	};
+
 	struct CalculateMipLevelData
 	{
 		std::vector<std::vector<Point>>    mesh;
@@ -298,6 +334,9 @@ class SparseImage : public ApiVulkanSample
 
 	size_t blocks_to_update_per_cycle = 25U;
 
+	// Budget of the pages newly bound and of the pages uploaded or generated each frame
+	size_t pages_per_frame = 64U;
+
 	size_t num_vertical_blocks   = 50U;
 	size_t num_horizontal_blocks = 50U;
 
@@ -341,8 +380,9 @@ class SparseImage : public ApiVulkanSample
 	VkDescriptorSet       descriptor_set;
 	VkSampler             texture_sampler;
 
-	VkSemaphore bound_semaphore;
-	VkSemaphore submit_semaphore;
+	SparseBindScheduler sparse_bind_scheduler;
+
+	std::deque<PendingSubmission> pending_submissions;
 
 	//==================================================================================================
 	SparseImage();
@@ -380,7 +420,11 @@ class SparseImage : public ApiVulkanSample
 	void                      process_texture_block(const TextureBlock &on_screen_block);
 	std::vector<size_t>       get_memory_dependency_for_the_block(size_t column, size_t row, uint8_t mip_level);
 	void                      check_mip_page_requirements(std::vector<MemPageDescription> &mipgen_required_vec, MemPageDescription mip_dependency);
-	void                      bind_sparse_image();
+	void                      schedule_sparse_binds(size_t budget);
+	void                      submit_sparse_binds();
+	void                      submit_texture_update(VkCommandBuffer command_buffer, std::unique_ptr<vkb::core::Buffer> staging_buffer = nullptr);
+	void                      retire_submissions();
+	void                      create_timeline_semaphores();
 	void                      load_least_detailed_level();
 	void                      set_least_detailed_level();
 	void                      update_frag_settings();
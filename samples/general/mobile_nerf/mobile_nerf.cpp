@@ -1,4 +1,4 @@
-/* Copyright (c) 2023-2024, Qualcomm Innovation Center, Inc. All rights reserved.
+/* Copyright (c) 2023-2026, Qualcomm Innovation Center, Inc. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,7 @@
 
 #include "mobile_nerf.h"
 #include "filesystem/legacy.h"
+#include "glm/gtc/packing.hpp"
 #include "glm/gtx/matrix_decompose.hpp"
 #include "gltf_loader.h"
 #include "platform/platform.h"
@@ -29,6 +30,18 @@
 namespace
 {
 constexpr uint32_t MIN_THREAD_COUNT = 1;
+
+// Identifies the binary form of a parsed mlp.json, bump the version whenever MLP_Weights changes layout
+constexpr uint32_t MLP_CACHE_MAGIC   = 0x4D4C5043;        // "MLPC"
+constexpr uint32_t MLP_CACHE_VERSION = 1;
+
+std::string mlp_cache_name(const std::string &model_path)
+{
+	std::string name = "mobile_nerf_" + model_path;
+	std::replace_if(name.begin(), name.end(), [](char c) { return c == '/' || c == '\\'; }, '_');
+	return name + "mlp.bin";
+}
+
 struct RequestFeature
 {
 	vkb::PhysicalDevice &gpu;
@@ -100,6 +113,10 @@ MobileNerf::MobileNerf()
 	add_device_extension(VK_KHR_SPIRV_1_4_EXTENSION_NAME);
 	// Required by VK_KHR_spirv_1_4
 	add_device_extension(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME);
+
+	// Optional, allows evaluating the MLP with half precision arithmetic
+	add_instance_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+	add_device_extension(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME, true);
 }
 
 MobileNerf::~MobileNerf()
@@ -157,6 +174,7 @@ MobileNerf::~MobileNerf()
 			attachment.feature_0.destroy();
 			attachment.feature_1.destroy();
 			attachment.feature_2.destroy();
+			attachment.visibility.destroy();
 		}
 	}
 }
@@ -195,6 +213,10 @@ void MobileNerf::read_json_map()
 
             "deferred": false,
 
+            "visibility": false,
+
+            "fp16": true,
+
             "rotation": true,
 
             "lego_ball":{
@@ -320,8 +342,16 @@ void MobileNerf::read_json_map()
 		LOGW("Unrecognized feature texture type, using VK_FORMAT_R32G32B32A32_SFLOAT");
 		feature_map_format = VK_FORMAT_R32G32B32A32_SFLOAT;
 	}
-	use_deferred = raw_asset_map["deferred"].get<bool>();
-	do_rotation  = raw_asset_map["rotation"].get<bool>();
+	use_deferred          = raw_asset_map["deferred"].get<bool>();
+	use_visibility_buffer = raw_asset_map.value("visibility", false);
+	fp16_requested        = raw_asset_map.value("fp16", true);
+	do_rotation           = raw_asset_map["rotation"].get<bool>();
+
+	if (use_visibility_buffer && use_deferred)
+	{
+		LOGW("Both deferred and visibility buffer modes requested, using the visibility buffer");
+		use_deferred = false;
+	}
 
 	view_port_width  = raw_asset_map["width"].get<int>();
 	view_port_height = raw_asset_map["height"].get<int>();
@@ -366,7 +396,18 @@ void MobileNerf::read_json_map()
 void MobileNerf::load_shaders()
 {
 	// Loading first pass shaders
-	if (use_deferred)
+	if (use_visibility_buffer)
+	{
+		// The first pass only writes triangle, instance and model ids
+		shader_stages_first_pass[0] = load_shader("mobile_nerf/visibility.vert", VK_SHADER_STAGE_VERTEX_BIT);
+		shader_stages_first_pass[1] = load_shader("mobile_nerf/visibility.frag", VK_SHADER_STAGE_FRAGMENT_BIT);
+
+		// The second pass fetches the features of the visible triangle and runs the mlp once per pixel
+		shader_stages_second_pass[0] = load_shader("mobile_nerf/quad.vert", VK_SHADER_STAGE_VERTEX_BIT);
+		shader_stages_second_pass[1] = load_shader(use_fp16_mlp ? "mobile_nerf/visibility_resolve_fp16.frag" : "mobile_nerf/visibility_resolve.frag",
+		                                           VK_SHADER_STAGE_FRAGMENT_BIT);
+	}
+	else if (use_deferred)
 	{
 		// Loading first pass shaders
 		shader_stages_first_pass[0] = load_shader("mobile_nerf/raster.vert", VK_SHADER_STAGE_VERTEX_BIT);
@@ -375,18 +416,16 @@ void MobileNerf::load_shaders()
 		    VK_SHADER_STAGE_FRAGMENT_BIT);
 
 		// Loading second pass shaders
+		std::string mlp_shader = using_original_nerf_models[0] ? "mobile_nerf/mlp" : "mobile_nerf/mlp_morpheus";
 		shader_stages_second_pass[0] = load_shader("mobile_nerf/quad.vert", VK_SHADER_STAGE_VERTEX_BIT);
-		shader_stages_second_pass[1] = load_shader(
-		    using_original_nerf_models[0] ? "mobile_nerf/mlp.frag" : "mobile_nerf/mlp_morpheus.frag",
-		    VK_SHADER_STAGE_FRAGMENT_BIT);
+		shader_stages_second_pass[1] = load_shader(mlp_shader + (use_fp16_mlp ? "_fp16.frag" : ".frag"), VK_SHADER_STAGE_FRAGMENT_BIT);
 	}
 	else
 	{
 		// Loading one pass shaders
+		std::string merged_shader   = using_original_nerf_models[0] ? "mobile_nerf/merged" : "mobile_nerf/merged_morpheus";
 		shader_stages_first_pass[0] = load_shader("mobile_nerf/raster.vert", VK_SHADER_STAGE_VERTEX_BIT);
-		shader_stages_first_pass[1] = load_shader(
-		    using_original_nerf_models[0] ? "mobile_nerf/merged.frag" : "mobile_nerf/merged_morpheus.frag",
-		    VK_SHADER_STAGE_FRAGMENT_BIT);
+		shader_stages_first_pass[1] = load_shader(merged_shader + (use_fp16_mlp ? "_fp16.frag" : ".frag"), VK_SHADER_STAGE_FRAGMENT_BIT);
 	}
 }
 
@@ -402,6 +441,14 @@ bool MobileNerf::prepare(const vkb::ApplicationOptions &options)
 		initialize_mlp_uniform_buffers(i);
 	}
 
+	// The visibility buffer packs the instance and the model ids into 16 bits each
+	const auto instance_count = instancing_info.dim.x * instancing_info.dim.y * instancing_info.dim.z;
+	if (use_visibility_buffer && (instance_count > 0xFFFF || models.size() >= 0xFFFF))
+	{
+		LOGW("Too many instances or models for the visibility buffer, using forward rendering instead");
+		use_visibility_buffer = false;
+	}
+
 	if (!ApiVulkanSample::prepare(options))
 	{
 		return false;
@@ -414,9 +461,16 @@ bool MobileNerf::prepare(const vkb::ApplicationOptions &options)
 		use_native_screen_size = true;
 	}
 
+	use_fp16_mlp = fp16_requested && fp16_supported;
+	LOGI("Evaluating the MLP with {} precision", use_fp16_mlp ? "half" : "full");
+
 	load_shaders();
 
-	if (use_deferred)
+	if (use_visibility_buffer)
+	{
+		update_render_pass_nerf_visibility();
+	}
+	else if (use_deferred)
 	{
 		update_render_pass_nerf_baseline();
 	}
@@ -453,7 +507,15 @@ bool MobileNerf::prepare(const vkb::ApplicationOptions &options)
 	}
 	create_uniforms();
 	prepare_instance_data();
-	create_pipeline_layout_fist_pass();
+
+	if (use_visibility_buffer)
+	{
+		create_pipeline_layout_visibility();
+	}
+	else
+	{
+		create_pipeline_layout_fist_pass();
+	}
 
 	if (use_deferred)
 	{
@@ -463,7 +525,14 @@ bool MobileNerf::prepare(const vkb::ApplicationOptions &options)
 
 	for (auto &model : models)
 	{
-		create_descriptor_sets_first_pass(model);
+		if (use_visibility_buffer)
+		{
+			create_descriptor_sets_visibility(model);
+		}
+		else
+		{
+			create_descriptor_sets_first_pass(model);
+		}
 	}
 
 	if (use_deferred)
@@ -487,6 +556,13 @@ bool MobileNerf::resize(const uint32_t width, const uint32_t height)
 
 void MobileNerf::request_gpu_features(vkb::PhysicalDevice &gpu)
 {
+	// Half precision MLP evaluation only needs shaderFloat16, as the weights are packed into 32-bit words in the uniform buffer
+	if (gpu.is_extension_supported(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME))
+	{
+		auto &float16_int8_features =
+		    gpu.request_extension_features<VkPhysicalDeviceShaderFloat16Int8FeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR);
+		fp16_supported = float16_int8_features.shaderFloat16 == VK_TRUE;
+	}
 }
 
 void MobileNerf::render(float delta_time)
@@ -580,7 +656,16 @@ void MobileNerf::setup_attachment(VkFormat format, VkImageUsageFlags usage, Fram
 
 void MobileNerf::setup_nerf_framebuffer_baseline()
 {
-	if (use_deferred)
+	if (use_visibility_buffer)
+	{
+		frameAttachments.resize(get_render_context().get_render_frames().size());
+
+		for (auto i = 0; i < frameAttachments.size(); i++)
+		{
+			setup_attachment(VK_FORMAT_R32G32_UINT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT, frameAttachments[i].visibility);
+		}
+	}
+	else if (use_deferred)
 	{
 		frameAttachments.resize(get_render_context().get_render_frames().size());
 
@@ -606,7 +691,12 @@ void MobileNerf::setup_nerf_framebuffer_baseline()
 
 	std::vector<VkImageView> views;
 
-	if (use_deferred)
+	if (use_visibility_buffer)
+	{
+		views.resize(3);
+		views[1] = depth_stencil.view;
+	}
+	else if (use_deferred)
 	{
 		views.resize(5);
 		views[3] = depth_stencil.view;
@@ -633,7 +723,12 @@ void MobileNerf::setup_nerf_framebuffer_baseline()
 
 	for (uint32_t i = 0; i < nerf_framebuffers.size(); i++)
 	{
-		if (use_deferred)
+		if (use_visibility_buffer)
+		{
+			views[0] = frameAttachments[i].visibility.view;
+			views[2] = swapchain_buffers[i].view;
+		}
+		else if (use_deferred)
 		{
 			views[0] = frameAttachments[i].feature_0.view;
 			views[1] = frameAttachments[i].feature_1.view;
@@ -698,7 +793,11 @@ void MobileNerf::build_command_buffers_baseline()
 	{
 		setup_nerf_framebuffer_baseline();
 
-		if (use_deferred)
+		if (use_visibility_buffer)
+		{
+			update_descriptor_sets_visibility();
+		}
+		else if (use_deferred)
 		{
 			update_descriptor_sets_baseline();
 		}
@@ -707,7 +806,14 @@ void MobileNerf::build_command_buffers_baseline()
 	VkCommandBufferBeginInfo  command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
 	std::vector<VkClearValue> clear_values;
 
-	if (use_deferred)
+	if (use_visibility_buffer)
+	{
+		clear_values.resize(3);
+		clear_values[0].color        = {{0.0f, 0.0f, 0.0f, 0.0f}};        // model id 0 marks empty pixels
+		clear_values[1].depthStencil = {1.0f, 0};
+		clear_values[2].color        = {{1.0f, 1.0f, 1.0f, 0.5f}};        // default_clear_color;
+	}
+	else if (use_deferred)
 	{
 		clear_values.resize(5);
 		clear_values[0].color        = {{0.025f, 0.025f, 0.025f, 0.5f}};        // default_clear_color;
@@ -764,19 +870,47 @@ void MobileNerf::build_command_buffers_baseline()
 		vkCmdSetScissor(draw_cmd_buffers[i], 0, 1, &scissor);
 
 		auto &ii = instancing_info;
-		for (auto &model : models)
+
+		if (use_visibility_buffer)
 		{
-			vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, model.pipeline_first_pass);
-			// If deferred, only use the first descriptor bounded with the model
-			// If forward, each model has the swapchan number of descriptor
-			int descriptorIndex = use_deferred ? 0 : i;
-			vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_first_pass_layout,
-			                        0, 1, &model.descriptor_set_first_pass[descriptorIndex], 0, nullptr);
-			VkDeviceSize offsets[1] = {0};
-			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, model.vertex_buffer->get(), offsets);
-			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, instance_buffer->get(), offsets);
-			vkCmdBindIndexBuffer(draw_cmd_buffers[i], model.index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
-			vkCmdDrawIndexed(draw_cmd_buffers[i], static_cast<uint32_t>(model.indices.size()) * 3, ii.dim.x * ii.dim.y * ii.dim.z, 0, 0, 0);
+			// First sub pass writes the ids of the visible triangles, the mesh is pulled from storage buffers
+			for (uint32_t model_id = 0; model_id < models.size(); model_id++)
+			{
+				auto &model = models[model_id];
+				vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, model.pipeline_first_pass);
+				vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_first_pass_layout,
+				                        0, 1, &model.descriptor_set_first_pass[i], 0, nullptr);
+				vkCmdPushConstants(draw_cmd_buffers[i], pipeline_first_pass_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(model_id), &model_id);
+				vkCmdDraw(draw_cmd_buffers[i], static_cast<uint32_t>(model.indices.size()) * 3, ii.dim.x * ii.dim.y * ii.dim.z, 0, 0);
+			}
+
+			// Second sub pass resolves each model with its own textures and mlp weights, pixels of other models are discarded
+			vkCmdNextSubpass(draw_cmd_buffers[i], VK_SUBPASS_CONTENTS_INLINE);
+			vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_baseline);
+			for (uint32_t model_id = 0; model_id < models.size(); model_id++)
+			{
+				vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_first_pass_layout,
+				                        0, 1, &models[model_id].descriptor_set_first_pass[i], 0, nullptr);
+				vkCmdPushConstants(draw_cmd_buffers[i], pipeline_first_pass_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(model_id), &model_id);
+				vkCmdDraw(draw_cmd_buffers[i], 3, 1, 0, 0);
+			}
+		}
+		else
+		{
+			for (auto &model : models)
+			{
+				vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, model.pipeline_first_pass);
+				// If deferred, only use the first descriptor bounded with the model
+				// If forward, each model has the swapchan number of descriptor
+				int descriptorIndex = use_deferred ? 0 : i;
+				vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_first_pass_layout,
+				                        0, 1, &model.descriptor_set_first_pass[descriptorIndex], 0, nullptr);
+				VkDeviceSize offsets[1] = {0};
+				vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, model.vertex_buffer->get(), offsets);
+				vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, instance_buffer->get(), offsets);
+				vkCmdBindIndexBuffer(draw_cmd_buffers[i], model.index_buffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
+				vkCmdDrawIndexed(draw_cmd_buffers[i], static_cast<uint32_t>(model.indices.size()) * 3, ii.dim.x * ii.dim.y * ii.dim.z, 0, 0, 0);
+			}
 		}
 
 		if (use_deferred)
@@ -879,7 +1013,21 @@ void MobileNerf::load_scene(int model_index, int sub_model_index, int models_ent
 
 void MobileNerf::create_descriptor_pool()
 {
-	if (use_deferred)
+	if (use_visibility_buffer)
+	{
+		// Each model has one set per frame buffer, holding both passes' resources
+		const uint32_t set_count = static_cast<uint32_t>(models.size()) * static_cast<uint32_t>(framebuffers.size());
+
+		std::vector<VkDescriptorPoolSize> pool_sizes = {
+		    {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1 * set_count},
+		    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 * set_count},
+		    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 * set_count},
+		    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * set_count}};
+
+		VkDescriptorPoolCreateInfo descriptor_pool_create_info = vkb::initializers::descriptor_pool_create_info(pool_sizes, set_count);
+		VK_CHECK(vkCreateDescriptorPool(get_device().get_handle(), &descriptor_pool_create_info, nullptr, &descriptor_pool));
+	}
+	else if (use_deferred)
 	{
 		std::vector<VkDescriptorPoolSize> pool_sizes = {
 		    // First Pass
@@ -932,6 +1080,42 @@ void MobileNerf::create_pipeline_layout_fist_pass()
 	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &pipeline_layout_create_info, nullptr, &pipeline_first_pass_layout));
 }
 
+void MobileNerf::create_pipeline_layout_visibility()
+{
+	// Both visibility passes share one layout, the second pass reads the id written by the first one
+	VkShaderStageFlags all_stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	std::vector<VkDescriptorSetLayoutBinding> set_layout_bindings = {
+	    // Triangle, instance and model ids
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_SHADER_STAGE_FRAGMENT_BIT, 0),
+	    // Feature textures
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1),
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 2),
+	    // MLP weights
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT, 3),
+	    // Camera
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, all_stages, 4),
+	    // Vertices, indices and instance offsets
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, all_stages, 5),
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, all_stages, 6),
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, all_stages, 7)};
+
+	VkDescriptorSetLayoutCreateInfo descriptor_layout = vkb::initializers::descriptor_set_layout_create_info(set_layout_bindings.data(), static_cast<uint32_t>(set_layout_bindings.size()));
+	VK_CHECK(vkCreateDescriptorSetLayout(get_device().get_handle(), &descriptor_layout, nullptr, &descriptor_set_first_pass_layout));
+
+	// The index of the model being drawn or resolved
+	VkPushConstantRange push_constant_range = vkb::initializers::push_constant_range(all_stages, sizeof(uint32_t), 0);
+
+	VkPipelineLayoutCreateInfo pipeline_layout_create_info =
+	    vkb::initializers::pipeline_layout_create_info(
+	        &descriptor_set_first_pass_layout,
+	        1);
+	pipeline_layout_create_info.pushConstantRangeCount = 1;
+	pipeline_layout_create_info.pPushConstantRanges    = &push_constant_range;
+
+	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &pipeline_layout_create_info, nullptr, &pipeline_first_pass_layout));
+}
+
 void MobileNerf::create_pipeline_layout_baseline()
 {
 	// Second Pass Descriptor set and layout
@@ -1006,6 +1190,62 @@ void MobileNerf::create_descriptor_sets_first_pass(Model &model)
 	}
 }
 
+void MobileNerf::create_descriptor_sets_visibility(Model &model)
+{
+	model.descriptor_set_first_pass.resize(nerf_framebuffers.size());
+
+	for (int i = 0; i < nerf_framebuffers.size(); i++)
+	{
+		VkDescriptorSetAllocateInfo descriptor_set_allocate_info =
+		    vkb::initializers::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_first_pass_layout, 1);
+		VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &descriptor_set_allocate_info, &model.descriptor_set_first_pass[i]));
+
+		std::array<VkDescriptorImageInfo, 2> texture_input_descriptors;
+
+		texture_input_descriptors[0].sampler     = model.texture_input_0.sampler;
+		texture_input_descriptors[0].imageView   = model.texture_input_0.image->get_vk_image_view().get_handle();
+		texture_input_descriptors[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		texture_input_descriptors[1].sampler     = model.texture_input_1.sampler;
+		texture_input_descriptors[1].imageView   = model.texture_input_1.image->get_vk_image_view().get_handle();
+		texture_input_descriptors[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkDescriptorImageInfo visibility_descriptor{VK_NULL_HANDLE, frameAttachments[i].visibility.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+		VkDescriptorBufferInfo weights_buffer_descriptor  = create_descriptor(**model.weights_buffer_ref);
+		VkDescriptorBufferInfo uniform_buffer_descriptor  = create_descriptor(**model.uniform_buffer_ref);
+		VkDescriptorBufferInfo vertex_buffer_descriptor   = create_descriptor(*model.vertex_buffer);
+		VkDescriptorBufferInfo index_buffer_descriptor    = create_descriptor(*model.index_buffer);
+		VkDescriptorBufferInfo instance_buffer_descriptor = create_descriptor(*instance_buffer);
+
+		std::vector<VkWriteDescriptorSet> write_descriptor_sets = {
+		    vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0, &visibility_descriptor),
+		    vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &texture_input_descriptors[0]),
+		    vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2, &texture_input_descriptors[1]),
+		    vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 3, &weights_buffer_descriptor),
+		    vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4, &uniform_buffer_descriptor),
+		    vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5, &vertex_buffer_descriptor),
+		    vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6, &index_buffer_descriptor),
+		    vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 7, &instance_buffer_descriptor)};
+
+		vkUpdateDescriptorSets(get_device().get_handle(), static_cast<uint32_t>(write_descriptor_sets.size()), write_descriptor_sets.data(), 0, VK_NULL_HANDLE);
+	}
+}
+
+void MobileNerf::update_descriptor_sets_visibility()
+{
+	// The visibility attachments are recreated on resize, the other resources stay the same
+	for (auto &model : models)
+	{
+		for (int i = 0; i < model.descriptor_set_first_pass.size(); i++)
+		{
+			VkDescriptorImageInfo visibility_descriptor{VK_NULL_HANDLE, frameAttachments[i].visibility.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+			VkWriteDescriptorSet  visibility_write = vkb::initializers::write_descriptor_set(model.descriptor_set_first_pass[i], VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0, &visibility_descriptor);
+			vkUpdateDescriptorSets(get_device().get_handle(), 1, &visibility_write, 0, VK_NULL_HANDLE);
+		}
+	}
+}
+
 void MobileNerf::create_descriptor_sets_baseline()
 {
 	descriptor_set_baseline.resize(nerf_framebuffers.size());
@@ -1100,10 +1340,13 @@ void MobileNerf::prepare_pipelines()
 	vertex_input_state.vertexAttributeDescriptionCount      = static_cast<uint32_t>(vertex_input_attributes.size());
 	vertex_input_state.pVertexAttributeDescriptions         = vertex_input_attributes.data();
 
+	// The visibility buffer shaders pull the mesh from storage buffers
+	VkPipelineVertexInputStateCreateInfo empty_input_state = vkb::initializers::pipeline_vertex_input_state_create_info();
+
 	// First Pass
 
 	VkGraphicsPipelineCreateInfo pipeline_create_info = vkb::initializers::pipeline_create_info(pipeline_first_pass_layout, render_pass_nerf, 0);
-	pipeline_create_info.pVertexInputState            = &vertex_input_state;
+	pipeline_create_info.pVertexInputState            = use_visibility_buffer ? &empty_input_state : &vertex_input_state;
 	pipeline_create_info.pInputAssemblyState          = &input_assembly_state;
 	pipeline_create_info.pRasterizationState          = &rasterization_state;
 	pipeline_create_info.pColorBlendState             = &color_blend_state;
@@ -1115,11 +1358,40 @@ void MobileNerf::prepare_pipelines()
 	pipeline_create_info.stageCount                   = static_cast<uint32_t>(shader_stages_first_pass.size());
 	pipeline_create_info.pStages                      = shader_stages_first_pass.data();
 
+	VkSpecializationMapEntry specialization_entry = vkb::initializers::specialization_map_entry(0, 0, sizeof(VkBool32));
+
 	// Each model will have its own pipeline
 	for (auto &model : models)
 	{
+		// The visibility pass alpha tests the original models only
+		VkBool32             alpha_test          = using_original_nerf_models[model.model_index];
+		VkSpecializationInfo specialization_info = vkb::initializers::specialization_info(1, &specialization_entry, sizeof(alpha_test), &alpha_test);
+		if (use_visibility_buffer)
+		{
+			shader_stages_first_pass[1].pSpecializationInfo = &specialization_info;
+		}
+
 		VK_CHECK(vkCreateGraphicsPipelines(get_device().get_handle(), pipeline_cache, 1, &pipeline_create_info, nullptr, &model.pipeline_first_pass));
 	}
+	shader_stages_first_pass[1].pSpecializationInfo = nullptr;
+
+	if (use_visibility_buffer)
+	{
+		// Second Pass, shared by all models
+
+		VkBool32             morpheus_view_direction = !using_original_nerf_models[0];
+		VkSpecializationInfo specialization_info     = vkb::initializers::specialization_info(1, &specialization_entry, sizeof(morpheus_view_direction), &morpheus_view_direction);
+		shader_stages_second_pass[1].pSpecializationInfo = &specialization_info;
+
+		pipeline_create_info.subpass         = 1;
+		pipeline_create_info.stageCount      = static_cast<uint32_t>(shader_stages_second_pass.size());
+		pipeline_create_info.pStages         = shader_stages_second_pass.data();
+		depth_stencil_state.depthTestEnable  = VK_FALSE;
+		depth_stencil_state.depthWriteEnable = VK_FALSE;
+
+		VK_CHECK(vkCreateGraphicsPipelines(get_device().get_handle(), pipeline_cache, 1, &pipeline_create_info, nullptr, &pipeline_baseline));
+		shader_stages_second_pass[1].pSpecializationInfo = nullptr;
+	}
 
 	if (use_deferred)
 	{
@@ -1153,13 +1425,13 @@ void MobileNerf::create_static_object_buffers(int model_index, int sub_model_ind
 	model.vertex_buffer = std::make_unique<vkb::core::Buffer>(
 	    get_device(),
 	    vertex_buffer_size,
-	    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 	    VMA_MEMORY_USAGE_GPU_ONLY);
 	model.vertex_buffer->set_debug_name(fmt::format("Model #{} Sub-Model #{} vertices", model_index, sub_model_index));
 	model.index_buffer = std::make_unique<vkb::core::Buffer>(
 	    get_device(),
 	    index_buffer_size,
-	    VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	    VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 	    VMA_MEMORY_USAGE_GPU_ONLY);
 	model.index_buffer->set_debug_name(fmt::format("Model #{} Sub-Model #{} indices", model_index, sub_model_index));
 
@@ -1202,7 +1474,7 @@ void MobileNerf::create_uniforms()
 
 		LOGI("Creating mlp weights uniform buffer for model {}", i);
 		weights_buffers[i] = std::make_unique<vkb::core::Buffer>(get_device(),
-		                                                         sizeof(MLP_Weights),
+		                                                         use_fp16_mlp ? sizeof(MLP_Weights_FP16) : sizeof(MLP_Weights),
 		                                                         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
 		                                                         VMA_MEMORY_USAGE_CPU_TO_GPU);
 	}
@@ -1214,17 +1486,37 @@ void MobileNerf::create_uniforms()
 		model.weights_buffer_ref = &weights_buffers[model.model_index];
 	}
 
+	upload_mlp_weights();
 	update_uniform_buffers();
 }
 
+void MobileNerf::upload_mlp_weights()
+{
+	// The weights never change, so they are only uploaded once
+	for (int i = 0; i < model_path.size(); i++)
+	{
+		if (use_fp16_mlp)
+		{
+			MLP_Weights_FP16 weights_fp16{};
+			for (size_t ii = 0; ii < std::size(mlp_weight_vector[i].data); ii++)
+			{
+				weights_fp16.data[ii] = glm::packHalf1x16(mlp_weight_vector[i].data[ii]);
+			}
+			weights_buffers[i]->update(&weights_fp16, sizeof(MLP_Weights_FP16));
+		}
+		else
+		{
+			weights_buffers[i]->update(&(mlp_weight_vector[i].data[0]), sizeof(MLP_Weights));
+		}
+	}
+}
+
 void MobileNerf::initialize_mlp_uniform_buffers(int model_index)
 {
 	std::string assetBase   = vkb::fs::path::get(vkb::fs::path::Type::Assets);
 	std::string mlpJsonPath = assetBase + model_path[model_index] + "mlp.json";
 
-	using json = nlohmann::json;
-
-	std::ifstream f(mlpJsonPath);
+	std::ifstream f(mlpJsonPath, std::ios::binary | std::ios::ate);
 
 	if (!f)
 	{
@@ -1232,12 +1524,20 @@ void MobileNerf::initialize_mlp_uniform_buffers(int model_index)
 		assert(0);
 	}
 
-	LOGI("Parsing mlp data {}", mlpJsonPath);
-	json data = json::parse(f);
+	// The size of the source file is used to detect stale caches
+	const uint64_t source_size = static_cast<uint64_t>(f.tellg());
+	f.seekg(0);
+
+	int obj_num = 0;
+	if (!load_mlp_cache(model_index, source_size, obj_num))
+	{
+		LOGI("Parsing mlp data {}", mlpJsonPath);
+		obj_num = parse_mlp_json(f, mlp_weight_vector[model_index]);
+		save_mlp_cache(model_index, source_size, obj_num);
+	}
 
 	// Record a index of the first sub-model
 	int first_sub_model = models.size();
-	int obj_num         = data["obj_num"].get<int>();
 
 	// Here we know the actual number of sub models
 	int next_sub_model_index = models.size();
@@ -1248,6 +1548,78 @@ void MobileNerf::initialize_mlp_uniform_buffers(int model_index)
 		models[i].model_index = model_index;
 	}
 
+	// Update all sub model with the same mlp weight
+	for (int i = 0; i < obj_num; i++)
+	{
+		models[first_sub_model + i].sub_model_num = obj_num;
+	}
+}
+
+bool MobileNerf::load_mlp_cache(int model_index, uint64_t source_size, int &obj_num)
+{
+	std::vector<uint8_t> cache;
+
+	try
+	{
+		cache = vkb::fs::read_temp(mlp_cache_name(model_path[model_index]));
+	}
+	catch (std::runtime_error &ex)
+	{
+		LOGI("No mlp cache found for model {}. {}", model_index, ex.what());
+		return false;
+	}
+
+	MLP_CacheHeader header{};
+	if (cache.size() != sizeof(MLP_CacheHeader) + sizeof(MLP_Weights))
+	{
+		LOGW("Ignoring mlp cache for model {} with unexpected size", model_index);
+		return false;
+	}
+	memcpy(&header, cache.data(), sizeof(MLP_CacheHeader));
+
+	if (header.magic != MLP_CACHE_MAGIC || header.version != MLP_CACHE_VERSION || header.source_size != source_size ||
+	    header.weight_count != std::size(MLP_Weights{}.data) || header.obj_num <= 0)
+	{
+		LOGW("Ignoring stale mlp cache for model {}", model_index);
+		return false;
+	}
+
+	memcpy(&mlp_weight_vector[model_index], cache.data() + sizeof(MLP_CacheHeader), sizeof(MLP_Weights));
+	obj_num = header.obj_num;
+	LOGI("Loaded mlp data for model {} from cache", model_index);
+	return true;
+}
+
+void MobileNerf::save_mlp_cache(int model_index, uint64_t source_size, int obj_num)
+{
+	MLP_CacheHeader header{};
+	header.magic        = MLP_CACHE_MAGIC;
+	header.version      = MLP_CACHE_VERSION;
+	header.source_size  = source_size;
+	header.obj_num      = obj_num;
+	header.weight_count = static_cast<uint32_t>(std::size(MLP_Weights{}.data));
+
+	std::vector<uint8_t> cache(sizeof(MLP_CacheHeader) + sizeof(MLP_Weights));
+	memcpy(cache.data(), &header, sizeof(MLP_CacheHeader));
+	memcpy(cache.data() + sizeof(MLP_CacheHeader), &mlp_weight_vector[model_index], sizeof(MLP_Weights));
+
+	// A missing cache only costs the json parse on the next run, so failing to write it is not an error
+	try
+	{
+		vkb::fs::write_temp(cache, mlp_cache_name(model_path[model_index]));
+	}
+	catch (std::runtime_error &ex)
+	{
+		LOGW("Failed to write mlp cache for model {}. {}", model_index, ex.what());
+	}
+}
+
+int MobileNerf::parse_mlp_json(std::ifstream &f, MLP_Weights &model_weights)
+{
+	json data = json::parse(f);
+
+	int obj_num = data["obj_num"].get<int>();
+
 	auto weights_0_array_raw = data["0_weights"].get<std::vector<std::vector<float>>>();
 
 	std::vector<float> weights_0_array;
@@ -1313,7 +1685,7 @@ void MobileNerf::initialize_mlp_uniform_buffers(int model_index)
 	}
 
 	// Each sub model will share the same mlp weights data
-	MLP_Weights *model_mlp = &mlp_weight_vector[model_index];
+	MLP_Weights *model_mlp = &model_weights;
 
 	for (int ii = 0; ii < WEIGHTS_0_COUNT; ii++)
 	{
@@ -1365,11 +1737,7 @@ void MobileNerf::initialize_mlp_uniform_buffers(int model_index)
 		}
 	}
 
-	// Update all sub model with the same mlp weight
-	for (int i = 0; i < obj_num; i++)
-	{
-		models[first_sub_model + i].sub_model_num = obj_num;
-	}
+	return obj_num;
 }
 
 void MobileNerf::update_uniform_buffers()
@@ -1395,7 +1763,6 @@ void MobileNerf::update_uniform_buffers()
 	{
 		global_uniform.model = combo_mode ? model_translation[i] : glm::translate(glm::vec3(0.0f));
 		uniform_buffers[i]->update(&global_uniform, sizeof(global_uniform));
-		weights_buffers[i]->update(&(mlp_weight_vector[i].data[0]), sizeof(MLP_Weights));
 	}
 }
 
@@ -1428,7 +1795,7 @@ void MobileNerf::prepare_instance_data()
 	instance_buffer = std::make_unique<vkb::core::Buffer>(
 	    get_device(),
 	    instance_buffer_size,
-	    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 	    VMA_MEMORY_USAGE_GPU_ONLY);
 
 	// Copy over the data for each of the models
@@ -1691,6 +2058,96 @@ void MobileNerf::update_render_pass_nerf_baseline()
 	VK_CHECK(vkCreateRenderPass(get_device().get_handle(), &render_pass_create_info, nullptr, &render_pass_nerf));
 }
 
+void MobileNerf::update_render_pass_nerf_visibility()
+{
+	std::array<VkAttachmentDescription, 3> attachments = {};
+	// Visibility attachment, 8 bytes per pixel holding the triangle, instance and model ids
+	attachments[0].format         = VK_FORMAT_R32G32_UINT;
+	attachments[0].samples        = VK_SAMPLE_COUNT_1_BIT;
+	attachments[0].loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachments[0].storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[0].stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[0].initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[0].finalLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	// Depth attachment
+	attachments[1].format         = depth_format;
+	attachments[1].samples        = VK_SAMPLE_COUNT_1_BIT;
+	attachments[1].loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachments[1].storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[1].stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[1].initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[1].finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	// Swapchain attachment
+	attachments[2].format         = get_render_context().get_swapchain().get_format();
+	attachments[2].samples        = VK_SAMPLE_COUNT_1_BIT;
+	attachments[2].loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachments[2].storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
+	attachments[2].stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[2].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[2].initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[2].finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+	VkAttachmentReference visibility_reference = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkAttachmentReference depth_reference      = {1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+	VkAttachmentReference swapchain_reference  = {2, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+	// The ids written in the first sub pass are read back as an input attachment in the second one
+	VkAttachmentReference input_reference = {0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+	std::array<VkSubpassDescription, 2> subpassDescriptions{};
+
+	subpassDescriptions[0].pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpassDescriptions[0].colorAttachmentCount    = 1;
+	subpassDescriptions[0].pColorAttachments       = &visibility_reference;
+	subpassDescriptions[0].pDepthStencilAttachment = &depth_reference;
+
+	subpassDescriptions[1].pipelineBindPoint    = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpassDescriptions[1].colorAttachmentCount = 1;
+	subpassDescriptions[1].pColorAttachments    = &swapchain_reference;
+	subpassDescriptions[1].inputAttachmentCount = 1;
+	subpassDescriptions[1].pInputAttachments    = &input_reference;
+
+	// Subpass dependencies for layout transitions
+	std::array<VkSubpassDependency, 3> dependencies;
+
+	dependencies[0].srcSubpass      = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass      = 0;
+	dependencies[0].srcStageMask    = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	dependencies[0].dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+	dependencies[0].srcAccessMask   = VK_ACCESS_NONE;
+	dependencies[0].dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	dependencies[1].srcSubpass      = 0;
+	dependencies[1].dstSubpass      = 1;
+	dependencies[1].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].dstStageMask    = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[1].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstAccessMask   = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+	dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	dependencies[2].srcSubpass      = 1;
+	dependencies[2].dstSubpass      = VK_SUBPASS_EXTERNAL;
+	dependencies[2].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[2].dstStageMask    = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	dependencies[2].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[2].dstAccessMask   = VK_ACCESS_NONE;
+	dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	VkRenderPassCreateInfo render_pass_create_info = {};
+	render_pass_create_info.sType                  = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	render_pass_create_info.attachmentCount        = static_cast<uint32_t>(attachments.size());
+	render_pass_create_info.pAttachments           = attachments.data();
+	render_pass_create_info.subpassCount           = static_cast<uint32_t>(subpassDescriptions.size());
+	render_pass_create_info.pSubpasses             = subpassDescriptions.data();
+	render_pass_create_info.dependencyCount        = static_cast<uint32_t>(dependencies.size());
+	render_pass_create_info.pDependencies          = dependencies.data();
+
+	VK_CHECK(vkCreateRenderPass(get_device().get_handle(), &render_pass_create_info, nullptr, &render_pass_nerf));
+}
+
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_mobile_nerf()
 {
 	return std::make_unique<MobileNerf>();
@@ -1,4 +1,4 @@
-/* Copyright (c) 2023-2024, Qualcomm Innovation Center, Inc. All rights reserved.
+/* Copyright (c) 2023-2026, Qualcomm Innovation Center, Inc. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -76,6 +76,24 @@ class MobileNerf : public ApiVulkanSample
 		           BIAS_0_COUNT + BIAS_1_COUNT + BIAS_2_COUNT];        // Array of floats
 	};
 
+	// Half precision copy of MLP_Weights, padded to whole uvec4s so the shaders can unpack pairs with unpackFloat2x16
+	struct MLP_Weights_FP16
+	{
+		uint16_t data[(WEIGHTS_0_COUNT + WEIGHTS_1_COUNT + WEIGHTS_2_COUNT +
+		               BIAS_0_COUNT + BIAS_1_COUNT + BIAS_2_COUNT + 7) /
+		              8 * 8];
+	};
+
+	// Header of the binary cache written for each parsed mlp.json
+	struct MLP_CacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t source_size;        // Size of the mlp.json the cache was built from
+		int32_t  obj_num;
+		uint32_t weight_count;
+	};
+
 	struct Vertex
 	{
 		alignas(4) glm::vec3 position;
@@ -159,6 +177,10 @@ class MobileNerf : public ApiVulkanSample
 	void prepare_instance_data();
 	void load_scene(int model_index, int sub_model_index, int models_entry);
 	void initialize_mlp_uniform_buffers(int model_index);
+	int  parse_mlp_json(std::ifstream &f, MLP_Weights &model_weights);
+	bool load_mlp_cache(int model_index, uint64_t source_size, int &obj_num);
+	void save_mlp_cache(int model_index, uint64_t source_size, int obj_num);
+	void upload_mlp_weights();
 	void update_uniform_buffers();
 
 	void     create_texture(int model_index, int sub_model_index, int models_entry);
@@ -184,6 +206,8 @@ class MobileNerf : public ApiVulkanSample
 	struct Attachments_baseline
 	{
 		FrameBufferAttachment feature_0, feature_1, feature_2;
+		// Triangle, instance and model ids, only used by the visibility buffer mode
+		FrameBufferAttachment visibility;
 	};
 
 	std::vector<Attachments_baseline> frameAttachments;
@@ -206,14 +230,26 @@ class MobileNerf : public ApiVulkanSample
 	// For creating the forward mode rendepass
 	void update_render_pass_nerf_forward();
 
+	// For the visibility buffer mode, the first pass only writes ids and the second pass runs the mlp once per pixel
+	void update_render_pass_nerf_visibility();
+	void create_pipeline_layout_visibility();
+	void create_descriptor_sets_visibility(Model &model);
+	void update_descriptor_sets_visibility();
+
 	// For loading nerf assets map
 	json                     asset_map;
 	std::vector<std::string> model_path;
 	bool                     combo_mode;
 	std::vector<bool>        using_original_nerf_models;
 	bool                     use_deferred;
+	bool                     use_visibility_buffer = false;
 	bool                     do_rotation;
 
+	// Evaluate the MLP in half precision when the device supports shaderFloat16
+	bool fp16_requested = true;
+	bool fp16_supported = false;
+	bool use_fp16_mlp   = false;
+
 	glm::vec3 camera_pos = glm::vec3(-2.2f, 2.2f, 2.2f);
 
 	// For instancing
@@ -178,7 +178,6 @@ void AsyncComputeSample::setup_queues()
 	if (async_enabled)
 	{
 		uint32_t graphics_family_index = get_device().get_queue_family_index(VK_QUEUE_GRAPHICS_BIT);
-		uint32_t compute_family_index  = get_device().get_queue_family_index(VK_QUEUE_COMPUTE_BIT);
 
 		if (get_device().get_num_queues_for_queue_family(graphics_family_index) >= 2)
 		{
@@ -191,7 +190,7 @@ void AsyncComputeSample::setup_queues()
 			early_graphics_queue = present_graphics_queue;
 		}
 
-		if (graphics_family_index == compute_family_index)
+		if (!get_render_context().has_async_compute())
 		{
 			LOGI("Device has does not have a dedicated compute queue family.");
 			post_compute_queue = early_graphics_queue;
@@ -199,7 +198,7 @@ void AsyncComputeSample::setup_queues()
 		else
 		{
 			LOGI("Device has async compute queue.");
-			post_compute_queue = &get_device().get_queue(compute_family_index, 0);
+			post_compute_queue = &get_render_context().get_compute_queue();
 		}
 	}
 	else
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -117,6 +117,9 @@ void CommandBufferUsage::update(float delta_time)
 
 	subpass_state.multi_threading = gui_multi_threading;
 
+	// The culling queries the hierarchy once it is built by the next scene update
+	get_scene().set_bvh_enabled(gui_bvh_culling);
+
 	auto &render_context = get_render_context();
 
 	update_scene(delta_time);
@@ -141,7 +144,7 @@ void CommandBufferUsage::update(float delta_time)
 void CommandBufferUsage::draw_gui()
 {
 	const bool landscape = camera->get_aspect_ratio() > 1.0f;
-	uint32_t   lines     = landscape ? 3 : 5;
+	uint32_t   lines     = landscape ? 4 : 6;
 
 	const auto &subpass = static_cast<ForwardSubpassSecondary *>(get_render_pipeline().get_active_subpass().get());
 
@@ -158,6 +161,9 @@ void CommandBufferUsage::draw_gui()
 		    ImGui::SameLine();
 		    ImGui::Text("(%d threads)", subpass->get_state().thread_count);
 
+		    // Frustum culling against a bounding volume hierarchy instead of each node
+		    ImGui::Checkbox("BVH culling", &gui_bvh_culling);
+
 		    // Buffer management options
 		    ImGui::RadioButton("Allocate and free", &gui_command_buffer_reset_mode, static_cast<int>(vkb::CommandBuffer::ResetMode::AlwaysAllocate));
 		    if (landscape)
@@ -313,7 +319,7 @@ void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &prima
 	}
 	const auto transparent_submeshes = vkb::to_u32(sorted_transparent_nodes.size());
 
-	allocate_lights<vkb::ForwardLights>(scene.get_components<vkb::sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+	allocate_lights<vkb::ForwardLights>(scene.get_component_view<vkb::sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
 
 	color_blend_attachment.blend_enable = VK_FALSE;
 	color_blend_state.attachments.resize(get_output_attachments().size());
@@ -142,6 +142,8 @@ class CommandBufferUsage : public vkb::VulkanSample<vkb::BindingType::C>
 
 	bool gui_multi_threading{false};
 
+	bool gui_bvh_culling{false};
+
 	const uint32_t MIN_THREAD_COUNT{4};
 
 	uint32_t max_thread_count{0};
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: MIT
  *
@@ -442,7 +442,7 @@ void ConstantData::BufferArraySubpass::draw(vkb::CommandBuffer &command_buffer)
 	// Reset the instance index back to 0 for each draw call
 	instance_index = 0;
 
-	allocate_lights<vkb::ForwardLights>(scene.get_components<vkb::sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+	allocate_lights<vkb::ForwardLights>(scene.get_component_view<vkb::sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
 	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
 
 	GeometrySubpass::draw(command_buffer);
@@ -475,7 +475,7 @@ void ConstantData::BufferArraySubpass::prepare_push_constants(vkb::CommandBuffer
 	return;
 }
 
-void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh)
+void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, uint32_t lod, uint32_t instance_count)
 {
 	/**
 	 * POI
@@ -492,7 +492,9 @@ void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &
 		// Bind index buffer of submesh
 		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
 
-		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, instance_index++);
+		auto indices = sub_mesh.get_lod_indices(lod);
+
+		command_buffer.draw_indexed(indices.second, 1, indices.first, 0, instance_index++);
 	}
 	else
 	{
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: MIT
  *
@@ -210,7 +210,7 @@ class ConstantData : public vkb::VulkanSample<vkb::BindingType::C>
 		/**
 		 * @brief Overridden to send an index
 		 */
-		virtual void draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh) override;
+		virtual void draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, uint32_t lod, uint32_t instance_count) override;
 
 		uint32_t instance_index{0};
 	};
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -57,8 +57,14 @@ bool DescriptorManagement::prepare(const vkb::ApplicationOptions &options)
 	render_pipeline->add_subpass(std::move(scene_subpass));
 	set_render_pipeline(std::move(render_pipeline));
 
+	// Switching to one allocation per buffer grows the buffer pools, release the blocks left idle after switching back
+	for (auto &render_frame : get_render_context().get_render_frames())
+	{
+		render_frame->set_buffer_pool_trim_policy(0, BUFFER_BLOCK_IDLE_RESET_LIMIT);
+	}
+
 	// Add a GUI with the stats you want to monitor
-	get_stats().request_stats({vkb::StatIndex::frame_times});
+	get_stats().request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::descriptor_pool_growths, vkb::StatIndex::buffer_pool_peak_usage});
 	create_gui(*window, &get_stats());
 
 	return true;
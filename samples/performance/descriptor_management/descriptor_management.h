@@ -33,6 +33,9 @@ class DescriptorManagement : public vkb::VulkanSample<vkb::BindingType::C>
 	virtual void update(float delta_time) override;
 
   private:
+	/// Buffer blocks unused for this many resets of their frame are released
+	static constexpr uint32_t BUFFER_BLOCK_IDLE_RESET_LIMIT{120};
+
 	/**
 	 * @brief Struct that contains radio button labeling and the value
 	 *        which is selected
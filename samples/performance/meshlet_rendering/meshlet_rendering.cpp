@@ -0,0 +1,152 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "meshlet_rendering.h"
+
+#include "common/vk_common.h"
+#include "glsl_compiler.h"
+#include "gui.h"
+#include "rendering/render_pipeline.h"
+#include "rendering/subpasses/forward_subpass.h"
+#include "rendering/subpasses/meshlet_subpass.h"
+#include "scene_graph/node.h"
+#include "stats/stats.h"
+
+MeshletRendering::MeshletRendering()
+{
+	set_api_version(VK_API_VERSION_1_1);
+
+	// Without mesh shaders, the meshlet subpass draws the scene like the forward subpass
+	add_device_extension(VK_KHR_SPIRV_1_4_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME, true);
+	add_device_extension(VK_EXT_MESH_SHADER_EXTENSION_NAME, true);
+
+	// The mesh shaders read the vertices of the submeshes from storage buffers
+	set_meshlet_geometry_enable(true);
+
+	auto &config = get_configuration();
+
+	config.insert<vkb::BoolSetting>(0, meshlets_enabled, true);
+	config.insert<vkb::BoolSetting>(1, meshlets_enabled, false);
+}
+
+MeshletRendering::~MeshletRendering()
+{
+	vkb::GLSLCompiler::reset_target_environment();
+}
+
+void MeshletRendering::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	if (!gpu.is_extension_supported(VK_EXT_MESH_SHADER_EXTENSION_NAME))
+	{
+		return;
+	}
+
+	VkPhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT};
+	VkPhysicalDeviceFeatures2             features2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+	features2.pNext = &mesh_shader_features;
+	vkGetPhysicalDeviceFeatures2(gpu.get_handle(), &features2);
+
+	if (mesh_shader_features.taskShader && mesh_shader_features.meshShader)
+	{
+		auto &requested_mesh_shader_features      = gpu.request_extension_features<VkPhysicalDeviceMeshShaderFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT);
+		requested_mesh_shader_features.taskShader = VK_TRUE;
+		requested_mesh_shader_features.meshShader = VK_TRUE;
+	}
+}
+
+bool MeshletRendering::prepare(const vkb::ApplicationOptions &options)
+{
+	if (!VulkanSample::prepare(options))
+	{
+		return false;
+	}
+
+	if (get_device().uses_mesh_shaders())
+	{
+		// Mesh shaders need SPIR-V 1.4
+		vkb::GLSLCompiler::set_target_environment(glslang::EShTargetSpv, glslang::EShTargetSpv_1_4);
+	}
+
+	load_scene("scenes/sponza/Sponza01.gltf");
+
+	auto &camera_node = vkb::add_free_camera(get_scene(), "main_camera", get_render_context().get_surface_extent());
+	camera            = &camera_node.get_component<vkb::sg::Camera>();
+
+	set_render_pipeline(create_render_pipeline(meshlets_enabled));
+	meshlets_enabled_last_value = meshlets_enabled;
+
+	get_stats().request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::gpu_vertex_cycles, vkb::StatIndex::gpu_fragment_cycles});
+
+	create_gui(*window, &get_stats());
+
+	return true;
+}
+
+std::unique_ptr<vkb::RenderPipeline> MeshletRendering::create_render_pipeline(bool meshlets)
+{
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	std::unique_ptr<vkb::Subpass> scene_subpass;
+	if (meshlets)
+	{
+		scene_subpass = std::make_unique<vkb::MeshletSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), get_scene(), *camera);
+	}
+	else
+	{
+		scene_subpass = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), get_scene(), *camera);
+	}
+
+	auto render_pipeline = std::make_unique<vkb::RenderPipeline>();
+	render_pipeline->add_subpass(std::move(scene_subpass));
+
+	return render_pipeline;
+}
+
+void MeshletRendering::update(float delta_time)
+{
+	if (meshlets_enabled != meshlets_enabled_last_value)
+	{
+		// The frames in flight may still use the previous pipeline
+		get_device().wait_idle();
+
+		set_render_pipeline(create_render_pipeline(meshlets_enabled));
+
+		meshlets_enabled_last_value = meshlets_enabled;
+	}
+
+	VulkanSample::update(delta_time);
+}
+
+void MeshletRendering::draw_gui()
+{
+	get_gui().show_options_window(
+	    /* body = */ [this]() {
+		    ImGui::Checkbox("Draw meshlets", &meshlets_enabled);
+
+		    ImGui::SameLine();
+		    ImGui::Text("(%s)", get_device().uses_mesh_shaders() ? "mesh shaders" : "mesh shaders not supported, vertex fallback");
+	    },
+	    /* lines = */ 1);
+}
+
+std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_meshlet_rendering()
+{
+	return std::make_unique<MeshletRendering>();
+}
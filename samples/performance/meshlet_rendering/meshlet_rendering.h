@@ -0,0 +1,57 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "scene_graph/components/camera.h"
+#include "vulkan_sample.h"
+
+/**
+ * @brief Drawing the scene as meshlets, culled on the GPU by task and mesh shaders
+ *        The scene is loaded with the meshlets of its submeshes, and drawn either by a vkb::MeshletSubpass, or by a
+ *        vkb::ForwardSubpass to compare with the vertex pipeline.
+ */
+class MeshletRendering : public vkb::VulkanSample<vkb::BindingType::C>
+{
+  public:
+	MeshletRendering();
+
+	virtual ~MeshletRendering();
+
+	virtual bool prepare(const vkb::ApplicationOptions &options) override;
+
+	virtual void update(float delta_time) override;
+
+  private:
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	virtual void draw_gui() override;
+
+	/**
+	 * @return A pipeline drawing the scene with meshlets, or with vertices
+	 */
+	std::unique_ptr<vkb::RenderPipeline> create_render_pipeline(bool meshlets);
+
+	vkb::sg::Camera *camera{nullptr};
+
+	bool meshlets_enabled{true};
+
+	bool meshlets_enabled_last_value{true};
+};
+
+std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_meshlet_rendering();
@@ -0,0 +1,79 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "mip_streaming.h"
+
+#include "common/vk_common.h"
+#include "gui.h"
+#include "rendering/mip_streamer.h"
+#include "rendering/render_pipeline.h"
+#include "rendering/subpasses/forward_subpass.h"
+#include "scene_graph/node.h"
+#include "stats/stats.h"
+
+MipStreaming::MipStreaming()
+{
+	// The textures are created with their smallest levels by load_scene()
+	set_mip_streaming_budget(MEMORY_BUDGET);
+}
+
+bool MipStreaming::prepare(const vkb::ApplicationOptions &options)
+{
+	if (!VulkanSample::prepare(options))
+	{
+		return false;
+	}
+
+	load_scene("scenes/sponza/Sponza01.gltf");
+
+	auto &camera_node = vkb::add_free_camera(get_scene(), "main_camera", get_render_context().get_surface_extent());
+	camera            = &camera_node.get_component<vkb::sg::Camera>();
+
+	// The levels are estimated from the screen size of the meshes in the view of the camera
+	set_mip_streaming_camera(camera);
+
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+	auto              scene_subpass = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), get_scene(), *camera);
+
+	auto render_pipeline = std::make_unique<vkb::RenderPipeline>();
+	render_pipeline->add_subpass(std::move(scene_subpass));
+
+	set_render_pipeline(std::move(render_pipeline));
+
+	get_stats().request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::gpu_ext_read_bytes});
+
+	create_gui(*window, &get_stats());
+
+	return true;
+}
+
+void MipStreaming::draw_gui()
+{
+	get_gui().show_options_window(
+	    /* body = */ [this]() {
+		    float resident_size = get_mip_streamer() ? get_mip_streamer()->get_resident_size() / (1024.0f * 1024.0f) : 0.0f;
+		    ImGui::Text("Resident textures: %.1f MiB of %.1f MiB", resident_size, MEMORY_BUDGET / (1024.0f * 1024.0f));
+	    },
+	    /* lines = */ 1);
+}
+
+std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_mip_streaming()
+{
+	return std::make_unique<MipStreaming>();
+}
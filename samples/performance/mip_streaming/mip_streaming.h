@@ -0,0 +1,47 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "scene_graph/components/camera.h"
+#include "vulkan_sample.h"
+
+/**
+ * @brief Streaming the mip levels of the scene textures within a memory budget
+ *        The scene textures start with their smallest levels, and the finer ones stream in as the camera gets closer
+ *        to the meshes sampling them, see vkb::MipStreamer.
+ */
+class MipStreaming : public vkb::VulkanSample<vkb::BindingType::C>
+{
+  public:
+	MipStreaming();
+
+	virtual ~MipStreaming() = default;
+
+	virtual bool prepare(const vkb::ApplicationOptions &options) override;
+
+  private:
+	/// Device memory of the streamed textures
+	static constexpr VkDeviceSize MEMORY_BUDGET = 64 * 1024 * 1024;
+
+	virtual void draw_gui() override;
+
+	vkb::sg::Camera *camera{nullptr};
+};
+
+std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_mip_streaming();
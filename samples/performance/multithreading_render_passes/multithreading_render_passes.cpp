@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2024, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -107,7 +107,7 @@ std::unique_ptr<vkb::RenderPipeline> MultithreadingRenderPasses::create_shadow_r
 	// Shadowmap subpass
 	auto shadowmap_vs  = vkb::ShaderSource{"shadows/shadowmap.vert"};
 	auto shadowmap_fs  = vkb::ShaderSource{"shadows/shadowmap.frag"};
-	auto scene_subpass = std::make_unique<ShadowSubpass>(get_render_context(), std::move(shadowmap_vs), std::move(shadowmap_fs), get_scene(), *shadowmap_camera);
+	auto scene_subpass = std::make_unique<vkb::ShadowSubpass>(get_render_context(), std::move(shadowmap_vs), std::move(shadowmap_fs), get_scene(), *shadowmap_camera);
 
 	shadow_subpass = scene_subpass.get();
 
@@ -494,54 +494,6 @@ void MultithreadingRenderPasses::MainSubpass::draw(vkb::CommandBuffer &command_b
 	ForwardSubpass::draw(command_buffer);
 }
 
-MultithreadingRenderPasses::ShadowSubpass::ShadowSubpass(vkb::RenderContext &render_context,
-                                                         vkb::ShaderSource &&vertex_source,
-                                                         vkb::ShaderSource &&fragment_source,
-                                                         vkb::sg::Scene     &scene,
-                                                         vkb::sg::Camera    &camera) :
-    vkb::GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene, camera}
-{
-}
-
-void MultithreadingRenderPasses::ShadowSubpass::prepare_pipeline_state(vkb::CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
-{
-	// Enabling depth bias to get rid of self-shadowing artifacts
-	// Depth bias literally "pushes" slightly all the primitives further away from the camera taking their slope into account
-	// It helps to avoid precision related problems while doing depth comparisons in the final pass
-	vkb::RasterizationState rasterization_state{};
-	rasterization_state.front_face        = front_face;
-	rasterization_state.depth_bias_enable = VK_TRUE;
-
-	if (double_sided_material)
-	{
-		rasterization_state.cull_mode = VK_CULL_MODE_NONE;
-	}
-
-	command_buffer.set_rasterization_state(rasterization_state);
-	command_buffer.set_depth_bias(-1.4f, 0.0f, -1.7f);
-
-	vkb::MultisampleState multisample_state{};
-	multisample_state.rasterization_samples = sample_count;
-	command_buffer.set_multisample_state(multisample_state);
-}
-
-vkb::PipelineLayout &MultithreadingRenderPasses::ShadowSubpass::prepare_pipeline_layout(vkb::CommandBuffer &command_buffer, const std::vector<vkb::ShaderModule *> &shader_modules)
-{
-	// Only vertex shader is needed in the shadow subpass
-	assert(!shader_modules.empty());
-	auto vertex_shader_module = shader_modules[0];
-
-	vertex_shader_module->set_resource_mode("GlobalUniform", vkb::ShaderResourceMode::Dynamic);
-
-	return command_buffer.get_device().get_resource_cache().request_pipeline_layout({vertex_shader_module});
-}
-
-void MultithreadingRenderPasses::ShadowSubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh)
-{
-	// No push constants are used the in shadow pass
-	return;
-}
-
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_multithreading_render_passes()
 {
 	return std::make_unique<MultithreadingRenderPasses>();
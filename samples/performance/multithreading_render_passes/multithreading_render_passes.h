@@ -1,4 +1,4 @@
-/* Copyright (c) 2023-2024, Arm Limited and Contributors
+/* Copyright (c) 2023-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -22,6 +22,7 @@
 #include "core/command_buffer.h"
 #include "rendering/render_pipeline.h"
 #include "rendering/subpasses/forward_subpass.h"
+#include "rendering/subpasses/shadow_subpass.h"
 #include "scene_graph/components/camera.h"
 #include "vulkan_sample.h"
 
@@ -55,26 +56,6 @@ class MultithreadingRenderPasses : public vkb::VulkanSample<vkb::BindingType::C>
 
 	void draw_gui() override;
 
-	/**
-	 * @brief This subpass is responsible for rendering a shadowmap
-	 */
-	class ShadowSubpass : public vkb::GeometrySubpass
-	{
-	  public:
-		ShadowSubpass(vkb::RenderContext &render_context,
-		              vkb::ShaderSource &&vertex_source,
-		              vkb::ShaderSource &&fragment_source,
-		              vkb::sg::Scene     &scene,
-		              vkb::sg::Camera    &camera);
-
-	  protected:
-		virtual void prepare_pipeline_state(vkb::CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material) override;
-
-		virtual vkb::PipelineLayout &prepare_pipeline_layout(vkb::CommandBuffer &command_buffer, const std::vector<vkb::ShaderModule *> &shader_modules) override;
-
-		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh) override;
-	};
-
 	/**
 	 * @brief This subpass is responsible for rendering a Scene
 	 *		  It implements a custom draw function which passes shadowmap and light matrix
@@ -134,7 +115,7 @@ class MultithreadingRenderPasses : public vkb::VulkanSample<vkb::BindingType::C>
 	/**
 	 * @brief Subpass for shadowmap rendering
 	 */
-	ShadowSubpass *shadow_subpass{};
+	vkb::ShadowSubpass *shadow_subpass{};
 
 	/**
 	 * @brief Camera for shadowmap rendering (view from the light source)
@@ -35,6 +35,9 @@ PipelineCache::PipelineCache()
 
 	config.insert<vkb::BoolSetting>(0, enable_pipeline_cache, true);
 	config.insert<vkb::BoolSetting>(1, enable_pipeline_cache, false);
+
+	// This sample manages its own pipeline cache, to compare runs with and without it
+	set_pipeline_cache_persistence_enable(false);
 }
 
 PipelineCache::~PipelineCache()
@@ -0,0 +1,195 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ray_traced_shadows.h"
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "gui.h"
+#include "rendering/render_pipeline.h"
+#include "rendering/subpasses/forward_subpass.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/node.h"
+#include "stats/stats.h"
+
+RayTracedShadows::RayTracedShadows()
+{
+	set_api_version(VK_API_VERSION_1_1);
+
+	// Without ray queries, the light is only shaded with the shadow map
+	add_device_extension(VK_KHR_RAY_QUERY_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME, true);
+	add_device_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, true);
+
+	auto &config = get_configuration();
+
+	config.insert<vkb::BoolSetting>(0, ray_query_enabled, true);
+	config.insert<vkb::BoolSetting>(1, ray_query_enabled, false);
+}
+
+RayTracedShadows::~RayTracedShadows()
+{
+	if (has_device())
+	{
+		// The frames in flight may still trace the acceleration structures
+		get_device().wait_idle();
+	}
+}
+
+void RayTracedShadows::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	if (!gpu.is_extension_supported(VK_KHR_RAY_QUERY_EXTENSION_NAME) || !gpu.is_extension_supported(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME) ||
+	    !gpu.is_extension_supported(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME))
+	{
+		return;
+	}
+
+	VkPhysicalDeviceBufferDeviceAddressFeaturesKHR   buffer_device_address_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR};
+	VkPhysicalDeviceAccelerationStructureFeaturesKHR acceleration_structure_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR};
+	VkPhysicalDeviceRayQueryFeaturesKHR              ray_query_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR};
+	acceleration_structure_features.pNext = &buffer_device_address_features;
+	ray_query_features.pNext             = &acceleration_structure_features;
+
+	VkPhysicalDeviceFeatures2 features2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+	features2.pNext = &ray_query_features;
+	vkGetPhysicalDeviceFeatures2(gpu.get_handle(), &features2);
+
+	if (buffer_device_address_features.bufferDeviceAddress && acceleration_structure_features.accelerationStructure && ray_query_features.rayQuery)
+	{
+		gpu.request_extension_features<VkPhysicalDeviceBufferDeviceAddressFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR).bufferDeviceAddress = VK_TRUE;
+		gpu.request_extension_features<VkPhysicalDeviceAccelerationStructureFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR).accelerationStructure = VK_TRUE;
+		gpu.request_extension_features<VkPhysicalDeviceRayQueryFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR).rayQuery = VK_TRUE;
+
+		ray_query_supported = true;
+	}
+}
+
+bool RayTracedShadows::prepare(const vkb::ApplicationOptions &options)
+{
+	if (!VulkanSample::prepare(options))
+	{
+		return false;
+	}
+
+	ray_query_supported = ray_query_supported && vkb::RayQueryShadows::is_supported(get_device());
+
+	// The acceleration structures are built from the vertex and index buffers of the scene
+	set_ray_tracing_geometry_enable(ray_query_supported);
+
+	load_scene("scenes/sponza/Sponza01.gltf");
+
+	vkb::add_directional_light(get_scene(), glm::quat({glm::radians(-60.0f), glm::radians(20.0f), glm::radians(0.0f)}));
+
+	auto &camera_node = vkb::add_free_camera(get_scene(), "main_camera", get_render_context().get_surface_extent());
+	camera            = &camera_node.get_component<vkb::sg::Camera>();
+
+	if (ray_query_supported)
+	{
+		// The scene is static, so the top-level structure is never refitted
+		ray_tracing_scene = std::make_unique<vkb::RayTracingScene>(get_device(), get_scene());
+		ray_tracing_scene->build(get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_handle());
+
+		ray_query_shadows = std::make_unique<vkb::RayQueryShadows>(get_render_context(), get_scene(), *camera, *ray_tracing_scene);
+	}
+
+	shadow_map = std::make_unique<vkb::CascadedShadowMap>(get_render_context(), get_scene());
+
+	ray_query_enabled = ray_query_enabled && ray_query_supported;
+
+	set_render_pipeline(create_render_pipeline(ray_query_enabled));
+	ray_query_enabled_last_value = ray_query_enabled;
+
+	get_stats().request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::shadow_cascades_drawn, vkb::StatIndex::shadow_rays});
+
+	create_gui(*window, &get_stats());
+
+	return true;
+}
+
+std::unique_ptr<vkb::RenderPipeline> RayTracedShadows::create_render_pipeline(bool ray_query)
+{
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+
+	auto scene_subpass = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), get_scene(), *camera);
+
+	// The shadow map is set either way, the ray query shadows take precedence over it
+	scene_subpass->set_shadow_map(shadow_map.get());
+	if (ray_query)
+	{
+		scene_subpass->set_ray_query_shadows(ray_query_shadows.get());
+	}
+
+	auto render_pipeline = std::make_unique<vkb::RenderPipeline>();
+	render_pipeline->add_subpass(std::move(scene_subpass));
+
+	return render_pipeline;
+}
+
+void RayTracedShadows::update(float delta_time)
+{
+	if (!ray_query_supported)
+	{
+		ray_query_enabled = false;
+	}
+
+	if (ray_query_enabled != ray_query_enabled_last_value)
+	{
+		// The frames in flight may still use the previous pipeline
+		get_device().wait_idle();
+
+		set_render_pipeline(create_render_pipeline(ray_query_enabled));
+
+		ray_query_enabled_last_value = ray_query_enabled;
+	}
+
+	if (ray_query_shadows)
+	{
+		ray_query_shadows->set_light_angular_radius(glm::radians(light_angular_radius));
+	}
+
+	VulkanSample::update(delta_time);
+}
+
+void RayTracedShadows::draw_gui()
+{
+	get_gui().show_options_window(
+	    /* body = */ [this]() {
+		    ImGui::Checkbox("Ray query shadows", &ray_query_enabled);
+
+		    ImGui::SameLine();
+		    if (ray_query_supported)
+		    {
+			    ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.3f);
+			    ImGui::SliderFloat("Light radius", &light_angular_radius, 0.0f, 2.0f, "%.2f deg");
+			    ImGui::PopItemWidth();
+		    }
+		    else
+		    {
+			    ImGui::Text("(ray queries not supported, shadow map fallback)");
+		    }
+	    },
+	    /* lines = */ 1);
+}
+
+std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_ray_traced_shadows()
+{
+	return std::make_unique<RayTracedShadows>();
+}
@@ -0,0 +1,73 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "rendering/cascaded_shadow_map.h"
+#include "rendering/ray_query_shadows.h"
+#include "rendering/ray_tracing_scene.h"
+#include "scene_graph/components/camera.h"
+#include "vulkan_sample.h"
+
+/**
+ * @brief Shadows of a directional light traced with ray queries, instead of drawn in cascaded shadow maps
+ *        The scene is loaded with geometry to build a vkb::RayTracingScene from, and a vkb::ForwardSubpass shades the
+ *        light with either vkb::RayQueryShadows or a vkb::CascadedShadowMap. Devices without VK_KHR_ray_query only
+ *        use the shadow map.
+ */
+class RayTracedShadows : public vkb::VulkanSample<vkb::BindingType::C>
+{
+  public:
+	RayTracedShadows();
+
+	virtual ~RayTracedShadows();
+
+	virtual bool prepare(const vkb::ApplicationOptions &options) override;
+
+	virtual void update(float delta_time) override;
+
+  private:
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	virtual void draw_gui() override;
+
+	/**
+	 * @return A pipeline shading the light with ray query shadows, or with the shadow map
+	 */
+	std::unique_ptr<vkb::RenderPipeline> create_render_pipeline(bool ray_query);
+
+	vkb::sg::Camera *camera{nullptr};
+
+	/// Whether the ray tracing features were requested
+	bool ray_query_supported{false};
+
+	std::unique_ptr<vkb::RayTracingScene> ray_tracing_scene;
+
+	std::unique_ptr<vkb::RayQueryShadows> ray_query_shadows;
+
+	std::unique_ptr<vkb::CascadedShadowMap> shadow_map;
+
+	bool ray_query_enabled{true};
+
+	bool ray_query_enabled_last_value{true};
+
+	/// Angular radius of the light in degrees, for the softness of the traced shadows
+	float light_angular_radius{0.5f};
+};
+
+std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_ray_traced_shadows();
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -23,6 +23,7 @@
 #include "rendering/pipeline_state.h"
 #include "rendering/render_context.h"
 #include "rendering/render_pipeline.h"
+#include "rendering/subpasses/clustered_forward_subpass.h"
 #include "rendering/subpasses/geometry_subpass.h"
 #include "rendering/subpasses/lighting_subpass.h"
 #include "scene_graph/node.h"
@@ -35,67 +36,58 @@ Subpasses::Subpasses()
 	config.insert<vkb::IntSetting>(0, configs[Config::RenderTechnique].value, 0);
 	config.insert<vkb::IntSetting>(0, configs[Config::TransientAttachments].value, 0);
 	config.insert<vkb::IntSetting>(0, configs[Config::GBufferSize].value, 0);
+	config.insert<vkb::IntSetting>(0, configs[Config::LightCulling].value, 0);
 
 	// Use two render passes
 	config.insert<vkb::IntSetting>(1, configs[Config::RenderTechnique].value, 1);
 	config.insert<vkb::IntSetting>(1, configs[Config::TransientAttachments].value, 0);
 	config.insert<vkb::IntSetting>(1, configs[Config::GBufferSize].value, 0);
+	config.insert<vkb::IntSetting>(1, configs[Config::LightCulling].value, 0);
 
 	// Disable transient attachments
 	config.insert<vkb::IntSetting>(2, configs[Config::RenderTechnique].value, 0);
 	config.insert<vkb::IntSetting>(2, configs[Config::TransientAttachments].value, 1);
 	config.insert<vkb::IntSetting>(2, configs[Config::GBufferSize].value, 0);
+	config.insert<vkb::IntSetting>(2, configs[Config::LightCulling].value, 0);
 
 	// Increase G-buffer size
 	config.insert<vkb::IntSetting>(3, configs[Config::RenderTechnique].value, 0);
 	config.insert<vkb::IntSetting>(3, configs[Config::TransientAttachments].value, 0);
 	config.insert<vkb::IntSetting>(3, configs[Config::GBufferSize].value, 1);
+	config.insert<vkb::IntSetting>(3, configs[Config::LightCulling].value, 0);
+
+	// Pack the material parameters in the G-buffer
+	config.insert<vkb::IntSetting>(4, configs[Config::RenderTechnique].value, 0);
+	config.insert<vkb::IntSetting>(4, configs[Config::TransientAttachments].value, 0);
+	config.insert<vkb::IntSetting>(4, configs[Config::GBufferSize].value, 2);
+	config.insert<vkb::IntSetting>(4, configs[Config::LightCulling].value, 0);
+
+	// Forward render the lights binned into clusters
+	config.insert<vkb::IntSetting>(5, configs[Config::RenderTechnique].value, 2);
+	config.insert<vkb::IntSetting>(5, configs[Config::TransientAttachments].value, 0);
+	config.insert<vkb::IntSetting>(5, configs[Config::GBufferSize].value, 0);
+	config.insert<vkb::IntSetting>(5, configs[Config::LightCulling].value, 0);
+
+	// Bin the lights into clusters in the lighting subpass
+	config.insert<vkb::IntSetting>(6, configs[Config::RenderTechnique].value, 0);
+	config.insert<vkb::IntSetting>(6, configs[Config::TransientAttachments].value, 0);
+	config.insert<vkb::IntSetting>(6, configs[Config::GBufferSize].value, 0);
+	config.insert<vkb::IntSetting>(6, configs[Config::LightCulling].value, 1);
 }
 
 std::unique_ptr<vkb::RenderTarget> Subpasses::create_render_target(vkb::core::Image &&swapchain_image)
 {
-	auto &device = swapchain_image.get_device();
-	auto &extent = swapchain_image.get_extent();
-
 	// G-Buffer should fit 128-bit budget for buffer color storage
 	// in order to enable subpasses merging by the driver
 	// Light (swapchain_image) RGBA8_UNORM   (32-bit)
 	// Albedo                  RGBA8_UNORM   (32-bit)
 	// Normal                  RGB10A2_UNORM (32-bit)
+	// The packed layout keeps these formats, and fits the material parameters in them with an octahedral normal
+	vkb::GBufferConfig gbuffer_config;
+	gbuffer_config.layout    = gbuffer_layout;
+	gbuffer_config.transient = configs[Config::TransientAttachments].value == 0;
 
-	vkb::core::Image depth_image{device,
-	                             extent,
-	                             vkb::get_suitable_depth_format(swapchain_image.get_device().get_gpu().get_handle()),
-	                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | rt_usage_flags,
-	                             VMA_MEMORY_USAGE_GPU_ONLY};
-
-	vkb::core::Image albedo_image{device,
-	                              extent,
-	                              albedo_format,
-	                              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | rt_usage_flags,
-	                              VMA_MEMORY_USAGE_GPU_ONLY};
-
-	vkb::core::Image normal_image{device,
-	                              extent,
-	                              normal_format,
-	                              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | rt_usage_flags,
-	                              VMA_MEMORY_USAGE_GPU_ONLY};
-
-	std::vector<vkb::core::Image> images;
-
-	// Attachment 0
-	images.push_back(std::move(swapchain_image));
-
-	// Attachment 1
-	images.push_back(std::move(depth_image));
-
-	// Attachment 2
-	images.push_back(std::move(albedo_image));
-
-	// Attachment 3
-	images.push_back(std::move(normal_image));
-
-	return std::make_unique<vkb::RenderTarget>(std::move(images));
+	return vkb::RenderTarget::create_gbuffer_func(gbuffer_config)(std::move(swapchain_image));
 }
 
 void Subpasses::prepare_render_context()
@@ -155,12 +147,16 @@ bool Subpasses::prepare(const vkb::ApplicationOptions &options)
 	geometry_render_pipeline = create_geometry_renderpass();
 	lighting_render_pipeline = create_lighting_renderpass();
 
+	clustered_forward_render_pipeline = create_clustered_forward_renderpass();
+
 	// Enable stats
 	get_stats().request_stats({vkb::StatIndex::frame_times,
 	                           vkb::StatIndex::gpu_fragment_jobs,
 	                           vkb::StatIndex::gpu_tiles,
 	                           vkb::StatIndex::gpu_ext_read_bytes,
-	                           vkb::StatIndex::gpu_ext_write_bytes});
+	                           vkb::StatIndex::gpu_ext_write_bytes,
+	                           vkb::StatIndex::ext_read_bytes_saved,
+	                           vkb::StatIndex::ext_write_bytes_saved});
 
 	// Enable gui
 	create_gui(*window, &get_stats());
@@ -183,6 +179,25 @@ void Subpasses::update(float delta_time)
 		}
 	}
 
+	// Check whether the user switched the light culling
+	if (configs[Config::LightCulling].value != last_light_culling)
+	{
+		LOGI("Changing light culling");
+		last_light_culling = configs[Config::LightCulling].value;
+
+		// The lighting subpasses are prepared with the culling, and the old pipelines may still be in use
+		get_device().wait_idle();
+
+		render_pipeline          = create_one_renderpass_two_subpasses();
+		lighting_render_pipeline = create_lighting_renderpass();
+
+		// Reset frames, their synchronization objects and their command buffers
+		for (auto &frame : get_render_context().get_render_frames())
+		{
+			frame->reset();
+		}
+	}
+
 	// Check whether the user switched the attachment or the G-buffer option
 	if (configs[Config::TransientAttachments].value != last_transient_attachment ||
 	    configs[Config::GBufferSize].value != last_g_buffer_size)
@@ -190,14 +205,8 @@ void Subpasses::update(float delta_time)
 		// If attachment option has changed
 		if (configs[Config::TransientAttachments].value != last_transient_attachment)
 		{
-			rt_usage_flags = VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
-
-			// If attachment should be transient
-			if (configs[Config::TransientAttachments].value == 0)
-			{
-				rt_usage_flags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
-			}
-			else
+			// If attachment should not be transient
+			if (configs[Config::TransientAttachments].value != 0)
 			{
 				LOGI("Creating non transient attachments");
 			}
@@ -210,16 +219,26 @@ void Subpasses::update(float delta_time)
 			if (configs[Config::GBufferSize].value == 0)
 			{
 				// Use less bits
-				albedo_format = VK_FORMAT_R8G8B8A8_UNORM;                  // 32-bit
-				normal_format = VK_FORMAT_A2B10G10R10_UNORM_PACK32;        // 32-bit
+				gbuffer_layout = vkb::GBufferLayout::Default;
 			}
-			else
+			else if (configs[Config::GBufferSize].value == 1)
 			{
 				// Use more bits
-				albedo_format = VK_FORMAT_R32G32B32A32_SFLOAT;        // 128-bit
-				normal_format = VK_FORMAT_R32G32B32A32_SFLOAT;        // 128-bit
+				gbuffer_layout = vkb::GBufferLayout::Full;
+			}
+			else
+			{
+				// Use less bits for more data
+				gbuffer_layout = vkb::GBufferLayout::Packed;
 			}
 
+			// The shaders of the subpasses depend on the layout, and the old pipelines may still be in use
+			get_device().wait_idle();
+
+			render_pipeline          = create_one_renderpass_two_subpasses();
+			geometry_render_pipeline = create_geometry_renderpass();
+			lighting_render_pipeline = create_lighting_renderpass();
+
 			last_g_buffer_size = configs[Config::GBufferSize].value;
 		}
 
@@ -290,11 +309,14 @@ std::unique_ptr<vkb::RenderPipeline> Subpasses::create_one_renderpass_two_subpas
 
 	// Outputs are depth, albedo, and normal
 	scene_subpass->set_output_attachments({1, 2, 3});
+	scene_subpass->set_gbuffer_layout(gbuffer_layout);
 
 	// Lighting subpass
 	auto lighting_vs      = vkb::ShaderSource{"deferred/lighting.vert"};
 	auto lighting_fs      = vkb::ShaderSource{"deferred/lighting.frag"};
 	auto lighting_subpass = std::make_unique<vkb::LightingSubpass>(get_render_context(), std::move(lighting_vs), std::move(lighting_fs), *camera, get_scene());
+	lighting_subpass->set_gbuffer_layout(gbuffer_layout);
+	lighting_subpass->set_clustered_lighting(configs[Config::LightCulling].value != 0);
 
 	// Inputs are depth, albedo, and normal from the geometry subpass
 	lighting_subpass->set_input_attachments({1, 2, 3});
@@ -322,6 +344,7 @@ std::unique_ptr<vkb::RenderPipeline> Subpasses::create_geometry_renderpass()
 
 	// Outputs are depth, albedo, and normal
 	scene_subpass->set_output_attachments({1, 2, 3});
+	scene_subpass->set_gbuffer_layout(gbuffer_layout);
 
 	// Create geometry pipeline
 	std::vector<std::unique_ptr<vkb::Subpass>> scene_subpasses{};
@@ -342,6 +365,8 @@ std::unique_ptr<vkb::RenderPipeline> Subpasses::create_lighting_renderpass()
 	auto lighting_vs      = vkb::ShaderSource{"deferred/lighting.vert"};
 	auto lighting_fs      = vkb::ShaderSource{"deferred/lighting.frag"};
 	auto lighting_subpass = std::make_unique<vkb::LightingSubpass>(get_render_context(), std::move(lighting_vs), std::move(lighting_fs), *camera, get_scene());
+	lighting_subpass->set_gbuffer_layout(gbuffer_layout);
+	lighting_subpass->set_clustered_lighting(configs[Config::LightCulling].value != 0);
 
 	// Inputs are depth, albedo, and normal from the geometry subpass
 	lighting_subpass->set_input_attachments({1, 2, 3});
@@ -358,6 +383,29 @@ std::unique_ptr<vkb::RenderPipeline> Subpasses::create_lighting_renderpass()
 	return lighting_render_pipeline;
 }
 
+std::unique_ptr<vkb::RenderPipeline> Subpasses::create_clustered_forward_renderpass()
+{
+	// Clustered forward subpass
+	auto forward_vs      = vkb::ShaderSource{"base.vert"};
+	auto forward_fs      = vkb::ShaderSource{"base.frag"};
+	auto forward_subpass = std::make_unique<vkb::ClusteredForwardSubpass>(get_render_context(), std::move(forward_vs), std::move(forward_fs), get_scene(), *camera);
+
+	// Output is the swapchain image, with the depth attachment of the G-buffer, while albedo and normal are unused
+	forward_subpass->set_output_attachments({0});
+
+	// Create forward pipeline
+	std::vector<std::unique_ptr<vkb::Subpass>> forward_subpasses{};
+	forward_subpasses.push_back(std::move(forward_subpass));
+
+	auto clustered_forward_render_pipeline = std::make_unique<vkb::RenderPipeline>(std::move(forward_subpasses));
+
+	clustered_forward_render_pipeline->set_load_store(vkb::gbuffer::get_clear_all_store_swapchain());
+
+	clustered_forward_render_pipeline->set_clear_value(vkb::gbuffer::get_clear_value());
+
+	return clustered_forward_render_pipeline;
+}
+
 void draw_pipeline(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target, vkb::RenderPipeline &render_pipeline, vkb::Gui *gui = nullptr)
 {
 	auto &extent = render_target.get_extent();
@@ -427,6 +475,11 @@ void Subpasses::draw_renderpasses(vkb::CommandBuffer &command_buffer, vkb::Rende
 	draw_pipeline(command_buffer, render_target, *lighting_render_pipeline, &get_gui());
 }
 
+void Subpasses::draw_clustered_forward(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	draw_pipeline(command_buffer, render_target, *clustered_forward_render_pipeline, &get_gui());
+}
+
 void Subpasses::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
 {
 	if (configs[Config::RenderTechnique].value == 0)
@@ -434,11 +487,16 @@ void Subpasses::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderT
 		// Efficient way
 		draw_subpasses(command_buffer, render_target);
 	}
-	else
+	else if (configs[Config::RenderTechnique].value == 1)
 	{
 		// Inefficient way
 		draw_renderpasses(command_buffer, render_target);
 	}
+	else
+	{
+		// No G-buffer at all
+		draw_clustered_forward(command_buffer, render_target);
+	}
 }
 
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_subpasses()
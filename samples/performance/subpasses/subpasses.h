@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -65,6 +65,11 @@ class Subpasses : public vkb::VulkanSample<vkb::BindingType::C>
 	 */
 	std::unique_ptr<vkb::RenderPipeline> create_lighting_renderpass();
 
+	/**
+	 * @return A forward pipeline, which shades the lights binned into clusters
+	 */
+	std::unique_ptr<vkb::RenderPipeline> create_clustered_forward_renderpass();
+
 	/**
 	 * @brief Draws using the good pipeline: one render pass with two subpasses
 	 */
@@ -75,6 +80,11 @@ class Subpasses : public vkb::VulkanSample<vkb::BindingType::C>
 	 */
 	void draw_renderpasses(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target);
 
+	/**
+	 * @brief Draws using a single forward render pass, without G-buffer
+	 */
+	void draw_clustered_forward(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target);
+
 	std::unique_ptr<vkb::RenderTarget> create_render_target(vkb::core::Image &&swapchain_image);
 
 	/// Good pipeline with two subpasses within one render pass
@@ -86,6 +96,9 @@ class Subpasses : public vkb::VulkanSample<vkb::BindingType::C>
 	/// 2. Bad pipeline with a lighting subpass in the second render pass
 	std::unique_ptr<vkb::RenderPipeline> lighting_render_pipeline{};
 
+	/// Forward pipeline with a clustered forward subpass, for comparison with deferred rendering
+	std::unique_ptr<vkb::RenderPipeline> clustered_forward_render_pipeline{};
+
 	vkb::sg::PerspectiveCamera *camera{};
 
 	/**
@@ -101,7 +114,8 @@ class Subpasses : public vkb::VulkanSample<vkb::BindingType::C>
 		{
 			RenderTechnique,
 			TransientAttachments,
-			GBufferSize
+			GBufferSize,
+			LightCulling
 		} type;
 
 		/// Used as label by the GUI
@@ -117,15 +131,14 @@ class Subpasses : public vkb::VulkanSample<vkb::BindingType::C>
 	uint16_t last_render_technique{0};
 	uint16_t last_transient_attachment{0};
 	uint16_t last_g_buffer_size{0};
+	uint16_t last_light_culling{0};
 
-	VkFormat          albedo_format{VK_FORMAT_R8G8B8A8_UNORM};
-	VkFormat          normal_format{VK_FORMAT_A2B10G10R10_UNORM_PACK32};
-	VkImageUsageFlags rt_usage_flags{VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT};
+	vkb::GBufferLayout gbuffer_layout{vkb::GBufferLayout::Default};
 
 	std::vector<Config> configs = {
 	    {/* config      = */ Config::RenderTechnique,
 	     /* description = */ "Render technique",
-	     /* options     = */ {"Subpasses", "Renderpasses"},
+	     /* options     = */ {"Subpasses", "Renderpasses", "Clustered forward"},
 	     /* value       = */ 0},
 	    {/* config      = */ Config::TransientAttachments,
 	     /* description = */ "Transient attachments",
@@ -133,7 +146,11 @@ class Subpasses : public vkb::VulkanSample<vkb::BindingType::C>
 	     /* value       = */ 0},
 	    {/* config      = */ Config::GBufferSize,
 	     /* description = */ "G-Buffer size",
-	     /* options     = */ {"128-bit", "More"},
+	     /* options     = */ {"128-bit", "More", "Packed"},
+	     /* value       = */ 0},
+	    {/* config      = */ Config::LightCulling,
+	     /* description = */ "Light culling",
+	     /* options     = */ {"None", "Clustered"},
 	     /* value       = */ 0}};
 };
 
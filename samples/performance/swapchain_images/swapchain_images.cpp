@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2024, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -35,6 +35,19 @@ SwapchainImages::SwapchainImages()
 
 	config.insert<vkb::IntSetting>(0, swapchain_image_count, 3);
 	config.insert<vkb::IntSetting>(1, swapchain_image_count, 2);
+
+	// Optional, the low latency mode is only available with present wait
+	add_device_extension(VK_KHR_PRESENT_ID_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME, true);
+}
+
+void SwapchainImages::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	if (gpu.is_extension_supported(VK_KHR_PRESENT_ID_EXTENSION_NAME) && gpu.is_extension_supported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+	{
+		gpu.request_extension_features<VkPhysicalDevicePresentIdFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR);
+		gpu.request_extension_features<VkPhysicalDevicePresentWaitFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR);
+	}
 }
 
 bool SwapchainImages::prepare(const vkb::ApplicationOptions &options)
@@ -58,7 +71,7 @@ bool SwapchainImages::prepare(const vkb::ApplicationOptions &options)
 
 	set_render_pipeline(std::move(render_pipeline));
 
-	get_stats().request_stats({vkb::StatIndex::frame_times});
+	get_stats().request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::present_interval, vkb::StatIndex::input_to_photon_latency, vkb::StatIndex::event_to_photon_latency});
 	create_gui(*window, &get_stats());
 
 	return true;
@@ -77,6 +90,12 @@ void SwapchainImages::update(float delta_time)
 		last_swapchain_image_count = swapchain_image_count;
 	}
 
+	if (low_latency != get_render_context().uses_low_latency_mode() || target_latency_ms != last_target_latency_ms)
+	{
+		low_latency            = get_render_context().set_low_latency_mode(low_latency, std::chrono::microseconds{target_latency_ms * 1000});
+		last_target_latency_ms = target_latency_ms;
+	}
+
 	VulkanSample::update(delta_time);
 }
 
@@ -88,8 +107,15 @@ void SwapchainImages::draw_gui()
 		    ImGui::SameLine();
 		    ImGui::RadioButton("Triple buffering", &swapchain_image_count, 3);
 		    ImGui::SameLine();
+
+		    if (get_device().uses_present_wait())
+		    {
+			    ImGui::Checkbox("Low latency", &low_latency);
+			    ImGui::SameLine();
+			    ImGui::SliderInt("Target latency (ms)", &target_latency_ms, 0, 100);
+		    }
 	    },
-	    /* lines = */ 1);
+	    /* lines = */ get_device().uses_present_wait() ? 2 : 1);
 }
 
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_swapchain_images()
@@ -36,6 +36,8 @@ class SwapchainImages : public vkb::VulkanSample<vkb::BindingType::C>
 
 	virtual void update(float delta_time) override;
 
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
   private:
 	vkb::sg::Camera *camera{nullptr};
 
@@ -44,6 +46,12 @@ class SwapchainImages : public vkb::VulkanSample<vkb::BindingType::C>
 	int swapchain_image_count{3};
 
 	int last_swapchain_image_count{3};
+
+	bool low_latency{false};
+
+	int target_latency_ms{0};
+
+	int last_target_latency_ms{0};
 };
 
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_swapchain_images();
@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2024, Holochip
+/* Copyright (c) 2021-2026, Holochip
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,6 +16,11 @@
  */
 
 #include "texture_compression_comparison.h"
+
+#include <cmath>
+#include <limits>
+#include <tuple>
+
 #include "rendering/subpasses/forward_subpass.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
@@ -86,7 +91,11 @@ bool TextureCompressionComparison::prepare(const vkb::ApplicationOptions &option
 
 void TextureCompressionComparison::update(float delta_time)
 {
-	if (require_redraw)
+	if (reporting)
+	{
+		update_report();
+	}
+	else if (require_redraw)
 	{
 		const auto &formats = get_texture_formats();
 		require_redraw      = false;
@@ -112,28 +121,34 @@ void TextureCompressionComparison::draw_gui()
 		return in.c_str();
 	});
 
-	get_gui().show_options_window([this, &name_pointers]() {
-		if (ImGui::Combo("Compressed Format", &current_gui_format, name_pointers.data(), static_cast<int>(name_pointers.size())))
-		{
-			require_redraw     = true;
-			const auto &format = get_texture_formats()[current_gui_format];
-			if (is_texture_format_supported(format))
-			{
-				current_format = current_gui_format;
-			}
-		}
-		const auto &format = get_texture_formats()[current_gui_format];
-		if (is_texture_format_supported(format))
-		{
-			ImGui::Text("Format name: %s", format.format_name);
-			ImGui::Text("Bytes: %f MB", static_cast<float>(current_benchmark.total_bytes) / 1024.f / 1024.f);
-			ImGui::Text("Compression Time: %f (ms)", current_benchmark.compress_time_ms);
-		}
-		else
-		{
-			ImGui::Text("%s not supported on this GPU.", format.short_name);
-		}
-	});
+	get_gui().show_options_window(
+	    /* body = */ [this, &name_pointers]() {
+		    if (ImGui::Combo("Compressed Format", &current_gui_format, name_pointers.data(), static_cast<int>(name_pointers.size())))
+		    {
+			    require_redraw     = true;
+			    const auto &format = get_texture_formats()[current_gui_format];
+			    if (is_texture_format_supported(format))
+			    {
+				    current_format = current_gui_format;
+			    }
+		    }
+		    const auto &format = get_texture_formats()[current_gui_format];
+		    if (is_texture_format_supported(format))
+		    {
+			    ImGui::Text("Format name: %s", format.format_name);
+			    ImGui::Text("Bytes: %f MB", static_cast<float>(current_benchmark.total_bytes) / 1024.f / 1024.f);
+			    ImGui::Text("Compression Time: %f (ms)", current_benchmark.compress_time_ms);
+		    }
+		    else
+		    {
+			    ImGui::Text("%s not supported on this GPU.", format.short_name);
+		    }
+		    if (ImGui::Button("Run report"))
+		    {
+			    start_report();
+		    }
+	    },
+	    /* lines = */ 5);
 }
 
 const std::vector<TextureCompressionComparison::CompressedTexture_t> &TextureCompressionComparison::get_texture_formats()
@@ -187,7 +202,15 @@ bool TextureCompressionComparison::is_texture_format_supported(const TextureComp
 	const bool supported_by_extension = strlen(format.extension_name) && get_device().is_extension_supported(format.extension_name);
 	const bool supported_by_default   = format.always_supported;
 
-	return supported_by_default || supported_by_feature || supported_by_extension;
+	if (!supported_by_default && !supported_by_feature && !supported_by_extension)
+	{
+		return false;
+	}
+
+	// The format properties are looked up in the capabilities probed by a previous launch, so listing the formats is cheap
+	const auto format_properties = get_device().get_gpu().get_format_properties(format.format);
+
+	return (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
 }
 
 void TextureCompressionComparison::get_available_texture_formats()
@@ -369,6 +392,170 @@ std::pair<std::unique_ptr<vkb::sg::Image>, TextureCompressionComparison::Texture
 	return {std::move(image), benchmark};
 }
 
+void TextureCompressionComparison::start_report()
+{
+	// The reference frame of the quality measurements is the one drawn with the uncompressed textures,
+	// which are always supported and listed first
+	assert(!available_texture_formats.empty() && available_texture_formats.front().ktx_format == KTX_TTF_RGBA32);
+
+	report.clear();
+	for (auto &format : available_texture_formats)
+	{
+		FormatReport entry;
+		entry.short_name  = format.short_name;
+		entry.format_name = format.format_name;
+		report.push_back(entry);
+	}
+	reference_pixels.clear();
+
+	auto surface_format = get_render_context().get_format();
+	if (!readback && (surface_format == VK_FORMAT_R8G8B8A8_UNORM || surface_format == VK_FORMAT_B8G8R8A8_UNORM ||
+	                  surface_format == VK_FORMAT_R8G8B8A8_SRGB || surface_format == VK_FORMAT_B8G8R8A8_SRGB))
+	{
+		readback = std::make_unique<vkb::FrameReadback>(get_render_context());
+	}
+
+	get_render_context().set_gpu_frame_timing(true);
+
+	// The overlay would be part of the frames compared
+	vkb::Gui::visible = false;
+
+	reporting     = true;
+	report_format = 0;
+	report_frame  = 0;
+
+	LOGI("Measuring {} texture formats, keep the camera still", report.size());
+}
+
+void TextureCompressionComparison::update_report()
+{
+	auto &entry = report[report_format];
+
+	// Taken every frame, so that the frames measured are the ones drawn with the textures of the format
+	double gpu_frame_time = get_render_context().take_gpu_frame_time();
+
+	if (report_frame == 0)
+	{
+		entry.total_bytes = update_textures(available_texture_formats[report_format]).total_bytes;
+	}
+	else if (report_frame > REPORT_WARMUP_FRAMES)
+	{
+		if (gpu_frame_time > 0.0)
+		{
+			entry.gpu_frame_time_ms += static_cast<float>(gpu_frame_time * 1000.0);
+			entry.gpu_frames++;
+		}
+
+		auto &stats = get_stats();
+		if (stats.is_available(vkb::StatIndex::gpu_ext_read_bytes))
+		{
+			entry.ext_read_mib_s += stats.get_data(vkb::StatIndex::gpu_ext_read_bytes).back() / (1024.f * 1024.f);
+			entry.ext_read_frames++;
+		}
+	}
+
+	if (++report_frame <= REPORT_WARMUP_FRAMES + REPORT_FRAMES)
+	{
+		return;
+	}
+
+	// The last frame drawn is the last one with the textures of the format
+	capture_report_quality(report_format);
+
+	report_frame = 0;
+	if (++report_format < report.size())
+	{
+		return;
+	}
+
+	if (readback)
+	{
+		readback->flush();
+	}
+
+	write_report();
+
+	reporting         = false;
+	require_redraw    = true;
+	vkb::Gui::visible = true;
+}
+
+void TextureCompressionComparison::capture_report_quality(size_t index)
+{
+	if (!readback)
+	{
+		return;
+	}
+
+	// The frames are compared rather than the textures, so that the error is the one seen on screen, once filtered and lit.
+	// The callbacks run in order on the thread of the readback, the main thread reads the results after flushing it.
+	readback->capture([this, index](const uint8_t *pixels, uint32_t width, uint32_t height) {
+		size_t size = static_cast<size_t>(width) * height * 4;
+
+		if (index == 0)
+		{
+			reference_pixels.assign(pixels, pixels + size);
+			report[index].psnr_db = std::numeric_limits<float>::infinity();
+			return;
+		}
+
+		if (reference_pixels.size() != size)
+		{
+			return;
+		}
+
+		// Alpha is always opaque in the frames read back
+		double squared_error = 0.0;
+		for (size_t i = 0; i < size; i += 4)
+		{
+			for (size_t c = 0; c < 3; c++)
+			{
+				double error = static_cast<double>(pixels[i + c]) - static_cast<double>(reference_pixels[i + c]);
+				squared_error += error * error;
+			}
+		}
+
+		double mean_squared_error = squared_error / (static_cast<double>(width) * height * 3);
+		report[index].psnr_db     = mean_squared_error > 0.0 ? static_cast<float>(10.0 * std::log10(255.0 * 255.0 / mean_squared_error)) :
+		                                                       std::numeric_limits<float>::infinity();
+	});
+}
+
+void TextureCompressionComparison::write_report()
+{
+	for (auto &entry : report)
+	{
+		entry.gpu_frame_time_ms = entry.gpu_frames > 0 ? entry.gpu_frame_time_ms / entry.gpu_frames : 0.f;
+		entry.ext_read_mib_s    = entry.ext_read_frames > 0 ? entry.ext_read_mib_s / entry.ext_read_frames : 0.f;
+	}
+
+	// Cheapest first: by external read bandwidth where the GPU counters are available, then by GPU frame time
+	std::stable_sort(report.begin(), report.end(), [](const FormatReport &a, const FormatReport &b) {
+		return std::tie(a.ext_read_mib_s, a.gpu_frame_time_ms) < std::tie(b.ext_read_mib_s, b.gpu_frame_time_ms);
+	});
+
+	std::string filename = vkb::fs::path::get(vkb::fs::path::Type::Logs) + "texture_compression_report.csv";
+
+	std::ofstream file{filename};
+	if (!file)
+	{
+		LOGE("Cannot write the texture compression report to {}", filename);
+		return;
+	}
+
+	// A PSNR of 0 was not measured, an infinite one is the reference or identical to it
+	file << "format,ktx_format,bytes,gpu_frame_time_ms,ext_read_mib_s,psnr_db\n";
+	for (auto &entry : report)
+	{
+		file << fmt::format("{},{},{},{:.4f},{:.2f},{:.2f}\n", entry.short_name, entry.format_name, entry.total_bytes, entry.gpu_frame_time_ms, entry.ext_read_mib_s, entry.psnr_db);
+
+		LOGI("{}: {:.1f} MiB, GPU frame time {:.2f} ms, external reads {:.1f} MiB/s, PSNR {:.2f} dB",
+		     entry.short_name, entry.total_bytes / (1024.0 * 1024.0), entry.gpu_frame_time_ms, entry.ext_read_mib_s, entry.psnr_db);
+	}
+
+	LOGI("Texture compression report written to {}", filename);
+}
+
 std::unique_ptr<TextureCompressionComparison> create_texture_compression_comparison()
 {
 	return std::make_unique<TextureCompressionComparison>();
@@ -20,6 +20,7 @@
 #include "ktx.h"
 
 #include "api_vulkan_sample.h"
+#include "rendering/frame_readback.h"
 #include "scene_graph/components/camera.h"
 
 class TextureCompressionComparison : public vkb::VulkanSample<vkb::BindingType::C>
@@ -57,6 +58,25 @@ class TextureCompressionComparison : public vkb::VulkanSample<vkb::BindingType::
 		float        frame_time_ms    = 0.f;
 	};
 
+	/// Measurements of a format in the report, see start_report()
+	struct FormatReport
+	{
+		const char  *short_name        = "";
+		const char  *format_name       = "";
+		VkDeviceSize total_bytes       = 0;
+		float        gpu_frame_time_ms = 0.f;
+		float        ext_read_mib_s    = 0.f;
+		float        psnr_db           = 0.f;
+		uint32_t     gpu_frames        = 0;
+		uint32_t     ext_read_frames   = 0;
+	};
+
+	/// Frames drawn with the textures of a format before it is measured, so that the frames with the previous textures retire
+	static constexpr uint32_t REPORT_WARMUP_FRAMES = 10;
+
+	/// Frames measured for each format
+	static constexpr uint32_t REPORT_FRAMES = 60;
+
 	struct SampleTexture
 	{
 		std::vector<uint8_t>            raw_bytes;
@@ -74,6 +94,10 @@ class TextureCompressionComparison : public vkb::VulkanSample<vkb::BindingType::
 	std::unique_ptr<vkb::sg::Image>                              create_image(ktxTexture2 *ktx_texture, const std::string &name);
 	static std::vector<uint8_t>                                  get_raw_image(const std::string &filename);
 	std::pair<std::unique_ptr<vkb::sg::Image>, TextureBenchmark> compress(const std::string &filename, CompressedTexture_t texture_format, const std::string &name);
+	void                                                         start_report();
+	void                                                         update_report();
+	void                                                         capture_report_quality(size_t index);
+	void                                                         write_report();
 	std::vector<std::string>                                     gui_texture_names;
 	std::vector<CompressedTexture_t>                             available_texture_formats = {};
 	std::unordered_map<std::string, SampleTexture>               texture_raw_data;
@@ -82,6 +106,12 @@ class TextureCompressionComparison : public vkb::VulkanSample<vkb::BindingType::
 	TextureBenchmark                                             current_benchmark{};
 	int                                                          current_format = 0, current_gui_format = 0;
 	bool                                                         require_redraw = true;
+	bool                                                         reporting      = false;
+	size_t                                                       report_format  = 0;
+	uint32_t                                                     report_frame   = 0;
+	std::vector<FormatReport>                                    report;
+	std::vector<uint8_t>                                         reference_pixels;
+	std::unique_ptr<vkb::FrameReadback>                          readback;
 };
 
 std::unique_ptr<TextureCompressionComparison> create_texture_compression_comparison();
@@ -1,4 +1,4 @@
-/* Copyright (c) 2022-2024, Sascha Willems
+/* Copyright (c) 2022-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -37,6 +37,9 @@
 Profiles::Profiles()
 {
 	title = "Vulkan Profiles";
+
+	// The instance and device are created from the profile, see create_instance() and create_device()
+	set_device_sharing_enable(false);
 }
 
 Profiles::~Profiles()
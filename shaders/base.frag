@@ -1,5 +1,5 @@
 #version 320 es
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,9 +16,20 @@
  * limitations under the License.
  */
 
+#include "half_precision.h"
+
 precision highp float;
 
-#ifdef HAS_BASE_COLOR_TEXTURE
+#if defined(BINDLESS_MATERIALS)
+#	if MATERIAL_TEXTURE_COUNT > 0
+layout(set = 1, binding = 0) uniform sampler2D material_textures[MATERIAL_TEXTURE_COUNT];
+#	endif
+#	if defined(MATERIAL_TEXTURE_ARRAY_COUNT)
+// Textures packed by vkb::GLTFLoader::set_texture_arrays(), indexed by the low 16 bits of the texture indices
+precision highp sampler2DArray;
+layout(set = 1, binding = 1) uniform sampler2DArray material_texture_arrays[MATERIAL_TEXTURE_ARRAY_COUNT];
+#	endif
+#elif defined(HAS_BASE_COLOR_TEXTURE)
 layout(set = 0, binding = 0) uniform sampler2D base_color_texture;
 #endif
 
@@ -28,6 +39,14 @@ layout(location = 2) in vec3 in_normal;
 
 layout(location = 0) out vec4 o_color;
 
+#if defined(MOTION_VECTORS)
+layout(location = 3) in vec4 in_current_clip;
+layout(location = 4) in vec4 in_previous_clip;
+
+// Screen space motion from the previous frame in texture coordinates, see vkb::GeometrySubpass::set_motion_vectors()
+layout(location = 1) out vec2 o_velocity;
+#endif
+
 layout(set = 0, binding = 1) uniform GlobalUniform
 {
 	mat4 model;
@@ -43,6 +62,15 @@ layout(push_constant, std430) uniform PBRMaterialUniform
 	vec4  base_color_factor;
 	float metallic_factor;
 	float roughness_factor;
+#ifdef BINDLESS_MATERIALS
+	// Indices in material_textures, -1 if the material has no such texture
+	// Textures in material_texture_arrays have their layer plus one in the bits above the low 16
+	int base_color_texture_index;
+	int normal_texture_index;
+	int metallic_roughness_texture_index;
+	int occlusion_texture_index;
+	int emissive_texture_index;
+#endif
 }
 pbr_material_uniform;
 
@@ -56,21 +84,67 @@ layout(set = 0, binding = 4) uniform LightsInfo
 }
 lights_info;
 
+#ifdef CLUSTERED_LIGHTING
+#include "clustered_lighting.h"
+#endif
+
+#if defined(CASCADED_SHADOWS)
+#include "cascaded_shadows.h"
+#elif defined(RAY_QUERY_SHADOWS)
+#include "ray_query_shadows.h"
+#endif
+
+#if defined(BINDLESS_MATERIALS)
+vec4 sample_material_texture(int index, vec2 uv)
+{
+#	if defined(MATERIAL_TEXTURE_ARRAY_COUNT)
+	if (index >= 0x10000)
+	{
+		return texture(material_texture_arrays[index & 0xffff], vec3(uv, float((index >> 16) - 1)));
+	}
+#	endif
+#	if MATERIAL_TEXTURE_COUNT > 0
+	return texture(material_textures[index], uv);
+#	else
+	return vec4(1.0);
+#	endif
+}
+#endif
+
 layout(constant_id = 0) const uint DIRECTIONAL_LIGHT_COUNT = 0U;
 layout(constant_id = 1) const uint POINT_LIGHT_COUNT       = 0U;
 layout(constant_id = 2) const uint SPOT_LIGHT_COUNT        = 0U;
 
 void main(void)
 {
-	vec3 normal = normalize(in_normal);
+	// Positions stay in full precision, the colors and directions are half precision with FP16_ARITHMETIC
+	hvec3 normal = hvec3(normalize(in_normal));
 
-	vec3 light_contribution = vec3(0.0);
+	hvec3 light_contribution = hvec3(0.0);
 
 	for (uint i = 0U; i < DIRECTIONAL_LIGHT_COUNT; ++i)
 	{
-		light_contribution += apply_directional_light(lights_info.directional_lights[i], normal);
+		hvec3 contribution = apply_directional_light(lights_info.directional_lights[i], normal);
+
+		// Only the first directional light casts shadows
+#if defined(CASCADED_SHADOWS)
+		if (i == 0U)
+		{
+			contribution *= hfloat(calculate_cascaded_shadow(in_pos.xyz));
+		}
+#elif defined(RAY_QUERY_SHADOWS)
+		if (i == 0U)
+		{
+			contribution *= hfloat(get_ray_query_shadow(gl_FragCoord.xy, gl_FragCoord.z));
+		}
+#endif
+
+		light_contribution += contribution;
 	}
 
+#ifdef CLUSTERED_LIGHTING
+	light_contribution += hvec3(min(apply_cluster_lights(in_pos.xyz, vec3(normal)), vec3(HFLOAT_MAX)));
+#else
 	for (uint i = 0U; i < POINT_LIGHT_COUNT; ++i)
 	{
 		light_contribution += apply_point_light(lights_info.point_lights[i], in_pos.xyz, normal);
@@ -80,16 +154,31 @@ void main(void)
 	{
 		light_contribution += apply_spot_light(lights_info.spot_lights[i], in_pos.xyz, normal);
 	}
+#endif
 
-	vec4 base_color = vec4(1.0, 0.0, 0.0, 1.0);
+	hvec4 base_color = hvec4(1.0, 0.0, 0.0, 1.0);
 
-#ifdef HAS_BASE_COLOR_TEXTURE
-	base_color = texture(base_color_texture, in_uv);
+#if defined(BINDLESS_MATERIALS)
+	// The index is the same for the whole draw, so it is dynamically uniform
+	if (pbr_material_uniform.base_color_texture_index >= 0)
+	{
+		base_color = hvec4(sample_material_texture(pbr_material_uniform.base_color_texture_index, in_uv));
+	}
+	else
+	{
+		base_color = hvec4(pbr_material_uniform.base_color_factor);
+	}
+#elif defined(HAS_BASE_COLOR_TEXTURE)
+	base_color = hvec4(texture(base_color_texture, in_uv));
 #else
-	base_color = pbr_material_uniform.base_color_factor;
+	base_color = hvec4(pbr_material_uniform.base_color_factor);
 #endif
 
-	vec3 ambient_color = vec3(0.2) * base_color.xyz;
+	hvec3 ambient_color = hvec3(0.2) * base_color.xyz;
 
 	o_color = vec4(ambient_color + light_contribution * base_color.xyz, base_color.w);
+
+#if defined(MOTION_VECTORS)
+	o_velocity = (in_current_clip.xy / in_current_clip.w - in_previous_clip.xy / in_previous_clip.w) * 0.5;
+#endif
 }
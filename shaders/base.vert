@@ -1,5 +1,5 @@
 #version 320 es
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,27 +16,132 @@
  * limitations under the License.
  */
 
+#ifdef MULTIVIEW
+#	extension GL_EXT_multiview : require
+#endif
+
+#ifdef VERTEX_PULLING
+// Vertices packed by vkb::GLTFLoader::set_vertex_pulling(), five words each: the position, the texture coordinates
+// as half floats and the octahedral normal, read at gl_VertexIndex without vertex input state
+layout(std430, set = 0, binding = 7) readonly buffer PulledVertices {
+    uint pulled_vertices[];
+};
+#else
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec2 texcoord_0;
+// Octahedral normals only fill the first two components
 layout(location = 2) in vec3 normal;
+#endif
 
 layout(set = 0, binding = 1) uniform GlobalUniform {
     mat4 model;
     mat4 view_proj;
     vec3 camera_position;
+    vec4 position_offset;
+    vec4 position_scale;
+    mat4 previous_model;
+    mat4 previous_view_proj;
+    vec4 jitter;
 } global_uniform;
 
+#ifdef INSTANCING
+// Model matrices of the nodes drawn as instances of a single draw, see vkb::GeometrySubpass::set_instancing()
+struct Instance
+{
+    mat4 model;
+    mat4 previous_model;
+};
+
+layout(std430, set = 0, binding = 14) readonly buffer Instances {
+    Instance instances[];
+};
+#endif
+
+#ifdef MULTIVIEW
+#include "multiview.h"
+#endif
+
+#include "skinning.h"
+#include "vertex_compression.h"
+
 layout (location = 0) out vec4 o_pos;
 layout (location = 1) out vec2 o_uv;
 layout (location = 2) out vec3 o_normal;
 
+// The depth must match the one of depth_prepass.vert, see vkb::DepthPrepassSubpass
+invariant gl_Position;
+
+#ifdef MOTION_VECTORS
+// Clip space positions of the current frame without jitter and of the previous frame, see vkb::GeometrySubpass::set_motion_vectors()
+layout (location = 3) out vec4 o_current_clip;
+layout (location = 4) out vec4 o_previous_clip;
+#endif
+
 void main(void)
 {
-    o_pos = global_uniform.model * vec4(position, 1.0);
+#ifdef VERTEX_PULLING
+    uint vertex = uint(gl_VertexIndex) * 5u;
+    vec3 position = uintBitsToFloat(uvec3(pulled_vertices[vertex], pulled_vertices[vertex + 1u], pulled_vertices[vertex + 2u]));
+    vec2 texcoord_0 = unpackHalf2x16(pulled_vertices[vertex + 3u]);
+    vec3 normal = decode_octahedral(unpackSnorm2x16(pulled_vertices[vertex + 4u]));
+#endif
+
+#ifdef INSTANCING
+    mat4 node_model = instances[gl_InstanceIndex].model;
+#else
+    mat4 node_model = global_uniform.model;
+#endif
+
+#ifdef SKINNING
+    mat4 model = node_model * get_skin_matrix();
+#else
+    mat4 model = node_model;
+#endif
+
+    vec4 local_position = vec4(position, 1.0);
+    if (QUANTIZED_POSITION)
+    {
+        local_position.xyz = decode_position(position, global_uniform.position_offset, global_uniform.position_scale);
+    }
+
+    o_pos = model * local_position;
 
     o_uv = texcoord_0;
 
-    o_normal = mat3(global_uniform.model) * normal;
+    if (OCTAHEDRAL_NORMAL)
+    {
+        o_normal = mat3(model) * decode_octahedral(normal.xy);
+    }
+    else
+    {
+        o_normal = mat3(model) * normal;
+    }
 
+#ifdef MULTIVIEW
+    gl_Position = multiview_uniform.view_proj[gl_ViewIndex] * o_pos;
+#else
     gl_Position = global_uniform.view_proj * o_pos;
+#endif
+
+#ifdef MOTION_VECTORS
+    o_current_clip = vec4(gl_Position.xy - global_uniform.jitter.xy * gl_Position.w, gl_Position.zw);
+
+    // The skin of the previous frame is not kept, so skinned meshes reuse the current one
+#ifdef INSTANCING
+    mat4 previous_node_model = instances[gl_InstanceIndex].previous_model;
+#else
+    mat4 previous_node_model = global_uniform.previous_model;
+#endif
+#ifdef SKINNING
+    mat4 previous_model = previous_node_model * get_skin_matrix();
+#else
+    mat4 previous_model = previous_node_model;
+#endif
+#ifdef MULTIVIEW
+    mat4 previous_view_proj = multiview_uniform.previous_view_proj[gl_ViewIndex];
+#else
+    mat4 previous_view_proj = global_uniform.previous_view_proj;
+#endif
+    o_previous_clip = previous_view_proj * previous_model * local_position;
+#endif
 }
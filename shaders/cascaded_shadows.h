@@ -0,0 +1,73 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Cascaded shadow maps of a directional light, see vkb::CascadedShadowMap, bound with CascadedShadowMap::bind() at bindings 5 and 9.
+// Depth is reversed, positions nearer to the light than the shadow map compare as lit.
+
+precision highp sampler2DArrayShadow;
+
+layout(set = 0, binding = 5) uniform sampler2DArrayShadow cascaded_shadow_map;
+
+layout(set = 0, binding = 9) uniform CascadedShadowUniform
+{
+	mat4  light_matrices[4];
+	vec4  split_depths;         // view space distance at which each cascade ends
+	uvec4 cascade_count;        // x number of cascades
+}
+cascaded_shadow_uniform;
+
+float sample_cascade(vec3 pos, uint cascade)
+{
+	vec4 projected_coord = cascaded_shadow_uniform.light_matrices[cascade] * vec4(pos, 1.0);
+	projected_coord /= projected_coord.w;
+	projected_coord.xy = 0.5 * projected_coord.xy + 0.5;
+
+	return texture(cascaded_shadow_map, vec4(projected_coord.xy, float(cascade), projected_coord.z));
+}
+
+// Returns 1 where the world space position is lit and 0 where it is in shadow, past the last cascade positions are lit
+float calculate_cascaded_shadow(vec3 pos, float view_depth)
+{
+	uint cascade = 0U;
+	while (cascade < cascaded_shadow_uniform.cascade_count.x && view_depth > cascaded_shadow_uniform.split_depths[cascade])
+	{
+		++cascade;
+	}
+
+	if (cascade == cascaded_shadow_uniform.cascade_count.x)
+	{
+		return 1.0;
+	}
+
+	return sample_cascade(pos, cascade);
+}
+
+// Same as above without the view depth, the position is shadowed by the first cascade whose box holds it.
+// The cascades are bounding boxes of the slices, so this is the cascade of the slice or a nearer one.
+float calculate_cascaded_shadow(vec3 pos)
+{
+	for (uint cascade = 0U; cascade < cascaded_shadow_uniform.cascade_count.x; ++cascade)
+	{
+		vec4 projected_coord = cascaded_shadow_uniform.light_matrices[cascade] * vec4(pos, 1.0);
+		if (all(lessThanEqual(abs(projected_coord.xy), vec2(projected_coord.w))))
+		{
+			return sample_cascade(pos, cascade);
+		}
+	}
+
+	return 1.0;
+}
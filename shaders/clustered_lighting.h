@@ -0,0 +1,75 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Point and spot lights binned into clusters by clustered_light_cull.comp, see vkb::LightClusters.
+// Must be included after lighting.h, with MAX_LIGHTS_PER_CLUSTER defined.
+
+layout(set = 0, binding = 6) uniform ClusterUniform
+{
+	mat4  view;
+	vec4  projection;           // x, y scales and x, y offsets of the projection
+	vec4  depth_slicing;        // near and far depths, scale and bias of the slice of a log depth
+	uvec4 grid;                 // xyz number of clusters, w number of lights
+}
+cluster_uniform;
+
+layout(std430, set = 0, binding = 7) readonly buffer ClusterLightBuffer
+{
+	Light cluster_light_data[];
+};
+
+// For each cluster, the number of lights then their indices in cluster_light_data
+layout(std430, set = 0, binding = 8) readonly buffer ClusterLightsBuffer
+{
+	uint cluster_lights[];
+};
+
+uint get_cluster_base(vec3 pos)
+{
+	vec4  view_pos = cluster_uniform.view * vec4(pos, 1.0);
+	float depth    = max(-view_pos.z, cluster_uniform.depth_slicing.x);
+	vec2  ndc      = view_pos.xy * cluster_uniform.projection.xy / depth - cluster_uniform.projection.zw;
+	vec3  grid     = vec3(cluster_uniform.grid.xyz);
+	vec2  tile     = clamp(floor((ndc * 0.5 + 0.5) * grid.xy), vec2(0.0), grid.xy - 1.0);
+	float slice    = clamp(floor(log(depth) * cluster_uniform.depth_slicing.z + cluster_uniform.depth_slicing.w), 0.0, grid.z - 1.0);
+	uint  cluster  = (uint(slice) * cluster_uniform.grid.y + uint(tile.y)) * cluster_uniform.grid.x + uint(tile.x);
+	return cluster * (MAX_LIGHTS_PER_CLUSTER + 1U);
+}
+
+vec3 apply_cluster_lights(vec3 pos, vec3 normal)
+{
+	uint cluster_base        = get_cluster_base(pos);
+	uint cluster_light_count = cluster_lights[cluster_base];
+
+	vec3 light_contribution = vec3(0.0);
+
+	for (uint i = 0U; i < cluster_light_count; ++i)
+	{
+		Light light = cluster_light_data[cluster_lights[cluster_base + 1U + i]];
+
+		if (light.position.w == POINT_LIGHT)
+		{
+			light_contribution += apply_point_light(light, pos, normal);
+		}
+		else
+		{
+			light_contribution += apply_spot_light(light, pos, normal);
+		}
+	}
+
+	return light_contribution;
+}
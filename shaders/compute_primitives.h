@@ -0,0 +1,152 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Workgroup wide reductions and scans of uints shared by the shaders of vkb::ComputePrimitives. They use subgroup
+// arithmetic with SUBGROUP_ARITHMETIC, otherwise trees in shared memory. Each function contains barriers, so it must be
+// called from uniform control flow by every invocation of a workgroup of local_size_x = WORKGROUP_SIZE.
+
+#ifdef SUBGROUP_ARITHMETIC
+#	extension GL_KHR_shader_subgroup_basic : require
+#	extension GL_KHR_shader_subgroup_arithmetic : require
+#endif
+
+#define WORKGROUP_SIZE 256
+
+// Same as ReduceOperation in vkb::ComputePrimitives
+#if defined(REDUCE_MIN)
+#	define REDUCE_IDENTITY 0xffffffffU
+#	define reduce_operation(a, b) min(a, b)
+#	define subgroup_reduce_operation(value) subgroupMin(value)
+#elif defined(REDUCE_MAX)
+#	define REDUCE_IDENTITY 0U
+#	define reduce_operation(a, b) max(a, b)
+#	define subgroup_reduce_operation(value) subgroupMax(value)
+#else
+#	define REDUCE_IDENTITY 0U
+#	define reduce_operation(a, b) ((a) + (b))
+#	define subgroup_reduce_operation(value) subgroupAdd(value)
+#endif
+
+// A subgroup has at least one invocation, so there are at most WORKGROUP_SIZE of them
+shared uint workgroup_scratch[WORKGROUP_SIZE];
+
+// Index of the workgroup in a dispatch split over x and y, as large dispatches exceed the group count limit of x
+uint get_workgroup_index()
+{
+	return gl_WorkGroupID.x + gl_WorkGroupID.y * gl_NumWorkGroups.x;
+}
+
+// Returns the reduction of the values of every invocation of the workgroup
+uint workgroup_reduce(uint value)
+{
+#ifdef SUBGROUP_ARITHMETIC
+	value = subgroup_reduce_operation(value);
+
+	if (subgroupElect())
+	{
+		workgroup_scratch[gl_SubgroupID] = value;
+	}
+
+	barrier();
+
+	// Every subgroup reduces the results of the subgroups, as many at a time as it has invocations
+	uint result = REDUCE_IDENTITY;
+	for (uint first = 0U; first < gl_NumSubgroups; first += gl_SubgroupSize)
+	{
+		uint i = first + gl_SubgroupInvocationID;
+		result = reduce_operation(result, subgroup_reduce_operation(i < gl_NumSubgroups ? workgroup_scratch[i] : REDUCE_IDENTITY));
+	}
+#else
+	uint index = gl_LocalInvocationIndex;
+
+	workgroup_scratch[index] = value;
+
+	barrier();
+
+	for (uint stride = WORKGROUP_SIZE / 2U; stride > 0U; stride >>= 1)
+	{
+		if (index < stride)
+		{
+			workgroup_scratch[index] = reduce_operation(workgroup_scratch[index], workgroup_scratch[index + stride]);
+		}
+
+		barrier();
+	}
+
+	uint result = workgroup_scratch[0];
+#endif
+
+	// The scratch memory may be written again by the next call
+	barrier();
+
+	return result;
+}
+
+// Returns the sum of the values of the invocations before this one in the workgroup, and the sum of all of them in total
+uint workgroup_exclusive_add(uint value, out uint total)
+{
+#ifdef SUBGROUP_ARITHMETIC
+	uint prefix = subgroupExclusiveAdd(value);
+	uint sum    = subgroupAdd(value);
+
+	if (subgroupElect())
+	{
+		workgroup_scratch[gl_SubgroupID] = sum;
+	}
+
+	barrier();
+
+	// Every subgroup adds up the sums of the subgroups before it, and of all of them, as many at a time as it has invocations
+	uint offset = 0U;
+	total       = 0U;
+	for (uint first = 0U; first < gl_NumSubgroups; first += gl_SubgroupSize)
+	{
+		uint i            = first + gl_SubgroupInvocationID;
+		uint subgroup_sum = i < gl_NumSubgroups ? workgroup_scratch[i] : 0U;
+
+		offset += subgroupAdd(i < gl_SubgroupID ? subgroup_sum : 0U);
+		total += subgroupAdd(subgroup_sum);
+	}
+
+	prefix += offset;
+#else
+	uint index = gl_LocalInvocationIndex;
+
+	workgroup_scratch[index] = value;
+
+	barrier();
+
+	// Inclusive scan with log2(WORKGROUP_SIZE) steps, each invocation adds the value stride invocations before it
+	for (uint stride = 1U; stride < WORKGROUP_SIZE; stride <<= 1)
+	{
+		uint previous = index >= stride ? workgroup_scratch[index - stride] : 0U;
+
+		barrier();
+
+		workgroup_scratch[index] += previous;
+
+		barrier();
+	}
+
+	uint prefix = workgroup_scratch[index] - value;
+	total       = workgroup_scratch[WORKGROUP_SIZE - 1U];
+#endif
+
+	barrier();
+
+	return prefix;
+}
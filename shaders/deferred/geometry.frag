@@ -41,11 +41,26 @@ layout(push_constant, std430) uniform PBRMaterialUniform {
     float roughness_factor;
 } pbr_material_uniform;
 
+#ifdef PACKED_GBUFFER
+// Unit vectors are mapped to the octahedron folded onto the [-1, 1] square
+vec2 encode_octahedral(vec3 v)
+{
+    v /= abs(v.x) + abs(v.y) + abs(v.z);
+    vec2 signs = vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    return v.z >= 0.0 ? v.xy : (1.0 - abs(v.yx)) * signs;
+}
+#endif
+
 void main(void)
 {
     vec3 normal = normalize(in_normal);
+#ifdef PACKED_GBUFFER
+    // Octahedral normal transformed from [-1, 1] to [0, 1], with the roughness in the free component
+    o_normal = vec4(0.5 * encode_octahedral(normal) + 0.5, pbr_material_uniform.roughness_factor, 1.0);
+#else
     // Transform normals from [-1, 1] to [0, 1]
     o_normal = vec4(0.5 * normal + 0.5, 1.0);
+#endif
 
     vec4 base_color = vec4(1.0, 0.0, 0.0, 1.0);
 
@@ -55,5 +70,10 @@ void main(void)
     base_color = pbr_material_uniform.base_color_factor;
 #endif
 
+#ifdef PACKED_GBUFFER
+    // The lighting only reads the color, so the alpha holds the metallic factor
+    o_albedo = vec4(base_color.rgb, pbr_material_uniform.metallic_factor);
+#else
     o_albedo = base_color;
+#endif
 }
@@ -1,5 +1,5 @@
 #version 320 es
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,27 +16,65 @@
  * limitations under the License.
  */
 
+#ifdef MULTIVIEW
+#	extension GL_EXT_multiview : require
+#endif
+
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec2 texcoord_0;
+// Octahedral normals only fill the first two components
 layout(location = 2) in vec3 normal;
 
 layout(set = 0, binding = 1) uniform GlobalUniform {
     mat4 model;
     mat4 view_proj;
     vec3 camera_position;
+    vec4 position_offset;
+    vec4 position_scale;
 } global_uniform;
 
+#ifdef MULTIVIEW
+#include "multiview.h"
+#endif
+
+#include "skinning.h"
+#include "vertex_compression.h"
+
 layout (location = 0) out vec4 o_pos;
 layout (location = 1) out vec2 o_uv;
 layout (location = 2) out vec3 o_normal;
 
 void main(void)
 {
-    o_pos = global_uniform.model * vec4(position, 1.0);
+#ifdef SKINNING
+    mat4 model = global_uniform.model * get_skin_matrix();
+#else
+    mat4 model = global_uniform.model;
+#endif
+
+    if (QUANTIZED_POSITION)
+    {
+        o_pos = model * vec4(decode_position(position, global_uniform.position_offset, global_uniform.position_scale), 1.0);
+    }
+    else
+    {
+        o_pos = model * vec4(position, 1.0);
+    }
 
     o_uv = texcoord_0;
 
-    o_normal = mat3(global_uniform.model) * normal;
+    if (OCTAHEDRAL_NORMAL)
+    {
+        o_normal = mat3(model) * decode_octahedral(normal.xy);
+    }
+    else
+    {
+        o_normal = mat3(model) * normal;
+    }
 
+#ifdef MULTIVIEW
+    gl_Position = multiview_uniform.view_proj[gl_ViewIndex] * o_pos;
+#else
     gl_Position = global_uniform.view_proj * o_pos;
+#endif
 }
@@ -1,5 +1,5 @@
 #version 450
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -15,6 +15,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+
+#include "half_precision.h"
+
 precision highp float;
 
 layout(input_attachment_index = 0, binding = 0) uniform subpassInput i_depth;
@@ -41,26 +44,50 @@ layout(set = 0, binding = 4) uniform LightsInfo
 }
 lights_info;
 
+#ifdef CLUSTERED_LIGHTING
+#include "clustered_lighting.h"
+#endif
+
 layout(constant_id = 0) const uint DIRECTIONAL_LIGHT_COUNT = 0U;
 layout(constant_id = 1) const uint POINT_LIGHT_COUNT       = 0U;
 layout(constant_id = 2) const uint SPOT_LIGHT_COUNT        = 0U;
 
+#ifdef PACKED_GBUFFER
+// Unit vectors are mapped to the octahedron folded onto the [-1, 1] square, see deferred/geometry.frag
+vec3 decode_octahedral(vec2 octahedral)
+{
+	vec3  v = vec3(octahedral, 1.0 - abs(octahedral.x) - abs(octahedral.y));
+	float t = max(-v.z, 0.0);
+	v.x += v.x >= 0.0 ? -t : t;
+	v.y += v.y >= 0.0 ? -t : t;
+	return normalize(v);
+}
+#endif
+
 void main()
 {
 	// Retrieve position from depth
 	vec4  clip         = vec4(in_uv * 2.0 - 1.0, subpassLoad(i_depth).x, 1.0);
 	highp vec4 world_w = global_uniform.inv_view_proj * clip;
 	highp vec3 pos     = world_w.xyz / world_w.w;
-	vec4 albedo = subpassLoad(i_albedo);
+	hvec4 albedo = hvec4(subpassLoad(i_albedo));
+#ifdef PACKED_GBUFFER
+	// Octahedral normal, decoded in full precision, the roughness in the third component is not used by the diffuse lighting
+	hvec3 normal = hvec3(decode_octahedral(subpassLoad(i_normal).xy * 2.0 - 1.0));
+#else
 	// Transform from [0,1] to [-1,1]
-	vec3 normal = subpassLoad(i_normal).xyz;
-	normal      = normalize(2.0 * normal - 1.0);
+	hvec3 normal = hvec3(subpassLoad(i_normal).xyz);
+	normal       = normalize(hfloat(2.0) * normal - hfloat(1.0));
+#endif
 	// Calculate lighting
-	vec3 L = vec3(0.0);
+	hvec3 L = hvec3(0.0);
 	for (uint i = 0U; i < DIRECTIONAL_LIGHT_COUNT; ++i)
 	{
 		L += apply_directional_light(lights_info.directional_lights[i], normal);
 	}
+#ifdef CLUSTERED_LIGHTING
+	L += hvec3(min(apply_cluster_lights(pos, vec3(normal)), vec3(HFLOAT_MAX)));
+#else
 	for (uint i = 0U; i < POINT_LIGHT_COUNT; ++i)
 	{
 		L += apply_point_light(lights_info.point_lights[i], pos, normal);
@@ -69,7 +96,8 @@ void main()
 	{
 		L += apply_spot_light(lights_info.spot_lights[i], pos, normal);
 	}
-	vec3 ambient_color = vec3(0.2) * albedo.xyz;
+#endif
+	hvec3 ambient_color = hvec3(0.2) * albedo.xyz;
 	
 	o_color = vec4(ambient_color + L * albedo.xyz, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#version 320 es
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef MULTIVIEW
+#	extension GL_EXT_multiview : require
+#endif
+
+// Position-only vertex shader of vkb::DepthPrepassSubpass. The position must be computed exactly like base.vert,
+// and both are invariant, so that the forward subpass finds the same depth with its EQUAL test.
+
+layout(location = 0) in vec3 position;
+
+layout(set = 0, binding = 1) uniform GlobalUniform {
+    mat4 model;
+    mat4 view_proj;
+    vec3 camera_position;
+    vec4 position_offset;
+    vec4 position_scale;
+} global_uniform;
+
+#ifdef MULTIVIEW
+#include "multiview.h"
+#endif
+
+#include "skinning.h"
+#include "vertex_compression.h"
+
+invariant gl_Position;
+
+void main(void)
+{
+#ifdef SKINNING
+    mat4 model = global_uniform.model * get_skin_matrix();
+#else
+    mat4 model = global_uniform.model;
+#endif
+
+    vec4 local_position = vec4(position, 1.0);
+    if (QUANTIZED_POSITION)
+    {
+        local_position.xyz = decode_position(position, global_uniform.position_offset, global_uniform.position_scale);
+    }
+
+#ifdef MULTIVIEW
+    gl_Position = multiview_uniform.view_proj[gl_ViewIndex] * (model * local_position);
+#else
+    gl_Position = global_uniform.view_proj * (model * local_position);
+#endif
+}
@@ -0,0 +1,39 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Half precision shading, see vkb::Device::uses_float16_arithmetic().
+// With the FP16_ARITHMETIC definition, the hfloat and hvec types are 16-bit floats, otherwise they are 32-bit floats.
+// Must be included before any declaration, as it enables an extension.
+
+#ifdef FP16_ARITHMETIC
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+
+#define HALF_PRECISION_TYPES
+
+#define hfloat float16_t
+#define hvec2 f16vec2
+#define hvec3 f16vec3
+#define hvec4 f16vec4
+#else
+#define hfloat float
+#define hvec2 vec2
+#define hvec3 vec3
+#define hvec4 vec4
+#endif
+
+// Largest finite half float, for clamping full precision values before converting them
+#define HFLOAT_MAX 65504.0
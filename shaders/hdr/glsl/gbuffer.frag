@@ -1,5 +1,5 @@
 #version 450
-/* Copyright (c) 2019-2024, Sascha Willems
+/* Copyright (c) 2019-2026, Sascha Willems
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -42,6 +42,7 @@ layout (binding = 0) uniform UBOCamera {
 
 layout (binding = 2) uniform UBO {
 	float exposure;
+	uint hdr_output;
 } ubo;
 
 void main() 
@@ -104,6 +105,14 @@ void main()
 	}
 
 
+	// Linear color for the compute post-processing, which applies the exposure and extracts the bright parts itself
+	if (ubo.hdr_output != 0)
+	{
+		outColor0 = vec4(color.rgb, 1.0);
+		outColor1 = vec4(0.0);
+		return;
+	}
+
 	// Color with manual exposure into attachment 0
 	outColor0.rgb = vec3(1.0) - exp(-color.rgb * ubo.exposure);
 
@@ -0,0 +1,59 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// HDR post-processing, see vkb::HDRPostProcessing.
+// Resources shared by hdr_luminance.comp, hdr_exposure.comp and hdr_tonemap.frag.
+
+#define HISTOGRAM_BIN_COUNT 256
+
+#define MAX_BLOOM_LEVELS 6
+
+layout(set = 0, binding = 0) uniform sampler2D hdr_image;
+
+// Only written by hdr_exposure.comp
+#ifndef EXPOSURE_ACCESS
+#	define EXPOSURE_ACCESS readonly
+#endif
+
+layout(std430, set = 0, binding = 2) EXPOSURE_ACCESS buffer ExposureBuffer
+{
+	float exposure;
+	float average_luminance;
+}
+exposure_state;
+
+layout(set = 0, binding = 5) uniform Parameters
+{
+	uvec2 hdr_extent;
+	uvec2 bloom_extent;
+	float min_log_luminance;
+	float log_luminance_range;
+	float delta_time;               // seconds
+	float adaptation_speed;
+	float exposure;                 // manual exposure, or a factor of the measured one
+	float bloom_threshold;
+	float bloom_knee;
+	float bloom_intensity;
+	uint  auto_exposure;
+	uint  bloom_level_count;        // zero when the bloom is disabled
+}
+parameters;
+
+float luminance(vec3 color)
+{
+	return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
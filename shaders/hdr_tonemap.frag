@@ -0,0 +1,66 @@
+#version 450
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Composites the bloom onto the HDR image, then tonemaps it.
+// The bloom levels are upsampled while they are added, each with a tent filter of 4 bilinear taps, so that there
+// is no separate upsampling pass. The exposure is the one written by hdr_exposure.comp, the curve is ACES filmic.
+
+precision highp float;
+
+#include "hdr_postprocessing.h"
+
+layout(set = 0, binding = 4) uniform sampler2D bloom_chain;
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 outColor;
+
+vec3 sample_bloom_level(vec2 uv, float level)
+{
+	vec2 texel_size = 1.0 / vec2(textureSize(bloom_chain, int(level)));
+
+	return 0.25 * (textureLod(bloom_chain, uv + texel_size * vec2(-0.5, -0.5), level).rgb +
+	               textureLod(bloom_chain, uv + texel_size * vec2(0.5, -0.5), level).rgb +
+	               textureLod(bloom_chain, uv + texel_size * vec2(-0.5, 0.5), level).rgb +
+	               textureLod(bloom_chain, uv + texel_size * vec2(0.5, 0.5), level).rgb);
+}
+
+vec3 aces_filmic(vec3 color)
+{
+	return clamp((color * (2.51 * color + 0.03)) / (color * (2.43 * color + 0.59) + 0.14), 0.0, 1.0);
+}
+
+void main()
+{
+	// Fetched rather than filtered, as 32 bit float formats may not support linear filtering
+	ivec2 texel = min(ivec2(inUV * vec2(parameters.hdr_extent)), ivec2(parameters.hdr_extent) - 1);
+	vec3  color = texelFetch(hdr_image, texel, 0).rgb;
+
+	if (parameters.bloom_level_count > 0U)
+	{
+		vec3 bloom = vec3(0.0);
+		for (uint level = 0U; level < parameters.bloom_level_count; ++level)
+		{
+			bloom += sample_bloom_level(inUV, float(level));
+		}
+
+		color += bloom * parameters.bloom_intensity;
+	}
+
+	outColor = vec4(aces_filmic(color * exposure_state.exposure), 1.0);
+}
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020, Arm Limited and Contributors
+/* Copyright (c) 2020-2026, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -49,4 +49,36 @@ vec3 apply_spot_light(Light light, vec3 pos, vec3 normal)
 	float outer_cone_angle = light.info.y;
 	float intensity        = (theta - outer_cone_angle) / (inner_cone_angle - outer_cone_angle);
 	return smoothstep(0.0, 1.0, intensity) * light.color.w * light.color.rgb;
-}
\ No newline at end of file
+}
+
+#ifdef HALF_PRECISION_TYPES
+// Half precision variants, see half_precision.h
+// The vectors between lights and world positions are computed in full precision, then only their directions are converted
+
+f16vec3 apply_directional_light(Light light, f16vec3 normal)
+{
+	f16vec3   world_to_light = f16vec3(normalize(-light.direction.xyz));
+	float16_t ndotl          = clamp(dot(normal, world_to_light), float16_t(0.0), float16_t(1.0));
+	return ndotl * f16vec3(min(light.color.w * light.color.rgb, vec3(HFLOAT_MAX)));
+}
+
+f16vec3 apply_point_light(Light light, vec3 pos, f16vec3 normal)
+{
+	vec3      world_to_light = light.position.xyz - pos;
+	float     dist           = length(world_to_light) * 0.005;
+	float     atten          = 1.0 / (dist * dist);
+	float16_t ndotl          = clamp(dot(normal, f16vec3(normalize(world_to_light))), float16_t(0.0), float16_t(1.0));
+	return ndotl * f16vec3(min(light.color.w * atten * light.color.rgb, vec3(HFLOAT_MAX)));
+}
+
+f16vec3 apply_spot_light(Light light, vec3 pos, f16vec3 normal)
+{
+	// Cone angles are close cosines, their difference needs full precision
+	vec3  light_to_pixel   = normalize(pos - light.position.xyz);
+	float theta            = dot(light_to_pixel, normalize(light.direction.xyz));
+	float inner_cone_angle = light.info.x;
+	float outer_cone_angle = light.info.y;
+	float intensity        = (theta - outer_cone_angle) / (inner_cone_angle - outer_cone_angle);
+	return float16_t(smoothstep(0.0, 1.0, intensity)) * f16vec3(min(light.color.w * light.color.rgb, vec3(HFLOAT_MAX)));
+}
+#endif
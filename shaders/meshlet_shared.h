@@ -0,0 +1,68 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Interface of meshlet_geometry.task and meshlet_geometry.mesh, see vkb::MeshletSubpass and geometry/meshlets.h
+
+// vkb::MAX_MESHLET_VERTICES and vkb::MAX_MESHLET_TRIANGLES
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+
+// Meshlets culled per task shader workgroup, and invocations of a mesh shader workgroup
+#define MESHLET_TASK_GROUP_SIZE 32
+#define MESHLET_MESH_GROUP_SIZE 32
+
+// The normal cone of the meshlets is tested, unset for double sided materials
+#define MESHLET_DRAW_CONE_CULLING 1u
+
+struct Meshlet
+{
+	vec4 bounding_sphere;        // xyz center in model space, w radius
+	vec4 cone;                   // xyz axis in model space, w cutoff, 1 if the meshlet faces every direction
+	uint first_vertex;
+	uint vertex_count;
+	uint first_triangle;
+	uint triangle_count;
+};
+
+layout(set = 0, binding = 10) uniform MeshletDrawUniform
+{
+	mat4 model;
+	vec4 camera_position;        // in model space
+	uint first_meshlet;
+	uint meshlet_count;
+	int  vertex_offset;          // added to the vertex indices of the meshlets
+	uint flags;
+	// Offsets and strides of the attributes in their buffers, counted in floats
+	uint position_offset;
+	uint position_stride;
+	uint normal_offset;
+	uint normal_stride;
+	uint texcoord_offset;
+	uint texcoord_stride;
+}
+draw_uniform;
+
+layout(std430, set = 0, binding = 12) readonly buffer MeshletBuffer
+{
+	Meshlet meshlets[];
+};
+
+// Meshlets of a task shader workgroup which passed culling, one mesh shader workgroup each
+struct MeshletPayload
+{
+	uint meshlet_indices[MESHLET_TASK_GROUP_SIZE];
+};
@@ -0,0 +1,60 @@
+/* Copyright (c) 2026, Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * THIS IS A MODIFIED VERSION OF THE ORIGINAL FILE
+ * 
+ * The original file, along with the original Apache-2.0 LICENSE can be found at:
+ * https://github.com/google-research/jax3d/tree/main/jax3d/projects/mobilenerf
+ *
+ * Modification details: Shader code was updated to work on Vulkan (originally
+ * built for WebGL), the MLP is evaluated with half precision arithmetic
+ */
+#version 460
+
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+
+layout(location = 0) in vec2 texCoord_frag;
+layout(location = 1) in vec3 rayDirectionIn;
+
+layout(location = 0) out vec4 o_color;
+
+layout(binding = 0) uniform sampler2D textureInput_0;
+layout(binding = 1) uniform sampler2D textureInput_1;
+
+precision highp float;
+
+#define MORPHEUS_VIEW_DIRECTION true
+#include "mobile_nerf/mlp_fp16.h"
+
+void main(void)
+{
+	vec2 flipped = vec2(texCoord_frag.x, 1.0 - texCoord_frag.y);
+	vec4 pixel_0 = texture(textureInput_0, flipped);
+	vec4 feature_0 = pixel_0;
+	vec4 feature_1 = texture(textureInput_1, flipped);
+
+	vec4 rayDirection = vec4(normalize(rayDirectionIn), 1.0f);
+
+	// deal with iphone
+	feature_0.a    = feature_0.a * 2.0 - 1.0;
+	feature_1.a    = feature_1.a * 2.0 - 1.0;
+	rayDirection.a = rayDirection.a * 2.0 - 1.0;
+
+	o_color.rgb = Convert_sRGB_ToLinear(evaluateNetwork(feature_0, feature_1, rayDirection));
+	o_color.a   = 1.0;
+}
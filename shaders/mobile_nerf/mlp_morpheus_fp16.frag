@@ -0,0 +1,58 @@
+/* Copyright (c) 2026, Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * THIS IS A MODIFIED VERSION OF THE ORIGINAL FILE
+ * 
+ * The original file, along with the original Apache-2.0 LICENSE can be found at:
+ * https://github.com/google-research/jax3d/tree/main/jax3d/projects/mobilenerf
+ *
+ * Modification details: Shader code was updated to work on Vulkan (originally
+ * built for WebGL), the MLP is evaluated with half precision arithmetic
+ */
+#version 460
+
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+
+layout(input_attachment_index = 0, binding = 0) uniform subpassInput inputFeature_0;
+layout(input_attachment_index = 1, binding = 1) uniform subpassInput inputFeature_1;
+layout(input_attachment_index = 2, binding = 2) uniform subpassInput rayDirectionIn;
+
+layout(location = 0) out vec4 o_color;
+
+precision highp float;
+
+#define MORPHEUS_VIEW_DIRECTION true
+#include "mobile_nerf/mlp_fp16.h"
+
+void main(void)
+{
+	vec4 feature_0    = subpassLoad(inputFeature_0).rgba;
+	vec4 feature_1    = subpassLoad(inputFeature_1).rgba;
+	vec4 rayDirection = subpassLoad(rayDirectionIn).rgba;
+
+	if (rayDirection.a < 0.6)
+		discard;
+
+	// deal with iphone
+	feature_0.a    = feature_0.a * 2.0 - 1.0;
+	feature_1.a    = feature_1.a * 2.0 - 1.0;
+	rayDirection.a = rayDirection.a * 2.0 - 1.0;
+
+	o_color.rgb = Convert_sRGB_ToLinear(evaluateNetwork(feature_0, feature_1, rayDirection));
+	o_color.a   = 1.0;
+}
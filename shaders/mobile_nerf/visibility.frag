@@ -0,0 +1,42 @@
+/* Copyright (c) 2026, Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#version 460
+
+#include "mobile_nerf/visibility.h"
+
+// Only the models of the original mobile nerf are alpha tested, as in the forward shaders
+layout(constant_id = 0) const bool alpha_test = true;
+
+layout(location = 0) in vec2 texCoord_frag;
+layout(location = 1) flat in uint triangle_id;
+layout(location = 2) flat in uint instance_id;
+
+layout(location = 0) out uvec2 o_visibility;
+
+layout(binding = 1) uniform sampler2D textureInput_0;
+
+void main(void)
+{
+	if (alpha_test)
+	{
+		vec2 flipped = vec2(texCoord_frag.x, 1.0 - texCoord_frag.y);
+		if (texture(textureInput_0, flipped).r == 0.0)
+			discard;
+	}
+
+	o_visibility = pack_visibility(triangle_id, instance_id);
+}
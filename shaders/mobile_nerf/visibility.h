@@ -0,0 +1,82 @@
+/* Copyright (c) 2026, Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Resources shared by the visibility buffer passes, the mesh is read from storage buffers
+// so that both passes can fetch any triangle of the model
+
+layout(binding = 4) uniform GlobalUniform
+{
+	mat4x4 model;
+	mat4x4 view;
+	mat4x4 proj;
+	vec3   camera_position;
+	vec3   camera_side;
+	vec3   camera_up;
+	vec3   camera_lookat;
+	vec2   img_dim;
+}
+global_uniform;
+
+// Tightly packed position (3 floats) and texture coordinate (2 floats) per vertex
+layout(std430, binding = 5) readonly buffer Vertices
+{
+	float vertices[];
+};
+
+// Three indices per triangle
+layout(std430, binding = 6) readonly buffer Indices
+{
+	uint indices[];
+};
+
+// One position offset (3 floats) per instance
+layout(std430, binding = 7) readonly buffer Instances
+{
+	float instance_offsets[];
+};
+
+layout(push_constant) uniform PushConstants
+{
+	uint model_id;
+}
+push_constants;
+
+struct Vertex
+{
+	vec3 position;
+	vec2 tex_coord;
+};
+
+Vertex fetch_vertex(uint index, uint instance)
+{
+	Vertex vertex;
+	vertex.position  = vec3(vertices[index * 5], vertices[index * 5 + 1], vertices[index * 5 + 2]);
+	vertex.tex_coord = vec2(vertices[index * 5 + 3], vertices[index * 5 + 4]);
+	vertex.position += vec3(instance_offsets[instance * 3], instance_offsets[instance * 3 + 1], instance_offsets[instance * 3 + 2]);
+	return vertex;
+}
+
+vec4 to_clip_space(vec3 position)
+{
+	return global_uniform.proj * global_uniform.view * global_uniform.model * vec4(position.x, -position.y, position.z, 1.0);
+}
+
+// Model ids are stored with an offset of one, so that the cleared value marks pixels not covered by any triangle
+uvec2 pack_visibility(uint triangle, uint instance)
+{
+	return uvec2(triangle, ((push_constants.model_id + 1u) << 16) | instance);
+}
@@ -0,0 +1,36 @@
+/* Copyright (c) 2026, Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#version 460
+
+#include "mobile_nerf/visibility.h"
+
+layout(location = 0) out vec2 texCoord_frag;
+layout(location = 1) flat out uint triangle_id;
+layout(location = 2) flat out uint instance_id;
+
+void main(void)
+{
+	// The draw is not indexed, the vertices are pulled through the index buffer instead. This gives every
+	// triangle its own provoking vertex, so the triangle index can be passed on without gl_PrimitiveID,
+	// which would need the geometryShader feature
+	Vertex vertex = fetch_vertex(indices[gl_VertexIndex], uint(gl_InstanceIndex));
+
+	texCoord_frag = vertex.tex_coord;
+	triangle_id   = uint(gl_VertexIndex) / 3u;
+	instance_id   = uint(gl_InstanceIndex);
+	gl_Position   = to_clip_space(vertex.position);
+}
@@ -0,0 +1,90 @@
+/* Copyright (c) 2026, Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * THIS IS A MODIFIED VERSION OF THE ORIGINAL FILE
+ * 
+ * The original file, along with the original Apache-2.0 LICENSE can be found at:
+ * https://github.com/google-research/jax3d/tree/main/jax3d/projects/mobilenerf
+ *
+ * Modification details: Shader code was updated to work on Vulkan (originally
+ * built for WebGL), features are fetched from a visibility buffer
+ */
+
+// Requires the network to be included first, from either mlp.h or mlp_fp16.h
+
+#include "mobile_nerf/visibility.h"
+
+layout(input_attachment_index = 0, binding = 0) uniform usubpassInput visibilityIn;
+
+layout(binding = 1) uniform sampler2D textureInput_0;
+layout(binding = 2) uniform sampler2D textureInput_1;
+
+layout(location = 0) out vec4 o_color;
+
+// Perspective correct barycentrics of the pixel at ndc inside the triangle given in clip space
+vec3 barycentrics(vec4 clip_0, vec4 clip_1, vec4 clip_2, vec2 ndc)
+{
+	vec2 p0 = clip_0.xy / clip_0.w;
+	vec2 e1 = clip_1.xy / clip_1.w - p0;
+	vec2 e2 = clip_2.xy / clip_2.w - p0;
+	vec2 p  = ndc - p0;
+
+	float area = e1.x * e2.y - e2.x * e1.y;
+	float b1   = (p.x * e2.y - e2.x * p.y) / area;
+	float b2   = (e1.x * p.y - p.x * e1.y) / area;
+
+	vec3 perspective = vec3(1.0 - b1 - b2, b1, b2) / vec3(clip_0.w, clip_1.w, clip_2.w);
+	return perspective / (perspective.x + perspective.y + perspective.z);
+}
+
+void main(void)
+{
+	// The resolve is drawn once per model, every draw only shades the pixels of its own model
+	uvec2 visibility = subpassLoad(visibilityIn).xy;
+	if ((visibility.y >> 16) != push_constants.model_id + 1u)
+		discard;
+
+	uint triangle = visibility.x;
+	uint instance = visibility.y & 0xFFFFu;
+
+	Vertex v0 = fetch_vertex(indices[triangle * 3], instance);
+	Vertex v1 = fetch_vertex(indices[triangle * 3 + 1], instance);
+	Vertex v2 = fetch_vertex(indices[triangle * 3 + 2], instance);
+
+	vec2 ndc = gl_FragCoord.xy / global_uniform.img_dim * 2.0 - 1.0;
+	vec3 b   = barycentrics(to_clip_space(v0.position), to_clip_space(v1.position), to_clip_space(v2.position), ndc);
+
+	vec3 position  = b.x * v0.position + b.y * v1.position + b.z * v2.position;
+	vec2 tex_coord = b.x * v0.tex_coord + b.y * v1.tex_coord + b.z * v2.tex_coord;
+
+	// Neighbouring pixels may belong to other triangles, so there are no meaningful derivatives to select a mip level
+	vec2 flipped   = vec2(tex_coord.x, 1.0 - tex_coord.y);
+	vec4 feature_0 = textureLod(textureInput_0, flipped, 0.0);
+	vec4 feature_1 = textureLod(textureInput_1, flipped, 0.0);
+
+	vec3 camera_position = global_uniform.camera_position;
+	vec4 rayDirection    = vec4(normalize(position - vec3(camera_position.x, -camera_position.y, camera_position.z)), 1.0f);
+
+	// deal with iphone
+	feature_0.a    = feature_0.a * 2.0 - 1.0;
+	feature_1.a    = feature_1.a * 2.0 - 1.0;
+	rayDirection.a = rayDirection.a * 2.0 - 1.0;
+
+	o_color.rgb = Convert_sRGB_ToLinear(evaluateNetwork(feature_0, feature_1, rayDirection));
+	o_color.a   = 1.0;
+}
@@ -0,0 +1,28 @@
+/* Copyright (c) 2026, Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#version 460
+
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+
+// The models from the Morpheus team encode the view direction differently
+layout(constant_id = 0) const bool morpheus_view_direction = false;
+#define MORPHEUS_VIEW_DIRECTION morpheus_view_direction
+
+precision highp float;
+
+#include "mobile_nerf/mlp_fp16.h"
+#include "mobile_nerf/visibility_resolve.h"
@@ -0,0 +1,28 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Camera matrices of the views rendered at once with VK_KHR_multiview, indexed by gl_ViewIndex, see vkb::GeometrySubpass::set_views().
+// The shaders including it must enable GL_EXT_multiview before their first declaration.
+#define MAX_VIEW_COUNT 4
+
+layout(set = 0, binding = 15) uniform MultiviewUniform
+{
+	mat4 view_proj[MAX_VIEW_COUNT];
+	mat4 previous_view_proj[MAX_VIEW_COUNT];
+	vec4 camera_position[MAX_VIEW_COUNT];
+}
+multiview_uniform;
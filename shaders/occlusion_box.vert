@@ -0,0 +1,44 @@
+#version 450
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Bounding box of a mesh node, drawn for its occlusion query, see vkb::GeometrySubpass::set_occlusion_predicates()
+// The 12 triangles of the box are generated from the vertex index, without vertex buffers.
+
+layout(push_constant) uniform OcclusionBox
+{
+	mat4 view_proj;
+	vec4 box_min;
+	vec4 box_max;
+}
+box;
+
+// Corners of the triangles, with bits 0, 1 and 2 selecting the maximum x, y and z
+const int corners[36] = int[36](0, 2, 1, 1, 2, 3,
+                                4, 5, 6, 5, 7, 6,
+                                0, 1, 4, 1, 5, 4,
+                                2, 6, 3, 3, 6, 7,
+                                0, 4, 2, 2, 4, 6,
+                                1, 3, 5, 3, 7, 5);
+
+void main()
+{
+	int  corner = corners[gl_VertexIndex];
+	vec3 t      = vec3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+
+	gl_Position = box.view_proj * vec4(mix(box.box_min.xyz, box.box_max.xyz, t), 1.0);
+}
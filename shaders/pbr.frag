@@ -1,5 +1,5 @@
 #version 320 es
-/* Copyright (c) 2019-2023 Arm Limited and Contributors
+/* Copyright (c) 2019-2026 Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,6 +16,10 @@
  * limitations under the License.
  */
 
+#ifdef MULTIVIEW
+#	extension GL_EXT_multiview : require
+#endif
+
 /* References will be formatted by: [source] explination
  *
  * Sources:
@@ -55,6 +59,10 @@ layout(set = 0, binding = 1) uniform GlobalUniform
 }
 global_uniform;
 
+#ifdef MULTIVIEW
+#include "multiview.h"
+#endif
+
 struct Light
 {
 	vec4 position;         // position.w represents type of light
@@ -225,7 +233,13 @@ void main(void)
 #endif
 
 	vec3  N     = normal();
-	vec3  V     = normalize(global_uniform.camera_position - in_pos);
+#ifdef MULTIVIEW
+	vec3 camera_position = multiview_uniform.camera_position[gl_ViewIndex].xyz;
+#else
+	vec3 camera_position = global_uniform.camera_position;
+#endif
+
+	vec3  V     = normalize(camera_position - in_pos);
 	float NdotV = saturate(dot(N, V));
 
 	vec3 LightContribution = vec3(0.0);
@@ -0,0 +1,38 @@
+#version 450
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+precision highp float;
+
+layout(set = 0, binding = 0) uniform sampler2D scene_sampler;
+
+layout(location = 0) in vec2 in_uv;
+
+layout(location = 0) out vec4 o_color;
+
+// The scene only covers the rendered region of its image
+layout(push_constant, std430) uniform UpscaleParameters
+{
+	vec2 uv_scale;
+	vec2 max_uv;
+} parameters;
+
+void main(void)
+{
+	// Bilinear filtering must not blend in the texels outside of the rendered region
+	o_color = texture(scene_sampler, min(in_uv * parameters.uv_scale, parameters.max_uv));
+}
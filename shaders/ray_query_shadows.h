@@ -0,0 +1,50 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Shadows of a directional light traced with ray queries, see vkb::RayQueryShadows, bound with RayQueryShadows::bind()
+// at binding 5. The mask is traced at a fraction of the resolution, RAY_QUERY_SHADOW_SCALE, and upsampled here by
+// weighting the 2x2 nearest texels with the similarity of their depth to the depth of the fragment.
+
+precision highp sampler2D;
+
+layout(set = 0, binding = 5) uniform sampler2D ray_query_shadow_mask;
+
+// Returns 1 where the fragment is lit and 0 where it is in shadow, frag_coord and depth are those of gl_FragCoord
+float get_ray_query_shadow(vec2 frag_coord, float depth)
+{
+	vec2  coord = frag_coord / float(RAY_QUERY_SHADOW_SCALE) - 0.5;
+	ivec2 base  = ivec2(floor(coord));
+	vec2  blend = coord - vec2(base);
+	ivec2 last  = textureSize(ray_query_shadow_mask, 0) - 1;
+
+	float sum        = 0.0;
+	float weight_sum = 0.0;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		ivec2 offset = ivec2(i & 1, i >> 1);
+		vec2  texel  = texelFetch(ray_query_shadow_mask, clamp(base + offset, ivec2(0), last), 0).rg;
+
+		vec2  bilinear = mix(1.0 - blend, blend, vec2(offset));
+		float weight   = bilinear.x * bilinear.y / (1e-4 + abs(texel.g - depth) / max(depth, 1e-6));
+
+		sum += texel.r * weight;
+		weight_sum += weight;
+	}
+
+	return weight_sum > 0.0 ? sum / weight_sum : 1.0;
+}
@@ -0,0 +1,40 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Skinning of the meshes deformed by a vkb::sg::Skin, which GLTFLoader loads with joints_0 and weights_0 attributes.
+// The joint matrices of the node are uploaded by vkb::GeometrySubpass every frame.
+
+#if defined(HAS_JOINTS_0) && defined(HAS_WEIGHTS_0)
+#	define SKINNING
+
+layout(location = 5) in uvec4 joints_0;
+layout(location = 6) in vec4 weights_0;
+
+// Matrices of the joints in the model space of the node, see vkb::sg::Skin::get_joint_matrices()
+layout(std430, set = 0, binding = 3) readonly buffer JointMatrices
+{
+	mat4 joint_matrices[];
+};
+
+mat4 get_skin_matrix()
+{
+	return weights_0.x * joint_matrices[joints_0.x] +
+	       weights_0.y * joint_matrices[joints_0.y] +
+	       weights_0.z * joint_matrices[joints_0.z] +
+	       weights_0.w * joint_matrices[joints_0.w];
+}
+#endif
@@ -0,0 +1,82 @@
+#version 450
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+layout(set = 0, binding = 0) uniform UBO
+{
+	mat4  projection;
+	mat4  modelview;
+	vec4  frustum_planes[6];
+	vec4  viewer;
+	vec4  light_dir;
+	float terrain_size;
+	float height_scale;
+	float split_factor;
+}
+ubo;
+
+layout(set = 0, binding = 2) uniform sampler2DArray samplerLayers;
+
+layout(location = 0) in vec3 inNormal;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec3 inViewVec;
+layout(location = 3) in float inHeight;
+
+layout(location = 0) out vec4 outFragColor;
+
+// Texture layers blended by height, like terrain.frag, repeating every 32 world units
+vec3 sampleTerrainLayer()
+{
+	vec2 layers[6];
+	layers[0] = vec2(-10.0, 10.0);
+	layers[1] = vec2(5.0, 45.0);
+	layers[2] = vec2(45.0, 80.0);
+	layers[3] = vec2(75.0, 100.0);
+	layers[4] = vec2(95.0, 150.0);
+	layers[5] = vec2(140.0, 290.0);
+
+	vec3  color  = vec3(0.0);
+	float height = inHeight * 255.0;
+	vec2  uv     = inUV * ubo.terrain_size / 32.0;
+
+	for (int i = 0; i < 6; i++)
+	{
+		float range  = layers[i].y - layers[i].x;
+		float weight = max(0.0, (range - abs(height - layers[i].y)) / range);
+		color += weight * texture(samplerLayers, vec3(uv, i)).rgb;
+	}
+
+	return color;
+}
+
+float fog(float density)
+{
+	const float LOG2 = -1.442695;
+	float       d    = density * length(inViewVec) / ubo.terrain_size;
+	return 1.0 - clamp(exp2(d * d * LOG2), 0.0, 1.0);
+}
+
+void main()
+{
+	vec3 N       = normalize(inNormal);
+	vec3 ambient = vec3(0.5);
+	vec3 diffuse = max(dot(N, ubo.light_dir.xyz), 0.0) * vec3(1.0);
+
+	vec4 color = vec4((ambient + diffuse) * sampleTerrainLayer(), 1.0);
+
+	const vec4 fogColor = vec4(0.47, 0.5, 0.67, 0.0);
+	outFragColor        = mix(color, fogColor, fog(4.0));
+}
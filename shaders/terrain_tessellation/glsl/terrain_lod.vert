@@ -0,0 +1,87 @@
+#version 450
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Draws a node of the terrain quadtree as a grid displaced by the tile of its level in the atlas.
+// Vertices far from the viewer morph onto the grid of the parent level, so that they match the coarser neighbours.
+
+layout(constant_id = 0) const uint TILE_QUADS = 32;
+
+layout(set = 0, binding = 0) uniform UBO
+{
+	mat4  projection;
+	mat4  modelview;
+	vec4  frustum_planes[6];
+	vec4  viewer;
+	vec4  light_dir;
+	float terrain_size;
+	float height_scale;
+	float split_factor;
+}
+ubo;
+
+layout(set = 0, binding = 1) uniform sampler2DArray heightTiles;
+
+layout(std430, set = 0, binding = 3) readonly buffer Instances
+{
+	uvec4 instances[];
+};
+
+layout(location = 0) in vec2 inGridPos;
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec2 outUV;
+layout(location = 2) out vec3 outViewVec;
+layout(location = 3) out float outHeight;
+
+// Fraction of the split distance where vertices start to morph, they are on the parent grid past 1.9 split distances
+#define MORPH_START 1.5
+#define MORPH_RANGE 0.4
+
+float sample_height(vec2 grid, float slot)
+{
+	return textureLod(heightTiles, vec3((grid + 0.5) / float(TILE_QUADS + 1U), slot), 0.0).r;
+}
+
+void main()
+{
+	uvec4 instance  = instances[gl_InstanceIndex];
+	float node_size = 1.0 / float(1U << instance.z);
+	vec2  node_min  = vec2(instance.xy) * node_size;
+	float slot      = float(instance.w);
+
+	vec2  uv       = node_min + inGridPos / float(TILE_QUADS) * node_size;
+	float distance = length(vec3(uv - ubo.viewer.xy, ubo.viewer.z));
+	float morph    = clamp((distance / (ubo.split_factor * node_size) - MORPH_START) / MORPH_RANGE, 0.0, 1.0);
+
+	vec2 grid = inGridPos - fract(inGridPos * 0.5) * 2.0 * morph;
+	uv        = node_min + grid / float(TILE_QUADS) * node_size;
+
+	float height = sample_height(grid, slot);
+
+	// Central differences, in world units
+	float texel_size = node_size * ubo.terrain_size / float(TILE_QUADS);
+	float dx         = (sample_height(grid + vec2(1.0, 0.0), slot) - sample_height(grid - vec2(1.0, 0.0), slot)) * ubo.height_scale / (2.0 * texel_size);
+	float dz         = (sample_height(grid + vec2(0.0, 1.0), slot) - sample_height(grid - vec2(0.0, 1.0), slot)) * ubo.height_scale / (2.0 * texel_size);
+	outNormal        = normalize(vec3(-dx, -1.0, -dz));
+
+	vec4 pos = vec4((uv.x - 0.5) * ubo.terrain_size, -height * ubo.height_scale, (uv.y - 0.5) * ubo.terrain_size, 1.0);
+
+	outUV       = uv;
+	outHeight   = height;
+	outViewVec  = (ubo.modelview * pos).xyz;
+	gl_Position = ubo.projection * ubo.modelview * pos;
+}
@@ -0,0 +1,46 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Decoding of the vertex attributes compressed by vkb::GLTFLoader, see vkb::VertexQuantization::Compressed.
+// Submeshes set these specialization constants for the attributes which are compressed, see vkb::SubMeshSpecializationConstant.
+// Compressed attributes are read with the same types as uncompressed ones, so that submeshes share shader modules.
+layout(constant_id = 100) const bool QUANTIZED_POSITION = false;
+layout(constant_id = 101) const bool OCTAHEDRAL_NORMAL  = false;
+layout(constant_id = 102) const bool OCTAHEDRAL_TANGENT = false;
+
+// Positions are normalized in the box of their mesh, found in the GlobalUniform
+vec3 decode_position(vec3 position, vec4 position_offset, vec4 position_scale)
+{
+	return position_offset.xyz + position * position_scale.xyz;
+}
+
+// Unit vectors are mapped to the octahedron folded onto the [-1, 1] square
+vec3 decode_octahedral(vec2 octahedral)
+{
+	vec3  v = vec3(octahedral, 1.0 - abs(octahedral.x) - abs(octahedral.y));
+	float t = max(-v.z, 0.0);
+	v.x += v.x >= 0.0 ? -t : t;
+	v.y += v.y >= 0.0 ? -t : t;
+	return normalize(v);
+}
+
+// The handedness of tangents is the sign of the second component, which holds the octahedral y remapped to [0, 1]
+vec4 decode_octahedral_tangent(vec2 octahedral)
+{
+	vec2 folded = vec2(octahedral.x, abs(octahedral.y) * 2.0 - 1.0);
+	return vec4(decode_octahedral(folded), octahedral.y < 0.0 ? -1.0 : 1.0);
+}
@@ -0,0 +1,95 @@
+/* Copyright (c) 2026, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <CLI/CLI.hpp>
+
+#include "core/util/logging.hpp"
+#include "filesystem/archive.hpp"
+
+namespace
+{
+// The files are read without vkb::filesystem, which would serve them from the archive being replaced
+std::vector<uint8_t> read_file(const std::filesystem::path &path)
+{
+	std::ifstream file{path, std::ios::binary};
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open " + path.string());
+	}
+
+	return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+}        // namespace
+
+/**
+ * Packs a directory into an archive which the samples read instead of the directory, e.g. from the root of the repository:
+ *     vkb_asset_packer assets assets.vkbpak
+ */
+int main(int argc, char *argv[])
+{
+	CLI::App app{"Packs a directory into a single archive, served in place of the directory by the filesystem"};
+
+	std::string input;
+	std::string output;
+	bool        store = false;
+
+	app.add_option("input", input, "Directory to pack")->required()->check(CLI::ExistingDirectory);
+	app.add_option("output", output, "Archive file, named after the directory with the .vkbpak extension to be found by the samples")->required();
+	app.add_flag("--store", store, "Store every file as is, so that all of them are mapped in place");
+
+	CLI11_PARSE(app, argc, argv);
+
+	try
+	{
+		std::vector<std::filesystem::path> files;
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(input))
+		{
+			if (entry.is_regular_file())
+			{
+				files.push_back(entry.path());
+			}
+		}
+
+		// Files of the same directory are read together, so they are packed next to each other
+		std::sort(files.begin(), files.end());
+
+		auto compression = store ? vkb::filesystem::ArchiveCompression::None : vkb::filesystem::ArchiveCompression::Zstd;
+
+		vkb::filesystem::ArchiveWriter writer{output};
+
+		for (const auto &file : files)
+		{
+			writer.add(file.lexically_relative(input).generic_string(), read_file(file), compression);
+		}
+
+		writer.finish();
+
+		LOGI("Packed {} files of {} into {}", files.size(), input, output);
+	}
+	catch (const std::exception &e)
+	{
+		LOGE("Failed to pack {}: {}", input, e.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}